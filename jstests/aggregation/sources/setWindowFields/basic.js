@@ -0,0 +1,53 @@
+// Tests the basic behavior of the $setWindowFields stage.
+(function() {
+    "use strict";
+
+    const coll = db.set_window_fields_basic;
+    coll.drop();
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, group: i % 2, t: i, x: i * 10}));
+    }
+
+    // Running totals and moving averages are computed within each partition, in sortBy order.
+    let results = coll.aggregate([
+                          {
+                            $setWindowFields: {
+                                partitionBy: "$group",
+                                sortBy: {t: 1},
+                                output: {
+                                    total: {
+                                        $sum: "$x",
+                                        window: {documents: ["unbounded", "current"]}
+                                    },
+                                    avg: {$avg: "$x", window: {documents: [-1, 1]}},
+                                    rank: {$rank: {}}
+                                }
+                            }
+                          },
+                          {$match: {group: 0}}
+                      ])
+                      .toArray();
+    assert.eq(results.map((doc) => doc.total), [0, 20, 60, 120, 200]);
+    assert.eq(results.map((doc) => doc.avg), [10, 20, 40, 60, 70]);
+    assert.eq(results.map((doc) => doc.rank), [1, 2, 3, 4, 5]);
+
+    // A range window includes every document whose sortBy value is within the offsets.
+    results = coll.aggregate([
+                      {
+                        $setWindowFields:
+                            {sortBy: {t: 1}, output: {n: {$sum: 1, window: {range: [-2, 0]}}}}
+                      },
+                      {$sort: {t: 1}}
+                  ])
+                  .toArray();
+    assert.eq(results.map((doc) => doc.n), [1, 2, 3, 3, 3, 3, 3, 3, 3, 3]);
+
+    // The partitionBy must be a field path so that the input can be sorted by it.
+    assert.commandFailedWithCode(db.runCommand({
+        aggregate: coll.getName(),
+        pipeline: [{$setWindowFields: {partitionBy: {$mod: ["$t", 2]}, output: {n: {$sum: 1}}}}],
+        cursor: {}
+    }),
+                                 50899);
+}());
@@ -0,0 +1,61 @@
+/**
+ * Tests that an allPaths index can answer range queries, cover projections on non-multikey paths
+ * and provide a sort on the queried field.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage and isIndexOnly.
+
+    const coll = db.all_paths_index_covered;
+    coll.drop();
+
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(coll.insert({a: i, b: {c: i % 5}, d: [i, i + 1], e: "x" + i}));
+    }
+    assert.commandWorked(coll.createIndex({"$**": 1}));
+
+    // A range predicate on a leaf path uses the index and returns the right documents.
+    assert.eq(5, coll.find({a: {$gte: 5, $lt: 10}}).itcount());
+    assert.eq(4, coll.find({"b.c": 3}).itcount());
+    assert.eq(2, coll.find({d: 7}).itcount());
+    assert.eq(1, coll.find({e: /^x1[5]$/}).itcount());
+
+    let explain = coll.find({a: {$gte: 5, $lt: 10}}).explain("executionStats");
+    assert.neq(null, getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN"), explain);
+    assert.eq(5, explain.executionStats.totalKeysExamined, explain);
+
+    // A projection of the queried, non-multikey path is covered.
+    explain = coll.find({a: {$gt: 15}}, {_id: 0, a: 1}).explain("executionStats");
+    assert(isIndexOnly(db, explain.queryPlanner.winningPlan), explain);
+    assert.eq(0, explain.executionStats.totalDocsExamined, explain);
+    assert.eq([{a: 16}, {a: 17}, {a: 18}, {a: 19}],
+              coll.find({a: {$gt: 15}}, {_id: 0, a: 1}).sort({a: 1}).toArray());
+
+    // The same projection of a path which holds an array requires a fetch.
+    explain = coll.find({d: {$gt: 15}}, {_id: 0, d: 1}).explain();
+    assert(!isIndexOnly(db, explain.queryPlanner.winningPlan), explain);
+
+    // The index provides a sort on the queried field in either direction.
+    for (let dir of[1, -1]) {
+        explain = coll.find({a: {$lt: 10}}).sort({a: dir}).explain();
+        assert.eq(null, getPlanStage(explain.queryPlanner.winningPlan, "SORT"), explain);
+        const results = coll.find({a: {$lt: 10}}).sort({a: dir}).toArray();
+        assert.eq(10, results.length);
+        for (let i = 1; i < results.length; ++i) {
+            assert.eq(dir, results[i].a > results[i - 1].a ? 1 : -1, results);
+        }
+    }
+
+    // Predicates the index keys cannot answer fall back to a collection scan.
+    assert.eq(20, coll.find({a: {$exists: true}}).itcount());
+    assert.eq(4, coll.find({b: {c: 1}}).itcount());
+    assert.eq(0, coll.find({a: null}).itcount());
+    explain = coll.find({a: {$exists: true}}).explain();
+    assert.neq(null, getPlanStage(explain.queryPlanner.winningPlan, "COLLSCAN"), explain);
+
+    // Removing documents removes their keys.
+    assert.writeOK(coll.remove({a: {$gte: 10}}));
+    assert.eq(0, coll.find({a: {$gte: 10}}).itcount());
+    assert.eq(2, coll.find({"b.c": 3}).itcount());
+})();
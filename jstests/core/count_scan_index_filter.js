@@ -0,0 +1,28 @@
+/**
+ * Tests that a count whose predicate has a part that can only be evaluated against the index keys
+ * is answered with a COUNT_SCAN rather than an IXSCAN followed by a COUNT.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+    load("jstests/libs/fixture_helpers.js");
+
+    const coll = db.count_scan_index_filter;
+    coll.drop();
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    for (let i = 0; i < 20; ++i) {
+        assert.writeOK(coll.insert({a: i % 2, b: i}));
+    }
+
+    const query = {a: 1, b: {$mod: [3, 0]}};
+    assert.eq(3, coll.find(query).count());
+
+    if (!(isMongos(db) && FixtureHelpers.isSharded(coll))) {
+        const explain = coll.explain("executionStats").find(query).count();
+        const countScan = getPlanStage(explain.executionStats.executionStages, "COUNT_SCAN");
+        assert.neq(null, countScan, tojson(explain));
+        assert(countScan.hasOwnProperty("filter"), tojson(explain));
+        assert(!planHasStage(db, explain.queryPlanner.winningPlan, "FETCH"), tojson(explain));
+    }
+}());
@@ -0,0 +1,48 @@
+// Tests the per-range hashes reported by dbHash with 'rangeSize', and rehashing a single range with
+// 'idRange'.
+// @tags: [
+//     # dbhash command is not available on embedded
+//     incompatible_with_embedded,
+// ]
+(function() {
+    "use strict";
+
+    const testDB = db.getSiblingDB("dbhash_ranges");
+    assert.commandWorked(testDB.dropDatabase());
+    const coll = testDB.coll;
+    for (let i = 0; i < 25; ++i) {
+        assert.commandWorked(coll.insert({_id: i, x: i}));
+    }
+
+    const full = assert.commandWorked(testDB.runCommand({dbHash: 1}));
+    let res = assert.commandWorked(testDB.runCommand({dbHash: 1, rangeSize: 10}));
+    assert.eq(full.md5, res.md5, tojson(res));
+    assert.eq(full.collections.coll, res.collections.coll, tojson(res));
+
+    const ranges = res.ranges.coll;
+    assert.eq(3, ranges.length, tojson(res));
+    assert.eq([10, 10, 5], ranges.map(range => range.count), tojson(ranges));
+    assert.eq(0, ranges[0].min, tojson(ranges));
+    assert.eq(9, ranges[0].max, tojson(ranges));
+    assert.eq(20, ranges[2].min, tojson(ranges));
+    assert.eq(24, ranges[2].max, tojson(ranges));
+
+    // Rehashing a range on its own gives the hash reported for it.
+    res = assert.commandWorked(testDB.runCommand(
+        {dbHash: 1, collections: ["coll"], idRange: {min: ranges[1].min, max: ranges[1].max}}));
+    assert.eq(ranges[1].md5, res.collections.coll, tojson(res));
+
+    // A change shows up only in the range containing it.
+    assert.commandWorked(coll.update({_id: 15}, {$set: {x: -1}}));
+    res = assert.commandWorked(testDB.runCommand({dbHash: 1, rangeSize: 10}));
+    assert.eq(ranges[0].md5, res.ranges.coll[0].md5, tojson(res));
+    assert.neq(ranges[1].md5, res.ranges.coll[1].md5, tojson(res));
+    assert.eq(ranges[2].md5, res.ranges.coll[2].md5, tojson(res));
+
+    assert.commandFailedWithCode(testDB.runCommand({dbHash: 1, rangeSize: 0}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(testDB.runCommand({dbHash: 1, idRange: {min: 0, max: 1}}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        testDB.runCommand({dbHash: 1, collections: ["coll"], idRange: {min: 0}}),
+        ErrorCodes.BadValue);
+})();
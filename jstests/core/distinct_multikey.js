@@ -100,4 +100,18 @@
     explain = coll.explain("queryPlanner").distinct("b.c", {a: 3});
     assert(planHasStage(db, explain.queryPlanner.winningPlan, "PROJECTION"));
     assert(planHasStage(db, explain.queryPlanner.winningPlan, "DISTINCT_SCAN"));
+
+    // Test distinct with no predicate over a leading non-multikey dotted path where a trailing
+    // field is multikey.
+    coll.drop();
+    assert.commandWorked(coll.createIndex({"a.b": 1, c: 1}));
+    assert.writeOK(coll.insert({a: {b: 1}, c: [2, 3]}));
+    assert.writeOK(coll.insert({a: {b: 8}, c: [3, 4]}));
+    assert.writeOK(coll.insert({a: {b: 1}, c: [3, 5]}));
+
+    result = coll.distinct("a.b");
+    assert.eq([1, 8], result.sort());
+    explain = coll.explain("queryPlanner").distinct("a.b");
+    assert(planHasStage(db, explain.queryPlanner.winningPlan, "PROJECTION"));
+    assert(planHasStage(db, explain.queryPlanner.winningPlan, "DISTINCT_SCAN"));
 }());
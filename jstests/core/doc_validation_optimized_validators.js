@@ -0,0 +1,57 @@
+// Tests that validators, which are simplified when they are parsed, accept and reject the same
+// documents as the validators they were written as.
+// @tags: [assumes_no_implicit_collection_creation_after_drop, requires_non_retryable_commands]
+(function() {
+    "use strict";
+
+    const coll = db.doc_validation_optimized_validators;
+    coll.drop();
+
+    // A $jsonSchema translates into a tree with trivially true and nested logical nodes.
+    assert.commandWorked(db.createCollection(coll.getName(), {
+        validator: {
+            $jsonSchema: {
+                bsonType: "object",
+                required: ["name"],
+                properties: {
+                    name: {bsonType: "string", maxLength: 5},
+                    age: {bsonType: "int", minimum: 0, maximum: 150},
+                    tags: {bsonType: "array", items: {bsonType: "string"}},
+                    address: {
+                        bsonType: "object",
+                        required: ["city"],
+                        properties: {city: {bsonType: "string"}}
+                    }
+                },
+                allOf: [{anyOf: [{required: ["age"]}, {required: ["tags"]}]}]
+            }
+        }
+    }));
+
+    assert.writeOK(coll.insert({name: "a", age: NumberInt(1)}));
+    assert.writeOK(coll.insert({name: "b", tags: ["x"], address: {city: "c"}}));
+    assert.writeErrorWithCode(coll.insert({age: NumberInt(1)}),
+                              ErrorCodes.DocumentValidationFailure);
+    assert.writeErrorWithCode(coll.insert({name: "toolong", age: NumberInt(1)}),
+                              ErrorCodes.DocumentValidationFailure);
+    assert.writeErrorWithCode(coll.insert({name: "c", age: NumberInt(200)}),
+                              ErrorCodes.DocumentValidationFailure);
+    assert.writeErrorWithCode(coll.insert({name: "d", tags: [1]}),
+                              ErrorCodes.DocumentValidationFailure);
+    assert.writeErrorWithCode(coll.insert({name: "e", age: NumberInt(1), address: {}}),
+                              ErrorCodes.DocumentValidationFailure);
+    assert.writeErrorWithCode(coll.insert({name: "f"}), ErrorCodes.DocumentValidationFailure);
+
+    assert.writeOK(coll.update({name: "a"}, {$set: {age: NumberInt(2)}}));
+    assert.writeErrorWithCode(coll.update({name: "a"}, {$unset: {age: 1}}),
+                              ErrorCodes.DocumentValidationFailure);
+    assert.eq(2, coll.find().itcount());
+
+    // An $expr which could only be simplified by evaluating it is kept as written, so the
+    // collection can still be created and the error is raised when a document is validated.
+    coll.drop();
+    assert.commandWorked(
+        db.createCollection(coll.getName(), {validator: {$expr: {$eq: [{$divide: [1, 0]}, 1]}}}));
+    assert.writeError(coll.insert({_id: 0}));
+    assert.eq(0, coll.find().itcount());
+})();
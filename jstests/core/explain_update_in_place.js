@@ -0,0 +1,35 @@
+// Cannot implicitly shard accessed collections because of following errmsg: A single
+// update/delete on a sharded collection must contain an exact match on _id or contain the shard
+// key.
+// @tags: [assumes_unsharded_collection]
+
+// Test that explain of an update reports whether the update would be applied in place.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const t = db.jstests_explain_update_in_place;
+    t.drop();
+    assert.writeOK(t.insert({_id: 0, counter: NumberInt(1), s: "abc"}));
+
+    function explainUpdate(update) {
+        const explain = assert.commandWorked(t.explain("executionStats").update({_id: 0}, update));
+        const stage = getPlanStage(explain.executionStats.executionStages, "UPDATE");
+        assert.neq(null, stage, tojson(explain));
+        assert.eq(1, stage.nWouldModify, tojson(explain));
+        return stage.inPlaceUpdate;
+    }
+
+    // Changing the size of a value always requires rewriting the document.
+    assert.eq(false, explainUpdate({$set: {s: "abcdef"}}));
+    assert.eq(false, explainUpdate({$set: {s: "a"}}));
+    assert.eq(false, explainUpdate({$set: {added: 1}}));
+
+    // Values of the same size are updated in place on storage engines that support damages.
+    const storageEngine = db.serverStatus().storageEngine.name;
+    if (storageEngine === "wiredTiger" || storageEngine === "inMemory") {
+        assert.eq(true, explainUpdate({$inc: {counter: NumberInt(1)}}));
+        assert.eq(true, explainUpdate({$set: {s: "xyz"}}));
+    }
+})();
@@ -84,4 +84,33 @@
 
     // Non-simple: .returnKey() overrides other projections.
     assert.eq({_id: 1}, t.find({_id: 1}, {a: 1}).returnKey().next());
+
+    //
+    // $in over _id.
+    //
+
+    t.drop();
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(t.insert({_id: i, a: i}));
+    }
+
+    // Keys are looked up in ascending order, duplicates are returned once, and missing keys are
+    // skipped.
+    explain = t.find({_id: {$in: [7, 3, 3.0, 42, 1]}}).explain(true);
+    assert(isIdhack(db, explain.queryPlanner.winningPlan));
+    assert.eq(3, explain.executionStats.nReturned);
+    assert.eq(3, explain.executionStats.totalKeysExamined);
+    assert.eq([{_id: 1, a: 1}, {_id: 3, a: 3}, {_id: 7, a: 7}],
+              t.find({_id: {$in: [7, 3, 3.0, 42, 1]}}).toArray());
+    assert.eq([], t.find({_id: {$in: []}}).toArray());
+    assert.eq([{a: 2}, {a: 5}], t.find({_id: {$in: [5, 2]}}, {_id: 0, a: 1}).toArray());
+
+    // ID hack cannot be used for an $in with a sort, a limit or a regex.
+    explain = t.find({_id: {$in: [1, 2]}}).sort({_id: -1}).explain();
+    assert(!isIdhack(db, explain.queryPlanner.winningPlan));
+    explain = t.find({_id: {$in: [1, 2]}}).limit(1).explain();
+    assert(!isIdhack(db, explain.queryPlanner.winningPlan));
+    explain = t.find({_id: {$in: [1, /2/]}}).explain();
+    assert(!isIdhack(db, explain.queryPlanner.winningPlan));
+    assert.eq(2, t.find({_id: {$in: [1, 2]}}).sort({_id: -1}).limit(2).itcount());
 })();
@@ -0,0 +1,37 @@
+// The shell sends the documents of an insert command as an OP_MSG document sequence when they are
+// all objects, and as part of the command otherwise. Both must insert the same documents.
+(function() {
+    "use strict";
+
+    const coll = db.insert_command_documents;
+    coll.drop();
+
+    // A batch of plain objects, with _id not first, and a document read back from the server.
+    assert.commandWorked(coll.insert({_id: 0, a: 0}));
+    const fromServer = coll.findOne({_id: 0});
+    fromServer._id = 1;
+
+    const docs = [fromServer];
+    for (let i = 2; i < 1000; ++i) {
+        docs.push({a: i, _id: i, nested: {b: [i, {c: i}]}});
+    }
+    let res = assert.commandWorked(db.runCommand({insert: coll.getName(), documents: docs}));
+    assert.eq(docs.length, res.n, tojson(res));
+    assert.eq(1000, coll.find().itcount());
+    assert.eq({_id: 500, a: 500, nested: {b: [500, {c: 500}]}}, coll.findOne({_id: 500}));
+    assert.eq({_id: 1, a: 0}, coll.findOne({_id: 1}));
+
+    // Documents are still validated by the server when they are not all objects.
+    assert.commandFailedWithCode(
+        db.runCommand({insert: coll.getName(), documents: [{_id: 1000}, 1]}),
+        ErrorCodes.TypeMismatch);
+    assert.commandFailed(db.runCommand({insert: coll.getName(), documents: []}));
+
+    // Errors for individual documents are reported at their position in the batch.
+    res = db.runCommand({insert: coll.getName(), documents: [{_id: 1001}, {_id: 0}, {_id: 1002}]});
+    assert.commandWorked(res);
+    assert.eq(1, res.n, tojson(res));
+    assert.eq(1, res.writeErrors.length, tojson(res));
+    assert.eq(1, res.writeErrors[0].index, tojson(res));
+    assert.eq(ErrorCodes.DuplicateKey, res.writeErrors[0].code, tojson(res));
+})();
@@ -83,4 +83,18 @@
     assert.eq(6, t.find(regexQuery).itcount());
     assert.eq(
         4, getShapes().length, 'unexpected number of shapes in planCacheListQueryShapes result');
+
+    // The result also reports the number of entries and the hit, miss and eviction counts of each
+    // partition of the cache.
+    const res = assert.commandWorked(t.runCommand('planCacheListQueryShapes'));
+    assert(res.hasOwnProperty('stripes'), tojson(res));
+    let totalEntries = 0;
+    let totalLookups = 0;
+    for (let stripe of res.stripes) {
+        totalEntries += stripe.entries;
+        totalLookups += stripe.hits + stripe.misses;
+        assert.gte(stripe.evictions, 0, tojson(res));
+    }
+    assert.eq(4, totalEntries, tojson(res));
+    assert.gte(totalLookups, 4, tojson(res));
 })();
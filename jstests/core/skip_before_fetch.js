@@ -0,0 +1,38 @@
+// Tests that a skip over an index scan drops index keys before their documents are fetched, and
+// that predicates which can be answered from index keys are applied before fetching.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.skip_before_fetch;
+    coll.drop();
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i % 5, b: "str" + i, c: i}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    // Skipped documents are never fetched.
+    let results = coll.find({a: 1}).sort({a: 1, b: 1}).skip(15).toArray();
+    assert.eq(5, results.length);
+    let explain = coll.find({a: 1}).sort({a: 1, b: 1}).skip(15).explain("executionStats");
+    assert.eq(5, explain.executionStats.nReturned, tojson(explain));
+    assert.eq(5, explain.executionStats.totalDocsExamined, tojson(explain));
+    const fetch = getPlanStage(explain.executionStats.executionStages, "FETCH");
+    assert.neq(null, fetch, tojson(explain));
+    assert.eq("SKIP", fetch.inputStage.stage, tojson(explain));
+
+    // A residual predicate on a trailing index field is checked against the index key, so only
+    // the matching documents are fetched.
+    results = coll.find({a: 2, b: {$not: /7$/}}).toArray();
+    assert.eq(10, results.length);
+    results.forEach(doc => assert(!(/7$/.test(doc.b)), tojson(doc)));
+    explain = coll.find({a: 2, b: {$not: /7$/}}).explain("executionStats");
+    assert.eq(10, explain.executionStats.totalDocsExamined, tojson(explain));
+
+    // A multikey index cannot answer the predicate from its keys.
+    assert.writeOK(coll.insert({_id: 100, a: 2, b: ["str7", "x"], c: 100}));
+    results = coll.find({a: 2, b: {$not: /7$/}}).toArray();
+    assert.eq(10, results.length);
+}());
@@ -109,6 +109,7 @@
         addShard: {skip: isUnrelated},
         addShardToZone: {skip: isUnrelated},
         aggregate: {command: {aggregate: "view", pipeline: [{$match: {}}], cursor: {}}},
+        analyze: {command: {analyze: "view", keys: ["x"]}, expectFailure: true},
         appendOplogNote: {skip: isUnrelated},
         applyOps: {
             command: {applyOps: [{op: "i", o: {_id: 1}, ns: "test.view"}]},
@@ -404,9 +405,16 @@
         planCacheListQueryShapes:
             {command: {planCacheListQueryShapes: "view"}, expectFailure: true},
         planCacheSetFilter: {command: {planCacheSetFilter: "view"}, expectFailure: true},
+        planCacheSnapshot: {command: {planCacheSnapshot: "view"}, expectFailure: true},
         prepareTransaction: {skip: isUnrelated},
         profile: {skip: isUnrelated},
         refreshLogicalSessionCacheNow: {skip: isAnInternalCommand},
+        refreshMaterializedView: {
+            command: {refreshMaterializedView: "view", into: "materialized"},
+            teardown: function(conn) {
+                assert.commandWorked(conn.runCommand({drop: "materialized"}));
+            }
+        },
         reapLogicalSessionCacheNow: {skip: isAnInternalCommand},
         refreshSessions: {skip: isUnrelated},
         refreshSessionsInternal: {skip: isAnInternalCommand},
@@ -0,0 +1,97 @@
+/**
+ * Tests benchRun's open-loop mode, latency percentiles, interval reports, JSON results file and
+ * command ops run in multi-statement transactions.
+ * @tags: [uses_transactions]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    const coll = testDB.benchrun_open_loop;
+    assert.writeOK(coll.insert({_id: 1, x: 1}));
+
+    // An open-loop run issues ops at about the target rate, regardless of how quickly the server
+    // answers them, and reports each few seconds of the run.
+    const resultsFile = MongoRunner.dataPath + "benchrun_open_loop_results.json";
+    let res = benchRun({
+        ops: [{op: "findOne", ns: coll.getFullName(), query: {_id: 1}}],
+        parallel: 2,
+        seconds: 4,
+        targetOpsPerSecond: 200,
+        reportIntervalSeconds: 2,
+        resultsFile: resultsFile,
+        host: primary.host,
+    });
+    jsTestLog("Open-loop benchRun result: " + tojson(res));
+    assert.eq(0, res.errCount, tojson(res));
+    assert.gt(res["totalOps/s"], 100, tojson(res));
+    assert.lt(res["totalOps/s"], 300, tojson(res));
+
+    const findOneLatencies = res.latencyPercentilesMicros.findOne;
+    assert.eq(res.findOnes, findOneLatencies.count, tojson(res));
+    assert.lte(findOneLatencies.p50, findOneLatencies.p99, tojson(res));
+    assert.lte(findOneLatencies.p99, findOneLatencies.p999, tojson(res));
+    assert.lte(findOneLatencies.p999, findOneLatencies.max, tojson(res));
+
+    assert.eq(2, res.intervals.length, tojson(res));
+    res.intervals.forEach(function(interval) {
+        assert.gt(interval.latencyPercentilesMicros.findOne.count, 0, tojson(interval));
+    });
+
+    const exported = JSON.parse(cat(resultsFile));
+    assert.eq(res.findOnes, exported.findOnes, tojson(exported));
+    assert.eq(2, exported.intervals.length, tojson(exported));
+
+    // Command ops can start a transaction and run more commands in it, up to the commit.
+    assert.commandWorked(testDB.runCommand({create: "benchrun_txn"}));
+    res = benchRun({
+        ops: [
+            {
+              op: "command",
+              ns: "test",
+              command: {insert: "benchrun_txn", documents: [{x: 1}]},
+              transaction: "start"
+            },
+            {
+              op: "command",
+              ns: "test",
+              command: {insert: "benchrun_txn", documents: [{x: 2}]},
+              transaction: "continue"
+            },
+            {
+              op: "command",
+              ns: "admin",
+              command: {commitTransaction: 1},
+              transaction: "continue"
+            },
+        ],
+        parallel: 1,
+        seconds: 2,
+        useSessions: true,
+        host: primary.host,
+    });
+    jsTestLog("Transaction benchRun result: " + tojson(res));
+    assert.eq(0, res.errCount, tojson(res));
+    const numOnes = testDB.benchrun_txn.count({x: 1});
+    assert.gt(numOnes, 0);
+    assert.eq(numOnes, testDB.benchrun_txn.count({x: 2}));
+
+    // The 'transaction' field needs a session to run in.
+    assert.throws(() => benchRun({
+                      ops: [{
+                          op: "command",
+                          ns: "test",
+                          command: {ping: 1},
+                          transaction: "start",
+                      }],
+                      seconds: 1,
+                      host: primary.host,
+                  }));
+
+    rst.stopSet();
+})();
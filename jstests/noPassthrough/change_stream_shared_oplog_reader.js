@@ -0,0 +1,85 @@
+// Tests that change streams reading the oplog through the shared oplog reader return the same
+// events as with a cursor of their own, including when resuming from behind the shared buffer.
+// @tags: [requires_replication,requires_journaling]
+(function() {
+    "use strict";
+    load("jstests/replsets/rslib.js");  // For startSetIfSupportsReadMajority.
+
+    // A small buffer, so that the resumed change stream below starts behind it.
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {setParameter: {internalChangeStreamSharedOplogBufferBytes: 4096}}
+    });
+    if (!startSetIfSupportsReadMajority(rst)) {
+        jsTestLog("Skipping test since storage engine doesn't support majority read concern.");
+        rst.stopSet();
+        return;
+    }
+    rst.initiate();
+
+    const testDB = rst.getPrimary().getDB(jsTestName());
+    const collA = testDB.a;
+    const collB = testDB.b;
+    assert.commandWorked(testDB.createCollection(collA.getName()));
+    assert.commandWorked(testDB.createCollection(collB.getName()));
+
+    const explain = assert.commandWorked(collA.explain().aggregate([{$changeStream: {}}]));
+    assert(explain.stages[0].hasOwnProperty("$_internalSharedOplogScan"), tojson(explain));
+
+    // Several change streams on each collection, and one on the whole database.
+    const streamsOnA = [collA.watch(), collA.watch(), collA.watch()];
+    const streamsOnB = [collB.watch(), collB.watch()];
+    const streamOnDB = testDB.watch();
+
+    const kNumDocs = 50;
+    for (let i = 0; i < kNumDocs; ++i) {
+        assert.commandWorked(collA.insert({_id: i, padding: "x".repeat(200)}));
+        assert.commandWorked(collB.insert({_id: i}));
+    }
+    assert.commandWorked(collA.update({_id: 0}, {$set: {updated: true}}));
+
+    function assertNextEvents(stream, ns, expected) {
+        let events = [];
+        for (let event of expected) {
+            assert.soon(() => stream.hasNext());
+            const next = stream.next();
+            assert.eq(next.operationType, event.operationType, tojson(next));
+            assert.eq(next.ns.coll, ns, tojson(next));
+            assert.eq(next.documentKey, {_id: event._id}, tojson(next));
+            events.push(next);
+        }
+        return events;
+    }
+
+    const insertsInto = [...Array(kNumDocs).keys()].map(i => ({operationType: "insert", _id: i}));
+    const expectedOnA = insertsInto.concat([{operationType: "update", _id: 0}]);
+    let eventsOnA;
+    for (let stream of streamsOnA) {
+        eventsOnA = assertNextEvents(stream, collA.getName(), expectedOnA);
+    }
+    for (let stream of streamsOnB) {
+        assertNextEvents(stream, collB.getName(), insertsInto);
+    }
+
+    // The database-wide change stream sees the inserts into both collections, in order.
+    for (let i = 0; i < kNumDocs; ++i) {
+        assertNextEvents(streamOnDB, collA.getName(), [{operationType: "insert", _id: i}]);
+        assertNextEvents(streamOnDB, collB.getName(), [{operationType: "insert", _id: i}]);
+    }
+
+    // Resuming after the first insert reads the entries which are no longer buffered by itself,
+    // then continues from the buffer.
+    const resumed = collA.watch([], {resumeAfter: eventsOnA[0]._id});
+    assertNextEvents(resumed, collA.getName(), expectedOnA.slice(1));
+
+    // A drop invalidates the change streams on the collection.
+    assert(collB.drop());
+    for (let stream of streamsOnB) {
+        assert.soon(() => stream.hasNext());
+        assert.eq(stream.next().operationType, "drop");
+        assert.soon(() => stream.hasNext());
+        assert.eq(stream.next().operationType, "invalidate");
+    }
+
+    rst.stopSet();
+}());
@@ -0,0 +1,48 @@
+// Tests that with internalQueryFindFirstBatchMaxBytes set, the first batch of a find without a
+// batchSize is cut by size rather than after the default number of documents, and that an explicit
+// batchSize is still respected.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.find_first_batch_max_bytes;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, s: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function firstBatchLength(cmd) {
+        const res = assert.commandWorked(testDB.runCommand(cmd));
+        return res.cursor.firstBatch.length;
+    }
+
+    // The default first batch holds 101 documents.
+    assert.eq(101, firstBatchLength({find: coll.getName()}));
+
+    // A byte budget larger than the whole result returns everything in the first batch.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryFindFirstBatchMaxBytes: 1024 * 1024}));
+    assert.eq(1000, firstBatchLength({find: coll.getName()}));
+    assert.eq(1000, coll.find().itcount());
+
+    // A smaller budget cuts the batch once it has been reached.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryFindFirstBatchMaxBytes: 16 * 1024}));
+    const length = firstBatchLength({find: coll.getName()});
+    assert.gt(length, 101, "expected more than the default number of documents");
+    assert.lt(length, 1000, "expected the batch to be cut by size");
+    assert.eq(1000, coll.find().itcount());
+
+    // An explicit batchSize is respected.
+    assert.eq(10, firstBatchLength({find: coll.getName(), batchSize: 10}));
+
+    assert.commandFailedWithCode(
+        testDB.adminCommand({setParameter: 1, internalQueryFindFirstBatchMaxBytes: -1}),
+        ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,53 @@
+// Tests that a blocking sort in a find command spills to disk when 'allowDiskUse' is set, and fails
+// with the usual error when it is not.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: "internalQueryExecMaxBlockingSortBytes=" + 100 * 1024});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.find_sort_allow_disk_use;
+
+    const bigStr = "x".repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({a: (i * 7) % 500, s: bigStr});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Without allowDiskUse the sort exceeds its memory limit.
+    assert.commandFailedWithCode(testDB.runCommand({find: coll.getName(), sort: {a: 1}}),
+                                 ErrorCodes.OperationFailed);
+
+    // With allowDiskUse the results come back in order, across getMores.
+    let res = assert.commandWorked(testDB.runCommand(
+        {find: coll.getName(), sort: {a: 1}, batchSize: 50, allowDiskUse: true}));
+    let results = new DBCommandCursor(testDB, res).toArray();
+    assert.eq(500, results.length);
+    for (let i = 0; i < results.length; ++i) {
+        assert.eq(i, results[i].a, tojson(results[i]));
+    }
+
+    // The same holds for a top-k sort whose results do not fit in memory.
+    res = assert.commandWorked(testDB.runCommand(
+        {find: coll.getName(), sort: {a: -1}, limit: 200, allowDiskUse: true}));
+    results = new DBCommandCursor(testDB, res).toArray();
+    assert.eq(200, results.length);
+    for (let i = 0; i < results.length; ++i) {
+        assert.eq(499 - i, results[i].a, tojson(results[i]));
+    }
+
+    const explain = assert.commandWorked(testDB.runCommand({
+        explain: {find: coll.getName(), sort: {a: 1}, allowDiskUse: true},
+        verbosity: "executionStats"
+    }));
+    const sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+    assert.neq(null, sortStage, tojson(explain));
+    assert.eq(true, sortStage.usedDisk, tojson(explain));
+    assert.gt(sortStage.spills, 0, tojson(explain));
+
+    MongoRunner.stopMongod(conn);
+}());
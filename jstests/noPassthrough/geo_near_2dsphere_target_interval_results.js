@@ -0,0 +1,71 @@
+// Tests that a 2dsphere $near search which sizes its annuli from the density of the documents it
+// found returns the same results, and needs fewer annuli when the documents are sparse.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.geo_near_2dsphere_target_interval_results;
+
+    // A dense cluster around the origin and sparse points further away.
+    const bulk = coll.initializeUnorderedBulkOp();
+    let id = 0;
+    for (let i = 0; i < 40; ++i) {
+        for (let j = 0; j < 40; ++j) {
+            bulk.insert({_id: id++, loc: {type: "Point", coordinates: [i * 0.001, j * 0.001]}});
+        }
+    }
+    for (let i = 1; i <= 200; ++i) {
+        bulk.insert({_id: id++, loc: {type: "Point", coordinates: [i * 0.7 - 70, i * 0.31 - 31]}});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({loc: "2dsphere"}));
+
+    function setTargetResults(value) {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalGeoNearQuery2DSphereTargetIntervalResults: value}));
+    }
+
+    // Returns the distances of the 'limit' nearest documents, which don't depend on the order in
+    // which documents at equal distances are returned, and the number of annuli searched.
+    function near(point, limit) {
+        const geometry = {type: "Point", coordinates: point};
+        const distances =
+            coll.aggregate([
+                    {$geoNear: {near: geometry, distanceField: "dist", spherical: true}},
+                    {$limit: limit}
+                ])
+                .toArray()
+                .map(doc => doc.dist);
+        const explain =
+            coll.find({loc: {$near: {$geometry: geometry}}}).limit(limit).explain("executionStats");
+        const nearStage = getPlanStage(explain.executionStats.executionStages, "GEO_NEAR_2DSPHERE");
+        assert.neq(null, nearStage, tojson(explain));
+        return {distances: distances, numIntervals: nearStage.searchIntervals.length};
+    }
+
+    for (let [point, limit] of [[[0.02, 0.02], 1800], [[0.02, 0.02], 10], [[-60, -60], 50]]) {
+        setTargetResults(0);
+        const fixed = near(point, limit);
+        setTargetResults(300);
+        const adaptive = near(point, limit);
+        assert.eq(limit, adaptive.distances.length);
+        assert.eq(fixed.distances, adaptive.distances);
+    }
+
+    // Far from any document, the adaptive search widens its annuli faster.
+    setTargetResults(0);
+    const fixed = near([-170, -80], 5);
+    setTargetResults(300);
+    const adaptive = near([-170, -80], 5);
+    assert.lte(adaptive.numIntervals, fixed.numIntervals, tojson({fixed, adaptive}));
+
+    assert.commandFailedWithCode(
+        db.adminCommand({setParameter: 1, internalGeoNearQuery2DSphereTargetIntervalResults: -1}),
+        ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+}());
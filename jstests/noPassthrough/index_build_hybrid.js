@@ -0,0 +1,82 @@
+// Tests that a hybrid background index build, which sets aside the writes made while it scans the
+// collection, builds an index which reflects those writes.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/index_build.js");
+
+    const conn = MongoRunner.runMongod({setParameter: "internalIndexBuildHybrid=true"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.index_build_hybrid;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Runs 'writes' while a background build of 'spec' is held after its collection scan, and
+    // returns the function which waits for the build to finish.
+    function buildIndexWhileWriting(spec, options, expectedCode, writes) {
+        assert.commandWorked(testDB.adminCommand(
+            {configureFailPoint: "hangAfterStartingIndexBuild", mode: "alwaysOn"}));
+        const awaitBuild = startParallelShell(
+            "const res = db.getSiblingDB('test').index_build_hybrid.createIndex(" + tojson(spec) +
+                ", " + tojson(Object.extend({background: true}, options)) + ");" +
+                (expectedCode ? "assert.commandFailedWithCode(res, " + expectedCode + ");"
+                              : "assert.commandWorked(res);"),
+            conn.port);
+        assert.soon(function() {
+            return getIndexBuildOpId(testDB) != -1;
+        }, "Index build operation not found after starting via parallelShell");
+
+        writes();
+
+        assert.commandWorked(
+            testDB.adminCommand({configureFailPoint: "hangAfterStartingIndexBuild", mode: "off"}));
+        assert.eq(0, awaitBuild(), "expected shell to exit cleanly");
+    }
+
+    buildIndexWhileWriting({a: 1}, {}, null, function() {
+        for (let i = 1000; i < 1100; ++i) {
+            assert.writeOK(coll.insert({_id: i, a: i}));
+        }
+        for (let i = 0; i < 100; ++i) {
+            assert.writeOK(coll.update({_id: i}, {$set: {a: [i + 10000, -i]}}));
+        }
+        assert.writeOK(coll.remove({_id: {$gte: 100, $lt: 200}}));
+    });
+
+    const validation = assert.commandWorked(coll.validate(true));
+    assert(validation.valid, tojson(validation));
+    // The updated documents became multikey, with two keys each.
+    assert.eq(1000 + 100,
+              validation.keysPerIndex[coll.getFullName() + ".$a_1"],
+              tojson(validation));
+    assert.eq(1, coll.find({a: 1050}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 5}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 10005}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({a: -5}).hint({a: 1}).itcount());
+    assert.eq(0, coll.find({a: 150}).hint({a: 1}).itcount());
+
+    // A key which more than one document held during the build does not fail a unique index build
+    // as long as it is unique once the build commits. The indexes are sparse since most documents
+    // have neither field.
+    const uniqueOptions = {unique: true, sparse: true};
+    buildIndexWhileWriting({b: 1}, uniqueOptions, null, function() {
+        assert.writeOK(coll.insert({_id: "dup1", b: "dup"}));
+        assert.writeOK(coll.insert({_id: "dup2", b: "dup"}));
+        assert.writeOK(coll.remove({_id: "dup1"}));
+    });
+    assert.writeError(coll.insert({_id: "dup3", b: "dup"}));
+
+    // A duplicate key which is still there when the build commits fails it.
+    buildIndexWhileWriting({c: 1}, uniqueOptions, ErrorCodes.DuplicateKey, function() {
+        assert.writeOK(coll.insert({_id: "dup4", c: "dup"}));
+        assert.writeOK(coll.insert({_id: "dup5", c: "dup"}));
+    });
+    assert.eq(3, coll.getIndexes().length);
+
+    MongoRunner.stopMongod(conn);
+}());
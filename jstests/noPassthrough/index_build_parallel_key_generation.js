@@ -0,0 +1,36 @@
+// Tests that a foreground build of several indexes which generates their keys on multiple threads
+// builds the same indexes as a serial build.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: "internalIndexBuildKeyGenerationThreads=4"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const coll = conn.getDB("test").index_build_parallel_key_generation;
+
+    // Use enough documents to fill several batches of the key generator.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: i % 7, b: [i, -i], c: "str" + i, d: (i % 2 === 0) ? i : null});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(coll.createIndexes([{a: 1}, {b: 1}, {c: -1, a: 1}, {d: 1}]));
+
+    const validation = assert.commandWorked(coll.validate(true));
+    assert(validation.valid, tojson(validation));
+    // Each document has two keys in the multikey index, except for {_id: 0}, whose are equal.
+    assert.eq(5000 * 2 - 1,
+              validation.keysPerIndex[coll.getFullName() + ".$b_1"],
+              tojson(validation));
+
+    assert.eq(714, coll.find({a: 3}).hint({a: 1}).itcount());
+    assert.eq(1, coll.find({b: -42}).hint({b: 1}).itcount());
+    assert.eq(2500, coll.find({d: null}).hint({d: 1}).itcount());
+
+    // A unique index still fails to build if there are duplicate keys.
+    assert.writeOK(coll.insert({_id: 5000, c: "str0"}));
+    assert.commandFailedWithCode(coll.createIndexes([{c: 1, e: 1}, {e: 1, c: 1}], {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,43 @@
+// Tests that batches of inserts whose index keys are inserted in each index's key order leave the
+// same indexes as inserting them document by document.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {indexSortedInsertMinBatchSize: 2}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.index_sorted_insert;
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: -1}, {unique: true}));
+    assert.commandWorked(coll.createIndex({c: 1}));
+    assert.commandWorked(coll.createIndex({d: 1}, {partialFilterExpression: {a: {$gte: 50}}}));
+
+    let docs = [];
+    for (let i = 0; i < 100; ++i) {
+        const x = (i * 37) % 100;
+        docs.push({_id: i, a: x, b: -x, c: [x, x + 1], d: i});
+    }
+    assert.commandWorked(coll.insert(docs));
+
+    assert.eq(100, coll.find({a: {$gte: 0}}).hint({a: 1}).itcount());
+    assert.eq(
+        [0, -1, -2], coll.find({}, {_id: 0, b: 1}).hint({b: -1}).limit(3).toArray().map(d => d.b));
+    assert.eq(2, coll.find({c: 10}).hint({c: 1}).itcount());
+    assert.eq(50, coll.find({a: {$gte: 50}, d: {$gte: 0}}).hint({d: 1}).itcount());
+    assert(coll.explain().find({c: 10}).hint({c: 1}).finish().queryPlanner.winningPlan.inputStage
+               .isMultiKey);
+
+    // A duplicate key fails only its own document, and leaves no keys of it in any index.
+    const res = coll.insert([{_id: 100, a: 100, b: 1}, {_id: 101, a: 101, b: 0}, {_id: 102, b: 2}],
+                            {ordered: false});
+    assert.eq(2, res.nInserted, tojson(res));
+    assert.eq(1, res.getWriteErrors().length, tojson(res));
+    assert.eq(ErrorCodes.DuplicateKey, res.getWriteErrors()[0].code, tojson(res));
+    assert.eq(0, coll.find({a: 101}).hint({a: 1}).itcount());
+
+    const validateRes = assert.commandWorked(coll.validate(true));
+    assert(validateRes.valid, tojson(validateRes));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,51 @@
+// Tests that mapReduce jobs reusing a scope from the per-thread scope cache see their own functions
+// and scope variables rather than those of a previous job on the same connection.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {scriptingEngineThreadScopeCacheSize: 1}});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.mapreduce_thread_scope_cache;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({_id: i, key: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+
+    const reduce = function(key, values) {
+        return Array.sum(values);
+    };
+
+    function runMapReduce(map, scope) {
+        const res = assert.commandWorked(testDB.runCommand({
+            mapReduce: coll.getName(),
+            map: map,
+            reduce: reduce,
+            out: {inline: 1},
+            scope: scope,
+        }));
+        let results = {};
+        res.results.forEach(function(result) {
+            results[result._id] = result.value;
+        });
+        return results;
+    }
+
+    // The same job run repeatedly, with a different scope variable each time.
+    for (let factor = 1; factor <= 3; ++factor) {
+        assert.eq({0: 50 * factor, 1: 50 * factor}, runMapReduce(function() {
+            emit(this.key, factor);
+        }, {factor: factor}));
+    }
+
+    // A different map function on the same connection.
+    assert.eq({0: 50}, runMapReduce(function() {
+        if (this.key === 0) {
+            emit(this.key, 1);
+        }
+    }, {}));
+
+    MongoRunner.stopMongod(conn);
+})();
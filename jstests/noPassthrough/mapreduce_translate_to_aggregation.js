@@ -0,0 +1,72 @@
+// Tests that mapReduce jobs run as an aggregation with mapReduceTranslateToAggregation return the
+// same results as when they run in JavaScript, and that jobs the aggregation cannot run identically
+// still run in JavaScript.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+    const coll = testDB.mapreduce_translate_to_aggregation;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, key: i % 7, amount: NumberInt(i), fraction: i / 4});
+    }
+    bulk.insert({_id: 1000, key: "single", amount: 5});
+    assert.writeOK(bulk.execute());
+
+    const reduce = function(key, values) {
+        return Array.sum(values);
+    };
+
+    function runMapReduce(cmd, translate) {
+        assert.commandWorked(
+            adminDB.runCommand({setParameter: 1, mapReduceTranslateToAggregation: translate}));
+        const res = assert.commandWorked(testDB.runCommand(Object.extend(
+            {mapReduce: coll.getName(), reduce: reduce, out: {inline: 1}, verbose: true}, cmd)));
+        return res;
+    }
+
+    function assertSameResults(cmd, expectTranslated) {
+        const fromJS = runMapReduce(cmd, false);
+        const fromAgg = runMapReduce(cmd, true);
+        assert.eq(fromJS.results, fromAgg.results, tojson(fromAgg));
+        assert.eq(fromJS.counts.input, fromAgg.counts.input, tojson(fromAgg));
+        assert.eq(fromJS.counts.output, fromAgg.counts.output, tojson(fromAgg));
+        assert.eq(expectTranslated, fromAgg.timing.mode === "aggregation", tojson(fromAgg));
+    }
+
+    const countByKey = function() {
+        emit(this.key, 1);
+    };
+    const sumAmountByKey = function() {
+        emit(this.key, this.amount);
+    };
+    const sumFractionByKey = function() {
+        emit(this.key, this.fraction);
+    };
+
+    // Counts and sums by key.
+    assertSameResults({map: countByKey}, true);
+    assertSameResults({map: sumAmountByKey}, true);
+    assertSameResults({map: sumFractionByKey, query: {_id: {$lt: 500}}, sort: {_id: 1}, limit: 100},
+                      true);
+
+    // A non-numeric value makes the job run in JavaScript.
+    assert.writeOK(coll.insert({_id: 1001, key: 0, amount: "text"}));
+    assertSameResults({map: sumAmountByKey}, false);
+
+    // So does a map function that is not a single emit.
+    assertSameResults({
+        map: function() {
+            if (this.key === 0) {
+                emit(this.key, 1);
+            }
+        }
+    },
+                      false);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,66 @@
+/**
+ * Tests that the CPU time used by an operation is reported in currentOp, the profiler and the slow
+ * query log, on platforms where thread CPU time can be measured.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.operation_cpu_time;
+
+    if (testDB.hostInfo().os.type != "Linux") {
+        jsTestLog("Skipping test, thread CPU time is only measured on Linux");
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    assert.writeOK(coll.insert({_id: 1}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    // Spins in the server for about 200ms, which is well over the default slowms.
+    const spinQuery = {
+        $where: function() {
+            const start = Date.now();
+            while (Date.now() - start < 200) {
+            }
+            return true;
+        },
+        comment: "operation_cpu_time"
+    };
+    assert.eq(1, coll.find(spinQuery).itcount());
+
+    const profileEntry =
+        testDB.system.profile.find({"command.comment": "operation_cpu_time"}).next();
+    assert.gte(profileEntry.cpuTimeMicros, 100 * 1000, tojson(profileEntry));
+    assert.lte(profileEntry.cpuTimeMicros, profileEntry.millis * 1000 + 1000, tojson(profileEntry));
+
+    checkLog.contains(conn, /comment: "operation_cpu_time".* cpuTimeMicros:\d+/);
+
+    // A running operation reports the CPU time it has used so far.
+    assert.commandWorked(testDB.setProfilingLevel(0));
+    const awaitShell = startParallelShell(function() {
+        assert.eq(1,
+                  db.getSiblingDB("test")
+                      .operation_cpu_time
+                      .find({
+                          $where: function() {
+                              sleep(3000);
+                              return true;
+                          },
+                          comment: "operation_cpu_time_running"
+                      })
+                      .itcount());
+    }, conn.port);
+
+    assert.soon(function() {
+        const ops = testDB.currentOp({"command.comment": "operation_cpu_time_running"}).inprog;
+        return ops.length === 1 && ops[0].hasOwnProperty("cpuTimeMicros");
+    }, () => tojson(testDB.currentOp()));
+
+    awaitShell();
+    MongoRunner.stopMongod(conn);
+}());
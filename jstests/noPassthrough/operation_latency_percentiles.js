@@ -0,0 +1,57 @@
+// Checks the latency percentiles over the last minute reported by serverStatus, globally and per
+// command, and by $collStats per namespace when trackNamespaceLatencyPercentiles is set.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {trackNamespaceLatencyPercentiles: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.operation_latency_percentiles;
+
+    for (let i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+
+    // Each of these reads takes at least 100ms.
+    for (let i = 0; i < 3; i++) {
+        assert.eq(1,
+                  coll.find({
+                          _id: 0,
+                          $where: function() {
+                              sleep(100);
+                              return true;
+                          }
+                      })
+                      .itcount());
+    }
+
+    const percentiles = testDB.serverStatus().opLatencyPercentiles;
+    assert.eq(60 * 1000, percentiles.windowMillis, tojson(percentiles));
+    assert.gte(percentiles.writes.ops, 10, tojson(percentiles));
+    assert.gte(percentiles.reads.ops, 3, tojson(percentiles));
+    assert.gte(percentiles.reads.p99, 99 * 1000, tojson(percentiles));
+    assert.lte(percentiles.reads.p50, percentiles.reads.p99, tojson(percentiles));
+    assert.lte(percentiles.reads.p99, percentiles.reads.p999, tojson(percentiles));
+
+    assert.gte(percentiles.byCommand.insert.ops, 10, tojson(percentiles));
+    assert.gte(percentiles.byCommand.find.ops, 3, tojson(percentiles));
+    assert.gte(percentiles.byCommand.find.p50, 99 * 1000, tojson(percentiles));
+    assert(!percentiles.byCommand.hasOwnProperty("mapReduce"), tojson(percentiles));
+
+    const latencyStats =
+        coll.aggregate([{$collStats: {latencyStats: {}}}]).next().latencyStats;
+    assert.eq(10, latencyStats.percentiles.writes.ops, tojson(latencyStats));
+    assert.eq(3, latencyStats.percentiles.reads.ops, tojson(latencyStats));
+    assert.gte(latencyStats.percentiles.reads.p50, 99 * 1000, tojson(latencyStats));
+
+    // Namespaces used while the parameter is off have no percentiles.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, trackNamespaceLatencyPercentiles: false}));
+    const otherColl = testDB.operation_latency_percentiles_other;
+    assert.writeOK(otherColl.insert({_id: 0}));
+    const otherLatencyStats =
+        otherColl.aggregate([{$collStats: {latencyStats: {}}}]).next().latencyStats;
+    assert(!otherLatencyStats.hasOwnProperty("percentiles"), tojson(otherLatencyStats));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,54 @@
+// Checks that the bytes an operation reads from the storage engine, and the time it spends in
+// storage engine reads while trackOperationStorageReadTime is set, are reported by the profiler and
+// aggregated per namespace by the top command.
+// @tags: [requires_wiredtiger, requires_profiling]
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.operation_storage_stats;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; i++) {
+        bulk.insert({_id: i, padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    assert.eq(100, coll.find({}).comment("untimed").itcount());
+    assert.eq(1, coll.find({_id: 50}).comment("point").itcount());
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, trackOperationStorageReadTime: true}));
+    assert.eq(100, coll.find({}).comment("timed").itcount());
+    assert.commandWorked(testDB.setProfilingLevel(0));
+
+    function getProfileEntry(comment) {
+        const entry = testDB.system.profile.findOne({"command.comment": comment});
+        assert.neq(null, entry, comment);
+        return entry;
+    }
+
+    // The collection scan reads every record.
+    let entry = getProfileEntry("untimed");
+    assert.gte(entry.storageBytesRead, 100 * 100, tojson(entry));
+    assert(!entry.hasOwnProperty("storageTimeReadingMicros"), tojson(entry));
+
+    // The point read reads an index key and a record.
+    entry = getProfileEntry("point");
+    assert.gt(entry.storageBytesRead, 100, tojson(entry));
+    assert.lt(entry.storageBytesRead, 1000, tojson(entry));
+
+    entry = getProfileEntry("timed");
+    assert.gte(entry.storageBytesRead, 100 * 100, tojson(entry));
+    assert.gte(entry.storageTimeReadingMicros, 0, tojson(entry));
+
+    const top = assert.commandWorked(testDB.adminCommand({top: 1}));
+    const storage = top.totals[coll.getFullName()].storage;
+    assert.gte(storage.bytesRead, 2 * 100 * 100, tojson(storage));
+    assert.gte(storage.timeReadingMicros, 0, tojson(storage));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,56 @@
+// Tests that count commands answered by a collection scan return the same results when the scan is
+// split into RecordId ranges and run on worker threads.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalQueryParallelCollectionScanMaxRanges: 4,
+            internalQueryParallelCollectionScanMinRecords: 100
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.parallel_count_collection_scan;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: i % 10, s: (i % 2 === 0) ? "even" : "ODD"});
+    }
+    assert.writeOK(bulk.execute());
+
+    function assertCount(expected, cmd) {
+        const res =
+            assert.commandWorked(testDB.runCommand(Object.merge({count: coll.getName()}, cmd)));
+        assert.eq(expected, res.n, tojson(cmd));
+    }
+
+    assertCount(500, {query: {a: 3}});
+    assertCount(2500, {query: {a: {$lt: 5}}});
+    assertCount(0, {query: {a: 11}});
+    assertCount(2000, {query: {a: {$lt: 5}}, skip: 500});
+    assertCount(100, {query: {a: {$lt: 5}}, limit: 100});
+    assertCount(100, {query: {a: {$lt: 5}}, limit: -100});
+    assertCount(0, {query: {a: 3}, skip: 1000});
+    assertCount(2500, {query: {s: "odd"}, collation: {locale: "en_US", strength: 2}});
+    assertCount(1000, {query: {$expr: {$lt: ["$a", 2]}}});
+
+    // Removing documents, including ones that may have been chosen as range boundaries, must not
+    // change the results of later counts.
+    assert.writeOK(coll.remove({_id: {$mod: [7, 0]}}));
+    let expected = 0;
+    for (let i = 0; i < 5000; ++i) {
+        if (i % 7 !== 0 && i % 10 === 3) {
+            ++expected;
+        }
+    }
+    assertCount(expected, {query: {a: 3}});
+    assertCount(5000 - 715, {query: {a: {$gte: 0}}});
+
+    // With an index the count does not use a collection scan, but the answer is the same.
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assertCount(expected, {query: {a: 3}});
+    assertCount(expected, {query: {a: 3}, hint: {$natural: 1}});
+
+    MongoRunner.stopMongod(conn);
+}());
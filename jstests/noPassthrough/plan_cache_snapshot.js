@@ -0,0 +1,101 @@
+/**
+ * Tests that the planCacheSnapshot command saves a collection's active plan cache entries and
+ * index filters, and that they are restored after a restart when
+ * internalQueryPlanCacheRestoreFromSnapshot is enabled.
+ *
+ * This test requires persistence to ensure data survives a restart.
+ * @tags: [requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    const dbpath = MongoRunner.dataPath + '_plan_cache_snapshot';
+    resetDbpath(dbpath);
+
+    let conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, 'mongod was unable to start up');
+
+    let coll = conn.getDB('test').plan_cache_snapshot;
+    for (let i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert({a: i, b: i % 10, c: i % 3}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    assert.commandWorked(coll.createIndex({c: 1}));
+
+    const cachedQuery = {a: 5, b: 5};
+    const filteredQuery = {b: 2, c: 2};
+
+    function getPlans(query) {
+        return assert.commandWorked(coll.runCommand('planCacheListPlans', {query: query}));
+    }
+
+    // Running the query twice creates an active plan cache entry.
+    assert.eq(1, coll.find(cachedQuery).itcount());
+    assert.eq(1, coll.find(cachedQuery).itcount());
+    assert.eq(true, getPlans(cachedQuery).isActive);
+    assert.commandWorked(
+        coll.runCommand('planCacheSetFilter', {query: filteredQuery, indexes: [{c: 1}]}));
+
+    // Snapshots need an existing collection.
+    assert.commandFailedWithCode(conn.getDB('test').runCommand({planCacheSnapshot: 'missing'}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    let res = assert.commandWorked(coll.runCommand('planCacheSnapshot'));
+    assert.eq(2, res.entries, tojson(res));
+    assert.eq(2,
+              conn.getDB('config').planCacheSnapshots.find({ns: coll.getFullName()}).itcount());
+
+    // Snapshotting again replaces the earlier snapshot.
+    res = assert.commandWorked(coll.runCommand('planCacheSnapshot'));
+    assert.eq(2, res.entries, tojson(res));
+    assert.eq(2,
+              conn.getDB('config').planCacheSnapshots.find({ns: coll.getFullName()}).itcount());
+
+    // Restart with restoring enabled. The snapshot is loaded by the first query on the collection.
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({
+        dbpath: dbpath,
+        noCleanData: true,
+        setParameter: {internalQueryPlanCacheRestoreFromSnapshot: true}
+    });
+    assert.neq(null, conn, 'mongod was unable to restart');
+    coll = conn.getDB('test').plan_cache_snapshot;
+
+    assert.eq(0, getPlans(cachedQuery).plans.length);
+    assert.eq(10, coll.find({b: 3}).itcount());
+
+    res = getPlans(cachedQuery);
+    assert.eq(1, res.plans.length, tojson(res));
+    assert.eq(true, res.isActive, tojson(res));
+    assert.eq(true, res.restoredFromSnapshot, tojson(res));
+
+    res = assert.commandWorked(coll.runCommand('planCacheListFilters'));
+    assert.eq(1, res.filters.length, tojson(res));
+    assert.eq(filteredQuery, res.filters[0].query, tojson(res));
+    assert.eq([{c: 1}], res.filters[0].indexes, tojson(res));
+
+    // The restored plan answers the query.
+    assert.eq(1, coll.find(cachedQuery).itcount());
+
+    // Plans using an index which no longer exists are not restored.
+    assert.commandWorked(coll.runCommand('planCacheSnapshot'));
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, 'mongod was unable to restart');
+    coll = conn.getDB('test').plan_cache_snapshot;
+    assert.commandWorked(coll.dropIndex({a: 1}));
+    assert.commandWorked(coll.dropIndex({b: 1}));
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod({
+        dbpath: dbpath,
+        noCleanData: true,
+        setParameter: {internalQueryPlanCacheRestoreFromSnapshot: true}
+    });
+    assert.neq(null, conn, 'mongod was unable to restart');
+    coll = conn.getDB('test').plan_cache_snapshot;
+    assert.eq(34, coll.find({c: 0}).itcount());
+    assert.eq(0, getPlans(cachedQuery).plans.length);
+    MongoRunner.stopMongod(conn);
+}());
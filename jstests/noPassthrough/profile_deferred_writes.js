@@ -0,0 +1,32 @@
+// Tests that with deferProfilerWrites set, profiler entries are written to system.profile by a
+// background writer, which creates the capped profile collection when it does not exist.
+// @tags: [requires_profiling]
+
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: "deferProfilerWrites=true"});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("profile_deferred_writes");
+    const coll = testDB.getCollection("coll");
+    assert.writeOK(coll.insert({a: 1}));
+
+    testDB.setProfilingLevel(2);
+    testDB.system.profile.drop();
+
+    const numFinds = 50;
+    for (let i = 0; i < numFinds; ++i) {
+        assert.eq(1, coll.find({a: 1}).comment("deferred_" + i).itcount());
+    }
+
+    assert.soon(function() {
+        return testDB.system.profile.find({"command.comment": /^deferred_/}).itcount() ===
+            numFinds;
+    }, "profiler entries were not written");
+
+    const profileInfo = testDB.getCollectionInfos({name: "system.profile"})[0];
+    assert(profileInfo.options.capped, tojson(profileInfo));
+
+    MongoRunner.stopMongod(conn);
+})();
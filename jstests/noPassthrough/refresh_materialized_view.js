@@ -0,0 +1,108 @@
+/**
+ * Tests that refreshMaterializedView materializes a view into a collection, and that later
+ * refreshes only recompute the documents changed since the previous one when the view allows it.
+ */
+(function() {
+    "use strict";
+
+    // Skip this test if running with --nojournal and WiredTiger.
+    if (jsTest.options().noJournal &&
+        (!jsTest.options().storageEngine || jsTest.options().storageEngine === "wiredTiger")) {
+        print("Skipping test because running WiredTiger without journaling isn't a valid" +
+              " replica set configuration");
+        return;
+    }
+
+    const rst = new ReplSetTest({name: "refreshMaterializedView", nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    const testDB = rst.getPrimary().getDB("test");
+    const coll = testDB.source;
+    assert.commandWorked(coll.insert([{_id: 1, x: 1, g: "a"}, {_id: 2, x: 5, g: "b"}]));
+
+    function refresh(view, into, extra) {
+        const res = assert.commandWorked(testDB.runCommand(
+            Object.extend({refreshMaterializedView: view, into: into}, extra || {})));
+        return res;
+    }
+
+    function assertMaterialized(view, into) {
+        assert.sameMembers(testDB[view].find().toArray(), testDB[into].find().toArray());
+    }
+
+    // A view which maps each document to at most one document is refreshed document by document.
+    assert.commandWorked(testDB.createView(
+        "perDocument", coll.getName(), [{$match: {x: {$gt: 2}}}, {$addFields: {y: "$x"}}]));
+    assert.eq("full", refresh("perDocument", "perDocumentResults").mode);
+    assertMaterialized("perDocument", "perDocumentResults");
+
+    assert.commandWorked(coll.insert({_id: 3, x: 10, g: "a"}));
+    assert.commandWorked(coll.update({_id: 2}, {$set: {x: 0}}));
+    assert.commandWorked(coll.update({_id: 1}, {$set: {x: 3}}));
+    let res = refresh("perDocument", "perDocumentResults");
+    assert.eq("incremental", res.mode);
+    assert.eq(3, res.changed);
+    assertMaterialized("perDocument", "perDocumentResults");
+
+    assert.commandWorked(coll.remove({_id: 3}));
+    assert.eq("incremental", refresh("perDocument", "perDocumentResults").mode);
+    assertMaterialized("perDocument", "perDocumentResults");
+
+    // Nothing changed, so nothing is recomputed.
+    res = refresh("perDocument", "perDocumentResults");
+    assert.eq("incremental", res.mode);
+    assert.eq(0, res.changed);
+
+    // A full refresh can be requested.
+    assert.eq("full", refresh("perDocument", "perDocumentResults", {full: true}).mode);
+    assertMaterialized("perDocument", "perDocumentResults");
+
+    // A trailing $group with $sum, $min and $max folds in inserted documents.
+    assert.commandWorked(testDB.createView(
+        "grouped",
+        coll.getName(),
+        [{$group: {_id: "$g", total: {$sum: "$x"}, lo: {$min: "$x"}, hi: {$max: "$x"}}}]));
+    assert.eq("full", refresh("grouped", "groupedResults").mode);
+    assertMaterialized("grouped", "groupedResults");
+
+    assert.commandWorked(coll.insert([{_id: 4, x: 7, g: "a"}, {_id: 5, x: -1, g: "c"}]));
+    assert.eq("incremental", refresh("grouped", "groupedResults").mode);
+    assertMaterialized("grouped", "groupedResults");
+
+    // Updates cannot be folded into a $group, so the whole pipeline is rerun.
+    assert.commandWorked(coll.update({_id: 4}, {$set: {x: 2}}));
+    assert.eq("full", refresh("grouped", "groupedResults").mode);
+    assertMaterialized("grouped", "groupedResults");
+
+    // Other pipelines are always rerun in full.
+    assert.commandWorked(
+        testDB.createView("sorted", coll.getName(), [{$sort: {x: 1}}, {$limit: 2}]));
+    assert.eq("full", refresh("sorted", "sortedResults").mode);
+    assert.commandWorked(coll.insert({_id: 6, x: -5, g: "a"}));
+    assert.eq("full", refresh("sorted", "sortedResults").mode);
+    assertMaterialized("sorted", "sortedResults");
+
+    // Changing the view's definition requires a full refresh.
+    assert.commandWorked(
+        testDB.runCommand({collMod: "perDocument", viewOn: coll.getName(), pipeline: []}));
+    assert.eq("full", refresh("perDocument", "perDocumentResults").mode);
+    assertMaterialized("perDocument", "perDocumentResults");
+
+    // Dropping the backing collection requires a full refresh.
+    assert(testDB.perDocumentResults.drop());
+    assert.eq("full", refresh("perDocument", "perDocumentResults").mode);
+    assertMaterialized("perDocument", "perDocumentResults");
+
+    // Only views can be materialized, and not into the namespace they read from.
+    assert.commandFailedWithCode(
+        testDB.runCommand({refreshMaterializedView: coll.getName(), into: "x"}),
+        ErrorCodes.CommandNotSupportedOnView);
+    assert.commandFailedWithCode(
+        testDB.runCommand({refreshMaterializedView: "perDocument", into: coll.getName()}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(testDB.runCommand({refreshMaterializedView: "perDocument"}),
+                                 ErrorCodes.BadValue);
+
+    rst.stopSet();
+}());
@@ -0,0 +1,69 @@
+// Checks that sampleCpuProfile returns folded stacks of the operations using CPU, and that a
+// profile is taken automatically when the p99 latency exceeds
+// automaticCpuProfileP99ThresholdMillis.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDB = conn.getDB("admin");
+    const testDB = conn.getDB("test");
+    const coll = testDB.sample_cpu_profile;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10 * 1000; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandFailedWithCode(adminDB.runCommand({sampleCpuProfile: 1, durationSecs: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(adminDB.runCommand({sampleCpuProfile: 1, frequencyHz: 100000}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(testDB.runCommand({sampleCpuProfile: 1}), ErrorCodes.Unauthorized);
+    assert.commandFailedWithCode(adminDB.runCommand({sampleCpuProfile: 1, lastAutomatic: true}),
+                                 ErrorCodes.NoSuchKey);
+
+    // Collection scans keep the thread running the find busy while the profiler samples.
+    const awaitReads = startParallelShell(function() {
+        const coll = db.getSiblingDB("test").sample_cpu_profile;
+        const end = Date.now() + 5 * 1000;
+        while (Date.now() < end) {
+            assert.eq(0, coll.find({x: {$lt: 0}}).itcount());
+        }
+    }, conn.port);
+
+    let res = assert.commandWorked(
+        adminDB.runCommand({sampleCpuProfile: 1, durationSecs: 2, frequencyHz: 200}));
+    awaitReads();
+
+    assert.eq(200, res.frequencyHz, tojson(res));
+    assert.gt(res.samples, 0, tojson(res));
+    assert.lte(res.startTime, res.endTime, tojson(res));
+    assert(res.stacks.some(stack => stack.startsWith("find:test.sample_cpu_profile;")),
+           tojson(res));
+    res.stacks.forEach(stack => assert(/ \d+$/.test(stack), stack));
+
+    res = assert.commandWorked(
+        adminDB.runCommand({sampleCpuProfile: 1, durationSecs: 1, maxStacks: 1}));
+    assert.lte(res.stacks.length, 1, tojson(res));
+
+    // This read takes longer than the threshold.
+    assert.commandWorked(
+        adminDB.runCommand({setParameter: 1, automaticCpuProfileP99ThresholdMillis: 1}));
+    assert.eq(1,
+              coll.find({
+                      _id: 0,
+                      $where: function() {
+                          sleep(100);
+                          return true;
+                      }
+                  })
+                  .itcount());
+    assert.soon(function() {
+        res = adminDB.runCommand({sampleCpuProfile: 1, lastAutomatic: true});
+        return res.ok;
+    }, "no automatic profile was taken", 60 * 1000);
+    assert.eq(100, res.frequencyHz, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+})();
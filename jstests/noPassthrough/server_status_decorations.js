@@ -0,0 +1,31 @@
+// Tests that the "decorations" serverStatus section lists the decorations of the decorated types
+// and is only reported when requested.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const adminDB = conn.getDB("admin");
+
+    let res = assert.commandWorked(adminDB.runCommand({serverStatus: 1}));
+    assert(!res.hasOwnProperty("decorations"), tojson(res));
+
+    res = assert.commandWorked(adminDB.runCommand({serverStatus: 1, decorations: 1}));
+    for (let type of ["ServiceContext", "Client", "OperationContext"]) {
+        const section = res.decorations[type];
+        assert(section, tojson(res.decorations));
+        assert.gt(section.bufferBytes, section.hotBytes, tojson(section));
+        assert.gt(section.decorations.length, 0, tojson(section));
+        for (let decoration of section.decorations) {
+            assert.eq(decoration.hot, decoration.offset < 0, tojson(decoration));
+        }
+    }
+
+    // The read concern arguments are looked up on every operation, so they are declared hot.
+    const readConcernArgs = res.decorations.OperationContext.decorations.filter(
+        decoration => decoration.type === "mongo::repl::ReadConcernArgs");
+    assert.eq(1, readConcernArgs.length, tojson(res.decorations.OperationContext));
+    assert(readConcernArgs[0].hot, tojson(readConcernArgs));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,23 @@
+// Tests that serverStatus reports how long each phase of mongod startup took.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const timings = assert.commandWorked(conn.adminCommand({serverStatus: 1})).startupTimings;
+    assert.neq(undefined, timings);
+    assert.gte(timings.totalMillis, 0, tojson(timings));
+
+    let sum = 0;
+    for (let phase of ["storageEngine", "repairDatabases", "replication", "listen"]) {
+        assert(timings.phaseMillis.hasOwnProperty(phase), tojson(timings));
+    }
+    for (let phase in timings.phaseMillis) {
+        assert.gte(timings.phaseMillis[phase], 0, tojson(timings));
+        sum += timings.phaseMillis[phase];
+    }
+    assert.eq(timings.totalMillis, sum, tojson(timings));
+
+    MongoRunner.stopMongod(conn);
+})();
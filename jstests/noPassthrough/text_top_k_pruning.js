@@ -0,0 +1,74 @@
+// Tests that a text search sorted by text score with a limit returns the same documents and scores
+// with internalQueryTextTopKPruning as without it, and that it stops reading the index early.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.text_top_k_pruning;
+    assert.commandWorked(coll.createIndex({title: "text", body: "text"}, {weights: {title: 10}}));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        let body = "common words";
+        for (let j = 0; j < i % 13; ++j) {
+            body += " apple";
+        }
+        bulk.insert({_id: i, title: i % 100 === 0 ? "apple pie" : "other", body: body});
+    }
+    assert.writeOK(bulk.execute());
+
+    function runSearch(search, limit, prune) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, internalQueryTextTopKPruning: prune}));
+        return coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+            .sort({score: {$meta: "textScore"}})
+            .limit(limit)
+            .toArray();
+    }
+
+    function assertSameResults(search, limit) {
+        const expected = runSearch(search, limit, false);
+        const actual = runSearch(search, limit, true);
+        assert.eq(expected.length, actual.length, tojson(actual));
+        for (let i = 0; i < expected.length; ++i) {
+            assert.eq(expected[i].score, actual[i].score, tojson(actual));
+        }
+    }
+
+    assertSameResults("apple", 5);
+    assertSameResults("apple pie", 10);
+    assertSameResults("apple common", 25);
+    assertSameResults("apple", 5000);
+    assertSameResults("missing", 5);
+
+    // Negations and phrases are filtered after scoring, so they do not stop early.
+    assertSameResults("apple -pie", 5);
+    assertSameResults("\"apple pie\"", 5);
+
+    // The search stops reading once no other document can make the top 5.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryTextTopKPruning: true}));
+    let explain = coll.find({$text: {$search: "apple pie"}}, {score: {$meta: "textScore"}})
+                      .sort({score: {$meta: "textScore"}})
+                      .limit(5)
+                      .explain("executionStats");
+    let textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.neq(null, textOr, tojson(explain));
+    assert.eq(5, textOr.topK, tojson(explain));
+    assert.eq(true, textOr.stoppedEarly, tojson(explain));
+    assert.lt(textOr.docsExamined, 2000, tojson(explain));
+
+    explain = coll.find({$text: {$search: "apple -pie"}}, {score: {$meta: "textScore"}})
+                  .sort({score: {$meta: "textScore"}})
+                  .limit(5)
+                  .explain("executionStats");
+    textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.eq(undefined, textOr.topK, tojson(explain));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,28 @@
+/**
+ * Tests that messages of all sizes round-trip correctly when sessions read from the socket through
+ * a read-ahead buffer, including messages larger than the buffer and messages that straddle a
+ * refill.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {transportLayerASIOReadAheadBytes: 1024}});
+    assert.neq(null, conn, "mongod failed to start with transportLayerASIOReadAheadBytes set");
+
+    const coll = conn.getDB("test").read_ahead;
+    const sizes = [0, 1, 100, 900, 1000, 1024, 1500, 4096, 64 * 1024, 1024 * 1024];
+    sizes.forEach(function(size, i) {
+        assert.writeOK(coll.insert({_id: i, payload: "x".repeat(size)}));
+    });
+
+    sizes.forEach(function(size, i) {
+        const doc = coll.findOne({_id: i});
+        assert.neq(null, doc, "missing document " + i);
+        assert.eq(size, doc.payload.length, tojson({_id: i}));
+    });
+
+    // Exhaust the cursor in small batches so that many short replies follow each other.
+    assert.eq(sizes.length, coll.find().batchSize(1).itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,80 @@
+/**
+ * Tests that the TTL monitor deletes expired documents in batches on several workers, leaves
+ * unexpired documents alone, and paces its deletes when a rate limit is set.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorNumWorkers: 2, ttlMonitorBatchSize: 7}
+    });
+    assert.neq(null, conn, 'mongod was unable to start up');
+    const testDB = conn.getDB('test');
+
+    assert.commandFailedWithCode(testDB.adminCommand({setParameter: 1, ttlMonitorBatchSize: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        testDB.adminCommand({setParameter: 1, ttlMonitorDeletesPerSecond: -1}),
+        ErrorCodes.BadValue);
+
+    function getTTLMetrics() {
+        return testDB.serverStatus().metrics.ttl;
+    }
+
+    const now = Date.now();
+    const expired = new Date(now - 3600 * 1000);
+    const alsoExpired = new Date(now - 1800 * 1000);
+    const live = new Date(now + 3600 * 1000);
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, ttlMonitorEnabled: false}));
+    const numCollections = 4;
+    const numExpired = 100;
+    const numLive = 10;
+    for (let i = 0; i < numCollections; i++) {
+        const coll = testDB['ttl' + i];
+        assert.commandWorked(coll.createIndex({date: 1}, {expireAfterSeconds: 0}));
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < numExpired; j++) {
+            // Some documents have several expired dates, so that the index returns them twice.
+            bulk.insert({date: j % 10 === 0 ? [expired, alsoExpired] : expired});
+        }
+        for (let j = 0; j < numLive; j++) {
+            bulk.insert({date: live});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    const before = getTTLMetrics();
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, ttlMonitorEnabled: true}));
+    assert.soon(function() {
+        for (let i = 0; i < numCollections; i++) {
+            if (testDB['ttl' + i].count() !== numLive) {
+                return false;
+            }
+        }
+        return true;
+    }, 'the TTL monitor did not delete the expired documents');
+
+    const after = getTTLMetrics();
+    assert.eq(numCollections * numExpired, after.deletedDocuments - before.deletedDocuments);
+    assert.gte(after.deletedBatches - before.deletedBatches,
+               numCollections * Math.ceil(numExpired / 7),
+               tojson(after));
+    for (let i = 0; i < numCollections; i++) {
+        assert.eq(numLive, testDB['ttl' + i].count({date: live}));
+    }
+
+    // With a rate limit, the deletes of a pass are spread out over time.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, ttlMonitorDeletesPerSecond: 100}));
+    const coll = testDB.ttl0;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let j = 0; j < 2 * numExpired; j++) {
+        bulk.insert({date: expired});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.soon(() => coll.count() === numLive, 'the rate limited deletes did not complete');
+    assert.gt(getTTLMetrics().rateLimitedMillis, after.rateLimitedMillis, tojson(getTTLMetrics()));
+
+    MongoRunner.stopMongod(conn);
+})();
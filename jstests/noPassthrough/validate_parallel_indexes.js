@@ -0,0 +1,47 @@
+// Tests that validating the indexes of a collection on multiple threads reports the same results as
+// validating them one after the other.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: "internalValidateIndexThreads=4"});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.validate_parallel_indexes;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: i % 7, b: [i, -i], c: "str" + i, d: (i % 2 === 0) ? i : null});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndexes([{a: 1}, {b: 1}, {c: -1, a: 1}, {d: 1}]));
+
+    function validate(threads, full) {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalValidateIndexThreads: threads}));
+        const res = assert.commandWorked(coll.validate(full));
+        assert(res.valid, tojson(res));
+        return res;
+    }
+
+    for (let full of [false, true]) {
+        const serial = validate(1, full);
+        const parallel = validate(4, full);
+        assert.eq(serial.nIndexes, parallel.nIndexes, tojson(parallel));
+        assert.docEq(serial.keysPerIndex, parallel.keysPerIndex, tojson(parallel));
+        // Each document has two keys in the multikey index, except for {_id: 0}, whose are equal.
+        assert.eq(5000 * 2 - 1,
+                  parallel.keysPerIndex[coll.getFullName() + ".$b_1"],
+                  tojson(parallel));
+    }
+
+    // A collection with a single index is validated serially.
+    const single = db.validate_parallel_indexes_single;
+    assert.writeOK(single.insert({_id: 0}));
+    const res = assert.commandWorked(single.validate(true));
+    assert(res.valid, tojson(res));
+
+    assert.commandFailedWithCode(
+        db.adminCommand({setParameter: 1, internalValidateIndexThreads: 0}), ErrorCodes.BadValue);
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,69 @@
+/**
+ * Tests that a collection and an index created with a WiredTiger compression dictionary can be
+ * written to and read back across a restart, and that malformed dictionaries are rejected.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const dbpath = MongoRunner.dataPath + 'wt_compression_dictionary';
+    resetDbpath(dbpath);
+
+    let conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, 'mongod was unable to start up');
+    let testDB = conn.getDB('test');
+
+    assert.commandFailedWithCode(
+        testDB.createCollection('bad', {storageEngine: {wiredTiger: {compressionDictionary: 1}}}),
+        ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(
+        testDB.createCollection(
+            'bad', {storageEngine: {wiredTiger: {compressionDictionary: BinData(0, '')}}}),
+        ErrorCodes.BadValue);
+
+    const dictionary = BinData(0, 'AnN0YXR1cwAQY3VzdG9tZXJJZABhY3RpdmU=');
+    assert.commandWorked(testDB.createCollection(
+        'coll', {storageEngine: {wiredTiger: {compressionDictionary: dictionary}}}));
+
+    const nDocs = 1000;
+    let bulk = testDB.coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, customerId: i, status: 'active'});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Index keys which share a long leading string benefit from a dictionary holding it.
+    const urlPrefix = 'https://tenant-0001.example.com/events/';
+    assert.commandFailedWithCode(
+        testDB.coll.createIndex({url: 1},
+                                {storageEngine: {wiredTiger: {compressionDictionary: 'abc'}}}),
+        ErrorCodes.TypeMismatch);
+    // The base64 encoding of 'urlPrefix'.
+    const urlDictionary = BinData(0, 'aHR0cHM6Ly90ZW5hbnQtMDAwMS5leGFtcGxlLmNvbS9ldmVudHMv');
+    assert.commandWorked(testDB.coll.createIndex(
+        {url: 1}, {storageEngine: {wiredTiger: {compressionDictionary: urlDictionary}}}));
+    bulk = testDB.coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.find({_id: i}).updateOne({$set: {url: urlPrefix + i}});
+    }
+    assert.writeOK(bulk.execute());
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod({dbpath: dbpath, noCleanData: true});
+    assert.neq(null, conn, 'mongod was unable to restart');
+    testDB = conn.getDB('test');
+
+    assert.eq(nDocs, testDB.coll.find().itcount());
+    assert.eq({_id: 7, customerId: 7, status: 'active', url: urlPrefix + 7},
+              testDB.coll.findOne({_id: 7}));
+    assert.eq(nDocs, testDB.coll.find({url: {$gte: urlPrefix}}).hint({url: 1}).itcount());
+    assert.eq(7, testDB.coll.find({url: urlPrefix + 7}).hint({url: 1}).next()._id);
+    assert.commandWorked(testDB.coll.validate(true));
+
+    MongoRunner.stopMongod(conn);
+})();
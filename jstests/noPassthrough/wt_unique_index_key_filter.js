@@ -0,0 +1,77 @@
+/**
+ * Tests that a unique index with a WiredTiger key filter still rejects duplicate keys, both while
+ * the filter is being built and once it lets inserts skip their duplicate key search, and that
+ * the filter is rebuilt across a restart.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    'use strict';
+
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    const dbpath = MongoRunner.dataPath + 'wt_unique_index_key_filter';
+    resetDbpath(dbpath);
+
+    const options = {
+        dbpath: dbpath,
+        noCleanData: true,
+        setParameter: {createTimestampSafeUniqueIndex: true}
+    };
+    let conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'mongod was unable to start up');
+    let coll = conn.getDB('test').coll;
+
+    assert.commandFailedWithCode(
+        coll.createIndex({a: 1},
+                         {unique: true, storageEngine: {wiredTiger: {uniqueKeyFilter: 1}}}),
+        ErrorCodes.TypeMismatch);
+    assert.commandWorked(coll.createIndex(
+        {a: 1}, {unique: true, storageEngine: {wiredTiger: {uniqueKeyFilter: true}}}));
+
+    const nDocs = 1000;
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.insert({a: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function getFilterStats() {
+        const stats = coll.aggregate([{$indexStats: {}}, {$match: {name: 'a_1'}}]).toArray();
+        assert.eq(1, stats.length, tojson(stats));
+        assert(stats[0].storage, tojson(stats));
+        return stats[0].storage.uniqueKeyFilter;
+    }
+
+    function checkFilter() {
+        assert.soon(() => getFilterStats().ready, 'the key filter was never built');
+
+        for (let i = 0; i < nDocs; i += 100) {
+            assert.writeErrorWithCode(coll.insert({a: i}), ErrorCodes.DuplicateKey);
+        }
+
+        const before = getFilterStats();
+        for (let i = nDocs; i < nDocs + 100; i++) {
+            assert.writeOK(coll.insert({a: i}));
+        }
+        const after = getFilterStats();
+        assert.gt(after.checksSkipped, before.checksSkipped, tojson(after));
+
+        for (let i = nDocs; i < nDocs + 100; i += 10) {
+            assert.writeErrorWithCode(coll.insert({a: i}), ErrorCodes.DuplicateKey);
+        }
+        assert.writeOK(coll.remove({a: {$gte: nDocs}}));
+    }
+
+    checkFilter();
+
+    MongoRunner.stopMongod(conn);
+    conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, 'mongod was unable to restart');
+    coll = conn.getDB('test').coll;
+
+    checkFilter();
+    MongoRunner.stopMongod(conn);
+})();
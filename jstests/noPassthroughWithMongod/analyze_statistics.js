@@ -0,0 +1,70 @@
+/**
+ * Tests the 'analyze' command and the use of the statistics it gathers to prune candidate plans
+ * before they are raced against each other.
+ */
+(function() {
+    "use strict";
+
+    load('jstests/libs/analyze_plan.js');              // For getPlanStage().
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const coll = assertDropAndRecreateCollection(db, "analyze_statistics");
+
+    // 'a' is unique while 'b' only has two values.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({a: i, b: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    // Invalid arguments are rejected.
+    assert.commandFailedWithCode(coll.runCommand("analyze"), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.runCommand("analyze", {keys: []}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.runCommand("analyze", {keys: [1]}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.runCommand("analyze", {keys: ["a"], sampleSize: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({analyze: "nonexistent", keys: ["a"]}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    const res = assert.commandWorked(coll.runCommand("analyze", {keys: ["a", "b"]}));
+    assert.eq(1000, res.sampled, tojson(res));
+    assert.eq(1000, res.fields.a.histogram.numValues, tojson(res));
+    assert.eq(2, res.fields.b.histogram.buckets.length, tojson(res));
+    assert.close(1000, res.fields.a.distinctEstimate, "distinct estimate of 'a'", -2);
+    assert.close(2, res.fields.b.distinctEstimate, "distinct estimate of 'b'", 0);
+
+    // Without statistics-based pruning both indexes compete. A range on 'b' keeps index
+    // intersection out of the candidates.
+    const query = {a: 5, b: {$gte: 1}};
+    let explain = coll.find(query).explain();
+    assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+
+    const originalRatio = assert
+                              .commandWorked(db.adminCommand(
+                                  {getParameter: 1, internalQueryPlanStatisticsPruneRatio: 1}))
+                              .internalQueryPlanStatisticsPruneRatio;
+    assert.commandFailed(
+        db.adminCommand({setParameter: 1, internalQueryPlanStatisticsPruneRatio: 0.5}));
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryPlanStatisticsPruneRatio: 10}));
+
+    try {
+        // The {b: 1} candidate is estimated to read half of the collection and is never raced.
+        explain = coll.find(query).explain();
+        assert.eq(0, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+        const ixscan = getPlanStage(explain.queryPlanner.winningPlan, "IXSCAN");
+        assert.neq(null, ixscan, tojson(explain));
+        assert.eq({a: 1}, ixscan.keyPattern, tojson(explain));
+        assert.eq([{_id: coll.findOne({a: 5})._id, a: 5, b: 1}], coll.find(query).toArray());
+
+        // Candidates on fields without statistics are kept.
+        assert.commandWorked(coll.createIndex({c: 1}));
+        explain = coll.find({a: {$gte: 5}, c: {$gte: 0}}).explain();
+        assert.eq(1, explain.queryPlanner.rejectedPlans.length, tojson(explain));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryPlanStatisticsPruneRatio: originalRatio}));
+    }
+}());
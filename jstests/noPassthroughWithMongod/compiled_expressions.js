@@ -0,0 +1,69 @@
+/**
+ * Tests that $project and $addFields produce the same results whether or not their arithmetic and
+ * boolean expressions are compiled.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const coll = assertDropAndRecreateCollection(db, "compiled_expressions");
+    assert.writeOK(coll.insert([
+        {_id: 0, a: 1, b: 2},
+        {_id: 1, a: NumberLong(3), b: 2.5},
+        {_id: 2, a: NumberInt(2147483647), b: NumberInt(1)},
+        {_id: 3, a: NumberDecimal("1.5"), b: 2},
+        {_id: 4, a: 1, b: null},
+        {_id: 5, a: 1},
+        {_id: 6, a: NumberLong("9223372036854775807"), b: 0},
+    ]));
+
+    const pipelines = [
+        [{
+           $project: {
+               sum: {$add: ["$a", {$multiply: ["$b", 2]}]},
+               diff: {$subtract: ["$b", 1]},
+               cmp: {$cmp: ["$a", "$b"]},
+           }
+        }],
+        [{
+           $addFields: {
+               big: {$and: [{$gt: ["$a", 0]}, {$not: [{$eq: ["$b", 0]}]}]},
+               picked: {$cond: [{$or: [{$lt: ["$b", 2]}, "$a"]}, "$a", {$add: ["$b", 1]}]},
+               "nested.value": {$multiply: ["$b", "$b", {$abs: "$b"}]},
+           }
+        }],
+    ];
+
+    function runPipelines() {
+        return pipelines.map((pipeline) => coll.aggregate(pipeline.concat([{$sort: {_id: 1}}]))
+                                               .toArray());
+    }
+
+    const originalValue =
+        assert
+            .commandWorked(
+                db.adminCommand({getParameter: 1, internalQueryCompileAggregationExpressions: 1}))
+            .internalQueryCompileAggregationExpressions;
+    try {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryCompileAggregationExpressions: false}));
+        const expected = runPipelines();
+
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryCompileAggregationExpressions: true}));
+        const actual = runPipelines();
+
+        // Compare the extended JSON so that numeric types must match too.
+        assert.eq(tojson(expected), tojson(actual));
+
+        // Errors raised by the interpreter are raised by the compiled form too.
+        assert.commandWorked(coll.insert({_id: 7, a: "str", b: 1}));
+        const error = assert.throws(
+            () => coll.aggregate([{$project: {sum: {$add: ["$a", "$b"]}}}]).toArray());
+        assert.eq(16554, error.code, tojson(error));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryCompileAggregationExpressions: originalValue}));
+    }
+}());
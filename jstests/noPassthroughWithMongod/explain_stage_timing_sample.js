@@ -0,0 +1,34 @@
+// Tests that explain reports a microsecond estimate of each stage's execution time when calls to
+// work() are sampled with internalQueryExecStageTimingSampleInterval, and only then.
+(function() {
+    "use strict";
+
+    const coll = db.explain_stage_timing_sample;
+    coll.drop();
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    function executionStages() {
+        return assert.commandWorked(coll.find({a: 1}).explain("executionStats"))
+            .executionStats.executionStages;
+    }
+
+    assert(!executionStages().hasOwnProperty("executionTimeMicrosEstimate"));
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecStageTimingSampleInterval: 4}));
+    try {
+        const stage = executionStages();
+        assert(stage.hasOwnProperty("executionTimeMicrosEstimate"), tojson(stage));
+        assert.gte(stage.executionTimeMicrosEstimate, 0, tojson(stage));
+    } finally {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryExecStageTimingSampleInterval: 0}));
+    }
+
+    assert.commandFailed(
+        db.adminCommand({setParameter: 1, internalQueryExecStageTimingSampleInterval: -1}));
+})();
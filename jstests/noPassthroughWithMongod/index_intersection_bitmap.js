@@ -0,0 +1,64 @@
+/**
+ * Tests that hash-based index intersection plans run with the AND_BITMAP stage when
+ * internalQueryExecUseBitmapIntersection is enabled, and that they return the same results as
+ * AND_HASH.
+ */
+(function() {
+    "use strict";
+
+    load('jstests/libs/analyze_plan.js');              // For getPlanStage().
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const coll = assertDropAndRecreateCollection(db, "index_intersection_bitmap");
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({a: i % 100, b: i % 7, c: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    const knobs = [
+        "internalQueryPlannerEnableHashIntersection",
+        "internalQueryForceIntersectionPlans",
+        "internalQueryExecUseBitmapIntersection"
+    ];
+    const original = {};
+    knobs.forEach(function(knob) {
+        original[knob] =
+            assert.commandWorked(db.adminCommand({getParameter: 1, [knob]: 1}))[knob];
+    });
+
+    function setKnob(knob, value) {
+        assert.commandWorked(db.adminCommand({setParameter: 1, [knob]: value}));
+    }
+
+    // Range predicates on both fields rule out AND_SORTED.
+    const query = {a: {$gte: 10, $lte: 30}, b: {$lte: 2}};
+
+    try {
+        setKnob("internalQueryPlannerEnableHashIntersection", true);
+        setKnob("internalQueryForceIntersectionPlans", true);
+
+        let explain = coll.find(query).explain("executionStats");
+        assert.neq(null, getPlanStage(explain.executionStats.executionStages, "AND_HASH"),
+                   tojson(explain));
+        const expected = coll.find(query).sort({c: 1}).toArray();
+        assert.gt(expected.length, 0);
+
+        setKnob("internalQueryExecUseBitmapIntersection", true);
+        assert.commandWorked(coll.runCommand("planCacheClear"));
+
+        explain = coll.find(query).explain("executionStats");
+        const andBitmap = getPlanStage(explain.executionStats.executionStages, "AND_BITMAP");
+        assert.neq(null, andBitmap, tojson(explain));
+        assert.eq(expected.length, explain.executionStats.nReturned, tojson(explain));
+        assert.gt(andBitmap.bitmapAfterChild_0, 0, tojson(andBitmap));
+        assert.eq(expected, coll.find(query).sort({c: 1}).toArray());
+    } finally {
+        knobs.forEach(function(knob) {
+            setKnob(knob, original[knob]);
+        });
+    }
+}());
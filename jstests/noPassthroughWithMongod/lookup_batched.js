@@ -0,0 +1,103 @@
+/**
+ * Tests that a $lookup with localField/foreignField syntax returns the same results whether its
+ * inputs are looked up one at a time, in batches, or hash joined against the foreign collection.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const local = assertDropAndRecreateCollection(db, "lookup_batched_local");
+    const foreign = assertDropAndRecreateCollection(db, "lookup_batched_foreign");
+
+    assert.writeOK(local.insert([
+        {_id: 0, a: 1},
+        {_id: 1, a: [1, 2]},
+        {_id: 2, a: null},
+        {_id: 3},
+        {_id: 4, a: NumberLong(3)},
+        {_id: 5, a: [[1, 2]]},
+        {_id: 6, a: "abc"},
+        {_id: 7, a: /^a/},
+        {_id: 8, a: {x: 1}},
+        {_id: 9, a: 42},
+    ]));
+    assert.writeOK(foreign.insert([
+        {_id: 0, b: 1},
+        {_id: 1, b: 2.0},
+        {_id: 2, b: [1, 3]},
+        {_id: 3, b: null},
+        {_id: 4},
+        {_id: 5, b: [1, 2]},
+        {_id: 6, b: [[1, 2], 4]},
+        {_id: 7, b: "ABC"},
+        {_id: 8, b: "abc"},
+        {_id: 9, b: /^a/},
+        {_id: 10, b: {x: 1}},
+        {_id: 11, b: [{x: 1}]},
+    ]));
+    // Documents which never match, to make the foreign collection larger than its matches.
+    const bulk = foreign.initializeUnorderedBulkOp();
+    for (let i = 100; i < 300; ++i) {
+        bulk.insert({_id: i, b: "filler", padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(foreign.createIndex({b: 1}));
+
+    const pipelines = [
+        [{$lookup: {from: foreign.getName(), localField: "a", foreignField: "b", as: "joined"}}],
+        [
+          {$lookup: {from: foreign.getName(), localField: "a", foreignField: "_id", as: "byId"}},
+          {$project: {ids: "$byId._id"}},
+        ],
+    ];
+
+    function runPipelines(options) {
+        return pipelines.map((pipeline) => {
+            const results =
+                local.aggregate(pipeline.concat([{$sort: {_id: 1}}]), options).toArray();
+            // The order of the joined documents depends on the plan of the foreign query.
+            results.forEach((doc) => {
+                if (doc.joined) {
+                    doc.joined.sort((x, y) => x._id - y._id);
+                }
+            });
+            return results;
+        });
+    }
+
+    function setParameter(name, value) {
+        return assert.commandWorked(db.adminCommand({setParameter: 1, [name]: value})).was;
+    }
+
+    const originalBatchSize = setParameter("internalDocumentSourceLookupBatchSize", 0);
+    const originalCacheSize =
+        setParameter("internalDocumentSourceLookupCacheSizeBytes", 100 * 1024 * 1024);
+    try {
+        for (let options of [{}, {collation: {locale: "en", strength: 2}}]) {
+            setParameter("internalDocumentSourceLookupBatchSize", 0);
+            const expected = runPipelines(options);
+
+            // The foreign collection fits in the cache, so it is hash joined.
+            setParameter("internalDocumentSourceLookupBatchSize", 3);
+            assert.eq(tojson(expected), tojson(runPipelines(options)));
+
+            // The foreign collection does not fit in the cache, but the matches of each batch
+            // do, so each batch runs a single query.
+            setParameter("internalDocumentSourceLookupCacheSizeBytes", 10 * 1024);
+            assert.eq(tojson(expected), tojson(runPipelines(options)));
+
+            // The matches of a batch do not fit either, so each input runs its own query.
+            setParameter("internalDocumentSourceLookupCacheSizeBytes", 1);
+            assert.eq(tojson(expected), tojson(runPipelines(options)));
+            setParameter("internalDocumentSourceLookupCacheSizeBytes", 100 * 1024 * 1024);
+        }
+
+        assert.commandFailedWithCode(
+            db.adminCommand({setParameter: 1, internalDocumentSourceLookupBatchSize: -1}),
+            ErrorCodes.BadValue);
+    } finally {
+        setParameter("internalDocumentSourceLookupBatchSize", originalBatchSize);
+        setParameter("internalDocumentSourceLookupCacheSizeBytes", originalCacheSize);
+    }
+}());
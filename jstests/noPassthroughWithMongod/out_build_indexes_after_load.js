@@ -0,0 +1,36 @@
+// Tests that $out gives the target collection the same indexes when they are built after all the
+// documents are inserted, and that unique indexes are still enforced.
+(function() {
+    "use strict";
+
+    const source = db.out_build_indexes_after_load_source;
+    const target = db.out_build_indexes_after_load_target;
+    source.drop();
+    target.drop();
+
+    const bulk = source.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i, b: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(target.createIndex({a: 1}, {unique: true}));
+    assert.commandWorked(target.createIndex({b: 1, a: -1}));
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalDocumentSourceOutBuildIndexesAfterLoad: true}));
+    try {
+        source.aggregate([{$out: target.getName()}]);
+        assert.eq(1000, target.find().itcount());
+        assert.eq(3, target.getIndexes().length, tojson(target.getIndexes()));
+        assert.eq(100, target.find({b: 3}).hint({b: 1, a: -1}).itcount());
+
+        // A duplicate of a unique key fails the $out and leaves the target collection as it was.
+        assert.throws(() => source.aggregate(
+                          [{$project: {a: {$literal: 1}}}, {$out: target.getName()}]));
+        assert.eq(1000, target.find().itcount());
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalDocumentSourceOutBuildIndexesAfterLoad: false}));
+    }
+})();
@@ -0,0 +1,91 @@
+/**
+ * Tests that an aggregation whose leading stages and first $group are split among several threads
+ * returns the same results as when it runs on a single thread.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const coll = assertDropAndRecreateCollection(db, "parallel_aggregation");
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, key: i % 97, value: i % 13, tags: ["a" + (i % 3), "b" + (i % 5)]});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [{$group: {_id: "$key", count: {$sum: 1}, total: {$sum: "$value"}}}],
+        [
+          {$match: {value: {$gte: 2}}},
+          {$addFields: {doubled: {$multiply: ["$value", 2]}}},
+          {$unwind: "$tags"},
+          {
+            $group: {
+                _id: {key: "$key", tag: "$tags"},
+                avg: {$avg: "$doubled"},
+                min: {$min: "$value"},
+                max: {$max: "$value"},
+                tags: {$addToSet: "$tags"},
+            }
+          },
+          {$match: {avg: {$gt: 10}}},
+        ],
+        [{$project: {key: 1}}, {$group: {_id: null, keys: {$addToSet: "$key"}}}],
+        // The rewrite does not apply when a blocking stage precedes the $group.
+        [{$sort: {value: 1}}, {$group: {_id: "$value", n: {$sum: 1}}}],
+    ];
+
+    function runPipelines() {
+        return pipelines.map((pipeline) => {
+            const results = coll.aggregate(pipeline.concat([{$sort: {_id: 1}}])).toArray();
+            // The order of the elements of an $addToSet depends on the order of the input.
+            results.forEach((doc) => {
+                if (doc.keys) {
+                    doc.keys.sort((a, b) => a - b);
+                }
+                if (doc.tags) {
+                    doc.tags.sort();
+                }
+            });
+            return results;
+        });
+    }
+
+    function setParallelism(value) {
+        return db.adminCommand({setParameter: 1, internalQueryAggregationParallelism: value});
+    }
+
+    const originalValue =
+        assert
+            .commandWorked(
+                db.adminCommand({getParameter: 1, internalQueryAggregationParallelism: 1}))
+            .internalQueryAggregationParallelism;
+    try {
+        assert.commandWorked(setParallelism(1));
+        const expected = runPipelines();
+
+        assert.commandWorked(setParallelism(4));
+        const actual = runPipelines();
+
+        assert.eq(tojson(expected), tojson(actual));
+
+        // Explain shows the pipeline as it would run on a single thread.
+        const explain = coll.explain().aggregate(pipelines[0]);
+        assert(!tojson(explain).includes("$_internalParallel"), tojson(explain));
+
+        // An error raised by one of the threads fails the whole aggregation.
+        assert.commandFailedWithCode(db.runCommand({
+            aggregate: coll.getName(),
+            pipeline: [{$group: {_id: {$divide: ["$value", 0]}}}],
+            cursor: {}
+        }),
+                                     16608);
+
+        // Out of range values are rejected.
+        assert.commandFailedWithCode(setParallelism(0), ErrorCodes.BadValue);
+        assert.commandFailedWithCode(setParallelism(65), ErrorCodes.BadValue);
+    } finally {
+        assert.commandWorked(setParallelism(originalValue));
+    }
+}());
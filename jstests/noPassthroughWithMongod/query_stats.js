@@ -0,0 +1,72 @@
+/**
+ * Tests that sampled queries are aggregated per query shape and reported by $queryStats.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/collection_drop_recreate.js");  // For assert[Drop|Create]Collection.
+
+    const coll = assertDropAndRecreateCollection(db, "query_stats");
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 20; i++) {
+        bulk.insert({a: i, b: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+
+    // The stage must run on a database with {aggregate: 1} and takes no arguments.
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: coll.getName(), pipeline: [{$queryStats: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: 1, pipeline: [{$queryStats: {all: true}}], cursor: {}}),
+        ErrorCodes.BadValue);
+
+    function statsForColl() {
+        return db.aggregate([{$queryStats: {}}, {$match: {ns: coll.getFullName()}}]).toArray();
+    }
+
+    const originalSampleRate =
+        assert.commandWorked(db.adminCommand({getParameter: 1, internalQueryStatsSampleRate: 1}))
+            .internalQueryStatsSampleRate;
+    try {
+        // Nothing is recorded while sampling is disabled.
+        assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryStatsSampleRate: 0}));
+        assert.eq(10, coll.find({b: 0}).itcount());
+        assert.eq(0, statsForColl().length);
+
+        assert.commandWorked(db.adminCommand({setParameter: 1, internalQueryStatsSampleRate: 1}));
+
+        // Queries differing only in their constants share an entry.
+        assert.eq(10, coll.find({b: 0}).itcount());
+        assert.eq(10, coll.find({b: 1}).itcount());
+        assert.eq(20, coll.find({a: {$gte: 0}}).sort({a: 1}).itcount());
+
+        // getMores count towards the entry of the query that created the cursor.
+        assert.eq(20, coll.find({a: {$gte: 0}}).sort({a: 1}).batchSize(5).itcount());
+
+        const stats = statsForColl();
+        assert.eq(2, stats.length, tojson(stats));
+
+        const eqShape = stats.find((entry) => entry.query.hasOwnProperty("b"));
+        assert(eqShape, tojson(stats));
+        assert.eq(2, eqShape.execCount, tojson(eqShape));
+        assert.eq(0, eqShape.getMoreCount, tojson(eqShape));
+        assert.eq(40, eqShape.docsExamined, tojson(eqShape));
+        assert.eq(20, eqShape.nreturned, tojson(eqShape));
+        assert.eq(2, eqShape.latency.reads.ops, tojson(eqShape));
+
+        const sortShape = stats.find((entry) => entry.query.hasOwnProperty("a"));
+        assert(sortShape, tojson(stats));
+        assert.eq({a: 1}, sortShape.sort, tojson(sortShape));
+        assert.eq(2, sortShape.execCount, tojson(sortShape));
+        assert.gt(sortShape.getMoreCount, 0, tojson(sortShape));
+        assert.eq(40, sortShape.nreturned, tojson(sortShape));
+
+        // Invalid sample rates are rejected.
+        assert.commandFailed(db.adminCommand({setParameter: 1, internalQueryStatsSampleRate: 2}));
+        assert.commandFailed(db.adminCommand({setParameter: 1, internalQueryStatsMaxEntries: 0}));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryStatsSampleRate: originalSampleRate}));
+    }
+}());
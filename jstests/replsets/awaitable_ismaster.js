@@ -0,0 +1,77 @@
+/**
+ * Tests the topologyVersion reported by isMaster on replica set members, and that an isMaster
+ * which supplies the current topologyVersion along with maxAwaitTimeMS waits until the topology
+ * changes or the time limit expires.
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({name: "awaitable_ismaster", nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const primaryAdmin = primary.getDB("admin");
+
+    let res = assert.commandWorked(primaryAdmin.runCommand({isMaster: 1}));
+    assert(res.hasOwnProperty("topologyVersion"), tojson(res));
+    const topologyVersion = res.topologyVersion;
+    assert(topologyVersion.hasOwnProperty("processId"), tojson(res));
+    assert(topologyVersion.hasOwnProperty("counter"), tojson(res));
+
+    // A stale topologyVersion returns immediately with the current one.
+    res = assert.commandWorked(primaryAdmin.runCommand({
+        isMaster: 1,
+        topologyVersion: {processId: ObjectId(), counter: NumberLong(0)},
+        maxAwaitTimeMS: 60 * 1000
+    }));
+    assert.eq(topologyVersion, res.topologyVersion, tojson(res));
+
+    // The current topologyVersion waits for maxAwaitTimeMS when nothing changes.
+    res = assert.commandWorked(primaryAdmin.runCommand(
+        {isMaster: 1, topologyVersion: topologyVersion, maxAwaitTimeMS: 100}));
+    assert.eq(topologyVersion, res.topologyVersion, tojson(res));
+
+    // An awaitable isMaster returns once the primary steps down, with a higher counter.
+    TestData.topologyVersion = topologyVersion;
+    const awaitIsMaster = startParallelShell(function() {
+        const res = assert.commandWorked(db.adminCommand({
+            isMaster: 1,
+            topologyVersion: TestData.topologyVersion,
+            maxAwaitTimeMS: 5 * 60 * 1000
+        }));
+        assert.eq(TestData.topologyVersion.processId, res.topologyVersion.processId, tojson(res));
+        assert.gt(res.topologyVersion.counter, TestData.topologyVersion.counter, tojson(res));
+        assert.eq(false, res.ismaster, tojson(res));
+    }, primary.port);
+
+    assert.soon(function() {
+        return primaryAdmin
+                   .aggregate([
+                       {$currentOp: {}},
+                       {$match: {"command.isMaster": 1, "command.maxAwaitTimeMS": {$exists: true}}}
+                   ])
+                   .itcount() > 0;
+    });
+
+    assert.throws(function() {
+        primaryAdmin.runCommand({replSetStepDown: 60, force: true});
+    });
+    awaitIsMaster();
+
+    // topologyVersion and maxAwaitTimeMS must be supplied together and be well formed.
+    assert.commandFailedWithCode(primaryAdmin.runCommand({isMaster: 1, maxAwaitTimeMS: 100}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        primaryAdmin.runCommand({isMaster: 1, topologyVersion: topologyVersion}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        primaryAdmin.runCommand({isMaster: 1, topologyVersion: 1, maxAwaitTimeMS: 100}),
+        ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(
+        primaryAdmin.runCommand(
+            {isMaster: 1, topologyVersion: topologyVersion, maxAwaitTimeMS: -1}),
+        ErrorCodes.BadValue);
+
+    rst.stopSet();
+})();
@@ -0,0 +1,57 @@
+/**
+ * Tests that initial sync builds the secondary indexes of the collections it clones when their
+ * keys are only generated once all of the documents of a collection have been cloned.
+ */
+
+(function() {
+    "use strict";
+
+    const name = "initial_sync_defer_secondary_index_builds";
+    const replSet = new ReplSetTest({name: name, nodes: 2});
+    replSet.startSet({
+        setParameter: {
+            initialSyncDeferSecondaryIndexBuilds: true,
+            internalIndexBuildKeyGenerationThreads: 4,
+            maxNumInitialSyncCollectionClonerCursors: 4,
+        }
+    });
+    replSet.initiate();
+
+    const primary = replSet.getPrimary();
+    const coll = primary.getDB("test").getCollection(name);
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1, a: -1}));
+    assert.commandWorked(coll.createIndex({c: 1}, {unique: true, sparse: true}));
+    assert.commandWorked(coll.createIndex({"d.e": 1}));
+
+    const numDocs = 2000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        const doc = {_id: i, a: i % 7, b: "b" + (i % 13), d: [{e: i}, {e: -i}]};
+        if (i % 2 === 0) {
+            doc.c = i;
+        }
+        bulk.insert(doc);
+    }
+    assert.writeOK(bulk.execute());
+
+    let secondary = replSet.getSecondary();
+    secondary = replSet.restart(secondary, {startClean: true});
+    replSet.awaitReplication();
+    replSet.awaitSecondaryNodes();
+    secondary.setSlaveOk();
+
+    const secondaryColl = secondary.getDB("test").getCollection(name);
+    assert.eq(numDocs, secondaryColl.find().itcount());
+    assert.eq(5, secondaryColl.getIndexes().length, tojson(secondaryColl.getIndexes()));
+
+    // Every index holds the keys of every document it covers.
+    assert.eq(numDocs, secondaryColl.find().hint({a: 1}).itcount());
+    assert.eq(numDocs, secondaryColl.find().hint({b: 1, a: -1}).itcount());
+    assert.eq(numDocs / 2, secondaryColl.find({c: {$exists: true}}).hint({c: 1}).itcount());
+    assert.eq(1, secondaryColl.find({"d.e": {$in: [5, -5]}}).hint({"d.e": 1}).itcount());
+    const res = assert.commandWorked(secondaryColl.validate(true));
+    assert(res.valid, tojson(res));
+
+    replSet.stopSet();
+})();
@@ -0,0 +1,64 @@
+/**
+ * Tests that with secondaryReadsWaitForPendingCatalogChanges set, a read on a secondary that finds
+ * catalog changes after the last applied timestamp waits for the batch that makes them to finish,
+ * without waiting for the PBWM lock, and then reads at the new last applied timestamp.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/replsets/libs/secondary_reads_test.js");
+
+    const name = "secondaryReadsWaitForPendingCatalogChanges";
+    const collName = "testColl";
+    let secondaryReadsTest = new SecondaryReadsTest(name);
+
+    let primaryDB = secondaryReadsTest.getPrimaryDB();
+    let secondaryDB = secondaryReadsTest.getSecondaryDB();
+
+    assert.commandWorked(secondaryDB.adminCommand(
+        {setParameter: 1, secondaryReadsWaitForPendingCatalogChanges: true}));
+
+    assert.commandWorked(primaryDB.runCommand({create: collName}));
+    assert.writeOK(primaryDB[collName].insert({_id: 0, x: 0}));
+    secondaryReadsTest.getReplset().awaitReplication();
+
+    // Build an index in a batch that stops before it updates the last applied optime, so that the
+    // collection has catalog changes after the last applied timestamp.
+    let waitForPause = secondaryReadsTest.pauseSecondaryBatchApplication();
+    assert.commandWorked(primaryDB.runCommand(
+        {createIndexes: collName, indexes: [{key: {x: 1}, name: "x_1"}]}));
+    waitForPause();
+
+    TestData.dbName = name;
+    TestData.collName = collName;
+    let awaitRead = startParallelShell(function() {
+        db.getMongo().setSlaveOk();
+        let res = assert.commandWorked(db.getSiblingDB(TestData.dbName).runCommand({
+            find: TestData.collName,
+            filter: {x: 0},
+            hint: {x: 1},
+            readConcern: {level: "local"},
+        }));
+        assert.eq(1, res.cursor.firstBatch.length, tojson(res));
+    }, secondaryDB.getMongo().port);
+
+    // The read waits for the batch to be applied, not for a lock.
+    assert.soon(function() {
+        let ops = secondaryDB.getSiblingDB("admin")
+                      .aggregate([
+                          {$currentOp: {}},
+                          {$match: {ns: name + "." + collName, "command.find": collName}}
+                      ])
+                      .toArray();
+        if (ops.length === 0) {
+            return false;
+        }
+        assert.eq(false, ops[0].waitingForLock, tojson(ops));
+        return true;
+    });
+
+    secondaryReadsTest.resumeSecondaryBatchApplication();
+    awaitRead();
+
+    secondaryReadsTest.stop();
+})();
@@ -0,0 +1,41 @@
+/**
+ * Tests that balancerMaxMigrationsPerRound limits the migrations a balancer round starts, and that
+ * balancerStatus reports the migrations performed by the balancer.
+ */
+(function() {
+    'use strict';
+
+    var st = new ShardingTest({shards: 4});
+    var config = st.s0.getDB('config');
+    var collName = 'TestDB.TestColl';
+
+    assert.commandWorked(st.s0.adminCommand({enableSharding: 'TestDB'}));
+    st.ensurePrimaryShard('TestDB', st.shard0.shardName);
+    assert.commandWorked(st.s0.adminCommand({shardCollection: collName, key: {Key: 1}}));
+
+    // Two chunks on each of the first two shards, so that a round could balance them in parallel.
+    assert.commandWorked(st.splitAt(collName, {Key: 10}));
+    assert.commandWorked(st.splitAt(collName, {Key: 20}));
+    assert.commandWorked(st.splitAt(collName, {Key: 30}));
+    assert.commandWorked(st.moveChunk(collName, {Key: 20}, st.shard1.shardName));
+    assert.commandWorked(st.moveChunk(collName, {Key: 30}, st.shard1.shardName));
+
+    assert.commandWorked(st.configRS.getPrimary().adminCommand(
+        {setParameter: 1, balancerMaxMigrationsPerRound: 1}));
+
+    st.startBalancer();
+    assert.soon(function() {
+        return [st.shard0, st.shard1, st.shard2, st.shard3].every(function(shard) {
+            return config.chunks.find({ns: collName, shard: shard.shardName}).itcount() === 1;
+        });
+    });
+    st.stopBalancer();
+
+    var status = assert.commandWorked(st.s0.adminCommand({balancerStatus: 1}));
+    assert.gte(status.migrations.numChunksMoved, 2, tojson(status));
+    assert.eq(0, status.migrations.numFailed, tojson(status));
+    assert.eq(1, status.migrations.lastRound.numCandidates, tojson(status));
+    assert.eq(1, status.migrations.lastRound.numChunksMoved, tojson(status));
+
+    st.stop();
+})();
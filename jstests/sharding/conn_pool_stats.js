@@ -25,6 +25,7 @@
     if (post32) {
         assert("pools" in stats);
         assert("totalRefreshing" in stats);
+        assert("totalRequestsWaiting" in stats);
         assert.lte(stats["totalInUse"] + stats["totalAvailable"] + stats["totalRefreshing"],
                    stats["totalCreated"],
                    tojson(stats));
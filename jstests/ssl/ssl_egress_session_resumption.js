@@ -0,0 +1,39 @@
+/**
+ * Tests that with sslEgressSessionResumption set, a mongod connecting to the same peer again
+ * resumes the TLS session of its previous connection rather than running a full handshake.
+ */
+load('jstests/ssl/libs/ssl_helpers.js');
+requireSSLProvider('openssl', function() {
+    "use strict";
+
+    const sslOptions = {
+        sslMode: "requireSSL",
+        sslPEMKeyFile: SERVER_CERT,
+        sslCAFile: CA_CERT,
+        sslAllowInvalidHostnames: "",
+    };
+
+    const source = MongoRunner.runMongod(sslOptions);
+    assert.neq(null, source, "mongod was unable to start up");
+
+    const dest = MongoRunner.runMongod(Object.merge(
+        sslOptions, {setParameter: {sslEgressSessionResumption: true}}));
+    assert.neq(null, dest, "mongod was unable to start up");
+    assert.commandWorked(
+        dest.adminCommand({setParameter: 1, logComponentVerbosity: {network: {verbosity: 2}}}));
+
+    assert.writeOK(source.getDB("test").coll.insert({_id: 0}));
+
+    // Each cloneCollection opens a new connection to the source.
+    for (let i = 0; i < 2; i++) {
+        dest.getDB("test").coll.drop();
+        assert.commandWorked(
+            dest.getDB("test").runCommand({cloneCollection: "test.coll", from: source.host}));
+        assert.eq(1, dest.getDB("test").coll.find().itcount());
+    }
+
+    checkLog.contains(dest, "Resumed SSL session with");
+
+    MongoRunner.stopMongod(dest);
+    MongoRunner.stopMongod(source);
+});
@@ -414,6 +414,145 @@ Status validateBSONIterative(Buffer* buffer) {
     return Status::OK();
 }
 
+/**
+ * A validator for the common case of a valid document, which only answers whether the document is
+ * valid and does so with straight-line bounds checks instead of the state machine above. It accepts
+ * exactly the documents validateBSONIterative accepts, except that it gives up on code with scope
+ * and on nesting deeper than kMaxDepth, leaving those, and reporting errors, to the state machine.
+ */
+class FastPathValidator {
+public:
+    static constexpr size_t kMaxDepth = 32;
+
+    FastPathValidator(const char* buffer, uint64_t maxLength)
+        : _buffer(buffer),
+          _maxLength(maxLength),
+          _maxDepth(std::min<size_t>(kMaxDepth, BSONDepth::getMaxAllowableDepth())) {}
+
+    bool validate() {
+        uint64_t position = 0;
+        return _validateObject(&position, 0);
+    }
+
+private:
+    // Mirrors Buffer::skip, which requires something to follow the skipped bytes.
+    bool _skip(uint64_t* position, uint64_t size) const {
+        *position += size;
+        return *position < _maxLength;
+    }
+
+    bool _readInt(uint64_t* position, int32_t* out) const {
+        if (*position + sizeof(int32_t) > _maxLength)
+            return false;
+        *out = ConstDataView(_buffer).read<LittleEndian<int32_t>>(*position);
+        *position += sizeof(int32_t);
+        return true;
+    }
+
+    bool _skipCString(uint64_t* position) const {
+        const void* end = memchr(_buffer + *position, 0, _maxLength - *position);
+        if (!end)
+            return false;
+        *position = static_cast<const char*>(end) - _buffer + 1;
+        return true;
+    }
+
+    bool _skipString(uint64_t* position) const {
+        int32_t size;
+        if (!_readInt(position, &size) || size <= 0)
+            return false;
+        if (!_skip(position, size - 1) || _buffer[*position] != 0)
+            return false;
+        ++*position;
+        return true;
+    }
+
+    // 'depth' is the number of objects enclosing this one.
+    bool _validateObject(uint64_t* position, size_t depth) const {
+        if (depth > _maxDepth)
+            return false;
+
+        const uint64_t startPosition = *position;
+        int32_t expectedSize;
+        if (!_readInt(position, &expectedSize))
+            return false;
+
+        while (true) {
+            if (*position >= _maxLength)
+                return false;
+            const signed char type = _buffer[(*position)++];
+            if (type == EOO)
+                break;
+
+            if (!_skipCString(position))
+                return false;
+
+            bool ok;
+            switch (type) {
+                case MinKey:
+                case MaxKey:
+                case jstNULL:
+                case Undefined:
+                    ok = true;
+                    break;
+                case jstOID:
+                    ok = _skip(position, OID::kOIDSize);
+                    break;
+                case NumberInt:
+                    ok = _skip(position, sizeof(int32_t));
+                    break;
+                case Bool:
+                    ok = *position < _maxLength &&
+                        static_cast<uint8_t>(_buffer[*position]) <= 1;
+                    ++*position;
+                    break;
+                case NumberDouble:
+                case NumberLong:
+                case bsonTimestamp:
+                case Date:
+                    ok = _skip(position, sizeof(int64_t));
+                    break;
+                case NumberDecimal:
+                    ok = _skip(position, sizeof(Decimal128::Value));
+                    break;
+                case DBRef:
+                    ok = _skipString(position) && _skip(position, OID::kOIDSize);
+                    break;
+                case RegEx:
+                    ok = _skipCString(position) && _skipCString(position);
+                    break;
+                case Code:
+                case Symbol:
+                case String:
+                    ok = _skipString(position);
+                    break;
+                case BinData: {
+                    int32_t size;
+                    ok = _readInt(position, &size) && size >= 0 &&
+                        size != std::numeric_limits<int>::max() && _skip(position, 1 + size);
+                    break;
+                }
+                case Object:
+                case Array:
+                    ok = _validateObject(position, depth + 1);
+                    break;
+                default:
+                    // Includes CodeWScope, which is left to the state machine.
+                    return false;
+            }
+
+            if (!ok)
+                return false;
+        }
+
+        return *position - startPosition == static_cast<uint64_t>(expectedSize);
+    }
+
+    const char* const _buffer;
+    const uint64_t _maxLength;
+    const size_t _maxDepth;
+};
+
 }  // namespace
 
 Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion version) {
@@ -421,6 +560,20 @@ Status validateBSON(const char* originalBuffer, uint64_t maxLength, BSONVersion
         return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
     }
 
+    if (FastPathValidator(originalBuffer, maxLength).validate()) {
+        return Status::OK();
+    }
+
+    return validateBSONWithoutFastPath_forTest(originalBuffer, maxLength, version);
+}
+
+Status validateBSONWithoutFastPath_forTest(const char* originalBuffer,
+                                           uint64_t maxLength,
+                                           BSONVersion version) {
+    if (maxLength < 5) {
+        return Status(ErrorCodes::InvalidBSON, "bson data has to be at least 5 bytes");
+    }
+
     Buffer buf(originalBuffer, maxLength, version);
     return validateBSONIterative(&buf);
 }
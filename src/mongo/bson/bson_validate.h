@@ -46,4 +46,12 @@ class Status;
  */
 Status validateBSON(const char* buf, uint64_t maxLength, BSONVersion version);
 
+/**
+ * Validates like validateBSON, but without first trying the fast path that validateBSON uses for
+ * valid documents. Exposed to compare both in tests and benchmarks.
+ */
+Status validateBSONWithoutFastPath_forTest(const char* buf,
+                                           uint64_t maxLength,
+                                           BSONVersion version);
+
 }  // namespace mongo
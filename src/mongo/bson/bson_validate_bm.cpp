@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Document shapes to validate, selected by the benchmark argument.
+ */
+enum Corpus { kFlat = 0, kWide, kNested, kStrings };
+
+BSONObj makeDocument(int corpus) {
+    BSONObjBuilder builder;
+    builder.append("_id", OID::gen());
+    switch (corpus) {
+        case kFlat:
+            // A typical small document: a few scalars and a short string.
+            builder.append("name", "a short name");
+            builder.append("count", 42);
+            builder.append("total", 12345678LL);
+            builder.append("ratio", 0.5);
+            builder.append("active", true);
+            builder.appendDate("created", Date_t::fromMillisSinceEpoch(1500000000000LL));
+            break;
+        case kWide:
+            // Many top-level fields of mixed types.
+            for (int i = 0; i < 300; ++i) {
+                const std::string fieldName = str::stream() << "field" << i;
+                switch (i % 4) {
+                    case 0:
+                        builder.append(fieldName, i);
+                        break;
+                    case 1:
+                        builder.append(fieldName, static_cast<long long>(i));
+                        break;
+                    case 2:
+                        builder.append(fieldName, "value");
+                        break;
+                    case 3:
+                        builder.append(fieldName, i * 1.5);
+                        break;
+                }
+            }
+            break;
+        case kNested: {
+            // An array of small subdocuments, as in embedded line items.
+            BSONArrayBuilder items(builder.subarrayStart("items"));
+            for (int i = 0; i < 100; ++i) {
+                items.append(BSON("sku" << i << "qty" << 2 << "price" << 9.99 << "tags"
+                                        << BSON_ARRAY("a"
+                                                      << "b")));
+            }
+            items.done();
+            break;
+        }
+        case kStrings:
+            // A few long strings, as in text-heavy documents.
+            for (int i = 0; i < 8; ++i) {
+                builder.append(str::stream() << "text" << i, std::string(2048, 'x'));
+            }
+            break;
+    }
+    return builder.obj();
+}
+
+void BM_ValidateBSON(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(validateBSON(doc.objdata(), doc.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.objsize());
+}
+
+void BM_ValidateBSONWithoutFastPath(benchmark::State& state) {
+    const BSONObj doc = makeDocument(state.range(0));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(validateBSONWithoutFastPath_forTest(
+            doc.objdata(), doc.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * doc.objsize());
+}
+
+BENCHMARK(BM_ValidateBSON)->ArgName("corpus")->DenseRange(kFlat, kStrings);
+BENCHMARK(BM_ValidateBSONWithoutFastPath)->ArgName("corpus")->DenseRange(kFlat, kStrings);
+
+}  // namespace
+}  // namespace mongo
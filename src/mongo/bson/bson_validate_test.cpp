@@ -194,6 +194,64 @@ TEST(BSONValidate, Fuzz) {
     }
 }
 
+TEST(BSONValidate, FastPathAgreesWithStateMachineOnFuzzedData) {
+    PseudoRandom randomSource(4321);
+
+    BSONObj original = BSON("one" << 3 << "two" << true << "three" << BSONObj() << "four"
+                                  << BSON("five" << BSON("six" << 11LL))
+                                  << "seven"
+                                  << BSON_ARRAY("a"
+                                                << "bb" << 5.5 << BSONNULL << MINKEY)
+                                  << "eight"
+                                  << BSONDBRef("rrr", OID("01234567890123456789aaaa"))
+                                  << "_id"
+                                  << OID("deadbeefdeadbeefdeadbeef")
+                                  << "nine"
+                                  << BSONBinData("\x69\xb7", 2, BinDataGeneral)
+                                  << "ten"
+                                  << Date_t::fromMillisSinceEpoch(44)
+                                  << "eleven"
+                                  << BSONRegEx("foooooo", "i")
+                                  << "twelve"
+                                  << Decimal128("1.5")
+                                  << "thirteen"
+                                  << Timestamp(1, 2));
+
+    int numValid = 0;
+    for (int run = 0; run < 10000; ++run) {
+        unique_ptr<char[]> buffer(new char[original.objsize()]);
+        memcpy(buffer.get(), original.objdata(), original.objsize());
+
+        const int32_t fuzzFrequency = 50 + randomSource.nextInt32(2000);
+        for (int32_t byteIdx = 4; byteIdx < original.objsize(); ++byteIdx) {
+            for (int32_t bitIdx = 0; bitIdx < 8; ++bitIdx) {
+                if (randomSource.nextInt32(fuzzFrequency) == 0) {
+                    reinterpret_cast<unsigned char&>(buffer[byteIdx]) ^= (1U << bitIdx);
+                }
+            }
+        }
+
+        const Status withFastPath =
+            validateBSON(buffer.get(), original.objsize(), BSONVersion::kLatest);
+        const Status withoutFastPath = validateBSONWithoutFastPath_forTest(
+            buffer.get(), original.objsize(), BSONVersion::kLatest);
+        ASSERT_EQ(withoutFastPath.isOK(), withFastPath.isOK());
+        numValid += withFastPath.isOK();
+    }
+    ASSERT_GT(numValid, 0);
+}
+
+TEST(BSONValidate, FastPathLeavesDeepAndCodeWithScopeDocumentsToStateMachine) {
+    BSONObj deep = BSON("x" << 1);
+    for (int i = 0; i < 50; ++i) {
+        deep = BSON("a" << deep);
+    }
+    ASSERT_OK(validateBSON(deep.objdata(), deep.objsize(), BSONVersion::kLatest));
+
+    BSONObj withScope = BSON("a" << BSONCodeWScope("x", BSON("y" << 1)));
+    ASSERT_OK(validateBSON(withScope.objdata(), withScope.objsize(), BSONVersion::kLatest));
+}
+
 TEST(BSONValidateFast, Empty) {
     BSONObj x;
     ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
@@ -31,6 +31,7 @@
 
 #include <cmath>
 #include <cstdint>
+#include <sstream>
 #include <string.h>  // strlen
 #include <string>
 #include <vector>
@@ -210,6 +211,15 @@ public:
     std::string jsonString(JsonStringFormat format,
                            bool includeFieldNames = true,
                            int pretty = 0) const;
+
+    /**
+     * Appends the same string as jsonString() to 's', so that the elements of a document are all
+     * formatted into one stream.
+     */
+    void jsonStringStream(JsonStringFormat format,
+                          bool includeFieldNames,
+                          int pretty,
+                          std::stringstream& s) const;
     operator std::string() const {
         return toString();
     }
@@ -117,13 +117,26 @@ string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) co
     if (isEmpty())
         return isArray ? "[]" : "{}";
 
-    StringBuilder s;
+    std::stringstream s;
+    jsonStringStream(format, pretty, isArray, s);
+    return s.str();
+}
+
+void BSONObj::jsonStringStream(JsonStringFormat format,
+                               int pretty,
+                               bool isArray,
+                               std::stringstream& s) const {
+    if (isEmpty()) {
+        s << (isArray ? "[]" : "{}");
+        return;
+    }
+
     s << (isArray ? "[ " : "{ ");
     BSONObjIterator i(*this);
     BSONElement e = i.next();
     if (!e.eoo())
         while (1) {
-            s << e.jsonString(format, !isArray, pretty ? pretty + 1 : 0);
+            e.jsonStringStream(format, !isArray, pretty ? pretty + 1 : 0, s);
             e = i.next();
             if (e.eoo())
                 break;
@@ -137,7 +150,6 @@ string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) co
             }
         }
     s << (isArray ? " ]" : " }");
-    return s.str();
 }
 
 bool BSONObj::valid(BSONVersion version) const {
@@ -254,6 +254,12 @@ public:
                            int pretty = 0,
                            bool isArray = false) const;
 
+    /** Appends the same string as jsonString() to 's'. */
+    void jsonStringStream(JsonStringFormat format,
+                          int pretty,
+                          bool isArray,
+                          std::stringstream& s) const;
+
     /** note: addFields always adds _id even if not specified */
     int addFields(BSONObj& from, std::set<std::string>& fields); /* returns n added */
 
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+namespace {
+
+const Date_t kDate = Date_t::fromMillisSinceEpoch(1500000000000LL);
+
+void BM_AppendScalars(benchmark::State& state) {
+    const int numFields = state.range(0);
+    std::vector<std::string> fieldNames;
+    for (int i = 0; i < numFields; ++i) {
+        fieldNames.push_back(str::stream() << "field" << i);
+    }
+
+    long long bytes = 0;
+    for (auto keepRunning : state) {
+        BSONObjBuilder builder;
+        for (int i = 0; i < numFields; ++i) {
+            switch (i % 6) {
+                case 0:
+                    builder.append(fieldNames[i], i);
+                    break;
+                case 1:
+                    builder.append(fieldNames[i], static_cast<long long>(i));
+                    break;
+                case 2:
+                    builder.append(fieldNames[i], i * 0.5);
+                    break;
+                case 3:
+                    builder.append(fieldNames[i], "a short string");
+                    break;
+                case 4:
+                    builder.appendBool(fieldNames[i], true);
+                    break;
+                case 5:
+                    builder.appendDate(fieldNames[i], kDate);
+                    break;
+            }
+        }
+        BSONObj obj = builder.obj();
+        bytes += obj.objsize();
+        benchmark::DoNotOptimize(obj.objdata());
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_AppendSubobjects(benchmark::State& state) {
+    const int numItems = state.range(0);
+    long long bytes = 0;
+    for (auto keepRunning : state) {
+        BSONObjBuilder builder;
+        builder.append("_id", 1);
+        {
+            BSONArrayBuilder items(builder.subarrayStart("items"));
+            for (int i = 0; i < numItems; ++i) {
+                BSONObjBuilder item(items.subobjStart());
+                item.append("sku", i);
+                item.append("qty", 2);
+                item.append("price", 9.99);
+            }
+        }
+        BSONObj obj = builder.obj();
+        bytes += obj.objsize();
+        benchmark::DoNotOptimize(obj.objdata());
+    }
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_AppendElements(benchmark::State& state) {
+    // Copying the elements of an existing document, as projections and updates do.
+    BSONObjBuilder sourceBuilder;
+    for (int i = 0; i < state.range(0); ++i) {
+        sourceBuilder.append(str::stream() << "field" << i, i);
+    }
+    const BSONObj source = sourceBuilder.obj();
+
+    for (auto keepRunning : state) {
+        BSONObjBuilder builder;
+        for (auto&& element : source) {
+            builder.append(element);
+        }
+        benchmark::DoNotOptimize(builder.done().objdata());
+    }
+    state.SetBytesProcessed(state.iterations() * source.objsize());
+}
+
+BENCHMARK(BM_AppendScalars)->ArgName("fields")->Arg(6)->Arg(60)->Arg(600);
+BENCHMARK(BM_AppendSubobjects)->ArgName("items")->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_AppendElements)->ArgName("fields")->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace mongo
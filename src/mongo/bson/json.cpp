@@ -60,13 +60,14 @@ using std::string;
 #define CONTROL "\a\b\f\n\r\t\v"
 #define JOPTIONS "gims"
 
-// Size hints given to char vectors
+// Size hints given to char vectors. Field names and string values are usually short, and are
+// parsed into strings which grow as needed, so their hints are small.
 enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
+    FIELD_RESERVE_SIZE = 64,
+    STRINGVAL_RESERVE_SIZE = 64,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -80,6 +81,16 @@ static const char *LBRACE = "{", *RBRACE = "}", *LBRACKET = "[", *RBRACKET = "]"
                   *RPAREN = ")", *COLON = ":", *COMMA = ",", *FORWARDSLASH = "/",
                   *SINGLEQUOTE = "'", *DOUBLEQUOTE = "\"";
 
+namespace {
+
+// Whether 'c' may appear in an unquoted field name after its first character: [A-Za-z0-9$_].
+inline bool isUnquotedFieldChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+        c == '$';
+}
+
+}  // namespace
+
 JParse::JParse(StringData str)
     : _buf(str.rawData()), _input(_buf), _input_end(_input + str.size()) {}
 
@@ -314,17 +325,18 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // Reuse the buffer of the first field name for the remaining ones.
+        std::string& nextField = firstField;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
-            Status fieldRet = field(&fieldName);
+            nextField.clear();
+            Status fieldRet = field(&nextField);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
             }
             if (!readToken(COLON)) {
                 return parseError("Expecting ':'");
             }
-            Status valueRet = value(fieldName, *objBuilder);
+            Status valueRet = value(nextField, *objBuilder);
             if (valueRet != Status::OK()) {
                 return valueRet;
             }
@@ -1062,7 +1074,15 @@ Status JParse::field(std::string* result) {
         if (!match(*_input, ALPHA "_$")) {
             return parseError("First character in field must be [A-Za-z$_]");
         }
-        return chars(result, "", ALPHA DIGIT "_$");
+        const char* start = _input;
+        while (_input < _input_end && isUnquotedFieldChar(*_input)) {
+            ++_input;
+        }
+        if (_input >= _input_end) {
+            return parseError("Unexpected end of input");
+        }
+        result->append(start, _input - start);
+        return Status::OK();
     }
 }
 
@@ -1100,7 +1120,27 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
         return parseError("Unexpected end of input");
     }
     const char* q = _input;
-    while (q < _input_end && !match(*q, terminalSet)) {
+
+    // A string ended by a single character, like a quoted string, is copied a run at a time,
+    // up to the next character which needs a closer look.
+    const char singleTerminal =
+        (allowedSet == NULL && terminalSet[0] != '\0' && terminalSet[1] == '\0') ? terminalSet[0]
+                                                                                 : '\0';
+    while (q < _input_end) {
+        if (singleTerminal != '\0') {
+            const char* run = q;
+            while (q < _input_end && *q != singleTerminal && *q != '\\' &&
+                   static_cast<unsigned char>(*q) > 0x1F) {
+                ++q;
+            }
+            result->append(run, q - run);
+            if (q >= _input_end) {
+                break;
+            }
+        }
+        if (match(*q, terminalSet)) {
+            break;
+        }
         MONGO_JSON_DEBUG("q: " << q);
         if (allowedSet != NULL) {
             if (!match(*q, allowedSet)) {
@@ -1294,8 +1334,13 @@ BSONObj fromjson(const char* jsonString, int* len) {
             *len = 0;
         return BSONObj();
     }
-    JParse jparse(jsonString);
-    BSONObjBuilder builder;
+    const StringData input(jsonString);
+    JParse jparse(input);
+
+    // BSON is usually no larger than the JSON it is parsed from, so size the builder for the
+    // input, up to a limit for inputs holding many documents.
+    const size_t kMaxInitialBuilderSize = 64 * 1024;
+    BSONObjBuilder builder(std::min(input.size() + 1, kMaxInitialBuilderSize));
     Status ret = Status::OK();
     try {
         ret = jparse.parse(builder);
@@ -39,6 +39,7 @@
 
 #include <boost/optional.hpp>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/disallow_copying.h"
@@ -75,10 +76,21 @@ const int BufferMaxSize = 64 * 1024 * 1024;
 template <typename Allocator>
 class StringBuilderImpl;
 
+/**
+ * Counts the times BufBuilders have grown their buffers, and the bytes they held when they did,
+ * which is an upper bound on the bytes copied by those reallocations.
+ */
+struct BufBuilderGrowthStats {
+    static Counter64 reallocations;
+    static Counter64 bytesReallocated;
+};
+
 class SharedBufferAllocator {
     MONGO_DISALLOW_COPYING(SharedBufferAllocator);
 
 public:
+    static constexpr size_t kAllocationOverhead = SharedBuffer::allocationOverhead();
+
     SharedBufferAllocator() = default;
     SharedBufferAllocator(SharedBuffer buf) : _buf(std::move(buf)) {
         invariant(!_buf.isShared());
@@ -119,6 +131,8 @@ public:
         free();
     }
 
+    static constexpr size_t kAllocationOverhead = 0;
+
     enum { SZ = 512 };
     void malloc(size_t sz) {
         if (sz > SZ)
@@ -346,12 +360,18 @@ private:
             msgasserted(13548, ss.str().c_str());
         }
 
+        // Grow to a power of two including the allocator's own header, so that the allocation fills
+        // a size class of the underlying allocator rather than spilling just past one.
+        const int overhead = BufferAllocator::kAllocationOverhead;
         int a = 64;
-        while (a < minSize)
+        while (a - overhead < minSize)
             a = a * 2;
 
-        _buf.realloc(a);
-        size = a;
+        BufBuilderGrowthStats::reallocations.increment();
+        BufBuilderGrowthStats::bytesReallocated.increment(size);
+
+        _buf.realloc(a - overhead);
+        size = a - overhead;
     }
 
     BufferAllocator _buf;
@@ -84,6 +84,30 @@ TEST(Builder, StackAllocatorShouldNotLeak) {
     // Let the builder go out of scope. If this leaks, it will trip the ASAN leak detector.
 }
 
+TEST(Builder, GrowthAllocatesPowersOfTwoIncludingOverhead) {
+    const long long reallocationsBefore = BufBuilderGrowthStats::reallocations.get();
+    const long long bytesReallocatedBefore = BufBuilderGrowthStats::bytesReallocated.get();
+
+    BufBuilder bb(512);
+    const std::string chunk(1000, 'x');
+    bb.appendStr(chunk, false);
+    ASSERT_EQ(1024U, bb.getSize() + SharedBufferAllocator::kAllocationOverhead);
+
+    bb.appendStr(chunk, false);
+    ASSERT_EQ(2048U, bb.getSize() + SharedBufferAllocator::kAllocationOverhead);
+
+    ASSERT_EQ(2, BufBuilderGrowthStats::reallocations.get() - reallocationsBefore);
+    ASSERT_EQ(512 + 1024 - static_cast<long long>(SharedBufferAllocator::kAllocationOverhead),
+              BufBuilderGrowthStats::bytesReallocated.get() - bytesReallocatedBefore);
+}
+
+TEST(Builder, StackBufBuilderGrowthAllocatesPowersOfTwo) {
+    StackBufBuilder bb;
+    const std::string chunk(1000, 'x');
+    bb.appendStr(chunk, false);
+    ASSERT_EQ(1024, bb.getSize());
+}
+
 template <typename T>
 void testStringBuilderIntegral() {
     auto check = [](T num) { ASSERT_EQ(std::string(str::stream() << num), std::to_string(num)); };
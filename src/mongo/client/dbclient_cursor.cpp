@@ -44,6 +44,7 @@
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata.h"
 #include "mongo/rpc/object_check.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/bufreader.h"
@@ -61,6 +62,18 @@ using std::string;
 using std::vector;
 
 namespace {
+
+// The fraction of a batch, in (0, 1], that must have been returned by next() before the getMore for
+// the following batch is sent ahead of time. 0 disables prefetching. See setPrefetchThreshold().
+MONGO_EXPORT_SERVER_PARAMETER(dbClientCursorPrefetchThreshold, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 0.0 || newVal > 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "dbClientCursorPrefetchThreshold must be between 0 and 1");
+        }
+        return Status::OK();
+    });
+
 Message assembleCommandRequest(DBClientBase* cli,
                                StringData database,
                                int legacyQueryOptions,
@@ -208,7 +221,6 @@ void DBClientCursor::requestMore() {
         return exhaustReceiveMore();
     }
 
-    invariant(!_connectionHasPendingReplies);
     verify(cursorId && batch.pos == batch.objs.size());
 
     if (haveLimit) {
@@ -216,6 +228,12 @@ void DBClientCursor::requestMore() {
         verify(nToReturn > 0);
     }
 
+    if (_prefetchPending) {
+        return _receivePrefetchedBatch();
+    }
+
+    invariant(!_connectionHasPendingReplies);
+
     auto doRequestMore = [&] {
         Message toSend = _assembleGetMore();
         Message response;
@@ -233,6 +251,52 @@ void DBClientCursor::requestMore() {
     });
 }
 
+void DBClientCursor::setPrefetchThreshold(double threshold) {
+    invariant(threshold >= 0.0 && threshold <= 1.0);
+    _prefetchThreshold = threshold;
+}
+
+void DBClientCursor::_prefetchMoreIfNeeded() {
+    if (_prefetchThreshold == 0.0 || _prefetchPending || _connectionHasPendingReplies || !cursorId)
+        return;
+
+    if (batch.pos < batch.objs.size() * _prefetchThreshold)
+        return;
+
+    // Exhaust cursors are already streamed by the server and a getMore on a tailable cursor may
+    // block waiting for data. Only a direct network connection is guaranteed to send the getMore to
+    // the host that owns the cursor and to hold the reply until it is received.
+    if ((opts & (QueryOption_Exhaust | QueryOption_CursorTailable)) || !_client ||
+        _client->type() != ConnectionString::MASTER || !_client->lazySupported())
+        return;
+
+    // The getMore asks only for what is left once the current batch has been consumed. The
+    // remaining count itself is adjusted in requestMore(), as it is for an ordinary getMore.
+    int remaining = nToReturn;
+    if (haveLimit) {
+        if (nToReturn <= static_cast<int>(batch.objs.size()))
+            return;
+        nToReturn -= batch.objs.size();
+    }
+    ON_BLOCK_EXIT([&] { nToReturn = remaining; });
+
+    Message toSend = _assembleGetMore();
+    _client->say(toSend);
+    _lastRequestId = toSend.header().getId();
+    _connectionHasPendingReplies = true;
+    _prefetchPending = true;
+}
+
+void DBClientCursor::_receivePrefetchedBatch() {
+    invariant(_prefetchPending);
+    Message response;
+    bool recvd = _client->recv(response, _lastRequestId);
+    _prefetchPending = false;
+    _connectionHasPendingReplies = false;
+    uassert(50911, "recv failed while receiving prefetched batch", recvd);
+    dataReceived(response);
+}
+
 /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
 void DBClientCursor::exhaustReceiveMore() {
     verify(cursorId && batch.pos == batch.objs.size());
@@ -377,7 +441,9 @@ BSONObj DBClientCursor::next() {
         13422, "DBClientCursor next() called but more() is false", batch.pos < batch.objs.size());
 
     /* todo would be good to make data null at end of batch for safety */
-    return std::move(batch.objs[batch.pos++]);
+    BSONObj ret = std::move(batch.objs[batch.pos++]);
+    _prefetchMoreIfNeeded();
+    return ret;
 }
 
 BSONObj DBClientCursor::nextSafe() {
@@ -429,6 +495,7 @@ bool DBClientCursor::peekError(BSONObj* error) {
 
 void DBClientCursor::attach(AScopedConnection* conn) {
     verify(_scopedHost.size() == 0);
+    invariant(!_prefetchPending);
     verify(conn);
     verify(conn->get());
 
@@ -512,7 +579,8 @@ DBClientCursor::DBClientCursor(DBClientBase* client,
       cursorId(cursorId),
       _ownCursor(true),
       wasError(false),
-      _enabledBSONVersion(Validator<BSONObj>::enabledBSONVersion()) {
+      _enabledBSONVersion(Validator<BSONObj>::enabledBSONVersion()),
+      _prefetchThreshold(dbClientCursorPrefetchThreshold.load()) {
     if (queryOptions & QueryOptionLocal_forceOpQuery)
         _useFindCommand = false;
 }
@@ -523,6 +591,11 @@ DBClientCursor::~DBClientCursor() {
 
 void DBClientCursor::kill() {
     DESTRUCTOR_GUARD({
+        if (_prefetchPending) {
+            // Read the reply to the prefetched getMore, so that the connection can be reused.
+            _receivePrefetchedBatch();
+        }
+
         if (cursorId && _ownCursor && !globalInShutdownDeprecated()) {
             auto killCursor = [&](auto&& conn) {
                 if (_useFindCommand) {
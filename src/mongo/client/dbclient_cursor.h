@@ -134,6 +134,18 @@ public:
         batchSize = newBatchSize;
     }
 
+    /**
+     * Once 'threshold', a fraction in [0, 1], of the current batch has been returned by next(),
+     * the getMore for the following batch is sent without waiting for its reply, which is read
+     * when the current batch runs out. This hides the round trip at each batch boundary from
+     * callers that consume the cursor at a steady rate. 0 disables prefetching. Defaults to the
+     * dbClientCursorPrefetchThreshold server parameter.
+     *
+     * Prefetching only happens on direct connections for cursors that are neither exhaust nor
+     * tailable. While a getMore is outstanding, connectionHasPendingReplies() returns true.
+     */
+    void setPrefetchThreshold(double threshold);
+
 
     /**
      * Fold this in with queryOptions to force the use of legacy query operations.
@@ -211,8 +223,8 @@ public:
      * If true, you should not try to use the connection for any other purpose or return it to a
      * pool.
      *
-     * This can happen if either initLazy() was called without initLazyFinish() or an exhaust query
-     * was started but not completed.
+     * This can happen if either initLazy() was called without initLazyFinish(), an exhaust query
+     * was started but not completed or a prefetched getMore has not been received yet.
      */
     bool connectionHasPendingReplies() const {
         return _connectionHasPendingReplies;
@@ -264,6 +276,8 @@ private:
     bool _useFindCommand = true;
     bool _connectionHasPendingReplies = false;
     int _lastRequestId = 0;
+    double _prefetchThreshold;
+    bool _prefetchPending = false;
 
     void dataReceived(const Message& reply) {
         bool retry;
@@ -280,6 +294,17 @@ private:
 
     void requestMore();
 
+    /**
+     * Sends the getMore for the next batch if prefetching is enabled and enough of the current
+     * batch has been consumed.
+     */
+    void _prefetchMoreIfNeeded();
+
+    /**
+     * Reads the reply to the prefetched getMore into the batch.
+     */
+    void _receivePrefetchedBatch();
+
     // init pieces
     Message _assembleInit();
     Message _assembleGetMore();
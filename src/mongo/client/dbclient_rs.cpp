@@ -45,6 +45,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -532,8 +533,10 @@ unique_ptr<DBClientCursor> DBClientReplicaSet::query(const string& ns,
                     break;
                 }
 
+                Timer timer;
                 unique_ptr<DBClientCursor> cursor = conn->query(
                     ns, query, nToReturn, nToSkip, fieldsToReturn, queryOptions, batchSize);
+                _recordSecondaryLatency(timer);
 
                 return checkSlaveQueryResult(std::move(cursor));
             } catch (const DBException& ex) {
@@ -584,7 +587,11 @@ BSONObj DBClientReplicaSet::findOne(const string& ns,
                     break;
                 }
 
-                return conn->findOne(ns, query, fieldsToReturn, queryOptions);
+                Timer timer;
+                BSONObj result = conn->findOne(ns, query, fieldsToReturn, queryOptions);
+                _recordSecondaryLatency(timer);
+
+                return result;
             } catch (const DBException& ex) {
                 const Status status = ex.toStatus(str::stream() << "can't findone replica set node "
                                                                 << _lastSlaveOkHost.toString());
@@ -649,6 +656,10 @@ unique_ptr<DBClientCursor> DBClientReplicaSet::checkSlaveQueryResult(
     return result;
 }
 
+void DBClientReplicaSet::_recordSecondaryLatency(const Timer& timer) {
+    _getMonitor()->recordOperationLatency(_lastSlaveOkHost, timer.elapsed());
+}
+
 void DBClientReplicaSet::isntSecondary() {
     // Failover to next slave
     _getMonitor()->failedHost(
@@ -929,7 +940,11 @@ std::pair<rpc::UniqueReply, DBClientBase*> DBClientReplicaSet::runCommandWithTar
                 break;
             }
             // We can't move the request since we need it to retry.
-            return conn->runCommandWithTarget(request);
+            Timer timer;
+            auto out = conn->runCommandWithTarget(request);
+            _recordSecondaryLatency(timer);
+
+            return out;
         } catch (const DBException& ex) {
             _invalidateLastSlaveOkCache(ex.toStatus());
         }
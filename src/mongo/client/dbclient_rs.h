@@ -39,6 +39,7 @@ namespace mongo {
 
 class ReplicaSetMonitor;
 class TagSet;
+class Timer;
 struct ReadPreferenceSetting;
 typedef std::shared_ptr<ReplicaSetMonitor> ReplicaSetMonitorPtr;
 
@@ -276,6 +277,12 @@ private:
      */
     void _invalidateLastSlaveOkCache(const Status& status);
 
+    /**
+     * Reports the time elapsed on 'timer' as the latency of an operation on the last slaveOk
+     * host to the replica set monitor, which can rank hosts by it during selection.
+     */
+    void _recordSecondaryLatency(const Timer& timer);
+
     void _authConnection(DBClientConnection* conn);
 
     /**
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
@@ -106,6 +108,30 @@ public:
      */
     virtual void markHostUnreachable(const HostAndPort& host, const Status& status) = 0;
 
+    /**
+     * Returns a host other than 'excluded' which matches readPref, based only on the targeter's
+     * cached view, or boost::none if there is no such host. Used to pick the target of a hedged
+     * read. Targeters for a single host never have an alternate host.
+     */
+    virtual boost::optional<HostAndPort> findAlternateHostNoWait(
+        const ReadPreferenceSetting& readPref, const HostAndPort& excluded) {
+        return boost::none;
+    }
+
+    /**
+     * Reports to the targeter that an operation run on 'host' took 'latency' from sending the
+     * request to receiving its reply, so that it may take it into account when selecting hosts.
+     */
+    virtual void recordOperationLatency(const HostAndPort& host, Microseconds latency) {}
+
+    /**
+     * Returns the given percentile, between 0 and 100, of the operation latencies recently
+     * reported through recordOperationLatency, or boost::none if they are not tracked.
+     */
+    virtual boost::optional<Microseconds> getOperationLatencyPercentile(double percentile) {
+        return boost::none;
+    }
+
 protected:
     RemoteCommandTargeter() = default;
 };
@@ -100,4 +100,29 @@ void RemoteCommandTargeterRS::markHostUnreachable(const HostAndPort& host, const
     _rsMonitor->failedHost(host, status);
 }
 
+boost::optional<HostAndPort> RemoteCommandTargeterRS::findAlternateHostNoWait(
+    const ReadPreferenceSetting& readPref, const HostAndPort& excluded) {
+    invariant(_rsMonitor);
+
+    auto host = _rsMonitor->getAlternateHost(readPref, excluded);
+    if (host.empty()) {
+        return boost::none;
+    }
+    return host;
+}
+
+void RemoteCommandTargeterRS::recordOperationLatency(const HostAndPort& host,
+                                                     Microseconds latency) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->recordOperationLatency(host, latency);
+}
+
+boost::optional<Microseconds> RemoteCommandTargeterRS::getOperationLatencyPercentile(
+    double percentile) {
+    invariant(_rsMonitor);
+
+    return _rsMonitor->getOperationLatencyPercentile(percentile);
+}
+
 }  // namespace mongo
@@ -62,6 +62,13 @@ public:
 
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    boost::optional<HostAndPort> findAlternateHostNoWait(const ReadPreferenceSetting& readPref,
+                                                         const HostAndPort& excluded) override;
+
+    void recordOperationLatency(const HostAndPort& host, Microseconds latency) override;
+
+    boost::optional<Microseconds> getOperationLatencyPercentile(double percentile) override;
+
 private:
     // Name of the replica set which this targeter maintains
     const std::string _rsName;
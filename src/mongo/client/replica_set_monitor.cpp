@@ -42,6 +42,9 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -68,6 +71,15 @@ MONGO_FAIL_POINT_DEFINE(failAsyncConfigChangeHook);
 // Failpoint for changing the default refresh period
 MONGO_FAIL_POINT_DEFINE(modifyReplicaSetMonitorDefaultRefreshPeriod);
 
+// When true, hosts which have operation latencies reported through
+// ReplicaSetMonitor::recordOperationLatency are ranked by those rather than by isMaster ping time.
+MONGO_EXPORT_SERVER_PARAMETER(replicaSetMonitorRankByOperationLatency, bool, false);
+
+// When true, after each refresh the monitor keeps an awaitable isMaster outstanding against the
+// primary, which replies as soon as the primary's topology version changes. A change triggers an
+// immediate refresh, and periodic refreshes become less frequent while the primary is watched.
+MONGO_EXPORT_SERVER_PARAMETER(replicaSetMonitorUseAwaitableIsMaster, bool, false);
+
 namespace {
 
 // Pull nested types to top-level scope
@@ -83,13 +95,24 @@ typedef SetState::Nodes Nodes;
 using executor::TaskExecutor;
 using CallbackArgs = TaskExecutor::CallbackArgs;
 using CallbackHandle = TaskExecutor::CallbackHandle;
+using RemoteCommandCallbackArgs = TaskExecutor::RemoteCommandCallbackArgs;
 
 const double socketTimeoutSecs = 5;
 
 // Intentionally chosen to compare worse than all known latencies.
 const int64_t unknownLatency = numeric_limits<int64_t>::max();
 
+// Number of recent operation latencies kept per set for percentile estimates.
+const size_t kMaxOperationLatencySamples = 256;
+
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly, TagSet());
+
+// While an awaitable isMaster watches the primary, periodic refreshes are this many times less
+// frequent, since they only need to catch changes on the other members.
+const int kAwaitableIsMasterRefreshPeriodMultiplier = 4;
+
+// How much longer than its maxAwaitTimeMS an awaitable isMaster may take before it times out.
+const Milliseconds kAwaitableIsMasterTimeoutMargin{5000};
 const Milliseconds kFindHostMaxBackOffTime(500);
 AtomicBool areRefreshRetriesDisabledForTest{false};  // Only true in tests.
 
@@ -109,11 +132,6 @@ bool opTimeGreater(const Node* lhs, const Node* rhs) {
     return lhs->opTime > rhs->opTime;
 }
 
-bool compareLatencies(const Node* lhs, const Node* rhs) {
-    // NOTE: this automatically compares Node::unknownLatency worse than all others.
-    return lhs->latencyMicros < rhs->latencyMicros;
-}
-
 bool hostsEqual(const Node& lhs, const HostAndPort& rhs) {
     return lhs.host == rhs;
 }
@@ -193,7 +211,8 @@ ReplicaSetMonitor::ReplicaSetMonitor(const MongoURI& uri)
     : _state(std::make_shared<SetState>(uri)), _executor(globalRSMonitorManager.getExecutor()) {}
 
 void ReplicaSetMonitor::init() {
-    _scheduleRefresh(_executor->now());
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _scheduleRefresh(_executor->now(), lk);
 }
 
 ReplicaSetMonitor::~ReplicaSetMonitor() {
@@ -210,9 +229,14 @@ ReplicaSetMonitor::~ReplicaSetMonitor() {
     // task to execute eliminating the need to call method "wait".
     //
     _refresherHandle = {};
+
+    if (_awaitableIsMasterHandle) {
+        _executor->cancel(_awaitableIsMasterHandle);
+        _awaitableIsMasterHandle = {};
+    }
 }
 
-void ReplicaSetMonitor::_scheduleRefresh(Date_t when) {
+void ReplicaSetMonitor::_scheduleRefresh(Date_t when, WithLock) {
     // Reschedule the refresh
     invariant(_executor);
 
@@ -221,7 +245,6 @@ void ReplicaSetMonitor::_scheduleRefresh(Date_t when) {
         return;
     }
 
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
     std::weak_ptr<ReplicaSetMonitor> that(shared_from_this());
     auto status = _executor->scheduleWorkAt(when, [that](const CallbackArgs& cbArgs) {
         if (!cbArgs.status.isOK())
@@ -249,8 +272,128 @@ void ReplicaSetMonitor::_scheduleRefresh(Date_t when) {
 void ReplicaSetMonitor::_doScheduledRefresh(const CallbackHandle& currentHandle) {
     startOrContinueRefresh().refreshAll();
 
+    if (replicaSetMonitorUseAwaitableIsMaster.load()) {
+        _startAwaitableIsMaster();
+    }
+
     // And now we set up the next one
-    _scheduleRefresh(_executor->now() + _state->refreshPeriod);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // If a topology change scheduled an immediate refresh while this one was running, that refresh
+    // sets up the next one instead.
+    if (currentHandle != _refresherHandle) {
+        return;
+    }
+
+    const auto refreshPeriod = _awaitableIsMasterHandle
+        ? _state->refreshPeriod * kAwaitableIsMasterRefreshPeriodMultiplier
+        : _state->refreshPeriod;
+    _scheduleRefresh(_executor->now() + refreshPeriod, lk);
+}
+
+void ReplicaSetMonitor::_refreshNow() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_refresherHandle) {
+        _executor->cancel(_refresherHandle);
+    }
+    _scheduleRefresh(_executor->now(), lk);
+}
+
+void ReplicaSetMonitor::_startAwaitableIsMaster() {
+    HostAndPort primary;
+    BSONObj topologyVersion;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        auto it = std::find_if(_state->nodes.begin(), _state->nodes.end(), isMaster);
+        if (it == _state->nodes.end() || it->topologyVersion.isEmpty()) {
+            return;
+        }
+        primary = it->host;
+        topologyVersion = it->topologyVersion;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_awaitableIsMasterHandle) {
+        return;
+    }
+    _scheduleAwaitableIsMaster(primary, topologyVersion, lk);
+}
+
+void ReplicaSetMonitor::_scheduleAwaitableIsMaster(const HostAndPort& host,
+                                                   const BSONObj& topologyVersion,
+                                                   WithLock) {
+    if (_isRemovedFromManager.load()) {
+        return;
+    }
+
+    const Milliseconds maxAwaitTime = _state->refreshPeriod;
+    executor::RemoteCommandRequest request(host,
+                                           "admin",
+                                           BSON("isMaster" << 1 << "topologyVersion"
+                                                           << topologyVersion
+                                                           << "maxAwaitTimeMS"
+                                                           << durationCount<Milliseconds>(
+                                                                  maxAwaitTime)),
+                                           nullptr,
+                                           maxAwaitTime + kAwaitableIsMasterTimeoutMargin);
+
+    std::weak_ptr<ReplicaSetMonitor> that(shared_from_this());
+    auto status = _executor->scheduleRemoteCommand(
+        request, [that, host, topologyVersion](const RemoteCommandCallbackArgs& cbData) {
+            if (auto ptr = that.lock()) {
+                ptr->_onAwaitableIsMasterResponse(host, topologyVersion, cbData);
+            }
+        });
+
+    if (!status.isOK()) {
+        LOG(1) << "Can't watch the topology of replica set " << getName() << " on " << host
+               << causedBy(redact(status.getStatus()));
+        return;
+    }
+
+    _awaitableIsMasterHandle = status.getValue();
+}
+
+void ReplicaSetMonitor::_onAwaitableIsMasterResponse(const HostAndPort& host,
+                                                     const BSONObj& topologyVersion,
+                                                     const RemoteCommandCallbackArgs& cbData) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (cbData.myHandle != _awaitableIsMasterHandle) {
+            return;
+        }
+        _awaitableIsMasterHandle = {};
+    }
+
+    const auto& response = cbData.response;
+    if (response.status == ErrorCodes::CallbackCanceled ||
+        response.status == ErrorCodes::ShutdownInProgress) {
+        return;
+    }
+
+    Status status = response.status;
+    if (status.isOK()) {
+        status = getStatusFromCommandResult(response.data);
+    }
+
+    if (status.isOK()) {
+        const BSONObj newTopologyVersion = response.data.getObjectField("topologyVersion");
+        if (newTopologyVersion.binaryEqual(topologyVersion)) {
+            // Nothing changed within maxAwaitTimeMS, so keep waiting.
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (!_awaitableIsMasterHandle) {
+                _scheduleAwaitableIsMaster(host, topologyVersion, lk);
+            }
+            return;
+        }
+        LOG(1) << "Topology of replica set " << getName() << " changed on " << host
+               << ", refreshing";
+    } else {
+        LOG(1) << "Awaitable isMaster to " << host << " for replica set " << getName()
+               << " failed, refreshing" << causedBy(redact(status));
+    }
+
+    _refreshNow();
 }
 
 StatusWith<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreferenceSetting& criteria,
@@ -321,6 +464,51 @@ void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status
     DEV _state->checkInvariants();
 }
 
+HostAndPort ReplicaSetMonitor::getAlternateHost(const ReadPreferenceSetting& criteria,
+                                                const HostAndPort& excluded) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->getMatchingHost(criteria, excluded);
+}
+
+void ReplicaSetMonitor::recordOperationLatency(const HostAndPort& host, Microseconds latency) {
+    const int64_t micros = durationCount<Microseconds>(latency);
+    if (micros < 0)
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (!node)
+        return;
+    node->recordOperationLatency(micros);
+
+    auto& samples = _state->operationLatencySamples;
+    if (samples.size() < kMaxOperationLatencySamples) {
+        samples.push_back(micros);
+    } else {
+        samples[_state->nextOperationLatencySample] = micros;
+        _state->nextOperationLatencySample =
+            (_state->nextOperationLatencySample + 1) % kMaxOperationLatencySamples;
+    }
+}
+
+boost::optional<Microseconds> ReplicaSetMonitor::getOperationLatencyPercentile(
+    double percentile) const {
+    invariant(percentile >= 0 && percentile <= 100);
+
+    std::vector<int64_t> samples;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        samples = _state->operationLatencySamples;
+    }
+    if (samples.empty())
+        return boost::none;
+
+    const size_t rank =
+        std::min(samples.size() - 1, static_cast<size_t>(samples.size() * percentile / 100));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return Microseconds(samples[rank]);
+}
+
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -905,6 +1093,7 @@ void IsMasterReply::parse(const BSONObj& obj) {
         }
 
         tags = raw.getObjectField("tags");
+        topologyVersion = raw.getObjectField("topologyVersion");
         BSONObj lastWriteField = raw.getObjectField("lastWrite");
         if (!lastWriteField.isEmpty()) {
             if (auto lastWrite = lastWriteField["lastWriteDate"]) {
@@ -919,7 +1108,8 @@ void IsMasterReply::parse(const BSONObj& obj) {
     }
 }
 
-Node::Node(const HostAndPort& host) : host(host), latencyMicros(unknownLatency) {}
+Node::Node(const HostAndPort& host)
+    : host(host), latencyMicros(unknownLatency), operationLatencyMicros(unknownLatency) {}
 
 void Node::markFailed(const Status& status) {
     if (isUp) {
@@ -983,6 +1173,12 @@ void Node::update(const IsMasterReply& reply) {
             // update latency with smoothed moving average (1/4th the delta)
             latencyMicros += (reply.latencyMicros - latencyMicros) / 4;
         }
+
+        // Slowly pull the operation latency towards the ping time, so that a node which stopped
+        // being selected because of a burst of slow operations is eventually tried again.
+        if (operationLatencyMicros != unknownLatency) {
+            operationLatencyMicros += (latencyMicros - operationLatencyMicros) / 16;
+        }
     }
 
     LOG(3) << "Updating " << host << " lastWriteDate to " << reply.lastWriteDate;
@@ -990,14 +1186,35 @@ void Node::update(const IsMasterReply& reply) {
 
     LOG(3) << "Updating " << host << " opTime to " << reply.opTime;
     opTime = reply.opTime;
+
+    if (!topologyVersion.binaryEqual(reply.topologyVersion))
+        topologyVersion = reply.topologyVersion.getOwned();
     lastWriteDateUpdateTime = Date_t::now();
 }
 
+void Node::recordOperationLatency(int64_t micros) {
+    if (operationLatencyMicros == unknownLatency) {
+        operationLatencyMicros = micros;
+    } else {
+        // Same smoothing as the isMaster latency (1/4th the delta).
+        operationLatencyMicros += (micros - operationLatencyMicros) / 4;
+    }
+}
+
+int64_t Node::selectionLatencyMicros(bool useOperationLatency) const {
+    // NOTE: a node without any known latency compares worse than all others.
+    if (useOperationLatency && operationLatencyMicros != unknownLatency) {
+        return operationLatencyMicros;
+    }
+    return latencyMicros;
+}
+
 SetState::SetState(StringData name, const std::set<HostAndPort>& seedNodes)
     : name(name.toString()),
       consecutiveFailedScans(0),
       seedNodes(seedNodes),
       latencyThresholdMicros(serverGlobalParams.defaultLocalThresholdMillis * 1000),
+      rankByOperationLatency(replicaSetMonitorRankByOperationLatency.load()),
       rand(int64_t(time(0))),
       roundRobin(0),
       refreshPeriod(getDefaultRefreshPeriod()) {
@@ -1025,33 +1242,38 @@ SetState::SetState(const MongoURI& uri)
     setUri = uri;
 }
 
-HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria,
+                                      const HostAndPort& excluded) const {
     switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference::PrimaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excluded);
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
-            return getMatchingHost(ReadPreferenceSetting(
-                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            return getMatchingHost(
+                ReadPreferenceSetting(
+                    ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds),
+                excluded);
         }
 
         case ReadPreference::SecondaryPreferred: {
-            HostAndPort out = getMatchingHost(ReadPreferenceSetting(
-                ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(
+                    ReadPreference::SecondaryOnly, criteria.tags, criteria.maxStalenessSeconds),
+                excluded);
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excluded);
         }
 
         case ReadPreference::PrimaryOnly: {
             // NOTE: isMaster implies isUp
             Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
-            if (it == nodes.end())
+            if (it == nodes.end() || it->host == excluded)
                 return HostAndPort();
             return it->host;
         }
@@ -1106,8 +1328,8 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
 
                 std::vector<const Node*> matchingNodes;
                 for (size_t i = 0; i < nodes.size(); i++) {
-                    if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag) &&
-                        matchNode(nodes[i])) {
+                    if (nodes[i].host != excluded && nodes[i].matches(criteria.pref) &&
+                        nodes[i].matches(tag) && matchNode(nodes[i])) {
                         matchingNodes.push_back(&nodes[i]);
                     }
                 }
@@ -1142,10 +1364,17 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
 
                 // If there are multiple nodes satisfying the minOpTime, next order by latency
                 // and don't consider hosts further than a threshold from the closest.
-                std::sort(matchingNodes.begin(), matchingNodes.end(), compareLatencies);
+                const auto selectionLatency = [this](const Node* node) {
+                    return node->selectionLatencyMicros(rankByOperationLatency);
+                };
+                std::sort(matchingNodes.begin(),
+                          matchingNodes.end(),
+                          [&](const Node* lhs, const Node* rhs) {
+                              return selectionLatency(lhs) < selectionLatency(rhs);
+                          });
                 for (size_t i = 1; i < matchingNodes.size(); i++) {
                     int64_t distance =
-                        matchingNodes[i]->latencyMicros - matchingNodes[0]->latencyMicros;
+                        selectionLatency(matchingNodes[i]) - selectionLatency(matchingNodes[0]);
                     if (distance >= latencyThresholdMicros) {
                         // this node and all remaining ones are too far away
                         matchingNodes.erase(matchingNodes.begin() + i, matchingNodes.end());
@@ -28,6 +28,7 @@
 #pragma once
 
 #include <atomic>
+#include <boost/optional.hpp>
 #include <memory>
 #include <memory>
 #include <set>
@@ -39,6 +40,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -119,6 +121,29 @@ public:
      */
     void failedHost(const HostAndPort& host, const Status& status);
 
+    /**
+     * Returns a host other than 'excluded' matching the given read preference, or an empty host
+     * if there is no such host. Uses only cached information. Used to pick the target of a
+     * hedged read, which duplicates a read that is slow to complete on 'excluded'.
+     */
+    HostAndPort getAlternateHost(const ReadPreferenceSetting& criteria,
+                                 const HostAndPort& excluded) const;
+
+    /**
+     * Notifies this Monitor that an operation sent to 'host' completed after 'latency', measured
+     * by the caller from sending the request to receiving the reply. The latencies are tracked
+     * per host as a moving average, which is used to rank hosts for selection when the
+     * replicaSetMonitorRankByOperationLatency server parameter is enabled.
+     */
+    void recordOperationLatency(const HostAndPort& host, Microseconds latency);
+
+    /**
+     * Returns the given percentile, between 0 and 100, of the most recent operation latencies
+     * reported through recordOperationLatency for any host in this set, or boost::none if no
+     * latency has been reported.
+     */
+    boost::optional<Microseconds> getOperationLatencyPercentile(double percentile) const;
+
     /**
      * Returns true if this node is the master based ONLY on local data. Be careful, return may
      * be stale.
@@ -275,16 +300,45 @@ private:
     /**
      * Schedules a refresh via the task executor. (Task is automatically canceled in the d-tor.)
      */
-    void _scheduleRefresh(Date_t when);
+    void _scheduleRefresh(Date_t when, WithLock);
 
     /**
      * This function refreshes the replica set and calls _scheduleRefresh() again.
      */
     void _doScheduledRefresh(const executor::TaskExecutor::CallbackHandle& currentHandle);
 
-    // Serializes refresh and protects _refresherHandle
+    /**
+     * Replaces the scheduled refresh with one that runs immediately.
+     */
+    void _refreshNow();
+
+    /**
+     * Sends an awaitable isMaster to the primary, unless one is already outstanding or the last
+     * refresh did not find a primary which reports a topology version.
+     */
+    void _startAwaitableIsMaster();
+
+    /**
+     * Sends an isMaster to 'host' which replies once its topology version differs from
+     * 'topologyVersion' or the refresh period has passed.
+     */
+    void _scheduleAwaitableIsMaster(const HostAndPort& host,
+                                    const BSONObj& topologyVersion,
+                                    WithLock);
+
+    /**
+     * Waits again if the topology version in the reply is unchanged and refreshes immediately
+     * otherwise, or on error.
+     */
+    void _onAwaitableIsMasterResponse(
+        const HostAndPort& host,
+        const BSONObj& topologyVersion,
+        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData);
+
+    // Serializes refresh and protects _refresherHandle and _awaitableIsMasterHandle
     stdx::mutex _mutex;
     executor::TaskExecutor::CallbackHandle _refresherHandle;
+    executor::TaskExecutor::CallbackHandle _awaitableIsMasterHandle;
 
     const SetStatePtr _state;
     executor::TaskExecutor* _executor;
@@ -75,6 +75,7 @@ struct ReplicaSetMonitor::IsMasterReply {
     BSONObj tags;
     int minWireVersion{};
     int maxWireVersion{};
+    BSONObj topologyVersion;  // empty if the host does not support awaitable isMaster
 
     // remaining fields aren't in isMaster reply, but are known to caller.
     HostAndPort host;
@@ -122,10 +123,24 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Folds the round trip time of an operation run against this node into
+         * operationLatencyMicros.
+         */
+        void recordOperationLatency(int64_t micros);
+
+        /**
+         * Returns the latency used to rank this node during host selection. This is the moving
+         * average of operation latencies if 'useOperationLatency' is true and any have been
+         * recorded, and the moving average of isMaster round trips otherwise.
+         */
+        int64_t selectionLatencyMicros(bool useOperationLatency) const;
+
         HostAndPort host;
         bool isUp{false};
         bool isMaster{false};
         int64_t latencyMicros{};
+        int64_t operationLatencyMicros{};  // unknown until recordOperationLatency is called
         BSONObj tags;  // owned
         int minWireVersion{};
         int maxWireVersion{};
@@ -133,6 +148,7 @@ public:
         Date_t lastWriteDateUpdateTime{};  // set to the local system's time at the time of updating
                                            // lastWriteDate
         repl::OpTime opTime{};             // from isMasterReply
+        BSONObj topologyVersion;           // owned, from isMasterReply
     };
 
     typedef std::vector<Node> Nodes;
@@ -147,11 +163,13 @@ public:
     bool isUsable() const;
 
     /**
-     * Returns a host matching criteria or an empty host if no known host matches.
+     * Returns a host matching criteria or an empty host if no known host matches. If 'excluded'
+     * is not empty, that host is never returned.
      *
      * Note: Uses only local data and does not go over the network.
      */
-    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
+    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria,
+                                const HostAndPort& excluded = HostAndPort()) const;
 
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
@@ -203,6 +221,9 @@ public:
     Nodes nodes;                 // maintained sorted and unique by host
     ScanStatePtr currentScan;    // NULL if no scan in progress
     int64_t latencyThresholdMicros;
+    bool rankByOperationLatency;                   // rank nodes by operation rather than ping time
+    std::vector<int64_t> operationLatencySamples;  // ring of recent operation latencies
+    size_t nextOperationLatencySample{0};          // next slot to overwrite in a full ring
     mutable PseudoRandom rand;  // only used for host selection to balance load
     mutable int roundRobin;     // used when useDeterministicHostSelection is true
     MongoURI setUri;            // URI that may have constructed this
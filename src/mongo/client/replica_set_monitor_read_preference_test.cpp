@@ -298,6 +298,78 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, NearestRanksByOperationLatency) {
+    SetState set("name", {HostAndPort("a")});
+    set.nodes = getThreeMemberWithTags();
+    set.latencyThresholdMicros = 3 * 1000;
+
+    set.nodes[0].latencyMicros = 10 * 1000;
+    set.nodes[1].latencyMicros = 20 * 1000;
+    set.nodes[2].latencyMicros = 30 * 1000;
+
+    set.nodes[0].recordOperationLatency(90 * 1000);
+    set.nodes[1].recordOperationLatency(60 * 1000);
+    set.nodes[2].recordOperationLatency(40 * 1000);
+
+    const ReadPreferenceSetting criteria(ReadPreference::Nearest, TagSet(getDefaultTagSet()));
+
+    set.rankByOperationLatency = false;
+    ASSERT_EQUALS("a", set.getMatchingHost(criteria).host());
+
+    set.rankByOperationLatency = true;
+    ASSERT_EQUALS("c", set.getMatchingHost(criteria).host());
+}
+
+TEST(ReplSetMonitorReadPref, OperationLatencyFallsBackToPingTime) {
+    SetState set("name", {HostAndPort("a")});
+    set.nodes = getThreeMemberWithTags();
+    set.latencyThresholdMicros = 3 * 1000;
+    set.rankByOperationLatency = true;
+
+    set.nodes[0].latencyMicros = 10 * 1000;
+    set.nodes[1].latencyMicros = 20 * 1000;
+    set.nodes[2].latencyMicros = 30 * 1000;
+
+    // Only 'a' has run an operation, and it was slower than the ping time of 'b'.
+    set.nodes[0].recordOperationLatency(25 * 1000);
+
+    const ReadPreferenceSetting criteria(ReadPreference::Nearest, TagSet(getDefaultTagSet()));
+    ASSERT_EQUALS("b", set.getMatchingHost(criteria).host());
+}
+
+TEST(ReplSetMonitorReadPref, RecordOperationLatencyUsesMovingAverage) {
+    Node node(HostAndPort("a"));
+
+    node.recordOperationLatency(1000);
+    ASSERT_EQUALS(1000, node.operationLatencyMicros);
+
+    node.recordOperationLatency(5000);
+    ASSERT_EQUALS(2000, node.operationLatencyMicros);
+}
+
+TEST(ReplSetMonitorReadPref, MatchingHostSkipsExcludedHost) {
+    SetState set("name", {HostAndPort("a")});
+    set.nodes = getThreeMemberWithTags();
+    set.latencyThresholdMicros = 3 * 1000;
+
+    set.nodes[0].latencyMicros = 10 * 1000;
+    set.nodes[1].latencyMicros = 20 * 1000;
+    set.nodes[2].latencyMicros = 30 * 1000;
+
+    const TagSet tags(getDefaultTagSet());
+    ASSERT_EQUALS("b",
+                  set.getMatchingHost(ReadPreferenceSetting(ReadPreference::Nearest, tags),
+                                      HostAndPort("a"))
+                      .host());
+    ASSERT_EQUALS("c",
+                  set.getMatchingHost(ReadPreferenceSetting(ReadPreference::SecondaryOnly, tags),
+                                      HostAndPort("a"))
+                      .host());
+    ASSERT(set.getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, tags),
+                               HostAndPort("b"))
+               .empty());
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
@@ -68,6 +68,7 @@ void AuthorizationSessionForTest::revokePrivilegesForDB(StringData dbName) {
                                         return dbName == user->getName().getDB();
                                     }),
                      _testUsers.end());
+    _buildAuthenticatedRolesVector();
 }
 
 void AuthorizationSessionForTest::revokeAllPrivileges() {
@@ -78,5 +79,6 @@ void AuthorizationSessionForTest::revokeAllPrivileges() {
                                         return true;
                                     }),
                      _testUsers.end());
+    _buildAuthenticatedRolesVector();
 }
 }  // namespace mongo
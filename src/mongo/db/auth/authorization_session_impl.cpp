@@ -812,11 +812,14 @@ bool AuthorizationSessionImpl::isAuthenticated() {
 
 void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx) {
     AuthorizationManager& authMan = getAuthorizationManager();
+    bool usersChanged = false;
     UserSet::iterator it = _authenticatedUsers.begin();
     while (it != _authenticatedUsers.end()) {
         User* user = *it;
 
         if (!user->isValid()) {
+            usersChanged = true;
+
             // Make a good faith effort to acquire an up-to-date user object, since the one
             // we've cached is marked "out-of-date."
             UserName name = user->getName();
@@ -885,10 +888,14 @@ void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx)
         }
         ++it;
     }
-    _buildAuthenticatedRolesVector();
+
+    if (usersChanged) {
+        _buildAuthenticatedRolesVector();
+    }
 }
 
 void AuthorizationSessionImpl::_buildAuthenticatedRolesVector() {
+    _grantedActions.clear();
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
@@ -989,19 +996,37 @@ bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privil
         }
     }
 
+    unmetRequirements.removeAllActionsFromSet(
+        _getGrantedActions(target, resourceSearchList, resourceSearchListLength));
+    return unmetRequirements.empty();
+}
+
+const ActionSet& AuthorizationSessionImpl::_getGrantedActions(
+    const ResourcePattern& target,
+    const ResourcePattern* resourceSearchList,
+    int resourceSearchListLength) {
+    // Most sessions touch a handful of resources, so this bound is only reached by unusual ones.
+    const size_t kMaxGrantedActionsSize = 256;
+
+    auto cached = _grantedActions.find(target);
+    if (cached != _grantedActions.end()) {
+        return cached->second;
+    }
+
+    if (_grantedActions.size() >= kMaxGrantedActionsSize) {
+        _grantedActions.clear();
+    }
+
+    ActionSet& grantedActions = _grantedActions[target];
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
         User* user = *it;
         for (int i = 0; i < resourceSearchListLength; ++i) {
-            ActionSet userActions = user->getActionsForResource(resourceSearchList[i]);
-            unmetRequirements.removeAllActionsFromSet(userActions);
-
-            if (unmetRequirements.empty())
-                return true;
+            grantedActions.addAllActionsFromSet(
+                user->getActionsForResource(resourceSearchList[i]));
         }
     }
-
-    return false;
+    return grantedActions;
 }
 
 void AuthorizationSessionImpl::setImpersonatedUserData(std::vector<UserName> usernames,
@@ -44,6 +44,7 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -201,6 +202,7 @@ protected:
     // Builds a vector of all roles held by users who are authenticated on this connection. The
     // vector is stored in _authenticatedRoleNames. This function is called when users are
     // logged in or logged out, as well as when the user cache is determined to be out of date.
+    // It also forgets the actions granted by the previous users, see _grantedActions.
     void _buildAuthenticatedRolesVector();
 
     // All Users who have been authenticated on this connection.
@@ -221,12 +223,24 @@ private:
     // lock on the admin database (to update out-of-date user privilege information).
     bool _isAuthorizedForPrivilege(const Privilege& privilege);
 
+    // Returns the actions that the authenticated users are granted on 'target', which are those
+    // they are granted on any of the 'resourceSearchListLength' resources in 'resourceSearchList'.
+    const ActionSet& _getGrantedActions(const ResourcePattern& target,
+                                        const ResourcePattern* resourceSearchList,
+                                        int resourceSearchListLength);
+
     std::tuple<std::vector<UserName>*, std::vector<RoleName>*> _getImpersonations() override {
         return std::make_tuple(&_impersonatedUserNames, &_impersonatedRoleNames);
     }
 
     std::unique_ptr<AuthzSessionExternalState> _externalState;
 
+    // The actions that the authenticated users are granted on the resources which privilege checks
+    // have asked about, so that repeated checks do not search the users' privileges again. Users'
+    // privileges do not change while they are authenticated, so this is only cleared when the set
+    // of authenticated users changes, or when it grows too large.
+    stdx::unordered_map<ResourcePattern, ActionSet> _grantedActions;
+
     // A vector of impersonated UserNames and a vector of those users' RoleNames.
     // These are used in the auditing system. They are not used for authz checks.
     std::vector<UserName> _impersonatedUserNames;
@@ -252,6 +252,47 @@ TEST_F(AuthorizationSessionTest, AddUserAndCheckAuthorization) {
         authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::collMod));
 }
 
+TEST_F(AuthorizationSessionTest, RepeatedChecksOnManyResourcesGiveTheSameAnswers) {
+    ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
+                                                    BSON("user"
+                                                         << "spencer"
+                                                         << "db"
+                                                         << "test"
+                                                         << "credentials"
+                                                         << credentials
+                                                         << "roles"
+                                                         << BSON_ARRAY(BSON("role"
+                                                                            << "read"
+                                                                            << "db"
+                                                                            << "test"))),
+                                                    BSONObj()));
+    ASSERT_OK(authzSession->addAndAuthorizeUser(_opCtx.get(), UserName("spencer", "test")));
+
+    ActionSet findAndInsert;
+    findAndInsert.addAction(ActionType::find);
+    findAndInsert.addAction(ActionType::insert);
+
+    // Check more resources than the session remembers the granted actions of, twice over.
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            const auto coll = std::to_string(i);
+            ASSERT_TRUE(authzSession->isAuthorizedForActionsOnResource(
+                ResourcePattern::forExactNamespace(NamespaceString("test", coll)),
+                ActionType::find));
+            ASSERT_FALSE(authzSession->isAuthorizedForActionsOnResource(
+                ResourcePattern::forExactNamespace(NamespaceString("test", coll)),
+                findAndInsert));
+            ASSERT_FALSE(authzSession->isAuthorizedForActionsOnResource(
+                ResourcePattern::forExactNamespace(NamespaceString("other", coll)),
+                ActionType::find));
+        }
+    }
+
+    authzSession->logoutDatabase("test");
+    ASSERT_FALSE(authzSession->isAuthorizedForActionsOnResource(
+        ResourcePattern::forExactNamespace(NamespaceString("test", "0")), ActionType::find));
+}
+
 TEST_F(AuthorizationSessionTest, DuplicateRolesOK) {
     // Add a user with doubled-up readWrite and single dbAdmin on the test DB
     ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
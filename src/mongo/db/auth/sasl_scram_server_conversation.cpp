@@ -44,15 +44,99 @@
 #include "mongo/db/auth/sasl_mechanism_policies.h"
 #include "mongo/db/auth/sasl_mechanism_registry.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
+#include "mongo/util/lru_cache.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/sequence_util.h"
 #include "mongo/util/text.h"
 
 namespace mongo {
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(scramServerSecretsCacheSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "scramServerSecretsCacheSize must be non-negative");
+        }
+        return Status::OK();
+    });
+
+/**
+ * Holds the server keys decoded from the stored credentials of recently authenticated users, so
+ * that a burst of connections for the same user does not decode and securely allocate them again
+ * for every conversation. Entries are keyed by the stored keys themselves, so a user whose
+ * credentials change never gets the old keys back.
+ */
+template <typename HashBlock>
+class SCRAMServerSecretsCache {
+public:
+    static SCRAMServerSecretsCache& get() {
+        static auto cache = new SCRAMServerSecretsCache();
+        return *cache;
+    }
+
+    scram::Secrets<HashBlock> getSecrets(const UserName& userName,
+                                         const User::SCRAMCredentials<HashBlock>& credentials) {
+        const int maxSize = scramServerSecretsCacheSize.load();
+        if (maxSize <= 0) {
+            return _decode(credentials);
+        }
+
+        const std::string key = str::stream() << userName.getFullName() << '\0'
+                                              << credentials.storedKey << '\0'
+                                              << credentials.serverKey;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _resize(maxSize);
+            auto it = _cache->promote(key);
+            if (it != _cache->end()) {
+                return it->second;
+            }
+        }
+
+        auto secrets = _decode(credentials);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _resize(maxSize);
+        _cache->add(key, secrets);
+        return secrets;
+    }
 
+private:
+    static scram::Secrets<HashBlock> _decode(const User::SCRAMCredentials<HashBlock>& credentials) {
+        return scram::Secrets<HashBlock>(
+            "", base64::decode(credentials.storedKey), base64::decode(credentials.serverKey));
+    }
+
+    void _resize(size_t maxSize) {
+        if (!_cache || _maxSize != maxSize) {
+            _cache = stdx::make_unique<LRUCache<std::string, scram::Secrets<HashBlock>>>(maxSize);
+            _maxSize = maxSize;
+        }
+    }
+
+    stdx::mutex _mutex;
+    size_t _maxSize = 0;
+    std::unique_ptr<LRUCache<std::string, scram::Secrets<HashBlock>>> _cache;
+};
+
+/**
+ * Returns this thread's source of server nonces, rather than opening a new one for every
+ * conversation.
+ */
+SecureRandom* getNonceSource() {
+    static thread_local std::unique_ptr<SecureRandom> nonceSource;
+    if (!nonceSource) {
+        nonceSource = SecureRandom::create();
+    }
+    return nonceSource.get();
+}
+
+}  // namespace
 
 template <typename Policy>
 StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::stepImpl(
@@ -220,16 +304,14 @@ StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::_fir
         }
     }
 
-    _secrets = scram::Secrets<HashBlock>("",
-                                         base64::decode(_scramCredentials.storedKey),
-                                         base64::decode(_scramCredentials.serverKey));
+    _secrets = SCRAMServerSecretsCache<HashBlock>::get().getSecrets(userName, _scramCredentials);
 
     // Generate server-first-message
     // Create text-based nonce as base64 encoding of a binary blob of length multiple of 3
     const int nonceLenQWords = 3;
     uint64_t binaryNonce[nonceLenQWords];
 
-    std::unique_ptr<SecureRandom> sr(SecureRandom::create());
+    SecureRandom* sr = getNonceSource();
 
     binaryNonce[0] = sr->nextInt64();
     binaryNonce[1] = sr->nextInt64();
@@ -43,12 +43,14 @@
 #include "mongo/db/auth/authz_session_external_state_mock.h"
 #include "mongo/db/auth/sasl_mechanism_registry.h"
 #include "mongo/db/auth/sasl_scram_server_conversation.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
 #include "mongo/util/password_digest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -519,6 +521,65 @@ TEST_F(SCRAMFixture, testIncorrectPassword) {
               runSteps());
 }
 
+TEST_F(SCRAMFixture, testCachedServerSecretsFollowCredentialChanges) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("scramServerSecretsCacheSize");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString("10"));
+    ON_BLOCK_EXIT([&] { param->second->setFromString("0").transitional_ignore(); });
+
+    const auto mechanism = saslServerSession->mechanismName().toString();
+    const auto authenticate = [&](StringData password) {
+        if (mechanism == "SCRAM-SHA-1") {
+            saslServerSession = std::make_unique<SaslSCRAMSHA1ServerMechanism>("test");
+        } else {
+            saslServerSession = std::make_unique<SaslSCRAMSHA256ServerMechanism>("test");
+        }
+        saslClientSession = std::make_unique<NativeSaslClientSession>();
+        saslClientSession->setParameter(NativeSaslClientSession::parameterMechanism, mechanism);
+        saslClientSession->setParameter(NativeSaslClientSession::parameterServiceName, "mongodb");
+        saslClientSession->setParameter(NativeSaslClientSession::parameterServiceHostname,
+                                        "MockServer.test");
+        saslClientSession->setParameter(NativeSaslClientSession::parameterServiceHostAndPort,
+                                        "MockServer.test:27017");
+        saslClientSession->setParameter(NativeSaslClientSession::parameterUser, "sajack");
+        saslClientSession->setParameter(NativeSaslClientSession::parameterPassword,
+                                        createPasswordDigest("sajack", password));
+        ASSERT_OK(saslClientSession->initialize());
+        return runSteps();
+    };
+
+    ASSERT_OK(authzManagerExternalState->insertPrivilegeDocument(
+        opCtx.get(), generateSCRAMUserDocument("sajack", "sajack"), BSONObj()));
+
+    // The second conversation uses the secrets cached by the first.
+    ASSERT_EQ(goalState, authenticate("sajack"));
+    ASSERT_EQ(goalState, authenticate("sajack"));
+
+    int numRemoved;
+    ASSERT_OK(authzManagerExternalState->remove(opCtx.get(),
+                                                AuthorizationManager::usersCollectionNamespace,
+                                                BSONObj(),
+                                                BSONObj(),
+                                                &numRemoved));
+    ASSERT_EQ(1, numRemoved);
+    ASSERT_OK(authzManagerExternalState->insertPrivilegeDocument(
+        opCtx.get(), generateSCRAMUserDocument("sajack", "newPassword"), BSONObj()));
+    authzManager->invalidateUserCache();
+
+    // Only the new password is accepted once the credentials change.
+    ASSERT_EQ(SCRAMStepsResult(SaslTestState(SaslTestState::kServer, 2),
+                               Status(ErrorCodes::AuthenticationFailed,
+                                      "SCRAM authentication failed, storedKey mismatch")),
+              authenticate("sajack"));
+    ASSERT_EQ(goalState, authenticate("newPassword"));
+}
+
+TEST(SCRAMServerSecretsCache, RejectsNegativeCacheSize) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("scramServerSecretsCacheSize");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_NOT_OK(param->second->setFromString("-1"));
+}
+
 TEST_F(SCRAMFixture, testOptionalClientExtensions) {
     // Verify server ignores unknown/optional extensions sent by client.
     ASSERT_OK(authzManagerExternalState->insertPrivilegeDocument(
@@ -49,6 +49,7 @@
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/catalog/namespace_uuid_cache.h"
 #include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
@@ -70,6 +71,7 @@
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -102,6 +104,18 @@ namespace {
 // Used below to fail during inserts.
 MONGO_FAIL_POINT_DEFINE(failCollectionInserts);
 
+// The number of threads among which a foreground validation spreads the validation of the
+// collection's indexes. With 1, the indexes are validated one after the other by the validation's
+// own thread.
+MONGO_EXPORT_SERVER_PARAMETER(internalValidateIndexThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalValidateIndexThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
 // Uses the collator factory to convert the BSON representation of a collator to a
 // CollatorInterface. Returns null if the BSONObj is empty. We expect the stored collation to be
 // valid, since it gets validated on collection create.
@@ -299,7 +313,16 @@ StatusWithMatchExpression CollectionImpl::parseValidator(
     if (!statusWithMatcher.isOK())
         return statusWithMatcher.getStatus();
 
-    return statusWithMatcher;
+    // The validator is evaluated against every document written to the collection, so simplify it
+    // once here. $jsonSchema in particular translates into trees with many trivially true and
+    // nested logical nodes. Optimizing an $expr can throw where evaluating it would not, in which
+    // case the validator is used as parsed.
+    try {
+        return {MatchExpression::optimize(std::move(statusWithMatcher.getValue()))};
+    } catch (const DBException&) {
+        return MatchExpressionParser::parse(
+            validator, expCtx, ExtensionsCallbackNoop(), allowedFeatures);
+    }
 }
 
 Status CollectionImpl::insertDocumentsForOplog(OperationContext* opCtx,
@@ -1025,14 +1048,162 @@ void _validateRecordStore(OperationContext* opCtx,
     }
 }
 
+/**
+ * Validates one index and traverses its entries for index consistency. With 'workerOpCtx', the
+ * index is read through that operation on behalf of the validation's 'opCtx'. Errors that concern
+ * the collection as a whole are added to 'errors'.
+ */
+void _validateIndex(OperationContext* opCtx,
+                    OperationContext* workerOpCtx,
+                    IndexAccessMethod* iam,
+                    const IndexDescriptor* descriptor,
+                    RecordStoreValidateAdaptor* indexValidator,
+                    ValidateCmdLevel level,
+                    ValidateResults* curIndexResults,
+                    int64_t* numTraversedKeys,
+                    std::vector<std::string>* errors) {
+    OperationContext* readOpCtx = workerOpCtx ? workerOpCtx : opCtx;
+    bool checkCounts = false;
+    int64_t numValidatedKeys;
+
+    if (level == kValidateFull) {
+        iam->validate(readOpCtx, &numValidatedKeys, curIndexResults);
+        checkCounts = true;
+    }
+
+    if (!curIndexResults->valid) {
+        return;
+    }
+
+    if (workerOpCtx) {
+        indexValidator->traverseIndexConcurrently(
+            workerOpCtx, iam, descriptor, curIndexResults, numTraversedKeys);
+    } else {
+        indexValidator->traverseIndex(iam, descriptor, curIndexResults, numTraversedKeys);
+    }
+
+    if (checkCounts && (numValidatedKeys != *numTraversedKeys)) {
+        curIndexResults->valid = false;
+        string msg = str::stream() << "number of traversed index entries (" << *numTraversedKeys
+                                   << ") does not match the number of expected index entries ("
+                                   << numValidatedKeys
+                                   << ")";
+        errors->push_back(msg);
+    }
+}
+
+/**
+ * Validates the indexes at once on a pool of 'numThreads' threads, each reading through an
+ * operation of its own. The caller holds the collection exclusively, so every one of these
+ * operations sees the collection at the same point in time as the record store validation did.
+ * The index results and key counts are then reported in index catalog order, as the serial
+ * validation does.
+ */
+void _validateIndexesInParallel(OperationContext* opCtx,
+                                IndexCatalog* indexCatalog,
+                                BSONObjBuilder* keysPerIndex,
+                                RecordStoreValidateAdaptor* indexValidator,
+                                ValidateCmdLevel level,
+                                ValidateResultsMap* indexNsResultsMap,
+                                ValidateResults* results,
+                                size_t numThreads) {
+    struct IndexToValidate {
+        const IndexDescriptor* descriptor;
+        IndexAccessMethod* iam;
+        ValidateResults* results;
+        int64_t numTraversedKeys = 0;
+        std::vector<std::string> errors;
+        Status status = Status::OK();
+    };
+
+    // Entries in 'indexNsResultsMap' are all created up front, since the map may not be modified
+    // while the threads hold references into it.
+    std::vector<IndexToValidate> indexes;
+    IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        IndexToValidate index;
+        index.descriptor = i.next();
+        index.iam = indexCatalog->getIndex(index.descriptor);
+        index.results = &(*indexNsResultsMap)[index.descriptor->indexNamespace()];
+        indexes.push_back(std::move(index));
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "ValidateIndexes";
+    options.minThreads = options.maxThreads = std::min(numThreads, indexes.size());
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    for (auto& index : indexes) {
+        log(LogComponent::kIndex) << "validating index " << index.descriptor->indexNamespace()
+                                  << endl;
+        auto status = pool.schedule([&, level] {
+            try {
+                auto workerOpCtx = cc().makeOperationContext();
+                // Readers of the storage engine hold the global lock. Its intent mode does not
+                // conflict with the locks held by the validation.
+                Lock::GlobalLock globalLock(workerOpCtx.get(), MODE_IS);
+                _validateIndex(opCtx,
+                               workerOpCtx.get(),
+                               index.iam,
+                               index.descriptor,
+                               indexValidator,
+                               level,
+                               index.results,
+                               &index.numTraversedKeys,
+                               &index.errors);
+            } catch (const DBException& ex) {
+                index.status = ex.toStatus();
+            }
+        });
+        if (!status.isOK()) {
+            index.status = status;
+        }
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (auto& index : indexes) {
+        uassertStatusOK(index.status);
+        results->errors.insert(results->errors.end(), index.errors.begin(), index.errors.end());
+
+        if (index.results->valid) {
+            keysPerIndex->appendNumber(index.descriptor->indexNamespace(),
+                                       static_cast<long long>(index.numTraversedKeys));
+        } else {
+            results->valid = false;
+        }
+    }
+}
+
 void _validateIndexes(OperationContext* opCtx,
                       IndexCatalog* indexCatalog,
                       BSONObjBuilder* keysPerIndex,
                       RecordStoreValidateAdaptor* indexValidator,
                       ValidateCmdLevel level,
+                      bool background,
                       ValidateResultsMap* indexNsResultsMap,
                       ValidateResults* results) {
 
+    // Indexes are only read on other threads when no writes can happen during the validation,
+    // and on storage engines whose data may be read without the locks the validation holds.
+    const int numThreads = internalValidateIndexThreads.load();
+    if (numThreads > 1 && !background && indexCatalog->numIndexesReady(opCtx) > 1 &&
+        opCtx->getServiceContext()->getStorageEngine()->supportsDocLocking()) {
+        _validateIndexesInParallel(opCtx,
+                                   indexCatalog,
+                                   keysPerIndex,
+                                   indexValidator,
+                                   level,
+                                   indexNsResultsMap,
+                                   results,
+                                   static_cast<size_t>(numThreads));
+        return;
+    }
+
     IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
 
     // Validate Indexes.
@@ -1042,34 +1213,21 @@ void _validateIndexes(OperationContext* opCtx,
         log(LogComponent::kIndex) << "validating index " << descriptor->indexNamespace() << endl;
         IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
         ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
-        bool checkCounts = false;
         int64_t numTraversedKeys;
-        int64_t numValidatedKeys;
 
-        if (level == kValidateFull) {
-            iam->validate(opCtx, &numValidatedKeys, &curIndexResults);
-            checkCounts = true;
-        }
+        _validateIndex(opCtx,
+                       nullptr,
+                       iam,
+                       descriptor,
+                       indexValidator,
+                       level,
+                       &curIndexResults,
+                       &numTraversedKeys,
+                       &results->errors);
 
         if (curIndexResults.valid) {
-            indexValidator->traverseIndex(iam, descriptor, &curIndexResults, &numTraversedKeys);
-
-            if (checkCounts && (numValidatedKeys != numTraversedKeys)) {
-                curIndexResults.valid = false;
-                string msg = str::stream()
-                    << "number of traversed index entries (" << numTraversedKeys
-                    << ") does not match the number of expected index entries (" << numValidatedKeys
-                    << ")";
-                results->errors.push_back(msg);
-                results->valid = false;
-            }
-
-            if (curIndexResults.valid) {
-                keysPerIndex->appendNumber(descriptor->indexNamespace(),
-                                           static_cast<long long>(numTraversedKeys));
-            } else {
-                results->valid = false;
-            }
+            keysPerIndex->appendNumber(descriptor->indexNamespace(),
+                                       static_cast<long long>(numTraversedKeys));
         } else {
             results->valid = false;
         }
@@ -1238,6 +1396,7 @@ Status CollectionImpl::validate(OperationContext* opCtx,
                              &keysPerIndex,
                              &indexValidator,
                              level,
+                             background,
                              &indexNsResultsMap,
                              results);
 
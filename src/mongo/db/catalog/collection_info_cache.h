@@ -30,6 +30,7 @@
 
 #include "mongo/base/shim.h"
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -54,6 +55,8 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual CollectionStatistics* getStatistics() const = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
@@ -103,6 +106,13 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Get the field statistics gathered for this collection by the 'analyze' command.
+     */
+    inline CollectionStatistics* getStatistics() const {
+        return this->_impl().getStatistics();
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
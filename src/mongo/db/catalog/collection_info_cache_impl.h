@@ -32,6 +32,7 @@
 
 #include "mongo/base/shim.h"
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -62,6 +63,11 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get the field statistics gathered for this collection by the 'analyze' command.
+     */
+    CollectionStatistics* getStatistics() const;
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -132,6 +138,9 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Field statistics used to prune candidate plans.
+    std::unique_ptr<CollectionStatistics> _statistics;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
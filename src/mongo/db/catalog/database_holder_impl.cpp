@@ -89,22 +89,55 @@ StringData _todb(StringData ns) {
     return d;
 }
 
+// Source of the snapshot versions. Sharing it between all DatabaseHolderImpl instances makes a
+// cached version identify the snapshot unambiguously, even after the holder it came from has been
+// destroyed.
+AtomicUInt64 snapshotVersionCounter;
+
+// The snapshot most recently read by this thread.
+thread_local DatabaseHolderImpl::Snapshot cachedSnapshot;
+
 }  // namespace
 
+DatabaseHolderImpl::DatabaseHolderImpl() {
+    stdx::lock_guard<SimpleMutex> lk(_m);
+    _publishSnapshot_inlock();
+}
 
 Database* DatabaseHolderImpl::get(OperationContext* opCtx, StringData ns) const {
     const StringData db = _todb(ns);
     invariant(opCtx->lockState()->isDbLockedForMode(db, MODE_IS));
 
-    stdx::lock_guard<SimpleMutex> lk(_m);
-    DBs::const_iterator it = _dbs.find(db);
-    if (it != _dbs.end()) {
+    // Any open or close of 'db' published its snapshot before releasing the X lock on 'db', which
+    // we now hold in a compatible mode, so a cached snapshot with the current version is accurate
+    // for 'db'. Entries for other databases may be stale, but are never returned.
+    if (cachedSnapshot.version != _snapshotVersion.load()) {
+        stdx::lock_guard<SimpleMutex> lk(_m);
+        cachedSnapshot = _snapshot;
+    }
+
+    DBs::const_iterator it = cachedSnapshot.dbs->find(db);
+    if (it != cachedSnapshot.dbs->end()) {
         return it->second;
     }
 
     return NULL;
 }
 
+void DatabaseHolderImpl::_publishSnapshot_inlock() {
+    auto dbs = std::make_shared<DBs>();
+    for (const auto& nameAndPointer : _dbs) {
+        // Entries which are still being opened are treated as non-existent by get().
+        if (nameAndPointer.second) {
+            dbs->try_emplace(nameAndPointer.first, nameAndPointer.second);
+        }
+    }
+
+    _snapshot.version = snapshotVersionCounter.addAndFetch(1);
+    _snapshot.dbs = std::move(dbs);
+    _snapshotVersion.store(_snapshot.version);
+}
+
 std::set<std::string> DatabaseHolderImpl::_getNamesWithConflictingCasing_inlock(StringData name) {
     std::set<std::string> duplicates;
 
@@ -176,6 +209,7 @@ Database* DatabaseHolderImpl::openDb(OperationContext* opCtx, StringData ns, boo
     invariant(it != _dbs.end() && it->second == nullptr);
     it->second = newDb.release();
     invariant(_getNamesWithConflictingCasing_inlock(dbname.toString()).empty());
+    _publishSnapshot_inlock();
 
     return it->second;
 }
@@ -210,6 +244,7 @@ void DatabaseHolderImpl::close(OperationContext* opCtx, StringData ns, const std
     db = nullptr;
 
     _dbs.erase(it);
+    _publishSnapshot_inlock();
 
     getGlobalServiceContext()
         ->getStorageEngine()
@@ -240,6 +275,7 @@ void DatabaseHolderImpl::closeAll(OperationContext* opCtx, const std::string& re
         delete db;
 
         _dbs.erase(name);
+        _publishSnapshot_inlock();
 
         getGlobalServiceContext()
             ->getStorageEngine()
@@ -30,11 +30,13 @@
 
 #include "mongo/db/catalog/database_holder.h"
 
+#include <memory>
 #include <set>
 #include <string>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
@@ -49,11 +51,14 @@ class OperationContext;
  */
 class DatabaseHolderImpl : public DatabaseHolder::Impl {
 public:
-    DatabaseHolderImpl() = default;
+    DatabaseHolderImpl();
 
     /**
      * Retrieves an already opened database or returns NULL. Must be called with the database
      * locked in at least IS-mode.
+     *
+     * Does not take the registry mutex unless a database was opened or closed since the calling
+     * thread last looked up a database.
      */
     Database* get(OperationContext* opCtx, StringData ns) const override;
 
@@ -85,11 +90,33 @@ public:
      */
     std::set<std::string> getNamesWithConflictingCasing(StringData name) override;
 
+    typedef StringMap<Database*> DBs;
+
+    /**
+     * An immutable copy of the opened databases, tagged with a version which is unique across all
+     * DatabaseHolderImpl instances in the process.
+     */
+    struct Snapshot {
+        uint64_t version = 0;
+        std::shared_ptr<const DBs> dbs;
+    };
+
 private:
     std::set<std::string> _getNamesWithConflictingCasing_inlock(StringData name);
 
-    typedef StringMap<Database*> DBs;
+    /**
+     * Publishes a new snapshot of the opened databases for get() to read from. Must be called
+     * after every change to a non-null entry of '_dbs', before the database lock protecting the
+     * change is released.
+     */
+    void _publishSnapshot_inlock();
+
     mutable SimpleMutex _m;
     DBs _dbs;
+
+    // Guarded by '_m'. Readers first compare '_snapshotVersion' against the version of the
+    // snapshot they cached, and only take '_m' to refresh their copy when it changed.
+    Snapshot _snapshot;
+    AtomicUInt64 _snapshotVersion;
 };
 }  // namespace mongo
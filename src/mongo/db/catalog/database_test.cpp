@@ -32,6 +32,7 @@
 
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/client.h"
@@ -471,6 +472,26 @@ TEST_F(
     });
 }
 
+TEST_F(DatabaseTest, DatabaseHolderGetReflectsOpenAndClose) {
+    auto& dbHolder = DatabaseHolder::getDatabaseHolder();
+    Lock::GlobalWrite lock(_opCtx.get());
+
+    // Look the database up before it exists, so that the calling thread has a cached snapshot of
+    // the opened databases which must be refreshed by openDb() and close().
+    ASSERT_FALSE(dbHolder.get(_opCtx.get(), _nss.db()));
+
+    auto db = dbHolder.openDb(_opCtx.get(), _nss.db());
+    ASSERT_TRUE(db);
+    ASSERT_EQUALS(db, dbHolder.get(_opCtx.get(), _nss.db()));
+
+    dbHolder.close(_opCtx.get(), _nss.db(), "test");
+    ASSERT_FALSE(dbHolder.get(_opCtx.get(), _nss.db()));
+
+    db = dbHolder.openDb(_opCtx.get(), _nss.db());
+    ASSERT_TRUE(db);
+    ASSERT_EQUALS(db, dbHolder.get(_opCtx.get(), _nss.db()));
+}
+
 TEST_F(DatabaseTest, AutoGetDBSucceedsWithDeadlineNow) {
     NamespaceString nss("test", "coll");
     Lock::DBLock lock(_opCtx.get(), nss.db(), MODE_X);
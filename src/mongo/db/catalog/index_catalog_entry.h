@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -49,6 +50,7 @@ class CollectionCatalogEntry;
 class CollectionInfoCache;
 class HeadManager;
 class IndexAccessMethod;
+class IndexBuildInterceptor;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
@@ -101,6 +103,11 @@ public:
         virtual boost::optional<Timestamp> getMinimumVisibleSnapshot() = 0;
 
         virtual void setMinimumVisibleSnapshot(Timestamp name) = 0;
+
+        virtual IndexBuildInterceptor* indexBuildInterceptor() const = 0;
+
+        virtual void setIndexBuildInterceptor(
+            std::shared_ptr<IndexBuildInterceptor> interceptor) = 0;
     };
 
 public:
@@ -243,6 +250,22 @@ public:
         return this->_impl().setMinimumVisibleSnapshot(name);
     }
 
+    /**
+     * If not null, the index is being built by a hybrid index build and writes to it must be
+     * handed to the interceptor instead of being applied to the index directly.
+     */
+    IndexBuildInterceptor* indexBuildInterceptor() const {
+        return this->_impl().indexBuildInterceptor();
+    }
+
+    /**
+     * Must be called while holding an exclusive lock on the collection, so that no write is in
+     * the middle of deciding where its keys go.
+     */
+    void setIndexBuildInterceptor(std::shared_ptr<IndexBuildInterceptor> interceptor) {
+        return this->_impl().setIndexBuildInterceptor(std::move(interceptor));
+    }
+
 private:
     // This structure exists to give us a customization point to decide how to force users of this
     // class to depend upon the corresponding `index_catalog_entry.cpp` Translation Unit (TU).  All
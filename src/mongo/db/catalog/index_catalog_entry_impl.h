@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -49,6 +50,7 @@ class CollectionCatalogEntry;
 class CollectionInfoCache;
 class HeadManager;
 class IndexAccessMethod;
+class IndexBuildInterceptor;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
@@ -165,6 +167,14 @@ public:
         _minVisibleSnapshot = name;
     }
 
+    IndexBuildInterceptor* indexBuildInterceptor() const final {
+        return _indexBuildInterceptor.get();
+    }
+
+    void setIndexBuildInterceptor(std::shared_ptr<IndexBuildInterceptor> interceptor) final {
+        _indexBuildInterceptor = std::move(interceptor);
+    }
+
 private:
     class SetMultikeyChange;
     class SetHeadChange;
@@ -232,5 +242,8 @@ private:
 
     // The earliest snapshot that is allowed to read this index.
     boost::optional<Timestamp> _minVisibleSnapshot;
+
+    // Shared with the hybrid index build, if any, that is building this index.
+    std::shared_ptr<IndexBuildInterceptor> _indexBuildInterceptor;
 };
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -63,6 +64,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine_init.h"
 #include "mongo/util/assert_util.h"
@@ -108,6 +110,17 @@ using IndexVersion = IndexDescriptor::IndexVersion;
 static const int INDEX_CATALOG_INIT = 283711;
 static const int INDEX_CATALOG_UNINIT = 654321;
 
+// When non-zero, a batch of at least this many records is inserted into each index key by key in
+// the index's order, rather than document by document.
+MONGO_EXPORT_SERVER_PARAMETER(indexSortedInsertMinBatchSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "indexSortedInsertMinBatchSize must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
 const BSONObj IndexCatalogImpl::_idObj = BSON("_id" << 1);
 
 // -------------
@@ -1391,6 +1404,32 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    // Keys can only be inserted out of document order if all of the documents are written at the
+    // same timestamp, since each write is given the timestamp set when it is made.
+    const int sortedInsertMinBatchSize = indexSortedInsertMinBatchSize.load();
+    if (sortedInsertMinBatchSize > 0 && bsonRecords.size() >= size_t(sortedInsertMinBatchSize) &&
+        !index->indexBuildInterceptor() &&
+        std::all_of(bsonRecords.begin(), bsonRecords.end(), [&](const BsonRecord& bsonRecord) {
+            return bsonRecord.ts == bsonRecords.front().ts;
+        })) {
+        if (!bsonRecords.front().ts.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(bsonRecords.front().ts);
+            if (!status.isOK())
+                return status;
+        }
+
+        int64_t inserted;
+        Status status =
+            index->accessMethod()->insertSorted(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -137,6 +137,36 @@ void IndexConsistency::removeIndexKey(const KeyString& ks, int indexNumber) {
     _removeIndexKey_inlock(ks, indexNumber);
 }
 
+void IndexConsistency::addIndexKeyToBatch(const KeyString& ks, IndexKeyBatch* batch) const {
+
+    // '_indexesInfo' is only modified before the collection and index scans start, so it can be
+    // read here without holding '_classMutex'.
+    if (batch->indexNumber < 0 || batch->indexNumber >= static_cast<int>(_indexesInfo.size())) {
+        return;
+    }
+
+    // Ignore indexes that weren't ready before we started validation.
+    if (!_indexesInfo.at(batch->indexNumber).isReady) {
+        return;
+    }
+
+    batch->bucketDecrements[_hashKeyString(ks, batch->indexNumber)]++;
+    batch->numKeys++;
+}
+
+void IndexConsistency::addIndexKeyBatch(const IndexKeyBatch& batch) {
+
+    stdx::lock_guard<stdx::mutex> lock(_classMutex);
+    if (batch.indexNumber < 0 || batch.indexNumber >= static_cast<int>(_indexesInfo.size())) {
+        return;
+    }
+
+    for (const auto& bucket : batch.bucketDecrements) {
+        _indexKeyCount[bucket.first] -= bucket.second;
+    }
+    _indexesInfo.at(batch.indexNumber).numKeys += batch.numKeys;
+}
+
 void IndexConsistency::addLongIndexKey(int indexNumber) {
 
     stdx::lock_guard<stdx::mutex> lock(_classMutex);
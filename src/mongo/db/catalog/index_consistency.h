@@ -33,6 +33,7 @@
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/elapsed_tracker.h"
 
 namespace mongo {
@@ -81,6 +82,21 @@ struct IndexInfo {
     int64_t numExtraIndexKeys;
 };
 
+/**
+ * The index keys seen by a single thread traversing one index, kept apart from the shared
+ * buckets in IndexConsistency so that several indexes can be traversed at once without
+ * contending on its mutex for every key.
+ */
+struct IndexKeyBatch {
+    explicit IndexKeyBatch(int indexNumber) : indexNumber(indexNumber) {}
+
+    int indexNumber;
+    // The number of index keys added to the batch.
+    int64_t numKeys = 0;
+    // How much each bucket's count is to be decremented by when the batch is applied.
+    stdx::unordered_map<uint32_t, uint32_t> bucketDecrements;
+};
+
 class IndexConsistency final {
 public:
     IndexConsistency(OperationContext* opCtx,
@@ -99,6 +115,14 @@ public:
     void addIndexKey(const KeyString& ks, int indexNumber);
     void removeIndexKey(const KeyString& ks, int indexNumber);
 
+    /**
+     * Equivalent to addIndexKey(), except that the key is only recorded in 'batch' and is not
+     * visible to the rest of the validation until 'addIndexKeyBatch()' is called. Safe to call
+     * from several threads at once as long as each uses its own batch.
+     */
+    void addIndexKeyToBatch(const KeyString& ks, IndexKeyBatch* batch) const;
+    void addIndexKeyBatch(const IndexKeyBatch& batch);
+
     /**
      * Add one to the `_longKeys` count for the given `indexNs`.
      * This is required because index keys > `KeyString::kMaxKeyBytes` are not indexed.
@@ -32,6 +32,8 @@
 
 #include "mongo/db/catalog/index_create_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/init.h"
 #include "mongo/db/audit.h"
@@ -42,6 +44,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/op_observer.h"
@@ -49,8 +52,11 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -95,6 +101,164 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// The number of threads among which a foreground build of several indexes spreads the generation of
+// their keys. With 1, the keys are all generated on the thread scanning the collection.
+MONGO_EXPORT_SERVER_PARAMETER(internalIndexBuildKeyGenerationThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalIndexBuildKeyGenerationThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+// When set, a background build loads its indexes from sorted keys like a foreground build, while
+// the writes made during the build are set aside and applied afterwards. Requires a storage engine
+// with document-level locking.
+MONGO_EXPORT_SERVER_PARAMETER(internalIndexBuildHybrid, bool, false);
+
+/**
+ * Generates the keys of the documents of a bulk build on a pool of threads. Documents are collected
+ * into batches, and once a batch is full the keys of each index are generated from it by a task of
+ * their own, while the collection scan goes on to fill the next batch. Each index's BulkBuilder
+ * is used by one task at a time and receives the documents in the order of the scan, so it sorts
+ * the same keys as a serial build would.
+ */
+class MultiIndexBlockImpl::ParallelKeyGenerator {
+public:
+    static constexpr size_t kMaxBatchDocuments = 1000;
+    static constexpr size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+    ParallelKeyGenerator(OperationContext* opCtx,
+                         std::vector<IndexToBuild>* indexes,
+                         size_t numThreads)
+        : _opCtx(opCtx),
+          _indexes(indexes),
+          _pool([&] {
+              ThreadPool::Options options;
+              options.poolName = "IndexBuildKeyGeneration";
+              options.minThreads = options.maxThreads = numThreads;
+              options.onCreateThread = [](const std::string& threadName) {
+                  Client::initThread(threadName.c_str());
+              };
+              return options;
+          }()),
+          _statuses(indexes->size(), Status::OK()) {
+        _pool.startup();
+    }
+
+    ~ParallelKeyGenerator() {
+        _pool.shutdown();
+        _pool.join();
+    }
+
+    /**
+     * Adds a copy of 'doc' to the batch being filled, and hands the batch over to the pool if it
+     * is full. Returns the first error from generating the keys of an earlier batch.
+     */
+    Status add(const BSONObj& doc, const RecordId& loc) {
+        _filling.emplace_back(doc.getOwned(), loc);
+        _fillingBytes += doc.objsize();
+        if (_filling.size() < kMaxBatchDocuments && _fillingBytes < kMaxBatchBytes) {
+            return Status::OK();
+        }
+        return _startBatch();
+    }
+
+    /**
+     * Generates the keys of the remaining documents and waits for all of the tasks to finish.
+     */
+    Status finish() {
+        Status status = _startBatch();
+        if (!status.isOK()) {
+            return status;
+        }
+        return _waitForBatch();
+    }
+
+    /**
+     * The time the collection scan spent waiting for the keys of a batch to be generated.
+     */
+    Milliseconds getWaitTime() const {
+        return _waitTime;
+    }
+
+private:
+    Status _startBatch() {
+        // The batch in flight must be done with before its documents are replaced.
+        Status status = _waitForBatch();
+        if (!status.isOK()) {
+            return status;
+        }
+
+        std::swap(_filling, _inFlight);
+        _filling.clear();
+        _fillingBytes = 0;
+        if (_inFlight.empty()) {
+            return Status::OK();
+        }
+
+        for (size_t i = 0; i < _indexes->size(); ++i) {
+            status = _pool.schedule([this, i] { _statuses[i] = _generateKeys(i); });
+            if (!status.isOK()) {
+                _pool.waitForIdle();
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    Status _waitForBatch() {
+        Timer timer;
+        _pool.waitForIdle();
+        _waitTime += Milliseconds(timer.millis());
+
+        for (auto&& status : _statuses) {
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    Status _generateKeys(size_t indexId) {
+        auto& index = (*_indexes)[indexId];
+        try {
+            for (auto&& entry : _inFlight) {
+                if (index.filterExpression && !index.filterExpression->matchesBSON(entry.first)) {
+                    continue;
+                }
+
+                // BulkBuilder::insert() only adds the keys to the builder's sorter, and does not
+                // use the OperationContext, so it is safe to pass the one of the scanning thread.
+                int64_t unused;
+                Status status =
+                    index.bulk->insert(_opCtx, entry.first, entry.second, index.options, &unused);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    }
+
+    OperationContext* const _opCtx;
+    std::vector<IndexToBuild>* const _indexes;
+    ThreadPool _pool;
+
+    std::vector<std::pair<BSONObj, RecordId>> _filling;
+    size_t _fillingBytes = 0;
+    std::vector<std::pair<BSONObj, RecordId>> _inFlight;
+
+    // The result of generating the keys of the batch in flight, for each index. Each is only
+    // written by the task for its index.
+    std::vector<Status> _statuses;
+
+    Milliseconds _waitTime{0};
+};
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -235,6 +399,9 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         _buildInBackground = (_buildInBackground && initBackgroundIndexFromSpec(info));
     }
 
+    _buildIsHybrid = _buildInBackground && internalIndexBuildHybrid.load() &&
+        _opCtx->getServiceContext()->getStorageEngine()->supportsDocLocking();
+
     std::vector<BSONObj> indexInfoObjs;
     indexInfoObjs.reserve(indexSpecs.size());
     std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
@@ -265,9 +432,9 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!status.isOK())
             return status;
 
-        if (!_buildInBackground) {
+        if (!_buildInBackground || _buildIsHybrid) {
             // Bulk build process requires foreground building as it assumes nothing is changing
-            // under it.
+            // under it, unless the changes are set aside by an interceptor.
             index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
         }
 
@@ -279,10 +446,18 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
             index.options.getKeysMode = IndexAccessMethod::GetKeysMode::kRelaxConstraints;
         }
 
+        if (_buildIsHybrid) {
+            index.interceptor = std::make_shared<IndexBuildInterceptor>(
+                descriptor->unique() && !index.options.dupsAllowed);
+            index.block->getEntry()->setIndexBuildInterceptor(index.interceptor);
+        }
+
         log() << "build index on: " << ns << " properties: " << descriptor->toString();
         if (index.bulk)
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+        if (index.interceptor)
+            log() << "\t writes to the index during the build will be applied after the bulk load";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -364,6 +539,20 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    // A background build inserts into the indexes themselves, which must be done by the thread
+    // holding the locks, or yields those locks while scanning, so only the keys of a foreground
+    // bulk build can be generated on other threads.
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    const size_t keyGenerationThreads = std::min(
+        _indexes.size(), static_cast<size_t>(internalIndexBuildKeyGenerationThreads.load()));
+    if (keyGenerationThreads > 1 && !_buildInBackground &&
+        std::all_of(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return static_cast<bool>(index.bulk);
+        })) {
+        keyGenerator =
+            stdx::make_unique<ParallelKeyGenerator>(_opCtx, &_indexes, keyGenerationThreads);
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -397,7 +586,8 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
             WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = keyGenerator ? keyGenerator->add(objToIndex.value(), loc)
+                                      : insert(objToIndex.value(), loc);
             if (_buildInBackground)
                 exec->saveState();
             if (ret.isOK()) {
@@ -465,13 +655,28 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
         }
     }
 
+    if (keyGenerator) {
+        Status status = keyGenerator->finish();
+        if (!status.isOK()) {
+            return status;
+        }
+        log() << "generated the keys of " << _indexes.size() << " indexes on "
+              << keyGenerationThreads << " threads, waiting " << keyGenerator->getWaitTime()
+              << " for them while scanning";
+        keyGenerator.reset();
+    }
+
     progress->finished();
 
+    const int scanSecs = t.seconds();
+
     Status ret = doneInserting(dupsOut);
     if (!ret.isOK())
         return ret;
 
-    log() << "build index done.  scanned " << n << " total records. " << t.seconds() << " secs";
+    log() << "build index done.  scanned " << n << " total records. " << t.seconds() << " secs ("
+          << scanSecs << " secs scanning, " << (t.seconds() - scanSecs)
+          << " secs loading the sorted keys)";
 
     return Status::OK();
 }
@@ -503,16 +708,65 @@ Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
             continue;
         LOG(1) << "\t bulk commit starting for index: "
                << _indexes[i].block->getEntry()->descriptor()->indexName();
+
+        // The scan of a hybrid build does not see a single version of the collection, so the keys
+        // it rejects as duplicates may belong to versions of documents that no longer exist.
+        std::set<RecordId> hybridDups;
+        const auto& interceptor = _indexes[i].interceptor;
         Status status = _indexes[i].real->commitBulk(_opCtx,
                                                      _indexes[i].bulk.get(),
                                                      _allowInterruption,
                                                      _indexes[i].options.dupsAllowed,
-                                                     dupsOut);
+                                                     interceptor ? &hybridDups : dupsOut);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (interceptor) {
+            status = _finishHybridBulkLoad(_indexes[i], hybridDups);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::_finishHybridBulkLoad(const IndexToBuild& index,
+                                                  const std::set<RecordId>& dups) {
+    // Index the rejected documents again as they are now. Since the index has an interceptor, this
+    // turns into side writes, whose keys are checked for duplicates when the build commits.
+    for (const auto& loc : dups) {
+        Status status = writeConflictRetry(_opCtx, "index build", _collection->ns().ns(), [&] {
+            WriteUnitOfWork wunit(_opCtx);
+            Snapshotted<BSONObj> doc;
+            if (_collection->findDoc(_opCtx, loc, &doc) &&
+                (!index.filterExpression || index.filterExpression->matchesBSON(doc.value()))) {
+                int64_t unused;
+                Status status =
+                    index.real->insert(_opCtx, doc.value(), loc, index.options, &unused);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+            wunit.commit();
+            return Status::OK();
+        });
         if (!status.isOK()) {
             return status;
         }
     }
 
+    // Apply what was written during the scan while writers are still let in, so that little is
+    // left for commit(), which runs under an exclusive lock.
+    Status status = index.interceptor->drainWritesIntoIndex(_opCtx, index.real);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    log() << "applied " << index.interceptor->getNumApplied() << " writes made to index "
+          << index.block->getIndexName() << " during the collection scan";
     return Status::OK();
 }
 
@@ -530,6 +784,21 @@ void MultiIndexBlockImpl::commit(stdx::function<void(const BSONObj& spec)> onCre
     }
     MultikeyPathTracker::get(_opCtx).stopTrackingMultikeyPathInfo();
 
+    // With the exclusive lock held, no write can come after the ones applied here, so the indexes
+    // of a hybrid build take writes directly from then on.
+    for (size_t i = 0; i < _indexes.size(); i++) {
+        const auto& interceptor = _indexes[i].interceptor;
+        if (!interceptor) {
+            continue;
+        }
+        uassertStatusOK(interceptor->drainWritesIntoIndex(_opCtx, _indexes[i].real));
+        uassertStatusOK(interceptor->checkDuplicateKeyConstraints(_opCtx, _indexes[i].real));
+
+        IndexCatalogEntry* entry = _indexes[i].block->getEntry();
+        _opCtx->recoveryUnit()->onCommit(
+            [entry](boost::optional<Timestamp>) { entry->setIndexBuildInterceptor(nullptr); });
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (onCreateFn) {
             onCreateFn(_indexes[i].block->getSpec());
@@ -539,13 +808,15 @@ void MultiIndexBlockImpl::commit(stdx::function<void(const BSONObj& spec)> onCre
 
         // The bulk builder will track multikey information itself. Non-bulk builders re-use the
         // code path that a typical insert/update uses. State is altered on the non-bulk build
-        // path to accumulate the multikey information on the `MultikeyPathTracker`.
+        // path to accumulate the multikey information on the `MultikeyPathTracker`. A hybrid build
+        // takes both paths, as it indexes the duplicates of its scan again like an insert.
         if (_indexes[i].bulk) {
             const auto& bulkBuilder = _indexes[i].bulk;
             if (bulkBuilder->isMultikey()) {
                 _indexes[i].block->getEntry()->setMultikey(_opCtx, bulkBuilder->getMultikeyPaths());
             }
-        } else {
+        }
+        if (!_indexes[i].bulk || _indexes[i].interceptor) {
             auto multikeyPaths =
                 boost::optional<MultikeyPaths>(MultikeyPathTracker::get(_opCtx).getMultikeyPathInfo(
                     _collection->ns(), _indexes[i].block->getIndexName()));
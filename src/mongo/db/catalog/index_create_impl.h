@@ -191,6 +191,7 @@ public:
 private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
+    class ParallelKeyGenerator;
 
     struct IndexToBuild {
         std::unique_ptr<IndexCatalogImpl::IndexBuildBlock> block;
@@ -199,11 +200,20 @@ private:
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
         std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
 
+        // Set on a hybrid build, which fills 'bulk' from a scan that lets writers in.
+        std::shared_ptr<IndexBuildInterceptor> interceptor;
+
         InsertDeleteOptions options;
     };
 
     virtual bool initBackgroundIndexFromSpec(const BSONObj& spec) const = 0;
 
+    /**
+     * Indexes again the documents whose keys the bulk load of a hybrid build rejected as 'dups',
+     * then applies the side writes made so far.
+     */
+    Status _finishHybridBulkLoad(const IndexToBuild& index, const std::set<RecordId>& dups);
+
     std::vector<IndexToBuild> _indexes;
 
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
@@ -213,6 +223,7 @@ private:
     OperationContext* _opCtx;
 
     bool _buildInBackground;
+    bool _buildIsHybrid = false;
     bool _allowInterruption;
     bool _ignoreUnique;
 
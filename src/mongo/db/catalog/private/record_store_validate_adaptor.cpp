@@ -121,6 +121,25 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
                                                const IndexDescriptor* descriptor,
                                                ValidateResults* results,
                                                int64_t* numTraversedKeys) {
+    _traverseIndex(_opCtx, iam, descriptor, results, numTraversedKeys, nullptr);
+}
+
+void RecordStoreValidateAdaptor::traverseIndexConcurrently(OperationContext* opCtx,
+                                                           const IndexAccessMethod* iam,
+                                                           const IndexDescriptor* descriptor,
+                                                           ValidateResults* results,
+                                                           int64_t* numTraversedKeys) {
+    IndexKeyBatch batch(_indexConsistency->getIndexNumber(descriptor->indexNamespace()));
+    _traverseIndex(opCtx, iam, descriptor, results, numTraversedKeys, &batch);
+    _indexConsistency->addIndexKeyBatch(batch);
+}
+
+void RecordStoreValidateAdaptor::_traverseIndex(OperationContext* opCtx,
+                                                const IndexAccessMethod* iam,
+                                                const IndexDescriptor* descriptor,
+                                                ValidateResults* results,
+                                                int64_t* numTraversedKeys,
+                                                IndexKeyBatch* batch) {
     auto indexNs = descriptor->indexNamespace();
     int indexNumber = _indexConsistency->getIndexNumber(indexNs);
     int64_t numKeys = 0;
@@ -131,7 +150,8 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
     bool isFirstEntry = true;
 
-    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
+    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(opCtx, true);
+    const int interruptInterval = 4096;
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
 
@@ -148,9 +168,19 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
             results->valid = false;
         }
 
-        _indexConsistency->addIndexKey(*indexKeyString, indexNumber);
+        if (batch) {
+            _indexConsistency->addIndexKeyToBatch(*indexKeyString, batch);
+        } else {
+            _indexConsistency->addIndexKey(*indexKeyString, indexNumber);
+        }
 
         numKeys++;
+        // The validation's operation is the one that can be killed, even when the index is read
+        // on another thread's behalf. Only its kill status may be read from here.
+        if (opCtx != _opCtx && !(numKeys % interruptInterval)) {
+            auto killStatus = _opCtx->getKillStatus();
+            uassert(killStatus, "index traversal interrupted", killStatus == ErrorCodes::OK);
+        }
         isFirstEntry = false;
         prevIndexKeyString.swap(indexKeyString);
     }
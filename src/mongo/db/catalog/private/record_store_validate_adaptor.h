@@ -77,6 +77,17 @@ public:
                        ValidateResults* results,
                        int64_t* numTraversedKeys);
 
+    /**
+     * Like traverseIndex(), but reads the index through 'opCtx', which belongs to another thread
+     * than the validation's own. The index keys are recorded for index consistency once the
+     * whole index has been traversed, so several indexes can be traversed at once.
+     */
+    void traverseIndexConcurrently(OperationContext* opCtx,
+                                   const IndexAccessMethod* iam,
+                                   const IndexDescriptor* descriptor,
+                                   ValidateResults* results,
+                                   int64_t* numTraversedKeys);
+
     /**
      * Traverses the record store to retrieve every record and go through its document key
      * set to keep track of the index consistency during a validation.
@@ -92,6 +103,17 @@ public:
     void validateIndexKeyCount(IndexDescriptor* idx, int64_t numRecs, ValidateResults& results);
 
 private:
+    /**
+     * Traverses the index through 'opCtx'. Each index key is added to 'batch' when it is not
+     * null, and directly to the index consistency otherwise.
+     */
+    void _traverseIndex(OperationContext* opCtx,
+                        const IndexAccessMethod* iam,
+                        const IndexDescriptor* descriptor,
+                        ValidateResults* results,
+                        int64_t* numTraversedKeys,
+                        IndexKeyBatch* batch);
+
     OperationContext* _opCtx;             // Not owned.
     IndexConsistency* _indexConsistency;  // Not owned.
     ValidateCmdLevel _level;
@@ -42,6 +42,20 @@ namespace mongo {
 namespace {
 const ServiceContext::Decoration<UUIDCatalog> getCatalog =
     ServiceContext::declareDecoration<UUIDCatalog>();
+
+// Source of the catalog epochs. Sharing it between all UUIDCatalog instances makes a cached epoch
+// identify the catalog state unambiguously, even after the catalog it came from has been destroyed.
+AtomicUInt64 epochCounter;
+
+// Namespaces which this thread recently resolved through lookupNSSByUUID, valid while the catalog
+// still has epoch 'epoch'.
+struct CachedNamespaces {
+    static constexpr size_t kMaxSize = 128;
+
+    uint64_t epoch = 0;
+    stdx::unordered_map<CollectionUUID, NamespaceString, CollectionUUID::Hash> namespaces;
+};
+thread_local CachedNamespaces cachedNamespaces;
 }  // namespace
 
 void UUIDCatalogObserver::onCreateCollection(OperationContext* opCtx,
@@ -167,12 +181,14 @@ void UUIDCatalog::onCloseCatalog() {
     _shadowCatalog.emplace();
     for (auto entry : _catalog)
         _shadowCatalog->insert({entry.first, entry.second->ns()});
+    _bumpEpoch_inlock();
 }
 
 void UUIDCatalog::onOpenCatalog() {
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     invariant(_shadowCatalog);
     _shadowCatalog.reset();
+    _bumpEpoch_inlock();
 }
 
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
@@ -182,10 +198,26 @@ Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
+    // Read the epoch before the catalog, so that the cache is never tagged with an epoch newer
+    // than the state it holds.
+    const uint64_t epoch = _epoch.load();
+    auto& cache = cachedNamespaces;
+    if (cache.epoch != epoch) {
+        cache.epoch = epoch;
+        cache.namespaces.clear();
+    } else {
+        auto cachedIt = cache.namespaces.find(uuid);
+        if (cachedIt != cache.namespaces.end())
+            return cachedIt->second;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto foundIt = _catalog.find(uuid);
-    if (foundIt != _catalog.end())
+    if (foundIt != _catalog.end()) {
+        if (epoch && cache.namespaces.size() < CachedNamespaces::kMaxSize)
+            cache.namespaces.emplace(uuid, foundIt->second->ns());
         return foundIt->second->ns();
+    }
 
     // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
     // using the pre-close state. This ensures that any tasks reloading the catalog can see their
@@ -271,6 +303,7 @@ void UUIDCatalog::_registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collecti
         std::pair<CollectionUUID, Collection*> entry = std::make_pair(uuid, coll);
         LOG(2) << "registering collection " << coll->ns() << " with UUID " << uuid.toString();
         invariant(_catalog.insert(entry).second == true);
+        _bumpEpoch_inlock();
     }
 }
 Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
@@ -284,6 +317,11 @@ Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
     auto foundCol = foundIt->second;
     LOG(2) << "unregistering collection " << foundCol->ns() << " with UUID " << uuid.toString();
     _catalog.erase(foundIt);
+    _bumpEpoch_inlock();
     return foundCol;
 }
+
+void UUIDCatalog::_bumpEpoch_inlock() {
+    _epoch.store(epochCounter.addAndFetch(1));
+}
 }  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/uuid.h"
 
@@ -176,6 +177,9 @@ public:
      * This function gets the NamespaceString from the Collection* pointer that
      * corresponds to CollectionUUID uuid. If there is no such pointer, an empty
      * NamespaceString is returned. See onCloseCatalog/onOpenCatalog for more info.
+     *
+     * Does not take the catalog mutex if the calling thread resolved 'uuid' before and the catalog
+     * has not changed since.
      */
     NamespaceString lookupNSSByUUID(CollectionUUID uuid) const;
 
@@ -211,7 +215,17 @@ private:
     void _registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll);
     Collection* _removeUUIDCatalogEntry_inlock(CollectionUUID uuid);
 
+    /**
+     * Invalidates the namespaces that threads have cached from lookupNSSByUUID. Must be called
+     * with '_catalogLock' held after every change to '_catalog' or '_shadowCatalog'.
+     */
+    void _bumpEpoch_inlock();
+
     mutable mongo::stdx::mutex _catalogLock;
+
+    // Changes whenever the catalog does. A namespace that a thread cached from lookupNSSByUUID is
+    // only used while this still has the value it had when the namespace was looked up.
+    AtomicUInt64 _epoch;
     /**
      * When present, indicates that the catalog is in closed state, and contains a map from UUID
      * to pre-close NSS. See also onCloseCatalog.
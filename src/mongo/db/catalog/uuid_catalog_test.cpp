@@ -123,6 +123,34 @@ TEST_F(UUIDCatalogTest, OnRenameCollection) {
     ASSERT_EQUALS(catalog.lookupCollectionByUUID(oldUUID), &newCol);
 }
 
+TEST_F(UUIDCatalogTest, LookupNSSByUUIDAfterRenameAndDrop) {
+    // Repeated lookups may be served from this thread's cache, but must see every change.
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), nss);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), nss);
+
+    NamespaceString newNss(nss.db(), "newcol");
+    Collection newCol(stdx::make_unique<CollectionMock>(newNss));
+    catalog.onRenameCollection(&opCtx, &newCol, colUUID);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), newNss);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), newNss);
+
+    catalog.onDropCollection(&opCtx, colUUID);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), NamespaceString());
+}
+
+TEST_F(UUIDCatalogTest, LookupNSSByUUIDDoesNotMixUpCatalogs) {
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), nss);
+
+    // A different catalog which knows the same UUID under another name.
+    UUIDCatalog otherCatalog;
+    NamespaceString otherNss("otherdb", "othercol");
+    Collection otherCol(stdx::make_unique<CollectionMock>(otherNss));
+    otherCatalog.onCreateCollection(&opCtx, &otherCol, colUUID);
+    ASSERT_EQUALS(otherCatalog.lookupNSSByUUID(colUUID), otherNss);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), nss);
+    otherCatalog.onDropCollection(&opCtx, colUUID);
+}
+
 TEST_F(UUIDCatalogTest, NonExistingNextCol) {
     ASSERT_FALSE(catalog.next(nss.db(), colUUID));
     ASSERT_FALSE(catalog.next(nss.db(), nextUUID));
@@ -45,6 +45,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/cursor_server_params.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/repl_client_info.h"
@@ -88,6 +89,8 @@ ClientCursor::ClientCursor(ClientCursorParams params,
       _readConcernLevel(params.readConcernLevel),
       _cursorManager(cursorManager),
       _originatingCommand(params.originatingCommandObj),
+      _queryStatsKey(CurOp::get(operationUsingCursor)->debug().queryStatsKey),
+      _queryStatsShape(CurOp::get(operationUsingCursor)->debug().queryStatsShape),
       _queryOptions(params.queryOptions),
       _exec(std::move(params.exec)),
       _operationUsingCursor(operationUsingCursor),
@@ -165,6 +165,18 @@ public:
         return _originatingCommand;
     }
 
+    /**
+     * If the operation which created the cursor was sampled for $queryStats, the shape which the
+     * cursor's getMores are attributed to. Otherwise empty.
+     */
+    const std::string& getQueryStatsKey() const {
+        return _queryStatsKey;
+    }
+
+    const BSONObj& getQueryStatsShape() const {
+        return _queryStatsShape;
+    }
+
     /**
      * Returns the total number of query results returned by the cursor so far.
      */
@@ -303,6 +315,10 @@ private:
     // Holds an owned copy of the command specification received from the client.
     const BSONObj _originatingCommand;
 
+    // Copied from the OpDebug of the operation which created the cursor.
+    const std::string _queryStatsKey;
+    const BSONObj _queryStatsShape;
+
     // See the QueryOptions enum in dbclientinterface.h.
     const int _queryOptions = 0;
 
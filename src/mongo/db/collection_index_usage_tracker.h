@@ -58,12 +58,14 @@ public:
         IndexUsageStats(const IndexUsageStats& other)
             : accesses(other.accesses.load()),
               trackerStartTime(other.trackerStartTime),
-              indexKey(other.indexKey) {}
+              indexKey(other.indexKey),
+              storageStats(other.storageStats) {}
 
         IndexUsageStats& operator=(const IndexUsageStats& other) {
             accesses.store(other.accesses.load());
             trackerStartTime = other.trackerStartTime;
             indexKey = other.indexKey;
+            storageStats = other.storageStats;
             return *this;
         }
 
@@ -75,6 +77,10 @@ public:
 
         // An owned copy of the associated IndexDescriptor's index key.
         BSONObj indexKey;
+
+        // The in-memory statistics the storage engine keeps about the index. Only filled in when
+        // the stats are reported, and empty if the storage engine keeps none.
+        BSONObj storageStats;
     };
 
     /**
@@ -50,11 +50,13 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/windowed_latency_histogram.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/op_msg_rpc_impls.h"
 #include "mongo/rpc/protocol.h"
 #include "mongo/rpc/write_concern_error_detail.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/invariant.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -474,7 +476,21 @@ private:
     const std::string _dbName;
 };
 
-Command::~Command() = default;
+Command::~Command() {
+    delete _latencyPercentiles.load();
+}
+
+void Command::recordLatency(uint64_t latencyMicros, Date_t now) const {
+    auto histogram = _latencyPercentiles.load();
+    if (!histogram) {
+        auto newHistogram = stdx::make_unique<WindowedLatencyHistogram>();
+        histogram = _latencyPercentiles.compareAndSwap(nullptr, newHistogram.get());
+        if (!histogram) {
+            histogram = newHistogram.release();
+        }
+    }
+    histogram->record(latencyMicros, now);
+}
 
 std::unique_ptr<CommandInvocation> BasicCommand::parse(OperationContext* opCtx,
                                                        const OpMsgRequest& request) {
@@ -55,6 +55,7 @@ namespace mongo {
 class Command;
 class CommandInvocation;
 class OperationContext;
+class WindowedLatencyHistogram;
 
 namespace mutablebson {
 class Document;
@@ -397,6 +398,20 @@ public:
         _commandsFailed.increment();
     }
 
+    /**
+     * Records the latency of one execution of this command, for its percentiles over the last
+     * minute. Thread-safe.
+     */
+    void recordLatency(uint64_t latencyMicros, Date_t now) const;
+
+    /**
+     * Returns the latencies of this command recorded over the last minute, or nullptr if none was
+     * ever recorded.
+     */
+    const WindowedLatencyHistogram* getLatencyPercentiles() const {
+        return _latencyPercentiles.load();
+    }
+
     /**
      * Generates a reply from the 'help' information associated with a command. The state of
      * the passed ReplyBuilder will be in kOutputDocs after calling this method.
@@ -415,6 +430,10 @@ private:
     // Pointers to hold the metrics tree references
     ServerStatusMetricField<Counter64> _commandsExecutedMetric;
     ServerStatusMetricField<Counter64> _commandsFailedMetric;
+
+    // Latencies of this command, allocated when the first one is recorded since most commands
+    // are never run.
+    mutable AtomicWord<WindowedLatencyHistogram*> _latencyPercentiles{nullptr};
 };
 
 /**
@@ -0,0 +1,221 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultSampleSize = 10000;
+const long long kMaxSampleSize = 1000 * 1000;
+const long long kDefaultNumBuckets = 100;
+const long long kMaxNumBuckets = 1000;
+
+long long parsePositiveLong(const BSONObj& cmdObj,
+                            StringData fieldName,
+                            long long defaultValue,
+                            long long maxValue) {
+    BSONElement elt = cmdObj[fieldName];
+    if (elt.eoo()) {
+        return defaultValue;
+    }
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << "'" << fieldName << "' must be a number",
+            elt.isNumber());
+    long long value = elt.safeNumberLong();
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "'" << fieldName << "' must be between 1 and " << maxValue,
+            value >= 1 && value <= maxValue);
+    return value;
+}
+
+/**
+ * Appends the values 'doc' holds for 'path' to 'values', each as the only element of an object
+ * with an empty field name. Arrays contribute each of their elements, and a missing path
+ * contributes null, mirroring the keys a btree index would generate.
+ */
+void extractValues(const BSONObj& doc, const std::string& path, std::vector<BSONObj>* values) {
+    BSONElementSet elements;
+    dotted_path_support::extractAllElementsAlongPath(doc, path, elements);
+    if (elements.empty()) {
+        values->push_back(BSON("" << BSONNULL));
+        return;
+    }
+    for (auto&& elt : elements) {
+        BSONObjBuilder bob;
+        bob.appendAs(elt, "");
+        values->push_back(bob.obj());
+    }
+}
+
+/**
+ * { analyze: <collection>, keys: [<path>, ...], sampleSize: <n>, buckets: <n> }
+ *
+ * Samples documents from a collection and builds an equi-depth histogram and a distinct-value
+ * sketch for each of the given paths. The statistics are kept with the collection's plan cache
+ * and are used by the planner to discard unselective candidate plans before they are raced
+ * against each other.
+ */
+class AnalyzeCmd : public BasicCommand {
+public:
+    AnalyzeCmd() : BasicCommand("analyze") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "Builds field statistics used by the query planner from a sample of documents.\n"
+               "{ analyze: <collection>, keys: [<path>, ...], sampleSize: <n>, buckets: <n> }";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        AuthorizationSession* authzSession = AuthorizationSession::get(client);
+        ResourcePattern pattern = parseResourcePattern(dbname, cmdObj);
+
+        if (authzSession->isAuthorizedForActionsOnResource(pattern, ActionType::planCacheWrite)) {
+            return Status::OK();
+        }
+
+        return Status(ErrorCodes::Unauthorized, "unauthorized");
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        BSONElement keysElt = cmdObj["keys"];
+        uassert(ErrorCodes::BadValue,
+                "'keys' must be a non-empty array of field paths",
+                keysElt.type() == Array && !keysElt.Obj().isEmpty());
+        std::vector<std::string> paths;
+        for (auto&& path : keysElt.Obj()) {
+            uassert(ErrorCodes::BadValue,
+                    "'keys' must be a non-empty array of field paths",
+                    path.type() == String && !path.valueStringData().empty());
+            paths.push_back(path.String());
+        }
+
+        const long long sampleSize =
+            parsePositiveLong(cmdObj, "sampleSize", kDefaultSampleSize, kMaxSampleSize);
+        const long long numBuckets =
+            parsePositiveLong(cmdObj, "buckets", kDefaultNumBuckets, kMaxNumBuckets);
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound, "ns not found", collection);
+
+        // Small collections are read in full. Otherwise sample at random when the storage engine
+        // supports it, which is the same primitive $sample is built on.
+        RecordStore* rs = collection->getRecordStore();
+        std::unique_ptr<RecordCursor> cursor;
+        bool random = false;
+        if (rs->numRecords(opCtx) > sampleSize) {
+            cursor = rs->getRandomCursor(opCtx);
+            random = static_cast<bool>(cursor);
+        }
+        if (!cursor) {
+            cursor = rs->getCursor(opCtx);
+        }
+
+        std::vector<std::vector<BSONObj>> values(paths.size());
+        std::vector<HyperLogLog> sketches(paths.size());
+        long long sampled = 0;
+        while (sampled < sampleSize) {
+            if (sampled % 128 == 0) {
+                opCtx->checkForInterrupt();
+            }
+
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            ++sampled;
+
+            BSONObj doc = record->data.toBson();
+            for (size_t i = 0; i < paths.size(); ++i) {
+                size_t first = values[i].size();
+                extractValues(doc, paths[i], &values[i]);
+                for (size_t j = first; j < values[i].size(); ++j) {
+                    sketches[i].add(values[i][j]);
+                }
+            }
+        }
+
+        CollectionStatistics* stats = collection->infoCache()->getStatistics();
+        BSONObjBuilder fieldsBuilder(result.subobjStart("fields"));
+        for (size_t i = 0; i < paths.size(); ++i) {
+            auto fieldStats = std::make_shared<FieldStatistics>();
+            fieldStats->histogram = FieldHistogram::make(&values[i], numBuckets);
+            fieldStats->distinct = sketches[i];
+            fieldStats->sampleSize = sampled;
+
+            BSONObjBuilder fieldBuilder(fieldsBuilder.subobjStart(paths[i]));
+            fieldStats->appendToBSON(&fieldBuilder);
+            fieldBuilder.doneFast();
+
+            stats->set(paths[i], std::move(fieldStats));
+        }
+        fieldsBuilder.doneFast();
+
+        LOG(1) << "analyze " << nss << " sampled " << sampled << " documents for "
+               << paths.size() << " fields";
+
+        result.append("ns", nss.ns());
+        result.appendNumber("sampled", sampled);
+        result.appendBool("random", random);
+        return true;
+    }
+
+} analyzeCmd;
+
+}  // namespace
+}  // namespace mongo
@@ -30,16 +30,26 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cstdlib>
+#include <numeric>
+
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/run_aggregate.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/parallel_collection_scan.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/view_response_formatter.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/util/log.h"
@@ -51,6 +61,114 @@ using std::unique_ptr;
 using std::string;
 using std::stringstream;
 
+/**
+ * Returns a parallel scan to run a count with, if parallel collection scans are enabled and the
+ * plan in 'exec' counts the results of a bare collection scan. Each worker of a parallel scan reads
+ * from its own snapshot, so only the 'local' and 'available' read concerns are eligible. Counts run
+ * through DBDirectClient are not eligible either, since their caller may be holding locks.
+ */
+boost::optional<ParallelCollectionScan> makeParallelCountScan(OperationContext* opCtx,
+                                                              const Collection* collection,
+                                                              PlanExecutor* exec) {
+    const int maxRanges = internalQueryParallelCollectionScanMaxRanges.load();
+    if (maxRanges < 2 || !collection || opCtx->getClient()->isInDirectClient()) {
+        return boost::none;
+    }
+
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern) {
+        return boost::none;
+    }
+
+    PlanStage* root = exec->getRootStage();
+    if (STAGE_COUNT != root->stageType() || root->getChildren().size() != 1 ||
+        STAGE_COLLSCAN != root->getChildren()[0]->stageType()) {
+        return boost::none;
+    }
+
+    return ParallelCollectionScan::make(opCtx, collection, static_cast<size_t>(maxRanges));
+}
+
+/**
+ * Counts the documents matching 'request' by summing the matches in each range of 'scan', then
+ * applies the request's skip and limit the way CountStage does. Fills out 'summaryStats' with the
+ * totals across all ranges.
+ */
+long long countInParallel(OperationContext* opCtx,
+                          const ParallelCollectionScan& scan,
+                          const CountRequest& request,
+                          PlanSummaryStats* summaryStats) {
+    std::vector<long long> nCounted(scan.numRanges());
+    std::vector<size_t> docsExamined(scan.numRanges());
+
+    auto countRange = [&](OperationContext* workerOpCtx,
+                          Collection* collection,
+                          const CollectionScanParams& params,
+                          size_t rangeIndex) -> Status {
+        auto qr = stdx::make_unique<QueryRequest>(request.getNs());
+        qr->setFilter(request.getQuery());
+        qr->setCollation(request.getCollation());
+
+        const boost::intrusive_ptr<ExpressionContext> expCtx;
+        auto statusWithCQ =
+            CanonicalQuery::canonicalize(workerOpCtx,
+                                         std::move(qr),
+                                         expCtx,
+                                         ExtensionsCallbackReal(workerOpCtx, &collection->ns()),
+                                         MatchExpressionParser::kAllowAllSpecialFeatures);
+        if (!statusWithCQ.isOK()) {
+            return statusWithCQ.getStatus();
+        }
+        auto cq = std::move(statusWithCQ.getValue());
+        if (request.getCollation().isEmpty() && collection->getDefaultCollator()) {
+            cq->setCollator(collection->getDefaultCollator()->clone());
+        }
+
+        auto ws = stdx::make_unique<WorkingSet>();
+        auto root = stdx::make_unique<CollectionScan>(workerOpCtx, params, ws.get(), cq->root());
+        auto statusWithExec = PlanExecutor::make(workerOpCtx,
+                                                 std::move(ws),
+                                                 std::move(root),
+                                                 std::move(cq),
+                                                 collection,
+                                                 PlanExecutor::YIELD_AUTO);
+        if (!statusWithExec.isOK()) {
+            return statusWithExec.getStatus();
+        }
+        auto exec = std::move(statusWithExec.getValue());
+
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        long long n = 0;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+            ++n;
+        }
+        if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+            return WorkingSetCommon::getMemberObjectStatus(obj);
+        }
+
+        nCounted[rangeIndex] = n;
+        docsExamined[rangeIndex] =
+            static_cast<const CollectionScanStats*>(exec->getRootStage()->getSpecificStats())
+                ->docsTested;
+        return Status::OK();
+    };
+    uassertStatusOK(scan.run(opCtx, countRange));
+
+    long long n = std::accumulate(nCounted.begin(), nCounted.end(), 0LL);
+    summaryStats->nReturned = 1;
+    summaryStats->totalDocsExamined =
+        std::accumulate(docsExamined.begin(), docsExamined.end(), size_t(0));
+
+    n = std::max(0LL, n - request.getSkip());
+    const long long limit = std::abs(request.getLimit());
+    if (limit != 0 && limit < n) {
+        n = limit;
+    }
+    return n;
+}
+
 /**
  * Implements the MongoD side of the count command.
  */
@@ -218,6 +336,18 @@ public:
             curOp->setPlanSummary_inlock(Explain::getPlanSummary(exec.get()));
         }
 
+        if (auto parallelScan = makeParallelCountScan(opCtx, collection, exec.get())) {
+            // The workers lock the collection themselves, so release the executor and our locks.
+            exec.reset();
+            ctx.reset();
+
+            PlanSummaryStats summaryStats;
+            result.appendNumber(
+                "n", countInParallel(opCtx, *parallelScan, request.getValue(), &summaryStats));
+            curOp->debug().setPlanSummaryMetrics(summaryStats);
+            return true;
+        }
+
         Status execPlanStatus = exec->executePlan();
         uassertStatusOK(execPlanStatus);
 
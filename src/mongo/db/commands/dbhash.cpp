@@ -107,6 +107,29 @@ public:
             }
         }
 
+        // With 'rangeSize', each collection's documents are also hashed in consecutive ranges of
+        // that many documents in _id order, so that two nodes whose collection hashes differ can
+        // find the differing ranges, and rehash only those with 'idRange'.
+        long long rangeSize = 0;
+        if (auto rangeSizeElt = cmdObj["rangeSize"]) {
+            uassert(ErrorCodes::BadValue,
+                    "rangeSize must be a positive number",
+                    rangeSizeElt.isNumber() && rangeSizeElt.safeNumberLong() > 0);
+            rangeSize = rangeSizeElt.safeNumberLong();
+        }
+
+        BSONObj idRange;
+        if (auto idRangeElt = cmdObj["idRange"]) {
+            uassert(ErrorCodes::BadValue,
+                    "idRange must be an object with 'min' and 'max' fields",
+                    idRangeElt.type() == Object && idRangeElt.Obj()["min"] &&
+                        idRangeElt.Obj()["max"] && idRangeElt.Obj().nFields() == 2);
+            uassert(ErrorCodes::BadValue,
+                    "idRange requires exactly one collection in 'collections'",
+                    desiredCollections.size() == 1);
+            idRange = idRangeElt.Obj();
+        }
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
@@ -145,6 +168,7 @@ public:
 
         BSONArrayBuilder cappedCollections;
         BSONObjBuilder collectionsByUUID;
+        BSONObjBuilder rangesByCollection;
 
         BSONObjBuilder bb(result.subobjStart("collections"));
         for (const auto& collectionName : colls) {
@@ -186,7 +210,12 @@ public:
             }
 
             // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            BSONArrayBuilder ranges;
+            std::string hash =
+                _hashCollection(opCtx, db, collNss.toString(), idRange, rangeSize, &ranges);
+            if (rangeSize) {
+                rangesByCollection.append(collNss.coll(), ranges.arr());
+            }
 
             bb.append(collNss.coll(), hash);
             md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
@@ -195,6 +224,9 @@ public:
 
         result.append("capped", BSONArray(cappedCollections.done()));
         result.append("uuids", collectionsByUUID.done());
+        if (rangeSize) {
+            result.append("ranges", rangesByCollection.done());
+        }
 
         md5digest d;
         md5_finish(&globalState, d);
@@ -207,9 +239,17 @@ public:
     }
 
 private:
+    /**
+     * Returns the hash of the documents of 'fullCollectionName' whose _id is within 'idRange', or
+     * of all of them if 'idRange' is empty. If 'rangeSize' is non-zero, also appends the hash of
+     * each consecutive range of that many documents to 'ranges'.
+     */
     std::string _hashCollection(OperationContext* opCtx,
                                 Database* db,
-                                const std::string& fullCollectionName) {
+                                const std::string& fullCollectionName,
+                                const BSONObj& idRange,
+                                long long rangeSize,
+                                BSONArrayBuilder* ranges) {
 
         NamespaceString ns(fullCollectionName);
 
@@ -248,15 +288,28 @@ private:
 
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
         if (desc) {
+            BSONObj startKey;
+            BSONObj endKey;
+            auto boundInclusion = BoundInclusion::kIncludeStartKeyOnly;
+            if (!idRange.isEmpty()) {
+                startKey = BSON("" << idRange["min"]);
+                endKey = BSON("" << idRange["max"]);
+                boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+            }
             exec = InternalPlanner::indexScan(opCtx,
                                               collection,
                                               desc,
-                                              BSONObj(),
-                                              BSONObj(),
-                                              BoundInclusion::kIncludeStartKeyOnly,
+                                              startKey,
+                                              endKey,
+                                              boundInclusion,
                                               PlanExecutor::NO_YIELD,
                                               InternalPlanner::FORWARD,
                                               InternalPlanner::IXSCAN_FETCH);
+        } else if (!idRange.isEmpty() || rangeSize) {
+            uasserted(ErrorCodes::BadValue,
+                      str::stream() << "idRange and rangeSize require an _id index, which "
+                                    << fullCollectionName
+                                    << " does not have");
         } else if (collection->isCapped()) {
             exec = InternalPlanner::collectionScan(
                 opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
@@ -268,6 +321,22 @@ private:
         md5_state_t st;
         md5_init(&st);
 
+        md5_state_t rangeState;
+        long long rangeCount = 0;
+        BSONObj rangeMin;
+        BSONObj rangeMax;
+        auto finishRange = [&] {
+            md5digest d;
+            md5_finish(&rangeState, d);
+            ranges->append(BSON("min" << rangeMin.firstElement() << "max"
+                                      << rangeMax.firstElement()
+                                      << "count"
+                                      << rangeCount
+                                      << "md5"
+                                      << digestToString(d)));
+            rangeCount = 0;
+        };
+
         long long n = 0;
         PlanExecutor::ExecState state;
         BSONObj c;
@@ -275,6 +344,18 @@ private:
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
             md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
             n++;
+
+            if (rangeSize) {
+                if (!rangeCount) {
+                    md5_init(&rangeState);
+                    rangeMin = c["_id"].wrap();
+                }
+                md5_append(&rangeState, (const md5_byte_t*)c.objdata(), c.objsize());
+                rangeMax = c["_id"].wrap();
+                if (++rangeCount == rangeSize) {
+                    finishRange();
+                }
+            }
         }
         if (PlanExecutor::IS_EOF != state) {
             warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
@@ -282,6 +363,9 @@ private:
                       "Plan executor error while running dbHash command: " +
                           WorkingSetCommon::toStatusString(c));
         }
+        if (rangeCount) {
+            finishRange();
+        }
         md5digest d;
         md5_finish(&st, d);
         std::string hash = digestToString(d);
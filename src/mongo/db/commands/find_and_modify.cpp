@@ -205,6 +205,7 @@ void assertCanWrite(OperationContext* opCtx, const NamespaceString& nsString) {
 
 void recordStatsForTopCommand(OperationContext* opCtx) {
     auto curOp = CurOp::get(opCtx);
+    const auto& metrics = curOp->debug().additiveMetrics;
     Top::get(opCtx->getClient()->getServiceContext())
         .record(opCtx,
                 curOp->getNS(),
@@ -212,7 +213,9 @@ void recordStatsForTopCommand(OperationContext* opCtx) {
                 Top::LockType::WriteLocked,
                 durationCount<Microseconds>(curOp->elapsedTimeExcludingPauses()),
                 curOp->isCommand(),
-                curOp->getReadWriteType());
+                curOp->getReadWriteType(),
+                {metrics.storageBytesRead.get_value_or(0),
+                 metrics.storageTimeReadingMicros.get_value_or(0)});
 }
 
 class CmdFindAndModify : public BasicCommand {
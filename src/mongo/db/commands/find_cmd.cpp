@@ -325,7 +325,8 @@ public:
             BSONObj obj;
             PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
             long long numResults = 0;
-            while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
+            while (!FindCommon::enoughForFirstBatch(
+                       originalQR, numResults, firstBatch.bytesUsed()) &&
                    PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
                 // If we can't fit this result inside the current batch, then we stash it for later.
                 if (!FindCommon::haveSpaceForNext(obj, numResults, firstBatch.bytesUsed())) {
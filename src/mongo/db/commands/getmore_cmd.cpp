@@ -425,6 +425,8 @@ public:
                     curOp->setOriginatingCommand_inlock(originatingCommand);
                 }
             }
+            curOp->debug().queryStatsKey = cursor->getQueryStatsKey();
+            curOp->debug().queryStatsShape = cursor->getQueryStatsShape();
 
             CursorId respondWithId = 0;
             CursorResponseBuilder nextBatch(/*isInitialResponse*/ false, &result);
@@ -32,9 +32,13 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <regex>
+
+#include "mongo/base/parse_number.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connpool.h"
+#include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
@@ -55,6 +59,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/insert.h"
+#include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
@@ -63,7 +68,9 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
 #include "mongo/s/client/shard_connection.h"
@@ -93,6 +100,10 @@ namespace dps = ::mongo::dotted_path_support;
 namespace mr {
 namespace {
 
+// Whether mapReduce jobs that the aggregation framework can run, see translateToAggregation(), are
+// run as an aggregation instead of in JavaScript.
+MONGO_EXPORT_SERVER_PARAMETER(mapReduceTranslateToAggregation, bool, false);
+
 /**
  * Runs a count against the namespace specified by 'ns'. If the caller holds the global write lock,
  * then this function does not acquire any additional locks.
@@ -437,6 +448,120 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
     }
 }
 
+namespace {
+
+// A top-level field that can be used as an aggregation field path.
+#define MR_FIELD_PATTERN "([A-Za-z_][A-Za-z0-9_]*)"
+
+// function() { emit(this.<key>, this.<value> | <number>); }
+const std::regex kSumMapPattern(
+    R"(^\s*function\s*\(\s*\)\s*\{\s*emit\s*\(\s*this\.)" MR_FIELD_PATTERN
+    R"(\s*,\s*(?:this\.)" MR_FIELD_PATTERN R"(|(-?[0-9]+(?:\.[0-9]+)?))\s*\)\s*;?\s*\}\s*$)");
+
+// function(<key>, <values>) { return Array.sum(<values>); }
+const std::regex kSumReducePattern(
+    R"(^\s*function\s*\(\s*[A-Za-z_$][\w$]*\s*,\s*([A-Za-z_$][\w$]*)\s*\)\s*)"
+    R"(\{\s*return\s+Array\.sum\s*\(\s*\1\s*\)\s*;?\s*\}\s*$)");
+
+#undef MR_FIELD_PATTERN
+
+// The types of keys that are the same after a round trip through JavaScript, once 32-bit integers,
+// which become doubles, are converted. A missing key is emitted as null.
+const BSONArray kSumKeyTypes = BSON_ARRAY("double"
+                                          << "string"
+                                          << "objectId"
+                                          << "bool"
+                                          << "date"
+                                          << "null"
+                                          << "missing"
+                                          << "int"
+                                          << "long"
+                                          << "decimal");
+
+// The types of values that Array.sum() adds up as numbers.
+const BSONArray kSumValueTypes = BSON_ARRAY("double"
+                                            << "int"
+                                            << "long");
+
+/**
+ * Returns the code of a map or reduce function, or an empty string if it is not plain code.
+ */
+std::string functionCode(const BSONElement& elem) {
+    if (elem.type() != Code && elem.type() != String)
+        return std::string();
+    return elem._asCode();
+}
+
+}  // namespace
+
+boost::optional<AggregationTranslation> translateToAggregation(const BSONObj& cmdObj) {
+    const BSONElement out = cmdObj["out"];
+    if (out.type() != Object || !out.Obj()["inline"].trueValue())
+        return boost::none;
+
+    const BSONElement scope = cmdObj["scope"];
+    if (cmdObj["finalize"].trueValue() || (!scope.eoo() && !scope.isABSONObj()) ||
+        (scope.isABSONObj() && !scope.Obj().isEmpty()) ||
+        cmdObj.hasField("collation") || cmdObj.hasField("readConcern") ||
+        cmdObj.hasField("mapparams"))
+        return boost::none;
+
+    std::smatch mapMatch;
+    const std::string mapCode = functionCode(cmdObj["map"]);
+    if (!std::regex_match(mapCode, mapMatch, kSumMapPattern))
+        return boost::none;
+
+    const std::string reduceCode = functionCode(cmdObj["reduce"]);
+    if (!std::regex_match(reduceCode, kSumReducePattern))
+        return boost::none;
+
+    const std::string keyPath = "$" + mapMatch[1].str();
+    const BSONObj keyType = BSON("$type" << keyPath);
+    const BSONObj keyIsValid = BSON("$in" << BSON_ARRAY(keyType << kSumKeyTypes));
+
+    AggregationTranslation translation;
+    BSONObjBuilder group;
+    group.append("_id", keyPath);
+    if (mapMatch[2].matched) {
+        // Non-numbers make the group invalid, so converting them to 0 only avoids failing.
+        const std::string valuePath = "$" + mapMatch[2].str();
+        const BSONObj valueIsValid =
+            BSON("$in" << BSON_ARRAY(BSON("$type" << valuePath) << kSumValueTypes));
+        translation.valueIsField = true;
+        group.append("value",
+                     BSON("$sum" << BSON("$convert" << BSON("input" << valuePath << "to"
+                                                                    << "double"
+                                                                    << "onError"
+                                                                    << 0
+                                                                    << "onNull"
+                                                                    << 0))));
+        group.append("first", BSON("$first" << valuePath));
+        group.append("invalid",
+                     BSON("$sum" << BSON("$cond" << BSON_ARRAY(
+                                             BSON("$and" << BSON_ARRAY(keyIsValid << valueIsValid))
+                                             << 0
+                                             << 1))));
+    } else {
+        // JavaScript numbers are doubles, so the constant is summed as one.
+        double value;
+        if (!parseNumberFromString(mapMatch[3].str(), &value).isOK())
+            return boost::none;
+        group.append("value", BSON("$sum" << value));
+        group.append("invalid", BSON("$sum" << BSON("$cond" << BSON_ARRAY(keyIsValid << 0 << 1))));
+    }
+    group.append("n", BSON("$sum" << 1));
+
+    if (cmdObj["query"].type() == Object && !cmdObj["query"].Obj().isEmpty())
+        translation.pipeline.push_back(BSON("$match" << cmdObj["query"].Obj()));
+    if (cmdObj["sort"].type() == Object && !cmdObj["sort"].Obj().isEmpty())
+        translation.pipeline.push_back(BSON("$sort" << cmdObj["sort"].Obj()));
+    if (cmdObj["limit"].isNumber() && cmdObj["limit"].numberLong() > 0)
+        translation.pipeline.push_back(BSON("$limit" << cmdObj["limit"].numberLong()));
+    translation.pipeline.push_back(BSON("$group" << group.obj()));
+    translation.pipeline.push_back(BSON("$sort" << BSON("_id" << 1)));
+    return translation;
+}
+
 /**
  * Clean up the temporary and incremental collections
  */
@@ -895,11 +1020,9 @@ void State::init() {
     // setup js
     const string userToken =
         AuthorizationSession::get(Client::getCurrent())->getAuthenticatedUserNamesToken();
-    _scope.reset(getGlobalScriptEngine()->newScopeForCurrentThread());
+    _scope = getGlobalScriptEngine()->getPooledScopeForCurrentThread(
+        _opCtx, _config.dbname, "mapreduce" + userToken);
     _scope->requireOwnedObjects();
-    _scope->registerOperation(_opCtx);
-    _scope->setLocalDB(_config.dbname);
-    _scope->loadStored(_opCtx, true);
 
     if (!_config.scopeSetup.isEmpty())
         _scope->init(&_config.scopeSetup);
@@ -1338,6 +1461,107 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
     }
 }
 
+namespace {
+
+/**
+ * JavaScript has no 32-bit integers, so a NumberInt that went through a map function comes back as
+ * a double. Appends 'elem' as 'fieldName' the way it would have.
+ */
+void appendAsFromJS(BSONObjBuilder* builder, StringData fieldName, const BSONElement& elem) {
+    if (elem.type() == NumberInt) {
+        builder->append(fieldName, elem.numberDouble());
+    } else {
+        builder->appendAs(elem, fieldName);
+    }
+}
+
+/**
+ * Runs the aggregation produced by translateToAggregation() and appends the reply of an inline
+ * mapReduce to 'result'. Returns false, without appending anything, if the job must run in
+ * JavaScript instead, because some document does not have a key or value the aggregation handles
+ * identically or because of an error, which the JavaScript job will report if it recurs.
+ */
+bool runAsAggregation(OperationContext* opCtx,
+                      const Config& config,
+                      const AggregationTranslation& translation,
+                      const Timer& timer,
+                      BSONObjBuilder& result) {
+    BSONArrayBuilder pipeline;
+    for (const auto& stage : translation.pipeline)
+        pipeline.append(stage);
+
+    DBDirectClient client(opCtx);
+    BSONObj reply;
+    client.runCommand(config.nss.db().toString(),
+                      BSON("aggregate" << config.nss.coll() << "pipeline" << pipeline.arr()
+                                       << "allowDiskUse"
+                                       << true
+                                       << "cursor"
+                                       << BSONObj()),
+                      reply);
+    auto response = CursorResponse::parseFromBSON(reply);
+    if (!response.isOK()) {
+        LOG(1) << "mr aggregation failed, running in JavaScript: " << response.getStatus();
+        return false;
+    }
+
+    DBClientCursor cursor(&client,
+                          response.getValue().getNSS().ns(),
+                          response.getValue().getCursorId(),
+                          0,
+                          0,
+                          response.getValue().releaseBatch());
+
+    BSONArrayBuilder results;
+    long long numInputs = 0;
+    long long numReduces = 0;
+    long long numOutputs = 0;
+    try {
+        while (cursor.more()) {
+            const BSONObj group = cursor.next();
+            if (group["invalid"].numberLong() > 0)
+                return false;
+
+            const long long n = group["n"].numberLong();
+            BSONObjBuilder doc;
+            appendAsFromJS(&doc, "_id", group["_id"]);
+            if (translation.valueIsField && n == 1) {
+                appendAsFromJS(&doc, "value", group["first"]);
+            } else {
+                appendAsFromJS(&doc, "value", group["value"]);
+            }
+            if (results.len() + doc.len() > BSONObjMaxUserSize)
+                return false;
+            results.append(doc.obj());
+
+            numInputs += n;
+            numReduces += n > 1 ? 1 : 0;
+            ++numOutputs;
+        }
+    } catch (const DBException& ex) {
+        LOG(1) << "mr aggregation failed, running in JavaScript: " << redact(ex);
+        return false;
+    }
+
+    // Leave an empty job to JavaScript, which reports an error if the collection does not exist.
+    if (numInputs == 0)
+        return false;
+
+    result.appendArray("results", results.arr());
+    result.appendNumber("timeMillis", timer.millis());
+    if (config.verbose)
+        result.append("timing",
+                      BSON("total" << timer.millis() << "mode"
+                                   << "aggregation"));
+    result.append("counts",
+                  BSON("input" << numInputs << "emit" << numInputs << "reduce" << numReduces
+                               << "output"
+                               << numOutputs));
+    return true;
+}
+
+}  // namespace
+
 /**
  * This class represents a map/reduce command executed on a single server
  */
@@ -1401,6 +1625,14 @@ public:
 
         uassert(16149, "cannot run map reduce without the js engine", getGlobalScriptEngine());
 
+        if (mapReduceTranslateToAggregation.load() &&
+            serverGlobalParams.clusterRole == ClusterRole::None && !config.shardedFirstPass) {
+            if (auto translation = translateToAggregation(cmd)) {
+                if (runAsAggregation(opCtx, config, *translation, t, result))
+                    return true;
+            }
+        }
+
         // Prevent sharding state from changing during the MR.
         const auto collMetadata = [&] {
             // Get metadata before we check our version, to make sure it doesn't increment in the
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
@@ -411,5 +412,30 @@ void addPrivilegesRequiredForMapReduce(const BasicCommand* commandTemplate,
  */
 bool mrSupportsWriteConcern(const BSONObj& cmd);
 
+/**
+ * The aggregation equivalent of a mapReduce command, see translateToAggregation().
+ */
+struct AggregationTranslation {
+    // Groups the input documents by the emitted key into documents of the form
+    // {_id: <key>, value: <sum of the values>, n: <number of emits>, invalid: <count>}, sorted by
+    // _id. When 'valueIsField', they also hold the first value emitted for the key as 'first'.
+    std::vector<BSONObj> pipeline;
+
+    // True if the emitted value is a field of the input document rather than a constant.
+    bool valueIsField = false;
+};
+
+/**
+ * Returns the aggregation pipeline computing the results of the mapReduce command 'cmdObj', if
+ * its output is inline, its map function emits a top-level field of each document with either a
+ * numeric constant or another top-level field as the value, its reduce function returns the
+ * Array.sum() of the values and it has no finalize function, scope, collation or read concern.
+ *
+ * The results only match those of mapReduce if no group is counted as invalid. A group is invalid
+ * if one of its keys has a type that JavaScript does not preserve, or if one of its values is not
+ * a number.
+ */
+boost::optional<AggregationTranslation> translateToAggregation(const BSONObj& cmdObj);
+
 }  // namespace mr
 }  // namespace mongo
@@ -270,6 +270,92 @@ TEST(ConfigTest, CollationNotAnObjectFailsToParse) {
     ASSERT_THROWS(mr::Config(dbname, cmdObj), AssertionException);
 }
 
+/**
+ * Returns an inline mapReduce command with the given map and reduce functions and 'extra' fields.
+ */
+BSONObj makeInlineMapReduce(const std::string& map,
+                            const std::string& reduce,
+                            const BSONObj& extra = BSONObj()) {
+    BSONObjBuilder bob;
+    bob.append("mapReduce", "myCollection");
+    bob.appendCode("map", map);
+    bob.appendCode("reduce", reduce);
+    bob.append("out", BSON("inline" << 1));
+    bob.appendElements(extra);
+    return bob.obj();
+}
+
+const std::string kSumReduce = "function(key, values) { return Array.sum(values); }";
+
+TEST(TranslateToAggregationTest, CountByField) {
+    auto translation = mr::translateToAggregation(
+        makeInlineMapReduce("function() { emit(this.category, 1); }", kSumReduce));
+    ASSERT(translation);
+    ASSERT_FALSE(translation->valueIsField);
+    ASSERT_EQ(2U, translation->pipeline.size());
+
+    const BSONObj group = translation->pipeline[0]["$group"].Obj();
+    ASSERT_EQ("$category", group["_id"].String());
+    ASSERT_BSONOBJ_EQ(BSON("$sum" << 1.0), group["value"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("$sum" << 1), group["n"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON("$sort" << BSON("_id" << 1)), translation->pipeline[1]);
+}
+
+TEST(TranslateToAggregationTest, SumOfFieldWithQuerySortAndLimit) {
+    auto translation = mr::translateToAggregation(makeInlineMapReduce(
+        "function () {\n    emit(this.k, this.amount);\n}",
+        "function(k, vals) {\n    return Array.sum(vals);\n}",
+        BSON("query" << BSON("x" << 1) << "sort" << BSON("x" << 1) << "limit" << 10)));
+    ASSERT(translation);
+    ASSERT_TRUE(translation->valueIsField);
+    ASSERT_EQ(5U, translation->pipeline.size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("x" << 1)), translation->pipeline[0]);
+    ASSERT_BSONOBJ_EQ(BSON("$sort" << BSON("x" << 1)), translation->pipeline[1]);
+    ASSERT_BSONOBJ_EQ(BSON("$limit" << 10LL), translation->pipeline[2]);
+
+    const BSONObj group = translation->pipeline[3]["$group"].Obj();
+    ASSERT_EQ("$k", group["_id"].String());
+    ASSERT_BSONOBJ_EQ(BSON("$first"
+                           << "$amount"),
+                      group["first"].Obj());
+}
+
+TEST(TranslateToAggregationTest, UnsupportedJobsAreNotTranslated) {
+    const std::string map = "function() { emit(this.k, 1); }";
+    ASSERT(mr::translateToAggregation(makeInlineMapReduce(map, kSumReduce)));
+
+    // Options that change the result or need JavaScript.
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce(map, kSumReduce, BSON("finalize" << BSONCode("function(k, v) {}")))));
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce(map, kSumReduce, BSON("scope" << BSON("x" << 1)))));
+    ASSERT_FALSE(mr::translateToAggregation(makeInlineMapReduce(map,
+                                                                kSumReduce,
+                                                                BSON("collation" << BSON(
+                                                                         "locale"
+                                                                         << "en_US")))));
+
+    // Output to a collection.
+    BSONObjBuilder bob;
+    bob.append("mapReduce", "myCollection");
+    bob.appendCode("map", map);
+    bob.appendCode("reduce", kSumReduce);
+    bob.append("out", "outCollection");
+    ASSERT_FALSE(mr::translateToAggregation(bob.obj()));
+
+    // Other map and reduce functions.
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce("function() { emit(this.a.b, 1); }", kSumReduce)));
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce("function() { emit(this.k, this.v * 2); }", kSumReduce)));
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce("function() { emit(this.k, 1); emit(this.k, 1); }", kSumReduce)));
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce(map, "function(k, values) { return Array.sum(k); }")));
+    ASSERT_FALSE(mr::translateToAggregation(
+        makeInlineMapReduce(map, "function(k, values) { return values.length; }")));
+}
+
 /**
  * OpObserver for mapReduce test fixture.
  */
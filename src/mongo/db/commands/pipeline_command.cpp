@@ -33,6 +33,7 @@
 #include "mongo/db/commands/run_aggregate.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/find_common.h"
 
 namespace mongo {
 namespace {
@@ -130,6 +131,10 @@ public:
         return ReadWriteType::kRead;
     }
 
+    std::size_t reserveBytesForReply() const override {
+        return FindCommon::kInitReplyBufferSize;
+    }
+
 } pipelineCmd;
 
 }  // namespace
@@ -45,6 +45,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/plan_cache_snapshot.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/util/log.h"
 
@@ -92,6 +93,7 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(SetupPlanCacheCommands, MONGO_NO_PREREQUISI
     new PlanCacheListQueryShapes();
     new PlanCacheClear();
     new PlanCacheListPlans();
+    new PlanCacheSnapshot();
 
     return Status::OK();
 }
@@ -267,6 +269,8 @@ Status PlanCacheListQueryShapes::list(const PlanCache& planCache, BSONObjBuilder
     }
     arrayBuilder.doneFast();
 
+    planCache.appendStripeStats(bob);
+
     return Status::OK();
 }
 
@@ -444,8 +448,44 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     // Append whether or not the entry is active.
     bob->append("isActive", entry->isActive);
     bob->append("works", static_cast<long long>(entry->works));
+    if (entry->restoredFromSnapshot) {
+        bob->append("restoredFromSnapshot", true);
+    }
+
+    // Append the plans used for ranges of the leading constant, if any.
+    if (!entry->constantRangePlans.empty()) {
+        BSONArrayBuilder rangePlansBuilder(bob->subarrayStart("constantRangePlans"));
+        for (auto&& rangePlan : entry->constantRangePlans) {
+            BSONObjBuilder rangePlanBob(rangePlansBuilder.subobjStart());
+            rangePlanBob.appendAs(rangePlan.low.firstElement(), "low");
+            rangePlanBob.appendAs(rangePlan.high.firstElement(), "high");
+            rangePlanBob.append("solution", rangePlan.solution->toString());
+            rangePlanBob.append("works", static_cast<long long>(rangePlan.works));
+            rangePlanBob.append("hits", static_cast<long long>(rangePlan.hits));
+            rangePlanBob.doneFast();
+        }
+        rangePlansBuilder.doneFast();
+    }
 
     return Status::OK();
 }
 
+PlanCacheSnapshot::PlanCacheSnapshot()
+    : PlanCacheCommand("planCacheSnapshot",
+                       "Saves the active cached plans and index filters of a collection so that "
+                       "they can be restored after a restart or failover.",
+                       ActionType::planCacheWrite) {}
+
+Status PlanCacheSnapshot::runPlanCacheCommand(OperationContext* opCtx,
+                                              const string& ns,
+                                              const BSONObj& cmdObj,
+                                              BSONObjBuilder* bob) {
+    auto statusWithCount = writePlanCacheSnapshot(opCtx, NamespaceString(ns));
+    if (!statusWithCount.isOK()) {
+        return statusWithCount.getStatus();
+    }
+    bob->appendNumber("entries", static_cast<long long>(statusWithCount.getValue()));
+    return Status::OK();
+}
+
 }  // namespace mongo
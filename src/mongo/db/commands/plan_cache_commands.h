@@ -178,4 +178,24 @@ public:
                        BSONObjBuilder* bob);
 };
 
+/**
+ * planCacheSnapshot
+ *
+ * {
+ *     planCacheSnapshot: <collection>
+ * }
+ *
+ * Replaces the collection's plan cache snapshot with its active entries and index filters. The
+ * snapshot is loaded back the first time the collection is queried by a node which has
+ * 'internalQueryPlanCacheRestoreFromSnapshot' enabled.
+ */
+class PlanCacheSnapshot : public PlanCacheCommand {
+public:
+    PlanCacheSnapshot();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+};
+
 }  // namespace mongo
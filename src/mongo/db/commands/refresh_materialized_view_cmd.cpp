@@ -0,0 +1,576 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/client/dbclient_cursor.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/run_aggregate.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/collation/collation_spec.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/views/view_catalog.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+// The largest number of _ids put in a single {_id: {$in: [...]}} query.
+const size_t kMaxIdsPerBatch = 1000;
+
+/**
+ * How the contents of a materialized view can be brought up to date.
+ */
+enum class RefreshKind {
+    // The pipeline can only be rerun over the whole collection.
+    kFullOnly,
+
+    // Every stage maps each document to at most one document with the same _id, so the documents
+    // of the view which may have changed are those with the _ids of the changed documents.
+    kPerDocument,
+
+    // The pipeline is a kPerDocument prefix followed by a $group whose accumulators can all merge
+    // their results with the results over new documents, so inserts can be folded in.
+    kInsertOnlyGroup,
+};
+
+const StringData kMergeableAccumulators[] = {"$sum"_sd, "$min"_sd, "$max"_sd};
+
+bool isPerDocumentStage(const BSONObj& stage) {
+    const BSONElement spec = stage.firstElement();
+    const StringData name = spec.fieldNameStringData();
+    if (name == "$match") {
+        return true;
+    }
+    if (name != "$project" && name != "$addFields") {
+        return false;
+    }
+    if (spec.type() != Object) {
+        return false;
+    }
+
+    // The _id must pass through unchanged, since it identifies the input the output came from.
+    for (auto&& field : spec.Obj()) {
+        if (FieldPath::extractFirstFieldFromDottedPath(field.fieldNameStringData()) != "_id") {
+            continue;
+        }
+        const bool keepsId = field.fieldNameStringData() == "_id" &&
+            ((field.isBoolean() && field.boolean()) || (field.isNumber() && field.number() == 1));
+        if (name == "$addFields" || !keepsId) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns the accumulator used for each output field of the $group 'spec', or an empty map if any
+ * of them cannot merge its results with results over new documents.
+ */
+StringMap<std::string> getMergeableAccumulators(const BSONElement& spec) {
+    StringMap<std::string> accumulators;
+    if (spec.type() != Object) {
+        return {};
+    }
+    for (auto&& field : spec.Obj()) {
+        if (field.fieldNameStringData() == "_id") {
+            continue;
+        }
+        if (field.type() != Object || field.Obj().nFields() != 1) {
+            return {};
+        }
+        const StringData accumulator = field.Obj().firstElement().fieldNameStringData();
+        if (std::find(std::begin(kMergeableAccumulators),
+                      std::end(kMergeableAccumulators),
+                      accumulator) == std::end(kMergeableAccumulators)) {
+            return {};
+        }
+        accumulators[field.fieldNameStringData()] = accumulator.toString();
+    }
+    return accumulators;
+}
+
+RefreshKind classifyPipeline(const std::vector<BSONObj>& pipeline,
+                             const BSONObj& collation,
+                             StringMap<std::string>* groupAccumulators) {
+    for (size_t i = 0; i < pipeline.size(); ++i) {
+        if (isPerDocumentStage(pipeline[i])) {
+            continue;
+        }
+
+        // A $group is only merged when it is the last stage, and when its keys compare in the same
+        // way as the _ids of the view's collection.
+        const BSONElement spec = pipeline[i].firstElement();
+        if (i + 1 == pipeline.size() && spec.fieldNameStringData() == "$group" &&
+            SimpleBSONObjComparator::kInstance.evaluate(collation == CollationSpec::kSimpleSpec)) {
+            *groupAccumulators = getMergeableAccumulators(spec);
+            if (!groupAccumulators->empty() || spec.Obj().nFields() == 1) {
+                return RefreshKind::kInsertOnlyGroup;
+            }
+        }
+        return RefreshKind::kFullOnly;
+    }
+    return RefreshKind::kPerDocument;
+}
+
+/**
+ * What an earlier refresh materialized, and up to which point in the oplog.
+ */
+struct RefreshState {
+    std::string view;
+    BSONObj definition;
+    Timestamp refreshedThrough;
+
+    // Identifies the collection the results were written to, which changes if it is dropped or
+    // replaced.
+    OptionalCollectionUUID uuid;
+
+    bool inProgress = false;
+};
+
+stdx::mutex refreshStatesMutex;
+StringMap<RefreshState> refreshStates;  // Keyed by the namespace materialized into.
+
+/**
+ * The changes made to a collection in a window of the oplog.
+ */
+struct OplogChanges {
+    // The _ids of the documents which were inserted, updated or deleted.
+    BSONObjSet ids = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+
+    // True if documents were only inserted.
+    bool onlyInserts = true;
+
+    // True if the changes cannot be applied incrementally, for instance because the collection
+    // was dropped or the window is no longer in the oplog.
+    bool requiresFullRefresh = false;
+};
+
+Timestamp getOplogEdge(DBDirectClient* client, int direction) {
+    BSONObj entry = client->findOne(NamespaceString::kRsOplogNamespace.ns(),
+                                    Query().sort(BSON("$natural" << direction)));
+    return entry.isEmpty() ? Timestamp() : entry["ts"].timestamp();
+}
+
+/**
+ * Returns true if the command recorded in the oplog entry 'entry' may affect the collection 'nss'.
+ */
+bool commandAffects(const BSONObj& entry, const NamespaceString& nss) {
+    const BSONObj command = entry["o"].Obj();
+    const BSONElement first = command.firstElement();
+    if (first.fieldNameStringData() == "applyOps") {
+        return true;
+    }
+    if (first.type() == String &&
+        (first.valueStringData() == nss.coll() || first.valueStringData() == nss.ns())) {
+        return true;
+    }
+    return command["to"].type() == String && command["to"].valueStringData() == nss.ns();
+}
+
+OplogChanges readOplogChanges(DBDirectClient* client,
+                              const NamespaceString& source,
+                              Timestamp from,
+                              Timestamp to) {
+    OplogChanges changes;
+    if (getOplogEdge(client, 1) > from) {
+        // Some of the oplog entries after 'from' have been truncated.
+        changes.requiresFullRefresh = true;
+        return changes;
+    }
+
+    const std::string commandNs = source.getCommandNS().ns();
+    BSONObj filter = BSON("ts" << BSON("$gt" << from << "$lte" << to) << "$or"
+                               << BSON_ARRAY(BSON("ns" << source.ns())
+                                             << BSON("ns" << commandNs)
+                                             << BSON("ns"
+                                                     << "admin.$cmd"
+                                                     << "o.applyOps"
+                                                     << BSON("$exists" << true))));
+    auto cursor = client->query(NamespaceString::kRsOplogNamespace.ns(),
+                                filter,
+                                0,
+                                0,
+                                nullptr,
+                                QueryOption_OplogReplay);
+    uassert(50879, "failed to read the oplog", cursor);
+
+    const size_t maxChanges = internalQueryMaterializedViewMaxIncrementalChanges.load();
+    while (cursor->more()) {
+        BSONObj entry = cursor->next();
+        const StringData op = entry["op"].valueStringData();
+        if (op == "c") {
+            if (commandAffects(entry, source)) {
+                changes.requiresFullRefresh = true;
+                return changes;
+            }
+            continue;
+        }
+
+        BSONElement id;
+        if (op == "i") {
+            id = entry["o"]["_id"];
+        } else if (op == "u") {
+            id = entry["o2"]["_id"];
+            changes.onlyInserts = false;
+        } else if (op == "d") {
+            id = entry["o"]["_id"];
+            changes.onlyInserts = false;
+        } else {
+            continue;
+        }
+
+        if (id.eoo() || changes.ids.size() >= maxChanges) {
+            changes.requiresFullRefresh = true;
+            return changes;
+        }
+        changes.ids.insert(id.wrap());
+    }
+    return changes;
+}
+
+/**
+ * Runs 'pipeline' over 'nss' and returns all of its results.
+ */
+std::vector<BSONObj> aggregate(OperationContext* opCtx,
+                               DBDirectClient* client,
+                               const NamespaceString& nss,
+                               std::vector<BSONObj> pipeline,
+                               const BSONObj& collation) {
+    AggregationRequest request(nss, std::move(pipeline));
+    request.setCollation(collation);
+
+    BSONObjBuilder responseBuilder;
+    uassertStatusOK(runAggregate(
+        opCtx, nss, request, request.serializeToCommandObj().toBson(), responseBuilder));
+    CommandHelpers::appendSimpleCommandStatus(responseBuilder, true);
+    auto response = CursorResponse::parseFromBSONThrowing(responseBuilder.obj());
+    DBClientCursor cursor(client,
+                          response.getNSS().toString(),
+                          response.getCursorId(),
+                          0,
+                          0,
+                          response.releaseBatch());
+
+    std::vector<BSONObj> results;
+    while (cursor.more()) {
+        results.push_back(cursor.next().getOwned());
+    }
+    return results;
+}
+
+void checkLastWrite(DBDirectClient* client, const NamespaceString& into) {
+    BSONObj err = client->getLastErrorDetailed(into.db().toString());
+    uassert(50880,
+            str::stream() << "failed to write to " << into.ns() << ": "
+                          << DBClientBase::getLastErrorString(err),
+            DBClientBase::getLastErrorString(err).empty());
+}
+
+/**
+ * Combines the $group result 'delta', over newly inserted documents, into the existing result for
+ * the same group in 'into'.
+ */
+void mergeGroup(OperationContext* opCtx,
+                DBDirectClient* client,
+                const NamespaceString& into,
+                const StringMap<std::string>& accumulators,
+                const BSONObj& delta) {
+    const BSONObj existing = client->findOne(into.ns(), Query(BSON("_id" << delta["_id"])));
+    if (existing.isEmpty()) {
+        client->insert(into.ns(), delta);
+        checkLastWrite(client, into);
+        return;
+    }
+
+    boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(opCtx, nullptr));
+    MutableDocument merged(Document{existing});
+    for (auto&& accumulator : accumulators) {
+        auto acc = AccumulationStatement::getFactory(accumulator.second)(expCtx);
+        acc->process(Value(existing[accumulator.first]), false);
+        acc->process(Value(delta[accumulator.first]), false);
+        merged[accumulator.first] = acc->getValue(false);
+    }
+    client->update(into.ns(), Query(BSON("_id" << delta["_id"])), merged.freeze().toBson());
+    checkLastWrite(client, into);
+}
+
+/**
+ * Recomputes the view for the documents with the given _ids, and applies the results to 'into'.
+ */
+void applyChangedIds(OperationContext* opCtx,
+                     DBDirectClient* client,
+                     const ResolvedView& resolved,
+                     const NamespaceString& into,
+                     RefreshKind kind,
+                     const StringMap<std::string>& accumulators,
+                     const std::vector<BSONObj>& ids) {
+    BSONArrayBuilder idsBuilder;
+    for (auto&& id : ids) {
+        idsBuilder.append(id.firstElement());
+    }
+
+    std::vector<BSONObj> pipeline{
+        BSON("$match" << BSON("_id" << BSON("$in" << idsBuilder.arr())))};
+    pipeline.insert(pipeline.end(), resolved.getPipeline().begin(), resolved.getPipeline().end());
+    auto results = aggregate(opCtx,
+                             client,
+                             resolved.getNamespace(),
+                             std::move(pipeline),
+                             resolved.getDefaultCollation());
+
+    if (kind == RefreshKind::kInsertOnlyGroup) {
+        for (auto&& delta : results) {
+            mergeGroup(opCtx, client, into, accumulators, delta);
+        }
+        return;
+    }
+
+    // Replace the documents which are still in the view, and remove those which no longer are.
+    auto remaining = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    remaining.insert(ids.begin(), ids.end());
+    for (auto&& result : results) {
+        BSONObj id = result["_id"].wrap();
+        client->update(into.ns(), Query(id), result, true);
+        checkLastWrite(client, into);
+        remaining.erase(id);
+    }
+    for (auto&& id : remaining) {
+        client->remove(into.ns(), Query(id));
+        checkLastWrite(client, into);
+    }
+}
+
+OptionalCollectionUUID getCollectionUUID(OperationContext* opCtx, const NamespaceString& nss) {
+    AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+    return autoColl.getCollection() ? autoColl.getCollection()->uuid() : boost::none;
+}
+
+ResolvedView resolveView(OperationContext* opCtx, const NamespaceString& viewNss) {
+    AutoGetDb autoDb(opCtx, viewNss.db(), MODE_IS);
+    Database* db = autoDb.getDb();
+    uassert(ErrorCodes::NamespaceNotFound,
+            str::stream() << "database " << viewNss.db() << " does not exist",
+            db);
+    uassert(ErrorCodes::CommandNotSupportedOnView,
+            str::stream() << viewNss.ns() << " is not a view",
+            db->getViewCatalog()->lookup(opCtx, viewNss.ns()));
+    return uassertStatusOK(db->getViewCatalog()->resolveView(opCtx, viewNss));
+}
+
+BSONObj makeDefinition(const ResolvedView& resolved) {
+    BSONObjBuilder definition;
+    definition.append("viewOn", resolved.getNamespace().ns());
+    definition.append("pipeline", resolved.getPipeline());
+    definition.append("collation", resolved.getDefaultCollation());
+    return definition.obj();
+}
+
+/**
+ * { refreshMaterializedView: <view>, into: <collection>, full: <bool> }
+ *
+ * Materializes the results of a view into a collection in the same database, so that they can be
+ * read without rerunning the view's pipeline. The first refresh runs the whole pipeline with $out.
+ * Later refreshes on a replica set primary only recompute the results for the documents changed
+ * since the previous refresh, as recorded in the oplog, when the pipeline allows it; see
+ * RefreshKind.
+ */
+class RefreshMaterializedViewCmd : public BasicCommand {
+public:
+    RefreshMaterializedViewCmd() : BasicCommand("refreshMaterializedView") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kNever;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "Materializes the results of a view into a collection, incrementally when "
+               "possible.\n{ refreshMaterializedView: <view>, into: <collection>, full: <bool> }";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        AuthorizationSession* authzSession = AuthorizationSession::get(client);
+        const NamespaceString viewNss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+        const NamespaceString into(dbname, cmdObj["into"].str());
+
+        ActionSet writeActions;
+        writeActions.addAction(ActionType::insert);
+        writeActions.addAction(ActionType::update);
+        writeActions.addAction(ActionType::remove);
+        if (authzSession->isAuthorizedForActionsOnNamespace(viewNss, ActionType::find) &&
+            authzSession->isAuthorizedForActionsOnNamespace(into, writeActions)) {
+            return Status::OK();
+        }
+
+        return Status(ErrorCodes::Unauthorized, "unauthorized");
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString viewNss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+        uassert(ErrorCodes::BadValue,
+                "'into' must be the name of a collection in the same database",
+                cmdObj["into"].type() == String);
+        const NamespaceString into(dbname, cmdObj["into"].valueStringData());
+        uassert(ErrorCodes::InvalidNamespace,
+                str::stream() << "invalid collection name: " << into.ns(),
+                into.isValid() && !into.isSystem());
+        const bool forceFull = cmdObj["full"].trueValue();
+
+        const ResolvedView resolved = resolveView(opCtx, viewNss);
+        uassert(ErrorCodes::BadValue,
+                "cannot materialize a view into the namespace it reads from",
+                resolved.getNamespace() != into && viewNss != into);
+        const BSONObj definition = makeDefinition(resolved);
+
+        // Claim the refresh of 'into', and find out what the previous refresh materialized.
+        boost::optional<Timestamp> refreshedThrough;
+        const OptionalCollectionUUID intoUuid = getCollectionUUID(opCtx, into);
+        {
+            stdx::lock_guard<stdx::mutex> lk(refreshStatesMutex);
+            auto& state = refreshStates[into.ns()];
+            uassert(ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "a refresh into " << into.ns() << " is already in progress",
+                    !state.inProgress);
+            if (!state.definition.isEmpty() && state.view == viewNss.ns() &&
+                SimpleBSONObjComparator::kInstance.evaluate(state.definition == definition) &&
+                state.uuid && state.uuid == intoUuid) {
+                refreshedThrough = state.refreshedThrough;
+            }
+            state.inProgress = true;
+        }
+        bool succeeded = false;
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> lk(refreshStatesMutex);
+            auto& state = refreshStates[into.ns()];
+            state.inProgress = false;
+            if (!succeeded) {
+                // The contents of 'into' are unknown, so the next refresh must start over.
+                state.definition = BSONObj();
+            }
+        });
+
+        DBDirectClient client(opCtx);
+        const bool isReplSet = repl::ReplicationCoordinator::get(opCtx)->getReplicationMode() ==
+            repl::ReplicationCoordinator::modeReplSet;
+
+        // Changes up to this point will be reflected in 'into' by the end of this refresh.
+        const Timestamp refreshTo = isReplSet ? getOplogEdge(&client, -1) : Timestamp();
+
+        StringMap<std::string> accumulators;
+        const RefreshKind kind = classifyPipeline(
+            resolved.getPipeline(), resolved.getDefaultCollation(), &accumulators);
+
+        OplogChanges changes;
+        changes.requiresFullRefresh =
+            forceFull || !isReplSet || !refreshedThrough || kind == RefreshKind::kFullOnly;
+        if (!changes.requiresFullRefresh) {
+            changes = readOplogChanges(
+                &client, resolved.getNamespace(), *refreshedThrough, refreshTo);
+            if (kind == RefreshKind::kInsertOnlyGroup && !changes.onlyInserts) {
+                changes.requiresFullRefresh = true;
+            }
+        }
+
+        if (changes.requiresFullRefresh) {
+            std::vector<BSONObj> pipeline = resolved.getPipeline();
+            pipeline.push_back(BSON("$out" << into.coll()));
+            aggregate(opCtx,
+                      &client,
+                      resolved.getNamespace(),
+                      std::move(pipeline),
+                      resolved.getDefaultCollation());
+        } else {
+            std::vector<BSONObj> batch;
+            for (auto&& id : changes.ids) {
+                batch.push_back(id);
+                if (batch.size() == kMaxIdsPerBatch) {
+                    applyChangedIds(opCtx, &client, resolved, into, kind, accumulators, batch);
+                    batch.clear();
+                }
+            }
+            if (!batch.empty()) {
+                applyChangedIds(opCtx, &client, resolved, into, kind, accumulators, batch);
+            }
+        }
+
+        const OptionalCollectionUUID refreshedUuid = getCollectionUUID(opCtx, into);
+        {
+            stdx::lock_guard<stdx::mutex> lk(refreshStatesMutex);
+            auto& state = refreshStates[into.ns()];
+            state.view = viewNss.ns();
+            state.definition = definition;
+            state.refreshedThrough = refreshTo;
+            state.uuid = refreshedUuid;
+        }
+        succeeded = true;
+
+        LOG(1) << "refreshMaterializedView " << viewNss << " into " << into << ": "
+               << (changes.requiresFullRefresh ? "full" : "incremental") << ", "
+               << changes.ids.size() << " changed documents";
+
+        result.append("mode", changes.requiresFullRefresh ? "full" : "incremental");
+        result.appendNumber("changed", static_cast<long long>(changes.ids.size()));
+        if (isReplSet) {
+            result.append("refreshedThrough", refreshTo);
+        }
+        return true;
+    }
+
+} refreshMaterializedViewCmd;
+
+}  // namespace
+}  // namespace mongo
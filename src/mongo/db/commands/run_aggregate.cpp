@@ -56,6 +56,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/read_concern_args.h"
@@ -532,6 +533,10 @@ Status runAggregate(OperationContext* opCtx,
         // this process uses the correct collation if it does any string comparisons.
         pipeline->optimizePipeline();
 
+        // Split the stages up to the first $group among several threads, if so configured.
+        PipelineD::parallelizePipeline(pipeline.get(),
+                                       internalQueryAggregationParallelism.load());
+
         std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines;
 
         pipelines.emplace_back(std::move(pipeline));
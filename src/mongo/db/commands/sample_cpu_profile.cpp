@@ -0,0 +1,296 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+/**
+ * This module provides the sampleCpuProfile command, which runs the built-in sampling CPU profiler
+ * for a while and returns the folded stacks of the samples, ready to be rendered as a flamegraph:
+ *     { sampleCpuProfile: 1, durationSecs: 10, frequencyHz: 100, maxStacks: 1000 }
+ *
+ * Each stack is a string "<op>:<ns>;<outermost frame>;...;<innermost frame> <samples>", where the
+ * first element names the operation the sampled thread was running, if any.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/sample_cpu_profile.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+#include "mongo/util/sampling_cpu_profiler.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+// The p99 latency, in milliseconds, above which a CPU profile is taken automatically. 0 disables
+// automatic profiles.
+MONGO_EXPORT_SERVER_PARAMETER(automaticCpuProfileP99ThresholdMillis, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "automaticCpuProfileP99ThresholdMillis must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    });
+
+namespace {
+
+const long long kDefaultDurationSecs = 10;
+const long long kMaxDurationSecs = 300;
+const long long kDefaultFrequencyHz = 100;
+const long long kMaxFrequencyHz = 1000;
+const long long kDefaultMaxStacks = 1000;
+const size_t kMaxSamples = 20 * 1000;
+
+// Leaves room in the reply for the other fields.
+const int kMaxStacksBytes = 8 * 1024 * 1024;
+
+const Seconds kAutomaticProfileDuration{10};
+const Minutes kAutomaticProfileCooldown{10};
+const int kAutomaticProfileLoggedStacks = 10;
+
+size_t maxSamplesFor(long long frequencyHz, Seconds duration) {
+    // Each thread using CPU is sampled at the frequency, so allow for a few busy threads.
+    return std::min<size_t>(frequencyHz * durationCount<Seconds>(duration) * 4, kMaxSamples);
+}
+
+void appendProfile(const SamplingCpuProfiler::Result& profile,
+                   long long maxStacks,
+                   BSONObjBuilder* builder) {
+    builder->append("startTime", profile.startTime);
+    builder->append("endTime", profile.endTime);
+    builder->append("frequencyHz", profile.frequencyHz);
+    builder->append("samples", profile.samples);
+    builder->append("droppedSamples", profile.droppedSamples);
+
+    long long appendedStacks = 0;
+    BSONArrayBuilder stacksBuilder(builder->subarrayStart("stacks"));
+    for (const auto& stack : profile.foldedStacks) {
+        if (appendedStacks == maxStacks ||
+            stacksBuilder.len() + static_cast<int>(stack.first.size()) > kMaxStacksBytes) {
+            break;
+        }
+        stacksBuilder.append(str::stream() << stack.first << " " << stack.second);
+        appendedStacks++;
+    }
+    stacksBuilder.doneFast();
+    builder->append("truncatedStacks",
+                    static_cast<long long>(profile.foldedStacks.size()) - appendedStacks);
+}
+
+/**
+ * The state of automatic profiles, shared by the periodic job and the command.
+ */
+struct AutomaticProfiles {
+    stdx::mutex mutex;
+    bool running = false;
+    Date_t runningUntil;
+    Date_t nextAllowed;
+    boost::optional<SamplingCpuProfiler::Result> last;
+};
+
+AutomaticProfiles automaticProfiles;
+
+void checkAutomaticProfile(ServiceContext* service) {
+    auto& profiler = SamplingCpuProfiler::get();
+    const auto now = Date_t::now();
+
+    stdx::lock_guard<stdx::mutex> lk(automaticProfiles.mutex);
+    if (automaticProfiles.running) {
+        if (now < automaticProfiles.runningUntil) {
+            return;
+        }
+
+        auto profile = profiler.stop();
+        automaticProfiles.running = false;
+        automaticProfiles.nextAllowed = now + kAutomaticProfileCooldown;
+
+        log() << "Finished automatic CPU profile with " << profile.samples << " samples and "
+              << profile.droppedSamples << " dropped samples; most frequent stacks:";
+        const auto numLogged = std::min<size_t>(profile.foldedStacks.size(),
+                                                kAutomaticProfileLoggedStacks);
+        for (size_t i = 0; i < numLogged; i++) {
+            log() << "    " << profile.foldedStacks[i].first << " "
+                  << profile.foldedStacks[i].second;
+        }
+        automaticProfiles.last = std::move(profile);
+        return;
+    }
+
+    const long long thresholdMicros = automaticCpuProfileP99ThresholdMillis.load() * 1000LL;
+    if (thresholdMicros == 0 || now < automaticProfiles.nextAllowed) {
+        return;
+    }
+
+    auto& top = Top::get(service);
+    for (auto type : {Command::ReadWriteType::kRead,
+                      Command::ReadWriteType::kWrite,
+                      Command::ReadWriteType::kCommand,
+                      Command::ReadWriteType::kTransaction}) {
+        const auto summary = top.getGlobalLatencyPercentiles(type, now);
+        if (summary.ops == 0 || summary.p99 <= static_cast<uint64_t>(thresholdMicros)) {
+            continue;
+        }
+
+        // Fails if a profile requested with the command is already running, in which case this
+        // one is simply retried later.
+        auto status = profiler.start(kDefaultFrequencyHz,
+                                     maxSamplesFor(kDefaultFrequencyHz, kAutomaticProfileDuration));
+        if (!status.isOK()) {
+            LOG(1) << "Could not start automatic CPU profile: " << status;
+            return;
+        }
+
+        log() << "Starting automatic CPU profile for " << kAutomaticProfileDuration
+              << " because the p99 latency of " << Top::getReadWriteTypeName(type)
+              << " over the last minute is " << summary.p99 << " micros";
+        automaticProfiles.running = true;
+        automaticProfiles.runningUntil = now + kAutomaticProfileDuration;
+        return;
+    }
+}
+
+class CmdSampleCpuProfile final : public BasicCommand {
+public:
+    CmdSampleCpuProfile() : BasicCommand("sampleCpuProfile") {}
+
+    std::string help() const override {
+        return "Samples the stacks of the threads using CPU and returns them folded, as "
+               "{sampleCpuProfile: 1, durationSecs: <int>, frequencyHz: <int>, "
+               "maxStacks: <int>}, or returns the last profile taken automatically, as "
+               "{sampleCpuProfile: 1, lastAutomatic: true}";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long maxStacks;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "maxStacks", kDefaultMaxStacks, &maxStacks));
+        uassert(ErrorCodes::BadValue, "maxStacks must be greater than 0", maxStacks > 0);
+
+        if (cmdObj["lastAutomatic"].trueValue()) {
+            stdx::lock_guard<stdx::mutex> lk(automaticProfiles.mutex);
+            uassert(ErrorCodes::NoSuchKey,
+                    "No CPU profile has been taken automatically",
+                    automaticProfiles.last);
+            appendProfile(*automaticProfiles.last, maxStacks, &result);
+            return true;
+        }
+
+        uassert(ErrorCodes::IllegalOperation,
+                "The sampling CPU profiler is not supported on this platform",
+                SamplingCpuProfiler::isSupported());
+
+        long long durationSecs;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "durationSecs", kDefaultDurationSecs, &durationSecs));
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "durationSecs must be between 1 and " << kMaxDurationSecs,
+                durationSecs >= 1 && durationSecs <= kMaxDurationSecs);
+
+        long long frequencyHz;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "frequencyHz", kDefaultFrequencyHz, &frequencyHz));
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "frequencyHz must be between 1 and " << kMaxFrequencyHz,
+                frequencyHz >= 1 && frequencyHz <= kMaxFrequencyHz);
+
+        const Seconds duration(durationSecs);
+        auto& profiler = SamplingCpuProfiler::get();
+        uassertStatusOK(profiler.start(frequencyHz, maxSamplesFor(frequencyHz, duration)));
+
+        // Stop profiling, discarding the samples, if the command is interrupted.
+        auto stopGuard = MakeGuard([&] { profiler.stop(); });
+        opCtx->sleepFor(duration);
+        stopGuard.Dismiss();
+
+        appendProfile(profiler.stop(), maxStacks, &result);
+        return true;
+    }
+} cmdSampleCpuProfile;
+
+}  // namespace
+
+void startAutomaticCpuProfiling(ServiceContext* service) {
+    if (!SamplingCpuProfiler::isSupported()) {
+        return;
+    }
+
+    auto periodicRunner = service->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    PeriodicRunner::PeriodicJob job("AutomaticCpuProfiling",
+                                    [](Client* client) {
+                                        checkAutomaticProfile(client->getServiceContext());
+                                    },
+                                    Seconds(1));
+
+    periodicRunner->scheduleJob(std::move(job));
+}
+
+}  // namespace mongo
@@ -31,9 +31,12 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_internal.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/util/log.h"
@@ -248,6 +251,50 @@ public:
 
 } asserts;
 
+/**
+ * Lists the decorations declared on the most commonly decorated types, to help decide which ones
+ * are worth declaring hot. Access counts are only reported by debug builds.
+ */
+class Decorations : public ServerStatusSection {
+public:
+    Decorations() : ServerStatusSection("decorations") {}
+    virtual bool includeByDefault() const {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder bb;
+        appendRegistry(&bb, "ServiceContext", ServiceContext::getDecorationRegistry());
+        appendRegistry(&bb, "Client", Client::getDecorationRegistry());
+        appendRegistry(&bb, "OperationContext", OperationContext::getDecorationRegistry());
+        return bb.obj();
+    }
+
+private:
+    template <typename D>
+    static void appendRegistry(BSONObjBuilder* bb,
+                               StringData name,
+                               const DecorationRegistry<D>& registry) {
+        BSONObjBuilder sub(bb->subobjStart(name));
+        sub.appendNumber("bufferBytes",
+                         static_cast<long long>(registry.getDecorationBufferSizeBytes()));
+        sub.appendNumber("hotBytes",
+                         static_cast<long long>(registry.getHotDecorationBufferSizeBytes()));
+        BSONArrayBuilder decorations(sub.subarrayStart("decorations"));
+        for (auto&& stats : registry.getDecorationStats()) {
+            BSONObjBuilder decoration(decorations.subobjStart());
+            decoration.append("type", demangleName(*stats.type));
+            decoration.appendNumber("offset", static_cast<long long>(stats.offset));
+            decoration.appendNumber("sizeBytes", static_cast<long long>(stats.sizeBytes));
+            decoration.appendBool("hot", stats.hot);
+            if (kDebugBuild) {
+                decoration.appendNumber("accesses", static_cast<long long>(stats.accessCount));
+            }
+        }
+    }
+
+} decorations;
+
 class MemBase : public ServerStatusMetric {
 public:
     MemBase() : ServerStatusMetric(".mem.bits") {}
@@ -268,6 +315,11 @@ public:
     }
 } memBase;
 
+ServerStatusMetricField<Counter64> displayBufBuilderReallocations(
+    "bufBuilder.reallocations", &BufBuilderGrowthStats::reallocations);
+ServerStatusMetricField<Counter64> displayBufBuilderBytesReallocated(
+    "bufBuilder.bytesReallocated", &BufBuilderGrowthStats::bytesReallocated);
+
 }  // namespace
 
 }  // namespace mongo
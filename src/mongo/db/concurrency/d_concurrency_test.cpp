@@ -44,6 +44,7 @@
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/transport_layer_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
@@ -1158,6 +1159,26 @@ TEST_F(DConcurrencyTestFixture, Throttling) {
     ASSERT(!overlongWait);
 }
 
+TEST_F(DConcurrencyTestFixture, ThrottlingRecordsTimeWaitingForTicket) {
+    auto clientOpctxPairs = makeKClientsWithLockers(2);
+    auto opctx1 = clientOpctxPairs[0].second.get();
+    auto opctx2 = clientOpctxPairs[1].second.get();
+    UseGlobalThrottling throttle(opctx1, 1);
+
+    Lock::GlobalRead R1(opctx1, Date_t::now(), Lock::InterruptBehavior::kThrow);
+    ASSERT(R1.isLocked());
+    {
+        Lock::GlobalRead R2(
+            opctx2, Date_t::now() + Milliseconds(20), Lock::InterruptBehavior::kThrow);
+        ASSERT(!R2.isLocked());
+    }
+
+    // Only the locker that had to wait records it, even though its wait timed out. The timer starts
+    // after the deadline is computed, so allow for some slack.
+    ASSERT_GTE(opctx2->lockState()->getTimeWaitingForTicket(), Milliseconds(10));
+    ASSERT_LT(opctx1->lockState()->getTimeWaitingForTicket(), Milliseconds(10));
+}
+
 TEST_F(DConcurrencyTestFixture, NoThrottlingWhenNotAcquiringTickets) {
     auto clientOpctxPairs = makeKClientsWithLockers(2);
     auto opctx1 = clientOpctxPairs[0].second.get();
@@ -1176,6 +1197,54 @@ TEST_F(DConcurrencyTestFixture, NoThrottlingWhenNotAcquiringTickets) {
     ASSERT(R2.isLocked());
 }
 
+TEST_F(DConcurrencyTestFixture, FlowControlThrottlesOnlyWritesFromUserConnections) {
+    transport::TransportLayerMock transportLayer;
+    std::vector<std::pair<ServiceContext::UniqueClient, ServiceContext::UniqueOperationContext>>
+        userClients;
+    for (int i = 0; i < 2; ++i) {
+        auto client = getServiceContext()->makeClient(str::stream() << "user client " << i,
+                                                      transportLayer.createSession());
+        auto opCtx = client->makeOperationContext();
+        opCtx->swapLockState(stdx::make_unique<LockerImpl>());
+        userClients.emplace_back(std::move(client), std::move(opCtx));
+    }
+    auto internalClients = makeKClientsWithLockers(1);
+    auto userOpCtx1 = userClients[0].second.get();
+    auto userOpCtx2 = userClients[1].second.get();
+    auto internalOpCtx = internalClients[0].second.get();
+
+    TicketHolder flowControlTickets(1);
+    Locker::setFlowControlThrottling(&flowControlTickets);
+    ON_BLOCK_EXIT([] { Locker::setFlowControlThrottling(nullptr); });
+
+    {
+        Lock::GlobalLock W1(userOpCtx1, MODE_IX, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(W1.isLocked());
+        ASSERT_EQ(flowControlTickets.used(), 1);
+
+        // The second user write must wait for the only flow control ticket.
+        {
+            Lock::GlobalLock W2(userOpCtx2,
+                                MODE_IX,
+                                Date_t::now() + Milliseconds(10),
+                                Lock::InterruptBehavior::kThrow);
+            ASSERT(!W2.isLocked());
+        }
+
+        // Reads and internal writes are not throttled.
+        Lock::GlobalLock R2(userOpCtx2, MODE_IS, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(R2.isLocked());
+        Lock::GlobalLock W3(internalOpCtx, MODE_IX, Date_t::now(), Lock::InterruptBehavior::kThrow);
+        ASSERT(W3.isLocked());
+    }
+    ASSERT_EQ(flowControlTickets.used(), 0);
+
+    ASSERT_EQ(userOpCtx1->lockState()->getFlowControlStats().acquireCount, 1);
+    ASSERT_EQ(userOpCtx2->lockState()->getFlowControlStats().acquireCount, 0);
+    ASSERT_GT(userOpCtx2->lockState()->getFlowControlStats().timeAcquiring, Microseconds(0));
+    ASSERT_EQ(internalOpCtx->lockState()->getFlowControlStats().acquireCount, 0);
+}
+
 TEST_F(DConcurrencyTestFixture, ReleaseAndReacquireTicket) {
     auto clientOpctxPairs = makeKClientsWithLockers(2);
     auto opctx1 = clientOpctxPairs[0].second.get();
@@ -30,6 +30,7 @@
 
 #include "mongo/db/concurrency/deferred_writer.h"
 #include "mongo/db/catalog/create_collection.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -62,6 +63,14 @@ void DeferredWriter::_logDroppedEntry() {
 }
 
 Status DeferredWriter::_makeCollection(OperationContext* opCtx) {
+    if (_collectionMaker) {
+        try {
+            return _collectionMaker(opCtx);
+        } catch (const DBException& exception) {
+            return exception.toStatus();
+        }
+    }
+
     BSONObjBuilder builder;
     builder.append("create", _nss.coll());
     builder.appendElements(_collectionOptions.toBSON());
@@ -92,12 +101,12 @@ StatusWith<std::unique_ptr<AutoGetCollection>> DeferredWriter::_getCollection(
     return std::move(agc);
 }
 
-void DeferredWriter::_worker(InsertStatement stmt) {
-    auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
-    OperationContext* opCtx = uniqueOpCtx.get();
+void DeferredWriter::_writeBatches(OperationContext* opCtx,
+                                   const std::vector<InsertStatement>& stmts) {
     auto result = _getCollection(opCtx);
 
     if (!result.isOK()) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
         _logFailure(result.getStatus());
         return;
     }
@@ -106,24 +115,76 @@ void DeferredWriter::_worker(InsertStatement stmt) {
 
     Collection& collection = *agc->getCollection();
 
-    Status status = writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
-        WriteUnitOfWork wuow(opCtx);
-        Status status = collection.insertDocument(opCtx, stmt, nullptr, false);
+    auto insert = [&](std::vector<InsertStatement>::const_iterator begin,
+                      std::vector<InsertStatement>::const_iterator end) {
+        return writeConflictRetry(opCtx, "deferred insert", _nss.ns(), [&] {
+            WriteUnitOfWork wuow(opCtx);
+            Status status = collection.insertDocuments(opCtx, begin, end, nullptr, false);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            wuow.commit();
+            return Status::OK();
+        });
+    };
+
+    // Capped collections with indexes cannot take multi-document inserts, so those get one
+    // storage transaction per document, but still share the worker's collection lock.
+    const size_t maxBatchSize =
+        collection.isCapped() && collection.getIndexCatalog()->haveAnyIndexes() ? 1
+                                                                                : kMaxBatchSize;
+
+    for (auto batchBegin = stmts.begin(); batchBegin != stmts.end();) {
+        const auto batchEnd =
+            batchBegin + std::min<size_t>(maxBatchSize, std::distance(batchBegin, stmts.end()));
+
+        Status status = insert(batchBegin, batchEnd);
+        if (!status.isOK() && std::distance(batchBegin, batchEnd) > 1) {
+            // Retry the documents one at a time so that a bad one does not lose the whole batch.
+            status = Status::OK();
+            for (auto it = batchBegin; it != batchEnd; ++it) {
+                Status docStatus = insert(it, std::next(it));
+                if (!docStatus.isOK()) {
+                    status = docStatus;
+                }
+            }
+        }
+
+        // If a write to a deferred collection fails, periodically tell the log.
         if (!status.isOK()) {
-            return status;
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _logFailure(status);
         }
 
-        wuow.commit();
-        return Status::OK();
-    });
+        batchBegin = batchEnd;
+    }
+}
 
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
+void DeferredWriter::_worker() {
+    auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
+    OperationContext* opCtx = uniqueOpCtx.get();
+
+    while (true) {
+        std::vector<InsertStatement> stmts;
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            if (_pending.empty()) {
+                _workerScheduled = false;
+                return;
+            }
+            stmts.swap(_pending);
+        }
 
-    _numBytes -= stmt.doc.objsize();
+        _writeBatches(opCtx, stmts);
 
-    // If a write to a deferred collection fails, periodically tell the log.
-    if (!status.isOK()) {
-        _logFailure(status);
+        int64_t numBytes = 0;
+        for (const auto& stmt : stmts) {
+            numBytes += stmt.doc.objsize();
+        }
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _numBytes -= numBytes;
     }
 }
 
@@ -135,6 +196,16 @@ DeferredWriter::DeferredWriter(NamespaceString nss, CollectionOptions opts, int6
       _droppedEntries(0),
       _lastLogged(TimePoint::clock::now() - kLogInterval) {}
 
+DeferredWriter::DeferredWriter(NamespaceString nss,
+                               CollectionMaker collectionMaker,
+                               int64_t maxSize)
+    : _collectionMaker(std::move(collectionMaker)),
+      _maxNumBytes(maxSize),
+      _nss(nss),
+      _numBytes(0),
+      _droppedEntries(0),
+      _lastLogged(TimePoint::clock::now() - kLogInterval) {}
+
 DeferredWriter::~DeferredWriter() {}
 
 void DeferredWriter::startup(std::string workerName) {
@@ -175,9 +246,13 @@ bool DeferredWriter::insertDocument(BSONObj obj) {
         return false;
     }
 
-    // Add the object to the buffer.
+    // Add the object to the buffer, and wake the worker unless it is already going to write it.
     _numBytes += obj.objsize();
-    fassert(40588, _pool->schedule([this, obj] { _worker(InsertStatement(obj.getOwned())); }));
+    _pending.emplace_back(obj.getOwned());
+    if (!_workerScheduled) {
+        _workerScheduled = true;
+        fassert(40588, _pool->schedule([this] { _worker(); }));
+    }
     return true;
 }
 
@@ -28,9 +28,12 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -52,6 +55,10 @@ class ThreadPool;
  * caller, it cannot report most errors to the client; it instead periodically logs any errors to
  * the system log.
  *
+ * Buffered documents are written by a single background task which drains everything buffered
+ * so far, so that bursts of inserts are written in batches rather than one storage transaction
+ * per document.
+ *
  * Instances of this class are unconditionally thread-safe, and cannot cause deadlock barring
  * improper use of the ctor, `flush` and `shutdown` methods below.
  */
@@ -59,6 +66,18 @@ class DeferredWriter {
     MONGO_DISALLOW_COPYING(DeferredWriter);
 
 public:
+    /**
+     * Creates the backing collection on the worker thread when it does not exist, holding no
+     * locks when called.
+     */
+    using CollectionMaker = stdx::function<Status(OperationContext*)>;
+
+    /**
+     * The maximum number of documents written in a single storage transaction. Capped collections
+     * with indexes are written one document at a time.
+     */
+    static const size_t kMaxBatchSize = 64;
+
     /**
      * Create a new DeferredWriter for writing to a given collection.
      *
@@ -69,6 +88,12 @@ public:
      */
     DeferredWriter(NamespaceString nss, CollectionOptions opts, int64_t maxSize);
 
+    /**
+     * Create a new DeferredWriter whose backing collection is created by 'collectionMaker'
+     * instead of a createCollection with fixed options.
+     */
+    DeferredWriter(NamespaceString nss, CollectionMaker collectionMaker, int64_t maxSize);
+
     /**
      * Start the background worker thread writing to the given collection.
      *
@@ -132,15 +157,26 @@ private:
     StatusWith<std::unique_ptr<AutoGetCollection>> _getCollection(OperationContext* opCtx);
 
     /**
-     * The method that the worker thread will run.
+     * The method that the worker thread will run. Writes buffered documents until the buffer is
+     * empty.
      */
-    void _worker(InsertStatement stmt);
+    void _worker();
+
+    /**
+     * Writes 'stmts' to the backing collection, in batches of at most kMaxBatchSize documents.
+     */
+    void _writeBatches(OperationContext* opCtx, const std::vector<InsertStatement>& stmts);
 
     /**
      * The options for the collection, in case we need to create it.
      */
     const CollectionOptions _collectionOptions;
 
+    /**
+     * Creates the collection in place of '_collectionOptions', if set.
+     */
+    const CollectionMaker _collectionMaker;
+
     /**
      * The size limit of the in-memory buffer.
      */
@@ -163,6 +199,13 @@ private:
      */
     int64_t _numBytes;
 
+    /**
+     * Documents not yet picked up by the worker, and whether a worker task is scheduled to pick
+     * them up.
+     */
+    std::vector<InsertStatement> _pending;
+    bool _workerScheduled = false;
+
     /**
      * The number of deffered entries that have been dropped. Resets when the
      * rate-limited system log is written out.
@@ -411,13 +411,12 @@ void LockHead::migratePartitionedLockHeads() {
 const unsigned LockManager::_numLockBuckets(128);
 
 // Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// The exact value doesn't appear very important, but should be power of two. Conflicting locks
+// only visit the partitions actually used for the resource, so this can be at least as large as
+// the number of cores on the host.
+const unsigned LockManager::_numPartitions = 64;
 
-LockManager::LockManager() {
-    _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
-}
+LockManager::LockManager() : _lockBuckets(_numLockBuckets), _partitions(_numPartitions) {}
 
 LockManager::~LockManager() {
     cleanupUnusedLocks();
@@ -426,9 +425,6 @@ LockManager::~LockManager() {
         // TODO: dump more information about the non-empty bucket to see what locks were leaked
         invariant(_lockBuckets[i].data.empty());
     }
-
-    delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
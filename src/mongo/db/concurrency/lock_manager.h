@@ -33,6 +33,8 @@
 #include <map>
 #include <vector>
 
+#include <boost/align/aligned_allocator.hpp>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
@@ -43,6 +45,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -211,11 +214,17 @@ private:
      */
     void _cleanupUnusedLocksInBucket(LockBucket* bucket);
 
+    // Buckets and partitions are each padded to their own cache line, so that lockers working on
+    // neighbouring entries do not invalidate each other's cached copy of the mutex.
+    template <typename T>
+    using CacheAlignedVector =
+        std::vector<CacheAligned<T>, boost::alignment::aligned_allocator<CacheAligned<T>>>;
+
     static const unsigned _numLockBuckets;
-    LockBucket* _lockBuckets;
+    mutable CacheAlignedVector<LockBucket> _lockBuckets;
 
     static const unsigned _numPartitions;
-    Partition* _partitions;
+    mutable CacheAlignedVector<Partition> _partitions;
 };
 
 
@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
@@ -44,6 +45,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -73,6 +75,10 @@ public:
         _get(resId).recordDeadlock(resId, mode);
     }
 
+    void append(LockerId id, const SingleThreadedLockStats& stats) {
+        _get(id).append(stats);
+    }
+
     void report(SingleThreadedLockStats* outStats) const {
         for (int i = 0; i < NumPartitions; i++) {
             outStats->append(_partitions[i].stats);
@@ -227,6 +233,18 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+TicketHolder* flowControlTicketHolder = nullptr;
+
+// How long low priority ticket acquisitions let normal priority ones go first, before competing
+// with them. Bounds how long background tasks can be starved of tickets.
+MONGO_EXPORT_SERVER_PARAMETER(lowPriorityTicketMaxDeferralMillis, int, 100)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "lowPriorityTicketMaxDeferralMillis must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
 }  // namespace
 
 
@@ -241,6 +259,11 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+void Locker::setFlowControlThrottling(TicketHolder* holder) {
+    flowControlTicketHolder = holder;
+}
+
 LockerImpl::LockerImpl()
     : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
 
@@ -264,6 +287,9 @@ LockerImpl::~LockerImpl() {
     invariant(_numResourcesToUnlockAtEndUnitOfWork == 0);
     invariant(_requests.empty());
     invariant(_modeForTicket == MODE_NONE);
+    invariant(!_flowControlTicketHolder);
+
+    _publishUnpublishedStats();
 
     // Reset the locking statistics so the object can be reused
     _stats.reset();
@@ -298,22 +324,78 @@ void LockerImpl::reacquireTicket(OperationContext* opCtx) {
 LockResult LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t deadline) {
     const bool reader = isSharedLockMode(mode);
     auto holder = shouldAcquireTicket() ? ticketHolders[mode] : nullptr;
+
+    // Writes throttled by flow control wait for it without holding a storage engine ticket. If
+    // the ticket wait below fails, give the flow control ticket back.
+    if (!_acquireFlowControlTicket(opCtx, mode, deadline)) {
+        return LOCK_TIMEOUT;
+    }
+    auto releaseFlowControlTicketOnErrorGuard = MakeGuard([&] { _releaseFlowControlTicket(); });
+
     if (holder) {
         _clientState.store(reader ? kQueuedReader : kQueuedWriter);
 
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
-        if (deadline == Date_t::max()) {
+        Timer timer;
+        ON_BLOCK_EXIT([&] { _ticketMicrosAcquiring.addAndFetch(timer.micros()); });
+        if (getTicketPriority() == TicketPriority::kLow) {
+            if (!holder->waitForLowPriorityTicketUntil(
+                    opCtx, deadline, Milliseconds(lowPriorityTicketMaxDeferralMillis.load()))) {
+                return LOCK_TIMEOUT;
+            }
+        } else if (deadline == Date_t::max()) {
             holder->waitForTicket(opCtx);
         } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
             return LOCK_TIMEOUT;
         }
         restoreStateOnErrorGuard.Dismiss();
     }
+    releaseFlowControlTicketOnErrorGuard.Dismiss();
     _clientState.store(reader ? kActiveReader : kActiveWriter);
     return LOCK_OK;
 }
 
+bool LockerImpl::_acquireFlowControlTicket(OperationContext* opCtx,
+                                           LockMode mode,
+                                           Date_t deadline) {
+    invariant(!_flowControlTicketHolder);
+
+    // Only writes from user connections are throttled, so that replication and internal work on
+    // the node are never held back by flow control.
+    auto holder = flowControlTicketHolder;
+    if (!holder || mode != MODE_IX || !shouldAcquireTicket() || !opCtx ||
+        !opCtx->getClient()->session()) {
+        return true;
+    }
+
+    if (!holder->tryAcquire()) {
+        _clientState.store(kQueuedWriter);
+
+        // If the ticket wait is interrupted, restore the state of the client.
+        auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
+        Timer timer;
+        ON_BLOCK_EXIT([&] { _flowControlMicrosAcquiring.addAndFetch(timer.micros()); });
+        if (deadline == Date_t::max()) {
+            holder->waitForTicket(opCtx);
+        } else if (!holder->waitForTicketUntil(opCtx, deadline)) {
+            return false;
+        }
+        restoreStateOnErrorGuard.Dismiss();
+    }
+
+    _flowControlAcquireCount.addAndFetch(1);
+    _flowControlTicketHolder = holder;
+    return true;
+}
+
+void LockerImpl::_releaseFlowControlTicket() {
+    if (_flowControlTicketHolder) {
+        _flowControlTicketHolder->release();
+        _flowControlTicketHolder = nullptr;
+    }
+}
+
 LockResult LockerImpl::_lockGlobalBegin(OperationContext* opCtx, LockMode mode, Date_t deadline) {
     dassert(isLocked() == (_modeForTicket != MODE_NONE));
     if (_modeForTicket == MODE_NONE) {
@@ -365,6 +447,7 @@ bool LockerImpl::unlockGlobal() {
         }
     }
 
+    _publishUnpublishedStats();
     return true;
 }
 
@@ -575,6 +658,7 @@ bool LockerImpl::saveLockStateAndUnlock(Locker::LockSnapshot* stateOut) {
     // The global lock must have been acquired just once
     stateOut->globalMode = globalRequest->mode;
     invariant(unlock(resourceIdGlobal));
+    _publishUnpublishedStats();
 
     // Next, the non-global locks.
     for (LockRequestsMap::Iterator it = _requests.begin(); !it.finished(); it.next()) {
@@ -653,7 +737,12 @@ LockResult LockerImpl::lockBegin(OperationContext* opCtx, ResourceId resId, Lock
     }
 
     // Making this call here will record lock re-acquisitions and conversions as well.
-    globalStats.recordAcquisition(_id, resId, mode);
+    if (mode == MODE_IS || mode == MODE_IX) {
+        _unpublishedStats.recordAcquisition(resId, mode);
+        _hasUnpublishedStats = true;
+    } else {
+        globalStats.recordAcquisition(_id, resId, mode);
+    }
     _stats.recordAcquisition(resId, mode);
 
     // Give priority to the full modes for global, parallel batch writer mode,
@@ -811,9 +900,20 @@ void LockerImpl::_releaseTicket() {
     if (holder) {
         holder->release();
     }
+    _releaseFlowControlTicket();
     _clientState.store(kInactive);
 }
 
+void LockerImpl::_publishUnpublishedStats() {
+    if (!_hasUnpublishedStats) {
+        return;
+    }
+
+    globalStats.append(_id, _unpublishedStats);
+    _unpublishedStats.reset();
+    _hasUnpublishedStats = false;
+}
+
 bool LockerImpl::_unlockImpl(LockRequestsMap::Iterator* it) {
     if (globalLockManager.unlock(it->objAddr())) {
         if (it->key() == resourceIdGlobal) {
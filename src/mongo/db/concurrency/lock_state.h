@@ -291,6 +291,23 @@ private:
      */
     LockResult _acquireTicket(OperationContext* opCtx, LockMode mode, Date_t deadline);
 
+    /**
+     * Acquires a flow control ticket for the Locker if writes in 'mode' by its client are
+     * throttled by flow control. Returns false if it cannot acquire the ticket within 'deadline'.
+     */
+    bool _acquireFlowControlTicket(OperationContext* opCtx, LockMode mode, Date_t deadline);
+
+    /**
+     * Releases the flow control ticket of the Locker, if it holds one.
+     */
+    void _releaseFlowControlTicket();
+
+    /**
+     * Adds the intent lock acquisitions counted since the last call to the instance-wide locking
+     * statistics.
+     */
+    void _publishUnpublishedStats();
+
     // Used to disambiguate different lockers
     const LockerId _id;
 
@@ -313,6 +330,13 @@ private:
     // db.currentOp. Complementary to the per-instance locking statistics.
     SingleThreadedLockStats _stats;
 
+    // Intent lock acquisitions which have not yet been added to the instance-wide locking
+    // statistics. Intent locks are taken by every operation, so rather than paying for an atomic
+    // increment of a shared counter on each acquisition, they are counted here and published in
+    // bulk when the global lock is released.
+    SingleThreadedLockStats _unpublishedStats;
+    bool _hasUnpublishedStats = false;
+
     // Delays release of exclusive/intent-exclusive locked resources until the write unit of
     // work completes. Value of 0 means we are not inside a write unit of work.
     int _wuowNestingLevel;
@@ -320,6 +344,9 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // The holder from which the Locker acquired a flow control ticket, if any.
+    TicketHolder* _flowControlTicketHolder = nullptr;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
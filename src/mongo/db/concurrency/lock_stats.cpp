@@ -146,6 +146,21 @@ void LockStats<CounterType>::reset() {
     }
 }
 
+template <typename CounterType>
+int64_t LockStats<CounterType>::getCombinedWaitTimeMicros() const {
+    int64_t waitMicros = 0;
+    for (int i = 0; i < ResourceTypesCount; i++) {
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            waitMicros += CounterOps::get(_stats[i].modeStats[mode].combinedWaitTimeMicros);
+        }
+    }
+
+    for (int mode = 0; mode < LockModesCount; mode++) {
+        waitMicros += CounterOps::get(_oplogStats.modeStats[mode].combinedWaitTimeMicros);
+    }
+    return waitMicros;
+}
+
 
 // Ensures that there are instances compiled for LockStats for AtomicInt64 and int64_t
 template class LockStats<int64_t>;
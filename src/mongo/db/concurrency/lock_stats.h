@@ -65,7 +65,10 @@ struct CounterOps {
     }
 
     static void add(AtomicInt64& counter, int64_t value) {
-        counter.addAndFetch(value);
+        // Appending a mostly empty set of statistics should not dirty the shared cache lines.
+        if (value) {
+            counter.addAndFetch(value);
+        }
     }
 };
 
@@ -161,6 +164,11 @@ public:
     void report(BSONObjBuilder* builder) const;
     void reset();
 
+    /**
+     * Returns the total time spent waiting for locks, across all resources and modes.
+     */
+    int64_t getCombinedWaitTimeMicros() const;
+
 private:
     // Necessary for the append call, which accepts argument of type different than our
     // template parameter.
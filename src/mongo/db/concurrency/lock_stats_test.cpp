@@ -84,6 +84,42 @@ TEST(LockStats, Wait) {
     ASSERT_GREATER_THAN(stats.get(resId, MODE_S).combinedWaitTimeMicros, 0);
 }
 
+TEST(LockStats, CombinedWaitTime) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.CombinedWaitTime"));
+
+    SingleThreadedLockStats stats;
+    ASSERT_EQUALS(0, stats.getCombinedWaitTimeMicros());
+
+    stats.recordWaitTime(resId, MODE_S, 10);
+    stats.recordWaitTime(resId, MODE_X, 20);
+    stats.recordWaitTime(ResourceId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL), MODE_IS, 30);
+    stats.recordWaitTime(resourceIdOplog, MODE_IX, 40);
+    ASSERT_EQUALS(100, stats.getCombinedWaitTimeMicros());
+}
+
+TEST(LockStats, IntentAcquisitionsPublishedOnGlobalUnlock) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.IntentAcquisitions"));
+
+    resetGlobalLockStats();
+
+    SingleThreadedLockStats stats;
+    {
+        LockerForTests locker(MODE_IX);
+        locker.lock(resId, MODE_IX);
+        locker.unlock(resId);
+
+        // Intent acquisitions are only counted towards the instance-wide statistics once the
+        // global lock is released.
+        reportGlobalLockingStats(&stats);
+        ASSERT_EQUALS(0, stats.get(resId, MODE_IX).numAcquisitions);
+    }
+
+    reportGlobalLockingStats(&stats);
+    ASSERT_EQUALS(1, stats.get(resId, MODE_IX).numAcquisitions);
+    const ResourceId resIdGlobal(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+    ASSERT_EQUALS(1, stats.get(resIdGlobal, MODE_IX).numAcquisitions);
+}
+
 TEST(LockStats, Reporting) {
     const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Reporting"));
 
@@ -73,6 +73,37 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Require global lock attempts in MODE_IX made for user connections to also obtain a ticket
+     * from 'holder', which must have a static lifetime, before the ticket for 'writing' above.
+     * Flow control resizes 'holder' to throttle the writes of a primary whose majority commit
+     * point lags behind.
+     */
+    static void setFlowControlThrottling(class TicketHolder* holder);
+
+    /**
+     * The flow control tickets acquired by this locker, and the time spent waiting for them.
+     */
+    struct FlowControlStats {
+        long long acquireCount = 0;
+        Microseconds timeAcquiring{0};
+    };
+
+    FlowControlStats getFlowControlStats() const {
+        FlowControlStats stats;
+        stats.acquireCount = _flowControlAcquireCount.load();
+        stats.timeAcquiring = Microseconds(_flowControlMicrosAcquiring.load());
+        return stats;
+    }
+
+    /**
+     * Returns the time this locker has spent waiting for storage engine tickets (see
+     * setGlobalThrottling()).
+     */
+    Microseconds getTimeWaitingForTicket() const {
+        return Microseconds(_ticketMicrosAcquiring.load());
+    }
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -416,6 +447,22 @@ public:
     bool shouldAcquireTicket() const {
         return _shouldAcquireTicket;
     }
+
+    /**
+     * The priority with which the Locker acquires tickets. Low priority acquisitions let normal
+     * priority ones waiting for a ticket go first, for up to lowPriorityTicketMaxDeferralMillis.
+     * Meant for background tasks, such as TTL deletes and range deletion, which should not hold
+     * back user operations when tickets run out.
+     */
+    enum class TicketPriority { kNormal, kLow };
+
+    void setTicketPriority(TicketPriority newValue) {
+        invariant(!isLocked() || isNoop());
+        _ticketPriority = newValue;
+    }
+    TicketPriority getTicketPriority() const {
+        return _ticketPriority;
+    }
     /**
      * This function is for unit testing only.
      */
@@ -440,9 +487,15 @@ protected:
      */
     unsigned _numResourcesToUnlockAtEndUnitOfWork = 0;
 
+    // Updated by the locker, and read by currentOp from other threads.
+    AtomicInt64 _flowControlAcquireCount{0};
+    AtomicInt64 _flowControlMicrosAcquiring{0};
+    AtomicInt64 _ticketMicrosAcquiring{0};
+
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
     bool _shouldAcquireTicket = true;
+    TicketPriority _ticketPriority = TicketPriority::kNormal;
 };
 
 /**
@@ -43,10 +43,12 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/query_stats.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/sampling_cpu_profiler.h"
 #include "mongo/util/stringutils.h"
 
 namespace mongo {
@@ -62,6 +64,17 @@ const std::vector<const char*> kDollarQueryModifiers = {
     "$hint", "$comment", "$max", "$min", "$returnKey", "$showDiskLoc", "$snapshot", "$maxTimeMS",
 };
 
+/**
+ * Appends the flow control tickets acquired by an operation, and the time it was throttled, as
+ * {flowControl: {acquireCount: <n>, timeAcquiringMicros: <n>}}.
+ */
+void appendFlowControlStats(const Locker::FlowControlStats& stats, BSONObjBuilder* builder) {
+    BSONObjBuilder flowControlBob(builder->subobjStart("flowControl"));
+    flowControlBob.appendNumber("acquireCount", stats.acquireCount);
+    flowControlBob.appendNumber("timeAcquiringMicros",
+                                durationCount<Microseconds>(stats.timeAcquiring));
+}
+
 }  // namespace
 
 BSONObj upconvertQueryEntry(const BSONObj& query,
@@ -258,6 +271,17 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+
+        const auto flowControlStats = clientOpCtx->lockState()->getFlowControlStats();
+        if (flowControlStats.acquireCount > 0) {
+            appendFlowControlStats(flowControlStats, infoBuilder);
+        }
+
+        const auto ticketWait = clientOpCtx->lockState()->getTimeWaitingForTicket();
+        if (ticketWait > Microseconds(0)) {
+            infoBuilder->append("timeWaitingForTicketMicros",
+                                durationCount<Microseconds>(ticketWait));
+        }
     }
 }
 
@@ -274,6 +298,8 @@ CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
 CurOp::~CurOp() {
     if (parent() != nullptr)
         parent()->yielded(_numYields);
+    else
+        SamplingCpuProfiler::clearThreadTag();
     invariant(this == _stack->pop());
 }
 
@@ -295,6 +321,12 @@ void CurOp::setGenericOpRequestDetails(OperationContext* opCtx,
     _opDescription = cmdObj;
     _command = command;
     _ns = nss.ns();
+
+    // Samples of the CPU profiler are attributed to the outermost operation of the thread.
+    if (parent() == nullptr) {
+        SamplingCpuProfiler::setThreadTag(
+            command ? StringData(command->getName()) : logicalOpToString(logicalOp), _ns);
+    }
 }
 
 ProgressMeter& CurOp::setMessage_inlock(const char* msg,
@@ -322,9 +354,23 @@ void CurOp::setNS_inlock(StringData ns) {
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
+        _cpuClock = ThreadCpuClock::forCurrentThread();
+        _cpuTimeAtStart = _cpuClock.now().value_or(Microseconds(0));
     }
 }
 
+boost::optional<Microseconds> CurOp::cpuTimeSinceStart() const {
+    if (!isStarted()) {
+        return boost::none;
+    }
+
+    auto cpuTime = _cpuClock.now();
+    if (!cpuTime) {
+        return boost::none;
+    }
+    return *cpuTime - _cpuTimeAtStart;
+}
+
 void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     ensureStarted();
     _ns = ns;
@@ -357,9 +403,29 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     _end = curTimeMicros64();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
+    if (!_debug.queryStatsKey.empty()) {
+        QueryStatsSample sample;
+        sample.isGetMore = LogicalOp::opGetMore == _debug.logicalOp;
+        sample.readWriteType = getReadWriteType();
+        sample.latencyMicros = _debug.executionTimeMicros;
+        sample.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+        sample.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+        sample.nreturned = std::max(0LL, _debug.nreturned);
+        sample.bytesReturned = std::max(0, _debug.responseLength);
+        QueryStatsStore::get(opCtx->getServiceContext())
+            .record(_debug.queryStatsKey, _debug.queryStatsShape, sample);
+    }
+
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
 
+    _debug.flowControlStats = opCtx->lockState()->getFlowControlStats();
+    _debug.timeWaitingForTicketMicros =
+        durationCount<Microseconds>(opCtx->lockState()->getTimeWaitingForTicket());
+    if (auto cpuTime = cpuTimeSinceStart()) {
+        _debug.cpuTimeMicros = durationCount<Microseconds>(*cpuTime);
+    }
+
     if (shouldLogOp || (shouldSample && _debug.executionTimeMicros > slowMs * 1000LL)) {
         const auto lockerInfo = opCtx->lockState()->getLockerInfo();
         log(component) << _debug.report(client, *this, (lockerInfo ? &lockerInfo->stats : nullptr));
@@ -436,6 +502,10 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
         builder->append("microsecs_running", durationCount<Microseconds>(elapsedTimeTotal()));
     }
 
+    if (auto cpuTime = cpuTimeSinceStart()) {
+        builder->append("cpuTimeMicros", durationCount<Microseconds>(*cpuTime));
+    }
+
     builder->append("op", logicalOpToString(_logicalOp));
     builder->append("ns", _ns);
 
@@ -569,6 +639,9 @@ string OpDebug::report(Client* client,
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
     OPDEBUG_TOSTRING_HELP_OPTIONAL("writeConflicts", additiveMetrics.writeConflicts);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("storageBytesRead", additiveMetrics.storageBytesRead);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("storageTimeReadingMicros",
+                                   additiveMetrics.storageTimeReadingMicros);
 
     s << " numYields:" << curop.numYields();
     OPDEBUG_TOSTRING_HELP(nreturned);
@@ -590,12 +663,29 @@ string OpDebug::report(Client* client,
         BSONObjBuilder locks;
         lockStats->report(&locks);
         s << " locks:" << locks.obj().toString();
+
+        const long long lockWaitMicros = lockStats->getCombinedWaitTimeMicros();
+        if (lockWaitMicros > 0) {
+            s << " timeWaitingForLocksMicros:" << lockWaitMicros;
+        }
+    }
+
+    if (timeWaitingForTicketMicros > 0) {
+        s << " timeWaitingForTicketMicros:" << timeWaitingForTicketMicros;
+    }
+
+    if (flowControlStats.acquireCount > 0) {
+        BSONObjBuilder flowControl;
+        appendFlowControlStats(flowControlStats, &flowControl);
+        s << " flowControl:" << flowControl.obj()["flowControl"].Obj().toString();
     }
 
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
 
+    OPDEBUG_TOSTRING_HELP(cpuTimeMicros);
+
     s << " " << (executionTimeMicros / 1000) << "ms";
 
     return s.str();
@@ -650,6 +740,8 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_APPEND_OPTIONAL("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
     OPDEBUG_APPEND_OPTIONAL("writeConflicts", additiveMetrics.writeConflicts);
+    OPDEBUG_APPEND_OPTIONAL("storageBytesRead", additiveMetrics.storageBytesRead);
+    OPDEBUG_APPEND_OPTIONAL("storageTimeReadingMicros", additiveMetrics.storageTimeReadingMicros);
 
     b.appendNumber("numYield", curop.numYields());
     OPDEBUG_APPEND_NUMBER(nreturned);
@@ -659,6 +751,19 @@ void OpDebug::append(const CurOp& curop,
         lockStats.report(&locks);
     }
 
+    const long long lockWaitMicros = lockStats.getCombinedWaitTimeMicros();
+    if (lockWaitMicros > 0) {
+        b.appendNumber("timeWaitingForLocksMicros", lockWaitMicros);
+    }
+
+    if (timeWaitingForTicketMicros > 0) {
+        b.appendNumber("timeWaitingForTicketMicros", timeWaitingForTicketMicros);
+    }
+
+    if (flowControlStats.acquireCount > 0) {
+        appendFlowControlStats(flowControlStats, &b);
+    }
+
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
         if (!errInfo.reason().empty()) {
@@ -673,6 +778,7 @@ void OpDebug::append(const CurOp& curop,
         b.append("protocol", getProtoString(networkOp));
     }
     b.appendIntOrLL("millis", executionTimeMicros / 1000);
+    OPDEBUG_APPEND_NUMBER(cpuTimeMicros);
 
     if (!curop.getPlanSummary().empty()) {
         b.append("planSummary", curop.getPlanSummary());
@@ -720,6 +826,9 @@ void OpDebug::AdditiveMetrics::add(const AdditiveMetrics& otherMetrics) {
     prepareReadConflicts =
         addOptionalLongs(prepareReadConflicts, otherMetrics.prepareReadConflicts);
     writeConflicts = addOptionalLongs(writeConflicts, otherMetrics.writeConflicts);
+    storageBytesRead = addOptionalLongs(storageBytesRead, otherMetrics.storageBytesRead);
+    storageTimeReadingMicros =
+        addOptionalLongs(storageTimeReadingMicros, otherMetrics.storageTimeReadingMicros);
 }
 
 bool OpDebug::AdditiveMetrics::equals(const AdditiveMetrics& otherMetrics) {
@@ -729,7 +838,9 @@ bool OpDebug::AdditiveMetrics::equals(const AdditiveMetrics& otherMetrics) {
         nmoved == otherMetrics.nmoved && keysInserted == otherMetrics.keysInserted &&
         keysDeleted == otherMetrics.keysDeleted &&
         prepareReadConflicts == otherMetrics.prepareReadConflicts &&
-        writeConflicts == otherMetrics.writeConflicts;
+        writeConflicts == otherMetrics.writeConflicts &&
+        storageBytesRead == otherMetrics.storageBytesRead &&
+        storageTimeReadingMicros == otherMetrics.storageTimeReadingMicros;
 }
 
 void OpDebug::AdditiveMetrics::incrementWriteConflicts(long long n) {
@@ -774,4 +885,18 @@ void OpDebug::AdditiveMetrics::incrementPrepareReadConflicts(long long n) {
     *prepareReadConflicts += n;
 }
 
+void OpDebug::AdditiveMetrics::incrementStorageBytesRead(long long n) {
+    if (!storageBytesRead) {
+        storageBytesRead = 0;
+    }
+    *storageBytesRead += n;
+}
+
+void OpDebug::AdditiveMetrics::incrementStorageTimeReadingMicros(long long n) {
+    if (!storageTimeReadingMicros) {
+        storageTimeReadingMicros = 0;
+    }
+    *storageTimeReadingMicros += n;
+}
+
 }  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/thread_cpu_clock.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -98,6 +99,16 @@ public:
          */
         void incrementPrepareReadConflicts(long long n);
 
+        /**
+         * Increments storageBytesRead by n.
+         */
+        void incrementStorageBytesRead(long long n);
+
+        /**
+         * Increments storageTimeReadingMicros by n.
+         */
+        void incrementStorageTimeReadingMicros(long long n);
+
         boost::optional<long long> keysExamined;
         boost::optional<long long> docsExamined;
 
@@ -117,6 +128,12 @@ public:
         // Number of read conflicts caused by a prepared transaction.
         boost::optional<long long> prepareReadConflicts;
         boost::optional<long long> writeConflicts;
+        // Bytes of records and index entries read from the storage engine.
+        boost::optional<long long> storageBytesRead;
+        // Time spent in storage engine read calls, measured while trackOperationStorageReadTime is
+        // set. Calls that find their data in the cache take well under a microsecond, so this is
+        // mostly time spent reading from disk and waiting for cache eviction.
+        boost::optional<long long> storageTimeReadingMicros;
     };
 
     OpDebug() = default;
@@ -184,8 +201,22 @@ public:
     // Shard targeting info.
     int nShards{-1};
 
+    // Set if the operation was sampled for $queryStats: identifies the shape of the query it ran,
+    // and describes that shape for the first sample of it.
+    std::string queryStatsKey;
+    BSONObj queryStatsShape;
+
     // Stores additive metrics.
     AdditiveMetrics additiveMetrics;
+
+    // CPU time used by the thread running the operation, or -1 where it cannot be measured.
+    long long cpuTimeMicros{-1};
+
+    // Time the operation spent waiting for storage engine tickets.
+    long long timeWaitingForTicketMicros{0};
+
+    // The flow control tickets acquired by the operation, and the time it was throttled.
+    Locker::FlowControlStats flowControlStats;
 };
 
 /**
@@ -377,6 +408,10 @@ public:
     // negative, if the system time has been reset during the course of this operation.
     //
 
+    /**
+     * Marks the operation as started, and starts measuring the CPU time of the calling thread,
+     * which must be the one executing the operation.
+     */
     void ensureStarted();
     bool isStarted() const {
         return _start > 0;
@@ -455,6 +490,13 @@ public:
         return elapsedTimeTotal() - _totalPausedDuration;
     }
 
+    /**
+     * Returns the CPU time spent by the thread executing this operation since it was started, or
+     * boost::none if the op has not been started or thread CPU time cannot be measured on this
+     * platform. May be called from other threads while the operation is running.
+     */
+    boost::optional<Microseconds> cpuTimeSinceStart() const;
+
     /**
      * 'opDescription' must be either an owned BSONObj or guaranteed to outlive the OperationContext
      * it is associated with.
@@ -571,6 +613,10 @@ private:
     // The cumulative duration for which the timer has been paused.
     Microseconds _totalPausedDuration{0};
 
+    // The CPU clock of the thread that started this CurOp, and its reading at that time.
+    ThreadCpuClock _cpuClock;
+    Microseconds _cpuTimeAtStart{0};
+
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_COMMAND, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
     // _logicalOp is the logical operation type, ie 'dbQuery' regardless of whether this is an
@@ -63,6 +63,10 @@ TEST(CurOpTest, AddingAdditiveMetricsObjectsTogetherShouldAddFieldsTogether) {
     additiveMetricsToAdd.prepareReadConflicts = 5;
     currentAdditiveMetrics.writeConflicts = 7;
     additiveMetricsToAdd.writeConflicts = 0;
+    currentAdditiveMetrics.storageBytesRead = 100;
+    additiveMetricsToAdd.storageBytesRead = 20;
+    currentAdditiveMetrics.storageTimeReadingMicros = 3;
+    additiveMetricsToAdd.storageTimeReadingMicros = 9;
 
     // Save the current AdditiveMetrics object before adding.
     OpDebug::AdditiveMetrics additiveMetricsBeforeAdd = currentAdditiveMetrics;
@@ -92,6 +96,11 @@ TEST(CurOpTest, AddingAdditiveMetricsObjectsTogetherShouldAddFieldsTogether) {
                   *additiveMetricsToAdd.prepareReadConflicts);
     ASSERT_EQ(*currentAdditiveMetrics.writeConflicts,
               *additiveMetricsBeforeAdd.writeConflicts + *additiveMetricsToAdd.writeConflicts);
+    ASSERT_EQ(*currentAdditiveMetrics.storageBytesRead,
+              *additiveMetricsBeforeAdd.storageBytesRead + *additiveMetricsToAdd.storageBytesRead);
+    ASSERT_EQ(*currentAdditiveMetrics.storageTimeReadingMicros,
+              *additiveMetricsBeforeAdd.storageTimeReadingMicros +
+                  *additiveMetricsToAdd.storageTimeReadingMicros);
 }
 
 TEST(CurOpTest, AddingUninitializedAdditiveMetricsFieldsShouldBeTreatedAsZero) {
@@ -159,6 +168,8 @@ TEST(CurOpTest, AdditiveMetricsFieldsShouldIncrementByN) {
     additiveMetrics.incrementNmoved(1);
     additiveMetrics.incrementNinserted(3);
     additiveMetrics.incrementPrepareReadConflicts(2);
+    additiveMetrics.incrementStorageBytesRead(512);
+    additiveMetrics.incrementStorageTimeReadingMicros(0);
 
     ASSERT_EQ(*additiveMetrics.writeConflicts, 2);
     ASSERT_EQ(*additiveMetrics.keysInserted, 7);
@@ -166,6 +177,8 @@ TEST(CurOpTest, AdditiveMetricsFieldsShouldIncrementByN) {
     ASSERT_EQ(*additiveMetrics.nmoved, 1);
     ASSERT_EQ(*additiveMetrics.ninserted, 3);
     ASSERT_EQ(*additiveMetrics.prepareReadConflicts, 8);
+    ASSERT_EQ(*additiveMetrics.storageBytesRead, 512);
+    ASSERT_EQ(*additiveMetrics.storageTimeReadingMicros, 0);
 }
 
 }  // namespace
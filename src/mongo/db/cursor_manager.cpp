@@ -562,33 +562,43 @@ void CursorManager::deregisterExecutor(PlanExecutor* exec) {
 StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx,
                                                      CursorId id,
                                                      AuthCheck checkSessionAuth) {
-    auto lockedPartition = _cursorMap->lockOnePartition(id);
-    auto it = lockedPartition->find(id);
-    if (it == lockedPartition->end()) {
-        return {ErrorCodes::CursorNotFound, str::stream() << "cursor id " << id << " not found"};
-    }
+    ClientCursor* cursor;
+    {
+        auto lockedPartition = _cursorMap->lockOnePartition(id);
+        auto it = lockedPartition->find(id);
+        if (it == lockedPartition->end()) {
+            return {ErrorCodes::CursorNotFound,
+                    str::stream() << "cursor id " << id << " not found"};
+        }
 
-    ClientCursor* cursor = it->second;
-    uassert(ErrorCodes::CursorInUse,
-            str::stream() << "cursor id " << id << " is already in use",
-            !cursor->_operationUsingCursor);
-    if (cursor->getExecutor()->isMarkedAsKilled()) {
-        // This cursor was killed while it was idle.
-        Status error = cursor->getExecutor()->getKillStatus();
-        deregisterAndDestroyCursor(std::move(lockedPartition),
-                                   opCtx,
-                                   std::unique_ptr<ClientCursor, ClientCursor::Deleter>(cursor));
-        return error;
-    }
-
-    if (checkSessionAuth == kCheckSession) {
-        auto cursorPrivilegeStatus = checkCursorSessionPrivilege(opCtx, cursor->getSessionId());
-        if (!cursorPrivilegeStatus.isOK()) {
-            return cursorPrivilegeStatus;
+        cursor = it->second;
+        uassert(ErrorCodes::CursorInUse,
+                str::stream() << "cursor id " << id << " is already in use",
+                !cursor->_operationUsingCursor);
+        if (cursor->getExecutor()->isMarkedAsKilled()) {
+            // This cursor was killed while it was idle.
+            Status error = cursor->getExecutor()->getKillStatus();
+            deregisterAndDestroyCursor(
+                std::move(lockedPartition),
+                opCtx,
+                std::unique_ptr<ClientCursor, ClientCursor::Deleter>(cursor));
+            return error;
         }
+
+        if (checkSessionAuth == kCheckSession) {
+            auto cursorPrivilegeStatus =
+                checkCursorSessionPrivilege(opCtx, cursor->getSessionId());
+            if (!cursorPrivilegeStatus.isOK()) {
+                return cursorPrivilegeStatus;
+            }
+        }
+
+        cursor->_operationUsingCursor = opCtx;
     }
 
-    cursor->_operationUsingCursor = opCtx;
+    // Once the cursor is pinned it can no longer be destroyed by anyone else, so the rest of the
+    // work happens without holding the partition lock. If it fails, the pin returns the cursor.
+    ClientCursorPin pin(opCtx, cursor);
 
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefor,
     // we pass down to the logical session cache and vivify the record (updating last use).
@@ -600,7 +610,7 @@ StatusWith<ClientCursorPin> CursorManager::pinCursor(OperationContext* opCtx,
         }
     }
 
-    return ClientCursorPin(opCtx, cursor);
+    return std::move(pin);
 }
 
 void CursorManager::unpin(OperationContext* opCtx,
@@ -682,27 +692,20 @@ size_t CursorManager::numCursors() const {
 }
 
 CursorId CursorManager::allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        // The leading two bits of a CursorId are used to determine if the cursor is registered on
-        // the global cursor manager.
-        CursorId id;
-        if (isGlobalManager()) {
-            // This is the global cursor manager, so generate a random number and make sure the
-            // first two bits are 01.
-            uint64_t mask = 0x3FFFFFFFFFFFFFFF;
-            uint64_t bitToSet = 1ULL << 62;
-            id = ((_random->nextInt64() & mask) | bitToSet);
-        } else {
-            // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
-            // bits are random.
-            uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
-            id = cursorIdFromParts(_collectionCacheRuntimeId, myPart);
-        }
-        auto partition = _cursorMap->lockOnePartition(id);
-        if (partition->count(id) == 0)
-            return id;
+    // The leading two bits of a CursorId are used to determine if the cursor is registered on the
+    // global cursor manager.
+    if (isGlobalManager()) {
+        // This is the global cursor manager, so generate a random number and make sure the first
+        // two bits are 01.
+        uint64_t mask = 0x3FFFFFFFFFFFFFFF;
+        uint64_t bitToSet = 1ULL << 62;
+        return ((_random->nextInt64() & mask) | bitToSet);
     }
-    fassertFailed(17360);
+
+    // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32 bits
+    // are random.
+    uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
+    return cursorIdFromParts(_collectionCacheRuntimeId, myPart);
 }
 
 ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
@@ -717,23 +720,33 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     cursorParams.exec.get_deleter().dismissDisposal();
     cursorParams.exec->unsetRegistered();
 
-    // Note we must hold the registration lock from now until insertion into '_cursorMap' to ensure
-    // we don't insert two cursors with the same cursor id.
-    stdx::lock_guard<SimpleMutex> lock(_registrationLock);
-    CursorId cursorId = allocateCursorId_inlock();
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
-        new ClientCursor(std::move(cursorParams), this, cursorId, opCtx, now));
-
     // Register this cursor for lookup by transaction.
     if (opCtx->getLogicalSessionId() && opCtx->getTxnNumber()) {
         invariant(opCtx->getLogicalSessionId());
     }
 
-    // Transfer ownership of the cursor to '_cursorMap'.
-    auto partition = _cursorMap->lockOnePartition(cursorId);
-    ClientCursor* unownedCursor = clientCursor.release();
-    partition->emplace(cursorId, unownedCursor);
-    return ClientCursorPin(opCtx, unownedCursor);
+    // The registration lock is only held while drawing a candidate cursor id. The id is checked
+    // for uniqueness and the cursor inserted under the lock of the one partition the id maps to,
+    // so registrations of cursors in different partitions do not wait for each other.
+    for (int i = 0; i < 10000; i++) {
+        CursorId cursorId;
+        {
+            stdx::lock_guard<SimpleMutex> lock(_registrationLock);
+            cursorId = allocateCursorId_inlock();
+        }
+
+        auto partition = _cursorMap->lockOnePartition(cursorId);
+        if (partition->count(cursorId) > 0) {
+            continue;
+        }
+
+        // Transfer ownership of the cursor to '_cursorMap'.
+        ClientCursor* unownedCursor =
+            new ClientCursor(std::move(cursorParams), this, cursorId, opCtx, now);
+        partition->emplace(cursorId, unownedCursor);
+        return ClientCursorPin(opCtx, unownedCursor);
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cursor) {
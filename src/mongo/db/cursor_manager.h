@@ -256,6 +256,10 @@ private:
         std::size_t operator()(const PlanExecutor* exec, std::size_t nPartitions);
     };
 
+    /**
+     * Returns a candidate id for a new cursor, which the caller must check for uniqueness under the
+     * lock of the partition it maps to. Requires '_registrationLock'.
+     */
     CursorId allocateCursorId_inlock();
 
     ClientCursorPin _registerCursor(
@@ -290,9 +294,10 @@ private:
     // this cursor manager. The two registration data structures '_registeredPlanExecutors' and
     // '_cursorMap' are partitioned to decrease contention, and each partition of the structure is
     // protected by its own mutex. Separately, there is a '_registrationLock' which protects
-    // concurrent access to '_random' for cursor id generation, and must be held from cursor id
-    // generation until insertion into '_cursorMap'. If you ever need to acquire more than one of
-    // these mutexes at once, you must follow the following rules:
+    // concurrent access to '_random' for cursor id generation. It is not held while inserting into
+    // '_cursorMap'; a new id is checked for uniqueness under its partition's mutex instead. If you
+    // ever need to acquire more than one of these mutexes at once, you must follow the following
+    // rules:
     // - '_registrationLock' must be acquired first, if at all.
     // - Mutex(es) for '_registeredPlanExecutors' must be acquired next.
     // - Mutex(es) for '_cursorMap' must be acquired next.
@@ -62,6 +62,8 @@
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
+#include "mongo/db/commands/sample_cpu_profile.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -99,6 +101,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
+#include "mongo/db/repl/flow_control.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
@@ -145,6 +148,7 @@
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/assert_util.h"
@@ -172,6 +176,7 @@
 #include "mongo/util/startup_test.h"
 #include "mongo/util/text.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 #include "mongo/util/version.h"
 
 #ifdef MONGO_CONFIG_SSL
@@ -274,6 +279,55 @@ void initWireSpec() {
 
 MONGO_FAIL_POINT_DEFINE(shutdownAtStartup);
 
+/**
+ * Records how long each phase of startup took, so that slow restarts can be attributed to the
+ * phase responsible. The timings are logged once the server accepts connections and are reported
+ * in the 'startupTimings' section of serverStatus.
+ */
+class StartupTimings {
+public:
+    /**
+     * Ends the current phase, which started when the previous one ended, and names it 'phase'.
+     */
+    void endPhase(StringData phase) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const auto now = _timer.millis();
+        _phases.emplace_back(phase.toString(), now - _lastPhaseEndMillis);
+        _lastPhaseEndMillis = now;
+    }
+
+    void append(BSONObjBuilder* builder) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->append("totalMillis", _lastPhaseEndMillis);
+        BSONObjBuilder phases(builder->subobjStart("phaseMillis"));
+        for (auto&& phase : _phases) {
+            phases.append(phase.first, phase.second);
+        }
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    Timer _timer;
+    long long _lastPhaseEndMillis = 0;
+    std::vector<std::pair<std::string, long long>> _phases;
+} startupTimings;
+
+class StartupTimingsServerStatusSection final : public ServerStatusSection {
+public:
+    StartupTimingsServerStatusSection() : ServerStatusSection("startupTimings") {}
+
+    bool includeByDefault() const final {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const final {
+        BSONObjBuilder builder;
+        startupTimings.append(&builder);
+        return builder.obj();
+    }
+} startupTimingsServerStatusSection;
+
 ExitCode _initAndListen(int listenPort) {
     Client::initThread("initandlisten");
 
@@ -334,7 +388,10 @@ ExitCode _initAndListen(int listenPort) {
         serviceContext->setTransportLayer(std::move(tl));
     }
 
+    startupTimings.endPhase("setup");
+
     initializeStorageEngine(serviceContext, StorageEngineInitFlags::kNone);
+    startupTimings.endPhase("storageEngine");
 
 #ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
     if (EncryptionHooks::get(serviceContext)->restartRequired()) {
@@ -457,6 +514,7 @@ ExitCode _initAndListen(int listenPort) {
         log() << "finished checking dbs";
         exitCleanly(EXIT_CLEAN);
     }
+    startupTimings.endPhase("repairDatabases");
 
     // Start up health log writer thread.
     HealthLog::get(startupOpCtx.get()).startup();
@@ -516,6 +574,8 @@ ExitCode _initAndListen(int listenPort) {
               << startupWarningsLog;
     }
 
+    startupTimings.endPhase("authorization");
+
     // This function may take the global lock.
     auto shardingInitialized =
         uassertStatusOK(ShardingState::get(startupOpCtx.get())
@@ -523,6 +583,7 @@ ExitCode _initAndListen(int listenPort) {
     if (shardingInitialized) {
         waitForShardRegistryReload(startupOpCtx.get()).transitional_ignore();
     }
+    startupTimings.endPhase("shardingAwareness");
 
     auto storageEngine = serviceContext->getStorageEngine();
     invariant(storageEngine);
@@ -535,9 +596,8 @@ ExitCode _initAndListen(int listenPort) {
 
         startMongoDFTDC();
 
-        startFreeMonitoring(serviceContext);
-
         restartInProgressIndexesFromLastShutdown(startupOpCtx.get());
+        startupTimings.endPhase("indexBuilds");
 
         if (serverGlobalParams.clusterRole == ClusterRole::ShardServer) {
             // Note: For replica sets, ShardingStateRecovery happens on transition to primary.
@@ -567,7 +627,10 @@ ExitCode _initAndListen(int listenPort) {
                                       stdx::make_unique<LogicalTimeValidator>(keyManager));
         }
 
+        startupTimings.endPhase("shardingState");
+
         repl::ReplicationCoordinator::get(startupOpCtx.get())->startup(startupOpCtx.get());
+        startupTimings.endPhase("replication");
         const unsigned long long missingRepl =
             checkIfReplMissingFromCommandLine(startupOpCtx.get());
         if (missingRepl) {
@@ -609,6 +672,9 @@ ExitCode _initAndListen(int listenPort) {
     SessionKiller::set(serviceContext,
                        std::make_shared<SessionKiller>(serviceContext, killSessionsLocal));
 
+    repl::FlowControl::get(serviceContext).startup(serviceContext);
+    startAutomaticCpuProfiling(serviceContext);
+
     // Start up a background task to periodically check for and kill expired transactions; and a
     // background task to periodically check for and decrease cache pressure by decreasing the
     // target size setting for the storage engine's window of available snapshots.
@@ -632,6 +698,7 @@ ExitCode _initAndListen(int listenPort) {
 
     auto sessionCache = makeLogicalSessionCacheD(serviceContext, kind);
     LogicalSessionCache::set(serviceContext, std::move(sessionCache));
+    startupTimings.endPhase("backgroundJobs");
 
     // MessageServer::run will return when exit code closes its socket and we don't need the
     // operation context anymore
@@ -650,6 +717,19 @@ ExitCode _initAndListen(int listenPort) {
     }
 
     serviceContext->notifyStartupComplete();
+    startupTimings.endPhase("listen");
+
+    {
+        BSONObjBuilder timings;
+        startupTimings.append(&timings);
+        log() << "Waiting for connections after startup phases " << timings.obj();
+    }
+
+    // Free monitoring only reports to an external service, so it need not delay accepting
+    // connections.
+    if (!storageGlobalParams.readOnly) {
+        startFreeMonitoring(serviceContext);
+    }
 
 #ifndef _WIN32
     mongo::signalForkSuccess();
@@ -939,6 +1019,7 @@ void shutdownTask() {
     stopMongoDFTDC();
 
     HealthLog::get(serviceContext).shutdown();
+    shutdownProfileWriters(serviceContext);
 
     // We should always be able to acquire the global lock at shutdown.
     //
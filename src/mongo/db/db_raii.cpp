@@ -35,6 +35,7 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_parameters.h"
@@ -46,18 +47,29 @@ namespace {
 
 const boost::optional<int> kDoNotChangeProfilingLevel = boost::none;
 
+Top::StorageUsage getStorageUsage(OperationContext* opCtx) {
+    const auto& metrics = CurOp::get(opCtx)->debug().additiveMetrics;
+    return {metrics.storageBytesRead.get_value_or(0),
+            metrics.storageTimeReadingMicros.get_value_or(0)};
+}
+
 }  // namespace
 
 // If true, do not take the PBWM lock in AutoGetCollectionForRead on secondaries during batch
 // application.
 MONGO_EXPORT_SERVER_PARAMETER(allowSecondaryReadsDuringBatchApplication, bool, true);
 
+// If true, a read on a secondary that finds catalog changes to its collection after the last
+// applied timestamp waits for them to be applied, instead of taking the PBWM lock and reading the
+// latest data. Readers then never hold back batch application.
+MONGO_EXPORT_SERVER_PARAMETER(secondaryReadsWaitForPendingCatalogChanges, bool, false);
+
 AutoStatsTracker::AutoStatsTracker(OperationContext* opCtx,
                                    const NamespaceString& nss,
                                    Top::LockType lockType,
                                    boost::optional<int> dbProfilingLevel,
                                    Date_t deadline)
-    : _opCtx(opCtx), _lockType(lockType) {
+    : _opCtx(opCtx), _lockType(lockType), _storageUsageAtStart(getStorageUsage(opCtx)) {
     if (!dbProfilingLevel) {
         // No profiling level was determined, attempt to read the profiling level from the Database
         // object.
@@ -80,7 +92,8 @@ AutoStatsTracker::~AutoStatsTracker() {
                 _lockType,
                 durationCount<Microseconds>(curOp->elapsedTimeExcludingPauses()),
                 curOp->isCommand(),
-                curOp->getReadWriteType());
+                curOp->getReadWriteType(),
+                Top::StorageUsage(_storageUsageAtStart, getStorageUsage(_opCtx)));
 }
 
 AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
@@ -157,7 +170,23 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
         // initial sync finishes, if we waited instead of retrying, readers would block indefinitely
         // waiting for the lastAppliedTimestamp to move forward. Instead we force the reader take
         // the PBWM lock and retry.
-        if (lastAppliedTimestamp) {
+        //
+        // In SECONDARY state, the catalog changes are part of the batch being applied, so the
+        // reader may instead wait for this batch to finish and then read at the new last applied
+        // timestamp. Unlike a reader holding the PBWM lock, it does not keep the next batch from
+        // being applied while it runs.
+        if (lastAppliedTimestamp && secondaryReadsWaitForPendingCatalogChanges.load() &&
+            replCoord->getMemberState().secondary()) {
+            LOG(2) << "Tried reading at last-applied time: " << *lastAppliedTimestamp
+                   << " on nss: " << nss.ns() << ", but future catalog changes are pending at time "
+                   << *minSnapshot << ". Waiting for them to be applied.";
+            const repl::ReadConcernArgs waitArgs(LogicalTime(*minSnapshot),
+                                                 repl::ReadConcernLevel::kLocalReadConcern);
+            uassertStatusOK(replCoord->waitUntilOpTimeForReadUntil(
+                opCtx,
+                waitArgs,
+                deadline == Date_t::max() ? boost::none : boost::optional<Date_t>(deadline)));
+        } else if (lastAppliedTimestamp) {
             LOG(2) << "Tried reading at last-applied time: " << *lastAppliedTimestamp
                    << " on nss: " << nss.ns() << ", but future catalog changes are pending at time "
                    << *minSnapshot << ". Trying again without reading at last-applied time.";
@@ -311,7 +340,8 @@ OldClientContext::~OldClientContext() {
                                                      : Top::LockType::ReadLocked,
                 _timer.micros(),
                 currentOp->isCommand(),
-                currentOp->getReadWriteType());
+                currentOp->getReadWriteType(),
+                getStorageUsage(_opCtx));
 }
 
 LockMode getLockModeForQuery(OperationContext* opCtx) {
@@ -64,6 +64,9 @@ public:
 private:
     OperationContext* _opCtx;
     Top::LockType _lockType;
+
+    // The storage usage of the operation before the namespace was accessed.
+    Top::StorageUsage _storageUsageAtStart;
 };
 
 /**
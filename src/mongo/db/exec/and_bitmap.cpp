@@ -0,0 +1,316 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/and_bitmap.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+namespace {
+
+// Upper limit for buffered data, matching the limit of AND_HASH.
+// Stage execution will fail once the bitmaps exceed this threshold.
+const size_t kDefaultMaxMemUsageBytes = 32 * 1024 * 1024;
+
+}  // namespace
+
+// static
+const char* AndBitmapStage::kStageType = "AND_BITMAP";
+
+AndBitmapStage::AndBitmapStage(OperationContext* opCtx,
+                               WorkingSet* ws,
+                               const Collection* collection)
+    : AndBitmapStage(opCtx, ws, collection, kDefaultMaxMemUsageBytes) {}
+
+AndBitmapStage::AndBitmapStage(OperationContext* opCtx,
+                               WorkingSet* ws,
+                               const Collection* collection,
+                               size_t maxMemUsage)
+    : PlanStage(kStageType, opCtx),
+      _collection(collection),
+      _ws(ws),
+      _currentChild(0),
+      _idRetrying(WorkingSet::INVALID_ID),
+      _maxMemUsage(maxMemUsage) {}
+
+AndBitmapStage::~AndBitmapStage() {}
+
+void AndBitmapStage::addChild(PlanStage* child) {
+    _children.emplace_back(child);
+}
+
+size_t AndBitmapStage::getMemUsage() const {
+    return _bitmap.getMemUsage() + _childBitmap.getMemUsage();
+}
+
+bool AndBitmapStage::isEOF() {
+    if (WorkingSet::INVALID_ID != _idRetrying) {
+        return false;
+    }
+
+    // Still building the bitmap.
+    invariant(_children.size() >= 2);
+    if (_currentChild < _children.size() - 1) {
+        return false;
+    }
+
+    // Either nothing is left to probe for, or the last child is done.
+    return _bitmap.empty() || _children.back()->isEOF();
+}
+
+PlanStage::StageState AndBitmapStage::doWork(WorkingSetID* out) {
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (WorkingSet::INVALID_ID != _idRetrying) {
+        WorkingSetID id = _idRetrying;
+        _idRetrying = WorkingSet::INVALID_ID;
+        return fetchSurvivor(id, out);
+    }
+
+    if (_currentChild < _children.size() - 1) {
+        return readIntoBitmap(out);
+    }
+
+    return probeLastChild(out);
+}
+
+PlanStage::StageState AndBitmapStage::readIntoBitmap(WorkingSetID* out) {
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = _children[_currentChild]->work(&id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        WorkingSetMember* member = _ws->get(id);
+
+        // Maybe the child had an invalidation.  We intersect RecordId(s) so we can't do anything
+        // with this WSM.
+        if (!member->hasRecordId()) {
+            _ws->flagForReview(id);
+            return PlanStage::NEED_TIME;
+        }
+
+        // Duplicates, for instance from a multikey index, are absorbed by the bitmap.
+        (0 == _currentChild ? _bitmap : _childBitmap).add(member->recordId);
+        _ws->free(id);
+
+        const size_t memUsage = getMemUsage();
+        if (memUsage > _maxMemUsage) {
+            mongoutils::str::stream ss;
+            ss << "bitmap AND stage buffered data usage of " << memUsage
+               << " bytes exceeds internal limit of " << _maxMemUsage << " bytes";
+            Status status(ErrorCodes::Overflow, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
+
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::IS_EOF == childStatus) {
+        if (_currentChild > 0) {
+            _bitmap.intersectWith(_childBitmap);
+            _childBitmap = RecordIdBitmap();
+        }
+        _specificStats.bitmapAfterChild.push_back(_bitmap.size());
+        ++_currentChild;
+
+        // If nothing survived this child, don't scan any others, no possible results.
+        if (_bitmap.empty()) {
+            _currentChild = _children.size() - 1;
+            return PlanStage::IS_EOF;
+        }
+
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
+        // The stage which produces a failure is responsible for allocating a working set member
+        // with error details.
+        invariant(WorkingSet::INVALID_ID != id);
+        *out = id;
+        return childStatus;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
+PlanStage::StageState AndBitmapStage::probeLastChild(WorkingSetID* out) {
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childStatus = _children.back()->work(&id);
+
+    if (PlanStage::ADVANCED == childStatus) {
+        WorkingSetMember* member = _ws->get(id);
+
+        // Maybe the child had an invalidation.  We intersect RecordId(s) so we can't do anything
+        // with this WSM.
+        if (!member->hasRecordId()) {
+            _ws->flagForReview(id);
+            return PlanStage::NEED_TIME;
+        }
+
+        // Removing the RecordId once it survives ensures that we return each document only once.
+        if (!_bitmap.remove(member->recordId)) {
+            _ws->free(id);
+            return PlanStage::NEED_TIME;
+        }
+
+        return fetchSurvivor(id, out);
+    } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
+        // The stage which produces a failure is responsible for allocating a working set member
+        // with error details.
+        invariant(WorkingSet::INVALID_ID != id);
+        *out = id;
+        return childStatus;
+    } else {
+        if (PlanStage::NEED_YIELD == childStatus) {
+            *out = id;
+        }
+
+        return childStatus;
+    }
+}
+
+PlanStage::StageState AndBitmapStage::fetchSurvivor(WorkingSetID id, WorkingSetID* out) {
+    WorkingSetMember* member = _ws->get(id);
+
+    // The last child may have fetched the document already, or the member may have been
+    // invalidated and force-fetched while we were waiting to retry.
+    if (!member->hasObj()) {
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+
+        try {
+            if (!_cursor)
+                _cursor = _collection->getCursor(getOpCtx());
+
+            if (auto fetcher = _cursor->fetcherForId(member->recordId)) {
+                // There's something to fetch. Hand the fetcher off to the WSM, and pass up
+                // a fetch request.
+                _idRetrying = id;
+                member->setFetcher(fetcher.release());
+                *out = id;
+                return PlanStage::NEED_YIELD;
+            }
+
+            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                _ws->free(id);
+                return PlanStage::NEED_TIME;
+            }
+        } catch (const WriteConflictException&) {
+            _idRetrying = id;
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+    }
+
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+void AndBitmapStage::doSaveState() {
+    if (_cursor)
+        _cursor->saveUnpositioned();
+}
+
+void AndBitmapStage::doRestoreState() {
+    if (_cursor)
+        _cursor->restore();
+}
+
+void AndBitmapStage::doDetachFromOperationContext() {
+    if (_cursor)
+        _cursor->detachFromOperationContext();
+}
+
+void AndBitmapStage::doReattachToOperationContext() {
+    if (_cursor)
+        _cursor->reattachToOperationContext(getOpCtx());
+}
+
+void AndBitmapStage::doInvalidate(OperationContext* opCtx,
+                                  const RecordId& dl,
+                                  InvalidationType type) {
+    // The survivor we are about to fetch may be the one being invalidated. Fetch it now.
+    if (WorkingSet::INVALID_ID != _idRetrying) {
+        WorkingSetMember* member = _ws->get(_idRetrying);
+        if (member->hasRecordId() && member->recordId == dl) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
+
+    // As with AND_HASH, a deleted or mutated document may no longer satisfy every child, and we
+    // only hold its RecordId. So we fetch it, flag it to be picked up later, and forget about it.
+    // RecordIds which are only in the child bitmap are not in the intersection so far anyway.
+    _childBitmap.remove(dl);
+    if (!_bitmap.remove(dl)) {
+        return;
+    }
+
+    ++_specificStats.flagged;
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->recordId = dl;
+    _ws->transitionToRecordIdAndIdx(id);
+    WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+    _ws->flagForReview(id);
+}
+
+unique_ptr<PlanStageStats> AndBitmapStage::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    _specificStats.memLimit = _maxMemUsage;
+    _specificStats.memUsage = getMemUsage();
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_AND_BITMAP);
+    ret->specific = make_unique<AndBitmapStats>(_specificStats);
+    for (size_t i = 0; i < _children.size(); ++i) {
+        ret->children.emplace_back(_children[i]->getStats());
+    }
+
+    return ret;
+}
+
+const SpecificStats* AndBitmapStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+class SeekableRecordCursor;
+
+/**
+ * Reads from N children, each of which must have a valid RecordId, and outputs the documents
+ * whose RecordIds are produced by every child. An alternative to AndHashStage which buffers
+ * RecordIds rather than working set members.
+ *
+ * The RecordIds of all children but the last are read into compressed bitmaps, which are
+ * intersected as each child finishes. The last child is then streamed and probed against the
+ * bitmap, so that results come out in the last child's order, as with AndHashStage. Since the
+ * index data of the other children is not kept, the stage fetches each surviving document itself.
+ *
+ * Preconditions: Valid RecordId.  More than one child.
+ *
+ * Any RecordId buffered in the bitmap that is invalidated before we are able to return it is
+ * fetched and added to the WorkingSet as "flagged for further review."
+ */
+class AndBitmapStage final : public PlanStage {
+public:
+    AndBitmapStage(OperationContext* opCtx, WorkingSet* ws, const Collection* collection);
+
+    /**
+     * For testing only. Allows tests to set memory usage threshold.
+     */
+    AndBitmapStage(OperationContext* opCtx,
+                   WorkingSet* ws,
+                   const Collection* collection,
+                   size_t maxMemUsage);
+
+    ~AndBitmapStage();
+
+    void addChild(PlanStage* child);
+
+    /**
+     * Returns memory usage.
+     * For testing only.
+     */
+    size_t getMemUsage() const;
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
+
+    StageType stageType() const final {
+        return STAGE_AND_BITMAP;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    StageState readIntoBitmap(WorkingSetID* out);
+    StageState probeLastChild(WorkingSetID* out);
+
+    /**
+     * Fetches the document for the surviving member 'id' unless the last child already did.
+     */
+    StageState fetchSurvivor(WorkingSetID id, WorkingSetID* out);
+
+    // Not owned by us.
+    const Collection* _collection;
+
+    // Not owned by us.
+    WorkingSet* _ws;
+
+    // The intersection of the RecordIds of the children read so far.
+    RecordIdBitmap _bitmap;
+
+    // The RecordIds of the child currently being read, other than the first.
+    RecordIdBitmap _childBitmap;
+
+    // Which child are we currently working on?
+    size_t _currentChild;
+
+    // Used to fetch surviving documents.
+    std::unique_ptr<SeekableRecordCursor> _cursor;
+
+    // A surviving member whose fetch must be retried after a yield.
+    WorkingSetID _idRetrying;
+
+    // Stats
+    AndBitmapStats _specificStats;
+
+    // Upper limit for the memory used by the bitmaps.
+    size_t _maxMemUsage;
+};
+
+}  // namespace mongo
@@ -200,7 +200,13 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
 
     _specificStats.replanned = true;
 
-    if (shouldCache) {
+    // When the cached plan was merely a poor fit for this query's leading constant, keep the
+    // entry as it is and cache the result of replanning for a range of constants instead.
+    const bool addConstantRangePlan = shouldCache &&
+        internalQueryCacheMaxPlansPerShape.load() > 1 &&
+        !PlanCache::getLeadingConstant(*_canonicalQuery).isEmpty();
+
+    if (shouldCache && !addConstantRangePlan) {
         // Deactivate the current cache entry.
         PlanCache* cache = _collection->infoCache()->getPlanCache();
         cache->deactivate(*_canonicalQuery);
@@ -244,8 +250,9 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
 
     // Many solutions. Create a MultiPlanStage to pick the best, update the cache,
     // and so on. The working set will be shared by all candidate plans.
-    auto cachingMode = shouldCache ? MultiPlanStage::CachingMode::AlwaysCache
-                                   : MultiPlanStage::CachingMode::NeverCache;
+    auto cachingMode = shouldCache && !addConstantRangePlan
+        ? MultiPlanStage::CachingMode::AlwaysCache
+        : MultiPlanStage::CachingMode::NeverCache;
     _children.emplace_back(
         new MultiPlanStage(getOpCtx(), _collection, _canonicalQuery, cachingMode));
     MultiPlanStage* multiPlanStage = static_cast<MultiPlanStage*>(child().get());
@@ -269,6 +276,19 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
         return pickBestPlanStatus;
     }
 
+    if (addConstantRangePlan) {
+        const size_t winnerWorks =
+            multiPlanStage->getChildren()[multiPlanStage->bestPlanIdx()]->getStats()->common.works;
+        PlanCache* cache = _collection->infoCache()->getPlanCache();
+        Status status = cache->addConstantRangePlan(
+            *_canonicalQuery, *multiPlanStage->bestSolution(), winnerWorks);
+        LOG(1) << "Replanning " << redact(_canonicalQuery->toStringShort())
+               << " resulted in plan with summary: "
+               << redact(Explain::getPlanSummary(child().get()))
+               << ", caching it as a constant-range plan: " << status;
+        return Status::OK();
+    }
+
     LOG(1) << "Replanning " << redact(_canonicalQuery->toStringShort())
            << " resulted in plan with summary: " << redact(Explain::getPlanSummary(child().get()))
            << ", which " << (shouldCache ? "has" : "has not") << " been written to the cache";
@@ -38,6 +38,7 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
@@ -69,6 +70,11 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || _params.collection->ns().isOplog());
+    invariant(_params.end.isNull() || _params.direction == CollectionScanParams::FORWARD);
+
+    if (_filter) {
+        _compiledFilter = stdx::make_unique<CompiledMatchExpression>(_filter);
+    }
 
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
@@ -119,6 +125,13 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
             _cursor = _params.collection->getCursor(getOpCtx(), forward);
 
+            // Tailable cursors spend most of their time waiting at the end of the collection, so
+            // there is nothing useful to prefetch for them.
+            const int readAheadRecords = internalQueryCollectionScanReadAheadRecords.load();
+            if (forward && !_params.tailable && readAheadRecords > 0) {
+                _cursor->enableReadAhead(static_cast<std::size_t>(readAheadRecords));
+            }
+
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
                 // Seek to where we were last time. If it no longer exists, mark us as dead
@@ -142,8 +155,15 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
-        if (_lastSeenId.isNull() && !_params.start.isNull()) {
+        if (_lastSeenId.isNull() && !_params.start.isNull() && !_skippingToStart) {
             record = _cursor->seekExact(_params.start);
+            if (!record && !_params.end.isNull()) {
+                // The first record of the range has been deleted. Rather than lose the rest of
+                // the range, walk up to it from the start of the collection.
+                _skippingToStart = true;
+                _cursor = _params.collection->getCursor(getOpCtx(), true);
+                return PlanStage::NEED_TIME;
+            }
         } else {
             // See if the record we're about to access is in memory. If not, pass a fetch
             // request up.
@@ -178,6 +198,16 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (!_params.end.isNull()) {
+        if (_skippingToStart && record->id < _params.start) {
+            return PlanStage::NEED_TIME;
+        }
+        if (record->id >= _params.end) {
+            _commonStats.isEOF = true;
+            return PlanStage::IS_EOF;
+        }
+    }
+
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         auto status = setLatestOplogEntryTimestamp(*record);
@@ -214,9 +244,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -49,6 +49,13 @@ struct CollectionScanParams {
     // not being invalidated before the first call to work(...).
     RecordId start;
 
+    // If non-null, a forward scan returns EOF instead of the first record whose id is greater than
+    // or equal to 'end', restricting the scan to the RecordId range ['start', 'end'). Only
+    // meaningful for record stores that return records in RecordId order. When this is set and
+    // 'start' no longer exists, the scan begins from the first record and skips up to 'start'
+    // rather than returning EOF.
+    RecordId end;
+
     // If present, the collection scan will stop and return EOF the first time it sees a document
     // that does not pass the filter and has 'ts' greater than 'maxTs'.
     boost::optional<Timestamp> maxTs;
@@ -30,9 +30,12 @@
 
 #include "mongo/db/exec/count.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -113,19 +116,20 @@ PlanStage::StageState CountStage::doWork(WorkingSetID* out) {
     // For cases where we can't ask the record store directly, we should always have a child stage
     // from which we can retrieve results.
     invariant(child());
+
+    // Ask the child for a batch of results at a time, but never for more than it takes to reach
+    // the limit.
+    std::size_t batchSize = std::max(internalQueryExecWorkBatchSize.load(), 1);
+    if (_params.limit > 0) {
+        const long long needed = _params.limit - _specificStats.nCounted + _leftToSkip;
+        batchSize = std::min(batchSize, static_cast<std::size_t>(needed));
+    }
+
+    _batch.clear();
     WorkingSetID id = WorkingSet::INVALID_ID;
-    PlanStage::StageState state = child()->work(&id);
+    PlanStage::StageState state = child()->workBatch(batchSize, &_batch, &id);
 
-    if (PlanStage::IS_EOF == state) {
-        _commonStats.isEOF = true;
-        return PlanStage::IS_EOF;
-    } else if (PlanStage::FAILURE == state || PlanStage::DEAD == state) {
-        // The stage which produces a failure is responsible for allocating a working set member
-        // with error details.
-        invariant(WorkingSet::INVALID_ID != id);
-        *out = id;
-        return state;
-    } else if (PlanStage::ADVANCED == state) {
+    for (auto resultId : _batch) {
         // We got a result. If we're still skipping, then decrement the number left to skip.
         // Otherwise increment the count until we hit the limit.
         if (_leftToSkip > 0) {
@@ -137,9 +141,20 @@ PlanStage::StageState CountStage::doWork(WorkingSetID* out) {
 
         // Count doesn't need the actual results, so we just discard any valid working
         // set members that got returned from the child.
-        if (WorkingSet::INVALID_ID != id) {
-            _ws->free(id);
+        if (WorkingSet::INVALID_ID != resultId) {
+            _ws->free(resultId);
         }
+    }
+
+    if (PlanStage::IS_EOF == state) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    } else if (PlanStage::FAILURE == state || PlanStage::DEAD == state) {
+        // The stage which produces a failure is responsible for allocating a working set member
+        // with error details.
+        invariant(WorkingSet::INVALID_ID != id);
+        *out = id;
+        return state;
     } else if (PlanStage::NEED_YIELD == state) {
         *out = id;
         return PlanStage::NEED_YIELD;
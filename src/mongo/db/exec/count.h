@@ -111,6 +111,10 @@ private:
     // by us.
     WorkingSet* _ws;
 
+    // Results of the last batch of work requested from the child. Kept as a member so that its
+    // storage is reused across calls to doWork().
+    std::vector<WorkingSetID> _batch;
+
     CountStats _specificStats;
 };
 
@@ -30,6 +30,7 @@
 
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/stdx/memory.h"
@@ -69,11 +70,16 @@ using stdx::make_unique;
 // static
 const char* CountScan::kStageType = "COUNT_SCAN";
 
-CountScan::CountScan(OperationContext* opCtx, const CountScanParams& params, WorkingSet* workingSet)
+CountScan::CountScan(OperationContext* opCtx,
+                     const CountScanParams& params,
+                     WorkingSet* workingSet,
+                     const MatchExpression* filter)
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _descriptor(params.descriptor),
       _iam(params.descriptor->getIndexCatalog()->getIndex(params.descriptor)),
+      _keyPattern(params.descriptor->keyPattern().getOwned()),
+      _filter(filter),
       _shouldDedup(params.descriptor->isMultikey(opCtx)),
       _params(params) {
     _specificStats.keyPattern = _params.descriptor->keyPattern();
@@ -103,17 +109,18 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     boost::optional<IndexKeyEntry> entry;
     const bool needInit = !_cursor;
     try {
-        // We don't care about the keys.
-        const auto kWantLoc = SortedDataInterface::Cursor::kWantLoc;
+        // We only care about the keys if we need to filter them.
+        const auto parts = _filter ? SortedDataInterface::Cursor::kKeyAndLoc
+                                   : SortedDataInterface::Cursor::kWantLoc;
 
         if (needInit) {
             // First call to work().  Perform cursor init.
             _cursor = _iam->newCursor(getOpCtx());
             _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
 
-            entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, kWantLoc);
+            entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, parts);
         } else {
-            entry = _cursor->next(kWantLoc);
+            entry = _cursor->next(parts);
         }
     } catch (const WriteConflictException&) {
         if (needInit) {
@@ -137,6 +144,12 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    // As in IndexScan, the filter is applied after deduplication. The planner only assigns a
+    // filter to an index scan when this order does not affect the result.
+    if (_filter && !Filter::passes(entry->key, _keyPattern, _filter)) {
+        return PlanStage::NEED_TIME;
+    }
+
     WorkingSetID id = _workingSet->allocate();
     _workingSet->transitionToRecordIdAndObj(id);
     *out = id;
@@ -186,6 +199,13 @@ void CountScan::doInvalidate(OperationContext* opCtx, const RecordId& dl, Invali
 }
 
 unique_ptr<PlanStageStats> CountScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (_filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COUNT_SCAN);
 
     unique_ptr<CountScanStats> countStats = make_unique<CountScanStats>(_specificStats);
@@ -57,17 +57,24 @@ struct CountScanParams {
 };
 
 /**
- * Used by the count command. Scans an index from a start key to an end key. Creates a
- * WorkingSetMember for each matching index key in RID_AND_OBJ state. It has a null record id and an
- * empty object with a null snapshot id rather than real data. Returning real data is unnecessary
- * since all we need is the count.
+ * Used by the count command. Scans an index from a start key to an end key, optionally skipping
+ * keys which do not pass a filter over the index key. Creates a WorkingSetMember for each matching
+ * index key in RID_AND_OBJ state. It has a null record id and an empty object with a null snapshot
+ * id rather than real data. Returning real data is unnecessary since all we need is the count.
  *
  * Only created through the getExecutorCount() path, as count is the only operation that doesn't
  * care about its data.
  */
 class CountScan final : public PlanStage {
 public:
-    CountScan(OperationContext* opCtx, const CountScanParams& params, WorkingSet* workingSet);
+    /**
+     * If 'filter' is non-null, only index keys that pass it are counted. The filter is evaluated
+     * against the index key alone. It is not owned by the stage and must outlive it.
+     */
+    CountScan(OperationContext* opCtx,
+              const CountScanParams& params,
+              WorkingSet* workingSet,
+              const MatchExpression* filter = nullptr);
 
     StageState doWork(WorkingSetID* out) final;
     bool isEOF() final;
@@ -97,6 +104,12 @@ private:
 
     std::unique_ptr<SortedDataInterface::Cursor> _cursor;
 
+    // Key pattern of the index, used to match '_filter' against index keys.
+    const BSONObj _keyPattern;
+
+    // Not owned by us. May be null.
+    const MatchExpression* const _filter;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     bool _shouldDedup;
     stdx::unordered_set<RecordId, RecordId::Hasher> _returned;
@@ -40,6 +40,7 @@
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -81,7 +82,10 @@ DeleteStage::DeleteStage(OperationContext* opCtx,
       _ws(ws),
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID) {
+      _idReturning(WorkingSet::INVALID_ID),
+      _batchSize(params.isMulti && !params.returnDeleted && !params.isExplain
+                     ? internalQueryMultiDeleteBatchSize.load()
+                     : 1) {
     _children.emplace_back(child);
 }
 
@@ -93,7 +97,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _batch.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -102,6 +106,10 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     }
     invariant(_collection);  // If isEOF() returns false, we must have a collection.
 
+    if (_batchSize > 1) {
+        return doBatchedWork(out);
+    }
+
     // It is possible that after a delete was executed, a WriteConflictException occurred
     // and prevented us from returning ADVANCED with the old version of the document.
     if (_idReturning != WorkingSet::INVALID_ID) {
@@ -196,9 +204,6 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         member->obj.setValue(deletedDoc.getOwned());
     }
 
-    // TODO: Do we want to buffer docs and delete them in a group rather than saving/restoring state
-    // repeatedly?
-
     WorkingSetCommon::prepareForSnapshotChange(_ws);
     try {
         child()->saveState();
@@ -265,6 +270,133 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     return PlanStage::NEED_TIME;
 }
 
+PlanStage::StageState DeleteStage::doBatchedWork(WorkingSetID* out) {
+    if (!_batchRetrying) {
+        invariant(_batch.empty());
+
+        // Gather the batch within this call, so that no yield can happen between reading the
+        // documents and deleting them. Our child is worked at most '_batchSize' times, so that a
+        // plan whose child skips most of what it reads still yields as often as it would have.
+        for (size_t works = 0; works < _batchSize; ++works) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            auto status = child()->work(&id);
+
+            if (status == PlanStage::ADVANCED) {
+                WorkingSetMember* member = _ws->get(id);
+                // Deletes can't have projections, so we should always get fetched data.
+                invariant(!member->hasRecordId() || member->hasObj());
+                _batch.push_back(id);
+                continue;
+            }
+            if (status == PlanStage::NEED_TIME) {
+                continue;
+            }
+            if (status == PlanStage::IS_EOF) {
+                break;
+            }
+            if (status == PlanStage::NEED_YIELD) {
+                // The documents gathered so far are rechecked and deleted after the yield.
+                _batchRetrying = !_batch.empty();
+                *out = id;
+                return status;
+            }
+
+            // The stage which produces a failure is responsible for allocating a working set
+            // member with error details.
+            invariant(status == PlanStage::FAILURE || status == PlanStage::DEAD);
+            invariant(WorkingSet::INVALID_ID != id);
+            for (auto batchId : _batch) {
+                _ws->free(batchId);
+            }
+            _batch.clear();
+            *out = id;
+            return status;
+        }
+    }
+
+    // Ensure each document still exists and matches the predicate, keeping those which do at the
+    // front of the batch.
+    size_t numMatching = 0;
+    for (size_t i = 0; i < _batch.size(); ++i) {
+        WorkingSetID id = _batch[i];
+        if (!_ws->get(id)->hasRecordId()) {
+            // We expect to be here because of an invalidation causing a force-fetch.
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            continue;
+        }
+
+        bool docStillMatches;
+        try {
+            docStillMatches = write_stage_common::ensureStillMatches(
+                _collection, getOpCtx(), _ws, id, _params.canonicalQuery);
+        } catch (const WriteConflictException&) {
+            // Keep the documents checked so far and the rest of the batch, and retry them all.
+            _batch.erase(_batch.begin() + numMatching, _batch.begin() + i);
+            _batchRetrying = true;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (docStillMatches) {
+            _batch[numMatching++] = id;
+        } else {
+            _ws->free(id);
+        }
+    }
+    _batch.resize(numMatching);
+    _batchRetrying = false;
+
+    if (_batch.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    // Deletes can't be explained or return the deleted documents when batched, so always write.
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch) {
+            _collection->deleteDocument(getOpCtx(),
+                                        _params.stmtId,
+                                        _ws->get(id)->recordId,
+                                        _params.opDebug,
+                                        _params.fromMigrate,
+                                        false,
+                                        Collection::StoreDeletedDoc::Off);
+        }
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        // Keep the batch around so we can retry deleting it.
+        _batchRetrying = true;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    _specificStats.docsDeleted += _batch.size();
+
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The deletes were committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void DeleteStage::doRestoreState() {
     invariant(_collection);
     const NamespaceString& ns(_collection->ns());
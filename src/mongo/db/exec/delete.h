@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/logical_session_id.h"
@@ -80,6 +82,9 @@ struct DeleteStageParams {
  * document was requested to be returned, then ADVANCED is returned after deleting a document.
  * Otherwise, NEED_TIME is returned after deleting a document.
  *
+ * A multi delete which does not return the deleted documents removes up to
+ * 'internalQueryMultiDeleteBatchSize' documents from its child in each storage transaction.
+ *
  * Callers of work() must be holding a write lock (and, for replicated deletes, callers must have
  * had the replication coordinator approve the write).
  */
@@ -122,6 +127,13 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Does the work of a call to work() for a delete which removes multiple documents in each
+     * WriteUnitOfWork. Gathers up to '_batchSize' documents from the child, or retries the batch
+     * held in '_batch', and deletes those which still exist and match.
+     */
+    StageState doBatchedWork(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -138,6 +150,15 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The largest number of documents deleted in one WriteUnitOfWork. Always 1 unless this is a
+    // multi delete which does not return the deleted documents.
+    const size_t _batchSize;
+
+    // The members gathered for the next batch of deletes, and whether they were gathered before a
+    // yield and must be checked again before they are deleted.
+    std::vector<WorkingSetID> _batch;
+    bool _batchRetrying = false;
+
     // Stats
     DeleteStats _specificStats;
 };
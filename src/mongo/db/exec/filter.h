@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
 
@@ -157,6 +158,22 @@ public:
         return filter->matches(&doc, NULL);
     }
 
+    /**
+     * Same as above, but evaluates 'compiled', which must have been compiled from 'filter', when
+     * 'wsm' has a document to match against.
+     */
+    static bool passes(WorkingSetMember* wsm,
+                       const MatchExpression* filter,
+                       const CompiledMatchExpression* compiled) {
+        if (NULL == filter) {
+            return true;
+        }
+        if (compiled && wsm->hasObj()) {
+            return compiled->matchesBSON(wsm->obj.value());
+        }
+        return passes(wsm, filter);
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
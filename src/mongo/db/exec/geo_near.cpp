@@ -806,6 +806,22 @@ GeoNear2DSphereStage::~GeoNear2DSphereStage() {}
 
 namespace {
 
+// The area of the Earth's surface within 'distance' meters of a point.
+double sphereCapArea(double distance) {
+    const double angle = std::min(distance / kRadiusOfEarthInMeters, M_PI);
+    return 2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters * (1 - std::cos(angle));
+}
+
+// The distance in meters within which the Earth's surface around a point has the given area.
+double sphereCapDistance(double area) {
+    const double cosAngle =
+        1 - area / (2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters);
+    if (cosAngle <= -1) {
+        return kMaxEarthDistanceInMeters;
+    }
+    return kRadiusOfEarthInMeters * std::acos(cosAngle);
+}
+
 S2Region* buildS2Region(const R2Annulus& sphereBounds) {
     // Internal bounds come in SPHERE CRS units
     // i.e. center is lon/lat, inner/outer are in meters
@@ -1042,13 +1058,18 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
+        const int targetResults = internalGeoNearQuery2DSphereTargetIntervalResults.load();
+        if (targetResults > 0) {
+            _boundsIncrement = _densityBasedBoundsIncrement(targetResults);
+        } else {
+            const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
 
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+            // TODO: Generally we want small numbers of results fast, then larger numbers later
+            if (lastIntervalStats.numResultsReturned < 300)
+                _boundsIncrement *= 2;
+            else if (lastIntervalStats.numResultsReturned > 600)
+                _boundsIncrement /= 2;
+        }
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -1111,6 +1132,31 @@ StatusWith<NearStage::CoveredInterval*>  //
                                                             isLastInterval));
 }
 
+double GeoNear2DSphereStage::_densityBasedBoundsIncrement(int targetResults) const {
+    // The increment changes by at most this factor from one interval to the next, so that a few
+    // documents clustered near the center or just outside the searched area don't throw the
+    // search far off.
+    const double kMaxChangeFactor = 4;
+
+    long long numResults = 0;
+    for (const auto& intervalStats : _specificStats.intervalStats) {
+        numResults += intervalStats.numResultsBuffered;
+    }
+
+    const double searchedOuterArea = sphereCapArea(_currBounds.getOuter());
+    const double searchedArea = searchedOuterArea - sphereCapArea(_fullBounds.getInner());
+    if (numResults == 0 || searchedArea <= 0) {
+        return _boundsIncrement * kMaxChangeFactor;
+    }
+
+    // Assume that the documents beyond the searched area are as dense as within it.
+    const double density = numResults / searchedArea;
+    const double nextOuter = sphereCapDistance(searchedOuterArea + targetResults / density);
+    const double increment = nextOuter - _currBounds.getOuter();
+    return std::max(std::min(increment, _boundsIncrement * kMaxChangeFactor),
+                    _boundsIncrement / kMaxChangeFactor);
+}
+
 StatusWith<double> GeoNear2DSphereStage::computeDistance(WorkingSetMember* member) {
     return computeGeoNearDistance(_nearParams, member);
 }
@@ -146,6 +146,12 @@ private:
     // The current search annulus
     R2Annulus _currBounds;
 
+    /**
+     * Returns the increment which makes the next interval contain about 'targetResults'
+     * documents, given the density of the documents found in the intervals searched so far.
+     */
+    double _densityBasedBoundsIncrement(int targetResults) const;
+
     // Amount to increment the next bounds by
     double _boundsIncrement;
 
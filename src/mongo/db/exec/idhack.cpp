@@ -30,6 +30,8 @@
 
 #include "mongo/db/exec/idhack.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/projection.h"
@@ -37,6 +39,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 
@@ -49,6 +52,32 @@ using stdx::make_unique;
 // static
 const char* IDHackStage::kStageType = "IDHACK";
 
+namespace {
+
+/**
+ * Returns the _id keys to look up for 'query', each of the form {_id: <value>}. The keys of an $in
+ * query are returned in ascending order without duplicates, which is the order of the _id index
+ * since such queries are only supported with the simple collation.
+ */
+std::vector<BSONObj> getIdKeys(const CanonicalQuery& query) {
+    BSONElement idElt = query.getQueryObj()["_id"];
+    if (!CanonicalQuery::isSimpleIdInQuery(query.getQueryObj())) {
+        return {idElt.wrap()};
+    }
+
+    std::vector<BSONObj> keys;
+    for (auto&& elt : idElt.Obj().firstElement().Obj()) {
+        keys.push_back(elt.wrap("_id"));
+    }
+    std::sort(keys.begin(), keys.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+    keys.erase(
+        std::unique(keys.begin(), keys.end(), SimpleBSONObjComparator::kInstance.makeEqualTo()),
+        keys.end());
+    return keys;
+}
+
+}  // namespace
+
 IDHackStage::IDHackStage(OperationContext* opCtx,
                          const Collection* collection,
                          CanonicalQuery* query,
@@ -57,8 +86,8 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _workingSet(ws),
-      _key(query->getQueryObj()["_id"].wrap()),
-      _done(false),
+      _keys(getIdKeys(*query)),
+      _done(_keys.empty()),
       _idBeingPagedIn(WorkingSet::INVALID_ID) {
     const IndexCatalog* catalog = _collection->getIndexCatalog();
     _specificStats.indexName = descriptor->indexName();
@@ -79,7 +108,7 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _workingSet(ws),
-      _key(key),
+      _keys{key},
       _done(false),
       _addKeyMetadata(false),
       _idBeingPagedIn(WorkingSet::INVALID_ID) {
@@ -119,12 +148,16 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
     WorkingSetID id = WorkingSet::INVALID_ID;
     try {
         // Look up the key by going directly to the index.
-        RecordId recordId = _accessMethod->findSingle(getOpCtx(), _key);
+        RecordId recordId = _accessMethod->findSingle(getOpCtx(), _keys[_nextKey]);
 
         // Key not found.
         if (recordId.isNull()) {
-            _done = true;
-            return PlanStage::IS_EOF;
+            if (++_nextKey == _keys.size()) {
+                _done = true;
+                return PlanStage::IS_EOF;
+            }
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_TIME;
         }
 
         ++_specificStats.keysExamined;
@@ -152,11 +185,15 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
         // The doc was already in memory, so we go ahead and return it.
         if (!WorkingSetCommon::fetch(getOpCtx(), _workingSet, id, _recordCursor)) {
             // _id is immutable so the index would return the only record that could
-            // possibly match the query.
+            // possibly match this key.
             _workingSet->free(id);
-            _commonStats.isEOF = true;
-            _done = true;
-            return IS_EOF;
+            if (++_nextKey == _keys.size()) {
+                _commonStats.isEOF = true;
+                _done = true;
+                return IS_EOF;
+            }
+            *out = WorkingSet::INVALID_ID;
+            return NEED_TIME;
         }
 
         return advance(id, member, out);
@@ -179,11 +216,13 @@ PlanStage::StageState IDHackStage::advance(WorkingSetID id,
     if (_addKeyMetadata) {
         BSONObjBuilder bob;
         BSONObj ownedKeyObj = member->obj.value()["_id"].wrap().getOwned();
-        bob.appendKeys(_key, ownedKeyObj);
+        bob.appendKeys(_keys[_nextKey], ownedKeyObj);
         member->addComputed(new IndexKeyComputedData(bob.obj()));
     }
 
-    _done = true;
+    if (++_nextKey == _keys.size()) {
+        _done = true;
+    }
     *out = id;
     return PlanStage::ADVANCED;
 }
@@ -227,11 +266,19 @@ void IDHackStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inva
 
 // static
 bool IDHackStage::supportsQuery(Collection* collection, const CanonicalQuery& query) {
-    return !query.getQueryRequest().showRecordId() && query.getQueryRequest().getHint().isEmpty() &&
-        !query.getQueryRequest().getSkip() &&
-        CanonicalQuery::isSimpleIdQuery(query.getQueryRequest().getFilter()) &&
-        !query.getQueryRequest().isTailable() &&
-        CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator());
+    const QueryRequest& qr = query.getQueryRequest();
+    if (qr.showRecordId() || !qr.getHint().isEmpty() || qr.getSkip() || qr.isTailable() ||
+        !CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator())) {
+        return false;
+    }
+
+    if (CanonicalQuery::isSimpleIdQuery(qr.getFilter())) {
+        return true;
+    }
+
+    return CanonicalQuery::isSimpleIdInQuery(qr.getFilter()) && !query.getCollator() &&
+        qr.getSort().isEmpty() && !qr.getLimit() && !qr.getNToReturn() &&
+        qr.getMin().isEmpty() && qr.getMax().isEmpty();
 }
 
 unique_ptr<PlanStageStats> IDHackStage::getStats() {
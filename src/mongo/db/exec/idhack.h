@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -44,6 +45,9 @@ class RecordCursor;
  * A standalone stage implementing the fast path for key-value retrievals via the _id index. Since
  * the _id index always has the collection default collation, the IDHackStage can only be used when
  * the query's collation is equal to the collection default.
+ *
+ * Besides a single _id equality, the stage also answers {_id: {$in: [...]}} queries by looking up
+ * each distinct key in ascending _id order. Documents are returned in that order.
  */
 class IDHackStage final : public PlanStage {
 public:
@@ -72,7 +76,9 @@ public:
     void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     /**
-     * ID Hack has a very strict criteria for the queries it supports.
+     * ID Hack has a very strict criteria for the queries it supports. An $in over _id is only
+     * supported when there is no collation, sort, limit or min/max, since the stage returns every
+     * match in _id order.
      */
     static bool supportsQuery(Collection* collection, const CanonicalQuery& query);
 
@@ -88,7 +94,8 @@ public:
 
 private:
     /**
-     * Marks this stage as done, optionally adds key metadata, and returns PlanStage::ADVANCED.
+     * Moves on to the next key, optionally adds key metadata, and returns PlanStage::ADVANCED. The
+     * stage is done once the last key has been looked up.
      *
      * Called whenever we have a WSM containing the matching obj.
      */
@@ -105,10 +112,13 @@ private:
     // Not owned here.
     const IndexAccessMethod* _accessMethod;
 
-    // The value to match against the _id field.
-    BSONObj _key;
+    // The values to match against the _id field, sorted in ascending order without duplicates.
+    std::vector<BSONObj> _keys;
+
+    // Index into '_keys' of the next key to look up.
+    size_t _nextKey = 0;
 
-    // Have we returned our one document?
+    // Have we looked up every key?
     bool _done;
 
     // Do we need to add index key metadata for returnKey?
@@ -50,6 +50,10 @@ struct IndexScanParams {
 
     const IndexDescriptor* descriptor;
 
+    // The shape of the keys being scanned, if it differs from the descriptor's key pattern. An
+    // allPaths index stores keys of the form {$_path: <path>, <path>: <value>}.
+    BSONObj keyPattern;
+
     IndexBounds bounds;
 
     int direction;
@@ -45,6 +45,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -210,13 +211,29 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
-    // Work the plans, stopping when a plan hits EOF or returns some
-    // fixed number of results.
+    const Milliseconds maxTrialTime(internalQueryPlanEvaluationMaxMillis.load());
+    const Date_t trialStart = getClock()->now();
+
+    // Work the plans, stopping when a plan hits EOF or returns some fixed number of results, when
+    // a single plan dominates all others, or when the trial period runs out of time.
     for (size_t ix = 0; ix < numWorks; ++ix) {
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
         }
+
+        if (pruneDominatedPlans()) {
+            LOG(2) << "Ending trial period after " << (ix + 1)
+                   << " works: only one plan left after pruning";
+            break;
+        }
+
+        if (maxTrialTime > Milliseconds(0) && getClock()->now() - trialStart >= maxTrialTime) {
+            LOG(1) << "Ending trial period after " << (ix + 1) << " works: exceeded "
+                   << "internalQueryPlanEvaluationMaxMillis of " << maxTrialTime
+                   << " ns: " << _collection->ns() << " " << redact(_query->toStringShort());
+            break;
+        }
     }
 
     if (_failure) {
@@ -228,7 +245,12 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // After picking best plan, ranking will own plan stats from
     // candidate solutions (winner and losers).
     std::unique_ptr<PlanRankingDecision> ranking(new PlanRankingDecision);
-    _bestPlanIdx = PlanRanker::pickBestPlan(_candidates, ranking.get());
+    boost::optional<CollectionIndexUsageMap> indexUsage;
+    if (internalQueryPlanTieBreakingWithIndexUsage.load()) {
+        indexUsage = _collection->infoCache()->getIndexUsageStats();
+    }
+    _bestPlanIdx = PlanRanker::pickBestPlan(
+        _candidates, ranking.get(), indexUsage ? indexUsage.get_ptr() : nullptr);
     verify(_bestPlanIdx >= 0 && _bestPlanIdx < static_cast<int>(_candidates.size()));
 
     // Copy candidate order. We will need this to sort candidate stats for explain
@@ -342,7 +364,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.pruned) {
             continue;
         }
 
@@ -410,6 +432,48 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::pruneDominatedPlans() {
+    const double pruneRatio = internalQueryPlanEvaluationPruneRatio.load();
+    if (pruneRatio == 0.0) {
+        return false;
+    }
+
+    size_t leaderIdx = 0;
+    size_t leaderResults = 0;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        const CandidatePlan& candidate = _candidates[ix];
+        if (!candidate.failed && !candidate.pruned && candidate.results.size() > leaderResults) {
+            leaderIdx = ix;
+            leaderResults = candidate.results.size();
+        }
+    }
+
+    if (leaderResults < static_cast<size_t>(internalQueryPlanEvaluationPruneMinResults.load())) {
+        return false;
+    }
+
+    // Every live candidate has been worked the same number of times, so comparing result counts
+    // is the same as comparing productivity.
+    size_t numLive = 1;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[ix];
+        if (ix == leaderIdx || candidate.failed || candidate.pruned) {
+            continue;
+        }
+
+        auto results = std::max(static_cast<size_t>(1), candidate.results.size());
+        if (static_cast<double>(leaderResults) >= pruneRatio * results) {
+            LOG(5) << "Pruning candidate " << ix << " with " << candidate.results.size()
+                   << " results; leader has " << leaderResults;
+            candidate.pruned = true;
+        } else {
+            ++numLive;
+        }
+    }
+
+    return numLive == 1U;
+}
+
 namespace {
 
 void invalidateHelper(OperationContext* opCtx,
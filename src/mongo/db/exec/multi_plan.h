@@ -168,6 +168,15 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Marks as pruned every candidate whose result count has fallen behind the leading candidate's
+     * by the ratio given by 'internalQueryPlanEvaluationPruneRatio'. Pruned candidates are no
+     * longer worked, but are still ranked.
+     *
+     * Returns true if only one candidate is left to work, in which case the trial period can end.
+     */
+    bool pruneDominatedPlans();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -34,17 +34,35 @@
 
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/tick_source.h"
 
 namespace mongo {
 
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+
+    // Sampled calls are timed with the tick source, which is too expensive to read on every call.
+    const int sampleInterval = internalQueryExecStageTimingSampleInterval.load();
+    TickSource* tickSource = nullptr;
+    TickSource::Tick startTicks = 0;
+    if (MONGO_unlikely(sampleInterval > 0) && _commonStats.works % sampleInterval == 0) {
+        tickSource = _opCtx->getServiceContext()->getTickSource();
+        startTicks = tickSource->getTicks();
+    }
     ++_commonStats.works;
 
     StageState workResult = doWork(out);
 
+    if (MONGO_unlikely(tickSource)) {
+        const auto elapsedTicks = tickSource->getTicks() - startTicks;
+        _commonStats.executionTimeSampledNanos += static_cast<long long>(
+            static_cast<double>(elapsedTicks) * 1e9 / tickSource->getTicksPerSecond());
+        ++_commonStats.worksTimed;
+    }
+
     if (StageState::ADVANCED == workResult) {
         ++_commonStats.advanced;
     } else if (StageState::NEED_TIME == workResult) {
@@ -56,6 +74,34 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(std::size_t maxWorks,
+                                           std::vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    invariant(_opCtx);
+    // A single timer for the whole batch avoids reading the clock twice per result.
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    return doWorkBatch(maxWorks, results, out);
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(std::size_t maxWorks,
+                                             std::vector<WorkingSetID>* results,
+                                             WorkingSetID* out) {
+    for (std::size_t i = 0; i < maxWorks; ++i) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        StageState state = doWork(&id);
+        recordWork(state);
+
+        if (StageState::ADVANCED == state) {
+            results->push_back(id);
+        } else if (StageState::NEED_TIME != state) {
+            *out = id;
+            return state;
+        }
+    }
+
+    return StageState::NEED_TIME;
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
@@ -188,6 +188,19 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Batched variant of work(). Performs up to 'maxWorks' units of work, appending the output of
+     * each one that returns ADVANCED to 'results'. Returns NEED_TIME if all 'maxWorks' units were
+     * performed. Otherwise stops at the first unit that returns IS_EOF, NEED_YIELD, DEAD or
+     * FAILURE, and returns that state with '*out' set as work() would have set it.
+     *
+     * The caller must process 'results' before acting on the returned state. Stats are kept per
+     * unit of work, exactly as if work() had been called 'maxWorks' times.
+     */
+    StageState workBatch(std::size_t maxWorks,
+                         std::vector<WorkingSetID>* results,
+                         WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -347,6 +360,30 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work.  See comment at workBatch() above.
+     *
+     * The default implementation calls doWork() once per unit. Stages that can produce results
+     * more cheaply in bulk may override it, and must call recordWork() once per unit of work.
+     */
+    virtual StageState doWorkBatch(std::size_t maxWorks,
+                                   std::vector<WorkingSetID>* results,
+                                   WorkingSetID* out);
+
+    /**
+     * Updates the common stats for one unit of work which returned 'state'.
+     */
+    void recordWork(StageState state) {
+        ++_commonStats.works;
+        if (StageState::ADVANCED == state) {
+            ++_commonStats.advanced;
+        } else if (StageState::NEED_TIME == state) {
+            ++_commonStats.needTime;
+        } else if (StageState::NEED_YIELD == state) {
+            ++_commonStats.needYield;
+        }
+    }
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -65,6 +65,8 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          executionTimeSampledNanos(0),
+          worksTimed(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -87,6 +89,11 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // Time elapsed in the calls to work() which were timed with the tick source, and their number.
+    // See internalQueryExecStageTimingSampleInterval.
+    long long executionTimeSampledNanos;
+    size_t worksTimed;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -167,6 +174,27 @@ struct AndHashStats : public SpecificStats {
     size_t memLimit;
 };
 
+struct AndBitmapStats : public SpecificStats {
+    AndBitmapStats() : flagged(0), memUsage(0), memLimit(0) {}
+
+    SpecificStats* clone() const final {
+        AndBitmapStats* specific = new AndBitmapStats(*this);
+        return specific;
+    }
+
+    // How many buffered RecordIds were invalidated before we could return them?
+    size_t flagged;
+
+    // How many RecordIds remain in the bitmap after intersecting each child but the last?
+    std::vector<size_t> bitmapAfterChild;
+
+    // What's our current memory usage?
+    size_t memUsage;
+
+    // What's our memory limit?
+    size_t memLimit;
+};
+
 struct AndSortedStats : public SpecificStats {
     AndSortedStats() : flagged(0) {}
 
@@ -513,7 +541,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false), spills(0) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -529,6 +557,12 @@ struct SortStats : public SpecificStats {
     // What's our memory limit?
     size_t memLimit;
 
+    // Did we exceed the memory limit and sort externally?
+    bool usedDisk;
+
+    // How many sorted runs were written to disk? Only meaningful if 'usedDisk' is true.
+    size_t spills;
+
     // The number of results to return from the sort.
     size_t limit;
 
@@ -611,6 +645,7 @@ struct UpdateStats : public SpecificStats {
           isDocReplacement(false),
           fastmodinsert(false),
           inserted(false),
+          inPlaceUpdate(false),
           nInvalidateSkips(0) {}
 
     SpecificStats* clone() const final {
@@ -637,6 +672,10 @@ struct UpdateStats : public SpecificStats {
     // The object that was inserted. This is an empty document if no insert was performed.
     BSONObj objInserted;
 
+    // True iff at least one document was modified and every modified document was written by
+    // applying damage events to the stored record, rather than by rewriting it in full.
+    bool inPlaceUpdate;
+
     // Invalidated documents can be force-fetched, causing the now invalid RecordId to
     // be thrown out. The update stage skips over any results which do not have the
     // RecordId to update.
@@ -682,6 +721,13 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of best scoring documents the stage was asked for, or zero if it scores all of
+    // them.
+    size_t topK = 0;
+
+    // Whether the stage stopped reading the index once no other document could make the top K.
+    bool stoppedEarly = false;
 };
 
 }  // namespace mongo
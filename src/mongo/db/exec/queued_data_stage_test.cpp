@@ -128,4 +128,59 @@ TEST_F(QueuedDataStageTest, validateStats) {
     unique_ptr<PlanStageStats> allStats(mock->getStats());
     ASSERT_TRUE(stats->isEOF);
 }
+
+//
+// Test that a batch of work collects results until it stops on a state other than NEED_TIME.
+//
+TEST_F(QueuedDataStageTest, workBatchStopsAtYield) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+
+    WorkingSetID first = ws.allocate();
+    WorkingSetID second = ws.allocate();
+    mock->pushBack(first);
+    mock->pushBack(PlanStage::NEED_TIME);
+    mock->pushBack(second);
+    mock->pushBack(PlanStage::NEED_YIELD);
+    mock->pushBack(PlanStage::NEED_TIME);
+
+    std::vector<WorkingSetID> results;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_YIELD, mock->workBatch(10, &results, &out));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(first, results[0]);
+    ASSERT_EQUALS(second, results[1]);
+
+    // Stats are kept per unit of work.
+    const CommonStats* stats = mock->getCommonStats();
+    ASSERT_EQUALS(stats->works, 4U);
+    ASSERT_EQUALS(stats->advanced, 2U);
+    ASSERT_EQUALS(stats->needTime, 1U);
+    ASSERT_EQUALS(stats->needYield, 1U);
+
+    results.clear();
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(10, &results, &out));
+    ASSERT(results.empty());
+}
+
+//
+// Test that a batch does no more than the requested units of work.
+//
+TEST_F(QueuedDataStageTest, workBatchRespectsMaxWorks) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+
+    for (int i = 0; i < 3; ++i) {
+        mock->pushBack(ws.allocate());
+    }
+
+    std::vector<WorkingSetID> results;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_TIME, mock->workBatch(2, &results, &out));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(mock->getCommonStats()->works, 2U);
+
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(2, &results, &out));
+    ASSERT_EQUALS(3U, results.size());
+}
 }
@@ -0,0 +1,246 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const size_t kBitsPerWord = 64;
+const size_t kWordsPerBitset = (1 << 16) / kBitsPerWord;
+
+// The approximate overhead of one node of the ordered map of containers.
+const size_t kContainerNodeOverhead = 4 * sizeof(void*);
+
+size_t countBits(uint64_t word) {
+    return std::bitset<kBitsPerWord>(word).count();
+}
+
+}  // namespace
+
+const size_t RecordIdBitmap::kMaxArrayCardinality = 4096;
+
+bool RecordIdBitmap::Container::add(uint16_t low) {
+    if (isBitset()) {
+        uint64_t& word = _bits[low / kBitsPerWord];
+        const uint64_t mask = 1ULL << (low % kBitsPerWord);
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        ++_bitsCardinality;
+        return true;
+    }
+
+    auto it = std::lower_bound(_array.begin(), _array.end(), low);
+    if (it != _array.end() && *it == low) {
+        return false;
+    }
+
+    if (_array.size() < kMaxArrayCardinality) {
+        _array.insert(it, low);
+        return true;
+    }
+
+    convertToBitset();
+    return add(low);
+}
+
+bool RecordIdBitmap::Container::remove(uint16_t low) {
+    if (isBitset()) {
+        uint64_t& word = _bits[low / kBitsPerWord];
+        const uint64_t mask = 1ULL << (low % kBitsPerWord);
+        if (!(word & mask)) {
+            return false;
+        }
+        word &= ~mask;
+        --_bitsCardinality;
+        convertToArrayIfSparse();
+        return true;
+    }
+
+    auto it = std::lower_bound(_array.begin(), _array.end(), low);
+    if (it == _array.end() || *it != low) {
+        return false;
+    }
+    _array.erase(it);
+    return true;
+}
+
+bool RecordIdBitmap::Container::contains(uint16_t low) const {
+    if (isBitset()) {
+        return _bits[low / kBitsPerWord] & (1ULL << (low % kBitsPerWord));
+    }
+    return std::binary_search(_array.begin(), _array.end(), low);
+}
+
+void RecordIdBitmap::Container::intersectWith(const Container& other) {
+    if (isBitset() && other.isBitset()) {
+        _bitsCardinality = 0;
+        for (size_t i = 0; i < kWordsPerBitset; ++i) {
+            _bits[i] &= other._bits[i];
+            _bitsCardinality += countBits(_bits[i]);
+        }
+        convertToArrayIfSparse();
+        return;
+    }
+
+    // At least one side is a sorted array, and the intersection can be no larger than it.
+    const std::vector<uint16_t>& candidates = isBitset() ? other._array : _array;
+    const Container& filter = isBitset() ? *this : other;
+
+    std::vector<uint16_t> result;
+    if (!filter.isBitset()) {
+        std::set_intersection(candidates.begin(),
+                              candidates.end(),
+                              filter._array.begin(),
+                              filter._array.end(),
+                              std::back_inserter(result));
+    } else {
+        std::copy_if(candidates.begin(),
+                     candidates.end(),
+                     std::back_inserter(result),
+                     [&filter](uint16_t low) { return filter.contains(low); });
+    }
+
+    _array = std::move(result);
+    _bits.clear();
+    _bits.shrink_to_fit();
+    _bitsCardinality = 0;
+}
+
+size_t RecordIdBitmap::Container::cardinality() const {
+    return isBitset() ? _bitsCardinality : _array.size();
+}
+
+size_t RecordIdBitmap::Container::getMemUsage() const {
+    return sizeof(Container) + _array.capacity() * sizeof(uint16_t) +
+        _bits.capacity() * sizeof(uint64_t);
+}
+
+void RecordIdBitmap::Container::convertToBitset() {
+    invariant(!isBitset());
+    _bits.assign(kWordsPerBitset, 0);
+    for (uint16_t low : _array) {
+        _bits[low / kBitsPerWord] |= 1ULL << (low % kBitsPerWord);
+    }
+    _bitsCardinality = _array.size();
+    _array.clear();
+    _array.shrink_to_fit();
+}
+
+void RecordIdBitmap::Container::convertToArrayIfSparse() {
+    if (!isBitset() || _bitsCardinality > kMaxArrayCardinality) {
+        return;
+    }
+
+    _array.reserve(_bitsCardinality);
+    for (size_t i = 0; i < kWordsPerBitset; ++i) {
+        for (uint64_t word = _bits[i]; word; word &= word - 1) {
+            const size_t bit = countTrailingZeros64(word);
+            _array.push_back(static_cast<uint16_t>(i * kBitsPerWord + bit));
+        }
+    }
+    _bits.clear();
+    _bits.shrink_to_fit();
+    _bitsCardinality = 0;
+}
+
+bool RecordIdBitmap::add(const RecordId& rid) {
+    const uint64_t key = toKey(rid);
+    if (!_containers[key >> 16].add(static_cast<uint16_t>(key))) {
+        return false;
+    }
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::remove(const RecordId& rid) {
+    const uint64_t key = toKey(rid);
+    auto it = _containers.find(key >> 16);
+    if (it == _containers.end() || !it->second.remove(static_cast<uint16_t>(key))) {
+        return false;
+    }
+    if (0 == it->second.cardinality()) {
+        _containers.erase(it);
+    }
+    --_size;
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& rid) const {
+    const uint64_t key = toKey(rid);
+    auto it = _containers.find(key >> 16);
+    return it != _containers.end() && it->second.contains(static_cast<uint16_t>(key));
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    _size = 0;
+    auto otherIt = other._containers.begin();
+    for (auto it = _containers.begin(); it != _containers.end();) {
+        while (otherIt != other._containers.end() && otherIt->first < it->first) {
+            ++otherIt;
+        }
+
+        if (otherIt == other._containers.end() || otherIt->first != it->first) {
+            it = _containers.erase(it);
+            continue;
+        }
+
+        it->second.intersectWith(otherIt->second);
+        if (0 == it->second.cardinality()) {
+            it = _containers.erase(it);
+            continue;
+        }
+
+        _size += it->second.cardinality();
+        ++it;
+    }
+}
+
+size_t RecordIdBitmap::getMemUsage() const {
+    size_t memUsage = sizeof(RecordIdBitmap);
+    for (auto&& container : _containers) {
+        memUsage += kContainerNodeOverhead + sizeof(container.first);
+        memUsage += container.second.getMemUsage();
+    }
+    return memUsage;
+}
+
+}  // namespace mongo
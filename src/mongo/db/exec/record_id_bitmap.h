@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, laid out like a roaring bitmap. The 64-bit RecordId space is
+ * split into chunks of 2^16 consecutive values. Each non-empty chunk is stored either as a sorted
+ * array of 16-bit offsets, while it holds at most kMaxArrayCardinality values, or as a bitset of
+ * 2^16 bits once it is denser than that. A chunk therefore never takes more than 8KB, and sets of
+ * nearby RecordIds, which is what index scans over a collection produce, stay small.
+ *
+ * Not thread safe.
+ */
+class RecordIdBitmap {
+public:
+    // A chunk switches from a sorted array to a bitset once it holds more than this many values.
+    static const size_t kMaxArrayCardinality;
+
+    /**
+     * Adds 'rid' to the set. Returns false if it was already present.
+     */
+    bool add(const RecordId& rid);
+
+    /**
+     * Removes 'rid' from the set. Returns false if it was not present.
+     */
+    bool remove(const RecordId& rid);
+
+    bool contains(const RecordId& rid) const;
+
+    /**
+     * Removes from this set every RecordId which is not also in 'other'.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    /**
+     * Returns the number of RecordIds in the set.
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return 0 == _size;
+    }
+
+    /**
+     * Returns an estimate, in bytes, of the memory used by the set.
+     */
+    size_t getMemUsage() const;
+
+private:
+    /**
+     * The RecordIds of one chunk, identified by the low 16 bits of their keys.
+     */
+    class Container {
+    public:
+        bool add(uint16_t low);
+        bool remove(uint16_t low);
+        bool contains(uint16_t low) const;
+        void intersectWith(const Container& other);
+
+        size_t cardinality() const;
+        size_t getMemUsage() const;
+
+    private:
+        bool isBitset() const {
+            return !_bits.empty();
+        }
+
+        void convertToBitset();
+        void convertToArrayIfSparse();
+
+        // Sorted offsets. Only used while '_bits' is empty.
+        std::vector<uint16_t> _array;
+
+        // Either empty or exactly 2^16 bits.
+        std::vector<uint64_t> _bits;
+        size_t _bitsCardinality = 0;
+    };
+
+    /**
+     * Maps a RecordId to a key whose unsigned order matches the signed order of RecordIds.
+     */
+    static uint64_t toKey(const RecordId& rid) {
+        return static_cast<uint64_t>(rid.repr()) ^ (1ULL << 63);
+    }
+
+    // Indexed by the high 48 bits of the key.
+    std::map<uint64_t, Container> _containers;
+
+    size_t _size = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdBitmapTest, AddRemoveAndContains) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    ASSERT_TRUE(bitmap.add(RecordId(5)));
+    ASSERT_FALSE(bitmap.add(RecordId(5)));
+    ASSERT_TRUE(bitmap.add(RecordId(1 << 20)));
+    ASSERT_TRUE(bitmap.add(RecordId(-3)));
+    ASSERT_EQ(bitmap.size(), 3U);
+
+    ASSERT_TRUE(bitmap.contains(RecordId(5)));
+    ASSERT_TRUE(bitmap.contains(RecordId(1 << 20)));
+    ASSERT_TRUE(bitmap.contains(RecordId(-3)));
+    ASSERT_FALSE(bitmap.contains(RecordId(6)));
+    ASSERT_FALSE(bitmap.contains(RecordId(3)));
+
+    ASSERT_TRUE(bitmap.remove(RecordId(5)));
+    ASSERT_FALSE(bitmap.remove(RecordId(5)));
+    ASSERT_FALSE(bitmap.contains(RecordId(5)));
+    ASSERT_EQ(bitmap.size(), 2U);
+}
+
+TEST(RecordIdBitmapTest, DenseChunksSwitchToBitsetsAndBack) {
+    RecordIdBitmap bitmap;
+    const long long numIds = 3 * RecordIdBitmap::kMaxArrayCardinality;
+    for (long long i = 1; i <= numIds; ++i) {
+        ASSERT_TRUE(bitmap.add(RecordId(i)));
+    }
+    ASSERT_EQ(bitmap.size(), static_cast<size_t>(numIds));
+
+    // A full bitset chunk is 8KB, far less than the 2 bytes per id of a sorted array.
+    ASSERT_LT(bitmap.getMemUsage(), 2 * 8192U);
+
+    for (long long i = 1; i <= numIds; i += 2) {
+        ASSERT_TRUE(bitmap.remove(RecordId(i)));
+    }
+    for (long long i = 1; i <= numIds; ++i) {
+        ASSERT_EQ(bitmap.contains(RecordId(i)), i % 2 == 0);
+    }
+    ASSERT_EQ(bitmap.size(), static_cast<size_t>(numIds / 2));
+}
+
+TEST(RecordIdBitmapTest, IntersectMatchesSetIntersection) {
+    RecordIdBitmap multiplesOfTwo;
+    RecordIdBitmap multiplesOfThree;
+    std::set<long long> expected;
+
+    // Cover sparse chunks, dense chunks and chunks present on only one side.
+    for (long long i = 1; i < 200 * 1000; ++i) {
+        const bool inFirst = (i % 2 == 0) && (i < 150 * 1000);
+        const bool inSecond = (i % 3 == 0) || (i > 180 * 1000 && i % 97 == 0);
+        if (inFirst) {
+            multiplesOfTwo.add(RecordId(i));
+        }
+        if (inSecond) {
+            multiplesOfThree.add(RecordId(i));
+        }
+        if (inFirst && inSecond) {
+            expected.insert(i);
+        }
+    }
+
+    multiplesOfTwo.intersectWith(multiplesOfThree);
+    ASSERT_EQ(multiplesOfTwo.size(), expected.size());
+    for (long long i = 1; i < 200 * 1000; ++i) {
+        ASSERT_EQ(multiplesOfTwo.contains(RecordId(i)), expected.count(i) == 1);
+    }
+}
+
+TEST(RecordIdBitmapTest, IntersectWithEmptyBitmapIsEmpty) {
+    RecordIdBitmap bitmap;
+    bitmap.add(RecordId(1));
+    bitmap.add(RecordId(100 * 1000));
+
+    bitmap.intersectWith(RecordIdBitmap());
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(1)));
+}
+
+}  // namespace
+}  // namespace mongo
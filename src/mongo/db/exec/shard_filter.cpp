@@ -77,7 +77,7 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
         if (_metadata->isSharded()) {
-            ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
+            const auto& shardKeyPattern = _metadata->getChunkManager()->getShardKeyPattern();
             WorkingSetMember* member = _ws->get(*out);
             WorkingSetMatchableDocument matchable(member);
             BSONObj shardKey = shardKeyPattern.extractShardKeyFromMatchable(matchable);
@@ -41,6 +41,8 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -51,6 +53,41 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// Field names of the values stored in the spill sorter.
+const char kSpillRecordIdField[] = "r";
+const char kSpillObjField[] = "o";
+const char kSpillTextScoreField[] = "t";
+const char kSpillGeoDistanceField[] = "d";
+const char kSpillGeoNearPointField[] = "p";
+
+/**
+ * Orders spilled data the same way WorkingSetComparator orders buffered data: by sort key, then by
+ * RecordId.
+ */
+class SpillComparator {
+public:
+    explicit SpillComparator(BSONObj pattern) : _pattern(std::move(pattern)) {}
+
+    int operator()(const std::pair<BSONObj, BSONObj>& lhs,
+                   const std::pair<BSONObj, BSONObj>& rhs) const {
+        // False means ignore field names.
+        int result = lhs.first.woCompare(rhs.first, _pattern, false);
+        if (0 != result) {
+            return result;
+        }
+        const long long lhsId = lhs.second[kSpillRecordIdField].numberLong();
+        const long long rhsId = rhs.second[kSpillRecordIdField].numberLong();
+        return lhsId < rhsId ? -1 : (lhsId > rhsId ? 1 : 0);
+    }
+
+private:
+    BSONObj _pattern;
+};
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
@@ -58,8 +95,13 @@ SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
-    // False means ignore field names.
-    int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
+    int result;
+    if (!lhs.encodedSortKey.empty() && !rhs.encodedSortKey.empty()) {
+        result = lhs.encodedSortKey.compare(rhs.encodedSortKey);
+    } else {
+        // False means ignore field names.
+        result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
+    }
     if (0 != result) {
         return result < 0;
     }
@@ -76,6 +118,7 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -84,11 +127,8 @@ SortStage::SortStage(OperationContext* opCtx,
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
 
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
+    if (internalQueryExecSortUseKeyStrings.load() && sortComparator.nFields() <= 32) {
+        _keyStringOrdering = Ordering::make(sortComparator);
     }
 }
 
@@ -97,12 +137,17 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _spillIterator ? !_spillIterator->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
+    if (_memUsage > maxBytes && _allowDiskUse) {
+        spill();
+    } else if (_memUsage > maxBytes) {
         mongoutils::str::stream ss;
         ss << "Sort operation used more than the maximum " << maxBytes
            << " bytes of RAM. Add an index, or specify a smaller limit.";
@@ -148,14 +193,37 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
+            if (_spillSorter) {
+                // Once we have spilled, the sorter owns all remaining input.
+                addToSpillSorter(member, item.sortKey, item.recordId);
+                if (member->hasRecordId()) {
+                    _wsidByRecordId.erase(member->recordId);
+                }
+                _ws->free(id);
+                return PlanStage::NEED_TIME;
+            }
+
+            if (_keyStringOrdering) {
+                // The sort keys already reflect the collation, so their KeyString encodings compare
+                // exactly as woCompare() compares the keys themselves.
+                KeyString encoded(KeyString::Version::V1, item.sortKey, *_keyStringOrdering);
+                item.encodedSortKey.assign(encoded.getBuffer(), encoded.getSize());
+            }
+
             addToBuffer(item);
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
-            _resultIterator = _data.begin();
+            if (_spillSorter) {
+                _specificStats.spills = _spillSorter->numFiles();
+                _spillIterator.reset(_spillSorter->done());
+                _spillSorter.reset();
+            } else {
+                sortBuffer();
+                _resultIterator = _data.begin();
+            }
             _sorted = true;
             return PlanStage::NEED_TIME;
         } else if (PlanStage::FAILURE == code || PlanStage::DEAD == code) {
@@ -172,8 +240,13 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+    if (_spillIterator) {
+        *out = restoreFromSpill(_spillIterator->next());
+        return PlanStage::ADVANCED;
+    }
+
+    verify(_resultIterator != _data.end());
     *out = _resultIterator->wsid;
     _resultIterator++;
 
@@ -215,7 +288,7 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
     _specificStats.memLimit = maxBytes;
-    _specificStats.memUsage = _memUsage;
+    _specificStats.memUsage = _spillSorter ? _spillSorter->memUsed() : _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
 
@@ -244,10 +317,10 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     Updates memory usage if item was replaced.
  *     sortBuffer() - Does nothing.
  * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ *     addToBuffer() - Pushes item onto a max-heap kept in the vector.
+ *                     If size of heap exceeds limit, pop the item with
+ *                     the highest key. Updates memory usage accordingly.
+ *     sortBuffer() - Sorts the heap in place.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
     // Holds ID of working set member to be freed at end of this function.
@@ -258,12 +331,12 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
         _data.push_back(item);
-        _memUsage += member->getMemUsage();
+        _memUsage += member->getMemUsage() + item.encodedSortKey.size();
     } else if (_limit == 1) {
         if (_data.empty()) {
             member->makeObjOwnedIfNeeded();
             _data.push_back(item);
-            _memUsage = member->getMemUsage();
+            _memUsage = member->getMemUsage() + item.encodedSortKey.size();
             return;
         }
         wsidToFree = item.wsid;
@@ -273,36 +346,31 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             wsidToFree = _data[0].wsid;
             member->makeObjOwnedIfNeeded();
             _data[0] = item;
-            _memUsage = member->getMemUsage();
+            _memUsage = member->getMemUsage() + item.encodedSortKey.size();
         }
     } else {
-        // Update data item set instead of vector
-        // Limit not reached - insert and return
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        // Limit not reached - push onto the heap and return
         vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
+        if (_data.size() < limit) {
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
+            _data.push_back(item);
+            std::push_heap(_data.begin(), _data.end(), cmp);
+            _memUsage += member->getMemUsage() + item.encodedSortKey.size();
             return;
         }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+        // Limit will be exceeded - compare with the item with the highest key, which is at the
+        // top of the heap. If the new item does not have a lower key, do nothing.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
+        if (cmp(item, _data.front())) {
+            std::pop_heap(_data.begin(), _data.end(), cmp);
+            SortableDataItem& lastItem = _data.back();
+            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage() + lastItem.encodedSortKey.size();
+            _memUsage += member->getMemUsage() + item.encodedSortKey.size();
             wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            lastItem = item;
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
     }
 
@@ -325,13 +393,83 @@ void SortStage::sortBuffer() {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        std::sort_heap(_data.begin(), _data.end(), cmp);
+    }
+}
+
+void SortStage::spill() {
+    invariant(!_sorted);
+
+    if (!_spillSorter) {
+        const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+        SortOptions opts = SortOptions()
+                               .Limit(_limit)
+                               .MaxMemoryUsageBytes(maxBytes)
+                               .ExtSortAllowed()
+                               .TempDir(storageGlobalParams.dbpath + "/_tmp");
+        _spillSorter.reset(SpillSorter::make(opts, SpillComparator(_sortKeyComparator->pattern)));
+        _specificStats.usedDisk = true;
+    }
+
+    for (auto&& item : _data) {
+        WorkingSetMember* member = _ws->get(item.wsid);
+        addToSpillSorter(member, item.sortKey, item.recordId);
+        if (member->hasRecordId()) {
+            _wsidByRecordId.erase(member->recordId);
+        }
+        _ws->free(item.wsid);
     }
+    _data.clear();
+    _memUsage = 0;
+}
+
+void SortStage::addToSpillSorter(WorkingSetMember* member,
+                                 const BSONObj& sortKey,
+                                 const RecordId& recordId) {
+    BSONObjBuilder bob;
+    bob.append(kSpillRecordIdField, static_cast<long long>(recordId.repr()));
+    bob.append(kSpillObjField, member->obj.value());
+    if (member->hasComputed(WSM_COMPUTED_TEXT_SCORE)) {
+        auto score = static_cast<const TextScoreComputedData*>(
+            member->getComputed(WSM_COMPUTED_TEXT_SCORE));
+        bob.append(kSpillTextScoreField, score->getScore());
+    }
+    if (member->hasComputed(WSM_COMPUTED_GEO_DISTANCE)) {
+        auto dist = static_cast<const GeoDistanceComputedData*>(
+            member->getComputed(WSM_COMPUTED_GEO_DISTANCE));
+        bob.append(kSpillGeoDistanceField, dist->getDist());
+    }
+    if (member->hasComputed(WSM_GEO_NEAR_POINT)) {
+        auto point =
+            static_cast<const GeoNearPointComputedData*>(member->getComputed(WSM_GEO_NEAR_POINT));
+        bob.append(kSpillGeoNearPointField, point->getPoint());
+    }
+    _spillSorter->add(sortKey, bob.obj());
+}
+
+WorkingSetID SortStage::restoreFromSpill(const SpillSorter::Data& data) {
+    const BSONObj& value = data.second;
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), value[kSpillObjField].Obj().getOwned());
+    _ws->transitionToOwnedObj(id);
+
+    member->addComputed(new SortKeyComputedData(data.first));
+    if (BSONElement score = value[kSpillTextScoreField]) {
+        member->addComputed(new TextScoreComputedData(score.numberDouble()));
+    }
+    if (BSONElement dist = value[kSpillGeoDistanceField]) {
+        member->addComputed(new GeoDistanceComputedData(dist.numberDouble()));
+    }
+    if (BSONElement point = value[kSpillGeoNearPointField]) {
+        member->addComputed(new GeoNearPointComputedData(point.Obj()));
+    }
+    return id;
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
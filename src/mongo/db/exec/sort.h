@@ -28,7 +28,8 @@
 
 #pragma once
 
-#include <set>
+#include <boost/optional.hpp>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -37,6 +38,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +48,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,11 +58,20 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, data which exceeds the memory limit is spilled to disk rather than failing the
+    // sort.
+    bool allowDiskUse;
 };
 
 /**
  * Sorts the input received from the child according to the sort pattern provided.
  *
+ * Results are buffered in memory up to internalQueryExecMaxBlockingSortBytes. Beyond that the
+ * sort fails, unless 'allowDiskUse' is set, in which case the buffered results and all remaining
+ * input are handed to an external Sorter that spills sorted runs to temporary files and merges
+ * them. Results that have been spilled are returned as owned objects without a RecordId.
+ *
  * Preconditions:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
@@ -106,6 +117,9 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether we may spill to disk once the memory limit is exceeded.
+    const bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -118,6 +132,9 @@ private:
     struct SortableDataItem {
         WorkingSetID wsid;
         BSONObj sortKey;
+        // 'sortKey' encoded as a KeyString under the sort pattern's ordering, or empty when the
+        // stage compares the BSON sort keys. An encoded key is never empty.
+        std::string encodedSortKey;
         // Since we must replicate the behavior of a covered sort as much as possible we use the
         // RecordId to break sortKey ties.
         // See sorta.js.
@@ -126,7 +143,8 @@ private:
 
     // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
     // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // BSONObj::woCompare() with RecordId as a tie-breaker. When both items carry an encoded sort
+    // key, the encodings are compared bytewise instead, which orders them identically.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
@@ -138,8 +156,12 @@ private:
         BSONObj pattern;
     };
 
+    // Sorts spilled data. Keys are sort keys. Values hold the document, the RecordId used to
+    // break ties and whatever computed data later stages may need.
+    typedef Sorter<BSONObj, BSONObj> SpillSorter;
+
     /**
-     * Inserts one item into data buffer (vector or set).
+     * Inserts one item into data buffer.
      * If limit is exceeded, remove item with lowest key.
      */
     void addToBuffer(const SortableDataItem& item);
@@ -147,29 +169,52 @@ private:
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
+    /**
+     * Moves everything buffered in memory into '_spillSorter', creating it, and frees the
+     * corresponding working set members. All subsequent input goes to '_spillSorter'.
+     */
+    void spill();
+
+    /**
+     * Adds the data of 'member' to '_spillSorter'. 'recordId' is used to break ties.
+     */
+    void addToSpillSorter(WorkingSetMember* member,
+                          const BSONObj& sortKey,
+                          const RecordId& recordId);
+
+    /**
+     * Returns a new owned-object working set member holding a result read back from the sorter.
+     */
+    WorkingSetID restoreFromSpill(const SpillSorter::Data& data);
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // Set when sort keys are encoded as KeyStrings before being buffered. Only patterns with at
+    // most 32 fields can be expressed as an Ordering.
+    boost::optional<Ordering> _keyStringOrdering;
+
     // The data we buffer and sort.
     // _data will contain sorted data when all data is gathered
     // and sorted.
     // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data is kept as a max-heap of at most _limit items, so that the item with the highest
+    // key can be evicted in logarithmic time without any per-item allocation.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // Non-null once we have spilled and until input is exhausted.
+    std::unique_ptr<SpillSorter> _spillSorter;
+
+    // Non-null if we spilled and are returning results from the sorter.
+    std::unique_ptr<SpillSorter::Iterator> _spillIterator;
+
     // We buffer a lot of data and we want to look it up by RecordId quickly upon invalidation.
     typedef stdx::unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByRecordId;
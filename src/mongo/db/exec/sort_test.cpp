@@ -37,12 +37,14 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/collation/collator_factory_mock.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -289,4 +291,36 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+TEST_F(SortStageTest, SortWithKeyStringsMatchesBSONOrder) {
+    internalQueryExecSortUseKeyStrings.store(true);
+    ON_BLOCK_EXIT([] { internalQueryExecSortUseKeyStrings.store(false); });
+
+    const char* input =
+        "{input: [{a: 'b', b: 2}, {a: 1.5, b: 1}, {b: 3}, {a: {x: 1}, b: 0}, {a: 2, b: 5},"
+        " {a: NumberLong(2), b: 4}, {a: null, b: 1}, {a: 'b', b: 7}]}";
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             0,
+             input,
+             "{output: [{b: 3}, {a: null, b: 1}, {a: 1.5, b: 1}, {a: 2, b: 5},"
+             " {a: NumberLong(2), b: 4}, {a: 'b', b: 7}, {a: 'b', b: 2}, {a: {x: 1}, b: 0}]}");
+    testWork("{a: -1, b: 1}",
+             nullptr,
+             3,
+             input,
+             "{output: [{a: {x: 1}, b: 0}, {a: 'b', b: 2}, {a: 'b', b: 7}]}");
+}
+
+TEST_F(SortStageTest, SortWithKeyStringsAndCollation) {
+    internalQueryExecSortUseKeyStrings.store(true);
+    ON_BLOCK_EXIT([] { internalQueryExecSortUseKeyStrings.store(false); });
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testWork("{a: 1}",
+             &collator,
+             0,
+             "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
+             "{output: [{a: 'aa'}, {a: 'ba'}, {a: 'ab'}]}");
+}
 }  // namespace
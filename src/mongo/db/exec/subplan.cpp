@@ -42,6 +42,7 @@
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/stdx/memory.h"
@@ -112,6 +113,9 @@ Status SubplanStage::planSubqueries() {
         LOG(5) << "Subplanner: index " << i << " is " << ie;
     }
 
+    const bool shareBranchPlans = internalQuerySubplannerShareBranchPlans.load();
+    std::map<PlanCacheKey, size_t> branchByShape;
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         // We need a place to shove the results from planning this branch.
         _branchResults.push_back(stdx::make_unique<BranchPlanningResult>());
@@ -133,6 +137,22 @@ Status SubplanStage::planSubqueries() {
         // Plan the i-th child. We might be able to find a plan for the i-th child in the plan
         // cache. If there's no cached plan, then we generate and rank plans using the MPS.
         const auto* planCache = _collection->infoCache()->getPlanCache();
+
+        // Branches which differ only in their constants share a plan cache key. Ranking plans
+        // for each of them would repeat the same trial, so we let later branches reuse the index
+        // assignment chosen for the first branch with their shape.
+        if (shareBranchPlans) {
+            const auto key = planCache->computeKey(*branchResult->canonicalQuery);
+            auto firstWithShape = branchByShape.find(key);
+            if (firstWithShape != branchByShape.end()) {
+                LOG(5) << "Subplanner: child " << i << " has the same shape as child "
+                       << firstWithShape->second;
+                branchResult->sameShapeAs = firstWithShape->second;
+                continue;
+            }
+            branchByShape.emplace(key, i);
+        }
+
         if (auto cachedSol = planCache->getCacheEntryIfCacheable(*branchResult->canonicalQuery)) {
             // We have a CachedSolution. Store it for later.
             LOG(5) << "Subplanner: cached plan found for child " << i << " of "
@@ -221,7 +241,18 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
         MatchExpression* orChild = _orExpression->getChild(i);
         BranchPlanningResult* branchResult = _branchResults[i].get();
 
-        if (branchResult->cachedSolution.get()) {
+        if (branchResult->sameShapeAs) {
+            // Branches only refer to earlier branches, which have already been assigned indexes.
+            const auto* siblingTree = _branchResults[*branchResult->sameShapeAs]->chosenTree.get();
+            invariant(siblingTree);
+            Status tagStatus = QueryPlanner::tagAccordingToCache(orChild, siblingTree, _indexMap);
+            if (!tagStatus.isOK()) {
+                mongoutils::str::stream ss;
+                ss << "Failed to extract indices from subchild " << orChild->toString();
+                return Status(ErrorCodes::BadValue, ss);
+            }
+            cacheData->children.push_back(siblingTree->clone());
+        } else if (branchResult->cachedSolution.get()) {
             // We can get the index tags we need out of the cache.
             Status tagStatus = tagOrChildAccordingToCache(
                 cacheData.get(), branchResult->cachedSolution->plannerData[0], orChild, _indexMap);
@@ -314,6 +345,8 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
 
             cacheData->children.push_back(bestSoln->cacheData->tree->clone());
         }
+
+        branchResult->chosenTree.reset(cacheData->children.back()->clone());
     }
 
     // Must do this before using the planner functionality.
@@ -481,6 +514,10 @@ bool SubplanStage::branchPlannedFromCache(size_t i) const {
     return NULL != _branchResults[i]->cachedSolution.get();
 }
 
+bool SubplanStage::branchPlannedFromSibling(size_t i) const {
+    return static_cast<bool>(_branchResults[i]->sameShapeAs);
+}
+
 const SpecificStats* SubplanStage::getSpecificStats() const {
     return NULL;
 }
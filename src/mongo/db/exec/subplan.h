@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <string>
 #include <vector>
@@ -117,6 +118,12 @@ public:
      */
     bool branchPlannedFromCache(size_t i) const;
 
+    /**
+     * Returns true if the i-th branch reused the index assignment chosen for an earlier branch
+     * with the same plan cache key, otherwise returns false.
+     */
+    bool branchPlannedFromSibling(size_t i) const;
+
     /**
      * Provide access to the query solution for our composite solution. Does not relinquish
      * ownership.
@@ -147,6 +154,15 @@ private:
 
         // Query solutions resulting from planning the $or branch.
         std::vector<std::unique_ptr<QuerySolution>> solutions;
+
+        // If an earlier branch of the $or has the same plan cache key as this one, the index of
+        // that branch. The index assignment chosen for the earlier branch is reused for this one
+        // instead of ranking this branch's candidate plans again.
+        boost::optional<size_t> sameShapeAs;
+
+        // The index assignment chosen for this branch, kept so that later branches with the same
+        // shape can reuse it.
+        std::unique_ptr<PlanCacheIndexTree> chosenTree;
     };
 
     /**
@@ -125,6 +125,15 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
 
         textScorer->addChildren(std::move(indexScanList));
 
+        // The TEXT_MATCH stage passes every document containing a positive term unless the query
+        // has negations or phrases, or is case or diacritic sensitive, so the TEXT_OR stage may
+        // produce just the best scoring documents.
+        if (_params.topK && _params.query.getNegatedTerms().empty() &&
+            _params.query.getPositivePhr().empty() && _params.query.getNegatedPhr().empty() &&
+            !_params.query.getCaseSensitive() && !_params.query.getDiacriticSensitive()) {
+            textScorer->setTopK(_params.topK, _params.query.getTermsForBounds());
+        }
+
         textMatchStage = make_unique<TextMatchStage>(
             opCtx, std::move(textScorer), _params.query, _params.spec, ws);
     } else {
@@ -29,6 +29,7 @@
 #include "mongo/db/exec/text_or.h"
 
 #include <map>
+#include <numeric>
 #include <vector>
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -50,6 +51,8 @@ using std::string;
 using stdx::make_unique;
 
 using fts::FTSSpec;
+using fts::MAX_WEIGHT;
+using fts::TermFrequencyMap;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
@@ -78,6 +81,15 @@ void TextOrStage::addChildren(Children childrenToAdd) {
                      std::make_move_iterator(childrenToAdd.end()));
 }
 
+void TextOrStage::setTopK(size_t k, std::set<std::string> terms) {
+    invariant(k > 0);
+    _topK = k;
+    _topKTerms = std::move(terms);
+    _termScoreBounds.assign(_children.size(), MAX_WEIGHT);
+    _childEOF.assign(_children.size(), false);
+    _specificStats.topK = k;
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -108,6 +120,9 @@ void TextOrStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inva
     // Remove the RecordID from the ScoreMap.
     ScoreMap::iterator scoreIt = _scores.find(dl);
     if (scoreIt != _scores.end()) {
+        if (_topK && scoreIt->second.wsid != WorkingSet::INVALID_ID) {
+            _topKDocs.erase(std::make_pair(scoreIt->second.score, dl));
+        }
         if (scoreIt == _scoreIterator) {
             _scoreIterator++;
         }
@@ -197,10 +212,39 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        StageState addState = addTerm(id, out);
+        if (!_topK || PlanStage::NEED_TIME != addState) {
+            return addState;
+        }
+
+        if (topKComplete()) {
+            _specificStats.stoppedEarly = true;
+            _scoreIterator = _scores.begin();
+            _internalState = State::kReturningResults;
+            return PlanStage::NEED_TIME;
+        }
+
+        // Read the next entry of the next term that has any left.
+        do {
+            _currentChild = (_currentChild + 1) % _children.size();
+        } while (_childEOF[_currentChild]);
+        return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
-        ++_currentChild;
+        if (_topK) {
+            _childEOF[_currentChild] = true;
+            _termScoreBounds[_currentChild] = 0;
+            for (size_t i = 1; i < _children.size(); ++i) {
+                size_t next = (_currentChild + i) % _children.size();
+                if (!_childEOF[next]) {
+                    _currentChild = next;
+                    return PlanStage::NEED_TIME;
+                }
+            }
+            _currentChild = _children.size();
+        } else {
+            ++_currentChild;
+        }
 
         if (_currentChild < _children.size()) {
             // We have another child to read from.
@@ -261,6 +305,11 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
     invariant(1 == wsm->keyData.size());
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
+    const double documentTermScore = getTermScore(newKeyData.keyData);
+    if (_topK) {
+        // No later entry for this term scores higher.
+        _termScoreBounds[_currentChild] = documentTermScore;
+    }
     TextRecordData* textRecordData = &_scores[wsm->recordId];
 
     if (textRecordData->score < 0) {
@@ -300,6 +349,15 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         wsm->makeObjOwnedIfNeeded();
+
+        if (_topK) {
+            addTopKCandidate(wsm->recordId);
+            return NEED_TIME;
+        }
+    } else if (_topK) {
+        // The document was scored for all of the terms when we first saw it.
+        _ws->free(wsid);
+        return NEED_TIME;
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -310,8 +368,14 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
+    // Aggregate relevance score, term keys.
+    textRecordData->score += documentTermScore;
+    return NEED_TIME;
+}
+
+double TextOrStage::getTermScore(const BSONObj& keyData) const {
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
+    BSONObjIterator keyIt(keyData);
     for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
         keyIt.next();
     }
@@ -319,11 +383,53 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     keyIt.next();  // Skip past 'term'.
 
     BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    return scoreElement.number();
+}
 
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
-    return NEED_TIME;
+void TextOrStage::addTopKCandidate(const RecordId& recordId) {
+    TextRecordData* textRecordData = &_scores[recordId];
+
+    // Score the document for every term now, since we may stop before reading its other entries.
+    // These are the scores that the index keys for the document hold.
+    TermFrequencyMap termScores;
+    _ftsSpec.scoreDocument(_ws->get(textRecordData->wsid)->obj.value(), &termScores);
+    double score = 0;
+    for (const auto& term : _topKTerms) {
+        auto termScore = termScores.find(term);
+        if (termScore != termScores.end()) {
+            score += termScore->second;
+        }
+    }
+
+    if (_topKDocs.size() == _topK) {
+        if (score <= _topKDocs.begin()->first) {
+            _ws->free(textRecordData->wsid);
+            textRecordData->wsid = WorkingSet::INVALID_ID;
+            textRecordData->score = -1;
+            return;
+        }
+
+        // Discard the worst of the best documents to make room.
+        TextRecordData* discarded = &_scores[_topKDocs.begin()->second];
+        _ws->free(discarded->wsid);
+        discarded->wsid = WorkingSet::INVALID_ID;
+        discarded->score = -1;
+        _topKDocs.erase(_topKDocs.begin());
+    }
+
+    textRecordData->score = score;
+    _topKDocs.emplace(score, recordId);
+}
+
+bool TextOrStage::topKComplete() const {
+    if (_topKDocs.size() < _topK) {
+        return false;
+    }
+
+    // An unseen document scores at most the sum of the current bounds of the terms.
+    const double maxUnseenScore =
+        std::accumulate(_termScoreBounds.begin(), _termScoreBounds.end(), 0.0);
+    return _topKDocs.begin()->first >= maxUnseenScore;
 }
 
 }  // namespace mongo
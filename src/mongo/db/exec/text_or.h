@@ -29,6 +29,10 @@
 #pragma once
 
 #include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -48,6 +52,9 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If only the K best scoring documents are needed, see setTopK(), the stage reads the terms in turn
+ * and stops once no document it has not seen can score above the K best it has.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -79,6 +86,13 @@ public:
 
     void addChildren(Children childrenToAdd);
 
+    /**
+     * Limits the results to the 'k' documents with the highest scores for 'terms', the terms our
+     * children scan for. Each child must return the entries for its term in decreasing order of
+     * score. Must be called after the children are added.
+     */
+    void setTopK(size_t k, std::set<std::string> terms);
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -118,6 +132,24 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Returns the score of the term in the text index key 'keyData'.
+     */
+    double getTermScore(const BSONObj& keyData) const;
+
+    /**
+     * Helper called from addTerm when only the best _topK documents are needed. Scores the newly
+     * fetched document with RecordId 'recordId' for all of the terms, and keeps it if it is among
+     * the best _topK documents seen so far. Discards it or the worst of them otherwise.
+     */
+    void addTopKCandidate(const RecordId& recordId);
+
+    /**
+     * Returns true if no document that we have not seen can score higher than the worst of the
+     * best _topK documents.
+     */
+    bool topKComplete() const;
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -150,6 +182,18 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // When non-zero, only the _topK documents with the highest scores for _topKTerms are returned.
+    size_t _topK = 0;
+    std::set<std::string> _topKTerms;
+
+    // The best _topK documents seen so far, by score.
+    std::set<std::pair<double, RecordId>> _topKDocs;
+
+    // For each child, the score of the last entry that it returned, which no later entry exceeds,
+    // and whether it is EOF.
+    std::vector<double> _termScoreBounds;
+    std::vector<bool> _childEOF;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -43,6 +43,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -173,7 +174,11 @@ UpdateStage::UpdateStage(OperationContext* opCtx,
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : NULL),
-      _doc(params.driver->getDocument()) {
+      _doc(params.driver->getDocument()),
+      _batchMaxBytes(params.request->isMulti() && !params.request->shouldReturnAnyDocs() &&
+                             !params.request->isExplain()
+                         ? internalQueryMultiUpdateBatchMaxBytes.load()
+                         : 0) {
     _children.emplace_back(child);
 
     // Should the modifiers validate their embedded docs via storage_validation::storageValid()?
@@ -204,10 +209,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // is needed to accomodate the new bson layout of the resulting document. In any event,
     // only enable in-place mutations if the underlying storage engine offers support for
     // writing damage events.
-    _doc.reset(oldObj.value(),
-               (_collection->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
+    const bool damagesSupported = _collection->updateWithDamagesSupported();
 
     BSONObj logObj;
 
@@ -227,48 +229,72 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
         immutablePaths.keepShortest(&idFieldRef);
     }
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(
-            StringData(), &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
-    } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
 
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+    // Updates of top-level fields can be applied to the document's BSON directly, without
+    // building '_doc'.
+    BSONObj directlyUpdatedObj;
+    const bool updatedDirectly =
+        driver->updateTopLevelFields(oldObj.value(),
+                                     immutablePaths,
+                                     &directlyUpdatedObj,
+                                     &logObj,
+                                     &docWasModified,
+                                     damagesSupported ? &_damages : nullptr);
+
+    if (!updatedDirectly) {
+        _doc.reset(oldObj.value(),
+                   (damagesSupported ? mutablebson::Document::kInPlaceEnabled
+                                     : mutablebson::Document::kInPlaceDisabled));
+
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status = driver->update(
+                StringData(), &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
 
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
 
-        status = driver->update(
-            matchedField, &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
-    }
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
 
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
-    }
+            status = driver->update(
+                matchedField, &_doc, validateForStorage, immutablePaths, &logObj, &docWasModified);
+        }
+
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-    // Skip adding _id field if the collection is capped (since capped collection documents can
-    // neither grow nor shrink).
-    const auto createIdField = !_collection->isCapped();
+        // Skip adding _id field if the collection is capped (since capped collection documents can
+        // neither grow nor shrink).
+        const auto createIdField = !_collection->isCapped();
 
-    // Ensure if _id exists it is first
-    status = ensureIdFieldIsFirst(&_doc);
-    if (status.code() == ErrorCodes::InvalidIdField) {
-        // Create ObjectId _id field if we are doing that
-        if (createIdField) {
-            addObjectIDIdField(&_doc);
+        // Ensure if _id exists it is first
+        status = ensureIdFieldIsFirst(&_doc);
+        if (status.code() == ErrorCodes::InvalidIdField) {
+            // Create ObjectId _id field if we are doing that
+            if (createIdField) {
+                addObjectIDIdField(&_doc);
+            }
+        } else {
+            uassertStatusOK(status);
         }
-    } else {
-        uassertStatusOK(status);
     }
 
     // See if the changes were applied in place
     const char* source = NULL;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    bool inPlace;
+    if (updatedDirectly) {
+        inPlace = damagesSupported && !_damages.empty();
+        source = directlyUpdatedObj.objdata();
+    } else {
+        inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    }
 
     if (inPlace && _damages.empty()) {
         // An interesting edge case. A modifier didn't notice that it was really a no-op
@@ -323,7 +349,7 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         } else {
             // The updates were not in place. Apply them through the file manager.
 
-            newObj = _doc.getObject();
+            newObj = updatedDirectly ? directlyUpdatedObj : _doc.getObject();
             uassert(17419,
                     str::stream() << "Resulting document after update is larger than "
                                   << BSONObjMaxUserSize,
@@ -351,15 +377,20 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         // it again.  For an example, see the comment above near declaration of
         // updatedRecordIds.
         //
-        // This must be done after the wunit commits so we are sure we won't be rolling back.
+        // This must be done after the wunit commits so we are sure we won't be rolling back. A
+        // batch of updates commits later, so it remembers what to remove if it rolls back.
         if (_updatedRecordIds && (newRecordId != recordId || driver->modsAffectIndices())) {
-            _updatedRecordIds->insert(newRecordId);
+            if (_updatedRecordIds->insert(newRecordId).second && !_batch.empty()) {
+                _batchUpdatedRecordIds.push_back(newRecordId);
+            }
         }
     }
 
     // Only record doc modifications if they wrote (exclude no-ops). Explains get
     // recorded as if they wrote.
     if (docWasModified || request->isExplain()) {
+        _specificStats.inPlaceUpdate =
+            inPlace && (_specificStats.nModified == 0 || _specificStats.inPlaceUpdate);
         _specificStats.nModified++;
     }
 
@@ -486,6 +517,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _batch.empty() &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -555,6 +587,10 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         return PlanStage::ADVANCED;
     }
 
+    if (_batchMaxBytes > 0) {
+        return doBatchedWork(out);
+    }
+
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
@@ -614,11 +650,8 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
-        // Ensure that the BSONObj underlying the WorkingSetMember is owned because saveState()
-        // is allowed to free the memory.
-        member->makeObjOwnedIfNeeded();
-
-        // Save state before making changes
+        // Save state before making changes. This also takes ownership of the BSONObj underlying
+        // the WorkingSetMember, since saveState() is allowed to free the memory.
         WorkingSetCommon::prepareForSnapshotChange(_ws);
         try {
             child()->saveState();
@@ -711,6 +744,166 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState UpdateStage::doBatchedWork(WorkingSetID* out) {
+    if (!_batchRetrying) {
+        invariant(_batch.empty());
+
+        // Gather the batch within this call, so that no yield can happen between reading the
+        // documents and updating them. Our child is worked no more often than the plan yields, so
+        // that a plan whose child skips most of what it reads still yields as often as it would.
+        const size_t maxWorks = std::max(1, internalQueryExecYieldIterations.load());
+        size_t batchBytes = 0;
+        for (size_t works = 0; works < maxWorks && batchBytes < _batchMaxBytes; ++works) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            auto status = child()->work(&id);
+
+            if (status == PlanStage::ADVANCED) {
+                WorkingSetMember* member = _ws->get(id);
+                if (!member->hasRecordId()) {
+                    // We expect to be here because of an invalidation causing a force-fetch.
+                    ++_specificStats.nInvalidateSkips;
+                    _ws->free(id);
+                    continue;
+                }
+
+                // Updates can't have projections, so we should always get fetched data.
+                invariant(member->hasObj());
+
+                if (_updatedRecordIds->count(member->recordId) > 0) {
+                    // Found a RecordId that refers to a document we had already updated.
+                    _ws->free(id);
+                    continue;
+                }
+
+                // Reading the next documents from our child may free the memory of this one.
+                member->makeObjOwnedIfNeeded();
+                batchBytes += member->obj.value().objsize();
+                _batch.push_back(id);
+                continue;
+            }
+            if (status == PlanStage::NEED_TIME) {
+                continue;
+            }
+            if (status == PlanStage::IS_EOF) {
+                break;
+            }
+            if (status == PlanStage::NEED_YIELD) {
+                // The documents gathered so far are rechecked and updated after the yield.
+                _batchRetrying = !_batch.empty();
+                *out = id;
+                return status;
+            }
+
+            invariant(status == PlanStage::FAILURE || status == PlanStage::DEAD);
+            for (auto batchId : _batch) {
+                _ws->free(batchId);
+            }
+            _batch.clear();
+            *out = id;
+            // If a stage fails, it may create a status WSM to indicate why it failed, in which
+            // case 'id' is valid. If ID is invalid, we create our own error message.
+            if (WorkingSet::INVALID_ID == id) {
+                const std::string errmsg = "update stage failed to read in results from child";
+                *out = WorkingSetCommon::allocateStatusMember(
+                    _ws, Status(ErrorCodes::InternalError, errmsg));
+                return PlanStage::FAILURE;
+            }
+            return status;
+        }
+    }
+
+    // Ensure each document still exists and matches the predicate, keeping those which do at the
+    // front of the batch.
+    size_t numMatching = 0;
+    for (size_t i = 0; i < _batch.size(); ++i) {
+        WorkingSetID id = _batch[i];
+        if (!_ws->get(id)->hasRecordId()) {
+            ++_specificStats.nInvalidateSkips;
+            _ws->free(id);
+            continue;
+        }
+
+        bool docStillMatches;
+        try {
+            docStillMatches = write_stage_common::ensureStillMatches(
+                _collection, getOpCtx(), _ws, id, _params.canonicalQuery);
+        } catch (const WriteConflictException&) {
+            // Keep the documents checked so far and the rest of the batch, and retry them all.
+            _batch.erase(_batch.begin() + numMatching, _batch.begin() + i);
+            _batchRetrying = true;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+
+        if (docStillMatches) {
+            _ws->get(id)->makeObjOwnedIfNeeded();
+            _batch[numMatching++] = id;
+        } else {
+            _ws->free(id);
+        }
+    }
+    _batch.resize(numMatching);
+    _batchRetrying = false;
+
+    if (_batch.empty()) {
+        return PlanStage::NEED_TIME;
+    }
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException&) {
+        std::terminate();
+    }
+
+    // The stats count the updates as they are applied, so put them back if the batch does not
+    // commit.
+    const UpdateStats statsBeforeBatch = _specificStats;
+    ScopeGuard statsRestorer = MakeGuard([&] { _specificStats = statsBeforeBatch; });
+    ScopeGuard updatedRecordIdsRestorer = MakeGuard([&] {
+        for (auto&& recordId : _batchUpdatedRecordIds) {
+            _updatedRecordIds->erase(recordId);
+        }
+        _batchUpdatedRecordIds.clear();
+    });
+
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch) {
+            WorkingSetMember* member = _ws->get(id);
+            RecordId recordId = member->recordId;
+            transformAndUpdate(member->obj, recordId);
+            ++_specificStats.nMatched;
+        }
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        // Keep the batch around so we can retry updating it.
+        _batchRetrying = true;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+    statsRestorer.Dismiss();
+    updatedRecordIdsRestorer.Dismiss();
+    _batchUpdatedRecordIds.clear();
+
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+
+    // As restoreState may restore (recreate) cursors, make sure to restore the state outside of
+    // the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException&) {
+        // The updates were committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 void UpdateStage::doRestoreState() {
     const UpdateRequest& request = *_params.request;
     const NamespaceString& nsString(request.getNamespaceString());
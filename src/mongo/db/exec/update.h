@@ -29,6 +29,8 @@
 #pragma once
 
 
+#include <vector>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
@@ -71,6 +73,10 @@ private:
  * returned after updating or inserting a document. Otherwise, NEED_TIME is returned after
  * updating or inserting a document.
  *
+ * When 'internalQueryMultiUpdateBatchMaxBytes' is set, a multi update which does not return
+ * documents applies its update to batches of documents from its child, each in one storage
+ * transaction.
+ *
  * Callers of work() must be holding a write lock.
  */
 class UpdateStage final : public PlanStage {
@@ -176,6 +182,13 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Does the work of a call to work() for a multi update which updates batches of documents in
+     * one WriteUnitOfWork. Gathers documents from the child until they total '_batchMaxBytes', or
+     * retries the batch held in '_batch', and updates those which still exist and match.
+     */
+    StageState doBatchedWork(WorkingSetID* out);
+
     UpdateStageParams _params;
 
     // Not owned by us.
@@ -214,6 +227,19 @@ private:
     // These get reused for each update.
     mutablebson::Document& _doc;
     mutablebson::DamageVector _damages;
+
+    // The size at which a batch of documents to update is closed, or 0 if each document is updated
+    // in a WriteUnitOfWork of its own.
+    const size_t _batchMaxBytes;
+
+    // The members gathered for the next batch of updates, and whether they were gathered before a
+    // yield and must be checked again before they are updated.
+    std::vector<WorkingSetID> _batch;
+    bool _batchRetrying = false;
+
+    // The RecordIds added to '_updatedRecordIds' by the batch being updated, which are removed
+    // again if its WriteUnitOfWork does not commit.
+    std::vector<RecordId> _batchUpdatedRecordIds;
 };
 
 }  // namespace mongo
@@ -28,10 +28,13 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -42,15 +45,28 @@ namespace dps = ::mongo::dotted_path_support;
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
+constexpr size_t WorkingSet::kMinMembersPerSlab;
+constexpr size_t WorkingSet::kMaxMembersPerSlab;
+
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+WorkingSet::~WorkingSet() {}
+
+WorkingSetMember* WorkingSet::_newMember() {
+    if (_lastSlabUsed == _lastSlabSize) {
+        _lastSlabSize =
+            std::min(std::max(2 * _lastSlabSize, kMinMembersPerSlab), kMaxMembersPerSlab);
+        _slabs.push_back(stdx::make_unique<WorkingSetMember[]>(_lastSlabSize));
+        _lastSlabUsed = 0;
+        ++_stats.slabsAllocated;
     }
+
+    ++_stats.membersCreated;
+    return &_slabs.back()[_lastSlabUsed++];
 }
 
 WorkingSetID WorkingSet::allocate() {
+    ++_stats.allocations;
     if (_freeList == INVALID_ID) {
         // The free list is empty so we need to make a single new WSM to return. This relies on
         // vector::resize being amortized O(1) for efficient allocation. Note that the free list
@@ -58,7 +74,7 @@ WorkingSetID WorkingSet::allocate() {
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = _newMember();
         return id;
     }
 
@@ -96,14 +112,14 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-    _data.clear();
-
-    // Since working set is now empty, the free list pointer should
-    // point to nothing.
+    // Free every member, threading the free list through the ids in ascending order so that they
+    // are handed out again in the order they were first allocated.
     _freeList = INVALID_ID;
+    for (size_t i = _data.size(); i-- > 0;) {
+        _data[i].member->clear();
+        _data[i].nextFreeOrSelf = _freeList;
+        _freeList = i;
+    }
 
     _flagged.clear();
     _yieldSensitiveIds.clear();
@@ -118,6 +134,7 @@ void WorkingSet::transitionToRecordIdAndIdx(WorkingSetID id) {
 void WorkingSet::transitionToRecordIdAndObj(WorkingSetID id) {
     WorkingSetMember* member = get(id);
     member->_state = WorkingSetMember::RID_AND_OBJ;
+    _yieldSensitiveIds.push_back(id);
 }
 
 void WorkingSet::transitionToOwnedObj(WorkingSetID id) {
@@ -147,6 +164,9 @@ void WorkingSetMember::clear() {
 
     keyData.clear();
     obj.reset();
+    recordId = RecordId();
+    isSuspicious = false;
+    _fetcher.reset();
     _state = WorkingSetMember::INVALID;
 }
 
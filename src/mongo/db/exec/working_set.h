@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -112,7 +113,8 @@ public:
     const stdx::unordered_set<WorkingSetID>& getFlagged() const;
 
     /**
-     * Removes and deallocates all members of this working set.
+     * Frees all members of this working set. The members' storage is kept for reuse by later
+     * calls to allocate().
      */
     void clear();
 
@@ -138,6 +140,25 @@ public:
      */
     std::vector<WorkingSetID> getAndClearYieldSensitiveIds();
 
+    /**
+     * Counts of how this working set obtained its members, reported by explain.
+     */
+    struct Stats {
+        // Number of calls to allocate().
+        size_t allocations = 0;
+
+        // Number of WorkingSetMembers constructed, none of which are ever destroyed before the
+        // working set is. The rest of the allocations were satisfied by recycling freed members.
+        size_t membersCreated = 0;
+
+        // Number of heap allocations made to hold those members.
+        size_t slabsAllocated = 0;
+    };
+
+    const Stats& getStats() const {
+        return _stats;
+    }
+
 private:
     struct MemberHolder {
         MemberHolder();
@@ -146,10 +167,20 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of '_slabs'.
         WorkingSetMember* member;
     };
 
+    // Members are constructed in slabs which double in size up to this many members, so that small
+    // queries stay small and large ones need few heap allocations.
+    static constexpr size_t kMinMembersPerSlab = 4;
+    static constexpr size_t kMaxMembersPerSlab = 256;
+
+    /**
+     * Returns a newly constructed member from the last slab, allocating a new slab if it is full.
+     */
+    WorkingSetMember* _newMember();
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
@@ -164,6 +195,14 @@ private:
 
     // Contains ids of WSMs that may need to be adjusted when we next yield.
     std::vector<WorkingSetID> _yieldSensitiveIds;
+
+    // Storage for every member ever created by this working set. Only the last slab may have
+    // unused members, of which there are '_lastSlabSize - _lastSlabUsed'.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _slabs;
+    size_t _lastSlabSize = 0;
+    size_t _lastSlabUsed = 0;
+
+    Stats _stats;
 };
 
 /**
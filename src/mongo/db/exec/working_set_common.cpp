@@ -81,6 +81,11 @@ void WorkingSetCommon::prepareForSnapshotChange(WorkingSet* workingSet) {
         WorkingSetMember* member = workingSet->get(id);
         if (member->getState() == WorkingSetMember::RID_AND_IDX) {
             member->isSuspicious = true;
+        } else if (member->getState() == WorkingSetMember::RID_AND_OBJ) {
+            // Record cursors hand out documents that point into the storage engine's buffers,
+            // which only stay pinned until the cursor is saved. Take ownership now, rather than
+            // having every stage copy each document it passes along.
+            member->makeObjOwnedIfNeeded();
         }
     }
 }
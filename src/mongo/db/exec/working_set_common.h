@@ -54,10 +54,12 @@ public:
      * state.
      *
      * Iterates over WorkingSetIDs in 'workingSet' which are "sensitive to yield". These are ids
-     * that have transitioned into the RID_AND_IDX state since the previous yield.
+     * that have transitioned into the RID_AND_IDX or RID_AND_OBJ state since the previous yield.
      *
      * The RID_AND_IDX members are tagged as suspicious so that they can be handled properly in case
-     * the document keyed by the index key is deleted or updated during the yield.
+     * the document keyed by the index key is deleted or updated during the yield. The RID_AND_OBJ
+     * members take ownership of their BSONObj, which may point into storage engine memory that is
+     * only valid until the yield.
      */
     static void prepareForSnapshotChange(WorkingSet* workingSet);
 
@@ -103,6 +103,14 @@ TEST_F(WorkingSetFixture, getFieldUnowned) {
     ASSERT_EQUALS(elt.numberInt(), 5);
 }
 
+TEST_F(WorkingSetFixture, transitionToRecordIdAndObjIsYieldSensitive) {
+    ws->transitionToRecordIdAndObj(id);
+    std::vector<WorkingSetID> ids = ws->getAndClearYieldSensitiveIds();
+    ASSERT_EQUALS(1U, ids.size());
+    ASSERT_EQUALS(id, ids[0]);
+    ASSERT_TRUE(ws->getAndClearYieldSensitiveIds().empty());
+}
+
 TEST_F(WorkingSetFixture, getFieldOwned) {
     string fieldName = "x";
 
@@ -154,4 +162,36 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST(WorkingSetTest, MembersAreRecycledAfterClear) {
+    WorkingSet ws;
+    std::vector<WorkingSetID> ids;
+    for (int i = 0; i < 10; ++i) {
+        ids.push_back(ws.allocate());
+    }
+    ASSERT_EQUALS(10U, ws.getStats().membersCreated);
+    // Slabs of 4, 8 members.
+    ASSERT_EQUALS(2U, ws.getStats().slabsAllocated);
+
+    ws.get(ids[3])->isSuspicious = true;
+    ws.clear();
+    ASSERT_TRUE(ws.isFree(ids[3]));
+
+    // Ids are handed out again in their original order, without constructing new members.
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQUALS(ids[i], ws.allocate());
+    }
+    ASSERT_FALSE(ws.get(ids[3])->isSuspicious);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws.get(ids[3])->getState());
+    ASSERT_EQUALS(20U, ws.getStats().allocations);
+    ASSERT_EQUALS(10U, ws.getStats().membersCreated);
+    ASSERT_EQUALS(2U, ws.getStats().slabsAllocated);
+
+    // Members stay valid as more slabs are added.
+    WorkingSetMember* first = ws.get(ids[0]);
+    for (int i = 0; i < 100; ++i) {
+        ws.allocate();
+    }
+    ASSERT_EQUALS(first, ws.get(ids[0]));
+}
+
 }  // namespace
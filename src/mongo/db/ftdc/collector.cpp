@@ -42,9 +42,10 @@
 
 namespace mongo {
 
-void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector) {
+void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector,
+                                  Milliseconds minPeriod) {
     // TODO: ensure the collectors all have unique names.
-    _collectors.emplace_back(std::move(collector));
+    _collectors.push_back({std::move(collector), minPeriod, BSONObj(), Date_t()});
 }
 
 std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
@@ -72,8 +73,8 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
     // Explicitly start future read transactions without a timestamp.
     opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kNoTimestamp);
 
-    for (auto& collector : _collectors) {
-        BSONObjBuilder subObjBuilder(builder.subobjStart(collector->name()));
+    for (auto& info : _collectors) {
+        auto& collector = info.collector;
 
         // Add a Date_t before and after each BSON is collected so that we can track timing of the
         // collector.
@@ -85,12 +86,33 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
 
         firstLoop = false;
 
-        subObjBuilder.appendDate(kFTDCCollectStartField, now);
+        if (info.minPeriod == Milliseconds(0)) {
+            BSONObjBuilder subObjBuilder(builder.subobjStart(collector->name()));
+            subObjBuilder.appendDate(kFTDCCollectStartField, now);
 
-        collector->collect(opCtx.get(), subObjBuilder);
+            collector->collect(opCtx.get(), subObjBuilder);
 
-        end = client->getServiceContext()->getPreciseClockSource()->now();
-        subObjBuilder.appendDate(kFTDCCollectEndField, end);
+            end = client->getServiceContext()->getPreciseClockSource()->now();
+            subObjBuilder.appendDate(kFTDCCollectEndField, end);
+            continue;
+        }
+
+        if (info.lastSample.isEmpty() || now >= info.nextCollection) {
+            BSONObjBuilder subObjBuilder;
+            subObjBuilder.appendDate(kFTDCCollectStartField, now);
+
+            collector->collect(opCtx.get(), subObjBuilder);
+
+            end = client->getServiceContext()->getPreciseClockSource()->now();
+            subObjBuilder.appendDate(kFTDCCollectEndField, end);
+
+            info.lastSample = subObjBuilder.obj();
+            info.nextCollection = FTDCUtil::roundTime(now, info.minPeriod);
+        } else {
+            end = now;
+        }
+
+        builder.append(collector->name(), info.lastSample);
     }
 
     builder.appendDate(kFTDCCollectEndField, end);
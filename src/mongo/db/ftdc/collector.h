@@ -33,6 +33,9 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -86,8 +89,14 @@ public:
     /**
      * Add a metric collector to the collection.
      * Must be called before collect. Cannot be called after collect is called.
+     *
+     * A collector with a non-zero minPeriod is collected at most once per minPeriod interval,
+     * with intervals aligned the same way as the collection period. Samples
+     * taken in between repeat its last result, which keeps the schema of the samples stable and
+     * costs almost nothing to store since the repeated metrics do not change.
      */
-    void add(std::unique_ptr<FTDCCollectorInterface> collector);
+    void add(std::unique_ptr<FTDCCollectorInterface> collector,
+             Milliseconds minPeriod = Milliseconds(0));
 
     /**
      * Collect a sample from all collectors. Called after all adding is complete.
@@ -108,8 +117,18 @@ public:
     std::tuple<BSONObj, Date_t> collect(Client* client);
 
 private:
+    struct CollectorInfo {
+        std::unique_ptr<FTDCCollectorInterface> collector;
+        Milliseconds minPeriod;
+
+        // Last result of a collector with a minPeriod, and the start of the next minPeriod
+        // interval, after which it is collected again
+        BSONObj lastSample;
+        Date_t nextCollection;
+    };
+
     // collection of collectors
-    std::vector<std::unique_ptr<FTDCCollectorInterface>> _collectors;
+    std::vector<CollectorInfo> _collectors;
 };
 
 }  // namespace mongo
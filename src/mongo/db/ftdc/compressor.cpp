@@ -36,12 +36,70 @@
 #include "mongo/db/ftdc/varint.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
 using std::swap;
 
+namespace {
+
+/**
+ * Returns the number of bytes FTDCVarInt encodes 'value' in.
+ */
+std::size_t varIntSize(std::uint64_t value) {
+    return value ? (63 - countLeadingZeros64(value)) / 7 + 1 : 1;
+}
+
+/**
+ * Returns the number of bytes a series of values encodes in, with runs of zeros compressed.
+ */
+template <typename GetValue>
+std::size_t encodedSize(std::uint32_t count, GetValue getValue) {
+    std::size_t size = 0;
+    std::uint32_t zeroesCount = 0;
+    for (std::uint32_t j = 0; j < count; j++) {
+        std::uint64_t value = getValue(j);
+        if (value == 0) {
+            ++zeroesCount;
+            continue;
+        }
+
+        if (zeroesCount > 0) {
+            size += 1 + varIntSize(zeroesCount - 1);
+            zeroesCount = 0;
+        }
+        size += varIntSize(value);
+    }
+
+    if (zeroesCount > 0) {
+        size += 1 + varIntSize(zeroesCount - 1);
+    }
+    return size;
+}
+
+}  // namespace
+
+std::uint64_t FTDCCompressor::zigZagEncode(std::uint64_t value) {
+    return (value << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(value) >> 63);
+}
+
+std::uint64_t FTDCCompressor::zigZagDecode(std::uint64_t value) {
+    return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+std::uint64_t FTDCCompressor::getDeltaOfDelta(const std::vector<std::uint64_t>& deltas,
+                                              std::uint32_t sampleCount,
+                                              std::uint32_t sample,
+                                              std::uint32_t metric) {
+    std::uint64_t delta = deltas[getArrayOffset(sampleCount, sample, metric)];
+    if (sample == 0) {
+        return zigZagEncode(delta);
+    }
+    return zigZagEncode(delta - deltas[getArrayOffset(sampleCount, sample - 1, metric)]);
+}
+
 StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
 FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     if (_referenceDoc.isEmpty()) {
@@ -111,8 +169,28 @@ FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     return {boost::none};
 }
 
+void FTDCCompressor::_chooseEncodings() {
+    _useDeltaOfDelta.assign(_metricsCount, false);
+    _hasDeltaOfDeltaMetrics = false;
+
+    for (std::uint32_t i = 0; i < _metricsCount; i++) {
+        auto deltaSize = encodedSize(_deltaCount, [&](std::uint32_t j) {
+            return _deltas[getArrayOffset(_maxDeltas, j, i)];
+        });
+        auto deltaOfDeltaSize = encodedSize(_deltaCount, [&](std::uint32_t j) {
+            return getDeltaOfDelta(_deltas, _maxDeltas, j, i);
+        });
+
+        if (deltaOfDeltaSize < deltaSize) {
+            _useDeltaOfDelta[i] = true;
+            _hasDeltaOfDeltaMetrics = true;
+        }
+    }
+}
+
 StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamples() {
     _uncompressedChunkBuffer.setlen(0);
+    _hasDeltaOfDeltaMetrics = false;
 
     // Append reference document - BSON Object
     _uncompressedChunkBuffer.appendBuf(_referenceDoc.objdata(), _referenceDoc.objsize());
@@ -124,6 +202,21 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     _uncompressedChunkBuffer.appendNum(static_cast<std::uint32_t>(_deltaCount));
 
     if (_metricsCount != 0 && _deltaCount != 0) {
+        if (_config->deltaOfDeltaEncoding) {
+            _chooseEncodings();
+        }
+
+        // Append which metrics are delta-of-delta encoded - one bit per metric
+        if (_hasDeltaOfDeltaMetrics) {
+            for (std::uint32_t i = 0; i < _metricsCount; i += 8) {
+                std::uint8_t bits = 0;
+                for (std::uint32_t bit = 0; bit < 8 && i + bit < _metricsCount; ++bit) {
+                    bits |= _useDeltaOfDelta[i + bit] << bit;
+                }
+                _uncompressedChunkBuffer.appendNum(static_cast<char>(bits));
+            }
+        }
+
         // On average, we do not need all 10 bytes for every sample, worst case, we grow the buffer
         DataBuilder db(_metricsCount * _deltaCount * FTDCVarInt::kMaxSizeBytes64 / 2);
 
@@ -143,8 +236,10 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
         // These byte arrays are added to a buffer which is then concatenated with other chunks and
         // compressed with ZLIB.
         for (std::uint32_t i = 0; i < _metricsCount; i++) {
+            const bool deltaOfDelta = _hasDeltaOfDeltaMetrics && _useDeltaOfDelta[i];
             for (std::uint32_t j = 0; j < _deltaCount; j++) {
-                std::uint64_t delta = _deltas[getArrayOffset(_maxDeltas, j, i)];
+                std::uint64_t delta = deltaOfDelta ? getDeltaOfDelta(_deltas, _maxDeltas, j, i)
+                                                   : _deltas[getArrayOffset(_maxDeltas, j, i)];
 
                 if (delta == 0) {
                     ++zeroesCount;
@@ -56,6 +56,13 @@ namespace mongo {
  * 4. Encodes zeros in Run Length Encoded pairs of <Count, Zero>
  * 5. ZLIB compresses the final processed array
  *
+ * If FTDCConfig::deltaOfDeltaEncoding is set, a metric whose deltas change little from sample to
+ * sample, like a counter that grows at a steady rate, is instead stored as the ZigZag encoded
+ * differences between consecutive deltas, which turns long runs of equal deltas into runs of
+ * zeros. Each metric uses whichever representation encodes smaller, and the chunk records which
+ * metrics use delta-of-delta encoding in a bitmap after the sample count; see
+ * FTDCBSONUtil::FTDCType::kDeltaOfDeltaMetricChunk.
+ *
  * NOTE: This compression ignores non-number data, and assumes the non-number data is constant
  * across all documents in the series of documents.
  */
@@ -127,6 +134,14 @@ public:
      */
     StatusWith<std::tuple<ConstDataRange, Date_t>> getCompressedSamples();
 
+    /**
+     * Returns true if the buffer last returned by addSample() or getCompressedSamples() stores
+     * some metrics as deltas of deltas, and so must be written as a kDeltaOfDeltaMetricChunk.
+     */
+    bool compressedSamplesHaveDeltaOfDeltaMetrics() const {
+        return _hasDeltaOfDeltaMetrics;
+    }
+
     /**
      * Reset the state of the compressor.
      *
@@ -143,12 +158,34 @@ public:
         return metric * sampleCount + sample;
     }
 
+    /**
+     * Maps signed differences to unsigned integers so that small negative differences, like
+     * small positive ones, have short FTDCVarInt encodings.
+     */
+    static std::uint64_t zigZagEncode(std::uint64_t value);
+    static std::uint64_t zigZagDecode(std::uint64_t value);
+
+    /**
+     * Returns the ZigZag encoded difference between the delta of a (sample, metric) pair in an
+     * array laid out by getArrayOffset and the delta of the preceding sample.
+     */
+    static std::uint64_t getDeltaOfDelta(const std::vector<std::uint64_t>& deltas,
+                                         std::uint32_t sampleCount,
+                                         std::uint32_t sample,
+                                         std::uint32_t metric);
+
 private:
     /**
      * Reset the state
      */
     void _reset(const BSONObj& referenceDoc, Date_t date);
 
+    /**
+     * Decide for each metric whether delta-of-delta encoding makes it smaller, filling in
+     * _useDeltaOfDelta and _hasDeltaOfDeltaMetrics.
+     */
+    void _chooseEncodings();
+
 private:
     // Block Compressor
     BlockCompressor _compressor;
@@ -185,6 +222,10 @@ private:
     // Buffer to hold metrics
     std::vector<std::uint64_t> _metrics;
     std::vector<std::uint64_t> _prevmetrics;
+
+    // Whether each metric of the last compressed chunk is stored as deltas of deltas
+    std::vector<bool> _useDeltaOfDelta;
+    bool _hasDeltaOfDeltaMetrics{false};
 };
 
 }  // namespace mongo
@@ -127,7 +127,9 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie() : _compressor(&_config) {}
+    explicit TestTie(bool deltaOfDeltaEncoding = false) : _compressor(&_config) {
+        _config.deltaOfDeltaEncoding = deltaOfDeltaEncoding;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -159,13 +161,16 @@ public:
     void validate(boost::optional<ConstDataRange> cdr) {
         std::vector<BSONObj> list;
         if (cdr.is_initialized()) {
-            auto sw = _decompressor.uncompress(cdr.get());
+            auto sw = _decompressor.uncompress(
+                cdr.get(), _compressor.compressedSamplesHaveDeltaOfDeltaMetrics());
             ASSERT_TRUE(sw.isOK());
             list = sw.getValue();
         } else {
             auto swBuf = _compressor.getCompressedSamples();
             ASSERT_TRUE(swBuf.isOK());
-            auto sw = _decompressor.uncompress(std::get<0>(swBuf.getValue()));
+            auto sw = _decompressor.uncompress(
+                std::get<0>(swBuf.getValue()),
+                _compressor.compressedSamplesHaveDeltaOfDeltaMetrics());
             ASSERT_TRUE(sw.isOK());
 
             list = sw.getValue();
@@ -539,4 +544,47 @@ TEST_F(FTDCCompressorTest, TestManyMetrics) {
     }
 }
 
+// Test that counters growing at a steady rate compress better as deltas of deltas, and that
+// metrics of all shapes round trip with delta-of-delta encoding enabled
+TEST_F(FTDCCompressorTest, TestDeltaOfDelta) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<long long> genValues(1, std::numeric_limits<long long>::max());
+
+    size_t compressedSize[2];
+    for (int deltaOfDelta = 0; deltaOfDelta < 2; deltaOfDelta++) {
+        FTDCConfig config;
+        config.deltaOfDeltaEncoding = deltaOfDelta;
+        FTDCCompressor compressor(&config);
+        TestTie c(deltaOfDelta);
+
+        for (long long i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 1; i++) {
+            BSONObj sample = BSON("name"
+                                  << "joe"
+                                  << "steady"
+                                  << i * 1000
+                                  << "accelerating"
+                                  << i * i
+                                  << "decreasing"
+                                  << -i * 7
+                                  << "constant"
+                                  << 42
+                                  << "random"
+                                  << genValues(gen)
+                                  << "sawtooth"
+                                  << i % 5);
+            ASSERT_HAS_SPACE(c.addSample(sample));
+            ASSERT_HAS_SPACE(compressor.addSample(sample, Date_t()));
+        }
+
+        auto swBuf = compressor.getCompressedSamples();
+        ASSERT_TRUE(swBuf.isOK());
+        ASSERT_EQUALS(static_cast<bool>(deltaOfDelta),
+                      compressor.compressedSamplesHaveDeltaOfDeltaMetrics());
+        compressedSize[deltaOfDelta] = std::get<0>(swBuf.getValue()).length();
+    }
+
+    ASSERT_LESS_THAN(compressedSize[1], compressedSize[0]);
+}
+
 }  // namespace mongo
@@ -46,7 +46,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          deltaOfDeltaEncoding(kDeltaOfDeltaEncodingDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -83,7 +84,15 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * True if metrics that compress better as deltas of deltas may be stored that way. This makes
+     * sampling more often than once a second cheaper, but produces files that earlier versions
+     * cannot read.
+     */
+    bool deltaOfDeltaEncoding;
+
     static const bool kEnabledDefault = true;
+    static const bool kDeltaOfDeltaEncodingDefault = false;
 
     static const std::int64_t kPeriodMillisDefault;
     static const std::uint64_t kMaxDirectorySizeBytesDefault = 200 * 1024 * 1024;
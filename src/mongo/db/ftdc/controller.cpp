@@ -47,6 +47,14 @@
 
 namespace mongo {
 
+namespace {
+
+// Most samples to queue for the writer thread before dropping new ones. At the shortest collection
+// period of 100ms, this is ten seconds of samples.
+const size_t kMaxPendingSamples = 100;
+
+}  // namespace
+
 Status FTDCController::setEnabled(bool enabled) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -92,6 +100,12 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setDeltaOfDeltaEncoding(bool enabled) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.deltaOfDeltaEncoding = enabled;
+    _condvar.notify_one();
+}
+
 Status FTDCController::setDirectory(const boost::filesystem::path& path) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
@@ -109,12 +123,13 @@ Status FTDCController::setDirectory(const boost::filesystem::path& path) {
 }
 
 
-void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector,
+                                          Milliseconds minPeriod) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
         invariant(_state == State::kNotStarted);
 
-        _periodicCollectors.add(std::move(collector));
+        _periodicCollectors.add(std::move(collector), minPeriod);
     }
 }
 
@@ -138,8 +153,9 @@ void FTDCController::start() {
     log() << "Initializing full-time diagnostic data capture with directory '"
           << _path.generic_string() << "'";
 
-    // Start the thread
+    // Start the threads
     _thread = stdx::thread([this] { doLoop(); });
+    _writerThread = stdx::thread([this] { writeLoop(); });
 
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -167,11 +183,14 @@ void FTDCController::stop() {
         _configTemp.enabled = false;
         _state = State::kStopRequested;
 
-        // Wake up the thread if sleeping so that it will check if we are done
+        // Wake up the threads if sleeping so that they will check if we are done
         _condvar.notify_one();
+        _writerCondvar.notify_one();
     }
 
+    // The writer thread exits once it has written the samples queued before collection stopped.
     _thread.join();
+    _writerThread.join();
 
     _state = State::kDone;
 
@@ -232,33 +251,88 @@ void FTDCController::doLoop() {
             // TODO: consider only running this thread if we are enabled
             // for now, we just keep an idle thread as it is simpler
             if (_config.enabled) {
-                // Delay initialization of FTDCFileManager until we are sure the user has enabled
-                // FTDC
-                if (!_mgr) {
-                    auto swMgr =
-                        FTDCFileManager::create(&_config, _path, &_rotateCollectors, client);
+                auto collectSample = _periodicCollectors.collect(client);
+
+                stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-                    _mgr = uassertStatusOK(std::move(swMgr));
+                if (_writerFailed) {
+                    break;
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
+                // Queue the sample for the writer thread, unless it has fallen far behind
+                if (_pendingSamples.size() < kMaxPendingSamples) {
+                    if (_droppingSamples) {
+                        log() << "Resuming full-time diagnostic data capture after dropping "
+                                 "samples that could not be written in time";
+                        _droppingSamples = false;
+                    }
+                    _pendingSamples.push_back(collectSample);
+                    _writerCondvar.notify_one();
+                } else if (!_droppingSamples) {
+                    warning() << "Dropping full-time diagnostic data capture samples because "
+                              << _pendingSamples.size() << " samples are waiting to be written";
+                    _droppingSamples = true;
+                }
 
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                // Store a reference to the most recent document from the periodic collectors
+                _mostRecentPeriodicDocument = std::get<0>(collectSample);
+            }
+        }
+    } catch (...) {
+        warning() << "Uncaught exception in '" << exceptionToStatus()
+                  << "' in full-time diagnostic data capture subsystem. Shutting down the "
+                     "full-time diagnostic data capture subsystem.";
+    }
+}
 
-                uassertStatusOK(s);
+void FTDCController::writeLoop() {
+    try {
+        Client::initThread("ftdc-writer");
+        Client* client = &cc();
 
-                // Store a reference to the most recent document from the periodic collectors
-                {
-                    stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+        while (true) {
+            std::tuple<BSONObj, Date_t> sample;
+
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+
+                _writerCondvar.wait(lock, [this] {
+                    return !_pendingSamples.empty() || _state == State::kStopRequested;
+                });
+
+                // Stop once everything collected before the stop request has been written
+                if (_pendingSamples.empty()) {
+                    break;
                 }
+
+                sample = std::move(_pendingSamples.front());
+                _pendingSamples.pop_front();
+
+                _writerConfig = _configTemp;
+            }
+
+            // Delay initialization of FTDCFileManager until we are sure the user has enabled FTDC
+            if (!_mgr) {
+                auto swMgr =
+                    FTDCFileManager::create(&_writerConfig, _path, &_rotateCollectors, client);
+
+                _mgr = uassertStatusOK(std::move(swMgr));
             }
+
+            Status s = _mgr->writeSampleAndRotateIfNeeded(
+                client, std::get<0>(sample), std::get<1>(sample));
+
+            uassertStatusOK(s);
         }
     } catch (...) {
         warning() << "Uncaught exception in '" << exceptionToStatus()
                   << "' in full-time diagnostic data capture subsystem. Shutting down the "
                      "full-time diagnostic data capture subsystem.";
+
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _writerFailed = true;
+        _pendingSamples.clear();
     }
 }
 
@@ -30,7 +30,9 @@
 
 #include <boost/filesystem/path.hpp>
 #include <cstdint>
+#include <deque>
 #include <memory>
+#include <tuple>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/ftdc/collector.h"
@@ -56,7 +58,7 @@ class FTDCController {
 
 public:
     FTDCController(const boost::filesystem::path path, FTDCConfig config)
-        : _path(path), _config(std::move(config)), _configTemp(_config) {}
+        : _path(path), _config(std::move(config)), _writerConfig(_config), _configTemp(_config) {}
 
     ~FTDCController() = default;
 
@@ -98,6 +100,11 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set whether metrics may be stored as deltas of deltas when that compresses better.
+     */
+    void setDeltaOfDeltaEncoding(bool enabled);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
@@ -107,8 +114,12 @@ public:
 
     /**
      * Add a metric collector to collect periodically. i.e., serverStatus
+     *
+     * If minPeriod is longer than the collection period, the collector is only run once per
+     * minPeriod. See FTDCCollectorCollection::add.
      */
-    void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+    void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector,
+                              Milliseconds minPeriod = Milliseconds(0));
 
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
@@ -120,7 +131,8 @@ public:
     /**
      * Start the controller.
      *
-     * Spawns a new thread.
+     * Spawns a thread that collects samples, and a thread that compresses and writes them so
+     * that slow disk writes do not delay collection.
      */
     void start();
 
@@ -143,10 +155,17 @@ public:
 
 private:
     /**
-     * Do periodic statistics collection, and all other work on the background thread.
+     * Do periodic statistics collection on the background thread, and queue the samples for
+     * writeLoop.
      */
     void doLoop();
 
+    /**
+     * Write queued samples to disk on the writer thread until stop is requested and the queue is
+     * drained.
+     */
+    void writeLoop();
+
 private:
     /**
     * Private enum to track state.
@@ -185,14 +204,19 @@ private:
     // Directory to store files
     boost::filesystem::path _path;
 
-    // Mutex to protect the condvar, configuration changes, and most recent periodic document.
+    // Mutex to protect the condvars, configuration changes, most recent periodic document, and the
+    // queue of samples to write.
     stdx::mutex _mutex;
     stdx::condition_variable _condvar;
 
-    // Config settings that are used by controller, file manager, and all other classes.
+    // Config settings that are used by the collection thread.
     // Copied from _configTemp periodically to get a consistent snapshot.
     FTDCConfig _config;
 
+    // Config settings that are used by the writer thread and the file manager.
+    // Copied from _configTemp before each sample is written.
+    FTDCConfig _writerConfig;
+
     // Config settings that are manipulated by setters via setParameter.
     FTDCConfig _configTemp;
 
@@ -209,8 +233,23 @@ private:
     // File manager that manages file rotation, and logging
     std::unique_ptr<FTDCFileManager> _mgr;
 
-    // Background collection and writing thread
+    // Samples collected but not yet written, oldest first
+    std::deque<std::tuple<BSONObj, Date_t>> _pendingSamples;
+
+    // True while samples are dropped because too many are waiting to be written
+    bool _droppingSamples{false};
+
+    // Set if the writer thread has failed, at which point collection stops too
+    bool _writerFailed{false};
+
+    // Signals the writer thread that a sample was queued or that stop was requested
+    stdx::condition_variable _writerCondvar;
+
+    // Background collection thread
     stdx::thread _thread;
+
+    // Background writing thread
+    stdx::thread _writerThread;
 };
 
 }  // namespace mongo
@@ -41,7 +41,8 @@
 
 namespace mongo {
 
-StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf) {
+StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf,
+                                                              bool hasDeltaOfDeltaMetrics) {
     ConstDataRangeCursor compressedDataRange(buf);
 
     // Read the length of the uncompressed buffer
@@ -121,6 +122,21 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         return {docs};
     }
 
+    // Read which metrics are delta-of-delta encoded
+    std::vector<bool> useDeltaOfDelta(metricsCount, false);
+    if (hasDeltaOfDeltaMetrics) {
+        for (std::uint32_t i = 0; i < metricsCount; i += 8) {
+            auto swBits = cdc.readAndAdvance<std::uint8_t>();
+            if (!swBits.isOK()) {
+                return {swBits.getStatus()};
+            }
+
+            for (std::uint32_t bit = 0; bit < 8 && i + bit < metricsCount; ++bit) {
+                useDeltaOfDelta[i + bit] = swBits.getValue() & (1 << bit);
+            }
+        }
+    }
+
     // Read the samples
     std::vector<std::uint64_t> deltas(metricsCount * sampleCount);
 
@@ -157,6 +173,20 @@ StatusWith<std::vector<BSONObj>> FTDCDecompressor::uncompress(ConstDataRange buf
         }
     }
 
+    // Turn deltas of deltas back into deltas
+    for (std::uint32_t i = 0; i < metricsCount; i++) {
+        if (!useDeltaOfDelta[i]) {
+            continue;
+        }
+
+        std::uint64_t delta = 0;
+        for (std::uint32_t j = 0; j < sampleCount; j++) {
+            auto offset = FTDCCompressor::getArrayOffset(sampleCount, j, i);
+            delta += FTDCCompressor::zigZagDecode(deltas[offset]);
+            deltas[offset] = delta;
+        }
+    }
+
     // Inflate the deltas
     for (std::uint32_t i = 0; i < metricsCount; i++) {
         deltas[FTDCCompressor::getArrayOffset(sampleCount, 0, i)] += metrics[i];
@@ -53,8 +53,11 @@ public:
      * Will fail if the chunk is corrupt or too short.
      *
      * Returns N samples where N = sample count + 1. The 1 is the reference document.
+     *
+     * hasDeltaOfDeltaMetrics must be true for chunks stored as kDeltaOfDeltaMetricChunk.
      */
-    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf);
+    StatusWith<std::vector<BSONObj>> uncompress(ConstDataRange buf,
+                                                bool hasDeltaOfDeltaMetrics = false);
 
 private:
     BlockCompressor _compressor;
@@ -45,9 +45,14 @@ void registerMongoDCollectors(FTDCController* controller) {
     // These metrics are only collected if replication is enabled
     if (repl::ReplicationCoordinator::get(getGlobalServiceContext())->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
+        // These change slowly, so they are collected at most once a second even when the
+        // collection period is shorter.
+
         // CmdReplSetGetStatus
-        controller->addPeriodicCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
-            "replSetGetStatus", "replSetGetStatus", "", BSON("replSetGetStatus" << 1)));
+        controller->addPeriodicCollector(
+            stdx::make_unique<FTDCSimpleInternalCommandCollector>(
+                "replSetGetStatus", "replSetGetStatus", "", BSON("replSetGetStatus" << 1)),
+            Seconds(1));
 
         // CollectionStats
         controller->addPeriodicCollector(
@@ -55,7 +60,8 @@ void registerMongoDCollectors(FTDCController* controller) {
                                                                   "local.oplog.rs.stats",
                                                                   "local",
                                                                   BSON("collStats"
-                                                                       << "oplog.rs")));
+                                                                       << "oplog.rs")),
+            Seconds(1));
     }
 }
 
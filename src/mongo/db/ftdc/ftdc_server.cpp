@@ -241,6 +241,28 @@ public:
     }
 
 } exportedFTDCInterimChunkSizeParameter;
+
+AtomicBool localDeltaOfDeltaEncodingFlag(FTDCConfig::kDeltaOfDeltaEncodingDefault);
+
+class ExportedFTDCDeltaOfDeltaEncodingParameter
+    : public ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCDeltaOfDeltaEncodingParameter()
+        : ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionDeltaOfDeltaEncoding",
+              &localDeltaOfDeltaEncodingFlag) {}
+
+    virtual Status validate(const bool& potentialNewValue) {
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setDeltaOfDeltaEncoding(potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCDeltaOfDeltaEncodingParameter;
 }  // namespace
 
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
@@ -278,6 +300,7 @@ void startFTDC(boost::filesystem::path& path,
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.deltaOfDeltaEncoding = localDeltaOfDeltaEncodingFlag.load();
 
     auto controller = stdx::make_unique<FTDCController>(path, config);
 
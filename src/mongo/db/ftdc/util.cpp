@@ -352,11 +352,16 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date) {
     return builder.obj();
 }
 
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t date) {
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf,
+                                      Date_t date,
+                                      bool hasDeltaOfDeltaMetrics) {
     BSONObjBuilder builder;
 
     builder.appendDate(kFTDCIdField, date);
-    builder.appendNumber(kFTDCTypeField, static_cast<int>(FTDCType::kMetricChunk));
+    builder.appendNumber(kFTDCTypeField,
+                         static_cast<int>(hasDeltaOfDeltaMetrics
+                                              ? FTDCType::kDeltaOfDeltaMetricChunk
+                                              : FTDCType::kMetricChunk));
     builder.appendBinData(kFTDCDataField, buf.length(), BinDataType::BinDataGeneral, buf.data());
 
     return builder.obj();
@@ -382,6 +387,7 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj) {
     }
 
     if (static_cast<FTDCType>(value) != FTDCType::kMetricChunk &&
+        static_cast<FTDCType>(value) != FTDCType::kDeltaOfDeltaMetricChunk &&
         static_cast<FTDCType>(value) != FTDCType::kMetadata) {
         return {ErrorCodes::BadValue,
                 str::stream() << "Field '" << std::string(kFTDCTypeField)
@@ -411,10 +417,12 @@ StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj) {
 
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor) {
-    if (kDebugBuild) {
-        auto swType = getBSONDocumentType(obj);
-        dassert(swType.isOK() && swType.getValue() == FTDCType::kMetricChunk);
+    auto swType = getBSONDocumentType(obj);
+    if (!swType.isOK()) {
+        return {swType.getStatus()};
     }
+    dassert(swType.getValue() == FTDCType::kMetricChunk ||
+            swType.getValue() == FTDCType::kDeltaOfDeltaMetricChunk);
 
     BSONElement element;
 
@@ -430,7 +438,9 @@ StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                 str::stream() << "Field " << std::string(kFTDCTypeField) << " is not a BinData."};
     }
 
-    return decompressor->uncompress({buffer, static_cast<std::size_t>(length)});
+    return decompressor->uncompress(
+        {buffer, static_cast<std::size_t>(length)},
+        swType.getValue() == FTDCType::kDeltaOfDeltaMetricChunk);
 }
 
 }  // namespace FTDCBSONUtil
@@ -62,6 +62,13 @@ enum class FTDCType : std::int32_t {
     * See createBSONMetricChunkDocument
     */
     kMetricChunk = 1,
+
+    /**
+    * A metrics chunk whose compressed metric chunk stores some metrics as deltas of deltas.
+    *
+    * See FTDCCompressor and createBSONMetricChunkDocument
+    */
+    kDeltaOfDeltaMetricChunk = 2,
 };
 
 
@@ -145,8 +152,12 @@ BSONObj createBSONMetadataDocument(const BSONObj& metadata, Date_t date);
  *  "type" : 1
  *  "data" : BinData(...)
  * }
+ *
+ * The type is 2 instead if hasDeltaOfDeltaMetrics is true.
  */
-BSONObj createBSONMetricChunkDocument(ConstDataRange buf, Date_t now);
+BSONObj createBSONMetricChunkDocument(ConstDataRange buf,
+                                      Date_t now,
+                                      bool hasDeltaOfDeltaMetrics = false);
 
 /**
  * Get the _id field of a BSON document
@@ -164,7 +175,8 @@ StatusWith<FTDCType> getBSONDocumentType(const BSONObj& obj);
 StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj);
 
 /**
- * Get the set of metric documents from the compressed chunk of a metric document
+ * Get the set of metric documents from the compressed chunk of a metric document of either metric
+ * chunk type
  */
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor);
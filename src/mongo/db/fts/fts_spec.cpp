@@ -37,6 +37,7 @@
 #include "mongo/db/fts/fts_tokenizer.h"
 #include "mongo/db/fts/fts_util.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/stringutils.h"
 
@@ -63,6 +64,20 @@ bool validateOverride(const string& override) {
     // can't contain a dot.
     return !override.empty()&& override[0] != '$' && override.find('.') == std::string::npos;
 }
+
+// The tokenizers used to score documents on this thread, by language. Creating a tokenizer creates
+// a stemmer, so they are reused for every field of every document rather than created for each,
+// which also lets a stemmer's cache of stems outlive a single document.
+thread_local stdx::unordered_map<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>
+    scoringTokenizers;
+
+FTSTokenizer* getScoringTokenizer(const FTSLanguage* language) {
+    auto& tokenizer = scoringTokenizers[language];
+    if (!tokenizer) {
+        tokenizer = language->createTokenizer();
+    }
+    return tokenizer.get();
+}
 }
 
 FTSSpec::FTSSpec(const BSONObj& indexInfo) {
@@ -184,8 +199,7 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+        _scoreStringV2(getScoringTokenizer(val._language), val._text, term_freqs, val._weight);
     }
 }
 
@@ -31,12 +31,28 @@
 #include <cstdlib>
 
 #include "mongo/db/fts/stemmer.h"
+
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
 namespace fts {
 
+namespace {
+
+// How many stems each stemmer keeps, so that frequent words are not stemmed again. Zero disables
+// the cache.
+MONGO_EXPORT_SERVER_PARAMETER(textSearchStemCacheSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "textSearchStemCacheSize must be non-negative");
+        }
+        return Status::OK();
+    });
+
+}  // namespace
+
 Stemmer::Stemmer(const FTSLanguage* language) {
     _stemmer = NULL;
     if (language->str() != "none")
@@ -54,6 +70,14 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    const size_t maxCacheSize = textSearchStemCacheSize.load();
+    if (maxCacheSize) {
+        auto cached = _stemCache.find(word);
+        if (cached != _stemCache.end()) {
+            return cached->second;
+        }
+    }
+
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -62,7 +86,17 @@ StringData Stemmer::stem(StringData word) const {
         MONGO_UNREACHABLE;
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    const StringData stemmed((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    if (!maxCacheSize) {
+        return stemmed;
+    }
+
+    if (_stemCache.size() >= maxCacheSize) {
+        _stemCache.clear();
+    }
+    std::string& cachedStem = _stemCache[word];
+    cachedStem.assign(stemmed.rawData(), stemmed.size());
+    return cachedStem;
 }
 }
 }
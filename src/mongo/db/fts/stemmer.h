@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -62,6 +65,10 @@ public:
 
 private:
     struct sb_stemmer* _stemmer;
+
+    // The stems of the words stemmed most recently, by word. Holds up to textSearchStemCacheSize
+    // of them, and is emptied when full.
+    mutable StringMap<std::string> _stemCache;
 };
 }
 }
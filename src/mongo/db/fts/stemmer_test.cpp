@@ -33,6 +33,8 @@
 
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace fts {
@@ -48,5 +50,28 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, CachedStems) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("textSearchStemCacheSize");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString("2"));
+    ON_BLOCK_EXIT([&] { param->second->setFromString("0").transitional_ignore(); });
+
+    // Stems are the same whether they come from the cache or not, including once it has filled up
+    // and been emptied.
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("Run", s.stem("Running"));
+        ASSERT_EQUALS("unit", s.stem("united"));
+    }
+}
+
+TEST(English, RejectsNegativeStemCacheSize) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("textSearchStemCacheSize");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_NOT_OK(param->second->setFromString("-1"));
+}
 }
 }
@@ -34,6 +34,7 @@
 
 #include "mongo/db/hasher.h"
 
+#include <cstring>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/util/md5.hpp"
@@ -79,7 +80,171 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+// MD5 appends at least a 0x80 byte and the 8 byte length of its input to it, so inputs of up to
+// this many bytes are hashed as a single 64 byte block.
+const size_t kMaxSingleBlockSize = 64 - 9;
+
+/**
+ * Collects what Hasher would hash for an element into a single MD5 block, so that the block can
+ * be hashed together with those of other elements. Records whether the bytes do not fit instead.
+ */
+class SingleBlockHasher {
+    MONGO_DISALLOW_COPYING(SingleBlockHasher);
+
+public:
+    static const size_t kLanes = 8;
+    // The blocks of 'kLanes' elements, as little-endian words. Word w of the block in lane l is
+    // at [w][l], so that the same word of every block can be read at once.
+    typedef uint32_t Blocks[16][kLanes];
+
+    explicit SingleBlockHasher(HashSeed seed) {
+        addData(&seed, sizeof(seed));
+    }
+
+    void addData(const void* keyData, size_t numBytes) {
+        if (_overflowed || numBytes > kMaxSingleBlockSize - _size) {
+            _overflowed = true;
+            return;
+        }
+        std::memcpy(_data + _size, keyData, numBytes);
+        _size += numBytes;
+    }
+
+    bool overflowed() const {
+        return _overflowed;
+    }
+
+    // Writes the padded block into lane 'lane' of 'blocks'. Only call this if !overflowed().
+    void writeBlock(Blocks* blocks, size_t lane) const;
+
+private:
+    unsigned char _data[kMaxSingleBlockSize];
+    size_t _size = 0;
+    bool _overflowed = false;
+};
+
+void SingleBlockHasher::writeBlock(Blocks* blocks, size_t lane) const {
+    char block[64] = {};
+    std::memcpy(block, _data, _size);
+    block[_size] = static_cast<char>(0x80);
+    DataView(block + 56).write<LittleEndian<uint64_t>>(static_cast<uint64_t>(_size) * 8);
+
+    ConstDataView blockView(block);
+    for (size_t word = 0; word < 16; ++word) {
+        (*blocks)[word][lane] = blockView.read<LittleEndian<uint32_t>>(word * 4);
+    }
+}
+
+const uint32_t kMD5SineTable[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+    0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+    0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+    0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+    0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+    0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+const int kMD5Shifts[64] = {7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22,
+                            5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20,
+                            4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23,
+                            6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21};
+
+// The index of the word of the block used by step 'i' of MD5.
+int md5MessageWord(int i) {
+    switch (i / 16) {
+        case 0:
+            return i;
+        case 1:
+            return (5 * i + 1) % 16;
+        case 2:
+            return (3 * i + 5) % 16;
+        default:
+            return (7 * i) % 16;
+    }
+}
+
+template <int kRound>
+uint32_t md5Function(uint32_t b, uint32_t c, uint32_t d) {
+    switch (kRound) {
+        case 0:
+            return (b & c) | (~b & d);
+        case 1:
+            return (b & d) | (c & ~d);
+        case 2:
+            return b ^ c ^ d;
+        default:
+            return c ^ (b | ~d);
+    }
+}
+
+/**
+ * Applies the 16 steps of one MD5 round to every lane. Each step does the same thing to all the
+ * lanes, so that the inner loops can be vectorized.
+ */
+template <int kRound>
+void md5Round(uint32_t* a,
+              uint32_t* b,
+              uint32_t* c,
+              uint32_t* d,
+              const SingleBlockHasher::Blocks& blocks) {
+    const size_t kLanes = SingleBlockHasher::kLanes;
+    for (int step = 0; step < 16; ++step) {
+        const int i = kRound * 16 + step;
+        const uint32_t* x = blocks[md5MessageWord(i)];
+        const uint32_t sine = kMD5SineTable[i];
+        const int shift = kMD5Shifts[i];
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            const uint32_t sum = a[lane] + md5Function<kRound>(b[lane], c[lane], d[lane]) + sine +
+                x[lane];
+            const uint32_t rotated = (sum << shift) | (sum >> (32 - shift));
+            a[lane] = d[lane];
+            d[lane] = c[lane];
+            c[lane] = b[lane];
+            b[lane] = b[lane] + rotated;
+        }
+    }
+}
+
+/**
+ * Computes the MD5 digests of the single blocks in every lane of 'blocks' and stores their first
+ * 8 bytes, read as a little-endian integer like hash64() does, in 'out'.
+ */
+void md5SingleBlocks(const SingleBlockHasher::Blocks& blocks,
+                     long long (&out)[SingleBlockHasher::kLanes]) {
+    const size_t kLanes = SingleBlockHasher::kLanes;
+    uint32_t a[kLanes], b[kLanes], c[kLanes], d[kLanes];
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        a[lane] = 0x67452301;
+        b[lane] = 0xefcdab89;
+        c[lane] = 0x98badcfe;
+        d[lane] = 0x10325476;
+    }
+
+    md5Round<0>(a, b, c, d, blocks);
+    md5Round<1>(a, b, c, d, blocks);
+    md5Round<2>(a, b, c, d, blocks);
+    md5Round<3>(a, b, c, d, blocks);
+
+    // The digest starts with the little-endian bytes of 'a' and then those of 'b'.
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        const uint64_t low = a[lane] + 0x67452301U;
+        const uint64_t high = b[lane] + 0xefcdab89U;
+        out[lane] = static_cast<long long>((high << 32) | static_cast<uint32_t>(low));
+    }
+}
+
+template <typename HasherType>
+void recursiveHash(HasherType* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -122,6 +287,8 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64Batch({o.firstElement()}, 0) ==
+               std::vector<long long>{-944302157085130861LL});
     }
 } hasherUnitTest;
 
@@ -137,4 +304,47 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+std::vector<long long> BSONElementHasher::hash64Batch(const std::vector<BSONElement>& elements,
+                                                      HashSeed seed) {
+    const size_t kLanes = SingleBlockHasher::kLanes;
+    std::vector<long long> hashes(elements.size());
+
+    SingleBlockHasher::Blocks blocks = {};
+    size_t laneElements[kLanes];
+    size_t numLanes = 0;
+    auto hashLanes = [&] {
+        long long laneHashes[kLanes];
+        md5SingleBlocks(blocks, laneHashes);
+        for (size_t lane = 0; lane < numLanes; ++lane) {
+            hashes[laneElements[lane]] = laneHashes[lane];
+        }
+        numLanes = 0;
+    };
+
+    for (size_t i = 0; i < elements.size(); ++i) {
+        // Elements with larger values hardly ever fit, so their bytes are not collected.
+        const bool mayFit = elements[i].valuesize() <= static_cast<int>(kMaxSingleBlockSize);
+        SingleBlockHasher h(seed);
+        if (mayFit) {
+            recursiveHash(&h, elements[i], false);
+        }
+
+        if (!mayFit || h.overflowed()) {
+            hashes[i] = hash64(elements[i], seed);
+            continue;
+        }
+
+        h.writeBlock(&blocks, numLanes);
+        laneElements[numLanes++] = i;
+        if (numLanes == kLanes) {
+            hashLanes();
+        }
+    }
+
+    if (numLanes > 0) {
+        hashLanes();
+    }
+    return hashes;
+}
+
 }  // namespace mongo
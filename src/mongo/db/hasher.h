@@ -34,6 +34,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bsonelement.h"
 
@@ -68,6 +70,15 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* Returns the hash64() of each of "elements", in order. The elements that hash
+     * few enough bytes to fit in a single MD5 block are hashed several at a time,
+     * one per lane of a vectorizable MD5 implementation, which makes hashing many
+     * small values, such as most shard key values, faster than hashing them one by
+     * one. Larger elements are hashed by hash64().
+     */
+    static std::vector<long long> hash64Batch(const std::vector<BSONElement>& elements,
+                                              HashSeed seed);
+
 private:
     BSONElementHasher();
 };
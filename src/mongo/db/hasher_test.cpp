@@ -359,5 +359,36 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+TEST(BSONElementHasher, BatchHashesMatchSingleHashes) {
+    BSONArrayBuilder values;
+    for (int i = 0; i < 100; ++i) {
+        values.append(i);
+        values.append(i * 1.5);
+        values.append(static_cast<long long>(i) << 40);
+        values.append(std::string(i, 'x'));
+        values.append(BSON("a" << i << "b" << BSON_ARRAY(i << "y")));
+    }
+    values.appendNull();
+    values.append(BSON("" << MINKEY).firstElement());
+    values.append(OID("010203040506070809101112"));
+    values.append(BSONCodeWScope("func f() { return 1; }", BSON("c" << true)));
+    const BSONArray array = values.arr();
+
+    std::vector<BSONElement> elements;
+    for (const auto& element : array) {
+        elements.push_back(element);
+    }
+
+    for (int seed : {0, 1, -42}) {
+        const std::vector<long long> hashes = BSONElementHasher::hash64Batch(elements, seed);
+        ASSERT_EQUALS(hashes.size(), elements.size());
+        for (size_t i = 0; i < elements.size(); ++i) {
+            ASSERT_EQUALS(hashes[i], BSONElementHasher::hash64(elements[i], seed)) << elements[i];
+        }
+    }
+
+    ASSERT(BSONElementHasher::hash64Batch({}, 0).empty());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -30,20 +30,143 @@
 
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/collation/collation_index_key.h"
 
 namespace mongo {
 
+namespace {
+
+// The value of the first field of a multikey metadata key. Path keys begin with a string, so the
+// metadata keys sort before all of them.
+const int kMultikeyMetadataKeyVal = 1;
+
+std::string appendPath(const std::string& path, StringData fieldName) {
+    return path.empty() ? fieldName.toString() : path + '.' + fieldName;
+}
+
+}  // namespace
+
 // Standard AllPaths implementation below.
 AllPathsAccessMethod::AllPathsAccessMethod(IndexCatalogEntry* allPathsState,
                                            SortedDataInterface* btree)
     : IndexAccessMethod(allPathsState, btree) {
-    // TODO: SERVER-35325: Implement AllPathsAcessMethod.
+    FieldRef keyPath(_descriptor->keyPattern().firstElementFieldName());
+    invariant(keyPath.numParts() > 0 && keyPath.getPart(keyPath.numParts() - 1) == "$**");
+    if (keyPath.numParts() > 1) {
+        _prefix.parse(keyPath.dottedSubstring(0, keyPath.numParts() - 1));
+    }
 }
 
 void AllPathsAccessMethod::doGetKeys(const BSONObj& obj,
                                      BSONObjSet* keys,
                                      MultikeyPaths* multikeyPaths) const {
-    // TODO: SERVER-35325: Implement AllPathsAcessMethod.
+    // The index tracks multikeyness per path through its metadata keys rather than through the
+    // catalog's path-level multikey information.
+    if (_prefix.numParts() == 0) {
+        _traverseObject(obj, "", true, keys);
+    } else {
+        _traversePrefix(obj, 0, "", keys);
+    }
+}
+
+void AllPathsAccessMethod::_traversePrefix(const BSONObj& obj,
+                                           size_t depth,
+                                           const std::string& path,
+                                           BSONObjSet* keys) const {
+    const StringData fieldName = _prefix.getPart(depth);
+    BSONElement elem = obj[fieldName];
+    if (elem.eoo()) {
+        return;
+    }
+
+    const std::string elemPath = appendPath(path, fieldName);
+    if (depth + 1 == _prefix.numParts()) {
+        _traverseElement(elem, elemPath, keys);
+    } else if (elem.type() == BSONType::Object) {
+        _traversePrefix(elem.Obj(), depth + 1, elemPath, keys);
+    } else if (elem.type() == BSONType::Array) {
+        _addMultikeyMetadataKey(elemPath, keys);
+        for (auto&& arrayElem : elem.Obj()) {
+            if (arrayElem.type() == BSONType::Object) {
+                _traversePrefix(arrayElem.Obj(), depth + 1, elemPath, keys);
+            }
+        }
+    }
+}
+
+void AllPathsAccessMethod::_traverseObject(const BSONObj& obj,
+                                           const std::string& path,
+                                           bool isTopLevel,
+                                           BSONObjSet* keys) const {
+    for (auto&& elem : obj) {
+        // The _id field has its own index, so an index over the whole document leaves it out.
+        if (isTopLevel && elem.fieldNameStringData() == "_id") {
+            continue;
+        }
+        _traverseElement(elem, appendPath(path, elem.fieldNameStringData()), keys);
+    }
+}
+
+void AllPathsAccessMethod::_traverseElement(BSONElement elem,
+                                            const std::string& path,
+                                            BSONObjSet* keys) const {
+    if (elem.type() == BSONType::Object && !elem.Obj().isEmpty()) {
+        _traverseObject(elem.Obj(), path, false, keys);
+        return;
+    }
+
+    if (elem.type() != BSONType::Array || elem.Obj().isEmpty()) {
+        _addPathKey(elem, path, keys);
+        return;
+    }
+
+    // The elements of an array are indexed under the path of the array itself. An array nested
+    // directly inside an array is indexed as a single value.
+    _addMultikeyMetadataKey(path, keys);
+    for (auto&& arrayElem : elem.Obj()) {
+        if (arrayElem.type() == BSONType::Object && !arrayElem.Obj().isEmpty()) {
+            _traverseObject(arrayElem.Obj(), path, false, keys);
+        } else {
+            _addPathKey(arrayElem, path, keys);
+        }
+    }
+}
+
+void AllPathsAccessMethod::_addPathKey(BSONElement elem,
+                                       const std::string& path,
+                                       BSONObjSet* keys) const {
+    BSONObjBuilder bob;
+    bob.append("", path);
+    CollationIndexKey::collationAwareIndexKeyAppend(elem, _btreeState->getCollator(), &bob);
+    keys->insert(bob.obj());
+}
+
+void AllPathsAccessMethod::_addMultikeyMetadataKey(const std::string& path,
+                                                   BSONObjSet* keys) const {
+    keys->insert(BSON("" << kMultikeyMetadataKeyVal << "" << path));
+}
+
+std::set<std::string> AllPathsAccessMethod::getMultikeyPathSet(OperationContext* opCtx) const {
+    std::set<std::string> multikeyPaths;
+    auto cursor = newCursor(opCtx);
+
+    // Each multikey path has one metadata key per document which holds an array along it, so
+    // after reading a path we seek past all of its remaining entries.
+    auto entry = cursor->seek(BSON("" << kMultikeyMetadataKeyVal << ""
+                                         << ""),
+                              true);
+    while (entry) {
+        BSONObjIterator it(entry->key);
+        BSONElement first = it.next();
+        if (!first.isNumber() || first.numberInt() != kMultikeyMetadataKeyVal) {
+            break;
+        }
+        BSONElement pathElem = it.next();
+        invariant(pathElem.type() == BSONType::String);
+        multikeyPaths.insert(pathElem.String());
+        entry = cursor->seek(BSON("" << kMultikeyMetadataKeyVal << "" << pathElem.String()), false);
+    }
+    return multikeyPaths;
 }
 
 }  // namespace mongo
@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <set>
+#include <string>
+
+#include "mongo/db/field_ref.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/jsobj.h"
 
@@ -41,8 +45,37 @@ class AllPathsAccessMethod : public IndexAccessMethod {
 public:
     AllPathsAccessMethod(IndexCatalogEntry* allPathsState, SortedDataInterface* btree);
 
+    /**
+     * Returns the set of dotted paths, relative to the root of the document, which hold an array
+     * in at least one indexed document. The set is read from the multikey metadata keys stored in
+     * the index, so it may also contain paths whose arrays have since been removed.
+     */
+    std::set<std::string> getMultikeyPathSet(OperationContext* opCtx) const;
+
 private:
+    /**
+     * Every leaf value under the indexed prefix generates the key {"": <path>, "": <value>}, where
+     * <path> is the dotted path of the value with any array positions omitted. In addition, every
+     * path which holds an array generates the multikey metadata key
+     * {"": 1, "": <path>}, which sorts before all of the path keys.
+     */
     void doGetKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const final;
+
+    void _traversePrefix(const BSONObj& obj,
+                         size_t depth,
+                         const std::string& path,
+                         BSONObjSet* keys) const;
+    void _traverseObject(const BSONObj& obj,
+                         const std::string& path,
+                         bool isTopLevel,
+                         BSONObjSet* keys) const;
+    void _traverseElement(BSONElement elem, const std::string& path, BSONObjSet* keys) const;
+    void _addPathKey(BSONElement elem, const std::string& path, BSONObjSet* keys) const;
+    void _addMultikeyMetadataKey(const std::string& path, BSONObjSet* keys) const;
+
+    // The path preceding the "$**" component of the key pattern. Empty if the whole document is
+    // indexed.
+    FieldRef _prefix;
 };
 
 }  // namespace mongo
@@ -87,7 +87,9 @@ void BtreeKeyGenerator::getKeys(const BSONObj& obj,
                                 MultikeyPaths* multikeyPaths) const {
     // '_fieldNames' and '_fixed' are passed by value so that they can be mutated as part of the
     // getKeys call.  :|
-    getKeysImpl(_fieldNames, _fixed, obj, keys, multikeyPaths);
+    if (!getKeysWithoutArrays(obj, keys, multikeyPaths)) {
+        getKeysImpl(_fieldNames, _fixed, obj, keys, multikeyPaths);
+    }
     if (keys->empty() && !_isSparse) {
         keys->insert(_nullKey);
     }
@@ -347,6 +349,44 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
         std::move(fieldNames), std::move(fixed), obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
 }
 
+bool BtreeKeyGeneratorV1::getKeysWithoutArrays(const BSONObj& obj,
+                                               BSONObjSet* keys,
+                                               MultikeyPaths* multikeyPaths) const {
+    if (_isIdIndex) {
+        // getKeysImpl() already special cases the _id index.
+        return false;
+    }
+
+    BSONObjBuilder b(_sizeTracker);
+    unsigned numNotFound = 0;
+    for (size_t i = 0; i < _fieldNames.size(); ++i) {
+        if (*_fieldNames[i] == '\0') {
+            CollationIndexKey::collationAwareIndexKeyAppend(_fixed[i], _collator, &b);
+            continue;
+        }
+
+        const char* remainingPath = _fieldNames[i];
+        BSONElement e = dps::extractElementAtPathOrArrayAlongPath(obj, remainingPath);
+        if (e.type() == Array) {
+            return false;
+        }
+        if (e.eoo()) {
+            e = nullElt;
+            numNotFound++;
+        }
+        CollationIndexKey::collationAwareIndexKeyAppend(e, _collator, &b);
+    }
+
+    if (multikeyPaths) {
+        invariant(multikeyPaths->empty());
+        multikeyPaths->resize(_fieldNames.size());
+    }
+    if (!_isSparse || numNotFound != _fieldNames.size()) {
+        keys->insert(b.obj());
+    }
+    return true;
+}
+
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
     std::vector<const char*> fieldNames,
     std::vector<BSONElement> fixed,
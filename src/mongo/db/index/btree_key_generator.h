@@ -68,6 +68,7 @@ protected:
     bool _isSparse;
     BSONObj _nullKey;  // a full key with all fields null
     BSONSizeTracker _sizeTracker;
+    std::vector<BSONElement> _fixed;
 
 private:
     virtual void getKeysImpl(std::vector<const char*> fieldNames,
@@ -76,7 +77,16 @@ private:
                              BSONObjSet* keys,
                              MultikeyPaths* multikeyPaths) const = 0;
 
-    std::vector<BSONElement> _fixed;
+    /**
+     * Generates the keys of 'obj' in a single pass over the indexed paths, without copying the key
+     * pattern, if this is cheaper than getKeysImpl(). Returns false, leaving 'keys' and
+     * 'multikeyPaths' untouched, if getKeysImpl() must be used instead.
+     */
+    virtual bool getKeysWithoutArrays(const BSONObj& obj,
+                                      BSONObjSet* keys,
+                                      MultikeyPaths* multikeyPaths) const {
+        return false;
+    }
 };
 
 class BtreeKeyGeneratorV0 : public BtreeKeyGenerator {
@@ -185,6 +195,16 @@ private:
                      BSONObjSet* keys,
                      MultikeyPaths* multikeyPaths) const final;
 
+    /**
+     * Generates the single key of 'obj' when none of the indexed paths in 'obj' holds or traverses
+     * an array, which is the common case for an index that isn't multikey. Gives up as soon as it
+     * meets an array, leaving the expansion of arrays and the tracking of multikey paths to
+     * getKeysImplWithArray().
+     */
+    bool getKeysWithoutArrays(const BSONObj& obj,
+                              BSONObjSet* keys,
+                              MultikeyPaths* multikeyPaths) const final;
+
     /**
      * This recursive method does the heavy-lifting for getKeysImpl().
      */
@@ -1160,4 +1160,36 @@ TEST(BtreeKeyGeneratorTest, GetCollationAwareKeysFromNestedArray) {
         testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths, false, &collator));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromCompoundIndexWithNumericFieldNamesOfSubobject) {
+    BSONObj keyPattern = fromjson("{'a.0.b': 1, c: 1}");
+    BSONObj genKeysFrom = fromjson("{a: {'0': {b: 5}}, c: 'foo'}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 5, '': 'foo'}"));
+    MultikeyPaths expectedMultikeyPaths{std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromCompoundIndexWithArrayOnLastIndexedPath) {
+    BSONObj keyPattern = fromjson("{a: 1, b: 1, 'c.d': 1}");
+    BSONObj genKeysFrom = fromjson("{a: 1, b: {x: 2}, c: {d: [3, 4]}}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 1, '': {x: 2}, '': 3}"));
+    expectedKeys.insert(fromjson("{'': 1, '': {x: 2}, '': 4}"));
+    MultikeyPaths expectedMultikeyPaths{std::set<size_t>{}, std::set<size_t>{}, {1U}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromSparseCompoundIndexWithoutArrays) {
+    const bool sparse = true;
+    BSONObj keyPattern = fromjson("{a: 1, 'b.c': 1}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths expectedMultikeyPaths{std::set<size_t>{}, std::set<size_t>{}};
+    ASSERT(testKeygen(
+        keyPattern, fromjson("{b: 1, c: 2}"), expectedKeys, expectedMultikeyPaths, sparse));
+
+    expectedKeys.insert(fromjson("{'': null, '': 2}"));
+    ASSERT(testKeygen(
+        keyPattern, fromjson("{b: {c: 2}}"), expectedKeys, expectedMultikeyPaths, sparse));
+}
+
 }  // namespace
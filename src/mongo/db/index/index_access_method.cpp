@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -126,6 +127,17 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     // Delegate to the subclass.
     getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
 
+    if (auto interceptor = _btreeState->indexBuildInterceptor()) {
+        for (const auto& key : keys) {
+            interceptor->sideWrite(opCtx, key, loc, IndexBuildInterceptor::Op::kInsert);
+        }
+        *numInserted = keys.size();
+        if (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths)) {
+            _btreeState->setMultikey(opCtx, multikeyPaths);
+        }
+        return Status::OK();
+    }
+
     Status ret = Status::OK();
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         Status status = _newInterface->insert(opCtx, *i, loc, options.dupsAllowed);
@@ -169,6 +181,67 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     return ret;
 }
 
+Status IndexAccessMethod::insertSorted(OperationContext* opCtx,
+                                       const std::vector<BsonRecord>& bsonRecords,
+                                       const InsertDeleteOptions& options,
+                                       int64_t* numInserted) {
+    invariant(numInserted);
+    invariant(!_btreeState->indexBuildInterceptor());
+    *numInserted = 0;
+
+    std::vector<BtreeExternalSortComparison::Data> entries;
+    std::vector<MultikeyPaths> multikeyPathsToSet;
+    for (const auto& bsonRecord : bsonRecords) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*bsonRecord.docPtr, options.getKeysMode, &keys, &multikeyPaths);
+
+        if (keys.size() > 1 || isMultikeyFromPaths(multikeyPaths)) {
+            multikeyPathsToSet.push_back(std::move(multikeyPaths));
+        }
+        for (const auto& key : keys) {
+            entries.emplace_back(key, bsonRecord.id);
+        }
+    }
+
+    const BtreeExternalSortComparison comparator(_descriptor->keyPattern(),
+                                                 _descriptor->version());
+    std::sort(entries.begin(),
+              entries.end(),
+              [&](const BtreeExternalSortComparison::Data& l,
+                  const BtreeExternalSortComparison::Data& r) { return comparator(l, r) < 0; });
+
+    for (auto i = entries.begin(); i != entries.end(); ++i) {
+        Status status = _newInterface->insert(opCtx, i->first, i->second, options.dupsAllowed);
+        if (status.isOK()) {
+            ++*numInserted;
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue && !_btreeState->isReady(opCtx)) {
+            LOG(3) << "key " << i->first << " already in index during background indexing (ok)";
+            continue;
+        }
+
+        // Clean up after ourselves.
+        for (auto j = entries.begin(); j != i; ++j) {
+            removeOneKey(opCtx, j->first, j->second, options.dupsAllowed);
+        }
+        *numInserted = 0;
+        return status;
+    }
+
+    for (const auto& multikeyPaths : multikeyPathsToSet) {
+        _btreeState->setMultikey(opCtx, multikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -185,6 +258,24 @@ void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
     }
 }
 
+Status IndexAccessMethod::applySideWrite(OperationContext* opCtx,
+                                         const BSONObj& key,
+                                         const RecordId& loc,
+                                         IndexBuildInterceptor::Op op) {
+    // Duplicates are allowed because the side writes may pass through states the collection was
+    // never in. A unique index checks its keys once all of them are applied.
+    if (op == IndexBuildInterceptor::Op::kDelete) {
+        removeOneKey(opCtx, key, loc, true /* dupsAllowed */);
+        return Status::OK();
+    }
+
+    Status status = _newInterface->insert(opCtx, key, loc, true /* dupsAllowed */);
+    if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+        return Status::OK();
+    }
+    return status;
+}
+
 std::unique_ptr<SortedDataInterface::Cursor> IndexAccessMethod::newCursor(OperationContext* opCtx,
                                                                           bool isForward) const {
     return _newInterface->newCursor(opCtx, isForward);
@@ -213,8 +304,13 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     // those that don't apply to the partialIndex filter.
     getKeys(obj, GetKeysMode::kRelaxConstraintsUnfiltered, &keys, multikeyPaths);
 
+    auto interceptor = _btreeState->indexBuildInterceptor();
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
-        removeOneKey(opCtx, *i, loc, options.dupsAllowed);
+        if (interceptor) {
+            interceptor->sideWrite(opCtx, *i, loc, IndexBuildInterceptor::Op::kDelete);
+        } else {
+            removeOneKey(opCtx, *i, loc, options.dupsAllowed);
+        }
         ++*numDeleted;
     }
 
@@ -288,6 +384,10 @@ bool IndexAccessMethod::appendCustomStats(OperationContext* opCtx,
     return _newInterface->appendCustomStats(opCtx, output, scale);
 }
 
+void IndexAccessMethod::appendIndexStats(BSONObjBuilder* builder) const {
+    _newInterface->appendIndexStats(builder);
+}
+
 long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* opCtx) const {
     return _newInterface->getSpaceUsedBytes(opCtx);
 }
@@ -376,6 +476,18 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         _btreeState->setMultikey(opCtx, ticket.newMultikeyPaths);
     }
 
+    if (auto interceptor = _btreeState->indexBuildInterceptor()) {
+        for (const auto& key : ticket.removed) {
+            interceptor->sideWrite(opCtx, key, ticket.loc, IndexBuildInterceptor::Op::kDelete);
+        }
+        for (const auto& key : ticket.added) {
+            interceptor->sideWrite(opCtx, key, ticket.loc, IndexBuildInterceptor::Op::kInsert);
+        }
+        *numInserted = ticket.added.size();
+        *numDeleted = ticket.removed.size();
+        return Status::OK();
+    }
+
     for (size_t i = 0; i < ticket.removed.size(); ++i) {
         _newInterface->unindex(opCtx, ticket.removed[i], ticket.loc, ticket.dupsAllowed);
         IndexKeyEntry indexEntry = IndexKeyEntry(ticket.removed[i], ticket.loc);
@@ -33,6 +33,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -45,6 +46,7 @@ namespace mongo {
 extern AtomicBool failIndexKeyTooLong;
 
 class BSONObjBuilder;
+struct BsonRecord;
 class MatchExpression;
 class UpdateTicket;
 struct InsertDeleteOptions;
@@ -85,7 +87,19 @@ public:
                   int64_t* numInserted);
 
     /**
-     * Analogous to above, but remove the records instead of inserting them.
+     * Analogous to above for each of 'bsonRecords', but generates the keys of all of the documents
+     * first and inserts them into the index in its key order, so that consecutive inserts touch
+     * neighbouring parts of the index. Ignores the records' timestamps, which the caller must have
+     * set. If inserting any key fails, none of the keys are left in the index. Must not be called
+     * while the index has an IndexBuildInterceptor.
+     */
+    Status insertSorted(OperationContext* opCtx,
+                        const std::vector<BsonRecord>& bsonRecords,
+                        const InsertDeleteOptions& options,
+                        int64_t* numInserted);
+
+    /**
+     * Analogous to insert(), but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
      */
     Status remove(OperationContext* opCtx,
@@ -128,6 +142,16 @@ public:
                   int64_t* numInserted,
                   int64_t* numDeleted);
 
+    /**
+     * Inserts or removes the single entry ('key' -> 'loc') that an IndexBuildInterceptor absorbed
+     * while this index was being built, allowing duplicates. Unlike the methods above, this writes
+     * to the index even while it has an interceptor.
+     */
+    Status applySideWrite(OperationContext* opCtx,
+                          const BSONObj& key,
+                          const RecordId& loc,
+                          IndexBuildInterceptor::Op op);
+
     /**
      * Returns an unpositioned cursor over 'this' index.
      */
@@ -176,6 +200,11 @@ public:
      */
     bool appendCustomStats(OperationContext* opCtx, BSONObjBuilder* result, double scale) const;
 
+    /**
+     * Add the in-memory statistics the storage engine keeps about this index to 'builder'.
+     */
+    void appendIndexStats(BSONObjBuilder* builder) const;
+
     /**
      * @return The number of bytes consumed by this index.
      *         Exactly what is counted is not defined based on padding, re-use, etc...
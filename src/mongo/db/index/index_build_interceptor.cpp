@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_build_interceptor.h"
+
+#include <utility>
+#include <vector>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+void IndexBuildInterceptor::sideWrite(OperationContext* opCtx,
+                                      const BSONObj& key,
+                                      const RecordId& loc,
+                                      Op op) {
+    long long sequenceNumber;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        sequenceNumber = _nextSequenceNumber++;
+        SideWrite& sideWrite = _sideWrites[sequenceNumber];
+        sideWrite.op = op;
+        sideWrite.key = key.getOwned();
+        sideWrite.loc = loc;
+    }
+
+    // The side write is numbered when it is made rather than when it commits: two writes to the
+    // same document cannot both be in progress, so this orders the writes to every document.
+    opCtx->recoveryUnit()->onCommit([this, sequenceNumber](boost::optional<Timestamp>) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sideWrites[sequenceNumber].committed = true;
+    });
+    opCtx->recoveryUnit()->onRollback([this, sequenceNumber]() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sideWrites.erase(sequenceNumber);
+    });
+}
+
+Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
+                                                   IndexAccessMethod* indexAccessMethod) {
+    // Side writes applied by an enclosing unit of work that has not committed are still in
+    // '_sideWrites', so the position reached is tracked here.
+    long long nextToApply = 0;
+    while (true) {
+        std::vector<std::pair<long long, SideWrite>> batch;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            for (auto it = _sideWrites.lower_bound(nextToApply);
+                 it != _sideWrites.end() && it->second.committed && batch.size() < kBatchSize;
+                 ++it) {
+                batch.push_back(*it);
+            }
+        }
+        if (batch.empty()) {
+            return Status::OK();
+        }
+
+        Status status = writeConflictRetry(opCtx, "index build drain", "", [&] {
+            WriteUnitOfWork wunit(opCtx);
+            for (const auto& entry : batch) {
+                const SideWrite& sideWrite = entry.second;
+                Status status = indexAccessMethod->applySideWrite(
+                    opCtx, sideWrite.key, sideWrite.loc, sideWrite.op);
+                if (!status.isOK()) {
+                    return status;
+                }
+
+                // Keeping a key whose insert is rolled back only costs an extra check.
+                if (_unique && sideWrite.op == Op::kInsert) {
+                    stdx::lock_guard<stdx::mutex> lk(_mutex);
+                    _appliedUniqueKeys.insert(sideWrite.key);
+                }
+            }
+
+            opCtx->recoveryUnit()->onCommit([this, batch](boost::optional<Timestamp>) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                for (const auto& entry : batch) {
+                    _sideWrites.erase(entry.first);
+                }
+                _numApplied += batch.size();
+            });
+            wunit.commit();
+            return Status::OK();
+        });
+        if (!status.isOK()) {
+            return status;
+        }
+
+        nextToApply = batch.back().first + 1;
+    }
+}
+
+Status IndexBuildInterceptor::checkDuplicateKeyConstraints(
+    OperationContext* opCtx, const IndexAccessMethod* indexAccessMethod) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_appliedUniqueKeys.empty()) {
+        return Status::OK();
+    }
+
+    auto cursor = indexAccessMethod->newCursor(opCtx);
+    for (const auto& key : _appliedUniqueKeys) {
+        int numEntries = 0;
+        for (auto entry = cursor->seek(key, true);
+             entry && entry->key.woCompare(key, BSONObj(), /*considerFieldNames*/ false) == 0;
+             entry = cursor->next()) {
+            if (++numEntries > 1) {
+                return Status(ErrorCodes::DuplicateKey,
+                              str::stream() << "E11000 duplicate key error dup key: "
+                                            << redact(key)
+                                            << " was written while the index was being built");
+            }
+        }
+    }
+    return Status::OK();
+}
+
+bool IndexBuildInterceptor::areAllWritesApplied() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sideWrites.empty();
+}
+
+long long IndexBuildInterceptor::getNumApplied() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numApplied;
+}
+
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class OperationContext;
+
+/**
+ * Absorbs the writes made to an index while a hybrid index build fills it from a scan of the
+ * collection that does not hold off concurrent writers. Writers hand their keys to the interceptor
+ * instead of the index, and the build applies them to the index, in the order they were made, once
+ * the keys of the scan are loaded. Since inserting a key that is already there and removing one
+ * that is not are both no-ops, replaying every side write over the scan leaves the index matching
+ * the collection however the two interleaved.
+ *
+ * The side writes are kept in memory, so they are lost with the build if the server shuts down in
+ * the middle of it, which restarts the build anyway.
+ *
+ * All methods are thread-safe, but only the thread running the build may call
+ * drainWritesIntoIndex() and checkDuplicateKeyConstraints(). The interceptor must outlive every
+ * WriteUnitOfWork that recorded a side write.
+ */
+class IndexBuildInterceptor {
+    MONGO_DISALLOW_COPYING(IndexBuildInterceptor);
+
+public:
+    enum class Op { kInsert, kDelete };
+
+    /**
+     * If 'unique' is true, the interceptor remembers the keys it applies so that
+     * checkDuplicateKeyConstraints() can look for values indexed by several documents.
+     */
+    explicit IndexBuildInterceptor(bool unique) : _unique(unique) {}
+
+    /**
+     * Records that the current WriteUnitOfWork inserted or removed the index entry ('key' ->
+     * 'loc'). The side write is applied by drainWritesIntoIndex() once the unit of work commits and
+     * is forgotten if it rolls back.
+     */
+    void sideWrite(OperationContext* opCtx, const BSONObj& key, const RecordId& loc, Op op);
+
+    /**
+     * Applies the committed side writes to the index of 'indexAccessMethod' in the order they were
+     * made, in units of work of at most 'kBatchSize' side writes. Stops at the first side write
+     * whose unit of work has not committed yet, so only a call made while holding an exclusive lock
+     * on the collection is certain to leave nothing behind.
+     *
+     * May be called inside of a WriteUnitOfWork, in which case the applied side writes are only
+     * forgotten if the outermost unit of work commits.
+     */
+    Status drainWritesIntoIndex(OperationContext* opCtx, IndexAccessMethod* indexAccessMethod);
+
+    /**
+     * For a unique index, returns DuplicateKey if any key inserted by drainWritesIntoIndex() now
+     * refers to more than one document in the index.
+     */
+    Status checkDuplicateKeyConstraints(OperationContext* opCtx,
+                                        const IndexAccessMethod* indexAccessMethod) const;
+
+    /**
+     * Returns true if there is no side write left to apply, committed or not.
+     */
+    bool areAllWritesApplied() const;
+
+    long long getNumApplied() const;
+
+    static const size_t kBatchSize = 1000;
+
+private:
+    struct SideWrite {
+        Op op;
+        BSONObj key;
+        RecordId loc;
+        bool committed = false;
+    };
+
+    const bool _unique;
+
+    mutable stdx::mutex _mutex;
+
+    // Side writes not yet applied, keyed by the order in which they were made.
+    std::map<long long, SideWrite> _sideWrites;
+    long long _nextSequenceNumber = 0;
+    long long _numApplied = 0;
+
+    // For a unique index, the keys inserted by side writes. Every pair of documents sharing a key
+    // has at least one of its entries inserted by a side write, because the keys of the scan are
+    // loaded without allowing duplicates and the documents they reject are indexed again through
+    // side writes.
+    BSONObjSet _appliedUniqueKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+};
+
+}  // namespace mongo
@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/index/sort_key_generator.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kDoc = BSON("_id" << 1 << "a" << 5 << "b"
+                                << "a string to sort by"
+                                << "c"
+                                << BSON("d" << 3.5 << "e" << BSON_ARRAY(4 << 1 << 9))
+                                << "padding"
+                                << "some unrelated data that the generator has to skip");
+
+void runGetSortKey(benchmark::State& state,
+                   const BSONObj& sortSpec,
+                   const CollatorInterface* collator) {
+    const SortKeyGenerator generator(sortSpec, collator);
+    const SortKeyGenerator::Metadata metadata;
+    for (auto keepRunning : state) {
+        auto sortKey = generator.getSortKey(kDoc, &metadata);
+        benchmark::DoNotOptimize(sortKey.getValue().objdata());
+    }
+}
+
+void BM_GetSortKey(benchmark::State& state, BSONObj sortSpec) {
+    runGetSortKey(state, sortSpec, nullptr);
+}
+
+void BM_GetSortKeyWithCollation(benchmark::State& state, BSONObj sortSpec) {
+    const CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    runGetSortKey(state, sortSpec, &collator);
+}
+
+BENCHMARK_CAPTURE(BM_GetSortKey, SingleField, BSON("a" << 1));
+BENCHMARK_CAPTURE(BM_GetSortKey, Compound, BSON("a" << 1 << "b" << -1));
+BENCHMARK_CAPTURE(BM_GetSortKey, Dotted, BSON("c.d" << 1));
+BENCHMARK_CAPTURE(BM_GetSortKey, Array, BSON("c.e" << 1));
+BENCHMARK_CAPTURE(BM_GetSortKeyWithCollation, String, BSON("b" << 1));
+
+}  // namespace
+}  // namespace mongo
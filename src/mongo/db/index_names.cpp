@@ -87,6 +87,8 @@ IndexType IndexNames::nameToType(const string& accessMethod) {
         return INDEX_TEXT;
     } else if (IndexNames::HASHED == accessMethod) {
         return INDEX_HASHED;
+    } else if (IndexNames::ALLPATHS == accessMethod) {
+        return INDEX_ALLPATHS;
     } else {
         return INDEX_BTREE;
     }
@@ -52,6 +52,7 @@ enum IndexType {
     INDEX_2DSPHERE,
     INDEX_TEXT,
     INDEX_HASHED,
+    INDEX_ALLPATHS,
 };
 
 /**
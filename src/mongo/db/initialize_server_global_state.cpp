@@ -53,6 +53,7 @@
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -212,6 +213,16 @@ void forkServerOrDie() {
 }
 
 MONGO_EXPORT_SERVER_PARAMETER(maxLogSizeKB, int, logger::LogContext::kDefaultMaxLogSizeKB);
+
+// When positive, messages logged to the log file are written by a background thread, with at most
+// this many waiting to be written. See logger::AsyncAppender.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(logAsyncQueueMaxMessages, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "logAsyncQueueMaxMessages must not be negative");
+        }
+        return Status::OK();
+    });
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
@@ -299,9 +310,14 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        auto fileAppender = std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+            std::make_unique<MessageEventDetailsEncoder>(), writer.getValue());
+        if (logAsyncQueueMaxMessages > 0) {
+            manager->getGlobalDomain()->attachAppender(std::make_unique<logger::AsyncAppender>(
+                std::move(fileAppender), logAsyncQueueMaxMessages));
+        } else {
+            manager->getGlobalDomain()->attachAppender(std::move(fileAppender));
+        }
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
                 std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
@@ -32,15 +32,20 @@
 
 #include "mongo/db/introspect.h"
 
+#include <map>
+
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/deferred_writer.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -52,8 +57,67 @@ using std::unique_ptr;
 using std::endl;
 using std::string;
 
+// When set, profiler entries are handed to a background writer for their database instead of
+// being inserted by the profiled operation, at the cost of showing up in system.profile slightly
+// later and being dropped if the writer falls too far behind.
+MONGO_EXPORT_SERVER_PARAMETER(deferProfilerWrites, bool, false);
+
 namespace {
 
+// The most profiler entries, in bytes, buffered for each database when writes are deferred.
+const int64_t kProfileWriterBufferSize = 16 * 1024 * 1024;
+
+/**
+ * The deferred writers of the system.profile collections, one per database, created on first use.
+ */
+class ProfileWriters {
+public:
+    /**
+     * Buffers 'entry' for the profile collection of 'dbName'. Returns false if it was dropped.
+     */
+    bool insert(const std::string& dbName, BSONObj entry) {
+        // Inserting under the mutex keeps writers from being shut down in the meantime.
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_inShutdown) {
+            return false;
+        }
+
+        auto& writer = _writers[dbName];
+        if (!writer) {
+            writer = stdx::make_unique<DeferredWriter>(
+                NamespaceString(dbName, "system.profile"),
+                [dbName](OperationContext* opCtx) {
+                    AutoGetDb autoGetDb(opCtx, dbName, MODE_X);
+                    if (!autoGetDb.getDb()) {
+                        return Status(ErrorCodes::NamespaceNotFound,
+                                      str::stream() << "not profiling because db went away for "
+                                                    << dbName);
+                    }
+                    return createProfileCollection(opCtx, autoGetDb.getDb());
+                },
+                kProfileWriterBufferSize);
+            writer->startup("profile writer " + dbName);
+        }
+
+        return writer->insertDocument(std::move(entry));
+    }
+
+    void shutdown() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inShutdown = true;
+        for (auto& writer : _writers) {
+            writer.second->shutdown();
+        }
+    }
+
+private:
+    stdx::mutex _mutex;
+    bool _inShutdown = false;
+    std::map<std::string, std::unique_ptr<DeferredWriter>> _writers;
+};
+
+const auto getProfileWriters = ServiceContext::declareDecoration<ProfileWriters>();
+
 void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSession* authSession) {
     UserNameIterator nameIter = authSession->getAuthenticatedUserNames();
 
@@ -115,6 +179,11 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 
     const string dbName(nsToDatabase(CurOp::get(opCtx)->getNS()));
 
+    if (deferProfilerWrites.load()) {
+        getProfileWriters(opCtx->getServiceContext()).insert(dbName, p);
+        return;
+    }
+
     try {
         // Even if the operation we are profiling was interrupted, we still want to output the
         // profiler entry.  This lock guard will prevent lock acquisitions from throwing exceptions
@@ -174,6 +243,10 @@ void profile(OperationContext* opCtx, NetworkOp op) {
 }
 
 
+void shutdownProfileWriters(ServiceContext* serviceContext) {
+    getProfileWriters(serviceContext).shutdown();
+}
+
 Status createProfileCollection(OperationContext* opCtx, Database* db) {
     invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_X));
 
@@ -35,12 +35,19 @@ namespace mongo {
 
 class Database;
 class OperationContext;
+class ServiceContext;
 
 /**
  * Invoked when database profile is enabled.
  */
 void profile(OperationContext* opCtx, NetworkOp op);
 
+/**
+ * Writes out the profiler entries buffered when profiler writes are deferred, and stops buffering
+ * new ones. Called at shutdown.
+ */
+void shutdownProfileWriters(ServiceContext* serviceContext);
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/bson_field_index.h"
+
+namespace mongo {
+
+BSONFieldIndex::BSONFieldIndex(const BSONObj& obj) : _obj(obj) {
+    std::vector<uint32_t> offsets;
+    for (auto&& elem : _obj) {
+        offsets.push_back(elem.rawdata() - _obj.objdata());
+    }
+    _numFields = offsets.size();
+
+    // Keep the table at most half full so that probe sequences stay short.
+    size_t numSlots = 8;
+    while (numSlots < 2 * _numFields) {
+        numSlots *= 2;
+    }
+    _slots.resize(numSlots, 0);
+
+    const size_t mask = numSlots - 1;
+    for (auto offset : offsets) {
+        const BSONElement elem(_obj.objdata() + offset);
+        const StringData name = elem.fieldNameStringData();
+        for (size_t slot = _hash(name) & mask;; slot = (slot + 1) & mask) {
+            if (_slots[slot] == 0) {
+                _slots[slot] = offset + 1;
+                break;
+            }
+            if (BSONElement(_obj.objdata() + _slots[slot] - 1).fieldNameStringData() == name) {
+                // Keep the first of several elements with the same name.
+                break;
+            }
+        }
+    }
+}
+
+BSONElement BSONFieldIndex::getField(StringData name) const {
+    const size_t mask = _slots.size() - 1;
+    for (size_t slot = _hash(name) & mask; _slots[slot] != 0; slot = (slot + 1) & mask) {
+        const BSONElement elem(_obj.objdata() + _slots[slot] - 1);
+        if (elem.fieldNameStringData() == name) {
+            return elem;
+        }
+    }
+    return BSONElement();
+}
+
+uint32_t BSONFieldIndex::_hash(StringData name) {
+    // FNV-1a: field names are short, so a simple byte-at-a-time hash is cheaper than a stronger
+    // one.
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+const BSONFieldIndex* LazyBSONFieldIndex::forLookup() {
+    if (_index) {
+        return _index.get_ptr();
+    }
+
+    // Decide only once, on the second lookup, whether the object is worth indexing.
+    if (_minFields <= 0 || ++_numLookups != 2) {
+        return nullptr;
+    }
+
+    BSONFieldIndex index(_obj);
+    if (index.numFields() < static_cast<size_t>(_minFields)) {
+        return nullptr;
+    }
+    _index.emplace(std::move(index));
+    return _index.get_ptr();
+}
+
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * A hash index from the top-level field names of a BSONObj to the offsets of their elements, so
+ * that looking up many fields of a wide document does not scan it once per field. When a field
+ * name appears more than once, getField() returns the first element, like BSONObj::getField().
+ *
+ * The index refers to, but does not own, the object's buffer, which must outlive it.
+ */
+class BSONFieldIndex {
+public:
+    explicit BSONFieldIndex(const BSONObj& obj);
+
+    /**
+     * Returns the same element as obj.getField(name), or EOO if there is no such field.
+     */
+    BSONElement getField(StringData name) const;
+
+    const BSONObj& obj() const {
+        return _obj;
+    }
+
+    size_t numFields() const {
+        return _numFields;
+    }
+
+private:
+    static uint32_t _hash(StringData name);
+
+    BSONObj _obj;
+
+    // Open-addressed table of element offsets, plus one, into the object. Zero is an empty slot.
+    std::vector<uint32_t> _slots;
+    size_t _numFields = 0;
+};
+
+/**
+ * Builds a BSONFieldIndex for an object only once it has been asked for more than one field, and
+ * only keeps it if the object has at least 'minFields' fields. Lookups of a single path, and
+ * lookups in narrow documents, therefore never pay for building an index. A non-positive
+ * 'minFields' disables the index.
+ */
+class LazyBSONFieldIndex {
+public:
+    LazyBSONFieldIndex(const BSONObj& obj, int minFields) : _obj(obj), _minFields(minFields) {}
+
+    /**
+     * Records a lookup in the object, returning the index to use for it or nullptr if the lookup
+     * should scan the object.
+     */
+    const BSONFieldIndex* forLookup();
+
+private:
+    BSONObj _obj;
+    int _minFields;
+    int _numLookups = 0;
+    boost::optional<BSONFieldIndex> _index;
+};
+
+}  // namespace mongo
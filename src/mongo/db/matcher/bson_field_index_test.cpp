@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/bson_field_index.h"
+#include "mongo/db/matcher/path.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeWideObj(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        bob.append("f" + std::to_string(i), i);
+    }
+    return bob.obj();
+}
+
+TEST(BSONFieldIndex, FindsEveryFieldOfAWideObject) {
+    BSONObj obj = makeWideObj(1000);
+    BSONFieldIndex index(obj);
+    ASSERT_EQ(1000U, index.numFields());
+    for (int i = 0; i < 1000; ++i) {
+        const std::string name = "f" + std::to_string(i);
+        BSONElement elem = index.getField(name);
+        ASSERT_EQ(obj.getField(name).rawdata(), elem.rawdata());
+        ASSERT_EQ(i, elem.numberInt());
+    }
+}
+
+TEST(BSONFieldIndex, MissingFieldsAreEOO) {
+    BSONObj obj = makeWideObj(100);
+    BSONFieldIndex index(obj);
+    ASSERT(index.getField("f100").eoo());
+    ASSERT(index.getField("").eoo());
+    ASSERT(index.getField("f").eoo());
+
+    BSONObj empty;
+    BSONFieldIndex emptyIndex(empty);
+    ASSERT_EQ(0U, emptyIndex.numFields());
+    ASSERT(emptyIndex.getField("a").eoo());
+}
+
+TEST(BSONFieldIndex, DuplicateFieldNamesFindTheFirstElement) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    BSONFieldIndex index(obj);
+    ASSERT_EQ(obj.getField("a").rawdata(), index.getField("a").rawdata());
+    ASSERT_EQ(1, index.getField("a").numberInt());
+}
+
+TEST(LazyBSONFieldIndex, IndexesOnlyWideObjectsWithSeveralLookups) {
+    BSONObj wide = makeWideObj(20);
+    LazyBSONFieldIndex lazyWide(wide, 10);
+    ASSERT(!lazyWide.forLookup());
+    const BSONFieldIndex* index = lazyWide.forLookup();
+    ASSERT(index);
+    ASSERT_EQ(index, lazyWide.forLookup());
+
+    BSONObj narrow = makeWideObj(5);
+    LazyBSONFieldIndex lazyNarrow(narrow, 10);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT(!lazyNarrow.forLookup());
+    }
+
+    LazyBSONFieldIndex disabled(wide, 0);
+    for (int i = 0; i < 4; ++i) {
+        ASSERT(!disabled.forLookup());
+    }
+}
+
+TEST(BSONFieldIndex, ElementIteratorUsesTheFieldIndexForTheFirstPart) {
+    BSONObj doc = fromjson("{x: 1, a: {b: 2}, c: [{d: 3}, {d: 4}]}");
+    BSONFieldIndex index(doc);
+
+    ElementPath nested;
+    nested.init("a.b");
+    BSONElementIterator nestedCursor(&nested, doc, &index);
+    ASSERT(nestedCursor.more());
+    ASSERT_EQ(2, nestedCursor.next().element().numberInt());
+    ASSERT(!nestedCursor.more());
+
+    ElementPath throughArray;
+    throughArray.init("c.d");
+    BSONElementIterator arrayCursor(&throughArray, doc, &index);
+    ASSERT(arrayCursor.more());
+    ASSERT_EQ(3, arrayCursor.next().element().numberInt());
+    ASSERT(arrayCursor.more());
+    ASSERT_EQ(4, arrayCursor.next().element().numberInt());
+    ASSERT(!arrayCursor.more());
+
+    ElementPath missing;
+    missing.init("y");
+    BSONElementIterator missingCursor(&missing, doc, &index);
+    ASSERT(missingCursor.more());
+    ASSERT(missingCursor.next().element().eoo());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/matcher/expression_path.h"
+#include "mongo/db/matcher/path_internal.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+CompiledMatchExpression::CompiledMatchExpression(const MatchExpression* root) {
+    invariant(root);
+    _compile(root);
+}
+
+void CompiledMatchExpression::_compile(const MatchExpression* expr) {
+    const size_t pc = _program.size();
+    _program.push_back({Op::kGeneric, expr, 1, nullptr});
+
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            _program[pc].op = Op::kAnd;
+            break;
+        case MatchExpression::OR:
+            _program[pc].op = Op::kOr;
+            break;
+        case MatchExpression::NOR:
+            _program[pc].op = Op::kNor;
+            break;
+        case MatchExpression::NOT:
+            _program[pc].op = Op::kNot;
+            break;
+        default:
+            // Every PathMatchExpression matches a document by applying matchesSingleElement() to
+            // each element its path resolves to.
+            if (dynamic_cast<const PathMatchExpression*>(expr)) {
+                _program[pc].op = Op::kPath;
+                _program[pc].path = stdx::make_unique<FieldRef>(expr->path());
+            }
+            return;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        _compile(expr->getChild(i));
+    }
+    _program[pc].subtreeSize = _program.size() - pc;
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    LazyBSONFieldIndex fieldIndex(doc, internalQueryBSONFieldIndexMinFields.load());
+    return _eval(0, doc, &fieldIndex);
+}
+
+bool CompiledMatchExpression::_eval(size_t pc,
+                                    const BSONObj& doc,
+                                    LazyBSONFieldIndex* fieldIndex) const {
+    const Instruction& instr = _program[pc];
+    const size_t end = pc + instr.subtreeSize;
+
+    switch (instr.op) {
+        case Op::kPath: {
+            size_t idxPath = 0;
+            BSONElement elem =
+                getFieldDottedOrArray(doc, *instr.path, &idxPath, 0, fieldIndex->forLookup());
+            if (elem.type() == Array) {
+                // Arrays are traversed according to the expression's array behavior.
+                return instr.expr->matchesBSON(doc);
+            }
+            return instr.expr->matchesSingleElement(elem);
+        }
+        case Op::kGeneric:
+            return instr.expr->matchesBSON(doc);
+        case Op::kAnd:
+            for (size_t child = pc + 1; child < end; child += _program[child].subtreeSize) {
+                if (!_eval(child, doc, fieldIndex)) {
+                    return false;
+                }
+            }
+            return true;
+        case Op::kOr:
+            for (size_t child = pc + 1; child < end; child += _program[child].subtreeSize) {
+                if (_eval(child, doc, fieldIndex)) {
+                    return true;
+                }
+            }
+            return false;
+        case Op::kNor:
+            for (size_t child = pc + 1; child < end; child += _program[child].subtreeSize) {
+                if (_eval(child, doc, fieldIndex)) {
+                    return false;
+                }
+            }
+            return true;
+        case Op::kNot:
+            return !_eval(pc + 1, doc, fieldIndex);
+    }
+
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
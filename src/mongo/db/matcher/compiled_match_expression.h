@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/field_ref.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/bson_field_index.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * A MatchExpression flattened into a linear program, for filters that are evaluated against many
+ * documents. The program is the expression tree in pre-order, where each node records the size of
+ * its subtree so that $and, $or, $nor and $not can skip over children without recursing through
+ * virtual matches() calls.
+ *
+ * Path expressions are evaluated against a path that is split once, at compile time. When the
+ * path resolves to a single non-array element, the expression is applied to it directly, without
+ * allocating an ElementIterator. Paths which cross an array, and all other expressions, fall
+ * back to the expression's own matchesBSON().
+ *
+ * The compiled program refers to, but does not own, the nodes of the expression it was compiled
+ * from, which must outlive it and must not be modified.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    explicit CompiledMatchExpression(const MatchExpression* root);
+
+    /**
+     * Returns the same result as the source expression's matchesBSON().
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    /**
+     * Returns the number of instructions in the program.
+     */
+    size_t size() const {
+        return _program.size();
+    }
+
+private:
+    enum class Op {
+        // Applies a path expression to the element found at the instruction's path.
+        kPath,
+
+        // Evaluates the instruction's expression with matchesBSON().
+        kGeneric,
+
+        // Combine the results of the instruction's children.
+        kAnd,
+        kOr,
+        kNor,
+        kNot,
+    };
+
+    struct Instruction {
+        Op op;
+        const MatchExpression* expr;
+
+        // Number of instructions in the subtree rooted at this instruction, including itself.
+        size_t subtreeSize;
+
+        // Only used by kPath instructions.
+        std::unique_ptr<FieldRef> path;
+    };
+
+    void _compile(const MatchExpression* expr);
+
+    bool _eval(size_t pc, const BSONObj& doc, LazyBSONFieldIndex* fieldIndex) const;
+
+    std::vector<Instruction> _program;
+};
+
+}  // namespace mongo
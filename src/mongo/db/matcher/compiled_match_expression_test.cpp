@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+namespace {
+
+using unittest::assertGet;
+
+/**
+ * Asserts that the compiled form of 'filter' agrees with the uncompiled expression on every
+ * document in 'docs', and returns the number of documents that matched.
+ */
+size_t countMatches(const char* filter, const std::vector<BSONObj>& docs) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = assertGet(MatchExpressionParser::parse(fromjson(filter), expCtx));
+    CompiledMatchExpression compiled(expr.get());
+
+    size_t numMatched = 0;
+    for (auto&& doc : docs) {
+        const bool expected = expr->matchesBSON(doc);
+        ASSERT_EQ(expected, compiled.matchesBSON(doc)) << "filter: " << filter << ", doc: " << doc;
+        numMatched += expected;
+    }
+    return numMatched;
+}
+
+const std::vector<BSONObj> kDocs = {
+    fromjson("{}"),
+    fromjson("{a: 1}"),
+    fromjson("{a: 5}"),
+    fromjson("{a: null}"),
+    fromjson("{a: 'str'}"),
+    fromjson("{a: [1, 5]}"),
+    fromjson("{a: [[5]]}"),
+    fromjson("{a: []}"),
+    fromjson("{a: {b: 1}}"),
+    fromjson("{a: {b: 5, c: 'x'}}"),
+    fromjson("{a: {b: [1, 5]}}"),
+    fromjson("{a: [{b: 1}, {b: 5}]}"),
+    fromjson("{a: {b: {c: 1}}}"),
+    fromjson("{a: 1, b: 5}"),
+    fromjson("{a: 5, b: 1}"),
+};
+
+TEST(CompiledMatchExpressionTest, Comparison) {
+    ASSERT_EQ(countMatches("{a: 5}", kDocs), 3U);
+    ASSERT_GT(countMatches("{a: {$lt: 5}}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: {$gte: 5}}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: null}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: {$exists: false}}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: {$type: 'array'}}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: {$in: [1, 'str']}}", kDocs), 0U);
+}
+
+TEST(CompiledMatchExpressionTest, DottedPaths) {
+    ASSERT_GT(countMatches("{'a.b': 5}", kDocs), 0U);
+    ASSERT_GT(countMatches("{'a.b': null}", kDocs), 0U);
+    ASSERT_GT(countMatches("{'a.b': {$exists: true}}", kDocs), 0U);
+    ASSERT_GT(countMatches("{'a.b.c': 1}", kDocs), 0U);
+    ASSERT_GT(countMatches("{'a.1': 5}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: {b: 1}}", kDocs), 0U);
+}
+
+TEST(CompiledMatchExpressionTest, Logical) {
+    ASSERT_GT(countMatches("{a: 1, b: 5}", kDocs), 0U);
+    ASSERT_GT(countMatches("{$or: [{a: 1}, {'a.b': 5}]}", kDocs), 0U);
+    ASSERT_GT(countMatches("{$nor: [{a: 1}, {b: 1}]}", kDocs), 0U);
+    ASSERT_GT(countMatches("{a: {$not: {$gt: 1}}}", kDocs), 0U);
+    ASSERT_GT(countMatches("{$and: [{$or: [{a: 5}, {b: 5}]}, {a: {$ne: null}}]}", kDocs), 0U);
+    ASSERT_GT(
+        countMatches("{$or: [{$nor: [{a: {$exists: true}}]}, {a: {$elemMatch: {$gt: 1}}}]}", kDocs),
+        0U);
+}
+
+TEST(CompiledMatchExpressionTest, LogicalNodesAreFlattenedIntoOneProgram) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = assertGet(
+        MatchExpressionParser::parse(fromjson("{$or: [{a: 1, b: 1}, {c: {$not: {$lt: 5}}}]}"),
+                                     expCtx));
+    CompiledMatchExpression compiled(expr.get());
+
+    // OR, AND, a, b, NOT, c.
+    ASSERT_EQ(compiled.size(), 6U);
+    ASSERT_TRUE(compiled.matchesBSON(fromjson("{a: 1, b: 1}")));
+    ASSERT_TRUE(compiled.matchesBSON(fromjson("{c: 7}")));
+    ASSERT_FALSE(compiled.matchesBSON(fromjson("{a: 1, c: 2}")));
+}
+
+}  // namespace
+}  // namespace mongo
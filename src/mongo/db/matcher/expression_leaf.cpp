@@ -30,6 +30,7 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <climits>
 #include <cmath>
 #include <pcrecpp.h>
 
@@ -394,6 +395,10 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_homogeneousType = _homogeneousType;
+    next->_integralEqualities = _integralEqualities;
+    next->_objectIdEqualities = _objectIdEqualities;
+    next->_collatedStringEqualities = _collatedStringEqualities;
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -406,7 +411,7 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (_equalitiesContain(e)) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -507,6 +512,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    _computeHomogeneousEqualities();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -536,10 +542,142 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
     }
 
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    _computeHomogeneousEqualities();
 
     return Status::OK();
 }
 
+namespace {
+
+/**
+ * Returns true if the integral value of 'e' was stored in 'out'. Numbers other than integral
+ * doubles in the range of a long long, and all Decimal128 values, are rejected: the former
+ * cannot compare equal to any long long, and the latter must be compared by the BSON comparator.
+ */
+bool integralValue(const BSONElement& e, long long* out) {
+    switch (e.type()) {
+        case NumberInt:
+            *out = e._numberInt();
+            return true;
+        case NumberLong:
+            *out = e._numberLong();
+            return true;
+        case NumberDouble: {
+            // Positive 2**63, the smallest double that cannot be represented in a long long.
+            static const double kBoundOfLongRange = -static_cast<double>(LLONG_MIN);
+            const double d = e._numberDouble();
+            if (std::trunc(d) != d || d >= kBoundOfLongRange || d < -kBoundOfLongRange) {
+                return false;
+            }
+            *out = static_cast<long long>(d);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns whether 'value' is in 'sorted', which must be in ascending order. The search halves the
+ * range with a conditional move rather than a branch, so that its cost does not depend on the
+ * unpredictable outcome of each comparison.
+ */
+template <typename T>
+bool sortedContains(const std::vector<T>& sorted, const T& value) {
+    if (sorted.empty()) {
+        return false;
+    }
+    const T* base = sorted.data();
+    size_t n = sorted.size();
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = (base[half] < value) ? base + half : base;
+        n -= half;
+    }
+    if (*base < value) {
+        ++base;
+    }
+    return base != sorted.data() + sorted.size() && *base == value;
+}
+
+}  // namespace
+
+void InMatchExpression::_computeHomogeneousEqualities() {
+    _homogeneousType = HomogeneousType::kNone;
+    _integralEqualities.clear();
+    _objectIdEqualities.clear();
+    _collatedStringEqualities.clear();
+
+    if (_equalitySet.empty()) {
+        return;
+    }
+
+    if (_collator && _equalitySet.begin()->type() == String) {
+        for (auto&& equality : _equalitySet) {
+            if (equality.type() != String) {
+                _collatedStringEqualities.clear();
+                return;
+            }
+            _collatedStringEqualities.push_back(
+                _collator->getComparisonKey(equality.valueStringData()).getKeyData().toString());
+        }
+        std::sort(_collatedStringEqualities.begin(), _collatedStringEqualities.end());
+        _homogeneousType = HomogeneousType::kCollatedString;
+        return;
+    }
+
+    if (_equalitySet.begin()->type() == jstOID) {
+        for (auto&& equality : _equalitySet) {
+            if (equality.type() != jstOID) {
+                _objectIdEqualities.clear();
+                return;
+            }
+            _objectIdEqualities.push_back(equality.OID());
+        }
+        dassert(std::is_sorted(_objectIdEqualities.begin(), _objectIdEqualities.end()));
+        _homogeneousType = HomogeneousType::kObjectId;
+        return;
+    }
+
+    for (auto&& equality : _equalitySet) {
+        long long value;
+        if (!integralValue(equality, &value)) {
+            _integralEqualities.clear();
+            return;
+        }
+        _integralEqualities.push_back(value);
+    }
+    dassert(std::is_sorted(_integralEqualities.begin(), _integralEqualities.end()));
+    _homogeneousType = HomogeneousType::kIntegral;
+}
+
+bool InMatchExpression::_equalitiesContain(const BSONElement& e) const {
+    switch (_homogeneousType) {
+        case HomogeneousType::kIntegral: {
+            if (e.type() == NumberDecimal) {
+                break;
+            }
+            long long value;
+            return integralValue(e, &value) && sortedContains(_integralEqualities, value);
+        }
+        case HomogeneousType::kObjectId:
+            return e.type() == jstOID && sortedContains(_objectIdEqualities, e.OID());
+        case HomogeneousType::kCollatedString:
+            if (e.type() == Symbol) {
+                // Symbols compare equal to strings, leave them to the BSON comparator.
+                break;
+            }
+            return e.type() == String &&
+                sortedContains(_collatedStringEqualities,
+                               _collator->getComparisonKey(e.valueStringData())
+                                   .getKeyData()
+                                   .toString());
+        case HomogeneousType::kNone:
+            break;
+    }
+    return _equalitySet.find(e) != _equalitySet.end();
+}
+
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
     _regexes.push_back(std::move(expr));
     return Status::OK();
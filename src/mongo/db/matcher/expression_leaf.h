@@ -440,9 +440,41 @@ public:
         return _hasEmptyArray;
     }
 
+    /**
+     * Returns true if the equalities are all integral numbers or are all ObjectIds. Such values
+     * are unaffected by the collation, so getEqualities() returns them sorted in index key order
+     * and with no two equal to each other.
+     */
+    bool hasHomogeneousEqualities() const {
+        return _homogeneousType == HomogeneousType::kIntegral ||
+            _homogeneousType == HomogeneousType::kObjectId;
+    }
+
 private:
+    // The type shared by all elements of '_equalitySet', when matching against it may be done
+    // by a binary search over the values themselves.
+    enum class HomogeneousType {
+        kNone,
+        kIntegral,
+        kObjectId,
+        // All strings, compared with a non-simple collator by their comparison keys.
+        kCollatedString,
+    };
+
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Returns whether 'e' is equal to one of the equalities, using the homogeneous representation
+     * of the equalities when possible.
+     */
+    bool _equalitiesContain(const BSONElement& e) const;
+
+    /**
+     * Recomputes '_homogeneousType' and the matching sorted vector from '_equalitySet'. Must be
+     * called whenever '_equalitySet' changes.
+     */
+    void _computeHomogeneousEqualities();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -471,6 +503,20 @@ private:
 
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
+
+    HomogeneousType _homogeneousType = HomogeneousType::kNone;
+
+    // Copies of the values in '_equalitySet' in ascending order, when '_homogeneousType' is
+    // kIntegral or kObjectId respectively. Searching these contiguous arrays of fixed-size values
+    // avoids the type dispatch of comparing BSONElements.
+    std::vector<long long> _integralEqualities;
+    std::vector<OID> _objectIdEqualities;
+
+    // The collator's comparison keys of the values in '_equalitySet' in ascending binary order,
+    // when '_homogeneousType' is kCollatedString. A string is then matched by computing its own
+    // key once and searching these, rather than comparing it with the collator at each step of
+    // the search.
+    std::vector<std::string> _collatedStringEqualities;
 };
 
 /**
@@ -1350,6 +1350,104 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, IntegralEqualitiesMatchAllNumericTypes) {
+    BSONObj operand = BSON_ARRAY(7 << -3 << 1000000000000LL << 2.0 << 7LL);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    for (auto&& elt : operand) {
+        equalities.push_back(elt);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(in.hasHomogeneousEqualities());
+    ASSERT_EQ(in.getEqualities().size(), 4U);
+
+    ASSERT(in.matchesSingleElement(BSON("" << 7).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << -3.0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << 2LL).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << 1000000000000.0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << Decimal128("7")).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << 7.5).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << 8).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << -4).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << std::nan("")).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << "7").firstElement()));
+    ASSERT(!in.matchesSingleElement(BSONElement()));
+
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesSingleElement(BSON("" << 1000000000000LL).firstElement()));
+}
+
+TEST(InMatchExpression, ObjectIdEqualitiesMatchOnlyObjectIds) {
+    OID first = OID::gen();
+    OID second = OID::gen();
+    OID third = OID::gen();
+    BSONObj operand = BSON_ARRAY(third << first);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities{operand[0], operand[1]};
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(in.hasHomogeneousEqualities());
+
+    ASSERT(in.matchesSingleElement(BSON("" << first).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << third).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << second).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << first.toString()).firstElement()));
+}
+
+TEST(InMatchExpression, CollatedStringEqualitiesMatchByComparisonKey) {
+    BSONObj operand = BSON_ARRAY("Banana"
+                                 << "apple"
+                                 << "CHERRY");
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    InMatchExpression in("");
+    in.setCollator(&collator);
+    std::vector<BSONElement> equalities{operand[0], operand[1], operand[2]};
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    // String equalities depend on the collation, so they can't be used for index bounds as is.
+    ASSERT_FALSE(in.hasHomogeneousEqualities());
+
+    ASSERT(in.matchesSingleElement(BSON(""
+                                        << "banana")
+                                       .firstElement()));
+    ASSERT(in.matchesSingleElement(BSON(""
+                                        << "APPLE")
+                                       .firstElement()));
+    ASSERT(in.matchesSingleElement(BSON(""
+                                        << "cherry")
+                                       .firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON(""
+                                         << "date")
+                                        .firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << 1).firstElement()));
+
+    BSONObjBuilder symbol;
+    symbol.appendSymbol("", "CHERRY");
+    ASSERT(in.matchesSingleElement(symbol.obj().firstElement()));
+
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesSingleElement(BSON(""
+                                            << "bAnAnA")
+                                           .firstElement()));
+
+    // Without the collator, strings are compared in binary.
+    in.setCollator(nullptr);
+    ASSERT(!in.matchesSingleElement(BSON(""
+                                         << "banana")
+                                        .firstElement()));
+    ASSERT(in.matchesSingleElement(BSON(""
+                                        << "Banana")
+                                       .firstElement()));
+}
+
+TEST(InMatchExpression, MixedEqualitiesAreNotHomogeneous) {
+    BSONObj operand = BSON_ARRAY(1 << 2.5 << OID::gen());
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities{operand[0], operand[1], operand[2]};
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT_FALSE(in.hasHomogeneousEqualities());
+    ASSERT(in.matchesSingleElement(BSON("" << 2.5).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << 1LL).firstElement()));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -64,7 +64,8 @@ WhereMatchExpression::WhereMatchExpression(OperationContext* opCtx,
     const string userToken =
         AuthorizationSession::get(Client::getCurrent())->getAuthenticatedUserNamesToken();
 
-    _scope = getGlobalScriptEngine()->getPooledScope(_opCtx, _dbName, "where" + userToken);
+    _scope = getGlobalScriptEngine()->getPooledScope(
+        _opCtx, _dbName, "where" + userToken, getCode().c_str());
     _func = _scope->createFunction(getCode().c_str());
 
     uassert(ErrorCodes::BadValue, "$where compile error", _func);
@@ -30,11 +30,13 @@
 
 #include "mongo/db/matcher/matchable.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/platform/basic.h"
 
 namespace mongo {
 
-BSONMatchableDocument::BSONMatchableDocument(const BSONObj& obj) : _obj(obj) {
+BSONMatchableDocument::BSONMatchableDocument(const BSONObj& obj)
+    : _obj(obj), _fieldIndex(_obj, internalQueryBSONFieldIndexMinFields.load()) {
     _iteratorUsed = false;
 }
 
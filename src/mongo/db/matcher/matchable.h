@@ -85,10 +85,11 @@ public:
     }
 
     virtual ElementIterator* allocateIterator(const ElementPath* path) const {
+        const BSONFieldIndex* fieldIndex = _fieldIndex.forLookup();
         if (_iteratorUsed)
-            return new BSONElementIterator(path, _obj);
+            return new BSONElementIterator(path, _obj, fieldIndex);
         _iteratorUsed = true;
-        _iterator.reset(path, _obj);
+        _iterator.reset(path, _obj, fieldIndex);
         return &_iterator;
     }
 
@@ -104,6 +105,9 @@ private:
     BSONObj _obj;
     mutable BSONElementIterator _iterator;
     mutable bool _iteratorUsed;
+
+    // Indexes the top-level fields of wide documents against which several paths are matched.
+    mutable LazyBSONFieldIndex _fieldIndex;
 };
 
 /**
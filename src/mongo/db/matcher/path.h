@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/bson_field_index.h"
 
 namespace mongo {
 
@@ -195,14 +196,18 @@ public:
 
     /**
      * Constructs an iterator over 'objectToIterate', where the desired element(s) is/are at the end
-     * of 'path'.
+     * of 'path'. If 'fieldIndex' is not null, it must index 'objectToIterate'.
      */
-    BSONElementIterator(const ElementPath* path, const BSONObj& objectToIterate);
+    BSONElementIterator(const ElementPath* path,
+                        const BSONObj& objectToIterate,
+                        const BSONFieldIndex* fieldIndex = nullptr);
 
     virtual ~BSONElementIterator();
 
     void reset(const ElementPath* path, size_t suffixIndex, BSONElement elementToIterate);
-    void reset(const ElementPath* path, const BSONObj& objectToIterate);
+    void reset(const ElementPath* path,
+               const BSONObj& objectToIterate,
+               const BSONFieldIndex* fieldIndex = nullptr);
 
     bool more();
     Context next();
@@ -43,7 +43,10 @@ bool isAllDigits(StringData str) {
 BSONElement getFieldDottedOrArray(const BSONObj& doc,
                                   const FieldRef& path,
                                   size_t* idxPath,
-                                  size_t startIndex) {
+                                  size_t startIndex,
+                                  const BSONFieldIndex* docFieldIndex) {
+    dassert(!docFieldIndex || docFieldIndex->obj().objdata() == doc.objdata());
+
     if (path.numParts() == startIndex)
         return doc.getField("");
 
@@ -53,7 +56,9 @@ BSONElement getFieldDottedOrArray(const BSONObj& doc,
     bool stop = false;
     size_t partNum = startIndex;
     while (partNum < path.numParts() && !stop) {
-        res = curr.getField(path.getPart(partNum));
+        res = (docFieldIndex && partNum == startIndex)
+            ? docFieldIndex->getField(path.getPart(partNum))
+            : curr.getField(path.getPart(partNum));
 
         switch (res.type()) {
             case EOO:
@@ -35,6 +35,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/bson_field_index.h"
 
 namespace mongo {
 
@@ -44,10 +45,14 @@ bool isAllDigits(StringData str);
  * Finds the element at 'path' in 'doc', starting at 'startIndex' in 'path'. If none is found, an
  * EOO element is returned. If an array is encountered along 'path', the traversal stops early, and
  * the array is returned. 'idxPath' is set to the furthest index reached in 'path'.
+ *
+ * If 'docFieldIndex' is not null, it must index 'doc', and is used to find the first part of the
+ * path.
  */
 BSONElement getFieldDottedOrArray(const BSONObj& doc,
                                   const FieldRef& path,
                                   size_t* idxPath,
-                                  size_t startIndex = 0);
+                                  size_t startIndex = 0,
+                                  const BSONFieldIndex* docFieldIndex = nullptr);
 
 }  // namespace mongo
@@ -56,6 +56,8 @@ const NamespaceString NamespaceString::kLogicalSessionsNamespace(NamespaceString
                                                                  "system.sessions");
 const NamespaceString NamespaceString::kSessionTransactionsTableNamespace(
     NamespaceString::kConfigDb, "transactions");
+const NamespaceString NamespaceString::kPlanCacheSnapshotNamespace(NamespaceString::kConfigDb,
+                                                                   "planCacheSnapshots");
 const NamespaceString NamespaceString::kShardConfigCollectionsNamespace(NamespaceString::kConfigDb,
                                                                         "cache.collections");
 const NamespaceString NamespaceString::kShardConfigDatabasesNamespace(NamespaceString::kConfigDb,
@@ -73,6 +73,9 @@ public:
     // Namespace for storing the transaction information for each session
     static const NamespaceString kSessionTransactionsTableNamespace;
 
+    // Namespace for storing snapshots of collections' plan caches and index filters
+    static const NamespaceString kPlanCacheSnapshotNamespace;
+
     // Name for a shard's collections metadata collection, each document of which indicates the
     // state of a specific collection
     static const NamespaceString kShardConfigCollectionsNamespace;
@@ -388,8 +388,8 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
             return;
         }
         for (auto iter = first; iter != last; iter++) {
-            auto operation = OplogEntry::makeInsertOperation(nss, uuid, iter->doc);
-            session->addTransactionOperation(opCtx, operation);
+            session->addTransactionOperation(
+                opCtx, OplogEntry::makeInsertOperation(nss, uuid, iter->doc));
         }
     } else {
         lastWriteDate = getWallClockTimeForOpLog(opCtx);
@@ -469,9 +469,9 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
         session && opCtx->writesAreReplicated() && session->inMultiDocumentTransaction();
     OpTimeBundle opTime;
     if (inMultiDocumentTransaction) {
-        auto operation =
-            OplogEntry::makeUpdateOperation(args.nss, args.uuid, args.update, args.criteria);
-        session->addTransactionOperation(opCtx, operation);
+        session->addTransactionOperation(
+            opCtx,
+            OplogEntry::makeUpdateOperation(args.nss, args.uuid, args.update, args.criteria));
     } else {
         opTime = replLogUpdate(opCtx, session, args);
         onWriteOpCompleted(opCtx,
@@ -527,9 +527,10 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
         session && opCtx->writesAreReplicated() && session->inMultiDocumentTransaction();
     OpTimeBundle opTime;
     if (inMultiDocumentTransaction) {
-        auto operation = OplogEntry::makeDeleteOperation(
-            nss, uuid, deletedDoc ? deletedDoc.get() : deleteState.documentKey);
-        session->addTransactionOperation(opCtx, operation);
+        session->addTransactionOperation(
+            opCtx,
+            OplogEntry::makeDeleteOperation(
+                nss, uuid, deletedDoc ? deletedDoc.get() : deleteState.documentKey));
     } else {
         opTime = replLogDelete(opCtx, nss, uuid, session, stmtId, fromMigrate, deletedDoc);
         onWriteOpCompleted(opCtx,
@@ -923,12 +924,22 @@ namespace {
 
 OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
                                        Session* const session,
-                                       std::vector<repl::ReplOperation> stmts,
+                                       const std::vector<repl::ReplOperation>& stmts,
                                        bool prepare) {
-    BSONObjBuilder applyOpsBuilder;
+    // Size the buffer for the whole entry up front, so that building it does not repeatedly grow
+    // and copy it. Entries too large to be logged fail below regardless.
+    size_t estimatedSize = 512;
+    for (const auto& stmt : stmts) {
+        estimatedSize += repl::OplogEntry::getReplOperationSize(stmt);
+    }
+
+    BSONObjBuilder applyOpsBuilder(
+        static_cast<int>(std::min<size_t>(estimatedSize, BSONObjMaxInternalSize)));
     BSONArrayBuilder opsArray(applyOpsBuilder.subarrayStart("applyOps"_sd));
-    for (auto& stmt : stmts) {
-        opsArray.append(stmt.toBSON());
+    for (const auto& stmt : stmts) {
+        // Serialize each operation in place rather than through a temporary object.
+        BSONObjBuilder stmtBuilder(opsArray.subobjStart());
+        stmt.serialize(&stmtBuilder);
     }
     opsArray.done();
 
@@ -97,6 +97,12 @@ void updateRetryStats(OperationContext* opCtx, bool containsRetry) {
     }
 }
 
+Top::StorageUsage getStorageUsage(CurOp& curOp) {
+    const auto& metrics = curOp.debug().additiveMetrics;
+    return {metrics.storageBytesRead.get_value_or(0),
+            metrics.storageTimeReadingMicros.get_value_or(0)};
+}
+
 void finishCurOp(OperationContext* opCtx, CurOp* curOp) {
     try {
         curOp->done();
@@ -112,7 +118,8 @@ void finishCurOp(OperationContext* opCtx, CurOp* curOp) {
                     Top::LockType::WriteLocked,
                     durationCount<Microseconds>(curOp->elapsedTimeExcludingPauses()),
                     curOp->isCommand(),
-                    curOp->getReadWriteType());
+                    curOp->getReadWriteType(),
+                    getStorageUsage(*curOp));
 
         if (!curOp->debug().errInfo.isOK()) {
             LOG(3) << "Caught Assertion in " << redact(logicalOpToString(curOp->getLogicalOp()))
@@ -496,7 +503,8 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
                     Top::LockType::WriteLocked,
                     durationCount<Microseconds>(curOp.elapsedTimeExcludingPauses()),
                     curOp.isCommand(),
-                    curOp.getReadWriteType());
+                    curOp.getReadWriteType(),
+                    getStorageUsage(curOp));
 
     });
 
@@ -551,8 +559,10 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
                 }
             }
 
+            // Documents that don't need fixing up are inserted straight from the request, which
+            // for OP_MSG document sequences means from the message buffer itself.
             BSONObj toInsert = fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
-            batch.emplace_back(stmtId, toInsert);
+            batch.emplace_back(stmtId, std::move(toInsert));
             bytesInBatch += batch.back().doc.objsize();
             if (!isLastDoc && batch.size() < maxBatchSize && bytesInBatch < insertVectorMaxBytes)
                 continue;  // Add more to batch before inserting.
@@ -271,6 +271,40 @@ TEST(CommandWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, DocumentSequenceInsertReferencesMessageBuffer) {
+    const BSONObj obj0 = BSON("x" << 0);
+    const BSONObj obj1 = BSON("x" << 1);
+
+    const char* messageBegin;
+    const char* messageEnd;
+    boost::optional<write_ops::Insert> op;
+    {
+        OpMsgBuilder builder;
+        {
+            auto docSeq = builder.beginDocSequence("documents");
+            docSeq.append(obj0);
+            docSeq.append(obj1);
+        }
+        builder.setBody(BSON("insert"
+                             << "foo"
+                             << "$db"
+                             << "test"));
+        const auto message = builder.finish();
+        messageBegin = message.buf();
+        messageEnd = messageBegin + message.size();
+        op.emplace(InsertOp::parse(OpMsgRequest::parse(message)));
+    }
+
+    // The documents are views into the message, which they keep alive after it goes away.
+    ASSERT_EQ(op->getDocuments().size(), 2u);
+    for (auto&& doc : op->getDocuments()) {
+        ASSERT(doc.isOwned());
+        ASSERT(doc.objdata() >= messageBegin && doc.objdata() < messageEnd);
+    }
+    ASSERT_BSONOBJ_EQ(op->getDocuments()[0], obj0);
+    ASSERT_BSONOBJ_EQ(op->getDocuments()[1], obj1);
+}
+
 TEST(CommandWriteOpsParsers, MultiInsertWithStmtId) {
     const auto ns = NamespaceString("test", "foo");
     const BSONObj obj0 = BSON("x" << 0);
@@ -76,6 +76,15 @@ public:
     /// Reset this accumulator to a fresh state ready to receive input.
     virtual void reset() = 0;
 
+    /**
+     * Undoes the effect of an earlier process(input, false), for inputs leaving a sliding window.
+     * Returns false if 'input' cannot be removed exactly, in which case the caller must reset()
+     * and process the remaining inputs again.
+     */
+    virtual bool remove(const Value& input) {
+        return false;
+    }
+
 
     virtual bool isAssociative() const {
         return false;
@@ -170,6 +179,12 @@ public:
     const char* getOpName() const final;
     void reset() final;
 
+    /**
+     * Subtracts 'input' from the total. The type of the total stays the widest of all the values
+     * processed since the last reset().
+     */
+    bool remove(const Value& input) final;
+
     static boost::intrusive_ptr<Accumulator> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
@@ -257,6 +272,7 @@ public:
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
+    bool remove(const Value& input) final;
 
     static boost::intrusive_ptr<Accumulator> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -28,6 +28,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+#include <limits>
+
 #include "mongo/db/pipeline/accumulator.h"
 
 #include "mongo/db/pipeline/accumulation_statement.h"
@@ -92,6 +95,35 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+bool AccumulatorAvg::remove(const Value& input) {
+    switch (input.getType()) {
+        case NumberDecimal:
+            if (input.getDecimal().isNaN() || input.getDecimal().isInfinite()) {
+                return false;
+            }
+            _decimalTotal = _decimalTotal.subtract(input.getDecimal());
+            break;
+        case NumberLong:
+            if (input.getLong() == std::numeric_limits<long long>::min()) {
+                return false;
+            }
+            _nonDecimalTotal.addLong(-input.getLong());
+            break;
+        case NumberInt:
+        case NumberDouble:
+            if (!std::isfinite(input.getDouble())) {
+                return false;
+            }
+            _nonDecimalTotal.addDouble(-input.getDouble());
+            break;
+        default:
+            // Non-numeric inputs are ignored by processInternal().
+            return true;
+    }
+    _count--;
+    return true;
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorAvg(expCtx);
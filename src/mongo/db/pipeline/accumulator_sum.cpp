@@ -84,6 +84,36 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+bool AccumulatorSum::remove(const Value& input) {
+    switch (input.getType()) {
+        case NumberInt:
+            nonDecimalTotal.addLong(-input.coerceToLong());
+            return true;
+        case NumberLong:
+            if (input.getLong() == std::numeric_limits<long long>::min()) {
+                return false;
+            }
+            nonDecimalTotal.addLong(-input.getLong());
+            return true;
+        case NumberDouble:
+            // Infinities and NaN cannot be taken back out of the total.
+            if (!std::isfinite(input.getDouble())) {
+                return false;
+            }
+            nonDecimalTotal.addDouble(-input.getDouble());
+            return true;
+        case NumberDecimal:
+            if (input.getDecimal().isNaN() || input.getDecimal().isInfinite()) {
+                return false;
+            }
+            decimalTotal = decimalTotal.subtract(input.getDecimal());
+            return true;
+        default:
+            // Non-numeric inputs are ignored by processInternal().
+            return true;
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
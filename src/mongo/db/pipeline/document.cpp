@@ -51,7 +51,41 @@ const std::vector<StringData> Document::allMetadataFieldNames = {Document::metaF
                                                                  Document::metaFieldGeoNearDistance,
                                                                  Document::metaFieldGeoNearPoint};
 
+Value DocumentStorage::lazyValue(const BSONElement& elem, const BSONObj& owner) {
+    if (elem.type() != BSONType::Object) {
+        return Value(elem);
+    }
+
+    BSONObj embedded = elem.embeddedObject();
+    if (embedded.isEmpty()) {
+        return Value(Document());
+    }
+
+    // Metadata is only parsed at the top-level, so this does not check for it.
+    embedded.shareOwnershipWith(owner.sharedBuffer());
+    return Value(Document(new DocumentStorage(std::move(embedded))));
+}
+
+Value DocumentStorage::getLazyField(StringData name) const {
+    BSONElement elem = _bson[name];
+    return elem.eoo() ? Value() : lazyValue(elem, _bson);
+}
+
+void DocumentStorage::loadFieldsFromBson() {
+    BSONObj bson = std::move(_bson);
+    invariant(!isLazy());
+
+    if (!_buffer) {
+        reserveFields(bson.nFields());
+    }
+    for (auto&& elem : bson) {
+        appendField(elem.fieldNameStringData()) = lazyValue(elem, bson);
+    }
+}
+
 Position DocumentStorage::findField(StringData requested) const {
+    loadLazyFields();
+
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -210,6 +244,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     out->_sortKey = _sortKey.getOwned();
     out->_geoNearDistance = _geoNearDistance;
     out->_geoNearPoint = _geoNearPoint.getOwned();
+    out->_bson = _bson;
 
     // Tell values that they have been memcpyed (updates ref counts)
     for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
@@ -239,6 +274,19 @@ Document::Document(const BSONObj& bson) {
     *this = md.freeze();
 }
 
+Document Document::fromBsonWithMetaDataLazily(BSONObj bson) {
+    for (auto&& elem : bson) {
+        if (elem.fieldNameStringData()[0] == '$') {
+            return fromBsonWithMetaData(bson);
+        }
+    }
+
+    if (bson.isEmpty()) {
+        return Document();
+    }
+    return Document(new DocumentStorage(bson.getOwned()));
+}
+
 Document::Document(std::initializer_list<std::pair<StringData, ImplicitValue>> initializerList) {
     MutableDocument mutableDoc(initializerList.size());
 
@@ -263,6 +311,12 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    if (storage().isLazy()) {
+        // The fields have not been modified, so they can be copied straight from the original.
+        builder->appendElements(storage().lazyBson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
@@ -378,18 +432,25 @@ static Value getNestedFieldHelper(const Document& doc,
                                   vector<Position>* positions,
                                   size_t level) {
     const auto fieldName = fieldNames.getFieldName(level);
-    const Position pos = doc.positionOf(fieldName);
 
-    if (!pos.found())
-        return Value();
+    Value val;
+    if (positions) {
+        // Looking up a Position loads the fields of a lazy document, so only do so if asked to.
+        const Position pos = doc.positionOf(fieldName);
+        if (!pos.found())
+            return Value();
 
-    if (positions)
         positions->push_back(pos);
+        val = doc.getField(pos);
+    } else {
+        val = doc.getField(fieldName);
+        if (val.missing())
+            return Value();
+    }
 
     if (level == fieldNames.getPathLength() - 1)
-        return doc.getField(pos);
+        return val;
 
-    Value val = doc.getField(pos);
     if (val.getType() != Object)
         return Value();
 
@@ -406,6 +467,9 @@ size_t Document::getApproximateSize() const {
         return 0;  // we've allocated no memory
 
     size_t size = sizeof(DocumentStorage);
+    if (storage().isLazy()) {
+        return size + storage().lazyBson().objsize();
+    }
     size += storage().allocatedBytes();
 
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
@@ -146,7 +146,7 @@ public:
 
     /// True if this document has no fields.
     bool empty() const {
-        return !_storage || storage().iterator().atEnd();
+        return !_storage || (!storage().isLazy() && storage().iterator().atEnd());
     }
 
     /// Create a new FieldIterator that can be used to examine the Document's fields in order.
@@ -219,6 +219,17 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData, but the returned document is backed by an owned copy of 'bson'
+     * (which is free if 'bson' is already owned) and only converts its fields into Values once
+     * they are iterated over or modified. Until then the document occupies little more memory
+     * than 'bson' itself, reading a field by name converts just that field, and serializing the
+     * document back to BSON copies 'bson' directly.
+     *
+     * If 'bson' has any top-level metadata fields, this is the same as fromBsonWithMetaData.
+     */
+    static Document fromBsonWithMetaDataLazily(BSONObj bson);
+
     /**
      * Given a BSON object that may have metadata fields added as part of toBsonWithMetadata(),
      * returns the same object without any of the metadata fields.
@@ -299,6 +310,7 @@ public:
     }
 
 private:
+    friend class DocumentStorage;
     friend class FieldIterator;
     friend class ValueStorage;
     friend class MutableDocument;
@@ -596,7 +608,9 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        DocumentStorage& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.loadLazyFields();
+        return storage;
     }
     DocumentStorage& newStorage() {
         reset(new DocumentStorage);
@@ -604,7 +618,9 @@ private:
     }
     DocumentStorage& clonedStorage() {
         reset(storagePtr()->clone());
-        return const_cast<DocumentStorage&>(*storagePtr());
+        DocumentStorage& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.loadLazyFields();
+        return storage;
     }
 
     // recursive helpers for same-named public methods
@@ -192,6 +192,17 @@ public:
           _randVal(0),
           _geoNearDistance(0) {}
 
+    /**
+     * Creates storage backed by 'bson', which must be owned and non-empty. Its fields are only
+     * converted into ValueElements once they are iterated over, looked up by Position, or
+     * modified; until then lookups by name are answered from 'bson' directly. See
+     * Document::fromBsonWithMetaDataLazily().
+     */
+    explicit DocumentStorage(BSONObj bson) : DocumentStorage() {
+        dassert(bson.isOwned() && !bson.isEmpty());
+        _bson = std::move(bson);
+    }
+
     ~DocumentStorage();
 
     enum MetaType : char {
@@ -210,6 +221,9 @@ public:
     }
 
     size_t size() const {
+        if (isLazy())
+            return _bson.nFields();
+
         // can't use _numFields because it includes removed Fields
         size_t count = 0;
         for (DocumentStorageIterator it = iterator(); !it.atEnd(); it.advance())
@@ -231,6 +245,9 @@ public:
         return *(_firstElement->plusBytes(pos.index));
     }
     Value getField(StringData name) const {
+        if (isLazy())
+            return getLazyField(name);
+
         Position pos = findField(name);
         if (!pos.found())
             return Value();
@@ -259,10 +276,11 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadLazyFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
-    /// This includes missing values
+    /// This includes missing values. Only iterates over the fields which have been loaded.
     DocumentStorageIterator iteratorAll() const {
         return DocumentStorageIterator(_firstElement, end(), true);
     }
@@ -274,6 +292,27 @@ public:
         return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
     }
 
+    /// True if the fields of this document have not been converted from the BSON backing it yet.
+    bool isLazy() const {
+        return !_bson.isEmpty();
+    }
+
+    /// Returns the BSON backing this document. Only valid when isLazy().
+    const BSONObj& lazyBson() const {
+        dassert(isLazy());
+        return _bson;
+    }
+
+    /**
+     * Converts the fields of the BSON backing this document, if any, into ValueElements. This is
+     * done as an implementation detail of const accessors, so it must not be called concurrently
+     * with any other access to the same storage.
+     */
+    void loadLazyFields() const {
+        if (MONGO_unlikely(isLazy()))
+            const_cast<DocumentStorage*>(this)->loadFieldsFromBson();
+    }
+
     /**
      * Copies all metadata from source if it has any.
      * Note: does not clear metadata from this.
@@ -352,6 +391,18 @@ public:
     }
 
 private:
+    /**
+     * Converts 'elem', which is part of the owned object 'owner', into a Value. Embedded objects
+     * share the buffer of 'owner' and are themselves converted lazily.
+     */
+    static Value lazyValue(const BSONElement& elem, const BSONObj& owner);
+
+    /// Looks up a field of a lazy document in its BSON.
+    Value getLazyField(StringData name) const;
+
+    /// Implementation of loadLazyFields().
+    void loadFieldsFromBson();
+
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
@@ -435,6 +486,9 @@ private:
     BSONObj _sortKey;
     double _geoNearDistance;
     Value _geoNearPoint;
+
+    // The owned BSON backing a lazy document, or empty once its fields have been loaded.
+    BSONObj _bson;
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
@@ -31,8 +31,11 @@
 #include "mongo/db/pipeline/document_source.h"
 
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sequential_document_cache.h"
+#include "mongo/db/pipeline/document_source_skip.h"
+#include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/value.h"
@@ -160,6 +163,41 @@ splitMatchByModifiedFields(const boost::intrusive_ptr<DocumentSourceMatch>& matc
     return match->splitSourceBy(modifiedPaths, modifiedPathsRet.renames);
 }
 
+/**
+ * Returns true if 'nextStage' is a $sort, $skip or $limit which can be moved before a preceding
+ * stage which outputs one document for each input, in the same order, and which modifies the paths
+ * described by 'modifiedPathsRet'.
+ */
+bool canMoveBeforeOrderPreservingStage(DocumentSource* nextStage,
+                                       const DocumentSource::GetModPathsReturn& modifiedPathsRet) {
+    if (dynamic_cast<DocumentSourceSkip*>(nextStage) ||
+        dynamic_cast<DocumentSourceLimit*>(nextStage)) {
+        // The preceding stage neither adds nor removes documents, so the same documents are
+        // skipped or returned whichever of the two runs first.
+        return true;
+    }
+
+    auto nextSort = dynamic_cast<DocumentSourceSort*>(nextStage);
+    if (!nextSort || nextSort->mergingPresorted() ||
+        modifiedPathsRet.type != DocumentSource::GetModPathsReturn::Type::kFiniteSet) {
+        return false;
+    }
+
+    // The $sort can only be moved if the preceding stage does not modify anything it sorts by.
+    DepsTracker deps;
+    nextSort->getDependencies(&deps);
+    for (auto&& dependency : deps.fields) {
+        for (auto&& modifiedPath : modifiedPathsRet.paths) {
+            if (dependency == modifiedPath ||
+                expression::isPathPrefixOf(dependency, modifiedPath) ||
+                expression::isPathPrefixOf(modifiedPath, dependency)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
 Pipeline::SourceContainer::iterator DocumentSource::optimizeAt(
@@ -199,6 +237,15 @@ Pipeline::SourceContainer::iterator DocumentSource::optimizeAt(
                                                         : std::prev(std::prev(itr));
         }
     }
+
+    if (constraints().canSwapWithSortSkipAndLimit &&
+        canMoveBeforeOrderPreservingStage(std::next(itr)->get(), getModifiedPaths())) {
+        // Swap the $sort, $skip or $limit before ourselves, so that we process fewer documents or
+        // the $sort can be pushed down further. The stage before us may be able to optimize it
+        // further, for instance by coalescing a $limit into a $sort, so return to that stage.
+        std::swap(*itr, *std::next(itr));
+        return itr == container->begin() ? itr : std::prev(itr);
+    }
     return doOptimizeAt(itr, container);
 }
 
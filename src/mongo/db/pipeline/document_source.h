@@ -339,6 +339,15 @@ public:
         // True if a subsequent $limit stage can be moved before this stage in the pipeline. This is
         // true if this stage does not add or remove documents from the pipeline.
         bool canSwapWithLimit = false;
+
+        // True if a subsequent $sort, $skip or $limit stage should be moved before this stage,
+        // provided that the $sort does not depend on the paths returned by getModifiedPaths().
+        //
+        // Only a stage which outputs exactly one document for each input, in the same order, may
+        // set this to true, and it should only do so if it is expensive enough per document that
+        // it is worth running on fewer or already sorted documents. Such a stage must also set
+        // 'canSwapWithLimit' and override getModifiedPaths().
+        bool canSwapWithSortSkipAndLimit = false;
     };
 
     using ChangeStreamRequirement = StageConstraints::ChangeStreamRequirement;
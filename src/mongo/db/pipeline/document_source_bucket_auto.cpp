@@ -30,8 +30,12 @@
 
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -52,13 +56,17 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::getNext() {
     pExpCtx->checkForInterrupt();
 
     if (!_populated) {
-        const auto populationResult = populateSorter();
+        const auto populationResult = _approximate ? populateRanges() : populateSorter();
         if (populationResult.isPaused()) {
             return populationResult;
         }
         invariant(populationResult.isEOF());
 
-        populateBuckets();
+        if (_approximate) {
+            populateBucketsFromRanges();
+        } else {
+            populateBuckets();
+        }
 
         _populated = true;
         _bucketsIterator = _buckets.begin();
@@ -113,6 +121,106 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     return next;
 }
 
+DocumentSource::GetNextResult DocumentSourceBucketAuto::populateRanges() {
+    const auto& valueCmp = pExpCtx->getValueComparator();
+    const size_t maxRanges = static_cast<size_t>(_nBuckets) *
+        internalDocumentSourceBucketAutoApproximateRangesPerBucket.load();
+    // Buffering many times more documents than there are ranges before merging ranges makes the
+    // first ranges, which all later documents fall in, a less noisy sample of the input.
+    const size_t maxUnrangedInput = 16 * maxRanges;
+
+    auto next = pSource->getNext();
+    for (; next.isAdvanced(); next = pSource->getNext()) {
+        auto nextDoc = next.releaseDocument();
+        Value key = extractKey(nextDoc);
+        _nDocuments++;
+
+        // Find the last range whose minimum is not greater than 'key'.
+        auto range = std::upper_bound(
+            _ranges.begin(), _ranges.end(), key, [&valueCmp](const Value& lhs, const Bucket& rhs) {
+                return valueCmp.evaluate(lhs < rhs._min);
+            });
+        if (range != _ranges.begin() && valueCmp.evaluate(key <= std::prev(range)->_max)) {
+            Bucket& containingRange = *std::prev(range);
+            _rangesMemoryUsageBytes -= getRangeMemoryUsage(containingRange);
+            addDocumentToRange(nextDoc, containingRange);
+            _rangesMemoryUsageBytes += getRangeMemoryUsage(containingRange);
+        } else {
+            _unrangedInputMemoryUsageBytes +=
+                key.getApproximateSize() + nextDoc.getApproximateSize();
+            _unrangedInput.emplace_back(std::move(key), std::move(nextDoc));
+            if (_unrangedInput.size() >= maxUnrangedInput ||
+                _unrangedInputMemoryUsageBytes > _maxMemoryUsageBytes / 2) {
+                rangeUnrangedInput(true);
+            }
+        }
+
+        uassert(50914,
+                "Exceeded memory limit for $bucketAuto with 'approximate', which cannot spill to "
+                "disk. Request fewer buckets, or accumulators that use less memory.",
+                _rangesMemoryUsageBytes + _unrangedInputMemoryUsageBytes <= _maxMemoryUsageBytes);
+    }
+    return next;
+}
+
+void DocumentSourceBucketAuto::rangeUnrangedInput(bool compact) {
+    const auto& valueCmp = pExpCtx->getValueComparator();
+
+    // The sort is stable so that each range sees its documents in the order they arrived.
+    std::stable_sort(
+        _unrangedInput.begin(),
+        _unrangedInput.end(),
+        [&valueCmp](const pair<Value, Document>& lhs, const pair<Value, Document>& rhs) {
+            return valueCmp.evaluate(lhs.first < rhs.first);
+        });
+
+    // None of the buffered values fell in an existing range, so the new ranges go between them.
+    vector<Bucket> ranges;
+    ranges.reserve(_ranges.size() + _unrangedInput.size());
+    auto existingRange = _ranges.begin();
+    for (auto&& entry : _unrangedInput) {
+        if (!ranges.empty() && valueCmp.evaluate(ranges.back()._max == entry.first)) {
+            addDocumentToRange(entry.second, ranges.back());
+            continue;
+        }
+        while (existingRange != _ranges.end() &&
+               valueCmp.evaluate(existingRange->_min < entry.first)) {
+            ranges.push_back(std::move(*existingRange++));
+        }
+        ranges.emplace_back(pExpCtx, entry.first, entry.first, _accumulatedFields);
+        addDocumentToRange(entry.second, ranges.back());
+    }
+    std::move(existingRange, _ranges.end(), std::back_inserter(ranges));
+    _unrangedInput.clear();
+    _unrangedInputMemoryUsageBytes = 0;
+
+    const size_t maxRanges = static_cast<size_t>(_nBuckets) *
+        internalDocumentSourceBucketAutoApproximateRangesPerBucket.load();
+    if (compact && ranges.size() > maxRanges) {
+        // Merge each range into the one before it while their combined count stays within twice
+        // the average. Any two consecutive ranges left exceed that, so at most about 'maxRanges'
+        // remain.
+        const long long maxMergedCount =
+            std::max(1LL, 2 * _nDocuments / static_cast<long long>(maxRanges));
+        vector<Bucket> compacted;
+        compacted.reserve(maxRanges + 1);
+        for (auto&& range : ranges) {
+            if (!compacted.empty() && compacted.back()._count + range._count <= maxMergedCount) {
+                mergeRangeIntoBucket(range, compacted.back());
+            } else {
+                compacted.push_back(std::move(range));
+            }
+        }
+        ranges = std::move(compacted);
+    }
+    _ranges = std::move(ranges);
+
+    _rangesMemoryUsageBytes = 0;
+    for (auto&& range : _ranges) {
+        _rangesMemoryUsageBytes += getRangeMemoryUsage(range);
+    }
+}
+
 Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     if (!_groupByExpression) {
         return Value(BSONNULL);
@@ -155,6 +263,34 @@ void DocumentSourceBucketAuto::addDocumentToBucket(const pair<Value, Document>&
     }
 }
 
+void DocumentSourceBucketAuto::addDocumentToRange(const Document& doc, Bucket& range) {
+    range._count++;
+
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        range._accums[k]->process(_accumulatedFields[k].expression->evaluate(doc), false);
+    }
+}
+
+void DocumentSourceBucketAuto::mergeRangeIntoBucket(Bucket& from, Bucket& into) {
+    into._max = from._max;
+    into._count += from._count;
+
+    const bool toBeMerged = true;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        into._accums[k]->process(from._accums[k]->getValue(toBeMerged), toBeMerged);
+    }
+}
+
+size_t DocumentSourceBucketAuto::getRangeMemoryUsage(const Bucket& range) const {
+    size_t memoryUsageBytes = range._min.getApproximateSize() + range._max.getApproximateSize();
+    for (auto&& accum : range._accums) {
+        memoryUsageBytes += accum->memUsageForSorter();
+    }
+    return memoryUsageBytes;
+}
+
 void DocumentSourceBucketAuto::populateBuckets() {
     invariant(_sorter);
     _sortedInput.reset(_sorter->done());
@@ -254,6 +390,72 @@ void DocumentSourceBucketAuto::populateBuckets() {
         addBucket(currentBucket);
     }
 
+    roundOuterBoundaries();
+}
+
+void DocumentSourceBucketAuto::populateBucketsFromRanges() {
+    rangeUnrangedInput(false);
+
+    // If there are no buckets, then we don't need to populate anything.
+    if (_nBuckets == 0) {
+        return;
+    }
+
+    // As in populateBuckets(), we attempt to fill each bucket with this many documents. A range
+    // is never split, so like the documents with the same value, all of the documents in it go
+    // in the same bucket. Until ranges are merged, each holds a single value, and this gives the
+    // same buckets as populateBuckets().
+    long long approxBucketSize = std::round(double(_nDocuments) / double(_nBuckets));
+    if (approxBucketSize < 1) {
+        approxBucketSize = 1;
+    }
+
+    const auto& valueCmp = pExpCtx->getValueComparator();
+    auto range = _ranges.begin();
+    for (int i = 0; i < _nBuckets && range != _ranges.end(); i++) {
+        bool isLastBucket = (i == _nBuckets - 1);
+
+        Bucket currentBucket = std::move(*range++);
+
+        if (isLastBucket) {
+            while (range != _ranges.end()) {
+                mergeRangeIntoBucket(*range++, currentBucket);
+            }
+        } else {
+            while (currentBucket._count < approxBucketSize && range != _ranges.end()) {
+                // A range of several values may instead start the next bucket, if that leaves this
+                // one closer to the size we attempt.
+                const long long overshoot = currentBucket._count + range->_count - approxBucketSize;
+                if (valueCmp.evaluate(range->_min != range->_max) &&
+                    overshoot > approxBucketSize - currentBucket._count) {
+                    break;
+                }
+                mergeRangeIntoBucket(*range++, currentBucket);
+            }
+
+            if (_granularityRounder) {
+                Value boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+                // Absorb the ranges that start before the rounded boundary, which may move it.
+                while (range != _ranges.end() &&
+                       valueCmp.evaluate(boundaryValue > range->_min)) {
+                    mergeRangeIntoBucket(*range++, currentBucket);
+                    boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+                }
+                if (range != _ranges.end()) {
+                    currentBucket._max = boundaryValue;
+                }
+            }
+        }
+
+        addBucket(currentBucket);
+    }
+    _ranges.clear();
+    _rangesMemoryUsageBytes = 0;
+
+    roundOuterBoundaries();
+}
+
+void DocumentSourceBucketAuto::roundOuterBoundaries() {
     if (!_buckets.empty() && _granularityRounder) {
         // If we we have a granularity, we round the first bucket's minimum down and the last
         // bucket's maximum up. This way all of the bucket boundaries are rounded to numbers in the
@@ -328,6 +530,8 @@ Document DocumentSourceBucketAuto::makeDocument(const Bucket& bucket) {
 
 void DocumentSourceBucketAuto::doDispose() {
     _sortedInput.reset();
+    _ranges.clear();
+    _unrangedInput.clear();
     _bucketsIterator = _buckets.end();
 }
 
@@ -342,6 +546,10 @@ Value DocumentSourceBucketAuto::serialize(
         insides["granularity"] = Value(_granularityRounder->getName());
     }
 
+    if (_approximate) {
+        insides["approximate"] = Value(true);
+    }
+
     MutableDocument outputSpec(_accumulatedFields.size());
     for (auto&& accumulatedField : _accumulatedFields) {
         intrusive_ptr<Accumulator> accum = accumulatedField.makeAccumulator(pExpCtx);
@@ -360,7 +568,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes) {
+    uint64_t maxMemoryUsageBytes,
+    bool approximate) {
     uassert(40243,
             str::stream() << "The $bucketAuto 'buckets' field must be greater than 0, but found: "
                           << numBuckets,
@@ -376,7 +585,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
                                         numBuckets,
                                         accumulationStatements,
                                         granularityRounder,
-                                        maxMemoryUsageBytes);
+                                        maxMemoryUsageBytes,
+                                        approximate);
 }
 
 DocumentSourceBucketAuto::DocumentSourceBucketAuto(
@@ -385,12 +595,14 @@ DocumentSourceBucketAuto::DocumentSourceBucketAuto(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes)
+    uint64_t maxMemoryUsageBytes,
+    bool approximate)
     : DocumentSource(pExpCtx),
       _nBuckets(numBuckets),
       _maxMemoryUsageBytes(maxMemoryUsageBytes),
       _groupByExpression(groupByExpression),
-      _granularityRounder(granularityRounder) {
+      _granularityRounder(granularityRounder),
+      _approximate(approximate) {
 
     invariant(!accumulationStatements.empty());
     for (auto&& accumulationStatement : accumulationStatements) {
@@ -432,6 +644,7 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
     boost::intrusive_ptr<Expression> groupByExpression;
     boost::optional<int> numBuckets;
     boost::intrusive_ptr<GranularityRounder> granularityRounder;
+    bool approximate = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -472,6 +685,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
                         << typeName(argument.type()),
                     argument.type() == BSONType::String);
             granularityRounder = GranularityRounder::getGranularityRounder(pExpCtx, argument.str());
+        } else if ("approximate" == argName) {
+            uassert(50915,
+                    str::stream()
+                        << "The $bucketAuto 'approximate' field must be a boolean, but found type: "
+                        << typeName(argument.type()),
+                    argument.type() == BSONType::Bool);
+            approximate = argument.boolean();
         } else {
             uasserted(40245, str::stream() << "Unrecognized option to $bucketAuto: " << argName);
         }
@@ -481,8 +701,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             "$bucketAuto requires 'groupBy' and 'buckets' to be specified",
             groupByExpression && numBuckets);
 
-    return DocumentSourceBucketAuto::create(
-        pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+    return DocumentSourceBucketAuto::create(pExpCtx,
+                                            groupByExpression,
+                                            numBuckets.get(),
+                                            accumulationStatements,
+                                            granularityRounder,
+                                            kDefaultMaxMemoryUsageBytes,
+                                            approximate);
 }
 }  // namespace mongo
 
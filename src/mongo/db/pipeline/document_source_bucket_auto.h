@@ -40,6 +40,17 @@ namespace mongo {
 /**
  * The $bucketAuto stage takes a user-specified number of buckets and automatically determines
  * boundaries such that the values are approximately equally distributed between those buckets.
+ *
+ * By default, the stage sorts all of its input by the 'groupBy' value. With 'approximate: true',
+ * it instead keeps the input in a bounded number of disjoint ranges of 'groupBy' values, each
+ * holding the count and partial accumulators of its documents. A document whose value falls in a
+ * range goes straight into it. The others are buffered, and once the buffer is full they become
+ * ranges of their own, after which adjacent ranges are merged until there are at most
+ * internalDocumentSourceBucketAutoApproximateRangesPerBucket ranges per bucket. At the end, the
+ * buckets are made of consecutive ranges, so a boundary is only approximate when the ranges on
+ * either side of it were merged. Inputs that never fill the buffer get the same buckets as without
+ * 'approximate', except that $first and $last see the documents of a bucket in the order they
+ * arrived rather than in 'groupBy' order.
  */
 class DocumentSourceBucketAuto final : public DocumentSource, public NeedsMergerDocumentSource {
 public:
@@ -81,7 +92,8 @@ public:
         int numBuckets,
         std::vector<AccumulationStatement> accumulationStatements = {},
         const boost::intrusive_ptr<GranularityRounder>& granularityRounder = nullptr,
-        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
+        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes,
+        bool approximate = false);
 
     /**
      * Parses a $bucketAuto stage from the user-supplied BSON.
@@ -98,7 +110,8 @@ private:
                              int numBuckets,
                              std::vector<AccumulationStatement> accumulationStatements,
                              const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-                             uint64_t maxMemoryUsageBytes);
+                             uint64_t maxMemoryUsageBytes,
+                             bool approximate);
 
     // struct for holding information about a bucket.
     struct Bucket {
@@ -109,6 +122,8 @@ private:
         Value _min;
         Value _max;
         std::vector<boost::intrusive_ptr<Accumulator>> _accums;
+        // The number of documents in the bucket. Only maintained with 'approximate'.
+        long long _count = 0;
     };
 
     /**
@@ -119,6 +134,19 @@ private:
      */
     GetNextResult populateSorter();
 
+    /**
+     * Consumes all of the documents from the source in the pipeline into '_ranges', for
+     * 'approximate'. Like populateSorter(), it returns the last GetNextResult encountered.
+     */
+    GetNextResult populateRanges();
+
+    /**
+     * Turns the documents in '_unrangedInput' into ranges of a single 'groupBy' value, and merges
+     * them into '_ranges'. If 'compact' is true, then adjacent ranges are merged afterwards until
+     * there are no more than the configured number of ranges per bucket.
+     */
+    void rangeUnrangedInput(bool compact);
+
     /**
      * Computes the 'groupBy' expression value for 'doc'.
      */
@@ -129,11 +157,39 @@ private:
      */
     void populateBuckets();
 
+    /**
+     * Places the ranges of documents in '_ranges' into buckets, for 'approximate'.
+     */
+    void populateBucketsFromRanges();
+
+    /**
+     * Rounds the minimum of the first bucket down and the maximum of the last bucket up, if there
+     * is a granularity.
+     */
+    void roundOuterBoundaries();
+
     /**
      * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'.
      */
     void addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
 
+    /**
+     * Adds 'doc' to 'range', whose boundaries the caller is responsible for, by updating its count
+     * and accumulators.
+     */
+    void addDocumentToRange(const Document& doc, Bucket& range);
+
+    /**
+     * Adds the documents in 'from', which must come after those in 'into', to 'into' by merging
+     * their accumulators.
+     */
+    void mergeRangeIntoBucket(Bucket& from, Bucket& into);
+
+    /**
+     * Returns the approximate memory used by 'range'.
+     */
+    size_t getRangeMemoryUsage(const Bucket& range) const;
+
     /**
      * Adds 'newBucket' to _buckets and updates any boundaries if necessary.
      */
@@ -158,6 +214,16 @@ private:
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
+
+    bool _approximate;
+
+    // With 'approximate', the disjoint ranges of 'groupBy' values seen so far, in order, and the
+    // documents whose values fell in none of them, with those values. '_rangesMemoryUsageBytes'
+    // and '_unrangedInputMemoryUsageBytes' track the memory they use.
+    std::vector<Bucket> _ranges;
+    std::vector<std::pair<Value, Document>> _unrangedInput;
+    size_t _rangesMemoryUsageBytes = 0;
+    size_t _unrangedInputMemoryUsageBytes = 0;
 };
 
 }  // namespace mongo
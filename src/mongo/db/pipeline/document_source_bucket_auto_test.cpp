@@ -45,8 +45,10 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -503,6 +505,15 @@ TEST_F(BucketAutoTests, SerializesGranularityFieldIfSpecified) {
     testSerialize(spec, expected);
 }
 
+TEST_F(BucketAutoTests, SerializesApproximateFieldIfSpecified) {
+    BSONObj spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true}}");
+    BSONObj expected = fromjson(
+        "{groupBy : '$x', buckets : 2, approximate : true, output : {count : {$sum : {$const : "
+        "1}}}}");
+
+    testSerialize(spec, expected);
+}
+
 TEST_F(BucketAutoTests, ShouldBeAbleToReParseSerializedStage) {
     auto bucketAuto =
         createBucketAuto(fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, granularity: 'R5', "
@@ -587,6 +598,11 @@ TEST_F(BucketAutoTests, FailsWhenBucketsMissing) {
     ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 40246);
 }
 
+TEST_F(BucketAutoTests, FailsWithNonBooleanApproximate) {
+    auto spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 1, approximate : 1}}");
+    ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 50915);
+}
+
 TEST_F(BucketAutoTests, FailsWithUnknownField) {
     auto spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 1, field : 'test'}}");
     ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 40245);
@@ -802,5 +818,86 @@ TEST_F(BucketAutoTests, ShouldFailOnNegativeNumbersWhenGranularitySpecified) {
         AssertionException,
         40260);
 }
+TEST_F(BucketAutoTests, ApproximateMatchesExactWhenInputFitsInBuffer) {
+    // Values are 0 to 16, each 5 or 6 times, in an order unrelated to the values.
+    deque<Document> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.push_back(Document{{"x", (i * 7) % 17}, {"y", i}});
+    }
+
+    for (auto&& spec : {"{groupBy : '$x', buckets : 1}",
+                        "{groupBy : '$x', buckets : 4}",
+                        "{groupBy : '$x', buckets : 30}",
+                        "{groupBy : '$x', buckets : 3, granularity : 'R5'}",
+                        "{groupBy : '$x', buckets : 5, output : {n : {$sum : 1}, "
+                        "avg : {$avg : '$y'}, min : {$min : '$y'}, max : {$max : '$y'}}}"}) {
+        BSONObj exactSpec = BSON("$bucketAuto" << fromjson(spec));
+        BSONObjBuilder approximateSpec(fromjson(spec));
+        approximateSpec.append("approximate", true);
+
+        auto exactResults = getResults(exactSpec, inputs);
+        auto approximateResults =
+            getResults(BSON("$bucketAuto" << approximateSpec.obj()), inputs);
+        ASSERT_EQUALS(exactResults.size(), approximateResults.size());
+        for (size_t i = 0; i < exactResults.size(); ++i) {
+            ASSERT_DOCUMENT_EQ(exactResults[i], approximateResults[i]);
+        }
+    }
+}
+
+TEST_F(BucketAutoTests, ApproximateKeepsBucketsBalancedAfterMergingRanges) {
+    const auto rangesPerBucket = internalDocumentSourceBucketAutoApproximateRangesPerBucket.load();
+    ON_BLOCK_EXIT([rangesPerBucket] {
+        internalDocumentSourceBucketAutoApproximateRangesPerBucket.store(rangesPerBucket);
+    });
+    // With 4 buckets, ranges are merged down to 32 each time 512 documents are buffered.
+    internalDocumentSourceBucketAutoApproximateRangesPerBucket.store(8);
+
+    // Values are 0 to 9999, each once, in an order unrelated to the values.
+    const int numDocuments = 10000;
+    deque<Document> inputs;
+    for (int i = 0; i < numDocuments; ++i) {
+        inputs.push_back(Document{{"x", (i * 7919) % numDocuments}});
+    }
+
+    auto results = getResults(
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 4, approximate : true}}"), inputs);
+    ASSERT_EQUALS(results.size(), 4UL);
+    ASSERT_VALUE_EQ(results.front()["_id"]["min"], Value(0));
+    ASSERT_VALUE_EQ(results.back()["_id"]["max"], Value(numDocuments - 1));
+
+    int total = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (i > 0) {
+            ASSERT_VALUE_EQ(results[i - 1]["_id"]["max"], results[i]["_id"]["min"]);
+        }
+        const int count = results[i]["count"].getInt();
+        ASSERT_GTE(count, 1500) << results[i].toString();
+        ASSERT_LTE(count, 3500) << results[i].toString();
+        total += count;
+    }
+    ASSERT_EQUALS(total, numDocuments);
+}
+
+TEST_F(BucketAutoTests, ApproximateFailsWhenRangesExceedMemoryLimit) {
+    auto expCtx = getExpCtx();
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
+    const bool approximate = true;
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(
+        expCtx, groupByExpression, 2, {}, nullptr, maxMemoryUsageBytes, approximate);
+
+    // Allowing the use of disk does not help.
+    expCtx->allowDiskUse = true;
+    string largeStr(maxMemoryUsageBytes / 2, 'x');
+    auto mock = DocumentSourceMock::create({Document{{"a", largeStr + "0"}},
+                                            Document{{"a", largeStr + "1"}},
+                                            Document{{"a", largeStr + "2"}}});
+    bucketAutoStage->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(bucketAutoStage->getNext(), AssertionException, 50914);
+}
 }  // namespace
 }  // namespace mongo
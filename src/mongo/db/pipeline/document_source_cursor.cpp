@@ -64,7 +64,12 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
 }
 
 Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
-    return _dependencies ? _dependencies->extractFields(obj) : Document::fromBsonWithMetaData(obj);
+    if (_dependencies) {
+        return _dependencies->extractFields(obj);
+    }
+    return internalDocumentSourceCursorLazyDocuments.load()
+        ? Document::fromBsonWithMetaDataLazily(obj)
+        : Document::fromBsonWithMetaData(obj);
 }
 
 void DocumentSourceCursor::loadBatch() {
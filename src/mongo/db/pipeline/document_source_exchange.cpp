@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <iterator>
 
+#include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/util/log.h"
@@ -76,8 +77,9 @@ DocumentSource::GetNextResult DocumentSourceExchange::getNext() {
     return _exchange->getNext(_consumerId);
 }
 
-Exchange::Exchange(const ExchangeSpec& spec)
+Exchange::Exchange(const ExchangeSpec& spec, bool producerDriven)
     : _spec(spec),
+      _producerDriven(producerDriven),
       _keyPattern(spec.getKey().getOwned()),
       _boundaries(extractBoundaries(spec.getBoundaries())),
       _policy(spec.getPolicy()),
@@ -130,6 +132,9 @@ DocumentSource::GetNextResult Exchange::getNext(size_t consumerId) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     for (;;) {
+        // Fail everybody once the exchange has been aborted.
+        uassertStatusOK(_errorStatus);
+
         // Check if we have a document.
         if (!_consumers[consumerId]->isEmpty()) {
             auto doc = _consumers[consumerId]->getNext();
@@ -144,7 +149,7 @@ DocumentSource::GetNextResult Exchange::getNext(size_t consumerId) {
         }
 
         // There is not any document so try to load more from the source.
-        if (_loadingThreadId == kInvalidThreadId) {
+        if (!_producerDriven && _loadingThreadId == kInvalidThreadId) {
             LOG(3) << "A consumer " << consumerId << " begins loading";
 
             // This consumer won the race and will fill the buffers.
@@ -153,7 +158,16 @@ DocumentSource::GetNextResult Exchange::getNext(size_t consumerId) {
             // This will return when some exchange buffer is full and we cannot make any forward
             // progress anymore.
             // The return value is an index of a full consumer buffer.
-            size_t fullConsumerId = loadNextBatch();
+            size_t fullConsumerId;
+            try {
+                fullConsumerId = loadNextBatch();
+            } catch (const DBException& ex) {
+                // Nobody else can load from the failed source, so fail the waiting consumers
+                // rather than leave them waiting forever.
+                _errorStatus = ex.toStatus();
+                _haveBufferSpace.notify_all();
+                throw;
+            }
 
             // The loading cannot continue until the consumer with the full buffer consumes some
             // documents.
@@ -162,13 +176,72 @@ DocumentSource::GetNextResult Exchange::getNext(size_t consumerId) {
             // Wake up everybody and try to make some progress.
             _haveBufferSpace.notify_all();
         } else {
-            // Some other consumer is already loading the buffers. There is nothing else we can do
-            // but wait.
+            // Some other consumer (or the producer) is already loading the buffers. There is
+            // nothing else we can do but wait.
             _haveBufferSpace.wait(lk);
         }
     }
 }
 
+void Exchange::produce(OperationContext* opCtx) {
+    invariant(_producerDriven);
+    invariant(_policy != ExchangePolicyEnum::kBroadcast);
+
+    for (;;) {
+        // Only the producer reads from the source, so the lock is not held while doing so, which
+        // lets the consumers drain their buffers in the meantime.
+        auto input = pSource->getNext();
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        uassertStatusOK(_errorStatus);
+
+        if (!input.isAdvanced()) {
+            invariant(input.isEOF());
+
+            // We have reached the end so send EOS to all consumers.
+            for (auto& c : _consumers) {
+                c->appendDocument(input, _maxBufferSize);
+            }
+            _haveBufferSpace.notify_all();
+            return;
+        }
+
+        size_t target = 0;
+        if (_policy == ExchangePolicyEnum::kRoundRobin) {
+            target = _roundRobinCounter;
+            _roundRobinCounter = (_roundRobinCounter + 1) % _consumers.size();
+        } else if (_policy == ExchangePolicyEnum::kRange) {
+            target = getTargetConsumer(input.getDocument());
+        }
+
+        // A consumer can only be waiting if its buffer is empty.
+        const bool wasEmpty = _consumers[target]->isEmpty();
+        const bool full = _consumers[target]->appendDocument(std::move(input), _maxBufferSize);
+        if (wasEmpty) {
+            _haveBufferSpace.notify_all();
+        }
+
+        if (full) {
+            // The target consumer resets '_loadingThreadId' once it has consumed a document.
+            _loadingThreadId = target;
+            opCtx->waitForConditionOrInterrupt(_haveBufferSpace, lk, [&] {
+                return _loadingThreadId == kInvalidThreadId || !_errorStatus.isOK();
+            });
+            uassertStatusOK(_errorStatus);
+        }
+    }
+}
+
+void Exchange::abort(Status status) {
+    invariant(!status.isOK());
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_errorStatus.isOK()) {
+        _errorStatus = std::move(status);
+    }
+    _haveBufferSpace.notify_all();
+}
+
 size_t Exchange::loadNextBatch() {
     auto input = pSource->getNext();
 
@@ -45,9 +45,26 @@ class Exchange : public RefCountable {
         const boost::optional<std::vector<BSONObj>>& obj);
 
 public:
-    explicit Exchange(const ExchangeSpec& spec);
+    /**
+     * If 'producerDriven' is true the consumers never load their buffers themselves, and a single
+     * producer thread must feed them by calling produce().
+     */
+    explicit Exchange(const ExchangeSpec& spec, bool producerDriven = false);
     DocumentSource::GetNextResult getNext(size_t consumerId);
 
+    /**
+     * Reads the source until EOF and distributes its documents among the consumers, blocking
+     * whenever the buffer of a consumer is full until that consumer makes some progress. Waits are
+     * interruptible via 'opCtx'. Only valid when the exchange is producer driven.
+     */
+    void produce(OperationContext* opCtx);
+
+    /**
+     * Wakes up all waiting consumers and the producer, and makes every subsequent call to getNext()
+     * or produce() fail with 'status', which must not be OK. Only the first error is kept.
+     */
+    void abort(Status status);
+
     size_t getConsumers() const {
         return _consumers.size();
     }
@@ -81,6 +98,10 @@ private:
     // Keep a copy of the spec for serialization purposes.
     const ExchangeSpec _spec;
 
+    // If set to true then documents are pushed to the consumers by produce() rather than loaded by
+    // a consumer which has run out of documents.
+    const bool _producerDriven;
+
     // A pattern for extracting a key from a document used by range and hash policies.
     const BSONObj _keyPattern;
 
@@ -109,6 +130,9 @@ private:
 
     size_t _roundRobinCounter{0};
 
+    // Set when the exchange has been aborted, or when loading the source failed.
+    Status _errorStatus = Status::OK();
+
     std::vector<std::unique_ptr<ExchangeBuffer>> _consumers;
 };
 
@@ -326,4 +326,70 @@ TEST_F(DocumentSourceExchangeTest, RangeRandomExchangeNConsumer) {
 
     ASSERT_EQ(nDocs, processedDocs.load());
 }
+
+TEST_F(DocumentSourceExchangeTest, ProducerDrivenExchangeNConsumer) {
+    const size_t nDocs = 500;
+    auto source = getMockSource(nDocs);
+
+    const size_t nConsumers = 5;
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(nConsumers);
+    spec.setBufferSize(1024);
+
+    boost::intrusive_ptr<Exchange> ex = new Exchange(spec, true);
+    ex->setSource(source.get());
+
+    std::vector<executor::TaskExecutor::CallbackHandle> handles;
+
+    for (size_t id = 0; id < nConsumers; ++id) {
+        auto handle = _executor->scheduleWork(
+            [ex, id, nDocs, nConsumers](const executor::TaskExecutor::CallbackArgs& cb) {
+                PseudoRandom prng(getNewSeed());
+
+                auto input = ex->getNext(id);
+
+                size_t docs = 0;
+                for (; input.isAdvanced(); input = ex->getNext(id)) {
+                    sleepmillis(prng.nextInt32() % 5 + 1);
+                    ++docs;
+                }
+                ASSERT_EQ(docs, nDocs / nConsumers);
+            });
+
+        handles.emplace_back(std::move(handle.getValue()));
+    }
+
+    // The consumers never load, so only this thread reads the source.
+    ex->produce(getExpCtx()->opCtx);
+
+    for (auto& h : handles)
+        _executor->wait(h);
+}
+
+TEST_F(DocumentSourceExchangeTest, AbortFailsTheProducerAndTheConsumers) {
+    auto source = getMockSource(500);
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(1);
+    spec.setBufferSize(1024);
+
+    boost::intrusive_ptr<Exchange> ex = new Exchange(spec, true);
+    ex->setSource(source.get());
+
+    // The consumer only takes a single document, so the producer is left waiting on a full buffer
+    // until the consumer aborts.
+    auto handle = _executor->scheduleWork([ex](const executor::TaskExecutor::CallbackArgs& cb) {
+        ASSERT_TRUE(ex->getNext(0).isAdvanced());
+        ex->abort(Status(ErrorCodes::InternalError, "consumer failed"));
+    });
+
+    ASSERT_THROWS_CODE(
+        ex->produce(getExpCtx()->opCtx), AssertionException, ErrorCodes::InternalError);
+    _executor->wait(handle.getValue());
+
+    ASSERT_THROWS_CODE(ex->getNext(0), AssertionException, ErrorCodes::InternalError);
+}
 }  // namespace mongo
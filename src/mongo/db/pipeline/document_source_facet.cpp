@@ -44,6 +44,7 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
@@ -58,7 +59,12 @@ using std::vector;
 DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
                                          const intrusive_ptr<ExpressionContext>& expCtx)
     : DocumentSource(expCtx),
-      _teeBuffer(TeeBuffer::create(facetPipelines.size())),
+      // A batch is always cut off after its first document when the buffer is a single byte, so
+      // in streaming mode each sub-pipeline pauses as soon as it has consumed the latest input.
+      _teeBuffer(TeeBuffer::create(facetPipelines.size(),
+                                   internalQueryFacetStreamInput.load()
+                                       ? 1
+                                       : internalQueryFacetBufferSizeBytes.load())),
       _facets(std::move(facetPipelines)) {
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
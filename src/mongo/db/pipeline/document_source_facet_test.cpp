@@ -43,8 +43,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -220,7 +222,7 @@ public:
                 TransactionRequirement::kAllowed};
     }
 
-    DocumentSource::GetNextResult getNext() final {
+    DocumentSource::GetNextResult getNext() override {
         return pSource->getNext();
     }
 
@@ -336,6 +338,64 @@ TEST_F(DocumentSourceFacetTest,
     ASSERT(facetStage->getNext().isEOF());
 }
 
+/**
+ * A DocumentSource which passes all input along, recording how many documents were still left in
+ * 'mock' each time it saw one.
+ */
+class DocumentSourceRecordsRemainingInput final : public DocumentSourcePassthrough {
+public:
+    explicit DocumentSourceRecordsRemainingInput(const DocumentSourceMock* mock) : _mock(mock) {}
+
+    GetNextResult getNext() final {
+        auto next = pSource->getNext();
+        if (next.isAdvanced()) {
+            remaining.push_back(_mock->queue.size());
+        }
+        return next;
+    }
+
+    std::vector<size_t> remaining;
+
+private:
+    const DocumentSourceMock* _mock;
+};
+
+TEST_F(DocumentSourceFacetTest, StreamingShouldHandEachDocumentToAllFacetsBeforeReadingTheNext) {
+    auto ctx = getExpCtx();
+    internalQueryFacetStreamInput.store(true);
+    ON_BLOCK_EXIT([] { internalQueryFacetStreamInput.store(false); });
+
+    deque<DocumentSource::GetNextResult> inputs = {
+        Document{{"_id", 0}}, Document{{"_id", 1}}, Document{{"_id", 2}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    boost::intrusive_ptr<DocumentSourceRecordsRemainingInput> firstRecorder(
+        new DocumentSourceRecordsRemainingInput(mock.get()));
+    auto firstPipeline = uassertStatusOK(Pipeline::createFacetPipeline({firstRecorder}, ctx));
+    boost::intrusive_ptr<DocumentSourceRecordsRemainingInput> secondRecorder(
+        new DocumentSourceRecordsRemainingInput(mock.get()));
+    auto secondPipeline = uassertStatusOK(Pipeline::createFacetPipeline({secondRecorder}, ctx));
+
+    std::vector<DocumentSourceFacet::FacetPipeline> facets;
+    facets.emplace_back("first", std::move(firstPipeline));
+    facets.emplace_back("second", std::move(secondPipeline));
+    auto facetStage = DocumentSourceFacet::create(std::move(facets), ctx);
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        output.getDocument(),
+        Document(fromjson("{first: [{_id: 0}, {_id: 1}, {_id: 2}], second: [{_id: 0}, {_id: 1}, "
+                          "{_id: 2}]}")));
+
+    // Neither facet should have seen a document before the other had seen all the previous ones.
+    const std::vector<size_t> expectedRemaining{2, 1, 0};
+    ASSERT(firstRecorder->remaining == expectedRemaining);
+    ASSERT(secondRecorder->remaining == expectedRemaining);
+    ASSERT(facetStage->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldBeAbleToEvaluateMultipleStagesWithinOneSubPipeline) {
     auto ctx = getExpCtx();
 
@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -104,11 +105,8 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
-        // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+    while (auto result = popVisited()) {
+        results.push_back(Value(*result));
     }
 
     MutableDocument output(*_input);
@@ -127,7 +125,8 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        auto result = popVisited();
+        if (!result) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -140,10 +139,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
             performSearch();
             _visitedUsageBytes = 0;
             _outputIndex = 0;
+            result = popVisited();
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!result) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,23 +157,44 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(*result));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
     }
 }
 
+boost::optional<BSONObj> DocumentSourceGraphLookUp::popVisited() {
+    if (!_visited.empty()) {
+        // Remove elements one at a time to avoid consuming more memory.
+        auto it = _visited.begin();
+        auto result = std::move(it->second);
+        _visited.erase(it);
+        return result;
+    }
+
+    while (!_spilledVisited.empty()) {
+        auto& run = _spilledVisited.back();
+        if (run->more()) {
+            return run->next().second;
+        }
+        _spilledVisited.pop_back();
+    }
+
+    _spilledIds.clear();
+    return boost::none;
+}
+
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _spilledIds.clear();
+    _spilledVisited.clear();
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -184,7 +205,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
         // Check whether each key in the frontier exists in the cache or needs to be queried.
         auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
+        auto matchStages = makeMatchStagesFromFrontier(&cached);
 
         ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
         _frontier.swap(queried);
@@ -199,12 +220,12 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             checkMemoryUsage();
         }
 
-        if (matchStage) {
+        for (auto&& matchStage : matchStages) {
             // Query for all keys that were in the frontier and not in the cache, populating
             // '_frontier' for the next iteration of search.
 
             // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
+            _fromPipeline.back() = matchStage;
             auto pipeline = uassertStatusOK(
                 pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
             while (auto next = pipeline->getNext()) {
@@ -233,7 +254,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -256,10 +277,11 @@ bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long lo
         });
 
     // Add the object to our '_visited' list and update the size of '_visited' appropriately.
+    auto bson = result.toBson();
     _visitedUsageBytes += id.getApproximateSize();
-    _visitedUsageBytes += result.getApproximateSize();
+    _visitedUsageBytes += bson.objsize();
 
-    _visited[id] = std::move(result);
+    _visited[id] = std::move(bson);
 
     // We inserted into _visited, so return true.
     return true;
@@ -280,7 +302,7 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
+std::vector<BSONObj> DocumentSourceGraphLookUp::makeMatchStagesFromFrontier(
     DocumentUnorderedSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
     for (auto it = _frontier.begin(); it != _frontier.end();) {
@@ -298,35 +320,48 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
+    const size_t batchSize = internalDocumentSourceGraphLookupFrontierBatchSize.load();
+    const size_t maxValuesPerQuery = batchSize > 0 ? batchSize : _frontier.size();
+
+    // Leave plenty of room for the rest of the query under the maximum BSON size.
+    const int maxValueBytesPerQuery = BSONObjMaxUserSize / 2;
+
+    // Create queries of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
     //
-    // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
+    // We wrap each query in a $match so that it can be parsed into a DocumentSourceMatch when
     // constructing a pipeline to execute.
-    BSONObjBuilder match;
-    {
-        BSONObjBuilder query(match.subobjStart("$match"));
+    std::vector<BSONObj> matchStages;
+    auto value = _frontier.begin();
+    while (value != _frontier.end()) {
+        BSONObjBuilder match;
         {
-            BSONArrayBuilder andObj(query.subarrayStart("$and"));
-            if (_additionalFilter) {
-                andObj << *_additionalFilter;
-            }
-
+            BSONObjBuilder query(match.subobjStart("$match"));
             {
-                BSONObjBuilder connectToObj(andObj.subobjStart());
+                BSONArrayBuilder andObj(query.subarrayStart("$and"));
+                if (_additionalFilter) {
+                    andObj << *_additionalFilter;
+                }
+
                 {
-                    BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
+                    BSONObjBuilder connectToObj(andObj.subobjStart());
                     {
-                        BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
-                            in << value;
+                        BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
+                        {
+                            BSONArrayBuilder in(subObj.subarrayStart("$in"));
+                            for (size_t numValues = 0; value != _frontier.end() &&
+                                 numValues < maxValuesPerQuery && in.len() < maxValueBytesPerQuery;
+                                 ++value, ++numValues) {
+                                in << *value;
+                            }
                         }
                     }
                 }
             }
         }
+        matchStages.push_back(match.obj());
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return matchStages;
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -388,13 +423,35 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    // The results of a search are only spilled if they are unwound, since otherwise they must all
+    // be returned in a single document anyway.
+    if (_unwind && pExpCtx->allowDiskUse && !_visited.empty() &&
+        (_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes) {
+        spillVisited();
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillVisited() {
+    // The documents are returned in no particular order, so they need not be sorted.
+    SortedFileWriter<Value, BSONObj> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& entry : _visited) {
+        const size_t docSize = entry.second.objsize();
+        invariant(docSize <= _visitedUsageBytes);
+        _visitedUsageBytes -= docSize;
+
+        writer.addAlreadySorted(entry.first, entry.second);
+        _spilledIds.insert(entry.first);
+    }
+    _visited.clear();
+
+    _spilledVisited.emplace_back(writer.done());
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -464,8 +521,10 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
-      _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _visited(ValueComparator::kInstance.makeUnorderedValueMap<BSONObj>()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
@@ -602,3 +661,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
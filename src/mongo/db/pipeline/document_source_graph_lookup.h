@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -54,14 +55,21 @@ public:
     GetModPathsReturn getModifiedPaths() const final;
 
     StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        // Only the results of a search which are unwound may be spilled, see checkMemoryUsage().
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     _unwind ? DiskUseRequirement::kWritesTmpData
+                                             : DiskUseRequirement::kNoDiskUse,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
         constraints.canSwapWithMatch = true;
+
+        // Without an absorbed $unwind, we output exactly one document for each input, and each
+        // of them requires a search of the foreign collection.
+        constraints.canSwapWithLimit = !_unwind;
+        constraints.canSwapWithSortSkipAndLimit = !_unwind;
         return constraints;
     }
 
@@ -121,15 +129,17 @@ private:
     }
 
     /**
-     * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * Prepares the queries to execute on the 'from' collection wrapped in a $match by using the
+     * contents of '_frontier'. The values are split among several queries if there are more than
+     * 'internalDocumentSourceGraphLookupFrontierBatchSize' of them, or if they are too large to fit
+     * in a single query.
      *
      * Fills 'cached' with any values that were retrieved from the cache.
      *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Returns an empty vector if no query is necessary, i.e., all values were retrieved from the
+     * cache.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    std::vector<BSONObj> makeMatchStagesFromFrontier(DocumentUnorderedSet* cached);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -157,10 +167,22 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If the
+     * results are unwound and disk use is allowed, first spills '_visited' if it is too large.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to a file, keeping only their '_id's in memory.
+     */
+    void spillVisited();
+
+    /**
+     * Removes and returns one of the documents discovered by the last search, or returns
+     * boost::none once they have all been returned.
+     */
+    boost::optional<BSONObj> popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -186,7 +208,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -196,9 +218,14 @@ private:
     ValueUnorderedSet _frontier;
 
     // Tracks nodes that have been discovered for a given input. Keys are the '_id' value of the
-    // document from the foreign collection, value is the document itself.  The keys are compared
-    // using the simple collation.
-    ValueUnorderedMap<Document> _visited;
+    // document from the foreign collection, value is the document itself, kept as BSON since that
+    // is more compact than a Document. The keys are compared using the simple collation.
+    ValueUnorderedMap<BSONObj> _visited;
+
+    // The '_id's of the discovered documents which have been spilled to '_spilledVisited', which
+    // must still be remembered to avoid discovering them again.
+    ValueUnorderedSet _spilledIds;
+    std::vector<std::unique_ptr<Sorter<Value, BSONObj>::Iterator>> _spilledVisited;
 
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -65,6 +68,7 @@ public:
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -87,8 +91,13 @@ public:
         return Status::OK();
     }
 
+    size_t numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
 private:
     std::deque<DocumentSource::GetNextResult> _results;
+    size_t _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceGraphLookUpTest,
@@ -389,6 +398,123 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     ASSERT_TRUE(graphLookupStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSplitLargeFrontiersIntoSeveralQueries) {
+    auto expCtx = getExpCtx();
+
+    const int originalBatchSize = internalDocumentSourceGraphLookupFrontierBatchSize.load();
+    internalDocumentSourceGraphLookupFrontierBatchSize.store(2);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupFrontierBatchSize.store(originalBatchSize); });
+
+    // The start document connects to five others, which must be queried for in three batches.
+    auto inputMock = DocumentSourceMock::create(Document{
+        {"_id", 0},
+        {"to", Value(std::vector<Value>{Value(1), Value(2), Value(3), Value(4), Value(5)})}});
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 1; i <= 5; ++i) {
+        fromContents.push_back(Document{{"_id", i}});
+    }
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "to"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(5U, resultsArray.size());
+    for (int i = 1; i <= 5; ++i) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(Document{{"_id", i}})));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+
+    // Three queries for the start document's frontier, then none for the empty frontier which
+    // follows it.
+    ASSERT_EQ(3U, mongoInterface->numPipelinesMade());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsWhenUnwinding) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const long long originalMaxMemory = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(1000);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemory); });
+
+    // A chain 0 -> 1 -> ... -> 19, each of whose documents is large enough that the search can only
+    // fit in memory if the documents already discovered are spilled.
+    const std::string padding(100, 'x');
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (int i = 0; i < 20; ++i) {
+        fromContents.push_back(Document{{"_id", i}, {"to", i + 1}, {"padding", padding}});
+    }
+
+    auto inputMock = DocumentSourceMock::create(Document{{"start", 0}});
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(fromContents);
+
+    auto unwindStage = DocumentSourceUnwind::create(expCtx, "results", false, boost::none);
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          unwindStage);
+    graphLookupStage->setSource(inputMock.get());
+    ASSERT(graphLookupStage->constraints(Pipeline::SplitState::kUnsplit).diskRequirement ==
+           DocumentSource::StageConstraints::DiskUseRequirement::kWritesTmpData);
+
+    std::vector<Value> results;
+    for (auto next = graphLookupStage->getNext(); next.isAdvanced();
+         next = graphLookupStage->getNext()) {
+        results.push_back(next.getDocument().getField("results"));
+    }
+    ASSERT_EQ(20U, results.size());
+    for (auto&& doc : fromContents) {
+        ASSERT(arrayContains(expCtx, results, Value(doc.getDocument())));
+    }
+
+    // Without disk use, the same search exceeds the memory limit.
+    expCtx->allowDiskUse = false;
+    auto secondInputMock = DocumentSourceMock::create(Document{{"start", 0}});
+    auto secondStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          DocumentSourceUnwind::create(
+                                              expCtx, "results", false, boost::none));
+    secondStage->setSource(secondInputMock.get());
+    ASSERT_THROWS_CODE(secondStage->getNext(), AssertionException, 40099);
+}
+
 TEST_F(DocumentSourceGraphLookUpTest, GraphLookupShouldReportAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -70,7 +71,9 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         accum->reset();  // Prep accumulators for a new group.
     }
 
-    if (_spilled) {
+    if (_partitioned) {
+        return getNextPartitioned();
+    } else if (_spilled) {
         return getNextSpilled();
     } else if (_streaming) {
         return getNextStreaming();
@@ -103,7 +106,13 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
         }
 
         if (!_sorterIterator->more()) {
-            dispose();
+            if (_partitioned) {
+                // Only the current partition is done, so just release its runs.
+                _sorterIterator.reset();
+                _sortedFiles.clear();
+            } else {
+                dispose();
+            }
             break;
         }
 
@@ -126,6 +135,28 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     return std::move(out);
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextPartitioned() {
+    // Every group of a partition is returned before the next partition is loaded.
+    while (true) {
+        if (_spilled) {
+            if (_sorterIterator) {
+                return getNextSpilled();
+            }
+            _spilled = false;
+        } else if (groupsIterator != _groups->end()) {
+            Document out =
+                makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+            ++groupsIterator;
+            return std::move(out);
+        }
+
+        if (!loadNextPartition()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+    }
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
     // Streaming optimization is active.
     if (!_firstDocOfNextGroup) {
@@ -168,6 +199,7 @@ void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _partitionRuns.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -266,7 +298,8 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
-      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos),
+      _numSpillPartitions(internalDocumentSourceGroupSpillPartitions.load()) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
     _accumulatedFields.push_back(accumulationStatement);
@@ -486,7 +519,11 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
                     _allowDiskUse);
-            _sortedFiles.push_back(spill());
+            if (_numSpillPartitions > 0) {
+                spillToPartitions();
+            } else {
+                _sortedFiles.push_back(spill());
+            }
             _memoryUsageBytes = 0;
         }
 
@@ -548,7 +585,16 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (!_partitionRuns.empty()) {
+                // The groups still in memory may belong to any partition, so they are spilled too
+                // and each partition is then re-aggregated by getNextPartitioned().
+                if (!_groups->empty()) {
+                    spillToPartitions();
+                }
+                _memoryUsageBytes = 0;
+                _partitioned = true;
+                groupsIterator = _groups->end();
+            } else if (!_sortedFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
@@ -622,6 +668,142 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
 }
 
+void DocumentSourceGroup::spillToPartitions() {
+    if (_partitionRuns.empty()) {
+        _partitionRuns.resize(_numSpillPartitions);
+    }
+
+    // Runs are only ever read back in the order they were written, so although they are written
+    // with a SortedFileWriter, they need not be sorted. Writers are created lazily since an empty
+    // run cannot be read back.
+    const SortOptions opts = SortOptions().TempDir(pExpCtx->tempDir);
+    std::vector<std::unique_ptr<SortedFileWriter<Value, Value>>> writers(_numSpillPartitions);
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (auto&& idAndAccumulators : *_groups) {
+        const size_t partition =
+            pExpCtx->getValueComparator().hash(idAndAccumulators.first) % _numSpillPartitions;
+        if (!writers[partition]) {
+            writers[partition] = stdx::make_unique<SortedFileWriter<Value, Value>>(opts);
+        }
+
+        const Accumulators& accumulators = idAndAccumulators.second;
+        switch (numAccumulators) {  // mirrors switch in spill()
+            case 0:
+                writers[partition]->addAlreadySorted(idAndAccumulators.first, Value());
+                break;
+            case 1:
+                writers[partition]->addAlreadySorted(
+                    idAndAccumulators.first, accumulators[0]->getValue(/*toBeMerged=*/true));
+                break;
+            default: {
+                vector<Value> states;
+                states.reserve(numAccumulators);
+                for (auto&& accumulator : accumulators) {
+                    states.push_back(accumulator->getValue(/*toBeMerged=*/true));
+                }
+                writers[partition]->addAlreadySorted(idAndAccumulators.first,
+                                                     Value(std::move(states)));
+                break;
+            }
+        }
+    }
+
+    for (size_t partition = 0; partition < _numSpillPartitions; ++partition) {
+        if (writers[partition]) {
+            _partitionRuns[partition].emplace_back(writers[partition]->done());
+        }
+    }
+
+    _groups->clear();
+}
+
+bool DocumentSourceGroup::loadNextPartition() {
+    const size_t numAccumulators = _accumulatedFields.size();
+    while (_nextPartition < _partitionRuns.size()) {
+        // Taking the runs out of '_partitionRuns' deletes their files once they have been read.
+        auto runs = std::move(_partitionRuns[_nextPartition++]);
+        _groups->clear();
+        _memoryUsageBytes = 0;
+
+        for (auto&& run : runs) {
+            while (run->more()) {
+                if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+                    // This partition does not fit in memory by itself, so fall back to merging
+                    // sorted runs of it.
+                    _sortedFiles.push_back(spill());
+                    _memoryUsageBytes = 0;
+                }
+                auto idAndStates = run->next();
+                mergeSpilledGroup(idAndStates.first, idAndStates.second);
+            }
+        }
+
+        if (!_sortedFiles.empty()) {
+            if (!_groups->empty()) {
+                _sortedFiles.push_back(spill());
+            }
+            _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
+                _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
+
+            if (_currentAccumulators.empty()) {
+                _currentAccumulators.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            }
+
+            verify(_sorterIterator->more());  // we put data in, we should get something out.
+            _firstPartOfNextGroup = _sorterIterator->next();
+            _spilled = true;
+            return true;
+        }
+
+        if (!_groups->empty()) {
+            groupsIterator = _groups->begin();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DocumentSourceGroup::mergeSpilledGroup(const Value& id, const Value& states) {
+    const size_t numAccumulators = _accumulatedFields.size();
+
+    // As in initialize(), look up 'id' only once whether or not it is already in the map.
+    const size_t oldSize = _groups->size();
+    Accumulators& group = (*_groups)[id];
+    if (_groups->size() != oldSize) {
+        _memoryUsageBytes += id.getApproximateSize();
+        group.reserve(numAccumulators);
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& accumulator : group) {
+            _memoryUsageBytes -= accumulator->memUsageForSorter();
+        }
+    }
+
+    switch (numAccumulators) {  // mirrors switch in spill()
+        case 0:
+            break;
+        case 1:
+            group[0]->process(states, true);
+            break;
+        default: {
+            const vector<Value>& accumulatorStates = states.getArray();
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(accumulatorStates[i], true);
+            }
+            break;
+        }
+    }
+
+    for (auto&& accumulator : group) {
+        _memoryUsageBytes += accumulator->memUsageForSorter();
+    }
+}
+
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     if (true) {
         // Until streaming $group correctly handles nullish values, the streaming behavior is
@@ -695,7 +877,8 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
                        // False negatives are OK.
     }
 
-    if (!(_streaming || _spilled)) {
+    if (!(_streaming || _spilled) || _partitioned) {
+        // Partitions are returned one after another, so the output is not sorted as a whole.
         return SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     }
 
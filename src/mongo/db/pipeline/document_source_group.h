@@ -111,13 +111,14 @@ private:
                                  size_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
 
     /**
-     * getNext() dispatches to one of these three depending on what type of $group it is. All three
+     * getNext() dispatches to one of these four depending on what type of $group it is. All four
      * of these methods expect '_currentAccumulators' to have been reset before being called, and
      * also expect initialize() to have been called already.
      */
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
+    GetNextResult getNextPartitioned();
 
     /**
      * Attempt to identify an input sort order that allows us to turn into a streaming $group. If we
@@ -144,6 +145,26 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Used instead of spill() when '_numSpillPartitions' is non-zero. Writes each group in the
+     * groups map to the run of the partition its _id hashes to, then clears the map. Unlike
+     * spill(), this does not sort.
+     */
+    void spillToPartitions();
+
+    /**
+     * Re-aggregates the runs of the next non-empty partition into the groups map. If a partition
+     * does not fit in memory by itself, its groups are spilled again as sorted runs and returned
+     * through getNextSpilled(). Returns false once every partition has been loaded.
+     */
+    bool loadNextPartition();
+
+    /**
+     * Merges 'states', the accumulator states of the group 'id' as serialized by spill() or
+     * spillToPartitions(), into the groups map.
+     */
+    void mergeSpilledGroup(const Value& id, const Value& states);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -187,6 +208,16 @@ private:
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     const bool _allowDiskUse;
 
+    // The number of hash partitions to spill into, or zero to spill sorted runs. See
+    // 'internalDocumentSourceGroupSpillPartitions'.
+    const size_t _numSpillPartitions;
+
+    // The runs written by spillToPartitions(), indexed by partition. '_partitioned' is set once the
+    // input is exhausted and the partitions are being returned, starting with '_nextPartition'.
+    std::vector<std::vector<std::unique_ptr<Sorter<Value, Value>::Iterator>>> _partitionRuns;
+    size_t _nextPartition = 0;
+    bool _partitioned = false;
+
     std::pair<Value, Value> _firstPartOfNextGroup;
     // Only used when '_sorted' is true.
     boost::optional<Document> _firstDocOfNextGroup;
@@ -47,12 +47,14 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -139,6 +141,95 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldReaggregateHashPartitionsAfterSpilling) {
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const int originalNumPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(4);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupSpillPartitions.store(originalNumPartitions); });
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement maxStatement{"max",
+                                       ExpressionFieldPath::parse(expCtx, "$value", vps),
+                                       AccumulationStatement::getFactory("$max")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$key", vps),
+                                             {countStatement, maxStatement},
+                                             2000);
+
+    // Each key appears ten times, spread out so that every key is spilled more than once.
+    const int kNumKeys = 100;
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 10 * kNumKeys; ++i) {
+        inputs.emplace_back(Document{{"key", i % kNumKeys}, {"value", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    map<int, Document> results;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_TRUE(results.emplace(doc["_id"].coerceToInt(), doc).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    // The output of a partitioned $group is not sorted by _id.
+    ASSERT_TRUE(group->getOutputSorts().empty());
+
+    ASSERT_EQ(results.size(), static_cast<size_t>(kNumKeys));
+    for (auto&& keyAndDoc : results) {
+        ASSERT_DOCUMENT_EQ(keyAndDoc.second,
+                           (Document{{"_id", keyAndDoc.first},
+                                     {"count", 10},
+                                     {"max", keyAndDoc.first + 9 * kNumKeys}}));
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldSortSpillAHashPartitionWhichDoesNotFitInMemory) {
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    // With a single partition, re-aggregating it needs as much memory as the whole input.
+    const int originalNumPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    internalDocumentSourceGroupSpillPartitions.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupSpillPartitions.store(originalNumPartitions); });
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement pushStatement{"spaceHog",
+                                        ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$key", vps),
+                                             {pushStatement},
+                                             maxMemoryUsageBytes);
+
+    string largeStr(maxMemoryUsageBytes, 'x');
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 6; ++i) {
+        inputs.emplace_back(Document{{"key", i % 3}, {"largeStr", largeStr}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["spaceHog"].getArrayLength(), 2UL);
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(idSet.size(), 3UL);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
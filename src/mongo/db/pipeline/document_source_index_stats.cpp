@@ -62,6 +62,9 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
         doc["host"] = Value(_processName);
         doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
+        if (!stats.storageStats.isEmpty()) {
+            doc["storage"] = Value(stats.storageStats);
+        }
         ++_indexStatsIter;
         return doc.freeze();
     }
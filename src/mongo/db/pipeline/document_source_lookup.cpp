@@ -33,6 +33,7 @@
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
@@ -95,6 +96,7 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
     : DocumentSourceLookUp(fromNs, as, pExpCtx) {
     _localField = std::move(localField);
     _foreignField = std::move(foreignField);
+    _batchSize = internalDocumentSourceLookupBatchSize.load();
     // We append an additional BSONObj to '_resolvedPipeline' as a placeholder for the $match stage
     // we'll eventually construct from the input document.
     _resolvedPipeline.reserve(_resolvedPipeline.size() + 1);
@@ -210,13 +212,19 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
+    if (_batchSize > 0 && !wasConstructedWithPipelineSyntax()) {
+        return batchedResult();
+    }
+
     auto nextInput = pSource->getNext();
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
 
-    auto inputDoc = nextInput.releaseDocument();
+    return lookUpSingleInput(nextInput.releaseDocument());
+}
 
+Document DocumentSourceLookUp::lookUpSingleInput(Document inputDoc) {
     // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
@@ -249,6 +257,177 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+DocumentSource::GetNextResult DocumentSourceLookUp::batchedResult() {
+    if (_batchedResults.empty() && _batchedInputEnd) {
+        auto inputEnd = std::move(*_batchedInputEnd);
+        _batchedInputEnd = boost::none;
+        return inputEnd;
+    }
+
+    if (_batchedResults.empty()) {
+        std::vector<Document> inputs;
+        while (inputs.size() < _batchSize) {
+            auto nextInput = pSource->getNext();
+            if (!nextInput.isAdvanced()) {
+                if (inputs.empty()) {
+                    return nextInput;
+                }
+                _batchedInputEnd = std::move(nextInput);
+                break;
+            }
+            inputs.push_back(nextInput.releaseDocument());
+        }
+
+        if (!_hashJoinAttempted) {
+            _hashJoinAttempted = true;
+            buildHashJoinTable();
+        }
+
+        if (_hashJoinTable) {
+            for (auto&& input : inputs) {
+                _batchedResults.push_back(joinFromTable(*_hashJoinTable, std::move(input)));
+            }
+        } else {
+            // Query for the union of the values of the 'localField's of the whole batch. Putting
+            // them all in a single array lets makeMatchStageFromInput() build the query, which
+            // then matches exactly the union of the documents matched for each input.
+            std::vector<Value> localValues;
+            for (auto&& input : inputs) {
+                const auto numValues = localValues.size();
+                document_path_support::visitAllValuesAtPath(
+                    input, *_localField, [&](const Value& value) { localValues.push_back(value); });
+                if (localValues.size() == numValues) {
+                    // Missing values are treated as null.
+                    localValues.push_back(Value(BSONNULL));
+                }
+            }
+
+            const FieldPath batchField("localValues");
+            auto matchStage =
+                makeMatchStageFromInput(Document{{batchField.fullPath(), std::move(localValues)}},
+                                        batchField,
+                                        _foreignField->fullPath(),
+                                        BSONObj());
+
+            auto table = loadJoinTable(std::move(matchStage),
+                                       internalDocumentSourceLookupCacheSizeBytes.load());
+            for (auto&& input : inputs) {
+                // If the results for the whole batch are too large, look each input up on its own.
+                _batchedResults.push_back(table ? joinFromTable(*table, std::move(input))
+                                                : lookUpSingleInput(std::move(input)));
+            }
+        }
+    }
+
+    auto next = std::move(_batchedResults.front());
+    _batchedResults.pop_front();
+    return std::move(next);
+}
+
+boost::optional<DocumentSourceLookUp::JoinTable> DocumentSourceLookUp::loadJoinTable(
+    BSONObj matchStage, size_t maxBytes) {
+    // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+    _resolvedPipeline.back() = std::move(matchStage);
+
+    auto pipeline = buildPipeline(Document());
+
+    JoinTable table(_fromExpCtx->getValueComparator());
+    while (auto result = pipeline->getNext()) {
+        table.bytes += result->getApproximateSize();
+        if (table.bytes > maxBytes) {
+            return boost::none;
+        }
+
+        const auto docIndex = table.docs.size();
+        document_path_support::visitAllValuesAtPath(
+            *result, *_foreignField, [&](const Value& value) {
+                auto& docs = table.index[value];
+                if (docs.empty() || docs.back() != docIndex) {
+                    docs.push_back(docIndex);
+                }
+            });
+        table.docs.push_back(result->toBson());
+    }
+
+    return std::move(table);
+}
+
+void DocumentSourceLookUp::buildHashJoinTable() {
+    const size_t maxBytes = internalDocumentSourceLookupCacheSizeBytes.load();
+
+    // Avoid reading the foreign collection only to find out that it does not fit.
+    BSONObjBuilder storageStats;
+    if (!pExpCtx->mongoProcessInterface
+             ->appendStorageStats(pExpCtx->opCtx, _resolvedNs, BSONObj(), &storageStats)
+             .isOK()) {
+        return;
+    }
+    auto size = storageStats.obj()["size"];
+    if (!size.isNumber() || size.safeNumberLong() > static_cast<long long>(maxBytes)) {
+        return;
+    }
+
+    _hashJoinTable = loadJoinTable(BSON("$match" << BSONObj()), maxBytes);
+}
+
+Document DocumentSourceLookUp::joinFromTable(const JoinTable& table, Document input) {
+    // The index can only narrow down the candidates. Whether a candidate matches is decided by the
+    // same query that a $lookup of this input alone would have run.
+    auto matchStage =
+        makeMatchStageFromInput(input, *_localField, _foreignField->fullPath(), BSONObj());
+    auto filter =
+        uassertStatusOK(MatchExpressionParser::parse(matchStage.firstElement().Obj(), _fromExpCtx));
+
+    // A null, which also matches a missing field, or an array, which also matches an array which
+    // contains it, cannot be looked up by value. Missing values are treated as null.
+    bool sawValue = false;
+    bool scanAll = false;
+    std::vector<size_t> candidates;
+    document_path_support::visitAllValuesAtPath(input, *_localField, [&](const Value& value) {
+        sawValue = true;
+        if (value.nullish() || value.isArray()) {
+            scanAll = true;
+        } else {
+            auto it = table.index.find(value);
+            if (it != table.index.end()) {
+                candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+        }
+    });
+
+    if (scanAll || !sawValue) {
+        candidates.clear();
+        for (size_t idx = 0; idx < table.docs.size(); ++idx) {
+            candidates.push_back(idx);
+        }
+    } else {
+        // Return the matches in the order of the foreign pipeline, each only once.
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+    std::vector<Value> results;
+    int objsize = 0;
+    for (auto idx : candidates) {
+        if (!filter->matchesBSON(table.docs[idx])) {
+            continue;
+        }
+
+        objsize += table.docs[idx].objsize();
+        uassert(4568,
+                str::stream() << "Total size of documents in " << _fromNs.coll()
+                              << " matching pipeline "
+                              << matchStage
+                              << " exceeds maximum document size",
+                objsize <= BSONObjMaxInternalSize);
+        results.emplace_back(Document(table.docs[idx]));
+    }
+
+    MutableDocument output(std::move(input));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -433,6 +612,8 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashJoinTable = boost::none;
+    _batchedResults.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
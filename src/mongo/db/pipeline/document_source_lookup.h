@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -114,6 +115,11 @@ public:
                                      TransactionRequirement::kAllowed);
 
         constraints.canSwapWithMatch = true;
+
+        // Without an absorbed $unwind, we output exactly one document for each input, and each
+        // of them requires a query on the foreign collection.
+        constraints.canSwapWithLimit = !_unwindSrc;
+        constraints.canSwapWithSortSkipAndLimit = !_unwindSrc;
         return constraints;
     }
 
@@ -242,8 +248,51 @@ private:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * A set of foreign documents, indexed by the values at their 'foreignField', against which
+     * input documents are joined in memory.
+     */
+    struct JoinTable {
+        explicit JoinTable(const ValueComparator& comparator)
+            : index(comparator.makeUnorderedValueMap<std::vector<size_t>>()) {}
+
+        std::vector<BSONObj> docs;
+        ValueUnorderedMap<std::vector<size_t>> index;
+        size_t bytes = 0;
+    };
+
     GetNextResult unwindResult();
 
+    /**
+     * Used instead of unwindResult() for localField/foreignField syntax when '_batchSize' is
+     * non-zero. Joins up to '_batchSize' input documents at a time, either against the whole
+     * foreign collection if it was small enough to be loaded into '_hashJoinTable', or against the
+     * results of a single query for the values of all of their 'localField's.
+     */
+    GetNextResult batchedResult();
+
+    /**
+     * Runs the foreign pipeline with 'matchStage' as its final stage and loads its results into a
+     * JoinTable. Returns boost::none if the results exceed 'maxBytes'.
+     */
+    boost::optional<JoinTable> loadJoinTable(BSONObj matchStage, size_t maxBytes);
+
+    /**
+     * Loads the whole foreign collection into '_hashJoinTable' if it fits within the $lookup cache
+     * size.
+     */
+    void buildHashJoinTable();
+
+    /**
+     * Returns 'input' with the documents of 'table' which match its 'localField' added at '_as'.
+     */
+    Document joinFromTable(const JoinTable& table, Document input);
+
+    /**
+     * Returns 'input' with the results of the foreign pipeline for it added at '_as'.
+     */
+    Document lookUpSingleInput(Document input);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -332,6 +381,15 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // The following members are used by batchedResult(). A '_batchSize' of zero disables it.
+    size_t _batchSize = 0;
+    bool _hashJoinAttempted = false;
+    boost::optional<JoinTable> _hashJoinTable;
+    std::deque<Document> _batchedResults;
+    // The pause or EOF which ended the current batch of input documents, if any, to be returned
+    // once '_batchedResults' is exhausted.
+    boost::optional<GetNextResult> _batchedInputEnd;
 };
 
 }  // namespace mongo
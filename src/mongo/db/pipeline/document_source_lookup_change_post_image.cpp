@@ -30,7 +30,12 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include <map>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -58,6 +63,26 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     pExpCtx->checkForInterrupt();
 
+    const size_t batchSize = internalChangeStreamPostImageLookupBatchSize.load();
+    if (batchSize > 1 && _window.empty() && !_resultAfterWindow && !_closeAfterWindow) {
+        fillWindow(batchSize);
+    }
+    if (!_window.empty()) {
+        auto next = std::move(_window.front());
+        _window.pop_front();
+        return std::move(next);
+    }
+    if (_closeAfterWindow) {
+        auto status = std::move(*_closeAfterWindow);
+        _closeAfterWindow = boost::none;
+        uassertStatusOK(status);
+    }
+    if (_resultAfterWindow) {
+        auto result = std::move(*_resultAfterWindow);
+        _resultAfterWindow = boost::none;
+        return result;
+    }
+
     auto input = pSource->getNext();
     if (!input.isAdvanced()) {
         return input;
@@ -73,6 +98,90 @@ DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     return output.freeze();
 }
 
+void DocumentSourceLookupChangePostImage::fillWindow(size_t batchSize) {
+    // The events already read should be returned as soon as possible, rather than held back until
+    // there are more changes, so the source must not wait for inserts once one has been read.
+    auto& awaitData = awaitDataState(pExpCtx->opCtx);
+    const bool shouldWaitForInserts = awaitData.shouldWaitForInserts;
+    ON_BLOCK_EXIT([&] { awaitData.shouldWaitForInserts = shouldWaitForInserts; });
+
+    try {
+        while (_window.size() < batchSize) {
+            auto input = pSource->getNext();
+            if (!input.isAdvanced()) {
+                _resultAfterWindow = std::move(input);
+                break;
+            }
+            _window.push_back(input.releaseDocument());
+            awaitData.shouldWaitForInserts = false;
+        }
+    } catch (const ExceptionFor<ErrorCodes::CloseChangeStream>& ex) {
+        // Return the events before the invalidation first.
+        _closeAfterWindow = ex.toStatus();
+    }
+
+    lookupPostImagesInWindow();
+}
+
+void DocumentSourceLookupChangePostImage::lookupPostImagesInWindow() {
+    struct Lookups {
+        std::vector<size_t> positions;
+        std::vector<Document> documentKeys;
+        Timestamp latestClusterTime;
+    };
+    std::map<std::pair<NamespaceString, UUID>, Lookups> lookupsByCollection;
+
+    for (size_t i = 0; i < _window.size(); ++i) {
+        const Document& event = _window[i];
+        auto opTypeVal = assertFieldHasType(
+            event, DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+        if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
+            continue;
+        }
+
+        auto nss = assertValidNamespace(event);
+        auto documentKey = assertFieldHasType(event,
+                                              DocumentSourceChangeStream::kDocumentKeyField,
+                                              BSONType::Object)
+                               .getDocument();
+        auto resumeToken =
+            ResumeToken::parse(event[DocumentSourceChangeStream::kIdField].getDocument());
+        invariant(resumeToken.getData().uuid);
+
+        auto& lookups = lookupsByCollection[{nss, *resumeToken.getData().uuid}];
+        lookups.positions.push_back(i);
+        lookups.documentKeys.push_back(std::move(documentKey));
+        lookups.latestClusterTime =
+            std::max(lookups.latestClusterTime, resumeToken.getData().clusterTime);
+    }
+
+    for (auto&& collectionLookups : lookupsByCollection) {
+        const auto& lookups = collectionLookups.second;
+
+        // Reading after the latest of the updates' cluster times reads after each of them.
+        const auto readConcern = pExpCtx->inMongos
+            ? boost::optional<BSONObj>(BSON("level"
+                                            << "majority"
+                                            << "afterClusterTime"
+                                            << lookups.latestClusterTime))
+            : boost::none;
+        auto lookedUpDocs =
+            pExpCtx->mongoProcessInterface->lookupDocuments(pExpCtx,
+                                                            collectionLookups.first.first,
+                                                            collectionLookups.first.second,
+                                                            lookups.documentKeys,
+                                                            readConcern);
+        invariant(lookedUpDocs.size() == lookups.positions.size());
+
+        for (size_t i = 0; i < lookups.positions.size(); ++i) {
+            MutableDocument output(std::move(_window[lookups.positions[i]]));
+            output[kFullDocumentFieldName] =
+                lookedUpDocs[i] ? Value(*lookedUpDocs[i]) : Value(BSONNULL);
+            _window[lookups.positions[i]] = output.freeze();
+        }
+    }
+}
+
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
     const Document& inputDoc) const {
     auto namespaceObject =
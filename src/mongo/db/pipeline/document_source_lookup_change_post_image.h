@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -35,7 +37,9 @@ namespace mongo {
 
 /**
  * Part of the change stream API machinery used to look up the post-image of a document. Uses the
- * "documentKey" field of the input to look up the new version of the document.
+ * "documentKey" field of the input to look up the new version of the document. When
+ * internalChangeStreamPostImageLookupBatchSize is set, reads a window of events ahead and looks up
+ * the post-images of all the updates in it with one query per collection and shard.
  */
 class DocumentSourceLookupChangePostImage final : public DocumentSource {
 public:
@@ -112,12 +116,33 @@ private:
      */
     Value lookupPostImage(const Document& updateOp) const;
 
+    /**
+     * Reads up to 'batchSize' events into '_window', without waiting for more changes once it has
+     * read one, and fills in the post-images of the updates among them.
+     */
+    void fillWindow(size_t batchSize);
+
+    /**
+     * Looks up the post-images of the updates in '_window', grouping them by collection.
+     */
+    void lookupPostImagesInWindow();
+
     /**
      * Throws a AssertionException if the namespace found in 'inputDoc' doesn't match the one on the
      * ExpressionContext. If the namespace on the ExpressionContext is 'collectionless', then this
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Events which have been read from the source but not yet returned, in order.
+    std::deque<Document> _window;
+
+    // The result which ended the last read into '_window', to be returned once it is empty.
+    boost::optional<GetNextResult> _resultAfterWindow;
+
+    // Set if the change stream was closed while reading into '_window'. It is closed again once
+    // '_window' is empty.
+    boost::optional<Status> _closeAfterWindow;
 };
 
 }  // namespace mongo
@@ -42,8 +42,11 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/mongo_process_common.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -143,6 +146,32 @@ public:
         return lookedUpDocument;
     }
 
+    std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern) {
+        ++numBatchedLookups;
+
+        BSONArrayBuilder keys;
+        for (auto&& documentKey : documentKeys) {
+            keys.append(documentKey.toBson());
+        }
+        auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID, boost::none);
+        auto pipeline = uassertStatusOK(
+            makePipeline({BSON("$match" << BSON("$or" << keys.arr()))}, foreignExpCtx));
+
+        std::vector<Document> lookedUpDocuments;
+        while (auto next = pipeline->getNext()) {
+            lookedUpDocuments.push_back(std::move(*next));
+        }
+        return MongoProcessCommon::matchDocumentKeys(
+            foreignExpCtx, documentKeys, lookedUpDocuments);
+    }
+
+    int numBatchedLookups = 0;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
 };
@@ -393,5 +422,96 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldLookUpPostImagesOfAWindowOfUpdatesTogether) {
+    const int originalBatchSize = internalChangeStreamPostImageLookupBatchSize.load();
+    internalChangeStreamPostImageLookupBatchSize.store(10);
+    ON_BLOCK_EXIT([&] { internalChangeStreamPostImageLookupBatchSize.store(originalBatchSize); });
+
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeUpdate = [&](int id) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", ns}};
+    };
+
+    // The same document may be updated more than once in a window, and an updated document may
+    // since have been deleted.
+    const Document insert{{"_id", makeResumeToken(1)},
+                          {"documentKey", Document{{"_id", 1}}},
+                          {"operationType", "insert"_sd},
+                          {"ns", ns},
+                          {"fullDocument", Document{{"_id", 1}}}};
+    auto mockLocalSource = DocumentSourceMock::create(deque<DocumentSource::GetNextResult>{
+        makeUpdate(0), Document(insert), makeUpdate(2), makeUpdate(3), makeUpdate(0)});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"x", 0}},
+                                                             Document{{"_id", 1}, {"x", 1}},
+                                                             Document{{"_id", 2}, {"x", 2}}};
+    auto mongoInterface = stdx::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+    auto mockMongoInterface = mongoInterface.get();
+    getExpCtx()->mongoProcessInterface = std::move(mongoInterface);
+
+    const std::vector<std::pair<int, Value>> expected{{0, Value(Document{{"_id", 0}, {"x", 0}})},
+                                                      {1, Value(Document{{"_id", 1}})},
+                                                      {2, Value(Document{{"_id", 2}, {"x", 2}})},
+                                                      {3, Value(BSONNULL)},
+                                                      {0, Value(Document{{"_id", 0}, {"x", 0}})}};
+    for (auto&& event : expected) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_VALUE_EQ(doc["documentKey"]["_id"], Value(event.first));
+        ASSERT_VALUE_EQ(doc["fullDocument"], event.second);
+    }
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+
+    // All the updates were read into a single window, and looked up with a single query.
+    ASSERT_EQ(mockMongoInterface->numBatchedLookups, 1);
+}
+
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldReturnWindowBeforePauseWhenBatching) {
+    const int originalBatchSize = internalChangeStreamPostImageLookupBatchSize.load();
+    internalChangeStreamPostImageLookupBatchSize.store(10);
+    ON_BLOCK_EXIT([&] { internalChangeStreamPostImageLookupBatchSize.store(originalBatchSize); });
+
+    auto expCtx = getExpCtx();
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+    const Document ns{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeUpdate = [&](int id) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", ns}};
+    };
+
+    auto mockLocalSource = DocumentSourceMock::create(
+        {makeUpdate(0), makeUpdate(1), DocumentSource::GetNextResult::makePauseExecution(),
+         makeUpdate(2)});
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"_id", 0}}, Document{{"_id", 1}}, Document{{"_id", 2}}};
+    auto mongoInterface = stdx::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+    auto mockMongoInterface = mongoInterface.get();
+    getExpCtx()->mongoProcessInterface = std::move(mongoInterface);
+
+    for (int id : {0, 1}) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.releaseDocument()["fullDocument"], Value(Document{{"_id", id}}));
+    }
+    ASSERT_TRUE(lookupChangeStage->getNext().isPaused());
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["fullDocument"], Value(Document{{"_id", 2}}));
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+    ASSERT_EQ(mockMongoInterface->numBatchedLookups, 2);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -515,9 +516,21 @@ public:
             uassertStatusOK(attachCursorSourceToPipeline(expCtx, pipeline.getValue().get()));
         }
 
+        ++numPipelinesMade;
         return pipeline;
     }
 
+    Status appendStorageStats(OperationContext* opCtx,
+                              const NamespaceString& nss,
+                              const BSONObj& param,
+                              BSONObjBuilder* builder) const final {
+        if (!storageSize) {
+            return {ErrorCodes::NamespaceNotFound, "no storage size was mocked"};
+        }
+        builder->append("size", *storageSize);
+        return Status::OK();
+    }
+
     Status attachCursorSourceToPipeline(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                         Pipeline* pipeline) final {
         while (_removeLeadingQueryStages && !pipeline->getSources().empty()) {
@@ -532,11 +545,102 @@ public:
         return Status::OK();
     }
 
+    // The size reported for the foreign collection by appendStorageStats(), if any.
+    boost::optional<long long> storageSize;
+
+    size_t numPipelinesMade = 0;
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
 };
 
+/**
+ * Runs a $lookup from 'foreignId' to 'key' with a batch size of two over a few inputs, a pause
+ * among them, and returns the outputs along with the mock of the foreign collection.
+ */
+std::pair<std::vector<DocumentSource::GetNextResult>, std::shared_ptr<MockMongoInterface>>
+runBatchedLookup(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                 boost::optional<long long> foreignStorageSize) {
+    internalDocumentSourceLookupBatchSize.store(2);
+    ON_BLOCK_EXIT([] { internalDocumentSourceLookupBatchSize.store(0); });
+
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto lookup = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 0}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"foreignId", 1}},
+                                    Document{{"foreignId", vector<Value>{Value(1), Value(2)}}},
+                                    Document{{"_id", "missing"_sd}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}, {"key", 0}},
+                                                             Document{{"_id", 1}, {"key", 1}},
+                                                             Document{{"_id", 2}, {"key", 2}},
+                                                             Document{{"_id", 3}}};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    mongoInterface->storageSize = foreignStorageSize;
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    std::vector<DocumentSource::GetNextResult> results;
+    for (auto next = lookup->getNext(); !next.isEOF(); next = lookup->getNext()) {
+        results.push_back(std::move(next));
+    }
+    lookup->dispose();
+
+    return {std::move(results), std::move(mongoInterface)};
+}
+
+void assertBatchedLookupResults(const std::vector<DocumentSource::GetNextResult>& results) {
+    auto foreignDoc = [](int id) { return Value(Document{{"_id", id}, {"key", id}}); };
+
+    ASSERT_EQ(results.size(), 5U);
+    ASSERT_DOCUMENT_EQ(results[0].getDocument(),
+                       (Document{{"foreignId", 0}, {"foreignDocs", vector<Value>{foreignDoc(0)}}}));
+    ASSERT_TRUE(results[1].isPaused());
+    ASSERT_DOCUMENT_EQ(results[2].getDocument(),
+                       (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{foreignDoc(1)}}}));
+    ASSERT_DOCUMENT_EQ(results[3].getDocument(),
+                       (Document{{"foreignId", vector<Value>{Value(1), Value(2)}},
+                                 {"foreignDocs", vector<Value>{foreignDoc(1), foreignDoc(2)}}}));
+    // A missing local field matches the foreign documents which are missing the foreign field.
+    ASSERT_DOCUMENT_EQ(results[4].getDocument(),
+                       (Document{{"_id", "missing"_sd},
+                                 {"foreignDocs", vector<Value>{Value(Document{{"_id", 3}})}}}));
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinBatchesOfInputsWithASingleQueryEach) {
+    auto results = runBatchedLookup(getExpCtx(), boost::none);
+    assertBatchedLookupResults(results.first);
+
+    // The pause ends the first batch early, so the five inputs make three batches.
+    ASSERT_EQ(results.second->numPipelinesMade, 3U);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldHashJoinWhenTheForeignCollectionFitsInTheCache) {
+    auto results = runBatchedLookup(getExpCtx(), 1024);
+    assertBatchedLookupResults(results.first);
+
+    // The foreign collection is only read once.
+    ASSERT_EQ(results.second->numPipelinesMade, 1U);
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotHashJoinWhenTheForeignCollectionIsTooLarge) {
+    auto results = runBatchedLookup(getExpCtx(), kDefaultMaxCacheSize + 1);
+    assertBatchedLookupResults(results.first);
+    ASSERT_EQ(results.second->numPipelinesMade, 3U);
+}
+
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -31,6 +31,7 @@
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/document_source_out_gen.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/destructor_guard.h"
 
@@ -137,6 +138,16 @@ void DocumentSourceOut::initialize() {
                 ok);
     }
 
+    _buildIndexesAfterLoad = internalDocumentSourceOutBuildIndexesAfterLoad.load();
+    if (!_buildIndexesAfterLoad) {
+        copyIndexes();
+    }
+    _initialized = true;
+}
+
+void DocumentSourceOut::copyIndexes() {
+    DBClientBase* conn = pExpCtx->mongoProcessInterface->directClient();
+
     // copy indexes to _tempNs
     for (std::list<BSONObj>::const_iterator it = _originalIndexes.begin();
          it != _originalIndexes.end();
@@ -156,7 +167,6 @@ void DocumentSourceOut::initialize() {
                               << err,
                 DBClientBase::getLastErrorString(err).empty());
     }
-    _initialized = true;
 }
 
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
@@ -205,6 +215,10 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            // Building each index over all of the documents at once sorts its keys in bulk.
+            if (_buildIndexesAfterLoad) {
+                copyIndexes();
+            }
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
@@ -96,6 +96,11 @@ private:
      */
     void initialize();
 
+    /**
+     * Creates the indexes of the target collection on the temporary collection.
+     */
+    void copyIndexes();
+
     /**
      * Inserts all of 'toInsert' into the temporary collection.
      */
@@ -104,6 +109,10 @@ private:
     bool _initialized = false;
     bool _done = false;
 
+    // Whether the indexes are created on the temporary collection after all the documents have
+    // been inserted into it. See internalDocumentSourceOutBuildIndexesAfterLoad.
+    bool _buildIndexesAfterLoad = false;
+
     // Holds on to the original collection options and index specs so we can check they didn't
     // change during computation.
     BSONObj _originalOutOptions;
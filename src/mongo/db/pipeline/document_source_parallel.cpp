@@ -0,0 +1,225 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+constexpr StringData DocumentSourceParallel::kStageName;
+constexpr size_t DocumentSourceParallel::kMaxBufferedResults;
+constexpr int DocumentSourceParallel::kConsumerBufferSizeBytes;
+
+boost::intrusive_ptr<DocumentSourceParallel> DocumentSourceParallel::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const Pipeline::SourceContainer& subPipeline,
+    size_t numConsumers) {
+    invariant(numConsumers > 0);
+
+    std::vector<Value> serialized;
+    for (auto&& stage : subPipeline) {
+        stage->serializeToArray(serialized);
+    }
+
+    std::vector<BSONObj> rawPipeline;
+    for (auto&& stage : serialized) {
+        invariant(stage.getType() == BSONType::Object);
+        rawPipeline.push_back(stage.getDocument().toBson());
+    }
+
+    return new DocumentSourceParallel(expCtx, std::move(rawPipeline), numConsumers);
+}
+
+DocumentSourceParallel::DocumentSourceParallel(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    std::vector<BSONObj> subPipeline,
+    size_t numConsumers)
+    : DocumentSource(expCtx), _subPipeline(std::move(subPipeline)), _numConsumers(numConsumers) {}
+
+DocumentSourceParallel::~DocumentSourceParallel() {
+    stopConsumers();
+}
+
+Value DocumentSourceParallel::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
+    std::vector<Value> subPipeline;
+    for (auto&& stage : _subPipeline) {
+        subPipeline.emplace_back(stage);
+    }
+
+    return Value(DOC(getSourceName() << DOC("consumers" << static_cast<long long>(_numConsumers)
+                                                        << "pipeline"
+                                                        << Value(std::move(subPipeline)))));
+}
+
+DocumentSource::GetNextResult DocumentSourceParallel::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_exchange) {
+        startConsumers();
+
+        // This thread feeds the consumers until the source is exhausted. None of the consumers can
+        // produce anything before then, since their sub-pipelines end with a blocking stage.
+        try {
+            _exchange->produce(pExpCtx->opCtx);
+        } catch (const DBException& ex) {
+            _exchange->abort(ex.toStatus());
+            throw;
+        }
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    pExpCtx->opCtx->waitForConditionOrInterrupt(_cv, lk, [&] {
+        return !_results.empty() || _runningConsumers == 0 || !_status.isOK();
+    });
+    uassertStatusOK(_status);
+
+    if (_results.empty()) {
+        return GetNextResult::makeEOF();
+    }
+
+    const bool wasFull = _results.size() >= kMaxBufferedResults;
+    auto next = std::move(_results.front());
+    _results.pop_front();
+    if (wasFull) {
+        _cv.notify_all();
+    }
+
+    return std::move(next);
+}
+
+void DocumentSourceParallel::startConsumers() {
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kRoundRobin);
+    spec.setConsumers(static_cast<int>(_numConsumers));
+    spec.setBufferSize(kConsumerBufferSizeBytes);
+
+    _exchange = new Exchange(spec, true);
+    _exchange->setSource(pSource);
+
+    // Parse every copy of the sub-pipeline before starting any thread, so that a failure to do so
+    // is simply reported to the caller.
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines;
+    for (size_t idx = 0; idx < _numConsumers; ++idx) {
+        auto expCtx = pExpCtx->copyWith(pExpCtx->ns, pExpCtx->uuid);
+        expCtx->needsMerge = true;
+
+        auto pipeline = uassertStatusOK(Pipeline::parse(_subPipeline, expCtx));
+        pipeline->addInitialSource(new DocumentSourceExchange(expCtx, _exchange, idx));
+        pipelines.push_back(std::move(pipeline));
+    }
+
+    // Each consumer thread disposes of its copy with its own OperationContext.
+    for (auto&& pipeline : pipelines) {
+        pipeline.get_deleter().dismissDisposal();
+    }
+    _consumerPipelines = std::move(pipelines);
+
+    _runningConsumers = _numConsumers;
+    for (size_t idx = 0; idx < _numConsumers; ++idx) {
+        _threads.emplace_back([this, idx] { runConsumer(idx); });
+    }
+
+    LOG(3) << "Started " << _numConsumers << " consumers of a parallel aggregation on "
+           << pExpCtx->ns;
+}
+
+void DocumentSourceParallel::runConsumer(size_t consumerId) {
+    Client::initThread(str::stream() << "aggregateConsumer" << consumerId);
+    auto opCtx = cc().makeOperationContext();
+
+    auto& pipeline = _consumerPipelines[consumerId];
+    pipeline->getContext()->opCtx = opCtx.get();
+
+    Status status = Status::OK();
+    try {
+        while (auto next = pipeline->getNext()) {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _cv.wait(lk, [&] { return _results.size() < kMaxBufferedResults || !_status.isOK(); });
+            if (!_status.isOK()) {
+                break;
+            }
+
+            _results.push_back(std::move(*next));
+            if (_results.size() == 1) {
+                _cv.notify_all();
+            }
+        }
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    pipeline->dispose(opCtx.get());
+
+    if (!status.isOK()) {
+        // Make the producer and the other consumers give up rather than wait for this consumer.
+        _exchange->abort(status);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!status.isOK() && _status.isOK()) {
+        _status = status;
+    }
+    --_runningConsumers;
+    _cv.notify_all();
+}
+
+void DocumentSourceParallel::stopConsumers() {
+    const Status stopped(ErrorCodes::QueryPlanKilled, "parallel aggregation was disposed");
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_status.isOK()) {
+            _status = stopped;
+        }
+        _cv.notify_all();
+    }
+
+    if (_exchange) {
+        _exchange->abort(stopped);
+    }
+
+    for (auto&& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void DocumentSourceParallel::doDispose() {
+    stopConsumers();
+}
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+/**
+ * An internal stage which runs a sub-pipeline on several threads of this node at once. The input
+ * of the stage is distributed among the threads through a producer driven Exchange, each thread
+ * runs its own copy of the sub-pipeline over its share of the input, and the outputs of all the
+ * threads are returned in no particular order.
+ *
+ * The source of this stage is only ever read by the thread which calls getNext(), so a $cursor
+ * source keeps running under the operation of the command. The sub-pipelines run on their own
+ * Clients and OperationContexts, and so must not contain stages which may access the catalog or
+ * any other node.
+ *
+ * This stage is never parsed; it is created by the mongod planner, see
+ * PipelineD::parallelizePipeline().
+ */
+class DocumentSourceParallel final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallel"_sd;
+
+    /**
+     * Creates a stage which runs 'subPipeline' on 'numConsumers' threads. The stages from
+     * 'subPipeline' are re-parsed for each thread when execution begins. The copies run with
+     * 'needsMerge' set, so their output must be merged by the stages which follow this one.
+     */
+    static boost::intrusive_ptr<DocumentSourceParallel> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const Pipeline::SourceContainer& subPipeline,
+        size_t numConsumers);
+
+    ~DocumentSourceParallel();
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kBlocking,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kWritesTmpData,
+                FacetRequirement::kNotAllowed,
+                TransactionRequirement::kNotAllowed};
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+protected:
+    void doDispose() final;
+
+private:
+    // The maximum number of documents output by the sub-pipelines which are buffered before the
+    // threads running them wait for getNext() to catch up.
+    static constexpr size_t kMaxBufferedResults = 1024;
+
+    // The size of the exchange buffer of each consumer.
+    static constexpr int kConsumerBufferSizeBytes = 1024 * 1024;
+
+    DocumentSourceParallel(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                           std::vector<BSONObj> subPipeline,
+                           size_t numConsumers);
+
+    /**
+     * Parses a copy of the sub-pipeline for every consumer and starts the consumer threads.
+     */
+    void startConsumers();
+
+    /**
+     * The body of the thread of consumer 'consumerId'.
+     */
+    void runConsumer(size_t consumerId);
+
+    /**
+     * Makes any running consumer stop at its next opportunity, and waits until they all have.
+     */
+    void stopConsumers();
+
+    const std::vector<BSONObj> _subPipeline;
+    const size_t _numConsumers;
+
+    // Only set once execution has begun.
+    boost::intrusive_ptr<Exchange> _exchange;
+
+    // The copies of the sub-pipeline, one per consumer. Each is only accessed by its consumer's
+    // thread while that thread runs.
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> _consumerPipelines;
+    std::vector<stdx::thread> _threads;
+
+    // Protects the fields below, which are shared with the consumer threads.
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::deque<Document> _results;
+    size_t _runningConsumers{0};
+
+    // Set to the first error of any consumer, or when the stage is disposed.
+    Status _status = Status::OK();
+};
+
+}  // namespace mongo
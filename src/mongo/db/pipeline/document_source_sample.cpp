@@ -30,12 +30,17 @@
 
 #include "mongo/db/pipeline/document_source_sample.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "mongo/db/client.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 using boost::intrusive_ptr;
@@ -55,6 +60,13 @@ DocumentSource::GetNextResult DocumentSourceSample::getNext() {
 
     pExpCtx->checkForInterrupt();
 
+    if (_useReservoir && !_sortStage->isPopulated()) {
+        auto reservoirResult = populateReservoir();
+        if (reservoirResult.isPaused()) {
+            return reservoirResult;
+        }
+    }
+
     if (!_sortStage->isPopulated()) {
         // Exhaust source stage, add random metadata, and push all into sorter.
         PseudoRandom& prng = pExpCtx->opCtx->getClient()->getPrng();
@@ -81,6 +93,75 @@ DocumentSource::GetNextResult DocumentSourceSample::getNext() {
     return _sortStage->getNext();
 }
 
+DocumentSource::GetNextResult DocumentSourceSample::populateReservoir() {
+    PseudoRandom& prng = pExpCtx->opCtx->getClient()->getPrng();
+    // Orders the reservoir as a min-heap on the entries' random values.
+    const auto cmp = [](const ReservoirEntry& lhs, const ReservoirEntry& rhs) {
+        return lhs.randVal > rhs.randVal;
+    };
+
+    auto nextInput = pSource->getNext();
+    for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
+        if (_nToSkip > 0) {
+            --_nToSkip;
+            continue;
+        }
+
+        double randVal;
+        if (static_cast<long long>(_reservoir.size()) < _size) {
+            randVal = prng.nextCanonicalDouble();
+        } else {
+            // This document is known to beat the lowest value in the reservoir, so its value is
+            // uniformly distributed above that one, and it takes that document's place.
+            const double threshold = _reservoir.front().randVal;
+            randVal = threshold + (1.0 - threshold) * prng.nextCanonicalDouble();
+            std::pop_heap(_reservoir.begin(), _reservoir.end(), cmp);
+            _reservoirBytes -= _reservoir.back().doc.getApproximateSize();
+            _reservoir.pop_back();
+        }
+
+        _reservoirBytes += nextInput.getDocument().getApproximateSize();
+        _reservoir.push_back({randVal, nextInput.releaseDocument()});
+        std::push_heap(_reservoir.begin(), _reservoir.end(), cmp);
+
+        if (_reservoirBytes > DocumentSourceSort::kMaxMemoryUsageBytes) {
+            // Let the $sort enforce the memory limit, or spill to disk if that is allowed.
+            loadReservoirIntoSortStage();
+            _useReservoir = false;
+            return GetNextResult::makeEOF();
+        }
+
+        if (static_cast<long long>(_reservoir.size()) == _size) {
+            // Each following document beats the lowest value independently with probability
+            // (1 - threshold), so the number of documents before the next one that does is
+            // geometrically distributed.
+            const double threshold = _reservoir.front().randVal;
+            const double skip = threshold > 0.0
+                ? std::floor(std::log(1.0 - prng.nextCanonicalDouble()) / std::log(threshold))
+                : 0.0;
+            _nToSkip = skip < static_cast<double>(std::numeric_limits<long long>::max())
+                ? static_cast<long long>(skip)
+                : std::numeric_limits<long long>::max();
+        }
+    }
+
+    if (nextInput.isEOF()) {
+        loadReservoirIntoSortStage();
+        _sortStage->loadingDone();
+    }
+    return nextInput;
+}
+
+void DocumentSourceSample::loadReservoirIntoSortStage() {
+    for (auto&& entry : _reservoir) {
+        MutableDocument doc(std::move(entry.doc));
+        doc.setRandMetaField(entry.randVal);
+        _sortStage->loadDocument(doc.freeze());
+    }
+    _reservoir.clear();
+    _reservoirBytes = 0;
+}
+
 Value DocumentSourceSample::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     return Value(DOC(kStageName << DOC("size" << _size)));
 }
@@ -111,6 +192,7 @@ intrusive_ptr<DocumentSource> DocumentSourceSample::createFromBson(
     uassert(28749, "$sample stage must specify a size", sizeSpecified);
 
     sample->_sortStage = DocumentSourceSort::create(expCtx, randSortSpec, sample->_size);
+    sample->_useReservoir = internalQuerySampleUseReservoir.load();
 
     return sample;
 }
@@ -69,10 +69,45 @@ public:
 private:
     explicit DocumentSourceSample(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
+    /**
+     * Reads the input into '_reservoir', keeping the '_size' documents with the highest random
+     * values. Once the reservoir is full, the number of documents to pass over before the next one
+     * which beats the lowest value in the reservoir is drawn directly, so those documents are
+     * never given a random value. This produces the same distribution as giving every document a
+     * random value and keeping the '_size' highest.
+     *
+     * Returns a pause if the input pauses. Otherwise returns EOF, either with the sample loaded
+     * into '_sortStage' and '_sortStage' populated, or with '_useReservoir' set to false if the
+     * reservoir grew beyond the memory limit for a $sort, in which case its contents have been
+     * loaded into '_sortStage' and the rest of the input should be loaded after them.
+     */
+    GetNextResult populateReservoir();
+
+    /**
+     * Loads the documents in '_reservoir' into '_sortStage' with their random values, and empties
+     * the reservoir.
+     */
+    void loadReservoirIntoSortStage();
+
     long long _size;
 
     // Uses a $sort stage to randomly sort the documents.
     boost::intrusive_ptr<DocumentSourceSort> _sortStage;
+
+    struct ReservoirEntry {
+        double randVal;
+        Document doc;
+    };
+
+    // Set from 'internalQuerySampleUseReservoir' when the stage is created.
+    bool _useReservoir = false;
+
+    // A min-heap on 'randVal' of the documents sampled so far when using the reservoir.
+    std::vector<ReservoirEntry> _reservoir;
+    size_t _reservoirBytes = 0;
+
+    // The number of input documents to pass over before the next one enters the reservoir.
+    long long _nToSkip = 0;
 };
 
 }  // namespace mongo
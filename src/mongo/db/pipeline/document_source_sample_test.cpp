@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
@@ -188,6 +189,65 @@ TEST_F(SampleBasics, ShouldPropagatePauses) {
     assertEOF();
 }
 
+/**
+ * Runs the same checks with 'internalQuerySampleUseReservoir' enabled.
+ */
+class ReservoirSampleBasics : public SampleBasics {
+public:
+    ReservoirSampleBasics() {
+        internalQuerySampleUseReservoir.store(true);
+    }
+
+    ~ReservoirSampleBasics() {
+        internalQuerySampleUseReservoir.store(false);
+    }
+};
+
+TEST_F(ReservoirSampleBasics, SourceEOFBeforeSample) {
+    loadDocuments(5);
+    checkResults(10, 5);
+}
+
+TEST_F(ReservoirSampleBasics, SampleEOFBeforeSource) {
+    loadDocuments(100);
+    checkResults(5, 5);
+}
+
+TEST_F(ReservoirSampleBasics, ShouldPropagatePauses) {
+    createSample(2);
+    for (int i = 0; i < 3; ++i) {
+        source()->queue.push_back(DOC("_id" << i));
+        source()->queue.push_back(DocumentSource::GetNextResult::makePauseExecution());
+    }
+
+    ASSERT_TRUE(sample()->getNext().isPaused());
+    ASSERT_TRUE(sample()->getNext().isPaused());
+    ASSERT_TRUE(sample()->getNext().isPaused());
+    ASSERT_TRUE(sample()->getNext().isAdvanced());
+    ASSERT_TRUE(sample()->getNext().isAdvanced());
+    assertEOF();
+}
+
+TEST_F(ReservoirSampleBasics, ShouldSampleEachDocumentWithEqualProbability) {
+    const int nDocs = 4;
+    const int nTrials = 1000;
+    std::vector<int> timesSampled(nDocs, 0);
+    for (int trial = 0; trial < nTrials; ++trial) {
+        loadDocuments(nDocs);
+        createSample(1);
+        auto next = sample()->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ++timesSampled[next.getDocument()["_id"].getInt()];
+        assertEOF();
+    }
+
+    // Each document is expected to be sampled 250 times, with a standard deviation of about 14.
+    for (int timesThisDocSampled : timesSampled) {
+        ASSERT_GT(timesThisDocSampled, 150);
+        ASSERT_LT(timesThisDocSampled, 350);
+    }
+}
+
 /**
  * Fixture to test error cases of the $sample stage.
  */
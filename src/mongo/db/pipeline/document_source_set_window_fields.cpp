@@ -0,0 +1,705 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::list;
+
+using WindowBounds = DocumentSourceInternalSetWindowFields::WindowBounds;
+using WindowFunction = DocumentSourceInternalSetWindowFields::WindowFunction;
+
+constexpr StringData DocumentSourceSetWindowFields::kStageName;
+constexpr StringData DocumentSourceInternalSetWindowFields::kStageName;
+
+REGISTER_MULTI_STAGE_ALIAS(setWindowFields,
+                           LiteParsedDocumentSourceDefault::parse,
+                           DocumentSourceSetWindowFields::createFromBson);
+
+REGISTER_DOCUMENT_SOURCE(_internalSetWindowFields,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalSetWindowFields::createFromBson);
+
+namespace {
+const StringData kUnbounded = "unbounded"_sd;
+const StringData kCurrent = "current"_sd;
+
+boost::optional<double> parseBound(const BSONElement& elem, WindowBounds::Unit unit) {
+    if (elem.type() == String && elem.valueStringData() == kUnbounded) {
+        return boost::none;
+    }
+    if (elem.type() == String && elem.valueStringData() == kCurrent) {
+        return 0.0;
+    }
+    uassert(50883,
+            str::stream() << "window bounds must be \"unbounded\", \"current\" or a number, but "
+                             "found "
+                          << elem,
+            elem.isNumber() && std::isfinite(elem.numberDouble()));
+    const double bound = elem.numberDouble();
+    uassert(50884,
+            str::stream() << "the bounds of a documents window must be integers, but found "
+                          << elem,
+            unit != WindowBounds::Unit::kDocuments || std::trunc(bound) == bound);
+    return bound;
+}
+
+WindowBounds parseWindow(const BSONElement& elem) {
+    uassert(50885,
+            str::stream() << "window must be an object, but found " << elem,
+            elem.type() == Object);
+    BSONObj window = elem.embeddedObject();
+    uassert(50886,
+            str::stream() << "window must have exactly one of 'documents' or 'range', but found "
+                          << window,
+            window.nFields() == 1);
+
+    WindowBounds bounds;
+    auto unitElem = window.firstElement();
+    if (unitElem.fieldNameStringData() == "documents") {
+        bounds.unit = WindowBounds::Unit::kDocuments;
+    } else if (unitElem.fieldNameStringData() == "range") {
+        bounds.unit = WindowBounds::Unit::kRange;
+    } else {
+        uasserted(50887,
+                  str::stream() << "unrecognized window unit: " << unitElem.fieldNameStringData());
+    }
+
+    auto boundElems = unitElem.type() == Array ? unitElem.Array() : std::vector<BSONElement>{};
+    uassert(50888,
+            str::stream() << "window bounds must be an array of a lower and an upper bound, but "
+                             "found "
+                          << unitElem,
+            boundElems.size() == 2);
+    bounds.lower = parseBound(boundElems[0], bounds.unit);
+    bounds.upper = parseBound(boundElems[1], bounds.unit);
+    uassert(50889,
+            str::stream() << "the lower bound of a window must not be greater than its upper "
+                             "bound: "
+                          << unitElem,
+            !bounds.lower || !bounds.upper || *bounds.lower <= *bounds.upper);
+    return bounds;
+}
+
+WindowFunction parseWindowFunction(StringData fieldName,
+                                   const BSONElement& elem,
+                                   const intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(50890,
+            str::stream() << "the window function for '" << fieldName
+                          << "' must be an object, but found "
+                          << elem,
+            elem.type() == Object);
+
+    WindowFunction function;
+    function.fieldName = fieldName.toString();
+    bool hasWindow = false;
+    bool hasFunction = false;
+    for (auto&& specElem : elem.embeddedObject()) {
+        auto name = specElem.fieldNameStringData();
+        if (name == "window") {
+            function.bounds = parseWindow(specElem);
+            hasWindow = true;
+            continue;
+        }
+
+        uassert(50891,
+                str::stream() << "the window function for '" << fieldName
+                              << "' must specify exactly one function",
+                !hasFunction);
+        hasFunction = true;
+        function.opName = name.toString();
+        if (name == "$rank" || name == "$documentNumber") {
+            uassert(50892,
+                    str::stream() << name << " takes no arguments, but found " << specElem,
+                    specElem.type() == Object && specElem.embeddedObject().isEmpty());
+            function.kind = name == "$rank" ? WindowFunction::Kind::kRank
+                                            : WindowFunction::Kind::kDocumentNumber;
+        } else if (name == "$derivative") {
+            auto inputElem = specElem.type() == Object ? specElem.embeddedObject()["input"]
+                                                       : BSONElement();
+            uassert(50893,
+                    str::stream() << "$derivative must be of the form {input: <expression>}, but "
+                                     "found "
+                                  << specElem,
+                    inputElem && specElem.embeddedObject().nFields() == 1);
+            function.kind = WindowFunction::Kind::kDerivative;
+            function.input =
+                Expression::parseOperand(expCtx, inputElem, expCtx->variablesParseState);
+        } else {
+            function.kind = WindowFunction::Kind::kAccumulator;
+            function.factory = AccumulationStatement::getFactory(name);
+            function.input =
+                Expression::parseOperand(expCtx, specElem, expCtx->variablesParseState);
+        }
+    }
+    uassert(50894,
+            str::stream() << "the window function for '" << fieldName
+                          << "' must specify exactly one function",
+            hasFunction);
+
+    const bool isRanking = function.kind == WindowFunction::Kind::kRank ||
+        function.kind == WindowFunction::Kind::kDocumentNumber;
+    uassert(50895,
+            str::stream() << function.opName << " does not accept a window",
+            !isRanking || !hasWindow);
+    uassert(50896,
+            str::stream() << function.opName << " requires a window",
+            function.kind != WindowFunction::Kind::kDerivative || hasWindow);
+    return function;
+}
+
+Value serializeBound(const boost::optional<double>& bound, WindowBounds::Unit unit) {
+    if (!bound) {
+        return Value(kUnbounded);
+    }
+    return unit == WindowBounds::Unit::kDocuments ? Value(static_cast<long long>(*bound))
+                                                  : Value(*bound);
+}
+
+bool isRankingFunction(const WindowFunction& function) {
+    return function.kind == WindowFunction::Kind::kRank ||
+        function.kind == WindowFunction::Kind::kDocumentNumber;
+}
+
+bool usesNumericSortKey(const WindowFunction& function) {
+    return function.kind == WindowFunction::Kind::kDerivative ||
+        (function.kind == WindowFunction::Kind::kAccumulator &&
+         function.bounds.unit == WindowBounds::Unit::kRange);
+}
+
+double extractNumericSortKey(const Value& value) {
+    if (value.numeric()) {
+        return value.coerceToDouble();
+    }
+    uassert(50897,
+            str::stream() << "range windows and $derivative require the sortBy field to be a "
+                             "number or a date, but found "
+                          << typeName(value.getType()),
+            value.getType() == Date);
+    return static_cast<double>(value.getDate().toMillisSinceEpoch());
+}
+}  // namespace
+
+list<intrusive_ptr<DocumentSource>> DocumentSourceSetWindowFields::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(50898,
+            str::stream() << "the " << kStageName << " stage specification must be an object",
+            elem.type() == Object);
+    BSONObj spec = elem.embeddedObject();
+    auto windowStage = DocumentSourceInternalSetWindowFields::parse(spec, pExpCtx);
+
+    // Sort the input by the partitionBy field, then by the sortBy fields within each partition.
+    BSONObjBuilder sortSpec;
+    boost::optional<std::string> partitionField;
+    if (auto partitionElem = spec["partitionBy"]) {
+        uassert(50899,
+                str::stream() << "partitionBy of " << kStageName
+                              << " must be a field path, such as \"$a\", but found "
+                              << partitionElem,
+                partitionElem.type() == String && partitionElem.valueStringData().startsWith("$") &&
+                    !partitionElem.valueStringData().startsWith("$$"));
+        partitionField = partitionElem.valueStringData().substr(1).toString();
+        sortSpec.append(*partitionField, 1);
+    }
+    for (auto&& sortElem : windowStage->getSortBy()) {
+        if (!partitionField || sortElem.fieldNameStringData() != *partitionField) {
+            sortSpec.append(sortElem);
+        }
+    }
+
+    BSONObj sortObj = sortSpec.obj();
+    if (sortObj.isEmpty()) {
+        return {windowStage};
+    }
+    return {DocumentSourceSort::create(pExpCtx, sortObj), windowStage};
+}
+
+DocumentSourceInternalSetWindowFields::DocumentSourceInternalSetWindowFields(
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    intrusive_ptr<Expression> partitionBy,
+    BSONObj sortBy,
+    std::vector<WindowFunction> functions,
+    uint64_t maxMemoryUsageBytes)
+    : DocumentSource(pExpCtx),
+      _partitionBy(std::move(partitionBy)),
+      _sortBy(sortBy.getOwned()),
+      _functions(std::move(functions)),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes) {
+    for (auto&& sortElem : _sortBy) {
+        _sortByPaths.emplace_back(sortElem.fieldNameStringData());
+    }
+    for (auto&& function : _functions) {
+        _outputPaths.emplace_back(function.fieldName);
+        if (function.factory) {
+            function.accumulator = function.factory(pExpCtx);
+        }
+        _needsNumericSortKey = _needsNumericSortKey || usesNumericSortKey(function);
+    }
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceInternalSetWindowFields::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(50900,
+            str::stream() << "the " << kStageName << " stage specification must be an object",
+            elem.type() == Object);
+    return parse(elem.embeddedObject(), pExpCtx);
+}
+
+intrusive_ptr<DocumentSourceInternalSetWindowFields> DocumentSourceInternalSetWindowFields::parse(
+    BSONObj spec, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    intrusive_ptr<Expression> partitionBy;
+    BSONObj sortBy;
+    std::vector<WindowFunction> functions;
+    for (auto&& elem : spec) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "partitionBy") {
+            partitionBy = Expression::parseOperand(pExpCtx, elem, pExpCtx->variablesParseState);
+        } else if (fieldName == "sortBy") {
+            uassert(50901,
+                    str::stream() << "sortBy must be an object, but found " << elem,
+                    elem.type() == Object);
+            sortBy = elem.embeddedObject();
+            for (auto&& sortElem : sortBy) {
+                uassert(50902,
+                        str::stream() << "sortBy values must be 1 or -1, but found " << sortElem,
+                        sortElem.isNumber() &&
+                            (sortElem.numberLong() == 1 || sortElem.numberLong() == -1));
+            }
+        } else if (fieldName == "output") {
+            uassert(50903,
+                    str::stream() << "output must be an object, but found " << elem,
+                    elem.type() == Object);
+            for (auto&& outputElem : elem.embeddedObject()) {
+                functions.push_back(parseWindowFunction(
+                    outputElem.fieldNameStringData(), outputElem, pExpCtx));
+            }
+        } else {
+            uasserted(50904,
+                      str::stream() << "unrecognized option to "
+                                    << DocumentSourceSetWindowFields::kStageName
+                                    << ": "
+                                    << fieldName);
+        }
+    }
+    uassert(50905, "output must specify at least one field", !functions.empty());
+
+    for (auto&& function : functions) {
+        uassert(50906,
+                str::stream() << function.opName << " requires a sortBy",
+                !isRankingFunction(function) || !sortBy.isEmpty());
+        uassert(50907,
+                str::stream() << "range windows and $derivative require a sortBy on exactly one "
+                                 "field, in ascending order",
+                !usesNumericSortKey(function) ||
+                    (sortBy.nFields() == 1 && sortBy.firstElement().numberLong() == 1));
+    }
+
+    return new DocumentSourceInternalSetWindowFields(
+        pExpCtx, std::move(partitionBy), sortBy, std::move(functions), kDefaultMaxMemoryUsageBytes);
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalSetWindowFields::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (true) {
+        if (_nextToReturn < partitionEnd() && (_partitionComplete || canComputeNext())) {
+            return computeNext();
+        }
+
+        if (_partitionComplete) {
+            if (!_nextPartitionDoc) {
+                invariant(_inputExhausted);
+                return GetNextResult::makeEOF();
+            }
+            startNextPartition();
+            continue;
+        }
+
+        auto next = pSource->getNext();
+        if (next.isPaused()) {
+            return next;
+        }
+        if (next.isEOF()) {
+            _inputExhausted = true;
+            _partitionComplete = true;
+            continue;
+        }
+
+        auto doc = next.releaseDocument();
+        if (_partitionBy) {
+            auto key = _partitionBy->evaluate(doc);
+            if (key.missing()) {
+                // The $sort on the partitionBy field places missing and null values together.
+                key = Value(BSONNULL);
+            }
+
+            if (partitionEnd() == 0) {
+                _partitionKey = key;
+            } else if (pExpCtx->getValueComparator().evaluate(key != _partitionKey)) {
+                _nextPartitionDoc = std::move(doc);
+                _nextPartitionKey = std::move(key);
+                _partitionComplete = true;
+                continue;
+            }
+        }
+        addToBuffer(std::move(doc));
+    }
+}
+
+void DocumentSourceInternalSetWindowFields::addToBuffer(Document doc) {
+    BufferedDocument buffered;
+    buffered.memUsageBytes = doc.getApproximateSize();
+
+    buffered.inputs.reserve(_functions.size());
+    for (auto&& function : _functions) {
+        buffered.inputs.push_back(function.input ? function.input->evaluate(doc) : Value());
+        buffered.memUsageBytes += buffered.inputs.back().getApproximateSize();
+    }
+
+    buffered.sortValues.reserve(_sortByPaths.size());
+    for (auto&& path : _sortByPaths) {
+        buffered.sortValues.push_back(doc.getNestedField(path));
+        buffered.memUsageBytes += buffered.sortValues.back().getApproximateSize();
+    }
+
+    if (_needsNumericSortKey) {
+        buffered.numericSortKey = extractNumericSortKey(buffered.sortValues.front());
+        uassert(50908,
+                str::stream() << "range windows and $derivative require the input of "
+                              << kStageName
+                              << " to be in ascending order of its sortBy field",
+                _buffer.empty() || _buffer.back().numericSortKey <= buffered.numericSortKey);
+    }
+
+    buffered.doc = std::move(doc);
+    _memUsageBytes += buffered.memUsageBytes;
+    uassert(50909,
+            str::stream() << "Exceeded memory limit for "
+                          << DocumentSourceSetWindowFields::kStageName
+                          << ", the windows of its output fields span too many documents",
+            _memUsageBytes <= _maxMemoryUsageBytes);
+    _buffer.push_back(std::move(buffered));
+}
+
+bool DocumentSourceInternalSetWindowFields::canComputeNext() {
+    for (auto&& function : _functions) {
+        if (isRankingFunction(function)) {
+            continue;
+        }
+        if (!function.bounds.upper) {
+            return false;
+        }
+        if (function.bounds.unit == WindowBounds::Unit::kDocuments) {
+            if (partitionEnd() <= _nextToReturn + static_cast<long long>(*function.bounds.upper)) {
+                return false;
+            }
+        } else if (_buffer.back().numericSortKey <=
+                   bufferedAt(_nextToReturn).numericSortKey + *function.bounds.upper) {
+            // A later document may still have a sortBy value within the window.
+            return false;
+        }
+    }
+    return true;
+}
+
+std::pair<long long, long long> DocumentSourceInternalSetWindowFields::computeFrame(
+    const WindowFunction& function, long long position) {
+    const long long end = partitionEnd();
+    const auto& bounds = function.bounds;
+
+    if (bounds.unit == WindowBounds::Unit::kDocuments) {
+        long long begin = 0;
+        if (bounds.lower) {
+            begin = std::min(end, std::max(0LL, position + static_cast<long long>(*bounds.lower)));
+        }
+        long long stop = end;
+        if (bounds.upper) {
+            stop = std::min(end,
+                            std::max(0LL, position + static_cast<long long>(*bounds.upper) + 1));
+        }
+        return {begin, std::max(begin, stop)};
+    }
+
+    // The buffered documents are in ascending order of their sortBy values, and each document
+    // before '_bufferBegin' was dropped because its value is below the window of an earlier
+    // document, so the bounds can be found by binary search over the buffer.
+    const double key = bufferedAt(position).numericSortKey;
+    auto firstPositionWhere = [&](auto predicate) {
+        long long low = _bufferBegin;
+        long long high = end;
+        while (low < high) {
+            const long long mid = low + (high - low) / 2;
+            if (predicate(bufferedAt(mid).numericSortKey)) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    };
+
+    long long begin = 0;
+    if (bounds.lower) {
+        const double lowest = key + *bounds.lower;
+        begin = firstPositionWhere([&](double value) { return value >= lowest; });
+    }
+    long long stop = end;
+    if (bounds.upper) {
+        const double highest = key + *bounds.upper;
+        stop = firstPositionWhere([&](double value) { return value > highest; });
+    }
+    return {begin, std::max(begin, stop)};
+}
+
+Value DocumentSourceInternalSetWindowFields::computeAccumulator(size_t functionIndex,
+                                                                long long begin,
+                                                                long long end) {
+    auto& function = _functions[functionIndex];
+    auto& accumulator = *function.accumulator;
+
+    if (begin >= function.accumulatedEnd) {
+        // None of the documents accumulated so far are still in the window.
+        accumulator.reset();
+        function.accumulatedBegin = function.accumulatedEnd = begin;
+    }
+    for (; function.accumulatedBegin < begin; ++function.accumulatedBegin) {
+        if (!accumulator.remove(bufferedAt(function.accumulatedBegin).inputs[functionIndex])) {
+            accumulator.reset();
+            function.accumulatedBegin = function.accumulatedEnd = begin;
+            break;
+        }
+    }
+    for (; function.accumulatedEnd < end; ++function.accumulatedEnd) {
+        accumulator.process(bufferedAt(function.accumulatedEnd).inputs[functionIndex], false);
+    }
+    return accumulator.getValue(false);
+}
+
+Value DocumentSourceInternalSetWindowFields::computeDerivative(size_t functionIndex,
+                                                               long long begin,
+                                                               long long end) {
+    if (end - begin < 2) {
+        return Value(BSONNULL);
+    }
+
+    const auto& first = bufferedAt(begin);
+    const auto& last = bufferedAt(end - 1);
+    const auto& firstInput = first.inputs[functionIndex];
+    const auto& lastInput = last.inputs[functionIndex];
+    const double run = last.numericSortKey - first.numericSortKey;
+    if (!firstInput.numeric() || !lastInput.numeric() || run == 0) {
+        return Value(BSONNULL);
+    }
+    return Value((lastInput.coerceToDouble() - firstInput.coerceToDouble()) / run);
+}
+
+long long DocumentSourceInternalSetWindowFields::computeRank(long long position) {
+    const auto& sortValues = bufferedAt(position).sortValues;
+    bool tiesWithLast = position > 0;
+    for (size_t i = 0; tiesWithLast && i < sortValues.size(); ++i) {
+        tiesWithLast = pExpCtx->getValueComparator().evaluate(sortValues[i] == _lastSortValues[i]);
+    }
+
+    _lastRank = tiesWithLast ? _lastRank : position + 1;
+    _lastSortValues = sortValues;
+    return _lastRank;
+}
+
+Document DocumentSourceInternalSetWindowFields::computeNext() {
+    const long long position = _nextToReturn;
+    auto& current = bufferedAt(position);
+
+    const size_t docMemUsageBytes = current.doc.getApproximateSize();
+    MutableDocument output(std::move(current.doc));
+    current.memUsageBytes -= docMemUsageBytes;
+    _memUsageBytes -= docMemUsageBytes;
+
+    boost::optional<long long> rank;
+    for (size_t i = 0; i < _functions.size(); ++i) {
+        auto& function = _functions[i];
+        Value value;
+        switch (function.kind) {
+            case WindowFunction::Kind::kDocumentNumber:
+                value = Value::createIntOrLong(position + 1);
+                break;
+            case WindowFunction::Kind::kRank:
+                if (!rank) {
+                    rank = computeRank(position);
+                }
+                value = Value::createIntOrLong(*rank);
+                break;
+            case WindowFunction::Kind::kAccumulator: {
+                auto frame = computeFrame(function, position);
+                value = computeAccumulator(i, frame.first, frame.second);
+                break;
+            }
+            case WindowFunction::Kind::kDerivative: {
+                auto frame = computeFrame(function, position);
+                function.accumulatedBegin = frame.first;
+                value = computeDerivative(i, frame.first, frame.second);
+                break;
+            }
+        }
+        output.setNestedField(_outputPaths[i], std::move(value));
+    }
+    ++_nextToReturn;
+
+    // Drop the documents which are before the window of every later document.
+    long long keepFrom = _nextToReturn;
+    for (auto&& function : _functions) {
+        if (function.kind == WindowFunction::Kind::kDerivative) {
+            keepFrom = std::min(keepFrom, function.accumulatedBegin);
+        } else if (function.kind == WindowFunction::Kind::kAccumulator) {
+            // A window without a lower bound never removes anything from its accumulator.
+            keepFrom = std::min(keepFrom,
+                                function.bounds.lower ? function.accumulatedBegin
+                                                      : function.accumulatedEnd);
+        }
+    }
+    for (; _bufferBegin < keepFrom; ++_bufferBegin) {
+        _memUsageBytes -= _buffer.front().memUsageBytes;
+        _buffer.pop_front();
+    }
+
+    return output.freeze();
+}
+
+void DocumentSourceInternalSetWindowFields::startNextPartition() {
+    _buffer.clear();
+    _bufferBegin = 0;
+    _nextToReturn = 0;
+    _memUsageBytes = 0;
+    _lastRank = 0;
+    _lastSortValues.clear();
+    for (auto&& function : _functions) {
+        if (function.accumulator) {
+            function.accumulator->reset();
+        }
+        function.accumulatedBegin = function.accumulatedEnd = 0;
+    }
+
+    _partitionComplete = false;
+    _partitionKey = std::move(_nextPartitionKey);
+    auto doc = std::move(*_nextPartitionDoc);
+    _nextPartitionDoc = boost::none;
+    addToBuffer(std::move(doc));
+}
+
+Value DocumentSourceInternalSetWindowFields::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument output;
+    for (auto&& function : _functions) {
+        MutableDocument functionSpec;
+        switch (function.kind) {
+            case WindowFunction::Kind::kRank:
+            case WindowFunction::Kind::kDocumentNumber:
+                functionSpec[function.opName] = Value(Document());
+                break;
+            case WindowFunction::Kind::kDerivative:
+                functionSpec[function.opName] =
+                    Value(DOC("input" << function.input->serialize(static_cast<bool>(explain))));
+                break;
+            case WindowFunction::Kind::kAccumulator:
+                functionSpec[function.opName] =
+                    function.input->serialize(static_cast<bool>(explain));
+                break;
+        }
+        if (!isRankingFunction(function)) {
+            const auto unit = function.bounds.unit;
+            functionSpec["window"] = Value(
+                DOC((unit == WindowBounds::Unit::kDocuments ? "documents" : "range")
+                    << Value(std::vector<Value>{serializeBound(function.bounds.lower, unit),
+                                                serializeBound(function.bounds.upper, unit)})));
+        }
+        output[function.fieldName] = functionSpec.freezeToValue();
+    }
+
+    MutableDocument spec;
+    if (_partitionBy) {
+        spec["partitionBy"] = _partitionBy->serialize(static_cast<bool>(explain));
+    }
+    if (!_sortBy.isEmpty()) {
+        spec["sortBy"] = Value(_sortBy);
+    }
+    spec["output"] = output.freezeToValue();
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceInternalSetWindowFields::optimize() {
+    if (_partitionBy) {
+        _partitionBy = _partitionBy->optimize();
+    }
+    for (auto&& function : _functions) {
+        if (function.input) {
+            function.input = function.input->optimize();
+        }
+    }
+    return this;
+}
+
+DepsTracker::State DocumentSourceInternalSetWindowFields::getDependencies(
+    DepsTracker* deps) const {
+    if (_partitionBy) {
+        _partitionBy->addDependencies(deps);
+    }
+    for (auto&& path : _sortByPaths) {
+        deps->fields.insert(path.fullPath());
+    }
+    for (auto&& function : _functions) {
+        if (function.input) {
+            function.input->addDependencies(deps);
+        }
+    }
+    return DepsTracker::State::SEE_NEXT;
+}
+
+DocumentSource::GetModPathsReturn DocumentSourceInternalSetWindowFields::getModifiedPaths() const {
+    std::set<std::string> outputFields;
+    for (auto&& function : _functions) {
+        outputFields.insert(function.fieldName);
+    }
+    return {GetModPathsReturn::Type::kFiniteSet, std::move(outputFields), {}};
+}
+
+}  // namespace mongo
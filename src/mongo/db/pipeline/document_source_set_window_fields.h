@@ -0,0 +1,260 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/expression.h"
+
+namespace mongo {
+
+/**
+ * The $setWindowFields stage adds fields computed over a window of neighboring documents to each
+ * document, such as running totals and moving averages. The syntax is
+ *
+ * {$setWindowFields: {
+ *     partitionBy: "$<field>",
+ *     sortBy: {<field>: <1 or -1>, ...},
+ *     output: {
+ *         <output field>: {<accumulator>: <expression>, window: {documents: [<lower>, <upper>]}},
+ *         <output field>: {<accumulator>: <expression>, window: {range: [<lower>, <upper>]}},
+ *         <output field>: {$derivative: {input: <expression>}, window: {...}},
+ *         <output field>: {$rank: {}},
+ *         <output field>: {$documentNumber: {}},
+ *     }
+ * }}
+ *
+ * where each bound is "unbounded", "current" or a number. It is parsed into a $sort on the
+ * partitionBy and sortBy fields, followed by a $_internalSetWindowFields stage which reads the
+ * sorted documents in a single pass.
+ */
+class DocumentSourceSetWindowFields final {
+public:
+    static constexpr StringData kStageName = "$setWindowFields"_sd;
+
+    static std::list<boost::intrusive_ptr<DocumentSource>> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    // It is illegal to construct a DocumentSourceSetWindowFields directly, use createFromBson().
+    DocumentSourceSetWindowFields() = default;
+};
+
+/**
+ * Computes the window fields of $setWindowFields over input which is already sorted by the
+ * partitionBy expression and then by sortBy. Only the documents within the windows of the
+ * documents which have yet to be returned are buffered, so a window which is bounded on both sides
+ * uses memory proportional to the size of the window rather than of the partition.
+ *
+ * Accumulators which support Accumulator::remove() are updated incrementally as the window slides.
+ * Any other accumulator is recomputed over the window whenever a document leaves it.
+ */
+class DocumentSourceInternalSetWindowFields final : public DocumentSource,
+                                                    public NeedsMergerDocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalSetWindowFields"_sd;
+
+    static const uint64_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
+
+    /**
+     * The frame of a window function, relative to the current document. A missing bound is
+     * unbounded. For a 'kDocuments' window the bounds are offsets in the number of documents, and
+     * for a 'kRange' window they are offsets from the value of the current document's sortBy field.
+     */
+    struct WindowBounds {
+        enum class Unit { kDocuments, kRange };
+
+        Unit unit = Unit::kDocuments;
+        boost::optional<double> lower;
+        boost::optional<double> upper;
+    };
+
+    struct WindowFunction {
+        enum class Kind { kAccumulator, kDerivative, kRank, kDocumentNumber };
+
+        std::string fieldName;
+        Kind kind;
+        std::string opName;
+        Accumulator::Factory factory = nullptr;
+        boost::intrusive_ptr<Expression> input;
+        WindowBounds bounds;
+
+        // The accumulator holding the inputs of the documents in ['accumulatedBegin',
+        // 'accumulatedEnd'), given as positions within the current partition.
+        boost::intrusive_ptr<Accumulator> accumulator;
+        long long accumulatedBegin = 0;
+        long long accumulatedEnd = 0;
+    };
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    /**
+     * Parses the specification shared by $setWindowFields and $_internalSetWindowFields.
+     */
+    static boost::intrusive_ptr<DocumentSourceInternalSetWindowFields> parse(
+        BSONObj spec, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    GetNextResult getNext() final;
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    boost::intrusive_ptr<DocumentSource> optimize() final;
+    DepsTracker::State getDependencies(DepsTracker* deps) const final;
+    GetModPathsReturn getModifiedPaths() const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed};
+    }
+
+    /**
+     * The windows may span documents from every shard, so this stage must be run on the merger.
+     */
+    boost::intrusive_ptr<DocumentSource> getShardSource() final {
+        return nullptr;
+    }
+    std::list<boost::intrusive_ptr<DocumentSource>> getMergeSources() final {
+        return {this};
+    }
+
+    const boost::intrusive_ptr<Expression>& getPartitionBy() const {
+        return _partitionBy;
+    }
+
+    const BSONObj& getSortBy() const {
+        return _sortBy;
+    }
+
+private:
+    struct BufferedDocument {
+        // Released once the document has been returned.
+        Document doc;
+
+        // The evaluated input of each window function.
+        std::vector<Value> inputs;
+
+        // The values of the sortBy fields.
+        std::vector<Value> sortValues;
+
+        // The value of the single sortBy field as a number, for range windows and $derivative.
+        double numericSortKey = 0;
+
+        size_t memUsageBytes;
+    };
+
+    DocumentSourceInternalSetWindowFields(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+                                          boost::intrusive_ptr<Expression> partitionBy,
+                                          BSONObj sortBy,
+                                          std::vector<WindowFunction> functions,
+                                          uint64_t maxMemoryUsageBytes);
+
+    /**
+     * The position within the partition after the last document buffered so far.
+     */
+    long long partitionEnd() const {
+        return _bufferBegin + static_cast<long long>(_buffer.size());
+    }
+
+    BufferedDocument& bufferedAt(long long position) {
+        return _buffer[position - _bufferBegin];
+    }
+
+    void addToBuffer(Document doc);
+
+    /**
+     * Returns true if enough of the partition has been read to compute the windows of the next
+     * document to return.
+     */
+    bool canComputeNext();
+
+    /**
+     * Computes the window of 'function' for the document at 'position' as [begin, end).
+     */
+    std::pair<long long, long long> computeFrame(const WindowFunction& function,
+                                                 long long position);
+
+    Value computeAccumulator(size_t functionIndex, long long begin, long long end);
+    Value computeDerivative(size_t functionIndex, long long begin, long long end);
+    long long computeRank(long long position);
+
+    /**
+     * Adds the window fields to the next document and returns it, then drops the documents which
+     * cannot be in any later window from the buffer.
+     */
+    Document computeNext();
+
+    /**
+     * Starts a new partition with '_nextPartitionDoc', if there is one.
+     */
+    void startNextPartition();
+
+    boost::intrusive_ptr<Expression> _partitionBy;
+    BSONObj _sortBy;
+    std::vector<FieldPath> _sortByPaths;
+    std::vector<WindowFunction> _functions;
+    std::vector<FieldPath> _outputPaths;
+    const uint64_t _maxMemoryUsageBytes;
+
+    // Whether any window function needs 'numericSortKey' of the buffered documents.
+    bool _needsNumericSortKey = false;
+
+    // The documents of the current partition from the earliest which is still within a window of
+    // a document yet to be returned. '_bufferBegin' is the position of the first within the
+    // partition.
+    std::deque<BufferedDocument> _buffer;
+    long long _bufferBegin = 0;
+    long long _nextToReturn = 0;
+    uint64_t _memUsageBytes = 0;
+
+    Value _partitionKey;
+    bool _partitionComplete = false;
+    bool _inputExhausted = false;
+
+    // The first document of the next partition, read while looking for the end of this one.
+    boost::optional<Document> _nextPartitionDoc;
+    Value _nextPartitionKey;
+
+    // The rank and sortBy values of the document most recently returned.
+    long long _lastRank = 0;
+    std::vector<Value> _lastSortValues;
+};
+
+}  // namespace mongo
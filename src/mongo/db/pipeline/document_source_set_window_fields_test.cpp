@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_set_window_fields.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+using std::deque;
+using std::vector;
+
+class SetWindowFieldsTest : public AggregationContextFixture {
+protected:
+    intrusive_ptr<DocumentSource> createWindowStage(const BSONObj& spec) {
+        return DocumentSourceInternalSetWindowFields::createFromBson(
+            BSON("$_internalSetWindowFields" << spec).firstElement(), getExpCtx());
+    }
+
+    /**
+     * Runs the $_internalSetWindowFields stage with 'spec' over 'inputs', which must already be in
+     * the order the stage expects, and returns all of its results.
+     */
+    vector<Document> runWindowStage(const BSONObj& spec, const vector<BSONObj>& inputs) {
+        deque<DocumentSource::GetNextResult> queue;
+        for (auto&& input : inputs) {
+            queue.emplace_back(Document(input));
+        }
+        auto mock = DocumentSourceMock::create(queue);
+        auto stage = createWindowStage(spec);
+        stage->setSource(mock.get());
+
+        vector<Document> results;
+        for (auto next = stage->getNext(); next.isAdvanced(); next = stage->getNext()) {
+            results.push_back(next.releaseDocument());
+        }
+        ASSERT_TRUE(stage->getNext().isEOF());
+        return results;
+    }
+
+    /**
+     * Asserts that 'results' have the values of the field 'field' given in 'expected'.
+     */
+    void assertFieldValues(const vector<Document>& results,
+                           StringData field,
+                           const vector<Value>& expected) {
+        ASSERT_EQ(results.size(), expected.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            ASSERT_VALUE_EQ(results[i][field], expected[i]);
+        }
+    }
+};
+
+TEST_F(SetWindowFieldsTest, RunningSumShouldRestartInEachPartition) {
+    auto results = runWindowStage(
+        fromjson("{partitionBy: '$p', sortBy: {t: 1}, output: {total: {$sum: '$x', window: "
+                 "{documents: ['unbounded', 'current']}}}}"),
+        {BSON("p" << 1 << "t" << 1 << "x" << 1),
+         BSON("p" << 1 << "t" << 2 << "x" << 2),
+         BSON("p" << 1 << "t" << 3 << "x" << 3),
+         BSON("p" << 2 << "t" << 1 << "x" << 10),
+         BSON("p" << 2 << "t" << 2 << "x" << 20)});
+    assertFieldValues(results, "total", {Value(1), Value(3), Value(6), Value(10), Value(30)});
+}
+
+TEST_F(SetWindowFieldsTest, MissingAndNullPartitionKeysShouldShareAPartition) {
+    auto results = runWindowStage(
+        fromjson("{partitionBy: '$p', output: {count: {$sum: 1, window: {documents: "
+                 "['unbounded', 'unbounded']}}}}"),
+        {BSON("x" << 1), BSON("p" << BSONNULL), BSON("x" << 2), BSON("p" << 1)});
+    assertFieldValues(results, "count", {Value(3), Value(3), Value(3), Value(1)});
+}
+
+TEST_F(SetWindowFieldsTest, MovingAverageShouldSlideOverDocuments) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {t: 1}, output: {avg: {$avg: '$x', window: {documents: [-1, 1]}}}}"),
+        {BSON("t" << 1 << "x" << 2),
+         BSON("t" << 2 << "x" << 4),
+         BSON("t" << 3 << "x" << 6),
+         BSON("t" << 4 << "x" << 8)});
+    assertFieldValues(results, "avg", {Value(3.0), Value(4.0), Value(6.0), Value(7.0)});
+}
+
+TEST_F(SetWindowFieldsTest, NonRemovableAccumulatorShouldBeRecomputedAsTheWindowSlides) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {t: 1}, output: {low: {$min: '$x', window: {documents: [-1, 0]}}}}"),
+        {BSON("t" << 1 << "x" << 1),
+         BSON("t" << 2 << "x" << 5),
+         BSON("t" << 3 << "x" << 3),
+         BSON("t" << 4 << "x" << 4)});
+    assertFieldValues(results, "low", {Value(1), Value(1), Value(3), Value(3)});
+}
+
+TEST_F(SetWindowFieldsTest, SumShouldRecoverOnceANaNLeavesTheWindow) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {t: 1}, output: {total: {$sum: '$x', window: {documents: [-1, 0]}}}}"),
+        {BSON("t" << 1 << "x" << 1),
+         BSON("t" << 2 << "x" << std::numeric_limits<double>::quiet_NaN()),
+         BSON("t" << 3 << "x" << 2),
+         BSON("t" << 4 << "x" << 3)});
+    ASSERT_EQ(results.size(), 4UL);
+    ASSERT_TRUE(std::isnan(results[1]["total"].getDouble()));
+    ASSERT_TRUE(std::isnan(results[2]["total"].getDouble()));
+    ASSERT_VALUE_EQ(results[3]["total"], Value(5));
+}
+
+TEST_F(SetWindowFieldsTest, RangeWindowShouldIncludeDocumentsWithinTheOffsets) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {t: 1}, output: {total: {$sum: '$x', window: {range: [-2, "
+                 "'current']}}}}"),
+        {BSON("t" << 1 << "x" << 1),
+         BSON("t" << 2 << "x" << 2),
+         BSON("t" << 2 << "x" << 4),
+         BSON("t" << 5 << "x" << 8),
+         BSON("t" << 6 << "x" << 16)});
+    assertFieldValues(results, "total", {Value(1), Value(7), Value(7), Value(8), Value(24)});
+}
+
+TEST_F(SetWindowFieldsTest, RankShouldGiveTiesTheSameRank) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {score: -1}, output: {rank: {$rank: {}}, n: {$documentNumber: {}}}}"),
+        {BSON("score" << 9), BSON("score" << 7), BSON("score" << 7), BSON("score" << 4)});
+    assertFieldValues(results, "rank", {Value(1), Value(2), Value(2), Value(4)});
+    assertFieldValues(results, "n", {Value(1), Value(2), Value(3), Value(4)});
+}
+
+TEST_F(SetWindowFieldsTest, DerivativeShouldDivideByTheDistanceBetweenSortByValues) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {t: 1}, output: {rate: {$derivative: {input: '$x'}, window: "
+                 "{documents: [-1, 'current']}}}}"),
+        {BSON("t" << 0 << "x" << 0), BSON("t" << 2 << "x" << 10), BSON("t" << 3 << "x" << 13)});
+    assertFieldValues(results, "rate", {Value(BSONNULL), Value(5.0), Value(3.0)});
+}
+
+TEST_F(SetWindowFieldsTest, ShouldPreserveOtherFieldsAndSetNestedOutputs) {
+    auto results = runWindowStage(
+        fromjson("{sortBy: {t: 1}, output: {'stats.n': {$documentNumber: {}}}}"),
+        {BSON("t" << 1 << "a" << "x")});
+    ASSERT_EQ(results.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(results[0], Document(fromjson("{t: 1, a: 'x', stats: {n: 1}}")));
+}
+
+TEST_F(SetWindowFieldsTest, ShouldSortByPartitionAndSortByFields) {
+    auto stages = DocumentSourceSetWindowFields::createFromBson(
+        fromjson("{$setWindowFields: {partitionBy: '$p', sortBy: {t: -1}, output: {n: "
+                 "{$documentNumber: {}}}}}")
+            .firstElement(),
+        getExpCtx());
+    ASSERT_EQ(stages.size(), 2UL);
+
+    auto sortStage = dynamic_cast<DocumentSourceSort*>(stages.front().get());
+    ASSERT(sortStage);
+    vector<Value> serialized;
+    sortStage->serializeToArray(serialized);
+    ASSERT_VALUE_EQ(serialized[0], Value(fromjson("{$sort: {p: 1, t: -1}}")));
+    ASSERT(dynamic_cast<DocumentSourceInternalSetWindowFields*>(stages.back().get()));
+}
+
+TEST_F(SetWindowFieldsTest, ShouldRoundTripThroughSerialization) {
+    auto spec = fromjson(
+        "{partitionBy: '$p', sortBy: {t: 1}, output: {total: {$sum: '$x', window: {documents: "
+        "['unbounded', 0]}}, r: {$rank: {}}}}");
+    auto stage = createWindowStage(spec);
+    vector<Value> serialized;
+    stage->serializeToArray(serialized);
+    ASSERT_EQ(serialized.size(), 1UL);
+
+    auto reparsed = createWindowStage(serialized[0].getDocument()["$_internalSetWindowFields"]
+                                          .getDocument()
+                                          .toBson());
+    vector<Value> reserialized;
+    reparsed->serializeToArray(reserialized);
+    ASSERT_VALUE_EQ(serialized[0], reserialized[0]);
+}
+
+TEST_F(SetWindowFieldsTest, ShouldRejectInvalidSpecifications) {
+    ASSERT_THROWS_CODE(createWindowStage(fromjson("{sortBy: {t: 1}, output: {r: {$rank: {}, "
+                                                  "window: {documents: [-1, 0]}}}}")),
+                       AssertionException,
+                       50895);
+    ASSERT_THROWS_CODE(
+        createWindowStage(fromjson("{output: {s: {$sum: '$x', window: {range: [-1, 0]}}}}")),
+        AssertionException,
+        50907);
+    ASSERT_THROWS_CODE(createWindowStage(fromjson(
+                           "{output: {s: {$sum: '$x', window: {documents: [1, -1]}}}}")),
+                       AssertionException,
+                       50889);
+    ASSERT_THROWS_CODE(createWindowStage(fromjson("{output: {r: {$rank: {}}}}")),
+                       AssertionException,
+                       50906);
+    ASSERT_THROWS_CODE(DocumentSourceSetWindowFields::createFromBson(
+                           fromjson("{$setWindowFields: {partitionBy: {$add: ['$a', 1]}, output: "
+                                    "{n: {$sum: 1}}}}")
+                               .firstElement(),
+                           getExpCtx()),
+                       AssertionException,
+                       50899);
+}
+
+}  // namespace
+}  // namespace mongo
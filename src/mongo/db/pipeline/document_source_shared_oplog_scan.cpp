@@ -0,0 +1,351 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_shared_oplog_scan.h"
+
+#include "mongo/client/dbclient_cursor.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr StringData DocumentSourceSharedOplogScan::kStageName;
+
+namespace {
+
+const auto getSharedOplogReader = ServiceContext::declareDecoration<SharedOplogReader>();
+
+// The most oplog entries read into a single batch.
+const size_t kMaxEntriesPerBatch = 1000;
+
+/**
+ * Returns the timestamp immediately before 'ts', so that reading after it includes 'ts'.
+ */
+Timestamp justBefore(Timestamp ts) {
+    return ts.isNull() ? ts : Timestamp(ts.asULL() - 1);
+}
+
+/**
+ * Returns the point a change stream starts reading from, given the 'ts' predicate at the front of
+ * the filter built by DocumentSourceChangeStream::buildMatchFilter().
+ */
+Timestamp getStartingPoint(const BSONObj& filter) {
+    const BSONObj tsPredicate = filter["$and"]["0"]["ts"].Obj();
+    const BSONElement bound = tsPredicate.firstElement();
+    invariant(bound.type() == bsonTimestamp);
+    return bound.fieldNameStringData() == "$gte" ? justBefore(bound.timestamp())
+                                                 : bound.timestamp();
+}
+
+}  // namespace
+
+SharedOplogReader* SharedOplogReader::get(ServiceContext* service) {
+    return &getSharedOplogReader(service);
+}
+
+bool SharedOplogReader::read(OperationContext* opCtx,
+                             Subscription* sub,
+                             std::deque<BSONObj>* out) {
+    auto result = _readBuffered(sub, out);
+    if (result == BufferedReadResult::kRead ||
+        (result == BufferedReadResult::kBehind && _readPrivately(opCtx, sub, out))) {
+        return true;
+    }
+
+    _fill(opCtx, sub->readThrough);
+
+    result = _readBuffered(sub, out);
+    return result == BufferedReadResult::kRead ||
+        (result == BufferedReadResult::kBehind && _readPrivately(opCtx, sub, out));
+}
+
+SharedOplogReader::BufferedReadResult SharedOplogReader::_readBuffered(Subscription* sub,
+                                                                      std::deque<BSONObj>* out) {
+    std::vector<std::shared_ptr<const Batch>> batches;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_batches.empty() || sub->readThrough >= _batches.back()->through) {
+            return BufferedReadResult::kCaughtUp;
+        }
+        if (sub->readThrough < _batches.front()->after) {
+            return BufferedReadResult::kBehind;
+        }
+        for (auto&& batch : _batches) {
+            if (batch->through > sub->readThrough) {
+                batches.push_back(batch);
+            }
+        }
+    }
+
+    // The batches are never modified once buffered, so they can be scanned without the mutex.
+    for (auto&& batch : batches) {
+        _scanBatch(*batch, sub, out);
+    }
+    return BufferedReadResult::kRead;
+}
+
+void SharedOplogReader::_scanBatch(const Batch& batch,
+                                   Subscription* sub,
+                                   std::deque<BSONObj>* out) {
+    auto examine = [&](const BSONObj& entry) {
+        if (entry["ts"].timestamp() > sub->readThrough && sub->filter->matchesBSON(entry)) {
+            out->push_back(entry);
+        }
+    };
+
+    if (sub->ns) {
+        // Only the entries on the change stream's namespace and the commands can match, so merge
+        // those two lists of positions rather than examining every entry.
+        static const std::vector<size_t> kNone;
+        auto onNs = batch.byNs.find(*sub->ns);
+        const auto& nsPositions = onNs == batch.byNs.end() ? kNone : onNs->second;
+        auto nsIt = nsPositions.begin();
+        auto cmdIt = batch.commands.begin();
+        while (nsIt != nsPositions.end() || cmdIt != batch.commands.end()) {
+            if (cmdIt == batch.commands.end() ||
+                (nsIt != nsPositions.end() && *nsIt < *cmdIt)) {
+                examine(batch.entries[*nsIt++]);
+            } else {
+                examine(batch.entries[*cmdIt++]);
+            }
+        }
+    } else {
+        for (auto&& entry : batch.entries) {
+            examine(entry);
+        }
+    }
+    sub->readThrough = std::max(sub->readThrough, batch.through);
+}
+
+bool SharedOplogReader::_readPrivately(OperationContext* opCtx,
+                                       Subscription* sub,
+                                       std::deque<BSONObj>* out) {
+    Timestamp joinAt;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_batches.empty()) {
+            return false;
+        }
+        joinAt = _batches.front()->after;
+    }
+    if (sub->readThrough >= joinAt) {
+        return true;
+    }
+
+    // Read the matching entries up to the start of the buffered batches.
+    BSONObj query = BSON("$and" << BSON_ARRAY(
+                             BSON("ts" << BSON("$gt" << sub->readThrough << "$lte" << joinAt))
+                             << sub->filterObj));
+    DBDirectClient client(opCtx);
+    auto cursor = client.query(NamespaceString::kRsOplogNamespace.ns(),
+                               query,
+                               0,
+                               0,
+                               nullptr,
+                               QueryOption_OplogReplay);
+    uassert(50881, "failed to read the oplog", cursor);
+
+    size_t numRead = 0;
+    while (numRead < kMaxEntriesPerBatch && cursor->more()) {
+        BSONObj entry = cursor->next().getOwned();
+        sub->readThrough = entry["ts"].timestamp();
+        out->push_back(std::move(entry));
+        ++numRead;
+    }
+    if (numRead < kMaxEntriesPerBatch) {
+        sub->readThrough = joinAt;
+    }
+    return true;
+}
+
+void SharedOplogReader::_fill(OperationContext* opCtx, Timestamp from) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_filling) {
+        // Another operation is reading the next batch; use that instead of reading it again.
+        opCtx->waitForConditionOrInterrupt(_fillDone, lk, [&] { return !_filling; });
+        return;
+    }
+
+    if (!_batches.empty() && from > _batches.back()->through) {
+        // Nothing is waiting for the buffered entries, so start again from where this reader is.
+        _batches.clear();
+        _bytes = 0;
+    }
+    const Timestamp after = _batches.empty() ? from : _batches.back()->through;
+
+    _filling = true;
+    lk.unlock();
+    ON_BLOCK_EXIT([&] {
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+        _filling = false;
+        _fillDone.notify_all();
+    });
+
+    auto batch = std::make_shared<Batch>();
+    batch->after = after;
+
+    DBDirectClient client(opCtx);
+    auto cursor = client.query(NamespaceString::kRsOplogNamespace.ns(),
+                               BSON("ts" << BSON("$gt" << after)),
+                               0,
+                               0,
+                               nullptr,
+                               QueryOption_OplogReplay);
+    uassert(50882, "failed to read the oplog", cursor);
+
+    while (batch->entries.size() < kMaxEntriesPerBatch &&
+           batch->bytes < static_cast<size_t>(BSONObjMaxUserSize) && cursor->more()) {
+        BSONObj entry = cursor->next().getOwned();
+        const size_t pos = batch->entries.size();
+        if (entry["op"].valueStringData() == "c") {
+            batch->commands.push_back(pos);
+        } else {
+            batch->byNs[entry["ns"].valueStringData()].push_back(pos);
+        }
+        batch->through = entry["ts"].timestamp();
+        batch->bytes += entry.objsize();
+        batch->entries.push_back(std::move(entry));
+    }
+    if (batch->entries.empty()) {
+        return;
+    }
+
+    lk.lock();
+    _bytes += batch->bytes;
+    _batches.push_back(std::move(batch));
+
+    // Keep at least the newest batch, which the readers which are caught up are about to scan.
+    const size_t maxBytes = internalChangeStreamSharedOplogBufferBytes.load();
+    while (_batches.size() > 1 && _bytes > maxBytes) {
+        _bytes -= _batches.front()->bytes;
+        _batches.pop_front();
+    }
+}
+
+boost::intrusive_ptr<DocumentSourceSharedOplogScan> DocumentSourceSharedOplogScan::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, BSONObj filter) {
+    return new DocumentSourceSharedOplogScan(expCtx, std::move(filter));
+}
+
+DocumentSourceSharedOplogScan::DocumentSourceSharedOplogScan(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, BSONObj filter)
+    : DocumentSource(expCtx) {
+    _subscription.filterObj = filter.getOwned();
+
+    // Comparisons against the oplog always use the simple collation.
+    boost::intrusive_ptr<ExpressionContext> oplogExpCtx(
+        new ExpressionContext(expCtx->opCtx, nullptr));
+    _subscription.filter =
+        uassertStatusOK(MatchExpressionParser::parse(_subscription.filterObj, oplogExpCtx));
+
+    if (DocumentSourceChangeStream::getChangeStreamType(expCtx->ns) ==
+        DocumentSourceChangeStream::ChangeStreamType::kSingleCollection) {
+        _subscription.ns = expCtx->ns.ns();
+    }
+    _subscription.readThrough = getStartingPoint(_subscription.filterObj);
+}
+
+DocumentSource::GetNextResult DocumentSourceSharedOplogScan::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    auto opCtx = pExpCtx->opCtx;
+    auto reader = SharedOplogReader::get(opCtx->getServiceContext());
+    while (_matched.empty()) {
+        if (!_notifier && shouldWaitForInserts()) {
+            AutoGetCollectionForRead oplog(opCtx, NamespaceString::kRsOplogNamespace);
+            if (oplog.getCollection()) {
+                _notifier = oplog.getCollection()->getCappedInsertNotifier();
+            }
+        }
+
+        // Take the version before reading, so that no insert after the read is missed.
+        const uint64_t version = _notifier ? _notifier->getVersion() : 0;
+        if (reader->read(opCtx, &_subscription, &_matched)) {
+            continue;
+        }
+        if (!_notifier || !shouldWaitForInserts()) {
+            return GetNextResult::makeEOF();
+        }
+
+        auto curOp = CurOp::get(opCtx);
+        curOp->pauseTimer();
+        ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
+        _notifier->waitUntil(version, awaitDataState(opCtx).waitForInsertsDeadline);
+        pExpCtx->checkForInterrupt();
+    }
+
+    Document entry(_matched.front());
+    _matched.pop_front();
+    return std::move(entry);
+}
+
+bool DocumentSourceSharedOplogScan::shouldWaitForInserts() const {
+    // The same conditions as PlanExecutor::shouldWaitForInserts() for an awaitData cursor.
+    auto opCtx = pExpCtx->opCtx;
+    if (pExpCtx->tailableMode != TailableModeEnum::kTailableAndAwaitData ||
+        !awaitDataState(opCtx).shouldWaitForInserts ||
+        !opCtx->checkForInterruptNoAssert().isOK() ||
+        awaitDataState(opCtx).waitForInsertsDeadline <=
+            opCtx->getServiceContext()->getPreciseClockSource()->now()) {
+        return false;
+    }
+    if (!clientsLastKnownCommittedOpTime(opCtx).isNull()) {
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        return clientsLastKnownCommittedOpTime(opCtx) >= replCoord->getLastCommittedOpTime();
+    }
+    return true;
+}
+
+Value DocumentSourceSharedOplogScan::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (explain) {
+        return Value(Document{{kStageName, Document{{"filter", _subscription.filterObj}}}});
+    }
+    return Value();
+}
+
+}  // namespace mongo
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class CappedInsertNotifier;
+
+/**
+ * Reads the oplog on behalf of all the change streams on this node, so that each batch of oplog
+ * entries is scanned once however many change streams are reading it. The batches are kept in
+ * memory, up to internalChangeStreamSharedOplogBufferBytes, and are then filtered by each change
+ * stream in turn. A change stream which has fallen further behind reads the oplog by itself until
+ * it catches up with the batches.
+ */
+class SharedOplogReader {
+public:
+    /**
+     * The oplog entries a single change stream is interested in, and how far it has read.
+     */
+    struct Subscription {
+        // The filter built by DocumentSourceChangeStream::buildMatchFilter().
+        BSONObj filterObj;
+        std::unique_ptr<MatchExpression> filter;
+
+        // If set, 'filter' can only match commands and entries on this namespace.
+        boost::optional<std::string> ns;
+
+        // Every oplog entry up to and including this timestamp has been examined.
+        Timestamp readThrough;
+    };
+
+    static SharedOplogReader* get(ServiceContext* service);
+
+    /**
+     * Appends to 'out' the oplog entries after 'sub->readThrough' which match 'sub->filter', and
+     * advances 'sub->readThrough' past them and past any entries which did not match. Returns false
+     * if there were no entries after 'sub->readThrough' to examine.
+     */
+    bool read(OperationContext* opCtx, Subscription* sub, std::deque<BSONObj>* out);
+
+private:
+    /**
+     * Every oplog entry with a timestamp in (after, through], in order.
+     */
+    struct Batch {
+        Timestamp after;
+        Timestamp through;
+        std::vector<BSONObj> entries;
+
+        // The positions in 'entries' of the entries on each namespace, and of the commands.
+        StringMap<std::vector<size_t>> byNs;
+        std::vector<size_t> commands;
+
+        size_t bytes = 0;
+    };
+
+    enum class BufferedReadResult { kRead, kCaughtUp, kBehind };
+
+    /**
+     * Scans the buffered batches after 'sub->readThrough'. Returns kCaughtUp if there are none, and
+     * kBehind if 'sub' has not reached the oldest of them.
+     */
+    BufferedReadResult _readBuffered(Subscription* sub, std::deque<BSONObj>* out);
+
+    /**
+     * Reads the entries between 'sub->readThrough' and the oldest buffered batch with a query of
+     * its own. Returns false if nothing is buffered.
+     */
+    bool _readPrivately(OperationContext* opCtx, Subscription* sub, std::deque<BSONObj>* out);
+
+    /**
+     * Reads the next batch of oplog entries after those already buffered, or after 'from' if it is
+     * past the buffered entries. If another operation is already reading a batch, waits for it
+     * instead.
+     */
+    void _fill(OperationContext* opCtx, Timestamp from);
+
+    static void _scanBatch(const Batch& batch, Subscription* sub, std::deque<BSONObj>* out);
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _fillDone;
+
+    // Set while an operation reads the next batch without holding '_mutex'.
+    bool _filling = false;
+
+    std::deque<std::shared_ptr<const Batch>> _batches;
+    size_t _bytes = 0;
+};
+
+/**
+ * Stands in for the oplog cursor of a change stream, reading the oplog through the
+ * SharedOplogReader. Like the tailable, awaitData cursor it replaces, it waits for more oplog
+ * entries to be inserted when it runs out of entries during an awaitData getMore.
+ */
+class DocumentSourceSharedOplogScan final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalSharedOplogScan"_sd;
+
+    /**
+     * Creates a stage which returns the oplog entries matching 'filter', as built by
+     * DocumentSourceChangeStream::buildMatchFilter() for the change stream in 'expCtx'.
+     */
+    static boost::intrusive_ptr<DocumentSourceSharedOplogScan> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx, BSONObj filter);
+
+    GetNextResult getNext() final;
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     ChangeStreamRequirement::kChangeStreamStage);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * The timestamp of the latest oplog entry examined, which may not have been returned.
+     */
+    Timestamp getLatestOplogTimestamp() const {
+        return _subscription.readThrough;
+    }
+
+private:
+    DocumentSourceSharedOplogScan(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                  BSONObj filter);
+
+    bool shouldWaitForInserts() const;
+
+    SharedOplogReader::Subscription _subscription;
+
+    // Oplog entries which matched, but which have not been returned yet.
+    std::deque<BSONObj> _matched;
+
+    // Held for the lifetime of the stage, so that its version advances as entries are inserted.
+    std::shared_ptr<CappedInsertNotifier> _notifier;
+};
+
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeFlatObject(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; ++i) {
+        const std::string fieldName = str::stream() << "field" << i;
+        if (i % 2) {
+            builder.append(fieldName, i);
+        } else {
+            builder.append(fieldName, "value" + fieldName);
+        }
+    }
+    return builder.obj();
+}
+
+void BM_DocumentFromBson(benchmark::State& state) {
+    const BSONObj obj = makeFlatObject(state.range(0));
+    for (auto keepRunning : state) {
+        Document doc(obj);
+        benchmark::DoNotOptimize(doc.getApproximateSize());
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_DocumentToBson(benchmark::State& state) {
+    const BSONObj obj = makeFlatObject(state.range(0));
+    const Document doc(obj);
+    for (auto keepRunning : state) {
+        BSONObj roundTripped = doc.toBson();
+        benchmark::DoNotOptimize(roundTripped.objdata());
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_DocumentGetField(benchmark::State& state) {
+    // Looks up the last field, which is the slowest case for the linear field search.
+    const int numFields = state.range(0);
+    const Document doc(makeFlatObject(numFields));
+    const std::string fieldName = str::stream() << "field" << (numFields - 1);
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(doc[fieldName]);
+    }
+}
+
+void BM_DocumentCompare(benchmark::State& state) {
+    // The documents differ only in their last field, so every field is compared.
+    const int numFields = state.range(0);
+    const Document lhs(makeFlatObject(numFields));
+    MutableDocument rhs(lhs);
+    rhs.setField(str::stream() << "field" << (numFields - 1), Value(-1));
+    const Document rhsDoc = rhs.freeze();
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(Document::compare(lhs, rhsDoc, nullptr));
+    }
+}
+
+void BM_ValueCompare(benchmark::State& state, Value lhs, Value rhs) {
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(Value::compare(lhs, rhs, nullptr));
+    }
+}
+
+BENCHMARK(BM_DocumentFromBson)->ArgName("fields")->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentToBson)->ArgName("fields")->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentGetField)->ArgName("fields")->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_DocumentCompare)->ArgName("fields")->Arg(1)->Arg(10)->Arg(100);
+
+BENCHMARK_CAPTURE(BM_ValueCompare, Int_Int, Value(1), Value(2));
+BENCHMARK_CAPTURE(BM_ValueCompare, Int_Double, Value(1), Value(1.5));
+BENCHMARK_CAPTURE(BM_ValueCompare, Long_Decimal, Value(1LL), Value(Decimal128("1.5")));
+BENCHMARK_CAPTURE(BM_ValueCompare,
+                  String_String,
+                  Value("a shared prefix then one"_sd),
+                  Value("a shared prefix then two"_sd));
+BENCHMARK_CAPTURE(BM_ValueCompare,
+                  Array_Array,
+                  Value(std::vector<Value>{Value(1), Value(2), Value(3)}),
+                  Value(std::vector<Value>{Value(1), Value(2), Value(4)}));
+
+}  // namespace
+}  // namespace mongo
@@ -111,6 +111,53 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, FromBsonLazily) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << BSON_ARRAY(1 << 2) << "d"
+                                                     << "str"));
+    Document eager = fromBson(bson);
+    Document lazy = Document::fromBsonWithMetaDataLazily(bson);
+
+    // The lazy document is backed by the BSON, so it is smaller than one which converted it.
+    ASSERT_LT(lazy.getApproximateSize(), eager.getApproximateSize());
+
+    ASSERT_EQUALS(2U, lazy.size());
+    ASSERT_VALUE_EQ(lazy["a"], Value(1));
+    ASSERT(lazy["e"].missing());
+    ASSERT_VALUE_EQ(lazy.getNestedField(FieldPath("b.d")), Value("str"_sd));
+    ASSERT_BSONOBJ_EQ(bson, toBson(lazy));
+    ASSERT_DOCUMENT_EQ(eager, lazy);
+
+    ASSERT_EQUALS("a", getNthField(lazy, 0).first.toString());
+    ASSERT_EQUALS("b", getNthField(lazy, 1).first.toString());
+    ASSERT_BSONOBJ_EQ(bson, toBson(lazy));
+}
+
+TEST(DocumentConstruction, ModifyingLazyDocumentLeavesOriginalUnchanged) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON("c" << 2));
+    Document lazy = Document::fromBsonWithMetaDataLazily(bson);
+
+    MutableDocument md(lazy);
+    md.setNestedField(FieldPath("b.c"), Value(3));
+    md.addField("d", Value(4));
+    Document modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(bson, toBson(lazy));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 3) << "d" << 4), toBson(modified));
+}
+
+TEST(DocumentConstruction, FromBsonLazilyParsesMetadata) {
+    Document lazy = Document::fromBsonWithMetaDataLazily(BSON("a" << 1 << "$textScore" << 2.0));
+    ASSERT_TRUE(lazy.hasTextScore());
+    ASSERT_EQUALS(2.0, lazy.getTextScore());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), toBson(lazy));
+
+    // Only top-level fields are treated as metadata.
+    BSONObj nested = BSON("a" << BSON("$textScore" << 2.0));
+    lazy = Document::fromBsonWithMetaDataLazily(nested);
+    ASSERT_FALSE(lazy.hasTextScore());
+    ASSERT_BSONOBJ_EQ(nested, toBson(lazy));
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
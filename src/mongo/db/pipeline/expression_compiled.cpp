@@ -0,0 +1,445 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_compiled.h"
+
+#include <limits>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+//
+// CompiledExpression::Scalar
+//
+
+bool CompiledExpression::Scalar::fromValue(const Value& value, Scalar* out) {
+    switch (value.getType()) {
+        case NumberInt:
+            out->type = NumberInt;
+            out->intValue = value.getInt();
+            return true;
+        case NumberLong:
+            out->type = NumberLong;
+            out->longValue = value.getLong();
+            return true;
+        case NumberDouble:
+            out->type = NumberDouble;
+            out->doubleValue = value.getDouble();
+            return true;
+        case Bool:
+            out->type = Bool;
+            out->boolValue = value.getBool();
+            return true;
+        default:
+            return false;
+    }
+}
+
+Value CompiledExpression::Scalar::toValue() const {
+    switch (type) {
+        case NumberInt:
+            return Value(intValue);
+        case NumberLong:
+            return Value(longValue);
+        case NumberDouble:
+            return Value(doubleValue);
+        case Bool:
+            return Value(boolValue);
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+bool CompiledExpression::Scalar::coerceToBool() const {
+    // Matches Value::coerceToBool().
+    switch (type) {
+        case NumberInt:
+            return intValue;
+        case NumberLong:
+            return longValue;
+        case NumberDouble:
+            return doubleValue;
+        case Bool:
+            return boolValue;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+long long CompiledExpression::Scalar::coerceToLong() const {
+    // Matches Value::coerceToLong().
+    switch (type) {
+        case NumberInt:
+            return static_cast<long long>(intValue);
+        case NumberLong:
+            return longValue;
+        case NumberDouble:
+            return static_cast<long long>(doubleValue);
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+double CompiledExpression::Scalar::coerceToDouble() const {
+    // Matches Value::coerceToDouble().
+    switch (type) {
+        case NumberInt:
+            return static_cast<double>(intValue);
+        case NumberLong:
+            return static_cast<double>(longValue);
+        case NumberDouble:
+            return doubleValue;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+namespace {
+
+// Sets 'out' to an int if 'value' fits in one and to a long otherwise, like
+// Value::createIntOrLong().
+template <typename ScalarType>
+void setIntOrLong(long long value, ScalarType* out) {
+    if (value > std::numeric_limits<int>::max() || value < std::numeric_limits<int>::min()) {
+        out->type = NumberLong;
+        out->longValue = value;
+    } else {
+        out->type = NumberInt;
+        out->intValue = static_cast<int>(value);
+    }
+}
+
+}  // namespace
+
+//
+// CompiledExpression
+//
+
+CompiledExpression::CompiledExpression(boost::intrusive_ptr<Expression> tree)
+    : _tree(std::move(tree)) {}
+
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(
+    boost::intrusive_ptr<Expression> expr) {
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression(std::move(expr)));
+
+    std::map<std::string, size_t> slotsBySpec;
+    compiled->compileNode(compiled->_tree, &slotsBySpec);
+    if (compiled->_nodes[0].type == NodeType::kConstant ||
+        compiled->_nodes[0].type == NodeType::kSlot) {
+        return nullptr;
+    }
+
+    compiled->_slotStates.resize(compiled->_slots.size());
+    return compiled;
+}
+
+size_t CompiledExpression::compileNode(const boost::intrusive_ptr<Expression>& expr,
+                                       std::map<std::string, size_t>* slotsBySpec) {
+    const size_t index = _nodes.size();
+    _nodes.emplace_back();
+
+    const ExpressionNary* nary = nullptr;
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr.get())) {
+        if (Scalar::fromValue(constant->getValue(), &_nodes[index].constant)) {
+            _nodes[index].type = NodeType::kConstant;
+            return index;
+        }
+    } else if ((nary = dynamic_cast<const ExpressionAdd*>(expr.get()))) {
+        _nodes[index].type = NodeType::kAdd;
+    } else if ((nary = dynamic_cast<const ExpressionSubtract*>(expr.get()))) {
+        _nodes[index].type = NodeType::kSubtract;
+    } else if ((nary = dynamic_cast<const ExpressionMultiply*>(expr.get()))) {
+        _nodes[index].type = NodeType::kMultiply;
+    } else if (auto compare = dynamic_cast<const ExpressionCompare*>(expr.get())) {
+        nary = compare;
+        _nodes[index].type = NodeType::kCompare;
+        _nodes[index].cmpOp = compare->getOp();
+    } else if ((nary = dynamic_cast<const ExpressionAnd*>(expr.get()))) {
+        _nodes[index].type = NodeType::kAnd;
+    } else if ((nary = dynamic_cast<const ExpressionOr*>(expr.get()))) {
+        _nodes[index].type = NodeType::kOr;
+    } else if ((nary = dynamic_cast<const ExpressionNot*>(expr.get()))) {
+        _nodes[index].type = NodeType::kNot;
+    } else if ((nary = dynamic_cast<const ExpressionCond*>(expr.get()))) {
+        _nodes[index].type = NodeType::kCond;
+    }
+
+    if (!nary) {
+        // Expressions are deterministic, so any two with the same serialization can share a slot.
+        const BSONObj spec = Document{{"", expr->serialize(false)}}.toBson();
+        const std::string key(spec.objdata(), spec.objsize());
+        auto it = slotsBySpec->find(key);
+        if (it == slotsBySpec->end()) {
+            it = slotsBySpec->emplace(key, _slots.size()).first;
+            _slots.push_back(expr);
+        }
+        _nodes[index].type = NodeType::kSlot;
+        _nodes[index].slot = it->second;
+        return index;
+    }
+
+    for (auto&& operand : nary->getOperandList()) {
+        // Compile into a local first, since compiling the operand may grow '_nodes'.
+        const size_t child = compileNode(operand, slotsBySpec);
+        _nodes[index].children.push_back(child);
+    }
+    return index;
+}
+
+Value CompiledExpression::evaluate(const Document& root) const {
+    for (auto&& slotState : _slotStates) {
+        slotState.state = SlotState::State::kUnevaluated;
+    }
+
+    Scalar result;
+    if (evaluateNode(0, root, &result)) {
+        return result.toValue();
+    }
+    return _tree->evaluate(root);
+}
+
+bool CompiledExpression::evaluateNode(size_t index, const Document& root, Scalar* out) const {
+    const Node& node = _nodes[index];
+    switch (node.type) {
+        case NodeType::kConstant:
+            *out = node.constant;
+            return true;
+        case NodeType::kSlot:
+            return evaluateSlot(node.slot, root, out);
+        case NodeType::kAdd:
+            return evaluateAdd(node, root, out);
+        case NodeType::kSubtract:
+            return evaluateSubtract(node, root, out);
+        case NodeType::kMultiply:
+            return evaluateMultiply(node, root, out);
+        case NodeType::kCompare:
+            return evaluateCompare(node, root, out);
+        case NodeType::kAnd:
+        case NodeType::kOr: {
+            // Like the interpreter, stop at the first operand which decides the result.
+            const bool isAnd = node.type == NodeType::kAnd;
+            Scalar operand;
+            for (auto child : node.children) {
+                if (!evaluateNode(child, root, &operand)) {
+                    return false;
+                }
+                if (operand.coerceToBool() != isAnd) {
+                    break;
+                }
+            }
+            out->type = Bool;
+            out->boolValue = node.children.empty() ? isAnd : operand.coerceToBool();
+            return true;
+        }
+        case NodeType::kNot: {
+            Scalar operand;
+            if (!evaluateNode(node.children[0], root, &operand)) {
+                return false;
+            }
+            out->type = Bool;
+            out->boolValue = !operand.coerceToBool();
+            return true;
+        }
+        case NodeType::kCond: {
+            Scalar condition;
+            if (!evaluateNode(node.children[0], root, &condition)) {
+                return false;
+            }
+            return evaluateNode(node.children[condition.coerceToBool() ? 1 : 2], root, out);
+        }
+    }
+    MONGO_UNREACHABLE;
+}
+
+bool CompiledExpression::evaluateSlot(size_t slot, const Document& root, Scalar* out) const {
+    SlotState& slotState = _slotStates[slot];
+    if (slotState.state == SlotState::State::kUnevaluated) {
+        slotState.state = Scalar::fromValue(_slots[slot]->evaluate(root), &slotState.value)
+            ? SlotState::State::kScalar
+            : SlotState::State::kNotScalar;
+    }
+
+    if (slotState.state == SlotState::State::kNotScalar) {
+        return false;
+    }
+    *out = slotState.value;
+    return true;
+}
+
+bool CompiledExpression::evaluateAdd(const Node& node, const Document& root, Scalar* out) const {
+    // Mirrors ExpressionAdd::evaluate() for operands which are all int, long or double.
+    DoubleDoubleSummation total;
+    BSONType totalType = NumberInt;
+
+    Scalar operand;
+    for (auto child : node.children) {
+        if (!evaluateNode(child, root, &operand) || !operand.isNumber()) {
+            return false;
+        }
+        switch (operand.type) {
+            case NumberDouble:
+                total.addDouble(operand.doubleValue);
+                totalType = NumberDouble;
+                break;
+            case NumberLong:
+                total.addLong(operand.longValue);
+                if (totalType == NumberInt)
+                    totalType = NumberLong;
+                break;
+            case NumberInt:
+                total.addDouble(operand.intValue);
+                break;
+            default:
+                MONGO_UNREACHABLE;
+        }
+    }
+
+    if (totalType == NumberLong && total.fitsLong()) {
+        out->type = NumberLong;
+        out->longValue = total.getLong();
+    } else if (totalType != NumberDouble && total.fitsLong()) {
+        setIntOrLong(total.getLong(), out);
+    } else {
+        out->type = NumberDouble;
+        out->doubleValue = total.getDouble();
+    }
+    return true;
+}
+
+bool CompiledExpression::evaluateSubtract(const Node& node,
+                                          const Document& root,
+                                          Scalar* out) const {
+    // Mirrors ExpressionSubtract::evaluate() for int, long and double operands.
+    Scalar lhs;
+    Scalar rhs;
+    if (!evaluateNode(node.children[0], root, &lhs) ||
+        !evaluateNode(node.children[1], root, &rhs) || !lhs.isNumber() || !rhs.isNumber()) {
+        return false;
+    }
+
+    const BSONType diffType = Value::getWidestNumeric(rhs.type, lhs.type);
+    if (diffType == NumberDouble) {
+        out->type = NumberDouble;
+        out->doubleValue = lhs.coerceToDouble() - rhs.coerceToDouble();
+    } else if (diffType == NumberLong) {
+        out->type = NumberLong;
+        out->longValue = lhs.coerceToLong() - rhs.coerceToLong();
+    } else {
+        setIntOrLong(lhs.coerceToLong() - rhs.coerceToLong(), out);
+    }
+    return true;
+}
+
+bool CompiledExpression::evaluateMultiply(const Node& node,
+                                          const Document& root,
+                                          Scalar* out) const {
+    // Mirrors ExpressionMultiply::evaluate() for operands which are all int, long or double.
+    double doubleProduct = 1;
+    long long longProduct = 1;
+    BSONType productType = NumberInt;
+
+    Scalar operand;
+    for (auto child : node.children) {
+        if (!evaluateNode(child, root, &operand) || !operand.isNumber()) {
+            return false;
+        }
+        productType = Value::getWidestNumeric(productType, operand.type);
+        doubleProduct *= operand.coerceToDouble();
+        if (mongoSignedMultiplyOverflow64(longProduct, operand.coerceToLong(), &longProduct)) {
+            // The 'longProduct' would have overflowed, so we're abandoning it.
+            productType = NumberDouble;
+        }
+    }
+
+    if (productType == NumberDouble) {
+        out->type = NumberDouble;
+        out->doubleValue = doubleProduct;
+    } else if (productType == NumberLong) {
+        out->type = NumberLong;
+        out->longValue = longProduct;
+    } else {
+        setIntOrLong(longProduct, out);
+    }
+    return true;
+}
+
+bool CompiledExpression::evaluateCompare(const Node& node,
+                                         const Document& root,
+                                         Scalar* out) const {
+    Scalar lhs;
+    Scalar rhs;
+    if (!evaluateNode(node.children[0], root, &lhs) ||
+        !evaluateNode(node.children[1], root, &rhs)) {
+        return false;
+    }
+
+    // Numbers and booleans are stored inline in a Value, so boxing them here is cheap and keeps
+    // the comparison semantics, including those of NaN and of mixed types, in one place. The
+    // collation only applies to strings, so none is needed.
+    int cmp = Value::compare(lhs.toValue(), rhs.toValue(), nullptr);
+    cmp = cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+
+    if (node.cmpOp == ExpressionCompare::CMP) {
+        out->type = NumberInt;
+        out->intValue = cmp;
+        return true;
+    }
+
+    out->type = Bool;
+    switch (node.cmpOp) {
+        case ExpressionCompare::EQ:
+            out->boolValue = cmp == 0;
+            break;
+        case ExpressionCompare::NE:
+            out->boolValue = cmp != 0;
+            break;
+        case ExpressionCompare::GT:
+            out->boolValue = cmp > 0;
+            break;
+        case ExpressionCompare::GTE:
+            out->boolValue = cmp >= 0;
+            break;
+        case ExpressionCompare::LT:
+            out->boolValue = cmp < 0;
+            break;
+        case ExpressionCompare::LTE:
+            out->boolValue = cmp <= 0;
+            break;
+        default:
+            MONGO_UNREACHABLE;
+    }
+    return true;
+}
+
+}  // namespace mongo
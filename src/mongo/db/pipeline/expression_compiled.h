@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsontypes.h"
+#include "mongo/db/pipeline/expression.h"
+
+namespace mongo {
+
+/**
+ * A compiled form of an arithmetic or boolean expression tree, built once when the pipeline is
+ * optimized.
+ *
+ * The operators $add, $subtract, $multiply, $and, $or, $not, $cond and the comparison operators are
+ * compiled into a flat array of nodes whose intermediate results are kept as unboxed numbers and
+ * booleans. Every other subexpression, such as a field path or an operator with no compiled form,
+ * becomes a slot. Identical slots are shared, and each slot is evaluated by the tree interpreter at
+ * most once per call to evaluate().
+ *
+ * Whenever a slot produces something other than a number or a boolean, the whole expression is
+ * handed back to the tree interpreter, so the result is always the same as that of
+ * Expression::evaluate().
+ */
+class CompiledExpression {
+    MONGO_DISALLOW_COPYING(CompiledExpression);
+
+public:
+    /**
+     * Returns nullptr if the root of 'expr' has no compiled form, in which case there is nothing
+     * gained over calling 'expr->evaluate()' directly.
+     */
+    static std::unique_ptr<CompiledExpression> compile(boost::intrusive_ptr<Expression> expr);
+
+    Value evaluate(const Document& root) const;
+
+    size_t numNodes() const {
+        return _nodes.size();
+    }
+
+    size_t numSlots() const {
+        return _slots.size();
+    }
+
+private:
+    /**
+     * An unboxed intermediate result.
+     */
+    struct Scalar {
+        static bool fromValue(const Value& value, Scalar* out);
+
+        Value toValue() const;
+        bool coerceToBool() const;
+        long long coerceToLong() const;
+        double coerceToDouble() const;
+
+        bool isNumber() const {
+            return type == NumberInt || type == NumberLong || type == NumberDouble;
+        }
+
+        BSONType type = NumberInt;
+        union {
+            int intValue;
+            long long longValue;
+            double doubleValue;
+            bool boolValue;
+        };
+    };
+
+    enum class NodeType {
+        kConstant,
+        kSlot,
+        kAdd,
+        kSubtract,
+        kMultiply,
+        kCompare,
+        kAnd,
+        kOr,
+        kNot,
+        kCond,
+    };
+
+    struct Node {
+        NodeType type;
+
+        // Set for kConstant.
+        Scalar constant;
+
+        // Set for kSlot.
+        size_t slot = 0;
+
+        // Set for kCompare.
+        ExpressionCompare::CmpOp cmpOp = ExpressionCompare::EQ;
+
+        // Indexes into '_nodes' of the operands of an operator.
+        std::vector<size_t> children;
+    };
+
+    struct SlotState {
+        enum class State { kUnevaluated, kScalar, kNotScalar };
+
+        State state = State::kUnevaluated;
+        Scalar value;
+    };
+
+    explicit CompiledExpression(boost::intrusive_ptr<Expression> tree);
+
+    /**
+     * Appends the node for 'expr', and recursively the nodes of its operands, to '_nodes'. Returns
+     * the index of the node for 'expr'. 'slotsBySpec' maps the serialized form of each slot
+     * expression seen so far to its slot.
+     */
+    size_t compileNode(const boost::intrusive_ptr<Expression>& expr,
+                       std::map<std::string, size_t>* slotsBySpec);
+
+    /**
+     * Evaluates the node at 'index' into 'out'. Returns false if some operand was not a number or a
+     * boolean, or was of a type the operator does not accept, in which case the caller must fall
+     * back to the tree interpreter.
+     */
+    bool evaluateNode(size_t index, const Document& root, Scalar* out) const;
+
+    bool evaluateSlot(size_t slot, const Document& root, Scalar* out) const;
+    bool evaluateAdd(const Node& node, const Document& root, Scalar* out) const;
+    bool evaluateSubtract(const Node& node, const Document& root, Scalar* out) const;
+    bool evaluateMultiply(const Node& node, const Document& root, Scalar* out) const;
+    bool evaluateCompare(const Node& node, const Document& root, Scalar* out) const;
+
+    // The expression this was compiled from, used whenever the compiled form cannot produce the
+    // result.
+    const boost::intrusive_ptr<Expression> _tree;
+
+    // The root node is always at index 0.
+    std::vector<Node> _nodes;
+    std::vector<boost::intrusive_ptr<Expression>> _slots;
+
+    // Scratch space holding the slot values of the current call to evaluate(). A pipeline, and so
+    // its expressions, is only ever used by one thread at a time.
+    mutable std::vector<SlotState> _slotStates;
+};
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_compiled.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+class CompiledExpressionTest : public AggregationContextFixture {
+protected:
+    intrusive_ptr<Expression> parse(const BSONObj& spec) {
+        auto expCtx = getExpCtx();
+        return Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState)
+            ->optimize();
+    }
+
+    /**
+     * Asserts that the compiled form of 'expr' produces the same value, of the same type, or fails
+     * with the same error as 'expr' itself for each of 'inputs'.
+     */
+    void assertSameResults(const intrusive_ptr<Expression>& expr,
+                           const std::vector<Document>& inputs) {
+        auto compiled = CompiledExpression::compile(expr);
+        ASSERT(compiled);
+        for (auto&& input : inputs) {
+            Value expected;
+            try {
+                expected = expr->evaluate(input);
+            } catch (const DBException& ex) {
+                ASSERT_THROWS_CODE(compiled->evaluate(input), AssertionException, ex.code());
+                continue;
+            }
+            const Value actual = compiled->evaluate(input);
+            ASSERT_VALUE_EQ(actual, expected);
+            ASSERT_EQ(actual.getType(), expected.getType()) << input.toString();
+        }
+    }
+
+    const std::vector<Document> kNumericInputs = {
+        Document{{"a", 3}, {"b", 4}},
+        Document{{"a", 3}, {"b", 4.5}},
+        Document{{"a", 3LL}, {"b", 4}},
+        Document{{"a", std::numeric_limits<int>::max()}, {"b", 2}},
+        Document{{"a", std::numeric_limits<long long>::max()}, {"b", 2LL}},
+        Document{{"a", std::numeric_limits<double>::quiet_NaN()}, {"b", 1}},
+        Document{{"a", -0.5}, {"b", true}},
+        Document{{"a", 1}, {"b", BSONNULL}},
+        Document{{"a", 1}},
+        Document{{"a", Decimal128("1.5")}, {"b", 2}},
+        Document{{"a", 1}, {"b", Document{{"c", 1}}}},
+    };
+};
+
+TEST_F(CompiledExpressionTest, FieldPathsConstantsAndUnsupportedOperatorsAreNotCompiled) {
+    ASSERT_FALSE(CompiledExpression::compile(parse(fromjson("{'': '$a'}"))));
+    ASSERT_FALSE(CompiledExpression::compile(parse(fromjson("{'': {$add: [1, 2]}}"))));
+    ASSERT_FALSE(CompiledExpression::compile(parse(fromjson("{'': {$abs: '$a'}}"))));
+}
+
+TEST_F(CompiledExpressionTest, ArithmeticMatchesInterpreter) {
+    assertSameResults(parse(fromjson("{'': {$add: ['$a', '$b']}}")), kNumericInputs);
+    assertSameResults(parse(fromjson("{'': {$subtract: ['$a', '$b']}}")), kNumericInputs);
+    assertSameResults(parse(fromjson("{'': {$multiply: ['$a', '$b']}}")), kNumericInputs);
+    assertSameResults(
+        parse(fromjson("{'': {$add: [{$multiply: ['$a', '$b', 2]}, {$subtract: ['$a', 1]}]}}")),
+        kNumericInputs);
+}
+
+TEST_F(CompiledExpressionTest, BooleansAndComparisonsMatchInterpreter) {
+    assertSameResults(parse(fromjson("{'': {$gt: ['$a', '$b']}}")), kNumericInputs);
+    assertSameResults(parse(fromjson("{'': {$cmp: ['$a', '$b']}}")), kNumericInputs);
+    assertSameResults(parse(fromjson("{'': {$and: [{$lte: ['$a', 3]}, {$ne: ['$b', 4]}]}}")),
+                      kNumericInputs);
+    assertSameResults(parse(fromjson("{'': {$or: [{$eq: ['$a', 3]}, {$not: ['$b']}]}}")),
+                      kNumericInputs);
+    assertSameResults(
+        parse(fromjson("{'': {$cond: [{$gte: ['$a', 3]}, {$add: ['$a', 1]}, '$b']}}")),
+        kNumericInputs);
+}
+
+TEST_F(CompiledExpressionTest, IdenticalSubexpressionsShareASlot) {
+    auto compiled = CompiledExpression::compile(parse(
+        fromjson("{'': {$add: ['$a', '$a', {$multiply: ['$a', '$b']}, {$abs: '$b'}, "
+                 "{$abs: '$b'}]}}")));
+    ASSERT(compiled);
+    ASSERT_EQ(compiled->numSlots(), 3U);
+    ASSERT_VALUE_EQ(compiled->evaluate(Document{{"a", 2}, {"b", -3}}), Value(4));
+}
+
+TEST_F(CompiledExpressionTest, UnsupportedOperandFallsBackToInterpreter) {
+    auto compiled = CompiledExpression::compile(parse(fromjson("{'': {$add: ['$a', '$s']}}")));
+    ASSERT(compiled);
+    ASSERT_VALUE_EQ(compiled->evaluate(Document{{"a", 1}, {"s", BSONNULL}}), Value(BSONNULL));
+    ASSERT_THROWS_CODE(compiled->evaluate(Document{{"a", 1}, {"s", "str"_sd}}),
+                       AssertionException,
+                       16554);
+}
+
+TEST_F(CompiledExpressionTest, LogicalOperatorsShortCircuit) {
+    auto compiled = CompiledExpression::compile(
+        parse(fromjson("{'': {$or: [{$gt: ['$a', 0]}, {$gt: [{$add: ['$a', '$s']}, 0]}]}}")));
+    ASSERT(compiled);
+    ASSERT_VALUE_EQ(compiled->evaluate(Document{{"a", 1}, {"s", "str"_sd}}), Value(true));
+    ASSERT_THROWS_CODE(compiled->evaluate(Document{{"a", -1}, {"s", "str"_sd}}),
+                       AssertionException,
+                       16554);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -77,4 +77,45 @@ std::vector<BSONObj> MongoProcessCommon::getCurrentOps(OperationContext* opCtx,
     return ops;
 }
 
+std::vector<boost::optional<Document>> MongoProcessCommon::matchDocumentKeys(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const std::vector<Document>& documentKeys,
+    const std::vector<Document>& documents) {
+    // Every document key has an _id, so only the keys with the same _id need to be compared.
+    auto keysById = expCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    for (size_t i = 0; i < documentKeys.size(); ++i) {
+        keysById[documentKeys[i]["_id"]].push_back(i);
+    }
+
+    std::vector<boost::optional<Document>> results(documentKeys.size());
+    for (auto&& document : documents) {
+        auto candidates = keysById.find(document["_id"]);
+        if (candidates == keysById.end()) {
+            continue;
+        }
+        for (auto i : candidates->second) {
+            bool matchesKey = true;
+            for (auto it = documentKeys[i].fieldIterator(); matchesKey && it.more();) {
+                auto field = it.next();
+                matchesKey = expCtx->getValueComparator().evaluate(
+                    document.getNestedField(FieldPath(field.first)) == field.second);
+            }
+            if (!matchesKey) {
+                continue;
+            }
+            uassert(ErrorCodes::TooManyMatchingDocuments,
+                    str::stream() << "found more than one document with document key "
+                                  << documentKeys[i].toString()
+                                  << " ["
+                                  << results[i]->toString()
+                                  << ", "
+                                  << document.toString()
+                                  << "]",
+                    !results[i]);
+            results[i] = document;
+        }
+    }
+    return results;
+}
+
 }  // namespace mongo
@@ -31,6 +31,8 @@
 #include <vector>
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/mongo_process_interface.h"
 
 namespace mongo {
@@ -49,6 +51,16 @@ public:
                                        CurrentOpUserMode userMode,
                                        CurrentOpTruncateMode) const final;
 
+    /**
+     * Returns, for each of the 'documentKeys' in turn, the document among 'documents' which has
+     * all of the key's fields, comparing them using the collation of 'expCtx'. Throws
+     * TooManyMatchingDocuments if more than one of the 'documents' has the same key.
+     */
+    static std::vector<boost::optional<Document>> matchDocumentKeys(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const std::vector<Document>& documentKeys,
+        const std::vector<Document>& documents);
+
 protected:
     /**
      * Returns a BSONObj representing a report of the operation which is currently being
@@ -205,6 +205,18 @@ public:
         const Document& documentKey,
         boost::optional<BSONObj> readConcern) = 0;
 
+    /**
+     * Looks up the document with each of the 'documentKeys' as lookupSingleDocument() does, but
+     * with a single query per shard rather than one per key. Returns the result for each key, in
+     * the same order as 'documentKeys'.
+     */
+    virtual std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern) = 0;
+
     /**
      * Returns a vector of all local cursors.
      */
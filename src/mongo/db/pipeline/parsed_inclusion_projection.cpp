@@ -32,6 +32,8 @@
 
 #include <algorithm>
 
+#include "mongo/db/query/query_knobs.h"
+
 namespace mongo {
 
 namespace parsed_aggregation_projection {
@@ -46,8 +48,16 @@ using std::unique_ptr;
 InclusionNode::InclusionNode(std::string pathToNode) : _pathToNode(std::move(pathToNode)) {}
 
 void InclusionNode::optimize() {
+    const bool compileExpressions = internalQueryCompileAggregationExpressions.load();
+    _compiledExpressions.clear();
     for (auto&& expressionIt : _expressions) {
         _expressions[expressionIt.first] = expressionIt.second->optimize();
+        if (!compileExpressions) {
+            continue;
+        }
+        if (auto compiled = CompiledExpression::compile(_expressions[expressionIt.first])) {
+            _compiledExpressions[expressionIt.first] = std::move(compiled);
+        }
     }
     for (auto&& childPair : _children) {
         childPair.second->optimize();
@@ -148,6 +158,11 @@ void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document
             outputDoc->setField(field,
                                 childIt->second->addComputedFields(outputDoc->peek()[field], root));
         } else {
+            auto compiledIt = _compiledExpressions.find(field);
+            if (compiledIt != _compiledExpressions.end()) {
+                outputDoc->setField(field, compiledIt->second->evaluate(root));
+                continue;
+            }
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
             outputDoc->setField(field, expressionIt->second->evaluate(root));
@@ -193,6 +208,7 @@ bool InclusionNode::subtreeContainsComputedFields() const {
 void InclusionNode::addComputedField(const FieldPath& path, boost::intrusive_ptr<Expression> expr) {
     if (path.getPathLength() == 1) {
         auto fieldName = path.fullPath();
+        _compiledExpressions.erase(fieldName);
         _expressions[fieldName] = expr;
         _orderToProcessAdditionsAndChildren.push_back(fieldName);
         return;
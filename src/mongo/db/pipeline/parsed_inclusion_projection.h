@@ -31,6 +31,7 @@
 #include <memory>
 
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_compiled.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 #include "mongo/stdx/memory.h"
@@ -55,7 +56,8 @@ public:
     InclusionNode(std::string pathToNode = "");
 
     /**
-     * Optimize any computed expressions.
+     * Optimize any computed expressions, compiling those which have a compiled form if
+     * 'internalQueryCompileAggregationExpressions' is enabled.
      */
     void optimize();
 
@@ -171,6 +173,9 @@ private:
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
     stdx::unordered_set<std::string> _inclusions;
 
+    // Compiled forms of the entries of '_expressions' which have one, built by optimize().
+    stdx::unordered_map<std::string, std::unique_ptr<CompiledExpression>> _compiledExpressions;
+
     // TODO use StringMap once SERVER-23700 is resolved.
     stdx::unordered_map<std::string, std::unique_ptr<InclusionNode>> _children;
 };
@@ -57,18 +57,24 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
+#include "mongo/db/pipeline/document_source_parallel.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
+#include "mongo/db/pipeline/document_source_shared_oplog_scan.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -312,6 +318,16 @@ void PipelineD::prepareCursorSource(Collection* collection,
                 return;
             }
         }
+
+        // A change stream may read the oplog through the reader shared by all change streams,
+        // rather than with a cursor of its own.
+        auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(sources.front().get());
+        if (oplogMatch && internalChangeStreamSharedOplogBufferBytes.load() > 0) {
+            auto scan = DocumentSourceSharedOplogScan::create(expCtx, oplogMatch->getQuery());
+            sources.pop_front();
+            pipeline->addInitialSource(std::move(scan));
+            return;
+        }
     }
 
     // If the first stage is $geoNear, prepare a special DocumentSourceGeoNearCursor stage;
@@ -662,11 +678,67 @@ void PipelineD::addCursorSource(Pipeline* pipeline,
     pipeline->addInitialSource(std::move(cursor));
 }
 
+void PipelineD::parallelizePipeline(Pipeline* pipeline, size_t numConsumers) {
+    auto expCtx = pipeline->getContext();
+    auto& sources = pipeline->_sources;
+
+    // The consumers run on their own OperationContexts, which cannot take part in a transaction,
+    // and an explain or a pipeline whose output is merged elsewhere should not change shape.
+    if (numConsumers < 2 || expCtx->explain || expCtx->fromMongos || expCtx->needsMerge ||
+        expCtx->inMultiDocumentTransaction || expCtx->tailableMode != TailableModeEnum::kNormal) {
+        return;
+    }
+
+    if (sources.empty() || !dynamic_cast<DocumentSourceCursor*>(sources.front().get()) ||
+        dynamic_cast<DocumentSourceExchange*>(sources.back().get())) {
+        return;
+    }
+
+    // Only stages which handle each document independently of the others may run on a share of
+    // the input.
+    auto groupIt = std::next(sources.begin());
+    for (; groupIt != sources.end(); ++groupIt) {
+        auto stage = groupIt->get();
+        if (dynamic_cast<DocumentSourceGroup*>(stage)) {
+            break;
+        }
+
+        auto match = dynamic_cast<DocumentSourceMatch*>(stage);
+        if (!(match && !match->isTextQuery()) &&
+            !dynamic_cast<DocumentSourceSingleDocumentTransformation*>(stage) &&
+            !dynamic_cast<DocumentSourceUnwind*>(stage)) {
+            return;
+        }
+    }
+
+    if (groupIt == sources.end()) {
+        return;
+    }
+
+    auto group = static_cast<DocumentSourceGroup*>(groupIt->get());
+    auto mergeSources = group->getMergeSources();
+
+    const auto subPipelineEnd = std::next(groupIt);
+    auto parallel = DocumentSourceParallel::create(
+        expCtx,
+        Pipeline::SourceContainer(std::next(sources.begin()), subPipelineEnd),
+        numConsumers);
+
+    auto insertPos = sources.erase(std::next(sources.begin()), subPipelineEnd);
+    sources.insert(insertPos, std::move(parallel));
+    sources.splice(insertPos, mergeSources);
+    pipeline->stitch();
+}
+
 Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
     if (auto docSourceCursor =
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto oplogScan =
+            dynamic_cast<DocumentSourceSharedOplogScan*>(pipeline->_sources.front().get())) {
+        return oplogScan->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 
@@ -735,14 +807,26 @@ CollectionIndexUsageMap PipelineD::MongoDInterface::getIndexStats(OperationConte
         return CollectionIndexUsageMap();
     }
 
-    return collection->infoCache()->getIndexUsageStats();
+    CollectionIndexUsageMap stats = collection->infoCache()->getIndexUsageStats();
+    for (auto&& indexStats : stats) {
+        const IndexDescriptor* desc =
+            collection->getIndexCatalog()->findIndexByName(opCtx, indexStats.first);
+        if (!desc) {
+            continue;
+        }
+        BSONObjBuilder builder;
+        collection->getIndexCatalog()->getIndex(desc)->appendIndexStats(&builder);
+        indexStats.second.storageStats = builder.obj();
+    }
+    return stats;
 }
 
 void PipelineD::MongoDInterface::appendLatencyStats(OperationContext* opCtx,
                                                     const NamespaceString& nss,
                                                     bool includeHistograms,
                                                     BSONObjBuilder* builder) const {
-    Top::get(opCtx->getServiceContext()).appendLatencyStats(nss.ns(), includeHistograms, builder);
+    Top::get(opCtx->getServiceContext())
+        .appendLatencyStats(opCtx, nss.ns(), includeHistograms, builder);
 }
 
 Status PipelineD::MongoDInterface::appendStorageStats(OperationContext* opCtx,
@@ -953,6 +1037,40 @@ boost::optional<Document> PipelineD::MongoDInterface::lookupSingleDocument(
     return lookedUpDocument;
 }
 
+std::vector<boost::optional<Document>> PipelineD::MongoDInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern) {
+    invariant(!readConcern);  // As for lookupSingleDocument().
+
+    BSONArrayBuilder keys;
+    for (auto&& documentKey : documentKeys) {
+        keys.append(documentKey.toBson());
+    }
+
+    boost::intrusive_ptr<ExpressionContext> foreignExpCtx;
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        // Be sure to do the lookup using the collection default collation.
+        foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        pipeline = uassertStatusOK(
+            makePipeline({BSON("$match" << BSON("$or" << keys.arr()))}, foreignExpCtx));
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<boost::optional<Document>>(documentKeys.size());
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+    return matchDocumentKeys(foreignExpCtx, documentKeys, lookedUpDocuments);
+}
+
 BSONObj PipelineD::MongoDInterface::_reportCurrentOpForClient(
     OperationContext* opCtx, Client* client, CurrentOpTruncateMode truncateOps) const {
     BSONObjBuilder builder;
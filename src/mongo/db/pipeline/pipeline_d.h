@@ -107,6 +107,12 @@ public:
             UUID collectionUUID,
             const Document& documentKey,
             boost::optional<BSONObj> readConcern) final;
+        std::vector<boost::optional<Document>> lookupDocuments(
+            const boost::intrusive_ptr<ExpressionContext>& expCtx,
+            const NamespaceString& nss,
+            UUID collectionUUID,
+            const std::vector<Document>& documentKeys,
+            boost::optional<BSONObj> readConcern) final;
         std::vector<GenericCursor> getCursors(
             const boost::intrusive_ptr<ExpressionContext>& expCtx) const final;
 
@@ -177,6 +183,15 @@ public:
      */
     static void injectMongodInterface(Pipeline* pipeline);
 
+    /**
+     * If 'pipeline' reads from a $cursor and its first $group is only preceded by stages which
+     * handle each document on its own, replaces those stages and the $group with a
+     * DocumentSourceParallel which runs them on 'numConsumers' threads, followed by the stages
+     * which merge the partial groups. Otherwise, or if 'numConsumers' is less than 2, does nothing.
+     * Must be called after prepareCursorSource() and the final optimization of 'pipeline'.
+     */
+    static void parallelizePipeline(Pipeline* pipeline, size_t numConsumers);
+
     static std::string getPlanSummaryStr(const Pipeline* pipeline);
 
     static void getPlanSummaryStats(const Pipeline* pipeline, PlanSummaryStats* statsOut);
@@ -716,6 +716,104 @@ TEST(PipelineOptimizationTest, UnwindBeforeDoubleMatchShouldRepeatedlyOptimize)
     assertPipelineOptimizesTo(inputPipe, outputPipe);
 }
 
+TEST(PipelineOptimizationTest, SortSkipAndLimitShouldMoveBeforeLookup) {
+    string inputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$sort: {date: -1}}"
+        ",{$skip: 10}"
+        ",{$limit: 5}"
+        "]";
+    string outputPipe =
+        "[{$sort: {sortKey: {date: -1}, limit: 15}}"
+        ",{$skip: 10}"
+        ",{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        "]";
+    string serializedPipe =
+        "[{$sort: {date: -1}}"
+        ",{$limit: 15}"
+        ",{$skip: 10}"
+        ",{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        "]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
+TEST(PipelineOptimizationTest, LimitShouldMoveBeforeSeveralLookups) {
+    string inputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'a', localField: 'left', foreignField: 'right'}}"
+        ",{$lookup: {from : 'lookupColl', as : 'b', localField: 'left', foreignField: 'right'}}"
+        ",{$limit: 5}"
+        "]";
+    string outputPipe =
+        "[{$limit: 5}"
+        ",{$lookup: {from : 'lookupColl', as : 'a', localField: 'left', foreignField: 'right'}}"
+        ",{$lookup: {from : 'lookupColl', as : 'b', localField: 'left', foreignField: 'right'}}"
+        "]";
+    assertPipelineOptimizesTo(inputPipe, outputPipe);
+}
+
+TEST(PipelineOptimizationTest, SortOnAsFieldShouldNotMoveBeforeLookup) {
+    string inputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$sort: {'same.date': -1}}"
+        ",{$limit: 5}"
+        "]";
+    string outputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$sort: {sortKey: {'same.date': -1}, limit: 5}}"
+        "]";
+    string serializedPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$sort: {'same.date': -1}}"
+        ",{$limit: 5}"
+        "]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
+TEST(PipelineOptimizationTest, LimitShouldNotMoveBeforeLookupWithAbsorbedUnwind) {
+    string inputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$unwind: {path: '$same'}}"
+        ",{$limit: 5}"
+        "]";
+    string outputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right', unwinding: {preserveNullAndEmptyArrays: false}}}"
+        ",{$limit: 5}"
+        "]";
+    string serializedPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$unwind: {path: '$same'}}"
+        ",{$limit: 5}"
+        "]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
+TEST(PipelineOptimizationTest, SortAndLimitShouldMoveBeforeGraphLookup) {
+    string inputPipe =
+        "[{$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
+        "                 connectFromField: 'c', startWith: '$d'}}, "
+        " {$sort: {e: 1}}, "
+        " {$limit: 5}]";
+    string outputPipe =
+        "[{$sort: {sortKey: {e: 1}, limit: 5}}, "
+        " {$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
+        "                 connectFromField: 'c', startWith: '$d'}}]";
+    string serializedPipe =
+        "[{$sort: {e: 1}}, "
+        " {$limit: 5}, "
+        " {$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
+        "                 connectFromField: 'c', startWith: '$d'}}]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
 TEST(PipelineOptimizationTest, GraphLookupShouldCoalesceWithUnwindOnAs) {
     string inputPipe =
         "[{$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
@@ -30,8 +30,6 @@
 
 #include "mongo/db/pipeline/tee_buffer.h"
 
-#include <algorithm>
-
 #include "mongo/db/pipeline/document.h"
 
 namespace mongo {
@@ -49,12 +47,7 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
-    size_t nConsumersStillProcessingThisBatch =
-        std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-            return info.nLeftToReturn > 0;
-        });
-
-    if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
+    if (_buffer.empty() || _nConsumersStillProcessingBatch == 0) {
         loadNextBatch();
     }
 
@@ -70,13 +63,16 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     }
 
     const size_t bufferIndex = _buffer.size() - _consumers[consumerId].nLeftToReturn;
-    --_consumers[consumerId].nLeftToReturn;
+    if (--_consumers[consumerId].nLeftToReturn == 0) {
+        --_nConsumersStillProcessingBatch;
+    }
 
     return _buffer[bufferIndex];
 }
 
 void TeeBuffer::loadNextBatch() {
     _buffer.clear();
+    _nConsumersStillProcessingBatch = 0;
     size_t bytesInBuffer = 0;
 
     auto input = _source->getNext();
@@ -99,6 +95,9 @@ void TeeBuffer::loadNextBatch() {
     for (size_t consumerId = 0; consumerId < _consumers.size(); ++consumerId) {
         if (_consumers[consumerId].stillInUse) {
             _consumers[consumerId].nLeftToReturn = _buffer.size();
+            if (!_buffer.empty()) {
+                ++_nConsumersStillProcessingBatch;
+            }
         }
     }
 }
@@ -63,6 +63,9 @@ public:
      * consumer will not consume all input.
      */
     void dispose(size_t consumerId) {
+        if (_consumers[consumerId].nLeftToReturn > 0) {
+            --_nConsumersStillProcessingBatch;
+        }
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
@@ -102,5 +105,10 @@ private:
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // The number of consumers with results from the current batch left to return. This is kept up
+    // to date rather than counted on each call so that small batches stay cheap with many
+    // consumers.
+    size_t _nConsumersStillProcessingBatch = 0;
 };
 }  // namespace mongo
@@ -286,6 +286,36 @@ bool CanonicalQuery::isSimpleIdQuery(const BSONObj& query) {
     return hasID;
 }
 
+// static
+bool CanonicalQuery::isSimpleIdInQuery(const BSONObj& query) {
+    if (query.nFields() != 1) {
+        return false;
+    }
+
+    BSONElement idElt = query.firstElement();
+    if (!str::equals("_id", idElt.fieldName()) || idElt.type() != Object) {
+        return false;
+    }
+
+    BSONObj predicate = idElt.Obj();
+    if (predicate.nFields() != 1) {
+        return false;
+    }
+
+    BSONElement inElt = predicate.firstElement();
+    if (!str::equals("$in", inElt.fieldName()) || inElt.type() != Array) {
+        return false;
+    }
+
+    for (auto&& elt : inElt.Obj()) {
+        if (!Indexability::isExactBoundsGenerating(elt)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // static
 void CanonicalQuery::sortTree(MatchExpression* tree) {
     for (size_t i = 0; i < tree->numChildren(); ++i) {
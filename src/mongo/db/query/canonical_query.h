@@ -96,6 +96,12 @@ public:
      */
     static bool isSimpleIdQuery(const BSONObj& query);
 
+    /**
+     * Returns true if "query" is of the form {_id: {$in: [...]}} where every element of the $in
+     * list is an exact-match value.
+     */
+    static bool isSimpleIdInQuery(const BSONObj& query);
+
     const NamespaceString& nss() const {
         return _qr->nss();
     }
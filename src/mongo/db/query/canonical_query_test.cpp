@@ -389,5 +389,17 @@ TEST(CanonicalQueryTest, NorWithOneChildNormalizedAfterNormalizingChild) {
     ASSERT_EQ(MatchExpression::EQ, root->getChild(0)->matchType());
 }
 
+TEST(CanonicalQueryTest, IsSimpleIdInQuery) {
+    ASSERT_TRUE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: [1, 'a', {x: 1}]}}")));
+    ASSERT_TRUE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: []}}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: 1}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: [1, /a/]}}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: [1, null]}}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: [[1]]}}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: [1], $ne: 2}}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{_id: {$in: [1]}, a: 1}")));
+    ASSERT_FALSE(CanonicalQuery::isSimpleIdInQuery(fromjson("{a: {$in: [1]}}")));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,371 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cmath>
+
+#include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Mixes the bits of 'x' so that the register index and rank drawn from the result are
+ * independent. This is the finalizer of the splitmix64 generator.
+ */
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+/**
+ * Collects every node of the tree rooted at 'node' into 'out'.
+ */
+void collectNodes(const QuerySolutionNode* node, std::vector<const QuerySolutionNode*>* out) {
+    out->push_back(node);
+    for (auto&& child : node->children) {
+        collectNodes(child, out);
+    }
+}
+
+/**
+ * Returns the single index scan of 'solution' if it reads from one index and nothing else, and
+ * that scan is one whose bounds can be estimated against a histogram of its leading field.
+ * Returns nullptr otherwise.
+ */
+const IndexScanNode* getEstimableIndexScan(const QuerySolution& solution) {
+    if (!solution.root) {
+        return nullptr;
+    }
+
+    std::vector<const QuerySolutionNode*> nodes;
+    collectNodes(solution.root.get(), &nodes);
+
+    const IndexScanNode* ixscan = nullptr;
+    for (auto&& node : nodes) {
+        if (node->children.size() > 1) {
+            // OR, AND_HASH, AND_SORTED and SORT_MERGE read from several inputs.
+            return nullptr;
+        }
+        if (node->children.empty()) {
+            if (node->getType() != STAGE_IXSCAN || ixscan) {
+                return nullptr;
+            }
+            ixscan = static_cast<const IndexScanNode*>(node);
+        }
+    }
+
+    if (!ixscan || ixscan->bounds.isSimpleRange || ixscan->bounds.fields.empty()) {
+        return nullptr;
+    }
+
+    // Bounds over hashed, geo or text indexes are not in terms of field values, bounds over an
+    // index with a collation are in terms of collation keys, and a partial index may hold only a
+    // small part of the sampled values.
+    const IndexEntry& index = ixscan->index;
+    if (index.type != INDEX_BTREE || index.collator || index.filterExpr) {
+        return nullptr;
+    }
+    return ixscan;
+}
+
+}  // namespace
+
+//
+// HyperLogLog
+//
+
+HyperLogLog::HyperLogLog() {
+    _registers.fill(0);
+}
+
+void HyperLogLog::add(const BSONObj& value) {
+    uint64_t hash = mix64(SimpleBSONElementComparator::kInstance.hash(value.firstElement()));
+    size_t index = hash >> (64 - kPrecision);
+
+    // The sentinel bit bounds the rank by the number of bits left after the register index.
+    uint64_t rest = (hash << kPrecision) | (1ULL << (kPrecision - 1));
+    uint8_t rank = countLeadingZeros64(rest) + 1;
+    _registers[index] = std::max(_registers[index], rank);
+}
+
+double HyperLogLog::estimate() const {
+    const double m = kNumRegisters;
+    double sum = 0;
+    size_t zeros = 0;
+    for (auto reg : _registers) {
+        sum += std::ldexp(1.0, -reg);
+        if (reg == 0) {
+            ++zeros;
+        }
+    }
+
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+
+    // Linear counting is more accurate while many registers are still empty.
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / zeros);
+    }
+    return estimate;
+}
+
+//
+// FieldHistogram
+//
+
+FieldHistogram FieldHistogram::make(std::vector<BSONObj>* values, size_t maxBuckets) {
+    invariant(maxBuckets > 0);
+
+    FieldHistogram histogram;
+    if (values->empty()) {
+        return histogram;
+    }
+
+    std::sort(values->begin(), values->end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+
+    const size_t depth = (values->size() + maxBuckets - 1) / maxBuckets;
+    histogram._numValues = values->size();
+    histogram._min = values->front().getOwned();
+
+    Bucket current{BSONObj(), 0, 0};
+    for (size_t i = 0; i < values->size();) {
+        // Consume the whole run of values equal to values[i].
+        size_t runEnd = i + 1;
+        while (runEnd < values->size() &&
+               compareValues((*values)[i].firstElement(), (*values)[runEnd].firstElement()) == 0) {
+            ++runEnd;
+        }
+
+        current.upper = (*values)[i].getOwned();
+        current.count += runEnd - i;
+        current.distinct += 1;
+        i = runEnd;
+
+        if (current.count >= depth || i == values->size()) {
+            histogram._buckets.push_back(std::move(current));
+            current = Bucket{BSONObj(), 0, 0};
+        }
+    }
+
+    return histogram;
+}
+
+double FieldHistogram::estimateInterval(const Interval& bounds) const {
+    Interval interval = bounds;
+    if (compareValues(interval.start, interval.end) > 0) {
+        interval.reverse();
+    }
+
+    const BSONElement& start = interval.start;
+    const BSONElement& end = interval.end;
+
+    double total = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        const Bucket& bucket = _buckets[i];
+        const BSONElement lo =
+            (i == 0) ? _min.firstElement() : _buckets[i - 1].upper.firstElement();
+        const bool loInclusive = (i == 0);
+        const BSONElement hi = bucket.upper.firstElement();
+
+        int startVsLo = compareValues(start, lo);
+        int endVsLo = compareValues(end, lo);
+        int startVsHi = compareValues(start, hi);
+        int endVsHi = compareValues(end, hi);
+
+        bool disjoint = endVsLo < 0 || (endVsLo == 0 && (!interval.endInclusive || !loInclusive)) ||
+            startVsHi > 0 || (startVsHi == 0 && !interval.startInclusive);
+        if (disjoint) {
+            continue;
+        }
+
+        if (interval.isPoint()) {
+            // Equal values never span buckets, so a point lies in exactly one of them.
+            return static_cast<double>(bucket.count) / bucket.distinct;
+        }
+
+        bool coversLo =
+            startVsLo < 0 || (startVsLo == 0 && (interval.startInclusive || !loInclusive));
+        bool coversHi = endVsHi > 0 || (endVsHi == 0 && interval.endInclusive);
+        total += (coversLo && coversHi) ? bucket.count : bucket.count / 2.0;
+    }
+    return total;
+}
+
+double FieldHistogram::estimateFraction(const OrderedIntervalList& oil) const {
+    if (_numValues == 0) {
+        return 1.0;
+    }
+
+    double total = 0;
+    for (auto&& interval : oil.intervals) {
+        total += estimateInterval(interval);
+    }
+    return std::min(1.0, total / _numValues);
+}
+
+void FieldHistogram::appendToBSON(BSONObjBuilder* builder) const {
+    builder->appendNumber("numValues", static_cast<long long>(_numValues));
+    if (!_min.isEmpty()) {
+        builder->appendAs(_min.firstElement(), "min");
+    }
+
+    BSONArrayBuilder bucketsBuilder(builder->subarrayStart("buckets"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBuilder(bucketsBuilder.subobjStart());
+        bucketBuilder.appendAs(bucket.upper.firstElement(), "upper");
+        bucketBuilder.appendNumber("count", static_cast<long long>(bucket.count));
+        bucketBuilder.appendNumber("distinct", static_cast<long long>(bucket.distinct));
+    }
+    bucketsBuilder.doneFast();
+}
+
+//
+// FieldStatistics
+//
+
+void FieldStatistics::appendToBSON(BSONObjBuilder* builder) const {
+    builder->appendNumber("sampleSize", static_cast<long long>(sampleSize));
+    builder->append("distinctEstimate", distinct.estimate());
+
+    BSONObjBuilder histogramBuilder(builder->subobjStart("histogram"));
+    histogram.appendToBSON(&histogramBuilder);
+    histogramBuilder.doneFast();
+}
+
+//
+// CollectionStatistics
+//
+
+void CollectionStatistics::set(const std::string& field,
+                               std::shared_ptr<const FieldStatistics> stats) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fields[field] = std::move(stats);
+}
+
+std::shared_ptr<const FieldStatistics> CollectionStatistics::get(const std::string& field) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _fields.find(field);
+    return it == _fields.end() ? nullptr : it->second;
+}
+
+void CollectionStatistics::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fields.clear();
+}
+
+bool CollectionStatistics::empty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _fields.empty();
+}
+
+void CollectionStatistics::appendToBSON(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& field : _fields) {
+        BSONObjBuilder fieldBuilder(builder->subobjStart(field.first));
+        field.second->appendToBSON(&fieldBuilder);
+        fieldBuilder.doneFast();
+    }
+}
+
+size_t pruneSolutionsUsingStatistics(const CollectionStatistics& stats,
+                                     double ratio,
+                                     std::vector<std::unique_ptr<QuerySolution>>* solutions) {
+    if (ratio <= 0 || solutions->size() < 2 || stats.empty()) {
+        return 0;
+    }
+
+    // A negative estimate marks a solution which cannot be estimated and is always kept.
+    std::vector<double> estimates(solutions->size(), -1);
+    boost::optional<size_t> bestIdx;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        const IndexScanNode* ixscan = getEstimableIndexScan(*(*solutions)[i]);
+        if (!ixscan) {
+            continue;
+        }
+
+        auto fieldStats = stats.get(ixscan->index.keyPattern.firstElementFieldName());
+        if (!fieldStats || fieldStats->histogram.getNumValues() == 0) {
+            continue;
+        }
+
+        // Never let an estimate drop below one sampled value, so that a range which happened to
+        // miss the sample does not make every other candidate look infinitely worse.
+        const double floor = 1.0 / fieldStats->histogram.getNumValues();
+        estimates[i] =
+            std::max(floor, fieldStats->histogram.estimateFraction(ixscan->bounds.fields[0]));
+        if (!bestIdx || estimates[i] < estimates[*bestIdx]) {
+            bestIdx = i;
+        }
+    }
+
+    if (!bestIdx) {
+        return 0;
+    }
+
+    const QuerySolution& best = *(*solutions)[*bestIdx];
+    std::vector<std::unique_ptr<QuerySolution>> kept;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        auto& solution = (*solutions)[i];
+        bool prune = i != *bestIdx && estimates[i] >= 0 &&
+            estimates[i] >= ratio * estimates[*bestIdx] &&
+            !(best.hasBlockingStage && !solution->hasBlockingStage);
+        if (prune) {
+            LOG(2) << "Pruning candidate plan " << i << " using collection statistics, estimated "
+                   << estimates[i] << " of the collection versus " << estimates[*bestIdx];
+            continue;
+        }
+        kept.push_back(std::move(solution));
+    }
+
+    size_t numPruned = solutions->size() - kept.size();
+    *solutions = std::move(kept);
+    return numPruned;
+}
+
+}  // namespace mongo
@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * A HyperLogLog sketch estimating the number of distinct values added to it. Uses 2^kPrecision
+ * one-byte registers, giving a standard error of roughly 3%.
+ */
+class HyperLogLog {
+public:
+    static const int kPrecision = 10;
+    static const size_t kNumRegisters = 1 << kPrecision;
+
+    HyperLogLog();
+
+    /**
+     * Adds the first element of 'value' to the sketch. The element's field name is ignored.
+     */
+    void add(const BSONObj& value);
+
+    /**
+     * Returns the estimated number of distinct values added so far.
+     */
+    double estimate() const;
+
+private:
+    std::array<uint8_t, kNumRegisters> _registers;
+};
+
+/**
+ * An equi-depth histogram over the values of a single field. Each bucket holds roughly the same
+ * number of sampled values, and a run of equal values never spans two buckets, so the number of
+ * distinct values per bucket is exact for the sample.
+ */
+class FieldHistogram {
+public:
+    struct Bucket {
+        // Inclusive upper bound of the bucket, stored as the first element of an object with an
+        // empty field name. The lower bound is the previous bucket's upper bound (exclusive), or
+        // 'FieldHistogram::_min' (inclusive) for the first bucket.
+        BSONObj upper;
+        size_t count;
+        size_t distinct;
+    };
+
+    /**
+     * Builds a histogram with at most 'maxBuckets' buckets from 'values', each of which holds a
+     * single element with an empty field name. 'values' is sorted in place.
+     */
+    static FieldHistogram make(std::vector<BSONObj>* values, size_t maxBuckets);
+
+    /**
+     * Returns the estimated fraction, between 0 and 1, of sampled values which fall into one of
+     * the intervals of 'oil'. Buckets wholly inside an interval count fully, a point interval
+     * counts the average frequency of its bucket, and a bucket straddling a range boundary counts
+     * half of its values.
+     */
+    double estimateFraction(const OrderedIntervalList& oil) const;
+
+    size_t getNumValues() const {
+        return _numValues;
+    }
+
+    const std::vector<Bucket>& getBuckets() const {
+        return _buckets;
+    }
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+private:
+    double estimateInterval(const Interval& interval) const;
+
+    BSONObj _min;
+    std::vector<Bucket> _buckets;
+    size_t _numValues = 0;
+};
+
+/**
+ * Statistics gathered by the 'analyze' command for a single field of a collection.
+ */
+struct FieldStatistics {
+    FieldHistogram histogram;
+    HyperLogLog distinct;
+
+    // The number of documents sampled to build the statistics.
+    size_t sampleSize = 0;
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+};
+
+/**
+ * Per-collection holder of field statistics, owned by the CollectionInfoCache. Statistics are
+ * only ever replaced wholesale, so readers get a shared_ptr to an immutable snapshot.
+ */
+class CollectionStatistics {
+    MONGO_DISALLOW_COPYING(CollectionStatistics);
+
+public:
+    CollectionStatistics() = default;
+
+    void set(const std::string& field, std::shared_ptr<const FieldStatistics> stats);
+
+    /**
+     * Returns the statistics for 'field', or nullptr if it has not been analyzed.
+     */
+    std::shared_ptr<const FieldStatistics> get(const std::string& field) const;
+
+    void clear();
+
+    bool empty() const;
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+private:
+    mutable stdx::mutex _mutex;
+    std::map<std::string, std::shared_ptr<const FieldStatistics>> _fields;
+};
+
+/**
+ * Uses 'stats' to estimate the fraction of the collection scanned by each candidate in
+ * 'solutions', and drops candidates whose estimate is at least 'ratio' times that of the most
+ * selective one. Only solutions consisting of a single index scan over an index whose leading
+ * field has statistics are considered, and a solution without a blocking stage is never dropped
+ * in favor of one with a blocking stage. At least one solution is always kept.
+ *
+ * Returns the number of solutions removed.
+ */
+size_t pruneSolutionsUsingStatistics(const CollectionStatistics& stats,
+                                     double ratio,
+                                     std::vector<std::unique_ptr<QuerySolution>>* solutions);
+
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/query/collection_statistics.h
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeValues(int n, int distinct) {
+    std::vector<BSONObj> values;
+    for (int i = 0; i < n; ++i) {
+        values.push_back(BSON("" << (i % distinct)));
+    }
+    return values;
+}
+
+OrderedIntervalList makeOil(int lo, int hi) {
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(BSON("" << lo << "" << hi), true, true));
+    return oil;
+}
+
+std::unique_ptr<QuerySolution> makeIndexScanSolution(const std::string& field,
+                                                     OrderedIntervalList oil,
+                                                     bool blocking) {
+    IndexEntry index(BSON(field << 1), false, false, false, field + "_1", nullptr, BSONObj());
+    auto ixscan = stdx::make_unique<IndexScanNode>(index);
+    oil.name = field;
+    ixscan->bounds.fields.push_back(std::move(oil));
+
+    auto fetch = stdx::make_unique<FetchNode>();
+    fetch->children.push_back(ixscan.release());
+
+    auto solution = stdx::make_unique<QuerySolution>();
+    solution->root = std::move(fetch);
+    solution->hasBlockingStage = blocking;
+    return solution;
+}
+
+void setStats(CollectionStatistics* stats, const std::string& field, int n, int distinct) {
+    auto fieldStats = std::make_shared<FieldStatistics>();
+    auto values = makeValues(n, distinct);
+    for (auto&& value : values) {
+        fieldStats->distinct.add(value);
+    }
+    fieldStats->histogram = FieldHistogram::make(&values, 50);
+    fieldStats->sampleSize = n;
+    stats->set(field, std::move(fieldStats));
+}
+
+TEST(CollectionStatisticsTest, HyperLogLogEstimatesDistinctValues) {
+    HyperLogLog small;
+    for (int i = 0; i < 100; ++i) {
+        small.add(BSON("" << (i % 10)));
+    }
+    ASSERT_APPROX_EQUAL(10, small.estimate(), 2);
+
+    HyperLogLog large;
+    for (int i = 0; i < 20000; ++i) {
+        large.add(BSON("" << i));
+    }
+    ASSERT_APPROX_EQUAL(20000, large.estimate(), 2000);
+}
+
+TEST(CollectionStatisticsTest, HistogramDoesNotSplitRunsOfEqualValues) {
+    auto values = makeValues(1000, 10);
+    auto histogram = FieldHistogram::make(&values, 4);
+
+    ASSERT_EQ(1000U, histogram.getNumValues());
+    size_t total = 0;
+    for (auto&& bucket : histogram.getBuckets()) {
+        ASSERT_EQ(bucket.count, bucket.distinct * 100);
+        total += bucket.count;
+    }
+    ASSERT_EQ(1000U, total);
+}
+
+TEST(CollectionStatisticsTest, HistogramEstimatesPointsAndRanges) {
+    auto values = makeValues(1000, 100);
+    auto histogram = FieldHistogram::make(&values, 10);
+
+    ASSERT_APPROX_EQUAL(0.01, histogram.estimateFraction(makeOil(42, 42)), 0.001);
+    ASSERT_APPROX_EQUAL(1.0, histogram.estimateFraction(makeOil(0, 99)), 0.001);
+    ASSERT_APPROX_EQUAL(0.5, histogram.estimateFraction(makeOil(0, 49)), 0.1);
+    ASSERT_EQ(0.0, histogram.estimateFraction(makeOil(200, 300)));
+
+    // Descending index bounds run from high to low.
+    OrderedIntervalList reversed("a");
+    reversed.intervals.push_back(Interval(BSON("" << 49 << "" << 0), true, true));
+    ASSERT_APPROX_EQUAL(0.5, histogram.estimateFraction(reversed), 0.1);
+}
+
+TEST(CollectionStatisticsTest, PruneDropsUnselectiveIndexScans) {
+    CollectionStatistics stats;
+    setStats(&stats, "a", 1000, 1000);
+    setStats(&stats, "b", 1000, 2);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexScanSolution("b", makeOil(0, 0), false));
+    solutions.push_back(makeIndexScanSolution("a", makeOil(5, 5), false));
+
+    ASSERT_EQ(1U, pruneSolutionsUsingStatistics(stats, 10, &solutions));
+    ASSERT_EQ(1U, solutions.size());
+    auto ixscan = static_cast<IndexScanNode*>(solutions[0]->root->children[0]);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), ixscan->index.keyPattern);
+}
+
+TEST(CollectionStatisticsTest, PruneKeepsCandidatesWithoutStatisticsOrBlockingStages) {
+    CollectionStatistics stats;
+    setStats(&stats, "a", 1000, 1000);
+    setStats(&stats, "b", 1000, 2);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeIndexScanSolution("b", makeOil(0, 0), false));
+    solutions.push_back(makeIndexScanSolution("a", makeOil(5, 5), true));
+    solutions.push_back(makeIndexScanSolution("c", makeOil(0, 0), false));
+
+    // The unselective candidate avoids the blocking sort of the selective one, and nothing is
+    // known about 'c'.
+    ASSERT_EQ(0U, pruneSolutionsUsingStatistics(stats, 10, &solutions));
+    ASSERT_EQ(3U, solutions.size());
+
+    // Pruning is disabled by a ratio of zero.
+    solutions[1]->hasBlockingStage = false;
+    ASSERT_EQ(0U, pruneSolutionsUsingStatistics(stats, 0, &solutions));
+    ASSERT_EQ(1U, pruneSolutionsUsingStatistics(stats, 10, &solutions));
+    ASSERT_EQ(2U, solutions.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -322,6 +322,14 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
         bob->appendNumber("nReturned", stats.common.advanced);
         bob->appendNumber("executionTimeMillisEstimate", stats.common.executionTimeMillis);
+        if (stats.common.worksTimed > 0) {
+            // Extrapolate from the sampled calls to work() to all of them.
+            const double nanosPerWork =
+                static_cast<double>(stats.common.executionTimeSampledNanos) /
+                stats.common.worksTimed;
+            bob->appendNumber("executionTimeMicrosEstimate",
+                              static_cast<long long>(nanosPerWork * stats.common.works / 1000));
+        }
         bob->appendNumber("works", stats.common.works);
         bob->appendNumber("advanced", stats.common.advanced);
         bob->appendNumber("needTime", stats.common.needTime);
@@ -333,7 +341,20 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     }
 
     // Stage-specific stats
-    if (STAGE_AND_HASH == stats.stageType) {
+    if (STAGE_AND_BITMAP == stats.stageType) {
+        AndBitmapStats* spec = static_cast<AndBitmapStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+            bob->appendNumber("memUsage", spec->memUsage);
+            bob->appendNumber("memLimit", spec->memLimit);
+
+            bob->appendNumber("flagged", spec->flagged);
+            for (size_t i = 0; i < spec->bitmapAfterChild.size(); ++i) {
+                bob->appendNumber(string(stream() << "bitmapAfterChild_" << i),
+                                  spec->bitmapAfterChild[i]);
+            }
+        }
+    } else if (STAGE_AND_HASH == stats.stageType) {
         AndHashStats* spec = static_cast<AndHashStats*>(stats.specific.get());
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
@@ -538,6 +559,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
+            if (spec->usedDisk) {
+                bob->appendNumber("spills", spec->spills);
+            }
         }
 
         if (spec->limit > 0) {
@@ -567,8 +592,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_TEXT_OR == stats.stageType) {
         TextOrStats* spec = static_cast<TextOrStats*>(stats.specific.get());
 
+        if (spec->topK) {
+            bob->appendNumber("topK", spec->topK);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->fetches);
+            if (spec->topK) {
+                bob->appendBool("stoppedEarly", spec->stoppedEarly);
+            }
         }
     } else if (STAGE_UPDATE == stats.stageType) {
         UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -579,6 +611,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->appendNumber("nInvalidateSkips", spec->nInvalidateSkips);
             bob->appendBool("wouldInsert", spec->inserted);
             bob->appendBool("fastmodinsert", spec->fastmodinsert);
+            bob->appendBool("inPlaceUpdate", spec->inPlaceUpdate);
         }
     }
 
@@ -781,6 +814,15 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
     const auto winningExecStats = getWinningPlanStatsTree(exec);
     generateSinglePlanExecutionInfo(winningExecStats.get(), verbosity, totalTimeMillis, &execBob);
 
+    if (const WorkingSet* ws = exec->getWorkingSet()) {
+        const WorkingSet::Stats& wsStats = ws->getStats();
+        BSONObjBuilder wsBob(execBob.subobjStart("workingSet"));
+        wsBob.appendNumber("allocations", wsStats.allocations);
+        wsBob.appendNumber("membersCreated", wsStats.membersCreated);
+        wsBob.appendNumber("slabsAllocated", wsStats.slabsAllocated);
+        wsBob.doneFast();
+    }
+
     // Also generate exec stats for all plans, if the verbosity level is high enough.
     // These stats reflect what happened during the trial period that ranked the plans.
     if (verbosity >= ExplainOptions::Verbosity::kExecAllPlans) {
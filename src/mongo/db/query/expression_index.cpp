@@ -37,6 +37,8 @@
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -133,6 +135,79 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+namespace {
+
+/**
+ * The index intervals covering recently queried 2dsphere geometries, keyed by the geometry along
+ * with the index and covering parameters that determine the intervals.
+ */
+class S2CoveringCache {
+public:
+    boost::optional<std::vector<Interval>> get(const std::string& key, size_t maxSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _resize(maxSize);
+        auto it = _cache->promote(key);
+        if (it == _cache->end()) {
+            return boost::none;
+        }
+        return it->second;
+    }
+
+    void add(const std::string& key, std::vector<Interval> intervals, size_t maxSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _resize(maxSize);
+        _cache->add(key, std::move(intervals));
+    }
+
+private:
+    void _resize(size_t maxSize) {
+        if (!_cache || _maxSize != maxSize) {
+            _cache = stdx::make_unique<LRUCache<std::string, std::vector<Interval>>>(maxSize);
+            _maxSize = maxSize;
+        }
+    }
+
+    stdx::mutex _mutex;
+    size_t _maxSize = 0;
+    std::unique_ptr<LRUCache<std::string, std::vector<Interval>>> _cache;
+};
+
+S2CoveringCache s2CoveringCache;
+
+}  // namespace
+
+void ExpressionMapping::cover2dsphere(const S2Region& region,
+                                      const BSONObj& geometry,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    const int maxCacheSize = internalQueryS2CoveringCacheSize.load();
+    if (maxCacheSize <= 0) {
+        cover2dsphere(region, indexingParams, oilOut);
+        return;
+    }
+
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("geometry", geometry);
+    keyBuilder.append("indexVersion", static_cast<int>(indexingParams.indexVersion));
+    keyBuilder.append("coarsestIndexedLevel", indexingParams.coarsestIndexedLevel);
+    keyBuilder.append("coarsestLevel", internalQueryS2GeoCoarsestLevel.load());
+    keyBuilder.append("finestLevel", internalQueryS2GeoFinestLevel.load());
+    keyBuilder.append("maxCells", internalQueryS2GeoMaxCells.load());
+    const BSONObj keyObj = keyBuilder.done();
+    const std::string key(keyObj.objdata(), keyObj.objsize());
+
+    if (auto intervals = s2CoveringCache.get(key, maxCacheSize)) {
+        oilOut->intervals.insert(oilOut->intervals.end(), intervals->begin(), intervals->end());
+        return;
+    }
+
+    OrderedIntervalList covering;
+    cover2dsphere(region, indexingParams, &covering);
+    oilOut->intervals.insert(
+        oilOut->intervals.end(), covering.intervals.begin(), covering.intervals.end());
+    s2CoveringCache.add(key, std::move(covering.intervals), maxCacheSize);
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
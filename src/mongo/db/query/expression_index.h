@@ -77,6 +77,17 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    /**
+     * Like the above, but first looks for the intervals in a cache of the most recently covered
+     * query geometries, shared by all queries, and adds them to it if they are not there.
+     * 'geometry' is the query geometry from which 'region' was parsed. See
+     * internalQueryS2CoveringCacheSize.
+     */
+    static void cover2dsphere(const S2Region& region,
+                              const BSONObj& geometry,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
 };
 
 }  // namespace mongo
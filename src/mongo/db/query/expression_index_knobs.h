@@ -59,4 +59,13 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// When greater than 0, a 2dsphere $near search sizes each annulus after the first to contain
+// about this many documents, given the density of the documents found so far. Otherwise the
+// annulus width doubles or halves depending on how many documents the previous one returned.
+extern AtomicInt32 internalGeoNearQuery2DSphereTargetIntervalResults;
+
+// How many 2dsphere query geometries the planner keeps the index intervals covering, so that a
+// repeated geometry is not covered again. Zero disables the cache.
+extern AtomicInt32 internalQueryS2CoveringCacheSize;
+
 }  // namespace mongo
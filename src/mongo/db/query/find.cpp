@@ -404,6 +404,8 @@ Message getMore(OperationContext* opCtx,
             curOp.setOpDescription_inlock(upconvertGetMoreEntry(nss, cursorid, ntoreturn));
             curOp.setOriginatingCommand_inlock(cc->getOriginatingCommandObj());
         }
+        curOp.debug().queryStatsKey = cc->getQueryStatsKey();
+        curOp.debug().queryStatsShape = cc->getQueryStatsShape();
 
         PlanExecutor::ExecState state;
 
@@ -624,7 +626,7 @@ std::string runQuery(OperationContext* opCtx,
         // Count the result.
         ++numResults;
 
-        if (FindCommon::enoughForFirstBatch(qr, numResults)) {
+        if (FindCommon::enoughForFirstBatch(qr, numResults, bb.len())) {
             LOG(5) << "Enough for first batch, wantMore=" << qr.wantMore()
                    << " ntoreturn=" << qr.getNToReturn().value_or(0)
                    << " numResults=" << numResults;
@@ -32,6 +32,7 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/util/assert_util.h"
 
@@ -48,9 +49,15 @@ MONGO_FAIL_POINT_DEFINE(waitBeforeUnpinningOrDeletingCursorAfterGetMoreBatch);
 const OperationContext::Decoration<AwaitDataState> awaitDataState =
     OperationContext::declareDecoration<AwaitDataState>();
 
-bool FindCommon::enoughForFirstBatch(const QueryRequest& qr, long long numDocs) {
+bool FindCommon::enoughForFirstBatch(const QueryRequest& qr,
+                                     long long numDocs,
+                                     int bytesBuffered) {
     if (!qr.getEffectiveBatchSize()) {
-        // We enforce a default batch size for the initial find if no batch size is specified.
+        // Without a batch size, the initial find returns either a default number of documents or,
+        // if so configured, as many documents as fit in a fixed number of bytes.
+        if (const int maxBytes = internalQueryFindFirstBatchMaxBytes.load()) {
+            return bytesBuffered >= maxBytes;
+        }
         return numDocs >= QueryRequest::kDefaultBatchSize;
     }
 
@@ -87,11 +87,13 @@ public:
     static const int kInitReplyBufferSize = 32768;
 
     /**
-     * Returns true if the batchSize for the initial find has been satisfied.
+     * Returns true if the batchSize for the initial find has been satisfied, given the number of
+     * docs ('numDocs') and bytes ('bytesBuffered') in the batch so far.
      *
-     * If 'qr' does not have a batchSize, the default batchSize is respected.
+     * If 'qr' does not have a batchSize, the default batchSize is respected, unless
+     * internalQueryFindFirstBatchMaxBytes is set, in which case the batch is cut by size instead.
      */
-    static bool enoughForFirstBatch(const QueryRequest& qr, long long numDocs);
+    static bool enoughForFirstBatch(const QueryRequest& qr, long long numDocs, int bytesBuffered);
 
     /**
      * Returns true if the batchSize for the getMore has been satisfied.
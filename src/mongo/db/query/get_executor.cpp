@@ -39,6 +39,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/subplan.h"
 #include "mongo/db/exec/update.h"
+#include "mongo/db/index/all_paths_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
@@ -58,13 +60,17 @@
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_snapshot.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
+#include "mongo/db/query/planner_all_paths_helpers.h"
 #include "mongo/db/query/planner_analysis.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
@@ -126,20 +132,35 @@ void fillOutPlannerParams(OperationContext* opCtx,
                           CanonicalQuery* canonicalQuery,
                           QueryPlannerParams* plannerParams) {
     // If it's not NULL, we may have indices.  Access the catalog and fill out IndexEntry(s)
+    boost::optional<stdx::unordered_set<std::string>> queryFields;
     IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
     while (ii.more()) {
         const IndexDescriptor* desc = ii.next();
         IndexCatalogEntry* ice = ii.catalogEntry(desc);
-        plannerParams->indices.push_back(IndexEntry(desc->keyPattern(),
-                                                    desc->getAccessMethodName(),
-                                                    desc->isMultikey(opCtx),
-                                                    ice->getMultikeyPaths(opCtx),
-                                                    desc->isSparse(),
-                                                    desc->unique(),
-                                                    desc->indexName(),
-                                                    ice->getFilterExpression(),
-                                                    desc->infoObj(),
-                                                    ice->getCollator()));
+        IndexEntry entry(desc->keyPattern(),
+                         desc->getAccessMethodName(),
+                         desc->isMultikey(opCtx),
+                         ice->getMultikeyPaths(opCtx),
+                         desc->isSparse(),
+                         desc->unique(),
+                         desc->indexName(),
+                         ice->getFilterExpression(),
+                         desc->infoObj(),
+                         ice->getCollator());
+
+        // An allPaths index is planned as one entry per indexed path the query refers to, with
+        // multikey information read from the metadata keys in the index.
+        if (entry.type == INDEX_ALLPATHS) {
+            if (!queryFields) {
+                queryFields.emplace();
+                QueryPlannerIXSelect::getFields(canonicalQuery->root(), "", &*queryFields);
+            }
+            const auto* iam = static_cast<AllPathsAccessMethod*>(ice->accessMethod());
+            all_paths_planning::expandIndex(
+                entry, *queryFields, iam->getMultikeyPathSet(opCtx), &plannerParams->indices);
+            continue;
+        }
+        plannerParams->indices.push_back(std::move(entry));
     }
 
     // If query supports index filters, filter params.indices by indices in query settings.
@@ -254,6 +275,36 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Samples the operation for $queryStats, at the rate set by internalQueryStatsSampleRate, by
+ * attaching the plan cache key of 'canonicalQuery' to its OpDebug. The statistics are recorded
+ * when the operation completes. Only the first query an operation plans is attributed.
+ */
+void sampleForQueryStats(OperationContext* opCtx,
+                         const Collection* collection,
+                         const CanonicalQuery& canonicalQuery) {
+    const double sampleRate = internalQueryStatsSampleRate.load();
+    if (sampleRate <= 0.0) {
+        return;
+    }
+
+    auto& opDebug = CurOp::get(opCtx)->debug();
+    if (!opDebug.queryStatsKey.empty() ||
+        opCtx->getClient()->getPrng().nextCanonicalDouble() >= sampleRate) {
+        return;
+    }
+
+    const auto& qr = canonicalQuery.getQueryRequest();
+    opDebug.queryStatsKey = str::stream()
+        << canonicalQuery.ns() << '\0'
+        << collection->infoCache()->getPlanCache()->computeKey(canonicalQuery);
+    opDebug.queryStatsShape = BSON("ns" << canonicalQuery.ns() << "query" << qr.getFilter()
+                                        << "sort"
+                                        << qr.getSort()
+                                        << "projection"
+                                        << qr.getProj());
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -284,6 +335,8 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         return PrepareExecutionResult(std::move(canonicalQuery), nullptr, std::move(root));
     }
 
+    sampleForQueryStats(opCtx, collection, *canonicalQuery);
+
     // Fill out the planning params.  We use these for both cached solutions and non-cached.
     QueryPlannerParams plannerParams;
     plannerParams.options = plannerOptions;
@@ -434,6 +487,13 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // Use collection statistics, if any, to avoid racing plans which are known to be poor.
+    const double statsPruneRatio = internalQueryPlanStatisticsPruneRatio.load();
+    if (statsPruneRatio > 0 && solutions.size() > 1) {
+        pruneSolutionsUsingStatistics(
+            *collection->infoCache()->getStatistics(), statsPruneRatio, &solutions);
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -678,6 +738,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> _getExecutorFind(
     if (ShardingState::get(opCtx)->needCollectionMetadata(opCtx, nss.ns())) {
         plannerOptions |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+
+    // Snapshots are only restored on behalf of finds, so that replication and internal writes
+    // never read the snapshot collection while planning.
+    if (collection) {
+        restorePlanCacheSnapshotIfNeeded(opCtx, collection);
+    }
     return getExecutor(opCtx, collection, std::move(canonicalQuery), yieldPolicy, plannerOptions);
 }
 
@@ -1071,11 +1137,18 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
         ? static_cast<IndexScanNode*>(root->children[0])
         : static_cast<IndexScanNode*>(root);
 
-    // No filters allowed and side-stepping isSimpleRange for now.  TODO: do we ever see
-    // isSimpleRange here?  because we could well use it.  I just don't think we ever do see
-    // it.
+    // The count scan stage reads keys in the shape of the index's own key pattern, which the keys
+    // of an allPaths index do not have.
+    if (isn->index.type == INDEX_ALLPATHS) {
+        return false;
+    }
 
-    if (NULL != isn->filter.get() || isn->bounds.isSimpleRange) {
+    // Side-stepping isSimpleRange for now.  TODO: do we ever see isSimpleRange here?  because we
+    // could well use it.  I just don't think we ever do see it.
+    //
+    // A filter on the index scan is fine, since it only refers to fields of the index key. The
+    // count scan evaluates it on each key, just as the index scan would have.
+    if (isn->bounds.isSimpleRange) {
         return false;
     }
 
@@ -1096,6 +1169,7 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
     csn->startKeyInclusive = startKeyInclusive;
     csn->endKey = endKey;
     csn->endKeyInclusive = endKeyInclusive;
+    csn->filter = std::move(isn->filter);
     // Takes ownership of 'cn' and deletes the old root.
     soln->root.reset(csn);
     return true;
@@ -1112,9 +1186,10 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
  * Arrays are flattened in a multikey index which makes it impossible for the distinct scan stage
  * (plan stage generated from DistinctNode) to select the requested element by array index.
  *
- * Multikey indices cannot be used for the fast distinct hack if the field is dotted.  Currently the
+ * Multikey indices cannot be used for the fast distinct hack if the field is dotted, unless the
+ * path-level multikey metadata shows that no component of the field is an array.  Currently the
  * solution generated for the distinct hack includes a projection stage and the projection stage
- * cannot be covered with a dotted field.
+ * cannot be covered with a dotted field that may be multikey.
  */
 bool getDistinctNodeIndex(const std::vector<IndexEntry>& indices,
                           const std::string& field,
@@ -1136,8 +1211,9 @@ bool getDistinctNodeIndex(const std::vector<IndexEntry>& indices,
         if (indices[i].filterExpr) {
             continue;
         }
-        // Skip multikey indices if we are projecting on a dotted field.
-        if (indices[i].multikey && isDottedField) {
+        // Skip multikey indices if we are projecting on a dotted field which may be multikey.
+        if (indices[i].multikey && isDottedField &&
+            (indices[i].multikeyPaths.empty() || !indices[i].multikeyPaths[0].empty())) {
             continue;
         }
         // Skip indices where the first key is not field.
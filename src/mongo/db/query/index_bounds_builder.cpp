@@ -666,7 +666,15 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         }
 
-        unionize(oilOut);
+        if (ime->hasHomogeneousEqualities() && ime->getRegexes().empty() && !isHashed) {
+            // The equalities were translated in ascending order into distinct point intervals, so
+            // there is nothing to sort or merge. This saves an O(n log n) sort of the intervals
+            // for large lists of numbers or ObjectIds.
+            dassert(std::is_sorted(
+                oilOut->intervals.begin(), oilOut->intervals.end(), IntervalComparison));
+        } else {
+            unionize(oilOut);
+        }
     } else if (MatchExpression::GEO == expr->matchType()) {
         const GeoMatchExpression* gme = static_cast<const GeoMatchExpression*>(expr);
 
@@ -675,7 +683,7 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(region, gme->getRawObj(), indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -38,6 +38,7 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -933,6 +934,28 @@ TEST(IndexBoundsBuilderTest, TranslateIn) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateInMixedIntegralTypes) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONObj obj = fromjson("{a: {$in: [8, {$numberLong: '-1'}, 8.0, -3, 2]}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    ASSERT(static_cast<InMatchExpression*>(expr.get())->hasHomogeneousEqualities());
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 4U);
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[0].compare(Interval(fromjson("{'': -3, '': -3}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[1].compare(Interval(fromjson("{'': -1, '': -1}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[2].compare(Interval(fromjson("{'': 2, '': 2}"), true, true)));
+    ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                  oil.intervals[3].compare(Interval(fromjson("{'': 8, '': 8}"), true, true)));
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+}
+
 TEST(IndexBoundsBuilderTest, TranslateInArray) {
     IndexEntry testIndex = IndexEntry(BSONObj());
     BSONObj obj = fromjson("{a: {$in: [[1], 2]}}");
@@ -2979,4 +3002,43 @@ TEST(IndexBoundsBuilderTest, CanUseCoveredMatchingForExistsTrueWithSparseIndex)
     ASSERT_TRUE(IndexBoundsBuilder::canUseCoveredMatching(expr.get(), testIndex));
 }
 
+TEST(IndexBoundsBuilderTest, CachedS2CoveringMatchesComputedCovering) {
+    const int oldCacheSize = internalQueryS2CoveringCacheSize.load();
+    BSONObj keyPattern = BSON("loc"
+                              << "2dsphere");
+    IndexEntry testIndex = IndexEntry(keyPattern);
+    BSONObj obj = fromjson(
+        "{loc: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 1], [1, 1], [1, 0], [0, 0]]]}}}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+
+    auto translate = [&]() {
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(
+            expr.get(), keyPattern.firstElement(), testIndex, &oil, &tightness);
+        ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+        return oil.toString();
+    };
+
+    internalQueryS2CoveringCacheSize.store(0);
+    const std::string computed = translate();
+
+    // The first translation fills the cache, and the second is answered from it.
+    internalQueryS2CoveringCacheSize.store(10);
+    ASSERT_EQUALS(computed, translate());
+    ASSERT_EQUALS(computed, translate());
+
+    // The covering depends on the covering parameters, which are part of the cache key.
+    const int oldMaxCells = internalQueryS2GeoMaxCells.load();
+    internalQueryS2GeoMaxCells.store(1);
+    const std::string coarser = translate();
+    ASSERT_NOT_EQUALS(computed, coarser);
+    internalQueryS2CoveringCacheSize.store(0);
+    ASSERT_EQUALS(coarser, translate());
+
+    internalQueryS2GeoMaxCells.store(oldMaxCells);
+    internalQueryS2CoveringCacheSize.store(oldCacheSize);
+}
+
 }  // namespace
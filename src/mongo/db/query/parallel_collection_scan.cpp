@@ -0,0 +1,247 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parallel_collection_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Random samples taken per range when choosing split points. More samples even out the ranges at
+// the cost of a longer setup.
+const size_t kSamplesPerRange = 16;
+
+/**
+ * Lazily starts the worker pool shared by all parallel collection scans on a ServiceContext. The
+ * pool has a thread per available core and lets its threads exit once they have been idle for a
+ * while, so a server that never runs a parallel scan keeps no extra threads around.
+ */
+class WorkerPool {
+public:
+    ThreadPool* get() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_pool) {
+            ThreadPool::Options options;
+            options.poolName = "ParallelCollectionScan";
+            options.threadNamePrefix = "parallelCollScan-";
+            options.minThreads = 0;
+            options.maxThreads = std::max<size_t>(2, ProcessInfo::getNumAvailableCores());
+            options.onCreateThread = [](const std::string& threadName) {
+                Client::initThread(threadName);
+            };
+            _pool = stdx::make_unique<ThreadPool>(options);
+            _pool->startup();
+        }
+        return _pool.get();
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+const auto getWorkerPool = ServiceContext::declareDecoration<WorkerPool>();
+
+/**
+ * State shared between ParallelCollectionScan::run() and the workers it schedules. run() waits for
+ * every scheduled task to finish before returning, so the tasks may refer to it by reference.
+ */
+struct RunState {
+    explicit RunState(size_t numRanges) : statuses(numRanges, Status::OK()), opCtxs(numRanges) {}
+
+    stdx::mutex mutex;
+    stdx::condition_variable allDone;
+
+    size_t numPending = 0;
+    bool killed = false;
+    std::vector<Status> statuses;
+
+    // The OperationContext of each range's worker while it is scanning, so that run() can kill
+    // them if its own operation is interrupted.
+    std::vector<OperationContext*> opCtxs;
+};
+
+}  // namespace
+
+ParallelCollectionScan::ParallelCollectionScan(NamespaceString nss,
+                                               UUID uuid,
+                                               std::vector<RecordId> splitPoints)
+    : _nss(std::move(nss)), _uuid(std::move(uuid)), _splitPoints(std::move(splitPoints)) {}
+
+boost::optional<ParallelCollectionScan> ParallelCollectionScan::make(OperationContext* opCtx,
+                                                                     const Collection* collection,
+                                                                     size_t maxRanges) {
+    if (maxRanges < 2 || !collection || collection->isCapped() || !collection->uuid()) {
+        return boost::none;
+    }
+
+    const RecordStore* rs = collection->getRecordStore();
+    if (!rs->isInRecordIdOrder() ||
+        rs->numRecords(opCtx) < internalQueryParallelCollectionScanMinRecords.load()) {
+        return boost::none;
+    }
+
+    auto cursor = rs->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    std::vector<RecordId> samples;
+    samples.reserve(maxRanges * kSamplesPerRange);
+    while (samples.size() < maxRanges * kSamplesPerRange) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        samples.push_back(record->id);
+    }
+    std::sort(samples.begin(), samples.end());
+    samples.erase(std::unique(samples.begin(), samples.end()), samples.end());
+
+    std::vector<RecordId> splitPoints;
+    for (size_t i = 1; i < maxRanges; ++i) {
+        const RecordId& id = samples[i * samples.size() / maxRanges];
+        if (splitPoints.empty() || splitPoints.back() < id) {
+            splitPoints.push_back(id);
+        }
+    }
+    if (splitPoints.empty()) {
+        return boost::none;
+    }
+
+    return ParallelCollectionScan(collection->ns(), *collection->uuid(), std::move(splitPoints));
+}
+
+Status ParallelCollectionScan::run(OperationContext* opCtx, const RangeScanFn& scanRange) const {
+    invariant(!opCtx->lockState()->isLocked());
+
+    const size_t nRanges = numRanges();
+    RunState state(nRanges);
+    ThreadPool* pool = getWorkerPool(opCtx->getServiceContext()).get();
+
+    for (size_t i = 0; i < nRanges; ++i) {
+        auto task = [this, &state, &scanRange, i] {
+            Status status = [&]() -> Status {
+                auto workerOpCtx = cc().makeOperationContext();
+                {
+                    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+                    if (state.killed) {
+                        return Status(ErrorCodes::Interrupted, "parallel collection scan killed");
+                    }
+                    state.opCtxs[i] = workerOpCtx.get();
+                }
+                ON_BLOCK_EXIT([&] {
+                    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+                    state.opCtxs[i] = nullptr;
+                });
+
+                try {
+                    AutoGetCollectionForRead autoColl(workerOpCtx.get(),
+                                                      {_nss.db().toString(), _uuid});
+                    Collection* collection = autoColl.getCollection();
+                    if (!collection || collection->ns() != _nss) {
+                        return Status(ErrorCodes::QueryPlanKilled,
+                                      str::stream() << "collection " << _nss.ns()
+                                                    << " was dropped or renamed during a "
+                                                       "parallel collection scan");
+                    }
+
+                    CollectionScanParams params;
+                    params.collection = collection;
+                    params.start = i == 0 ? RecordId() : _splitPoints[i - 1];
+                    params.end = i < _splitPoints.size() ? _splitPoints[i] : RecordId::max();
+                    return scanRange(workerOpCtx.get(), collection, params, i);
+                } catch (const DBException& ex) {
+                    return ex.toStatus();
+                }
+            }();
+
+            stdx::lock_guard<stdx::mutex> lk(state.mutex);
+            state.statuses[i] = std::move(status);
+            if (--state.numPending == 0) {
+                state.allDone.notify_all();
+            }
+        };
+
+        stdx::lock_guard<stdx::mutex> lk(state.mutex);
+        ++state.numPending;
+        Status scheduleStatus = pool->schedule(std::move(task));
+        if (!scheduleStatus.isOK()) {
+            --state.numPending;
+            state.statuses[i] = std::move(scheduleStatus);
+            state.killed = true;
+            break;
+        }
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(state.mutex);
+    try {
+        opCtx->waitForConditionOrInterrupt(
+            state.allDone, lk, [&] { return state.numPending == 0; });
+    } catch (const DBException& ex) {
+        // The workers refer to 'state', so they must all stop before we can unwind.
+        state.killed = true;
+        for (OperationContext* workerOpCtx : state.opCtxs) {
+            if (workerOpCtx) {
+                stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+                workerOpCtx->getServiceContext()->killOperation(workerOpCtx, ex.code());
+            }
+        }
+        state.allDone.wait(lk, [&] { return state.numPending == 0; });
+        throw;
+    }
+
+    for (auto&& status : state.statuses) {
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class Collection;
+class OperationContext;
+
+/**
+ * Splits a forward collection scan into disjoint RecordId ranges and scans the ranges
+ * concurrently on a shared pool of worker threads. Each worker has its own Client and
+ * OperationContext, locks the collection itself, and yields independently of the others.
+ *
+ * Only order-insensitive operations such as counting may use this, and callers are responsible for
+ * merging the per-range results. The ranges complete in an arbitrary order, and because every
+ * worker reads from its own storage snapshot, the combined result has the same consistency as a
+ * single yielding collection scan rather than that of a point-in-time read.
+ */
+class ParallelCollectionScan {
+public:
+    /**
+     * Scans one range on a worker thread. 'collection' is locked on behalf of 'opCtx', which
+     * belongs to the worker, and 'params' describes the range. 'rangeIndex' identifies the range,
+     * so that callers can keep per-range results without synchronization.
+     */
+    using RangeScanFn = stdx::function<Status(OperationContext* opCtx,
+                                              Collection* collection,
+                                              const CollectionScanParams& params,
+                                              size_t rangeIndex)>;
+
+    /**
+     * Chooses range boundaries for scanning 'collection' in at most 'maxRanges' pieces by sampling
+     * its RecordIds. Returns boost::none if the collection cannot or should not be split: it has
+     * fewer than internalQueryParallelCollectionScanMinRecords records, it is capped, or its record
+     * store neither returns records in RecordId order nor supports random cursors.
+     *
+     * The caller must hold at least a MODE_IS lock on 'collection'.
+     */
+    static boost::optional<ParallelCollectionScan> make(OperationContext* opCtx,
+                                                        const Collection* collection,
+                                                        size_t maxRanges);
+
+    size_t numRanges() const {
+        return _splitPoints.size() + 1;
+    }
+
+    /**
+     * Runs 'scanRange' once for every range and waits for all of them to finish. Returns OK if
+     * every range succeeded, and otherwise the error of the lowest-numbered range that failed. A
+     * collection that was dropped or renamed since make() fails with QueryPlanKilled.
+     *
+     * If 'opCtx' is interrupted, the workers are killed and this throws once they have all stopped.
+     *
+     * The caller must not hold any locks, since the workers take their own and may otherwise queue
+     * behind a conflicting request which is itself waiting on the caller.
+     */
+    Status run(OperationContext* opCtx, const RangeScanFn& scanRange) const;
+
+private:
+    ParallelCollectionScan(NamespaceString nss, UUID uuid, std::vector<RecordId> splitPoints);
+
+    const NamespaceString _nss;
+    const UUID _uuid;
+
+    // Sorted and distinct. Range i covers the RecordIds in [_splitPoints[i - 1], _splitPoints[i]),
+    // where the first range is unbounded below and the last unbounded above.
+    const std::vector<RecordId> _splitPoints;
+};
+
+}  // namespace mongo
@@ -33,17 +33,21 @@
 #include "mongo/db/query/plan_cache.h"
 
 #include <algorithm>
+#include <functional>
 #include <math.h>
 #include <memory>
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -377,6 +381,17 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
     }
 }
 
+CachedSolution::CachedSolution(const PlanCacheKey& key,
+                               const PlanCacheEntry& entry,
+                               const PlanCacheConstantRangePlan& rangePlan)
+    : plannerData{rangePlan.solution->clone()},
+      key(key),
+      query(entry.query.getOwned()),
+      sort(entry.sort.getOwned()),
+      projection(entry.projection.getOwned()),
+      collation(entry.collation.getOwned()),
+      decisionWorks(rangePlan.works) {}
+
 CachedSolution::~CachedSolution() {
     for (std::vector<SolutionCacheData*>::const_iterator i = plannerData.begin();
          i != plannerData.end();
@@ -390,6 +405,33 @@ CachedSolution::~CachedSolution() {
 // PlanCacheEntry
 //
 
+namespace {
+
+/**
+ * Copies the shape of 'query' into 'entry' for display by the plan cache commands.
+ */
+void setEntryQueryShape(const CanonicalQuery& query, PlanCacheEntry* entry) {
+    const QueryRequest& qr = query.getQueryRequest();
+    entry->query = qr.getFilter().getOwned();
+    entry->sort = qr.getSort().getOwned();
+    if (query.getCollator()) {
+        entry->collation = query.getCollator()->getSpec().toBSON();
+    }
+
+    // Strip projections on $-prefixed fields, as these are added by internal callers of the query
+    // system and are not considered part of the user projection.
+    BSONObjBuilder projBuilder;
+    for (auto elem : qr.getProj()) {
+        if (elem.fieldName()[0] == '$') {
+            continue;
+        }
+        projBuilder.append(elem);
+    }
+    entry->projection = projBuilder.obj();
+}
+
+}  // namespace
+
 PlanCacheEntry::PlanCacheEntry(const std::vector<QuerySolution*>& solutions,
                                PlanRankingDecision* why)
     : plannerData(solutions.size()), decision(why) {
@@ -433,6 +475,10 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     entry->timeOfCreation = timeOfCreation;
     entry->isActive = isActive;
     entry->works = works;
+    entry->restoredFromSnapshot = restoredFromSnapshot;
+    for (auto&& rangePlan : constantRangePlans) {
+        entry->constantRangePlans.push_back(rangePlan.clone());
+    }
 
     // Copy performance stats.
     for (size_t i = 0; i < feedback.size(); ++i) {
@@ -517,6 +563,147 @@ std::string PlanCacheIndexTree::toString(int indents) const {
     return result.str();
 }
 
+BSONObj PlanCacheIndexTree::toBSON() const {
+    BSONObjBuilder bob;
+    if (entry) {
+        bob.append("index", entry->name);
+        bob.append("keyPattern", entry->keyPattern);
+        bob.appendNumber("pos", static_cast<long long>(index_pos));
+        bob.append("canCombineBounds", canCombineBounds);
+    }
+
+    if (!orPushdowns.empty()) {
+        BSONArrayBuilder pushdownsBuilder(bob.subarrayStart("orPushdowns"));
+        for (auto&& orPushdown : orPushdowns) {
+            BSONObjBuilder pushdownBuilder(pushdownsBuilder.subobjStart());
+            pushdownBuilder.append("index", orPushdown.indexName);
+            pushdownBuilder.appendNumber("pos", static_cast<long long>(orPushdown.position));
+            pushdownBuilder.append("canCombineBounds", orPushdown.canCombineBounds);
+            BSONArrayBuilder routeBuilder(pushdownBuilder.subarrayStart("route"));
+            for (auto position : orPushdown.route) {
+                routeBuilder.append(static_cast<long long>(position));
+            }
+            routeBuilder.doneFast();
+            pushdownBuilder.doneFast();
+        }
+        pushdownsBuilder.doneFast();
+    }
+
+    if (!children.empty()) {
+        BSONArrayBuilder childrenBuilder(bob.subarrayStart("children"));
+        for (auto&& child : children) {
+            childrenBuilder.append(child->toBSON());
+        }
+        childrenBuilder.doneFast();
+    }
+    return bob.obj();
+}
+
+namespace {
+
+const IndexEntry* findIndexEntry(const std::vector<IndexEntry>& indexes, StringData name) {
+    for (auto&& index : indexes) {
+        if (index.name == name) {
+            return &index;
+        }
+    }
+    return nullptr;
+}
+
+StatusWith<size_t> parseNonNegative(const BSONObj& obj, StringData fieldName) {
+    BSONElement elt = obj[fieldName];
+    if (!elt.isNumber() || elt.safeNumberLong() < 0) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "plan cache snapshot field '" << fieldName
+                                    << "' must be a non-negative number");
+    }
+    return static_cast<size_t>(elt.safeNumberLong());
+}
+
+}  // namespace
+
+// static
+StatusWith<std::unique_ptr<PlanCacheIndexTree>> PlanCacheIndexTree::parse(
+    const BSONObj& obj, const std::vector<IndexEntry>& indexes) {
+    auto tree = stdx::make_unique<PlanCacheIndexTree>();
+
+    if (BSONElement indexElt = obj["index"]) {
+        if (indexElt.type() != String || obj["keyPattern"].type() != Object) {
+            return Status(ErrorCodes::FailedToParse, "malformed index in plan cache snapshot");
+        }
+        const IndexEntry* index = findIndexEntry(indexes, indexElt.valueStringData());
+        if (!index || SimpleBSONObjComparator::kInstance.evaluate(index->keyPattern !=
+                                                                  obj["keyPattern"].Obj())) {
+            return Status(ErrorCodes::IndexNotFound,
+                          str::stream() << "index " << indexElt.valueStringData()
+                                        << " from plan cache snapshot no longer exists");
+        }
+
+        auto pos = parseNonNegative(obj, "pos");
+        if (!pos.isOK()) {
+            return pos.getStatus();
+        }
+        tree->setIndexEntry(*index);
+        tree->index_pos = pos.getValue();
+        tree->canCombineBounds = obj["canCombineBounds"].trueValue();
+    }
+
+    if (BSONElement pushdownsElt = obj["orPushdowns"]) {
+        if (pushdownsElt.type() != Array) {
+            return Status(ErrorCodes::FailedToParse,
+                          "malformed orPushdowns in plan cache snapshot");
+        }
+        for (auto&& pushdownElt : pushdownsElt.Obj()) {
+            if (pushdownElt.type() != Object || pushdownElt["index"].type() != String ||
+                pushdownElt["route"].type() != Array) {
+                return Status(ErrorCodes::FailedToParse,
+                              "malformed orPushdowns in plan cache snapshot");
+            }
+            BSONObj pushdownObj = pushdownElt.Obj();
+            OrPushdown orPushdown;
+            orPushdown.indexName = pushdownObj["index"].String();
+            if (!findIndexEntry(indexes, orPushdown.indexName)) {
+                return Status(ErrorCodes::IndexNotFound,
+                              str::stream() << "index " << orPushdown.indexName
+                                            << " from plan cache snapshot no longer exists");
+            }
+            auto pos = parseNonNegative(pushdownObj, "pos");
+            if (!pos.isOK()) {
+                return pos.getStatus();
+            }
+            orPushdown.position = pos.getValue();
+            orPushdown.canCombineBounds = pushdownObj["canCombineBounds"].trueValue();
+            for (auto&& routeElt : pushdownObj["route"].Obj()) {
+                if (!routeElt.isNumber() || routeElt.safeNumberLong() < 0) {
+                    return Status(ErrorCodes::FailedToParse,
+                                  "malformed orPushdowns in plan cache snapshot");
+                }
+                orPushdown.route.push_back(static_cast<size_t>(routeElt.safeNumberLong()));
+            }
+            tree->orPushdowns.push_back(std::move(orPushdown));
+        }
+    }
+
+    if (BSONElement childrenElt = obj["children"]) {
+        if (childrenElt.type() != Array) {
+            return Status(ErrorCodes::FailedToParse, "malformed children in plan cache snapshot");
+        }
+        for (auto&& childElt : childrenElt.Obj()) {
+            if (childElt.type() != Object) {
+                return Status(ErrorCodes::FailedToParse,
+                              "malformed children in plan cache snapshot");
+            }
+            auto child = parse(childElt.Obj(), indexes);
+            if (!child.isOK()) {
+                return child.getStatus();
+            }
+            tree->children.push_back(child.getValue().release());
+        }
+    }
+
+    return {std::move(tree)};
+}
+
 //
 // SolutionCacheData
 //
@@ -551,15 +738,141 @@ std::string SolutionCacheData::toString() const {
     MONGO_UNREACHABLE;
 }
 
+namespace {
+
+const char kWholeIxscanSolnType[] = "wholeIxscan";
+const char kCollscanSolnType[] = "collscan";
+const char kIndexTagsSolnType[] = "indexTags";
+
+}  // namespace
+
+BSONObj SolutionCacheData::toBSON() const {
+    BSONObjBuilder bob;
+    switch (solnType) {
+        case WHOLE_IXSCAN_SOLN:
+            bob.append("type", kWholeIxscanSolnType);
+            bob.append("direction", wholeIXSolnDir);
+            break;
+        case COLLSCAN_SOLN:
+            bob.append("type", kCollscanSolnType);
+            break;
+        case USE_INDEX_TAGS_SOLN:
+            bob.append("type", kIndexTagsSolnType);
+            break;
+    }
+    bob.append("indexFilterApplied", indexFilterApplied);
+    if (tree) {
+        bob.append("tree", tree->toBSON());
+    }
+    return bob.obj();
+}
+
+// static
+StatusWith<std::unique_ptr<SolutionCacheData>> SolutionCacheData::parse(
+    const BSONObj& obj, const std::vector<IndexEntry>& indexes) {
+    auto data = stdx::make_unique<SolutionCacheData>();
+
+    StringData type = obj["type"].type() == String ? obj["type"].valueStringData() : ""_sd;
+    if (type == kWholeIxscanSolnType) {
+        data->solnType = WHOLE_IXSCAN_SOLN;
+        data->wholeIXSolnDir = obj["direction"].numberInt() < 0 ? -1 : 1;
+    } else if (type == kCollscanSolnType) {
+        data->solnType = COLLSCAN_SOLN;
+    } else if (type == kIndexTagsSolnType) {
+        data->solnType = USE_INDEX_TAGS_SOLN;
+    } else {
+        return Status(ErrorCodes::FailedToParse, "unknown solution type in plan cache snapshot");
+    }
+    data->indexFilterApplied = obj["indexFilterApplied"].trueValue();
+
+    BSONElement treeElt = obj["tree"];
+    if (data->solnType == COLLSCAN_SOLN) {
+        return {std::move(data)};
+    }
+    if (treeElt.type() != Object) {
+        return Status(ErrorCodes::FailedToParse, "missing tree in plan cache snapshot");
+    }
+    auto tree = PlanCacheIndexTree::parse(treeElt.Obj(), indexes);
+    if (!tree.isOK()) {
+        return tree.getStatus();
+    }
+    data->tree = std::move(tree.getValue());
+    return {std::move(data)};
+}
+
+//
+// PlanCacheConstantRangePlan
+//
+
+PlanCacheConstantRangePlan PlanCacheConstantRangePlan::clone() const {
+    PlanCacheConstantRangePlan copy;
+    copy.low = low;
+    copy.high = high;
+    copy.solution.reset(solution->clone());
+    copy.works = works;
+    copy.hits = hits;
+    return copy;
+}
+
 //
 // PlanCache
 //
 
+namespace {
+
+/**
+ * Returns the first comparison predicate found by a pre-order traversal of 'tree' which only
+ * descends into $and nodes, or nullptr if there is none.
+ */
+const ComparisonMatchExpression* findLeadingComparison(const MatchExpression* tree) {
+    if (ComparisonMatchExpression::isComparisonMatchExpression(tree)) {
+        return static_cast<const ComparisonMatchExpression*>(tree);
+    }
+    if (MatchExpression::AND != tree->matchType()) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < tree->numChildren(); ++i) {
+        if (auto comparison = findLeadingComparison(tree->getChild(i))) {
+            return comparison;
+        }
+    }
+    return nullptr;
+}
+
+bool rangeContains(const PlanCacheConstantRangePlan& rangePlan, const BSONObj& constant) {
+    return SimpleBSONObjComparator::kInstance.evaluate(rangePlan.low <= constant) &&
+        SimpleBSONObjComparator::kInstance.evaluate(constant <= rangePlan.high);
+}
+
+bool rangesOverlap(const BSONObj& low,
+                   const BSONObj& high,
+                   const PlanCacheConstantRangePlan& other) {
+    return SimpleBSONObjComparator::kInstance.evaluate(low <= other.high) &&
+        SimpleBSONObjComparator::kInstance.evaluate(other.low <= high);
+}
+
+// Caches are split into at most this many stripes.
+const size_t kMaxStripes = 16;
+
+// No stripe holds fewer entries than this, so that small caches keep an exact LRU policy.
+const size_t kMinEntriesPerStripe = 64;
+
+}  // namespace
+
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) {
+    const size_t numStripes =
+        std::max(size_t(1), std::min(kMaxStripes, size / kMinEntriesPerStripe));
+    for (size_t i = 0; i < numStripes; ++i) {
+        const size_t stripeSize = size / numStripes + (i < size % numStripes ? 1 : 0);
+        _stripes.push_back(stdx::make_unique<Stripe>(stripeSize));
+    }
+}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : PlanCache(internalQueryCacheSize.load()) {
+    _ns = ns;
+}
 
 PlanCache::~PlanCache() {}
 
@@ -821,14 +1134,15 @@ Status PlanCache::set(const CanonicalQuery& query,
 
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Stripe& stripe = getStripe(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
     bool isNewEntryActive = false;
     if (internalQueryCacheDisableInactiveEntries.load()) {
         // All entries are always active.
         isNewEntryActive = true;
     } else {
         PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
+        Status cacheStatus = stripe.cache.get(key, &oldEntry);
         invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         auto newState = getNewEntryState(
             query,
@@ -843,38 +1157,69 @@ Status PlanCache::set(const CanonicalQuery& query,
     }
 
     auto newEntry = std::make_unique<PlanCacheEntry>(solns, why.release());
-    const QueryRequest& qr = query.getQueryRequest();
-    newEntry->query = qr.getFilter().getOwned();
-    newEntry->sort = qr.getSort().getOwned();
+    setEntryQueryShape(query, newEntry.get());
     newEntry->isActive = isNewEntryActive;
     newEntry->works = newWorks;
-    if (query.getCollator()) {
-        newEntry->collation = query.getCollator()->getSpec().toBSON();
-    }
     newEntry->timeOfCreation = now;
 
+    std::unique_ptr<PlanCacheEntry> evictedEntry = stripe.cache.add(key, newEntry.release());
 
-    // Strip projections on $-prefixed fields, as these are added by internal callers of the query
-    // system and are not considered part of the user projection.
-    BSONObjBuilder projBuilder;
-    for (auto elem : qr.getProj()) {
-        if (elem.fieldName()[0] == '$') {
-            continue;
-        }
-        projBuilder.append(elem);
+    if (NULL != evictedEntry.get()) {
+        stripe.evictions.fetchAndAdd(1);
+        LOG(1) << _ns << ": plan cache maximum size exceeded - "
+               << "removed least recently used entry " << redact(evictedEntry->toString());
     }
-    newEntry->projection = projBuilder.obj();
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    return Status::OK();
+}
 
-    if (NULL != evictedEntry.get()) {
+Status PlanCache::restore(const CanonicalQuery& query,
+                          const SolutionCacheData& solution,
+                          size_t works,
+                          Date_t now) {
+    if (!shouldCacheQuery(query)) {
+        return Status(ErrorCodes::BadValue,
+                      "query shape from plan cache snapshot is not cacheable");
+    }
+
+    QuerySolution soln;
+    soln.cacheData.reset(solution.clone());
+
+    auto decision = stdx::make_unique<PlanRankingDecision>();
+    decision->stats.push_back(
+        stdx::make_unique<PlanStageStats>(CommonStats("CACHED_PLAN"), STAGE_CACHED_PLAN));
+    decision->stats[0]->common.works = works;
+    decision->scores.push_back(0);
+    decision->candidateOrder.push_back(0);
+
+    auto newEntry = stdx::make_unique<PlanCacheEntry>(std::vector<QuerySolution*>{&soln},
+                                                      decision.release());
+    setEntryQueryShape(query, newEntry.get());
+    newEntry->isActive = true;
+    newEntry->works = works;
+    newEntry->timeOfCreation = now;
+    newEntry->restoredFromSnapshot = true;
+
+    const auto key = computeKey(query);
+    Stripe& stripe = getStripe(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    if (stripe.cache.hasKey(key)) {
+        return Status::OK();
+    }
+
+    std::unique_ptr<PlanCacheEntry> evictedEntry = stripe.cache.add(key, newEntry.release());
+    if (evictedEntry) {
+        stripe.evictions.fetchAndAdd(1);
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << redact(evictedEntry->toString());
     }
-
     return Status::OK();
 }
 
+bool PlanCache::markSnapshotRestoreAttempted() {
+    return !_snapshotRestoreAttempted.swap(true);
+}
+
 void PlanCache::deactivate(const CanonicalQuery& query) {
     if (internalQueryCacheDisableInactiveEntries.load()) {
         // This is a noop if inactive entries are disabled.
@@ -882,9 +1227,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Stripe& stripe = getStripe(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = stripe.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
@@ -895,31 +1241,144 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
 
 PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
+    Stripe& stripe = getStripe(key);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = stripe.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
+        stripe.misses.fetchAndAdd(1);
         return {CacheEntryState::kNotPresent, nullptr};
     }
     invariant(entry);
+    stripe.hits.fetchAndAdd(1);
 
     auto state =
         entry->isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
+
+    if (!entry->constantRangePlans.empty()) {
+        const BSONObj constant = getLeadingConstant(query);
+        for (auto&& rangePlan : entry->constantRangePlans) {
+            if (!constant.isEmpty() && rangeContains(rangePlan, constant)) {
+                ++rangePlan.hits;
+                return {state, stdx::make_unique<CachedSolution>(key, *entry, rangePlan)};
+            }
+        }
+    }
+
     return {state, stdx::make_unique<CachedSolution>(key, *entry)};
 }
 
+Status PlanCache::addConstantRangePlan(const CanonicalQuery& query,
+                                       const QuerySolution& solution,
+                                       size_t works) {
+    const size_t maxPlans = static_cast<size_t>(internalQueryCacheMaxPlansPerShape.load());
+    if (maxPlans <= 1U) {
+        return Status(ErrorCodes::BadValue, "constant-range plans are disabled");
+    }
+
+    if (!solution.cacheData) {
+        return Status(ErrorCodes::BadValue, "solution has no cache data");
+    }
+
+    const BSONObj constant = getLeadingConstant(query);
+    if (constant.isEmpty()) {
+        return Status(ErrorCodes::BadValue, "query has no leading constant");
+    }
+
+    const auto key = computeKey(query);
+    Stripe& stripe = getStripe(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    PlanCacheEntry* entry = nullptr;
+    Status cacheStatus = stripe.cache.get(key, &entry);
+    if (!cacheStatus.isOK()) {
+        return cacheStatus;
+    }
+    invariant(entry);
+
+    auto& rangePlans = entry->constantRangePlans;
+    const std::string solutionStr = solution.cacheData->toString();
+
+    // If the plan which was just replanned was itself a constant-range plan, it is only right for
+    // this constant if replanning picked the same solution again.
+    for (auto it = rangePlans.begin(); it != rangePlans.end(); ++it) {
+        if (rangeContains(*it, constant)) {
+            if (it->solution->toString() == solutionStr) {
+                it->works = std::max(it->works, works);
+                return Status::OK();
+            }
+            rangePlans.erase(it);
+            break;
+        }
+    }
+
+    // Extend the range of a plan with the same solution, provided that the extended range does
+    // not overlap any other plan's range.
+    for (auto&& rangePlan : rangePlans) {
+        if (rangePlan.solution->toString() != solutionStr) {
+            continue;
+        }
+
+        const BSONObj& low = SimpleBSONObjComparator::kInstance.evaluate(constant < rangePlan.low)
+            ? constant
+            : rangePlan.low;
+        const BSONObj& high =
+            SimpleBSONObjComparator::kInstance.evaluate(rangePlan.high < constant)
+            ? constant
+            : rangePlan.high;
+        const bool overlaps =
+            std::any_of(rangePlans.begin(), rangePlans.end(), [&](const auto& other) {
+                return &other != &rangePlan && rangesOverlap(low, high, other);
+            });
+        if (!overlaps) {
+            rangePlan.low = low;
+            rangePlan.high = high;
+            rangePlan.works = std::max(rangePlan.works, works);
+            return Status::OK();
+        }
+    }
+
+    if (rangePlans.size() >= maxPlans - 1) {
+        // Make room by dropping the least used constant-range plan.
+        rangePlans.erase(std::min_element(
+            rangePlans.begin(), rangePlans.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.hits < rhs.hits;
+            }));
+    }
+
+    PlanCacheConstantRangePlan rangePlan;
+    rangePlan.low = constant;
+    rangePlan.high = constant;
+    rangePlan.solution.reset(solution.cacheData->clone());
+    rangePlan.works = works;
+    rangePlans.push_back(std::move(rangePlan));
+
+    LOG(1) << _ns << ": added constant-range plan for " << redact(query.toStringShort())
+           << ", shape now has " << rangePlans.size() << " constant-range plans";
+    return Status::OK();
+}
+
+// static
+BSONObj PlanCache::getLeadingConstant(const CanonicalQuery& query) {
+    const ComparisonMatchExpression* comparison = findLeadingComparison(query.root());
+    if (!comparison) {
+        return BSONObj();
+    }
+    return comparison->getData().wrap("");
+}
+
 Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback) {
     if (NULL == feedback) {
         return Status(ErrorCodes::BadValue, "feedback is NULL");
     }
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
     PlanCacheKey ck = computeKey(cq);
+    Stripe& stripe = getStripe(ck);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = stripe.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -934,13 +1393,17 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheKey key = computeKey(canonicalQuery);
+    Stripe& stripe = getStripe(key);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
+    return stripe.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+        stripe->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -953,10 +1416,11 @@ PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
 
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
+    Stripe& stripe = getStripe(key);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    stdx::lock_guard<stdx::mutex> cacheLock(stripe.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = stripe.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -966,20 +1430,52 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
     typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+        for (ConstIterator i = stripe->cache.begin(); i != stripe->cache.end(); i++) {
+            PlanCacheEntry* entry = i->second;
+            entries.push_back(entry->clone());
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+        size += stripe->cache.size();
+    }
+    return size;
+}
+
+void PlanCache::appendStripeStats(BSONObjBuilder* bob) const {
+    BSONArrayBuilder stripesBuilder(bob->subarrayStart("stripes"));
+    for (auto&& stripe : _stripes) {
+        size_t numEntries;
+        {
+            stdx::lock_guard<stdx::mutex> cacheLock(stripe->mutex);
+            numEntries = stripe->cache.size();
+        }
+
+        BSONObjBuilder stripeBuilder(stripesBuilder.subobjStart());
+        stripeBuilder.appendNumber("entries", static_cast<long long>(numEntries));
+        stripeBuilder.appendNumber("hits", static_cast<long long>(stripe->hits.load()));
+        stripeBuilder.appendNumber("misses", static_cast<long long>(stripe->misses.load()));
+        stripeBuilder.appendNumber("evictions", static_cast<long long>(stripe->evictions.load()));
+        stripeBuilder.doneFast();
+    }
+    stripesBuilder.doneFast();
+}
+
+PlanCache::Stripe& PlanCache::getStripe(const PlanCacheKey& key) const {
+    if (_stripes.size() == 1U) {
+        return *_stripes.front();
+    }
+    return *_stripes[std::hash<PlanCacheKey>()(key) % _stripes.size()];
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
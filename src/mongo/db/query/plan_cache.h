@@ -29,7 +29,9 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
@@ -124,6 +126,19 @@ struct PlanCacheIndexTree {
      */
     std::string toString(int indents = 0) const;
 
+    /**
+     * Serializes the tree for a plan cache snapshot. Indexes are recorded by name, along with the
+     * key pattern of each tagged index.
+     */
+    BSONObj toBSON() const;
+
+    /**
+     * Rebuilds a tree serialized by toBSON(), taking the index entries from 'indexes'. Fails if the
+     * tree refers to an index which is not in 'indexes', or whose key pattern has changed.
+     */
+    static StatusWith<std::unique_ptr<PlanCacheIndexTree>> parse(
+        const BSONObj& obj, const std::vector<IndexEntry>& indexes);
+
     // Children owned here.
     std::vector<PlanCacheIndexTree*> children;
 
@@ -159,6 +174,14 @@ struct SolutionCacheData {
     // For debugging.
     std::string toString() const;
 
+    // Serializes the data for a plan cache snapshot.
+    BSONObj toBSON() const;
+
+    // Rebuilds data serialized by toBSON() against the current 'indexes' of the collection. See
+    // PlanCacheIndexTree::parse().
+    static StatusWith<std::unique_ptr<SolutionCacheData>> parse(
+        const BSONObj& obj, const std::vector<IndexEntry>& indexes);
+
     // Owned here. If 'wholeIXSoln' is false, then 'tree'
     // can be used to tag an isomorphic match expression. If 'wholeIXSoln'
     // is true, then 'tree' is used to store the relevant IndexEntry.
@@ -188,6 +211,33 @@ struct SolutionCacheData {
     bool indexFilterApplied;
 };
 
+/**
+ * A plan cached for a range of values of a query shape's leading constant, which is the operand of
+ * the first comparison predicate in the canonical match expression. It is used in place of the
+ * main plan of its PlanCacheEntry when a query's leading constant falls within ['low', 'high'].
+ *
+ * Constant-range plans are added when the main plan had to be replanned because it performed
+ * poorly for a particular constant, which happens for shapes whose values have skewed selectivity.
+ */
+struct PlanCacheConstantRangePlan {
+    PlanCacheConstantRangePlan clone() const;
+
+    // The bounds of the range of leading constants, inclusive. Each is an object holding a single
+    // element with an empty field name.
+    BSONObj low;
+    BSONObj high;
+
+    // The winning solution of the replanning which created this plan.
+    std::unique_ptr<SolutionCacheData> solution;
+
+    // The number of works the solution needed to win. This is the replanning threshold used when
+    // running this plan from the cache.
+    size_t works = 0;
+
+    // The number of cache lookups which returned this plan.
+    size_t hits = 0;
+};
+
 class PlanCacheEntry;
 
 /**
@@ -199,6 +249,14 @@ private:
 
 public:
     CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry);
+
+    /**
+     * Creates a CachedSolution which uses 'rangePlan' instead of the main plan of 'entry'.
+     */
+    CachedSolution(const PlanCacheKey& key,
+                   const PlanCacheEntry& entry,
+                   const PlanCacheConstantRangePlan& rangePlan);
+
     ~CachedSolution();
 
     // Owned here.
@@ -290,6 +348,13 @@ public:
     // trigger a replan. Running a query of the same shape while this cache entry is inactive may
     // cause this value to be increased.
     size_t works = 0;
+
+    // Plans used instead of the main plan for ranges of the leading constant. There are at most
+    // 'internalQueryCacheMaxPlansPerShape' - 1 of them, and their ranges do not overlap.
+    std::vector<PlanCacheConstantRangePlan> constantRangePlans;
+
+    // Whether the entry was loaded from a plan cache snapshot rather than created by planning.
+    bool restoredFromSnapshot = false;
 };
 
 /**
@@ -367,6 +432,25 @@ public:
                Date_t now,
                boost::optional<double> worksGrowthCoefficient = boost::none);
 
+    /**
+     * Adds an active entry for 'query' which uses 'solution', a plan loaded from a plan cache
+     * snapshot that needed 'works' works to win when it was first cached. The entry's decision
+     * holds a single CACHED_PLAN stage recording those works.
+     *
+     * Does nothing and returns Status::OK() if the cache already has an entry for the query shape,
+     * since that entry reflects the current data better than the snapshot.
+     */
+    Status restore(const CanonicalQuery& query,
+                   const SolutionCacheData& solution,
+                   size_t works,
+                   Date_t now);
+
+    /**
+     * Returns true the first time it is called on this cache and false afterwards. Used to load a
+     * plan cache snapshot into the cache at most once.
+     */
+    bool markSnapshotRestoreAttempted();
+
     /**
      * Set a cache entry back to the 'inactive' state. Rather than completely evicting an entry
      * when the associated plan starts to perform poorly, we deactivate it, so that plans which
@@ -405,6 +489,27 @@ public:
      */
     Status feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback);
 
+    /**
+     * Records that replanning 'query' after its cached plan performed poorly picked 'solution',
+     * which needed 'works' works to win. The solution is cached as a constant-range plan covering
+     * the query's leading constant, so that later queries with nearby constants use it instead of
+     * replanning again. If an existing constant-range plan uses the same solution, its range is
+     * extended to cover the constant instead.
+     *
+     * Returns an error Status if there is no entry for 'query', if the query has no leading
+     * constant, or if constant-range plans are disabled.
+     */
+    Status addConstantRangePlan(const CanonicalQuery& query,
+                                const QuerySolution& solution,
+                                size_t works);
+
+    /**
+     * Returns the operand of the first comparison predicate in the canonical match expression of
+     * 'query', wrapped in an object with an empty field name, or an empty object if the query has
+     * no comparison predicate.
+     */
+    static BSONObj getLeadingConstant(const CanonicalQuery& query);
+
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
      * was present and removed and an error status otherwise.
@@ -449,6 +554,12 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Appends an array named "stripes" to 'bob' with the number of entries and the hit, miss
+     * and eviction counters of each partition of the cache.
+     */
+    void appendStripeStats(BSONObjBuilder* bob) const;
+
     /**
      * Updates internal state kept about the collection's indexes.  Must be called when the set
      * of indexes on the associated collection have changed.
@@ -468,14 +579,40 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
+    /**
+     * One partition of the cache. Each query shape is assigned to a stripe by the hash of its
+     * cache key, so that operations on different shapes rarely contend for the same mutex.
+     */
+    struct Stripe {
+        explicit Stripe(size_t size) : cache(size) {}
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+
+        // Protects 'cache'. The counters below are not protected by this mutex.
+        stdx::mutex mutex;
+
+        // Number of get() calls which found an entry for the query shape.
+        AtomicUInt64 hits;
+
+        // Number of get() calls which found no entry for the query shape.
+        AtomicUInt64 misses;
+
+        // Number of entries removed to make room for a new entry.
+        AtomicUInt64 evictions;
+    };
+
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    /**
+     * Returns the stripe which holds the entry for 'key', if there is one.
+     */
+    Stripe& getStripe(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    // The partitions of the cache. Their number and sizes are fixed at construction, and their
+    // sizes sum to the maximum number of entries in the cache.
+    std::vector<std::unique_ptr<Stripe>> _stripes;
 
     // Full namespace of collection.
     std::string _ns;
@@ -486,6 +623,9 @@ private:
     // Concurrent access is synchronized by the collection lock.  Multiple concurrent readers
     // are allowed.
     PlanCacheIndexabilityState _indexabilityState;
+
+    // Set once a plan cache snapshot has been looked for.
+    AtomicWord<bool> _snapshotRestoreAttempted{false};
 };
 
 }  // namespace mongo
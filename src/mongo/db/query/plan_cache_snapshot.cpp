@@ -0,0 +1,363 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_snapshot.h"
+
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/query/query_settings.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/service_context.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+const char kNsField[] = "ns";
+const char kKindField[] = "kind";
+const char kKeyField[] = "key";
+const char kQueryField[] = "query";
+const char kSortField[] = "sort";
+const char kProjectionField[] = "projection";
+const char kCollationField[] = "collation";
+const char kWorksField[] = "works";
+const char kSolutionField[] = "solution";
+const char kIndexKeyPatternsField[] = "indexKeyPatterns";
+const char kIndexNamesField[] = "indexNames";
+
+const char kPlanKind[] = "plan";
+const char kFilterKind[] = "filter";
+
+StatusWith<std::unique_ptr<CanonicalQuery>> canonicalizeShape(OperationContext* opCtx,
+                                                              const NamespaceString& nss,
+                                                              const BSONObj& shape) {
+    if (shape[kQueryField].type() != Object) {
+        return Status(ErrorCodes::FailedToParse, "plan cache snapshot field 'query' is missing");
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    for (auto&& field : {kQueryField, kSortField, kProjectionField, kCollationField}) {
+        BSONElement elt = shape[field];
+        if (!elt.eoo() && elt.type() != Object) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "plan cache snapshot field '" << field
+                                        << "' must be an object");
+        }
+    }
+    qr->setFilter(shape[kQueryField].Obj().getOwned());
+    if (shape.hasField(kSortField)) {
+        qr->setSort(shape[kSortField].Obj().getOwned());
+    }
+    if (shape.hasField(kProjectionField)) {
+        qr->setProj(shape[kProjectionField].Obj().getOwned());
+    }
+    if (shape.hasField(kCollationField)) {
+        qr->setCollation(shape[kCollationField].Obj().getOwned());
+    }
+
+    const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    return CanonicalQuery::canonicalize(opCtx,
+                                        std::move(qr),
+                                        expCtx,
+                                        extensionsCallback,
+                                        MatchExpressionParser::kAllowAllSpecialFeatures);
+}
+
+void appendShape(const BSONObj& query,
+                 const BSONObj& sort,
+                 const BSONObj& projection,
+                 const BSONObj& collation,
+                 BSONObjBuilder* bob) {
+    bob->append(kQueryField, query);
+    bob->append(kSortField, sort);
+    bob->append(kProjectionField, projection);
+    if (!collation.isEmpty()) {
+        bob->append(kCollationField, collation);
+    }
+}
+
+std::vector<IndexEntry> getIndexEntries(OperationContext* opCtx, Collection* collection) {
+    std::vector<IndexEntry> indexes;
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii.more()) {
+        const IndexDescriptor* desc = ii.next();
+        IndexCatalogEntry* ice = ii.catalogEntry(desc);
+        indexes.emplace_back(desc->keyPattern(),
+                             desc->getAccessMethodName(),
+                             desc->isMultikey(opCtx),
+                             ice->getMultikeyPaths(opCtx),
+                             desc->isSparse(),
+                             desc->unique(),
+                             desc->indexName(),
+                             ice->getFilterExpression(),
+                             desc->infoObj(),
+                             ice->getCollator());
+    }
+    return indexes;
+}
+
+/**
+ * Restores a single snapshot document. Returns a non-OK status describing why the document was
+ * skipped.
+ */
+Status restoreSnapshotDoc(OperationContext* opCtx,
+                          Collection* collection,
+                          const std::vector<IndexEntry>& indexes,
+                          const BSONObj& doc,
+                          Date_t now) {
+    auto statusWithCQ = canonicalizeShape(opCtx, collection->ns(), doc);
+    if (!statusWithCQ.isOK()) {
+        return statusWithCQ.getStatus();
+    }
+    const CanonicalQuery& cq = *statusWithCQ.getValue();
+
+    PlanCache* planCache = collection->infoCache()->getPlanCache();
+    const PlanCacheKey key = planCache->computeKey(cq);
+    if (doc[kKeyField].type() != String || doc[kKeyField].valueStringData() != key) {
+        return Status(ErrorCodes::BadValue,
+                      "query shape no longer maps to the snapshotted plan cache key");
+    }
+
+    StringData kind = doc[kKindField].type() == String ? doc[kKindField].valueStringData() : ""_sd;
+    if (kind == kPlanKind) {
+        if (doc[kSolutionField].type() != Object || !doc[kWorksField].isNumber()) {
+            return Status(ErrorCodes::FailedToParse, "malformed plan cache snapshot entry");
+        }
+        auto solution = SolutionCacheData::parse(doc[kSolutionField].Obj(), indexes);
+        if (!solution.isOK()) {
+            return solution.getStatus();
+        }
+        long long works = std::max(0LL, doc[kWorksField].safeNumberLong());
+        return planCache->restore(cq, *solution.getValue(), works, now);
+    }
+
+    if (kind == kFilterKind) {
+        if (doc[kIndexKeyPatternsField].type() != Array ||
+            doc[kIndexNamesField].type() != Array) {
+            return Status(ErrorCodes::FailedToParse, "malformed plan cache snapshot filter");
+        }
+        BSONObjSet keyPatterns = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (auto&& elt : doc[kIndexKeyPatternsField].Obj()) {
+            if (elt.type() != Object) {
+                return Status(ErrorCodes::FailedToParse, "malformed plan cache snapshot filter");
+            }
+            keyPatterns.insert(elt.Obj().getOwned());
+        }
+        stdx::unordered_set<std::string> names;
+        for (auto&& elt : doc[kIndexNamesField].Obj()) {
+            if (elt.type() != String) {
+                return Status(ErrorCodes::FailedToParse, "malformed plan cache snapshot filter");
+            }
+            names.insert(elt.String());
+        }
+
+        // As with planCacheSetFilter, a filter may name indexes which do not exist.
+        QuerySettings* querySettings = collection->infoCache()->getQuerySettings();
+        if (!querySettings->getAllowedIndicesFilter(key)) {
+            querySettings->setAllowedIndices(cq, key, keyPatterns, names);
+        }
+        return Status::OK();
+    }
+
+    return Status(ErrorCodes::FailedToParse, "unknown kind of plan cache snapshot document");
+}
+
+}  // namespace
+
+StatusWith<size_t> writePlanCacheSnapshot(OperationContext* opCtx, const NamespaceString& nss) {
+    std::vector<BSONObj> docs;
+    {
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            return Status(ErrorCodes::NamespaceNotFound,
+                          str::stream() << "collection " << nss.ns() << " does not exist");
+        }
+
+        PlanCache* planCache = collection->infoCache()->getPlanCache();
+        std::vector<std::unique_ptr<PlanCacheEntry>> entries;
+        for (auto entry : planCache->getAllEntries()) {
+            entries.emplace_back(entry);
+        }
+
+        for (auto&& entry : entries) {
+            // Inactive entries have not yet proven their plan and are not worth restoring.
+            if (!entry->isActive || entry->plannerData.empty()) {
+                continue;
+            }
+
+            BSONObjBuilder shapeBuilder;
+            appendShape(
+                entry->query, entry->sort, entry->projection, entry->collation, &shapeBuilder);
+            BSONObj shape = shapeBuilder.obj();
+            auto statusWithCQ = canonicalizeShape(opCtx, nss, shape);
+            if (!statusWithCQ.isOK()) {
+                continue;
+            }
+
+            BSONObjBuilder bob;
+            bob.append(kNsField, nss.ns());
+            bob.append(kKindField, kPlanKind);
+            bob.append(kKeyField, planCache->computeKey(*statusWithCQ.getValue()));
+            bob.appendElements(shape);
+            bob.appendNumber(kWorksField, static_cast<long long>(entry->works));
+            bob.append(kSolutionField, entry->plannerData[0]->toBSON());
+            docs.push_back(bob.obj());
+        }
+
+        QuerySettings* querySettings = collection->infoCache()->getQuerySettings();
+        for (auto&& filter : querySettings->getAllAllowedIndices()) {
+            BSONObjBuilder shapeBuilder;
+            appendShape(
+                filter.query, filter.sort, filter.projection, filter.collation, &shapeBuilder);
+            BSONObj shape = shapeBuilder.obj();
+            auto statusWithCQ = canonicalizeShape(opCtx, nss, shape);
+            if (!statusWithCQ.isOK()) {
+                continue;
+            }
+
+            BSONObjBuilder bob;
+            bob.append(kNsField, nss.ns());
+            bob.append(kKindField, kFilterKind);
+            bob.append(kKeyField, planCache->computeKey(*statusWithCQ.getValue()));
+            bob.appendElements(shape);
+            BSONArrayBuilder keyPatternsBuilder(bob.subarrayStart(kIndexKeyPatternsField));
+            for (auto&& keyPattern : filter.indexKeyPatterns) {
+                keyPatternsBuilder.append(keyPattern);
+            }
+            keyPatternsBuilder.doneFast();
+            BSONArrayBuilder namesBuilder(bob.subarrayStart(kIndexNamesField));
+            for (auto&& name : filter.indexNames) {
+                namesBuilder.append(name);
+            }
+            namesBuilder.doneFast();
+            docs.push_back(bob.obj());
+        }
+    }
+
+    // The collection lock is released before writing, so that the snapshot collection is never
+    // locked while another collection's lock is held.
+    const NamespaceString& snapshotNss = NamespaceString::kPlanCacheSnapshotNamespace;
+    DBDirectClient client(opCtx);
+    BSONObj res;
+    client.runCommand(snapshotNss.db().toString(),
+                      BSON("delete" << snapshotNss.coll() << "deletes"
+                                    << BSON_ARRAY(BSON("q" << BSON(kNsField << nss.ns()) << "limit"
+                                                           << 0))),
+                      res);
+    Status status = getStatusFromWriteCommandReply(res);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    for (auto&& doc : docs) {
+        client.runCommand(snapshotNss.db().toString(),
+                          BSON("insert" << snapshotNss.coll() << "documents" << BSON_ARRAY(doc)),
+                          res);
+        status = getStatusFromWriteCommandReply(res);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    LOG(1) << "Wrote plan cache snapshot of " << nss << " with " << docs.size() << " entries";
+    return docs.size();
+}
+
+void restorePlanCacheSnapshotIfNeeded(OperationContext* opCtx, Collection* collection) {
+    if (!internalQueryPlanCacheRestoreFromSnapshot.load()) {
+        return;
+    }
+
+    // The snapshot collection lives in an internal database, and is never restored into itself.
+    // A snapshot read would see the snapshot as of its read timestamp, so it waits for a later
+    // operation.
+    const NamespaceString& nss = collection->ns();
+    if (nss.isOnInternalDb() ||
+        repl::ReadConcernArgs::get(opCtx).getLevel() ==
+            repl::ReadConcernLevel::kSnapshotReadConcern) {
+        return;
+    }
+
+    PlanCache* planCache = collection->infoCache()->getPlanCache();
+    if (!planCache->markSnapshotRestoreAttempted()) {
+        return;
+    }
+
+    const std::vector<IndexEntry> indexes = getIndexEntries(opCtx, collection);
+    const Date_t now = opCtx->getServiceContext()->getFastClockSource()->now();
+    size_t numRestored = 0;
+    size_t numSkipped = 0;
+    try {
+        DBDirectClient client(opCtx);
+        auto cursor = client.query(NamespaceString::kPlanCacheSnapshotNamespace.ns(),
+                                   QUERY(kNsField << nss.ns()));
+        while (cursor && cursor->more()) {
+            BSONObj doc = cursor->nextSafe();
+            Status status = restoreSnapshotDoc(opCtx, collection, indexes, doc, now);
+            if (status.isOK()) {
+                ++numRestored;
+            } else {
+                ++numSkipped;
+                LOG(2) << "Skipping plan cache snapshot entry " << redact(doc) << ": " << status;
+            }
+        }
+    } catch (const DBException& ex) {
+        warning() << "Failed to restore plan cache snapshot of " << nss << ": " << redact(ex);
+        return;
+    }
+
+    if (numRestored || numSkipped) {
+        LOG(1) << "Restored " << numRestored << " plan cache snapshot entries of " << nss
+               << ", skipped " << numSkipped;
+    }
+}
+
+}  // namespace mongo
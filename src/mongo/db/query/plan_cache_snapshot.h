@@ -0,0 +1,66 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+
+namespace mongo {
+
+class Collection;
+class NamespaceString;
+class OperationContext;
+
+/**
+ * Plan cache snapshots let a node start with the plans a collection had already settled on,
+ * rather than replanning every query shape after a restart or an election. A snapshot holds one
+ * document per active plan cache entry and per index filter of a collection, and is stored in
+ * NamespaceString::kPlanCacheSnapshotNamespace so that it is replicated to the whole set.
+ */
+
+/**
+ * Replaces the snapshot of the collection 'nss' with its current active plan cache entries and
+ * index filters. Returns the number of documents written.
+ */
+StatusWith<size_t> writePlanCacheSnapshot(OperationContext* opCtx, const NamespaceString& nss);
+
+/**
+ * Loads the snapshot of 'collection' into its plan cache and index filters, the first time this is
+ * called for the collection and only if 'internalQueryPlanCacheRestoreFromSnapshot' is enabled.
+ *
+ * Each entry is validated against the current index catalog: its shape must still produce the
+ * cache key it was snapshotted under, which depends on the PlanCacheIndexabilityState of the
+ * collection's indexes, and every index its plan uses must still exist with the same key pattern.
+ * Entries failing validation are skipped, as are errors reading the snapshot, which are logged.
+ *
+ * Must be called with the collection locked in at least MODE_IS.
+ */
+void restorePlanCacheSnapshotIfNeeded(OperationContext* opCtx, Collection* collection);
+
+}  // namespace mongo
@@ -508,6 +508,129 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, StripedCacheTracksEntriesAndCountersPerStripe) {
+    PlanCache planCache(16 * 64);
+    QueryTestServiceContext serviceContext;
+
+    const int kNumShapes = 50;
+    for (int i = 0; i < kNumShapes; ++i) {
+        unique_ptr<CanonicalQuery> cq(canonicalize(BSON(("a" + std::to_string(i)) << 1)));
+        addCacheEntryForShape(*cq, &planCache);
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+    unique_ptr<CanonicalQuery> missing(canonicalize("{b: 1}"));
+    ASSERT_EQ(planCache.get(*missing).state, PlanCache::CacheEntryState::kNotPresent);
+
+    ASSERT_EQ(planCache.size(), static_cast<size_t>(kNumShapes));
+    std::vector<PlanCacheEntry*> entries = planCache.getAllEntries();
+    ASSERT_EQ(entries.size(), static_cast<size_t>(kNumShapes));
+    for (auto entry : entries) {
+        delete entry;
+    }
+
+    BSONObjBuilder bob;
+    planCache.appendStripeStats(&bob);
+    BSONObj stats = bob.obj();
+    std::vector<BSONElement> stripes = stats["stripes"].Array();
+    ASSERT_EQ(stripes.size(), 16U);
+
+    long long totalEntries = 0;
+    long long totalHits = 0;
+    long long totalMisses = 0;
+    long long totalEvictions = 0;
+    for (auto&& stripe : stripes) {
+        totalEntries += stripe["entries"].numberLong();
+        totalHits += stripe["hits"].numberLong();
+        totalMisses += stripe["misses"].numberLong();
+        totalEvictions += stripe["evictions"].numberLong();
+    }
+    ASSERT_EQ(totalEntries, kNumShapes);
+    ASSERT_EQ(totalHits, kNumShapes);
+    ASSERT_EQ(totalMisses, 1);
+    ASSERT_EQ(totalEvictions, 0);
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+}
+
+TEST(PlanCacheTest, ConstantRangePlansAreUsedForTheirRangeOfLeadingConstants) {
+    internalQueryCacheMaxPlansPerShape.store(3);
+    ON_BLOCK_EXIT([] { internalQueryCacheMaxPlansPerShape.store(1); });
+
+    PlanCache planCache;
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cq5(canonicalize("{a: 5}"));
+    unique_ptr<CanonicalQuery> cq6(canonicalize("{a: 6}"));
+    unique_ptr<CanonicalQuery> cq7(canonicalize("{a: 7}"));
+    unique_ptr<CanonicalQuery> cq100(canonicalize("{a: 100}"));
+
+    // Adding a constant-range plan requires an existing entry.
+    auto collscan = getQuerySolutionForCaching();
+    collscan->cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    ASSERT_NOT_OK(planCache.addConstantRangePlan(*cq5, *collscan, 50U));
+
+    addCacheEntryForShape(*cq5, &planCache);
+    ASSERT_OK(planCache.addConstantRangePlan(*cq5, *collscan, 50U));
+
+    auto result = planCache.get(*cq5);
+    ASSERT(result.cachedSolution);
+    ASSERT_EQ(result.cachedSolution->plannerData[0]->solnType, SolutionCacheData::COLLSCAN_SOLN);
+    ASSERT_EQ(result.cachedSolution->decisionWorks, 50U);
+
+    // The same solution winning for another constant extends the range of the existing plan.
+    ASSERT_OK(planCache.addConstantRangePlan(*cq7, *collscan, 20U));
+    result = planCache.get(*cq6);
+    ASSERT_EQ(result.cachedSolution->plannerData[0]->solnType, SolutionCacheData::COLLSCAN_SOLN);
+    ASSERT_EQ(result.cachedSolution->decisionWorks, 50U);
+
+    // Constants outside of the range use the entry's main plan.
+    result = planCache.get(*cq100);
+    ASSERT_EQ(result.cachedSolution->plannerData[0]->solnType,
+              SolutionCacheData::USE_INDEX_TAGS_SOLN);
+
+    auto entry = unittest::assertGet(planCache.getEntry(*cq5));
+    ASSERT_EQ(entry->constantRangePlans.size(), 1U);
+    ASSERT_BSONOBJ_EQ(entry->constantRangePlans[0].low, BSON("" << 5));
+    ASSERT_BSONOBJ_EQ(entry->constantRangePlans[0].high, BSON("" << 7));
+    ASSERT_EQ(entry->constantRangePlans[0].hits, 2U);
+
+    // A query with no comparison predicate has no leading constant.
+    unique_ptr<CanonicalQuery> cqIn(canonicalize("{a: {$in: [1, 2]}}"));
+    ASSERT_BSONOBJ_EQ(PlanCache::getLeadingConstant(*cqIn), BSONObj());
+    ASSERT_BSONOBJ_EQ(PlanCache::getLeadingConstant(*cq6), BSON("" << 6));
+
+    // Constant-range plans can be disabled.
+    internalQueryCacheMaxPlansPerShape.store(1);
+    ASSERT_NOT_OK(planCache.addConstantRangePlan(*cq100, *collscan, 50U));
+}
+
+TEST(PlanCacheTest, RestoreAddsActiveEntryUnlessShapeIsCached) {
+    PlanCache planCache;
+    QueryTestServiceContext serviceContext;
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+    unique_ptr<CanonicalQuery> cqB(canonicalize("{b: 1}"));
+
+    auto collscan = getQuerySolutionForCaching();
+    collscan->cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    ASSERT_OK(planCache.restore(*cqA, *collscan->cacheData, 42U, Date_t{}));
+
+    auto result = planCache.get(*cqA);
+    ASSERT_EQ(result.state, PlanCache::CacheEntryState::kPresentActive);
+    ASSERT_EQ(result.cachedSolution->decisionWorks, 42U);
+    auto entry = unittest::assertGet(planCache.getEntry(*cqA));
+    ASSERT_TRUE(entry->restoredFromSnapshot);
+    ASSERT_EQ(entry->decision->stats[0]->common.works, 42U);
+
+    // An entry created by planning is not replaced by a restored one.
+    addCacheEntryForShape(*cqB, &planCache);
+    ASSERT_OK(planCache.restore(*cqB, *collscan->cacheData, 1U, Date_t{}));
+    ASSERT_EQ(planCache.get(*cqB).state, PlanCache::CacheEntryState::kPresentInactive);
+    ASSERT_FALSE(unittest::assertGet(planCache.getEntry(*cqB))->restoredFromSnapshot);
+
+    ASSERT_TRUE(planCache.markSnapshotRestoreAttempted());
+    ASSERT_FALSE(planCache.markSnapshotRestoreAttempted());
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -1292,6 +1415,33 @@ TEST_F(CachePlanSelectionTest, MergeSort) {
         "[{ixscan: {pattern: {a: 1, c: 1}}}, {ixscan: {pattern: {b: 1, c: 1}}}]}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, SnapshotOfCacheDataRecoversSolution) {
+    addIndex(BSON("a" << 1 << "c" << 1), "a_1_c_1");
+    addIndex(BSON("b" << 1 << "c" << 1), "b_1_c_1");
+
+    BSONObj query = fromjson("{$or: [{a:1}, {b:1}]}");
+    BSONObj sort = BSON("c" << 1);
+    runQuerySortProj(query, sort, BSONObj());
+
+    const string solnJson =
+        "{fetch: {node: {mergeSort: {nodes: "
+        "[{ixscan: {pattern: {a: 1, c: 1}}}, {ixscan: {pattern: {b: 1, c: 1}}}]}}}}";
+    BSONObj snapshot = firstMatchingSolution(solnJson)->cacheData->toBSON();
+
+    QuerySolution restored;
+    restored.cacheData = unittest::assertGet(SolutionCacheData::parse(snapshot, params.indices));
+    ASSERT_BSONOBJ_EQ(snapshot, restored.cacheData->toBSON());
+    auto planSoln = planQueryFromCache(query, sort, BSONObj(), BSONObj(), restored);
+    assertSolutionMatches(planSoln.get(), solnJson);
+
+    // The snapshot cannot be restored once an index it uses is dropped or redefined.
+    std::vector<IndexEntry> indexes = params.indices;
+    indexes.pop_back();
+    ASSERT_EQ(SolutionCacheData::parse(snapshot, indexes).getStatus(), ErrorCodes::IndexNotFound);
+    indexes.push_back(IndexEntry(BSON("b" << 1), false, false, false, "b_1_c_1", NULL, BSONObj()));
+    ASSERT_EQ(SolutionCacheData::parse(snapshot, indexes).getStatus(), ErrorCodes::IndexNotFound);
+}
+
 // SERVER-1205 as well.
 TEST_F(CachePlanSelectionTest, NoMergeSortIfNoSortWanted) {
     addIndex(BSON("a" << 1 << "c" << 1), "a_1_c_1");
@@ -32,6 +32,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -57,6 +59,51 @@ bool scoreComparator(const std::pair<double, size_t>& lhs, const std::pair<doubl
     return lhs.first > rhs.first;
 }
 
+/**
+ * Collects the names of the indexes used by the solution tree rooted at 'node' into 'names'.
+ */
+void getIndexNames(const mongo::QuerySolutionNode* node, std::set<std::string>* names) {
+    switch (node->getType()) {
+        case mongo::STAGE_IXSCAN:
+            names->insert(static_cast<const mongo::IndexScanNode*>(node)->index.name);
+            break;
+        case mongo::STAGE_COUNT_SCAN:
+            names->insert(static_cast<const mongo::CountScanNode*>(node)->index.name);
+            break;
+        case mongo::STAGE_DISTINCT_SCAN:
+            names->insert(static_cast<const mongo::DistinctNode*>(node)->index.name);
+            break;
+        default:
+            break;
+    }
+    for (auto&& child : node->children) {
+        getIndexNames(child, names);
+    }
+}
+
+/**
+ * Returns the total number of winning plans recorded in 'indexUsage' for the indexes used by
+ * 'solution'.
+ */
+long long getIndexAccesses(const mongo::QuerySolution& solution,
+                           const mongo::CollectionIndexUsageMap& indexUsage) {
+    if (!solution.root) {
+        return 0;
+    }
+
+    std::set<std::string> names;
+    getIndexNames(solution.root.get(), &names);
+
+    long long accesses = 0;
+    for (auto&& name : names) {
+        auto it = indexUsage.find(name);
+        if (it != indexUsage.end()) {
+            accesses += it->second.accesses.load();
+        }
+    }
+    return accesses;
+}
+
 }  // namespace
 
 namespace mongo {
@@ -65,7 +112,9 @@ using std::endl;
 using std::vector;
 
 // static
-size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRankingDecision* why) {
+size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates,
+                                PlanRankingDecision* why,
+                                const CollectionIndexUsageMap* indexUsage) {
     invariant(!candidates.empty());
     invariant(why);
 
@@ -117,6 +166,34 @@ size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRan
         double runnerUpScore = scoresAndCandidateindices[1].first;
         const double epsilon = 1e-10;
         why->tieForBest = std::abs(bestScore - runnerUpScore) < epsilon;
+
+        // Productivity can't tell the tied plans apart, so prefer the plan whose indexes have won
+        // most often in the past. Ties which remain are left in candidate order.
+        if (why->tieForBest && indexUsage) {
+            size_t bestTiedPos = 0;
+            long long bestAccesses =
+                getIndexAccesses(*candidates[scoresAndCandidateindices[0].second].solution,
+                                 *indexUsage);
+            for (size_t pos = 1; pos < scoresAndCandidateindices.size() &&
+                 std::abs(bestScore - scoresAndCandidateindices[pos].first) < epsilon;
+                 ++pos) {
+                long long accesses = getIndexAccesses(
+                    *candidates[scoresAndCandidateindices[pos].second].solution, *indexUsage);
+                if (accesses > bestAccesses) {
+                    bestAccesses = accesses;
+                    bestTiedPos = pos;
+                }
+            }
+
+            if (bestTiedPos != 0) {
+                LOG(2) << "Breaking tie in favor of plan "
+                       << scoresAndCandidateindices[bestTiedPos].second
+                       << " whose indexes have " << bestAccesses << " recorded accesses";
+                std::rotate(scoresAndCandidateindices.begin(),
+                            scoresAndCandidateindices.begin() + bestTiedPos,
+                            scoresAndCandidateindices.begin() + bestTiedPos + 1);
+            }
+        }
     }
 
     // Update results in 'why'
@@ -233,7 +310,8 @@ double PlanRanker::scoreTree(const PlanStageStats* stats) {
     // allows us to examine fewer documents, the penalty given to ixisect
     // can be made up via the no fetch bonus.
     double noIxisectBonus = epsilon;
-    if (hasStage(STAGE_AND_HASH, stats) || hasStage(STAGE_AND_SORTED, stats)) {
+    if (hasStage(STAGE_AND_HASH, stats) || hasStage(STAGE_AND_SORTED, stats) ||
+        hasStage(STAGE_AND_BITMAP, stats)) {
         noIxisectBonus = 0;
     }
 
@@ -250,7 +328,8 @@ double PlanRanker::scoreTree(const PlanStageStats* stats) {
     LOG(2) << scoreStr;
 
     if (internalQueryForceIntersectionPlans.load()) {
-        if (hasStage(STAGE_AND_HASH, stats) || hasStage(STAGE_AND_SORTED, stats)) {
+        if (hasStage(STAGE_AND_HASH, stats) || hasStage(STAGE_AND_SORTED, stats) ||
+            hasStage(STAGE_AND_BITMAP, stats)) {
             // The boost should be >2.001 to make absolutely sure the ixisect plan will win due
             // to the combination of 1) productivity, 2) eof bonus, and 3) no ixisect bonus.
             score += 3;
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/collection_index_usage_tracker.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/exec/working_set.h"
@@ -53,9 +54,14 @@ public:
      * Populates 'why' with information relevant to how each plan fared in the ranking process.
      * Caller owns pointers in 'why'.
      * 'candidateOrder' holds indices into candidates ordered by score (winner in first element).
+     *
+     * If 'indexUsage' is non-null, it is used to break a tie for the win in favor of the plan whose
+     * indexes have been used by the most winning plans so far. The decision is still reported as a
+     * tie in 'why'.
      */
     static size_t pickBestPlan(const std::vector<CandidatePlan>& candidates,
-                               PlanRankingDecision* why);
+                               PlanRankingDecision* why,
+                               const CollectionIndexUsageMap* indexUsage = nullptr);
 
     /**
      * Assign the stats tree a 'goodness' score. The higher the score, the better
@@ -70,7 +76,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(std::unique_ptr<QuerySolution> solution, PlanStage* r, WorkingSet* w)
-        : solution(std::move(solution)), root(r), ws(w), failed(false) {}
+        : solution(std::move(solution)), root(r), ws(w), failed(false), pruned(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -80,6 +86,10 @@ struct CandidatePlan {
     std::list<WorkingSetID> results;
 
     bool failed;
+
+    // Set when the plan was dominated by another candidate and stopped being worked before the
+    // end of the trial period. A pruned plan is still ranked using the stats it gathered.
+    bool pruned;
 };
 
 /**
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/planner_all_paths_helpers.h"
+
+#include <algorithm>
+#include <cctype>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/query/index_bounds_builder.h"
+
+namespace mongo {
+namespace all_paths_planning {
+
+const StringData kPathFieldName = "$_path"_sd;
+
+namespace {
+
+/**
+ * Returns true if a key of an allPaths index can hold 'elem' as its value under the path the
+ * predicate names. Objects and arrays are traversed rather than indexed, and missing fields have
+ * no keys at all, so comparisons against them or against the bracketing MinKey and MaxKey values
+ * cannot use the index.
+ */
+bool isIndexableValue(const BSONElement& elem) {
+    switch (elem.type()) {
+        case BSONType::jstNULL:
+        case BSONType::Undefined:
+        case BSONType::Object:
+        case BSONType::Array:
+        case BSONType::MinKey:
+        case BSONType::MaxKey:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/**
+ * Returns true if 'field' names a path the allPaths index keys. Positional path components are not
+ * recorded in the keys, so fields containing a numeric component are skipped.
+ */
+bool isIndexedField(const FieldRef& field, const FieldRef& prefix) {
+    if (prefix.numParts() > 0 && !(prefix == field || prefix.isPrefixOf(field))) {
+        return false;
+    }
+    if (prefix.numParts() == 0 && field.getPart(0) == "_id") {
+        return false;
+    }
+    for (size_t i = 0; i < field.numParts(); ++i) {
+        const StringData part = field.getPart(i);
+        if (std::all_of(part.begin(), part.end(), [](char c) { return isdigit(c); })) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void expandIndex(const IndexEntry& allPathsIndex,
+                 const stdx::unordered_set<std::string>& fields,
+                 const std::set<std::string>& multikeyPathSet,
+                 std::vector<IndexEntry>* out) {
+    invariant(allPathsIndex.type == INDEX_ALLPATHS);
+
+    const BSONElement keyPatternElt = allPathsIndex.keyPattern.firstElement();
+    FieldRef prefix(keyPatternElt.fieldNameStringData());
+    prefix.removeLastPart();
+
+    for (auto&& field : fields) {
+        FieldRef fieldRef(field);
+        if (!isIndexedField(fieldRef, prefix)) {
+            continue;
+        }
+
+        MultikeyPaths multikeyPaths(1);
+        for (size_t i = 0; i < fieldRef.numParts(); ++i) {
+            if (multikeyPathSet.count(fieldRef.dottedSubstring(0, i + 1).toString())) {
+                multikeyPaths[0].insert(i);
+            }
+        }
+
+        IndexEntry entry(allPathsIndex);
+        entry.keyPattern = BSON(field << 1);
+        entry.multikey = !multikeyPaths[0].empty();
+        entry.multikeyPaths = std::move(multikeyPaths);
+        out->push_back(std::move(entry));
+    }
+}
+
+bool canAnswerPredicate(const MatchExpression* node) {
+    switch (node->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return isIndexableValue(static_cast<const ComparisonMatchExpression*>(node)->getData());
+        case MatchExpression::MATCH_IN: {
+            const auto* in = static_cast<const InMatchExpression*>(node);
+            if (in->hasNull()) {
+                return false;
+            }
+            for (auto&& equality : in->getEqualities()) {
+                if (!isIndexableValue(equality)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case MatchExpression::REGEX:
+            return true;
+        default:
+            return false;
+    }
+}
+
+BSONObj makeKeyPatternWithPath(const IndexEntry& index) {
+    invariant(index.type == INDEX_ALLPATHS);
+    // The direction of the allPaths key pattern applies to the path. The values under a given path
+    // are always stored in ascending order.
+    const BSONElement allPathsKeyElt = index.infoObj.getObjectField("key").firstElement();
+    const int pathDirection = (allPathsKeyElt.isNumber() && allPathsKeyElt.number() < 0) ? -1 : 1;
+
+    BSONObjBuilder bob;
+    bob.append(kPathFieldName, pathDirection);
+    bob.appendElements(index.keyPattern);
+    return bob.obj();
+}
+
+IndexBounds makeBoundsWithPath(const IndexEntry& index, const IndexBounds& bounds) {
+    invariant(index.type == INDEX_ALLPATHS);
+    invariant(!bounds.isSimpleRange);
+    invariant(bounds.fields.size() == 1);
+
+    OrderedIntervalList pathOil(kPathFieldName.toString());
+    pathOil.intervals.push_back(
+        IndexBoundsBuilder::makePointInterval(index.keyPattern.firstElementFieldName()));
+
+    IndexBounds boundsWithPath;
+    boundsWithPath.fields.push_back(std::move(pathOil));
+    boundsWithPath.fields.push_back(bounds.fields[0]);
+    return boundsWithPath;
+}
+
+}  // namespace all_paths_planning
+}  // namespace mongo
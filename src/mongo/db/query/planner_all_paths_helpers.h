@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/index_entry.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+
+class MatchExpression;
+
+/**
+ * The planner sees an allPaths index as a set of single-field indexes, one for each path the query
+ * refers to. These helpers create those per-path entries and translate between them and the keys
+ * actually stored in the index, which are of the form {"$_path": <path>, <path>: <value>}.
+ */
+namespace all_paths_planning {
+
+/**
+ * The name given to the path component of an allPaths index key.
+ */
+extern const StringData kPathFieldName;
+
+/**
+ * Appends to 'out' one entry for each of 'fields' which 'allPathsIndex' can answer. Each entry has
+ * the name of the allPaths index, the key pattern {<field>: 1}, since the values under each path
+ * are stored in ascending order, and path-level multikey information derived from
+ * 'multikeyPathSet', the set of paths which hold an array in some indexed document.
+ */
+void expandIndex(const IndexEntry& allPathsIndex,
+                 const stdx::unordered_set<std::string>& fields,
+                 const std::set<std::string>& multikeyPathSet,
+                 std::vector<IndexEntry>* out);
+
+/**
+ * Returns true if the keys of an allPaths index are sufficient to answer 'node'. Only predicates
+ * which can never match a missing field, an object or an array are supported, since none of these
+ * has a key under its own path.
+ */
+bool canAnswerPredicate(const MatchExpression* node);
+
+/**
+ * Returns the key pattern of the index keys scanned for the per-path entry 'index'.
+ */
+BSONObj makeKeyPatternWithPath(const IndexEntry& index);
+
+/**
+ * Returns 'bounds', which were built for the per-path entry 'index', with a leading point interval
+ * on the path.
+ */
+IndexBounds makeBoundsWithPath(const IndexEntry& index, const IndexBounds& bounds);
+
+}  // namespace all_paths_planning
+}  // namespace mongo
@@ -39,8 +39,14 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/planner_all_paths_helpers.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -289,6 +295,128 @@ void geoSkipValidationOn(const std::set<StringData>& twoDSphereFields,
     }
 }
 
+/**
+ * Returns true if 'expr' gives the same answer when evaluated against the keys of 'index' as the
+ * documents those keys were generated from. This requires a predicate that key comparisons can
+ * answer (as decided by the bounds builder), over a single indexed field which is not multikey, in
+ * an index whose keys hold the original values rather than collation keys.
+ */
+bool canEvaluateOnIndexKeys(const MatchExpression* expr, const IndexEntry& index) {
+    if (INDEX_BTREE != index.type || index.collator) {
+        return false;
+    }
+
+    // The bounds builder does not support negations over sparse indexes.
+    const bool isNegation = MatchExpression::NOT == expr->matchType();
+    if (isNegation && index.sparse) {
+        return false;
+    }
+
+    const MatchExpression* leaf = isNegation ? expr->getChild(0) : expr;
+    switch (leaf->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LTE:
+        case MatchExpression::LT:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::REGEX:
+        case MatchExpression::MOD:
+        case MatchExpression::TYPE_OPERATOR:
+        case MatchExpression::MATCH_IN:
+        case MatchExpression::EXISTS:
+            break;
+        default:
+            return false;
+    }
+
+    size_t pos = 0;
+    BSONObjIterator it(index.keyPattern);
+    while (it.more() && it.next().fieldNameStringData() != leaf->path()) {
+        ++pos;
+    }
+    if (pos == static_cast<size_t>(index.keyPattern.nFields())) {
+        return false;
+    }
+    if (index.multikey && (index.multikeyPaths.empty() || !index.multikeyPaths[pos].empty())) {
+        return false;
+    }
+
+    return IndexBoundsBuilder::canUseCoveredMatching(expr, index);
+}
+
+/**
+ * Moves the parts of a FETCH filter that can be evaluated on index keys onto the filter of the
+ * IXSCAN beneath it, so that index entries which cannot match are discarded before their
+ * documents are fetched. The planner already does this for predicates it uses to build bounds;
+ * this catches the rest, such as predicates on trailing fields of a compound index which were not
+ * assigned to it.
+ */
+void pushCoveredFiltersIntoIndexScans(QuerySolutionNode* node) {
+    for (QuerySolutionNode* child : node->children) {
+        pushCoveredFiltersIntoIndexScans(child);
+    }
+
+    if (STAGE_FETCH != node->getType() || !node->filter ||
+        STAGE_IXSCAN != node->children[0]->getType()) {
+        return;
+    }
+
+    IndexScanNode* ixn = static_cast<IndexScanNode*>(node->children[0]);
+    std::vector<MatchExpression*> covered;
+    if (MatchExpression::AND == node->filter->matchType()) {
+        std::vector<MatchExpression*>* children = node->filter->getChildVector();
+        for (auto it = children->begin(); it != children->end();) {
+            if (canEvaluateOnIndexKeys(*it, ixn->index)) {
+                covered.push_back(*it);
+                it = children->erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (children->empty()) {
+            node->filter.reset();
+        } else if (children->size() == 1) {
+            unique_ptr<MatchExpression> remaining((*children)[0]);
+            children->clear();
+            node->filter = std::move(remaining);
+        }
+    } else if (canEvaluateOnIndexKeys(node->filter.get(), ixn->index)) {
+        covered.push_back(node->filter.release());
+    }
+
+    for (MatchExpression* expr : covered) {
+        if (!ixn->filter) {
+            ixn->filter.reset(expr);
+        } else {
+            if (MatchExpression::AND != ixn->filter->matchType()) {
+                auto andFilter = stdx::make_unique<AndMatchExpression>();
+                andFilter->add(ixn->filter.release());
+                ixn->filter = std::move(andFilter);
+            }
+            static_cast<AndMatchExpression*>(ixn->filter.get())->add(expr);
+        }
+    }
+}
+
+/**
+ * Returns the link in the tree rooted at '*root' where a SKIP should be inserted. Normally this is
+ * the root itself, but when the top of the tree is a FETCH without a filter, optionally beneath a
+ * PROJECTION, skipping the input to the FETCH drops the same results as skipping its output while
+ * sparing the work of fetching them.
+ */
+QuerySolutionNode** findSkipPosition(QuerySolutionNode** root) {
+    QuerySolutionNode* node = *root;
+    if (STAGE_PROJECTION == node->getType()) {
+        node = node->children[0];
+    }
+
+    if (STAGE_FETCH == node->getType() && !node->filter && !node->children[0]->fetched()) {
+        return &node->children[0];
+    }
+    return root;
+}
+
 }  // namespace
 
 // static
@@ -532,6 +660,7 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         fetch->children.push_back(solnRoot);
         solnRoot = fetch;
     }
+    QuerySolutionNode* sortedNode = solnRoot;
 
     // And build the full sort stage. The sort stage has to have a sort key generating stage
     // as its child, supplying it with the appropriate sort keys.
@@ -609,6 +738,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A TEXT node sorted by nothing but its text score only needs to produce the documents that
+    // make the limit.
+    if (sort->limit && STAGE_TEXT == sortedNode->getType() && sortObj.nFields() == 1 &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement()) &&
+        internalQueryTextTopKPruning.load()) {
+        static_cast<TextNode*>(sortedNode)->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -626,6 +763,8 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
 
     analyzeGeo(params, solnRoot.get());
 
+    pushCoveredFiltersIntoIndexScans(solnRoot.get());
+
     // solnRoot finds all our results.  Let's see what transformations we must perform to the
     // data.
 
@@ -776,7 +915,9 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
                         if (STAGE_IXSCAN == leafNodes[0]->getType()) {
                             projType = ProjectionNode::COVERED_ONE_INDEX;
                             IndexScanNode* ixn = static_cast<IndexScanNode*>(leafNodes[0]);
-                            coveredKeyObj = ixn->index.keyPattern;
+                            coveredKeyObj = ixn->index.type == INDEX_ALLPATHS
+                                ? all_paths_planning::makeKeyPatternWithPath(ixn->index)
+                                : ixn->index.keyPattern;
                         } else if (STAGE_DISTINCT_SCAN == leafNodes[0]->getType()) {
                             projType = ProjectionNode::COVERED_ONE_INDEX;
                             DistinctNode* dn = static_cast<DistinctNode*>(leafNodes[0]);
@@ -830,8 +971,12 @@ std::unique_ptr<QuerySolution> QueryPlannerAnalysis::analyzeDataAccess(
     if (qr.getSkip()) {
         SkipNode* skip = new SkipNode();
         skip->skip = *qr.getSkip();
-        skip->children.push_back(solnRoot.release());
-        solnRoot.reset(skip);
+
+        QuerySolutionNode* root = solnRoot.release();
+        QuerySolutionNode** skipPosition = findSkipPosition(&root);
+        skip->children.push_back(*skipPosition);
+        *skipPosition = skip;
+        solnRoot.reset(root);
     }
 
     // When there is both a blocking sort and a limit, the limit will
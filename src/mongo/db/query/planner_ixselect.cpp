@@ -43,6 +43,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/planner_all_paths_helpers.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
 
@@ -271,6 +272,14 @@ bool QueryPlannerIXSelect::_compatible(const BSONElement& keyPatternElt,
         return false;
     }
 
+    // An allPaths index has keys only for the leaf values under each path. Predicates beneath an
+    // $elemMatch are left to other indexes, since the index does not record array positions.
+    if (INDEX_ALLPATHS == index.type &&
+        (elemMatchContext.innermostParentElemMatch ||
+         !all_paths_planning::canAnswerPredicate(node))) {
+        return false;
+    }
+
     // Historically one could create indices with any particular value for the index spec,
     // including values that now indicate a special index.  As such we have to make sure the
     // index type wasn't overridden before we pay attention to the string in the index key
@@ -0,0 +1,239 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <memory>
+
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/platform/random.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/op_msg.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("query_execution_bm.coll");
+const NamespaceString kForeignNss("query_execution_bm.foreign");
+
+// The number of distinct values of the grouping and join field "b".
+const int kNumGroups = 100;
+
+/**
+ * Starts a storage engine through the ServiceContextMongoDTest fixture and populates 'kNss' with
+ * synthetic documents of the form {_id: i, a: i, b: i % kNumGroups, c: <random>, s: <padding>},
+ * with an index on "a". 'kForeignNss' holds one document for each value of "b", for $lookup.
+ *
+ * The fixture is built before the timed loop of each benchmark, so populating the collections is
+ * not part of the measurement.
+ */
+class QueryExecutionFixture : public ServiceContextMongoDTest {
+public:
+    explicit QueryExecutionFixture(int numDocs) {
+        auto service = getServiceContext();
+        repl::ReplicationCoordinator::set(
+            service, std::make_unique<repl::ReplicationCoordinatorMock>(service));
+
+        // There is no featureCompatibilityVersion document to initialize the parameter from.
+        serverGlobalParams.featureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42);
+
+        _opCtx = makeOperationContext();
+
+        PseudoRandom random(1);
+        const std::string padding(100, 'x');
+        _insert(kNss, numDocs, [&](BSONObjBuilder* builder, int i) {
+            builder->append("_id", i);
+            builder->append("a", i);
+            builder->append("b", i % kNumGroups);
+            builder->append("c", random.nextInt32(1000000));
+            builder->append("s", padding);
+        });
+        _insert(kForeignNss, kNumGroups, [&](BSONObjBuilder* builder, int i) {
+            builder->append("_id", i);
+            builder->append("name", str::stream() << "group" << i);
+        });
+
+        runCommand(BSON("createIndexes" << kNss.coll() << "indexes"
+                                        << BSON_ARRAY(BSON("key" << BSON("a" << 1) << "name"
+                                                                 << "a_1"))));
+    }
+
+    BSONObj runCommand(const BSONObj& cmdObj) {
+        auto result = CommandHelpers::runCommandDirectly(
+            _opCtx.get(), OpMsgRequest::fromDBAndBody(kNss.db(), cmdObj));
+        uassertStatusOK(getStatusFromCommandResult(result));
+        return result;
+    }
+
+    /**
+     * Runs 'qr' against 'kNss' with a PlanExecutor and returns the number of documents returned.
+     */
+    int runFind(std::unique_ptr<QueryRequest> qr) {
+        auto cq = uassertStatusOK(CanonicalQuery::canonicalize(_opCtx.get(), std::move(qr)));
+        AutoGetCollectionForRead autoColl(_opCtx.get(), kNss);
+        auto exec = uassertStatusOK(
+            getExecutorFind(_opCtx.get(), autoColl.getCollection(), kNss, std::move(cq)));
+
+        int numResults = 0;
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+            ++numResults;
+        }
+        invariant(PlanExecutor::IS_EOF == state);
+        return numResults;
+    }
+
+    /**
+     * Runs an aggregate command on 'kNss' whose first batch holds all of the results, and returns
+     * the number of results.
+     */
+    int runAggregate(const BSONArray& pipeline) {
+        auto result = runCommand(BSON("aggregate" << kNss.coll() << "pipeline" << pipeline
+                                                  << "cursor"
+                                                  << BSON("batchSize" << 1000000)));
+        invariant(result["cursor"]["id"].numberLong() == 0);
+        return result["cursor"]["firstBatch"].Obj().nFields();
+    }
+
+private:
+    void _doTest() override {}
+
+    template <typename MakeDocFn>
+    void _insert(const NamespaceString& nss, int numDocs, MakeDocFn makeDoc) {
+        const int kBatchSize = 1000;
+        for (int start = 0; start < numDocs; start += kBatchSize) {
+            BSONArrayBuilder docs;
+            for (int i = start; i < std::min(numDocs, start + kBatchSize); ++i) {
+                BSONObjBuilder doc(docs.subobjStart());
+                makeDoc(&doc, i);
+            }
+            runCommand(BSON("insert" << nss.coll() << "documents" << docs.arr()));
+        }
+    }
+
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+/**
+ * Each benchmark reports the documents it reads from the collection as items, so the items per
+ * second counter gives the per-document cost of the plan.
+ */
+
+void BM_CollectionScanWithFilter(benchmark::State& state) {
+    QueryExecutionFixture fixture(state.range(0));
+    for (auto keepRunning : state) {
+        auto qr = std::make_unique<QueryRequest>(kNss);
+        qr->setFilter(BSON("b" << 7));
+        benchmark::DoNotOptimize(fixture.runFind(std::move(qr)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_IndexScanWithFetch(benchmark::State& state) {
+    // Fetches a tenth of the collection through the index on "a".
+    const int numMatches = state.range(0) / 10;
+    QueryExecutionFixture fixture(state.range(0));
+    for (auto keepRunning : state) {
+        auto qr = std::make_unique<QueryRequest>(kNss);
+        qr->setFilter(BSON("a" << BSON("$gte" << 0 << "$lt" << numMatches)));
+        benchmark::DoNotOptimize(fixture.runFind(std::move(qr)));
+    }
+    state.SetItemsProcessed(state.iterations() * numMatches);
+}
+
+void BM_Sort(benchmark::State& state) {
+    QueryExecutionFixture fixture(state.range(0));
+    for (auto keepRunning : state) {
+        auto qr = std::make_unique<QueryRequest>(kNss);
+        qr->setSort(BSON("c" << 1));
+        benchmark::DoNotOptimize(fixture.runFind(std::move(qr)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Projection(benchmark::State& state) {
+    QueryExecutionFixture fixture(state.range(0));
+    for (auto keepRunning : state) {
+        auto qr = std::make_unique<QueryRequest>(kNss);
+        qr->setProj(BSON("_id" << 0 << "a" << 1 << "c" << 1));
+        benchmark::DoNotOptimize(fixture.runFind(std::move(qr)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Group(benchmark::State& state) {
+    QueryExecutionFixture fixture(state.range(0));
+    const BSONArray pipeline =
+        BSON_ARRAY(BSON("$group" << BSON("_id"
+                                         << "$b"
+                                         << "total"
+                                         << BSON("$sum"
+                                                 << "$c"))));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fixture.runAggregate(pipeline));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Lookup(benchmark::State& state) {
+    QueryExecutionFixture fixture(state.range(0));
+    const BSONArray pipeline = BSON_ARRAY(BSON("$lookup" << BSON("from" << kForeignNss.coll()
+                                                                        << "localField"
+                                                                        << "b"
+                                                                        << "foreignField"
+                                                                        << "_id"
+                                                                        << "as"
+                                                                        << "joined")));
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(fixture.runAggregate(pipeline));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_CollectionScanWithFilter)->ArgName("docs")->Arg(1000)->Arg(10000);
+BENCHMARK(BM_IndexScanWithFetch)->ArgName("docs")->Arg(1000)->Arg(10000);
+BENCHMARK(BM_Sort)->ArgName("docs")->Arg(1000)->Arg(10000);
+BENCHMARK(BM_Projection)->ArgName("docs")->Arg(1000)->Arg(10000);
+BENCHMARK(BM_Group)->ArgName("docs")->Arg(1000)->Arg(10000);
+BENCHMARK(BM_Lookup)->ArgName("docs")->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace mongo
@@ -27,6 +27,8 @@
  */
 
 #include "mongo/db/query/query_knobs.h"
+
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 
@@ -38,8 +40,34 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationPruneRatio, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal != 0.0 && newVal < 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlanEvaluationPruneRatio must be 0 or at least 1");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationPruneMinResults, int, 10);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxMillis, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanTieBreakingWithIndexUsage, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanStatisticsPruneRatio, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal != 0.0 && newVal < 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlanStatisticsPruneRatio must be 0 or at least 1");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanCacheRestoreFromSnapshot, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
@@ -55,6 +83,15 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheWorksGrowthCoefficient, double,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheDisableInactiveEntries, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheMaxPlansPerShape, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryCacheMaxPlansPerShape must be at least 1");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -67,26 +104,210 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexIntersection, bool,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableHashIntersection, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySubplannerShareBranchPlans, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, true);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSortUseKeyStrings, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryUpdateTopLevelFieldsFastPath, bool, false);
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWorkBatchSize, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecStageTimingSampleInterval, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryExecStageTimingSampleInterval must be non-negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecUseBitmapIntersection, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryBSONFieldIndexMinFields, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryBSONFieldIndexMinFields must be non-negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCollectionScanReadAheadRecords, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryParallelCollectionScanMaxRanges, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryParallelCollectionScanMinRecords,
+                              long long,
+                              100 * 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStatsSampleRate, double, 0.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 0.0 || newVal > 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryStatsSampleRate must be between 0 and 1 inclusive");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStatsMaxEntries, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue, "internalQueryStatsMaxEntries must be positive");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetStreamInput, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQuerySampleUseReservoir, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCompileAggregationExpressions, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorLazyDocuments, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              long long,
+                              100 * 1024 * 1024)
+    ->withValidator([](const long long& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGraphLookupMaxMemoryBytes must be positive");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupFrontierBatchSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGraphLookupFrontierBatchSize must be greater "
+                          "than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceLookupBatchSize must be greater than or equal "
+                          "to 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupSpillPartitions, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 256) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGroupSpillPartitions must be between 0 and 256");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceOutBuildIndexesAfterLoad, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceBucketAutoApproximateRangesPerBucket, int, 32)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 1024) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceBucketAutoApproximateRangesPerBucket must be "
+                          "between 1 and 1024");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAggregationParallelism, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryAggregationParallelism must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaterializedViewMaxIncrementalChanges,
+                              long long,
+                              100 * 1000)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMaterializedViewMaxIncrementalChanges must be greater "
+                          "than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalChangeStreamSharedOplogBufferBytes, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalChangeStreamSharedOplogBufferBytes must be greater than or "
+                          "equal to 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalChangeStreamPostImageLookupBatchSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "internalChangeStreamPostImageLookupBatchSize must be between 0 and "
+                          "1000");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryTextTopKPruning, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFindFirstBatchMaxBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > BSONObjMaxUserSize) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryFindFirstBatchMaxBytes must be between 0 and the maximum "
+                          "BSON document size");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMultiDeleteBatchSize, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 10000) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMultiDeleteBatchSize must be between 1 and 10000");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMultiUpdateBatchMaxBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 64 * 1024 * 1024) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMultiUpdateBatchMaxBytes must be between 0 and 64MB");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
@@ -48,6 +48,25 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// Stop working a candidate plan once the leading plan has produced this many times as many results.
+// A value of 0 disables pruning.
+extern AtomicDouble internalQueryPlanEvaluationPruneRatio;
+
+// The leading plan must have produced at least this many results before other plans are pruned.
+extern AtomicInt32 internalQueryPlanEvaluationPruneMinResults;
+
+// Stop working plans once the trial period has run for this many milliseconds. A value of 0 means
+// that the trial period is bounded only by work and result counts.
+extern AtomicInt32 internalQueryPlanEvaluationMaxMillis;
+
+// Do we break ties between plans in favor of the indexes that won most often in the past?
+extern AtomicBool internalQueryPlanTieBreakingWithIndexUsage;
+
+// Before racing candidate plans, discard those whose index scan is estimated from the statistics
+// gathered by 'analyze' to read at least this many times more of the collection than the most
+// selective candidate. A value of 0 disables pruning by statistics.
+extern AtomicDouble internalQueryPlanStatisticsPruneRatio;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -57,6 +76,10 @@ extern AtomicBool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern AtomicBool internalQueryPlannerEnableHashIntersection;
 
+// When subplanning a rooted $or, do we rank candidate plans only once per distinct branch shape and
+// reuse the winning index assignment for the other branches with that shape?
+extern AtomicBool internalQuerySubplannerShareBranchPlans;
+
 //
 // plan cache
 //
@@ -64,6 +87,10 @@ extern AtomicBool internalQueryPlannerEnableHashIntersection;
 // How many entries in the cache?
 extern AtomicInt32 internalQueryCacheSize;
 
+// Do we load a collection's plan cache snapshot, written by planCacheSnapshot, the first time the
+// collection is queried?
+extern AtomicBool internalQueryPlanCacheRestoreFromSnapshot;
+
 // How many feedback entries do we collect before possibly evicting from the cache based on bad
 // performance?
 extern AtomicInt32 internalQueryCacheFeedbacksStored;
@@ -79,6 +106,10 @@ extern AtomicDouble internalQueryCacheWorksGrowthCoefficient;
 // Whether or not cache entries can be marked as "inactive."
 extern AtomicBool internalQueryCacheDisableInactiveEntries;
 
+// How many plans can a cache entry hold, counting its main plan? Extra plans are each used for a
+// range of values of the query's leading constant. A value of 1 disables constant-range plans.
+extern AtomicInt32 internalQueryCacheMaxPlansPerShape;
+
 //
 // Planning and enumeration.
 //
@@ -111,23 +142,149 @@ extern AtomicBool internalQueryIgnoreUnknownJSONSchemaKeywords;
 
 extern AtomicInt32 internalQueryExecMaxBlockingSortBytes;
 
+// Whether blocking sorts encode each sort key once as a KeyString and compare the encodings
+// bytewise, rather than comparing the BSON sort keys element by element.
+extern AtomicBool internalQueryExecSortUseKeyStrings;
+
+// Whether updates that only $set, $inc or $unset top-level fields modify the document's BSON
+// directly instead of going through a mutable BSON document.
+extern AtomicBool internalQueryUpdateTopLevelFieldsFastPath;
+
 // Yield after this many "should yield?" checks.
 extern AtomicInt32 internalQueryExecYieldIterations;
 
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// Stages that consume their child's results in batches ask for this many units of work at a time.
+// One disables batching.
+extern AtomicInt32 internalQueryExecWorkBatchSize;
+
+// Every this many calls to a stage's work() are timed with the high resolution tick source, to
+// estimate the stage's execution time more precisely than the fast clock allows. Zero disables
+// the sampling.
+extern AtomicInt32 internalQueryExecStageTimingSampleInterval;
+
+// Execute hash-based index intersection plans by intersecting compressed RecordId bitmaps rather
+// than hash tables of working set members.
+extern AtomicBool internalQueryExecUseBitmapIntersection;
+
+// Documents with at least this many top-level fields, against which a filter matches more than one
+// path, are indexed by field name so that each path does not scan the document. Zero disables the
+// index.
+extern AtomicInt32 internalQueryBSONFieldIndexMinFields;
+
+// Ask the storage engine to prefetch this many records ahead of forward collection scans. Zero
+// disables read-ahead.
+extern AtomicInt32 internalQueryCollectionScanReadAheadRecords;
+
+// Split eligible collection scans into up to this many RecordId ranges and scan them on worker
+// threads. Zero or one disables parallel collection scans.
+extern AtomicInt32 internalQueryParallelCollectionScanMaxRanges;
+
+// Collections with fewer records than this are always scanned by a single thread.
+extern AtomicWord<long long> internalQueryParallelCollectionScanMinRecords;
+
+// The fraction of queries whose execution statistics are recorded for $queryStats. Zero disables
+// the collection of query statistics.
+extern AtomicDouble internalQueryStatsSampleRate;
+
+// The maximum number of query shapes for which $queryStats keeps statistics.
+extern AtomicInt32 internalQueryStatsMaxEntries;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
+// If true, $facet hands each input document to all of its sub-pipelines before reading the next
+// one, rather than buffering up to internalQueryFacetBufferSizeBytes of input for them.
+extern AtomicBool internalQueryFacetStreamInput;
+
+// If true, a $sample which cannot use a random cursor keeps its sample in a reservoir while
+// reading its input, skipping over the documents which cannot make it into the sample, rather
+// than assigning every input document a random value and sorting by it.
+extern AtomicBool internalQuerySampleUseReservoir;
+
+// If true, arithmetic and boolean expressions computed by $project and $addFields are compiled
+// into a form which keeps intermediate results unboxed when the pipeline is optimized.
+extern AtomicBool internalQueryCompileAggregationExpressions;
+
 extern AtomicInt32 internalInsertMaxBatchSize;
 
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// Whether $cursor produces documents which are backed by the BSON read from the collection, and
+// only converted into Values as their fields are needed.
+extern AtomicBool internalDocumentSourceCursorLazyDocuments;
+
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// The memory a $graphLookup may use for the documents it has discovered and the values it is about
+// to search for. When its results are unwound and allowDiskUse is set, the discovered documents
+// are spilled to disk before this is exceeded.
+extern AtomicWord<long long> internalDocumentSourceGraphLookupMaxMemoryBytes;
+
+// When non-zero, the maximum number of values a $graphLookup searches for with a single query. A
+// level of the search whose frontier is larger runs several queries.
+extern AtomicInt32 internalDocumentSourceGraphLookupFrontierBatchSize;
+
+// When non-zero, a $lookup with localField/foreignField syntax joins this many input documents at
+// a time with a single query on the foreign collection. If the foreign collection fits in
+// internalDocumentSourceLookupCacheSizeBytes, it is instead loaded once and hash joined.
+extern AtomicInt32 internalDocumentSourceLookupBatchSize;
+
+// When non-zero, a $group which exceeds its memory limit with allowDiskUse spills its groups into
+// this many hash partitions, which are then re-aggregated one at a time, instead of spilling
+// sorted runs which must be merged.
+extern AtomicInt32 internalDocumentSourceGroupSpillPartitions;
+
+// Whether $out builds the target collection's secondary indexes on its temporary collection in bulk
+// once all the documents are inserted, rather than maintaining them during the inserts.
+extern AtomicBool internalDocumentSourceOutBuildIndexesAfterLoad;
+
+// The number of ranges of 'groupBy' values per requested bucket that a $bucketAuto with
+// 'approximate: true' keeps. More ranges make the bucket boundaries more accurate, at the cost of
+// memory for their accumulators.
+extern AtomicInt32 internalDocumentSourceBucketAutoApproximateRangesPerBucket;
+
+// The number of threads among which an aggregation over a collection splits the stages up to and
+// including its first $group. Each thread computes a partial $group over a share of the input, and
+// the partial results are merged on the thread running the command. A value of 1 disables this.
+extern AtomicInt32 internalQueryAggregationParallelism;
+
+// The largest number of documents changed since the previous refreshMaterializedView which it
+// recomputes one by one. A refresh after more changes reruns the view's whole pipeline.
+extern AtomicWord<long long> internalQueryMaterializedViewMaxIncrementalChanges;
+
+// When non-zero, change streams read the oplog through a reader shared by all the change streams on
+// the node, which scans each batch of entries once and keeps up to this many bytes of them for the
+// change streams which have yet to read them.
+extern AtomicWord<long long> internalChangeStreamSharedOplogBufferBytes;
+
+// When greater than 1, a change stream with fullDocument: "updateLookup" reads up to this many
+// events ahead and looks up the post-images of the updates among them with one query per
+// collection and shard, rather than one query per update.
+extern AtomicInt32 internalChangeStreamPostImageLookupBatchSize;
+
+// Whether a text search sorted by its text score with a limit reads the index entries of its terms
+// in turn and stops once no unread document can score among the best 'limit', instead of scoring
+// every matching document.
+extern AtomicBool internalQueryTextTopKPruning;
+
+// When non-zero, the first batch of a find without a batchSize is cut once it holds this many bytes
+// of results, instead of after the default number of documents, so that queries over small
+// documents need fewer getMores.
+extern AtomicInt32 internalQueryFindFirstBatchMaxBytes;
+
+// The largest number of documents a multi-document delete removes in one storage transaction. A
+// value of 1 deletes each document in a transaction of its own.
+extern AtomicInt32 internalQueryMultiDeleteBatchSize;
+
+// When non-zero, a multi-document update applies its update to documents in batches, each in one
+// storage transaction, closing a batch once the documents in it total this many bytes.
+extern AtomicInt32 internalQueryMultiUpdateBatchMaxBytes;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
 }  // namespace mongo
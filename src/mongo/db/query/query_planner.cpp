@@ -320,6 +320,12 @@ StatusWith<std::unique_ptr<PlanCacheIndexTree>> QueryPlanner::cacheDataFromTagge
             return Status(ErrorCodes::BadValue, "can't cache '2d' index");
         }
 
+        // The entries for an allPaths index depend on the fields in the query and on the paths
+        // which are currently multikey, so they cannot be restored from the cache.
+        if (relevantIndices[itag->index].type == INDEX_ALLPATHS) {
+            return Status(ErrorCodes::BadValue, "can't cache 'allPaths' index");
+        }
+
         IndexEntry* ientry = new IndexEntry(relevantIndices[itag->index]);
         indexTree->entry.reset(ientry);
         indexTree->index_pos = itag->pos;
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/planner_all_paths_helpers.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_test_fixture.h"
+
+namespace mongo {
+namespace {
+
+class QueryPlannerAllPathsTest : public QueryPlannerTest {
+protected:
+    void setUp() final {
+        QueryPlannerTest::setUp();
+        params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    }
+
+    /**
+     * Adds the entries the executor would build for the allPaths index 'keyPattern' when planning
+     * a query over 'fields'.
+     */
+    void addAllPathsIndex(BSONObj keyPattern,
+                          const stdx::unordered_set<std::string>& fields,
+                          const std::set<std::string>& multikeyPathSet = {}) {
+        IndexEntry entry(keyPattern,
+                         IndexNames::ALLPATHS,
+                         true,
+                         {},
+                         false,
+                         false,
+                         "allPaths",
+                         nullptr,
+                         BSON("key" << keyPattern),
+                         nullptr);
+        all_paths_planning::expandIndex(entry, fields, multikeyPathSet, &params.indices);
+    }
+};
+
+TEST_F(QueryPlannerAllPathsTest, ExpandsOnlyIndexedFields) {
+    addAllPathsIndex(BSON("a.$**" << 1), {"a", "a.b", "a.0.b", "c", "_id"});
+    ASSERT_EQ(params.indices.size(), 2U);
+    for (auto&& entry : params.indices) {
+        ASSERT_EQ(entry.type, INDEX_ALLPATHS);
+        ASSERT_EQ(entry.name, "allPaths");
+        auto field = entry.keyPattern.firstElementFieldName();
+        ASSERT(str::equals(field, "a") || str::equals(field, "a.b"));
+    }
+
+    params.indices.clear();
+    addAllPathsIndex(BSON("$**" << 1), {"_id", "x", "x.1"});
+    ASSERT_EQ(params.indices.size(), 1U);
+    ASSERT_BSONOBJ_EQ(params.indices[0].keyPattern, BSON("x" << 1));
+}
+
+TEST_F(QueryPlannerAllPathsTest, MultikeyComponentsComeFromMetadata) {
+    addAllPathsIndex(BSON("$**" << 1), {"a.b.c", "d"}, {"a", "a.b.c"});
+    ASSERT_EQ(params.indices.size(), 2U);
+    for (auto&& entry : params.indices) {
+        ASSERT_EQ(entry.multikeyPaths.size(), 1U);
+        if (str::equals(entry.keyPattern.firstElementFieldName(), "d")) {
+            ASSERT_FALSE(entry.multikey);
+            ASSERT(entry.multikeyPaths[0].empty());
+        } else {
+            ASSERT(entry.multikey);
+            ASSERT(entry.multikeyPaths[0] == (std::set<size_t>{0U, 2U}));
+        }
+    }
+}
+
+TEST_F(QueryPlannerAllPathsTest, EqualityUsesTightBounds) {
+    addAllPathsIndex(BSON("$**" << 1), {"a"});
+    runQuery(fromjson("{a: 5}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: "
+        "{filter: null, pattern: {a: 1}, bounds: {a: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerAllPathsTest, RangeOnNonMultikeyPathIsCovered) {
+    addAllPathsIndex(BSON("$**" << 1), {"a.b"});
+    runQuerySortProj(fromjson("{'a.b': {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, 'a.b': 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, 'a.b': 1}, node: {ixscan: "
+        "{filter: null, pattern: {'a.b': 1}, bounds: {'a.b': [[1, Infinity, false, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerAllPathsTest, MultikeyPathIsNotCovered) {
+    addAllPathsIndex(BSON("$**" << 1), {"a"}, {"a"});
+    runQuerySortProj(fromjson("{a: {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {fetch: {filter: null, node: {ixscan: "
+        "{filter: null, pattern: {a: 1}, bounds: {a: [[1, Infinity, false, true]]}}}}}}");
+}
+
+TEST_F(QueryPlannerAllPathsTest, ProvidesSortOnQueriedField) {
+    addAllPathsIndex(BSON("$**" << 1), {"a"});
+    runQuerySortProj(fromjson("{a: {$lt: 10}}"), fromjson("{a: -1}"), BSONObj());
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: "
+        "{filter: null, dir: -1, pattern: {a: 1}, bounds: {a: [[10, -Infinity, false, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerAllPathsTest, UnsupportedPredicatesDoNotUseIndex) {
+    addAllPathsIndex(BSON("$**" << 1), {"a"});
+    for (auto&& query : {"{a: null}",
+                         "{a: {$exists: true}}",
+                         "{a: {$ne: 1}}",
+                         "{a: {b: 1}}",
+                         "{a: [1, 2]}",
+                         "{a: {$in: [1, null]}}",
+                         "{a: {$gt: {}}}",
+                         "{a: {$elemMatch: {$gt: 1}}}"}) {
+        runQuery(fromjson(query));
+        assertNumSolutions(0U);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -425,7 +425,7 @@ TEST_F(QueryPlannerTest, BasicSkipWithIndex) {
     ASSERT_EQUALS(getNumSolutions(), 2U);
     assertSolutionExists("{skip: {n: 8, node: {cscan: {dir: 1, filter: {a: 5}}}}}");
     assertSolutionExists(
-        "{skip: {n: 8, node: {fetch: {filter: null, node: "
+        "{fetch: {filter: null, node: {skip: {n: 8, node: "
         "{ixscan: {filter: null, pattern: {a: 1, b: 1}}}}}}}");
 }
 
@@ -481,9 +481,8 @@ TEST_F(QueryPlannerTest, SkipAndLimit) {
         "{limit: {n: 2, node: {skip: {n: 7, node: "
         "{cscan: {dir: 1, filter: {x: {$lte: 4}}}}}}}}");
     assertSolutionExists(
-        "{limit: {n: 2, node: {skip: {n: 7, node: {fetch: "
-        "{filter: null, node: {ixscan: "
-        "{filter: null, pattern: {x: 1}}}}}}}}}");
+        "{limit: {n: 2, node: {fetch: {filter: null, node: {skip: {n: 7, node: "
+        "{ixscan: {filter: null, pattern: {x: 1}}}}}}}}}");
 }
 
 TEST_F(QueryPlannerTest, SkipAndSoftLimit) {
@@ -495,12 +494,74 @@ TEST_F(QueryPlannerTest, SkipAndSoftLimit) {
     assertSolutionExists(
         "{skip: {n: 7, node: "
         "{cscan: {dir: 1, filter: {x: {$lte: 4}}}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {skip: {n: 7, node: "
+        "{ixscan: {filter: null, pattern: {x: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipStaysAboveFetchWithFilter) {
+    addIndex(BSON("x" << 1));
+
+    runQuerySkipNToReturn(fromjson("{x: {$lte: 4}, y: 1}"), 7, 0);
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists("{skip: {n: 7, node: {cscan: {dir: 1}}}}");
     assertSolutionExists(
         "{skip: {n: 7, node: {fetch: "
-        "{filter: null, node: {ixscan: "
+        "{filter: {y: 1}, node: {ixscan: "
         "{filter: null, pattern: {x: 1}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, SkipBelowFetchWithProjection) {
+    addIndex(BSON("x" << 1));
+
+    runQuerySortProjSkipNToReturn(
+        fromjson("{x: {$lte: 4}}"), BSONObj(), fromjson("{y: 1}"), 7, 0);
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists(
+        "{proj: {spec: {y: 1}, node: {fetch: {filter: null, node: {skip: {n: 7, node: "
+        "{ixscan: {filter: null, pattern: {x: 1}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CoverableFetchFilterMovesToIndexScan) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{a: 1, b: {$not: /foo/}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: {b: {$not: /foo/}}, "
+        "pattern: {a: 1, b: 1}, bounds: {a: [[1, 1, true, true]], "
+        "b: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CoverableFetchFilterStaysAboveMultikeyIndexScan) {
+    // true means multikey
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+
+    runQuery(fromjson("{a: 1, b: {$not: /foo/}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$not: /foo/}}, node: {ixscan: {filter: null, "
+        "pattern: {a: 1, b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, UncoverableFetchFilterStaysAboveIndexScan) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    runQuery(fromjson("{a: 1, b: {$not: /foo/}, c: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {c: 1}, node: {ixscan: {filter: {b: {$not: /foo/}}, "
+        "pattern: {a: 1, b: 1}}}}}");
+}
+
 //
 // tree operations
 //
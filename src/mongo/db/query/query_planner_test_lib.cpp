@@ -415,6 +415,13 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             }
         }
 
+        BSONElement topK = textObj["topK"];
+        if (!topK.eoo()) {
+            if (!topK.isNumber() || topK.numberLong() != static_cast<long long>(node->topK)) {
+                return false;
+            }
+        }
+
         BSONObj collation;
         if (BSONElement collationElt = textObj["collation"]) {
             if (!collationElt.isABSONObj()) {
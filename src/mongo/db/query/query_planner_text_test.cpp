@@ -30,6 +30,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
 
@@ -472,6 +473,72 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, TextScoreSortWithLimitSetsTopKOnTextNode) {
+    bool oldTopKPruning = internalQueryTextTopKPruning.load();
+    internalQueryTextTopKPruning.store(true);
+
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {a: {$meta: 'textScore'}}, "
+        "projection: {a: {$meta: 'textScore'}}, limit: 3}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 3, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 3}}}}}}}}");
+
+    internalQueryTextTopKPruning.store(oldTopKPruning);
+}
+
+TEST_F(QueryPlannerTest, TextScoreSortWithoutLimitDoesNotSetTopK) {
+    bool oldTopKPruning = internalQueryTextTopKPruning.load();
+    internalQueryTextTopKPruning.store(true);
+
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {a: {$meta: 'textScore'}}, "
+        "projection: {a: {$meta: 'textScore'}}}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 0, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}}}");
+
+    internalQueryTextTopKPruning.store(oldTopKPruning);
+}
+
+TEST_F(QueryPlannerTest, CompoundSortWithTextScoreDoesNotSetTopK) {
+    bool oldTopKPruning = internalQueryTextTopKPruning.load();
+    internalQueryTextTopKPruning.store(true);
+
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {a: {$meta: 'textScore'}, "
+        "b: 1}, projection: {a: {$meta: 'textScore'}}, limit: 3}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 3, pattern: {a: {$meta: 'textScore'}, b: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}}}");
+
+    internalQueryTextTopKPruning.store(oldTopKPruning);
+}
+
 TEST_F(QueryPlannerTest, PredicatesOverLeadingFieldsWithSharedPathPrefixHandledCorrectly) {
     const bool multikey = true;
     addIndex(BSON("a.x" << 1 << "a.y" << 1 << "b.x" << 1 << "b.y" << 1 << "_fts"
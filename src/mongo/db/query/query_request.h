@@ -367,6 +367,18 @@ public:
         _allowPartialResults = allowPartialResults;
     }
 
+    /**
+     * Whether a blocking sort which exceeds its memory limit may spill to temporary files rather
+     * than fail.
+     */
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     boost::optional<long long> getReplicationTerm() const {
         return _replicationTerm;
     }
@@ -495,6 +507,8 @@ private:
     bool _exhaust = false;
     bool _allowPartialResults = false;
 
+    bool _allowDiskUse = false;
+
     boost::optional<long long> _replicationTerm;
 };
 
@@ -277,6 +277,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // When non-zero, the results are sorted by text score and only the 'topK' with the highest
+    // scores are needed, so the text node may skip any document that cannot score among them.
+    size_t topK = 0u;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
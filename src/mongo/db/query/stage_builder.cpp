@@ -36,6 +36,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
+#include "mongo/db/exec/and_bitmap.h"
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/collection_scan.h"
@@ -57,6 +58,8 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/planner_all_paths_helpers.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -99,6 +102,10 @@ PlanStage* buildStages(OperationContext* opCtx,
             invariant(params.descriptor);
 
             params.bounds = ixn->bounds;
+            if (ixn->index.type == INDEX_ALLPATHS) {
+                params.keyPattern = all_paths_planning::makeKeyPatternWithPath(ixn->index);
+                params.bounds = all_paths_planning::makeBoundsWithPath(ixn->index, ixn->bounds);
+            }
             params.direction = ixn->direction;
             params.addKeyMetadata = ixn->addKeyMetadata;
             return new IndexScan(opCtx, params, ws, ixn->filter.get());
@@ -121,6 +128,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.collection = collection;
             params.pattern = sn->pattern;
             params.limit = sn->limit;
+            params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
             return new SortStage(opCtx, params, ws, childStage);
         }
         case STAGE_SORT_KEY_GENERATOR: {
@@ -177,6 +185,18 @@ PlanStage* buildStages(OperationContext* opCtx,
         }
         case STAGE_AND_HASH: {
             const AndHashNode* ahn = static_cast<const AndHashNode*>(root);
+            if (internalQueryExecUseBitmapIntersection.load()) {
+                auto ret = make_unique<AndBitmapStage>(opCtx, ws, collection);
+                for (size_t i = 0; i < ahn->children.size(); ++i) {
+                    PlanStage* childStage =
+                        buildStages(opCtx, collection, cq, qsol, ahn->children[i], ws);
+                    if (nullptr == childStage) {
+                        return nullptr;
+                    }
+                    ret->addChild(childStage);
+                }
+                return ret.release();
+            }
             auto ret = make_unique<AndHashStage>(opCtx, ws, collection);
             for (size_t i = 0; i < ahn->children.size(); ++i) {
                 PlanStage* childStage =
@@ -285,6 +305,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            params.topK = node->topK;
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -343,7 +364,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.endKey = csn->endKey;
             params.endKeyInclusive = csn->endKeyInclusive;
 
-            return new CountScan(opCtx, params, ws);
+            return new CountScan(opCtx, params, ws, csn->filter.get());
         }
         case STAGE_ENSURE_SORTED: {
             const EnsureSortedNode* esn = static_cast<const EnsureSortedNode*>(root);
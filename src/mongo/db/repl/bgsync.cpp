@@ -77,6 +77,10 @@ const auto defaultBatchSize = (16 * 1024 * 1024) / 12 * 10;
 // The batchSize to use for the find/getMore queries called by the OplogFetcher
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(bgSyncOplogFetcherBatchSize, int, defaultBatchSize);
 
+// When true, the batchSize of the getMores called by the OplogFetcher is limited to the number of
+// operations that still fit in the oplog buffer. Read whenever a new OplogFetcher is started.
+MONGO_EXPORT_SERVER_PARAMETER(bgSyncOplogFetcherLimitBatchesToBufferSpace, bool, false);
+
 // The batchSize to use for the find/getMore queries called by the rollback common point resolver.
 // A batchSize of 0 means that the 'find' and 'getMore' commands will be given no batchSize.
 // We set the default to 2000 to prevent the sync source from having to read too much data at once,
@@ -427,6 +431,16 @@ void BackgroundSync::_produce() {
         auto onOplogFetcherShutdownCallbackFn = [&fetcherReturnStatus](const Status& status) {
             fetcherReturnStatus = status;
         };
+        OplogFetcher::GetBufferSpaceFn getBufferSpaceFn;
+        if (bgSyncOplogFetcherLimitBatchesToBufferSpace.load()) {
+            getBufferSpaceFn = [this] {
+                auto buffer = _oplogApplier->getBuffer();
+                auto size = buffer->getSize();
+                auto maxSize = buffer->getMaxSize();
+                return size < maxSize ? maxSize - size : 0;
+            };
+        }
+
         // The construction of OplogFetcher has to be outside bgsync mutex, because it calls
         // replication coordinator.
         auto oplogFetcherPtr = stdx::make_unique<OplogFetcher>(
@@ -443,7 +457,8 @@ void BackgroundSync::_produce() {
                 return this->_enqueueDocuments(a1, a2, a3);
             },
             onOplogFetcherShutdownCallbackFn,
-            bgSyncOplogFetcherBatchSize);
+            bgSyncOplogFetcherBatchSize,
+            std::move(getBufferSpaceFn));
         stdx::lock_guard<stdx::mutex> lock(_mutex);
         if (_state != ProducerState::Running) {
             return;
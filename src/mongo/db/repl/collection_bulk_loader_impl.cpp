@@ -43,6 +43,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/collection_bulk_loader_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -51,6 +52,15 @@
 namespace mongo {
 namespace repl {
 
+namespace {
+
+// When true, the secondary indexes of a collection cloned during initial sync are built by a single
+// scan of the collection after all of its documents have been inserted, which can generate the keys
+// of several indexes at once on internalIndexBuildKeyGenerationThreads threads.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncDeferSecondaryIndexBuilds, bool, false);
+
+}  // namespace
+
 CollectionBulkLoaderImpl::CollectionBulkLoaderImpl(ServiceContext::UniqueClient&& client,
                                                    ServiceContext::UniqueOperationContext&& opCtx,
                                                    std::unique_ptr<AutoGetCollection>&& autoColl,
@@ -100,6 +110,11 @@ Status CollectionBulkLoaderImpl::init(const std::vector<BSONObj>& secondaryIndex
                 _idIndexBlock.reset();
             }
 
+            // Without an _id index, documents are inserted through the indexes of the collection,
+            // which include the secondary indexes being built, so their keys cannot be deferred.
+            _deferSecondaryIndexes = initialSyncDeferSecondaryIndexBuilds.load() &&
+                _secondaryIndexesBlock && _idIndexBlock;
+
             return Status::OK();
         });
 }
@@ -115,7 +130,7 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
             if (_idIndexBlock) {
                 indexers.push_back(_idIndexBlock.get());
             }
-            if (_secondaryIndexesBlock) {
+            if (_secondaryIndexesBlock && !_deferSecondaryIndexes) {
                 indexers.push_back(_secondaryIndexesBlock.get());
             }
 
@@ -165,7 +180,9 @@ Status CollectionBulkLoaderImpl::commit() {
         // deleted.
         if (_secondaryIndexesBlock) {
             std::set<RecordId> secDups;
-            auto status = _secondaryIndexesBlock->doneInserting(&secDups);
+            auto status = _deferSecondaryIndexes
+                ? _secondaryIndexesBlock->insertAllDocumentsInCollection(&secDups)
+                : _secondaryIndexesBlock->doneInserting(&secDups);
             if (!status.isOK()) {
                 return status;
             }
@@ -88,6 +88,10 @@ private:
     NamespaceString _nss;
     std::unique_ptr<MultiIndexBlock> _idIndexBlock;
     std::unique_ptr<MultiIndexBlock> _secondaryIndexesBlock;
+
+    // When true, the keys of the secondary indexes are not generated as documents are inserted,
+    // but by scanning the collection once all of its documents are in, in commit().
+    bool _deferSecondaryIndexes = false;
     BSONObj _idIndexSpec;
     Stats _stats;
 };
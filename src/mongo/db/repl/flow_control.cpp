@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/flow_control.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// Whether the writes of a primary are throttled when its majority commit point lags behind.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(enableFlowControl, bool, false);
+
+// The majority commit lag above which flow control throttles writes.
+MONGO_EXPORT_SERVER_PARAMETER(flowControlTargetLagSeconds, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "flowControlTargetLagSeconds must be greater than or equal to 1");
+        }
+        return Status::OK();
+    });
+
+const auto getFlowControl = ServiceContext::declareDecoration<FlowControl>();
+
+}  // namespace
+
+constexpr int FlowControl::kMinTickets;
+constexpr int FlowControl::kMaxTickets;
+
+FlowControl::FlowControl() : _tickets(kMaxTickets) {}
+
+FlowControl& FlowControl::get(ServiceContext* service) {
+    return getFlowControl(service);
+}
+
+void FlowControl::startup(ServiceContext* service) {
+    if (!enableFlowControl) {
+        return;
+    }
+
+    auto periodicRunner = service->getPeriodicRunner();
+    invariant(periodicRunner);
+
+    Locker::setFlowControlThrottling(&_tickets);
+
+    PeriodicRunner::PeriodicJob job(
+        "FlowControl",
+        [this](Client* client) {
+            try {
+                // The opCtx destructor handles unsetting itself from the Client.
+                auto opCtx = client->makeOperationContext();
+                adjust(opCtx.get());
+            } catch (const DBException& ex) {
+                if (!ErrorCodes::isShutdownError(ex.code())) {
+                    warning() << "Periodic task to adjust flow control failed! Caused by: "
+                              << ex.toStatus();
+                }
+            }
+        },
+        Seconds(1));
+
+    periodicRunner->scheduleJob(std::move(job));
+}
+
+void FlowControl::adjust(OperationContext* opCtx) {
+    auto replCoord = ReplicationCoordinator::get(opCtx);
+    auto numTickets = kMaxTickets;
+    if (replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet &&
+        replCoord->getMemberState().primary()) {
+        const long long lastAppliedSecs =
+            replCoord->getMyLastAppliedOpTime().getTimestamp().getSecs();
+        const long long lastCommittedSecs =
+            replCoord->getLastCommittedOpTime().getTimestamp().getSecs();
+        numTickets = computeNumTickets(_tickets.outof(),
+                                       Seconds(lastAppliedSecs - lastCommittedSecs),
+                                       Seconds(flowControlTargetLagSeconds.load()));
+    }
+
+    if (numTickets == _tickets.outof()) {
+        return;
+    }
+
+    auto status = _tickets.resize(numTickets);
+    if (!status.isOK()) {
+        LOG(1) << "Could not resize flow control tickets to " << numTickets << ": " << status;
+        return;
+    }
+    LOG(1) << "Flow control now hands out " << numTickets << " write tickets";
+}
+
+int FlowControl::computeNumTickets(int numTickets, Seconds majorityLag, Seconds targetLag) {
+    if (majorityLag > targetLag) {
+        return std::max(kMinTickets, numTickets / 2);
+    }
+    return std::min(kMaxTickets, numTickets + std::max(kMinTickets, numTickets / 2));
+}
+
+int FlowControl::getNumTickets() const {
+    return _tickets.outof();
+}
+
+}  // namespace repl
+}  // namespace mongo
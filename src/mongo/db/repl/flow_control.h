@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+namespace repl {
+
+/**
+ * Throttles the writes of a primary whose majority commit point lags behind its last applied
+ * optime. While secondaries fall behind, the storage engine must keep all the history since the
+ * majority commit point in its cache; throttling the primary bounds that history.
+ *
+ * Writes from user connections take one of a limited number of tickets along with the global lock
+ * (see Locker::setFlowControlThrottling()). Once a second, the number of tickets is halved while
+ * the majority commit lag exceeds flowControlTargetLagSeconds, and grows back otherwise.
+ */
+class FlowControl {
+    MONGO_DISALLOW_COPYING(FlowControl);
+
+public:
+    // The TicketHolder cannot have fewer than five tickets.
+    static constexpr int kMinTickets = 5;
+    static constexpr int kMaxTickets = 1000;
+
+    FlowControl();
+
+    static FlowControl& get(ServiceContext* service);
+
+    /**
+     * Makes the writes of user connections take the tickets of this FlowControl, and starts a
+     * periodic job to adjust their number. Called once at startup, if enableFlowControl is set.
+     */
+    void startup(ServiceContext* service);
+
+    /**
+     * Sets the number of tickets from the majority commit lag of this node if it is a primary, or
+     * to kMaxTickets otherwise.
+     */
+    void adjust(OperationContext* opCtx);
+
+    /**
+     * Returns the number of tickets to hand out after 'numTickets', if the majority commit point
+     * lags 'majorityLag' behind the last applied optime.
+     */
+    static int computeNumTickets(int numTickets, Seconds majorityLag, Seconds targetLag);
+
+    int getNumTickets() const;
+
+private:
+    TicketHolder _tickets;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,58 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/flow_control.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+TEST(FlowControlTest, TicketsAreHalvedWhileMajorityLagExceedsTarget) {
+    ASSERT_EQ(500, FlowControl::computeNumTickets(1000, Seconds(11), Seconds(10)));
+    ASSERT_EQ(250, FlowControl::computeNumTickets(500, Seconds(11), Seconds(10)));
+    ASSERT_EQ(FlowControl::kMinTickets,
+              FlowControl::computeNumTickets(FlowControl::kMinTickets, Seconds(60), Seconds(10)));
+}
+
+TEST(FlowControlTest, TicketsGrowBackWhileMajorityLagIsWithinTarget) {
+    ASSERT_EQ(15, FlowControl::computeNumTickets(10, Seconds(10), Seconds(10)));
+    ASSERT_EQ(FlowControl::kMinTickets * 2,
+              FlowControl::computeNumTickets(FlowControl::kMinTickets, Seconds(0), Seconds(10)));
+    ASSERT_EQ(FlowControl::kMaxTickets,
+              FlowControl::computeNumTickets(800, Seconds(0), Seconds(10)));
+    ASSERT_EQ(FlowControl::kMaxTickets,
+              FlowControl::computeNumTickets(FlowControl::kMaxTickets, Seconds(0), Seconds(10)));
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
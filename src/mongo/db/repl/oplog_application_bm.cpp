@@ -0,0 +1,270 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/idempotency_test_fixture.h"
+#include "mongo/db/repl/oplog_applier.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/repl/sync_tail_test_fixture.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+enum class OpMix {
+    // Inserts of new documents.
+    kInserts,
+    // Updates of existing documents that change the keys of three secondary indexes.
+    kIndexedUpdates,
+    // Inserts into capped collections, which are not bulk inserted.
+    kCappedInserts,
+    // Unprepared transactions, each an applyOps entry of kOpsPerTransaction inserts.
+    kTransactions,
+};
+
+// Operations are spread over several collections, since the writer thread an operation goes to
+// is chosen by namespace on storage engines without document-level locking.
+const int kNumCollections = 16;
+
+// The number of CRUD operations in each batch given to multiApply().
+const int kOpsPerBatch = 1000;
+const int kOpsPerTransaction = 10;
+
+// The documents each collection holds for kIndexedUpdates to update.
+const int kDocsPerCollection = 100;
+
+NamespaceString collectionName(int i) {
+    return NamespaceString(str::stream() << "oplog_application_bm.coll" << i);
+}
+
+OplogEntry makeTransactionOplogEntry(OpTime opTime,
+                                     const LogicalSessionId& lsid,
+                                     TxnNumber txnNumber,
+                                     const BSONArray& operations) {
+    OperationSessionInfo sessionInfo;
+    sessionInfo.setSessionId(lsid);
+    sessionInfo.setTxnNumber(txnNumber);
+    return OplogEntry(opTime,                          // optime
+                      1LL,                             // hash
+                      OpTypeEnum::kCommand,            // op type
+                      NamespaceString("admin.$cmd"),   // namespace
+                      boost::none,                     // uuid
+                      boost::none,                     // fromMigrate
+                      OplogEntry::kOplogVersion,       // version
+                      BSON("applyOps" << operations),  // o
+                      boost::none,                     // o2
+                      sessionInfo,                     // session info
+                      boost::none,                     // upsert
+                      Date_t::now(),                   // wall clock time
+                      boost::none,                     // statement id
+                      boost::none,   // optime of previous write within same transaction
+                      boost::none,   // pre-image optime
+                      boost::none);  // post-image optime
+}
+
+/**
+ * Applies generated batches of oplog entries through SyncTail::multiApply(), with the
+ * multiSyncApply() writer function that steady state replication uses and a writer pool of the
+ * given size, over the storage engine the SyncTailTest fixture starts.
+ */
+class OplogApplicationFixture : public SyncTailTest {
+public:
+    OplogApplicationFixture(OpMix mix, int numWriterThreads)
+        : _mix(mix), _writerPool(OplogApplier::makeWriterPool(numWriterThreads)), _random(1) {
+        setUp();
+        _syncTail = std::make_unique<SyncTail>(nullptr,
+                                               getConsistencyMarkers(),
+                                               getStorageInterface(),
+                                               multiSyncApply,
+                                               _writerPool.get());
+
+        CollectionOptions options;
+        if (_mix == OpMix::kCappedInserts) {
+            options.capped = true;
+            options.cappedSize = 64 * 1024 * 1024;
+        }
+        for (int i = 0; i < kNumCollections; ++i) {
+            options.uuid = UUID::gen();
+            uassertStatusOK(
+                getStorageInterface()->createCollection(_opCtx.get(), collectionName(i), options));
+        }
+
+        if (_mix == OpMix::kTransactions) {
+            CollectionOptions transactionTableOptions;
+            transactionTableOptions.uuid = UUID::gen();
+            uassertStatusOK(getStorageInterface()->createCollection(
+                _opCtx.get(),
+                NamespaceString::kSessionTransactionsTableNamespace,
+                transactionTableOptions));
+            _lsid = makeLogicalSessionIdForTest();
+        }
+
+        if (_mix == OpMix::kIndexedUpdates) {
+            std::vector<OplogEntry> setupOps;
+            for (int i = 0; i < kNumCollections; ++i) {
+                for (auto&& field : {"a", "b", "c"}) {
+                    setupOps.push_back(makeCreateIndexOplogEntry(nextOpTime(),
+                                                                 collectionName(i),
+                                                                 str::stream() << field << "_1",
+                                                                 BSON(field << 1)));
+                }
+                for (int id = 0; id < kDocsPerCollection; ++id) {
+                    setupOps.push_back(makeInsertDocumentOplogEntry(
+                        nextOpTime(),
+                        collectionName(i),
+                        BSON("_id" << id << "a" << 0 << "b" << 0 << "c" << 0)));
+                }
+            }
+            uassertStatusOK(runOpsSteadyState(std::move(setupOps)));
+        }
+    }
+
+    ~OplogApplicationFixture() {
+        _syncTail.reset();
+        _writerPool->shutdown();
+        _writerPool->join();
+        tearDown();
+    }
+
+    /**
+     * Returns the next batch of operations to apply. Each batch holds kOpsPerBatch CRUD
+     * operations, possibly grouped into transactions.
+     */
+    MultiApplier::Operations makeBatch() {
+        MultiApplier::Operations ops;
+        switch (_mix) {
+            case OpMix::kInserts:
+            case OpMix::kCappedInserts:
+                for (int i = 0; i < kOpsPerBatch; ++i) {
+                    ops.push_back(makeInsertDocumentOplogEntry(
+                        nextOpTime(), _nextCollection(), BSON("_id" << _nextId++ << "x" << i)));
+                }
+                break;
+            case OpMix::kIndexedUpdates:
+                for (int i = 0; i < kOpsPerBatch; ++i) {
+                    const int value = _nextId++;
+                    ops.push_back(makeUpdateDocumentOplogEntry(
+                        nextOpTime(),
+                        _nextCollection(),
+                        BSON("_id" << _random.nextInt32(kDocsPerCollection)),
+                        BSON("$set" << BSON("a" << value << "b" << -value << "c"
+                                                << std::to_string(value)))));
+                }
+                break;
+            case OpMix::kTransactions:
+                for (int i = 0; i < kOpsPerBatch / kOpsPerTransaction; ++i) {
+                    BSONArrayBuilder operations;
+                    for (int j = 0; j < kOpsPerTransaction; ++j) {
+                        operations.append(BSON("op"
+                                               << "i"
+                                               << "ns"
+                                               << _nextCollection().ns()
+                                               << "o"
+                                               << BSON("_id" << _nextId++)));
+                    }
+                    ops.push_back(makeTransactionOplogEntry(
+                        nextOpTime(), _lsid, ++_txnNumber, operations.arr()));
+                }
+                break;
+        }
+        return ops;
+    }
+
+    void apply(MultiApplier::Operations ops) {
+        uassertStatusOK(_syncTail->multiApply(_opCtx.get(), std::move(ops)));
+    }
+
+private:
+    void _doTest() override {}
+
+    NamespaceString _nextCollection() {
+        return collectionName(_random.nextInt32(kNumCollections));
+    }
+
+    const OpMix _mix;
+    std::unique_ptr<ThreadPool> _writerPool;
+    std::unique_ptr<SyncTail> _syncTail;
+    PseudoRandom _random;
+    long long _nextId = kDocsPerCollection;
+    LogicalSessionId _lsid;
+    TxnNumber _txnNumber = 0;
+};
+
+void BM_MultiApply(benchmark::State& state, OpMix mix) {
+    OplogApplicationFixture fixture(mix, state.range(0));
+    for (auto keepRunning : state) {
+        state.PauseTiming();
+        auto batch = fixture.makeBatch();
+        state.ResumeTiming();
+
+        fixture.apply(std::move(batch));
+    }
+    state.SetItemsProcessed(state.iterations() * kOpsPerBatch);
+}
+
+BENCHMARK_CAPTURE(BM_MultiApply, Inserts, OpMix::kInserts)
+    ->ArgName("replWriterThreadCount")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MultiApply, IndexedUpdates, OpMix::kIndexedUpdates)
+    ->ArgName("replWriterThreadCount")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MultiApply, CappedInserts, OpMix::kCappedInserts)
+    ->ArgName("replWriterThreadCount")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_MultiApply, Transactions, OpMix::kTransactions)
+    ->ArgName("replWriterThreadCount")
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
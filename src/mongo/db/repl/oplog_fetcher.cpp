@@ -324,7 +324,8 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
                            DataReplicatorExternalState* dataReplicatorExternalState,
                            EnqueueDocumentsFn enqueueDocumentsFn,
                            OnShutdownCallbackFn onShutdownCallbackFn,
-                           const int batchSize)
+                           const int batchSize,
+                           GetBufferSpaceFn getBufferSpaceFn)
     : AbstractOplogFetcher(executor,
                            lastFetched,
                            source,
@@ -338,7 +339,8 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
       _dataReplicatorExternalState(dataReplicatorExternalState),
       _enqueueDocumentsFn(enqueueDocumentsFn),
       _awaitDataTimeout(calculateAwaitDataTimeout(config)),
-      _batchSize(batchSize) {
+      _batchSize(batchSize),
+      _getBufferSpaceFn(std::move(getBufferSpaceFn)) {
 
     invariant(config.isInitialized());
     invariant(enqueueDocumentsFn);
@@ -479,7 +481,6 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
-    // TODO: back pressure handling will be added in SERVER-23499.
     auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
     if (!status.isOK()) {
         return status;
@@ -511,7 +512,26 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
                                     queryResponse.cursorId,
                                     lastCommittedWithCurrentTerm,
                                     _getGetMoreMaxTime(),
-                                    _batchSize);
+                                    _getGetMoreBatchSize(info));
+}
+
+int OplogFetcher::_getGetMoreBatchSize(const DocumentsInfo& info) {
+    if (!_getBufferSpaceFn) {
+        return _batchSize;
+    }
+
+    if (info.networkDocumentCount > 0) {
+        _averageDocumentBytes = info.networkDocumentBytes / info.networkDocumentCount;
+    }
+    if (_averageDocumentBytes == 0) {
+        return _batchSize;
+    }
+
+    // Always ask for at least one document so that the cursor keeps making progress. The buffer
+    // makes room for it as the operations already buffered are applied.
+    auto numDocuments = _getBufferSpaceFn() / _averageDocumentBytes;
+    return static_cast<int>(
+        std::max<std::size_t>(1, std::min<std::size_t>(numDocuments, _batchSize)));
 }
 }  // namespace repl
 }  // namespace mongo
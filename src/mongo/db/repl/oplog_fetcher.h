@@ -62,7 +62,10 @@ MONGO_FAIL_POINT_DECLARE(stopReplProducer);
  * Pushes operations from each batch of operations onto a buffer using the "enqueueDocumentsFn"
  * function.
  *
- * Issues a getMore command after successfully processing each batch of operations.
+ * Issues a getMore command after successfully processing each batch of operations. If a
+ * "getBufferSpaceFn" function is provided, the batch size of the getMore is limited to the number
+ * of operations, estimated from the size of the operations fetched so far, that still fit in the
+ * buffer.
  *
  * When there is an error or when it is not possible to issue another getMore request, calls
  * "onShutdownCallbackFn" to signal the end of processing.
@@ -99,6 +102,12 @@ public:
                                                      Fetcher::Documents::const_iterator end,
                                                      const DocumentsInfo& info)>;
 
+    /**
+     * Type of function that returns the number of bytes of operations that can still be pushed
+     * onto the buffer fed by the EnqueueDocumentsFn before it is full.
+     */
+    using GetBufferSpaceFn = stdx::function<std::size_t()>;
+
     /**
      * Validates documents in current batch of results returned from tailing the remote oplog.
      * 'first' should be set to true if this set of documents is the first batch returned from the
@@ -123,7 +132,8 @@ public:
                  DataReplicatorExternalState* dataReplicatorExternalState,
                  EnqueueDocumentsFn enqueueDocumentsFn,
                  OnShutdownCallbackFn onShutdownCallbackFn,
-                 const int batchSize);
+                 const int batchSize,
+                 GetBufferSpaceFn getBufferSpaceFn = GetBufferSpaceFn());
 
     virtual ~OplogFetcher();
 
@@ -158,6 +168,11 @@ private:
      */
     StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) override;
 
+    /**
+     * Returns the batch size of the next getMore, having fetched the batch described by 'info'.
+     */
+    int _getGetMoreBatchSize(const DocumentsInfo& info);
+
     // The metadata object sent with the Fetcher queries.
     const BSONObj _metadataObject;
 
@@ -174,6 +189,11 @@ private:
     const EnqueueDocumentsFn _enqueueDocumentsFn;
     const Milliseconds _awaitDataTimeout;
     const int _batchSize;
+    const GetBufferSpaceFn _getBufferSpaceFn;
+
+    // Average size of the documents of the last non-empty batch. Only used to size getMores when
+    // _getBufferSpaceFn is provided.
+    std::size_t _averageDocumentBytes = 0;
 };
 
 }  // namespace repl
@@ -735,6 +735,50 @@ TEST_F(
                       request.cmdObj["lastKnownCommittedOpTime"].Obj())));
 }
 
+TEST_F(OplogFetcherTest, GetMoreBatchSizeIsLimitedToOperationsThatFitInTheBuffer) {
+    auto firstEntry = makeNoopOplogEntry(lastFetched);
+    auto secondEntry = makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.opTime.getTerm()}, 200);
+    const std::size_t averageDocumentBytes = (firstEntry.objsize() + secondEntry.objsize()) / 2;
+
+    std::size_t bufferSpace = 10 * averageDocumentBytes + 1;
+    ShutdownState shutdownState;
+    OplogFetcher oplogFetcher(&getExecutor(),
+                              lastFetched,
+                              source,
+                              nss,
+                              _createConfig(),
+                              0,
+                              rbid,
+                              true,
+                              dataReplicatorExternalState.get(),
+                              enqueueDocumentsFn,
+                              stdx::ref(shutdownState),
+                              defaultBatchSize,
+                              [&bufferSpace] { return bufferSpace; });
+    ASSERT_OK(oplogFetcher.startup());
+
+    // The find command is not limited, since nothing is known yet about the size of the documents.
+    auto metadataObj = makeOplogQueryMetadataObject(remoteNewerOpTime, rbid, 2, 2);
+    auto request = processNetworkResponse(
+        {makeCursorResponse(22LL, {firstEntry, secondEntry}), metadataObj, Milliseconds(0)}, true);
+    ASSERT_EQUALS(defaultBatchSize, request.cmdObj.getIntField("batchSize"));
+
+    // The first getMore was sized from the documents of the first batch. Once the buffer is full,
+    // the next getMore still lets the oplog fetcher fetch one document.
+    bufferSpace = 0;
+    auto thirdEntry = makeNoopOplogEntry({{Seconds(789), 0}, lastFetched.opTime.getTerm()}, 300);
+    request = processNetworkResponse(makeCursorResponse(22LL, {thirdEntry}, false), true);
+    ASSERT_EQUALS(std::string("getMore"), request.cmdObj.firstElementFieldName());
+    ASSERT_EQUALS(10, request.cmdObj.getIntField("batchSize"));
+
+    auto fourthEntry = makeNoopOplogEntry({{Seconds(1200), 0}, lastFetched.opTime.getTerm()}, 300);
+    request = processNetworkResponse(makeCursorResponse(0, {fourthEntry}, false));
+    ASSERT_EQUALS(1, request.cmdObj.getIntField("batchSize"));
+
+    oplogFetcher.join();
+    ASSERT_OK(shutdownState.getStatus());
+}
+
 TEST_F(OplogFetcherTest, ValidateDocumentsReturnsNoSuchKeyIfTimestampIsNotFoundInAnyDocument) {
     auto firstEntry = makeNoopOplogEntry(Seconds(123), 100);
     auto secondEntry = BSON("o" << BSON("msg"
@@ -42,7 +42,7 @@ namespace mongo {
 namespace repl {
 
 const Client::Decoration<ReplClientInfo> ReplClientInfo::forClient =
-    Client::declareDecoration<ReplClientInfo>();
+    Client::declareHotDecoration<ReplClientInfo>();
 
 void ReplClientInfo::setLastOp(const OpTime& ot) {
     invariant(ot >= _lastOp);
@@ -37,6 +37,7 @@
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/db/repl/topology_version.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -513,6 +514,22 @@ public:
      */
     virtual void fillIsMasterForReplSet(IsMasterResponse* result) = 0;
 
+    /**
+     * Returns the current topology version of this node, which changes whenever the contents of
+     * its isMaster responses that matter to server selection change.
+     */
+    virtual TopologyVersion getTopologyVersion() const = 0;
+
+    /**
+     * Blocks until the topology version of this node differs from 'clientTopologyVersion', the
+     * 'deadline' passes or the node shuts down, and then returns the current topology version.
+     * Returns immediately if 'clientTopologyVersion' is already stale. Throws if 'opCtx' is
+     * interrupted.
+     */
+    virtual TopologyVersion awaitTopologyChange(OperationContext* opCtx,
+                                                const TopologyVersion& clientTopologyVersion,
+                                                Date_t deadline) = 0;
+
     /**
      * Adds to "result" a description of the slaveInfo data structure used to map RIDs to their
      * last known optimes.
@@ -39,6 +39,7 @@
 #include "mongo/client/fetcher.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -59,6 +60,7 @@
 #include "mongo/db/repl/repl_set_request_votes_args.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_process.h"
+#include "mongo/db/repl/rollback_progress.h"
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/topology_coordinator.h"
@@ -67,6 +69,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/executor/connection_pool_stats.h"
@@ -105,6 +108,13 @@ const OperationContext::Decoration<bool> alwaysAllowNonLocalWrites =
 
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncAttempts, int, 10);
 
+// On a node that is not primary, the time from each write that became majority committed, as given
+// by the timestamp of its optime, to when the node learned that the write was committed. This is
+// how long the commit point takes to come down the replication chain to the node, to the second.
+TimerStats commitPointPropagationStats;
+ServerStatusMetricField<TimerStats> displayCommitPointPropagation("repl.commitPoint.propagation",
+                                                                  &commitPointPropagationStats);
+
 // Number of seconds between noop writer writes.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(periodicNoopIntervalSecs, int, 10);
 
@@ -247,12 +257,68 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::OrderedWaiters*
+ReplicationCoordinatorImpl::WaiterList::_orderedWaitersFor(WaiterType waiter) {
+    if (!waiter->writeConcern || waiter->writeConcern->wMode != WriteConcernOptions::kMajority) {
+        return nullptr;
+    }
+    const bool journal = waiter->writeConcern->syncMode == WriteConcernOptions::SyncMode::JOURNAL;
+    return &_majorityWaiters[journal];
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
+    if (auto orderedWaiters = _orderedWaitersFor(waiter)) {
+        orderedWaiters->emplace(waiter->opTime, waiter);
+        return;
+    }
     _list.push_back(waiter);
 }
 
+void ReplicationCoordinatorImpl::WaiterList::_signalOrderedIf_inlock(
+    OrderedWaiters* waiters,
+    const stdx::function<bool(WaiterType)>& func,
+    bool stopAtFirstUnsatisfied) {
+    for (auto it = waiters->begin(); it != waiters->end();) {
+        if (!func(it->second)) {
+            if (stopAtFirstUnsatisfied) {
+                return;
+            }
+            ++it;
+            continue;
+        }
+
+        if (!it->second->runs_once()) {
+            // Keep the waiter on the list and let the guard remove it instead.
+            it->second->notify_inlock();
+            ++it;
+            continue;
+        }
+
+        // As below, notify() must only be called after the waiter has been removed.
+        WaiterType waiter = it->second;
+        it = waiters->erase(it);
+        waiter->notify_inlock();
+    }
+}
+
+void ReplicationCoordinatorImpl::WaiterList::signalReadyIf_inlock(
+    stdx::function<bool(WaiterType)> func) {
+    for (auto& orderedWaiters : _majorityWaiters) {
+        _signalOrderedIf_inlock(&orderedWaiters, func, true);
+    }
+    _signalUnorderedIf_inlock(func);
+}
+
 void ReplicationCoordinatorImpl::WaiterList::signalIf_inlock(
     stdx::function<bool(WaiterType)> func) {
+    for (auto& orderedWaiters : _majorityWaiters) {
+        _signalOrderedIf_inlock(&orderedWaiters, func, false);
+    }
+    _signalUnorderedIf_inlock(func);
+}
+
+void ReplicationCoordinatorImpl::WaiterList::_signalUnorderedIf_inlock(
+    const stdx::function<bool(WaiterType)>& func) {
     for (auto it = _list.begin(); it != _list.end();) {
         if (!func(*it)) {
             // This element doesn't match, so we advance the iterator to the next one.
@@ -292,6 +358,17 @@ void ReplicationCoordinatorImpl::WaiterList::signalAll_inlock() {
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
+    if (auto orderedWaiters = _orderedWaitersFor(waiter)) {
+        auto range = orderedWaiters->equal_range(waiter->opTime);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == waiter) {
+                orderedWaiters->erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
     auto it = std::find(_list.begin(), _list.end(), waiter);
     if (it == _list.end()) {
         return false;
@@ -803,6 +880,7 @@ void ReplicationCoordinatorImpl::shutdown(OperationContext* opCtx) {
         stdx::unique_lock<stdx::mutex> lk(_mutex);
         fassert(28533, !_inShutdown);
         _inShutdown = true;
+        _topologyVersionChange.notify_all();
         if (_rsConfigState == kConfigPreStart) {
             warning() << "ReplicationCoordinatorImpl::shutdown() called before "
                          "startup() finished.  Shutting down without cleaning up the "
@@ -1978,6 +2056,9 @@ Status ReplicationCoordinatorImpl::processReplSetGetStatus(
             _storage->getLastStableCheckpointTimestamp(_service)},
         response,
         &result);
+    if (result.isOK()) {
+        RollbackProgress::get(_service).append(response, _replExecutor->now());
+    }
     return result;
 }
 
@@ -2001,6 +2082,32 @@ void ReplicationCoordinatorImpl::fillIsMasterForReplSet(IsMasterResponse* respon
     }
 }
 
+TopologyVersion ReplicationCoordinatorImpl::getTopologyVersion() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return TopologyVersion(_topologyProcessId, _topologyVersionCounter);
+}
+
+TopologyVersion ReplicationCoordinatorImpl::awaitTopologyChange(
+    OperationContext* opCtx, const TopologyVersion& clientTopologyVersion, Date_t deadline) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    // A version from another process, or one this process has moved past, is already stale.
+    if (clientTopologyVersion.getProcessId() == _topologyProcessId &&
+        clientTopologyVersion.getCounter() == _topologyVersionCounter) {
+        const long long counter = _topologyVersionCounter;
+        opCtx->waitForConditionOrInterruptUntil(_topologyVersionChange, lk, deadline, [&] {
+            return _inShutdown || _topologyVersionCounter != counter;
+        });
+    }
+
+    return TopologyVersion(_topologyProcessId, _topologyVersionCounter);
+}
+
+void ReplicationCoordinatorImpl::_incrementTopologyVersion_inlock() {
+    ++_topologyVersionCounter;
+    _topologyVersionChange.notify_all();
+}
+
 void ReplicationCoordinatorImpl::appendSlaveInfoData(BSONObjBuilder* result) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _topCoord->fillMemberData(result);
@@ -2404,6 +2511,9 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock(
             // We must be holding the global X lock to change _canAcceptNonLocalWrites.
             invariant(opCtx);
             invariant(opCtx->lockState()->isW());
+
+            // isMaster reports a primary which cannot accept writes yet as a secondary.
+            _incrementTopologyVersion_inlock();
         }
         _canAcceptNonLocalWrites = canAcceptWrites;
     }
@@ -2521,6 +2631,7 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock(
     }
 
     _memberState = newState;
+    _incrementTopologyVersion_inlock();
 
     _cancelAndRescheduleElectionTimeout_inlock();
 
@@ -2720,6 +2831,7 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(OperationContext* opCtx,
     _setConfigState_inlock(kConfigSteady);
 
     _topCoord->updateConfig(newConfig, myIndex, _replExecutor->now());
+    _incrementTopologyVersion_inlock();
 
     // updateConfig() can change terms, so update our term shadow to match.
     _termShadow.store(_topCoord->getTerm());
@@ -2802,7 +2914,7 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(OperationContext* opCtx,
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    _replicationWaiterList.signalIf_inlock([this](Waiter* waiter) {
+    _replicationWaiterList.signalReadyIf_inlock([this](Waiter* waiter) {
         return _doneWaitingForReplication_inlock(waiter->opTime, *waiter->writeConcern);
     });
 }
@@ -3112,6 +3224,14 @@ void ReplicationCoordinatorImpl::advanceCommitPoint(const OpTime& committedOpTim
 
 void ReplicationCoordinatorImpl::_advanceCommitPoint_inlock(const OpTime& committedOpTime) {
     if (_topCoord->advanceLastCommittedOpTime(committedOpTime)) {
+        if (!_getMemberState_inlock().primary() && !committedOpTime.isNull()) {
+            const auto committedWriteTime = Date_t::fromMillisSinceEpoch(
+                static_cast<long long>(committedOpTime.getTimestamp().getSecs()) * 1000);
+            const auto delay = _replExecutor->now() - committedWriteTime;
+            commitPointPropagationStats.recordMillis(
+                static_cast<int>(std::max(0LL, durationCount<Milliseconds>(delay))));
+        }
+
         if (_getMemberState_inlock().arbiter()) {
             // Arbiters do not store replicated data, so we consider their data trivially
             // consistent.
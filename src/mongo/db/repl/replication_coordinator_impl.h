@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -187,6 +188,12 @@ public:
 
     virtual void fillIsMasterForReplSet(IsMasterResponse* result) override;
 
+    TopologyVersion getTopologyVersion() const override;
+
+    TopologyVersion awaitTopologyChange(OperationContext* opCtx,
+                                        const TopologyVersion& clientTopologyVersion,
+                                        Date_t deadline) override;
+
     virtual void appendSlaveInfoData(BSONObjBuilder* result) override;
 
     virtual ReplSetConfig getConfig() const override;
@@ -503,11 +510,32 @@ private:
         bool remove_inlock(WaiterType waiter);
         // Signals all waiters that satisfy the condition.
         void signalIf_inlock(stdx::function<bool(WaiterType)> fun);
+        // Signals all waiters that satisfy the condition, which must hold for every "majority"
+        // waiter of the same sync mode with an earlier opTime whenever it holds for one. Those
+        // waiters are visited in opTime order and only up to the first one left waiting, so that
+        // advancing the commit point wakes them in bulk without looking at the rest.
+        void signalReadyIf_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals all waiters from the list.
         void signalAll_inlock();
 
     private:
+        using OrderedWaiters = std::multimap<OpTime, WaiterType>;
+
+        // Returns the ordered list that holds 'waiter', or nullptr if it is kept in '_list'.
+        OrderedWaiters* _orderedWaitersFor(WaiterType waiter);
+
+        // Signals the waiters of '_list' that satisfy 'fun'.
+        void _signalUnorderedIf_inlock(const stdx::function<bool(WaiterType)>& fun);
+
+        // Signals the waiters of 'waiters' that satisfy 'fun', stopping at the first one that
+        // does not if 'stopAtFirstUnsatisfied' is true.
+        static void _signalOrderedIf_inlock(OrderedWaiters* waiters,
+                                            const stdx::function<bool(WaiterType)>& fun,
+                                            bool stopAtFirstUnsatisfied);
+
         std::vector<WaiterType> _list;
+        // Waiters with a "majority" write concern, by whether they wait for journaling.
+        OrderedWaiters _majorityWaiters[2];
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
@@ -585,6 +613,7 @@ private:
 
     /**
      * Helper to wake waiters in _replicationWaiterList that are doneWaitingForReplication.
+     * "majority" waiters are woken in opTime order, up to the commit point.
      */
     void _wakeReadyWaiters_inlock();
 
@@ -771,6 +800,13 @@ private:
     PostMemberStateUpdateAction _updateMemberStateFromTopologyCoordinator_inlock(
         OperationContext* opCtx);
 
+    /**
+     * Increments the topology version counter and wakes up the threads waiting for it to change
+     * in awaitTopologyChange(). Call this whenever the member state, the config, the primary or
+     * anything else fillIsMasterForReplSet() reports for server selection changes.
+     */
+    void _incrementTopologyVersion_inlock();
+
     /**
      * Performs a post member-state update action.  Do not call while holding _mutex.
      */
@@ -1140,6 +1176,15 @@ private:
     // Used to signal threads waiting for changes to _memberState.
     stdx::condition_variable _memberStateChange;  // (M)
 
+    // Identifies this process in the topology versions it reports.
+    const OID _topologyProcessId = OID::gen();  // (R)
+
+    // Incremented whenever the replica set topology, as reported by isMaster, changes.
+    long long _topologyVersionCounter = 0;  // (M)
+
+    // Used to signal threads waiting in awaitTopologyChange for _topologyVersionCounter to change.
+    stdx::condition_variable _topologyVersionChange;  // (M)
+
     // Current ReplicaSet state.
     MemberState _memberState;  // (M)
 
@@ -202,8 +202,13 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
         hbStatusResponse = StatusWith<ReplSetHeartbeatResponse>(responseStatus);
     }
 
+    const int primaryIndexBefore = _topCoord->getCurrentPrimaryIndex();
     HeartbeatResponseAction action =
         _topCoord->processHeartbeatResponse(now, networkTime, target, hbStatusResponse);
+    if (_topCoord->getCurrentPrimaryIndex() != primaryIndexBefore) {
+        // The primary reported by isMaster changed.
+        _incrementTopologyVersion_inlock();
+    }
 
     if (action.getAction() == HeartbeatResponseAction::NoAction && hbStatusResponse.isOK() &&
         hbStatusResponse.getValue().hasState() &&
@@ -2904,6 +2904,94 @@ TEST_F(ReplCoordTest, IsMaster) {
     ASSERT_OK(roundTripped.initialize(response.toBSON()));
 }
 
+TEST_F(ReplCoordTest, TopologyVersionIncrementsOnMemberStateChange) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("_id" << 0 << "host"
+                                                     << "h1")
+                                          << BSON("_id" << 1 << "host"
+                                                        << "h2"))),
+                       HostAndPort("h1"));
+
+    const auto before = getReplCoord()->getTopologyVersion();
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    const auto after = getReplCoord()->getTopologyVersion();
+
+    ASSERT_EQUALS(before.getProcessId(), after.getProcessId());
+    ASSERT_GREATER_THAN(after.getCounter(), before.getCounter());
+}
+
+TEST_F(ReplCoordTest, AwaitTopologyChangeReturnsImmediatelyForStaleTopologyVersion) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("_id" << 0 << "host"
+                                                     << "h1")
+                                          << BSON("_id" << 1 << "host"
+                                                        << "h2"))),
+                       HostAndPort("h1"));
+
+    auto opCtx = makeOperationContext();
+    const auto current = getReplCoord()->getTopologyVersion();
+    ASSERT_GREATER_THAN(current.getCounter(), 0);
+
+    const TopologyVersion olderCounter(current.getProcessId(), current.getCounter() - 1);
+    ASSERT(current ==
+           getReplCoord()->awaitTopologyChange(opCtx.get(), olderCounter, Date_t::max()));
+
+    const TopologyVersion otherProcess(OID::gen(), current.getCounter());
+    ASSERT(current ==
+           getReplCoord()->awaitTopologyChange(opCtx.get(), otherProcess, Date_t::max()));
+}
+
+TEST_F(ReplCoordTest, AwaitTopologyChangeTimesOutIfTopologyDoesNotChange) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("_id" << 0 << "host"
+                                                     << "h1")
+                                          << BSON("_id" << 1 << "host"
+                                                        << "h2"))),
+                       HostAndPort("h1"));
+
+    auto opCtx = makeOperationContext();
+    const auto current = getReplCoord()->getTopologyVersion();
+    ASSERT(current ==
+           getReplCoord()->awaitTopologyChange(
+               opCtx.get(), current, Date_t::now() + Milliseconds(10)));
+}
+
+TEST_F(ReplCoordTest, AwaitTopologyChangeReturnsWhenMemberStateChanges) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("_id" << 0 << "host"
+                                                     << "h1")
+                                          << BSON("_id" << 1 << "host"
+                                                        << "h2"))),
+                       HostAndPort("h1"));
+
+    auto opCtx = makeOperationContext();
+    const auto current = getReplCoord()->getTopologyVersion();
+
+    stdx::thread stateChangeThread(
+        [&] { ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY)); });
+    const auto after = getReplCoord()->awaitTopologyChange(opCtx.get(), current, Date_t::max());
+    stateChangeThread.join();
+
+    ASSERT_EQUALS(current.getProcessId(), after.getProcessId());
+    ASSERT_GREATER_THAN(after.getCounter(), current.getCounter());
+}
+
 TEST_F(ReplCoordTest, IsMasterWithCommittedSnapshot) {
     init("mySet");
 
@@ -3287,6 +3375,76 @@ TEST_F(ReplCoordTest, AwaitReplicationShouldResolveAsNormalDuringAReconfig) {
     awaiterJournaled.reset();
 }
 
+TEST_F(ReplCoordTest, MajorityWaitersAreWokenUpToTheCommitPointInOpTimeOrder) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+
+    // Turn off readconcern majority support, and snapshots.
+    disableReadConcernMajoritySupport();
+    disableSnapshots();
+
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 1));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 1));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 2);
+    OpTimeWithTermOne time2(100, 3);
+    OpTimeWithTermOne time3(100, 4);
+    getReplCoord()->setMyLastAppliedOpTime(time3);
+    getReplCoord()->setMyLastDurableOpTime(time3);
+
+    WriteConcernOptions writeConcern;
+    writeConcern.wTimeout = WriteConcernOptions::kNoTimeout;
+    writeConcern.wMode = WriteConcernOptions::kMajority;
+    writeConcern.syncMode = WriteConcernOptions::SyncMode::NONE;
+
+    // Register the waiters out of opTime order.
+    ReplicationAwaiter awaiter3(getReplCoord(), getServiceContext());
+    awaiter3.setOpTime(time3);
+    awaiter3.setWriteConcern(writeConcern);
+    awaiter3.start();
+
+    ReplicationAwaiter awaiter1(getReplCoord(), getServiceContext());
+    awaiter1.setOpTime(time1);
+    awaiter1.setWriteConcern(writeConcern);
+    awaiter1.start();
+
+    ReplicationAwaiter awaiter2(getReplCoord(), getServiceContext());
+    awaiter2.setOpTime(time2);
+    awaiter2.setWriteConcern(writeConcern);
+    awaiter2.start();
+
+    // Advancing the commit point to time2 wakes up every waiter at or before it.
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(getReplCoord()->setLastDurableOptime_forTest(2, 1, time2));
+    ASSERT_OK(awaiter1.getResult().status);
+    ASSERT_OK(awaiter2.getResult().status);
+    awaiter1.reset();
+    awaiter2.reset();
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time3));
+    ASSERT_OK(getReplCoord()->setLastDurableOptime_forTest(2, 1, time3));
+    ASSERT_OK(awaiter3.getResult().status);
+    awaiter3.reset();
+}
+
 void doReplSetReconfigToFewer(ReplicationCoordinatorImpl* replCoord, Status* status) {
     auto client = getGlobalServiceContext()->makeClient("rsr");
     auto opCtx = client->makeOperationContext();
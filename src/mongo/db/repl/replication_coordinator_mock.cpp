@@ -295,6 +295,16 @@ void ReplicationCoordinatorMock::fillIsMasterForReplSet(IsMasterResponse* result
     result->setElectionId(OID::gen());
 }
 
+TopologyVersion ReplicationCoordinatorMock::getTopologyVersion() const {
+    return TopologyVersion(_topologyProcessId, 0);
+}
+
+TopologyVersion ReplicationCoordinatorMock::awaitTopologyChange(
+    OperationContext* opCtx, const TopologyVersion& clientTopologyVersion, Date_t deadline) {
+    // The topology of the mock never changes, so there is nothing to wait for.
+    return getTopologyVersion();
+}
+
 void ReplicationCoordinatorMock::appendSlaveInfoData(BSONObjBuilder* result) {}
 
 void ReplicationCoordinatorMock::appendConnectionStats(executor::ConnectionPoolStats* stats) const {
@@ -154,6 +154,12 @@ public:
 
     virtual void fillIsMasterForReplSet(IsMasterResponse* result);
 
+    TopologyVersion getTopologyVersion() const override;
+
+    TopologyVersion awaitTopologyChange(OperationContext* opCtx,
+                                        const TopologyVersion& clientTopologyVersion,
+                                        Date_t deadline) override;
+
     virtual void appendSlaveInfoData(BSONObjBuilder* result);
 
     void appendConnectionStats(executor::ConnectionPoolStats* stats) const override;
@@ -292,6 +298,7 @@ private:
     };
     bool _alwaysAllowWrites = false;
     bool _resetLastOpTimesCalled = false;
+    const OID _topologyProcessId = OID::gen();
 };
 
 }  // namespace repl
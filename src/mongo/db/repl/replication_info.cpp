@@ -32,6 +32,7 @@
 #include <list>
 #include <vector>
 
+#include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/connpool.h"
 #include "mongo/db/auth/sasl_mechanism_registry.h"
 #include "mongo/db/client.h"
@@ -230,6 +231,33 @@ public:
             LastError::get(opCtx->getClient()).disable();
         }
 
+        // Parse the optional 'topologyVersion' and 'maxAwaitTimeMS' fields. Given together, they
+        // make the command wait for up to 'maxAwaitTimeMS' for the topology to change from
+        // 'topologyVersion' before replying, so that monitors learn of changes such as elections
+        // as soon as they happen without polling.
+        boost::optional<TopologyVersion> clientTopologyVersion;
+        Milliseconds maxAwaitTime{0};
+        auto topologyVersionElement = cmdObj["topologyVersion"];
+        auto maxAwaitTimeMSElement = cmdObj["maxAwaitTimeMS"];
+        uassert(ErrorCodes::BadValue,
+                "'topologyVersion' and 'maxAwaitTimeMS' must be specified together",
+                !topologyVersionElement == !maxAwaitTimeMSElement);
+        if (topologyVersionElement) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'topologyVersion' must be of type Object, but was of type "
+                                  << typeName(topologyVersionElement.type()),
+                    topologyVersionElement.type() == BSONType::Object);
+            clientTopologyVersion =
+                uassertStatusOK(TopologyVersion::parse(topologyVersionElement.Obj()));
+
+            long long maxAwaitTimeMS;
+            uassertStatusOK(bsonExtractIntegerField(cmdObj, "maxAwaitTimeMS", &maxAwaitTimeMS));
+            uassert(ErrorCodes::BadValue,
+                    "'maxAwaitTimeMS' must not be negative",
+                    maxAwaitTimeMS >= 0);
+            maxAwaitTime = Milliseconds(maxAwaitTimeMS);
+        }
+
         transport::Session::TagMask sessionTagsToSet = 0;
         transport::Session::TagMask sessionTagsToUnset = 0;
 
@@ -334,6 +362,17 @@ public:
                 });
         }
 
+        auto replCoord = ReplicationCoordinator::get(opCtx);
+        if (replCoord->getSettings().usingReplSets()) {
+            // Read the topology version before the rest of the response, so that the response is
+            // never older than the version it reports.
+            const auto topologyVersion = clientTopologyVersion
+                ? replCoord->awaitTopologyChange(
+                      opCtx, *clientTopologyVersion, Date_t::now() + maxAwaitTime)
+                : replCoord->getTopologyVersion();
+            result.append("topologyVersion", topologyVersion.toBSON());
+        }
+
         appendReplicationInfo(opCtx, result, 0);
 
         if (serverGlobalParams.clusterRole == ClusterRole::ConfigServer) {
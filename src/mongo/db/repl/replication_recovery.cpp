@@ -41,6 +41,7 @@
 #include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/session.h"
 #include "mongo/util/log.h"
@@ -54,11 +55,33 @@ namespace {
 const auto kRecoveryBatchLogLevel = logger::LogSeverity::Debug(2);
 const auto kRecoveryOperationLogLevel = logger::LogSeverity::Debug(3);
 
+// How often the progress of replaying the oplog is logged at the default log level.
+const int kRecoveryProgressLogIntervalSecs = 10;
+
+/**
+ * The maximum number of operations in a batch applied during recovery, or 0 to use the limit of
+ * steady state replication. Recovery has no sync source to keep up with and is the only thing the
+ * node is doing, so it may apply larger batches than steady state replication.
+ */
+MONGO_EXPORT_SERVER_PARAMETER(replRecoveryBatchLimitOperations, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > (1000 * 1000)) {
+            return Status(
+                ErrorCodes::BadValue,
+                "replRecoveryBatchLimitOperations must be between 0 and 1 million, inclusive");
+        }
+
+        return Status::OK();
+    });
+
 /**
  * Tracks and logs operations applied during recovery.
  */
 class RecoveryOplogApplierStats : public OplogApplier::Observer {
 public:
+    RecoveryOplogApplierStats(Timestamp startPoint, Timestamp topOfOplog)
+        : _startPoint(startPoint), _topOfOplog(topOfOplog) {}
+
     void onBatchBegin(const OplogApplier::Operations& batch) final {
         _numBatches++;
         LOG_FOR_RECOVERY(kRecoveryBatchLogLevel)
@@ -80,7 +103,31 @@ public:
         }
     }
 
-    void onBatchEnd(const StatusWith<OpTime>&, const OplogApplier::Operations&) final {}
+    void onBatchEnd(const StatusWith<OpTime>& lastOpTimeApplied,
+                    const OplogApplier::Operations&) final {
+        if (!lastOpTimeApplied.isOK() ||
+            _sinceLastProgressLog.seconds() < kRecoveryProgressLogIntervalSecs) {
+            return;
+        }
+        _sinceLastProgressLog.reset();
+
+        // Oplog entries are assumed to be spread evenly over time between the start point and the
+        // top of the oplog, to estimate how much of the work is left.
+        const auto applied = lastOpTimeApplied.getValue().getTimestamp();
+        const double total = double(_topOfOplog.getSecs()) - _startPoint.getSecs();
+        const double done = double(applied.getSecs()) - _startPoint.getSecs();
+        auto stream = log();
+        stream << "Replication recovery has applied " << _numOpsApplied << " operations in "
+               << _numBatches << " batches through " << applied.toBSON() << " of "
+               << _topOfOplog.toBSON();
+        if (total > 0 && done > 0) {
+            const double elapsedSecs = _sinceStart.seconds();
+            stream << ", " << static_cast<int>(100 * done / total)
+                   << "% done. Estimated time remaining: "
+                   << static_cast<long long>(elapsedSecs * (total - done) / done) << " seconds";
+        }
+    }
+
     void onMissingDocumentsFetchedAndInserted(const std::vector<FetchInfo>&) final {}
 
     void complete(const OpTime& applyThroughOpTime) const {
@@ -90,6 +137,10 @@ public:
     }
 
 private:
+    const Timestamp _startPoint;
+    const Timestamp _topOfOplog;
+    Timer _sinceStart;
+    Timer _sinceLastProgressLog;
     std::size_t _numBatches = 0;
     std::size_t _numOpsApplied = 0;
 };
@@ -350,7 +401,7 @@ void ReplicationRecoveryImpl::_applyToEndOfOplog(OperationContext* opCtx,
     OplogBufferLocalOplog oplogBuffer(oplogApplicationStartPoint);
     oplogBuffer.startup(opCtx);
 
-    RecoveryOplogApplierStats stats;
+    RecoveryOplogApplierStats stats(oplogApplicationStartPoint, topOfOplog);
 
     auto writerPool = OplogApplier::makeWriterPool();
     OplogApplier::Options options;
@@ -367,7 +418,9 @@ void ReplicationRecoveryImpl::_applyToEndOfOplog(OperationContext* opCtx,
 
     OplogApplier::BatchLimits batchLimits;
     batchLimits.bytes = OplogApplier::calculateBatchLimitBytes(opCtx, _storageInterface);
-    batchLimits.ops = OplogApplier::getBatchLimitOperations();
+    batchLimits.ops = replRecoveryBatchLimitOperations.load() > 0
+        ? std::size_t(replRecoveryBatchLimitOperations.load())
+        : OplogApplier::getBatchLimitOperations();
 
     OpTime applyThroughOpTime;
     OplogApplier::Operations batch;
@@ -39,6 +39,7 @@
 #include "mongo/db/repl/replication_consistency_markers_mock.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/session_txn_record_gen.h"
@@ -47,6 +48,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -486,6 +488,17 @@ TEST_F(ReplicationRecoveryTest, RecoveryAppliesDocumentsWhenAppliedThroughIsBehi
     testRecoveryAppliesDocumentsWhenAppliedThroughIsBehind(hasStableTimestamp, hasStableCheckpoint);
 }
 
+TEST_F(ReplicationRecoveryTest, RecoveryAppliesDocumentsInBatchesOfTheRecoveryBatchLimit) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("replRecoveryBatchLimitOperations");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString("1"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(param->second->setFromString("0")); });
+
+    bool hasStableTimestamp = false;
+    bool hasStableCheckpoint = true;
+    testRecoveryAppliesDocumentsWhenAppliedThroughIsBehind(hasStableTimestamp, hasStableCheckpoint);
+}
+
 TEST_F(ReplicationRecoveryTest,
        RecoveryAppliesDocumentsWhenAppliedThroughIsBehindWithStableTimestamp) {
     bool hasStableTimestamp = true;
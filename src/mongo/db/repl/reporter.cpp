@@ -89,12 +89,14 @@ Reporter::Reporter(executor::TaskExecutor* executor,
                    PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
                    const HostAndPort& target,
                    Milliseconds keepAliveInterval,
-                   Milliseconds updatePositionTimeout)
+                   Milliseconds updatePositionTimeout,
+                   Milliseconds coalesceInterval)
     : _executor(executor),
       _prepareReplSetUpdatePositionCommandFn(prepareReplSetUpdatePositionCommandFn),
       _target(target),
       _keepAliveInterval(keepAliveInterval),
-      _updatePositionTimeout(updatePositionTimeout) {
+      _updatePositionTimeout(updatePositionTimeout),
+      _coalesceInterval(coalesceInterval) {
     uassert(ErrorCodes::BadValue, "null task executor", executor);
     uassert(ErrorCodes::BadValue,
             "null function to create replSetUpdatePosition command object",
@@ -106,6 +108,9 @@ Reporter::Reporter(executor::TaskExecutor* executor,
     uassert(ErrorCodes::BadValue,
             "update position timeout must be positive",
             updatePositionTimeout > Milliseconds(0));
+    uassert(ErrorCodes::BadValue,
+            "coalesce interval cannot be negative",
+            coalesceInterval >= Milliseconds(0));
 }
 
 Reporter::~Reporter() {
@@ -164,7 +169,30 @@ Status Reporter::trigger() {
         return _status;
     }
 
-    if (_keepAliveTimeoutWhen != Date_t()) {
+    if (_keepAliveTimeoutWhen != Date_t() && _coalesceInterval > Milliseconds(0)) {
+        invariant(_prepareAndSendCommandCallbackHandle.isValid());
+        auto when = _executor->now() + _coalesceInterval;
+        if (_keepAliveTimeoutWhen <= when) {
+            // The next command is sent soon enough to carry this update.
+            return Status::OK();
+        }
+
+        // Bring the keep alive timeout forward to 'when'. The callback of the previous timeout
+        // finds out that it was replaced, and does nothing.
+        _executor->cancel(_prepareAndSendCommandCallbackHandle);
+        auto scheduleResult =
+            _executor->scheduleWorkAt(when, [=](const executor::TaskExecutor::CallbackArgs& args) {
+                _prepareAndSendCommandCallback(args, false);
+            });
+        _status = scheduleResult.getStatus();
+        if (!_status.isOK()) {
+            _onShutdown_inlock();
+            return _status;
+        }
+        _prepareAndSendCommandCallbackHandle = scheduleResult.getValue();
+        _keepAliveTimeoutWhen = when;
+        return Status::OK();
+    } else if (_keepAliveTimeoutWhen != Date_t()) {
         // Reset keep alive expiration to signal handler that it was canceled internally.
         invariant(_prepareAndSendCommandCallbackHandle.isValid());
         _keepAliveTimeoutWhen = Date_t();
@@ -272,10 +300,14 @@ void Reporter::_processResponseCallback(
             return;
         }
 
-        if (!_isWaitingToSendReporter) {
+        if (!_isWaitingToSendReporter || _coalesceInterval > Milliseconds(0)) {
             // Since we are also on a timer, schedule a report for that interval, or until
-            // triggered.
-            auto when = _executor->now() + _keepAliveInterval;
+            // triggered. An update triggered while waiting for the response is sent with the
+            // ones triggered during the coalesce interval.
+            auto when = _executor->now() +
+                (_isWaitingToSendReporter ? std::min(_coalesceInterval, _keepAliveInterval)
+                                          : _keepAliveInterval);
+            _isWaitingToSendReporter = false;
             bool fromTrigger = false;
             auto scheduleResult = _executor->scheduleWorkAt(
                 when, [=](const executor::TaskExecutor::CallbackArgs& args) {
@@ -323,6 +355,11 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
             return;
         }
 
+        // A keep alive timeout that trigger() brought forward has nothing left to do.
+        if (args.myHandle != _prepareAndSendCommandCallbackHandle) {
+            return;
+        }
+
         _status = args.status;
 
         // Ignore CallbackCanceled status if keep alive was canceled by triggered.
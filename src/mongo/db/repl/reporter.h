@@ -60,6 +60,10 @@ namespace repl {
  *
  * Calling trigger() while it is in state 3 sends a command upstream and cancels the current
  * keep alive timeout, resetting the keep alive schedule.
+ *
+ * With a positive "coalesceInterval", the reporter instead sends the command triggered in states 2
+ * and 3 up to "coalesceInterval" ms later, so that a single command reports all the progress made
+ * in the meantime.
  */
 class Reporter {
     MONGO_DISALLOW_COPYING(Reporter);
@@ -77,7 +81,8 @@ public:
              PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
              const HostAndPort& target,
              Milliseconds keepAliveInterval,
-             Milliseconds updatePositionTimeout);
+             Milliseconds updatePositionTimeout,
+             Milliseconds coalesceInterval = Milliseconds(0));
 
     virtual ~Reporter();
 
@@ -202,6 +207,10 @@ private:
     // Callback handle to the scheduled task for preparing and sending the remote command.
     executor::TaskExecutor::CallbackHandle _prepareAndSendCommandCallbackHandle;
 
+    // Longest time a triggered update may wait to be sent with later ones. Zero if triggered
+    // updates are sent as soon as possible.
+    const Milliseconds _coalesceInterval;
+
     // Keep alive timeout callback will not run before this time.
     // If this date is Date_t(), the callback is either unscheduled or canceled.
     // Used for testing only.
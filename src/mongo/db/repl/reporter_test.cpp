@@ -695,6 +695,71 @@ TEST_F(ReporterTest,
     assertReporterDone();
 }
 
+TEST_F(ReporterTestNoTriggerAtSetUp, TriggersWithinCoalesceIntervalAreSentInOneUpdate) {
+    const Milliseconds coalesceInterval(100);
+    reporter =
+        stdx::make_unique<Reporter>(_executorProxy.get(),
+                                    [this]() { return prepareReplSetUpdatePositionCommandFn(); },
+                                    HostAndPort("h1"),
+                                    Milliseconds(1000),
+                                    Milliseconds(5000),
+                                    coalesceInterval);
+
+    ASSERT_OK(reporter->trigger());
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_EQUALS(getExecutor().now() + reporter->getKeepAliveInterval(),
+                  reporter->getKeepAliveTimeoutWhen_forTest());
+
+    // The first trigger brings the keep alive timeout forward to the end of the coalesce interval.
+    ASSERT_OK(reporter->trigger());
+    auto coalescedWhen = getExecutor().now() + coalesceInterval;
+    ASSERT_EQUALS(coalescedWhen, reporter->getKeepAliveTimeoutWhen_forTest());
+
+    // Later triggers wait for the same update.
+    runUntil(getExecutor().now() + coalesceInterval / 2);
+    ASSERT_OK(reporter->trigger());
+    ASSERT_EQUALS(coalescedWhen, reporter->getKeepAliveTimeoutWhen_forTest());
+
+    runUntil(coalescedWhen, true);
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_EQUALS(getExecutor().now() + reporter->getKeepAliveInterval(),
+                  reporter->getKeepAliveTimeoutWhen_forTest());
+
+    reporter->shutdown();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, reporter->join());
+    assertReporterDone();
+}
+
+TEST_F(ReporterTestNoTriggerAtSetUp, TriggerWhileCommandIsInProgressIsSentAfterCoalesceInterval) {
+    const Milliseconds coalesceInterval(100);
+    reporter =
+        stdx::make_unique<Reporter>(_executorProxy.get(),
+                                    [this]() { return prepareReplSetUpdatePositionCommandFn(); },
+                                    HostAndPort("h1"),
+                                    Milliseconds(1000),
+                                    Milliseconds(5000),
+                                    coalesceInterval);
+
+    ASSERT_OK(reporter->trigger());
+    ASSERT_OK(reporter->trigger());
+    ASSERT_TRUE(reporter->isWaitingToSendReport());
+
+    // The update triggered while the first command was in progress is not sent immediately.
+    processNetworkResponse(BSON("ok" << 1));
+    auto coalescedWhen = getExecutor().now() + coalesceInterval;
+    ASSERT_EQUALS(coalescedWhen, reporter->getKeepAliveTimeoutWhen_forTest());
+    ASSERT_FALSE(reporter->isWaitingToSendReport());
+
+    runUntil(coalescedWhen, true);
+    processNetworkResponse(BSON("ok" << 1));
+
+    reporter->shutdown();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, reporter->join());
+    assertReporterDone();
+}
+
 TEST_F(ReporterTest, ShutdownImmediatelyAfterTriggerWhileKeepAliveTimeoutIsScheduledShouldSucceed) {
     processNetworkResponse(BSON("ok" << 1));
 
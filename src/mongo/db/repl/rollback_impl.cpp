@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/roll_back_local_operations.h"
+#include "mongo/db/repl/rollback_progress.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
 #include "mongo/db/s/type_shard_identity.h"
@@ -133,8 +134,22 @@ RollbackImpl::~RollbackImpl() {
 }
 
 Status RollbackImpl::runRollback(OperationContext* opCtx) {
+    auto& progress = RollbackProgress::get(opCtx->getServiceContext());
+    progress.start(opCtx->getServiceContext()->getFastClockSource()->now());
+    auto status = _runRollback(opCtx);
+    progress.finish(status, opCtx->getServiceContext()->getFastClockSource()->now());
+    return status;
+}
+
+void RollbackImpl::_startPhase(OperationContext* opCtx, StringData name) {
+    RollbackProgress::get(opCtx->getServiceContext())
+        .startPhase(name, opCtx->getServiceContext()->getFastClockSource()->now());
+}
+
+Status RollbackImpl::_runRollback(OperationContext* opCtx) {
     _rollbackStats.startTime = opCtx->getServiceContext()->getFastClockSource()->now();
 
+    _startPhase(opCtx, "transitionToRollback");
     auto status = _transitionToRollback(opCtx);
     if (!status.isOK()) {
         return status;
@@ -152,12 +167,14 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     ON_BLOCK_EXIT([this, opCtx] { _summarizeRollback(opCtx); });
 
     // Wait for all background index builds to complete before starting the rollback process.
+    _startPhase(opCtx, "awaitBackgroundIndexBuilds");
     status = _awaitBgIndexCompletion(opCtx);
     if (!status.isOK()) {
         return status;
     }
     _listener->onBgIndexesComplete();
 
+    _startPhase(opCtx, "findCommonPoint");
     auto commonPointSW = _findCommonPoint(opCtx);
     if (!commonPointSW.isOK()) {
         return commonPointSW.getStatus();
@@ -180,6 +197,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     // point, we keep track of how much each collection's count will change during the rollback.
     // Note: these numbers are relative to the common point, not the stable timestamp, and thus
     // must be set after recovering from the oplog.
+    _startPhase(opCtx, "findRecordStoreCounts");
     status = _findRecordStoreCounts(opCtx);
     if (!status.isOK()) {
         return status;
@@ -197,6 +215,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     if (shouldCreateDataFiles()) {
         // Write a rollback file for each namespace that has documents that would be deleted by
         // rollback.
+        _startPhase(opCtx, "writeRollbackFiles");
         status = _writeRollbackFiles(opCtx);
         if (!status.isOK()) {
             return status;
@@ -206,6 +225,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     }
 
     // Recover to the stable timestamp.
+    _startPhase(opCtx, "recoverToStableTimestamp");
     auto stableTimestampSW = _recoverToStableTimestamp(opCtx);
     if (!stableTimestampSW.isOK()) {
         return stableTimestampSW.getStatus();
@@ -253,12 +273,14 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     _resetDropPendingState(opCtx);
 
     // Run the recovery process.
+    _startPhase(opCtx, "recoverFromOplog");
     _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx,
                                                                     stableTimestampSW.getValue());
     _listener->onRecoverFromOplog();
 
     // Sets the correct post-rollback counts on any collections whose counts changed during the
     // rollback.
+    _startPhase(opCtx, "correctRecordStoreCounts");
     _correctRecordStoreCounts(opCtx);
 
     // At this point, the last applied and durable optimes on this node still point to ops on
@@ -266,6 +288,7 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     // oplog, which should now be at the common point.
     _replicationCoordinator->resetLastOpTimesFromOplog(
         opCtx, ReplicationCoordinator::DataConsistency::Consistent);
+    _startPhase(opCtx, "triggerOpObserver");
     status = _triggerOpObserver(opCtx);
     if (!status.isOK()) {
         return status;
@@ -335,6 +335,17 @@ private:
     Timestamp _findTruncateTimestamp(
         OperationContext* opCtx, RollBackLocalOperations::RollbackCommonPoint commonPoint) const;
 
+    /**
+     * Performs the steps of runRollback(), whose progress it records in the RollbackProgress of
+     * the service.
+     */
+    Status _runRollback(OperationContext* opCtx);
+
+    /**
+     * Records that the phase 'name' of the rollback starts now.
+     */
+    void _startPhase(OperationContext* opCtx, StringData name);
+
     /**
      * Uses the ReplicationCoordinator to transition the current member state to ROLLBACK.
      * If the transition to ROLLBACK fails, this could mean that we have been elected PRIMARY. In
@@ -39,6 +39,7 @@
 #include "mongo/db/repl/oplog_interface_local.h"
 #include "mongo/db/repl/oplog_interface_mock.h"
 #include "mongo/db/repl/rollback_impl.h"
+#include "mongo/db/repl/rollback_progress.h"
 #include "mongo/db/repl/rollback_test_fixture.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
 #include "mongo/db/s/type_shard_identity.h"
@@ -493,6 +494,31 @@ TEST_F(RollbackImplTest, RollbackFailsIfRollbackPeriodIsTooLong) {
     ASSERT_EQUALS(ErrorCodes::UnrecoverableRollbackError, rollbackStatus.code());
 }
 
+TEST_F(RollbackImplTest, RollbackProgressReportsPhasesOfCompletedRollback) {
+    auto commonPoint = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonPoint});
+    ASSERT_OK(_insertOplogEntry(commonPoint.first));
+    ASSERT_OK(_insertOplogEntry(makeOp(2)));
+    _storageInterface->setStableTimestamp(nullptr, Timestamp(1, 1));
+
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+
+    BSONObjBuilder bob;
+    RollbackProgress::get(getServiceContext()).append(&bob, Date_t::now());
+    auto progress = bob.obj()["rollbackStatus"].Obj();
+    ASSERT_EQUALS("complete", progress["state"].String());
+    ASSERT_FALSE(progress.hasField("currentPhase"));
+    ASSERT_TRUE(progress.hasField("endTime"));
+
+    std::vector<std::string> phases;
+    for (auto&& phase : progress["phases"].Obj()) {
+        phases.push_back(phase.Obj()["name"].String());
+    }
+    ASSERT_GTE(phases.size(), 3U);
+    ASSERT_EQUALS("transitionToRollback", phases.front());
+    ASSERT_EQUALS("triggerOpObserver", phases.back());
+}
+
 TEST_F(RollbackImplTest, RollbackPersistsDocumentAfterCommonPointToOplogTruncateAfterPoint) {
     auto commonPoint = makeOpAndRecordId(2);
     _remoteOplog->setOperations({commonPoint});
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/rollback_progress.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const auto getRollbackProgress = ServiceContext::declareDecoration<RollbackProgress>();
+
+}  // namespace
+
+RollbackProgress& RollbackProgress::get(ServiceContext* service) {
+    return getRollbackProgress(service);
+}
+
+void RollbackProgress::start(Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _started = true;
+    _finished = false;
+    _status = Status::OK();
+    _start = now;
+    _end = Date_t();
+    _phases.clear();
+}
+
+void RollbackProgress::startPhase(StringData name, Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_phases.empty() && _phases.back().end == Date_t()) {
+        _phases.back().end = now;
+    }
+    _phases.push_back({name.toString(), now, Date_t()});
+}
+
+void RollbackProgress::finish(const Status& status, Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_phases.empty() && _phases.back().end == Date_t()) {
+        _phases.back().end = now;
+    }
+    _finished = true;
+    _status = status;
+    _end = now;
+}
+
+void RollbackProgress::append(BSONObjBuilder* builder, Date_t now) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_started) {
+        return;
+    }
+
+    BSONObjBuilder rollbackBob(builder->subobjStart("rollbackStatus"));
+    rollbackBob.append("state", _finished ? (_status.isOK() ? "complete" : "failed") : "running");
+    rollbackBob.appendDate("startTime", _start);
+    if (_finished) {
+        rollbackBob.appendDate("endTime", _end);
+        if (!_status.isOK()) {
+            rollbackBob.append("error", _status.toString());
+        }
+    }
+    const auto end = _finished ? _end : now;
+    rollbackBob.appendNumber("elapsedMillis", durationCount<Milliseconds>(end - _start));
+    if (!_finished && !_phases.empty()) {
+        rollbackBob.append("currentPhase", _phases.back().name);
+    }
+
+    BSONArrayBuilder phasesBob(rollbackBob.subarrayStart("phases"));
+    for (auto&& phase : _phases) {
+        const auto phaseEnd = phase.end == Date_t() ? now : phase.end;
+        BSONObjBuilder(phasesBob.subobjStart())
+            .append("name", phase.name)
+            .appendNumber("durationMillis", durationCount<Milliseconds>(phaseEnd - phase.start));
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+namespace repl {
+
+/**
+ * Records the phases of the rollback running on this node, or of the last one to have run, and the
+ * time each took, so that they can be reported by replSetGetStatus while the rollback goes on.
+ *
+ * This class is thread-safe.
+ */
+class RollbackProgress {
+public:
+    static RollbackProgress& get(ServiceContext* service);
+
+    /**
+     * Forgets the last rollback, and records that a new one started at 'now'.
+     */
+    void start(Date_t now);
+
+    /**
+     * Ends the current phase, if any, and starts the phase 'name' at 'now'.
+     */
+    void startPhase(StringData name, Date_t now);
+
+    /**
+     * Ends the current phase, if any, and the rollback, at 'now'.
+     */
+    void finish(const Status& status, Date_t now);
+
+    /**
+     * Appends the progress of the rollback to 'builder', if a rollback has started since startup.
+     */
+    void append(BSONObjBuilder* builder, Date_t now) const;
+
+private:
+    struct Phase {
+        std::string name;
+        Date_t start;
+        Date_t end;
+    };
+
+    mutable stdx::mutex _mutex;
+    bool _started = false;
+    bool _finished = false;
+    Status _status = Status::OK();
+    Date_t _start;
+    Date_t _end;
+
+    // The phases that have started, in order. Only the last one may not have ended.
+    std::vector<Phase> _phases;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -31,6 +31,8 @@
 #include "mongo/db/repl/session_update_tracker.h"
 
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/retryable_write_history_cache.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/session.h"
 #include "mongo/util/assert_util.h"
 
@@ -59,6 +61,20 @@ void SessionUpdateTracker::_updateSessionInfo(const OplogEntry& entry) {
     auto lsid = sessionInfo.getSessionId();
     fassert(50842, lsid.is_initialized());
 
+    // Keep the history of retryable writes cached as they are applied, so that the first retry
+    // after this node becomes primary does not have to read it back from the oplog.
+    auto& historyCache = RetryableWriteHistoryCache::get(getGlobalServiceContext());
+    if (entry.isCommand() || !entry.getStatementId()) {
+        historyCache.invalidate(*lsid);
+    } else {
+        const auto prevOpTime = entry.getPrevWriteOpTimeInTransaction().value_or(OpTime());
+        historyCache.onStatementsWritten(*lsid,
+                                         *sessionInfo.getTxnNumber(),
+                                         {*entry.getStatementId()},
+                                         entry.getOpTime(),
+                                         prevOpTime);
+    }
+
     auto iter = _sessionsToUpdate.find(lsid->getId());
     if (iter == _sessionsToUpdate.end()) {
         _sessionsToUpdate.emplace(lsid->getId(), entry);
@@ -37,6 +37,7 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/reporter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
@@ -55,6 +56,17 @@ const Milliseconds maximumKeepAliveIntervalMS(30 * 1000);
 // The network timeout used for replSetUpdatePosition requests made to a node's sync source.
 const Seconds syncSourceFeedbackNetworkTimeoutSecs(30);
 
+// How long the progress reported after each applied batch may wait to be sent to the sync source
+// with the progress of later batches. Zero sends a replSetUpdatePosition as soon as possible.
+MONGO_EXPORT_SERVER_PARAMETER(syncSourceFeedbackCoalesceMillis, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "syncSourceFeedbackCoalesceMillis must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
 /**
  * Calculates the keep alive interval based on the given ReplSetConfig.
  */
@@ -217,7 +229,8 @@ void SyncSourceFeedback::run(executor::TaskExecutor* executor,
                           makePrepareReplSetUpdatePositionCommandFn(replCoord, syncTarget, bgsync),
                           syncTarget,
                           keepAliveInterval,
-                          syncSourceFeedbackNetworkTimeoutSecs);
+                          syncSourceFeedbackNetworkTimeoutSecs,
+                          Milliseconds(syncSourceFeedbackCoalesceMillis.load()));
         {
             stdx::lock_guard<stdx::mutex> lock(_mtx);
             if (_shutdownSignaled) {
@@ -66,11 +66,13 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/session_update_tracker.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -88,6 +90,14 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(pauseBatchApplicationBeforeCompletion);
 
+// When true, the operations of a batch are divided among the writer threads while the previous
+// batch is being applied, rather than at the start of the batch's own application.
+MONGO_EXPORT_SERVER_PARAMETER(replPrepareBatchesAhead, bool, false);
+
+// When true, an operation that does not conflict with any earlier operation of its batch is given
+// to the writer thread with the fewest operations, rather than to the writer its hash selects.
+MONGO_EXPORT_SERVER_PARAMETER(replAssignOpsToLeastLoadedWriter, bool, false);
+
 // The oplog entries applied
 Counter64 opsAppliedStats;
 ServerStatusMetricField<Counter64> displayOpsApplied("repl.apply.ops", &opsAppliedStats);
@@ -219,24 +229,25 @@ NamespaceString parseUUIDOrNs(OperationContext* opCtx, const OplogEntry& oplogEn
     return nss;
 }
 
-NamespaceStringOrUUID getNsOrUUID(const NamespaceString& nss, const BSONObj& op) {
-    if (auto ui = op["ui"]) {
-        return {nss.db().toString(), uassertStatusOK(UUID::parse(ui))};
+NamespaceStringOrUUID getNsOrUUID(const NamespaceString& nss, const boost::optional<UUID>& uuid) {
+    if (uuid) {
+        return {nss.db().toString(), *uuid};
     }
     return nss;
 }
 
-}  // namespace
-
-// static
-Status SyncTail::syncApply(OperationContext* opCtx,
-                           const BSONObj& op,
-                           OplogApplication::Mode oplogApplicationMode) {
+/**
+ * Applies 'op', whose namespace, type and collection UUID have already been parsed from it.
+ */
+Status syncApplyParsed(OperationContext* opCtx,
+                       const BSONObj& op,
+                       const NamespaceString& nss,
+                       OpTypeEnum opType,
+                       const boost::optional<UUID>& uuid,
+                       OplogApplication::Mode oplogApplicationMode) {
     // Count each log op application as a separate operation, for reporting purposes
     CurOp individualOp(opCtx);
 
-    const NamespaceString nss(op.getStringField("ns"));
-
     auto incrementOpsAppliedStats = [] { opsAppliedStats.increment(1); };
 
     auto applyOp = [&](Database* db) {
@@ -262,8 +273,6 @@ Status SyncTail::syncApply(OperationContext* opCtx,
         return status;
     };
 
-    auto opType = OpType_parse(IDLParserErrorContext("syncApply"), op["op"].valuestrsafe());
-
     if (opType == OpTypeEnum::kNoop) {
         if (nss.db() == "") {
             return Status::OK();
@@ -279,7 +288,7 @@ Status SyncTail::syncApply(OperationContext* opCtx,
         return writeConflictRetry(opCtx, "syncApply_CRUD", nss.ns(), [&] {
             // Need to throw instead of returning a status for it to be properly ignored.
             try {
-                AutoGetCollection autoColl(opCtx, getNsOrUUID(nss, op), MODE_IX);
+                AutoGetCollection autoColl(opCtx, getNsOrUUID(nss, uuid), MODE_IX);
                 auto db = autoColl.getDb();
                 uassert(ErrorCodes::NamespaceNotFound,
                         str::stream() << "missing database (" << nss.db() << ")",
@@ -320,6 +329,35 @@ Status SyncTail::syncApply(OperationContext* opCtx,
     MONGO_UNREACHABLE;
 }
 
+}  // namespace
+
+// static
+Status SyncTail::syncApply(OperationContext* opCtx,
+                           const BSONObj& op,
+                           OplogApplication::Mode oplogApplicationMode) {
+    const NamespaceString nss(op.getStringField("ns"));
+    auto opType = OpType_parse(IDLParserErrorContext("syncApply"), op["op"].valuestrsafe());
+    // Only CRUD operations are applied by UUID.
+    boost::optional<UUID> uuid;
+    auto ui = op["ui"];
+    if (ui && OplogEntry::isCrudOpType(opType)) {
+        uuid = uassertStatusOK(UUID::parse(ui));
+    }
+    return syncApplyParsed(opCtx, op, nss, opType, uuid, oplogApplicationMode);
+}
+
+// static
+Status SyncTail::syncApply(OperationContext* opCtx,
+                           const OplogEntry& entry,
+                           OplogApplication::Mode oplogApplicationMode) {
+    return syncApplyParsed(opCtx,
+                           entry.raw,
+                           entry.getNamespace(),
+                           entry.getOpType(),
+                           entry.getUuid(),
+                           oplogApplicationMode);
+}
+
 SyncTail::SyncTail(OplogApplier::Observer* observer,
                    ReplicationConsistencyMarkers* consistencyMarkers,
                    StorageInterface* storageInterface,
@@ -479,6 +517,46 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Chooses the writer thread for each operation of a batch from the hash of the key the operation
+ * conflicts on, which covers the document it writes when operations on the collection may be
+ * applied out of order, and only the namespace otherwise. Operations with the same hash are always
+ * given to the same writer, so they are applied in the order they appear in the batch.
+ *
+ * By default the writer is the hash modulo the number of writers. If 'balance' is true, the first
+ * operation with a given hash is instead given to the writer with the fewest operations, so that
+ * a batch of non-conflicting operations is spread evenly over the writers.
+ */
+class WriterAssigner {
+public:
+    explicit WriterAssigner(bool balance) : _balance(balance) {}
+
+    uint32_t getWriter(uint32_t hash,
+                       const std::vector<MultiApplier::OperationPtrs>& writerVectors) {
+        if (!_balance) {
+            return hash % writerVectors.size();
+        }
+
+        auto it = _writersByHash.find(hash);
+        if (it != _writersByHash.end()) {
+            return it->second;
+        }
+
+        uint32_t writer = 0;
+        for (uint32_t i = 1; i < writerVectors.size(); ++i) {
+            if (writerVectors[i].size() < writerVectors[writer].size()) {
+                writer = i;
+            }
+        }
+        _writersByHash.emplace(hash, writer);
+        return writer;
+    }
+
+private:
+    const bool _balance;
+    stdx::unordered_map<uint32_t, uint32_t> _writersByHash;
+};
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
@@ -486,22 +564,32 @@ private:
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
+ * writerAssigner - Chooses the writer of each operation. Shared by all the operations of a batch.
  */
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps,
-                       SessionUpdateTracker* sessionUpdateTracker) {
+                       SessionUpdateTracker* sessionUpdateTracker,
+                       WriterAssigner* writerAssigner) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getStorageEngine();
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
-    const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
 
+    // Runs of operations on the same namespace, as in single collection workloads, only hash their
+    // namespace once. The key refers to the namespace of an operation of 'ops', which outlives it.
+    StringMapTraits::HashedKey hashedNs;
+    bool hashedNsIsSet = false;
+
     for (auto&& op : *ops) {
-        StringMapTraits::HashedKey hashedNs(op.getNamespace().ns());
+        const auto& ns = op.getNamespace().ns();
+        if (!hashedNsIsSet || hashedNs.key() != ns) {
+            hashedNs = StringMapTraits::HashedKey(ns);
+            hashedNsIsSet = true;
+        }
         uint32_t hash = hashedNs.hash();
 
         // We need to track all types of ops, including type 'n' (these are generated from chunk
@@ -509,7 +597,12 @@ void fillWriterVectors(OperationContext* opCtx,
         if (sessionUpdateTracker) {
             if (auto newOplogWrites = sessionUpdateTracker->updateOrFlush(op)) {
                 derivedOps->emplace_back(std::move(*newOplogWrites));
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                fillWriterVectors(opCtx,
+                                  &derivedOps->back(),
+                                  writerVectors,
+                                  derivedOps,
+                                  nullptr,
+                                  writerAssigner);
             }
         }
 
@@ -545,8 +638,12 @@ void fillWriterVectors(OperationContext* opCtx,
             }
             try {
                 derivedOps->emplace_back(ApplyOps::extractOperations(op));
-                fillWriterVectors(
-                    opCtx, &derivedOps->back(), writerVectors, derivedOps, sessionUpdateTracker);
+                fillWriterVectors(opCtx,
+                                  &derivedOps->back(),
+                                  writerVectors,
+                                  derivedOps,
+                                  sessionUpdateTracker,
+                                  writerAssigner);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     50711,
@@ -557,7 +654,7 @@ void fillWriterVectors(OperationContext* opCtx,
             continue;
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
+        auto& writer = (*writerVectors)[writerAssigner->getWriter(hash, *writerVectors)];
         if (writer.empty()) {
             writer.reserve(8);  // Skip a few growth rounds
         }
@@ -570,17 +667,28 @@ void fillWriterVectors(OperationContext* opCtx,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps) {
     SessionUpdateTracker sessionUpdateTracker;
-    fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    WriterAssigner writerAssigner(replAssignOpsToLeastLoadedWriter.load());
+    fillWriterVectors(
+        opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker, &writerAssigner);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        fillWriterVectors(
+            opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr, &writerAssigner);
     }
 }
 
 }  // namespace
 
+void SyncTail::OpQueue::prepare(OperationContext* opCtx, size_t numWriters) {
+    invariant(!_preparedBatch);
+    auto preparedBatch = stdx::make_unique<PreparedBatch>();
+    preparedBatch->writerVectors.resize(numWriters);
+    fillWriterVectors(opCtx, &_batch, &preparedBatch->writerVectors, &preparedBatch->derivedOps);
+    _preparedBatch = std::move(preparedBatch);
+}
+
 namespace {
 void tryToGoLiveAsASecondary(OperationContext* opCtx,
                              ReplicationCoordinator* replCoord,
@@ -705,6 +813,23 @@ private:
             stdx::unique_lock<stdx::mutex> lk(_mutex);
             // Block until the previous batch has been taken.
             _cv.wait(lk, [&] { return _ops.empty(); });
+
+            // Once the previous batch has been taken, the batch before it has been applied, so
+            // the previous batch is the only one that can be in the middle of its application.
+            // Dividing this batch among the writers reads the properties of its collections, which
+            // only a command in the previous batch could change.
+            const bool prepare = replPrepareBatchesAhead.load() && !ops.empty() &&
+                !_previousBatchHadCommands;
+            _previousBatchHadCommands = std::any_of(
+                ops.getBatch().begin(), ops.getBatch().end(), [](const OplogEntry& entry) {
+                    return entry.isCommand();
+                });
+            if (prepare) {
+                lk.unlock();
+                _prepareBatch(&ops);
+                lk.lock();
+            }
+
             _ops = std::move(ops);
             _cv.notify_all();
             if (_ops.mustShutdown()) {
@@ -714,10 +839,22 @@ private:
         }
     }
 
+    void _prepareBatch(OpQueue* ops) {
+        auto opCtx = cc().makeOperationContext();
+
+        // The collection properties are read while the previous batch is applied under the
+        // parallel batch writer mode lock.
+        opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+        ops->prepare(opCtx.get(), _syncTail->_writerPool->getStats().numThreads);
+    }
+
     SyncTail* const _syncTail;
     StorageInterface* const _storageInterface;
     OplogBuffer* const _oplogBuffer;
 
+    // Whether the last batch handed to the applier contained a command. Only used by run().
+    bool _previousBatchHadCommands = false;
+
     stdx::mutex _mutex;  // Guards _ops.
     stdx::condition_variable _cv;
     OpQueue _ops;
@@ -815,8 +952,9 @@ void SyncTail::_oplogApplication(OplogBuffer* oplogBuffer,
 
         // Apply the operations in this batch. 'multiApply' returns the optime of the last op that
         // was applied, which should be the last optime in the batch.
-        auto lastOpTimeAppliedInBatch =
-            fassertNoTrace(34437, multiApply(&opCtx, ops.releaseBatch()));
+        auto preparedBatch = ops.releasePreparedBatch();
+        auto lastOpTimeAppliedInBatch = fassertNoTrace(
+            34437, multiApply(&opCtx, ops.releaseBatch(), std::move(preparedBatch)));
         invariant(lastOpTimeAppliedInBatch == lastOpTimeInBatch);
 
         // In order to provide resilience in the event of a crash in the middle of batch
@@ -1168,7 +1306,7 @@ Status multiSyncApply(OperationContext* opCtx,
 
             // If we didn't create a group, try to apply the op individually.
             try {
-                const Status status = SyncTail::syncApply(opCtx, entry.raw, oplogApplicationMode);
+                const Status status = SyncTail::syncApply(opCtx, entry, oplogApplicationMode);
 
                 if (!status.isOK()) {
                     // In initial sync, update operations can cause documents to be missed during
@@ -1211,7 +1349,9 @@ Status multiSyncApply(OperationContext* opCtx,
     return Status::OK();
 }
 
-StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::Operations ops) {
+StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx,
+                                        MultiApplier::Operations ops,
+                                        std::unique_ptr<PreparedBatch> preparedBatch) {
     invariant(!ops.empty());
 
     LOG(2) << "replication batch size is " << ops.size();
@@ -1251,7 +1391,13 @@ StatusWith<OpTime> SyncTail::multiApply(OperationContext* opCtx, MultiApplier::O
         std::vector<MultiApplier::Operations> derivedOps;
 
         std::vector<MultiApplier::OperationPtrs> writerVectors(_writerPool->getStats().numThreads);
-        fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        if (preparedBatch) {
+            invariant(preparedBatch->writerVectors.size() == writerVectors.size());
+            writerVectors = std::move(preparedBatch->writerVectors);
+            derivedOps = std::move(preparedBatch->derivedOps);
+        } else {
+            fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+        }
 
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
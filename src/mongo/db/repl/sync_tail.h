@@ -79,6 +79,14 @@ public:
                             const BSONObj& o,
                             OplogApplication::Mode oplogApplicationMode);
 
+    /**
+     * Applies 'entry' like syncApply() above, without parsing again the fields 'entry' already
+     * holds.
+     */
+    static Status syncApply(OperationContext* opCtx,
+                            const OplogEntry& entry,
+                            OplogApplication::Mode oplogApplicationMode);
+
     /**
      *
      * Constructs a SyncTail.
@@ -123,6 +131,14 @@ public:
      */
     bool inShutdown() const;
 
+    /**
+     * The operations of a batch divided among the writer threads that apply them, along with the
+     * operations derived from it, which the writer vectors may point into.
+     */
+    struct PreparedBatch {
+        std::vector<MultiApplier::OperationPtrs> writerVectors;
+        std::vector<MultiApplier::Operations> derivedOps;
+    };
 
     class OpQueue {
     public:
@@ -177,6 +193,20 @@ public:
             _mustShutdown = true;
         }
 
+        /**
+         * Divides the operations of this batch among 'numWriters' writer threads ahead of its
+         * application. The writer vectors point into the batch, which must therefore be released
+         * to the multiApply() that uses them.
+         */
+        void prepare(OperationContext* opCtx, size_t numWriters);
+
+        /**
+         * Returns the result of prepare(), or null if the batch was not prepared.
+         */
+        std::unique_ptr<PreparedBatch> releasePreparedBatch() {
+            return std::move(_preparedBatch);
+        }
+
         /**
          * Leaves this object in an unspecified state. Only assignment and destruction are valid.
          */
@@ -188,6 +218,7 @@ public:
         std::vector<OplogEntry> _batch;
         size_t _bytes;
         bool _mustShutdown = false;
+        std::unique_ptr<PreparedBatch> _preparedBatch;
     };
 
     using BatchLimits = OplogApplier::BatchLimits;
@@ -232,8 +263,13 @@ public:
      * To provide crash resilience, this function will advance the persistent value of 'minValid'
      * to at least the last optime of the batch. If 'minValid' is already greater than or equal
      * to the last optime of this batch, it will not be updated.
+     *
+     * If 'preparedBatch' is not null, it holds the result of OpQueue::prepare() for 'ops', and
+     * the operations are applied by the writer threads it assigns them to.
      */
-    StatusWith<OpTime> multiApply(OperationContext* opCtx, MultiApplier::Operations ops);
+    StatusWith<OpTime> multiApply(OperationContext* opCtx,
+                                  MultiApplier::Operations ops,
+                                  std::unique_ptr<PreparedBatch> preparedBatch = nullptr);
 
 private:
     /**
@@ -60,6 +60,7 @@
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/db/session_catalog.h"
@@ -278,6 +279,15 @@ TEST_F(SyncTailTest, SyncApplyInsertDocumentCollectionLookupByUUIDFails) {
         ExceptionFor<ErrorCodes::NamespaceNotFound>);
 }
 
+TEST_F(SyncTailTest, SyncApplyParsedInsertDocumentCollectionLookupByUUIDFails) {
+    const NamespaceString nss("test.t");
+    createDatabase(_opCtx.get(), nss.db());
+    NamespaceString otherNss(nss.getSisterNS("othername"));
+    auto op = makeOplogEntry(OpTypeEnum::kInsert, otherNss, UUID::gen());
+    ASSERT_THROWS(SyncTail::syncApply(_opCtx.get(), op, OplogApplication::Mode::kSecondary).ignore(),
+                  ExceptionFor<ErrorCodes::NamespaceNotFound>);
+}
+
 TEST_F(SyncTailTest, SyncApplyDeleteDocumentCollectionLookupByUUIDFails) {
     const NamespaceString nss("test.t");
     createDatabase(_opCtx.get(), nss.db());
@@ -448,6 +458,107 @@ TEST_F(SyncTailTest,
                                                      createOplogCollectionOptions()));
 }
 
+TEST_F(SyncTailTest, MultiApplyUsesWriterVectorsOfPreparedBatch) {
+    NamespaceString nss1("test.t0");
+    NamespaceString nss2("test.t1");
+    auto writerPool = OplogApplier::makeWriterPool(2);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn =
+        [&mutex, &operationsApplied](OperationContext* opCtx,
+                                     MultiApplier::OperationPtrs* operationsForWriterThreadToApply,
+                                     SyncTail* st,
+                                     WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss1, BSON("x" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss2, BSON("x" << 2));
+
+    SyncTail::OpQueue ops(2U);
+    ops.emplace_back(op1.raw);
+    ops.emplace_back(op2.raw);
+    ops.prepare(_opCtx.get(), writerPool->getStats().numThreads);
+    auto preparedBatch = ops.releasePreparedBatch();
+    ASSERT(preparedBatch);
+    ASSERT_FALSE(ops.releasePreparedBatch());
+    ASSERT_EQUALS(2U, preparedBatch->writerVectors.size());
+
+    // Record the assignment made ahead of time, which multiApply() must not redo.
+    std::vector<std::vector<OpTime>> expected;
+    for (auto&& writerVector : preparedBatch->writerVectors) {
+        if (writerVector.empty()) {
+            continue;
+        }
+        expected.emplace_back();
+        for (auto&& opPtr : writerVector) {
+            expected.back().push_back(opPtr->getOpTime());
+        }
+    }
+
+    SyncTail syncTail(nullptr,
+                      getConsistencyMarkers(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get());
+    auto lastOpTime = unittest::assertGet(
+        syncTail.multiApply(_opCtx.get(), ops.releaseBatch(), std::move(preparedBatch)));
+    ASSERT_EQUALS(op2.getOpTime(), lastOpTime);
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(expected.size(), operationsApplied.size());
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        std::vector<OpTime> opTimes;
+        for (auto&& oplogEntry : operationsAppliedByThread) {
+            opTimes.push_back(oplogEntry.getOpTime());
+        }
+        ASSERT_TRUE(std::find(expected.cbegin(), expected.cend(), opTimes) != expected.cend());
+    }
+}
+
+TEST_F(SyncTailTest, PrepareAssignsNonConflictingOperationsToLeastLoadedWriter) {
+    auto parameter =
+        ServerParameterSet::getGlobal()->getMap().find("replAssignOpsToLeastLoadedWriter");
+    ASSERT(parameter != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(parameter->second->setFromString("true"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(parameter->second->setFromString("false")); });
+
+    // The storage engine of this fixture does not support document locking, so all operations on
+    // a collection conflict and operations on different collections do not.
+    std::vector<OplogEntry> entries;
+    for (int i = 0; i < 4; ++i) {
+        NamespaceString nss("test.t" + std::to_string(i));
+        entries.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(i + 1), 0), 1LL}, nss, BSON("_id" << i)));
+    }
+    entries.push_back(makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(5), 0), 1LL}, NamespaceString("test.t0"), BSON("_id" << 4)));
+
+    SyncTail::OpQueue ops(entries.size());
+    for (auto&& entry : entries) {
+        ops.emplace_back(entry.raw);
+    }
+    ops.prepare(_opCtx.get(), 2U);
+    auto preparedBatch = ops.releasePreparedBatch();
+    ASSERT(preparedBatch);
+
+    const auto& writerVectors = preparedBatch->writerVectors;
+    ASSERT_EQUALS(2U, writerVectors.size());
+    ASSERT_EQUALS(3U, writerVectors[0].size());
+    ASSERT_EQUALS(2U, writerVectors[1].size());
+    ASSERT_EQUALS(entries[0], *writerVectors[0][0]);
+    ASSERT_EQUALS(entries[2], *writerVectors[0][1]);
+    ASSERT_EQUALS(entries[4], *writerVectors[0][2]);
+    ASSERT_EQUALS(entries[1], *writerVectors[1][0]);
+    ASSERT_EQUALS(entries[3], *writerVectors[1][1]);
+}
+
 TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceHash) {
     // This test relies on implementation details of how multiApply uses hashing to distribute ops
     // to threads. It is possible for this test to fail, even if the implementation of multiApply is
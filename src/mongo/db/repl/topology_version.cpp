@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/topology_version.h"
+
+#include "mongo/bson/util/bson_check.h"
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+constexpr StringData kProcessIdFieldName = "processId"_sd;
+constexpr StringData kCounterFieldName = "counter"_sd;
+
+constexpr StringData kLegalFieldNames[] = {kProcessIdFieldName, kCounterFieldName};
+
+}  // namespace
+
+TopologyVersion::TopologyVersion(OID processId, long long counter)
+    : _processId(std::move(processId)), _counter(counter) {}
+
+StatusWith<TopologyVersion> TopologyVersion::parse(const BSONObj& doc) {
+    Status status = bsonCheckOnlyHasFields("TopologyVersion", doc, kLegalFieldNames);
+    if (!status.isOK())
+        return status;
+
+    OID processId;
+    status = bsonExtractOIDField(doc, kProcessIdFieldName, &processId);
+    if (!status.isOK())
+        return status;
+
+    long long counter;
+    status = bsonExtractIntegerField(doc, kCounterFieldName, &counter);
+    if (!status.isOK())
+        return status;
+
+    if (counter < 0) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "TopologyVersion counter must not be negative, but was "
+                              << counter};
+    }
+
+    return TopologyVersion{processId, counter};
+}
+
+BSONObj TopologyVersion::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append(kProcessIdFieldName, _processId);
+    builder.append(kCounterFieldName, _counter);
+    return builder.obj();
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+
+class BSONObj;
+
+namespace repl {
+
+/**
+ * Identifies a version of the replica set topology as seen by one node, that is of everything
+ * the node reports in its isMaster responses that a client uses for server selection. The counter
+ * is incremented whenever that changes, and the process id distinguishes the counters of
+ * different runs of the node, since the counter starts over on restart.
+ */
+class TopologyVersion {
+public:
+    TopologyVersion(OID processId, long long counter);
+
+    static StatusWith<TopologyVersion> parse(const BSONObj& doc);
+
+    const OID& getProcessId() const {
+        return _processId;
+    }
+
+    long long getCounter() const {
+        return _counter;
+    }
+
+    BSONObj toBSON() const;
+
+    bool operator==(const TopologyVersion& other) const {
+        return _processId == other._processId && _counter == other._counter;
+    }
+
+    bool operator!=(const TopologyVersion& other) const {
+        return !(*this == other);
+    }
+
+private:
+    OID _processId;
+    long long _counter;
+};
+
+}  // namespace repl
+}  // namespace mongo
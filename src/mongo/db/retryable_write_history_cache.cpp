@@ -0,0 +1,212 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/retryable_write_history_cache.h"
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(retryableWriteHistoryCacheMaxStatements, int, 0)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "retryableWriteHistoryCacheMaxStatements must be greater than or equal "
+                          "to 0");
+        }
+
+        return Status::OK();
+    });
+
+namespace {
+
+const auto retryableWriteHistoryCacheDecoration =
+    ServiceContext::declareDecoration<RetryableWriteHistoryCache>();
+
+}  // namespace
+
+RetryableWriteHistoryCache& RetryableWriteHistoryCache::get(ServiceContext* service) {
+    return retryableWriteHistoryCacheDecoration(service);
+}
+
+boost::optional<RetryableWriteHistoryCache::History> RetryableWriteHistoryCache::find(
+    const LogicalSessionId& lsid, TxnNumber txnNumber, const repl::OpTime& lastWriteOpTime) {
+    if (!retryableWriteHistoryCacheMaxStatements.load()) {
+        return boost::none;
+    }
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    auto indexIt = _index.find(lsid);
+    if (indexIt == _index.end()) {
+        return boost::none;
+    }
+
+    auto it = indexIt->second;
+    if (it->txnNumber != txnNumber || it->lastWriteOpTime != lastWriteOpTime) {
+        return boost::none;
+    }
+
+    History history;
+    history.hasIncompleteHistory = it->hasIncompleteHistory;
+    history.committedStatements.reserve(it->statements.size());
+    for (const auto& stmt : it->statements) {
+        if (!history.committedStatements.emplace(stmt.first, stmt.second).second) {
+            // A repeated statement is reported by the oplog walk, so let the caller do it.
+            _erase_inlock(it);
+            return boost::none;
+        }
+    }
+
+    _entries.splice(_entries.begin(), _entries, it);
+    return history;
+}
+
+void RetryableWriteHistoryCache::put(const LogicalSessionId& lsid,
+                                     TxnNumber txnNumber,
+                                     const repl::OpTime& lastWriteOpTime,
+                                     const History& history) {
+    const size_t capacity = retryableWriteHistoryCacheMaxStatements.load();
+    if (!capacity || history.committedStatements.size() > capacity) {
+        invalidate(lsid);
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    auto indexIt = _index.find(lsid);
+    if (indexIt != _index.end()) {
+        auto existing = indexIt->second;
+        if (existing->txnNumber > txnNumber ||
+            (existing->txnNumber == txnNumber && existing->lastWriteOpTime >= lastWriteOpTime)) {
+            return;
+        }
+        _erase_inlock(existing);
+    }
+
+    Entry entry{lsid, txnNumber, lastWriteOpTime, {}, history.hasIncompleteHistory};
+    entry.statements.assign(history.committedStatements.begin(),
+                            history.committedStatements.end());
+
+    _numStatements += entry.statements.size();
+    _entries.push_front(std::move(entry));
+    _index.emplace(lsid, _entries.begin());
+
+    _touchAndEvict_inlock(_entries.begin(), capacity);
+}
+
+void RetryableWriteHistoryCache::onStatementsWritten(const LogicalSessionId& lsid,
+                                                     TxnNumber txnNumber,
+                                                     const std::vector<StmtId>& stmtIds,
+                                                     const repl::OpTime& opTime,
+                                                     const repl::OpTime& prevOpTime) {
+    const size_t capacity = retryableWriteHistoryCacheMaxStatements.load();
+
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    auto indexIt = _index.find(lsid);
+    EntryList::iterator it;
+    if (prevOpTime.isNull()) {
+        if (indexIt != _index.end()) {
+            if (indexIt->second->txnNumber > txnNumber) {
+                return;
+            }
+            _erase_inlock(indexIt->second);
+        }
+
+        if (!capacity) {
+            return;
+        }
+
+        _entries.push_front(Entry{lsid, txnNumber, {}, {}, false});
+        it = _index.emplace(lsid, _entries.begin()).first->second;
+    } else {
+        if (indexIt == _index.end()) {
+            return;
+        }
+
+        it = indexIt->second;
+        if (it->txnNumber != txnNumber || it->lastWriteOpTime != prevOpTime) {
+            _erase_inlock(it);
+            return;
+        }
+    }
+
+    it->lastWriteOpTime = opTime;
+    for (const auto stmtId : stmtIds) {
+        if (stmtId == kIncompleteHistoryStmtId) {
+            it->hasIncompleteHistory = true;
+            continue;
+        }
+
+        it->statements.emplace_back(stmtId, opTime);
+        ++_numStatements;
+    }
+
+    if (it->statements.size() > capacity) {
+        _erase_inlock(it);
+        return;
+    }
+
+    _touchAndEvict_inlock(it, capacity);
+}
+
+void RetryableWriteHistoryCache::invalidate(const LogicalSessionId& lsid) {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    auto indexIt = _index.find(lsid);
+    if (indexIt != _index.end()) {
+        _erase_inlock(indexIt->second);
+    }
+}
+
+size_t RetryableWriteHistoryCache::numStatements() const {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    return _numStatements;
+}
+
+void RetryableWriteHistoryCache::_erase_inlock(EntryList::iterator it) {
+    _numStatements -= it->statements.size();
+    _index.erase(it->lsid);
+    _entries.erase(it);
+}
+
+void RetryableWriteHistoryCache::_touchAndEvict_inlock(EntryList::iterator it, size_t capacity) {
+    _entries.splice(_entries.begin(), _entries, it);
+
+    while (_numStatements > capacity) {
+        // The entry at the front always fits on its own, so eviction stops before reaching it.
+        _erase_inlock(std::prev(_entries.end()));
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Maximum number of statements, summed over all sessions, that the retryable write history cache
+ * may hold. Zero disables the cache.
+ */
+extern AtomicInt32 retryableWriteHistoryCacheMaxStatements;
+
+/**
+ * Process-wide, bounded cache of the statements executed by the latest retryable write of each
+ * session, so that a Session which was invalidated or evicted from the SessionCatalog can be
+ * reloaded without walking its oplog chain.
+ *
+ * Every entry is tagged with the opTime of the last write it contains. It is only served when
+ * that opTime matches the lastWriteOpTime of the session's config.transactions record, so writes
+ * the cache has not seen, rollbacks and history truncation all show up as misses. Entries are
+ * extended by following the prevOpTime chain of the writes, both on primaries when a write
+ * commits and on secondaries as the oplog is applied; a write that does not continue the cached
+ * chain drops the entry. Sessions are evicted in least-recently-used order.
+ */
+class RetryableWriteHistoryCache {
+    MONGO_DISALLOW_COPYING(RetryableWriteHistoryCache);
+
+public:
+    using CommittedStatementTimestampMap = stdx::unordered_map<StmtId, repl::OpTime>;
+
+    struct History {
+        CommittedStatementTimestampMap committedStatements;
+        bool hasIncompleteHistory{false};
+    };
+
+    RetryableWriteHistoryCache() = default;
+
+    static RetryableWriteHistoryCache& get(ServiceContext* service);
+
+    /**
+     * Returns the cached history of 'lsid' if it describes 'txnNumber' up to and including the
+     * write at 'lastWriteOpTime'.
+     */
+    boost::optional<History> find(const LogicalSessionId& lsid,
+                                  TxnNumber txnNumber,
+                                  const repl::OpTime& lastWriteOpTime);
+
+    /**
+     * Records the complete history of 'txnNumber' up to 'lastWriteOpTime', as read from the oplog.
+     * Does not replace an entry that already describes a later write of the session.
+     */
+    void put(const LogicalSessionId& lsid,
+             TxnNumber txnNumber,
+             const repl::OpTime& lastWriteOpTime,
+             const History& history);
+
+    /**
+     * Records that the statements 'stmtIds' of 'txnNumber' were written at 'opTime' by a write
+     * whose prevOpTime is 'prevOpTime'. A null 'prevOpTime' starts a new chain.
+     */
+    void onStatementsWritten(const LogicalSessionId& lsid,
+                             TxnNumber txnNumber,
+                             const std::vector<StmtId>& stmtIds,
+                             const repl::OpTime& opTime,
+                             const repl::OpTime& prevOpTime);
+
+    /**
+     * Drops the entry of 'lsid', if any.
+     */
+    void invalidate(const LogicalSessionId& lsid);
+
+    /**
+     * Total number of statements currently held.
+     */
+    size_t numStatements() const;
+
+private:
+    struct Entry {
+        LogicalSessionId lsid;
+        TxnNumber txnNumber;
+        repl::OpTime lastWriteOpTime;
+        // Kept as a flat list rather than a hash map, since it is only scanned when served.
+        std::vector<std::pair<StmtId, repl::OpTime>> statements;
+        bool hasIncompleteHistory{false};
+    };
+
+    using EntryList = std::list<Entry>;
+
+    void _erase_inlock(EntryList::iterator it);
+
+    /**
+     * Moves 'it' to the front of the LRU list and evicts entries from the back until the cache
+     * fits in 'capacity'.
+     */
+    void _touchAndEvict_inlock(EntryList::iterator it, size_t capacity);
+
+    mutable stdx::mutex _mutex;
+
+    // Most recently used first.
+    EntryList _entries;
+    LogicalSessionIdMap<EntryList::iterator> _index;
+    size_t _numStatements{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/retryable_write_history_cache.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class RetryableWriteHistoryCacheTest : public unittest::Test {
+protected:
+    void setUp() final {
+        _savedMaxStatements = retryableWriteHistoryCacheMaxStatements.load();
+        retryableWriteHistoryCacheMaxStatements.store(4);
+    }
+
+    void tearDown() final {
+        retryableWriteHistoryCacheMaxStatements.store(_savedMaxStatements);
+    }
+
+    RetryableWriteHistoryCache cache;
+
+private:
+    int _savedMaxStatements;
+};
+
+const repl::OpTime kOpTime1(Timestamp(1, 1), 1);
+const repl::OpTime kOpTime2(Timestamp(2, 1), 1);
+const repl::OpTime kOpTime3(Timestamp(3, 1), 1);
+
+TEST_F(RetryableWriteHistoryCacheTest, ChainedWritesAreServedAtTheLastWriteOpTime) {
+    const auto lsid = makeLogicalSessionIdForTest();
+
+    cache.onStatementsWritten(lsid, 5, {0}, kOpTime1, repl::OpTime());
+    cache.onStatementsWritten(lsid, 5, {1, kIncompleteHistoryStmtId}, kOpTime2, kOpTime1);
+
+    ASSERT_FALSE(cache.find(lsid, 5, kOpTime1));
+    ASSERT_FALSE(cache.find(lsid, 4, kOpTime2));
+
+    auto history = cache.find(lsid, 5, kOpTime2);
+    ASSERT(history);
+    ASSERT_EQ(2U, history->committedStatements.size());
+    ASSERT_EQ(kOpTime1, history->committedStatements.at(0));
+    ASSERT_EQ(kOpTime2, history->committedStatements.at(1));
+    ASSERT(history->hasIncompleteHistory);
+}
+
+TEST_F(RetryableWriteHistoryCacheTest, WriteThatDoesNotContinueTheChainDropsTheEntry) {
+    const auto lsid = makeLogicalSessionIdForTest();
+
+    cache.onStatementsWritten(lsid, 5, {0}, kOpTime1, repl::OpTime());
+    cache.onStatementsWritten(lsid, 5, {2}, kOpTime3, kOpTime2);
+
+    ASSERT_FALSE(cache.find(lsid, 5, kOpTime1));
+    ASSERT_FALSE(cache.find(lsid, 5, kOpTime3));
+    ASSERT_EQ(0U, cache.numStatements());
+}
+
+TEST_F(RetryableWriteHistoryCacheTest, PutDoesNotReplaceALaterWrite) {
+    const auto lsid = makeLogicalSessionIdForTest();
+
+    cache.onStatementsWritten(lsid, 5, {0}, kOpTime1, repl::OpTime());
+    cache.onStatementsWritten(lsid, 5, {1}, kOpTime2, kOpTime1);
+    cache.put(lsid, 5, kOpTime1, {{{0, kOpTime1}}, false});
+
+    ASSERT(cache.find(lsid, 5, kOpTime2));
+    ASSERT_FALSE(cache.find(lsid, 5, kOpTime1));
+
+    cache.put(lsid, 6, kOpTime3, {{{0, kOpTime3}}, false});
+    auto history = cache.find(lsid, 6, kOpTime3);
+    ASSERT(history);
+    ASSERT_EQ(1U, history->committedStatements.size());
+    ASSERT_EQ(1U, cache.numStatements());
+}
+
+TEST_F(RetryableWriteHistoryCacheTest, EvictsLeastRecentlyUsedSessionsBeyondCapacity) {
+    const auto lsid1 = makeLogicalSessionIdForTest();
+    const auto lsid2 = makeLogicalSessionIdForTest();
+    const auto lsid3 = makeLogicalSessionIdForTest();
+
+    cache.onStatementsWritten(lsid1, 1, {0, 1}, kOpTime1, repl::OpTime());
+    cache.onStatementsWritten(lsid2, 1, {0, 1}, kOpTime1, repl::OpTime());
+    ASSERT(cache.find(lsid1, 1, kOpTime1));
+
+    cache.onStatementsWritten(lsid3, 1, {0}, kOpTime1, repl::OpTime());
+    ASSERT_EQ(3U, cache.numStatements());
+    ASSERT(cache.find(lsid1, 1, kOpTime1));
+    ASSERT_FALSE(cache.find(lsid2, 1, kOpTime1));
+    ASSERT(cache.find(lsid3, 1, kOpTime1));
+
+    // A session whose history alone exceeds the capacity is not cached at all.
+    cache.onStatementsWritten(lsid3, 1, {1, 2, 3, 4}, kOpTime2, kOpTime1);
+    ASSERT_FALSE(cache.find(lsid3, 1, kOpTime2));
+    ASSERT_EQ(2U, cache.numStatements());
+}
+
+TEST_F(RetryableWriteHistoryCacheTest, DisabledCacheServesNothing) {
+    const auto lsid = makeLogicalSessionIdForTest();
+
+    retryableWriteHistoryCacheMaxStatements.store(0);
+    cache.onStatementsWritten(lsid, 5, {0}, kOpTime1, repl::OpTime());
+    cache.put(lsid, 5, kOpTime1, {{{0, kOpTime1}}, false});
+
+    ASSERT_FALSE(cache.find(lsid, 5, kOpTime1));
+    ASSERT_EQ(0U, cache.numStatements());
+}
+
+}  // namespace
+}  // namespace mongo
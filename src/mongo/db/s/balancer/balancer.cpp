@@ -43,6 +43,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/s/balancer/balancer_chunk_selection_policy_impl.h"
 #include "mongo/db/s/balancer/cluster_statistics_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog_cache.h"
@@ -72,6 +73,18 @@ const Seconds kBalanceRoundDefaultInterval(10);
 // not being able to establish a stable shard version.
 const Seconds kShortBalanceRoundInterval(1);
 
+// The most migrations a balancer round starts, which bounds the extra load balancing puts on the
+// cluster at any time. Each shard takes part in at most one migration at a time regardless, so 0,
+// the default, lets a round start one migration for every pair of shards which need one.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxMigrationsPerRound, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "balancerMaxMigrationsPerRound must not be negative");
+        }
+        return Status::OK();
+    });
+
 const auto getBalancer = ServiceContext::declareDecoration<std::unique_ptr<Balancer>>();
 
 /**
@@ -297,6 +310,15 @@ void Balancer::report(OperationContext* opCtx, BSONObjBuilder* builder) {
     builder->append("mode", BalancerSettingsType::kBalancerModes[mode]);
     builder->append("inBalancerRound", _inBalancerRound);
     builder->append("numBalancerRounds", _numBalancerRounds);
+
+    BSONObjBuilder migrations(builder->subobjStart("migrations"));
+    migrations.append("numChunksMoved", _numChunksMoved);
+    migrations.append("numFailed", _numMigrationsFailed);
+    migrations.append("lastRound",
+                      BSON("numCandidates" << _lastRoundNumCandidates << "numChunksMoved"
+                                           << _lastRoundNumChunksMoved
+                                           << "durationMillis"
+                                           << durationCount<Milliseconds>(_lastRoundDuration)));
 }
 
 void Balancer::_mainThread() {
@@ -376,9 +398,17 @@ void Balancer::_mainThread() {
                     LOG(1) << "Done enforcing tag range boundaries.";
                 }
 
-                const auto candidateChunks = uassertStatusOK(
+                auto candidateChunks = uassertStatusOK(
                     _chunkSelectionPolicy->selectChunksToMove(opCtx.get(), _balancedLastTime));
 
+                const int maxMigrations = balancerMaxMigrationsPerRound.load();
+                if (maxMigrations > 0 && candidateChunks.size() > size_t(maxMigrations)) {
+                    LOG(1) << "Limiting the round to " << maxMigrations << " of "
+                           << candidateChunks.size() << " candidate migrations";
+                    candidateChunks.erase(candidateChunks.begin() + maxMigrations,
+                                          candidateChunks.end());
+                }
+
                 if (candidateChunks.empty()) {
                     LOG(1) << "no need to move any chunk";
                     _balancedLastTime = false;
@@ -573,6 +603,7 @@ int Balancer::_moveChunks(OperationContext* opCtx,
         return 0;
     }
 
+    Timer migrationsTimer;
     auto migrationStatuses =
         _migrationManager.executeMigrationsForAutoBalance(opCtx,
                                                           candidateChunks,
@@ -581,11 +612,13 @@ int Balancer::_moveChunks(OperationContext* opCtx,
                                                           balancerConfig->waitForDelete());
 
     int numChunksProcessed = 0;
+    int numChunksMoved = 0;
 
     for (const auto& migrationStatusEntry : migrationStatuses) {
         const Status& status = migrationStatusEntry.second;
         if (status.isOK()) {
             numChunksProcessed++;
+            numChunksMoved++;
             continue;
         }
 
@@ -612,6 +645,15 @@ int Balancer::_moveChunks(OperationContext* opCtx,
               << causedBy(redact(status));
     }
 
+    {
+        stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+        _numChunksMoved += numChunksMoved;
+        _numMigrationsFailed += migrationStatuses.size() - numChunksMoved;
+        _lastRoundNumCandidates = candidateChunks.size();
+        _lastRoundNumChunksMoved = numChunksMoved;
+        _lastRoundDuration = Milliseconds(migrationsTimer.millis());
+    }
+
     return numChunksProcessed;
 }
 
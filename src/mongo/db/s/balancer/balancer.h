@@ -231,6 +231,15 @@ private:
     // Counts the number of balancing rounds performed since the balancer thread was first activated
     int64_t _numBalancerRounds{0};
 
+    // Counts the chunks moved and the migrations which failed, over all balancer rounds
+    int64_t _numChunksMoved{0};
+    int64_t _numMigrationsFailed{0};
+
+    // The migrations attempted by the last balancer round which had any, and how they went
+    int _lastRoundNumCandidates{0};
+    int _lastRoundNumChunksMoved{0};
+    Milliseconds _lastRoundDuration{0};
+
     // Condition variable, which is signalled every time the above runtime state of the balancer
     // changes (in particular, state/balancer round and number of balancer rounds).
     stdx::condition_variable _condVar;
@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -52,6 +53,19 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+// When set, once the chunks of a zone are balanced by count, a chunk is moved from the shard with
+// the highest rate of writes to the one with the lowest if the former exceeds the latter by this
+// ratio. The ratio is what damps these migrations, since the rates have to diverge by that much
+// again before another chunk moves. Zero disables balancing by write load.
+MONGO_EXPORT_SERVER_PARAMETER(balancerWriteLoadImbalanceRatio, double, 0)
+    ->withValidator([](const double& newVal) {
+        if (newVal != 0 && newVal <= 1) {
+            return Status(ErrorCodes::BadValue,
+                          "balancerWriteLoadImbalanceRatio must be either 0 or greater than 1");
+        }
+        return Status::OK();
+    });
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -424,14 +438,26 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             (totalNumberOfChunksWithTag / totalNumberOfShardsWithTag) +
             (totalNumberOfChunksWithTag % totalNumberOfShardsWithTag ? 1 : 0);
 
+        bool balancedByCount = true;
         while (_singleZoneBalance(shardStats,
                                   distribution,
                                   tag,
                                   idealNumberOfChunksPerShardForTag,
                                   imbalanceThreshold,
                                   &migrations,
-                                  usedShards))
-            ;
+                                  usedShards)) {
+            balancedByCount = false;
+        }
+
+        if (balancedByCount) {
+            _singleZoneLoadBalance(shardStats,
+                                   distribution,
+                                   tag,
+                                   idealNumberOfChunksPerShardForTag,
+                                   imbalanceThreshold,
+                                   &migrations,
+                                   usedShards);
+        }
     }
 
     return migrations;
@@ -524,6 +550,62 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+void BalancerPolicy::_singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            const string& tag,
+                                            size_t idealNumberOfChunksPerShardForTag,
+                                            size_t imbalanceThreshold,
+                                            vector<MigrateInfo>* migrations,
+                                            set<ShardId>* usedShards) {
+    const double imbalanceRatio = balancerWriteLoadImbalanceRatio.load();
+    if (imbalanceRatio == 0)
+        return;
+
+    const ClusterStatistics::ShardStatistics* hottest = nullptr;
+    const ClusterStatistics::ShardStatistics* coolest = nullptr;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (!tag.empty() && !stat.shardTags.count(tag))
+            continue;
+
+        if (!hottest || stat.writeOpsPerSec > hottest->writeOpsPerSec)
+            hottest = &stat;
+
+        if (isShardSuitableReceiver(stat, tag).isOK() &&
+            (!coolest || stat.writeOpsPerSec < coolest->writeOpsPerSec))
+            coolest = &stat;
+    }
+
+    if (!hottest || !coolest || hottest == coolest)
+        return;
+
+    // Very low rates are treated as one write per second, so that they never cause migrations
+    if (hottest->writeOpsPerSec < imbalanceRatio * std::max(coolest->writeOpsPerSec, 1.0))
+        return;
+
+    const size_t receiverChunks = distribution.numberOfChunksInShardWithTag(coolest->shardId, tag);
+    if (receiverChunks + 1 >= idealNumberOfChunksPerShardForTag + imbalanceThreshold)
+        return;
+
+    for (const auto& chunk : distribution.getChunks(hottest->shardId)) {
+        if (distribution.getTagForChunk(chunk) != tag || chunk.getJumbo())
+            continue;
+
+        LOG(1) << "Moving chunk " << redact(chunk.toString()) << " of collection "
+               << distribution.nss().ns() << " from " << hottest->shardId << " with "
+               << hottest->writeOpsPerSec << " writes per second to " << coolest->shardId
+               << " with " << coolest->writeOpsPerSec << " writes per second";
+
+        migrations->emplace_back(coolest->shardId, chunk);
+        invariant(usedShards->insert(hottest->shardId).second);
+        invariant(usedShards->insert(coolest->shardId).second);
+        return;
+    }
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -239,6 +239,20 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * If balancing by write load is enabled and the shard in the specified zone with the highest
+     * rate of writes exceeds the lowest by the configured ratio, selects one chunk to be moved
+     * from the former to the latter. The chunk is only moved if the chunk counts stay within the
+     * imbalance threshold, so that chunk count balancing does not move it back.
+     */
+    static void _singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                       const DistributionStatus& distribution,
+                                       const std::string& tag,
+                                       size_t idealNumberOfChunksPerShardForTag,
+                                       size_t imbalanceThreshold,
+                                       std::vector<MigrateInfo>* migrations,
+                                       std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
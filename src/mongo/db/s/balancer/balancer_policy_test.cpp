@@ -32,10 +32,12 @@
 
 #include "mongo/db/keypattern.h"
 #include "mongo/db/s/balancer/balancer_policy.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -118,6 +120,55 @@ std::vector<MigrateInfo> balanceChunks(const ShardStatisticsVector& shardStats,
         shardStats, distribution, shouldAggressivelyBalance, &usedShards);
 }
 
+TEST(BalancerPolicy, BalancedByCountMovesChunkFromHottestToCoolestShard) {
+    auto parameter =
+        ServerParameterSet::getGlobal()->getMap().find("balancerWriteLoadImbalanceRatio");
+    ASSERT(parameter != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(parameter->second->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(parameter->second->setFromString("0")); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 25, false, emptyTagSet, emptyShardVersion), 25},
+         {ShardStatistics(kShardId1, kNoMaxSize, 25, false, emptyTagSet, emptyShardVersion), 25},
+         {ShardStatistics(kShardId2, kNoMaxSize, 25, false, emptyTagSet, emptyShardVersion), 25}});
+    cluster.first[0].writeOpsPerSec = 50;
+    cluster.first[1].writeOpsPerSec = 500;
+    cluster.first[2].writeOpsPerSec = 100;
+
+    auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId1, migrations[0].from);
+    ASSERT_EQ(kShardId0, migrations[0].to);
+
+    // Rates which do not differ by the ratio do not cause migrations
+    cluster.first[1].writeOpsPerSec = 90;
+    cluster.first[2].writeOpsPerSec = 60;
+    migrations =
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false);
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, WriteLoadDoesNotUnbalanceChunkCounts) {
+    auto parameter =
+        ServerParameterSet::getGlobal()->getMap().find("balancerWriteLoadImbalanceRatio");
+    ASSERT(parameter != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(parameter->second->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(parameter->second->setFromString("0")); });
+
+    // The coolest shard already has one chunk above the ideal, so receiving another would make
+    // chunk count balancing move it back
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 26, false, emptyTagSet, emptyShardVersion), 26},
+         {ShardStatistics(kShardId1, kNoMaxSize, 24, false, emptyTagSet, emptyShardVersion), 24}});
+    cluster.first[0].writeOpsPerSec = 10;
+    cluster.first[1].writeOpsPerSec = 1000;
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
 TEST(BalancerPolicy, Basic) {
     auto cluster = generateCluster(
         {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
@@ -92,6 +92,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Rate of inserts, updates and deletes on this shard's primary since the previous time
+        // the statistics were gathered. Zero if it is not known.
+        double writeOpsPerSec{0};
     };
 
     virtual ~ClusterStatistics();
@@ -48,16 +48,15 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard and returns its response.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -78,15 +77,20 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+/**
+ * Returns the total number of inserts, updates and deletes reported in a serverStatus response.
+ */
+long long getWriteOpCount(const BSONObj& serverStatus) {
+    const auto opCounters = serverStatus[kOpCountersField];
+    if (opCounters.type() != Object) {
+        return 0;
     }
 
-    return version;
+    return opCounters["insert"].safeNumberLong() + opCounters["update"].safeNumberLong() +
+        opCounters["delete"].safeNumberLong();
 }
 
 }  // namespace
@@ -133,15 +137,24 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        double writeOpsPerSec = 0;
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
-        } else {
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        auto mongoDVersionStatus = serverStatus.isOK()
+            ? bsonExtractStringField(serverStatus.getValue(), kVersionField, &mongoDVersion)
+            : serverStatus.getStatus();
+        if (!mongoDVersionStatus.isOK()) {
             // Since the mongod version is only used for reporting, there is no need to fail the
             // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(mongoDVersionStatus);
+        }
+
+        // The write load only matters once the chunks are balanced, so an unknown load is treated
+        // as none
+        if (serverStatus.isOK()) {
+            writeOpsPerSec =
+                _updateWriteOpsPerSec(shard.getName(), getWriteOpCount(serverStatus.getValue()));
         }
 
         std::set<std::string> shardTags;
@@ -156,9 +169,32 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().writeOpsPerSec = writeOpsPerSec;
     }
 
     return stats;
 }
 
+double ClusterStatisticsImpl::_updateWriteOpsPerSec(const ShardId& shardId, long long writeOps) {
+    const auto now = Date_t::now();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _lastWriteOpsSamples.find(shardId);
+    if (it == _lastWriteOpsSamples.end()) {
+        _lastWriteOpsSamples.emplace(shardId, WriteOpsSample{writeOps, now});
+        return 0;
+    }
+
+    auto& lastSample = it->second;
+    const auto elapsedMillis = durationCount<Milliseconds>(now - lastSample.time);
+
+    // A decreasing count means the primary of the shard has restarted or changed
+    const double writeOpsPerSec = (writeOps >= lastSample.writeOps && elapsedMillis > 0)
+        ? double(writeOps - lastSample.writeOps) * 1000 / elapsedMillis
+        : 0;
+
+    lastSample = {writeOps, now};
+    return writeOpsPerSec;
+}
+
 }  // namespace mongo
@@ -28,8 +28,12 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -46,8 +50,25 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    /**
+     * Returns the rate of write operations on the specified shard since the previous call for
+     * it, given its current cumulative count of write operations.
+     */
+    double _updateWriteOpsPerSec(const ShardId& shardId, long long writeOps);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    struct WriteOpsSample {
+        long long writeOps;
+        Date_t time;
+    };
+
+    // Protects _lastWriteOpsSamples
+    stdx::mutex _mutex;
+
+    // The cumulative count of write operations of each shard when the statistics were last gathered
+    std::map<ShardId, WriteOpsSample> _lastWriteOpsSamples;
 };
 
 }  // namespace mongo
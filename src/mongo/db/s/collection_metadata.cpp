@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/collection_metadata.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/bson/dotted_path_support.h"
@@ -43,7 +45,45 @@
 namespace mongo {
 
 CollectionMetadata::CollectionMetadata(std::shared_ptr<ChunkManager> cm, const ShardId& thisShardId)
-    : _cm(std::move(cm)), _thisShardId(thisShardId) {}
+    : _cm(std::move(cm)), _thisShardId(thisShardId) {
+    if (!_cm || _cm->isAtClusterTime()) {
+        return;
+    }
+
+    auto ownedRanges = std::make_shared<std::vector<OwnedRange>>();
+    for (const auto& chunk : _cm->chunks()) {
+        if (chunk.getShardId() != _thisShardId)
+            continue;
+
+        auto min = _cm->extractKeyString(chunk.getMin());
+        if (!ownedRanges->empty() && ownedRanges->back().max == min) {
+            ownedRanges->back().max = _cm->extractKeyString(chunk.getMax());
+        } else {
+            ownedRanges->push_back({std::move(min), _cm->extractKeyString(chunk.getMax())});
+        }
+    }
+    _ownedRanges = std::move(ownedRanges);
+}
+
+bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
+    invariant(isSharded());
+    if (!_ownedRanges) {
+        return _cm->keyBelongsToShard(key, _thisShardId);
+    }
+    if (key.isEmpty()) {
+        return false;
+    }
+
+    // The first owned range which ends after the key is the only one which can contain it.
+    const auto keyString = _cm->extractKeyString(key);
+    const auto it = std::upper_bound(_ownedRanges->begin(),
+                                     _ownedRanges->end(),
+                                     keyString,
+                                     [](const std::string& keyString, const OwnedRange& range) {
+                                         return keyString < range.max;
+                                     });
+    return it != _ownedRanges->end() && it->min <= keyString;
+}
 
 RangeMap CollectionMetadata::getChunks() const {
     invariant(isSharded());
@@ -124,10 +124,7 @@ public:
      * Returns true if the document with the given key belongs to this chunkset. If the key is empty
      * returns false. If key is not a valid shard key, the behaviour is undefined.
      */
-    bool keyBelongsToMe(const BSONObj& key) const {
-        invariant(isSharded());
-        return _cm->keyBelongsToShard(key, _thisShardId);
-    }
+    bool keyBelongsToMe(const BSONObj& key) const;
 
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
@@ -207,11 +204,22 @@ public:
     }
 
 private:
+    // A range of shard key values owned by this shard, as KeyStrings, with 'max' exclusive.
+    struct OwnedRange {
+        std::string min;
+        std::string max;
+    };
+
     // The full routing table for the collection.
     std::shared_ptr<ChunkManager> _cm;
 
     // The identity of this shard, for the purpose of answering "key belongs to me" queries.
     ShardId _thisShardId;
+
+    // The ranges owned by this shard in ascending order, with adjacent chunks merged, so that
+    // ownership checks search only these rather than the whole routing table. Not built for
+    // metadata at a past cluster time, which is created per operation.
+    std::shared_ptr<const std::vector<OwnedRange>> _ownedRanges;
 };
 
 }  // namespace mongo
@@ -44,7 +44,8 @@ using unittest::assertGet;
 std::unique_ptr<CollectionMetadata> makeCollectionMetadataImpl(
     const KeyPattern& shardKeyPattern,
     const std::vector<std::pair<BSONObj, BSONObj>>& thisShardsChunks,
-    bool staleChunkManager) {
+    bool staleChunkManager,
+    bool atClusterTime = true) {
 
     const OID epoch = OID::gen();
     const NamespaceString kNss("test.foo");
@@ -80,7 +81,8 @@ std::unique_ptr<CollectionMetadata> makeCollectionMetadataImpl(
     UUID uuid(UUID::gen());
     auto rt =
         RoutingTableHistory::makeNew(kNss, uuid, shardKeyPattern, nullptr, false, epoch, allChunks);
-    std::shared_ptr<ChunkManager> cm = std::make_shared<ChunkManager>(rt, kChunkManager);
+    std::shared_ptr<ChunkManager> cm = std::make_shared<ChunkManager>(
+        rt, atClusterTime ? boost::make_optional(kChunkManager) : boost::none);
     return stdx::make_unique<CollectionMetadata>(cm, kThisShard);
 }
 
@@ -380,6 +382,27 @@ protected:
     }
 };
 
+TEST(CollectionMetadataTest, LatestKeyBelongsToMeMatchesRoutingTable) {
+    // Two adjacent chunks, which are owned as a single range, and one further on.
+    const KeyPattern shardKeyPattern(BSON("a" << 1));
+    const std::vector<std::pair<BSONObj, BSONObj>> thisShardsChunks{
+        {BSON("a" << 10), BSON("a" << 20)},
+        {BSON("a" << 20), BSON("a" << 30)},
+        {BSON("a" << 40), BSON("a" << 50)}};
+    const auto latest = makeCollectionMetadataImpl(shardKeyPattern, thisShardsChunks, false, false);
+    const auto atClusterTime = makeCollectionMetadataImpl(shardKeyPattern, thisShardsChunks, false);
+
+    for (int a = 0; a < 60; ++a) {
+        const auto key = BSON("a" << a);
+        ASSERT_EQ(atClusterTime->keyBelongsToMe(key), latest->keyBelongsToMe(key)) << key;
+    }
+    ASSERT(latest->keyBelongsToMe(BSON("a" << 20)));
+    ASSERT(!latest->keyBelongsToMe(BSON("a" << 30)));
+    ASSERT(!latest->keyBelongsToMe(BSON("a" << MINKEY)));
+    ASSERT(!latest->keyBelongsToMe(BSON("a" << MAXKEY)));
+    ASSERT(!latest->keyBelongsToMe(BSONObj()));
+}
+
 TEST_F(StaleChunkFixture, KeyBelongsToMe) {
     ASSERT_THROWS_CODE(makeCollectionMetadata()->keyBelongsToMe(BSON("a" << 10)),
                        AssertionException,
@@ -48,15 +48,19 @@
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -68,8 +72,36 @@ MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 20)
         return Status::OK();
     });
 
+// Number of documents deleted in each write unit of work
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterDocsPerWriteUnitOfWork, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "rangeDeleterDocsPerWriteUnitOfWork must be at least 1");
+        }
+        return Status::OK();
+    });
+
+// When positive, the next batch is delayed while the majority commit point lags the last applied
+// optime by more than this many seconds
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxMajorityCommitLagSecs, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "rangeDeleterMaxMajorityCommitLagSecs must not be negative");
+        }
+        return Status::OK();
+    });
+
+// Whether the next batch is delayed while the storage engine cache is under pressure
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterThrottleOnCachePressure, bool, false);
+
 namespace {
 
+// Delay before the next batch when the deleter is throttled, unless rangeDeleterBatchDelayMS is
+// longer
+const Milliseconds kThrottledBatchDelay{1000};
+
 using Deletion = CollectionRangeDeleter::Deletion;
 using DeleteNotification = CollectionRangeDeleter::DeleteNotification;
 
@@ -90,6 +122,39 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Returns when the next batch of deletions should run, which is later than the regular delay
+ * between batches if the deletions are to be throttled.
+ */
+Date_t nextBatchTime(OperationContext* opCtx) {
+    const Milliseconds batchDelay{rangeDeleterBatchDelayMS.load()};
+
+    const bool underCachePressure = rangeDeleterThrottleOnCachePressure.load() &&
+        opCtx->getServiceContext()->getStorageEngine()->isCacheUnderPressure(opCtx);
+
+    const bool lagged = [&] {
+        const int maxLagSecs = rangeDeleterMaxMajorityCommitLagSecs.load();
+        if (maxLagSecs == 0) {
+            return false;
+        }
+        const auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+            return false;
+        }
+        const auto lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp();
+        const auto lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp();
+        return lastApplied > lastCommitted &&
+            lastApplied.getSecs() - lastCommitted.getSecs() > unsigned(maxLagSecs);
+    }();
+
+    if (underCachePressure || lagged) {
+        ShardingStatistics::get(opCtx).countRangeDeleterThrottles.addAndFetch(1);
+        return Date_t::now() + std::max(batchDelay, kThrottledBatchDelay);
+    }
+
+    return Date_t::now() + batchDelay;
+}
+
 }  // namespace
 
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
@@ -276,7 +341,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
                    << redact(self->_orphans.front().range.toString()) << " next.";
         }
 
-        return Date_t::now() + stdx::chrono::milliseconds{rangeDeleterBatchDelayMS.load()};
+        return nextBatchTime(opCtx);
     }
 
     invariant(range);
@@ -284,7 +349,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(wrote.getValue() > 0);
 
     notification.abandon();
-    return Date_t::now() + stdx::chrono::milliseconds{rangeDeleterBatchDelayMS.load()};
+    return nextBatchTime(opCtx);
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -341,32 +406,65 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
     auto exec = InternalPlanner::indexScan(
         opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
 
+    const size_t docsPerWriteUnitOfWork = rangeDeleterDocsPerWriteUnitOfWork.load();
+
+    Timer timer;
     int numDeleted = 0;
-    do {
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
+    bool exhausted = false;
+    while (!exhausted && numDeleted < maxToDelete) {
+        // Collect the documents to delete in the next write unit of work. Their contents are only
+        // needed, and so only kept, if they are saved before being deleted.
+        std::vector<std::pair<RecordId, BSONObj>> toDelete;
+        while (toDelete.size() < docsPerWriteUnitOfWork &&
+               numDeleted + int(toDelete.size()) < maxToDelete) {
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+            if (state == PlanExecutor::IS_EOF) {
+                exhausted = true;
+                break;
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning() << PlanExecutor::statestr(state)
+                          << " - cursor error while trying to delete " << redact(min) << " to "
+                          << redact(max) << " in " << nss << ": "
+                          << redact(WorkingSetCommon::toStatusString(obj))
+                          << ", stats: " << Explain::getWinningPlanStats(exec.get());
+                exhausted = true;
+                break;
+            }
+            invariant(PlanExecutor::ADVANCED == state);
+
+            toDelete.emplace_back(std::move(rloc), saver ? obj.getOwned() : BSONObj());
         }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning() << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                      << redact(min) << " to " << redact(max) << " in " << nss << ": "
-                      << redact(WorkingSetCommon::toStatusString(obj))
-                      << ", stats: " << Explain::getWinningPlanStats(exec.get());
+
+        if (toDelete.empty()) {
             break;
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
         exec->saveState();
+        bool isRetry = false;
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+            // After a write conflict the documents are looked up again in a new snapshot, in which
+            // some of them may already be gone
+            const bool mustCheckExists = isRetry;
+            isRetry = true;
+
             WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                uassertStatusOK(saver->goingToDelete(obj));
+            for (const auto& doc : toDelete) {
+                Snapshotted<BSONObj> unused;
+                if (mustCheckExists && !collection->findDoc(opCtx, doc.first, &unused)) {
+                    continue;
+                }
+                if (saver) {
+                    uassertStatusOK(saver->goingToDelete(doc.second));
+                }
+                collection->deleteDocument(opCtx, kUninitializedStmtId, doc.first, nullptr, true);
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
             wuow.commit();
         });
+        numDeleted += toDelete.size();
+
         auto restoreStateStatus = exec->restoreState();
         if (!restoreStateStatus.isOK()) {
             warning() << "error restoring cursor state while trying to delete " << redact(min)
@@ -375,8 +473,11 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                       << redact(restoreStateStatus);
             break;
         }
+    }
 
-    } while (++numDeleted < maxToDelete);
+    auto& shardingStatistics = ShardingStatistics::get(opCtx);
+    shardingStatistics.countDocsDeletedByRangeDeleter.addAndFetch(numDeleted);
+    shardingStatistics.totalRangeDeleterTimeMillis.addAndFetch(timer.millis());
 
     return numDeleted;
 }
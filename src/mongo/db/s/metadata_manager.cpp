@@ -132,6 +132,7 @@ void scheduleCleanup(executor::TaskExecutor* executor,
             Client::initThreadIfNotAlready("Collection Range Deleter");
             auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
             auto opCtx = uniqueOpCtx.get();
+            opCtx->lockState()->setTicketPriority(Locker::TicketPriority::kLow);
 
             const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
 
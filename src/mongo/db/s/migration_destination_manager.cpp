@@ -40,6 +40,7 @@
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/namespace_string.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -66,6 +68,28 @@
 namespace mongo {
 namespace {
 
+// Number of cloned documents inserted in each write unit of work. 0 inserts all the documents of a
+// batch from the donor in one.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionBatchSize, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneInsertionBatchSize must not be negative");
+        }
+        return Status::OK();
+    });
+
+// Number of threads inserting the cloned documents, each of which has one batch from the donor
+// fetched ahead of it
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInserterThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneInserterThreads must be between 1 and 16");
+        }
+        return Status::OK();
+    });
+
 const auto getMigrationDestinationManager =
     ServiceContext::declareDecoration<MigrationDestinationManager>();
 
@@ -376,32 +400,41 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
-    stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
-
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
-        Client::initThreadIfNotAlready("chunkInserter");
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
+    stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+    size_t numInserterThreads) {
+    invariant(numInserterThreads > 0);
+
+    // The inserter threads stop once the producer end is closed and all the batches are inserted,
+    // or once any of them fails, which closes the consumer end
+    ProducerConsumerQueue<BSONObj> batches(numInserterThreads);
+    std::vector<stdx::thread> inserterThreads;
+    auto joinInserterThreads = [&] {
+        batches.closeProducerEnd();
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
+    };
+    auto inserterThreadsJoinGuard = MakeGuard(joinInserterThreads);
+
+    for (size_t i = 0; i < numInserterThreads; ++i) {
+        inserterThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkInserter");
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    insertBatchFn(inserterOpCtx.get(), BSONObjIterator(nextBatch["objects"].Obj()));
                 }
-                insertBatchFn(inserterOpCtx.get(), BSONObjIterator(arr));
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Either all of the batches have been inserted or another inserter thread failed
+            } catch (...) {
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
+                log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
             }
-        } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
-        }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
-        batches.closeProducerEnd();
-        inserterThread.join();
-    });
+        });
+    }
 
     while (true) {
         opCtx->checkForInterrupt();
@@ -409,14 +442,14 @@ void MigrationDestinationManager::cloneDocumentsFromDonor(
         auto res = fetchBatchFn(opCtx);
 
         opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
         auto arr = res["objects"].Obj();
         if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
+            inserterThreadsJoinGuard.Dismiss();
+            joinInserterThreads();
             opCtx->checkForInterrupt();
             break;
         }
+        batches.push(res.getOwned(), opCtx);
     }
 }
 
@@ -754,6 +787,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
+        const size_t insertionBatchSize = migrateCloneInsertionBatchSize.load();
+
         auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
             while (docs.more()) {
                 opCtx->checkForInterrupt();
@@ -764,38 +799,49 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
                     uasserted(50748, message);
                 }
 
-                BSONObj docToClone = docs.next().Obj();
-                {
+                std::vector<BSONObj> docsToClone;
+                long long bytesToClone = 0;
+                while (docs.more() &&
+                       (insertionBatchSize == 0 || docsToClone.size() < insertionBatchSize)) {
+                    docsToClone.push_back(docs.next().Obj());
+                    bytesToClone += docsToClone.back().objsize();
+                }
+
+                writeConflictRetry(opCtx, "migrateCloneInsert", _nss.ns(), [&] {
                     AutoGetCollection autoColl(opCtx, _nss, MODE_IX);
                     uassert(ErrorCodes::ConflictingOperationInProgress,
                             str::stream() << "Collection " << _nss.ns()
                                           << " was dropped in the middle of the migration",
                             autoColl.getCollection());
 
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            _min,
-                                            _max,
-                                            _shardKeyPattern,
-                                            autoColl.getDb(),
-                                            docToClone,
-                                            &localDoc)) {
-                        const std::string errMsg = str::stream()
-                            << "cannot migrate chunk, local document " << redact(localDoc)
-                            << " has same _id as cloned "
-                            << "remote document " << redact(docToClone);
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    WriteUnitOfWork wuow(opCtx);
+                    for (const auto& docToClone : docsToClone) {
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(opCtx,
+                                                _nss,
+                                                _min,
+                                                _max,
+                                                _shardKeyPattern,
+                                                autoColl.getDb(),
+                                                docToClone,
+                                                &localDoc)) {
+                            const std::string errMsg = str::stream()
+                                << "cannot migrate chunk, local document " << redact(localDoc)
+                                << " has same _id as cloned "
+                                << "remote document " << redact(docToClone);
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+                        Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
                     }
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
-                }
+                    wuow.commit();
+                });
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += docsToClone.size();
+                    _clonedBytes += bytesToClone;
                 }
                 if (_writeConcern.shouldWaitForOtherNodes()) {
                     repl::ReplicationCoordinator::StatusAndDuration replStatus =
@@ -828,7 +874,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
             return res.response;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        cloneDocumentsFromDonor(
+            opCtx, insertBatchFn, fetchBatchFn, size_t(migrateCloneInserterThreads.load()));
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
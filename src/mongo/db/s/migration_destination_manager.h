@@ -112,12 +112,14 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. The batches are inserted by 'numInserterThreads'
+     * threads, concurrently with fetching up to as many batches ahead of them.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
         stdx::function<void(OperationContext*, BSONObjIterator)> insertBatchFn,
-        stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
+        stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+        size_t numInserterThreads = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
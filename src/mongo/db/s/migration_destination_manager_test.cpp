@@ -28,8 +28,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
+
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/s/shard_server_test_fixture.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -104,6 +107,48 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that with several inserter threads every fetched batch gets inserted exactly once.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithMultipleInserterThreads) {
+    const int kNumBatches = 20;
+    int numFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+        if (numFetched == kNumBatches) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            BSONArrayBuilder arrayBuilder;
+            for (int i = 0; i < 3; ++i) {
+                arrayBuilder.append(createDocument(numFetched * 3 + i));
+            }
+            fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+            ++numFetched;
+        }
+        return fetchBatchResultBuilder.obj();
+    };
+
+    stdx::mutex mutex;
+    std::set<int> insertedIds;
+    size_t numInserted = 0;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObjIterator docs) {
+        while (docs.more()) {
+            const auto id = docs.next().Obj()["_id"].numberInt();
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            insertedIds.insert(id);
+            ++numInserted;
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4);
+
+    ASSERT_EQ(size_t(kNumBatches * 3), numInserted);
+    ASSERT_EQ(size_t(kNumBatches * 3), insertedIds.size());
+    ASSERT_EQ(0, *insertedIds.begin());
+    ASSERT_EQ(kNumBatches * 3 - 1, *insertedIds.rbegin());
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
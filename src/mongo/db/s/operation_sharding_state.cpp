@@ -37,7 +37,7 @@ namespace mongo {
 namespace {
 
 const OperationContext::Decoration<OperationShardingState> shardingMetadataDecoration =
-    OperationContext::declareDecoration<OperationShardingState>();
+    OperationContext::declareHotDecoration<OperationShardingState>();
 
 // Max time to wait for the migration critical section to complete
 const Milliseconds kMaxWaitForMigrationCriticalSection = Minutes(5);
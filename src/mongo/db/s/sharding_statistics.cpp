@@ -57,6 +57,10 @@ void ShardingStatistics::report(BSONObjBuilder* builder) const {
     builder->append("totalCriticalSectionCommitTimeMillis",
                     totalCriticalSectionCommitTimeMillis.load());
     builder->append("totalCriticalSectionTimeMillis", totalCriticalSectionTimeMillis.load());
+
+    builder->append("countDocsDeletedByRangeDeleter", countDocsDeletedByRangeDeleter.load());
+    builder->append("totalRangeDeleterTimeMillis", totalRangeDeleterTimeMillis.load());
+    builder->append("countRangeDeleterThrottles", countRangeDeleterThrottles.load());
 }
 
 }  // namespace mongo
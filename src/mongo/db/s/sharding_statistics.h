@@ -70,6 +70,15 @@ struct ShardingStatistics {
     // from the donor to the recipient).
     AtomicInt64 totalCriticalSectionTimeMillis{0};
 
+    // Cumulative, always-increasing counter of how many orphaned documents the range deleter
+    // removed and of how much time it spent removing them, from which its throughput follows
+    AtomicInt64 countDocsDeletedByRangeDeleter{0};
+    AtomicInt64 totalRangeDeleterTimeMillis{0};
+
+    // Cumulative, always-increasing counter of how many times the range deleter delayed its next
+    // batch because of replication lag or storage engine cache pressure
+    AtomicInt64 countRangeDeleterThrottles{0};
+
     /**
      * Obtains the per-process instance of the sharding statistics object.
      */
@@ -970,6 +970,53 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
     curop->setNS_inlock(nss.ns());
 }
 
+/**
+ * If the OP_MSG request in 'message' allows exhaust and 'response' is its reply from a find,
+ * aggregate or getMore with a non-empty batch and an open cursor, returns the getMore that will
+ * produce the next reply. Otherwise returns none.
+ */
+boost::optional<BSONObj> makeExhaustGetMore(const Message& message, const Message& response) {
+    if (!OpMsg::isFlagSet(message, OpMsg::kExhaustSupported)) {
+        return boost::none;
+    }
+
+    const auto request = OpMsgRequest::parse(message);
+    const auto commandName = request.getCommandName();
+    BSONElement batchSize;
+    if (commandName == "find" || commandName == "getMore") {
+        batchSize = request.body["batchSize"];
+    } else if (commandName == "aggregate") {
+        batchSize = request.body["cursor"]["batchSize"];
+    } else {
+        return boost::none;
+    }
+
+    const auto reply = OpMsg::parse(response).body;
+    const auto cursor = reply["cursor"];
+    if (!reply["ok"].trueValue() || cursor.type() != Object) {
+        return boost::none;
+    }
+
+    // Stop streaming when the cursor is exhausted, and also on an empty batch so that an awaitData
+    // cursor hands control back to the client rather than spinning on getMores.
+    const auto cursorObj = cursor.Obj();
+    const auto batch = cursorObj.hasField("firstBatch") ? cursorObj["firstBatch"]
+                                                        : cursorObj["nextBatch"];
+    const auto cursorId = cursorObj["id"].safeNumberLong();
+    if (cursorId == 0 || batch.type() != Array || batch.Obj().isEmpty()) {
+        return boost::none;
+    }
+
+    BSONObjBuilder getMore;
+    getMore.append("getMore", cursorId);
+    getMore.append("collection", NamespaceString(cursorObj["ns"].String()).coll());
+    if (batchSize.isNumber()) {
+        getMore.append("batchSize", batchSize.safeNumberLong());
+    }
+    getMore.append("$db", request.getDatabase());
+    return getMore.obj();
+}
+
 DbResponse receivedCommands(OperationContext* opCtx,
                             const Message& message,
                             const ServiceEntryPointCommon::Hooks& behaviors) {
@@ -1055,8 +1102,13 @@ DbResponse receivedCommands(OperationContext* opCtx,
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
-    return DbResponse{std::move(response)};
+    DbResponse dbResponse{std::move(response)};
+    dbResponse.nextInvocation = makeExhaustGetMore(message, dbResponse.response);
+    if (dbResponse.nextInvocation) {
+        CurOp::get(opCtx)->debug().exhaust = true;
+        OpMsg::setFlag(&dbResponse.response, OpMsg::kMoreToCome);
+    }
+    return dbResponse;
 }
 
 DbResponse receivedQuery(OperationContext* opCtx,
@@ -1372,7 +1424,8 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
         .incrementGlobalLatencyStats(
             opCtx,
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
-            currentOp.getReadWriteType());
+            currentOp.getReadWriteType(),
+            currentOp.getCommand());
 
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
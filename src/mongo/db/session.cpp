@@ -45,6 +45,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/retryable_write_history_cache.h"
 #include "mongo/db/retryable_writes_stats.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/server_transactions_metrics.h"
@@ -153,6 +154,15 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
         return result;
     }
 
+    auto& historyCache = RetryableWriteHistoryCache::get(opCtx->getServiceContext());
+    if (auto cachedHistory = historyCache.find(lsid,
+                                               result.lastTxnRecord->getTxnNum(),
+                                               result.lastTxnRecord->getLastWriteOpTime())) {
+        result.committedStatements = std::move(cachedHistory->committedStatements);
+        result.hasIncompleteHistory = cachedHistory->hasIncompleteHistory;
+        return result;
+    }
+
     auto it = TransactionHistoryIterator(result.lastTxnRecord->getLastWriteOpTime());
     while (it.hasNext()) {
         try {
@@ -193,6 +203,15 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
         }
     }
 
+    // Only the history of retryable writes is cached, since whether a multi-statement transaction
+    // committed can only be learned from its oplog entries.
+    if (!result.transactionCommitted) {
+        historyCache.put(lsid,
+                         result.lastTxnRecord->getTxnNum(),
+                         result.lastTxnRecord->getLastWriteOpTime(),
+                         {result.committedStatements, result.hasIncompleteHistory});
+    }
+
     return result;
 }
 
@@ -969,8 +988,7 @@ void Session::_setActiveTxn(WithLock wl, TxnNumber txnNumber) {
     _multikeyPathInfo.clear();
 }
 
-void Session::addTransactionOperation(OperationContext* opCtx,
-                                      const repl::ReplOperation& operation) {
+void Session::addTransactionOperation(OperationContext* opCtx, repl::ReplOperation operation) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     // Always check '_activeTxnNumber' and '_txnState', since they can be modified by session kill
@@ -982,8 +1000,8 @@ void Session::addTransactionOperation(OperationContext* opCtx,
 
     invariant(!_autocommit && _activeTxnNumber != kUninitializedTxnNumber);
     invariant(opCtx->lockState()->inAWriteUnitOfWork());
-    _transactionOperations.push_back(operation);
     _transactionOperationBytes += repl::OplogEntry::getReplOperationSize(operation);
+    _transactionOperations.push_back(std::move(operation));
     // _transactionOperationBytes is based on the in-memory size of the operation.  With overhead,
     // we expect the BSON size of the operation to be larger, so it's possible to make a transaction
     // just a bit too large and have it fail only in the commit.  It's still useful to fail early
@@ -1249,6 +1267,20 @@ void Session::_registerUpdateCacheOnCommit(OperationContext* opCtx,
             if (!_isValid)
                 return;
 
+            // The oplog entries of this write were chained to the last write of the same
+            // transaction number, if any.
+            auto& historyCache = RetryableWriteHistoryCache::get(getGlobalServiceContext());
+            if (newTxnNumber == _activeTxnNumber && _autocommit) {
+                const auto prevOpTime = _lastWrittenSessionRecord &&
+                        _lastWrittenSessionRecord->getTxnNum() == newTxnNumber
+                    ? _lastWrittenSessionRecord->getLastWriteOpTime()
+                    : repl::OpTime();
+                historyCache.onStatementsWritten(
+                    _sessionId, newTxnNumber, stmtIdsWritten, lastStmtIdWriteOpTime, prevOpTime);
+            } else {
+                historyCache.invalidate(_sessionId);
+            }
+
             // The cache of the last written record must always be advanced after a write so that
             // subsequent writes have the correct point to start from.
             if (!_lastWrittenSessionRecord) {
@@ -331,9 +331,10 @@ public:
     /**
      * Adds a stored operation to the list of stored operations for the current multi-document
      * (non-autocommit) transaction.  It is illegal to add operations when no multi-document
-     * transaction is in progress.
+     * transaction is in progress. Takes the operation by value so that callers which are done
+     * with it can move it in.
      */
-    void addTransactionOperation(OperationContext* opCtx, const repl::ReplOperation& operation);
+    void addTransactionOperation(OperationContext* opCtx, repl::ReplOperation operation);
 
     /**
      * Returns and clears the stored operations for an multi-document (non-autocommit) transaction,
@@ -54,17 +54,25 @@ const auto operationSessionDecoration =
 
 }  // namespace
 
+constexpr size_t SessionCatalog::kNumPartitions;
+
+SessionCatalog::SessionCatalog() : _partitions(kNumPartitions) {}
+
 SessionCatalog::~SessionCatalog() {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-    for (const auto& entry : _txnTable) {
-        auto& sri = entry.second;
-        invariant(!sri->checkedOut);
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+        for (const auto& entry : partition.txnTable) {
+            auto& sri = entry.second;
+            invariant(!sri->checkedOut);
+        }
     }
 }
 
 void SessionCatalog::reset_forTest() {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-    _txnTable.clear();
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+        partition.txnTable.clear();
+    }
 }
 
 SessionCatalog* SessionCatalog::get(OperationContext* opCtx) {
@@ -125,9 +133,10 @@ ScopedCheckedOutSession SessionCatalog::checkOutSession(OperationContext* opCtx)
 
     const auto lsid = *opCtx->getLogicalSessionId();
 
-    stdx::unique_lock<stdx::mutex> ul(_mutex);
+    auto& partition = _getPartition(lsid);
+    stdx::unique_lock<stdx::mutex> ul(partition.mutex);
 
-    auto sri = _getOrCreateSessionRuntimeInfo(ul, opCtx, lsid);
+    auto sri = _getOrCreateSessionRuntimeInfo(ul, partition, opCtx, lsid);
 
     // Wait until the session is no longer checked out
     opCtx->waitForConditionOrInterrupt(
@@ -146,8 +155,9 @@ ScopedSession SessionCatalog::getOrCreateSession(OperationContext* opCtx,
     invariant(!opCtx->getTxnNumber());
 
     auto ss = [&] {
-        stdx::unique_lock<stdx::mutex> ul(_mutex);
-        return ScopedSession(_getOrCreateSessionRuntimeInfo(ul, opCtx, lsid));
+        auto& partition = _getPartition(lsid);
+        stdx::unique_lock<stdx::mutex> ul(partition.mutex);
+        return ScopedSession(_getOrCreateSessionRuntimeInfo(ul, partition, opCtx, lsid));
     }();
 
     // Perform the refresh outside of the mutex
@@ -164,31 +174,37 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
                           << " cannot be performed using a transaction or on a session.",
             !opCtx->getLogicalSessionId());
 
-    const auto invalidateSessionFn = [&](WithLock, SessionRuntimeInfoMap::iterator it) {
-        auto& sri = it->second;
-        sri->txnState.invalidate();
+    const auto invalidateSessionFn =
+        [&](WithLock, Partition& partition, SessionRuntimeInfoMap::iterator it) {
+            auto& sri = it->second;
+            sri->txnState.invalidate();
 
-        // We cannot remove checked-out sessions from the cache, because operations expect to find
-        // them there to check back in
-        if (!sri->checkedOut) {
-            _txnTable.erase(it);
-        }
-    };
-
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+            // We cannot remove checked-out sessions from the cache, because operations expect to
+            // find them there to check back in
+            if (!sri->checkedOut) {
+                partition.txnTable.erase(it);
+            }
+        };
 
     if (singleSessionDoc) {
         const auto lsid = LogicalSessionId::parse(IDLParserErrorContext("lsid"),
                                                   singleSessionDoc->getField("_id").Obj());
 
-        auto it = _txnTable.find(lsid);
-        if (it != _txnTable.end()) {
-            invalidateSessionFn(lg, it);
+        auto& partition = _getPartition(lsid);
+        stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+
+        auto it = partition.txnTable.find(lsid);
+        if (it != partition.txnTable.end()) {
+            invalidateSessionFn(lg, partition, it);
         }
     } else {
-        auto it = _txnTable.begin();
-        while (it != _txnTable.end()) {
-            invalidateSessionFn(lg, it++);
+        for (auto& partition : _partitions) {
+            stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+
+            auto it = partition.txnTable.begin();
+            while (it != partition.txnTable.end()) {
+                invalidateSessionFn(lg, partition, it++);
+            }
         }
     }
 }
@@ -196,37 +212,59 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
 void SessionCatalog::scanSessions(OperationContext* opCtx,
                                   const SessionKiller::Matcher& matcher,
                                   stdx::function<void(OperationContext*, Session*)> workerFn) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-
-    LOG(2) << "Beginning scanSessions. Scanning " << _txnTable.size() << " sessions.";
+    LOG(2) << "Beginning scanSessions.";
+
+    size_t numScanned = 0;
+    std::vector<std::pair<const KillAllSessionsByPattern*, std::shared_ptr<SessionRuntimeInfo>>>
+        matches;
+    for (auto& partition : _partitions) {
+        // Collect the matching sessions of this partition under its mutex, but apply 'workerFn'
+        // outside of it, so that checkouts are not blocked for as long as the work takes. The
+        // shared_ptrs keep the sessions alive if they are invalidated in the meantime.
+        matches.clear();
+        {
+            stdx::lock_guard<stdx::mutex> lg(partition.mutex);
+            numScanned += partition.txnTable.size();
+            for (const auto& entry : partition.txnTable) {
+                // TODO SERVER-33850: Rename KillAllSessionsByPattern and
+                // ScopedKillAllSessionsByPatternImpersonator to not refer to session kill.
+                if (const KillAllSessionsByPattern* pattern = matcher.match(entry.first)) {
+                    matches.emplace_back(pattern, entry.second);
+                }
+            }
+        }
 
-    for (auto it = _txnTable.begin(); it != _txnTable.end(); ++it) {
-        // TODO SERVER-33850: Rename KillAllSessionsByPattern and
-        // ScopedKillAllSessionsByPatternImpersonator to not refer to session kill.
-        if (const KillAllSessionsByPattern* pattern = matcher.match(it->first)) {
-            ScopedKillAllSessionsByPatternImpersonator impersonator(opCtx, *pattern);
-            workerFn(opCtx, &(it->second->txnState));
+        for (const auto& match : matches) {
+            ScopedKillAllSessionsByPatternImpersonator impersonator(opCtx, *match.first);
+            workerFn(opCtx, &(match.second->txnState));
         }
     }
+
+    LOG(2) << "Finished scanSessions. Scanned " << numScanned << " sessions.";
+}
+
+SessionCatalog::Partition& SessionCatalog::_getPartition(const LogicalSessionId& lsid) {
+    return _partitions[LogicalSessionIdHash{}(lsid) % kNumPartitions];
 }
 
 std::shared_ptr<SessionCatalog::SessionRuntimeInfo> SessionCatalog::_getOrCreateSessionRuntimeInfo(
-    WithLock, OperationContext* opCtx, const LogicalSessionId& lsid) {
+    WithLock, Partition& partition, OperationContext* opCtx, const LogicalSessionId& lsid) {
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
 
-    auto it = _txnTable.find(lsid);
-    if (it == _txnTable.end()) {
-        it = _txnTable.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
+    auto it = partition.txnTable.find(lsid);
+    if (it == partition.txnTable.end()) {
+        it = partition.txnTable.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
     }
 
     return it->second;
 }
 
 void SessionCatalog::_releaseSession(const LogicalSessionId& lsid) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    auto& partition = _getPartition(lsid);
+    stdx::lock_guard<stdx::mutex> lg(partition.mutex);
 
-    auto it = _txnTable.find(lsid);
-    invariant(it != _txnTable.end());
+    auto it = partition.txnTable.find(lsid);
+    invariant(it != partition.txnTable.end());
 
     auto& sri = it->second;
     invariant(sri->checkedOut);
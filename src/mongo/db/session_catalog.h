@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/session.h"
@@ -35,6 +39,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -53,7 +58,7 @@ class SessionCatalog {
     friend class ScopedCheckedOutSession;
 
 public:
-    SessionCatalog() = default;
+    SessionCatalog();
     ~SessionCatalog();
 
     /**
@@ -118,8 +123,9 @@ public:
     void invalidateSessions(OperationContext* opCtx, boost::optional<BSONObj> singleSessionDoc);
 
     /**
-     * Iterates through the SessionCatalog and applies 'workerFn' to each Session. This locks the
-     * SessionCatalog.
+     * Iterates through the SessionCatalog and applies 'workerFn' to each Session. Only locks one
+     * partition of the SessionCatalog at a time, and none while 'workerFn' runs, so sessions may be
+     * checked out, created or invalidated concurrently with the scan.
      * TODO SERVER-33850: Take Matcher out of the SessionKiller namespace.
      */
     void scanSessions(OperationContext* opCtx,
@@ -135,8 +141,8 @@ private:
         // check it out.
         bool checkedOut{false};
 
-        // Signaled when the state becomes available. Uses the transaction table's mutex to protect
-        // the state transitions.
+        // Signaled when the state becomes available. Uses the mutex of the partition of the session
+        // to protect the state transitions.
         stdx::condition_variable availableCondVar;
 
         // Must only be accessed when the state is kInUse and only by the operation context, which
@@ -148,21 +154,35 @@ private:
                                                       std::shared_ptr<SessionRuntimeInfo>,
                                                       LogicalSessionIdHash>;
 
+    /**
+     * The sessions are spread over partitions by the hash of their id, each with their own mutex,
+     * so that operations on different sessions rarely contend.
+     */
+    struct Partition {
+        stdx::mutex mutex;
+        SessionRuntimeInfoMap txnTable;
+    };
+
+    static constexpr size_t kNumPartitions = 16;
+
+    Partition& _getPartition(const LogicalSessionId& lsid);
+
     /**
      * May release and re-acquire it zero or more times before returning. The returned
-     * 'SessionRuntimeInfo' is guaranteed to be linked on the catalog's _txnTable as long as the
-     * lock is held.
+     * 'SessionRuntimeInfo' is guaranteed to be linked on the partition's txnTable as long as the
+     * partition's lock is held.
      */
     std::shared_ptr<SessionRuntimeInfo> _getOrCreateSessionRuntimeInfo(
-        WithLock, OperationContext* opCtx, const LogicalSessionId& lsid);
+        WithLock, Partition& partition, OperationContext* opCtx, const LogicalSessionId& lsid);
 
     /**
      * Makes a session, previously checked out through 'checkoutSession', available again.
      */
     void _releaseSession(const LogicalSessionId& lsid);
 
-    stdx::mutex _mutex;
-    SessionRuntimeInfoMap _txnTable;
+    using AlignedPartition = CacheAligned<Partition>;
+    using AlignedPartitionAllocator = boost::alignment::aligned_allocator<AlignedPartition>;
+    std::vector<AlignedPartition, AlignedPartitionAllocator> _partitions;
 };
 
 /**
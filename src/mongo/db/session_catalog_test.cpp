@@ -292,5 +292,23 @@ TEST_F(SessionCatalogTest, ScanSessions) {
     ASSERT_EQ(lsids.front(), lsid2);
 }
 
+TEST_F(SessionCatalogTest, ScanSessionsDoesNotHoldCatalogLockWhileApplyingWorker) {
+    const auto lsid = makeLogicalSessionIdForTest();
+    catalog()->getOrCreateSession(opCtx(), lsid);
+
+    // Looking up a session, which necessarily lives in the same partition as the one being
+    // visited, would deadlock if the partition were locked while the worker runs.
+    int numVisited = 0;
+    SessionKiller::Matcher matcherAllSessions(
+        KillAllSessionsByPatternSet{makeKillAllSessionsByPattern(opCtx())});
+    catalog()->scanSessions(
+        opCtx(), matcherAllSessions, [&](OperationContext* opCtx, Session* session) {
+            auto scopedSession = catalog()->getOrCreateSession(opCtx, session->getSessionId());
+            ASSERT_EQ(scopedSession.get(), session);
+            ++numVisited;
+        });
+    ASSERT_EQ(numVisited, 1);
+}
+
 }  // namespace
 }  // namespace mongo
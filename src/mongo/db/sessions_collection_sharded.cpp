@@ -30,6 +30,9 @@
 
 #include "mongo/db/sessions_collection_sharded.h"
 
+#include <map>
+#include <vector>
+
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/canonical_query.h"
@@ -53,6 +56,59 @@ BSONObj lsidQuery(const LogicalSessionId& lsid) {
     return BSON(LogicalSessionRecord::kIdFieldName << lsid.toBSON());
 }
 
+const LogicalSessionId& getLsid(const LogicalSessionId& lsid) {
+    return lsid;
+}
+
+const LogicalSessionId& getLsid(const LogicalSessionRecord& record) {
+    return record.getId();
+}
+
+/**
+ * Splits 'sessions' into one set per shard which owns the chunk of each session's document, so
+ * that each batch written by the caller targets a single shard instead of being scattered across
+ * all of them. Returns 'sessions' as the only set if the routing table is not available, in which
+ * case the writes are targeted as usual.
+ */
+template <typename Container>
+std::vector<Container> groupByShard(OperationContext* opCtx, const Container& sessions) {
+    auto routingInfo = Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(
+        opCtx, NamespaceString::kLogicalSessionsNamespace);
+    if (!routingInfo.isOK() || !routingInfo.getValue().cm() || sessions.size() <= 1) {
+        return {sessions};
+    }
+
+    const auto& cm = routingInfo.getValue().cm();
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(sessions.size());
+    for (const auto& session : sessions) {
+        shardKeys.push_back(
+            cm->getShardKeyPattern().extractShardKeyFromDoc(lsidQuery(getLsid(session))));
+    }
+
+    std::map<ShardId, Container> byShard;
+    try {
+        auto chunks = cm->findIntersectingChunksWithSimpleCollation(shardKeys);
+        size_t i = 0;
+        for (const auto& session : sessions) {
+            const auto& chunk = chunks[i++];
+            if (!chunk) {
+                return {sessions};
+            }
+            byShard[chunk->getShardId()].insert(session);
+        }
+    } catch (const DBException&) {
+        return {sessions};
+    }
+
+    std::vector<Container> groups;
+    groups.reserve(byShard.size());
+    for (auto& group : byShard) {
+        groups.push_back(std::move(group.second));
+    }
+    return groups;
+}
+
 }  // namespace
 
 Status SessionsCollectionSharded::_checkCacheForSessionsCollection(OperationContext* opCtx) {
@@ -94,7 +150,13 @@ Status SessionsCollectionSharded::refreshSessions(OperationContext* opCtx,
         return response.toStatus();
     };
 
-    return doRefresh(NamespaceString::kLogicalSessionsNamespace, sessions, send);
+    for (const auto& group : groupByShard(opCtx, sessions)) {
+        auto status = doRefresh(NamespaceString::kLogicalSessionsNamespace, group, send);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
 }
 
 Status SessionsCollectionSharded::removeRecords(OperationContext* opCtx,
@@ -111,7 +173,13 @@ Status SessionsCollectionSharded::removeRecords(OperationContext* opCtx,
         return response.toStatus();
     };
 
-    return doRemove(NamespaceString::kLogicalSessionsNamespace, sessions, send);
+    for (const auto& group : groupByShard(opCtx, sessions)) {
+        auto status = doRemove(NamespaceString::kLogicalSessionsNamespace, group, send);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
 }
 
 StatusWith<LogicalSessionIdSet> SessionsCollectionSharded::findRemovedSessions(
@@ -51,6 +51,11 @@
 #include <snappy.h>
 #include <vector>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
@@ -61,6 +66,7 @@
 #include "mongo/s/is_mongos.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
+#include "mongo/util/checksum.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/unowned_ptr.h"
@@ -143,6 +149,53 @@ private:
     std::deque<Data> _data;
 };
 
+/**
+ * Asks the operating system to read ahead of a FileIterator, so that the next blocks of each of the
+ * files being merged are read from disk while the current ones are consumed.
+ */
+class FileReadAhead {
+    MONGO_DISALLOW_COPYING(FileReadAhead);
+
+public:
+    explicit FileReadAhead(const std::string& fileName) {
+#ifdef __linux__
+        _fd = ::open(fileName.c_str(), O_RDONLY);
+        if (_fd >= 0) {
+            ::posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    ~FileReadAhead() {
+#ifdef __linux__
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+#endif
+    }
+
+    /**
+     * Called once the reader has reached 'offset'. Once less than half of the window read ahead of
+     * the reader remains, requests the file up to a whole window ahead of it.
+     */
+    void advanceTo(long long offset) {
+#ifdef __linux__
+        if (_fd < 0 || offset + kWindowBytes / 2 < _requestedUpTo) {
+            return;
+        }
+        const long long requestFrom = std::max(offset, _requestedUpTo);
+        _requestedUpTo = offset + kWindowBytes;
+        ::posix_fadvise(_fd, requestFrom, _requestedUpTo - requestFrom, POSIX_FADV_WILLNEED);
+#endif
+    }
+
+private:
+    static constexpr long long kWindowBytes = 1024 * 1024;
+
+    int _fd = -1;
+    long long _requestedUpTo = 0;
+};
+
 /** Returns results in order from a single file */
 template <typename Key, typename Value>
 class FileIterator : public SortIteratorInterface<Key, Value> {
@@ -159,7 +212,8 @@ public:
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
-          _file(_fileName.c_str(), std::ios::in | std::ios::binary) {
+          _file(_fileName.c_str(), std::ios::in | std::ios::binary),
+          _readAhead(_fileName) {
         massert(16814,
                 str::stream() << "error opening file \"" << _fileName << "\": "
                               << myErrnoWithDescription(),
@@ -206,7 +260,19 @@ private:
 
         _buffer.reset(new char[blockSize]);
         read(_buffer.get(), blockSize);
+        Checksum checksum;
+        if (!_done)
+            read(&checksum, sizeof(checksum));
         massert(16816, "file too short?", !_done);
+        _fileOffset += sizeof(rawSize) + blockSize + sizeof(checksum);
+        _readAhead.advanceTo(_fileOffset);
+
+        Checksum expectedChecksum;
+        expectedChecksum.gen(_buffer.get(), blockSize);
+        massert(50912,
+                str::stream() << "checksum mismatch in block ending at offset " << _fileOffset
+                              << " of file \"" << _fileName << "\"",
+                checksum == expectedChecksum);
 
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
@@ -270,6 +336,8 @@ private:
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
+    FileReadAhead _readAhead;
+    long long _fileOffset = 0;
 };
 
 /** Merge-sorts results from 0 or more FileIterators */
@@ -884,11 +952,16 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
+    // Each block is followed by a checksum of what was written, which reading the block checks.
+    Checksum checksum;
+    checksum.gen(outBuffer, size);
+
     // negative size means compressed
     size = shouldCompress ? -size : size;
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
         _file.write(outBuffer, std::abs(size));
+        _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
 
     } catch (const std::exception&) {
         msgasserted(16821,
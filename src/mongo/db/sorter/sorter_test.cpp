@@ -267,6 +267,30 @@ public:
     }
 };
 
+class FileIteratorDetectsCorruption {
+public:
+    void run() {
+        unittest::TempDir tempDir("fileIteratorDetectsCorruption");
+        SortedFileWriter<IntWrapper, IntWrapper> sorter(SortOptions().TempDir(tempDir.path()));
+        for (int i = 0; i < 5; i++)
+            sorter.addAlreadySorted(i, -i);
+        std::shared_ptr<IWIterator> iter(sorter.done());
+
+        // Flip a byte of the first block's data, which follows its 4-byte size.
+        const auto fileName =
+            boost::filesystem::directory_iterator(tempDir.path())->path().string();
+        {
+            std::fstream file(fileName, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekg(5);
+            char byte = file.get();
+            file.seekp(5);
+            file.put(~byte);
+        }
+
+        ASSERT_THROWS_CODE(iter->more(), AssertionException, 50912);
+    }
+};
+
 
 class MergeIteratorTests {
 public:
@@ -542,6 +566,7 @@ public:
     void setupTests() {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<FileIteratorDetectsCorruption>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
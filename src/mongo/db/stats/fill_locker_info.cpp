@@ -74,6 +74,11 @@ void fillLockerInfo(const Locker::LockerInfo& lockerInfo, BSONObjBuilder& infoBu
         lockerInfo.stats.report(&lockStats);
         lockStats.done();
     }
+
+    const long long lockWaitMicros = lockerInfo.stats.getCombinedWaitTimeMicros();
+    if (lockWaitMicros > 0) {
+        infoBuilder.appendNumber("timeWaitingForLocksMicros", lockWaitMicros);
+    }
 }
 
 }  // namespace mongo
@@ -79,6 +79,21 @@ TEST(FillLockerInfo, DoesReportLockStats) {
     const BSONObj infoObj = infoBuilder.done();
 
     ASSERT_EQ(infoObj["lockStats"].type(), BSONType::Object);
+    ASSERT_FALSE(infoObj.hasField("timeWaitingForLocksMicros"));
+}
+
+TEST(FillLockerInfo, DoesReportTimeWaitingForLocks) {
+    LockerInfo info;
+    SingleThreadedLockStats stats;
+    stats.recordWaitTime(kGlobalId, MODE_IX, 5);
+    stats.recordWaitTime(resourceIdOplog, MODE_IX, 7);
+    info.stats = stats;
+
+    BSONObjBuilder infoBuilder;
+    fillLockerInfo(info, infoBuilder);
+    const BSONObj infoObj = infoBuilder.done();
+
+    ASSERT_EQ(infoObj["timeWaitingForLocksMicros"].numberLong(), 12);
 }
 
 DEATH_TEST(FillLockerInfo, ShouldFailIfLocksAreNotSortedAppropriately, "Invariant failure") {
@@ -28,10 +28,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include <map>
+
+#include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/stats/windowed_latency_histogram.h"
 
 namespace mongo {
 namespace {
@@ -57,5 +61,49 @@ public:
         return latencyBuilder.obj();
     }
 } globalHistogramServerStatusSection;
+
+/**
+ * Appends the percentiles of operation latencies over the last minute, per type of operation as in
+ * opLatencies and per command, to the server status.
+ */
+class LatencyPercentilesServerStatusSection final : public ServerStatusSection {
+public:
+    LatencyPercentilesServerStatusSection() : ServerStatusSection("opLatencyPercentiles") {}
+
+    bool includeByDefault() const {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const {
+        const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+
+        BSONObjBuilder builder;
+        builder.append("windowMillis",
+                       durationCount<Milliseconds>(WindowedLatencyHistogram::kSlotDuration *
+                                                   WindowedLatencyHistogram::kNumSlots));
+        Top::get(opCtx->getServiceContext()).appendGlobalLatencyPercentiles(now, &builder);
+
+        // Only the commands that have run are reported, in the order of their names.
+        std::map<std::string, const WindowedLatencyHistogram*> commandPercentiles;
+        for (const auto& entry : globalCommandRegistry()->allCommands()) {
+            const Command* command = entry.second;
+            if (entry.first != command->getName()) {
+                // Skip the old names of commands.
+                continue;
+            }
+            if (auto percentiles = command->getLatencyPercentiles()) {
+                commandPercentiles.emplace(entry.first, percentiles);
+            }
+        }
+
+        BSONObjBuilder byCommandBuilder(builder.subobjStart("byCommand"));
+        for (const auto& entry : commandPercentiles) {
+            BSONObjBuilder commandBuilder(byCommandBuilder.subobjStart(entry.first));
+            entry.second->appendSummary(now, &commandBuilder);
+        }
+        byCommandBuilder.doneFast();
+        return builder.obj();
+    }
+} latencyPercentilesServerStatusSection;
 }  // namespace
 }  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+}  // namespace
+
+// static
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+void QueryStatsStore::record(const std::string& key,
+                             const BSONObj& shape,
+                             const QueryStatsSample& sample) {
+    const Date_t now = Date_t::now();
+    const size_t maxEntries = std::max(1, internalQueryStatsMaxEntries.load());
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _index.find(key);
+    if (it == _index.end()) {
+        _entries.emplace_front(key, Entry());
+        it = _index.emplace(key, _entries.begin()).first;
+
+        Entry& entry = _entries.front().second;
+        entry.shape = shape.getOwned();
+        entry.firstSeen = now;
+
+        while (_entries.size() > maxEntries) {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+    } else {
+        _entries.splice(_entries.begin(), _entries, it->second);
+    }
+
+    Entry& entry = it->second->second;
+    entry.lastSeen = now;
+    if (sample.isGetMore) {
+        ++entry.getMoreCount;
+    } else {
+        ++entry.execCount;
+    }
+    entry.keysExamined += sample.keysExamined;
+    entry.docsExamined += sample.docsExamined;
+    entry.nreturned += sample.nreturned;
+    entry.bytesReturned += sample.bytesReturned;
+    entry.latency.increment(sample.latencyMicros, sample.readWriteType);
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats() const {
+    std::vector<BSONObj> stats;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    stats.reserve(_entries.size());
+    for (auto&& keyAndEntry : _entries) {
+        BSONObjBuilder builder;
+        keyAndEntry.second.appendToBSON(&builder);
+        stats.push_back(builder.obj());
+    }
+    return stats;
+}
+
+size_t QueryStatsStore::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+void QueryStatsStore::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.clear();
+    _index.clear();
+}
+
+void QueryStatsStore::Entry::appendToBSON(BSONObjBuilder* builder) const {
+    builder->appendElements(shape);
+    builder->append("firstSeen", firstSeen);
+    builder->append("lastSeen", lastSeen);
+    builder->appendNumber("execCount", execCount);
+    builder->appendNumber("getMoreCount", getMoreCount);
+    builder->appendNumber("keysExamined", keysExamined);
+    builder->appendNumber("docsExamined", docsExamined);
+    builder->appendNumber("nreturned", nreturned);
+    builder->appendNumber("bytesReturned", bytesReturned);
+
+    BSONObjBuilder latencyBuilder(builder->subobjStart("latency"));
+    latency.append(true, &latencyBuilder);
+    latencyBuilder.doneFast();
+}
+
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * The execution metrics of one completed operation, attributed to the shape of the query it ran.
+ */
+struct QueryStatsSample {
+    // True for the getMores which fetch further batches of an existing cursor.
+    bool isGetMore = false;
+    Command::ReadWriteType readWriteType = Command::ReadWriteType::kRead;
+    long long latencyMicros = 0;
+    long long keysExamined = 0;
+    long long docsExamined = 0;
+    long long nreturned = 0;
+    long long bytesReturned = 0;
+};
+
+/**
+ * Keeps execution statistics per query shape for the $queryStats aggregation stage. Operations are
+ * sampled when they plan a query, at the rate set by internalQueryStatsSampleRate, and recorded as
+ * they complete. At most internalQueryStatsMaxEntries shapes are kept; the least recently executed
+ * shape is evicted first.
+ */
+class QueryStatsStore {
+public:
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * Adds 'sample' to the statistics of the shape identified by 'key'. 'shape' describes the
+     * shape the first time it is seen.
+     */
+    void record(const std::string& key, const BSONObj& shape, const QueryStatsSample& sample);
+
+    /**
+     * Returns one document per shape, most recently executed first.
+     */
+    std::vector<BSONObj> getStats() const;
+
+    size_t size() const;
+
+    void clear();
+
+private:
+    struct Entry {
+        void appendToBSON(BSONObjBuilder* builder) const;
+
+        BSONObj shape;
+        Date_t firstSeen;
+        Date_t lastSeen;
+        long long execCount = 0;
+        long long getMoreCount = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+        OperationLatencyHistogram latency;
+    };
+
+    using EntryList = std::list<std::pair<std::string, Entry>>;
+
+    mutable stdx::mutex _mutex;
+
+    // Ordered from most to least recently executed.
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _index;
+};
+
+}  // namespace mongo
@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats.h"
+
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+QueryStatsSample makeSample(long long latencyMicros, long long docsExamined) {
+    QueryStatsSample sample;
+    sample.latencyMicros = latencyMicros;
+    sample.keysExamined = docsExamined;
+    sample.docsExamined = docsExamined;
+    sample.nreturned = 1;
+    sample.bytesReturned = 100;
+    return sample;
+}
+
+TEST(QueryStatsStoreTest, AccumulatesSamplesOfTheSameShape) {
+    QueryStatsStore store;
+    const BSONObj shape = BSON("ns"
+                               << "test.coll"
+                               << "query"
+                               << BSON("a" << 1));
+    store.record("a", shape, makeSample(10, 5));
+    store.record("a", BSON("ns"
+                           << "test.coll"
+                           << "query"
+                           << BSON("a" << 2)),
+                 makeSample(30, 7));
+
+    QueryStatsSample getMore = makeSample(20, 3);
+    getMore.isGetMore = true;
+    store.record("a", shape, getMore);
+
+    auto stats = store.getStats();
+    ASSERT_EQ(stats.size(), 1U);
+    const BSONObj& entry = stats[0];
+
+    // The shape of the first sample describes the entry.
+    ASSERT_BSONOBJ_EQ(entry["query"].Obj(), BSON("a" << 1));
+    ASSERT_EQ(entry["execCount"].numberLong(), 2);
+    ASSERT_EQ(entry["getMoreCount"].numberLong(), 1);
+    ASSERT_EQ(entry["docsExamined"].numberLong(), 15);
+    ASSERT_EQ(entry["keysExamined"].numberLong(), 15);
+    ASSERT_EQ(entry["nreturned"].numberLong(), 3);
+    ASSERT_EQ(entry["bytesReturned"].numberLong(), 300);
+
+    const BSONObj reads = entry["latency"]["reads"].Obj();
+    ASSERT_EQ(reads["ops"].numberLong(), 3);
+    ASSERT_EQ(reads["latency"].numberLong(), 60);
+}
+
+TEST(QueryStatsStoreTest, EvictsLeastRecentlyExecutedShape) {
+    const int originalMaxEntries = internalQueryStatsMaxEntries.load();
+    internalQueryStatsMaxEntries.store(2);
+    ON_BLOCK_EXIT([&] { internalQueryStatsMaxEntries.store(originalMaxEntries); });
+
+    QueryStatsStore store;
+    store.record("a", BSON("query" << BSON("a" << 1)), makeSample(1, 1));
+    store.record("b", BSON("query" << BSON("b" << 1)), makeSample(1, 1));
+
+    // Executing 'a' again makes 'b' the least recently executed shape.
+    store.record("a", BSON("query" << BSON("a" << 1)), makeSample(1, 1));
+    store.record("c", BSON("query" << BSON("c" << 1)), makeSample(1, 1));
+    ASSERT_EQ(store.size(), 2U);
+
+    auto stats = store.getStats();
+    ASSERT_EQ(stats.size(), 2U);
+    ASSERT_BSONOBJ_EQ(stats[0]["query"].Obj(), BSON("c" << 1));
+    ASSERT_BSONOBJ_EQ(stats[1]["query"].Obj(), BSON("a" << 1));
+    ASSERT_EQ(stats[1]["execCount"].numberLong(), 2);
+
+    store.clear();
+    ASSERT_EQ(store.size(), 0U);
+}
+
+}  // namespace
+}  // namespace mongo
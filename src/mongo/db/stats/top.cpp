@@ -33,8 +33,12 @@
 
 #include "mongo/db/stats/top.h"
 
+#include <algorithm>
+
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -48,14 +52,35 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+// Whether to record latency percentiles per namespace, which takes about 40KB per namespace and
+// type of operation.
+MONGO_EXPORT_SERVER_PARAMETER(trackNamespaceLatencyPercentiles, bool, false);
+
+// The order in which percentiles are reported, which is that of OperationLatencyHistogram.
+const std::array<Command::ReadWriteType, Top::kNumReadWriteTypes> kReadWriteTypes = {
+    {Command::ReadWriteType::kRead,
+     Command::ReadWriteType::kWrite,
+     Command::ReadWriteType::kCommand,
+     Command::ReadWriteType::kTransaction}};
+
 }  // namespace
 
+constexpr int Top::kNumReadWriteTypes;
+
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
     // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
     time = (newer.time >= older.time) ? (newer.time - older.time) : newer.time;
     count = (newer.count >= older.count) ? (newer.count - older.count) : newer.count;
 }
 
+Top::StorageUsage::StorageUsage(const StorageUsage& older, const StorageUsage& newer) {
+    bytesRead = (newer.bytesRead >= older.bytesRead) ? (newer.bytesRead - older.bytesRead)
+                                                     : newer.bytesRead;
+    timeReadingMicros = (newer.timeReadingMicros >= older.timeReadingMicros)
+        ? (newer.timeReadingMicros - older.timeReadingMicros)
+        : newer.timeReadingMicros;
+}
+
 Top::CollectionData::CollectionData(const CollectionData& older, const CollectionData& newer)
     : total(older.total, newer.total),
       readLock(older.readLock, newer.readLock),
@@ -65,7 +90,8 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       insert(older.insert, newer.insert),
       update(older.update, newer.update),
       remove(older.remove, newer.remove),
-      commands(older.commands, newer.commands) {}
+      commands(older.commands, newer.commands),
+      storage(older.storage, newer.storage) {}
 
 // static
 Top& Top::get(ServiceContext* service) {
@@ -78,7 +104,8 @@ void Top::record(OperationContext* opCtx,
                  LockType lockType,
                  long long micros,
                  bool command,
-                 Command::ReadWriteType readWriteType) {
+                 Command::ReadWriteType readWriteType,
+                 const StorageUsage& storageUsage) {
     if (ns[0] == '?')
         return;
 
@@ -92,6 +119,8 @@ void Top::record(OperationContext* opCtx,
 
     CollectionData& coll = _usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
+    coll.storage.bytesRead += storageUsage.bytesRead;
+    coll.storage.timeReadingMicros += storageUsage.timeReadingMicros;
 }
 
 void Top::_record(OperationContext* opCtx,
@@ -102,6 +131,9 @@ void Top::_record(OperationContext* opCtx,
                   Command::ReadWriteType readWriteType) {
 
     _incrementHistogram(opCtx, micros, &c.opLatencyHistogram, readWriteType);
+    if (trackNamespaceLatencyPercentiles.load()) {
+        _recordLatencyPercentiles(opCtx, micros, &c, readWriteType);
+    }
 
     c.total.inc(micros);
 
@@ -186,6 +218,11 @@ void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
         _appendStatsEntry(b, "remove", coll.remove);
         _appendStatsEntry(b, "commands", coll.commands);
 
+        BSONObjBuilder storageBuilder(b.subobjStart("storage"));
+        storageBuilder.appendNumber("bytesRead", coll.storage.bytesRead);
+        storageBuilder.appendNumber("timeReadingMicros", coll.storage.timeReadingMicros);
+        storageBuilder.done();
+
         bb.done();
     }
 }
@@ -197,20 +234,49 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
     bb.done();
 }
 
-void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
+void Top::appendLatencyStats(OperationContext* opCtx,
+                             StringData ns,
+                             bool includeHistograms,
+                             BSONObjBuilder* builder) {
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
     auto hashedNs = UsageMap::HashedKey(ns);
     stdx::lock_guard<SimpleMutex> lk(_lock);
+    const auto& coll = _usage[hashedNs];
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    coll.opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+
+    const auto& percentiles = coll.latencyPercentiles;
+    if (std::any_of(percentiles.begin(), percentiles.end(), [](const auto& p) { return !!p; })) {
+        BSONObjBuilder percentilesBuilder(latencyStatsBuilder.subobjStart("percentiles"));
+        for (auto type : kReadWriteTypes) {
+            if (const auto& histogram = percentiles[static_cast<int>(type)]) {
+                BSONObjBuilder typeBuilder(
+                    percentilesBuilder.subobjStart(getReadWriteTypeName(type)));
+                histogram->appendSummary(now, &typeBuilder);
+            }
+        }
+    }
+
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
 
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
-                                      Command::ReadWriteType readWriteType) {
+                                      Command::ReadWriteType readWriteType,
+                                      const Command* command) {
+    if (!_isUserOperation(opCtx)) {
+        return;
+    }
+
+    const auto now = opCtx->getServiceContext()->getFastClockSource()->now();
+    _globalLatencyPercentiles[static_cast<int>(readWriteType)].record(latency, now);
+    if (command) {
+        command->recordLatency(latency, now);
+    }
+
     stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    _globalHistogramStats.increment(latency, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
@@ -218,14 +284,59 @@ void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* build
     _globalHistogramStats.append(includeHistograms, builder);
 }
 
+void Top::appendGlobalLatencyPercentiles(Date_t now, BSONObjBuilder* builder) {
+    for (auto type : kReadWriteTypes) {
+        BSONObjBuilder typeBuilder(builder->subobjStart(getReadWriteTypeName(type)));
+        _globalLatencyPercentiles[static_cast<int>(type)].appendSummary(now, &typeBuilder);
+    }
+}
+
+WindowedLatencyHistogram::Summary Top::getGlobalLatencyPercentiles(
+    Command::ReadWriteType readWriteType, Date_t now) const {
+    return _globalLatencyPercentiles[static_cast<int>(readWriteType)].summarize(now);
+}
+
+const char* Top::getReadWriteTypeName(Command::ReadWriteType readWriteType) {
+    switch (readWriteType) {
+        case Command::ReadWriteType::kRead:
+            return "reads";
+        case Command::ReadWriteType::kWrite:
+            return "writes";
+        case Command::ReadWriteType::kCommand:
+            return "commands";
+        case Command::ReadWriteType::kTransaction:
+            return "transactions";
+    }
+    MONGO_UNREACHABLE;
+}
+
+bool Top::_isUserOperation(OperationContext* opCtx) {
+    Client* client = opCtx->getClient();
+    return client->isFromUserConnection() && !client->isInDirectClient();
+}
+
 void Top::_incrementHistogram(OperationContext* opCtx,
                               long long latency,
                               OperationLatencyHistogram* histogram,
                               Command::ReadWriteType readWriteType) {
     // Only update histogram if operation came from a user.
-    Client* client = opCtx->getClient();
-    if (client->isFromUserConnection() && !client->isInDirectClient()) {
+    if (_isUserOperation(opCtx)) {
         histogram->increment(latency, readWriteType);
     }
 }
+
+void Top::_recordLatencyPercentiles(OperationContext* opCtx,
+                                    long long latency,
+                                    CollectionData* c,
+                                    Command::ReadWriteType readWriteType) {
+    if (!_isUserOperation(opCtx)) {
+        return;
+    }
+
+    auto& histogram = c->latencyPercentiles[static_cast<int>(readWriteType)];
+    if (!histogram) {
+        histogram = std::make_shared<WindowedLatencyHistogram>();
+    }
+    histogram->record(latency, opCtx->getServiceContext()->getFastClockSource()->now());
+}
 }  // namespace mongo
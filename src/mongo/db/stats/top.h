@@ -34,6 +34,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/db/stats/windowed_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
 
@@ -50,6 +51,9 @@ public:
 
     Top() = default;
 
+    // The number of values of Command::ReadWriteType.
+    static constexpr int kNumReadWriteTypes = 4;
+
     struct UsageData {
         UsageData() : time(0), count(0) {}
         UsageData(const UsageData& older, const UsageData& newer);
@@ -62,6 +66,19 @@ public:
         }
     };
 
+    /**
+     * Bytes read from the storage engine, and time spent in storage engine reads, by operations.
+     */
+    struct StorageUsage {
+        StorageUsage() = default;
+        StorageUsage(long long bytesRead, long long timeReadingMicros)
+            : bytesRead(bytesRead), timeReadingMicros(timeReadingMicros) {}
+        StorageUsage(const StorageUsage& older, const StorageUsage& newer);
+
+        long long bytesRead = 0;
+        long long timeReadingMicros = 0;
+    };
+
     struct CollectionData {
         /**
          * constructs a diff
@@ -80,7 +97,14 @@ public:
         UsageData update;
         UsageData remove;
         UsageData commands;
+        StorageUsage storage;
         OperationLatencyHistogram opLatencyHistogram;
+
+        // Latencies over the last minute per Command::ReadWriteType, only recorded while
+        // trackNamespaceLatencyPercentiles is set and allocated on first use. Shared by the copies
+        // made by cloneMap().
+        std::array<std::shared_ptr<WindowedLatencyHistogram>, kNumReadWriteTypes>
+            latencyPercentiles;
     };
 
     enum class LockType {
@@ -98,7 +122,8 @@ public:
                 LockType lockType,
                 long long micros,
                 bool command,
-                Command::ReadWriteType readWriteType);
+                Command::ReadWriteType readWriteType,
+                const StorageUsage& storageUsage);
 
     void append(BSONObjBuilder& b);
 
@@ -107,22 +132,46 @@ public:
     void collectionDropped(StringData ns, bool databaseDropped = false);
 
     /**
-     * Appends the collection-level latency statistics
+     * Appends the collection-level latency statistics, including their percentiles over the last
+     * minute if trackNamespaceLatencyPercentiles was set.
      */
-    void appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder);
+    void appendLatencyStats(OperationContext* opCtx,
+                            StringData ns,
+                            bool includeHistograms,
+                            BSONObjBuilder* builder);
 
     /**
-     * Increments the global histogram.
+     * Increments the global histogram, and records the latency for the percentiles of all
+     * operations of this type and those of 'command', if not null.
      */
     void incrementGlobalLatencyStats(OperationContext* opCtx,
                                      uint64_t latency,
-                                     Command::ReadWriteType readWriteType);
+                                     Command::ReadWriteType readWriteType,
+                                     const Command* command = nullptr);
 
     /**
      * Appends the global latency statistics.
      */
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
+    /**
+     * Appends the percentiles of the latencies of all operations over the last minute, per
+     * Command::ReadWriteType.
+     */
+    void appendGlobalLatencyPercentiles(Date_t now, BSONObjBuilder* builder);
+
+    /**
+     * Returns the percentiles of the latencies of all operations of 'readWriteType' over the last
+     * minute.
+     */
+    WindowedLatencyHistogram::Summary getGlobalLatencyPercentiles(
+        Command::ReadWriteType readWriteType, Date_t now) const;
+
+    /**
+     * Returns the field name under which latencies of operations of 'readWriteType' are reported.
+     */
+    static const char* getReadWriteTypeName(Command::ReadWriteType readWriteType);
+
 private:
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
@@ -140,8 +189,18 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
+    void _recordLatencyPercentiles(OperationContext* opCtx,
+                                   long long latency,
+                                   CollectionData* c,
+                                   Command::ReadWriteType readWriteType);
+
+    static bool _isUserOperation(OperationContext* opCtx);
+
     mutable SimpleMutex _lock;
     OperationLatencyHistogram _globalHistogramStats;
+
+    // Not guarded by _lock, since recording into them is thread-safe.
+    std::array<WindowedLatencyHistogram, kNumReadWriteTypes> _globalLatencyPercentiles;
     UsageMap _usage;
     std::string _lastDropped;
 };
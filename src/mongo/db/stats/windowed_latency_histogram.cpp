@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/windowed_latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+constexpr int WindowedLatencyHistogram::kSubBucketBits;
+constexpr int WindowedLatencyHistogram::kSubBucketCount;
+constexpr int WindowedLatencyHistogram::kMaxExponent;
+constexpr int WindowedLatencyHistogram::kNumBuckets;
+constexpr int WindowedLatencyHistogram::kNumSlots;
+constexpr Milliseconds WindowedLatencyHistogram::kSlotDuration;
+
+int WindowedLatencyHistogram::getBucket(uint64_t latencyMicros) {
+    if (latencyMicros < kSubBucketCount) {
+        return static_cast<int>(latencyMicros);
+    }
+
+    const uint64_t maxLatency = (1ULL << (kMaxExponent + 1)) - 1;
+    latencyMicros = std::min(latencyMicros, maxLatency);
+
+    // The top kSubBucketBits bits below the most significant one select the bucket within its
+    // power of two.
+    const int exponent = 63 - countLeadingZeros64(latencyMicros);
+    const int subBucket = static_cast<int>(latencyMicros >> (exponent - kSubBucketBits)) -
+        kSubBucketCount;
+    return (exponent - kSubBucketBits + 1) * kSubBucketCount + subBucket;
+}
+
+uint64_t WindowedLatencyHistogram::getBucketLowerBound(int bucket) {
+    if (bucket < kSubBucketCount) {
+        return bucket;
+    }
+
+    const int exponent = bucket / kSubBucketCount + kSubBucketBits - 1;
+    const uint64_t subBucket = bucket % kSubBucketCount;
+    return (kSubBucketCount + subBucket) << (exponent - kSubBucketBits);
+}
+
+uint64_t WindowedLatencyHistogram::getBucketMidpoint(int bucket) {
+    if (bucket < kSubBucketCount) {
+        return bucket;
+    }
+
+    const int exponent = bucket / kSubBucketCount + kSubBucketBits - 1;
+    const uint64_t width = 1ULL << (exponent - kSubBucketBits);
+    return getBucketLowerBound(bucket) + width / 2;
+}
+
+long long WindowedLatencyHistogram::_getInterval(Date_t now) {
+    return now.toMillisSinceEpoch() / durationCount<Milliseconds>(kSlotDuration);
+}
+
+void WindowedLatencyHistogram::record(uint64_t latencyMicros, Date_t now) {
+    const long long interval = _getInterval(now);
+    Slot& slot = _slots[interval % kNumSlots];
+    if (slot.interval.load() < interval) {
+        _rotate(&slot, interval);
+    }
+
+    // A recorder working with an older time than the slot's only skews the window slightly.
+    slot.counts[getBucket(latencyMicros)].fetchAndAdd(1);
+}
+
+void WindowedLatencyHistogram::_rotate(Slot* slot, long long interval) {
+    stdx::lock_guard<stdx::mutex> lk(_rotationMutex);
+    if (slot->interval.load() >= interval) {
+        return;
+    }
+
+    for (auto& count : slot->counts) {
+        count.store(0);
+    }
+    slot->interval.store(interval);
+}
+
+WindowedLatencyHistogram::Summary WindowedLatencyHistogram::summarize(Date_t now) const {
+    const long long interval = _getInterval(now);
+
+    Summary summary;
+    std::vector<uint64_t> counts(kNumBuckets);
+    for (const auto& slot : _slots) {
+        const long long slotInterval = slot.interval.load();
+        if (slotInterval <= interval - kNumSlots || slotInterval > interval) {
+            continue;
+        }
+
+        for (int i = 0; i < kNumBuckets; i++) {
+            const auto count = slot.counts[i].load();
+            counts[i] += count;
+            summary.ops += count;
+        }
+    }
+
+    if (summary.ops == 0) {
+        return summary;
+    }
+
+    // Each percentile is the middle of the bucket holding the latency of that rank.
+    const std::array<std::pair<double, uint64_t*>, 3> percentiles = {
+        {{0.5, &summary.p50}, {0.99, &summary.p99}, {0.999, &summary.p999}}};
+    auto percentile = percentiles.begin();
+    uint64_t seen = 0;
+    for (int i = 0; i < kNumBuckets && percentile != percentiles.end(); i++) {
+        seen += counts[i];
+        while (percentile != percentiles.end() &&
+               seen >= std::max<uint64_t>(1, std::ceil(percentile->first * summary.ops))) {
+            *percentile->second = getBucketMidpoint(i);
+            ++percentile;
+        }
+    }
+    return summary;
+}
+
+void WindowedLatencyHistogram::appendSummary(Date_t now, BSONObjBuilder* builder) const {
+    const auto summary = summarize(now);
+    builder->append("ops", summary.ops);
+    builder->append("p50", static_cast<long long>(summary.p50));
+    builder->append("p99", static_cast<long long>(summary.p99));
+    builder->append("p999", static_cast<long long>(summary.p999));
+}
+
+}  // namespace mongo
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Records operation latencies and estimates their percentiles over the last minute.
+ *
+ * Latencies are counted in log-linear buckets: below 64 micros every value has its own bucket, and
+ * above that each power of two is split into 64 buckets, so that reporting the middle of a bucket
+ * is within 1% of any latency in it. Latencies of 2^32 micros (about 71 minutes) or more all fall
+ * in the last bucket.
+ *
+ * The window is made of kNumSlots slots of kSlotDuration each. A latency is recorded in the slot of
+ * the time it is recorded at, which is cleared when its time comes around again, and percentiles
+ * are computed over the slots of the last minute. The window therefore covers between 50 and 60
+ * seconds.
+ *
+ * Recording is thread-safe and lock-free, except for the first recording in each slot which clears
+ * it. Readers merge the slots without blocking recorders.
+ */
+class WindowedLatencyHistogram {
+    MONGO_DISALLOW_COPYING(WindowedLatencyHistogram);
+
+public:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 31;
+    static constexpr int kNumBuckets = kSubBucketCount * (kMaxExponent - kSubBucketBits + 2);
+
+    static constexpr int kNumSlots = 6;
+    static constexpr Milliseconds kSlotDuration{10 * 1000};
+
+    /**
+     * Percentile estimates, in micros, over the latencies recorded in the window.
+     */
+    struct Summary {
+        long long ops = 0;
+        uint64_t p50 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+    };
+
+    WindowedLatencyHistogram() = default;
+
+    /**
+     * Returns the bucket counting 'latencyMicros', and the smallest and the middle latency of a
+     * bucket.
+     */
+    static int getBucket(uint64_t latencyMicros);
+    static uint64_t getBucketLowerBound(int bucket);
+    static uint64_t getBucketMidpoint(int bucket);
+
+    /**
+     * Records one latency, at time 'now'.
+     */
+    void record(uint64_t latencyMicros, Date_t now);
+
+    /**
+     * Computes the percentiles of the latencies recorded in the minute up to 'now'.
+     */
+    Summary summarize(Date_t now) const;
+
+    /**
+     * Appends the summary for 'now' as {ops: <n>, p50: <micros>, p99: <micros>, p999: <micros>}.
+     */
+    void appendSummary(Date_t now, BSONObjBuilder* builder) const;
+
+private:
+    struct Slot {
+        // The number of kSlotDuration intervals since the epoch of the time this slot counts, or
+        // -1 if it has never been used.
+        AtomicInt64 interval{-1};
+        std::array<AtomicUInt32, kNumBuckets> counts;
+    };
+
+    static long long _getInterval(Date_t now);
+
+    /**
+     * Clears 'slot' and makes it count 'interval', unless another thread already did.
+     */
+    void _rotate(Slot* slot, long long interval);
+
+    std::array<Slot, kNumSlots> _slots;
+
+    // Serializes the clearing of slots.
+    stdx::mutex _rotationMutex;
+};
+
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/windowed_latency_histogram.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Histogram = WindowedLatencyHistogram;
+
+const Date_t kStart = Date_t::fromMillisSinceEpoch(1000 * 1000 * 1000);
+
+TEST(WindowedLatencyHistogram, BucketsAreContiguous) {
+    ASSERT_EQ(0, Histogram::getBucket(0));
+    ASSERT_EQ(Histogram::kSubBucketCount - 1, Histogram::getBucket(Histogram::kSubBucketCount - 1));
+    for (int i = 1; i < Histogram::kNumBuckets; i++) {
+        const auto lowerBound = Histogram::getBucketLowerBound(i);
+        ASSERT_EQ(i, Histogram::getBucket(lowerBound));
+        ASSERT_EQ(i - 1, Histogram::getBucket(lowerBound - 1));
+    }
+    ASSERT_EQ(Histogram::kNumBuckets - 1, Histogram::getBucket(1ULL << 40));
+}
+
+TEST(WindowedLatencyHistogram, MidpointsAreWithinOnePercent) {
+    for (uint64_t latency = 1; latency < (1ULL << 32); latency = latency * 9 / 8 + 1) {
+        const double midpoint = Histogram::getBucketMidpoint(Histogram::getBucket(latency));
+        ASSERT_LTE(std::abs(midpoint - latency), latency * 0.01) << latency;
+    }
+}
+
+TEST(WindowedLatencyHistogram, EmptyHistogram) {
+    Histogram hist;
+    const auto summary = hist.summarize(kStart);
+    ASSERT_EQ(0, summary.ops);
+    ASSERT_EQ(0U, summary.p50);
+    ASSERT_EQ(0U, summary.p999);
+}
+
+TEST(WindowedLatencyHistogram, Percentiles) {
+    Histogram hist;
+    for (uint64_t latency = 1; latency <= 1000; latency++) {
+        hist.record(latency * 1000, kStart);
+    }
+
+    const auto summary = hist.summarize(kStart);
+    ASSERT_EQ(1000, summary.ops);
+    ASSERT_APPROX_EQUAL(500 * 1000.0, summary.p50, 500 * 10.0);
+    ASSERT_APPROX_EQUAL(990 * 1000.0, summary.p99, 990 * 10.0);
+    ASSERT_APPROX_EQUAL(999 * 1000.0, summary.p999, 999 * 10.0);
+
+    BSONObjBuilder builder;
+    hist.appendSummary(kStart, &builder);
+    const auto obj = builder.obj();
+    ASSERT_EQ(1000, obj["ops"].numberLong());
+    ASSERT_EQ(static_cast<long long>(summary.p99), obj["p99"].numberLong());
+}
+
+TEST(WindowedLatencyHistogram, OutlierSetsTailPercentiles) {
+    Histogram hist;
+    for (int i = 0; i < 999; i++) {
+        hist.record(10, kStart);
+    }
+    hist.record(5 * 1000 * 1000, kStart);
+
+    const auto summary = hist.summarize(kStart);
+    ASSERT_EQ(10U, summary.p50);
+    ASSERT_EQ(10U, summary.p99);
+    ASSERT_EQ(10U, summary.p999);
+
+    hist.record(5 * 1000 * 1000, kStart);
+    ASSERT_APPROX_EQUAL(5 * 1000 * 1000.0, hist.summarize(kStart).p999, 5 * 10 * 1000.0);
+}
+
+TEST(WindowedLatencyHistogram, OldLatenciesLeaveTheWindow) {
+    const auto slot = Histogram::kSlotDuration;
+    Histogram hist;
+    hist.record(100, kStart);
+    hist.record(200, kStart + slot);
+
+    ASSERT_EQ(2, hist.summarize(kStart + slot).ops);
+    ASSERT_EQ(2, hist.summarize(kStart + slot * (Histogram::kNumSlots - 1)).ops);
+
+    auto summary = hist.summarize(kStart + slot * Histogram::kNumSlots);
+    ASSERT_EQ(1, summary.ops);
+    ASSERT_EQ(Histogram::getBucketMidpoint(Histogram::getBucket(200)), summary.p50);
+
+    // Reusing the slot of the first latency clears it.
+    hist.record(300, kStart + slot * Histogram::kNumSlots);
+    summary = hist.summarize(kStart + slot * Histogram::kNumSlots);
+    ASSERT_EQ(2, summary.ops);
+
+    ASSERT_EQ(0, hist.summarize(kStart + slot * (2 * Histogram::kNumSlots + 1)).ops);
+}
+
+TEST(WindowedLatencyHistogram, ConcurrentRecording) {
+    const int kThreads = 4;
+    const int kRecordsPerThread = 10 * 1000;
+    Histogram hist;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&hist, i] {
+            for (int j = 0; j < kRecordsPerThread; j++) {
+                // Spread the records over two slots, so that the second one is cleared while
+                // other threads record.
+                hist.record(i * j, kStart + Histogram::kSlotDuration * (j % 2));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(kThreads * kRecordsPerThread,
+              hist.summarize(kStart + Histogram::kSlotDuration).ops);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,179 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/storage/biggie/biggie_record_store.h"
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+#include "mongo/db/storage/biggie/biggie_sorted_impl.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+namespace biggie {
+
+std::string createKeyPrefix(StringData ident) {
+    std::string prefix = ident.toString();
+    prefix.push_back('\1');
+    return prefix;
+}
+
+std::string createKeyPrefixEnd(StringData ident) {
+    std::string prefixEnd = ident.toString();
+    prefixEnd.push_back('\2');
+    return prefixEnd;
+}
+
+KVEngine::KVEngine() : _master(std::make_shared<StringStore>()) {}
+
+::mongo::RecoveryUnit* KVEngine::newRecoveryUnit() {
+    return new RecoveryUnit(this, [this]() {
+        stdx::lock_guard<stdx::mutex> lk(_journalListenerMutex);
+        JournalListener::Token token = _journalListener->getToken();
+        _journalListener->onDurable(token);
+    });
+}
+
+Status KVEngine::createRecordStore(OperationContext* opCtx,
+                                   StringData ns,
+                                   StringData ident,
+                                   const CollectionOptions& options) {
+    // Register the ident (for `getAllIdents`). The records themselves are only written by the
+    // record store.
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    _idents.insert(ident.toString());
+    return Status::OK();
+}
+
+std::unique_ptr<::mongo::RecordStore> KVEngine::getRecordStore(OperationContext* opCtx,
+                                                               StringData ns,
+                                                               StringData ident,
+                                                               const CollectionOptions& options) {
+    const auto master = getMasterInfo().second;
+    if (options.capped) {
+        return stdx::make_unique<RecordStore>(
+            ns,
+            ident,
+            *master,
+            true,
+            options.cappedSize ? options.cappedSize : 4096,
+            options.cappedMaxDocs ? options.cappedMaxDocs : -1);
+    } else {
+        return stdx::make_unique<RecordStore>(ns, ident, *master);
+    }
+}
+
+Status KVEngine::createSortedDataInterface(OperationContext* opCtx,
+                                           StringData ident,
+                                           const IndexDescriptor* desc) {
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    _idents.insert(ident.toString());
+    return Status::OK();
+}
+
+::mongo::SortedDataInterface* KVEngine::getSortedDataInterface(OperationContext* opCtx,
+                                                               StringData ident,
+                                                               const IndexDescriptor* desc) {
+    const auto keyStringVersion = desc->version() >= IndexDescriptor::IndexVersion::kV2
+        ? KeyString::Version::V1
+        : KeyString::Version::V0;
+    return new SortedDataInterface(Ordering::make(desc->keyPattern()),
+                                   desc->unique(),
+                                   desc->parentNS(),
+                                   desc->indexName(),
+                                   ident,
+                                   keyStringVersion);
+}
+
+Status KVEngine::dropIdent(OperationContext* opCtx, StringData ident) {
+    const std::string prefix = createKeyPrefix(ident);
+    const std::string prefixEnd = createKeyPrefixEnd(ident);
+
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    _idents.erase(ident.toString());
+
+    // Idents are dropped after the unit of work that dropped them committed, so the data is
+    // removed from the master directly. Snapshots taken before the drop are not affected.
+    auto newMaster = std::make_shared<StringStore>(*_master);
+    auto it = newMaster->lower_bound(prefix);
+    while (it != newMaster->end() && it->first < prefixEnd) {
+        const std::string key = it->first;
+        ++it;
+        newMaster->erase(key);
+    }
+
+    _master = std::move(newMaster);
+    ++_masterVersion;
+    return Status::OK();
+}
+
+int64_t KVEngine::getIdentSize(OperationContext* opCtx, StringData ident) {
+    const std::string prefix = createKeyPrefix(ident);
+    const std::string prefixEnd = createKeyPrefixEnd(ident);
+    const auto master = getMasterInfo().second;
+
+    int64_t size = 0;
+    for (auto it = master->lower_bound(prefix); it != master->end() && it->first < prefixEnd;
+         ++it) {
+        size += it->first.size() + it->second.size();
+    }
+    return size;
+}
+
+bool KVEngine::hasIdent(OperationContext* opCtx, StringData ident) const {
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    return _idents.find(ident.toString()) != _idents.end();
+}
+
+std::vector<std::string> KVEngine::getAllIdents(OperationContext* opCtx) const {
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    return std::vector<std::string>(_idents.begin(), _idents.end());
+}
+
+std::pair<uint64_t, std::shared_ptr<StringStore>> KVEngine::getMasterInfo() const {
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    return std::make_pair(_masterVersion, _master);
+}
+
+bool KVEngine::trySwapMaster(StringStore& newMaster, uint64_t version) {
+    stdx::lock_guard<stdx::mutex> lk(_masterLock);
+    if (version != _masterVersion) {
+        return false;
+    }
+
+    _master = std::make_shared<StringStore>(std::move(newMaster));
+    ++_masterVersion;
+    return true;
+}
+
+}  // namespace biggie
+}  // namespace mongo
@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/storage/biggie/store.h"
+#include "mongo/db/storage/journal_listener.h"
+#include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace biggie {
+
+/**
+ * Every record and index entry of the engine lives in a single ordered StringStore, under keys
+ * that begin with the ident of the table they belong to. These return the smallest key of the
+ * table with the given ident and a key that sorts after all keys of that table.
+ */
+std::string createKeyPrefix(StringData ident);
+std::string createKeyPrefixEnd(StringData ident);
+
+/**
+ * An in-memory storage engine that supports document-level concurrency. The current state of all
+ * tables is kept in one immutable master StringStore which recovery units take snapshots of, and
+ * which committing units of work replace as a whole. See biggie::RecoveryUnit.
+ */
+class KVEngine : public ::mongo::KVEngine {
+public:
+    KVEngine();
+
+    ::mongo::RecoveryUnit* newRecoveryUnit() final;
+
+    Status createRecordStore(OperationContext* opCtx,
+                             StringData ns,
+                             StringData ident,
+                             const CollectionOptions& options) final;
+
+    std::unique_ptr<::mongo::RecordStore> getRecordStore(OperationContext* opCtx,
+                                                         StringData ns,
+                                                         StringData ident,
+                                                         const CollectionOptions& options) final;
+
+    Status createSortedDataInterface(OperationContext* opCtx,
+                                     StringData ident,
+                                     const IndexDescriptor* desc) final;
+
+    ::mongo::SortedDataInterface* getSortedDataInterface(OperationContext* opCtx,
+                                                         StringData ident,
+                                                         const IndexDescriptor* desc) final;
+
+    Status beginBackup(OperationContext* opCtx) final {
+        return Status::OK();
+    }
+
+    void endBackup(OperationContext* opCtx) final {}
+
+    Status dropIdent(OperationContext* opCtx, StringData ident) final;
+
+    bool supportsDocLocking() const final {
+        return true;
+    }
+
+    bool supportsDirectoryPerDB() const final {
+        return false;
+    }
+
+    /**
+     * Data stored in memory is not durable.
+     */
+    bool isDurable() const final {
+        return false;
+    }
+
+    bool isEphemeral() const final {
+        return true;
+    }
+
+    int64_t getIdentSize(OperationContext* opCtx, StringData ident) final;
+
+    Status repairIdent(OperationContext* opCtx, StringData ident) final {
+        return Status::OK();
+    }
+
+    Status recoverOrphanedIdent(OperationContext* opCtx,
+                                StringData ns,
+                                StringData ident,
+                                const CollectionOptions& options) final {
+        return createRecordStore(opCtx, ns, ident, options);
+    }
+
+    void cleanShutdown() final {}
+
+    bool hasIdent(OperationContext* opCtx, StringData ident) const final;
+
+    std::vector<std::string> getAllIdents(OperationContext* opCtx) const final;
+
+    void setJournalListener(JournalListener* jl) final {
+        stdx::lock_guard<stdx::mutex> lk(_journalListenerMutex);
+        _journalListener = jl;
+    }
+
+    Timestamp getAllCommittedTimestamp() const final {
+        MONGO_UNREACHABLE;
+    }
+
+    /**
+     * Returns the current master and its version. The returned store is never modified; commits
+     * replace the master instead.
+     */
+    std::pair<uint64_t, std::shared_ptr<StringStore>> getMasterInfo() const;
+
+    /**
+     * Makes 'newMaster' the master if the master has not changed since version 'version' was
+     * obtained from getMasterInfo(), and returns whether it did. 'newMaster' is only moved from
+     * on success.
+     */
+    bool trySwapMaster(StringStore& newMaster, uint64_t version);
+
+private:
+    mutable stdx::mutex _masterLock;
+    std::shared_ptr<StringStore> _master;
+    uint64_t _masterVersion = 0;
+    std::set<std::string> _idents;
+
+    stdx::mutex _journalListenerMutex;
+
+    // Notified when we write as everything is considered "journalled" since repl depends on it.
+    JournalListener* _journalListener = &NoOpJournalListener::instance;
+};
+
+}  // namespace biggie
+}  // namespace mongo
@@ -0,0 +1,592 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/biggie/biggie_record_store.h"
+
+#include <cstring>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+#include "mongo/db/storage/oplog_hack.h"
+#include "mongo/platform/endian.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+const uint64_t kSignBit = 1ULL << 63;
+
+/**
+ * Flipping the sign bit and storing the result big-endian makes the byte-wise order of the
+ * encoded RecordIds match their numeric order, including for negative RecordIds.
+ */
+void appendRecordId(std::string* key, const RecordId& loc) {
+    const uint64_t encoded = endian::nativeToBig(static_cast<uint64_t>(loc.repr()) ^ kSignBit);
+    key->append(reinterpret_cast<const char*>(&encoded), sizeof(encoded));
+}
+
+RecordId extractRecordId(const std::string& key) {
+    invariant(key.size() >= sizeof(uint64_t));
+    uint64_t encoded;
+    std::memcpy(&encoded, key.data() + key.size() - sizeof(encoded), sizeof(encoded));
+    return RecordId(static_cast<int64_t>(endian::bigToNative(encoded) ^ kSignBit));
+}
+
+RecordData toRecordData(const std::string& value) {
+    // The string may be freed by the next write of the operation, so always hand out a copy.
+    return RecordData(value.data(), value.size()).getOwned();
+}
+
+}  // namespace
+
+class RecordStore::SizeAdjuster final : public ::mongo::RecoveryUnit::Change {
+public:
+    SizeAdjuster(RecordStore* rs, int64_t numRecordDiff, int64_t dataSizeDiff)
+        : _rs(rs), _numRecordDiff(numRecordDiff), _dataSizeDiff(dataSizeDiff) {}
+
+    void commit(boost::optional<Timestamp>) final {}
+
+    void rollback() final {
+        _rs->_numRecords.fetchAndSubtract(_numRecordDiff);
+        _rs->_dataSize.fetchAndSubtract(_dataSizeDiff);
+    }
+
+private:
+    RecordStore* const _rs;
+    const int64_t _numRecordDiff;
+    const int64_t _dataSizeDiff;
+};
+
+class RecordStore::NotifyCappedWaitersChange final : public ::mongo::RecoveryUnit::Change {
+public:
+    explicit NotifyCappedWaitersChange(CappedCallback* cappedCallback)
+        : _cappedCallback(cappedCallback) {}
+
+    void commit(boost::optional<Timestamp>) final {
+        _cappedCallback->notifyCappedWaitersIfNeeded();
+    }
+
+    void rollback() final {}
+
+private:
+    CappedCallback* const _cappedCallback;
+};
+
+/**
+ * Remembers the key of the last record it returned rather than an iterator, since the store the
+ * iterator points into may be replaced by the operation's next write or by a new snapshot.
+ */
+class RecordStore::Cursor final : public SeekableRecordCursor {
+public:
+    Cursor(OperationContext* opCtx, const RecordStore& rs, bool forward)
+        : _opCtx(opCtx), _rs(rs), _forward(forward) {}
+
+    boost::optional<Record> next() final {
+        if (_eof) {
+            return {};
+        }
+
+        const StringStore* view = RecoveryUnit::get(_opCtx)->getReadView();
+        if (_forward) {
+            auto it = _lastKey.empty() ? view->lower_bound(_rs._prefix)
+                                       : view->upper_bound(_lastKey);
+            if (it == view->end() || it->first >= _rs._postfix) {
+                _eof = true;
+                return {};
+            }
+            return _positionAt(it);
+        }
+
+        auto it = view->lower_bound(_lastKey.empty() ? _rs._postfix : _lastKey);
+        if (it == view->begin()) {
+            _eof = true;
+            return {};
+        }
+        --it;
+        if (it->first < _rs._prefix) {
+            _eof = true;
+            return {};
+        }
+        return _positionAt(it);
+    }
+
+    boost::optional<Record> seekExact(const RecordId& id) final {
+        const StringStore* view = RecoveryUnit::get(_opCtx)->getReadView();
+        auto it = view->find(_rs._createKey(id));
+        if (it == view->end()) {
+            _eof = true;
+            return {};
+        }
+        _eof = false;
+        return _positionAt(it);
+    }
+
+    void save() final {}
+
+    bool restore() final {
+        if (_eof || _lastKey.empty() || !_rs._isCapped) {
+            return true;
+        }
+
+        // The record we were positioned on was deleted by cappedDeleteAsNeeded() or
+        // cappedTruncateAfter(). It is important that we error out in this case so that consumers
+        // don't silently get 'holes' when scanning capped collections.
+        const StringStore* view = RecoveryUnit::get(_opCtx)->getReadView();
+        return view->find(_lastKey) != view->end();
+    }
+
+    void detachFromOperationContext() final {
+        _opCtx = nullptr;
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _opCtx = opCtx;
+    }
+
+private:
+    Record _positionAt(StringStore::const_iterator it) {
+        _lastKey = it->first;
+        return {extractRecordId(it->first), toRecordData(it->second)};
+    }
+
+    OperationContext* _opCtx;
+    const RecordStore& _rs;
+    const bool _forward;
+    bool _eof = false;
+
+    // Empty until the cursor is first positioned.
+    std::string _lastKey;
+};
+
+RecordStore::RecordStore(StringData ns,
+                         StringData ident,
+                         const StringStore& existingData,
+                         bool isCapped,
+                         int64_t cappedMaxSize,
+                         int64_t cappedMaxDocs,
+                         CappedCallback* cappedCallback)
+    : ::mongo::RecordStore(ns),
+      _isCapped(isCapped),
+      _cappedMaxSize(cappedMaxSize),
+      _cappedMaxDocs(cappedMaxDocs),
+      _cappedCallback(cappedCallback),
+      _ident(ident.toString()),
+      _prefix(createKeyPrefix(ident)),
+      _postfix(createKeyPrefixEnd(ident)),
+      _isOplog(NamespaceString::oplog(ns)) {
+    invariant(!_isCapped || _cappedMaxSize > 0);
+
+    long long numRecords = 0;
+    long long dataSize = 0;
+    for (auto it = existingData.lower_bound(_prefix);
+         it != existingData.end() && it->first < _postfix;
+         ++it) {
+        ++numRecords;
+        dataSize += it->second.size();
+        _highestRecordId.store(extractRecordId(it->first).repr() + 1);
+    }
+    _numRecords.store(numRecords);
+    _dataSize.store(dataSize);
+}
+
+const char* RecordStore::name() const {
+    return "biggie";
+}
+
+const std::string& RecordStore::getIdent() const {
+    return _ident;
+}
+
+long long RecordStore::dataSize(OperationContext* opCtx) const {
+    return _dataSize.load();
+}
+
+long long RecordStore::numRecords(OperationContext* opCtx) const {
+    return _numRecords.load();
+}
+
+bool RecordStore::isCapped() const {
+    return _isCapped;
+}
+
+void RecordStore::setCappedCallback(CappedCallback* cb) {
+    _cappedCallback = cb;
+}
+
+int64_t RecordStore::storageSize(OperationContext* opCtx,
+                                 BSONObjBuilder* extraInfo,
+                                 int infoLevel) const {
+    return _dataSize.load() + _numRecords.load() * (_prefix.size() + sizeof(uint64_t));
+}
+
+bool RecordStore::findRecord(OperationContext* opCtx,
+                             const RecordId& loc,
+                             RecordData* rd) const {
+    const StringStore* view = RecoveryUnit::get(opCtx)->getReadView();
+    auto it = view->find(_createKey(loc));
+    if (it == view->end()) {
+        return false;
+    }
+    *rd = toRecordData(it->second);
+    return true;
+}
+
+void RecordStore::deleteRecord(OperationContext* opCtx, const RecordId& dl) {
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+    auto it = workingCopy->find(_createKey(dl));
+    invariant(it != workingCopy->end());
+
+    const int64_t len = it->second.size();
+    workingCopy->erase(it->first);
+    _changeNumRecordsAndDataSize(opCtx, -1, -len);
+}
+
+StatusWith<RecordId> RecordStore::insertRecord(
+    OperationContext* opCtx, const char* data, int len, Timestamp, bool enforceQuota) {
+    RecordId loc;
+    Status status = _insert(opCtx, data, len, &loc);
+    if (!status.isOK()) {
+        return status;
+    }
+    return loc;
+}
+
+Status RecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
+                                               const DocWriter* const* docs,
+                                               const Timestamp*,
+                                               size_t nDocs,
+                                               RecordId* idsOut) {
+    for (size_t i = 0; i < nDocs; i++) {
+        const size_t len = docs[i]->documentSize();
+        std::string buf(len, '\0');
+        docs[i]->writeDocument(&buf[0]);
+
+        RecordId loc;
+        Status status = _insert(opCtx, buf.data(), len, &loc);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (idsOut) {
+            idsOut[i] = loc;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status RecordStore::updateRecord(OperationContext* opCtx,
+                                 const RecordId& oldLocation,
+                                 const char* data,
+                                 int len,
+                                 bool enforceQuota,
+                                 UpdateNotifier* notifier) {
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+    const std::string key = _createKey(oldLocation);
+    auto it = workingCopy->find(key);
+    invariant(it != workingCopy->end());
+
+    const int64_t oldLen = it->second.size();
+
+    // Documents in capped collections cannot change size. We check that above the storage layer.
+    invariant(!_isCapped || len == oldLen);
+
+    workingCopy->erase(key);
+    workingCopy->insert(StringStore::value_type(key, std::string(data, len)));
+    _changeNumRecordsAndDataSize(opCtx, 0, len - oldLen);
+
+    _cappedDeleteAsNeeded(opCtx);
+    return Status::OK();
+}
+
+bool RecordStore::updateWithDamagesSupported() const {
+    return true;
+}
+
+StatusWith<RecordData> RecordStore::updateWithDamages(OperationContext* opCtx,
+                                                      const RecordId& loc,
+                                                      const RecordData& oldRec,
+                                                      const char* damageSource,
+                                                      const mutablebson::DamageVector& damages) {
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+    const std::string key = _createKey(loc);
+    auto it = workingCopy->find(key);
+    invariant(it != workingCopy->end());
+
+    std::string newValue = it->second;
+    for (const auto& damage : damages) {
+        std::memcpy(&newValue[damage.targetOffset],
+                    damageSource + damage.sourceOffset,
+                    damage.size);
+    }
+
+    RecordData newRec = toRecordData(newValue);
+    workingCopy->erase(key);
+    workingCopy->insert(StringStore::value_type(key, std::move(newValue)));
+    return newRec;
+}
+
+std::unique_ptr<SeekableRecordCursor> RecordStore::getCursor(OperationContext* opCtx,
+                                                             bool forward) const {
+    return stdx::make_unique<Cursor>(opCtx, *this, forward);
+}
+
+Status RecordStore::truncate(OperationContext* opCtx) {
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+
+    int64_t numRecordsRemoved = 0;
+    int64_t dataSizeRemoved = 0;
+    auto it = workingCopy->lower_bound(_prefix);
+    while (it != workingCopy->end() && it->first < _postfix) {
+        const std::string key = it->first;
+        ++numRecordsRemoved;
+        dataSizeRemoved += it->second.size();
+        ++it;
+        workingCopy->erase(key);
+    }
+
+    _changeNumRecordsAndDataSize(opCtx, -numRecordsRemoved, -dataSizeRemoved);
+    return Status::OK();
+}
+
+void RecordStore::cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) {
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+
+    const std::string endKey = _createKey(end);
+    auto it = inclusive ? workingCopy->lower_bound(endKey) : workingCopy->upper_bound(endKey);
+    while (it != workingCopy->end() && it->first < _postfix) {
+        const std::string key = it->first;
+        const int64_t len = it->second.size();
+
+        if (_cappedCallback) {
+            uassertStatusOK(_cappedCallback->aboutToDeleteCapped(
+                opCtx, extractRecordId(key), RecordData(it->second.data(), len)));
+        }
+
+        ++it;
+        workingCopy->erase(key);
+        _changeNumRecordsAndDataSize(opCtx, -1, -len);
+    }
+}
+
+Status RecordStore::validate(OperationContext* opCtx,
+                             ValidateCmdLevel level,
+                             ValidateAdaptor* adaptor,
+                             ValidateResults* results,
+                             BSONObjBuilder* output) {
+    results->valid = true;
+
+    const StringStore* view = RecoveryUnit::get(opCtx)->getReadView();
+    long long numRecords = 0;
+    for (auto it = view->lower_bound(_prefix); it != view->end() && it->first < _postfix; ++it) {
+        ++numRecords;
+        size_t dataSize;
+        const Status status = adaptor->validate(extractRecordId(it->first),
+                                                RecordData(it->second.data(), it->second.size()),
+                                                &dataSize);
+        if (!status.isOK()) {
+            if (results->valid) {
+                // Only log once.
+                results->errors.push_back("detected one or more invalid documents (see logs)");
+            }
+            results->valid = false;
+            log() << "Invalid object detected in " << _ns << ": " << status.reason();
+        }
+    }
+
+    output->appendNumber("nrecords", numRecords);
+
+    return Status::OK();
+}
+
+void RecordStore::appendCustomStats(OperationContext* opCtx,
+                                    BSONObjBuilder* result,
+                                    double scale) const {
+    result->appendBool("capped", _isCapped);
+    if (_isCapped) {
+        result->appendIntOrLL("max", _cappedMaxDocs);
+        result->appendIntOrLL("maxSize", _cappedMaxSize / scale);
+    }
+}
+
+Status RecordStore::touch(OperationContext* opCtx, BSONObjBuilder* output) const {
+    if (output) {
+        output->append("numRanges", 1);
+        output->append("millis", 0);
+    }
+    return Status::OK();
+}
+
+boost::optional<RecordId> RecordStore::oplogStartHack(OperationContext* opCtx,
+                                                      const RecordId& startingPosition) const {
+    if (!_isOplog) {
+        return boost::none;
+    }
+
+    const StringStore* view = RecoveryUnit::get(opCtx)->getReadView();
+    auto it = view->upper_bound(_createKey(startingPosition));
+    if (it == view->begin()) {
+        return RecordId();
+    }
+    --it;
+
+    // If the startingPosition is before the oldest oplog entry, this ensures that we return
+    // RecordId() as specified in record_store.h.
+    if (it->first < _prefix) {
+        return RecordId();
+    }
+    return extractRecordId(it->first);
+}
+
+void RecordStore::updateStatsAfterRepair(OperationContext* opCtx,
+                                         long long numRecords,
+                                         long long dataSize) {
+    _numRecords.store(numRecords);
+    _dataSize.store(dataSize);
+}
+
+std::string RecordStore::_createKey(const RecordId& loc) const {
+    std::string key(_prefix);
+    appendRecordId(&key, loc);
+    return key;
+}
+
+StatusWith<RecordId> RecordStore::_nextLoc(const char* data,
+                                           int len,
+                                           const StringStore& workingCopy) {
+    if (!_isOplog) {
+        RecordId out(_highestRecordId.fetchAndAdd(1));
+        invariant(out < RecordId::max());
+        return out;
+    }
+
+    StatusWith<RecordId> status = oploghack::extractKey(data, len);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    auto it = workingCopy.lower_bound(_postfix);
+    if (it != workingCopy.begin() && (--it)->first >= _prefix) {
+        const RecordId lastLoc = extractRecordId(it->first);
+        if (status.getValue() <= lastLoc) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "attempted out-of-order oplog insert of "
+                                  << status.getValue()
+                                  << " (oplog last insert was "
+                                  << lastLoc
+                                  << " )"};
+        }
+    }
+    return status;
+}
+
+Status RecordStore::_insert(OperationContext* opCtx, const char* data, int len, RecordId* out) {
+    if (_isCapped && len > _cappedMaxSize) {
+        // We use dataSize for capped rollover and we don't want to delete everything if we know
+        // this won't fit.
+        return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
+    }
+
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+    StatusWith<RecordId> loc = _nextLoc(data, len, *workingCopy);
+    if (!loc.isOK()) {
+        return loc.getStatus();
+    }
+
+    auto result = workingCopy->insert(
+        StringStore::value_type(_createKey(loc.getValue()), std::string(data, len)));
+    invariant(result.second);
+    _changeNumRecordsAndDataSize(opCtx, 1, len);
+
+    if (_isCapped && _cappedCallback) {
+        opCtx->recoveryUnit()->registerChange(new NotifyCappedWaitersChange(_cappedCallback));
+    }
+
+    _cappedDeleteAsNeeded(opCtx);
+
+    *out = loc.getValue();
+    return Status::OK();
+}
+
+void RecordStore::_changeNumRecordsAndDataSize(OperationContext* opCtx,
+                                               int64_t numRecordDiff,
+                                               int64_t dataSizeDiff) {
+    opCtx->recoveryUnit()->registerChange(new SizeAdjuster(this, numRecordDiff, dataSizeDiff));
+    _numRecords.fetchAndAdd(numRecordDiff);
+    _dataSize.fetchAndAdd(dataSizeDiff);
+}
+
+bool RecordStore::_cappedAndNeedDelete(OperationContext* opCtx) const {
+    if (!_isCapped)
+        return false;
+
+    if (_dataSize.load() > _cappedMaxSize)
+        return true;
+
+    if ((_cappedMaxDocs != -1) && (numRecords(opCtx) > _cappedMaxDocs))
+        return true;
+
+    return false;
+}
+
+void RecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx) {
+    while (_cappedAndNeedDelete(opCtx)) {
+        StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+        auto oldest = workingCopy->lower_bound(_prefix);
+        if (oldest == workingCopy->end() || oldest->first >= _postfix) {
+            // The counters include the writes of concurrent units of work, which are not visible
+            // to this one.
+            break;
+        }
+
+        const std::string key = oldest->first;
+        const int64_t len = oldest->second.size();
+
+        if (_cappedCallback) {
+            uassertStatusOK(_cappedCallback->aboutToDeleteCapped(
+                opCtx, extractRecordId(key), RecordData(oldest->second.data(), len)));
+        }
+
+        workingCopy->erase(key);
+        _changeNumRecordsAndDataSize(opCtx, -1, -len);
+    }
+}
+
+}  // namespace biggie
+}  // namespace mongo
@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/db/storage/biggie/store.h"
+#include "mongo/db/storage/capped_callback.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace biggie {
+
+/**
+ * A RecordStore that keeps its records in the StringStore of the biggie engine, under the key
+ * prefix of its ident followed by the RecordId encoded so that keys sort in RecordId order.
+ *
+ * The record count and data size are kept in memory and adjusted as soon as a write happens, with
+ * a registered change undoing the adjustment if the unit of work rolls back.
+ */
+class RecordStore : public ::mongo::RecordStore {
+public:
+    /**
+     * 'existingData' is used to initialize the record count, data size and the next RecordId to
+     * hand out when the ident already holds records.
+     */
+    RecordStore(StringData ns,
+                StringData ident,
+                const StringStore& existingData,
+                bool isCapped = false,
+                int64_t cappedMaxSize = -1,
+                int64_t cappedMaxDocs = -1,
+                CappedCallback* cappedCallback = nullptr);
+
+    const char* name() const override;
+    const std::string& getIdent() const override;
+    long long dataSize(OperationContext* opCtx) const override;
+    long long numRecords(OperationContext* opCtx) const override;
+    bool isCapped() const override;
+    void setCappedCallback(CappedCallback* cb) override;
+    int64_t storageSize(OperationContext* opCtx,
+                        BSONObjBuilder* extraInfo = NULL,
+                        int infoLevel = 0) const override;
+
+    bool findRecord(OperationContext* opCtx, const RecordId& loc, RecordData* rd) const override;
+
+    void deleteRecord(OperationContext* opCtx, const RecordId& dl) override;
+
+    StatusWith<RecordId> insertRecord(OperationContext* opCtx,
+                                      const char* data,
+                                      int len,
+                                      Timestamp timestamp,
+                                      bool enforceQuota) override;
+
+    Status insertRecordsWithDocWriter(OperationContext* opCtx,
+                                      const DocWriter* const* docs,
+                                      const Timestamp* timestamps,
+                                      size_t nDocs,
+                                      RecordId* idsOut) override;
+
+    Status updateRecord(OperationContext* opCtx,
+                        const RecordId& oldLocation,
+                        const char* data,
+                        int len,
+                        bool enforceQuota,
+                        UpdateNotifier* notifier) override;
+
+    bool updateWithDamagesSupported() const override;
+
+    StatusWith<RecordData> updateWithDamages(OperationContext* opCtx,
+                                             const RecordId& loc,
+                                             const RecordData& oldRec,
+                                             const char* damageSource,
+                                             const mutablebson::DamageVector& damages) override;
+
+    std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* opCtx,
+                                                    bool forward) const final;
+
+    Status truncate(OperationContext* opCtx) override;
+
+    void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) override;
+
+    Status validate(OperationContext* opCtx,
+                    ValidateCmdLevel level,
+                    ValidateAdaptor* adaptor,
+                    ValidateResults* results,
+                    BSONObjBuilder* output) override;
+
+    void appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* result,
+                           double scale) const override;
+
+    Status touch(OperationContext* opCtx, BSONObjBuilder* output) const override;
+
+    boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
+                                             const RecordId& startingPosition) const override;
+
+    void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const override {}
+
+    void updateStatsAfterRepair(OperationContext* opCtx,
+                                long long numRecords,
+                                long long dataSize) override;
+
+private:
+    class Cursor;
+    class SizeAdjuster;
+    class NotifyCappedWaitersChange;
+
+    std::string _createKey(const RecordId& loc) const;
+    StatusWith<RecordId> _nextLoc(const char* data, int len, const StringStore& workingCopy);
+    Status _insert(OperationContext* opCtx, const char* data, int len, RecordId* out);
+
+    void _changeNumRecordsAndDataSize(OperationContext* opCtx,
+                                      int64_t numRecordDiff,
+                                      int64_t dataSizeDiff);
+
+    bool _cappedAndNeedDelete(OperationContext* opCtx) const;
+    void _cappedDeleteAsNeeded(OperationContext* opCtx);
+
+    const bool _isCapped;
+    const int64_t _cappedMaxSize;
+    const int64_t _cappedMaxDocs;
+    CappedCallback* _cappedCallback;
+
+    const std::string _ident;
+    const std::string _prefix;
+    const std::string _postfix;
+
+    const bool _isOplog;
+
+    AtomicInt64 _highestRecordId{1};
+    AtomicInt64 _numRecords{0};
+    AtomicInt64 _dataSize{0};
+};
+
+}  // namespace biggie
+}  // namespace mongo
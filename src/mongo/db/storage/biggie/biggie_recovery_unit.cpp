@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+
+#include "mongo/base/checked_cast.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+// SnapshotIds need to be globally unique, as they are used in a WorkingSetMember to determine if
+// documents changed between yields.
+AtomicUInt64 nextSnapshotId{1};
+
+}  // namespace
+
+RecoveryUnit::RecoveryUnit(KVEngine* parentKVEngine, stdx::function<void()> cb)
+    : _waitUntilDurableCallback(cb),
+      _KVEngine(parentKVEngine),
+      _mySnapshotId(nextSnapshotId.fetchAndAdd(1)) {}
+
+RecoveryUnit::~RecoveryUnit() {
+    invariant(!_inUnitOfWork);
+    _abort();
+}
+
+void RecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {
+    invariant(!_inUnitOfWork);
+    _inUnitOfWork = true;
+}
+
+void RecoveryUnit::commitUnitOfWork() {
+    invariant(_inUnitOfWork);
+
+    if (_dirty) {
+        invariant(_mergeBase);
+        while (true) {
+            auto masterInfo = _KVEngine->getMasterInfo();
+            if (masterInfo.first == _mergeBaseVersion) {
+                // Nothing was published since the snapshot was taken, so the working copy can
+                // become the master as is.
+                if (_KVEngine->trySwapMaster(_workingCopy, masterInfo.first)) {
+                    break;
+                }
+                continue;
+            }
+
+            StringStore merged;
+            try {
+                merged = _workingCopy.merge3(*_mergeBase, *masterInfo.second);
+            } catch (const merge_conflict_exception&) {
+                // The unit of work is left as is, so that the WriteUnitOfWork rolls back the
+                // registered changes when it is destroyed.
+                throw WriteConflictException();
+            }
+
+            if (_KVEngine->trySwapMaster(merged, masterInfo.first)) {
+                break;
+            }
+        }
+    }
+
+    try {
+        for (auto& change : _changes) {
+            change->commit(boost::none);
+        }
+        _changes.clear();
+    } catch (...) {
+        std::terminate();
+    }
+
+    _inUnitOfWork = false;
+    _resetSnapshot();
+
+    // This ensures that the journal listener gets called on each commit.
+    waitUntilDurable();
+}
+
+void RecoveryUnit::abortUnitOfWork() {
+    invariant(_inUnitOfWork);
+    _inUnitOfWork = false;
+    _abort();
+}
+
+bool RecoveryUnit::waitUntilDurable() {
+    if (_waitUntilDurableCallback) {
+        _waitUntilDurableCallback();
+    }
+    return true;
+}
+
+void RecoveryUnit::abandonSnapshot() {
+    invariant(!_inUnitOfWork);
+    _resetSnapshot();
+}
+
+void RecoveryUnit::registerChange(Change* change) {
+    _changes.push_back(std::unique_ptr<Change>(change));
+}
+
+SnapshotId RecoveryUnit::getSnapshotId() const {
+    return SnapshotId(_mySnapshotId);
+}
+
+const StringStore* RecoveryUnit::getReadView() {
+    if (_dirty) {
+        return &_workingCopy;
+    }
+    _forkIfNeeded();
+    return _mergeBase.get();
+}
+
+StringStore* RecoveryUnit::getWriteView() {
+    invariant(_inUnitOfWork);
+    if (!_dirty) {
+        _forkIfNeeded();
+        _workingCopy = *_mergeBase;
+        _dirty = true;
+    }
+    return &_workingCopy;
+}
+
+RecoveryUnit* RecoveryUnit::get(OperationContext* opCtx) {
+    return checked_cast<biggie::RecoveryUnit*>(opCtx->recoveryUnit());
+}
+
+void RecoveryUnit::_forkIfNeeded() {
+    if (_mergeBase) {
+        return;
+    }
+
+    auto masterInfo = _KVEngine->getMasterInfo();
+    _mergeBaseVersion = masterInfo.first;
+    _mergeBase = std::move(masterInfo.second);
+}
+
+void RecoveryUnit::_abort() {
+    try {
+        for (auto it = _changes.rbegin(), end = _changes.rend(); it != end; ++it) {
+            auto& change = *it;
+            LOG(2) << "CUSTOM ROLLBACK " << redact(demangleName(typeid(*change)));
+            change->rollback();
+        }
+        _changes.clear();
+    } catch (...) {
+        std::terminate();
+    }
+
+    _resetSnapshot();
+}
+
+void RecoveryUnit::_resetSnapshot() {
+    _dirty = false;
+    _workingCopy.clear();
+    _mergeBase.reset();
+    _mySnapshotId = nextSnapshotId.fetchAndAdd(1);
+}
+
+}  // namespace biggie
+}  // namespace mongo
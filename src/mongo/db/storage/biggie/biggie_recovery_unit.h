@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/biggie/store.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/stdx/functional.h"
+
+namespace mongo {
+namespace biggie {
+
+class KVEngine;
+
+/**
+ * Gives each operation a consistent snapshot of the engine's master StringStore.
+ *
+ * Reads are served from the snapshot that was current when the operation first touched the
+ * engine. The first write of a unit of work copies that snapshot into a private working copy, and
+ * committing publishes the working copy as the new master. If another unit of work has published
+ * in the meantime, the two sets of changes are combined with a three-way merge against the
+ * snapshot, and conflicting changes surface as a WriteConflictException.
+ */
+class RecoveryUnit : public ::mongo::RecoveryUnit {
+public:
+    RecoveryUnit(KVEngine* parentKVEngine, stdx::function<void()> cb = nullptr);
+    ~RecoveryUnit();
+
+    void beginUnitOfWork(OperationContext* opCtx) final;
+    void commitUnitOfWork() final;
+    void abortUnitOfWork() final;
+
+    bool waitUntilDurable() override;
+
+    void abandonSnapshot() override;
+
+    void registerChange(Change* change) override;
+
+    SnapshotId getSnapshotId() const override;
+
+    void setOrderedCommit(bool orderedCommit) override {}
+
+    /**
+     * Returns the data visible to this operation: its working copy once it has written, and the
+     * snapshot of the master otherwise. The returned store may change after any write, so callers
+     * must not hold on to iterators into it across calls that may write.
+     */
+    const StringStore* getReadView();
+
+    /**
+     * Returns the working copy that writes of the current unit of work go to. Must only be called
+     * inside of a unit of work.
+     */
+    StringStore* getWriteView();
+
+    static RecoveryUnit* get(OperationContext* opCtx);
+
+private:
+    void _forkIfNeeded();
+
+    void _abort();
+
+    void _resetSnapshot();
+
+    stdx::function<void()> _waitUntilDurableCallback;
+    KVEngine* const _KVEngine;
+
+    std::vector<std::unique_ptr<Change>> _changes;
+
+    bool _inUnitOfWork = false;
+
+    // True once '_workingCopy' has been populated from '_mergeBase' by the first write.
+    bool _dirty = false;
+
+    // The snapshot of the master this operation reads from, and its version. Null until the
+    // first access after the snapshot was last reset.
+    std::shared_ptr<StringStore> _mergeBase;
+    uint64_t _mergeBaseVersion = 0;
+
+    StringStore _workingCopy;
+
+    uint64_t _mySnapshotId;
+};
+
+}  // namespace biggie
+}  // namespace mongo
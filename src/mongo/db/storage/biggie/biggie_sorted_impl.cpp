@@ -0,0 +1,448 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/biggie/biggie_sorted_impl.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+#include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/bufreader.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+const int TempKeyMaxSize = 1024;  // this goes away with SERVER-3372
+
+bool hasFieldNames(const BSONObj& obj) {
+    BSONForEach(e, obj) {
+        if (e.fieldName()[0])
+            return true;
+    }
+    return false;
+}
+
+BSONObj stripFieldNames(const BSONObj& query) {
+    if (!hasFieldNames(query))
+        return query;
+
+    BSONObjBuilder bb;
+    BSONForEach(e, query) {
+        bb.appendAs(e, StringData());
+    }
+    return bb.obj();
+}
+
+Status checkKeySize(const BSONObj& key) {
+    if (key.objsize() >= TempKeyMaxSize) {
+        return Status(ErrorCodes::KeyTooLong,
+                      str::stream() << "biggie::SortedDataInterface::insert: key too large to "
+                                       "index, failing "
+                                    << key.objsize()
+                                    << ' '
+                                    << key);
+    }
+    return Status::OK();
+}
+
+bool startsWith(const std::string& str, const std::string& prefix) {
+    return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+}  // namespace
+
+SortedDataBuilderInterface::SortedDataBuilderInterface(OperationContext* opCtx,
+                                                       SortedDataInterface* index,
+                                                       bool dupsAllowed,
+                                                       Ordering order)
+    : _opCtx(opCtx), _index(index), _dupsAllowed(dupsAllowed), _order(order) {}
+
+Status SortedDataBuilderInterface::addKey(const BSONObj& key, const RecordId& loc) {
+    // _previousKey.isEmpty() is only true on the first call to addKey().
+    // key must be >= the last key
+    invariant(_previousKey.isEmpty() || key.woCompare(_previousKey, _order) >= 0);
+
+    Status status = _index->insert(_opCtx, key, loc, _dupsAllowed);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    _previousKey = key.getOwned();
+    return Status::OK();
+}
+
+/**
+ * Like the WiredTiger index cursor, this keeps its position as the stored key it is positioned
+ * on, and repositions from that key on every move since the store may be replaced by the
+ * operation's next write or by a new snapshot.
+ */
+class SortedDataInterface::Cursor final : public ::mongo::SortedDataInterface::Cursor {
+public:
+    Cursor(OperationContext* opCtx, const SortedDataInterface& index, bool forward)
+        : _opCtx(opCtx),
+          _index(index),
+          _forward(forward),
+          _typeBits(index._keyStringVersion) {}
+
+    boost::optional<IndexKeyEntry> next(RequestedInfo parts) override {
+        // Advance on a cursor at the end is a no-op
+        if (_eof)
+            return {};
+
+        if (!_lastMoveWasRestore) {
+            const StringStore* view = RecoveryUnit::get(_opCtx)->getReadView();
+            if (_forward) {
+                _positionAt(view, view->upper_bound(_key));
+            } else {
+                _positionBefore(view, view->lower_bound(_key));
+            }
+        }
+        _lastMoveWasRestore = false;
+        return _curr(parts);
+    }
+
+    void setEndPosition(const BSONObj& key, bool inclusive) override {
+        if (key.isEmpty()) {
+            // This means scan to end of index.
+            _endPosition.reset();
+            return;
+        }
+
+        // NOTE: this uses the opposite rules as a normal seek because a forward scan should
+        // end after the key if inclusive and before if exclusive.
+        const auto discriminator =
+            _forward == inclusive ? KeyString::kExclusiveAfter : KeyString::kExclusiveBefore;
+        _endPosition = stdx::make_unique<KeyString>(_index._keyStringVersion);
+        _endPosition->resetToKey(stripFieldNames(key), _index._order, discriminator);
+    }
+
+    boost::optional<IndexKeyEntry> seek(const BSONObj& key,
+                                        bool inclusive,
+                                        RequestedInfo parts) override {
+        const BSONObj finalKey = stripFieldNames(key);
+        const auto discriminator =
+            _forward == inclusive ? KeyString::kExclusiveBefore : KeyString::kExclusiveAfter;
+
+        // By using a discriminator other than kInclusive, the query sorts before or after all
+        // entries for the key, whatever their RecordIds.
+        const KeyString query(_index._keyStringVersion, finalKey, _index._order, discriminator);
+        _seek(_index._prefix + std::string(query.getBuffer(), query.getSize()));
+        return _curr(parts);
+    }
+
+    boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
+                                        RequestedInfo parts) override {
+        BSONObj key = IndexEntryComparison::makeQueryObject(seekPoint, _forward);
+
+        // makeQueryObject handles the discriminator in the real exclusive cases.
+        const auto discriminator =
+            _forward ? KeyString::kExclusiveBefore : KeyString::kExclusiveAfter;
+        const KeyString query(_index._keyStringVersion, key, _index._order, discriminator);
+        _seek(_index._prefix + std::string(query.getBuffer(), query.getSize()));
+        return _curr(parts);
+    }
+
+    void save() override {
+        // Our saved position is wherever we were when we last moved.
+    }
+
+    void saveUnpositioned() override {
+        save();
+        _eof = true;
+    }
+
+    void restore() override {
+        if (!_eof) {
+            // The key includes the RecordId, so landing on it again means nothing changed at our
+            // position. Otherwise we are now on the entry that follows it, which next() must
+            // return rather than skip.
+            _lastMoveWasRestore = !_seek(_key);
+        }
+    }
+
+    void detachFromOperationContext() final {
+        _opCtx = nullptr;
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _opCtx = opCtx;
+    }
+
+private:
+    /**
+     * Positions the cursor on the first entry at or after 'query' for forward cursors, and on the
+     * last entry at or before it for reverse cursors. Returns true on exact match.
+     */
+    bool _seek(const std::string& query) {
+        _lastMoveWasRestore = false;
+        const StringStore* view = RecoveryUnit::get(_opCtx)->getReadView();
+        if (_forward) {
+            _positionAt(view, view->lower_bound(query));
+        } else {
+            _positionBefore(view, view->upper_bound(query));
+        }
+        return !_eof && _key == query;
+    }
+
+    void _positionBefore(const StringStore* view, StringStore::const_iterator it) {
+        if (it == view->begin()) {
+            _setEof();
+            return;
+        }
+        _positionAt(view, --it);
+    }
+
+    void _positionAt(const StringStore* view, StringStore::const_iterator it) {
+        if (it == view->end() || it->first < _index._prefix || it->first >= _index._postfix) {
+            _setEof();
+            return;
+        }
+
+        _eof = false;
+        _key = it->first;
+
+        if (_atOrPastEndPoint()) {
+            _eof = true;
+            return;
+        }
+
+        const char* keyBuffer = _key.data() + _index._prefix.size();
+        const size_t keySize = _key.size() - _index._prefix.size();
+        _id = KeyString::decodeRecordIdAtEnd(keyBuffer, keySize);
+
+        BufReader br(it->second.data(), it->second.size());
+        _typeBits.resetFromBuffer(&br);
+    }
+
+    void _setEof() {
+        _eof = true;
+        _id = RecordId();
+    }
+
+    bool _atOrPastEndPoint() const {
+        if (!_endPosition)
+            return false;
+
+        const StringData key = StringData(_key).substr(_index._prefix.size());
+        const int cmp = key.compare(StringData(_endPosition->getBuffer(), _endPosition->getSize()));
+
+        // We set up _endPosition to be in between the last in-range value and the first
+        // out-of-range value. In particular, it is constructed to never equal any legal index
+        // key.
+        dassert(cmp != 0);
+
+        if (_forward) {
+            // We may have landed after the end point.
+            return cmp > 0;
+        } else {
+            // We may have landed before the end point.
+            return cmp < 0;
+        }
+    }
+
+    boost::optional<IndexKeyEntry> _curr(RequestedInfo parts) const {
+        if (_eof)
+            return {};
+
+        BSONObj bson;
+        if (parts & kWantKey) {
+            bson = KeyString::toBson(_key.data() + _index._prefix.size(),
+                                     _key.size() - _index._prefix.size(),
+                                     _index._order,
+                                     _typeBits);
+        }
+
+        return {{std::move(bson), _id}};
+    }
+
+    OperationContext* _opCtx;
+    const SortedDataInterface& _index;
+    const bool _forward;
+
+    // These are where this cursor instance is. '_key' is the full key in the store, including the
+    // ident prefix.
+    std::string _key;
+    KeyString::TypeBits _typeBits;
+    RecordId _id;
+    bool _eof = true;
+
+    // For handling cursor restores.
+    bool _lastMoveWasRestore = false;
+
+    std::unique_ptr<KeyString> _endPosition;
+};
+
+SortedDataInterface::SortedDataInterface(const Ordering& ordering,
+                                         bool isUnique,
+                                         StringData ns,
+                                         StringData indexName,
+                                         StringData ident,
+                                         KeyString::Version keyStringVersion)
+    : _order(ordering),
+      _isUnique(isUnique),
+      _collectionNamespace(ns.toString()),
+      _indexName(indexName.toString()),
+      _prefix(createKeyPrefix(ident)),
+      _postfix(createKeyPrefixEnd(ident)),
+      _keyStringVersion(keyStringVersion) {}
+
+::mongo::SortedDataBuilderInterface* SortedDataInterface::getBulkBuilder(OperationContext* opCtx,
+                                                                         bool dupsAllowed) {
+    return new SortedDataBuilderInterface(opCtx, this, dupsAllowed, _order);
+}
+
+Status SortedDataInterface::insert(OperationContext* opCtx,
+                                   const BSONObj& key,
+                                   const RecordId& loc,
+                                   bool dupsAllowed) {
+    invariant(loc.isNormal());
+    dassert(!hasFieldNames(key));
+
+    Status s = checkKeySize(key);
+    if (!s.isOK())
+        return s;
+
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+    if (!dupsAllowed && _hasOtherEntry(*workingCopy, key, loc)) {
+        return _dupKeyError(key);
+    }
+
+    const KeyString keyString(_keyStringVersion, key, _order, loc);
+    const KeyString::TypeBits& typeBits = keyString.getTypeBits();
+    std::string value;
+    if (!typeBits.isAllZeros()) {
+        value.assign(reinterpret_cast<const char*>(typeBits.getBuffer()), typeBits.getSize());
+    }
+
+    // Inserting an entry that already exists is a no-op.
+    workingCopy->insert(StringStore::value_type(
+        _prefix + std::string(keyString.getBuffer(), keyString.getSize()), std::move(value)));
+    return Status::OK();
+}
+
+void SortedDataInterface::unindex(OperationContext* opCtx,
+                                  const BSONObj& key,
+                                  const RecordId& loc,
+                                  bool dupsAllowed) {
+    invariant(loc.isNormal());
+    dassert(!hasFieldNames(key));
+
+    const KeyString keyString(_keyStringVersion, key, _order, loc);
+    StringStore* workingCopy = RecoveryUnit::get(opCtx)->getWriteView();
+    workingCopy->erase(_prefix + std::string(keyString.getBuffer(), keyString.getSize()));
+}
+
+Status SortedDataInterface::dupKeyCheck(OperationContext* opCtx,
+                                        const BSONObj& key,
+                                        const RecordId& loc) {
+    invariant(_isUnique);
+    if (_hasOtherEntry(*RecoveryUnit::get(opCtx)->getReadView(), key, loc)) {
+        return _dupKeyError(key);
+    }
+    return Status::OK();
+}
+
+void SortedDataInterface::fullValidate(OperationContext* opCtx,
+                                       long long* numKeysOut,
+                                       ValidateResults* fullResults) const {
+    const StringStore* view = RecoveryUnit::get(opCtx)->getReadView();
+    long long numKeys = 0;
+    for (auto it = view->lower_bound(_prefix); it != view->end() && it->first < _postfix; ++it) {
+        ++numKeys;
+    }
+    *numKeysOut = numKeys;
+}
+
+bool SortedDataInterface::appendCustomStats(OperationContext* opCtx,
+                                            BSONObjBuilder* output,
+                                            double scale) const {
+    return false;
+}
+
+long long SortedDataInterface::getSpaceUsedBytes(OperationContext* opCtx) const {
+    const StringStore* view = RecoveryUnit::get(opCtx)->getReadView();
+    long long size = 0;
+    for (auto it = view->lower_bound(_prefix); it != view->end() && it->first < _postfix; ++it) {
+        size += it->first.size() + it->second.size();
+    }
+    return size;
+}
+
+bool SortedDataInterface::isEmpty(OperationContext* opCtx) {
+    const StringStore* view = RecoveryUnit::get(opCtx)->getReadView();
+    auto it = view->lower_bound(_prefix);
+    return it == view->end() || it->first >= _postfix;
+}
+
+std::unique_ptr<::mongo::SortedDataInterface::Cursor> SortedDataInterface::newCursor(
+    OperationContext* opCtx, bool isForward) const {
+    return stdx::make_unique<Cursor>(opCtx, *this, isForward);
+}
+
+Status SortedDataInterface::initAsEmpty(OperationContext* opCtx) {
+    return Status::OK();
+}
+
+bool SortedDataInterface::_hasOtherEntry(const StringStore& view,
+                                         const BSONObj& key,
+                                         const RecordId& loc) const {
+    // Without a RecordId or discriminator, the KeyString of the key is a prefix of the KeyStrings
+    // of all of its entries.
+    const KeyString keyString(_keyStringVersion, key, _order);
+    const std::string keyPrefix =
+        _prefix + std::string(keyString.getBuffer(), keyString.getSize());
+
+    for (auto it = view.lower_bound(keyPrefix);
+         it != view.end() && startsWith(it->first, keyPrefix);
+         ++it) {
+        const RecordId id = KeyString::decodeRecordIdAtEnd(it->first.data() + _prefix.size(),
+                                                           it->first.size() - _prefix.size());
+        if (id != loc) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Status SortedDataInterface::_dupKeyError(const BSONObj& key) const {
+    StringBuilder sb;
+    sb << "E11000 duplicate key error";
+    sb << " collection: " << _collectionNamespace;
+    sb << " index: " << _indexName;
+    sb << " dup key: " << key;
+    return Status(ErrorCodes::DuplicateKey, sb.str());
+}
+
+}  // namespace biggie
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/biggie/store.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+
+namespace mongo {
+namespace biggie {
+
+class SortedDataInterface;
+
+class SortedDataBuilderInterface : public ::mongo::SortedDataBuilderInterface {
+public:
+    SortedDataBuilderInterface(OperationContext* opCtx,
+                               SortedDataInterface* index,
+                               bool dupsAllowed,
+                               Ordering order);
+
+    Status addKey(const BSONObj& key, const RecordId& loc) override;
+
+private:
+    OperationContext* const _opCtx;
+    SortedDataInterface* const _index;
+    const bool _dupsAllowed;
+    const Ordering _order;
+
+    BSONObj _previousKey;
+};
+
+/**
+ * An index that keeps its entries in the StringStore of the biggie engine. Each entry is stored
+ * under the key prefix of its ident followed by the KeyString of the index key and RecordId, and
+ * maps to the TypeBits needed to turn the KeyString back into BSON. Unique and non-unique indexes
+ * use the same format; uniqueness is enforced by looking for other entries with the same index
+ * key before inserting.
+ */
+class SortedDataInterface : public ::mongo::SortedDataInterface {
+public:
+    SortedDataInterface(const Ordering& ordering,
+                        bool isUnique,
+                        StringData ns,
+                        StringData indexName,
+                        StringData ident,
+                        KeyString::Version keyStringVersion);
+
+    ::mongo::SortedDataBuilderInterface* getBulkBuilder(OperationContext* opCtx,
+                                                        bool dupsAllowed) override;
+
+    Status insert(OperationContext* opCtx,
+                  const BSONObj& key,
+                  const RecordId& loc,
+                  bool dupsAllowed) override;
+
+    void unindex(OperationContext* opCtx,
+                 const BSONObj& key,
+                 const RecordId& loc,
+                 bool dupsAllowed) override;
+
+    Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& loc) override;
+
+    void fullValidate(OperationContext* opCtx,
+                      long long* numKeysOut,
+                      ValidateResults* fullResults) const override;
+
+    bool appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* output,
+                           double scale) const override;
+
+    long long getSpaceUsedBytes(OperationContext* opCtx) const override;
+
+    bool isEmpty(OperationContext* opCtx) override;
+
+    std::unique_ptr<::mongo::SortedDataInterface::Cursor> newCursor(
+        OperationContext* opCtx, bool isForward = true) const override;
+
+    Status initAsEmpty(OperationContext* opCtx) override;
+
+private:
+    class Cursor;
+
+    /**
+     * Returns whether 'view' holds an entry for 'key' with a RecordId other than 'loc'.
+     */
+    bool _hasOtherEntry(const StringStore& view, const BSONObj& key, const RecordId& loc) const;
+
+    Status _dupKeyError(const BSONObj& key) const;
+
+    const Ordering _order;
+    const bool _isUnique;
+    const std::string _collectionNamespace;
+    const std::string _indexName;
+    const std::string _prefix;
+    const std::string _postfix;
+    const KeyString::Version _keyStringVersion;
+};
+
+}  // namespace biggie
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include <exception>
 #include <map>
+#include <string>
 
 namespace mongo {
 namespace biggie {
@@ -117,8 +118,12 @@ public:
     // Constructors
 
     Store(const Store& other) = default;
+    Store(Store&& other) = default;
     Store() = default;
 
+    Store& operator=(const Store& other) = default;
+    Store& operator=(Store&& other) = default;
+
     ~Store() = default;
 
     // Non member equality
@@ -293,5 +298,7 @@ public:
         return typename iterator::difference_type(std::distance(iter1.iter, iter2.iter));
     };
 };
-}
-}
+
+using StringStore = Store<std::string, std::string>;
+}  // namespace biggie
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+enum class Key { kInt, kDouble, kString, kCompound };
+
+BSONObj makeKey(Key key) {
+    switch (key) {
+        case Key::kInt:
+            return BSON("" << 12345);
+        case Key::kDouble:
+            // A fractional double that needs type bits to round-trip.
+            return BSON("" << 12345.6789);
+        case Key::kString:
+            return BSON("" << "a string key that is longer than the small string buffers");
+        case Key::kCompound:
+            return BSON("" << 12345 << "" << "category" << ""
+                           << Date_t::fromMillisSinceEpoch(1500000000000LL) << "" << 3.5);
+    }
+    MONGO_UNREACHABLE;
+}
+
+void BM_KeyStringEncode(benchmark::State& state, KeyString::Version version, Key key) {
+    const BSONObj obj = makeKey(key);
+    const RecordId recordId(42);
+
+    KeyString ks(version);
+    for (auto keepRunning : state) {
+        ks.resetToKey(obj, kAllAscending, recordId);
+        benchmark::DoNotOptimize(ks.getBuffer());
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+void BM_KeyStringDecode(benchmark::State& state, KeyString::Version version, Key key) {
+    const BSONObj obj = makeKey(key);
+    const KeyString ks(version, obj, kAllAscending);
+
+    for (auto keepRunning : state) {
+        BSONObj decoded =
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), kAllAscending, ks.getTypeBits());
+        benchmark::DoNotOptimize(decoded.objdata());
+    }
+    state.SetBytesProcessed(state.iterations() * ks.getSize());
+}
+
+BENCHMARK_CAPTURE(BM_KeyStringEncode, V0_Int, KeyString::Version::V0, Key::kInt);
+BENCHMARK_CAPTURE(BM_KeyStringEncode, V1_Int, KeyString::Version::V1, Key::kInt);
+BENCHMARK_CAPTURE(BM_KeyStringEncode, V1_Double, KeyString::Version::V1, Key::kDouble);
+BENCHMARK_CAPTURE(BM_KeyStringEncode, V1_String, KeyString::Version::V1, Key::kString);
+BENCHMARK_CAPTURE(BM_KeyStringEncode, V1_Compound, KeyString::Version::V1, Key::kCompound);
+
+BENCHMARK_CAPTURE(BM_KeyStringDecode, V0_Int, KeyString::Version::V0, Key::kInt);
+BENCHMARK_CAPTURE(BM_KeyStringDecode, V1_Int, KeyString::Version::V1, Key::kInt);
+BENCHMARK_CAPTURE(BM_KeyStringDecode, V1_Double, KeyString::Version::V1, Key::kDouble);
+BENCHMARK_CAPTURE(BM_KeyStringDecode, V1_String, KeyString::Version::V1, Key::kString);
+BENCHMARK_CAPTURE(BM_KeyStringDecode, V1_Compound, KeyString::Version::V1, Key::kCompound);
+
+}  // namespace
+}  // namespace mongo
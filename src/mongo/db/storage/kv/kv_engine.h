@@ -205,6 +205,22 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * See StorageEngine::beginNonBlockingBackup for details. Returns the paths of the files to
+     * copy, relative to the dbpath.
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine doesn't support non-blocking backups");
+    }
+
+    /**
+     * See StorageEngine::endNonBlockingBackup for details
+     */
+    virtual void endNonBlockingBackup(OperationContext* opCtx) {
+        MONGO_UNREACHABLE;
+    }
+
     virtual bool isDurable() const = 0;
 
     /**
@@ -509,6 +509,32 @@ void KVStorageEngine::endBackup(OperationContext* opCtx) {
     _inBackupMode = false;
 }
 
+StatusWith<StorageEngine::BackupInformation> KVStorageEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    if (_inBackupMode)
+        return Status(ErrorCodes::BadValue, "Already in Backup Mode");
+
+    // Read before the backup holds on to the last checkpoint, so that a checkpoint completing in
+    // between can only make the files newer than the timestamp.
+    BackupInformation info;
+    if (_engine->supportsRecoverToStableTimestamp()) {
+        info.checkpointTimestamp = _engine->getLastStableCheckpointTimestamp();
+    }
+
+    auto filenames = _engine->beginNonBlockingBackup(opCtx);
+    if (!filenames.isOK())
+        return filenames.getStatus();
+    info.filenames = std::move(filenames.getValue());
+    _inBackupMode = true;
+    return std::move(info);
+}
+
+void KVStorageEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    invariant(_inBackupMode);
+    _engine->endNonBlockingBackup(opCtx);
+    _inBackupMode = false;
+}
+
 bool KVStorageEngine::isDurable() const {
     return _engine->isDurable();
 }
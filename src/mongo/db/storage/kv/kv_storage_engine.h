@@ -109,6 +109,10 @@ public:
 
     virtual void endBackup(OperationContext* opCtx);
 
+    virtual StatusWith<BackupInformation> beginNonBlockingBackup(OperationContext* opCtx) override;
+
+    virtual void endNonBlockingBackup(OperationContext* opCtx) override;
+
     virtual bool isDurable() const;
 
     virtual bool isEphemeral() const;
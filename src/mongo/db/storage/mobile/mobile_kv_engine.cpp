@@ -30,14 +30,17 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/system/error_code.hpp>
 #include <memory>
 #include <vector>
 
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/mobile/mobile_index.h"
 #include "mongo/db/storage/mobile/mobile_kv_engine.h"
 #include "mongo/db/storage/mobile/mobile_record_store.h"
@@ -46,14 +49,88 @@
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 #include "mongo/db/storage/mobile/mobile_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 class MobileSession;
 class SqliteStatement;
 
+namespace {
+// Number of prepared statements each SQLite connection keeps for reuse. Zero disables caching.
+int mobileStatementCacheSize = 32;
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> mobileStatementCacheSizeParam(
+    ServerParameterSet::getGlobal(), "mobileStatementCacheSize", &mobileStatementCacheSize);
+
+// How often the WAL is checkpointed by a background thread. Zero leaves checkpoints to SQLite,
+// which runs them on the committing thread once the WAL grows past 1000 pages.
+int mobileWALCheckpointIntervalMillis = 1000;
+ExportedServerParameter<int, ServerParameterType::kStartupOnly>
+    mobileWALCheckpointIntervalMillisParam(ServerParameterSet::getGlobal(),
+                                           "mobileWALCheckpointIntervalMillis",
+                                           &mobileWALCheckpointIntervalMillis);
+}  // namespace
+
+class MobileKVEngine::MobileWALCheckpointer : public BackgroundJob {
+public:
+    MobileWALCheckpointer(const std::string& path, int intervalMillis)
+        : BackgroundJob(false /* deleteSelf */), _path(path), _intervalMillis(intervalMillis) {}
+
+    std::string name() const override {
+        return "MobileWALCheckpointer";
+    }
+
+    void run() override {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        // The checkpointer uses its own connection so that it never competes with operations for
+        // sessions from the pool.
+        sqlite3* session;
+        int status = sqlite3_open(_path.c_str(), &session);
+        checkStatus(status, SQLITE_OK, "sqlite3_open");
+        ON_BLOCK_EXIT([&session] { sqlite3_close(session); });
+
+        while (!_shuttingDown.load()) {
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepmillis(_intervalMillis);
+            }
+
+            // A passive checkpoint copies as many frames as it can without waiting on readers or
+            // writers, so it never stalls foreground operations.
+            int logFrames = 0;
+            int checkpointedFrames = 0;
+            status = sqlite3_wal_checkpoint_v2(
+                session, nullptr, SQLITE_CHECKPOINT_PASSIVE, &logFrames, &checkpointedFrames);
+            if (status == SQLITE_BUSY || status == SQLITE_LOCKED) {
+                continue;
+            }
+            checkStatus(status, SQLITE_OK, "sqlite3_wal_checkpoint_v2");
+
+            LOG(MOBILE_TRACE_LEVEL) << "MobileSE: Checkpointed " << checkpointedFrames << " of "
+                                    << logFrames << " WAL frames";
+        }
+
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        wait();
+    }
+
+private:
+    const std::string _path;
+    const int _intervalMillis;
+    AtomicBool _shuttingDown{false};
+};
+
 MobileKVEngine::MobileKVEngine(const std::string& path) {
     _initDBPath(path);
 
@@ -134,7 +211,30 @@ MobileKVEngine::MobileKVEngine(const std::string& path) {
                                   << ". Val: " << fullfsync_val;
     }
 
-    _sessionPool.reset(new MobileSessionPool(_path));
+    const bool backgroundCheckpoints = mobileWALCheckpointIntervalMillis > 0;
+    _sessionPool.reset(new MobileSessionPool(_path,
+                                             80 /* maxPoolSize */,
+                                             std::max(mobileStatementCacheSize, 0),
+                                             backgroundCheckpoints));
+
+    if (backgroundCheckpoints) {
+        _walCheckpointer =
+            stdx::make_unique<MobileWALCheckpointer>(_path, mobileWALCheckpointIntervalMillis);
+        _walCheckpointer->go();
+    }
+}
+
+MobileKVEngine::~MobileKVEngine() {
+    cleanShutdown();
+}
+
+void MobileKVEngine::cleanShutdown() {
+    if (_walCheckpointer) {
+        log() << "Shutting down WAL checkpointer thread";
+        _walCheckpointer->shutdown();
+        _walCheckpointer.reset();
+        log() << "Finished shutting down WAL checkpointer thread";
+    }
 }
 
 void MobileKVEngine::_initDBPath(const std::string& path) {
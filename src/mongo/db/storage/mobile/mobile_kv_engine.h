@@ -44,6 +44,8 @@ class MobileKVEngine : public KVEngine {
 public:
     MobileKVEngine(const std::string& path);
 
+    ~MobileKVEngine() override;
+
     RecoveryUnit* newRecoveryUnit() override;
 
     Status createRecordStore(OperationContext* opCtx,
@@ -116,7 +118,7 @@ public:
         return createRecordStore(opCtx, ns, ident, options);
     }
 
-    void cleanShutdown() override{};
+    void cleanShutdown() override;
 
     bool hasIdent(OperationContext* opCtx, StringData ident) const override;
 
@@ -132,11 +134,17 @@ public:
     }
 
 private:
+    class MobileWALCheckpointer;
+
     mutable stdx::mutex _mutex;
     void _initDBPath(const std::string& path);
 
     std::unique_ptr<MobileSessionPool> _sessionPool;
 
+    // Checkpoints the WAL in the background, instead of on whichever writer happens to commit the
+    // transaction that crosses SQLite's auto-checkpoint threshold.
+    std::unique_ptr<MobileWALCheckpointer> _walCheckpointer;
+
     // Notified when we write as everything is considered "journalled" since repl depends on it.
     JournalListener* _journalListener = &NoOpJournalListener::instance;
 
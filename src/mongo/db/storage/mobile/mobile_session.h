@@ -33,6 +33,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/db/storage/mobile/mobile_statement_cache.h"
 
 namespace mongo {
 class MobileSessionPool;
@@ -44,7 +45,9 @@ class MobileSession final {
     MONGO_DISALLOW_COPYING(MobileSession);
 
 public:
-    MobileSession(sqlite3* session, MobileSessionPool* sessionPool);
+    MobileSession(sqlite3* session,
+                  MobileSessionPool* sessionPool,
+                  MobileStatementCache* statementCache = nullptr);
 
     ~MobileSession();
 
@@ -53,8 +56,17 @@ public:
      */
     sqlite3* getSession() const;
 
+    /**
+     * Returns the cache of prepared statements for the underlying connection, or nullptr if
+     * statements prepared on this session should not be reused.
+     */
+    MobileStatementCache* getStatementCache() const {
+        return _statementCache;
+    }
+
 private:
     sqlite3* _session;
     MobileSessionPool* _sessionPool;
+    MobileStatementCache* _statementCache;
 };
 }  // namespace mongo
@@ -94,8 +94,14 @@ bool MobileDelayedOpQueue::isEmpty() {
     return (_isEmpty.load());
 }
 
-MobileSessionPool::MobileSessionPool(const std::string& path, std::uint64_t maxPoolSize)
-    : _path(path), _maxPoolSize(maxPoolSize) {}
+MobileSessionPool::MobileSessionPool(const std::string& path,
+                                     std::uint64_t maxPoolSize,
+                                     std::size_t statementCacheSize,
+                                     bool disableAutoCheckpoint)
+    : _path(path),
+      _maxPoolSize(maxPoolSize),
+      _statementCacheSize(statementCacheSize),
+      _disableAutoCheckpoint(disableAutoCheckpoint) {}
 
 MobileSessionPool::~MobileSessionPool() {
     shutDown();
@@ -111,7 +117,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
     // Checks if there is an open session available.
     if (!_sessions.empty()) {
         sqlite3* session = _popSession_inlock();
-        return stdx::make_unique<MobileSession>(session, this);
+        return _makeSession_inlock(session);
     }
 
     // Checks if a new session can be opened.
@@ -119,8 +125,18 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         sqlite3* session;
         int status = sqlite3_open(_path.c_str(), &session);
         checkStatus(status, SQLITE_OK, "sqlite3_open");
+
+        if (_disableAutoCheckpoint) {
+            status = sqlite3_wal_autocheckpoint(session, 0);
+            checkStatus(status, SQLITE_OK, "sqlite3_wal_autocheckpoint");
+        }
+        if (_statementCacheSize > 0) {
+            _statementCaches[session] =
+                stdx::make_unique<MobileStatementCache>(_statementCacheSize);
+        }
+
         _curPoolSize++;
-        return stdx::make_unique<MobileSession>(session, this);
+        return _makeSession_inlock(session);
     }
 
     // There are no open sessions available and the maxPoolSize has been reached.
@@ -129,7 +145,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         _releasedSessionNotifier, lk, [&] { return !_sessions.empty(); });
 
     sqlite3* session = _popSession_inlock();
-    return stdx::make_unique<MobileSession>(session, this);
+    return _makeSession_inlock(session);
 }
 
 void MobileSessionPool::releaseSession(MobileSession* session) {
@@ -172,6 +188,8 @@ void MobileSessionPool::shutDown() {
         sqlite3_close(session);
     }
 
+    // A connection cannot be closed while it still has prepared statements.
+    _statementCaches.clear();
     for (auto&& session : _sessions) {
         sqlite3_close(session);
     }
@@ -184,4 +202,12 @@ sqlite3* MobileSessionPool::_popSession_inlock() {
     return session;
 }
 
+// This method should only be called when _sessions is locked.
+std::unique_ptr<MobileSession> MobileSessionPool::_makeSession_inlock(sqlite3* session) {
+    auto it = _statementCaches.find(session);
+    MobileStatementCache* statementCache =
+        it == _statementCaches.end() ? nullptr : it->second.get();
+    return stdx::make_unique<MobileSession>(session, this, statementCache);
+}
+
 }  // namespace mongo
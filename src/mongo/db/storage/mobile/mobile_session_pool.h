@@ -36,7 +36,9 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
+#include "mongo/db/storage/mobile/mobile_statement_cache.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 class MobileSession;
@@ -67,7 +69,15 @@ class MobileSessionPool final {
     MONGO_DISALLOW_COPYING(MobileSessionPool);
 
 public:
-    MobileSessionPool(const std::string& path, std::uint64_t maxPoolSize = 80);
+    /**
+     * Each open connection caches up to 'statementCacheSize' prepared statements. When
+     * 'disableAutoCheckpoint' is true, connections do not checkpoint the WAL when committing, and
+     * checkpoints are expected to be run in the background instead.
+     */
+    MobileSessionPool(const std::string& path,
+                      std::uint64_t maxPoolSize = 80,
+                      std::size_t statementCacheSize = 32,
+                      bool disableAutoCheckpoint = false);
 
     ~MobileSessionPool();
 
@@ -96,6 +106,11 @@ private:
      */
     sqlite3* _popSession_inlock();
 
+    /**
+     * Wraps a connection from the pool in a MobileSession along with its statement cache.
+     */
+    std::unique_ptr<MobileSession> _makeSession_inlock(sqlite3* session);
+
     // This is used to lock the _sessions vector.
     stdx::mutex _mutex;
     stdx::condition_variable _releasedSessionNotifier;
@@ -109,7 +124,14 @@ private:
     std::uint64_t _curPoolSize = 0;
     bool _shuttingDown = false;
 
+    const std::size_t _statementCacheSize;
+    const bool _disableAutoCheckpoint;
+
     using SessionPool = std::vector<sqlite3*>;
     SessionPool _sessions;
+
+    // Prepared statements of each open connection, whether or not it is currently checked out.
+    // These must be finalized before the connection is closed.
+    stdx::unordered_map<sqlite3*, std::unique_ptr<MobileStatementCache>> _statementCaches;
 };
 }  // namespace mongo
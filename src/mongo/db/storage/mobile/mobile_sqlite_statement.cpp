@@ -46,9 +46,20 @@ namespace mongo {
 
 AtomicInt64 SqliteStatement::_nextID(0);
 
-SqliteStatement::SqliteStatement(const MobileSession& session, const std::string& sqlQuery) {
+SqliteStatement::SqliteStatement(const MobileSession& session, const std::string& sqlQuery)
+    : _statementCache(session.getStatementCache()) {
     // Increment the global instance count and assign this instance an id.
     _id = _nextID.addAndFetch(1);
+
+    if (_statementCache) {
+        _sqlQuery = sqlQuery;
+        _stmt = _statementCache->checkOut(sqlQuery);
+        if (_stmt) {
+            SQLITE_STMT_TRACE() << "Reusing cached: " << sqlQuery;
+            return;
+        }
+    }
+
     SQLITE_STMT_TRACE() << "Preparing: " << sqlQuery;
     int status = sqlite3_prepare_v2(
         session.getSession(), sqlQuery.c_str(), sqlQuery.length() + 1, &_stmt, NULL);
@@ -65,6 +76,15 @@ SqliteStatement::SqliteStatement(const MobileSession& session, const std::string
 }
 
 SqliteStatement::~SqliteStatement() {
+    if (_statementCache && _exceptionStatus == SQLITE_OK) {
+        // Like sqlite3_finalize, sqlite3_reset returns the error of the last step, if any.
+        int status = sqlite3_reset(_stmt);
+        fassert(50876, status == SQLITE_OK);
+        sqlite3_clear_bindings(_stmt);
+        _statementCache->checkIn(_sqlQuery, _stmt);
+        return;
+    }
+
     int status = sqlite3_finalize(_stmt);
     fassert(37053, status == _exceptionStatus);
 }
@@ -43,12 +43,14 @@ namespace mongo {
 class SqliteStatement final {
 public:
     /**
-     * Creates and prepares a SQLite statement.
+     * Creates and prepares a SQLite statement, reusing a statement prepared earlier on the same
+     * connection when the session has one cached.
      */
     SqliteStatement(const MobileSession& session, const std::string& sqlQuery);
 
     /**
-     * Finalizes the prepared statement.
+     * Returns the prepared statement to the session's statement cache, or finalizes it if there is
+     * no cache or the statement last failed.
      */
     ~SqliteStatement();
 
@@ -122,6 +124,10 @@ private:
     static AtomicInt64 _nextID;
     sqlite3_stmt* _stmt;
 
+    // Not owned. Null when statements are not cached for the session's connection.
+    MobileStatementCache* _statementCache;
+    std::string _sqlQuery;
+
     // If the most recent call to sqlite3_step on this statement returned an error, the error is
     // returned again when the statement is finalized. This is used to verify that the last error
     // code returned matches the finalize error code, if there is any.
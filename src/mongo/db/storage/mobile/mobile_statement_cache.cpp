@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/mobile/mobile_statement_cache.h"
+
+namespace mongo {
+
+MobileStatementCache::MobileStatementCache(std::size_t capacity) : _cache(capacity) {}
+
+MobileStatementCache::~MobileStatementCache() {
+    for (auto&& entry : _cache) {
+        sqlite3_finalize(entry.second);
+    }
+}
+
+sqlite3_stmt* MobileStatementCache::checkOut(const std::string& sqlQuery) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _cache.find(sqlQuery);
+    if (it == _cache.end()) {
+        return nullptr;
+    }
+
+    sqlite3_stmt* stmt = it->second;
+    _cache.erase(it);
+    return stmt;
+}
+
+void MobileStatementCache::checkIn(const std::string& sqlQuery, sqlite3_stmt* stmt) {
+    boost::optional<sqlite3_stmt*> toFinalize;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_cache.hasKey(sqlQuery)) {
+            toFinalize = stmt;
+        } else {
+            toFinalize = _cache.add(sqlQuery, stmt);
+        }
+    }
+
+    if (toFinalize) {
+        sqlite3_finalize(*toFinalize);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <sqlite3.h>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/lru_cache.h"
+
+namespace mongo {
+
+/**
+ * A least recently used cache of prepared statements belonging to a single SQLite connection.
+ * Statements are checked out while in use and checked back in, already reset, once an operation is
+ * done with them. A connection is only used by one MobileSession at a time, but cursors may keep
+ * their statement past the end of the session, so the cache is still synchronized.
+ */
+class MobileStatementCache final {
+    MONGO_DISALLOW_COPYING(MobileStatementCache);
+
+public:
+    explicit MobileStatementCache(std::size_t capacity);
+
+    /**
+     * Finalizes all cached statements. This must happen before the connection is closed.
+     */
+    ~MobileStatementCache();
+
+    /**
+     * Removes and returns a prepared statement for 'sqlQuery', or returns nullptr if none is
+     * cached. The caller takes ownership of the returned statement.
+     */
+    sqlite3_stmt* checkOut(const std::string& sqlQuery);
+
+    /**
+     * Takes ownership of a reset statement prepared from 'sqlQuery'. The statement is finalized if
+     * another one for the same query is already cached. Finalizes the least recently used
+     * statement if the cache is full.
+     */
+    void checkIn(const std::string& sqlQuery, sqlite3_stmt* stmt);
+
+    std::size_t size() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _cache.size();
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    LRUCache<std::string, sqlite3_stmt*> _cache;
+};
+
+}  // namespace mongo
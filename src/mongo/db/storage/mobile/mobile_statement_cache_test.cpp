@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <sqlite3.h>
+
+#include "mongo/db/storage/mobile/mobile_statement_cache.h"
+#include "mongo/db/storage/mobile/mobile_util.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class MobileStatementCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        int status = sqlite3_open(":memory:", &_session);
+        checkStatus(status, SQLITE_OK, "sqlite3_open");
+    }
+
+    void tearDown() override {
+        ASSERT_EQUALS(SQLITE_OK, sqlite3_close(_session));
+    }
+
+    sqlite3_stmt* prepare(const std::string& sqlQuery) {
+        sqlite3_stmt* stmt;
+        int status = sqlite3_prepare_v2(_session, sqlQuery.c_str(), -1, &stmt, nullptr);
+        checkStatus(status, SQLITE_OK, "sqlite3_prepare_v2");
+        return stmt;
+    }
+
+    sqlite3* _session;
+};
+
+TEST_F(MobileStatementCacheTest, CheckOutReturnsCheckedInStatement) {
+    MobileStatementCache cache(2);
+    ASSERT(cache.checkOut("SELECT 1;") == nullptr);
+
+    sqlite3_stmt* stmt = prepare("SELECT 1;");
+    cache.checkIn("SELECT 1;", stmt);
+    ASSERT_EQUALS(1U, cache.size());
+
+    ASSERT(cache.checkOut("SELECT 1;") == stmt);
+    ASSERT_EQUALS(0U, cache.size());
+    ASSERT(cache.checkOut("SELECT 1;") == nullptr);
+    sqlite3_finalize(stmt);
+}
+
+TEST_F(MobileStatementCacheTest, EvictsLeastRecentlyUsedStatement) {
+    {
+        MobileStatementCache cache(2);
+        cache.checkIn("SELECT 1;", prepare("SELECT 1;"));
+        cache.checkIn("SELECT 2;", prepare("SELECT 2;"));
+        cache.checkIn("SELECT 3;", prepare("SELECT 3;"));
+        ASSERT_EQUALS(2U, cache.size());
+
+        ASSERT(cache.checkOut("SELECT 1;") == nullptr);
+        sqlite3_stmt* stmt = cache.checkOut("SELECT 2;");
+        ASSERT(stmt != nullptr);
+        sqlite3_finalize(stmt);
+    }
+
+    // Every statement, whether evicted or still cached, has been finalized.
+    ASSERT(sqlite3_next_stmt(_session, nullptr) == nullptr);
+}
+
+TEST_F(MobileStatementCacheTest, DuplicateCheckInFinalizesStatement) {
+    {
+        MobileStatementCache cache(2);
+        cache.checkIn("SELECT 1;", prepare("SELECT 1;"));
+        cache.checkIn("SELECT 1;", prepare("SELECT 1;"));
+        ASSERT_EQUALS(1U, cache.size());
+    }
+    ASSERT(sqlite3_next_stmt(_session, nullptr) == nullptr);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -202,6 +202,16 @@ public:
      */
     virtual void invalidate(OperationContext* opCtx, const RecordId& id) {}
 
+    /**
+     * Hints that the caller intends to scan forward through at least the next 'numRecords'
+     * records, so the storage engine may start bringing them into cache asynchronously while the
+     * current records are processed. Passing 0 disables read-ahead.
+     *
+     * This is purely advisory: it must never change the results returned by the cursor. Storage
+     * engines that cannot prefetch should use the default implementation, which does nothing.
+     */
+    virtual void enableReadAhead(std::size_t numRecords) {}
+
     //
     // RecordFetchers
     //
@@ -148,6 +148,12 @@ public:
                                    BSONObjBuilder* output,
                                    double scale) const = 0;
 
+    /**
+     * Appends in-memory statistics the storage engine keeps about 'this' index, for $indexStats.
+     * Unlike appendCustomStats(), this must not touch the underlying storage.
+     */
+    virtual void appendIndexStats(BSONObjBuilder* builder) const {}
+
 
     /**
      * Return the number of bytes consumed by 'this' index.
@@ -266,6 +266,41 @@ public:
         return;
     }
 
+    /**
+     * The files a backup must copy, and the timestamp from which the oplog must be replayed over
+     * them.
+     */
+    struct BackupInformation {
+        // The paths of the files, relative to the dbpath.
+        std::vector<std::string> filenames;
+
+        // No later than the timestamp of the checkpoint the files hold. Not set if the storage
+        // engine does not take stable checkpoints.
+        boost::optional<Timestamp> checkpointTimestamp;
+    };
+
+    /**
+     * Starts a backup that, unlike beginBackup(), does not need writes to be stopped. The files
+     * returned keep holding the last checkpoint taken before this call, even as later checkpoints
+     * are taken, until endNonBlockingBackup() is called. Only one backup, of either kind, may be
+     * in progress at a time.
+     *
+     * Storage engines that do not support this feature should use the default implementation.
+     */
+    virtual StatusWith<BackupInformation> beginNonBlockingBackup(OperationContext* opCtx) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine doesn't support non-blocking backups");
+    }
+
+    /**
+     * Ends the backup started by beginNonBlockingBackup().
+     *
+     * Storage engines that do not support this feature should use the default implementation.
+     */
+    virtual void endNonBlockingBackup(OperationContext* opCtx) {
+        return;
+    }
+
     /**
      * Recover as much data as possible from a potentially corrupt RecordStore.
      * This only recovers the record data, not indexes or anything else.
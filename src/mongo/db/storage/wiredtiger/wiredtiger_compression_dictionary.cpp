@@ -0,0 +1,308 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+#include "mongo/bson/bsonelement.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/md5.hpp"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr StringData WiredTigerCompressionDictionary::kOptionName;
+constexpr std::size_t WiredTigerCompressionDictionary::kMaxDictionarySize;
+constexpr std::size_t WiredTigerCompressionDictionaryTrainer::kDefaultMaxDictionarySize;
+constexpr int WiredTigerCompressionDictionaryTrainer::kMaxStringValueSize;
+constexpr std::size_t WiredTigerCompressionDictionaryTrainer::kMaxCandidates;
+
+namespace {
+
+// Raw deflate streams, without the zlib header and trailer. Pages are checksummed by WiredTiger.
+const int kWindowBits = -15;
+
+/**
+ * A WT_COMPRESSOR bound to a single dictionary. The WT_COMPRESSOR must be the first member so
+ * that the callbacks can recover the dictionary from the pointer WiredTiger hands them back.
+ * Ownership passes to the connection on registration, which releases it in terminate().
+ */
+struct DictionaryCompressor {
+    WT_COMPRESSOR compressor;
+    char* dictionary;
+    std::size_t dictionarySize;
+};
+
+StringData getDictionary(WT_COMPRESSOR* compressor) {
+    auto dc = reinterpret_cast<DictionaryCompressor*>(compressor);
+    return StringData(dc->dictionary, dc->dictionarySize);
+}
+
+int dictionaryCompress(WT_COMPRESSOR* compressor,
+                       WT_SESSION* session,
+                       uint8_t* src,
+                       size_t srcLen,
+                       uint8_t* dst,
+                       size_t dstLen,
+                       size_t* resultLen,
+                       int* compressionFailed) {
+    auto result = WiredTigerCompressionDictionary::compress(
+        getDictionary(compressor),
+        ConstDataRange(reinterpret_cast<const char*>(src), srcLen),
+        DataRange(reinterpret_cast<char*>(dst), dstLen));
+
+    // Data that does not shrink is stored uncompressed by WiredTiger.
+    if (!result.isOK() || result.getValue() >= srcLen) {
+        *compressionFailed = 1;
+        return 0;
+    }
+
+    *compressionFailed = 0;
+    *resultLen = result.getValue();
+    return 0;
+}
+
+int dictionaryDecompress(WT_COMPRESSOR* compressor,
+                         WT_SESSION* session,
+                         uint8_t* src,
+                         size_t srcLen,
+                         uint8_t* dst,
+                         size_t dstLen,
+                         size_t* resultLen) {
+    auto result = WiredTigerCompressionDictionary::decompress(
+        getDictionary(compressor),
+        ConstDataRange(reinterpret_cast<const char*>(src), srcLen),
+        DataRange(reinterpret_cast<char*>(dst), dstLen));
+    if (!result.isOK()) {
+        error() << "Failed to decompress a WiredTiger block with a compression dictionary: "
+                << result.getStatus();
+        return WT_ERROR;
+    }
+
+    *resultLen = result.getValue();
+    return 0;
+}
+
+int dictionaryTerminate(WT_COMPRESSOR* compressor, WT_SESSION* session) {
+    auto dc = reinterpret_cast<DictionaryCompressor*>(compressor);
+    delete[] dc->dictionary;
+    delete dc;
+    return 0;
+}
+
+}  // namespace
+
+Status WiredTigerCompressionDictionary::validate(const BSONElement& elem) {
+    if (elem.type() != BinData || elem.binDataType() != BinDataGeneral) {
+        return {ErrorCodes::TypeMismatch,
+                str::stream() << "'" << kOptionName << "' must be of type BinData with subtype "
+                              << static_cast<int>(BinDataGeneral)};
+    }
+
+    int len = 0;
+    elem.binData(len);
+    if (len <= 0 || static_cast<std::size_t>(len) > kMaxDictionarySize) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'" << kOptionName << "' must be between 1 and "
+                              << kMaxDictionarySize
+                              << " bytes long, got "
+                              << len};
+    }
+    return Status::OK();
+}
+
+std::string WiredTigerCompressionDictionary::compressorName(StringData dictionary) {
+    return "mongodb_dict_" + md5simpledigest(dictionary.rawData(), dictionary.size());
+}
+
+Status WiredTigerCompressionDictionary::registerCompressor(WT_CONNECTION* conn,
+                                                           StringData dictionary) {
+    invariant(!dictionary.empty() && dictionary.size() <= kMaxDictionarySize);
+
+    auto dc = new DictionaryCompressor();
+    std::memset(&dc->compressor, 0, sizeof(dc->compressor));
+    dc->compressor.compress = dictionaryCompress;
+    dc->compressor.decompress = dictionaryDecompress;
+    dc->compressor.terminate = dictionaryTerminate;
+    dc->dictionary = new char[dictionary.size()];
+    dc->dictionarySize = dictionary.size();
+    dictionary.copyTo(dc->dictionary, false);
+
+    const std::string name = compressorName(dictionary);
+    int ret = conn->add_compressor(conn, name.c_str(), &dc->compressor, nullptr);
+    if (ret != 0) {
+        dictionaryTerminate(&dc->compressor, nullptr);
+        return wtRCToStatus(ret, "Failed to register compression dictionary");
+    }
+
+    LOG(1) << "Registered WiredTiger compressor " << name << " with a " << dictionary.size()
+           << " byte dictionary";
+    return Status::OK();
+}
+
+StatusWith<std::size_t> WiredTigerCompressionDictionary::compress(StringData dictionary,
+                                                                   ConstDataRange src,
+                                                                   DataRange dst) {
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kWindowBits, 8, Z_DEFAULT_STRATEGY) !=
+        Z_OK) {
+        return {ErrorCodes::InternalError, "Failed to initialize deflate stream"};
+    }
+    ON_BLOCK_EXIT([&] { deflateEnd(&zs); });
+
+    if (deflateSetDictionary(&zs,
+                             reinterpret_cast<const Bytef*>(dictionary.rawData()),
+                             dictionary.size()) != Z_OK) {
+        return {ErrorCodes::InternalError, "Failed to set deflate dictionary"};
+    }
+
+    zs.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(src.data()));
+    zs.avail_in = src.length();
+    zs.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(dst.data()));
+    zs.avail_out = dst.length();
+
+    int ret = deflate(&zs, Z_FINISH);
+    if (ret != Z_STREAM_END) {
+        return {ErrorCodes::BadValue, "Compressed data does not fit in the output buffer"};
+    }
+    return {static_cast<std::size_t>(zs.total_out)};
+}
+
+StatusWith<std::size_t> WiredTigerCompressionDictionary::decompress(StringData dictionary,
+                                                                     ConstDataRange src,
+                                                                     DataRange dst) {
+    z_stream zs;
+    std::memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, kWindowBits) != Z_OK) {
+        return {ErrorCodes::InternalError, "Failed to initialize inflate stream"};
+    }
+    ON_BLOCK_EXIT([&] { inflateEnd(&zs); });
+
+    // Raw inflate streams take the dictionary up front rather than asking for it with Z_NEED_DICT.
+    if (inflateSetDictionary(&zs,
+                             reinterpret_cast<const Bytef*>(dictionary.rawData()),
+                             dictionary.size()) != Z_OK) {
+        return {ErrorCodes::InternalError, "Failed to set inflate dictionary"};
+    }
+
+    zs.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(src.data()));
+    zs.avail_in = src.length();
+    zs.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(dst.data()));
+    zs.avail_out = dst.length();
+
+    int ret = inflate(&zs, Z_FINISH);
+    if (ret != Z_STREAM_END) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Compressed data was invalid or corrupted, inflate returned "
+                              << ret};
+    }
+    return {static_cast<std::size_t>(zs.total_out)};
+}
+
+WiredTigerCompressionDictionaryTrainer::WiredTigerCompressionDictionaryTrainer(
+    std::size_t maxDictionarySize)
+    : _maxDictionarySize(std::min(maxDictionarySize,
+                                  WiredTigerCompressionDictionary::kMaxDictionarySize)) {}
+
+void WiredTigerCompressionDictionaryTrainer::addSample(const BSONObj& doc) {
+    _addFields(doc);
+    ++_numSamples;
+}
+
+void WiredTigerCompressionDictionaryTrainer::_addFields(const BSONObj& obj) {
+    for (auto&& elem : obj) {
+        // The type byte and the field name, including its terminating NUL, appear verbatim in
+        // every document which contains the field.
+        _addCandidate(StringData(elem.rawdata(), 1 + elem.fieldNameSize()));
+
+        if (elem.type() == String && elem.valuesize() <= kMaxStringValueSize) {
+            _addCandidate(StringData(elem.rawdata(), elem.size()));
+        } else if (elem.isABSONObj()) {
+            _addFields(elem.Obj());
+        }
+    }
+}
+
+void WiredTigerCompressionDictionaryTrainer::_addCandidate(StringData bytes) {
+    auto it = _counts.find(bytes);
+    if (it != _counts.end()) {
+        ++it->second;
+    } else if (_counts.size() < kMaxCandidates) {
+        _counts[bytes] = 1;
+    }
+}
+
+std::string WiredTigerCompressionDictionaryTrainer::train() const {
+    // Score each repeated sequence by the number of bytes it would save beyond its first use.
+    std::vector<std::pair<std::size_t, StringData>> candidates;
+    for (auto&& entry : _counts) {
+        if (entry.second > 1) {
+            candidates.emplace_back((entry.second - 1) * entry.first.size(), entry.first);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        if (lhs.first != rhs.first) {
+            return lhs.first > rhs.first;
+        }
+        return lhs.second < rhs.second;
+    });
+
+    std::vector<StringData> selected;
+    std::size_t totalSize = 0;
+    for (auto&& candidate : candidates) {
+        if (totalSize + candidate.second.size() > _maxDictionarySize) {
+            continue;
+        }
+        selected.push_back(candidate.second);
+        totalSize += candidate.second.size();
+    }
+
+    std::string dictionary;
+    dictionary.reserve(totalSize);
+    for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+        dictionary.append(it->rawData(), it->size());
+    }
+    return dictionary;
+}
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <wiredtiger.h>
+
+#include "mongo/base/data_range.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Support for WiredTiger block compressors that deflate pages against a preset dictionary.
+ *
+ * A collection opts in by supplying a dictionary as BinData in its
+ * 'storageEngine.wiredTiger.compressionDictionary' option, which is persisted with the rest of
+ * the collection options in the KVCatalog metadata. Every distinct dictionary is registered with
+ * the WiredTiger connection as its own compressor, named after a digest of the dictionary bytes
+ * so that the 'block_compressor' recorded in the table's WiredTiger metadata resolves to the same
+ * compressor after a restart.
+ */
+class WiredTigerCompressionDictionary {
+public:
+    /**
+     * The name of the collection storage engine option holding the dictionary.
+     */
+    static constexpr StringData kOptionName = "compressionDictionary"_sd;
+
+    /**
+     * zlib only ever references the last 32KB of a preset dictionary.
+     */
+    static constexpr std::size_t kMaxDictionarySize = 32 * 1024;
+
+    /**
+     * Returns OK if 'elem' holds a usable dictionary, i.e. non-empty general BinData no larger
+     * than kMaxDictionarySize.
+     */
+    static Status validate(const BSONElement& elem);
+
+    /**
+     * Returns the name of the WiredTiger compressor that uses 'dictionary'.
+     */
+    static std::string compressorName(StringData dictionary);
+
+    /**
+     * Registers a compressor for 'dictionary' with 'conn' under compressorName(dictionary). The
+     * caller is responsible for registering each dictionary only once per connection.
+     */
+    static Status registerCompressor(WT_CONNECTION* conn, StringData dictionary);
+
+    /**
+     * Deflates 'src' into 'dst' against 'dictionary' and returns the compressed length. Returns
+     * an error if the compressed representation does not fit in 'dst'.
+     */
+    static StatusWith<std::size_t> compress(StringData dictionary,
+                                            ConstDataRange src,
+                                            DataRange dst);
+
+    /**
+     * Inflates 'src', which must have been produced by compress() with the same 'dictionary',
+     * into 'dst' and returns the decompressed length.
+     */
+    static StatusWith<std::size_t> decompress(StringData dictionary,
+                                              ConstDataRange src,
+                                              DataRange dst);
+};
+
+/**
+ * Builds a compression dictionary from a sample of a collection's documents.
+ *
+ * Small documents with a shared schema compress poorly one page at a time because each page has
+ * to re-learn the same field names. The trainer counts the raw BSON byte sequences which repeat
+ * across documents (the type byte and name of every field, as well as short string values) and
+ * keeps the ones which save the most bytes, ordered so that the most valuable sequences end up
+ * closest to the end of the dictionary where deflate finds them at the shortest distances.
+ */
+class WiredTigerCompressionDictionaryTrainer {
+public:
+    static constexpr std::size_t kDefaultMaxDictionarySize = 16 * 1024;
+
+    // String values longer than this are unlikely to repeat and are not considered.
+    static constexpr int kMaxStringValueSize = 64;
+
+    // Bounds the memory used for counting; new sequences are ignored once this many are tracked.
+    static constexpr std::size_t kMaxCandidates = 64 * 1024;
+
+    explicit WiredTigerCompressionDictionaryTrainer(
+        std::size_t maxDictionarySize = kDefaultMaxDictionarySize);
+
+    void addSample(const BSONObj& doc);
+
+    std::size_t numSamples() const {
+        return _numSamples;
+    }
+
+    /**
+     * Returns a dictionary of at most the configured size. Only sequences seen more than once
+     * are included, so the result may be empty if the samples share nothing.
+     */
+    std::string train() const;
+
+private:
+    void _addFields(const BSONObj& obj);
+
+    void _addCandidate(StringData bytes);
+
+    const std::size_t _maxDictionarySize;
+    std::size_t _numSamples = 0;
+    StringMap<std::size_t> _counts;
+};
+
+}  // namespace mongo
@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeSamples(int n) {
+    std::vector<BSONObj> samples;
+    for (int i = 0; i < n; i++) {
+        samples.push_back(BSON("customerIdentifier" << i << "status"
+                                                    << "active"
+                                                    << "address"
+                                                    << BSON("streetName"
+                                                            << "Main Street"
+                                                            << "postalCode"
+                                                            << i * 7)));
+    }
+    return samples;
+}
+
+std::string trainOn(const std::vector<BSONObj>& samples, std::size_t maxSize) {
+    WiredTigerCompressionDictionaryTrainer trainer(maxSize);
+    for (auto&& doc : samples) {
+        trainer.addSample(doc);
+    }
+    ASSERT_EQ(samples.size(), trainer.numSamples());
+    return trainer.train();
+}
+
+TEST(WiredTigerCompressionDictionaryTrainerTest, IncludesRepeatedFieldNames) {
+    const std::string dictionary = trainOn(makeSamples(100), 1024);
+    ASSERT_NE(std::string::npos, dictionary.find("customerIdentifier"));
+    ASSERT_NE(std::string::npos, dictionary.find("streetName"));
+    ASSERT_NE(std::string::npos, dictionary.find("Main Street"));
+}
+
+TEST(WiredTigerCompressionDictionaryTrainerTest, RespectsMaximumSize) {
+    ASSERT_LTE(trainOn(makeSamples(100), 16).size(), 16U);
+}
+
+TEST(WiredTigerCompressionDictionaryTrainerTest, IgnoresSequencesSeenOnlyOnce) {
+    ASSERT_EQ("", trainOn({BSON("onlyOnce" << 1)}, 1024));
+}
+
+TEST(WiredTigerCompressionDictionaryTest, RoundTrip) {
+    const auto samples = makeSamples(100);
+    const std::string dictionary = trainOn(samples, 4096);
+    ASSERT_FALSE(dictionary.empty());
+
+    BSONObjBuilder page;
+    for (size_t i = 0; i < samples.size(); i++) {
+        page.append(std::to_string(i), samples[i]);
+    }
+    const BSONObj input = page.obj();
+
+    std::vector<char> compressed(input.objsize());
+    auto compressedSize = WiredTigerCompressionDictionary::compress(
+        dictionary,
+        ConstDataRange(input.objdata(), input.objsize()),
+        DataRange(compressed.data(), compressed.size()));
+    ASSERT_OK(compressedSize.getStatus());
+    ASSERT_LT(compressedSize.getValue(), static_cast<size_t>(input.objsize()));
+
+    std::vector<char> decompressed(input.objsize());
+    auto decompressedSize = WiredTigerCompressionDictionary::decompress(
+        dictionary,
+        ConstDataRange(compressed.data(), compressedSize.getValue()),
+        DataRange(decompressed.data(), decompressed.size()));
+    ASSERT_OK(decompressedSize.getStatus());
+    ASSERT_EQ(static_cast<size_t>(input.objsize()), decompressedSize.getValue());
+    ASSERT_EQ(0, memcmp(input.objdata(), decompressed.data(), input.objsize()));
+}
+
+TEST(WiredTigerCompressionDictionaryTest, CompressFailsWhenOutputDoesNotFit) {
+    const BSONObj input = makeSamples(1)[0];
+    std::vector<char> compressed(4);
+    ASSERT_NOT_OK(WiredTigerCompressionDictionary::compress(
+                      "dictionary",
+                      ConstDataRange(input.objdata(), input.objsize()),
+                      DataRange(compressed.data(), compressed.size()))
+                      .getStatus());
+}
+
+TEST(WiredTigerCompressionDictionaryTest, CompressorNameDependsOnDictionary) {
+    ASSERT_EQ(WiredTigerCompressionDictionary::compressorName("abc"),
+              WiredTigerCompressionDictionary::compressorName("abc"));
+    ASSERT_NE(WiredTigerCompressionDictionary::compressorName("abc"),
+              WiredTigerCompressionDictionary::compressorName("abd"));
+}
+
+TEST(WiredTigerCompressionDictionaryTest, Validate) {
+    BSONObjBuilder bob;
+    bob.appendBinData("valid", 3, BinDataGeneral, "abc");
+    bob.appendBinData("empty", 0, BinDataGeneral, "");
+    bob.appendBinData("wrongSubtype", 3, bdtCustom, "abc");
+    bob.append("notBinData", "abc");
+    const std::string tooLarge(WiredTigerCompressionDictionary::kMaxDictionarySize + 1, 'x');
+    bob.appendBinData("tooLarge", tooLarge.size(), BinDataGeneral, tooLarge.data());
+    const BSONObj obj = bob.obj();
+
+    ASSERT_OK(WiredTigerCompressionDictionary::validate(obj["valid"]));
+    ASSERT_EQ(ErrorCodes::BadValue, WiredTigerCompressionDictionary::validate(obj["empty"]));
+    ASSERT_EQ(ErrorCodes::TypeMismatch,
+              WiredTigerCompressionDictionary::validate(obj["wrongSubtype"]));
+    ASSERT_EQ(ErrorCodes::TypeMismatch,
+              WiredTigerCompressionDictionary::validate(obj["notBinData"]));
+    ASSERT_EQ(ErrorCodes::BadValue, WiredTigerCompressionDictionary::validate(obj["tooLarge"]));
+}
+
+}  // namespace
+}  // namespace mongo
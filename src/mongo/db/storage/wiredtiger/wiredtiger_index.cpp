@@ -39,6 +39,7 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/json.h"
@@ -46,8 +47,10 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -153,6 +156,26 @@ StatusWith<std::string> WiredTigerIndex::parseIndexOptions(const BSONObj& option
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == WiredTigerCompressionDictionary::kOptionName) {
+            // Keys which share long leading components, such as URLs or tenant identifiers,
+            // repeat far more than the prefix compression of a leaf page can recover. A dictionary
+            // of those components lets block compression remove the rest.
+            Status status = WiredTigerCompressionDictionary::validate(elem);
+            if (!status.isOK()) {
+                return status;
+            }
+            int len;
+            const char* data = elem.binData(len);
+            ss << "block_compressor="
+               << WiredTigerCompressionDictionary::compressorName(StringData(data, len)) << ',';
+        } else if (elem.fieldNameStringData() == WiredTigerIndexKeyFilter::kOptionName) {
+            // The filter lives in memory only, so it has no bearing on the table configuration.
+            if (!elem.isBoolean()) {
+                return StatusWith<std::string>(
+                    ErrorCodes::TypeMismatch,
+                    str::stream() << '\'' << WiredTigerIndexKeyFilter::kOptionName
+                                  << "' must be a boolean");
+            }
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -665,11 +688,13 @@ public:
     UniqueBulkBuilder(WiredTigerIndex* idx,
                       OperationContext* opCtx,
                       bool dupsAllowed,
-                      KVPrefix prefix)
+                      KVPrefix prefix,
+                      WiredTigerIndexKeyFilter* keyFilter)
         : BulkBuilder(idx, opCtx, prefix),
           _idx(idx),
           _dupsAllowed(dupsAllowed),
-          _keyString(idx->keyStringVersion()) {}
+          _keyString(idx->keyStringVersion()),
+          _keyFilter(keyFilter) {}
 
     Status addKey(const BSONObj& newKey, const RecordId& id) override {
         if (_idx->isTimestampSafeUniqueIdx()) {
@@ -708,6 +733,11 @@ private:
             invariant(_previousKey.isEmpty() || cmp > 0);
         }
 
+        if (_keyFilter && cmp != 0) {
+            const KeyString prefixKey(_idx->keyStringVersion(), newKey, _idx->ordering());
+            _keyFilter->add(prefixKey.getBuffer(), prefixKey.getSize());
+        }
+
         _keyString.resetToKey(newKey, _idx->ordering(), id);
 
         // Can't use WiredTigerCursor since we aren't using the cache.
@@ -790,6 +820,7 @@ private:
     KeyString _keyString;
     std::vector<std::pair<RecordId, KeyString::TypeBits>> _records;
     BSONObj _previousKey;
+    WiredTigerIndexKeyFilter* const _keyFilter;
 };
 
 namespace {
@@ -1102,6 +1133,7 @@ protected:
 
         // Store (a copy of) the new item data as the current key for this cursor.
         _key.resetFromBuffer(item.data, item.size);
+        CurOp::get(_opCtx)->debug().additiveMetrics.incrementStorageBytesRead(item.size);
 
         if (atOrPastEndPointAfterSeeking()) {
             _eof = true;
@@ -1230,7 +1262,17 @@ WiredTigerIndexUnique::WiredTigerIndexUnique(OperationContext* ctx,
                                              const IndexDescriptor* desc,
                                              KVPrefix prefix,
                                              bool isReadOnly)
-    : WiredTigerIndex(ctx, uri, desc, prefix, isReadOnly), _partial(desc->isPartial()) {}
+    : WiredTigerIndex(ctx, uri, desc, prefix, isReadOnly), _partial(desc->isPartial()) {
+    // Prefixed indexes share their table, and timestamp unsafe ones detect duplicates with the
+    // insert itself, so only the remaining unique indexes have a search for the filter to skip.
+    const bool wantsKeyFilter = desc->infoObj()
+                                    .getObjectField("storageEngine")
+                                    .getObjectField(kWiredTigerEngineName)
+                                    .getBoolField(WiredTigerIndexKeyFilter::kOptionName);
+    if (wantsKeyFilter && isTimestampSafeUniqueIdx() && !prefix.isPrefixed() && !isReadOnly) {
+        _keyFilter = std::make_shared<WiredTigerIndexKeyFilter>();
+    }
+}
 
 std::unique_ptr<SortedDataInterface::Cursor> WiredTigerIndexUnique::newCursor(
     OperationContext* opCtx, bool forward) const {
@@ -1239,7 +1281,14 @@ std::unique_ptr<SortedDataInterface::Cursor> WiredTigerIndexUnique::newCursor(
 
 SortedDataBuilderInterface* WiredTigerIndexUnique::getBulkBuilder(OperationContext* opCtx,
                                                                   bool dupsAllowed) {
-    return new UniqueBulkBuilder(this, opCtx, dupsAllowed, _prefix);
+    return new UniqueBulkBuilder(this, opCtx, dupsAllowed, _prefix, _keyFilter.get());
+}
+
+void WiredTigerIndexUnique::appendIndexStats(BSONObjBuilder* builder) const {
+    if (_keyFilter) {
+        BSONObjBuilder filterBuilder(builder->subobjStart(WiredTigerIndexKeyFilter::kOptionName));
+        _keyFilter->appendStats(&filterBuilder);
+    }
 }
 
 bool WiredTigerIndexUnique::isTimestampSafeUniqueIdx() const {
@@ -1420,9 +1469,21 @@ Status WiredTigerIndexUnique::_insertTimestampSafe(OperationContext* opCtx,
         ret = WT_OP_CHECK(c->remove(c));
         invariantWTOK(ret);
 
-        // Second phase looks up for existence of key to avoid insertion of duplicate key
-        if (isDup(opCtx, c, key, id))
-            return dupKeyError(key);
+        // Second phase looks up for existence of key to avoid insertion of duplicate key. A key
+        // the filter has never seen cannot be in the table, so the search is skipped for it.
+        const bool mayBeDup =
+            !_keyFilter || _keyFilter->mayContain(prefixKey.getBuffer(), prefixKey.getSize());
+        if (_keyFilter)
+            _keyFilter->add(prefixKey.getBuffer(), prefixKey.getSize());
+        if (mayBeDup) {
+            if (isDup(opCtx, c, key, id))
+                return dupKeyError(key);
+            if (_keyFilter)
+                _keyFilter->recordFalsePositive();
+        }
+    } else if (_keyFilter) {
+        const KeyString prefixKey(keyStringVersion(), key, _ordering);
+        _keyFilter->add(prefixKey.getBuffer(), prefixKey.getSize());
     }
 
     // Now create the table key/value, the actual data record.
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <wiredtiger.h>
 
 #include "mongo/base/status_with.h"
@@ -42,6 +43,7 @@ namespace mongo {
 
 class IndexCatalogEntry;
 class IndexDescriptor;
+class WiredTigerIndexKeyFilter;
 struct WiredTigerItem;
 
 class WiredTigerIndex : public SortedDataInterface {
@@ -213,6 +215,16 @@ public:
                const BSONObj& key,
                const RecordId& id) override;
 
+    void appendIndexStats(BSONObjBuilder* builder) const override;
+
+    /**
+     * Returns the filter that lets inserts skip their duplicate key search, if the index was
+     * created with the 'uniqueKeyFilter' option. The filter must be built before it is used.
+     */
+    const std::shared_ptr<WiredTigerIndexKeyFilter>& getKeyFilter() const {
+        return _keyFilter;
+    }
+
     Status _insert(OperationContext* opCtx,
                    WT_CURSOR* c,
                    const BSONObj& key,
@@ -251,6 +263,8 @@ public:
 
 private:
     bool _partial;
+
+    std::shared_ptr<WiredTigerIndexKeyFilter> _keyFilter;
 };
 
 class WiredTigerIndexStandard : public WiredTigerIndex {
@@ -0,0 +1,355 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
+
+#include <algorithm>
+#include <MurmurHash3.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr StringData WiredTigerIndexKeyFilter::kOptionName;
+constexpr std::size_t WiredTigerIndexKeyFilter::kBitsPerKey;
+constexpr std::size_t WiredTigerIndexKeyFilter::kProbes;
+constexpr std::size_t WiredTigerIndexKeyFilter::kMinCapacity;
+constexpr std::size_t WiredTigerIndexKeyFilter::kMaxPendingKeys;
+constexpr std::size_t WiredTigerIndexKeyFilterBuilder::kBatchSize;
+
+namespace {
+
+// A block is one 64-byte cache line.
+constexpr std::size_t kWordsPerBlock = 8;
+constexpr std::size_t kBitsPerBlock = kWordsPerBlock * 64;
+
+// Each probe consumes 9 bits of the hash to pick one of the 512 bits of the block.
+constexpr std::size_t kBitsPerProbe = 9;
+static_assert(WiredTigerIndexKeyFilter::kProbes * kBitsPerProbe <= 64,
+              "The probes of a key must fit in one 64-bit hash");
+static_assert((1 << kBitsPerProbe) == kBitsPerBlock, "A probe must address a whole block");
+
+}  // namespace
+
+WiredTigerIndexKeyFilter::Hash WiredTigerIndexKeyFilter::_hash(const void* key, std::size_t size) {
+    char hash[16];
+    MurmurHash3_x64_128(key, size, 0, hash);
+    return {ConstDataView(hash).read<LittleEndian<uint64_t>>(),
+            ConstDataView(hash).read<LittleEndian<uint64_t>>(8)};
+}
+
+void WiredTigerIndexKeyFilter::_set(const Hash& hash) {
+    std::atomic<uint64_t>* block = &_blocks[(hash.block % _numBlocks) * kWordsPerBlock];
+    for (std::size_t i = 0; i < kProbes; ++i) {
+        const std::size_t bit = (hash.bits >> (i * kBitsPerProbe)) & (kBitsPerBlock - 1);
+        block[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_release);
+    }
+}
+
+bool WiredTigerIndexKeyFilter::_test(const Hash& hash) const {
+    const std::atomic<uint64_t>* block = &_blocks[(hash.block % _numBlocks) * kWordsPerBlock];
+    for (std::size_t i = 0; i < kProbes; ++i) {
+        const std::size_t bit = (hash.bits >> (i * kBitsPerProbe)) & (kBitsPerBlock - 1);
+        if (!(block[bit / 64].load(std::memory_order_acquire) & (uint64_t(1) << (bit % 64))))
+            return false;
+    }
+    return true;
+}
+
+void WiredTigerIndexKeyFilter::add(const void* key, std::size_t size) {
+    if (_abandoned.load())
+        return;
+
+    _keys.fetchAndAdd(1);
+    const Hash hash = _hash(key, size);
+    if (!_allocated.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_allocated.load()) {
+            if (_pending.size() < kMaxPendingKeys) {
+                _pending.push_back(hash);
+            } else {
+                _pendingOverflowed = true;
+            }
+            return;
+        }
+    }
+    _set(hash);
+}
+
+bool WiredTigerIndexKeyFilter::mayContain(const void* key, std::size_t size) {
+    _checks.fetchAndAdd(1);
+    if (!_ready.load() || isSaturated())
+        return true;
+    if (_test(_hash(key, size)))
+        return true;
+    _definitelyAbsent.fetchAndAdd(1);
+    return false;
+}
+
+void WiredTigerIndexKeyFilter::recordFalsePositive() {
+    if (_ready.load() && !isSaturated())
+        _falsePositives.fetchAndAdd(1);
+}
+
+bool WiredTigerIndexKeyFilter::allocate(std::size_t expectedKeys) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_allocated.load());
+    if (_pendingOverflowed || _abandoned.load()) {
+        _abandoned.store(true);
+        std::vector<Hash>().swap(_pending);
+        return false;
+    }
+
+    _capacity = std::max(kMinCapacity, expectedKeys + expectedKeys / 2);
+    _numBlocks = (_capacity * kBitsPerKey + kBitsPerBlock - 1) / kBitsPerBlock;
+    _blocks.reset(new std::atomic<uint64_t>[_numBlocks * kWordsPerBlock]);
+    for (std::size_t i = 0; i < _numBlocks * kWordsPerBlock; ++i) {
+        _blocks[i].store(0, std::memory_order_relaxed);
+    }
+
+    for (const auto& hash : _pending) {
+        _set(hash);
+    }
+    std::vector<Hash>().swap(_pending);
+
+    _allocated.store(true);
+    return true;
+}
+
+void WiredTigerIndexKeyFilter::markReady() {
+    invariant(_allocated.load());
+    _ready.store(true);
+}
+
+void WiredTigerIndexKeyFilter::abandon() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _abandoned.store(true);
+    std::vector<Hash>().swap(_pending);
+}
+
+bool WiredTigerIndexKeyFilter::isSaturated() const {
+    // Past twice its capacity the filter answers "possibly present" for most absent keys anyway.
+    return _allocated.load() &&
+        static_cast<std::size_t>(_keys.load()) > 2 * static_cast<std::size_t>(_capacity);
+}
+
+void WiredTigerIndexKeyFilter::appendStats(BSONObjBuilder* builder) const {
+    builder->append("ready", isReady());
+    builder->append("saturated", isSaturated());
+    builder->append("capacity", static_cast<long long>(_allocated.load() ? _capacity : 0));
+    builder->append("keysAdded", _keys.load());
+    builder->append("checks", _checks.load());
+    builder->append("checksSkipped", _definitelyAbsent.load());
+    builder->append("falsePositives", _falsePositives.load());
+}
+
+namespace {
+
+ThreadPool::Options makeThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "WTIndexKeyFilter";
+    options.minThreads = 0;
+    options.maxThreads = 2;
+    return options;
+}
+
+/**
+ * Returns the size of the prefix key of a timestamp safe unique index entry, which is the entry's
+ * key without the RecordId at its end. The RecordId encoding stores its size in the low 3 bits of
+ * its last byte, as KeyString::decodeRecordIdAtEnd() reads it.
+ */
+std::size_t prefixKeySize(const WT_ITEM& key) {
+    if (key.size < 2)
+        return key.size;
+    const unsigned char lastByte = static_cast<const unsigned char*>(key.data)[key.size - 1];
+    const std::size_t ridSize = 2 + (lastByte & 0x7);
+
+    // Entries in the timestamp unsafe format, left behind by an upgrade, are only a prefix key.
+    // Whatever part of them is added, the first phase of an insert detects those duplicates.
+    return key.size > ridSize ? key.size - ridSize : key.size;
+}
+
+/**
+ * Calls 'fn' with every key of the index table 'uri' in batches of 'kBatchSize', releasing the
+ * cursor between batches. Returns true if the whole table was read.
+ */
+bool walkIndexTable(WiredTigerSession* session,
+                    const std::weak_ptr<WiredTigerIndexKeyFilter>& weakFilter,
+                    const std::string& uri,
+                    uint64_t tableId,
+                    const AtomicWord<bool>& shuttingDown,
+                    stdx::function<void(WiredTigerIndexKeyFilter*, const WT_ITEM&)> fn) {
+    std::string resumeKey;
+    bool resuming = false;
+    while (true) {
+        if (shuttingDown.load())
+            return false;
+
+        auto filter = weakFilter.lock();
+        if (!filter)
+            return false;
+
+        WT_CURSOR* c = session->getCursor(uri, tableId, false);
+        if (!c) {
+            // The table was dropped.
+            return false;
+        }
+        ON_BLOCK_EXIT([&] { session->releaseCursor(tableId, c); });
+
+        int ret;
+        if (resuming) {
+            // Releasing the cursor gave up its position, so find the first key not yet read.
+            WT_ITEM item;
+            item.data = resumeKey.data();
+            item.size = resumeKey.size();
+            c->set_key(c, &item);
+            int cmp;
+            ret = c->search_near(c, &cmp);
+            if (ret == 0 && cmp < 0)
+                ret = c->next(c);
+        } else {
+            ret = c->next(c);
+        }
+
+        WT_ITEM key;
+        for (std::size_t n = 0; ret == 0 && n < WiredTigerIndexKeyFilterBuilder::kBatchSize;
+             ++n) {
+            if (c->get_key(c, &key) != 0)
+                return false;
+            fn(filter.get(), key);
+            ret = c->next(c);
+        }
+
+        if (ret == WT_NOTFOUND)
+            return true;
+        if (ret != 0) {
+            // Any failure, including a prepare conflict, ends the build.
+            LOG(1) << "Stopped reading " << uri << " for its key filter: " << wtRCToStatus(ret);
+            return false;
+        }
+        if (c->get_key(c, &key) != 0)
+            return false;
+        resumeKey.assign(static_cast<const char*>(key.data), key.size);
+        resuming = true;
+    }
+}
+
+}  // namespace
+
+WiredTigerIndexKeyFilterBuilder::WiredTigerIndexKeyFilterBuilder(
+    WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache), _pool(stdx::make_unique<ThreadPool>(makeThreadPoolOptions())) {
+    _pool->startup();
+}
+
+WiredTigerIndexKeyFilterBuilder::~WiredTigerIndexKeyFilterBuilder() {
+    shutdown();
+}
+
+void WiredTigerIndexKeyFilterBuilder::shutdown() {
+    _shuttingDown.store(true);
+    _pool->shutdown();
+    _pool->join();
+}
+
+void WiredTigerIndexKeyFilterBuilder::schedule(
+    const std::shared_ptr<WiredTigerIndexKeyFilter>& filter,
+    const std::string& uri,
+    uint64_t tableId) {
+    std::weak_ptr<WiredTigerIndexKeyFilter> weakFilter = filter;
+    Status status =
+        _pool->schedule([this, weakFilter, uri, tableId] { build(weakFilter, uri, tableId); });
+    if (!status.isOK()) {
+        // The pool is shutting down.
+        filter->abandon();
+    }
+}
+
+bool WiredTigerIndexKeyFilterBuilder::build(
+    const std::weak_ptr<WiredTigerIndexKeyFilter>& weakFilter,
+    const std::string& uri,
+    uint64_t tableId) {
+    auto abandon = MakeGuard([&] {
+        if (auto filter = weakFilter.lock())
+            filter->abandon();
+    });
+
+    auto session = _sessionCache->getSession();
+
+    // Size the filter from the number of entries the table holds now. Keys inserted meanwhile
+    // are kept pending by the filter itself.
+    std::size_t numKeys = 0;
+    if (!walkIndexTable(session.get(),
+                        weakFilter,
+                        uri,
+                        tableId,
+                        _shuttingDown,
+                        [&](WiredTigerIndexKeyFilter*, const WT_ITEM&) { ++numKeys; })) {
+        return false;
+    }
+
+    {
+        auto filter = weakFilter.lock();
+        if (!filter || !filter->allocate(numKeys))
+            return false;
+    }
+
+    if (!walkIndexTable(session.get(),
+                        weakFilter,
+                        uri,
+                        tableId,
+                        _shuttingDown,
+                        [](WiredTigerIndexKeyFilter* filter, const WT_ITEM& key) {
+                            filter->add(key.data, prefixKeySize(key));
+                        })) {
+        return false;
+    }
+
+    auto filter = weakFilter.lock();
+    if (!filter)
+        return false;
+    filter->markReady();
+    abandon.Dismiss();
+    LOG(1) << "Built the key filter of " << uri << " from " << numKeys << " entries";
+    return true;
+}
+
+}  // namespace mongo
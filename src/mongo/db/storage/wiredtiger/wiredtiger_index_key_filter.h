@@ -0,0 +1,203 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ThreadPool;
+class WiredTigerSessionCache;
+
+/**
+ * A blocked Bloom filter over the prefix keys (the KeyString of an index key without its
+ * RecordId) of a timestamp safe unique index.
+ *
+ * An insert into such an index searches the table for an entry with the same prefix key before
+ * writing its own. A key the filter has never seen cannot be in the table, so that search can be
+ * skipped. Only the answer "definitely absent" is trusted: until the filter has been populated
+ * from the table, and once it holds so many keys that its false positive rate degrades, every key
+ * is reported as possibly present and the search always runs.
+ *
+ * Keys are added before they are written to the table and never removed, so the filter errs only
+ * towards false positives. Because a key is added as soon as the filter exists, the filter must be
+ * created together with the index object that writes to the table. Until the background build has
+ * sized it, added keys are kept in a bounded pending list which is folded in once the bits exist.
+ *
+ * Each key sets kProbes bits within a single 512-bit block, so a lookup touches one cache line.
+ */
+class WiredTigerIndexKeyFilter {
+    MONGO_DISALLOW_COPYING(WiredTigerIndexKeyFilter);
+
+public:
+    // The boolean 'storageEngine.wiredTiger' index option which enables the filter.
+    static constexpr StringData kOptionName = "uniqueKeyFilter"_sd;
+
+    static constexpr std::size_t kBitsPerKey = 10;
+    static constexpr std::size_t kProbes = 6;
+
+    // The filter is never sized for fewer keys than this, leaving room for the index to grow.
+    static constexpr std::size_t kMinCapacity = 64 * 1024;
+
+    // Keys added before the filter is sized beyond this many abandon the build.
+    static constexpr std::size_t kMaxPendingKeys = 1024 * 1024;
+
+    WiredTigerIndexKeyFilter() = default;
+
+    /**
+     * Records that 'key' is about to be written to the index. Safe to call concurrently.
+     */
+    void add(const void* key, std::size_t size);
+
+    /**
+     * Returns false only if 'key' was never added. Counts the check towards the statistics.
+     */
+    bool mayContain(const void* key, std::size_t size);
+
+    /**
+     * Counts a key reported as possibly present that the search did not find. Keys checked before
+     * the filter was ready or after it saturated are not counted.
+     */
+    void recordFalsePositive();
+
+    /**
+     * Allocates the bits for 'expectedKeys' keys plus headroom and folds in any pending keys.
+     * Returns false if too many keys were pending, in which case the filter stays unusable.
+     */
+    bool allocate(std::size_t expectedKeys);
+
+    /**
+     * Called once every key already in the table has been added. From then on the filter answers
+     * lookups until it saturates.
+     */
+    void markReady();
+
+    /**
+     * Gives up on the filter: it never becomes ready and stops tracking keys.
+     */
+    void abandon();
+
+    bool isReady() const {
+        return _ready.load();
+    }
+
+    bool isSaturated() const;
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Hash {
+        uint64_t block;
+        uint64_t bits;
+    };
+
+    static Hash _hash(const void* key, std::size_t size);
+
+    void _set(const Hash& hash);
+    bool _test(const Hash& hash) const;
+
+    // Guards '_pending' and the publication of '_blocks'.
+    stdx::mutex _mutex;
+    std::vector<Hash> _pending;
+    bool _pendingOverflowed = false;
+
+    // Written once under '_mutex' before '_allocated' is set.
+    std::unique_ptr<std::atomic<uint64_t>[]> _blocks;
+    std::size_t _numBlocks = 0;
+    std::size_t _capacity = 0;
+    AtomicWord<bool> _allocated{false};
+
+    AtomicWord<bool> _ready{false};
+    AtomicWord<bool> _abandoned{false};
+
+    AtomicInt64 _keys;
+    AtomicInt64 _checks;
+    AtomicInt64 _definitelyAbsent;
+    AtomicInt64 _falsePositives;
+};
+
+/**
+ * Populates unique index key filters in the background.
+ *
+ * A build opens its own session from the session cache, counts the entries of the index table to
+ * size the filter, then walks the table again adding every prefix key. The table is read in
+ * batches, releasing the cursor in between so that it never blocks a drop for long. A build stops
+ * when the index is closed, the table is dropped, or on any error, leaving its filter unused.
+ */
+class WiredTigerIndexKeyFilterBuilder {
+    MONGO_DISALLOW_COPYING(WiredTigerIndexKeyFilterBuilder);
+
+public:
+    static constexpr std::size_t kBatchSize = 10 * 1000;
+
+    explicit WiredTigerIndexKeyFilterBuilder(WiredTigerSessionCache* sessionCache);
+    ~WiredTigerIndexKeyFilterBuilder();
+
+    /**
+     * Asynchronously populates 'filter' from the table 'uri'. The builder keeps only a weak
+     * reference, so a filter whose index goes away is not built any further.
+     */
+    void schedule(const std::shared_ptr<WiredTigerIndexKeyFilter>& filter,
+                  const std::string& uri,
+                  uint64_t tableId);
+
+    /**
+     * Populates 'filter' from the table 'uri' on the calling thread. Returns true if the filter
+     * became ready.
+     */
+    bool build(const std::weak_ptr<WiredTigerIndexKeyFilter>& filter,
+               const std::string& uri,
+               uint64_t tableId);
+
+    /**
+     * Stops accepting new builds, interrupts the running ones at their next batch and waits for
+     * them to finish. Must be called before the session cache is shut down.
+     */
+    void shutdown();
+
+private:
+    WiredTigerSessionCache* const _sessionCache;
+    std::unique_ptr<ThreadPool> _pool;
+
+    AtomicWord<bool> _shuttingDown{false};
+};
+
+}  // namespace mongo
@@ -0,0 +1,221 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
+
+#include <memory>
+#include <string>
+#include <wiredtiger.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kOrdering = Ordering::make(BSON("a" << 1));
+
+void addKey(WiredTigerIndexKeyFilter* filter, int i) {
+    const KeyString key(KeyString::Version::V1, BSON("" << i), kOrdering);
+    filter->add(key.getBuffer(), key.getSize());
+}
+
+bool mayContain(WiredTigerIndexKeyFilter* filter, int i) {
+    const KeyString key(KeyString::Version::V1, BSON("" << i), kOrdering);
+    return filter->mayContain(key.getBuffer(), key.getSize());
+}
+
+TEST(WiredTigerIndexKeyFilterTest, ReportsEveryKeyPresentUntilReady) {
+    WiredTigerIndexKeyFilter filter;
+    ASSERT_TRUE(mayContain(&filter, 1));
+
+    ASSERT_TRUE(filter.allocate(0));
+    ASSERT_TRUE(mayContain(&filter, 1));
+
+    filter.markReady();
+    ASSERT_FALSE(mayContain(&filter, 1));
+}
+
+TEST(WiredTigerIndexKeyFilterTest, NeverReportsAnAddedKeyAbsent) {
+    WiredTigerIndexKeyFilter filter;
+
+    // Keys added before the filter is sized must survive the allocation.
+    for (int i = 0; i < 1000; i++) {
+        addKey(&filter, i);
+    }
+    ASSERT_TRUE(filter.allocate(1000));
+    for (int i = 1000; i < 2000; i++) {
+        addKey(&filter, i);
+    }
+    filter.markReady();
+
+    for (int i = 0; i < 2000; i++) {
+        ASSERT_TRUE(mayContain(&filter, i)) << i;
+    }
+}
+
+TEST(WiredTigerIndexKeyFilterTest, ReportsMostAbsentKeysAbsent) {
+    WiredTigerIndexKeyFilter filter;
+    ASSERT_TRUE(filter.allocate(WiredTigerIndexKeyFilter::kMinCapacity));
+    for (int i = 0; i < static_cast<int>(WiredTigerIndexKeyFilter::kMinCapacity); i++) {
+        addKey(&filter, i);
+    }
+    filter.markReady();
+
+    const int numAbsent = 10000;
+    int falsePositives = 0;
+    for (int i = -numAbsent; i < 0; i++) {
+        if (mayContain(&filter, i))
+            falsePositives++;
+    }
+    // Ten bits per key give a false positive rate of about 1%.
+    ASSERT_LT(falsePositives, numAbsent / 20);
+
+    BSONObjBuilder builder;
+    filter.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(numAbsent, stats["checks"].numberLong());
+    ASSERT_EQ(numAbsent - falsePositives, stats["checksSkipped"].numberLong());
+}
+
+TEST(WiredTigerIndexKeyFilterTest, StopsAnsweringOnceSaturated) {
+    WiredTigerIndexKeyFilter filter;
+    ASSERT_TRUE(filter.allocate(0));
+    filter.markReady();
+    ASSERT_FALSE(mayContain(&filter, -1));
+
+    for (int i = 0; i <= static_cast<int>(2 * WiredTigerIndexKeyFilter::kMinCapacity); i++) {
+        addKey(&filter, i);
+    }
+    ASSERT_TRUE(filter.isSaturated());
+    ASSERT_TRUE(mayContain(&filter, -1));
+}
+
+TEST(WiredTigerIndexKeyFilterTest, AbandonedFilterNeverBecomesUsable) {
+    WiredTigerIndexKeyFilter filter;
+    addKey(&filter, 1);
+    filter.abandon();
+    ASSERT_FALSE(filter.allocate(1));
+    ASSERT_TRUE(mayContain(&filter, 2));
+}
+
+class KeyFilterBuilderTest : public unittest::Test {
+public:
+    KeyFilterBuilderTest() : _dbpath("wt_key_filter_test") {
+        invariantWTOK(wiredtiger_open(_dbpath.path().c_str(), NULL, "create", &_conn));
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+    }
+
+    ~KeyFilterBuilderTest() {
+        _sessionCache.reset();
+        _conn->close(_conn, NULL);
+    }
+
+protected:
+    /**
+     * Creates an index table holding the keys 0, 2, 4, ... up to 'numKeys' entries, each followed
+     * by a RecordId as in a timestamp safe unique index.
+     */
+    void createIndexTable(int numKeys) {
+        WiredTigerSession session(_conn);
+        WT_SESSION* s = session.getSession();
+        invariantWTOK(s->create(s, kUri.c_str(), "key_format=u,value_format=u"));
+
+        WT_CURSOR* c;
+        invariantWTOK(s->open_cursor(s, kUri.c_str(), NULL, NULL, &c));
+        for (int i = 0; i < numKeys; i++) {
+            const KeyString key(
+                KeyString::Version::V1, BSON("" << 2 * i), kOrdering, RecordId(i + 1));
+            WiredTigerItem keyItem(key.getBuffer(), key.getSize());
+            WiredTigerItem valueItem("", 0);
+            c->set_key(c, keyItem.Get());
+            c->set_value(c, valueItem.Get());
+            invariantWTOK(c->insert(c));
+        }
+        invariantWTOK(c->close(c));
+    }
+
+    const std::string kUri = "table:key_filter";
+
+    unittest::TempDir _dbpath;
+    WT_CONNECTION* _conn;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+TEST_F(KeyFilterBuilderTest, BuildAddsThePrefixKeyOfEveryEntry) {
+    // More entries than one batch, so that the build has to resume its scan.
+    const int numKeys = WiredTigerIndexKeyFilterBuilder::kBatchSize + 100;
+    createIndexTable(numKeys);
+
+    auto filter = std::make_shared<WiredTigerIndexKeyFilter>();
+    WiredTigerIndexKeyFilterBuilder builder(_sessionCache.get());
+    ASSERT_TRUE(builder.build(filter, kUri, WiredTigerSession::genTableId()));
+    ASSERT_TRUE(filter->isReady());
+
+    int oddKeysPresent = 0;
+    for (int i = 0; i < numKeys; i++) {
+        ASSERT_TRUE(mayContain(filter.get(), 2 * i)) << 2 * i;
+        if (mayContain(filter.get(), 2 * i + 1))
+            oddKeysPresent++;
+    }
+    ASSERT_LT(oddKeysPresent, numKeys / 20);
+    builder.shutdown();
+}
+
+TEST_F(KeyFilterBuilderTest, BuildStopsWhenTheIndexGoesAway) {
+    createIndexTable(10);
+
+    std::weak_ptr<WiredTigerIndexKeyFilter> weakFilter;
+    {
+        auto filter = std::make_shared<WiredTigerIndexKeyFilter>();
+        weakFilter = filter;
+    }
+    WiredTigerIndexKeyFilterBuilder builder(_sessionCache.get());
+    ASSERT_FALSE(builder.build(weakFilter, kUri, WiredTigerSession::genTableId()));
+    builder.shutdown();
+}
+
+TEST_F(KeyFilterBuilderTest, BuildStopsWhenTheTableDoesNotExist) {
+    auto filter = std::make_shared<WiredTigerIndexKeyFilter>();
+    WiredTigerIndexKeyFilterBuilder builder(_sessionCache.get());
+    ASSERT_FALSE(builder.build(filter, kUri, WiredTigerSession::genTableId()));
+    ASSERT_FALSE(filter->isReady());
+    builder.shutdown();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -93,5 +94,17 @@ TEST(WiredTigerIndexTest, GenerateCreateStringValidConfigStringOption) {
     ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerIndexTest, GenerateCreateStringCompressionDictionary) {
+    BSONObjBuilder bob;
+    bob.appendBinData("compressionDictionary", 3, BinDataGeneral, "abc");
+    ASSERT_EQ(WiredTigerIndex::parseIndexOptions(bob.obj()),
+              "block_compressor=" + WiredTigerCompressionDictionary::compressorName("abc") + ",");
+}
+
+TEST(WiredTigerIndexTest, GenerateCreateStringInvalidCompressionDictionary) {
+    BSONObj spec = fromjson("{compressionDictionary: 'abc'}");
+    ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), ErrorCodes::TypeMismatch);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -70,14 +70,18 @@
 #include "mongo/db/snapshot_window_options.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_index_key_filter.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
@@ -572,6 +576,13 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         _checkpointThread->go();
     }
 
+    if (!_ephemeral) {
+        _readAhead = stdx::make_unique<WiredTigerReadAhead>(_sessionCache.get());
+    }
+    if (!_readOnly) {
+        _keyFilterBuilder = stdx::make_unique<WiredTigerIndexKeyFilterBuilder>(_sessionCache.get());
+    }
+
     _sizeStorerUri = _uri("sizeStorer");
     WiredTigerSession session(_conn);
     if (!_readOnly && repair && _hasUri(session.getSession(), _sizeStorerUri)) {
@@ -582,6 +593,12 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    if (WiredTigerTicketAdjuster::isEnabled()) {
+        _ticketAdjuster = stdx::make_unique<WiredTigerTicketAdjuster>(
+            _sessionCache.get(), &openReadTransaction, &openWriteTransaction);
+        _ticketAdjuster->go();
+    }
 }
 
 
@@ -600,6 +617,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        openWriteTransaction.appendWaitStats(&bbb);
         bbb.done();
     }
     {
@@ -607,6 +625,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        openReadTransaction.appendWaitStats(&bbb);
         bbb.done();
     }
     bb.done();
@@ -621,6 +640,21 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketAdjuster) {
+        log() << "Shutting down ticket adjuster thread";
+        _ticketAdjuster->shutdown();
+        log() << "Finished shutting down ticket adjuster thread";
+    }
+    if (_readAhead) {
+        log() << "Shutting down read-ahead threads";
+        _readAhead->shutdown();
+        log() << "Finished shutting down read-ahead threads";
+    }
+    if (_keyFilterBuilder) {
+        log() << "Shutting down index key filter threads";
+        _keyFilterBuilder->shutdown();
+        log() << "Finished shutting down index key filter threads";
+    }
     if (_journalFlusher) {
         log() << "Shutting down journal flusher thread";
         _journalFlusher->shutdown();
@@ -783,6 +817,50 @@ void WiredTigerKVEngine::endBackup(OperationContext* opCtx) {
     _backupSession.reset();
 }
 
+StatusWith<std::vector<std::string>> WiredTigerKVEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    invariant(!_backupSession);
+
+    if (_ephemeral) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The inMemory Storage Engine has no files to back up");
+    }
+
+    // As in beginBackup(), the cursor is freed when the uncached backupSession is closed. It
+    // lists the files holding the last checkpoint, which WiredTiger keeps until it is closed.
+    auto session = stdx::make_unique<WiredTigerSession>(_conn);
+    WT_CURSOR* c = NULL;
+    WT_SESSION* s = session->getSession();
+    int ret = WT_OP_CHECK(s->open_cursor(s, "backup:", NULL, NULL, &c));
+    if (ret != 0) {
+        return wtRCToStatus(ret);
+    }
+
+    std::vector<std::string> filenames;
+    const char* filename;
+    while ((ret = c->next(c)) == 0) {
+        invariantWTOK(c->get_key(c, &filename));
+
+        // The log files are kept in the journal directory, while the other files are listed
+        // relative to the dbpath.
+        std::string name(filename);
+        if (StringData(name).startsWith("WiredTigerLog.")) {
+            name = "journal/" + name;
+        }
+        filenames.push_back(std::move(name));
+    }
+    if (ret != WT_NOTFOUND) {
+        return wtRCToStatus(ret);
+    }
+
+    _backupSession = std::move(session);
+    return std::move(filenames);
+}
+
+void WiredTigerKVEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    _backupSession.reset();
+}
+
 void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
     if (!_sizeStorer)
         return;
@@ -814,6 +892,11 @@ Status WiredTigerKVEngine::createGroupedRecordStore(OperationContext* opCtx,
     _ensureIdentPath(ident);
     WiredTigerSession session(_conn);
 
+    Status dictionaryStatus = _registerCompressionDictionary(options.storageEngine);
+    if (!dictionaryStatus.isOK()) {
+        return dictionaryStatus;
+    }
+
     const bool prefixed = prefix.isPrefixed();
     StatusWith<std::string> result = WiredTigerRecordStore::generateCreateString(
         _canonicalName, ns, options, _rsOptions, prefixed);
@@ -898,6 +981,8 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     const CollectionOptions& options,
     KVPrefix prefix) {
 
+    fassert(50875, _registerCompressionDictionary(options.storageEngine));
+
     WiredTigerRecordStore::Params params;
     params.ns = ns;
     params.uri = _uri(ident);
@@ -935,12 +1020,47 @@ string WiredTigerKVEngine::_uri(StringData ident) const {
     return string("table:") + ident.toString();
 }
 
+Status WiredTigerKVEngine::_registerCompressionDictionary(const BSONObj& storageEngineOptions) {
+    BSONElement elem = storageEngineOptions.getObjectField(_canonicalName)
+                           .getField(WiredTigerCompressionDictionary::kOptionName);
+    if (elem.eoo()) {
+        return Status::OK();
+    }
+
+    Status status = WiredTigerCompressionDictionary::validate(elem);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    int len;
+    const char* data = elem.binData(len);
+    StringData dictionary(data, len);
+
+    stdx::lock_guard<stdx::mutex> lk(_dictionaryCompressorsMutex);
+    auto name = WiredTigerCompressionDictionary::compressorName(dictionary);
+    if (_dictionaryCompressors.count(name)) {
+        return Status::OK();
+    }
+
+    status = WiredTigerCompressionDictionary::registerCompressor(_conn, dictionary);
+    if (status.isOK()) {
+        _dictionaryCompressors.insert(std::move(name));
+    }
+    return status;
+}
+
 Status WiredTigerKVEngine::createGroupedSortedDataInterface(OperationContext* opCtx,
                                                             StringData ident,
                                                             const IndexDescriptor* desc,
                                                             KVPrefix prefix) {
     _ensureIdentPath(ident);
 
+    Status dictionaryStatus =
+        _registerCompressionDictionary(desc->infoObj().getObjectField("storageEngine"));
+    if (!dictionaryStatus.isOK()) {
+        return dictionaryStatus;
+    }
+
     std::string collIndexOptions;
     const Collection* collection = desc->getCollection();
 
@@ -975,8 +1095,14 @@ SortedDataInterface* WiredTigerKVEngine::getGroupedSortedDataInterface(Operation
                                                                        StringData ident,
                                                                        const IndexDescriptor* desc,
                                                                        KVPrefix prefix) {
+    fassert(50910, _registerCompressionDictionary(desc->infoObj().getObjectField("storageEngine")));
+
     if (desc->unique()) {
-        return new WiredTigerIndexUnique(opCtx, _uri(ident), desc, prefix, _readOnly);
+        auto index = new WiredTigerIndexUnique(opCtx, _uri(ident), desc, prefix, _readOnly);
+        if (index->getKeyFilter() && _keyFilterBuilder) {
+            _keyFilterBuilder->schedule(index->getKeyFilter(), index->uri(), index->tableId());
+        }
+        return index;
     }
 
     return new WiredTigerIndexStandard(opCtx, _uri(ident), desc, prefix, _readOnly);
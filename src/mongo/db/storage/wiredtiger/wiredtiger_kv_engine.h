@@ -33,6 +33,7 @@
 
 #include <list>
 #include <memory>
+#include <set>
 #include <string>
 
 #include <boost/filesystem/path.hpp>
@@ -52,9 +53,12 @@ namespace mongo {
 
 class ClockSource;
 class JournalListener;
+class WiredTigerIndexKeyFilterBuilder;
+class WiredTigerReadAhead;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
+class WiredTigerTicketAdjuster;
 
 struct WiredTigerFileVersion {
     enum class StartupVersion { IS_34, IS_36, IS_40, IS_42 };
@@ -162,6 +166,11 @@ public:
 
     virtual void endBackup(OperationContext* opCtx) override;
 
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(
+        OperationContext* opCtx) override;
+
+    virtual void endNonBlockingBackup(OperationContext* opCtx) override;
+
     virtual int64_t getIdentSize(OperationContext* opCtx, StringData ident) override;
 
     virtual Status repairIdent(OperationContext* opCtx, StringData ident) override;
@@ -251,6 +260,14 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Returns the background reader used to prefetch records ahead of forward scans, or nullptr
+     * for ephemeral engines, whose data is always in memory.
+     */
+    WiredTigerReadAhead* getReadAhead() const {
+        return _readAhead.get();
+    }
+
     /*
      * This function is called when replication has completed a batch.  In this function, we
      * refresh our oplog visiblity read-at-timestamp value.
@@ -301,6 +318,13 @@ private:
 
     std::string _uri(StringData ident) const;
 
+    /**
+     * Registers the compressor for the compression dictionary in the 'storageEngineOptions' of a
+     * collection or index, if there is one and it has not been registered with this connection
+     * yet. Must be called before the table is created or opened.
+     */
+    Status _registerCompressionDictionary(const BSONObj& storageEngineOptions);
+
     /**
      * Uses the 'stableTimestamp', the 'targetSnapshotHistoryWindowInSeconds' setting and the
      * current _oldestTimestamp to calculate what the new oldest_timestamp should be, in order to
@@ -342,10 +366,17 @@ private:
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerReadAhead> _readAhead;  // Depends on _sessionCache
+    std::unique_ptr<WiredTigerIndexKeyFilterBuilder> _keyFilterBuilder;  // Depends on _sessionCache
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;  // Depends on _sessionCache
 
     std::string _rsOptions;
     std::string _indexOptions;
 
+    // Names of the dictionary compressors registered with '_conn'.
+    stdx::mutex _dictionaryCompressorsMutex;
+    std::set<std::string> _dictionaryCompressors;
+
     mutable stdx::mutex _dropAllQueuesMutex;
     mutable stdx::mutex _identToDropMutex;
     std::list<std::string> _identToDrop;
@@ -231,6 +231,33 @@ TEST_F(WiredTigerKVEngineRepairTest, UnrecoverableOrphanedDataFilesFailGracefull
     ASSERT_NOT_OK(_engine->recoverOrphanedIdent(opCtxPtr.get(), ns, ident, options));
 }
 
+TEST_F(WiredTigerKVEngineTest, NonBlockingBackupListsTheDataFiles) {
+    auto opCtxPtr = makeOperationContext();
+
+    std::string ns = "a.b";
+    std::string ident = "collection-1234";
+    CollectionOptions options;
+    ASSERT_OK(_engine->createRecordStore(opCtxPtr.get(), ns, ident, options));
+    _engine->flushAllFiles(opCtxPtr.get(), true);
+
+    const boost::optional<boost::filesystem::path> dataFilePath =
+        _engine->getDataFilePathForIdent(ident);
+    ASSERT(dataFilePath);
+    const auto dbpath = dataFilePath->parent_path();
+
+    auto filenames = unittest::assertGet(_engine->beginNonBlockingBackup(opCtxPtr.get()));
+    ASSERT(std::find(filenames.begin(), filenames.end(), ident + ".wt") != filenames.end());
+    ASSERT(std::find(filenames.begin(), filenames.end(), "WiredTiger") != filenames.end());
+    for (auto&& filename : filenames) {
+        ASSERT(boost::filesystem::exists(dbpath / filename)) << filename;
+    }
+    _engine->endNonBlockingBackup(opCtxPtr.get());
+
+    // Ending the backup lets another one start.
+    ASSERT_OK(_engine->beginNonBlockingBackup(opCtxPtr.get()).getStatus());
+    _engine->endNonBlockingBackup(opCtxPtr.get());
+}
+
 std::unique_ptr<KVHarnessHelper> makeHelper() {
     return stdx::make_unique<WiredTigerKVHarnessHelper>();
 }
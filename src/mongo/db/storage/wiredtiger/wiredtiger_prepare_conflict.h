@@ -34,12 +34,17 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
 // When set, returns simulates returning WT_PREPARE_CONFLICT on WT cursor read operations.
 MONGO_FAIL_POINT_DECLARE(WTPrepareConflictForReads);
 
+// When set, the time spent in WT cursor read operations is added to the storageTimeReadingMicros
+// of the operation.
+extern AtomicBool trackOperationStorageReadTime;
+
 /**
  * Logs a message with the number of prepare conflict retry attempts.
  */
@@ -57,12 +62,22 @@ int wiredTigerPrepareConflictRetry(OperationContext* opCtx, F&& f) {
     invariant(opCtx);
 
     auto recoveryUnit = WiredTigerRecoveryUnit::get(opCtx);
+    const bool trackReadTime = trackOperationStorageReadTime.load();
     int attempts = 0;
     while (true) {
         attempts++;
         // If the failpoint is enabled, don't call the function, just simulate a conflict.
-        int ret =
-            MONGO_FAIL_POINT(WTPrepareConflictForReads) ? WT_PREPARE_CONFLICT : WT_READ_CHECK(f());
+        int ret;
+        if (MONGO_FAIL_POINT(WTPrepareConflictForReads)) {
+            ret = WT_PREPARE_CONFLICT;
+        } else if (trackReadTime) {
+            Timer timer;
+            ret = WT_READ_CHECK(f());
+            CurOp::get(opCtx)->debug().additiveMetrics.incrementStorageTimeReadingMicros(
+                timer.micros());
+        } else {
+            ret = WT_READ_CHECK(f());
+        }
 
         if (ret != WT_PREPARE_CONFLICT)
             return ret;
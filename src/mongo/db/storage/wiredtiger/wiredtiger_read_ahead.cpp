@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr std::size_t WiredTigerReadAhead::kMaxPendingRequests;
+
+namespace {
+
+ThreadPool::Options makeThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "WTReadAhead";
+    options.minThreads = 0;
+    options.maxThreads = 4;
+    return options;
+}
+
+}  // namespace
+
+WiredTigerReadAhead::WiredTigerReadAhead(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache), _pool(stdx::make_unique<ThreadPool>(makeThreadPoolOptions())) {
+    _pool->startup();
+}
+
+WiredTigerReadAhead::~WiredTigerReadAhead() {
+    shutdown();
+}
+
+void WiredTigerReadAhead::shutdown() {
+    _pool->shutdown();
+    _pool->join();
+}
+
+void WiredTigerReadAhead::schedule(const std::string& uri,
+                                   uint64_t tableId,
+                                   const RecordId& start,
+                                   std::size_t numRecords) {
+    if (numRecords == 0)
+        return;
+
+    if (static_cast<std::size_t>(_pending.fetchAndAdd(1)) >= kMaxPendingRequests) {
+        _pending.subtractAndFetch(1);
+        _dropped.addAndFetch(1);
+        return;
+    }
+
+    Status status = _pool->schedule([this, uri, tableId, start, numRecords] {
+        ON_BLOCK_EXIT([this] { _pending.subtractAndFetch(1); });
+        _readAhead(uri, tableId, start, numRecords);
+    });
+
+    if (!status.isOK()) {
+        // The pool is shutting down.
+        _pending.subtractAndFetch(1);
+        _dropped.addAndFetch(1);
+        return;
+    }
+
+    _scheduled.addAndFetch(1);
+}
+
+void WiredTigerReadAhead::_readAhead(const std::string& uri,
+                                     uint64_t tableId,
+                                     const RecordId& start,
+                                     std::size_t numRecords) {
+    auto session = _sessionCache->getSession();
+    WT_CURSOR* c = session->getCursor(uri, tableId, true);
+    if (!c) {
+        // The table was dropped after the request was made.
+        return;
+    }
+    ON_BLOCK_EXIT([&] { session->releaseCursor(tableId, c); });
+
+    // Any failure, including a prepare conflict, simply ends the read-ahead: the scan that asked
+    // for it will read the records itself.
+    c->set_key(c, start.repr());
+    int cmp;
+    int ret = c->search_near(c, &cmp);
+    if (ret != 0)
+        return;
+
+    std::size_t recordsRead = 0;
+    if (cmp < 0) {
+        ret = c->next(c);
+    }
+    while (ret == 0 && recordsRead < numRecords) {
+        WT_ITEM value;
+        if (c->get_value(c, &value) != 0)
+            break;
+        ++recordsRead;
+        ret = c->next(c);
+    }
+
+    _recordsRead.addAndFetch(recordsRead);
+}
+
+void WiredTigerReadAhead::appendStats(BSONObjBuilder* builder) const {
+    builder->append("scheduled", _scheduled.load());
+    builder->append("dropped", _dropped.load());
+    builder->append("pending", _pending.load());
+    builder->append("recordsRead", _recordsRead.load());
+}
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ThreadPool;
+class WiredTigerSessionCache;
+
+/**
+ * Warms the WiredTiger cache ahead of forward collection scans.
+ *
+ * A scheduled read-ahead opens its own session from the session cache, positions a cursor at the
+ * requested RecordId and walks forward over the requested number of records, touching each value
+ * so that WiredTiger faults the underlying pages in. The reads happen on a small background pool,
+ * so the scanning thread finds the pages already cached instead of waiting on disk.
+ *
+ * Read-ahead is purely best-effort: requests are dropped when too many are already pending, and a
+ * request stops early on any error, including the table having been dropped.
+ */
+class WiredTigerReadAhead {
+    MONGO_DISALLOW_COPYING(WiredTigerReadAhead);
+
+public:
+    // Requests beyond this many outstanding ones are dropped rather than queued.
+    static constexpr std::size_t kMaxPendingRequests = 64;
+
+    explicit WiredTigerReadAhead(WiredTigerSessionCache* sessionCache);
+    ~WiredTigerReadAhead();
+
+    /**
+     * Asynchronously reads up to 'numRecords' records of the record store table 'uri' (keyed by
+     * int64 RecordIds) starting at the first record not less than 'start'.
+     */
+    void schedule(const std::string& uri,
+                  uint64_t tableId,
+                  const RecordId& start,
+                  std::size_t numRecords);
+
+    /**
+     * Stops accepting new requests and waits for the ones already running to finish. Must be
+     * called before the session cache is shut down.
+     */
+    void shutdown();
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    void _readAhead(const std::string& uri,
+                    uint64_t tableId,
+                    const RecordId& start,
+                    std::size_t numRecords);
+
+    WiredTigerSessionCache* const _sessionCache;
+    std::unique_ptr<ThreadPool> _pool;
+
+    AtomicInt64 _pending;
+
+    AtomicInt64 _scheduled;
+    AtomicInt64 _dropped;
+    AtomicInt64 _recordsRead;
+};
+
+}  // namespace mongo
@@ -37,27 +37,34 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <array>
+
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/db/unclean_shutdown.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
@@ -87,8 +94,73 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// Counters for inserts that went through the bulk-append path of _insertRecords().
+AtomicInt64 bulkAppendBatches;
+AtomicInt64 bulkAppendRecords;
+
+// Counters for the truncations performed by reclaimOplog(). The latency histogram buckets are
+// keyed by their inclusive lower bound, in microseconds.
+constexpr std::array<int64_t, 6> kOplogTruncationLatencyLowerBoundsMicros = {
+    0, 1000, 10 * 1000, 100 * 1000, 1000 * 1000, 10 * 1000 * 1000};
+
+struct OplogTruncationStats {
+    void record(int64_t records, int64_t bytes, int64_t micros) {
+        truncations.addAndFetch(1);
+        recordsTruncated.addAndFetch(records);
+        bytesTruncated.addAndFetch(bytes);
+        totalMicros.addAndFetch(micros);
+
+        std::size_t bucket = kOplogTruncationLatencyLowerBoundsMicros.size() - 1;
+        while (micros < kOplogTruncationLatencyLowerBoundsMicros[bucket]) {
+            --bucket;
+        }
+        latencyBuckets[bucket].addAndFetch(1);
+    }
+
+    AtomicInt64 truncations;
+    AtomicInt64 recordsTruncated;
+    AtomicInt64 bytesTruncated;
+    AtomicInt64 totalMicros;
+    std::array<AtomicInt64, kOplogTruncationLatencyLowerBoundsMicros.size()> latencyBuckets;
+};
+
+OplogTruncationStats oplogTruncationStats;
+
+// The stones of the oplog whose truncation is reported in serverStatus. Held weakly so that
+// reporting never extends the lifetime of a dropped oplog.
+stdx::mutex oplogStonesForStatsMutex;
+std::weak_ptr<WiredTigerRecordStore::OplogStones> oplogStonesForStats;
 }  // namespace
 
+// The maximum rate, in bytes per second, at which the background reclaimer may truncate the oplog.
+// The oplog may temporarily grow past its configured size while truncation is throttled. A value
+// of 0 or less disables pacing.
+AtomicWord<long long> wiredTigerOplogTruncationBytesPerSec(0);
+
+ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime>
+    WiredTigerOplogTruncationBytesPerSecSetting(ServerParameterSet::getGlobal(),
+                                                "wiredTigerOplogTruncationBytesPerSec",
+                                                &wiredTigerOplogTruncationBytesPerSec);
+
+// The number of bytes by which a capped collection without a maximum document count may exceed its
+// maximum size before an insert deletes its oldest documents, so that each deletion removes a batch
+// of documents rather than each insert removing a few. It is bounded by the slack already allowed
+// while another insert is deleting. A value of 0 or less deletes as soon as the collection is full.
+AtomicWord<long long> wiredTigerCappedDeleteBatchBytes(0);
+
+ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCappedDeleteBatchBytesSetting(ServerParameterSet::getGlobal(),
+                                            "wiredTigerCappedDeleteBatchBytes",
+                                            &wiredTigerCappedDeleteBatchBytes);
+
+bool wiredTigerLazyRecordStoreInit = false;
+
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly>
+    WiredTigerLazyRecordStoreInitSetting(ServerParameterSet::getGlobal(),
+                                         "wiredTigerLazyRecordStoreInit",
+                                         &wiredTigerLazyRecordStoreInit);
+
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictExceptionForReads);
 
@@ -214,6 +286,50 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
         }
         _oplogReclaimCv.wait(lock);
     }
+
+    // Wait out the pacing delay, waking up early if the budget is raised or lifted meanwhile.
+    while (!_isDead && Date_t::now() < _nextTruncationAllowed) {
+        if (wiredTigerOplogTruncationBytesPerSec.load() <= 0) {
+            break;
+        }
+        MONGO_IDLE_THREAD_BLOCK;
+        _oplogReclaimCv.wait_until(
+            lock, std::min(_nextTruncationAllowed, Date_t::now() + Seconds(1)).toSystemTimePoint());
+    }
+}
+
+bool WiredTigerRecordStore::OplogStones::isTruncationAllowedNow() {
+    if (wiredTigerOplogTruncationBytesPerSec.load() <= 0) {
+        return true;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_oplogReclaimMutex);
+    return Date_t::now() >= _nextTruncationAllowed;
+}
+
+void WiredTigerRecordStore::OplogStones::chargeTruncation(int64_t bytesTruncated) {
+    const long long bytesPerSec = wiredTigerOplogTruncationBytesPerSec.load();
+    if (bytesPerSec <= 0) {
+        return;
+    }
+    const auto delay = Microseconds(static_cast<int64_t>(
+        static_cast<double>(std::max(bytesTruncated, int64_t(0))) * 1000 * 1000 / bytesPerSec));
+
+    stdx::lock_guard<stdx::mutex> lk(_oplogReclaimMutex);
+    _nextTruncationAllowed = Date_t::now() + duration_cast<Milliseconds>(delay);
+}
+
+void WiredTigerRecordStore::OplogStones::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    int64_t bytesInStones = 0;
+    for (auto&& stone : _stones) {
+        bytesInStones += stone.bytes;
+    }
+    const int64_t totalBytes = bytesInStones + _currentBytes.load();
+
+    builder->append("numStones", static_cast<long long>(_stones.size()));
+    builder->append("currentStoneBytes", static_cast<long long>(_currentBytes.load()));
+    builder->append("bytesPendingReclamation",
+                    static_cast<long long>(std::max(totalBytes - _rs->cappedMaxSize(), int64_t(0))));
 }
 
 boost::optional<WiredTigerRecordStore::OplogStones::Stone>
@@ -467,6 +583,41 @@ void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     _pokeReclaimThreadIfNeeded();
 }
 
+// static
+void WiredTigerRecordStore::appendGlobalStats(BSONObjBuilder& b) {
+    BSONObjBuilder bb(b.subobjStart("bulkAppendInserts"));
+    bb.append("batches", bulkAppendBatches.load());
+    bb.append("records", bulkAppendRecords.load());
+    bb.done();
+
+    BSONObjBuilder truncationBuilder(b.subobjStart("oplogTruncation"));
+    {
+        stdx::lock_guard<stdx::mutex> lk(oplogStonesForStatsMutex);
+        if (auto oplogStones = oplogStonesForStats.lock()) {
+            oplogStones->appendStats(&truncationBuilder);
+        }
+    }
+    truncationBuilder.append("bytesPerSecLimit", wiredTigerOplogTruncationBytesPerSec.load());
+    truncationBuilder.append("truncations", oplogTruncationStats.truncations.load());
+    truncationBuilder.append("recordsTruncated", oplogTruncationStats.recordsTruncated.load());
+    truncationBuilder.append("bytesTruncated", oplogTruncationStats.bytesTruncated.load());
+    truncationBuilder.append("totalTruncationMicros", oplogTruncationStats.totalMicros.load());
+    {
+        BSONArrayBuilder histogramBuilder(truncationBuilder.subarrayStart("latencyHistogram"));
+        for (std::size_t i = 0; i < kOplogTruncationLatencyLowerBoundsMicros.size(); i++) {
+            const auto count = oplogTruncationStats.latencyBuckets[i].load();
+            if (count == 0) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+            entryBuilder.append("micros",
+                                static_cast<long long>(kOplogTruncationLatencyLowerBoundsMicros[i]));
+            entryBuilder.append("count", count);
+        }
+    }
+    truncationBuilder.done();
+}
+
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
     StringBuilder ss;
     BSONForEach(elem, options) {
@@ -476,6 +627,15 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == WiredTigerCompressionDictionary::kOptionName) {
+            Status status = WiredTigerCompressionDictionary::validate(elem);
+            if (!status.isOK()) {
+                return status;
+            }
+            int len;
+            const char* data = elem.binData(len);
+            ss << "block_compressor="
+               << WiredTigerCompressionDictionary::compressorName(StringData(data, len)) << ',';
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -690,6 +850,11 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
 
     if (_oplogStones) {
         _oplogStones->kill();
+
+        stdx::lock_guard<stdx::mutex> lk(oplogStonesForStatsMutex);
+        if (oplogStonesForStats.lock() == _oplogStones) {
+            oplogStonesForStats.reset();
+        }
     }
 
     if (_isOplog) {
@@ -699,11 +864,23 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
 }
 
 void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
-    // Find the largest RecordId currently in use and estimate the number of records.
-    std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
     _sizeInfo =
         _sizeStorer ? _sizeStorer->load(_uri) : std::make_shared<WiredTigerSizeStorer::SizeInfo>();
 
+    // After a clean shutdown, a non-empty size storer entry is enough to know that the table is not
+    // empty, so finding the largest RecordId can wait until the first insert. This avoids opening
+    // the tables of collections that are never written to.
+    if (wiredTigerLazyRecordStoreInit && _sizeStorer && !_isOplog &&
+        _sizeInfo->numRecords.load() > 0 &&
+        !startingAfterUncleanShutdown(getGlobalServiceContext())) {
+        LOG(1) << "Deferring the lookup of the largest RecordId of " << ns() << " until the "
+               << "first insert";
+        _sizeStorer->store(_uri, _sizeInfo);
+        return;
+    }
+
+    // Find the largest RecordId currently in use and estimate the number of records.
+    std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
     if (auto record = cursor->next()) {
         int64_t max = record->id.repr();
         _nextIdNum.store(1 + max);
@@ -743,12 +920,16 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
         // Need to start at 1 so we are always higher than RecordId::min()
         _nextIdNum.store(1);
     }
+    _nextIdInitialized.store(true);
 
     if (_sizeStorer)
         _sizeStorer->store(_uri, _sizeInfo);
 
     if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns())) {
         _oplogStones = std::make_shared<OplogStones>(opCtx, this);
+
+        stdx::lock_guard<stdx::mutex> lk(oplogStonesForStatsMutex);
+        oplogStonesForStats = _oplogStones;
     }
 
     if (_isOplog) {
@@ -832,7 +1013,9 @@ RecordData WiredTigerRecordStore::dataFor(OperationContext* opCtx, const RecordI
     int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
     massert(28556, "Didn't find RecordId in WiredTigerRecordStore", ret != WT_NOTFOUND);
     invariantWTOK(ret);
-    return _getData(curwrap);
+    RecordData data = _getData(curwrap);
+    CurOp::get(opCtx)->debug().additiveMetrics.incrementStorageBytesRead(data.size());
+    return data;
 }
 
 bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
@@ -850,6 +1033,7 @@ bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
     }
     invariantWTOK(ret);
     *out = _getData(curwrap);
+    CurOp::get(opCtx)->debug().additiveMetrics.incrementStorageBytesRead(out->size());
     return true;
 }
 
@@ -924,6 +1108,14 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    if (_cappedMaxDocs == -1) {
+        const int64_t batchBytes =
+            std::min(static_cast<int64_t>(wiredTigerCappedDeleteBatchBytes.load()),
+                     _cappedMaxSizeSlack);
+        if (batchBytes > 0 && (_sizeInfo->dataSize.load() - _cappedMaxSize) < batchBytes)
+            return 0;
+    }
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     stdx::unique_lock<stdx::timed_mutex> lock(_cappedDeleterMutex, stdx::defer_lock);
 
@@ -1192,6 +1384,14 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp pers
             return;
         }
 
+        if (!_oplogStones->isTruncationAllowedNow()) {
+            // Truncation is paced. The reclaim thread waits for the budget without holding any
+            // locks and calls back in for the remaining stones.
+            LOG(1) << "Deferring oplog truncation to stay within "
+                   << wiredTigerOplogTruncationBytesPerSec.load() << " bytes per second";
+            break;
+        }
+
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
                << stone->lastRecord << " to remove approximately " << stone->records
                << " records totaling to " << stone->bytes << " bytes";
@@ -1200,6 +1400,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp pers
         WT_SESSION* session = ru->getSession()->getSession();
 
         try {
+            Timer truncateTimer;
             WriteUnitOfWork wuow(opCtx);
 
             WiredTigerCursor cwrap(_uri, _tableId, true, opCtx);
@@ -1226,6 +1427,9 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp pers
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
+
+            oplogTruncationStats.record(stone->records, stone->bytes, truncateTimer.micros());
+            _oplogStones->chargeTruncation(stone->bytes);
         } catch (const WriteConflictException&) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
@@ -1265,25 +1469,39 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
     WT_CURSOR* c = curwrap.get();
     invariant(c);
 
+    // A batch of more than one record is always assigned strictly increasing RecordIds: either a
+    // contiguous range reserved up front or, for the oplog, keys extracted from increasing
+    // optimes. Such batches take the bulk-append path, which reserves all of its RecordIds with a
+    // single atomic operation and appends the records through one positioned cursor. WiredTiger's
+    // true bulk cursors cannot be used here since they require an empty table and cannot run
+    // inside of a transaction.
+    const bool bulkAppend = nRecords > 1;
+
     RecordId highestId = RecordId();
     dassert(nRecords != 0);
-    for (size_t i = 0; i < nRecords; i++) {
-        auto& record = records[i];
-        if (_isOplog) {
+    if (_isOplog) {
+        for (size_t i = 0; i < nRecords; i++) {
+            auto& record = records[i];
             StatusWith<RecordId> status =
                 oploghack::extractKey(record.data.data(), record.data.size());
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
-        } else if (_isCapped) {
-            record.id = _nextId();
-        } else {
-            record.id = _nextId();
+            dassert(record.id > highestId);
+            highestId = record.id;
+        }
+    } else if (bulkAppend) {
+        const int64_t firstId = _reserveIds(opCtx, nRecords).repr();
+        for (size_t i = 0; i < nRecords; i++) {
+            records[i].id = RecordId(firstId + static_cast<int64_t>(i));
         }
-        dassert(record.id > highestId);
-        highestId = record.id;
+        highestId = records[nRecords - 1].id;
+    } else {
+        records[0].id = _nextId(opCtx);
+        highestId = records[0].id;
     }
 
+    Timestamp lastTimestampSet;
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         Timestamp ts;
@@ -1299,9 +1517,13 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         } else {
             ts = timestamps[i];
         }
-        if (!ts.isNull()) {
+        // Records in a batch frequently share a timestamp. Only the records in this loop are
+        // written in between, so there is no need to reconfigure the transaction with the
+        // timestamp it already has.
+        if (!ts.isNull() && ts != lastTimestampSet) {
             LOG(4) << "inserting record with timestamp " << ts;
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
+            lastTimestampSet = ts;
         }
         setKey(c, record.id);
         WiredTigerItem value(record.data.data(), record.data.size());
@@ -1311,8 +1533,12 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
     }
 
-    _changeNumRecords(opCtx, nRecords);
-    _increaseDataSize(opCtx, totalLength);
+    _changeNumRecordsAndDataSize(opCtx, nRecords, totalLength);
+
+    if (bulkAppend) {
+        bulkAppendBatches.fetchAndAdd(1);
+        bulkAppendRecords.fetchAndAdd(nRecords);
+    }
 
     if (_oplogStones) {
         _oplogStones->updateCurrentStoneAfterInsertOnCommit(
@@ -1699,13 +1925,77 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
         _sizeStorer->store(_uri, _sizeInfo);
 }
 
-RecordId WiredTigerRecordStore::_nextId() {
+class WiredTigerRecordStore::SizeInfoChange : public RecoveryUnit::Change {
+public:
+    SizeInfoChange(WiredTigerRecordStore* rs, int64_t numRecordsDiff, int64_t dataSizeDiff)
+        : _rs(rs), _numRecordsDiff(numRecordsDiff), _dataSizeDiff(dataSizeDiff) {}
+    virtual void commit(boost::optional<Timestamp>) {}
+    virtual void rollback() {
+        LOG(3) << "WiredTigerRecordStore: rolling back SizeInfoChange " << -_numRecordsDiff
+               << " records, " << -_dataSizeDiff << " bytes";
+        _rs->_sizeInfo->numRecords.fetchAndAdd(-_numRecordsDiff);
+        _rs->_increaseDataSize(NULL, -_dataSizeDiff);
+    }
+
+private:
+    WiredTigerRecordStore* _rs;
+    int64_t _numRecordsDiff;
+    int64_t _dataSizeDiff;
+};
+
+void WiredTigerRecordStore::_changeNumRecordsAndDataSize(OperationContext* opCtx,
+                                                         int64_t numRecordsDiff,
+                                                         int64_t dataSizeDiff) {
+    if (!sizeRecoveryState(getGlobalServiceContext()).collectionNeedsSizeAdjustment(_uri)) {
+        return;
+    }
+
+    opCtx->recoveryUnit()->registerChange(
+        new SizeInfoChange(this, numRecordsDiff, dataSizeDiff));
+
+    if (_sizeInfo->numRecords.fetchAndAdd(numRecordsDiff) < 0)
+        _sizeInfo->numRecords.store(std::max(numRecordsDiff, int64_t(0)));
+    if (_sizeInfo->dataSize.fetchAndAdd(dataSizeDiff) < 0)
+        _sizeInfo->dataSize.store(std::max(dataSizeDiff, int64_t(0)));
+
+    if (_sizeStorer)
+        _sizeStorer->store(_uri, _sizeInfo);
+}
+
+void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
+    if (_nextIdInitialized.load())
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_initNextIdMutex);
+    if (_nextIdInitialized.load())
+        return;
+
+    // No RecordIds have been handed out since startup, so the largest committed RecordId is
+    // visible to any snapshot.
+    std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
+    auto record = cursor->next();
+    _nextIdNum.store(record ? record->id.repr() + 1 : 1);
+    _nextIdInitialized.store(true);
+}
+
+RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
     invariant(!_isOplog);
+    _initNextIdIfNeeded(opCtx);
     RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
     invariant(out.isNormal());
     return out;
 }
 
+RecordId WiredTigerRecordStore::_reserveIds(OperationContext* opCtx, size_t n) {
+    invariant(!_isOplog);
+    invariant(n > 0);
+    _initNextIdIfNeeded(opCtx);
+    RecordId first = RecordId(_nextIdNum.fetchAndAdd(static_cast<int64_t>(n)));
+    invariant(first.isNormal());
+    invariant(RecordId(first.repr() + static_cast<int64_t>(n) - 1).isNormal());
+    return first;
+}
+
 WiredTigerRecoveryUnit* WiredTigerRecordStore::_getRecoveryUnit(OperationContext* opCtx) {
     return checked_cast<WiredTigerRecoveryUnit*>(opCtx->recoveryUnit());
 }
@@ -1929,13 +2219,32 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
         throw WriteConflictException();
     }
 
+    if (_readAheadRecords) {
+        _maybeScheduleReadAhead(id);
+    }
+
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
+    CurOp::get(_opCtx)->debug().additiveMetrics.incrementStorageBytesRead(value.size);
 
     _lastReturnedId = id;
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::_maybeScheduleReadAhead(const RecordId& id) {
+    // Keep at least half a window of records prefetched ahead of the cursor. The first call
+    // schedules immediately, since '_recordsSinceReadAhead' starts out at zero.
+    if (_recordsSinceReadAhead == 0 && _rs._kvEngine) {
+        if (auto readAhead = _rs._kvEngine->getReadAhead()) {
+            readAhead->schedule(_rs.getURI(), _rs.tableId(), id, _readAheadRecords);
+        }
+    }
+
+    if (++_recordsSinceReadAhead >= std::max<std::size_t>(_readAheadRecords / 2, 1)) {
+        _recordsSinceReadAhead = 0;
+    }
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     _skipNextAdvance = false;
     WT_CURSOR* c = _cursor->get();
@@ -1951,6 +2260,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
 
     WT_ITEM value;
     invariantWTOK(c->get_value(c, &value));
+    CurOp::get(_opCtx)->debug().additiveMetrics.incrementStorageBytesRead(value.size);
 
     _lastReturnedId = id;
     _eof = false;
@@ -2087,6 +2397,14 @@ WiredTigerRecordStoreStandardCursor::WiredTigerRecordStoreStandardCursor(
     OperationContext* opCtx, const WiredTigerRecordStore& rs, bool forward)
     : WiredTigerRecordStoreCursorBase(opCtx, rs, forward) {}
 
+void WiredTigerRecordStoreStandardCursor::enableReadAhead(std::size_t numRecords) {
+    if (!_forward) {
+        return;
+    }
+    _readAheadRecords = numRecords;
+    _recordsSinceReadAhead = 0;
+}
+
 void WiredTigerRecordStoreStandardCursor::setKey(WT_CURSOR* cursor, RecordId id) const {
     cursor->set_key(cursor, id.repr());
 }
@@ -70,6 +70,10 @@ class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
 
+// When true, record stores that the size storer reports as non-empty defer looking up their
+// largest RecordId, which opens the table, until their first insert.
+extern bool wiredTigerLazyRecordStoreInit;
+
 class WiredTigerRecordStore : public RecordStore {
     friend class WiredTigerRecordStoreCursorBase;
 
@@ -101,6 +105,12 @@ public:
                                                         StringData extraStrings,
                                                         bool prefixed);
 
+    /**
+     * Appends the process-wide counters for the batched (bulk-append) insert path to 'b'. Used
+     * by the "wiredTiger" serverStatus section.
+     */
+    static void appendGlobalStats(BSONObjBuilder& b);
+
     struct Params {
         StringData ns;
         std::string uri;
@@ -292,6 +302,7 @@ private:
 
     class NumRecordsChange;
     class DataSizeChange;
+    class SizeInfoChange;
 
     static WiredTigerRecoveryUnit* _getRecoveryUnit(OperationContext* opCtx);
 
@@ -300,7 +311,20 @@ private:
                           const Timestamp* timestamps,
                           size_t nRecords);
 
-    RecordId _nextId();
+    /**
+     * Finds the largest RecordId in use if postConstructorInit() deferred doing so. Must be called
+     * before handing out new RecordIds.
+     */
+    void _initNextIdIfNeeded(OperationContext* opCtx);
+
+    RecordId _nextId(OperationContext* opCtx);
+
+    /**
+     * Reserves 'n' consecutive RecordIds with a single atomic operation and returns the first
+     * one. Used by the bulk-append insert path.
+     */
+    RecordId _reserveIds(OperationContext* opCtx, size_t n);
+
     void _setId(RecordId id);
     bool cappedAndNeedDelete() const;
     RecordData _getData(const WiredTigerCursor& cursor) const;
@@ -335,6 +359,14 @@ private:
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
     void _increaseDataSize(OperationContext* opCtx, int64_t amount);
 
+    /**
+     * Combines _changeNumRecords() and _increaseDataSize() so that a batch registers a single
+     * RecoveryUnit::Change and notifies the SizeStorer only once.
+     */
+    void _changeNumRecordsAndDataSize(OperationContext* opCtx,
+                                      int64_t numRecordsDiff,
+                                      int64_t dataSizeDiff);
+
     /**
      * Delete records from this record store as needed while _cappedMaxSize or _cappedMaxDocs is
      * exceeded.
@@ -371,6 +403,11 @@ private:
 
     AtomicInt64 _nextIdNum;
 
+    // False while the largest RecordId in use has not been looked up yet. Guarded by
+    // _initNextIdMutex when set.
+    AtomicBool _nextIdInitialized{false};
+    stdx::mutex _initNextIdMutex;
+
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
     std::shared_ptr<WiredTigerSizeStorer::SizeInfo> _sizeInfo;
     WiredTigerKVEngine* _kvEngine;  // not owned.
@@ -471,8 +508,15 @@ protected:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
 
+    // Number of records to prefetch ahead of this cursor. Zero means read-ahead is disabled.
+    std::size_t _readAheadRecords = 0;
+    // Records returned since the last read-ahead request was scheduled.
+    std::size_t _recordsSinceReadAhead = 0;
+
 private:
     bool isVisible(const RecordId& id);
+
+    void _maybeScheduleReadAhead(const RecordId& id);
 };
 
 class WiredTigerRecordStoreStandardCursor final : public WiredTigerRecordStoreCursorBase {
@@ -481,6 +525,12 @@ public:
                                         const WiredTigerRecordStore& rs,
                                         bool forward = true);
 
+    /**
+     * Only forward cursors over tables keyed by RecordId alone support read-ahead. The hint is
+     * ignored for ephemeral engines, which have no read-ahead threads.
+     */
+    void enableReadAhead(std::size_t numRecords) override;
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const override;
 
@@ -35,12 +35,17 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 class RecordId;
 
+// Byte per second budget for the background oplog reclaimer. Zero or less means unpaced.
+extern AtomicWord<long long> wiredTigerOplogTruncationBytesPerSec;
+
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
 // grows beyond its desired maximum size.
 class WiredTigerRecordStore::OplogStones {
@@ -67,8 +72,29 @@ public:
         return total_bytes > _rs->cappedMaxSize();
     }
 
+    /**
+     * Waits until kill() is called, or until there are excess stones that may be truncated and
+     * the truncation pacing budget allows truncating the next one.
+     */
     void awaitHasExcessStonesOrDead();
 
+    /**
+     * Returns true if the truncation pacing budget allows the next stone to be truncated now.
+     */
+    bool isTruncationAllowedNow();
+
+    /**
+     * Charges a truncation of 'bytesTruncated' bytes against the pacing budget, delaying the next
+     * truncation so that the reclaimer stays within 'wiredTigerOplogTruncationBytesPerSec'.
+     */
+    void chargeTruncation(int64_t bytesTruncated);
+
+    /**
+     * Appends the number of stones, the number of bytes in the stone being filled and the
+     * approximate number of bytes in excess of the oplog's maximum size.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
     boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
 
     void popOldestStone();
@@ -136,6 +162,10 @@ private:
     // database, and false otherwise.
     bool _isDead = false;
 
+    // The earliest time the next stone may be truncated, when truncation is paced. Protected by
+    // '_oplogReclaimMutex'.
+    Date_t _nextTruncationAllowed;
+
     // Minimum number of bytes the stone being filled should contain before it gets added to the
     // deque of oplog stones.
     int64_t _minBytesPerStone;
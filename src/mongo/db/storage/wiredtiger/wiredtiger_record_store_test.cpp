@@ -40,8 +40,10 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_compression_dictionary.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -101,6 +103,18 @@ TEST(WiredTigerRecordStoreTest, GenerateCreateStringValidConfigStringOption) {
               std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringCompressionDictionary) {
+    BSONObjBuilder bob;
+    bob.appendBinData("compressionDictionary", 3, BinDataGeneral, "abc");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(bob.obj()),
+              "block_compressor=" + WiredTigerCompressionDictionary::compressorName("abc") + ",");
+}
+
+TEST(WiredTigerRecordStoreTest, GenerateCreateStringInvalidCompressionDictionary) {
+    BSONObj spec = fromjson("{compressionDictionary: 'abc'}");
+    ASSERT_EQ(WiredTigerRecordStore::parseOptionsField(spec), ErrorCodes::TypeMismatch);
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation1) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -204,6 +218,106 @@ TEST(WiredTigerRecordStoreTest, Isolation2) {
     }
 }
 
+TEST(WiredTigerRecordStoreTest, BulkAppendInsertAssignsContiguousIds) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    auto getBulkAppendStats = [] {
+        BSONObjBuilder bob;
+        WiredTigerRecordStore::appendGlobalStats(bob);
+        return bob.obj().getObjectField("bulkAppendInserts").getOwned();
+    };
+    const BSONObj statsBefore = getBulkAppendStats();
+
+    const int nToInsert = 10;
+    std::vector<Record> records;
+    std::vector<Timestamp> timestamps(nToInsert, Timestamp());
+    for (int i = 0; i < nToInsert; i++) {
+        records.push_back({RecordId(), RecordData("abc", 4)});
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecords(opCtx.get(), &records, &timestamps, false));
+        uow.commit();
+    }
+
+    for (int i = 1; i < nToInsert; i++) {
+        ASSERT_EQ(records[i - 1].id.repr() + 1, records[i].id.repr());
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQ(nToInsert, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(nToInsert * 4, rs->dataSize(opCtx.get()));
+        for (auto&& record : records) {
+            ASSERT_EQ(string("abc"), rs->dataFor(opCtx.get(), record.id).data());
+        }
+    }
+
+    const BSONObj statsAfter = getBulkAppendStats();
+    ASSERT_EQ(statsBefore["batches"].numberLong() + 1, statsAfter["batches"].numberLong());
+    ASSERT_EQ(statsBefore["records"].numberLong() + nToInsert,
+              statsAfter["records"].numberLong());
+}
+
+TEST(WiredTigerRecordStoreTest, BulkAppendInsertRollbackRestoresSizeInfo) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    std::vector<Record> records = {{RecordId(), RecordData("a", 2)},
+                                   {RecordId(), RecordData("b", 2)},
+                                   {RecordId(), RecordData("c", 2)}};
+    std::vector<Timestamp> timestamps(records.size(), Timestamp());
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecords(opCtx.get(), &records, &timestamps, false));
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(6, rs->dataSize(opCtx.get()));
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQ(0, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(0, rs->dataSize(opCtx.get()));
+    }
+}
+
+// Read-ahead is only a hint and must not change what a forward scan returns.
+TEST(WiredTigerRecordStoreTest, ForwardScanWithReadAheadReturnsAllRecords) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 100;
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < nToInsert; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "abc", 4, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+        }
+        uow.commit();
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        cursor->enableReadAhead(8);
+        for (auto&& id : ids) {
+            auto record = cursor->next();
+            ASSERT(record);
+            ASSERT_EQ(id, record->id);
+            ASSERT_EQ(string("abc"), record->data.data());
+        }
+        ASSERT(!cursor->next());
+    }
+}
+
 
 StatusWith<RecordId> insertBSON(ServiceContext::UniqueOperationContext& opCtx,
                                 unique_ptr<RecordStore>& rs,
@@ -261,6 +375,36 @@ TEST(WiredTigerRecordStoreTest, CappedCursorRollover) {
     ASSERT(!cursor->next());
 }
 
+TEST(WiredTigerRecordStoreTest, CappedDeletesInBatchesWhenConfigured) {
+    const long long batchBytes = 500;
+    auto param = ServerParameterSet::getGlobal()->getMap().find("wiredTigerCappedDeleteBatchBytes");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(std::to_string(batchBytes)));
+    ON_BLOCK_EXIT([&] { param->second->setFromString("0").transitional_ignore(); });
+
+    const int64_t cappedMaxSize = 10000;
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", cappedMaxSize, -1));
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    // The collection grows past its maximum size by up to a batch before the oldest documents are
+    // deleted, and is then brought back under its maximum size.
+    const std::string data(100, 'x');
+    long long largestSize = 0;
+    for (int i = 0; i < 500; ++i) {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp(), false)
+                      .getStatus());
+        uow.commit();
+
+        const long long dataSize = rs->dataSize(opCtx.get());
+        ASSERT_LTE(dataSize, cappedMaxSize + batchBytes + static_cast<long long>(data.size()));
+        largestSize = std::max(largestSize, dataSize);
+    }
+    ASSERT_GT(largestSize, cappedMaxSize + batchBytes - static_cast<long long>(data.size()));
+    ASSERT_LT(rs->numRecords(opCtx.get()), 500);
+}
+
 RecordId _oplogOrderInsertOplog(OperationContext* opCtx,
                                 const unique_ptr<RecordStore>& rs,
                                 int inc) {
@@ -820,6 +964,75 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that a truncation budget limits the reclaimer to one stone until the pacing delay has
+// passed, and that the truncations are reported in serverStatus.
+TEST(WiredTigerRecordStoreTest, OplogStones_PacedReclaimStones) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 100U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 100), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 100), RecordId(1, 3));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    auto getTruncationStats = [] {
+        BSONObjBuilder bob;
+        WiredTigerRecordStore::appendGlobalStats(bob);
+        return bob.obj().getObjectField("oplogTruncation").getOwned();
+    };
+    const BSONObj statsBefore = getTruncationStats();
+
+    // One byte per second makes the delay after the first truncation far longer than the test.
+    wiredTigerOplogTruncationBytesPerSec.store(1);
+    ON_BLOCK_EXIT([] { wiredTigerOplogTruncationBytesPerSec.store(0); });
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT(oplogStones->isTruncationAllowedNow());
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT(!oplogStones->isTruncationAllowedNow());
+    }
+
+    const BSONObj statsAfter = getTruncationStats();
+    ASSERT_EQ(statsBefore["truncations"].numberLong() + 1, statsAfter["truncations"].numberLong());
+    ASSERT_EQ(statsBefore["bytesTruncated"].numberLong() + 100,
+              statsAfter["bytesTruncated"].numberLong());
+    ASSERT_EQ(2, statsAfter["numStones"].numberLong());
+    ASSERT_EQ(100, statsAfter["bytesPendingReclamation"].numberLong());
+
+    // Lifting the budget allows the remaining excess stone to be truncated right away.
+    wiredTigerOplogTruncationBytesPerSec.store(0);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(1, 3));
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+    }
+}
+
 // Verify that an oplog stone isn't created if it would cause the logical representation of the
 // records to not be in increasing order.
 TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
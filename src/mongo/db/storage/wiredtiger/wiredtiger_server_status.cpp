@@ -37,9 +37,11 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/util/assert_util.h"
 
@@ -77,6 +79,24 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
     }
 
     WiredTigerKVEngine::appendGlobalStats(bob);
+    WiredTigerRecordStore::appendGlobalStats(bob);
+    WiredTigerSizeStorer::appendGlobalStats(bob);
+
+    {
+        BSONObjBuilder sessionCacheBuilder(bob.subobjStart("sessionCache"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendStats(&sessionCacheBuilder);
+    }
+
+    {
+        BSONObjBuilder journalFlushBuilder(bob.subobjStart("journalFlush"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendJournalFlushStats(
+            &journalFlushBuilder);
+    }
+
+    if (auto readAhead = _engine->getReadAhead()) {
+        BSONObjBuilder readAheadBuilder(bob.subobjStart("readAhead"));
+        readAhead->appendStats(&readAheadBuilder);
+    }
 
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
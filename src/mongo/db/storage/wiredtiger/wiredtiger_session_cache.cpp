@@ -36,6 +36,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_parameters.h"
@@ -45,6 +46,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -81,6 +83,26 @@ ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
                                      "wiredTigerCursorCacheSize",
                                      &kWiredTigerCursorCacheSize);
 
+// The number of partitions the session cache spreads its idle sessions over. A value of 0 means
+// one partition per available core, up to kMaxSessionCachePartitions.
+int wiredTigerSessionCachePartitions = 0;
+
+ExportedServerParameter<int, ServerParameterType::kStartupOnly>
+    WiredTigerSessionCachePartitionsSetting(ServerParameterSet::getGlobal(),
+                                            "wiredTigerSessionCachePartitions",
+                                            &wiredTigerSessionCachePartitions);
+
+namespace {
+const std::size_t kMaxSessionCachePartitions = 64;
+
+std::size_t numSessionCachePartitions() {
+    std::size_t partitions = wiredTigerSessionCachePartitions > 0
+        ? static_cast<std::size_t>(wiredTigerSessionCachePartitions)
+        : ProcessInfo::getNumAvailableCores();
+    return std::max(std::size_t(1), std::min(partitions, kMaxSessionCachePartitions));
+}
+}  // namespace
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch), _cursorEpoch(cursorEpoch), _session(NULL), _cursorGen(0), _cursorsOut(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
@@ -112,10 +134,13 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
             WT_CURSOR* c = i->_cursor;
             _cursors.erase(i);
             _cursorsOut++;
+            _cursorCacheHits++;
             return c;
         }
     }
 
+    _cursorCacheMisses++;
+
     WT_CURSOR* c = NULL;
     int ret = _session->open_cursor(
         _session, uri.c_str(), NULL, forRecordStore ? "" : "overwrite=false", &c);
@@ -185,10 +210,13 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _shuttingDown(0),
+      _partitions(numSessionCachePartitions()) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL), _conn(conn), _shuttingDown(0), _partitions(numSessionCachePartitions()) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -253,6 +281,9 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    // Group commit: every caller that reads 'start' before a flush begins has its writes covered
+    // by that flush, so callers queued behind an in-progress flush are all served by the next one.
+    _pendingDurabilityWaiters.fetchAndAdd(1);
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -263,6 +294,7 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
     _lastSyncTime.store(current + 1);
+    const auto batchSize = _pendingDurabilityWaiters.swap(0);
 
     // Nobody has synched yet, so we have to sync ourselves.
 
@@ -286,6 +318,19 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         LOG(4) << "created checkpoint";
     }
     _journalListener->onDurable(token);
+
+    _journalFlushes.fetchAndAdd(1);
+    _journalFlushWaiters.fetchAndAdd(batchSize);
+    if (batchSize > _maxJournalFlushBatchSize.loadRelaxed()) {
+        // Only updated while holding _lastSyncMutex.
+        _maxJournalFlushBatchSize.store(batchSize);
+    }
+}
+
+void WiredTigerSessionCache::appendJournalFlushStats(BSONObjBuilder* builder) const {
+    builder->append("flushes", static_cast<long long>(_journalFlushes.load()));
+    builder->append("waitersServed", static_cast<long long>(_journalFlushWaiters.load()));
+    builder->append("maxBatchSize", static_cast<long long>(_maxJournalFlushBatchSize.load()));
 }
 
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx) {
@@ -308,9 +353,12 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -318,9 +366,12 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        for (SessionCache::iterator i = partition.sessions.begin(); i != partition.sessions.end();
+             i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
@@ -329,9 +380,21 @@ void WiredTigerSessionCache::closeAll() {
     SessionCache swap;
 
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        // All partitions are locked while the epoch changes so that releaseSession(), which
+        // rechecks the epoch under its partition's lock, cannot cache a session from the old
+        // epoch.
+        std::vector<stdx::unique_lock<stdx::mutex>> locks;
+        locks.reserve(_partitions.size());
+        for (auto&& partition : _partitions) {
+            locks.emplace_back(partition.lock);
+        }
+
         _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+        for (auto&& partition : _partitions) {
+            swap.insert(swap.end(), partition.sessions.begin(), partition.sessions.end());
+            partition.sessions.clear();
+            partition.numIdle.store(0);
+        }
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -343,22 +406,51 @@ bool WiredTigerSessionCache::isEphemeral() {
     return _engine && _engine->isEphemeral();
 }
 
+std::size_t WiredTigerSessionCache::_myPartition() const {
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % _partitions.size();
+}
+
+// static
+WiredTigerSession* WiredTigerSessionCache::_popSession(Partition* partition) {
+    if (partition->numIdle.load() == 0) {
+        return nullptr;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(partition->lock);
+    if (partition->sessions.empty()) {
+        return nullptr;
+    }
+
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones.
+    WiredTigerSession* cachedSession = partition->sessions.back();
+    partition->sessions.pop_back();
+    partition->numIdle.subtractAndFetch(1);
+    return cachedSession;
+}
+
 UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // We should never be able to get here after _shuttingDown is set, because no new
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+    const std::size_t myPartition = _myPartition();
+    if (WiredTigerSession* cachedSession = _popSession(&_partitions[myPartition])) {
+        _partitions[myPartition].hits.fetchAndAdd(1);
+        return UniqueWiredTigerSession(cachedSession);
+    }
+
+    // Steal an idle session from another partition before paying for a new one.
+    for (std::size_t i = 1; i < _partitions.size(); i++) {
+        auto& partition = _partitions[(myPartition + i) % _partitions.size()];
+        if (WiredTigerSession* cachedSession = _popSession(&partition)) {
+            _partitions[myPartition].steals.fetchAndAdd(1);
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
+    _partitions[myPartition].misses.fetchAndAdd(1);
+
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
@@ -412,11 +504,18 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     // session cache.
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
+    auto& partition = _partitions[_myPartition()];
+    partition.cursorCacheHits.fetchAndAdd(session->_cursorCacheHits);
+    partition.cursorCacheMisses.fetchAndAdd(session->_cursorCacheMisses);
+    session->_cursorCacheHits = 0;
+    session->_cursorCacheMisses = 0;
+
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
+            partition.numIdle.addAndFetch(1);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -434,6 +533,49 @@ void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     _journalListener = jl;
 }
 
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) const {
+    long long totalIdle = 0;
+    long long totalHits = 0;
+    long long totalSteals = 0;
+    long long totalMisses = 0;
+    long long totalCursorCacheHits = 0;
+    long long totalCursorCacheMisses = 0;
+
+    BSONArrayBuilder partitionsBuilder;
+    for (auto&& partition : _partitions) {
+        const long long idle = partition.numIdle.load();
+        const long long hits = partition.hits.load();
+        const long long steals = partition.steals.load();
+        const long long misses = partition.misses.load();
+        const long long cursorCacheHits = partition.cursorCacheHits.load();
+        const long long cursorCacheMisses = partition.cursorCacheMisses.load();
+
+        BSONObjBuilder bob(partitionsBuilder.subobjStart());
+        bob.append("idle", idle);
+        bob.append("hits", hits);
+        bob.append("steals", steals);
+        bob.append("misses", misses);
+        bob.append("cursorCacheHits", cursorCacheHits);
+        bob.append("cursorCacheMisses", cursorCacheMisses);
+        bob.doneFast();
+
+        totalIdle += idle;
+        totalHits += hits;
+        totalSteals += steals;
+        totalMisses += misses;
+        totalCursorCacheHits += cursorCacheHits;
+        totalCursorCacheMisses += cursorCacheMisses;
+    }
+
+    builder->append("idle", totalIdle);
+    builder->append("hits", totalHits);
+    builder->append("steals", totalSteals);
+    builder->append("misses", totalMisses);
+    builder->append("cursorCacheHits", totalCursorCacheHits);
+    builder->append("cursorCacheMisses", totalCursorCacheMisses);
+    builder->append("partitions", partitionsBuilder.arr());
+}
+
 bool WiredTigerSessionCache::isEngineCachingCursors() {
     return kWiredTigerCursorCacheSize.load() <= 0;
 }
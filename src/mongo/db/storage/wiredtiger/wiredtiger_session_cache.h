@@ -31,8 +31,10 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -41,9 +43,11 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -147,6 +151,11 @@ private:
     uint64_t _cursorGen;
     int _cursorsOut;
     bool _dropQueuedIdentsAtSessionEnd = true;
+
+    // Cursor cache statistics accumulated since this session was last released to the session
+    // cache, which folds them into its partition's totals.
+    uint64_t _cursorCacheHits = 0;
+    uint64_t _cursorCacheMisses = 0;
 };
 
 /**
@@ -211,6 +220,12 @@ public:
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
+    /**
+     * Appends the number of journal flushes done by waitUntilDurable and how many callers they
+     * served, which are coalesced into a single flush when they wait concurrently.
+     */
+    void appendJournalFlushStats(BSONObjBuilder* builder) const;
+
     /**
      * Waits until a prepared unit of work has ended (either been commited or aborted). This
      * should be used when encountering WT_PREPARE_CONFLICT errors. The caller is required to retry
@@ -252,7 +267,48 @@ public:
         return _engine;
     }
 
+    /**
+     * Appends session checkout and cursor reuse statistics, in total and for each partition of
+     * the cache, to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
 private:
+    /**
+     * Idle sessions are kept in several independently locked partitions so that threads getting
+     * and releasing sessions concurrently do not serialize on a single mutex. A thread prefers
+     * the partition its id hashes to and steals from the other partitions when that one is empty.
+     */
+    struct Partition {
+        stdx::mutex lock;
+        std::vector<WiredTigerSession*> sessions;  // guarded by 'lock'
+
+        // Mirrors sessions.size() so that empty partitions can be skipped without locking them.
+        AtomicUInt64 numIdle;
+
+        // Sessions handed out from this partition, from another partition, or newly opened.
+        AtomicUInt64 hits;
+        AtomicUInt64 steals;
+        AtomicUInt64 misses;
+
+        // Cursor cache hits and misses of the sessions released into this partition.
+        AtomicUInt64 cursorCacheHits;
+        AtomicUInt64 cursorCacheMisses;
+    };
+
+    using CacheAlignedPartition = CacheAligned<Partition>;
+
+    /**
+     * Returns the index of the partition preferred by the calling thread.
+     */
+    std::size_t _myPartition() const;
+
+    /**
+     * Pops the most recently released session from 'partition', or returns nullptr if it holds
+     * no idle sessions.
+     */
+    static WiredTigerSession* _popSession(Partition* partition);
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
@@ -263,9 +319,9 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    std::vector<CacheAlignedPartition, boost::alignment::aligned_allocator<CacheAlignedPartition>>
+        _partitions;
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -277,6 +333,13 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // Callers of waitUntilDurable not yet accounted to a journal flush, and the journal flushes
+    // done so far with the number of callers they served.
+    AtomicUInt64 _pendingDurabilityWaiters;
+    AtomicUInt64 _journalFlushes;
+    AtomicUInt64 _journalFlushWaiters;
+    AtomicUInt64 _maxJournalFlushBatchSize;
+
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
     stdx::condition_variable _prepareCommittedOrAbortedCond;
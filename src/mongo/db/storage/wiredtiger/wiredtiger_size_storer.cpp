@@ -33,6 +33,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -44,15 +48,33 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
+namespace {
+
+struct FlushStats {
+    AtomicInt64 flushes;
+    AtomicInt64 failedFlushes;
+    AtomicInt64 entriesFlushed;
+    AtomicInt64 batchesCommitted;
+    AtomicInt64 totalMicros;
+    AtomicInt64 lastMicros;
+    AtomicInt64 maxMicros;
+} flushStats;
+
+}  // namespace
+
+constexpr std::size_t WiredTigerSizeStorer::kNumBufferShards;
+constexpr std::size_t WiredTigerSizeStorer::kFlushBatchSize;
 
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
                                            const std::string& storageUri,
                                            bool readOnly)
-    : _session(conn), _readOnly(readOnly) {
+    : _session(conn), _readOnly(readOnly), _shards(kNumBufferShards) {
     WT_SESSION* session = _session.getSession();
 
     std::string config = WiredTigerCustomizationHooks::get(getGlobalServiceContext())
@@ -76,8 +98,9 @@ void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeI
         return;
 
     // Ordering is important: as the entry may be flushed concurrently, set the dirty flag last.
-    stdx::lock_guard<stdx::mutex> lk(_bufferMutex);
-    auto& entry = _buffer[uri];
+    BufferShard& shard = _shardFor(uri);
+    stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+    auto& entry = shard.buffer[uri];
     // During rollback it is possible to get a new SizeInfo. In that case clear the dirty flag,
     // so the SizeInfo can be destructed without triggering the dirty check invariant.
     if (entry && entry.get() != sizeInfo.get())
@@ -92,9 +115,10 @@ void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeI
 std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(StringData uri) const {
     {
         // Check if we can satisfy the read from the buffer.
-        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
-        Buffer::const_iterator it = _buffer.find(uri);
-        if (it != _buffer.end())
+        const BufferShard& shard = _shardFor(uri);
+        stdx::lock_guard<stdx::mutex> bufferLock(shard.mutex);
+        Buffer::const_iterator it = shard.buffer.find(uri);
+        if (it != shard.buffer.end())
             return it->second;
     }
 
@@ -125,55 +149,103 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
 }
 
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
-    Buffer buffer;
-    {
-        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
-        _buffer.swap(buffer);
+    std::vector<std::pair<std::string, std::shared_ptr<SizeInfo>>> entries;
+    for (auto& shard : _shards) {
+        Buffer buffer;
+        {
+            stdx::lock_guard<stdx::mutex> bufferLock(shard.mutex);
+            shard.buffer.swap(buffer);
+        }
+        for (auto& it : buffer)
+            entries.emplace_back(it.first, std::move(it.second));
     }
 
-    if (buffer.empty())
+    if (entries.empty())
         return;  // Nothing to do.
 
     Timer t;
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     {
-        // On failure, place entries back into the map, unless a newer value already exists.
-        ON_BLOCK_EXIT([this, &buffer]() {
+        // Entries before this index have been committed.
+        std::size_t numCommitted = 0;
+
+        // On failure, place the uncommitted entries back into the buffer, unless a newer value
+        // already exists.
+        ON_BLOCK_EXIT([this, &entries, &numCommitted]() {
             this->_cursor->reset(this->_cursor);
-            if (!buffer.empty()) {
-                stdx::lock_guard<stdx::mutex> bufferLock(this->_bufferMutex);
-                for (auto& it : buffer)
-                    this->_buffer.try_emplace(it.first, it.second);
+            if (numCommitted < entries.size()) {
+                flushStats.failedFlushes.fetchAndAdd(1);
+                for (std::size_t i = numCommitted; i < entries.size(); i++) {
+                    BufferShard& shard = this->_shardFor(entries[i].first);
+                    stdx::lock_guard<stdx::mutex> bufferLock(shard.mutex);
+                    shard.buffer.try_emplace(entries[i].first, entries[i].second);
+                }
             }
         });
 
         WT_SESSION* session = _session.getSession();
-        WiredTigerBeginTxnBlock txnOpen(session, syncToDisk ? "sync=true" : nullptr);
-
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
-
-            // Ordering is important here: when the store method checks if the SizeInfo
-            // is dirty and it returns true, the current values of numRecords and dataSize must
-            // still be written back. So, the required order is to clear the dirty flag first.
-            SizeInfo& sizeInfo = *it->second;
-            sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
-
-            auto& uri = it->first;
-            LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
-            WiredTigerItem key(uri.c_str(), uri.size());
-            WiredTigerItem value(data.objdata(), data.objsize());
-            _cursor->set_key(_cursor, key.Get());
-            _cursor->set_value(_cursor, value.Get());
-            invariantWTOK(_cursor->insert(_cursor));
+        while (numCommitted < entries.size()) {
+            const std::size_t batchEnd = std::min(entries.size(), numCommitted + kFlushBatchSize);
+
+            // Commits are written to the journal in order, so syncing the last batch also makes
+            // the batches before it durable.
+            const bool lastBatch = batchEnd == entries.size();
+            WiredTigerBeginTxnBlock txnOpen(session,
+                                            syncToDisk && lastBatch ? "sync=true" : nullptr);
+
+            for (std::size_t i = numCommitted; i < batchEnd; i++) {
+                // Ordering is important here: when the store method checks if the SizeInfo
+                // is dirty and it returns true, the current values of numRecords and dataSize must
+                // still be written back. So, the required order is to clear the dirty flag first.
+                SizeInfo& sizeInfo = *entries[i].second;
+                sizeInfo._dirty.store(false);
+                BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
+                                                 << sizeInfo.dataSize.load());
+
+                auto& uri = entries[i].first;
+                LOG(2) << "WiredTigerSizeStorer::flush " << uri << " -> " << redact(data);
+                WiredTigerItem key(uri.c_str(), uri.size());
+                WiredTigerItem value(data.objdata(), data.objsize());
+                _cursor->set_key(_cursor, key.Get());
+                _cursor->set_value(_cursor, value.Get());
+                invariantWTOK(_cursor->insert(_cursor));
+            }
+            txnOpen.done();
+            invariantWTOK(session->commit_transaction(session, nullptr));
+
+            flushStats.entriesFlushed.fetchAndAdd(batchEnd - numCommitted);
+            flushStats.batchesCommitted.fetchAndAdd(1);
+            numCommitted = batchEnd;
         }
-        txnOpen.done();
-        invariantWTOK(session->commit_transaction(session, nullptr));
-        buffer.clear();
     }
 
     auto micros = t.micros();
-    LOG(2) << "WiredTigerSizeStorer flush took " << micros << " µs";
+    flushStats.flushes.fetchAndAdd(1);
+    flushStats.totalMicros.fetchAndAdd(micros);
+    flushStats.lastMicros.store(micros);
+    for (auto max = flushStats.maxMicros.load(); micros > max;) {
+        const auto prev = flushStats.maxMicros.compareAndSwap(max, micros);
+        if (prev == max)
+            break;
+        max = prev;
+    }
+    LOG(2) << "WiredTigerSizeStorer flush of " << entries.size() << " entries took " << micros
+           << " µs";
+}
+
+// static
+void WiredTigerSizeStorer::appendGlobalStats(BSONObjBuilder& builder) {
+    BSONObjBuilder bob(builder.subobjStart("sizeStorer"));
+    bob.append("flushes", flushStats.flushes.load());
+    bob.append("failedFlushes", flushStats.failedFlushes.load());
+    bob.append("entriesFlushed", flushStats.entriesFlushed.load());
+    bob.append("batchesCommitted", flushStats.batchesCommitted.load());
+    bob.append("totalFlushMicros", flushStats.totalMicros.load());
+    bob.append("lastFlushMicros", flushStats.lastMicros.load());
+    bob.append("maxFlushMicros", flushStats.maxMicros.load());
+}
+
+WiredTigerSizeStorer::BufferShard& WiredTigerSizeStorer::_shardFor(StringData uri) const {
+    return _shards[StringMapTraits::hash(uri) % _shards.size()];
 }
 }  // namespace mongo
@@ -31,7 +31,9 @@
 
 #pragma once
 
+#include <boost/align/aligned_allocator.hpp>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -40,9 +42,12 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
+
 /**
  * The WiredTigerSizeStorer class serves as a write buffer to durably store size information for
  * MongoDB collections. The size storer uses a separate WiredTiger table as key-value store, where
@@ -53,6 +58,11 @@ namespace mongo {
  * in size updates to be lost, so size information is only approximate. Reads use the buffer for
  * pending stores, or otherwise read directly from the WiredTiger table using a dedicated session
  * and cursor.
+ *
+ * The buffer is split into shards by URI, each with its own mutex, so that stores from many
+ * collections do not contend on a single lock. A flush writes the dirty entries in batches of
+ * separate transactions, so that flushing many collections neither builds one large transaction
+ * nor forces every batch to the journal.
  */
 class WiredTigerSizeStorer {
 public:
@@ -89,20 +99,44 @@ public:
     std::shared_ptr<SizeInfo> load(StringData uri) const;
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table. If 'syncToDisk' is true, all changes are
+     * durable once this returns.
      */
     void flush(bool syncToDisk);
 
+    /**
+     * Appends flush statistics of all size storers of this process to 'builder'.
+     */
+    static void appendGlobalStats(BSONObjBuilder& builder);
+
+    // Number of independently locked shards of the buffer.
+    static constexpr std::size_t kNumBufferShards = 16;
+
+    // Maximum number of entries written by a single transaction of a flush.
+    static constexpr std::size_t kFlushBatchSize = 1000;
+
 private:
     const WiredTigerSession _session;
     const bool _readOnly;
-    // Guards _cursor. Acquire *before* _bufferMutex.
+    // Guards _cursor. Acquire *before* any buffer shard mutex.
     mutable stdx::mutex _cursorMutex;
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
     using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
 
-    mutable stdx::mutex _bufferMutex;  // Guards _buffer
-    Buffer _buffer;
+    struct BufferShard {
+        mutable stdx::mutex mutex;  // Guards buffer
+        Buffer buffer;
+    };
+
+    using CacheAlignedBufferShard = CacheAligned<BufferShard>;
+
+    BufferShard& _shardFor(StringData uri) const;
+
+    // Pending stores, sharded by the hash of their URI. Shard mutexes are acquired *after*
+    // _cursorMutex, and at most one at a time.
+    mutable std::vector<CacheAlignedBufferShard,
+                        boost::alignment::aligned_allocator<CacheAlignedBufferShard>>
+        _shards;
 };
 }
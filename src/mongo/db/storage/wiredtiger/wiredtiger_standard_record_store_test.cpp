@@ -295,6 +295,101 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(nullptr);  // this has to be deleted before ss
 }
 
+// Flushing more entries than fit in one batch writes all of them, spread over several
+// transactions.
+TEST(WiredTigerRecordStoreTest, SizeStorerFlushInBatches) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    const string sizeStorerUri = "table:sizeStorerBatches";
+    const bool readOnly = false;
+
+    const int numEntries = 2 * WiredTigerSizeStorer::kFlushBatchSize + 1;
+    {
+        WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri, readOnly);
+        for (int i = 0; i < numEntries; i++) {
+            auto info = std::make_shared<WiredTigerSizeStorer::SizeInfo>();
+            info->numRecords.store(i);
+            info->dataSize.store(2 * i);
+            ss.store(str::stream() << "table:collection-" << i, info);
+        }
+
+        BSONObjBuilder before;
+        WiredTigerSizeStorer::appendGlobalStats(before);
+        const long long batchesBefore =
+            before.obj()["sizeStorer"]["batchesCommitted"].numberLong();
+
+        ss.flush(true);
+
+        BSONObjBuilder after;
+        WiredTigerSizeStorer::appendGlobalStats(after);
+        ASSERT_EQUALS(batchesBefore + 3,
+                      after.obj()["sizeStorer"]["batchesCommitted"].numberLong());
+    }
+
+    WiredTigerSizeStorer ss(harnessHelper->conn(), sizeStorerUri, readOnly);
+    for (int i = 0; i < numEntries; i++) {
+        auto info = ss.load(str::stream() << "table:collection-" << i);
+        ASSERT_EQUALS(i, info->numRecords.load());
+        ASSERT_EQUALS(2 * i, info->dataSize.load());
+    }
+}
+
+TEST(WiredTigerRecordStoreTest, LazyInitAssignsIdsAfterExistingRecords) {
+    wiredTigerLazyRecordStoreInit = true;
+    ON_BLOCK_EXIT([] { wiredTigerLazyRecordStoreInit = false; });
+
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    string uri = checked_cast<WiredTigerRecordStore*>(rs.get())->getURI();
+
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer ss(harnessHelper->conn(), "table:lazyInitSizeStorer", enableWtLogging);
+    checked_cast<WiredTigerRecordStore*>(rs.get())->setSizeStorer(&ss);
+
+    const int N = 12;
+    RecordId lastId;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < N; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+            ASSERT_OK(res.getStatus());
+            lastId = res.getValue();
+        }
+        uow.commit();
+    }
+
+    rs.reset(NULL);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = "a.b"_sd;
+        params.uri = uri;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = &ss;
+
+        auto ret = new StandardWiredTigerRecordStore(nullptr, opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        rs.reset(ret);
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(N, rs->numRecords(opCtx.get()));
+
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, Timestamp(), false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_GT(res.getValue(), lastId);
+        uow.commit();
+    }
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
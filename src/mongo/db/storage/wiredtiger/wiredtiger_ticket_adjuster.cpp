@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
+
+#include <algorithm>
+#include <wiredtiger.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+// Whether the number of concurrent WiredTiger transactions adapts to the state of the cache and
+// the ticket wait times, instead of staying at the configured values.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerAdaptiveConcurrentTransactions, bool, false);
+
+// The mean ticket wait above which tickets are added, when the cache is not under pressure.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsTargetWaitMicros, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveTicketsTargetWaitMicros must be greater than or "
+                          "equal to 0");
+        }
+        return Status::OK();
+    });
+
+// The percentage of the cache holding dirty data above which write tickets are taken away.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsDirtyFillPercent, int, 15)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 100) {
+            return Status(ErrorCodes::BadValue,
+                          "wiredTigerAdaptiveTicketsDirtyFillPercent must be between 1 and 100");
+        }
+        return Status::OK();
+    });
+
+const Seconds kAdjustmentInterval(1);
+
+}  // namespace
+
+constexpr int WiredTigerTicketAdjuster::kMinTickets;
+constexpr int WiredTigerTicketAdjuster::kMaxTickets;
+
+bool WiredTigerTicketAdjuster::isEnabled() {
+    return wiredTigerAdaptiveConcurrentTransactions;
+}
+
+WiredTigerTicketAdjuster::WiredTigerTicketAdjuster(WiredTigerSessionCache* sessionCache,
+                                                   TicketHolder* readTickets,
+                                                   TicketHolder* writeTickets)
+    : BackgroundJob(false /* deleteSelf */),
+      _sessionCache(sessionCache),
+      _readTickets(readTickets),
+      _writeTickets(writeTickets) {}
+
+std::string WiredTigerTicketAdjuster::name() const {
+    return "WTTicketAdjuster";
+}
+
+void WiredTigerTicketAdjuster::run() {
+    Client::initThread(name().c_str());
+
+    LOG(1) << "starting " << name() << " thread";
+
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _condvar.wait_for(lock, kAdjustmentInterval.toSystemDuration(), [this] {
+                return _shuttingDown.load();
+            });
+        }
+        if (_shuttingDown.load()) {
+            break;
+        }
+
+        try {
+            _adjust();
+        } catch (const AssertionException& ex) {
+            if (!ErrorCodes::isShutdownError(ex.code())) {
+                warning() << "Failed to adjust the WiredTiger tickets: " << ex.toStatus();
+            }
+        }
+    }
+    LOG(1) << "stopping " << name() << " thread";
+}
+
+void WiredTigerTicketAdjuster::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _shuttingDown.store(true);
+    }
+    _condvar.notify_one();
+    wait();
+}
+
+int WiredTigerTicketAdjuster::computeNumTickets(int numTickets,
+                                                bool cacheUnderPressure,
+                                                Microseconds meanWait,
+                                                Microseconds targetWait) {
+    if (cacheUnderPressure) {
+        return std::max(kMinTickets, numTickets - numTickets / 4);
+    }
+    if (meanWait > targetWait) {
+        // Never take away tickets configured beyond kMaxTickets for lack of pressure.
+        return std::max(numTickets,
+                        std::min(kMaxTickets, numTickets + std::max(kMinTickets, numTickets / 4)));
+    }
+    return numTickets;
+}
+
+void WiredTigerTicketAdjuster::_adjust() {
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+    auto getStat = [s](int key) {
+        return uassertStatusOK(
+            WiredTigerUtil::getStatisticsValueAs<long long>(s, "statistics:", "", key));
+    };
+
+    const long long maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    const long long dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    const long long applicationEvictions = getStat(WT_STAT_CONN_CACHE_EVICTION_APP);
+
+    // Application threads only evict pages themselves when the eviction server cannot keep up, so
+    // any such eviction since the last adjustment means operations stalled on the cache.
+    const bool evictionStalls = applicationEvictions > _lastApplicationEvictions;
+    _lastApplicationEvictions = applicationEvictions;
+
+    const bool dirtyFillExceeded = maxBytes > 0 &&
+        dirtyBytes * 100 > maxBytes * wiredTigerAdaptiveTicketsDirtyFillPercent.load();
+
+    const Microseconds targetWait(wiredTigerAdaptiveTicketsTargetWaitMicros.load());
+    _readTickets.adjust(evictionStalls, targetWait, "read");
+    _writeTickets.adjust(evictionStalls || dirtyFillExceeded, targetWait, "write");
+}
+
+WiredTigerTicketAdjuster::Tickets::Tickets(TicketHolder* holder)
+    : holder(holder),
+      lastNumWaits(holder->numWaits()),
+      lastTotalWaitMicros(holder->totalWaitMicros()) {}
+
+Microseconds WiredTigerTicketAdjuster::Tickets::meanWaitSinceLastCall() {
+    const long long numWaits = holder->numWaits();
+    const long long totalWaitMicros = holder->totalWaitMicros();
+    const long long waits = numWaits - lastNumWaits;
+    const long long waitMicros = totalWaitMicros - lastTotalWaitMicros;
+    lastNumWaits = numWaits;
+    lastTotalWaitMicros = totalWaitMicros;
+    return Microseconds(waits > 0 ? waitMicros / waits : 0);
+}
+
+void WiredTigerTicketAdjuster::Tickets::adjust(bool cacheUnderPressure,
+                                               Microseconds targetWait,
+                                               const char* kind) {
+    const int numTickets = holder->outof();
+    const int newNumTickets =
+        computeNumTickets(numTickets, cacheUnderPressure, meanWaitSinceLastCall(), targetWait);
+    if (newNumTickets == numTickets) {
+        return;
+    }
+
+    auto status = holder->resize(newNumTickets);
+    if (!status.isOK()) {
+        LOG(1) << "Could not resize WiredTiger " << kind << " tickets to " << newNumTickets << ": "
+               << status;
+        return;
+    }
+    LOG(1) << "WiredTiger now hands out " << newNumTickets << " " << kind << " tickets";
+}
+
+}  // namespace mongo
@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class TicketHolder;
+class WiredTigerSessionCache;
+
+/**
+ * Resizes the read and write TicketHolders which bound the number of concurrent WiredTiger
+ * transactions, in place of the static wiredTigerConcurrentReadTransactions and
+ * wiredTigerConcurrentWriteTransactions settings.
+ *
+ * Once a second, the number of write tickets is cut by a quarter while the dirty fill of the cache
+ * exceeds wiredTigerAdaptiveTicketsDirtyFillPercent, and both kinds of tickets are cut while
+ * application threads are pulled into eviction. Otherwise, tickets are added back when the
+ * acquisitions which had to wait for a ticket waited on average longer than
+ * wiredTigerAdaptiveTicketsTargetWaitMicros.
+ */
+class WiredTigerTicketAdjuster : public BackgroundJob {
+    MONGO_DISALLOW_COPYING(WiredTigerTicketAdjuster);
+
+public:
+    // The TicketHolder cannot have fewer than five tickets.
+    static constexpr int kMinTickets = 5;
+    static constexpr int kMaxTickets = 1024;
+
+    /**
+     * Returns whether wiredTigerAdaptiveConcurrentTransactions was set at startup.
+     */
+    static bool isEnabled();
+
+    WiredTigerTicketAdjuster(WiredTigerSessionCache* sessionCache,
+                             TicketHolder* readTickets,
+                             TicketHolder* writeTickets);
+
+    std::string name() const override;
+
+    void run() override;
+
+    void shutdown();
+
+    /**
+     * Returns the number of tickets to hand out after 'numTickets'. Shrinks if 'cacheUnderPressure'
+     * and otherwise grows if 'meanWait', the mean wait of the acquisitions which could not get a
+     * ticket right away, exceeds 'targetWait'.
+     */
+    static int computeNumTickets(int numTickets,
+                                 bool cacheUnderPressure,
+                                 Microseconds meanWait,
+                                 Microseconds targetWait);
+
+private:
+    /**
+     * Tracks the wait statistics of a TicketHolder between two adjustments.
+     */
+    struct Tickets {
+        explicit Tickets(TicketHolder* holder);
+
+        /**
+         * Returns the mean wait time of the acquisitions which waited since the last call.
+         */
+        Microseconds meanWaitSinceLastCall();
+
+        void adjust(bool cacheUnderPressure, Microseconds targetWait, const char* kind);
+
+        TicketHolder* holder;
+        long long lastNumWaits;
+        long long lastTotalWaitMicros;
+    };
+
+    void _adjust();
+
+    WiredTigerSessionCache* const _sessionCache;
+    Tickets _readTickets;
+    Tickets _writeTickets;
+
+    long long _lastApplicationEvictions = 0;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    AtomicBool _shuttingDown{false};
+};
+
+}  // namespace mongo
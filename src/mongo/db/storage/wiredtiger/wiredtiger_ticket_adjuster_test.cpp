@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const Microseconds kTargetWait(1000);
+
+TEST(WiredTigerTicketAdjusterTest, TicketsShrinkWhileCacheIsUnderPressure) {
+    ASSERT_EQ(96,
+              WiredTigerTicketAdjuster::computeNumTickets(128, true, Microseconds(0), kTargetWait));
+
+    // Pressure wins over long waits.
+    ASSERT_EQ(96,
+              WiredTigerTicketAdjuster::computeNumTickets(
+                  128, true, Microseconds(1000 * 1000), kTargetWait));
+    ASSERT_EQ(WiredTigerTicketAdjuster::kMinTickets,
+              WiredTigerTicketAdjuster::computeNumTickets(
+                  WiredTigerTicketAdjuster::kMinTickets, true, Microseconds(0), kTargetWait));
+}
+
+TEST(WiredTigerTicketAdjusterTest, TicketsGrowWhileWaitsExceedTarget) {
+    ASSERT_EQ(160,
+              WiredTigerTicketAdjuster::computeNumTickets(
+                  128, false, Microseconds(1001), kTargetWait));
+    ASSERT_EQ(WiredTigerTicketAdjuster::kMinTickets * 2,
+              WiredTigerTicketAdjuster::computeNumTickets(WiredTigerTicketAdjuster::kMinTickets,
+                                                          false,
+                                                          Microseconds(1001),
+                                                          kTargetWait));
+    ASSERT_EQ(WiredTigerTicketAdjuster::kMaxTickets,
+              WiredTigerTicketAdjuster::computeNumTickets(
+                  1000, false, Microseconds(1001), kTargetWait));
+
+    // Tickets configured beyond the maximum are kept.
+    ASSERT_EQ(2000,
+              WiredTigerTicketAdjuster::computeNumTickets(
+                  2000, false, Microseconds(1001), kTargetWait));
+}
+
+TEST(WiredTigerTicketAdjusterTest, TicketsStayWhileWaitsAreWithinTarget) {
+    ASSERT_EQ(128,
+              WiredTigerTicketAdjuster::computeNumTickets(128, false, kTargetWait, kTargetWait));
+    ASSERT_EQ(
+        128, WiredTigerTicketAdjuster::computeNumTickets(128, false, Microseconds(0), kTargetWait));
+}
+
+}  // namespace
+}  // namespace mongo
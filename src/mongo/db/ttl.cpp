@@ -47,7 +47,6 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
-#include "mongo/db/exec/delete.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/insert.h"
@@ -55,19 +54,35 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/ttl_collection_cache.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
 Counter64 ttlPasses;
 Counter64 ttlDeletedDocuments;
+Counter64 ttlDeletedBatches;
+Counter64 ttlCollectionsInProgress;
+Counter64 ttlRateLimitedMillis;
+Counter64 ttlReplicationLagBackoffs;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
+ServerStatusMetricField<Counter64> ttlDeletedBatchesDisplay("ttl.deletedBatches",
+                                                            &ttlDeletedBatches);
+ServerStatusMetricField<Counter64> ttlCollectionsInProgressDisplay("ttl.collectionsInProgress",
+                                                                   &ttlCollectionsInProgress);
+ServerStatusMetricField<Counter64> ttlRateLimitedMillisDisplay("ttl.rateLimitedMillis",
+                                                               &ttlRateLimitedMillis);
+ServerStatusMetricField<Counter64> ttlReplicationLagBackoffsDisplay("ttl.replicationLagBackoffs",
+                                                                    &ttlReplicationLagBackoffs);
 
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60)
@@ -77,9 +92,111 @@ MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60)
         return Status::OK();
     });  // used for testing
 
+// Number of expired documents deleted together in one storage transaction.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0)
+            return Status(ErrorCodes::BadValue, "ttlMonitorBatchSize must be strictly positive");
+        return Status::OK();
+    });
+
+// Maximum rate, across all collections, at which expired documents are deleted. 0 is unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorDeletesPerSecond, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0)
+            return Status(ErrorCodes::BadValue, "ttlMonitorDeletesPerSecond must be non-negative");
+        return Status::OK();
+    });
+
+// A primary whose majority commit point trails its last applied optime by more than this many
+// seconds stops deleting until the next pass. 0 disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxReplicationLagSecs, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0)
+            return Status(ErrorCodes::BadValue,
+                          "ttlMonitorMaxReplicationLagSecs must be non-negative");
+        return Status::OK();
+    });
+
+// Number of collections whose expired documents are deleted concurrently.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ttlMonitorNumWorkers, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 32)
+            return Status(ErrorCodes::BadValue, "ttlMonitorNumWorkers must be between 1 and 32");
+        return Status::OK();
+    });
+
+namespace {
+
+/**
+ * Paces the deletions of all TTL workers to 'ttlMonitorDeletesPerSecond'.
+ *
+ * Deletions are scheduled back to back on a shared timeline: every batch pushes the end of the
+ * timeline forward by the time its documents are worth at the configured rate, and the worker
+ * which deleted it waits until the timeline catches up with the clock.
+ */
+class TTLDeleteRateLimiter {
+public:
+    /**
+     * Accounts for 'numDeleted' documents and returns how long the caller must wait.
+     */
+    Milliseconds consume(long long numDeleted) {
+        const long long docsPerSecond = ttlMonitorDeletesPerSecond.load();
+        if (docsPerSecond <= 0 || numDeleted <= 0) {
+            return Milliseconds(0);
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const long long nowMicros = Date_t::now().toMillisSinceEpoch() * 1000;
+        // An idle limiter does not bank credit for a later burst.
+        _nextMicros = std::max(_nextMicros, nowMicros);
+        _nextMicros += numDeleted * 1000 * 1000 / docsPerSecond;
+        return Milliseconds((_nextMicros - nowMicros) / 1000);
+    }
+
+private:
+    stdx::mutex _mutex;
+    long long _nextMicros = 0;
+};
+
+/**
+ * Returns true if this node is a primary whose writes are not being replicated to a majority
+ * quickly enough, by 'ttlMonitorMaxReplicationLagSecs'.
+ */
+bool replicationLagExceeded(OperationContext* opCtx) {
+    const int maxLagSecs = ttlMonitorMaxReplicationLagSecs.load();
+    if (maxLagSecs <= 0) {
+        return false;
+    }
+
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet) {
+        return false;
+    }
+
+    const long long lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp().getSecs();
+    const long long lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp().getSecs();
+    return lastApplied - lastCommitted > maxLagSecs;
+}
+
+ThreadPool::Options makeWorkerPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "TTLWorkers";
+    options.threadNamePrefix = "TTLWorker-";
+    options.minThreads = 0;
+    options.maxThreads = ttlMonitorNumWorkers;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+    };
+    return options;
+}
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
-    TTLMonitor() {}
+    TTLMonitor() : _workers(makeWorkerPoolOptions()) {}
     virtual ~TTLMonitor() {}
 
     virtual std::string name() const {
@@ -91,6 +208,7 @@ public:
     virtual void run() {
         Client::initThread(name().c_str());
         AuthorizationSession::get(cc())->grantInternalAuthorization();
+        _workers.startup();
 
         while (!globalInShutdownDeprecated()) {
             {
@@ -133,7 +251,7 @@ private:
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
-        std::vector<BSONObj> ttlIndexes;
+        std::vector<std::vector<BSONObj>> ttlIndexesByCollection;
 
         ttlPasses.increment();
 
@@ -151,17 +269,39 @@ private:
             CollectionCatalogEntry* collEntry = coll->getCatalogEntry();
             std::vector<std::string> indexNames;
             collEntry->getAllIndexes(&opCtx, &indexNames);
+            std::vector<BSONObj> ttlIndexes;
             for (const std::string& name : indexNames) {
                 BSONObj spec = collEntry->getIndexSpec(&opCtx, name);
                 if (spec.hasField(secondsExpireField)) {
                     ttlIndexes.push_back(spec.getOwned());
                 }
             }
+            if (!ttlIndexes.empty()) {
+                ttlIndexesByCollection.push_back(std::move(ttlIndexes));
+            }
         }
 
+        // Collections are processed concurrently, the TTL indexes of one collection in turn.
+        for (auto&& ttlIndexes : ttlIndexesByCollection) {
+            Status status =
+                _workers.schedule([this, ttlIndexes] { doTTLForCollection(ttlIndexes); });
+            if (!status.isOK()) {
+                // The pool is shutting down.
+                return;
+            }
+        }
+        _workers.waitForIdle();
+    }
+
+    void doTTLForCollection(const std::vector<BSONObj>& ttlIndexes) {
+        ttlCollectionsInProgress.increment();
+        ON_BLOCK_EXIT([] { ttlCollectionsInProgress.decrement(); });
+
+        const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+        opCtx->lockState()->setTicketPriority(Locker::TicketPriority::kLow);
         for (const BSONObj& idx : ttlIndexes) {
             try {
-                doTTLForIndex(&opCtx, idx);
+                doTTLForIndex(opCtx.get(), idx);
             } catch (const DBException& dbex) {
                 error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
                 // Continue on to the next index.
@@ -185,8 +325,9 @@ private:
             return;
         }
 
-        const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
+        // Owned copies, since 'idx' is re-read from the index descriptor below.
+        const BSONObj key = idx["key"].Obj().getOwned();
+        const std::string name = idx["name"].String();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
             return;
@@ -194,89 +335,166 @@ private:
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
 
+        BSONObj startKey;
+        BSONObj endKey;
+        InternalPlanner::Direction direction;
+        {
+            AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IS);
+            Collection* collection = autoGetCollection.getCollection();
+            if (!collection) {
+                // Collection was dropped.
+                return;
+            }
+
+            IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
+            if (!desc) {
+                LOG(1) << "index not found (index build in progress? index dropped?), skipping "
+                       << "ttl job for: " << idx;
+                return;
+            }
+
+            // Re-read 'idx' from the descriptor, in case the collection or index definition
+            // changed before we re-acquired the collection lock.
+            idx = desc->infoObj();
+
+            if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
+                error() << "special index can't be used as a ttl index, skipping ttl job for: "
+                        << idx;
+                return;
+            }
+
+            BSONElement secondsExpireElt = idx[secondsExpireField];
+            if (!secondsExpireElt.isNumber()) {
+                error() << "ttl indexes require the " << secondsExpireField << " field to be "
+                        << "numeric but received a type of " << typeName(secondsExpireElt.type())
+                        << ", skipping ttl job for: " << idx;
+                return;
+            }
+
+            const Date_t kDawnOfTime =
+                Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
+            const Date_t expirationTime =
+                Date_t::now() - Seconds(secondsExpireElt.numberLong());
+            startKey = BSON("" << kDawnOfTime);
+            endKey = BSON("" << expirationTime);
+            // The canonical check as to whether a key pattern element is "ascending" or
+            // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
+            direction = (key.firstElement().number() >= 0) ? InternalPlanner::Direction::FORWARD
+                                                           : InternalPlanner::Direction::BACKWARD;
+        }
+
+        long long numDeleted = 0;
+        bool exhausted = false;
+        while (!exhausted) {
+            if (!ttlMonitorEnabled.load()) {
+                break;
+            }
+            opCtx->checkForInterrupt();
+
+            const long long batchSize = ttlMonitorBatchSize.load();
+            const long long numDeletedInBatch = deleteExpiredBatch(
+                opCtx, collectionNSS, name, endKey, direction, batchSize, &startKey);
+            if (numDeletedInBatch < 0) {
+                // The collection or the index went away, or this node stepped down.
+                break;
+            }
+            exhausted = numDeletedInBatch < batchSize;
+            numDeleted += numDeletedInBatch;
+            ttlDeletedDocuments.increment(numDeletedInBatch);
+            if (numDeletedInBatch > 0) {
+                ttlDeletedBatches.increment();
+            }
+
+            const Milliseconds wait = _rateLimiter.consume(numDeletedInBatch);
+            if (wait > Milliseconds(0)) {
+                ttlRateLimitedMillis.increment(durationCount<Milliseconds>(wait));
+                opCtx->sleepFor(wait);
+            }
+
+            if (!exhausted && replicationLagExceeded(opCtx)) {
+                LOG(1) << "replication lag exceeds " << ttlMonitorMaxReplicationLagSecs.load()
+                       << " seconds, deferring the rest of the ttl job for: " << idx;
+                ttlReplicationLagBackoffs.increment();
+                break;
+            }
+        }
+
+        LOG(1) << "deleted: " << numDeleted;
+    }
+
+    /**
+     * Deletes up to 'batchSize' documents, in one storage transaction, whose keys in the
+     * TTL index 'indexName' lie between '*startKey' and 'endKey', scanning in 'direction'. Each
+     * batch holds the collection lock only while it runs; '*startKey' is advanced to the last key
+     * seen so that the next batch does not rescan the keys this one removed.
+     *
+     * Returns the number of documents deleted, or -1 if the batch could not run.
+     */
+    long long deleteExpiredBatch(OperationContext* opCtx,
+                                 const NamespaceString& collectionNSS,
+                                 StringData indexName,
+                                 const BSONObj& endKey,
+                                 InternalPlanner::Direction direction,
+                                 long long batchSize,
+                                 BSONObj* startKey) {
         AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
         Collection* collection = autoGetCollection.getCollection();
         if (!collection) {
-            // Collection was dropped.
-            return;
+            return -1;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return -1;
         }
 
-        IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
+        IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
         if (!desc) {
-            LOG(1) << "index not found (index build in progress? index dropped?), skipping "
-                   << "ttl job for: " << idx;
-            return;
+            return -1;
         }
 
-        // Re-read 'idx' from the descriptor, in case the collection or index definition changed
-        // before we re-acquired the collection lock.
-        idx = desc->infoObj();
+        long long numDeleted = 0;
+        BSONObj lastKey;
+        writeConflictRetry(opCtx, "ttl delete", collectionNSS.ns(), [&] {
+            numDeleted = 0;
+            WriteUnitOfWork wuow(opCtx);
 
-        if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
-            error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
-        }
+            // The scan and the deletes share the transaction's snapshot, so every document found
+            // through an expired key is still expired when it is deleted.
+            stdx::unordered_set<RecordId, RecordId::Hasher> expired;
+            {
+                auto exec = InternalPlanner::indexScan(opCtx,
+                                                       collection,
+                                                       desc,
+                                                       *startKey,
+                                                       endKey,
+                                                       BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                       PlanExecutor::NO_YIELD,
+                                                       direction);
+                BSONObj key;
+                RecordId rid;
+                while (static_cast<long long>(expired.size()) < batchSize &&
+                       PlanExecutor::ADVANCED == exec->getNext(&key, &rid)) {
+                    // A multikey index may return a document once per expired key.
+                    expired.insert(rid);
+                    lastKey = key.getOwned();
+                }
+            }
 
-        BSONElement secondsExpireElt = idx[secondsExpireField];
-        if (!secondsExpireElt.isNumber()) {
-            error() << "ttl indexes require the " << secondsExpireField << " field to be "
-                    << "numeric but received a type of " << typeName(secondsExpireElt.type())
-                    << ", skipping ttl job for: " << idx;
-            return;
-        }
+            for (const RecordId& rid : expired) {
+                collection->deleteDocument(opCtx, kUninitializedStmtId, rid, nullptr);
+                ++numDeleted;
+            }
+            wuow.commit();
+        });
 
-        const Date_t kDawnOfTime =
-            Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
-        const BSONObj startKey = BSON("" << kDawnOfTime);
-        const BSONObj endKey = BSON("" << expirationTime);
-        // The canonical check as to whether a key pattern element is "ascending" or
-        // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
-        const InternalPlanner::Direction direction = (key.firstElement().number() >= 0)
-            ? InternalPlanner::Direction::FORWARD
-            : InternalPlanner::Direction::BACKWARD;
-
-        // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
-        // queries for the expired documents correctly so that we do not delete documents that are
-        // not actually expired when our snapshot changes during deletion.
-        const char* keyFieldName = key.firstElement().fieldName();
-        BSONObj query =
-            BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationTime));
-        auto qr = stdx::make_unique<QueryRequest>(collectionNSS);
-        qr->setFilter(query);
-        auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
-        invariant(canonicalQuery.getStatus());
-
-        DeleteStageParams params;
-        params.isMulti = true;
-        params.canonicalQuery = canonicalQuery.getValue().get();
-
-        auto exec =
-            InternalPlanner::deleteWithIndexScan(opCtx,
-                                                 collection,
-                                                 params,
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 BoundInclusion::kIncludeBothStartAndEndKeys,
-                                                 PlanExecutor::YIELD_AUTO,
-                                                 direction);
-
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            error() << "ttl query execution for index " << idx
-                    << " failed with status: " << redact(result);
-            return;
+        if (!lastKey.isEmpty()) {
+            *startKey = lastKey;
         }
-
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "deleted: " << numDeleted;
+        return numDeleted;
     }
+
+    ThreadPool _workers;
+    TTLDeleteRateLimiter _rateLimiter;
 };
 
 namespace {
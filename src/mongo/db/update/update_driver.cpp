@@ -37,6 +37,7 @@
 #include "mongo/db/field_ref.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/update/log_builder.h"
 #include "mongo/db/update/modifier_table.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/update/storage_validation.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/safe_num.h"
 #include "mongo/util/stringutils.h"
 
 namespace mongo {
@@ -186,6 +188,44 @@ void UpdateDriver::parse(
     auto root = stdx::make_unique<UpdateObjectNode>();
     _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
     _root = std::move(root);
+
+    if (internalQueryUpdateTopLevelFieldsFastPath.load() && arrayFilters.empty() &&
+        !_fromOplogApplication) {
+        parseTopLevelMods(updateExpr);
+    }
+}
+
+void UpdateDriver::parseTopLevelMods(const BSONObj& updateExpr) {
+    std::vector<TopLevelMod> mods;
+    for (auto&& mod : updateExpr) {
+        const auto modType = modifiertable::getType(mod.fieldNameStringData());
+        if (modType != modifiertable::MOD_SET && modType != modifiertable::MOD_INC &&
+            modType != modifiertable::MOD_UNSET) {
+            return;
+        }
+
+        for (auto&& field : mod.Obj()) {
+            // Dotted, positional and '_id' paths need checks that only the UpdateNode tree makes.
+            const auto fieldName = field.fieldNameStringData();
+            if (fieldName.empty() || fieldName[0] == '$' ||
+                fieldName.find('.') != std::string::npos || fieldName == "_id"_sd) {
+                return;
+            }
+
+            // Setting an object or an array requires validating it for storage.
+            if (modType == modifiertable::MOD_SET &&
+                (field.type() == BSONType::Object || field.type() == BSONType::Array)) {
+                return;
+            }
+
+            mods.push_back({modType, fieldName, field});
+        }
+    }
+
+    std::sort(mods.begin(), mods.end(), [](const TopLevelMod& lhs, const TopLevelMod& rhs) {
+        return lhs.fieldName < rhs.fieldName;
+    });
+    _topLevelMods = std::move(mods);
 }
 
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
@@ -288,6 +328,219 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::updateTopLevelFields(const BSONObj& oldObj,
+                                        const FieldRefSet& immutablePaths,
+                                        BSONObj* newObj,
+                                        BSONObj* logOpRec,
+                                        bool* docWasModified,
+                                        mutablebson::DamageVector* damages) {
+    if (damages) {
+        damages->clear();
+    }
+
+    // An upsert may also apply $setOnInsert, and the caller of update() moves or adds '_id' when
+    // it is not the first field.
+    if (_topLevelMods.empty() || _insert || _fromOplogApplication ||
+        oldObj.firstElement().fieldNameStringData() != "_id"_sd) {
+        return false;
+    }
+
+    const size_t numMods = _topLevelMods.size();
+    const auto findMod = [this, numMods](StringData fieldName) -> size_t {
+        auto it = std::lower_bound(
+            _topLevelMods.begin(),
+            _topLevelMods.end(),
+            fieldName,
+            [](const TopLevelMod& mod, StringData name) { return mod.fieldName < name; });
+        return (it != _topLevelMods.end() && it->fieldName == fieldName)
+            ? static_cast<size_t>(it - _topLevelMods.begin())
+            : numMods;
+    };
+
+    // Leave it to update() to decide whether a field that is or contains an immutable path may
+    // change.
+    for (auto&& immutablePath : immutablePaths) {
+        if (findMod(immutablePath->getPart(0)) != numMods) {
+            return false;
+        }
+    }
+
+    // Find the first field of 'oldObj' with each modified name, which is the one update() modifies.
+    std::vector<BSONElement> existing(numMods);
+    for (auto&& elem : oldObj) {
+        // Removing a field next to a '$'-prefixed one may require validating a DBRef.
+        const auto fieldName = elem.fieldNameStringData();
+        if (!fieldName.empty() && fieldName[0] == '$') {
+            return false;
+        }
+
+        const size_t i = findMod(fieldName);
+        if (i != numMods && existing[i].eoo()) {
+            existing[i] = elem;
+        }
+    }
+
+    // Compute the outcome of each modifier, treating the same updates as no-ops as update() does.
+    std::vector<SafeNum> incResults(numMods);
+    std::vector<char> changed(numMods, false);
+    bool anyChanged = false;
+    for (size_t i = 0; i < numMods; ++i) {
+        const TopLevelMod& mod = _topLevelMods[i];
+        const BSONElement& elem = existing[i];
+        switch (mod.type) {
+            case modifiertable::MOD_SET:
+                changed[i] = elem.eoo() || !elem.binaryEqualValues(mod.value);
+                break;
+            case modifiertable::MOD_INC:
+                if (elem.eoo()) {
+                    incResults[i] = SafeNum(mod.value);
+                    changed[i] = true;
+                    break;
+                }
+                // update() reports non-numeric fields and overflowing results.
+                if (!elem.isNumber()) {
+                    return false;
+                }
+                incResults[i] = SafeNum(mod.value) + SafeNum(elem);
+                if (!incResults[i].isValid()) {
+                    return false;
+                }
+                changed[i] = !incResults[i].isIdentical(SafeNum(elem));
+                break;
+            case modifiertable::MOD_UNSET:
+                changed[i] = !elem.eoo();
+                break;
+            default:
+                MONGO_UNREACHABLE;
+        }
+        anyChanged = anyChanged || changed[i];
+    }
+
+    _affectIndices = false;
+    if (_indexedFields) {
+        for (size_t i = 0; i < numMods; ++i) {
+            if (changed[i] && _indexedFields->mightBeIndexed(_topLevelMods[i].fieldName)) {
+                _affectIndices = true;
+                break;
+            }
+        }
+    }
+
+    const auto appendNewValue = [this, &incResults](size_t i, BSONObjBuilder* bob) {
+        const TopLevelMod& mod = _topLevelMods[i];
+        if (mod.type == modifiertable::MOD_INC) {
+            incResults[i].toBSON(mod.fieldName, bob);
+        } else {
+            bob->append(mod.value);
+        }
+    };
+
+    // Modified fields that are present in 'oldObj', in document order. The document can be
+    // updated with damages if these are all the changes and none of them changes a value's size.
+    std::vector<size_t> modifiedFields;
+    bool canUseDamages = damages && !_affectIndices;
+    int newFieldsSize = 0;
+    for (size_t i = 0; i < numMods; ++i) {
+        if (!changed[i]) {
+            continue;
+        }
+        const TopLevelMod& mod = _topLevelMods[i];
+        if (existing[i].eoo()) {
+            canUseDamages = false;
+            newFieldsSize += mod.value.size();
+            continue;
+        }
+        modifiedFields.push_back(i);
+        if (mod.type == modifiertable::MOD_UNSET ||
+            (mod.type == modifiertable::MOD_SET && mod.value.size() != existing[i].size()) ||
+            (mod.type == modifiertable::MOD_INC && incResults[i].type() != existing[i].type())) {
+            canUseDamages = false;
+        }
+    }
+    std::sort(modifiedFields.begin(), modifiedFields.end(), [&existing](size_t lhs, size_t rhs) {
+        return existing[lhs].rawdata() < existing[rhs].rawdata();
+    });
+
+    if (!anyChanged) {
+        *newObj = oldObj;
+    } else {
+        // Copy the unmodified runs of 'oldObj' around the modified fields, then append the new
+        // fields in the order update() creates them.
+        BSONObjBuilder bob(oldObj.objsize() + newFieldsSize);
+        const char* copyFrom = oldObj.objdata() + sizeof(int32_t);
+        for (size_t i : modifiedFields) {
+            const BSONElement& elem = existing[i];
+            bob.bb().appendBuf(copyFrom, elem.rawdata() - copyFrom);
+            const int sourceOffset = bob.len();
+            if (_topLevelMods[i].type != modifiertable::MOD_UNSET) {
+                appendNewValue(i, &bob);
+            }
+            if (canUseDamages) {
+                mutablebson::DamageEvent damage;
+                damage.sourceOffset = sourceOffset;
+                damage.targetOffset = elem.rawdata() - oldObj.objdata();
+                damage.size = elem.size();
+                damages->push_back(damage);
+            }
+            copyFrom = elem.rawdata() + elem.size();
+        }
+        // Leave out the terminating EOO byte, which the builder appends.
+        bob.bb().appendBuf(copyFrom, oldObj.objdata() + oldObj.objsize() - 1 - copyFrom);
+        for (size_t i = 0; i < numMods; ++i) {
+            if (changed[i] && existing[i].eoo()) {
+                appendNewValue(i, &bob);
+            }
+        }
+        *newObj = bob.obj();
+    }
+
+    if (docWasModified) {
+        *docWasModified = anyChanged;
+    }
+
+    if (_logOp && logOpRec) {
+        // Build the oplog entry update() would: $v first, then the $set and $unset sections in the
+        // order of their first entries.
+        BSONObjBuilder sets;
+        BSONObjBuilder unsets;
+        bool unsetsFirst = false;
+        bool loggedAny = false;
+        for (size_t i = 0; i < numMods; ++i) {
+            if (!changed[i]) {
+                continue;
+            }
+            const bool isUnset = _topLevelMods[i].type == modifiertable::MOD_UNSET;
+            if (!loggedAny) {
+                unsetsFirst = isUnset;
+                loggedAny = true;
+            }
+            if (isUnset) {
+                unsets.append(_topLevelMods[i].fieldName, true);
+            } else {
+                appendNewValue(i, &sets);
+            }
+        }
+
+        BSONObjBuilder logBob;
+        logBob.append(LogBuilder::kUpdateSemanticsFieldName,
+                      static_cast<int>(UpdateSemantics::kUpdateNode));
+        BSONObj setsObj = sets.obj();
+        BSONObj unsetsObj = unsets.obj();
+        if (unsetsFirst) {
+            logBob.append("$unset", unsetsObj);
+        }
+        if (!setsObj.isEmpty()) {
+            logBob.append("$set", setsObj);
+        }
+        if (!unsetsFirst && !unsetsObj.isEmpty()) {
+            logBob.append("$unset", unsetsObj);
+        }
+        *logOpRec = logBob.obj();
+    }
+
+    return true;
+}
+
 bool UpdateDriver::isDocReplacement() const {
     return _replacementMode;
 }
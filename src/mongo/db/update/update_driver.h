@@ -33,6 +33,7 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/jsobj.h"
@@ -101,6 +102,25 @@ public:
                   BSONObj* logOpRec = nullptr,
                   bool* docWasModified = nullptr);
 
+    /**
+     * Executes the update directly over the BSON of 'oldObj', without building a mutable
+     * Document, if the update expression only uses $set, $inc and $unset on top-level fields and
+     * 'oldObj' can be updated with exactly the effect update() would have. Returns false, having
+     * done nothing, if the caller must use update() instead. Otherwise stores the updated document
+     * in 'newObj' and fills in 'logOpRec' and 'docWasModified' as update() would. Uasserts are
+     * left to update(): any update or document that could fail is not handled here.
+     *
+     * If 'damages' is not null, it is cleared. It is then filled in with the damage events that
+     * turn 'oldObj' into 'newObj', using 'newObj.objdata()' as the damage source, if the update
+     * affects no indexes and rewrites each modified value with one of the same size.
+     */
+    bool updateTopLevelFields(const BSONObj& oldObj,
+                              const FieldRefSet& immutablePaths,
+                              BSONObj* newObj,
+                              BSONObj* logOpRec,
+                              bool* docWasModified,
+                              mutablebson::DamageVector* damages);
+
     //
     // Accessors
     //
@@ -144,6 +164,19 @@ private:
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
+    // A $set, $inc or $unset of a single top-level field, executed by updateTopLevelFields().
+    struct TopLevelMod {
+        modifiertable::ModifierType type;
+        StringData fieldName;
+        BSONElement value;
+    };
+
+    /**
+     * Populates '_topLevelMods' from 'updateExpr' if every modifier in it can be executed by
+     * updateTopLevelFields(), and leaves it empty otherwise.
+     */
+    void parseTopLevelMods(const BSONObj& updateExpr);
+
     //
     // immutable properties after parsing
     //
@@ -155,6 +188,11 @@ private:
     // The root of the UpdateNode tree.
     std::unique_ptr<UpdateNode> _root;
 
+    // The modifiers of the update sorted by field name, which is the order in which '_root' applies
+    // them, if updateTopLevelFields() can execute them. Empty otherwise. The values point into the
+    // update expression, which, as for '_root', must outlive the driver.
+    std::vector<TopLevelMod> _topLevelMods;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
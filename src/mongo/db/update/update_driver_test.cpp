@@ -41,6 +41,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/db/update_index_data.h"
 #include "mongo/unittest/unittest.h"
@@ -162,6 +163,138 @@ TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     ASSERT_TRUE(modified);
 }
 
+//
+// Tests of updateTopLevelFields(), which must produce the same document and oplog entry as
+// update() whenever it handles an update.
+//
+
+class TopLevelFieldsTest : public mongo::unittest::Test {
+public:
+    TopLevelFieldsTest() : _originalKnob(internalQueryUpdateTopLevelFieldsFastPath.load()) {
+        internalQueryUpdateTopLevelFieldsFastPath.store(true);
+        _immutablePaths.keepShortest(&_idFieldRef);
+    }
+
+    ~TopLevelFieldsTest() {
+        internalQueryUpdateTopLevelFieldsFastPath.store(_originalKnob);
+    }
+
+    /**
+     * Applies 'updateSpec' to 'docSpec' with both updateTopLevelFields() and update(), checks that
+     * the results are identical and returns whether the update could have been applied with
+     * damages. Damages are also checked to turn the original document into the updated one.
+     */
+    bool assertSameAsUpdate(const char* updateSpec, const char* docSpec) {
+        const BSONObj update = fromjson(updateSpec);
+        const BSONObj oldObj = fromjson(docSpec);
+        boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+        UpdateDriver driver(expCtx);
+        std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+        driver.parse(update, arrayFilters);
+        driver.setLogOp(true);
+
+        BSONObj newObj;
+        BSONObj logObj;
+        bool modified = false;
+        mutablebson::DamageVector damages;
+        ASSERT_TRUE(driver.updateTopLevelFields(
+            oldObj, _immutablePaths, &newObj, &logObj, &modified, &damages));
+
+        mutablebson::Document doc(oldObj);
+        BSONObj expectedLogObj;
+        bool expectedModified = false;
+        ASSERT_OK(driver.update(
+            StringData(), &doc, true, _immutablePaths, &expectedLogObj, &expectedModified));
+        const BSONObj expectedObj = doc.getObject();
+
+        ASSERT_EQ(expectedModified, modified);
+        ASSERT_TRUE(expectedObj.binaryEqual(newObj))
+            << "expected " << expectedObj << " but got " << newObj;
+        ASSERT_TRUE(expectedLogObj.binaryEqual(logObj))
+            << "expected " << expectedLogObj << " but got " << logObj;
+
+        if (damages.empty()) {
+            return false;
+        }
+        std::string damaged(oldObj.objdata(), oldObj.objsize());
+        for (auto&& damage : damages) {
+            std::copy_n(newObj.objdata() + damage.sourceOffset,
+                        damage.size,
+                        damaged.begin() + damage.targetOffset);
+        }
+        ASSERT_EQ(std::string(newObj.objdata(), newObj.objsize()), damaged);
+        return true;
+    }
+
+    /**
+     * Returns whether updateTopLevelFields() handles applying 'updateSpec' to 'docSpec'.
+     */
+    bool handles(const char* updateSpec, const char* docSpec) {
+        const BSONObj update = fromjson(updateSpec);
+        boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+        UpdateDriver driver(expCtx);
+        std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+        driver.parse(update, arrayFilters);
+
+        BSONObj newObj;
+        return driver.updateTopLevelFields(
+            fromjson(docSpec), _immutablePaths, &newObj, nullptr, nullptr, nullptr);
+    }
+
+protected:
+    FieldRef _idFieldRef{"_id"};
+    FieldRefSet _immutablePaths;
+
+private:
+    const bool _originalKnob;
+};
+
+TEST_F(TopLevelFieldsTest, SameSizeChangesUseDamages) {
+    ASSERT_TRUE(assertSameAsUpdate("{$inc: {counter: 1}, $set: {ts: 5, s: 'xyz'}}",
+                                   "{_id: 1, s: 'abc', counter: 1, ts: 4, other: 'x'}"));
+    ASSERT_TRUE(assertSameAsUpdate("{$inc: {d: 0.5}}", "{_id: 1, d: 1.0}"));
+}
+
+TEST_F(TopLevelFieldsTest, ResizedValuesRewriteTheDocument) {
+    ASSERT_FALSE(assertSameAsUpdate("{$set: {s: 'abcdef'}}", "{_id: 1, s: 'abc', t: 1}"));
+    ASSERT_FALSE(assertSameAsUpdate("{$inc: {n: 1}}", "{_id: 1, n: 2147483647, t: 1}"));
+    ASSERT_FALSE(assertSameAsUpdate("{$inc: {n: 0.5}}", "{_id: 1, n: 1, t: 1}"));
+}
+
+TEST_F(TopLevelFieldsTest, NewFieldsAreAppendedInFieldNameOrder) {
+    ASSERT_FALSE(
+        assertSameAsUpdate("{$set: {z: 1, b: 'x'}, $inc: {m: 2, a: 1}}", "{_id: 1, a: 3}"));
+}
+
+TEST_F(TopLevelFieldsTest, UnsetRemovesFields) {
+    ASSERT_FALSE(assertSameAsUpdate("{$unset: {a: 1}, $set: {b: 'x'}}", "{_id: 1, a: 1, b: 'y'}"));
+    ASSERT_FALSE(assertSameAsUpdate("{$unset: {c: 1}, $set: {a: 2}}", "{_id: 1, a: 1, c: 2}"));
+}
+
+TEST_F(TopLevelFieldsTest, NoOpUpdates) {
+    ASSERT_FALSE(assertSameAsUpdate("{$set: {a: 1}, $inc: {b: 0}, $unset: {c: 1}}",
+                                    "{_id: 1, a: 1, b: 2}"));
+}
+
+TEST_F(TopLevelFieldsTest, DuplicateFieldsUpdateTheFirstOne) {
+    ASSERT_TRUE(assertSameAsUpdate("{$inc: {a: 1}}", "{_id: 1, a: 1, a: 5}"));
+}
+
+TEST_F(TopLevelFieldsTest, OtherUpdatesAreLeftToUpdate) {
+    ASSERT_FALSE(handles("{$set: {'a.b': 1}}", "{_id: 1}"));
+    ASSERT_FALSE(handles("{$set: {a: {b: 1}}}", "{_id: 1}"));
+    ASSERT_FALSE(handles("{$set: {_id: 1}}", "{_id: 1}"));
+    ASSERT_FALSE(handles("{$max: {a: 1}}", "{_id: 1}"));
+    ASSERT_FALSE(handles("{$inc: {a: 1}}", "{_id: 1, a: 'x'}"));
+    ASSERT_FALSE(handles("{$inc: {a: 1}}", "{a: 1, _id: 1}"));
+    ASSERT_FALSE(handles("{$unset: {a: 1}}", "{_id: 1, a: 1, $x: 1}"));
+    ASSERT_TRUE(handles("{$inc: {a: 1}}", "{_id: 1, a: 1}"));
+
+    FieldRef shardKeyField("a");
+    _immutablePaths.insert(&shardKeyField);
+    ASSERT_FALSE(handles("{$inc: {a: 1}}", "{_id: 1, a: 1}"));
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
@@ -84,6 +84,7 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    _clearResolvedViews_inlock();
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -159,8 +160,10 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _clearResolvedViews_inlock();
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
+        this->_clearResolvedViews_inlock();
         this->_viewGraphNeedsRefresh = true;
     });
 
@@ -362,6 +365,7 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
     ViewDefinition savedDefinition = *viewPtr;
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_clearResolvedViews_inlock();
     });
 
     return _createOrUpdateView_inlock(
@@ -389,9 +393,11 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _clearResolvedViews_inlock();
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_clearResolvedViews_inlock();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -433,9 +439,28 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                                                   const NamespaceString& nss) {
     stdx::unique_lock<stdx::mutex> lock(_mutex);
 
+    // Views are resolved far more often than they change, so reuse an earlier resolution as long as
+    // the catalog has not been invalidated since.
+    if (_valid.load()) {
+        auto cached = _resolvedViews.find(nss.ns());
+        if (cached != _resolvedViews.end()) {
+            return *cached->second;
+        }
+    }
+
     // Keep looping until the resolution completes. If the catalog is invalidated during the
     // resolution, we start over from the beginning.
     while (true) {
+        // The failpoint below may release the mutex, so only cache a resolution if no view changed
+        // while it was computed.
+        const auto generation = _resolvedViewsGeneration;
+        auto cacheAndReturn = [&](ResolvedView resolved) -> StatusWith<ResolvedView> {
+            if (_valid.load() && generation == _resolvedViewsGeneration) {
+                _resolvedViews[nss.ns()] = std::make_shared<ResolvedView>(resolved);
+            }
+            return std::move(resolved);
+        };
+
         // Points to the name of the most resolved namespace.
         const NamespaceString* resolvedNss = &nss;
 
@@ -477,7 +502,7 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                             str::stream() << "View pipeline exceeds maximum size; maximum size is "
                                           << ViewGraph::kMaxViewPipelineSizeBytes};
                 }
-                return StatusWith<ResolvedView>(
+                return cacheAndReturn(
                     {*resolvedNss, std::move(resolvedPipeline), std::move(collation.get())});
             }
 
@@ -493,7 +518,7 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
 
             // If the first stage is a $collStats, then we return early with the viewOn namespace.
             if (toPrepend.size() > 0 && !toPrepend[0]["$collStats"].eoo()) {
-                return StatusWith<ResolvedView>(
+                return cacheAndReturn(
                     {*resolvedNss, std::move(resolvedPipeline), std::move(collation.get())});
             }
         }
@@ -170,8 +170,20 @@ private:
         invariant(_valid.load());
     }
 
+    /**
+     * Discards all cached view resolutions. Must be called whenever '_viewMap' changes.
+     */
+    void _clearResolvedViews_inlock() {
+        _resolvedViews.clear();
+        ++_resolvedViewsGeneration;
+    }
+
     stdx::mutex _mutex;  // Protects all members, except for _valid.
     ViewMap _viewMap;
+    // Caches the result of resolveView() for views whose resolution succeeded. It is only
+    // consulted while the catalog is valid, and is cleared whenever '_viewMap' changes.
+    StringMap<std::shared_ptr<ResolvedView>> _resolvedViews;
+    uint64_t _resolvedViewsGeneration = 0;
     DurableViewCatalog* _durable;
     AtomicBool _valid;
     ViewGraph _viewGraph;
@@ -529,6 +529,45 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectPipeline) {
     }
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewReflectsViewChanges) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+    BSONArrayBuilder pipeline1;
+    BSONArrayBuilder pipeline2;
+    BSONArrayBuilder modifiedPipeline;
+
+    pipeline1 << BSON("$match" << BSON("foo" << 1));
+    pipeline2 << BSON("$match" << BSON("foo" << 2));
+    modifiedPipeline << BSON("$match" << BSON("foo" << 3));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, pipeline1.arr(), emptyCollation));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view2, view1, pipeline2.arr(), emptyCollation));
+
+    // Resolving the same view twice returns the same result.
+    for (int i = 0; i < 2; ++i) {
+        auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+        ASSERT_OK(resolvedView.getStatus());
+        ASSERT_EQ(resolvedView.getValue().getNamespace(), viewOn);
+        ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+    }
+
+    // Modifying a view that another view depends on is visible in the resolution of both.
+    ASSERT_OK(viewCatalog.modifyView(opCtx.get(), view1, viewOn, modifiedPipeline.arr()));
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    std::vector<BSONObj> result = resolvedView.getValue().getPipeline();
+    ASSERT_EQ(2U, result.size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 3)), result[0]);
+
+    // Once 'view1' is dropped, 'view2' resolves to it as if it were a collection.
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view1));
+    resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(resolvedView.getValue().getNamespace(), view1);
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+}
+
 TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
     const NamespaceString view1("db.view1");
     const NamespaceString view2("db.view2");
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include <algorithm>
+#include <set>
 
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
@@ -198,6 +199,29 @@ TEST_F(CursorManagerTest,
     }
 }
 
+/**
+ * Tests that every registered cursor gets its own id, and that each can be pinned by id, but not by
+ * two operations at once.
+ */
+TEST_F(CursorManagerTest, RegisteredCursorsHaveDistinctIdsAndCanEachBePinned) {
+    CursorManager* cursorManager = useCursorManager();
+    std::set<CursorId> cursorIds;
+    for (int i = 0; i < 1000; i++) {
+        auto cursorPin = makeCursor(_opCtx.get());
+        ASSERT_TRUE(cursorIds.insert(cursorPin.getCursor()->cursorid()).second);
+    }
+    ASSERT_EQ(1000UL, cursorManager->numCursors());
+
+    for (auto&& cursorId : cursorIds) {
+        auto cursorPin = unittest::assertGet(cursorManager->pinCursor(_opCtx.get(), cursorId));
+        ASSERT_EQ(cursorId, cursorPin.getCursor()->cursorid());
+        ASSERT_THROWS_CODE(cursorManager->pinCursor(_opCtx.get(), cursorId).getStatus().ignore(),
+                           AssertionException,
+                           ErrorCodes::CursorInUse);
+    }
+    ASSERT_EQ(1000UL, cursorManager->numCursors());
+}
+
 /**
  * Tests that invalidating a cursor without dropping the collection while the cursor is not in use
  * will keep the cursor registered. After being invalidated, pinning the cursor should take
@@ -370,6 +370,38 @@ private:
     static const int kDocsPerWorker = 100;
 };
 
+/**
+ * Test that a writer given a collection maker uses it to create the backing collection, and
+ * writes a burst of documents larger than one batch.
+ */
+class DeferredWriterTestCollectionMaker : public DeferredWriterTestBase {
+public:
+    void run(void) {
+        const size_t nDocs = 3 * DeferredWriter::kMaxBatchSize + 1;
+        dropCollection();
+        AtomicInt32 numCalls(0);
+        {
+            auto maker = [&numCalls](OperationContext* opCtx) {
+                numCalls.fetchAndAdd(1);
+                DBDirectClient client(opCtx);
+                client.createCollection(kTestNamespace.toString());
+                return Status::OK();
+            };
+            RaiiWrapper gw(
+                stdx::make_unique<DeferredWriter>(kTestNamespace, std::move(maker), 200'000));
+            auto writer = gw.get();
+
+            // Hold the writer back so that the documents are buffered together.
+            Lock::GlobalWrite lock(_opCtx.get());
+            for (size_t i = 0; i < nDocs; ++i) {
+                ASSERT(writer->insertDocument(getObj()));
+            }
+        }
+        ASSERT_EQ(1, numCalls.load());
+        ASSERT_EQ(nDocs, readCollection().size());
+    }
+};
+
 class DeferredWriterTests : public Suite {
 public:
     DeferredWriterTests() : Suite("deferred_writer_tests") {}
@@ -381,6 +413,7 @@ public:
         add<DeferredWriterTestNoDeadlock>();
         add<DeferredWriterTestCap>();
         add<DeferredWriterTestAsync>();
+        add<DeferredWriterTestCollectionMaker>();
     }
 } deferredWriterTests;
 }
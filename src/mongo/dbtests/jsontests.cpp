@@ -109,6 +109,33 @@ public:
     }
 };
 
+class LongStringWithEscapes {
+public:
+    void run() {
+        const std::string run(100, 'x');
+        BSONObjBuilder b;
+        b.append("a", run + "\"" + run + "\n" + run + "\x1");
+        ASSERT_EQUALS("{ \"a\" : \"" + run + "\\\"" + run + "\\n" + run + "\\u0001\" }",
+                      b.done().jsonString(Strict));
+    }
+};
+
+// Elements are all formatted into one stream, so formatting one must not affect the next.
+class ElementsAfterBinData {
+public:
+    void run() {
+        BSONObjBuilder b;
+        b.appendBinData("a", 1, BinDataGeneral, "x");
+        b.append("b", 100);
+        b.append("c", 1.5);
+        b.append("d", BSON("e" << 12));
+        ASSERT_EQUALS(
+            "{ \"a\" : { \"$binary\" : \"eA==\", \"$type\" : \"00\" }, \"b\" : 100, "
+            "\"c\" : 1.5, \"d\" : { \"e\" : 12 } }",
+            b.done().jsonString(Strict));
+    }
+};
+
 class SingleIntMember {
 public:
     void run() {
@@ -1008,6 +1035,22 @@ class EscapeFieldName : public Base {
     }
 };
 
+class LongQuotedStrings : public Base {
+    virtual BSONObj bson() const {
+        const std::string run(100, 'x');
+        BSONObjBuilder b;
+        b.append("a", run + "\"" + run + "\n" + run + "A");
+        b.append("b", "it's " + run);
+        b.append("unquoted_$field", run);
+        return b.obj();
+    }
+    virtual string json() const {
+        const std::string run(100, 'x');
+        return "{ \"a\" : \"" + run + "\\\"" + run + "\\n" + run + "\\u0041\", b : 'it\\'s " +
+            run + "', unquoted_$field : \"" + run + "\" }";
+    }
+};
+
 class EscapedUnicodeToUtf8 : public Base {
     virtual BSONObj bson() const {
         BSONObjBuilder b;
@@ -2700,6 +2743,8 @@ public:
         add<JsonStringTests::AdditionalControlCharacters>();
         add<JsonStringTests::ExtendedAscii>();
         add<JsonStringTests::EscapeFieldName>();
+        add<JsonStringTests::LongStringWithEscapes>();
+        add<JsonStringTests::ElementsAfterBinData>();
         add<JsonStringTests::SingleIntMember>();
         add<JsonStringTests::SingleNumberMember>();
         add<JsonStringTests::InvalidNumbers>();
@@ -2772,6 +2817,7 @@ public:
         add<FromJsonTests::InvalidControlCharacter>();
         add<FromJsonTests::NumbersInFieldName>();
         add<FromJsonTests::EscapeFieldName>();
+        add<FromJsonTests::LongQuotedStrings>();
         add<FromJsonTests::EscapedUnicodeToUtf8>();
         add<FromJsonTests::Utf8AllOnes>();
         add<FromJsonTests::Utf8FirstByteOnes>();
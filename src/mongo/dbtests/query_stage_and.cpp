@@ -41,6 +41,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/and_bitmap.h"
 #include "mongo/db/exec/and_hash.h"
 #include "mongo/db/exec/and_sorted.h"
 #include "mongo/db/exec/fetch.h"
@@ -998,6 +999,153 @@ public:
     }
 };
 
+//
+// Bitmap AND tests
+//
+
+// An AND with three children. The survivors are fetched and come out in the last child's order.
+class QueryStageAndBitmapThreeLeaf : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "baz" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+        addIndex(BSON("baz" << 1));
+
+        WorkingSet ws;
+        auto ab = make_unique<AndBitmapStage>(&_opCtx, &ws, coll);
+
+        // Foo <= 20
+        IndexScanParams params;
+        params.descriptor = getIndex(BSON("foo" << 1), coll);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << 20);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = -1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params.descriptor = getIndex(BSON("bar" << 1), coll);
+        params.bounds.startKey = BSON("" << 10);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = 1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // 15 >= baz >= 5, scanned in descending order
+        params.descriptor = getIndex(BSON("baz" << 1), coll);
+        params.bounds.startKey = BSON("" << 15);
+        params.bounds.endKey = BSON("" << 5);
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = -1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // foo == bar == baz, and foo<=20, bar>=10, 5<=baz<=15, so our values are:
+        // foo == 15, 14, 13, 12, 11, 10, in the order of the last child.
+        for (int expected = 15; expected >= 10; --expected) {
+            BSONObj obj = getNext(ab.get(), &ws);
+            ASSERT_EQUALS(expected, obj["foo"].numberInt());
+            ASSERT_EQUALS(expected, obj["bar"].numberInt());
+        }
+        ASSERT_EQUALS(0, countResults(ab.get()));
+    }
+};
+
+/**
+ * Invalidate a RecordId held in the bitmap of a bitmap AND before the AND finishes evaluating.
+ * The AND should process all other data just fine and flag the invalidated RecordId in the
+ * WorkingSet.
+ */
+class QueryStageAndBitmapInvalidation : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ab = make_unique<AndBitmapStage>(&_opCtx, &ws, coll);
+
+        // Foo <= 20
+        IndexScanParams params;
+        params.descriptor = getIndex(BSON("foo" << 1), coll);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << 20);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = -1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Bar >= 10
+        params.descriptor = getIndex(BSON("bar" << 1), coll);
+        params.bounds.startKey = BSON("" << 10);
+        params.bounds.endKey = BSONObj();
+        params.bounds.boundInclusion = BoundInclusion::kIncludeBothStartAndEndKeys;
+        params.direction = 1;
+        ab->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // Read the first child, foo=20, foo=19, ..., foo=0, into the bitmap.
+        auto stats = static_cast<const AndBitmapStats*>(ab->getSpecificStats());
+        while (stats->bitmapAfterChild.empty()) {
+            WorkingSetID out;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, ab->work(&out));
+        }
+        ASSERT_EQUALS(size_t(21), stats->bitmapAfterChild[0]);
+
+        // ...yield
+        ab->saveState();
+        // ...invalidate one of the buffered RecordIds
+        set<RecordId> data;
+        getRecordIds(&data, coll);
+        for (set<RecordId>::const_iterator it = data.begin(); it != data.end(); ++it) {
+            if (coll->docFor(&_opCtx, *it).value()["foo"].numberInt() == 15) {
+                ab->invalidate(&_opCtx, *it, INVALIDATION_DELETION);
+                remove(coll->docFor(&_opCtx, *it).value());
+                break;
+            }
+        }
+        ab->restoreState();
+
+        // Expect to find foo==15 flagged for review.
+        const stdx::unordered_set<WorkingSetID>& flagged = ws.getFlagged();
+        ASSERT_EQUALS(size_t(1), flagged.size());
+        WorkingSetMember* member = ws.get(*flagged.begin());
+        ASSERT_EQUALS(WorkingSetMember::OWNED_OBJ, member->getState());
+        BSONElement elt;
+        ASSERT_TRUE(member->getFieldDotted("foo", &elt));
+        ASSERT_EQUALS(15, elt.numberInt());
+
+        // Since foo == bar, we would have 11 results, but we subtract one because of the
+        // mid-plan invalidation, so 10.
+        ASSERT_EQUALS(10, countResults(ab.get()));
+    }
+};
+
 //
 // Sorted AND tests
 //
@@ -1465,6 +1613,8 @@ public:
         add<QueryStageAndHashFirstChildFetched>();
         add<QueryStageAndHashSecondChildFetched>();
         add<QueryStageAndHashDeadChild>();
+        add<QueryStageAndBitmapThreeLeaf>();
+        add<QueryStageAndBitmapInvalidation>();
         add<QueryStageAndSortedInvalidation>();
         add<QueryStageAndSortedThreeLeaf>();
         add<QueryStageAndSortedWithNothing>();
@@ -400,6 +400,85 @@ public:
     }
 };
 
+//
+// Scan a range of RecordIds.
+//
+
+class QueryStageCollscanRangeBase : public QueryStageCollectionScanBase {
+public:
+    /**
+     * Returns the values of 'foo' for the records in ['start', 'end').
+     */
+    vector<int> scanRange(Collection* collection, const RecordId& start, const RecordId& end) {
+        WorkingSet ws;
+
+        CollectionScanParams params;
+        params.collection = collection;
+        params.start = start;
+        params.end = end;
+
+        vector<int> out;
+        unique_ptr<CollectionScan> scan(new CollectionScan(&_opCtx, params, &ws, NULL));
+        while (!scan->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                out.push_back(ws.get(id)->obj.value()["foo"].numberInt());
+            }
+        }
+        return out;
+    }
+};
+
+class QueryStageCollscanRange : public QueryStageCollscanRangeBase {
+public:
+    void run() {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* coll = ctx.getCollection();
+        if (!coll->getRecordStore()->isInRecordIdOrder()) {
+            return;
+        }
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        vector<int> results = scanRange(coll, recordIds[10], recordIds[20]);
+        ASSERT_EQUALS(10U, results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            ASSERT_EQUALS(static_cast<int>(i) + 10, results[i]);
+        }
+
+        // A null start scans from the first record, and RecordId::max() to the last.
+        ASSERT_EQUALS(20U, scanRange(coll, RecordId(), recordIds[20]).size());
+        ASSERT_EQUALS(static_cast<size_t>(numObj() - 20),
+                      scanRange(coll, recordIds[20], RecordId::max()).size());
+    }
+};
+
+class QueryStageCollscanRangeStartDeleted : public QueryStageCollscanRangeBase {
+public:
+    void run() {
+        vector<RecordId> recordIds;
+        {
+            AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+            if (!ctx.getCollection()->getRecordStore()->isInRecordIdOrder()) {
+                return;
+            }
+            getRecordIds(ctx.getCollection(), CollectionScanParams::FORWARD, &recordIds);
+        }
+
+        // Remove the first record of the range. The scan should still return the rest of it.
+        remove(BSON("foo" << 10));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        vector<int> results = scanRange(ctx.getCollection(), recordIds[10], recordIds[20]);
+        ASSERT_EQUALS(9U, results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            ASSERT_EQUALS(static_cast<int>(i) + 11, results[i]);
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -414,6 +493,8 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
         add<QueryStageCollscanInvalidateUpcomingObjectBackward>();
+        add<QueryStageCollscanRange>();
+        add<QueryStageCollscanRangeStartDeleted>();
     }
 };
 
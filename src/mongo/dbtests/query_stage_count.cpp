@@ -42,7 +42,9 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageCount {
 
@@ -275,6 +277,21 @@ public:
     }
 };
 
+class QueryStageCountBatchedWithSkipAndLimit : public CountStageTest {
+public:
+    void run() {
+        const int oldBatchSize = internalQueryExecWorkBatchSize.load();
+        internalQueryExecWorkBatchSize.store(16);
+        ON_BLOCK_EXIT([&] { internalQueryExecWorkBatchSize.store(oldBatchSize); });
+
+        CountRequest request(NamespaceString(ns()), BSON("x" << GTE << 0));
+        request.setSkip(5);
+        request.setLimit(20);
+
+        testCount(request, 20);
+        testCount(request, 20, true);
+    }
+};
 
 class QueryStageCountInsertDuringYield : public CountStageTest {
 public:
@@ -364,6 +381,7 @@ public:
         add<QueryStageCountNoChangeDuringYield>();
         add<QueryStageCountYieldWithSkip>();
         add<QueryStageCountYieldWithLimit>();
+        add<QueryStageCountBatchedWithSkipAndLimit>();
         add<QueryStageCountInsertDuringYield>();
         add<QueryStageCountDeleteDuringYield>();
         add<QueryStageCountUpdateDuringYield>();
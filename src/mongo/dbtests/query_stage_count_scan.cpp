@@ -175,6 +175,47 @@ public:
     }
 };
 
+//
+// Check that only keys passing the filter are counted, and that the filter is applied to index
+// keys after deduplicating a multikey index
+//
+class QueryStageCountScanFilter : public CountBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+
+        // Insert some docs
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << i << "b" << BSON_ARRAY(i % 3 << 10 + i)));
+        }
+
+        // Add an index
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        // Set up the count stage
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1 << "b" << 1));
+        params.startKey = BSON("" << 2 << "" << MINKEY);
+        params.startKeyInclusive = true;
+        params.endKey = BSON("" << 8 << "" << MAXKEY);
+        params.endKeyInclusive = true;
+
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("a" << BSON("$ne" << 5)), expCtx);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        std::unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws, filterExpr.get());
+
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(6, numCounted);
+    }
+};
+
 //
 // Check that expected results are returned with exclusive bounds
 //
@@ -648,6 +689,7 @@ public:
     void setupTests() {
         add<QueryStageCountScanDups>();
         add<QueryStageCountScanInclusiveBounds>();
+        add<QueryStageCountScanFilter>();
         add<QueryStageCountScanExclusiveBounds>();
         add<QueryStageCountScanLowerBound>();
         add<QueryStageCountScanNothingInInterval>();
@@ -42,9 +42,11 @@
 #include "mongo/db/exec/delete.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageDelete {
 
@@ -303,7 +305,62 @@ public:
         ASSERT_EQUALS(PlanStage::IS_EOF, state);
     }
 };
+/**
+ * Test that a multi delete configured to batch removes up to a batch of matching documents in each
+ * call to work().
+ */
+class QueryStageDeleteBatched : public QueryStageDeleteBase {
+public:
+    void run() {
+        auto param = ServerParameterSet::getGlobal()->getMap().find(
+            "internalQueryMultiDeleteBatchSize");
+        ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+        ASSERT_OK(param->second->setFromString("7"));
+        ON_BLOCK_EXIT([&] { ASSERT_OK(param->second->setFromString("1")); });
+
+        dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+        Collection* coll = ctx.getCollection();
+        const unique_ptr<CanonicalQuery> cq(canonicalize(BSON("foo" << BSON("$lt" << 40))));
+
+        CollectionScanParams collScanParams;
+        collScanParams.collection = coll;
+        collScanParams.direction = CollectionScanParams::FORWARD;
+        collScanParams.tailable = false;
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+        deleteStageParams.canonicalQuery = cq.get();
 
+        WorkingSet ws;
+        DeleteStage deleteStage(
+            &_opCtx,
+            deleteStageParams,
+            &ws,
+            coll,
+            new CollectionScan(&_opCtx, collScanParams, &ws, cq->root()));
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        ASSERT_EQUALS(7U, stats->docsDeleted);
+
+        size_t works = 1;
+        while (!deleteStage.isEOF()) {
+            id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+            ++works;
+        }
+
+        // The collection scan reads all of the documents, at most 7 per call.
+        ASSERT_EQUALS(40U, stats->docsDeleted);
+        ASSERT_LTE(works, (numObj() + 6) / 7 + 1);
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+        ASSERT_EQUALS(numObj() - 40, recordIds.size());
+    }
+};
 
 class All : public Suite {
 public:
@@ -314,6 +371,7 @@ public:
         add<QueryStageDeleteInvalidateUpcomingObject>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
+        add<QueryStageDeleteBatched>();
     }
 };
 
@@ -650,5 +650,94 @@ TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfKilledDuringPlanning) {
               multiPlanStage.pickBestPlan(&alwaysPlanKilledYieldPolicy));
 }
 
+TEST_F(QueryStageMultiPlanTest, MPSPrunesDominatedPlanAndEndsTrialEarly) {
+    // Insert a document to create the collection.
+    insert(BSON("x" << 1));
+
+    const double oldPruneRatio = internalQueryPlanEvaluationPruneRatio.load();
+    internalQueryPlanEvaluationPruneRatio.store(3.0);
+    ON_BLOCK_EXIT([oldPruneRatio] { internalQueryPlanEvaluationPruneRatio.store(oldPruneRatio); });
+
+    const int nDocs = 500;
+
+    auto ws = stdx::make_unique<WorkingSet>();
+    auto firstPlan = stdx::make_unique<QueuedDataStage>(_opCtx.get(), ws.get());
+    auto secondPlan = stdx::make_unique<QueuedDataStage>(_opCtx.get(), ws.get());
+
+    for (int i = 0; i < nDocs; ++i) {
+        addMember(firstPlan.get(), ws.get(), BSON("x" << 1));
+
+        // The second plan only produces a result on every fourth call to work().
+        addMember(secondPlan.get(), ws.get(), BSON("x" << 1));
+        for (int j = 0; j < 3; ++j) {
+            secondPlan->pushBack(PlanStage::NEED_TIME);
+        }
+    }
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("x" << 1));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    MultiPlanStage mps(
+        opCtx(), ctx.getCollection(), cq.get(), MultiPlanStage::CachingMode::NeverCache);
+    mps.addPlan(createQuerySolution(), firstPlan.release(), ws.get());
+    mps.addPlan(createQuerySolution(), secondPlan.release(), ws.get());
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps.pickBestPlan(&yieldPolicy));
+    ASSERT_EQ(mps.bestPlanIdx(), 0);
+
+    // The trial period ended as soon as the second plan was pruned, well before the first plan
+    // produced a full batch.
+    auto winnerStats = mps.getChildren()[0]->getStats();
+    auto loserStats = mps.getChildren()[1]->getStats();
+    const auto minResults =
+        static_cast<size_t>(internalQueryPlanEvaluationPruneMinResults.load());
+    ASSERT_GTE(winnerStats->common.advanced, minResults);
+    ASSERT_LT(winnerStats->common.advanced,
+              static_cast<size_t>(internalQueryPlanEvaluationMaxResults.load()));
+    ASSERT_EQ(winnerStats->common.works, loserStats->common.works);
+    ASSERT_LTE(loserStats->common.advanced * 3, winnerStats->common.advanced);
+}
+
+TEST_F(QueryStageMultiPlanTest, MPSBreaksTieUsingIndexUsageStats) {
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("b" << 1));
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* coll = ctx.getCollection();
+
+    // Record that the index on 'b' has been part of a winning plan before.
+    coll->infoCache()->notifyOfQuery(opCtx(), {"b_1"});
+
+    auto makeSolution = [](const BSONObj& keyPattern, const std::string& name) {
+        auto soln = createQuerySolution();
+        soln->root = stdx::make_unique<IndexScanNode>(
+            IndexEntry(keyPattern, false, false, false, name, nullptr, BSONObj()));
+        return soln;
+    };
+
+    // Both plans produce exactly the same results, so they tie on productivity.
+    auto ws = stdx::make_unique<WorkingSet>();
+    auto firstPlan = stdx::make_unique<QueuedDataStage>(_opCtx.get(), ws.get());
+    auto secondPlan = stdx::make_unique<QueuedDataStage>(_opCtx.get(), ws.get());
+    for (int i = 0; i < 10; ++i) {
+        addMember(firstPlan.get(), ws.get(), BSON("x" << 1));
+        addMember(secondPlan.get(), ws.get(), BSON("x" << 1));
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(BSON("a" << 1 << "b" << 1));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(opCtx(), std::move(qr)));
+    MultiPlanStage mps(opCtx(), coll, cq.get(), MultiPlanStage::CachingMode::NeverCache);
+    mps.addPlan(makeSolution(BSON("a" << 1), "a_1"), firstPlan.release(), ws.get());
+    mps.addPlan(makeSolution(BSON("b" << 1), "b_1"), secondPlan.release(), ws.get());
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps.pickBestPlan(&yieldPolicy));
+    ASSERT_EQ(mps.bestPlanIdx(), 1);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -41,8 +41,10 @@
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 /**
  * This file tests db/exec/sort.cpp
@@ -157,6 +159,7 @@ public:
         params.collection = coll;
         params.pattern = BSON("foo" << direction);
         params.limit = limit();
+        params.allowDiskUse = allowDiskUse();
 
         auto keyGenStage = make_unique<SortKeyGeneratorStage>(
             &_opCtx, queuedDataStage.release(), ws.get(), params.pattern, nullptr);
@@ -216,6 +219,11 @@ public:
         return 0;
     };
 
+    // Returns whether the sort may spill to disk.
+    virtual bool allowDiskUse() const {
+        return false;
+    }
+
 
     static const char* ns() {
         return "unittests.QueryStageSort";
@@ -303,6 +311,41 @@ public:
     }
 };
 
+// Sort more data than fits in the memory limit, spilling to disk.
+template <int LIMIT>
+class QueryStageSortSpillToDisk : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 10000;
+    }
+
+    virtual int limit() const {
+        return LIMIT;
+    }
+
+    virtual bool allowDiskUse() const {
+        return true;
+    }
+
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        const int oldMaxBytes = internalQueryExecMaxBlockingSortBytes.load();
+        ON_BLOCK_EXIT([oldMaxBytes] { internalQueryExecMaxBlockingSortBytes.store(oldMaxBytes); });
+        internalQueryExecMaxBlockingSortBytes.store(16 * 1024);
+
+        fillData();
+        sortAndCheck(1, coll);
+    }
+};
+
 // Mutation invalidation of docs fed to sort.
 class QueryStageSortMutationInvalidation : public QueryStageSortTestBase {
 public:
@@ -590,6 +633,8 @@ public:
         // and a special case for limit == 1
         add<QueryStageSortDecWithLimit<1>>();
         add<QueryStageSortExt>();
+        add<QueryStageSortSpillToDisk<0>>();
+        add<QueryStageSortSpillToDisk<5000>>();
         add<QueryStageSortMutationInvalidation>();
         add<QueryStageSortDeletionInvalidation>();
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
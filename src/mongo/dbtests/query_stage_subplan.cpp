@@ -44,9 +44,11 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/mock_yield_policies.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -203,6 +205,64 @@ TEST_F(QueryStageSubplanTest, QueryStageSubplanPlanFromCache) {
     ASSERT_FALSE(subplan->branchPlannedFromCache(1));
 }
 
+/**
+ * Test that branches with the same shape reuse the index assignment chosen for the first of them
+ * rather than ranking their candidate plans again.
+ */
+TEST_F(QueryStageSubplanTest, QueryStageSubplanSharesPlansBetweenBranchesWithSameShape) {
+    dbtests::WriteContextForTests ctx(opCtx(), nss.ns());
+
+    addIndex(BSON("a" << 1));
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("c" << 1));
+
+    for (int i = 0; i < 10; i++) {
+        insert(BSON("a" << (i % 2) << "b" << i << "c" << i));
+    }
+
+    // The first two branches differ only in their constants, so they share a plan cache key.
+    BSONObj query = fromjson("{$or: [{a: 1, b: 3}, {a: 0, b: 4}, {c: 1}]}");
+
+    Collection* collection = ctx.getCollection();
+
+    auto qr = stdx::make_unique<QueryRequest>(nss);
+    qr->setFilter(query);
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx(), std::move(qr));
+    ASSERT_OK(statusWithCQ.getStatus());
+    std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx(), collection, cq.get(), &plannerParams);
+
+    internalQuerySubplannerShareBranchPlans.store(true);
+    ON_BLOCK_EXIT([] { internalQuerySubplannerShareBranchPlans.store(false); });
+
+    WorkingSet ws;
+    std::unique_ptr<SubplanStage> subplan(
+        new SubplanStage(opCtx(), collection, &ws, plannerParams, cq.get()));
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+
+    ASSERT_FALSE(subplan->branchPlannedFromSibling(0));
+    ASSERT_TRUE(subplan->branchPlannedFromSibling(1));
+    ASSERT_FALSE(subplan->branchPlannedFromSibling(2));
+
+    // The composite plan must still return the documents matching every branch.
+    size_t numResults = 0;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (state != PlanStage::IS_EOF) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        state = subplan->work(&id);
+        ASSERT_NE(state, PlanStage::DEAD);
+        ASSERT_NE(state, PlanStage::FAILURE);
+        if (state == PlanStage::ADVANCED) {
+            ++numResults;
+        }
+    }
+    ASSERT_EQ(numResults, 3U);
+}
+
 /**
  * Ensure that the subplan stage doesn't create a plan cache entry if there are no query results.
  */
@@ -49,10 +49,12 @@
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/update/update_driver.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 #define ASSERT_DOES_NOT_THROW(EXPRESSION)                                          \
     try {                                                                          \
@@ -617,6 +619,88 @@ public:
     }
 };
 
+/**
+ * Test that a multi update configured to batch by size updates every matching document once,
+ * several in each call to work().
+ */
+class QueryStageUpdateBatched : public QueryStageUpdateBase {
+public:
+    void run() {
+        auto param = ServerParameterSet::getGlobal()->getMap().find(
+            "internalQueryMultiUpdateBatchMaxBytes");
+        ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+        ASSERT_OK(param->second->setFromString("50"));
+        ON_BLOCK_EXIT([&] { ASSERT_OK(param->second->setFromString("0")); });
+
+        {
+            dbtests::WriteContextForTests ctx(&_opCtx, nss.ns());
+
+            for (int i = 0; i < 10; ++i) {
+                insert(BSON("_id" << i << "foo" << i));
+            }
+
+            OpDebug* opDebug = &CurOp::get(_opCtx)->debug();
+            const CollatorInterface* collator = nullptr;
+            UpdateDriver driver(new ExpressionContext(&_opCtx, collator));
+            Collection* coll = ctx.getCollection();
+
+            UpdateRequest request(nss);
+            UpdateLifecycleImpl updateLifecycle(nss);
+            request.setLifecycle(&updateLifecycle);
+
+            BSONObj query = fromjson("{foo: {$lt: 5}}");
+            request.setMulti();
+            request.setQuery(query);
+            request.setUpdates(fromjson("{$set: {bar: 3}}"));
+
+            const std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+            ASSERT_DOES_NOT_THROW(
+                driver.parse(request.getUpdates(), arrayFilters, request.isMulti()));
+
+            CollectionScanParams collScanParams;
+            collScanParams.collection = coll;
+            collScanParams.direction = CollectionScanParams::FORWARD;
+            collScanParams.tailable = false;
+
+            UpdateStageParams updateParams(&request, &driver, opDebug);
+            unique_ptr<CanonicalQuery> cq(canonicalize(query));
+            updateParams.canonicalQuery = cq.get();
+
+            auto ws = make_unique<WorkingSet>();
+            auto cs = make_unique<CollectionScan>(&_opCtx, collScanParams, ws.get(), cq->root());
+            auto updateStage =
+                make_unique<UpdateStage>(&_opCtx, updateParams, ws.get(), coll, cs.release());
+            const UpdateStats* stats =
+                static_cast<const UpdateStats*>(updateStage->getSpecificStats());
+
+            // Each document is 23 bytes, so the first batch closes after three of them.
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, updateStage->work(&id));
+            ASSERT_EQUALS(3U, stats->nModified);
+
+            while (!updateStage->isEOF()) {
+                id = WorkingSet::INVALID_ID;
+                PlanStage::StageState state = updateStage->work(&id);
+                ASSERT(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+            }
+
+            ASSERT_EQUALS(5U, stats->nModified);
+            ASSERT_EQUALS(5U, stats->nMatched);
+        }
+
+        {
+            AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+            vector<BSONObj> objs;
+            getCollContents(ctx.getCollection(), &objs);
+
+            ASSERT_EQUALS(10U, objs.size());
+            assertHasDoc(objs, fromjson("{_id: 0, foo: 0, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 4, foo: 4, bar: 3}"));
+            assertHasDoc(objs, fromjson("{_id: 5, foo: 5}"));
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_update") {}
@@ -628,6 +712,7 @@ public:
         add<QueryStageUpdateReturnOldDoc>();
         add<QueryStageUpdateReturnNewDoc>();
         add<QueryStageUpdateSkipOwnedObjects>();
+        add<QueryStageUpdateBatched>();
     }
 };
 
@@ -255,6 +255,16 @@ void ReplicationCoordinatorEmbedded::fillIsMasterForReplSet(IsMasterResponse*) {
     UASSERT_NOT_IMPLEMENTED;
 }
 
+TopologyVersion ReplicationCoordinatorEmbedded::getTopologyVersion() const {
+    UASSERT_NOT_IMPLEMENTED;
+}
+
+TopologyVersion ReplicationCoordinatorEmbedded::awaitTopologyChange(OperationContext*,
+                                                                    const TopologyVersion&,
+                                                                    Date_t) {
+    UASSERT_NOT_IMPLEMENTED;
+}
+
 void ReplicationCoordinatorEmbedded::appendSlaveInfoData(BSONObjBuilder*) {
     UASSERT_NOT_IMPLEMENTED;
 }
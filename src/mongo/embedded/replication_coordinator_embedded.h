@@ -142,6 +142,12 @@ public:
 
     void fillIsMasterForReplSet(repl::IsMasterResponse*) override;
 
+    repl::TopologyVersion getTopologyVersion() const override;
+
+    repl::TopologyVersion awaitTopologyChange(OperationContext*,
+                                              const repl::TopologyVersion&,
+                                              Date_t) override;
+
     void appendSlaveInfoData(BSONObjBuilder*) override;
 
     repl::ReplSetConfig getConfig() const override;
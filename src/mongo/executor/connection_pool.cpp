@@ -144,6 +144,11 @@ public:
      */
     size_t createdConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the number of requests waiting for a connection from this pool.
+     */
+    size_t requestsWaiting(const stdx::unique_lock<stdx::mutex>& lk);
+
     /**
      * Returns the total number of connections currently open that belong to
      * this pool. This is the sum of refreshingConnections, availableConnections,
@@ -208,6 +213,17 @@ private:
     void updateStateInLock();
 
 private:
+    /**
+     * The number of connections the pool keeps open while idle: minConnections, raised to the
+     * recent peak of connections in use if recentDemandWindow is set.
+     */
+    size_t minimumConnections();
+
+    /**
+     * Records the number of connections currently checked out towards the recent demand peak.
+     */
+    void noteConnectionsInUse();
+
     ConnectionPool* const _parent;
 
     const HostAndPort _hostAndPort;
@@ -228,6 +244,12 @@ private:
 
     size_t _created;
 
+    // The peak number of connections checked out during the current recentDemandWindow, which
+    // ends at _recentDemandWindowEnd, and during the window before it
+    size_t _currentDemandPeak = 0;
+    size_t _previousDemandPeak = 0;
+    Date_t _recentDemandWindowEnd;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -272,6 +294,7 @@ ConnectionPool::ConnectionPool(std::unique_ptr<DependentTypeFactoryInterface> im
     : _name(std::move(name)),
       _options(std::move(options)),
       _factory(std::move(impl)),
+      _refreshJitterRandom(SecureRandom::create()->nextInt64()),
       _manager(options.egressTagCloserManager) {
     if (_manager) {
         _manager->add(this);
@@ -423,7 +446,8 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
         ConnectionStatsPer hostStats{pool->inUseConnections(lk),
                                      pool->availableConnections(lk),
                                      pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
+                                     pool->refreshingConnections(lk),
+                                     pool->requestsWaiting(lk)};
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -486,6 +510,10 @@ size_t ConnectionPool::SpecificPool::createdConnections(const stdx::unique_lock<
     return _created;
 }
 
+size_t ConnectionPool::SpecificPool::requestsWaiting(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _requests.size();
+}
+
 size_t ConnectionPool::SpecificPool::openConnections(const stdx::unique_lock<stdx::mutex>& lk) {
     return _checkedOutPool.size() + _readyPool.size() + _processingPool.size();
 }
@@ -512,7 +540,10 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
 
 void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr,
                                                     stdx::unique_lock<stdx::mutex> lk) {
-    auto needsRefreshTP = connPtr->getLastUsed() + _parent->_options.refreshRequirement;
+    // Connections whose refresh timer was brought forward by the jitter must still be refreshed
+    // when it fires, so anything idle for longer than the earliest such timer counts.
+    auto needsRefreshTP = connPtr->getLastUsed() + _parent->_options.refreshRequirement -
+        _parent->_options.refreshRequirementJitter;
 
     auto conn = takeFromPool(_checkedOutPool, connPtr);
 
@@ -539,7 +570,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
         // If we need to refresh this connection
 
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
-            _parent->_options.minConnections) {
+            minimumConnections()) {
             // If we already have minConnections, just let the connection lapse
             log() << "Ending idle connection to host " << _hostAndPort
                   << " because the pool meets constraints; " << openConnections(lk)
@@ -611,7 +642,11 @@ void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk
     // Our strategy for refreshing connections is to check them out and
     // immediately check them back in (which kicks off the refresh logic in
     // returnConnection
-    connPtr->setTimeout(_parent->_options.refreshRequirement, [this, connPtr]() {
+    auto refreshTimeout = _parent->_options.refreshRequirement;
+    if (auto jitter = _parent->_options.refreshRequirementJitter.count()) {
+        refreshTimeout -= Milliseconds(_parent->_refreshJitterRandom.nextInt64(jitter + 1));
+    }
+    connPtr->setTimeout(refreshTimeout, [this, connPtr]() {
         OwnedConnection conn;
 
         runWithActiveClient([&](stdx::unique_lock<stdx::mutex> lk) {
@@ -724,6 +759,7 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         // check out the connection
         _checkedOutPool[connPtr] = std::move(conn);
 
+        noteConnectionsInUse();
         updateStateInLock();
 
         // pass it to the user
@@ -748,7 +784,7 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     // We want minConnections <= outstanding requests <= maxConnections
     auto target = [&] {
         return std::max(
-            _parent->_options.minConnections,
+            minimumConnections(),
             std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
     };
 
@@ -861,6 +897,41 @@ ConnectionPool::SpecificPool::OwnedConnection ConnectionPool::SpecificPool::take
 
 
 // Updates our state and manages the request timer
+size_t ConnectionPool::SpecificPool::minimumConnections() {
+    const auto window = _parent->_options.recentDemandWindow;
+    if (window == Milliseconds(0)) {
+        return _parent->_options.minConnections;
+    }
+
+    // Demand from a window that ended more than a window ago is stale
+    auto now = _parent->_factory->now();
+    size_t recentPeak = 0;
+    if (now < _recentDemandWindowEnd) {
+        recentPeak = std::max(_currentDemandPeak, _previousDemandPeak);
+    } else if (now < _recentDemandWindowEnd + window) {
+        recentPeak = _currentDemandPeak;
+    }
+
+    return std::max(_parent->_options.minConnections,
+                    std::min(recentPeak, _parent->_options.maxConnections));
+}
+
+void ConnectionPool::SpecificPool::noteConnectionsInUse() {
+    const auto window = _parent->_options.recentDemandWindow;
+    if (window == Milliseconds(0)) {
+        return;
+    }
+
+    auto now = _parent->_factory->now();
+    if (now >= _recentDemandWindowEnd) {
+        _previousDemandPeak = (now < _recentDemandWindowEnd + window) ? _currentDemandPeak : 0;
+        _currentDemandPeak = 0;
+        _recentDemandWindowEnd = now + window;
+    }
+
+    _currentDemandPeak = std::max(_currentDemandPeak, _checkedOutPool.size());
+}
+
 void ConnectionPool::SpecificPool::updateStateInLock() {
     if (_requests.size()) {
         // We have some outstanding requests, we're live
@@ -33,6 +33,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/executor/egress_tag_closer.h"
 #include "mongo/executor/egress_tag_closer_manager.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/chrono.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -116,6 +117,22 @@ public:
          */
         Milliseconds refreshRequirement = kDefaultRefreshRequirement;
 
+        /**
+         * Upper bound on a random amount by which each idle connection's refresh is brought
+         * forward, so that connections established together don't all refresh at once. Must be
+         * less than refreshRequirement; zero refreshes every idle connection after exactly
+         * refreshRequirement.
+         */
+        Milliseconds refreshRequirementJitter = Milliseconds(0);
+
+        /**
+         * If non-zero, the largest number of connections to a host that were in use at once
+         * during the last window of this length is kept open alongside minConnections, so that
+         * a pool that just served a burst doesn't let those connections lapse and reconnect for
+         * the next one. Zero keeps only minConnections.
+         */
+        Milliseconds recentDemandWindow = Milliseconds(0);
+
         /**
          * Amount of time to keep a specific pool around without any checked
          * out connections or new requests
@@ -169,6 +186,9 @@ private:
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
 
+    // Picks the refresh jitter for each connection added to a ready pool, under _mutex
+    PseudoRandom _refreshJitterRandom;
+
     EgressTagCloserManager* _manager;
 };
 
@@ -39,8 +39,13 @@ namespace executor {
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
-                                       size_t nRefreshing)
-    : inUse(nInUse), available(nAvailable), created(nCreated), refreshing(nRefreshing) {}
+                                       size_t nRefreshing,
+                                       size_t nRequestsWaiting)
+    : inUse(nInUse),
+      available(nAvailable),
+      created(nCreated),
+      refreshing(nRefreshing),
+      requestsWaiting(nRequestsWaiting) {}
 
 ConnectionStatsPer::ConnectionStatsPer() = default;
 
@@ -49,6 +54,7 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    requestsWaiting += other.requestsWaiting;
 
     return *this;
 }
@@ -66,6 +72,7 @@ void ConnectionPoolStats::updateStatsForHost(std::string pool,
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
     totalRefreshing += newStats.refreshing;
+    totalRequestsWaiting += newStats.requestsWaiting;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
@@ -73,6 +80,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    result.appendNumber("totalRequestsWaiting", totalRequestsWaiting);
 
     {
         BSONObjBuilder poolBuilder(result.subobjStart("pools"));
@@ -83,6 +91,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolInfo.appendNumber("poolRequestsWaiting", poolStats.requestsWaiting);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -90,6 +99,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostInfo.appendNumber("requestsWaiting", hostStats.requestsWaiting);
             }
         }
     }
@@ -102,6 +112,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostInfo.appendNumber("requestsWaiting", hostStats.requestsWaiting);
         }
     }
 }
@@ -39,7 +39,11 @@ namespace executor {
  * a parent ConnectionPoolStats object and should not need to be created directly.
  */
 struct ConnectionStatsPer {
-    ConnectionStatsPer(size_t nInUse, size_t nAvailable, size_t nCreated, size_t nRefreshing);
+    ConnectionStatsPer(size_t nInUse,
+                       size_t nAvailable,
+                       size_t nCreated,
+                       size_t nRefreshing,
+                       size_t nRequestsWaiting = 0u);
 
     ConnectionStatsPer();
 
@@ -49,6 +53,10 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // Requests that are queued for a connection because none is available and the pool is not
+    // allowed to open another one, e.g. because of maxConnections.
+    size_t requestsWaiting = 0u;
 };
 
 /**
@@ -65,6 +73,7 @@ struct ConnectionPoolStats {
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
+    size_t totalRequestsWaiting = 0u;
 
     stdx::unordered_map<std::string, ConnectionStatsPer> statsByPool;
     stdx::unordered_map<HostAndPort, ConnectionStatsPer> statsByHost;
@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -611,6 +612,49 @@ TEST_F(ConnectionPoolTest, maxPoolRespected) {
     doneWith(conn3);
 }
 
+/**
+ * Verify that requests queued behind maxConnections are reported in the pool stats
+ */
+TEST_F(ConnectionPoolTest, requestsWaitingReported) {
+    ConnectionPool::Options options;
+    options.maxConnections = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto requestsWaiting = [&] {
+        ConnectionPoolStats stats;
+        pool.appendConnectionStats(&stats);
+        return stats.totalRequestsWaiting;
+    };
+
+    ConnectionPool::ConnectionHandle conn1;
+    ConnectionPool::ConnectionHandle conn2;
+
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn1 = std::move(swConn.getValue());
+             });
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 conn2 = std::move(swConn.getValue());
+             });
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+    ASSERT(!conn2);
+    ASSERT_EQ(requestsWaiting(), 1u);
+
+    doneWith(conn1);
+    conn1.reset();
+    ASSERT(conn2);
+    ASSERT_EQ(requestsWaiting(), 0u);
+
+    doneWith(conn2);
+}
+
 /**
  * Verify that we respect maxConnecting
  */
@@ -915,6 +959,95 @@ TEST_F(ConnectionPoolTest, minPoolRespected) {
     ASSERT(!reachedC);
 }
 
+/**
+ * Verify that the connections in use during the recent demand window are kept open alongside
+ * minConnections.
+ */
+TEST_F(ConnectionPoolTest, recentDemandRespected) {
+    ConnectionPool::Options options;
+    options.minConnections = 1;
+    options.maxConnections = 3;
+    options.refreshRequirement = Milliseconds(1000);
+    options.refreshTimeout = Milliseconds(2000);
+    options.recentDemandWindow = Milliseconds(10000);
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+
+    PoolImpl::setNow(now);
+
+    std::vector<ConnectionPool::ConnectionHandle> conns(3);
+
+    // Check out three connections at once
+    for (auto& conn : conns) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(HostAndPort(),
+                 Milliseconds(1000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+
+                     conn = std::move(swConn.getValue());
+                 });
+        ASSERT(conn);
+    }
+
+    size_t refreshed = 0;
+    for (size_t i = 0; i < conns.size(); ++i) {
+        ConnectionImpl::pushRefresh([&]() {
+            ++refreshed;
+            return Status::OK();
+        });
+    }
+
+    PoolImpl::setNow(now + Milliseconds(1));
+    for (auto& conn : conns) {
+        doneWith(conn);
+        conn.reset();
+    }
+
+    // Jump 5 seconds and verify that all three connections were refreshed rather than letting
+    // all but minConnections lapse
+    PoolImpl::setNow(now + Milliseconds(5000));
+
+    ASSERT_EQ(3u, refreshed);
+    ASSERT_EQ(3u, pool.getNumConnectionsPerHost(HostAndPort()));
+}
+
+/**
+ * Verify that the refresh jitter brings refreshes forward by at most the jitter.
+ */
+TEST_F(ConnectionPoolTest, refreshJitterRespected) {
+    bool refreshed = false;
+    ConnectionImpl::pushRefresh([&]() {
+        refreshed = true;
+        return Status::OK();
+    });
+
+    ConnectionPool::Options options;
+    options.refreshRequirement = Milliseconds(1000);
+    options.refreshRequirementJitter = Milliseconds(500);
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+
+    PoolImpl::setNow(now);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 doneWith(swConn.getValue());
+             });
+
+    // Before refreshRequirement - jitter, no refresh has occurred
+    PoolImpl::setNow(now + Milliseconds(499));
+    ASSERT(!refreshed);
+
+    // By refreshRequirement, the refresh has occurred
+    PoolImpl::setNow(now + Milliseconds(1000));
+    ASSERT(refreshed);
+}
 
 /**
  * Verify that the hostTimeout is respected. This implies that an idle
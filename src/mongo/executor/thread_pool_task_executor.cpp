@@ -94,6 +94,7 @@ public:
     AtomicUInt32 canceled{0U};
     WorkQueue::iterator iter;
     Date_t readyDate;
+    bool isInSleepersQueue = false;
     bool isNetworkOperation = false;
     AtomicWord<bool> isFinished{false};
     boost::optional<stdx::condition_variable> finishedCondition;
@@ -134,13 +135,13 @@ ThreadPoolTaskExecutor::ThreadPoolTaskExecutor(std::unique_ptr<ThreadPoolInterfa
 
 ThreadPoolTaskExecutor::~ThreadPoolTaskExecutor() {
     shutdown();
-    auto lk = _join(stdx::unique_lock<stdx::mutex>(_mutex));
+    auto lk = _join(_lock());
     invariant(_state == shutdownComplete);
 }
 
 void ThreadPoolTaskExecutor::startup() {
     _net->startup();
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     if (_inShutdown_inlock()) {
         return;
     }
@@ -150,7 +151,7 @@ void ThreadPoolTaskExecutor::startup() {
 }
 
 void ThreadPoolTaskExecutor::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     if (_inShutdown_inlock()) {
         invariant(_networkInProgressQueue.empty());
         invariant(_sleepersQueue.empty());
@@ -174,7 +175,7 @@ void ThreadPoolTaskExecutor::shutdown() {
 }
 
 void ThreadPoolTaskExecutor::join() {
-    _join(stdx::unique_lock<stdx::mutex>(_mutex));
+    _join(_lock());
 }
 
 stdx::unique_lock<stdx::mutex> ThreadPoolTaskExecutor::_join(stdx::unique_lock<stdx::mutex> lk) {
@@ -207,7 +208,7 @@ stdx::unique_lock<stdx::mutex> ThreadPoolTaskExecutor::_join(stdx::unique_lock<s
         EventHandle event;
         setEventForHandle(&event, std::move(eventState));
         signalEvent_inlock(event, std::move(lk));
-        lk = stdx::unique_lock<stdx::mutex>(_mutex);
+        lk = _lock();
     }
     lk.unlock();
     _net->shutdown();
@@ -231,7 +232,7 @@ stdx::unique_lock<stdx::mutex> ThreadPoolTaskExecutor::_join(stdx::unique_lock<s
 }
 
 void ThreadPoolTaskExecutor::appendDiagnosticBSON(BSONObjBuilder* b) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
 
     // ThreadPool details
     // TODO: fill in
@@ -245,6 +246,12 @@ void ThreadPoolTaskExecutor::appendDiagnosticBSON(BSONObjBuilder* b) const {
     queues.appendIntOrLL("sleepers", _sleepersQueue.size());
     queues.done();
 
+    // Acquisitions of _mutex, and how many of them had to wait for another thread to release it
+    BSONObjBuilder mutexCounters(b->subobjStart("mutex"));
+    mutexCounters.appendNumber("acquisitions", static_cast<long long>(_mutexAcquisitions));
+    mutexCounters.appendNumber("contended", static_cast<long long>(_mutexContentions));
+    mutexCounters.done();
+
     b->appendIntOrLL("unsignaledEvents", _unsignaledEvents.size());
     b->append("shuttingDown", _inShutdown_inlock());
     b->append("networkInterface", _net->getDiagnosticString());
@@ -258,7 +265,7 @@ StatusWith<TaskExecutor::EventHandle> ThreadPoolTaskExecutor::makeEvent() {
     auto el = makeSingletonEventList();
     EventHandle event;
     setEventForHandle(&event, el.front());
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     if (_inShutdown_inlock()) {
         return {ErrorCodes::ShutdownInProgress, "Shutdown in progress"};
     }
@@ -267,7 +274,7 @@ StatusWith<TaskExecutor::EventHandle> ThreadPoolTaskExecutor::makeEvent() {
 }
 
 void ThreadPoolTaskExecutor::signalEvent(const EventHandle& event) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     signalEvent_inlock(event, std::move(lk));
 }
 
@@ -277,7 +284,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::onEvent(const E
         return {ErrorCodes::BadValue, "Passed invalid event handle to onEvent"};
     }
     auto wq = makeSingletonWorkQueue(work, nullptr);
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     auto eventState = checked_cast<EventState*>(getEventFromHandle(event));
     auto cbHandle = enqueueCallbackState_inlock(&eventState->waiters, &wq);
     if (!cbHandle.isOK()) {
@@ -295,7 +302,7 @@ StatusWith<stdx::cv_status> ThreadPoolTaskExecutor::waitForEvent(OperationContex
     invariant(opCtx);
     invariant(event.isValid());
     auto eventState = checked_cast<EventState*>(getEventFromHandle(event));
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
 
     // std::condition_variable::wait() can wake up spuriously, so we have to loop until the event
     // is signalled or we time out.
@@ -314,7 +321,7 @@ StatusWith<stdx::cv_status> ThreadPoolTaskExecutor::waitForEvent(OperationContex
 void ThreadPoolTaskExecutor::waitForEvent(const EventHandle& event) {
     invariant(event.isValid());
     auto eventState = checked_cast<EventState*>(getEventFromHandle(event));
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
 
     while (!eventState->isSignaledFlag) {
         eventState->isSignaledCondition.wait(lk);
@@ -325,7 +332,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleWork(
     const CallbackFn& work) {
     auto wq = makeSingletonWorkQueue(work, nullptr);
     WorkQueue temp;
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     auto cbHandle = enqueueCallbackState_inlock(&temp, &wq);
     if (!cbHandle.isOK()) {
         return cbHandle;
@@ -340,7 +347,8 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleWorkAt(
         return scheduleWork(work);
     }
     auto wq = makeSingletonWorkQueue(work, nullptr, when);
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    wq.front()->isInSleepersQueue = true;
+    auto lk = _lock();
     auto cbHandle = enqueueCallbackState_inlock(&_sleepersQueue, &wq);
     if (!cbHandle.isOK()) {
         return cbHandle;
@@ -353,7 +361,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleWorkAt(
                        if (cbState->canceled.load()) {
                            return;
                        }
-                       stdx::unique_lock<stdx::mutex> lk(_mutex);
+                       auto lk = _lock();
                        if (cbState->canceled.load()) {
                            return;
                        }
@@ -412,7 +420,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
         },
         baton);
     wq.front()->isNetworkOperation = true;
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     auto cbHandle = enqueueCallbackState_inlock(&_networkInProgressQueue, &wq);
     if (!cbHandle.isOK())
         return cbHandle;
@@ -427,13 +435,13 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
                 CallbackFn newCb = [cb, scheduledRequest, response](const CallbackArgs& cbData) {
                     remoteCommandFinished(cbData, cb, scheduledRequest, response);
                 };
-                stdx::unique_lock<stdx::mutex> lk(_mutex);
-                if (_inShutdown_inlock()) {
-                    return;
-                }
                 LOG(3) << "Received remote response: "
                        << redact(response.isOK() ? response.toString()
                                                  : response.status.toString());
+                auto lk = _lock();
+                if (_inShutdown_inlock()) {
+                    return;
+                }
                 swap(cbState->callback, newCb);
                 scheduleIntoPool_inlock(&_networkInProgressQueue, cbState->iter, std::move(lk));
             },
@@ -445,7 +453,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleRemoteC
 void ThreadPoolTaskExecutor::cancel(const CallbackHandle& cbHandle) {
     invariant(cbHandle.isValid());
     auto cbState = checked_cast<CallbackState*>(getCallbackFromHandle(cbHandle));
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     if (_inShutdown_inlock()) {
         return;
     }
@@ -455,18 +463,10 @@ void ThreadPoolTaskExecutor::cancel(const CallbackHandle& cbHandle) {
         _net->cancelCommand(cbHandle, cbState->baton);
         return;
     }
-    if (cbState->readyDate != Date_t{}) {
-        // This callback might still be in the sleeper queue; if it is, schedule it now
-        // rather than when the alarm fires.
-        auto iter = std::find_if(_sleepersQueue.begin(),
-                                 _sleepersQueue.end(),
-                                 [cbState](const std::shared_ptr<CallbackState>& other) {
-                                     return cbState == other.get();
-                                 });
-        if (iter != _sleepersQueue.end()) {
-            invariant(iter == cbState->iter);
-            scheduleIntoPool_inlock(&_sleepersQueue, cbState->iter, std::move(lk));
-        }
+    if (cbState->isInSleepersQueue) {
+        // This callback is still in the sleeper queue, so schedule it now rather than when the
+        // alarm fires.
+        scheduleIntoPool_inlock(&_sleepersQueue, cbState->iter, std::move(lk));
     }
 }
 
@@ -476,7 +476,7 @@ void ThreadPoolTaskExecutor::wait(const CallbackHandle& cbHandle) {
     if (cbState->isFinished.load()) {
         return;
     }
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     if (!cbState->finishedCondition) {
         cbState->finishedCondition.emplace();
     }
@@ -545,6 +545,9 @@ void ThreadPoolTaskExecutor::scheduleIntoPool_inlock(WorkQueue* fromQueue,
                                                      stdx::unique_lock<stdx::mutex> lk) {
     dassert(fromQueue != &_poolInProgressQueue);
     std::vector<std::shared_ptr<CallbackState>> todo(begin, end);
+    for (const auto& cbState : todo) {
+        cbState->isInSleepersQueue = false;
+    }
     _poolInProgressQueue.splice(_poolInProgressQueue.end(), *fromQueue, begin, end);
 
     lk.unlock();
@@ -589,13 +592,23 @@ void ThreadPoolTaskExecutor::runCallback(std::shared_ptr<CallbackState> cbStateA
         callback(std::move(args));
     }
     cbStateArg->isFinished.store(true);
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto lk = _lock();
     _poolInProgressQueue.erase(cbStateArg->iter);
     if (cbStateArg->finishedCondition) {
         cbStateArg->finishedCondition->notify_all();
     }
 }
 
+stdx::unique_lock<stdx::mutex> ThreadPoolTaskExecutor::_lock() const {
+    stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        lk.lock();
+        ++_mutexContentions;
+    }
+    ++_mutexAcquisitions;
+    return lk;
+}
+
 bool ThreadPoolTaskExecutor::_inShutdown_inlock() const {
     return _state >= joinRequired;
 }
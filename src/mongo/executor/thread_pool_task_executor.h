@@ -174,6 +174,11 @@ private:
      */
     void runCallback(std::shared_ptr<CallbackState> cbState);
 
+    /**
+     * Locks _mutex, counting the acquisition and whether it had to wait.
+     */
+    stdx::unique_lock<stdx::mutex> _lock() const;
+
     bool _inShutdown_inlock() const;
     void _setState_inlock(State newState);
     stdx::unique_lock<stdx::mutex> _join(stdx::unique_lock<stdx::mutex> lk);
@@ -184,9 +189,13 @@ private:
     // The thread pool that executes scheduled work items.
     std::unique_ptr<ThreadPoolInterface> _pool;
 
-    // Mutex guarding all remaining fields.
+    // Mutex guarding all remaining fields. Always lock it through _lock().
     mutable stdx::mutex _mutex;
 
+    // Number of times _mutex was acquired, and how many of those found it already held.
+    mutable uint64_t _mutexAcquisitions = 0;
+    mutable uint64_t _mutexContentions = 0;
+
     // Queue containing all items currently scheduled into the thread pool but not yet completed.
     WorkQueue _poolInProgressQueue;
 
@@ -74,6 +74,24 @@ TEST_F(ThreadPoolExecutorTest, TimelyCancelationOfScheduleWorkAt) {
     ASSERT_EQUALS(startTime + Milliseconds(200), net->now());
 }
 
+TEST_F(ThreadPoolExecutorTest, DiagnosticBSONReportsMutexAcquisitions) {
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    auto status1 = getDetectableErrorStatus();
+    const auto cb1 = unittest::assertGet(executor.scheduleWork(
+        [&](const TaskExecutor::CallbackArgs& cbData) { status1 = cbData.status; }));
+    executor.wait(cb1);
+    ASSERT_OK(status1);
+
+    BSONObjBuilder builder;
+    executor.appendDiagnosticBSON(&builder);
+    const auto mutexCounters = builder.obj()["mutex"].Obj();
+    ASSERT_GT(mutexCounters["acquisitions"].safeNumberLong(), 0);
+    ASSERT_LTE(mutexCounters["contended"].safeNumberLong(),
+               mutexCounters["acquisitions"].safeNumberLong());
+}
+
 bool sharedCallbackStateDestroyed = false;
 class SharedCallbackState {
     MONGO_DISALLOW_COPYING(SharedCallbackState);
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace logger {
+
+AsyncAppender::AsyncAppender(std::unique_ptr<Appender<MessageEventEphemeral>> target,
+                             std::size_t maxQueuedEvents)
+    : _target(std::move(target)), _maxQueuedEvents(maxQueuedEvents) {
+    _thread = stdx::thread([this] { _run(); });
+}
+
+AsyncAppender::~AsyncAppender() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inShutdown = true;
+    }
+    _queueNotEmpty.notify_one();
+    _thread.join();
+}
+
+Status AsyncAppender::append(const MessageEventEphemeral& event) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (event.getSeverity() >= LogSeverity::Warning()) {
+        _waitUntilFlushed(lk);
+        ++_numInFlight;
+        lk.unlock();
+        Status status = _target->append(event);
+        lk.lock();
+        if (--_numInFlight == 0 && _queue.empty()) {
+            _flushed.notify_all();
+        }
+        return status;
+    }
+
+    if (_queue.size() >= _maxQueuedEvents) {
+        ++_numDropped;
+        return Status::OK();
+    }
+
+    _queue.push_back({event.getDate(),
+                      event.getSeverity(),
+                      event.getComponent(),
+                      event.getContextName().toString(),
+                      event.getMessage().toString(),
+                      event.isTruncatable()});
+    if (_queue.size() == 1) {
+        _queueNotEmpty.notify_one();
+    }
+    return Status::OK();
+}
+
+void AsyncAppender::flush() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _waitUntilFlushed(lk);
+}
+
+std::uint64_t AsyncAppender::getDroppedCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numDropped;
+}
+
+void AsyncAppender::_waitUntilFlushed(stdx::unique_lock<stdx::mutex>& lk) {
+    _flushed.wait(lk, [this] { return _queue.empty() && _numInFlight == 0; });
+}
+
+void AsyncAppender::_run() {
+    setThreadName("AsyncLogAppender");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        _queueNotEmpty.wait(lk, [this] { return _inShutdown || !_queue.empty(); });
+        if (_queue.empty()) {
+            invariant(_inShutdown);
+            return;
+        }
+
+        std::deque<QueuedEvent> events;
+        swap(events, _queue);
+        _numInFlight += events.size();
+        const auto numNewlyDropped = _numDropped - _numDroppedReported;
+        _numDroppedReported = _numDropped;
+        lk.unlock();
+
+        for (auto&& queued : events) {
+            MessageEventEphemeral event(queued.date,
+                                        queued.severity,
+                                        queued.component,
+                                        queued.contextName,
+                                        queued.message);
+            event.setIsTruncatable(queued.isTruncatable);
+            _target->append(event).transitional_ignore();
+        }
+
+        if (numNewlyDropped > 0) {
+            const std::string message = str::stream()
+                << numNewlyDropped << " log messages were dropped because the queue of "
+                << _maxQueuedEvents << " messages waiting to be logged was full";
+            _target
+                ->append(MessageEventEphemeral(
+                    Date_t::now(), LogSeverity::Warning(), "AsyncLogAppender", message))
+                .transitional_ignore();
+        }
+
+        lk.lock();
+        _numInFlight -= events.size();
+        if (_numInFlight == 0 && _queue.empty()) {
+            _flushed.notify_all();
+        }
+    }
+}
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender which hands events to a background thread that appends them to another appender, so
+ * that the threads logging them do not wait for the other appender, e.g. for a stalled disk.
+ *
+ * At most 'maxQueuedEvents' events wait to be appended. Further events are dropped and counted
+ * until the background thread catches up, and the number of dropped events is then logged.
+ * Warnings and more severe events are never dropped: they are appended by the logging thread
+ * once the events before them have been, so that they are not lost if the process exits next.
+ */
+class AsyncAppender : public Appender<MessageEventEphemeral> {
+    MONGO_DISALLOW_COPYING(AsyncAppender);
+
+public:
+    AsyncAppender(std::unique_ptr<Appender<MessageEventEphemeral>> target,
+                  std::size_t maxQueuedEvents);
+
+    /**
+     * Appends the events still queued before returning.
+     */
+    ~AsyncAppender() override;
+
+    Status append(const MessageEventEphemeral& event) override;
+
+    /**
+     * Waits until all the events appended so far have been appended to the target appender.
+     */
+    void flush();
+
+    /**
+     * Returns the number of events dropped because the queue was full.
+     */
+    std::uint64_t getDroppedCount() const;
+
+private:
+    /**
+     * A copy of a MessageEventEphemeral which owns its strings.
+     */
+    struct QueuedEvent {
+        Date_t date;
+        LogSeverity severity;
+        LogComponent component;
+        std::string contextName;
+        std::string message;
+        bool isTruncatable;
+    };
+
+    void _run();
+
+    void _waitUntilFlushed(stdx::unique_lock<stdx::mutex>& lk);
+
+    const std::unique_ptr<Appender<MessageEventEphemeral>> _target;
+    const std::size_t _maxQueuedEvents;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _queueNotEmpty;
+    stdx::condition_variable _flushed;
+    std::deque<QueuedEvent> _queue;
+    // The number of events taken off '_queue' that have not been appended to '_target' yet.
+    std::size_t _numInFlight = 0;
+    std::uint64_t _numDropped = 0;
+    std::uint64_t _numDroppedReported = 0;
+    bool _inShutdown = false;
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+/**
+ * Records the messages appended to it, and blocks appending them while it is paused.
+ */
+class RecordingAppender : public Appender<MessageEventEphemeral> {
+public:
+    Status append(const MessageEventEphemeral& event) override {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _unpaused.wait(lk, [this] { return !_paused; });
+        _messages.push_back(event.getMessage().toString());
+        return Status::OK();
+    }
+
+    void setPaused(bool paused) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _paused = paused;
+        }
+        _unpaused.notify_all();
+    }
+
+    std::vector<std::string> getMessages() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _messages;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _unpaused;
+    bool _paused = false;
+    std::vector<std::string> _messages;
+};
+
+MessageEventEphemeral makeEvent(LogSeverity severity, StringData message) {
+    return MessageEventEphemeral(Date_t::now(), severity, "test", message);
+}
+
+TEST(AsyncAppenderTest, AppendsEventsInOrder) {
+    auto target = stdx::make_unique<RecordingAppender>();
+    auto recorder = target.get();
+    AsyncAppender appender(std::move(target), 100);
+
+    std::vector<std::string> expected;
+    for (int i = 0; i < 50; ++i) {
+        expected.push_back(std::to_string(i));
+        ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), expected.back())));
+    }
+    appender.flush();
+
+    ASSERT(expected == recorder->getMessages());
+    ASSERT_EQ(0U, appender.getDroppedCount());
+}
+
+TEST(AsyncAppenderTest, DropsEventsWhenTheQueueIsFullAndReportsThem) {
+    auto target = stdx::make_unique<RecordingAppender>();
+    auto recorder = target.get();
+    AsyncAppender appender(std::move(target), 2);
+
+    // The background thread blocks on appending the first event, if it has taken it off the queue
+    // yet, so at most two of the events after it fit in the queue.
+    recorder->setPaused(true);
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "first")));
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "next")));
+    }
+    const auto dropped = appender.getDroppedCount();
+    ASSERT_GTE(dropped, 1U);
+    recorder->setPaused(false);
+    appender.flush();
+
+    // A warning about the dropped events follows the events which were queued.
+    auto messages = recorder->getMessages();
+    ASSERT_GTE(messages.size(), 2U);
+    ASSERT_EQ("first", messages.front());
+    ASSERT_STRING_CONTAINS(messages.back(),
+                           std::to_string(dropped) + " log messages were dropped");
+}
+
+TEST(AsyncAppenderTest, WarningsAreAppendedAfterPreviousEventsAndNeverDropped) {
+    auto target = stdx::make_unique<RecordingAppender>();
+    auto recorder = target.get();
+    AsyncAppender appender(std::move(target), 1);
+
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "info")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Warning(), "warning")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Severe(), "severe")));
+
+    // Warnings are appended by the logging thread, so they are visible without a flush.
+    std::vector<std::string> expected{"info", "warning", "severe"};
+    ASSERT(expected == recorder->getMessages());
+}
+
+TEST(AsyncAppenderTest, DestructionAppendsQueuedEvents) {
+    auto messages = std::make_shared<std::vector<std::string>>();
+
+    /**
+     * Records messages into a vector which outlives it.
+     */
+    class SharedRecordingAppender : public Appender<MessageEventEphemeral> {
+    public:
+        explicit SharedRecordingAppender(std::shared_ptr<std::vector<std::string>> messages)
+            : _messages(std::move(messages)) {}
+
+        Status append(const MessageEventEphemeral& event) override {
+            _messages->push_back(event.getMessage().toString());
+            return Status::OK();
+        }
+
+    private:
+        std::shared_ptr<std::vector<std::string>> _messages;
+    };
+
+    {
+        AsyncAppender appender(stdx::make_unique<SharedRecordingAppender>(messages), 100);
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "queued")));
+        }
+    }
+    ASSERT_EQ(10U, messages->size());
+}
+
+}  // namespace
+}  // namespace logger
+}  // namespace mongo
@@ -173,6 +173,31 @@ BID_UINT128 decimal128ToLibraryType(Decimal128::Value value) {
     dec128.w[kHigh64] = value.high64;
     return dec128;
 }
+
+// Coefficients up to this value are handled by the exact fast paths. The sum of two of them fits in
+// 64 bits, and every 64-bit coefficient is below the 10^34 limit of a Decimal128.
+const std::uint64_t kMaxExactCoefficient = (1ull << 63) - 1;
+
+const std::uint64_t kPowersOfTen[] = {1ull,
+                                      10ull,
+                                      100ull,
+                                      1000ull,
+                                      10000ull,
+                                      100000ull,
+                                      1000000ull,
+                                      10000000ull,
+                                      100000000ull,
+                                      1000000000ull,
+                                      10000000000ull,
+                                      100000000000ull,
+                                      1000000000000ull,
+                                      10000000000000ull,
+                                      100000000000000ull,
+                                      1000000000000000ull,
+                                      10000000000000000ull,
+                                      100000000000000000ull,
+                                      1000000000000000000ull};
+const std::uint32_t kNumPowersOfTen = sizeof(kPowersOfTen) / sizeof(kPowersOfTen[0]);
 }  // namespace
 
 Decimal128::Decimal128(std::int32_t int32Value)
@@ -562,9 +587,87 @@ Decimal128 Decimal128::add(const Decimal128& other, RoundingMode roundMode) cons
     return add(other, &throwAwayFlag, roundMode);
 }
 
+bool Decimal128::_hasSmallCoefficient() const {
+    return _getCombinationField() < kCombinationNonCanonical &&
+        (_value.high64 & kCanonicalCoefficientHighFieldMask) == 0 &&
+        _value.low64 <= kMaxExactCoefficient;
+}
+
+bool Decimal128::_addExact(const Decimal128& other,
+                           RoundingMode roundMode,
+                           Decimal128* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient()) {
+        return false;
+    }
+
+    std::uint32_t exponent = getBiasedExponent();
+    const std::uint32_t otherExponent = other.getBiasedExponent();
+    std::uint64_t coefficient = _value.low64;
+    std::uint64_t otherCoefficient = other._value.low64;
+
+    // An exact sum has the smaller of the two exponents, so scale the coefficient of the operand
+    // with the larger exponent to it.
+    if (exponent != otherExponent) {
+        const bool thisIsLarger = exponent > otherExponent;
+        std::uint64_t& larger = thisIsLarger ? coefficient : otherCoefficient;
+        const std::uint32_t shift =
+            thisIsLarger ? exponent - otherExponent : otherExponent - exponent;
+        if (larger != 0) {
+            if (shift >= kNumPowersOfTen || larger > kMaxExactCoefficient / kPowersOfTen[shift]) {
+                return false;
+            }
+            larger *= kPowersOfTen[shift];
+        }
+        exponent = std::min(exponent, otherExponent);
+    }
+
+    const std::uint64_t sign = _value.high64 >> kSignFieldPos;
+    const std::uint64_t otherSign = other._value.high64 >> kSignFieldPos;
+    if (sign == otherSign) {
+        *result = Decimal128(sign, exponent, 0, coefficient + otherCoefficient);
+    } else if (coefficient > otherCoefficient) {
+        *result = Decimal128(sign, exponent, 0, coefficient - otherCoefficient);
+    } else if (otherCoefficient > coefficient) {
+        *result = Decimal128(otherSign, exponent, 0, otherCoefficient - coefficient);
+    } else {
+        // An exact zero sum of operands of opposite signs is positive, except when rounding
+        // toward negative.
+        *result = Decimal128(roundMode == kRoundTowardNegative ? 1 : 0, exponent, 0, 0);
+    }
+    return true;
+}
+
+bool Decimal128::_multiplyExact(const Decimal128& other, Decimal128* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient()) {
+        return false;
+    }
+
+    const std::uint64_t coefficient = _value.low64;
+    const std::uint64_t otherCoefficient = other._value.low64;
+    if (otherCoefficient != 0 && coefficient > kMaxExactCoefficient / otherCoefficient) {
+        return false;
+    }
+
+    // The exponent of an exact product is the sum of the exponents, which must be representable.
+    const std::int64_t exponent = static_cast<std::int64_t>(getBiasedExponent()) +
+        other.getBiasedExponent() - kExponentBias;
+    if (exponent < 0 || exponent > kMaxBiasedExponent) {
+        return false;
+    }
+
+    const std::uint64_t sign = (_value.high64 ^ other._value.high64) >> kSignFieldPos;
+    *result = Decimal128(sign, exponent, 0, coefficient * otherCoefficient);
+    return true;
+}
+
 Decimal128 Decimal128::add(const Decimal128& other,
                            std::uint32_t* signalingFlags,
                            RoundingMode roundMode) const {
+    Decimal128 exact;
+    if (_addExact(other, roundMode, &exact)) {
+        return exact;
+    }
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 addend = decimal128ToLibraryType(other.getValue());
     current = bid128_add(current, addend, roundMode, signalingFlags);
@@ -581,6 +684,11 @@ Decimal128 Decimal128::subtract(const Decimal128& other, RoundingMode roundMode)
 Decimal128 Decimal128::subtract(const Decimal128& other,
                                 std::uint32_t* signalingFlags,
                                 RoundingMode roundMode) const {
+    Decimal128 exact;
+    if (_addExact(other.negate(), roundMode, &exact)) {
+        return exact;
+    }
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 sub = decimal128ToLibraryType(other.getValue());
     current = bid128_sub(current, sub, roundMode, signalingFlags);
@@ -597,6 +705,11 @@ Decimal128 Decimal128::multiply(const Decimal128& other, RoundingMode roundMode)
 Decimal128 Decimal128::multiply(const Decimal128& other,
                                 std::uint32_t* signalingFlags,
                                 RoundingMode roundMode) const {
+    Decimal128 exact;
+    if (_multiplyExact(other, &exact)) {
+        return exact;
+    }
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 factor = decimal128ToLibraryType(other.getValue());
     current = bid128_mul(current, factor, roundMode, signalingFlags);
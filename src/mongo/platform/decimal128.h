@@ -442,6 +442,20 @@ private:
         return (_value.high64 >> kCombinationFieldPos) & kCombinationFieldMask;
     }
 
+    /**
+     * Returns true if this is a finite decimal in canonical form whose coefficient is less than
+     * 2^63, which is the precondition for the exact fast paths below.
+     */
+    bool _hasSmallCoefficient() const;
+
+    /**
+     * Compute the sum or product of this and 'other' with 64-bit integer arithmetic when it is
+     * exact, and so independent of the rounding mode except for the sign of a zero sum. Return
+     * false, leaving 'result' untouched, when the operation must go through the decimal library.
+     */
+    bool _addExact(const Decimal128& other, RoundingMode roundMode, Decimal128* result) const;
+    bool _multiplyExact(const Decimal128& other, Decimal128* result) const;
+
     Value _value;
 };
 }  // namespace mongo
@@ -1045,6 +1045,43 @@ TEST(Decimal128Test, TestDecimal128MultiplicationCase2) {
     ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
 }
 
+// The following results are exact and are computed without the decimal library.
+TEST(Decimal128Test, TestDecimal128ExactAdditionAlignsToTheSmallerExponent) {
+    ASSERT_TRUE(Decimal128("1.5").add(Decimal128("2.25")).isBinaryEqual(Decimal128("3.75")));
+    ASSERT_TRUE(Decimal128("100E2").add(Decimal128("1")).isBinaryEqual(Decimal128("10001")));
+    ASSERT_TRUE(Decimal128().add(Decimal128("19.99")).isBinaryEqual(Decimal128("19.99")));
+    ASSERT_TRUE(Decimal128("-7").add(Decimal128("2.50")).isBinaryEqual(Decimal128("-4.50")));
+    ASSERT_TRUE(Decimal128("0E5").add(Decimal128("0E-3")).isBinaryEqual(Decimal128("0E-3")));
+}
+
+TEST(Decimal128Test, TestDecimal128ExactZeroSumSign) {
+    ASSERT_TRUE(Decimal128("1.0").subtract(Decimal128("1.0")).isBinaryEqual(Decimal128("0.0")));
+    ASSERT_TRUE(Decimal128("1.0")
+                    .subtract(Decimal128("1.0"), Decimal128::kRoundTowardNegative)
+                    .isBinaryEqual(Decimal128("-0.0")));
+    ASSERT_TRUE(Decimal128("-0").add(Decimal128("-0")).isBinaryEqual(Decimal128("-0")));
+    ASSERT_TRUE(Decimal128("-0").add(Decimal128("0")).isBinaryEqual(Decimal128("0")));
+}
+
+TEST(Decimal128Test, TestDecimal128ExactMultiplication) {
+    ASSERT_TRUE(Decimal128("1.5").multiply(Decimal128("-2.0")).isBinaryEqual(Decimal128("-3.00")));
+    ASSERT_TRUE(Decimal128("-0").multiply(Decimal128("5E3")).isBinaryEqual(Decimal128("-0E3")));
+}
+
+TEST(Decimal128Test, TestDecimal128InexactResultsStillRound) {
+    // The sum needs more than 34 digits.
+    uint32_t sigFlags = Decimal128::SignalingFlag::kNoFlag;
+    Decimal128 sum = Decimal128("1E40").add(Decimal128("1"), &sigFlags);
+    ASSERT_TRUE(sum.isBinaryEqual(Decimal128("1.000000000000000000000000000000000E40")));
+    ASSERT_TRUE(Decimal128::hasFlag(sigFlags, Decimal128::SignalingFlag::kInexact));
+
+    // The product's exponent is out of range.
+    sigFlags = Decimal128::SignalingFlag::kNoFlag;
+    Decimal128 product = Decimal128("1E-6000").multiply(Decimal128("1E-6000"), &sigFlags);
+    ASSERT_TRUE(product.isZero());
+    ASSERT_TRUE(Decimal128::hasFlag(sigFlags, Decimal128::SignalingFlag::kUnderflow));
+}
+
 TEST(Decimal128Test, TestDecimal128DivisionCase1) {
     Decimal128 d1("25.05E20");
     Decimal128 d2("-50.5218E19");
@@ -49,11 +49,29 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderUseBaton, bool, true);
 
+// When true, requests whose read preference allows more than one member are duplicated to a second
+// eligible member if they have not received a reply within the hedge delay. The request which
+// loses the race is canceled; a cursor it may already have opened on its member is left to time
+// out.
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeReads, bool, false);
+
+// Lower bound on the hedge delay, also used for shards for which no latencies are known yet.
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeMinDelayMillis, int, 10);
+
 namespace {
 
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Percentile of a shard's recent operation latencies after which a request is hedged.
+const double kHedgeDelayPercentile = 95;
+
+bool isHedgeable(const ReadPreferenceSetting& readPref) {
+    return readPref.pref == ReadPreference::SecondaryOnly ||
+        readPref.pref == ReadPreference::SecondaryPreferred ||
+        readPref.pref == ReadPreference::Nearest;
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -67,7 +85,8 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
       _baton(opCtx),
       _db(dbName.toString()),
       _readPreference(readPreference),
-      _retryPolicy(retryPolicy) {
+      _retryPolicy(retryPolicy),
+      _hedgeReads(AsyncRequestsSenderHedgeReads.load() && isHedgeable(readPreference)) {
     for (const auto& request : requests) {
         auto cmdObj = request.cmdObj;
         _remotes.emplace_back(request.shardId, cmdObj);
@@ -87,6 +106,11 @@ AsyncRequestsSender::~AsyncRequestsSender() {
     while (!done()) {
         next();
     }
+
+    // Wait on the callbacks of requests which lost the race against their hedge, or vice versa.
+    while (_hasOutstandingRequests()) {
+        _makeProgress(nullptr);
+    }
 }
 
 AsyncRequestsSender::Response AsyncRequestsSender::next() {
@@ -99,6 +123,9 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
         // Otherwise, wait for some response to be received.
         if (_interruptStatus.isOK()) {
             try {
+                if (_hedgeReads && !_stopRetrying) {
+                    _scheduleHedgedRequests();
+                }
                 _makeProgress(_opCtx);
             } catch (const AssertionException& ex) {
                 // If the operation is interrupted, we cancel outstanding requests and switch to
@@ -128,9 +155,13 @@ void AsyncRequestsSender::_cancelPendingRequests() {
 
     // Cancel all outstanding requests so they return immediately.
     for (auto& remote : _remotes) {
+        remote.hedgeDeadline = boost::none;
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
     }
 }
 
@@ -210,7 +241,7 @@ void AsyncRequestsSender::_scheduleRequests() {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        if (!remote.swResponse && !remote.cbHandle.isValid() && !remote.hedgeCbHandle.isValid()) {
             auto scheduleStatus = _scheduleRequest(i);
             if (!scheduleStatus.isOK()) {
                 remote.swResponse = std::move(scheduleStatus);
@@ -239,26 +270,101 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
         return resolveStatus;
     }
 
-    executor::RemoteCommandRequest request(
-        *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
+    auto callbackStatus = _scheduleRemoteCommand(remoteIndex, *remote.shardHostAndPort, false);
+    if (!callbackStatus.isOK()) {
+        return callbackStatus.getStatus();
+    }
+
+    remote.cbHandle = callbackStatus.getValue();
+    remote.hedgeHostAndPort = boost::none;
+
+    if (_hedgeReads) {
+        Milliseconds hedgeDelay{std::max(0, AsyncRequestsSenderHedgeMinDelayMillis.load())};
+        if (auto shard = remote.getShard()) {
+            if (auto latency =
+                    shard->getTargeter()->getOperationLatencyPercentile(kHedgeDelayPercentile)) {
+                hedgeDelay = std::max(hedgeDelay, duration_cast<Milliseconds>(*latency));
+            }
+        }
+        remote.hedgeDeadline = _executor->now() + hedgeDelay;
+    }
+
+    return Status::OK();
+}
+
+StatusWith<executor::TaskExecutor::CallbackHandle> AsyncRequestsSender::_scheduleRemoteCommand(
+    size_t remoteIndex, const HostAndPort& host, bool isHedge) {
+    auto& remote = _remotes[remoteIndex];
+
+    executor::RemoteCommandRequest request(host, _db, remote.cmdObj, _metadataObj, _opCtx);
 
-    auto callbackStatus = _executor->scheduleRemoteCommand(
+    const int attempt = remote.attempt;
+    return _executor->scheduleRemoteCommand(
         request,
-        [remoteIndex, this](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+        [remoteIndex, attempt, isHedge, this](
+            const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
             if (_baton) {
                 _batonRequests++;
                 _baton->schedule([this] { _batonRequests--; });
             }
 
-            _responseQueue.push(Job{cbData, remoteIndex});
+            _responseQueue.push(Job{cbData, remoteIndex, attempt, isHedge});
         },
         _baton);
-    if (!callbackStatus.isOK()) {
-        return callbackStatus.getStatus();
+}
+
+void AsyncRequestsSender::_scheduleHedgedRequests() {
+    const auto now = _executor->now();
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
+        if (!remote.hedgeDeadline || *remote.hedgeDeadline > now) {
+            continue;
+        }
+        remote.hedgeDeadline = boost::none;
+
+        if (remote.swResponse || !remote.cbHandle.isValid() || remote.hedgeCbHandle.isValid()) {
+            continue;
+        }
+
+        auto shard = remote.getShard();
+        if (!shard) {
+            continue;
+        }
+
+        auto hedgeHost = shard->getTargeter()->findAlternateHostNoWait(_readPreference,
+                                                                       *remote.shardHostAndPort);
+        if (!hedgeHost) {
+            continue;
+        }
+
+        auto callbackStatus = _scheduleRemoteCommand(i, *hedgeHost, true);
+        if (!callbackStatus.isOK()) {
+            LOG(1) << "Failed to send hedged request for remote " << remote.shardId << " to host "
+                   << *hedgeHost << causedBy(redact(callbackStatus.getStatus()));
+            continue;
+        }
+
+        LOG(2) << "Hedging request for remote " << remote.shardId << " at host "
+               << *remote.shardHostAndPort << " with host " << *hedgeHost;
+        remote.hedgeCbHandle = callbackStatus.getValue();
+        remote.hedgeHostAndPort = std::move(*hedgeHost);
+    }
+}
+
+boost::optional<Date_t> AsyncRequestsSender::_nextHedgeDeadline() const {
+    boost::optional<Date_t> deadline;
+    for (const auto& remote : _remotes) {
+        if (remote.hedgeDeadline && (!deadline || *remote.hedgeDeadline < *deadline)) {
+            deadline = remote.hedgeDeadline;
+        }
     }
+    return deadline;
+}
 
-    remote.cbHandle = callbackStatus.getValue();
-    return Status::OK();
+bool AsyncRequestsSender::_hasOutstandingRequests() const {
+    return std::any_of(_remotes.begin(), _remotes.end(), [](const RemoteData& remote) {
+        return remote.cbHandle.isValid() || remote.hedgeCbHandle.isValid();
+    });
 }
 
 // Passing opCtx means you'd like to opt into opCtx interruption.  During cleanup we actually don't.
@@ -267,12 +373,26 @@ void AsyncRequestsSender::_makeProgress(OperationContext* opCtx) {
 
     boost::optional<Job> job;
 
+    // Wake up in time to send any hedged request which is due.
+    const auto hedgeDeadline = _nextHedgeDeadline();
+
     if (_baton) {
         // If we're using a baton, we peek the queue, and block on the baton if it's empty
         if (boost::optional<boost::optional<Job>> tryJob = _responseQueue.tryPop()) {
             job = std::move(*tryJob);
         } else {
-            _baton->run(opCtx, boost::none);
+            _baton->run(opCtx, hedgeDeadline);
+        }
+    } else if (hedgeDeadline) {
+        try {
+            job = opCtx ? _responseQueue.pop(opCtx, *hedgeDeadline)
+                        : _responseQueue.pop(*hedgeDeadline);
+        } catch (const ExceptionFor<ErrorCodes::ExceededTimeLimit>&) {
+            // Reaching the hedge deadline is not an error, but reaching the operation's is.
+            if (opCtx) {
+                uassertStatusOK(opCtx->checkForInterruptNoAssert());
+            }
+            return;
         }
     } else {
         // Otherwise we block on the queue
@@ -284,11 +404,46 @@ void AsyncRequestsSender::_makeProgress(OperationContext* opCtx) {
     }
 
     auto& remote = _remotes[job->remoteIndex];
-    invariant(!remote.swResponse);
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    // this request.
+    auto& otherCbHandle = job->isHedge ? remote.cbHandle : remote.hedgeCbHandle;
+    (job->isHedge ? remote.hedgeCbHandle : remote.cbHandle) =
+        executor::TaskExecutor::CallbackHandle();
+
+    const auto& response = job->cbData.response;
+    if (response.status.isOK() && response.elapsedMillis) {
+        if (auto shard = remote.getShard()) {
+            shard->getTargeter()->recordOperationLatency(job->cbData.request.target,
+                                                          *response.elapsedMillis);
+        }
+    }
+
+    // Drop the reply if the other of the request and its hedge already won.
+    if (job->attempt != remote.attempt) {
+        return;
+    }
+
+    // While the other of the request and its hedge is still outstanding, wait for it rather than
+    // act on a failure to get a reply.
+    if (!response.status.isOK() && otherCbHandle.isValid()) {
+        LOG(1) << "Ignoring failed " << (job->isHedge ? "hedged " : "") << "request to "
+               << job->cbData.request.target << " for remote " << remote.shardId
+               << " while waiting for the other request" << causedBy(redact(response.status));
+        return;
+    }
+
+    invariant(!remote.swResponse);
+
+    // This reply wins, so cancel the other request and stop waiting to hedge.
+    ++remote.attempt;
+    remote.hedgeDeadline = boost::none;
+    if (otherCbHandle.isValid()) {
+        _executor->cancel(otherCbHandle);
+    }
+    if (job->isHedge) {
+        remote.shardHostAndPort = remote.hedgeHostAndPort;
+    }
 
     // Store the response or error.
     if (job->cbData.response.status.isOK()) {
@@ -76,6 +76,11 @@ namespace mongo {
  *     }
  * }
  *
+ * If the AsyncRequestsSenderHedgeReads server parameter is enabled and the read preference allows
+ * more than one member of a shard to serve the request, a request which has not received a reply
+ * within the hedge delay is duplicated to another eligible member, and the first reply received
+ * is returned. The hedge delay is the 95th percentile of the shard's recent operation latencies.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -199,6 +204,21 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // The host to which a hedged duplicate of the request was sent. Is unset until a hedged
+        // request has been sent.
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
+        // The callback handle to an outstanding hedged request for this remote.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
+        // The time after which the outstanding request should be hedged if it has not received a
+        // reply. Is unset if the request is not hedged or its hedge has already been sent.
+        boost::optional<Date_t> hedgeDeadline;
+
+        // Incremented each time a reply is accepted, so that the reply to whichever of a request
+        // and its hedge lost the race is recognized and dropped.
+        int attempt = 0;
+
         // Whether this remote's result has been returned.
         bool done = false;
     };
@@ -210,6 +230,8 @@ private:
     struct Job {
         executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
         size_t remoteIndex;
+        int attempt;
+        bool isHedge;
     };
 
     /**
@@ -278,6 +300,30 @@ private:
      */
     Status _scheduleRequest(size_t remoteIndex);
 
+    /**
+     * For each remote whose outstanding request has passed its hedge deadline, sends a duplicate
+     * of the request to another host matching the read preference, if there is one.
+     */
+    void _scheduleHedgedRequests();
+
+    /**
+     * Helper to schedule the command of the remote at 'remoteIndex' to 'host' and return its
+     * callback handle.
+     */
+    StatusWith<executor::TaskExecutor::CallbackHandle> _scheduleRemoteCommand(
+        size_t remoteIndex, const HostAndPort& host, bool isHedge);
+
+    /**
+     * Returns the earliest hedge deadline of any remote, or boost::none if no remote is waiting
+     * to be hedged.
+     */
+    boost::optional<Date_t> _nextHedgeDeadline() const;
+
+    /**
+     * Returns true if any request or hedged request has a callback which has not yet run.
+     */
+    bool _hasOutstandingRequests() const;
+
     /**
      * Waits for forward progress in gathering responses from a remote.
      *
@@ -306,6 +352,9 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
+    // Whether requests which are slow to receive a reply are duplicated to a second host.
+    const bool _hedgeReads;
+
     // Is set to a non-OK status if the client operation is interrupted.
     // When waiting for a remote to be ready, we only check for interrupt if the _interruptStatus
     // has not already been set to an error (so we can wait for callbacks for (canceled) outstanding
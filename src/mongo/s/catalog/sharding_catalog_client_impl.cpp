@@ -46,6 +46,7 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -93,6 +94,12 @@ const ReadPreferenceSetting kConfigPrimaryPreferredSelector(ReadPreference::Prim
 const int kMaxReadRetry = 3;
 const int kMaxWriteRetry = 3;
 
+// Whether a database which is not found on the nearest config server is looked up again on the
+// config primary. Reads from the nearest node wait for the config optime this node has seen, so
+// the second lookup only finds databases created through routers which this node has not yet heard
+// from. Disabling it stops lookups of nonexistent databases from all reaching the config primary.
+MONGO_EXPORT_SERVER_PARAMETER(catalogDatabaseLookupFallBackToConfigPrimary, bool, true);
+
 const std::string kActionLogCollectionName("actionlog");
 const int kActionLogCollectionSizeMB = 20 * 1024 * 1024;
 
@@ -253,7 +260,8 @@ StatusWith<repl::OpTimeWith<DatabaseType>> ShardingCatalogClientImpl::getDatabas
     }
 
     auto result = _fetchDatabaseMetadata(opCtx, dbName, kConfigReadSelector, readConcernLevel);
-    if (result == ErrorCodes::NamespaceNotFound) {
+    if (result == ErrorCodes::NamespaceNotFound &&
+        catalogDatabaseLookupFallBackToConfigPrimary.load()) {
         // If we failed to find the database metadata on the 'nearest' config server, try again
         // against the primary, in case the database was recently created.
         result = _fetchDatabaseMetadata(
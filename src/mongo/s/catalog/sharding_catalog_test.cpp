@@ -38,6 +38,7 @@
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -57,6 +58,7 @@
 #include "mongo/s/write_ops/batched_command_response.h"
 #include "mongo/stdx/future.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -264,6 +266,26 @@ TEST_F(ShardingCatalogClientTest, GetDatabaseNotExisting) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(ShardingCatalogClientTest, GetDatabaseNotExistingWithoutPrimaryFallBack) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find(
+        "catalogDatabaseLookupFallBackToConfigPrimary");
+    ASSERT_OK(param->second->setFromString("false"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(param->second->setFromString("true")); });
+
+    configTargeter()->setFindHostReturnValue(HostAndPort("TestHost1"));
+
+    auto future = launchAsync([this] {
+        auto dbResult = catalogClient()->getDatabase(
+            operationContext(), "NonExistent", repl::ReadConcernLevel::kMajorityReadConcern);
+        ASSERT_EQ(dbResult.getStatus(), ErrorCodes::NamespaceNotFound);
+    });
+
+    // Only the nearest config server is asked.
+    onFindCommand([](const RemoteCommandRequest& request) { return vector<BSONObj>{}; });
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(ShardingCatalogClientTest, GetAllShardsValid) {
     configTargeter()->setFindHostReturnValue(HostAndPort("TestHost1"));
 
@@ -32,6 +32,9 @@
 
 #include "mongo/s/catalog_cache.h"
 
+#include <deque>
+#include <set>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
@@ -393,6 +396,94 @@ void CatalogCache::purgeAllDatabases() {
     _collectionsByDb.clear();
 }
 
+void CatalogCache::warmUp(OperationContext* opCtx,
+                          size_t maxCollections,
+                          size_t maxConcurrentRefreshes) {
+    invariant(maxConcurrentRefreshes > 0);
+    Timer t;
+
+    repl::OpTime collLoadConfigOptime;
+    auto swCollections =
+        Grid::get(opCtx)->catalogClient()->getCollections(opCtx, nullptr, &collLoadConfigOptime);
+    if (!swCollections.isOK()) {
+        warning() << "Failed to list the sharded collections to warm up the catalog cache"
+                  << causedBy(redact(swCollections.getStatus()));
+        return;
+    }
+
+    std::vector<NamespaceString> nssToLoad;
+    std::set<std::string> dbNames;
+    for (const auto& coll : swCollections.getValue()) {
+        if (nssToLoad.size() >= maxCollections) {
+            break;
+        }
+        if (coll.getDropped()) {
+            continue;
+        }
+        nssToLoad.push_back(coll.getNs());
+        dbNames.insert(coll.getNs().db().toString());
+    }
+
+    // Loading a database also creates the entries of its sharded collections
+    for (const auto& dbName : dbNames) {
+        auto swDbInfo = getDatabase(opCtx, dbName);
+        if (!swDbInfo.isOK()) {
+            warning() << "Failed to load database " << dbName << " to warm up the catalog cache"
+                      << causedBy(redact(swDbInfo.getStatus()));
+        }
+    }
+
+    std::deque<std::shared_ptr<Notification<Status>>> pendingRefreshes;
+    size_t numFailedRefreshes = 0;
+    const auto waitForOldestRefresh = [&] {
+        const auto status = [&] {
+            try {
+                return pendingRefreshes.front()->get(opCtx);
+            } catch (const DBException& ex) {
+                return ex.toStatus();
+            }
+        }();
+        if (!status.isOK()) {
+            ++numFailedRefreshes;
+        }
+        pendingRefreshes.pop_front();
+    };
+
+    for (const auto& nss : nssToLoad) {
+        if (pendingRefreshes.size() >= maxConcurrentRefreshes) {
+            waitForOldestRefresh();
+        }
+
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+        const auto itDb = _collectionsByDb.find(nss.db());
+        if (itDb == _collectionsByDb.end()) {
+            continue;
+        }
+
+        const auto itColl = itDb->second.find(nss.ns());
+        if (itColl == itDb->second.end() || !itColl->second->needsRefresh) {
+            continue;
+        }
+
+        auto& collEntry = itColl->second;
+        auto refreshNotification = collEntry->refreshCompletionNotification;
+        if (!refreshNotification) {
+            refreshNotification = (collEntry->refreshCompletionNotification =
+                                       std::make_shared<Notification<Status>>());
+            _scheduleCollectionRefresh(lg, collEntry, nss, 1);
+        }
+        pendingRefreshes.push_back(std::move(refreshNotification));
+    }
+
+    while (!pendingRefreshes.empty()) {
+        waitForOldestRefresh();
+    }
+
+    log() << "Warmed up the routing info of " << nssToLoad.size() << " sharded collections in "
+          << t.millis() << " ms; " << numFailedRefreshes << " refreshes failed";
+}
+
 void CatalogCache::report(BSONObjBuilder* builder) const {
     BSONObjBuilder cacheStatsBuilder(builder->subobjStart("catalogCache"));
 
@@ -228,6 +228,15 @@ public:
      */
     void purgeAllDatabases();
 
+    /**
+     * Loads the routing info of up to 'maxCollections' sharded collections, so that the first
+     * requests to a newly started mongos do not each have to wait for a refresh. Keeps up to
+     * 'maxConcurrentRefreshes' collection refreshes in flight at once, and joins the refreshes
+     * already started by other threads instead of starting new ones. Failures are logged and do
+     * not stop the warm-up.
+     */
+    void warmUp(OperationContext* opCtx, size_t maxCollections, size_t maxConcurrentRefreshes);
+
     /**
      * Reports statistics about the catalog cache to be used by serverStatus
      */
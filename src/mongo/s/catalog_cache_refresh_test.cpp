@@ -37,6 +37,7 @@
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 #include "mongo/s/database_version_helpers.h"
+#include "mongo/s/grid.h"
 
 namespace mongo {
 namespace {
@@ -118,6 +119,48 @@ TEST_F(CatalogCacheRefreshTest, FullLoad) {
     ASSERT_EQ(4, cm->numChunks());
 }
 
+TEST_F(CatalogCacheRefreshTest, WarmUpLoadsShardedCollections) {
+    const OID epoch = OID::gen();
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto future = launchAsync([this] {
+        auto client = getServiceContext()->makeClient("Test");
+        auto opCtx = client->makeOperationContext();
+        Grid::get(getServiceContext())->catalogCache()->warmUp(opCtx.get(), 10, 4);
+    });
+
+    // Listing the sharded collections of the cluster
+    expectGetCollection(epoch, shardKeyPattern);
+
+    // Loading their database
+    expectGetDatabase();
+    expectGetCollection(epoch, shardKeyPattern);
+
+    // Refreshing the collection
+    expectGetCollection(epoch, shardKeyPattern);
+    expectFindSendBSONObjVector(kConfigHostAndPort, [&]() {
+        ChunkVersion version(1, 0, epoch);
+
+        ChunkType chunk1(
+            kNss, {shardKeyPattern.getKeyPattern().globalMin(), BSON("_id" << 0)}, version, {"0"});
+        version.incMinor();
+
+        ChunkType chunk2(
+            kNss, {BSON("_id" << 0), shardKeyPattern.getKeyPattern().globalMax()}, version, {"1"});
+
+        return std::vector<BSONObj>{chunk1.toConfigBSON(), chunk2.toConfigBSON()};
+    }());
+
+    future.timed_get(kFutureTimeout);
+
+    // The routing info is now served without contacting the config server
+    auto routingInfo = assertGet(Grid::get(getServiceContext())
+                                     ->catalogCache()
+                                     ->getCollectionRoutingInfo(operationContext(), kNss));
+    ASSERT(routingInfo.cm());
+    ASSERT_EQ(2, routingInfo.cm()->numChunks());
+}
+
 TEST_F(CatalogCacheRefreshTest, DatabaseNotFound) {
     auto future = scheduleRoutingInfoRefresh(kNss);
 
@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_info_map.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+constexpr size_t ChunkInfoMap::kDefaultMaxBucketSize;
+
+ChunkInfoMap::ChunkInfoMap(size_t maxBucketSize) : _maxBucketSize(maxBucketSize) {
+    invariant(_maxBucketSize >= 2);
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const key_type& key) const {
+    const auto bucketIt = std::lower_bound(
+        _buckets.begin(), _buckets.end(), key, [](const BucketPtr& bucket, const key_type& k) {
+            return bucket->back().first < k;
+        });
+    if (bucketIt == _buckets.end()) {
+        return end();
+    }
+
+    const auto& bucket = **bucketIt;
+    const auto entryIt = std::lower_bound(
+        bucket.begin(), bucket.end(), key, [](const value_type& entry, const key_type& k) {
+            return entry.first < k;
+        });
+    return {_buckets.data(),
+            size_t(bucketIt - _buckets.begin()),
+            size_t(entryIt - bucket.begin())};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const key_type& key) const {
+    const auto bucketIt = std::upper_bound(
+        _buckets.begin(), _buckets.end(), key, [](const key_type& k, const BucketPtr& bucket) {
+            return k < bucket->back().first;
+        });
+    if (bucketIt == _buckets.end()) {
+        return end();
+    }
+
+    const auto& bucket = **bucketIt;
+    const auto entryIt = std::upper_bound(
+        bucket.begin(), bucket.end(), key, [](const key_type& k, const value_type& entry) {
+            return k < entry.first;
+        });
+    return {_buckets.data(),
+            size_t(bucketIt - _buckets.begin()),
+            size_t(entryIt - bucket.begin())};
+}
+
+size_t ChunkInfoMap::erase(const_iterator first, const_iterator last) {
+    if (first == last) {
+        return 0;
+    }
+
+    size_t removed = 0;
+
+    if (first._bucket == last._bucket) {
+        // A range within a single bucket never covers all of it, since 'last' points to an entry
+        // of that bucket
+        auto& bucket = _mutableBucket(first._bucket);
+        bucket.erase(bucket.begin() + first._pos, bucket.begin() + last._pos);
+        removed = last._pos - first._pos;
+        _mergeWithNext(first._bucket);
+    } else {
+        // Remove the tail of the first bucket, the buckets in between and the head of the last
+        // bucket, copying only the buckets which are partially removed
+        size_t firstRemovedBucket = first._bucket;
+        if (first._pos > 0) {
+            auto& bucket = _mutableBucket(first._bucket);
+            removed += bucket.size() - first._pos;
+            bucket.erase(bucket.begin() + first._pos, bucket.end());
+            ++firstRemovedBucket;
+        }
+
+        if (last._pos > 0) {
+            auto& bucket = _mutableBucket(last._bucket);
+            removed += last._pos;
+            bucket.erase(bucket.begin(), bucket.begin() + last._pos);
+        }
+
+        for (size_t i = firstRemovedBucket; i < last._bucket; ++i) {
+            removed += _buckets[i]->size();
+        }
+        _buckets.erase(_buckets.begin() + firstRemovedBucket, _buckets.begin() + last._bucket);
+
+        if (firstRemovedBucket > 0) {
+            _mergeWithNext(firstRemovedBucket - 1);
+        }
+    }
+
+    _size -= removed;
+    return removed;
+}
+
+void ChunkInfoMap::insert(value_type entry) {
+    ++_size;
+
+    if (_buckets.empty()) {
+        _buckets.push_back(std::make_shared<Bucket>());
+        _buckets.back()->push_back(std::move(entry));
+        return;
+    }
+
+    // Entries greater than all existing keys go to the last bucket
+    const auto bucketIt = std::lower_bound(
+        _buckets.begin(),
+        _buckets.end(),
+        entry.first,
+        [](const BucketPtr& bucket, const key_type& k) { return bucket->back().first < k; });
+    const size_t bucketIndex =
+        (bucketIt == _buckets.end()) ? _buckets.size() - 1 : bucketIt - _buckets.begin();
+
+    auto& bucket = _mutableBucket(bucketIndex);
+    const auto entryIt = std::lower_bound(
+        bucket.begin(), bucket.end(), entry.first, [](const value_type& e, const key_type& k) {
+            return e.first < k;
+        });
+    dassert(entryIt == bucket.end() || entryIt->first != entry.first);
+    bucket.insert(entryIt, std::move(entry));
+
+    if (bucket.size() > _maxBucketSize) {
+        const auto middle = bucket.begin() + bucket.size() / 2;
+        auto upperHalf = std::make_shared<Bucket>(std::make_move_iterator(middle),
+                                                  std::make_move_iterator(bucket.end()));
+        bucket.erase(middle, bucket.end());
+        _buckets.insert(_buckets.begin() + bucketIndex + 1, std::move(upperHalf));
+    }
+}
+
+ChunkInfoMap::Bucket& ChunkInfoMap::_mutableBucket(size_t bucket) {
+    // Another instance may drop its reference concurrently, in which case this makes an
+    // unnecessary copy, but it can never acquire a new one, since only this instance can copy it
+    if (_buckets[bucket].use_count() > 1) {
+        _buckets[bucket] = std::make_shared<Bucket>(*_buckets[bucket]);
+    }
+    return *_buckets[bucket];
+}
+
+void ChunkInfoMap::_mergeWithNext(size_t bucket) {
+    if (bucket + 1 >= _buckets.size()) {
+        return;
+    }
+
+    // Only merge into buckets of at most half the split size, so that alternating inserts and
+    // removals around a bucket boundary don't split and merge the same entries repeatedly
+    if (_buckets[bucket]->size() + _buckets[bucket + 1]->size() > _maxBucketSize / 2) {
+        return;
+    }
+
+    auto& merged = _mutableBucket(bucket);
+    auto& next = _mutableBucket(bucket + 1);
+    merged.insert(merged.end(),
+                  std::make_move_iterator(next.begin()),
+                  std::make_move_iterator(next.end()));
+    _buckets.erase(_buckets.begin() + bucket + 1);
+}
+
+}  // namespace mongo
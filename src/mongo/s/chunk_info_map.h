@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mongo {
+
+class ChunkInfo;
+
+/**
+ * Ordered map from the key string of the max of each chunk to the entry describing that chunk.
+ *
+ * The entries are kept in sorted buckets of bounded size, which copies of the map share. Copying
+ * the map only copies a pointer per bucket and modifying a copy only copies the buckets it
+ * modifies, so a routing table can be built from its previous version in time proportional to the
+ * number of changed chunks rather than to the total number of chunks, while readers of the
+ * previous version are unaffected.
+ *
+ * Concurrent reads are safe, but any modification requires exclusive access to the instance
+ * modified. Modifications invalidate all iterators into the modified instance.
+ */
+class ChunkInfoMap {
+public:
+    using key_type = std::string;
+    using mapped_type = std::shared_ptr<ChunkInfo>;
+    using value_type = std::pair<key_type, mapped_type>;
+
+    static constexpr size_t kDefaultMaxBucketSize = 256;
+
+private:
+    using Bucket = std::vector<value_type>;
+    using BucketPtr = std::shared_ptr<Bucket>;
+
+public:
+    /**
+     * Bidirectional iterator over the entries of the map in key order.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return (*_buckets[_bucket])[_pos];
+        }
+
+        pointer operator->() const {
+            return &(*_buckets[_bucket])[_pos];
+        }
+
+        const_iterator& operator++() {
+            if (++_pos == _buckets[_bucket]->size()) {
+                ++_bucket;
+                _pos = 0;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        const_iterator& operator--() {
+            if (_pos == 0) {
+                --_bucket;
+                _pos = _buckets[_bucket]->size();
+            }
+            --_pos;
+            return *this;
+        }
+
+        const_iterator operator--(int) {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _bucket == other._bucket && _pos == other._pos;
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const BucketPtr* buckets, size_t bucket, size_t pos)
+            : _buckets(buckets), _bucket(bucket), _pos(pos) {}
+
+        // Points to the bucket array of the map rather than to the map itself, so that iterators
+        // stay valid when the map is moved
+        const BucketPtr* _buckets{nullptr};
+        size_t _bucket{0};
+        size_t _pos{0};
+    };
+
+    explicit ChunkInfoMap(size_t maxBucketSize = kDefaultMaxBucketSize);
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const_iterator begin() const {
+        return {_buckets.data(), 0, 0};
+    }
+
+    const_iterator end() const {
+        return {_buckets.data(), _buckets.size(), 0};
+    }
+
+    const_iterator cbegin() const {
+        return begin();
+    }
+
+    const_iterator cend() const {
+        return end();
+    }
+
+    /**
+     * Returns an iterator to the first entry with a key which is not less than 'key', or end().
+     */
+    const_iterator lower_bound(const key_type& key) const;
+
+    /**
+     * Returns an iterator to the first entry with a key which is greater than 'key', or end().
+     */
+    const_iterator upper_bound(const key_type& key) const;
+
+    /**
+     * Removes the entries in the range [first, last) and returns the number of entries removed.
+     */
+    size_t erase(const_iterator first, const_iterator last);
+
+    /**
+     * Inserts 'entry' at its position in key order. The map must not already contain its key.
+     */
+    void insert(value_type entry);
+
+private:
+    /**
+     * Returns the bucket at position 'bucket' for modification, first copying it if it is shared
+     * with another instance.
+     */
+    Bucket& _mutableBucket(size_t bucket);
+
+    /**
+     * Merges the bucket at position 'bucket' with the one after it if they have both become small.
+     */
+    void _mergeWithNext(size_t bucket);
+
+    // Buckets which grow above this size get split in two
+    size_t _maxBucketSize;
+
+    // Non-empty buckets of entries, ordered by key both within and across buckets
+    std::vector<BucketPtr> _buckets;
+
+    // Total number of entries across all buckets
+    size_t _size{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,180 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/chunk_info_map.h"
+
+#include <map>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+using ModelMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+
+std::string makeKey(int i) {
+    // Zero-padded, so that the order of the keys is the order of the numbers
+    return str::stream() << std::string(6 - std::to_string(i).size(), '0') << i;
+}
+
+void assertSameContents(const ModelMap& expected, const ChunkInfoMap& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    ASSERT_EQ(expected.empty(), actual.empty());
+
+    auto expectedIt = expected.begin();
+    for (auto it = actual.begin(); it != actual.end(); ++it, ++expectedIt) {
+        ASSERT_EQ(expectedIt->first, it->first);
+    }
+
+    // Iterate backwards as well, to exercise decrementing across buckets
+    auto expectedRIt = expected.rbegin();
+    for (auto it = actual.end(); it != actual.begin(); ++expectedRIt) {
+        --it;
+        ASSERT_EQ(expectedRIt->first, it->first);
+    }
+}
+
+ChunkInfoMap::const_iterator toIterator(const ChunkInfoMap& map,
+                                        const ModelMap& model,
+                                        ModelMap::const_iterator modelIt) {
+    return modelIt == model.end() ? map.end() : map.lower_bound(modelIt->first);
+}
+
+TEST(ChunkInfoMapTest, EmptyMap) {
+    ChunkInfoMap map;
+    ASSERT(map.empty());
+    ASSERT_EQ(0U, map.size());
+    ASSERT(map.begin() == map.end());
+    ASSERT(map.lower_bound("a") == map.end());
+    ASSERT(map.upper_bound("a") == map.end());
+    ASSERT_EQ(0U, map.erase(map.begin(), map.end()));
+}
+
+TEST(ChunkInfoMapTest, BoundsAcrossBuckets) {
+    ChunkInfoMap map(4);
+    for (int i = 0; i < 100; i += 2) {
+        map.insert({makeKey(i), nullptr});
+    }
+    ASSERT_EQ(50U, map.size());
+
+    for (int i = 0; i <= 100; ++i) {
+        const int lower = i + i % 2;
+        const int upper = i + 2 - i % 2;
+
+        const auto lowerIt = map.lower_bound(makeKey(i));
+        if (lower >= 100) {
+            ASSERT(lowerIt == map.end());
+        } else {
+            ASSERT_EQ(makeKey(lower), lowerIt->first);
+        }
+
+        const auto upperIt = map.upper_bound(makeKey(i));
+        if (upper >= 100) {
+            ASSERT(upperIt == map.end());
+        } else {
+            ASSERT_EQ(makeKey(upper), upperIt->first);
+        }
+    }
+}
+
+TEST(ChunkInfoMapTest, RandomOperationsMatchStdMap) {
+    PseudoRandom random(12345);
+    ChunkInfoMap map(8);
+    ModelMap model;
+
+    for (int round = 0; round < 2000; ++round) {
+        if (model.empty() || random.nextInt32(3) != 0) {
+            const auto key = makeKey(random.nextInt32(5000));
+            if (model.emplace(key, nullptr).second) {
+                map.insert({key, nullptr});
+            }
+        } else {
+            // Remove a range of up to 20 entries, as a changed chunk replacing a few others would
+            auto firstKey = makeKey(random.nextInt32(5000));
+            auto modelFirst = model.lower_bound(firstKey);
+            auto modelLast = modelFirst;
+            for (int n = random.nextInt32(20); n > 0 && modelLast != model.end(); --n) {
+                ++modelLast;
+            }
+
+            const auto expectedRemoved = std::distance(modelFirst, modelLast);
+            const auto first = toIterator(map, model, modelFirst);
+            const auto last = toIterator(map, model, modelLast);
+            model.erase(modelFirst, modelLast);
+            ASSERT_EQ(size_t(expectedRemoved), map.erase(first, last));
+        }
+
+        assertSameContents(model, map);
+    }
+
+    // Removing everything leaves an empty map which can be filled again
+    ASSERT_EQ(model.size(), map.erase(map.begin(), map.end()));
+    ASSERT(map.empty());
+    map.insert({makeKey(1), nullptr});
+    ASSERT_EQ(1U, map.size());
+}
+
+TEST(ChunkInfoMapTest, ModifyingCopyDoesNotAffectOriginal) {
+    ChunkInfoMap original(4);
+    ModelMap model;
+    for (int i = 0; i < 100; ++i) {
+        original.insert({makeKey(i), nullptr});
+        model.emplace(makeKey(i), nullptr);
+    }
+
+    ChunkInfoMap copy = original;
+    copy.erase(copy.lower_bound(makeKey(10)), copy.lower_bound(makeKey(50)));
+    copy.insert({makeKey(1000), nullptr});
+    copy.erase(copy.begin(), copy.lower_bound(makeKey(3)));
+
+    assertSameContents(model, original);
+    ASSERT_EQ(100U - 40U + 1U - 3U, copy.size());
+    ASSERT_EQ(makeKey(3), copy.begin()->first);
+    ASSERT_EQ(makeKey(9), std::prev(copy.lower_bound(makeKey(10)))->first);
+    ASSERT_EQ(makeKey(50), copy.lower_bound(makeKey(10))->first);
+}
+
+TEST(ChunkInfoMapTest, IteratorsRemainValidWhenMapIsMoved) {
+    ChunkInfoMap map(4);
+    for (int i = 0; i < 20; ++i) {
+        map.insert({makeKey(i), nullptr});
+    }
+
+    const auto it = map.lower_bound(makeKey(7));
+    const ChunkInfoMap moved = std::move(map);
+    ASSERT_EQ(makeKey(7), it->first);
+    ASSERT(std::next(it, 13) == moved.end());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,8 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/hasher.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/index_bounds_builder.h"
@@ -56,6 +58,14 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     }
 }
 
+bool allElementsAreOfType(BSONType type, const BSONObj& o) {
+    for (auto&& element : o) {
+        if (element.type() != type)
+            return false;
+    }
+    return true;
+}
+
 std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering ordering) {
     BSONObjBuilder strippedKeyValue;
     for (const auto& elem : shardKeyValue) {
@@ -74,6 +84,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          std::unique_ptr<CollatorInterface> defaultCollator,
                                          bool unique,
                                          ChunkInfoMap chunkMap,
+                                         ShardVersionMap shardVersions,
                                          ChunkVersion collectionVersion)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
@@ -83,8 +94,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
       _chunkMap(std::move(chunkMap)),
-      _shardVersions(
-          _constructShardVersionMap(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _shardVersions(std::move(shardVersions)),
       _collectionVersion(collectionVersion) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
@@ -107,6 +117,39 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj
     return Chunk(*(it->second), _clusterTime);
 }
 
+std::vector<boost::optional<Chunk>> ChunkManager::findIntersectingChunksWithSimpleCollation(
+    const std::vector<BSONObj>& shardKeys) const {
+    std::vector<std::pair<std::string, size_t>> sortedKeyStrings;
+    sortedKeyStrings.reserve(shardKeys.size());
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        if (!shardKeys[i].isEmpty()) {
+            sortedKeyStrings.emplace_back(_rt->_extractKeyString(shardKeys[i]), i);
+        }
+    }
+    std::sort(sortedKeyStrings.begin(), sortedKeyStrings.end());
+
+    const auto& chunkMap = _rt->getChunkMap();
+    auto it = chunkMap.end();
+
+    std::vector<boost::optional<Chunk>> chunks(shardKeys.size());
+    for (const auto& keyString : sortedKeyStrings) {
+        // The keys are visited in increasing order, so a key below the max of the chunk of the
+        // previous key belongs to that same chunk
+        if (it == chunkMap.end() || !(keyString.first < it->first)) {
+            it = chunkMap.upper_bound(keyString.first);
+        }
+
+        const auto& shardKey = shardKeys[keyString.second];
+        uassert(ErrorCodes::ShardKeyNotFound,
+                str::stream() << "Cannot target single shard using key " << shardKey,
+                it != chunkMap.end() && it->second->containsKey(shardKey));
+
+        chunks[keyString.second].emplace(*(it->second), _clusterTime);
+    }
+
+    return chunks;
+}
+
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
@@ -153,6 +196,12 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
         }
     }
 
+    // Fast path for a $in on a hashed shard key, which avoids planning the query to expand the
+    // hash of every value into index bounds.
+    if (_getShardIdsForHashedIn(*cq, shardIds)) {
+        return;
+    }
+
     // Transforms query into bounds for each field in the shard key
     // for example :
     //   Key { a: 1, b: 1 },
@@ -185,6 +234,58 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     }
 }
 
+bool ChunkManager::_getShardIdsForHashedIn(const CanonicalQuery& cq,
+                                           std::set<ShardId>* shardIds) const {
+    const auto& shardKeyPattern = _rt->getShardKeyPattern();
+    if (!shardKeyPattern.isHashedPattern()) {
+        return false;
+    }
+    const StringData shardKeyField = shardKeyPattern.toBSON().firstElementFieldName();
+
+    // The $in may be ANDed with other predicates, which can only narrow the set of shards.
+    const auto findIn = [shardKeyField](const MatchExpression* expr) -> const InMatchExpression* {
+        if (expr->matchType() == MatchExpression::MATCH_IN && expr->path() == shardKeyField) {
+            return static_cast<const InMatchExpression*>(expr);
+        }
+        return nullptr;
+    };
+    const MatchExpression* root = cq.root();
+    const InMatchExpression* in = findIn(root);
+    if (!in && root->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < root->numChildren() && !in; ++i) {
+            in = findIn(root->getChild(i));
+        }
+    }
+
+    // Null also matches documents missing the shard key, and the hashes of strings compared with
+    // a non-simple collation do not match the collation's notion of equality, so leave those
+    // queries to the general path.
+    if (!in || !in->getRegexes().empty() || in->hasNull() || in->getEqualities().empty()) {
+        return false;
+    }
+    for (const auto& value : in->getEqualities()) {
+        if (value.type() == Array || value.type() == Undefined ||
+            (cq.getCollator() && CollationIndexKey::isCollatableType(value.type()))) {
+            return false;
+        }
+    }
+
+    std::set<ShardId> targeted;
+    for (const auto& value : in->getEqualities()) {
+        const auto hash = BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED);
+        const auto chunk = findIntersectingChunkWithSimpleCollation(BSON(shardKeyField << hash));
+        targeted.insert(chunk.getShardId());
+
+        // Once every shard is targeted the remaining values cannot add any.
+        if (targeted.size() == _rt->_shardVersions.size()) {
+            break;
+        }
+    }
+
+    shardIds->insert(targeted.begin(), targeted.end());
+    return true;
+}
+
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
@@ -481,6 +582,60 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
     return shardVersions;
 }
 
+boost::optional<ShardVersionMap> RoutingTableHistory::_updateShardVersionMap(
+    const ChunkInfoMap& chunkMap,
+    const std::vector<std::string>& changedChunkKeys,
+    const std::set<ShardId>& shardsLosingChunks) const {
+    ShardVersionMap shardVersions = _shardVersions;
+    std::set<ShardId> shardsGainingChunks;
+
+    for (const auto& key : changedChunkKeys) {
+        const auto it = chunkMap.lower_bound(key);
+
+        // The chunk may have been replaced by a later change
+        if (it == chunkMap.end() || it->first != key)
+            continue;
+
+        const auto& chunk = it->second;
+
+        // Only the boundaries next to the changed chunks can have changed, so checking those is
+        // equivalent to the full pass over the chunks
+        if (it == chunkMap.begin()) {
+            if (!allElementsAreOfType(MinKey, chunk->getMin()))
+                return boost::none;
+        } else if (!SimpleBSONObjComparator::kInstance.evaluate(std::prev(it)->second->getMax() ==
+                                                                 chunk->getMin())) {
+            return boost::none;
+        }
+
+        const auto next = std::next(it);
+        if (next == chunkMap.end()) {
+            if (!allElementsAreOfType(MaxKey, chunk->getMax()))
+                return boost::none;
+        } else if (!SimpleBSONObjComparator::kInstance.evaluate(next->second->getMin() ==
+                                                                 chunk->getMax())) {
+            return boost::none;
+        }
+
+        const auto& shardId = chunk->getShardIdAt(boost::none);
+        auto& maxShardVersion =
+            shardVersions.emplace(shardId, ChunkVersion(0, 0, _collectionVersion.epoch()))
+                .first->second;
+        if (chunk->getLastmod() > maxShardVersion)
+            maxShardVersion = chunk->getLastmod();
+
+        shardsGainingChunks.insert(shardId);
+    }
+
+    // A shard which only lost chunks may have lost all of them, which requires a full pass to find
+    for (const auto& shardId : shardsLosingChunks) {
+        if (!shardsGainingChunks.count(shardId))
+            return boost::none;
+    }
+
+    return shardVersions;
+}
+
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -499,6 +654,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeNew(
                                std::move(defaultCollator),
                                std::move(unique),
                                {},
+                               {},
                                {0, 0, epoch})
         .makeUpdated(chunks);
 }
@@ -509,6 +665,10 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const auto startingCollectionVersion = getVersion();
     auto chunkMap = _chunkMap;
 
+    // Used to update the shard versions from the changed chunks only
+    std::vector<std::string> changedChunkKeys;
+    std::set<ShardId> shardsLosingChunks;
+
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
         const auto& chunkVersion = chunk.getVersion();
@@ -534,11 +694,17 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         // not overlap max
         const auto high = chunkMap.upper_bound(chunkMaxKeyString);
 
+        for (auto it = low; it != high; ++it) {
+            shardsLosingChunks.insert(it->second->getShardIdAt(boost::none));
+        }
+
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
         chunkMap.erase(low, high);
 
         // Insert only the chunk itself
         chunkMap.insert(std::make_pair(chunkMaxKeyString, std::make_shared<ChunkInfo>(chunk)));
+
+        changedChunkKeys.push_back(chunkMaxKeyString);
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -552,6 +718,16 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         return shared_from_this();
     }
 
+    // Building a routing table from scratch changes every chunk, so the full pass is cheaper
+    boost::optional<ShardVersionMap> shardVersions;
+    if (!_chunkMap.empty()) {
+        shardVersions = _updateShardVersionMap(chunkMap, changedChunkKeys, shardsLosingChunks);
+    }
+    if (!shardVersions) {
+        shardVersions =
+            _constructShardVersionMap(collectionVersion.epoch(), chunkMap, _shardKeyOrdering);
+    }
+
     return std::shared_ptr<RoutingTableHistory>(
         new RoutingTableHistory(_nss,
                                 _uuid,
@@ -559,6 +735,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
                                 CollatorInterface::cloneCollator(getDefaultCollator()),
                                 isUnique(),
                                 std::move(chunkMap),
+                                std::move(*shardVersions),
                                 collectionVersion));
 }
 
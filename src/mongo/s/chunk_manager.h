@@ -37,6 +37,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
+#include "mongo/s/chunk_info_map.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -49,9 +50,6 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
-
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
@@ -157,12 +155,26 @@ private:
                                                      const ChunkInfoMap& chunkMap,
                                                      Ordering shardKeyOrdering);
 
+    /**
+     * Computes the ShardVersionMap for 'chunkMap', which was obtained by replacing the ranges of
+     * the chunks at 'changedChunkKeys' in the chunk map of this routing table, from the versions
+     * of the changed chunks alone. Returns boost::none if that is not possible, because a shard
+     * lost chunks without getting any of the changed ones or because the changed chunks are not
+     * contiguous with their neighbours, in which case a full pass with _constructShardVersionMap
+     * must be used instead.
+     */
+    boost::optional<ShardVersionMap> _updateShardVersionMap(
+        const ChunkInfoMap& chunkMap,
+        const std::vector<std::string>& changedChunkKeys,
+        const std::set<ShardId>& shardsLosingChunks) const;
+
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
                         std::unique_ptr<CollatorInterface> defaultCollator,
                         bool unique,
                         ChunkInfoMap chunkMap,
+                        ShardVersionMap shardVersions,
                         ChunkVersion collectionVersion);
 
     std::string _extractKeyString(const BSONObj& shardKeyValue) const;
@@ -314,6 +326,21 @@ public:
         return _rt->getChunkMap().size();
     }
 
+    /**
+     * Returns whether chunk ownership is that of a past cluster time rather than the latest.
+     */
+    bool isAtClusterTime() const {
+        return bool(_clusterTime);
+    }
+
+    /**
+     * Returns the KeyString of "shardKey", which sorts the same way as the shard key values under
+     * the shard key's ordering and can be compared as a plain string.
+     */
+    std::string extractKeyString(const BSONObj& shardKey) const {
+        return _rt->_extractKeyString(shardKey);
+    }
+
     /**
      * Returns true if a document with the given "shardKey" is owned by the shard with the given
      * "shardId" in this routing table. If "shardKey" is empty returns false. If "shardKey" is not a
@@ -354,6 +381,15 @@ public:
         return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
     }
 
+    /**
+     * Same as findIntersectingChunkWithSimpleCollation for each of 'shardKeys', but looks the keys
+     * up in shard key order, so that all the keys which fall in the same chunk share one lookup.
+     * The result at each position is the chunk of the key at that position, or boost::none if the
+     * key is empty.
+     */
+    std::vector<boost::optional<Chunk>> findIntersectingChunksWithSimpleCollation(
+        const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
@@ -425,6 +461,13 @@ public:
     }
 
 private:
+    /**
+     * If 'cq' constrains a hashed shard key with a $in, adds the shards owning the hash of each of
+     * its values to 'shardIds' and returns true. Returns false, without modifying 'shardIds', if
+     * the query cannot be targeted this way.
+     */
+    bool _getShardIdsForHashedIn(const CanonicalQuery& cq, std::set<ShardId>* shardIds) const;
+
     std::shared_ptr<RoutingTableHistory> _rt;
     boost::optional<Timestamp> _clusterTime;
 };
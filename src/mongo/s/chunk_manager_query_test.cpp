@@ -487,5 +487,70 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksMatchesSingleKeyLookups) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(
+        kNss, shardKeyPattern, nullptr, false, {BSON("a" << 10), BSON("a" << 20), BSON("a" << 30)});
+
+    const std::vector<BSONObj> shardKeys{BSON("a" << 25),
+                                         BSON("a" << 5),
+                                         BSONObj(),
+                                         BSON("a" << 20),
+                                         BSON("a" << 35),
+                                         BSON("a" << 26),
+                                         BSON("a" << 19)};
+    const auto chunks = chunkManager->findIntersectingChunksWithSimpleCollation(shardKeys);
+    ASSERT_EQ(shardKeys.size(), chunks.size());
+
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        if (shardKeys[i].isEmpty()) {
+            ASSERT(!chunks[i]);
+            continue;
+        }
+
+        ASSERT(chunks[i]);
+        const auto expected = chunkManager->findIntersectingChunkWithSimpleCollation(shardKeys[i]);
+        ASSERT_BSONOBJ_EQ(expected.getMin(), chunks[i]->getMin());
+        ASSERT_EQ(expected.getShardId(), chunks[i]->getShardId());
+    }
+}
+
+TEST_F(ChunkManagerQueryTest, HashedInTargetsTheShardsOfEachValue) {
+    const ShardKeyPattern shardKeyPattern(BSON("a"
+                                               << "hashed"));
+    auto chunkManager = makeChunkManager(
+        kNss,
+        shardKeyPattern,
+        nullptr,
+        false,
+        {BSON("a" << -(1LL << 62)), BSON("a" << 0LL), BSON("a" << (1LL << 62))});
+
+    for (int numValues = 1; numValues <= 8; ++numValues) {
+        BSONArrayBuilder values;
+        BSONArrayBuilder equalities;
+        std::set<ShardId> expected;
+        for (int i = 0; i < numValues; ++i) {
+            values.append(i);
+            equalities.append(BSON("a" << i));
+            const auto shardKey = shardKeyPattern.extractShardKeyFromDoc(BSON("a" << i));
+            expected.insert(
+                chunkManager->findIntersectingChunkWithSimpleCollation(shardKey).getShardId());
+        }
+
+        std::set<ShardId> inShardIds;
+        chunkManager->getShardIdsForQuery(operationContext(),
+                                          BSON("a" << BSON("$in" << values.arr()) << "b" << 1),
+                                          BSONObj(),
+                                          &inShardIds);
+        ASSERT(expected == inShardIds);
+
+        // The same values targeted through the query planner.
+        std::set<ShardId> orShardIds;
+        chunkManager->getShardIdsForQuery(
+            operationContext(), BSON("$or" << equalities.arr()), BSONObj(), &orShardIds);
+        ASSERT(expected == orShardIds);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
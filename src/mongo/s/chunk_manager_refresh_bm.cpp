@@ -120,7 +120,42 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
+
+void BM_IncrementalRefreshWithSplits(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    const int nSplits = state.range(2);
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    // Split evenly spread chunks in two, which changes 2 * nSplits chunks all on the same shards
+    auto version = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    std::vector<ChunkType> newChunks;
+    for (int i = 0; i < nSplits; ++i) {
+        const int chunkNum = 1 + int64_t(i) * (nChunks - 2) / nSplits;
+        const auto range = getRangeForChunk(chunkNum, nChunks);
+        const auto splitPoint = BSON("_id" << range.getMin()["_id"].numberInt() + 50);
+        const auto shardId = optimalShardSelector(chunkNum, nShards, nChunks);
+
+        version.incMinor();
+        newChunks.emplace_back(collName, ChunkRange(range.getMin(), splitPoint), version, shardId);
+        version.incMinor();
+        newChunks.emplace_back(collName, ChunkRange(splitPoint, range.getMax()), version, shardId);
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
+BENCHMARK(BM_IncrementalRefreshWithSplits)
+    ->Args({2, 50000, 1})
+    ->Args({2, 50000, 100})
+    ->Args({2, 500000, 1})
+    ->Args({2, 500000, 100});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
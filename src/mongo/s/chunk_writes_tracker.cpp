@@ -36,11 +36,63 @@
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
+namespace {
+
+/**
+ * The splitmix64 finalizer, used as a cheap stateless pseudo-random number generator so that
+ * threads sampling keys concurrently do not need to share generator state.
+ */
+uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}  // namespace
 
 uint64_t ChunkWritesTracker::clearBytesWritten() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+        _sampledKeys.clear();
+        _numKeysSeen.store(0);
+    }
     return _bytesWritten.swap(0);
 }
 
+void ChunkWritesTracker::sampleKey(const BSONObj& shardKey) {
+    // Reservoir sampling: the n-th key replaces a random slot with probability k/n.
+    const uint64_t seen = _numKeysSeen.fetchAndAdd(1);
+    uint64_t slot = seen;
+    if (seen >= kMaxSampledKeys) {
+        slot = mix64(seen) % (seen + 1);
+        if (slot >= kMaxSampledKeys) {
+            return;
+        }
+    }
+
+    BSONObj ownedKey = shardKey.getOwned();
+
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+    if (_sampledKeys.size() <= slot) {
+        _sampledKeys.resize(slot + 1);
+    }
+    _sampledKeys[slot] = std::move(ownedKey);
+}
+
+std::vector<BSONObj> ChunkWritesTracker::getSampledKeys() {
+    std::vector<BSONObj> keys;
+
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+    keys.reserve(_sampledKeys.size());
+    for (const auto& key : _sampledKeys) {
+        if (!key.isEmpty()) {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
 bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     if (_isLockedForSplitting) {
         return false;
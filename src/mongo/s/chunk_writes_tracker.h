@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
@@ -42,6 +45,11 @@ public:
      */
     static constexpr uint64_t kSplitTestFactor = 5;
 
+    /**
+     * The maximum number of shard keys kept in the sample of keys written to the chunk.
+     */
+    static constexpr size_t kMaxSampledKeys = 32;
+
     /**
      * Add more bytes written to the chunk.
      */
@@ -56,9 +64,21 @@ public:
         return _bytesWritten.loadRelaxed();
     }
 
+    /**
+     * Offers the shard key of a document written to the chunk to a fixed size, uniformly
+     * distributed sample of the keys written since the tracker was last cleared. Only takes a
+     * mutex when the key is kept in the sample.
+     */
+    void sampleKey(const BSONObj& shardKey);
+
+    /**
+     * Returns a copy of the sampled shard keys, in no particular order.
+     */
+    std::vector<BSONObj> getSampledKeys();
+
     /**
      * Sets the number of bytes in the tracker to zero and returns the number
-     * of bytes in the tracker prior to clearing it.
+     * of bytes in the tracker prior to clearing it. Also discards the sampled shard keys.
      */
     uint64_t clearBytesWritten();
 
@@ -95,6 +115,22 @@ private:
      * Whether or not a current split is in progress for this chunk.
      */
     bool _isLockedForSplitting{false};
+
+    /**
+     * The number of keys offered to sampleKey since the sample was last cleared.
+     */
+    AtomicUInt64 _numKeysSeen{0};
+
+    /**
+     * Protects _sampledKeys.
+     */
+    stdx::mutex _sampleMutex;
+
+    /**
+     * A reservoir sample of the shard keys written to the chunk. Slots which a concurrent
+     * sampleKey has reserved but not yet filled hold empty objects.
+     */
+    std::vector<BSONObj> _sampledKeys;
 };
 
 }  // namespace mongo
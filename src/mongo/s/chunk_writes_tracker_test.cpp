@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/s/chunk_writes_tracker.h"
 
 #include "mongo/unittest/death_test.h"
@@ -143,6 +144,59 @@ TEST(ChunkWritesTrackerTest, AcquireSplitLockThenReleaseThenReacquireReturnsTrue
     ASSERT_TRUE(wt.acquireSplitLock());
 }
 
+TEST(ChunkWritesTrackerTest, SampledKeysStartEmpty) {
+    ChunkWritesTracker wt;
+    ASSERT(wt.getSampledKeys().empty());
+}
+
+TEST(ChunkWritesTrackerTest, SampleKeyKeepsAllKeysUntilTheSampleIsFull) {
+    ChunkWritesTracker wt;
+    for (int i = 0; i < 3; i++) {
+        wt.sampleKey(BSON("a" << i));
+    }
+
+    auto keys = wt.getSampledKeys();
+    ASSERT_EQ(keys.size(), 3u);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_BSONOBJ_EQ(keys[i], BSON("a" << i));
+    }
+}
+
+TEST(ChunkWritesTrackerTest, SampleKeyKeepsAtMostMaxSampledKeys) {
+    ChunkWritesTracker wt;
+    const int numKeys = 100 * ChunkWritesTracker::kMaxSampledKeys;
+    for (int i = 0; i < numKeys; i++) {
+        wt.sampleKey(BSON("a" << i));
+    }
+
+    auto keys = wt.getSampledKeys();
+    ASSERT_EQ(keys.size(), ChunkWritesTracker::kMaxSampledKeys);
+
+    // The sample should not be stuck on the first keys written.
+    int numLaterKeys = 0;
+    for (const auto& key : keys) {
+        const int value = key["a"].numberInt();
+        ASSERT_GTE(value, 0);
+        ASSERT_LT(value, numKeys);
+        if (value >= static_cast<int>(ChunkWritesTracker::kMaxSampledKeys)) {
+            numLaterKeys++;
+        }
+    }
+    ASSERT_GT(numLaterKeys, 0);
+}
+
+TEST(ChunkWritesTrackerTest, ClearBytesWrittenDiscardsSampledKeys) {
+    ChunkWritesTracker wt;
+    wt.sampleKey(BSON("a" << 1));
+    wt.clearBytesWritten();
+    ASSERT(wt.getSampledKeys().empty());
+
+    wt.sampleKey(BSON("a" << 2));
+    auto keys = wt.getSampledKeys();
+    ASSERT_EQ(keys.size(), 1u);
+    ASSERT_BSONOBJ_EQ(keys[0], BSON("a" << 2));
+}
+
 DEATH_TEST(ChunkWritesTrackerTest, ReleaseSplitLockWithoutAcquiringErrors, "Invariant failure") {
     ChunkWritesTracker wt;
     wt.releaseSplitLock();
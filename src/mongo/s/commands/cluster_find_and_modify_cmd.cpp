@@ -44,8 +44,10 @@
 #include "mongo/s/commands/cluster_explain.h"
 #include "mongo/s/commands/strategy.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/write_ops/cluster_write.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -159,6 +161,9 @@ public:
         // that the parsing be pulled into this function.
         uassertStatusOK(createShardDatabase(opCtx, nss.db()));
 
+        // The modified document may be in the cached results of queries on the namespace
+        ON_BLOCK_EXIT([&] { ClusterQueryResultCache::get(opCtx)->invalidate(nss); });
+
         const auto routingInfo =
             uassertStatusOK(Grid::get(opCtx)->catalogCache()->getCollectionRoutingInfo(opCtx, nss));
         if (!routingInfo.cm()) {
@@ -185,6 +185,94 @@ boost::optional<Document> PipelineS::MongoSInterface::lookupSingleDocument(
     return (!batch.empty() ? Document(batch.front()) : boost::optional<Document>{});
 }
 
+std::vector<boost::optional<Document>> PipelineS::MongoSInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+
+    std::vector<RemoteCursor> shardResults;
+    size_t numAttempts = 0;
+    while (++numAttempts <= kMaxNumStaleVersionRetries) {
+        // Verify that the collection exists, with the correct UUID.
+        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+        auto swRoutingInfo = getCollectionRoutingInfo(foreignExpCtx);
+        if (swRoutingInfo == ErrorCodes::NamespaceNotFound) {
+            return std::vector<boost::optional<Document>>(documentKeys.size());
+        }
+        auto routingInfo = uassertStatusOK(std::move(swRoutingInfo));
+
+        // Group the keys by the shard which owns them, so that each shard is sent a single find.
+        std::map<ShardId, std::pair<ChunkVersion, BSONArrayBuilder>> keysByShard;
+        for (auto&& documentKey : documentKeys) {
+            auto keyObj = documentKey.toBson();
+            auto shardInfo = getSingleTargetedShardForQuery(expCtx->opCtx, routingInfo, keyObj);
+            auto& shardKeys = keysByShard[shardInfo.first];
+            shardKeys.first = shardInfo.second;
+            shardKeys.second.append(keyObj);
+        }
+
+        // Find by UUID and shard versioning do not work together (SERVER-31946), so find by UUID
+        // only when the collection is unsharded, as in lookupSingleDocument().
+        std::vector<std::pair<ShardId, BSONObj>> requests;
+        for (auto&& shardKeys : keysByShard) {
+            BSONObjBuilder cmdBuilder;
+            if (foreignExpCtx->uuid && !routingInfo.cm()) {
+                foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
+            } else {
+                cmdBuilder.append("find", nss.coll());
+            }
+            const int numKeys = shardKeys.second.second.arrSize();
+            cmdBuilder.append("filter", BSON("$or" << shardKeys.second.second.arr()));
+            cmdBuilder.append("batchSize", numKeys);
+            cmdBuilder.append("singleBatch", true);
+            cmdBuilder.append("comment", expCtx->comment);
+            if (readConcern) {
+                cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
+            }
+            requests.emplace_back(shardKeys.first,
+                                  appendShardVersion(cmdBuilder.obj(), shardKeys.second.first));
+        }
+
+        try {
+            shardResults = establishCursors(
+                expCtx->opCtx,
+                Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                nss,
+                ReadPreferenceSetting::get(expCtx->opCtx),
+                requests,
+                false);
+            break;
+        } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+            return std::vector<boost::optional<Document>>(documentKeys.size());
+        } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>&) {
+            // If we hit a stale shardVersion exception, invalidate the routing table cache.
+            catalogCache->onStaleShardVersion(std::move(routingInfo));
+            continue;  // Try again if allowed.
+        }
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    for (auto&& shardResult : shardResults) {
+        for (auto&& obj : shardResult.getCursorResponse().getBatch()) {
+            lookedUpDocuments.emplace_back(obj);
+        }
+    }
+    auto results = matchDocumentKeys(foreignExpCtx, documentKeys, lookedUpDocuments);
+
+    // A key has no result if its document was deleted, or if a shard's batch was cut short by the
+    // size limit on a reply. Look up those keys one at a time to tell the two apart.
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i]) {
+            results[i] = lookupSingleDocument(
+                expCtx, nss, collectionUUID, documentKeys[i], readConcern);
+        }
+    }
+    return results;
+}
+
 BSONObj PipelineS::MongoSInterface::_reportCurrentOpForClient(
     OperationContext* opCtx, Client* client, CurrentOpTruncateMode truncateOps) const {
     BSONObjBuilder builder;
@@ -58,6 +58,13 @@ public:
             const Document& documentKey,
             boost::optional<BSONObj> readConcern) final;
 
+        std::vector<boost::optional<Document>> lookupDocuments(
+            const boost::intrusive_ptr<ExpressionContext>& expCtx,
+            const NamespaceString& nss,
+            UUID collectionUUID,
+            const std::vector<Document>& documentKeys,
+            boost::optional<BSONObj> readConcern) final;
+
         std::vector<GenericCursor> getCursors(
             const boost::intrusive_ptr<ExpressionContext>& expCtx) const final;
 
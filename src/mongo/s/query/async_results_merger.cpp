@@ -38,6 +38,8 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -53,6 +55,22 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// When enabled, the next batch of a non-tailable remote cursor is requested once half of its last
+// batch has been returned, so that the getMore overlaps with merging the rest of the batch.
+MONGO_EXPORT_SERVER_PARAMETER(asyncResultsMergerPrefetchGetMores, bool, false);
+
+/**
+ * Returns the ordering used to encode the sort keys of a merge with the given parameters as
+ * KeyStrings, or boost::none if the merge is not sorted or if its sort pattern has more fields
+ * than an Ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const AsyncResultsMergerParams& params) {
+    if (!params.getSort() || params.getSort()->nFields() > 32) {
+        return boost::none;
+    }
+    return Ordering::make(*params.getSort());
+}
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. This object is of the form
  * {'': 'firstSortKey', '': 'secondSortKey', ...}.
@@ -91,9 +109,11 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       _tailableMode(params.getTailableMode() ? *params.getTailableMode()
                                              : TailableModeEnum::kNormal),
       _params(std::move(params)),
+      _sortKeyOrdering(makeSortKeyOrdering(_params)),
       _mergeQueue(MergingComparator(_remotes,
                                     _params.getSort() ? *_params.getSort() : BSONObj(),
-                                    _params.getCompareWholeSortKey())) {
+                                    _params.getCompareWholeSortKey(),
+                                    static_cast<bool>(_sortKeyOrdering))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
@@ -106,7 +126,10 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
 
         // We don't check the return value of _addBatchToBuffer here; if there was an error,
         // it will be stored in the remote and the first call to ready() will return true.
-        _addBatchToBuffer(WithLock::withoutLock(), remoteIndex, remote.getCursorResponse());
+        _addBatchToBuffer(WithLock::withoutLock(),
+                          remoteIndex,
+                          remote.getCursorResponse(),
+                          _encodeSortKeys(remote.getCursorResponse()));
         ++remoteIndex;
     }
 }
@@ -277,7 +300,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -293,6 +316,9 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_sortKeyOrdering) {
+        _remotes[smallestRemote].encodedSortKeys.pop();
+    }
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -300,10 +326,11 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
         _mergeQueue.push(smallestRemote);
     }
 
+    _prefetchNextBatchIfNeeded(lk, smallestRemote);
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -321,6 +348,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _prefetchNextBatchIfNeeded(lk, _gettingFromRemote);
             return front;
         }
 
@@ -376,8 +404,12 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
 
     auto callbackStatus =
         _executor->scheduleRemoteCommand(request, [this, remoteIndex](auto const& cbData) {
+            // Parse the batch before taking the mutex, so that the batches of several remotes can
+            // be parsed at the same time by the executor's threads.
+            auto parsedBatch = this->_parseBatch(cbData.response);
+
             stdx::lock_guard<stdx::mutex> lk(this->_mutex);
-            this->_handleBatchResponse(lk, cbData, remoteIndex);
+            this->_handleBatchResponse(lk, cbData, std::move(parsedBatch), remoteIndex);
         });
 
     if (!callbackStatus.isOK()) {
@@ -458,25 +490,59 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
     return eventToReturn;
 }
 
-StatusWith<CursorResponse> AsyncResultsMerger::_parseCursorResponse(
-    const BSONObj& responseObj, const RemoteCursorData& remote) {
+StatusWith<AsyncResultsMerger::ParsedBatch> AsyncResultsMerger::_parseBatch(
+    const CbResponse& response) const {
+    if (!response.isOK()) {
+        return response.status;
+    }
 
-    auto getMoreParseStatus = CursorResponse::parseFromBSON(responseObj);
+    auto getMoreParseStatus = CursorResponse::parseFromBSON(response.data);
     if (!getMoreParseStatus.isOK()) {
         return getMoreParseStatus.getStatus();
     }
 
-    auto cursorResponse = std::move(getMoreParseStatus.getValue());
+    auto encodedSortKeys = _encodeSortKeys(getMoreParseStatus.getValue());
+    return ParsedBatch{std::move(getMoreParseStatus.getValue()), std::move(encodedSortKeys)};
+}
 
-    // If we get a non-zero cursor id that is not equal to the established cursor id, we will fail
-    // the operation.
-    if (cursorResponse.getCursorId() != 0 && remote.cursorId != cursorResponse.getCursorId()) {
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Expected cursorid " << remote.cursorId << " but received "
-                                    << cursorResponse.getCursorId());
+StatusWith<std::vector<std::string>> AsyncResultsMerger::_encodeSortKeys(
+    const CursorResponse& response) const {
+    std::vector<std::string> encodedSortKeys;
+    if (!_params.getSort()) {
+        return encodedSortKeys;
+    }
+
+    if (_sortKeyOrdering) {
+        encodedSortKeys.reserve(response.getBatch().size());
     }
 
-    return std::move(cursorResponse);
+    KeyString encodedKey(KeyString::Version::V1);
+    for (const auto& obj : response.getBatch()) {
+        // If there's a sort, we're expecting the remote node to have given us back a sort key.
+        auto key = obj[AsyncResultsMerger::kSortKeyField];
+        if (!key) {
+            return Status(ErrorCodes::InternalError,
+                          str::stream() << "Missing field '" << AsyncResultsMerger::kSortKeyField
+                                        << "' in document: "
+                                        << obj);
+        } else if (!_params.getCompareWholeSortKey() && key.type() != BSONType::Object) {
+            return Status(ErrorCodes::InternalError,
+                          str::stream() << "Field '" << AsyncResultsMerger::kSortKeyField
+                                        << "' was not of type Object in document: "
+                                        << obj);
+        }
+
+        if (_sortKeyOrdering) {
+            // KeyStrings compare in the same order as the sort keys do under the sort pattern.
+            // Strings need no collator, since mongod has already mapped them to their ICU
+            // comparison keys as part of the $sortKey meta projection.
+            encodedKey.resetToKey(extractSortKey(obj, _params.getCompareWholeSortKey()),
+                                  *_sortKeyOrdering);
+            encodedSortKeys.emplace_back(encodedKey.getBuffer(), encodedKey.getSize());
+        }
+    }
+
+    return encodedSortKeys;
 }
 
 void AsyncResultsMerger::updateRemoteMetadata(RemoteCursorData* remote,
@@ -525,6 +591,7 @@ void AsyncResultsMerger::updateRemoteMetadata(RemoteCursorData* remote,
 
 void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
                                               CbData const& cbData,
+                                              StatusWith<ParsedBatch> parsedBatch,
                                               size_t remoteIndex) {
     // Got a response from remote, so indicate we are no longer waiting for one.
     _remotes[remoteIndex].cbHandle = executor::TaskExecutor::CallbackHandle();
@@ -536,7 +603,7 @@ void AsyncResultsMerger::_handleBatchResponse(WithLock lk,
         return;
     }
     try {
-        _processBatchResults(lk, cbData.response, remoteIndex);
+        _processBatchResults(lk, std::move(parsedBatch), remoteIndex);
     } catch (DBException const& e) {
         _remotes[remoteIndex].status = e.toStatus();
     }
@@ -566,34 +633,42 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
     if (_params.getAllowPartialResults()) {
         remote.status = Status::OK();
 
-        // Clear the results buffer and cursor id.
-        std::queue<ClusterQueryResult> emptyBuffer;
-        std::swap(remote.docBuffer, emptyBuffer);
+        // Clear the cursor id. Any results still buffered, which happens if this was a prefetched
+        // batch, were retrieved successfully and are still returned; this also keeps them on
+        // '_mergeQueue' consistent with the buffer.
         remote.cursorId = 0;
     }
 }
 
 void AsyncResultsMerger::_processBatchResults(WithLock lk,
-                                              CbResponse const& response,
+                                              StatusWith<ParsedBatch> parsedBatch,
                                               size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
-    if (!response.isOK()) {
-        _cleanUpFailedBatch(lk, response.status, remoteIndex);
+    if (!parsedBatch.isOK()) {
+        _cleanUpFailedBatch(lk, parsedBatch.getStatus(), remoteIndex);
         return;
     }
-    auto cursorResponseStatus = _parseCursorResponse(response.data, remote);
-    if (!cursorResponseStatus.isOK()) {
-        _cleanUpFailedBatch(lk, cursorResponseStatus.getStatus(), remoteIndex);
+
+    CursorResponse cursorResponse = std::move(parsedBatch.getValue().cursorResponse);
+
+    // If we get a non-zero cursor id that is not equal to the established cursor id, we will fail
+    // the operation.
+    if (cursorResponse.getCursorId() != 0 && remote.cursorId != cursorResponse.getCursorId()) {
+        _cleanUpFailedBatch(lk,
+                            Status(ErrorCodes::BadValue,
+                                   str::stream() << "Expected cursorid " << remote.cursorId
+                                                 << " but received "
+                                                 << cursorResponse.getCursorId()),
+                            remoteIndex);
         return;
     }
 
-    CursorResponse cursorResponse = std::move(cursorResponseStatus.getValue());
-
     // Update the cursorId; it is sent as '0' when the cursor has been exhausted on the shard.
     remote.cursorId = cursorResponse.getCursorId();
 
     // Save the batch in the remote's buffer.
-    if (!_addBatchToBuffer(lk, remoteIndex, cursorResponse)) {
+    if (!_addBatchToBuffer(
+            lk, remoteIndex, cursorResponse, std::move(parsedBatch.getValue().encodedSortKeys))) {
         return;
     }
 
@@ -617,43 +692,52 @@ void AsyncResultsMerger::_processBatchResults(WithLock lk,
 
 bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
-                                           const CursorResponse& response) {
+                                           const CursorResponse& response,
+                                           StatusWith<std::vector<std::string>> encodedSortKeys) {
     auto& remote = _remotes[remoteIndex];
     updateRemoteMetadata(&remote, response);
-    for (const auto& obj : response.getBatch()) {
-        // If there's a sort, we're expecting the remote node to have given us back a sort key.
-        if (_params.getSort()) {
-            auto key = obj[AsyncResultsMerger::kSortKeyField];
-            if (!key) {
-                remote.status =
-                    Status(ErrorCodes::InternalError,
-                           str::stream() << "Missing field '" << AsyncResultsMerger::kSortKeyField
-                                         << "' in document: "
-                                         << obj);
-                return false;
-            } else if (!_params.getCompareWholeSortKey() && key.type() != BSONType::Object) {
-                remote.status =
-                    Status(ErrorCodes::InternalError,
-                           str::stream() << "Field '" << AsyncResultsMerger::kSortKeyField
-                                         << "' was not of type Object in document: "
-                                         << obj);
-                return false;
-            }
-        }
+    if (!encodedSortKeys.isOK()) {
+        remote.status = encodedSortKeys.getStatus();
+        return false;
+    }
+
+    // A remote which still has buffered results, because this batch was prefetched, is already on
+    // the merge queue.
+    const bool wasDrained = !remote.hasNext();
 
+    for (const auto& obj : response.getBatch()) {
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
     }
+    for (auto& encodedSortKey : encodedSortKeys.getValue()) {
+        remote.encodedSortKeys.push(std::move(encodedSortKey));
+    }
+    remote.lastBatchSize = response.getBatch().size();
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
+    if (_params.getSort() && wasDrained && !response.getBatch().empty()) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
 }
 
+void AsyncResultsMerger::_prefetchNextBatchIfNeeded(WithLock lk, size_t remoteIndex) {
+    if (!asyncResultsMergerPrefetchGetMores.load() || _tailableMode != TailableModeEnum::kNormal ||
+        _lifecycleState != kAlive || !_opCtx) {
+        return;
+    }
+
+    auto& remote = _remotes[remoteIndex];
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        remote.docBuffer.size() * 2 > remote.lastBatchSize) {
+        return;
+    }
+
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 void AsyncResultsMerger::_signalCurrentEventIfReady(WithLock lk) {
     if (_ready(lk) && _currentEvent.isValid()) {
         // To prevent ourselves from signalling the event twice, we set '_currentEvent' as
@@ -761,6 +845,10 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    if (_compareEncodedSortKeys) {
+        return _remotes[lhs].encodedSortKeys.front() > _remotes[rhs].encodedSortKeys.front();
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
@@ -30,12 +30,15 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/query/cursor_response.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
@@ -46,8 +49,6 @@
 
 namespace mongo {
 
-class CursorResponse;
-
 /**
  * Given a set of cursorIds across one or more shards, the AsyncResultsMerger calls getMore on the
  * cursors to present a single sorted or unsorted stream of documents.
@@ -67,6 +68,10 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * Responses are parsed on the executor thread which receives them before the ARM's mutex is taken,
+ * and for a sorted merge the sort key of each result is encoded then as a KeyString, so that the
+ * merge compares results with memcmp.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -291,6 +296,14 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The KeyString encoded sort keys of the results in 'docBuffer', in the same order. Only
+        // filled when the results are merged in sort order using KeyString comparisons.
+        std::queue<std::string> encodedSortKeys;
+
+        // The number of results in the last batch received from this remote. Used to decide when
+        // to prefetch the next batch.
+        size_t lastBatchSize = 0;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -307,8 +320,12 @@ private:
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareEncodedSortKeys)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareEncodedSortKeys(compareEncodedSortKeys) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -321,17 +338,42 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When '_compareEncodedSortKeys' is true, the remotes' KeyString encoded sort keys are
+        // compared instead of their $sortKey fields.
+        const bool _compareEncodedSortKeys;
+    };
+
+    /**
+     * A batch received from a remote, parsed outside of the ARM's mutex.
+     */
+    struct ParsedBatch {
+        CursorResponse cursorResponse;
+
+        // The KeyString encoded sort keys of the batch's results or the error found while
+        // extracting them. See _encodeSortKeys().
+        StatusWith<std::vector<std::string>> encodedSortKeys;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
 
+    using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
+    using CbResponse = executor::TaskExecutor::ResponseStatus;
+
     /**
-     * Parses the find or getMore command response object to a CursorResponse.
+     * Parses the find or getMore command response to a CursorResponse and encodes the sort keys of
+     * its results. Only reads '_params', so it does not need the ARM's mutex.
      *
-     * Returns a non-OK response if the response fails to parse or if there is a cursor id mismatch.
+     * Returns a non-OK response if the remote command failed or if the response fails to parse.
+     */
+    StatusWith<ParsedBatch> _parseBatch(const CbResponse& response) const;
+
+    /**
+     * Checks that each result in 'response' has a sort key if the merge is sorted, and returns
+     * their KeyString encodings if the merge compares encoded sort keys. Returns no keys for an
+     * unsorted merge. Only reads '_params', so it does not need the ARM's mutex.
      */
-    static StatusWith<CursorResponse> _parseCursorResponse(const BSONObj& responseObj,
-                                                           const RemoteCursorData& remote);
+    StatusWith<std::vector<std::string>> _encodeSortKeys(const CursorResponse& response) const;
 
     /**
      * Helper to schedule a command asking the remote node for another batch of results.
@@ -364,9 +406,6 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
-    using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
-    using CbResponse = executor::TaskExecutor::ResponseStatus;
-
     /**
      * When nextEvent() schedules remote work, the callback uses this function to process results.
      *
@@ -374,7 +413,10 @@ private:
      * indicates which node the response came from and where the new result documents should be
      * buffered.
      */
-    void _handleBatchResponse(WithLock, CbData const&, size_t remoteIndex);
+    void _handleBatchResponse(WithLock,
+                              CbData const&,
+                              StatusWith<ParsedBatch> parsedBatch,
+                              size_t remoteIndex);
 
     /**
      * Cleans up if the remote cursor was killed while waiting for a response.
@@ -389,13 +431,22 @@ private:
     /**
      * Processes results from a remote query.
      */
-    void _processBatchResults(WithLock, CbResponse const&, size_t remoteIndex);
+    void _processBatchResults(WithLock, StatusWith<ParsedBatch> parsedBatch, size_t remoteIndex);
 
     /**
-     * Adds the batch of results to the RemoteCursorData. Returns false if there was an error
-     * parsing the batch.
+     * Adds the batch of results and their encoded sort keys to the RemoteCursorData. Returns false
+     * if there was an error extracting the sort keys of the batch.
      */
-    bool _addBatchToBuffer(WithLock, size_t remoteIndex, const CursorResponse& response);
+    bool _addBatchToBuffer(WithLock,
+                           size_t remoteIndex,
+                           const CursorResponse& response,
+                           StatusWith<std::vector<std::string>> encodedSortKeys);
+
+    /**
+     * If prefetching is enabled, asks the remote for its next batch once it has returned at least
+     * half of its last batch, rather than waiting for its buffer to drain.
+     */
+    void _prefetchNextBatchIfNeeded(WithLock, size_t remoteIndex);
 
     /**
      * If there is a valid unsignaled event that has been requested via nextEvent() and there are
@@ -432,6 +483,11 @@ private:
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // The ordering used to encode sort keys as KeyStrings. Is boost::none if there is no sort or
+    // if the sort pattern has too many fields for an Ordering, in which case the merge compares
+    // the $sortKey fields of the results.
+    const boost::optional<Ordering> _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     stdx::mutex _mutex;
 
@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
@@ -45,6 +46,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -631,6 +633,75 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortKeysOfDifferentTypesMergeInBSONOrder) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1}}");
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 'b'}}"),
+                                   fromjson("{$sortKey: {'': {$numberLong: '3'}}}"),
+                                   fromjson("{$sortKey: {'': 1}}")};
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 'a'}}"),
+                                   fromjson("{$sortKey: {'': 2.5}}"),
+                                   fromjson("{$sortKey: {'': null}}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 0, batch1)));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, batch2)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    std::vector<BSONObj> expected = {fromjson("{$sortKey: {'': 'b'}}"),
+                                     fromjson("{$sortKey: {'': 'a'}}"),
+                                     fromjson("{$sortKey: {'': {$numberLong: '3'}}}"),
+                                     fromjson("{$sortKey: {'': 2.5}}"),
+                                     fromjson("{$sortKey: {'': 1}}"),
+                                     fromjson("{$sortKey: {'': null}}")};
+    for (const auto& obj : expected) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(obj, *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchOnceHalfOfTheLastBatchIsReturned) {
+    auto prefetchParam =
+        ServerParameterSet::getGlobal()->getMap().find("asyncResultsMergerPrefetchGetMores");
+    ASSERT(prefetchParam != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(prefetchParam->second->setFromString("true"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(prefetchParam->second->setFromString("false")); });
+
+    std::vector<BSONObj> batch1 = {
+        fromjson("{_id: 1}"), fromjson("{_id: 2}"), fromjson("{_id: 3}"), fromjson("{_id: 4}")};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, batch1)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // No getMore is sent while more than half of the first batch is still buffered.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Returning half of the batch sends the getMore for the next one.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(networkHasReadyRequests());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 5}"), fromjson("{_id: 6}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses));
+
+    // The prefetched batch is returned after the rest of the first batch.
+    for (int i = 3; i <= 6; i++) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
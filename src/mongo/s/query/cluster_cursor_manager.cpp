@@ -280,7 +280,7 @@ StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCur
     OperationContext* opCtx,
     AuthzCheckFn authChecker,
     AuthCheck checkSessionAuth) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     if (_inShutdown) {
         return Status(ErrorCodes::ShutdownInProgress,
@@ -311,23 +311,26 @@ StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCur
         return cursorInUseStatus(nss, cursorId);
     }
 
-    // Note: due to SERVER-31138, despite putting this in a unique_ptr, it's actually not safe to
-    // return before the end of this function. Be careful to avoid any early returns/throws after
-    // this point.
+    // Once the cursor is released from its entry, the entry records 'opCtx' as using it and no one
+    // else can check it out, so the rest of the work happens without holding '_mutex'.
     auto cursor = entry->releaseCursor(opCtx);
+    lk.unlock();
+
+    cursor->reattachToOperationContext(opCtx);
+    PinnedCursor pinnedCursor(this, std::move(cursor), nss, cursorId);
 
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefore,
     // we pass down to the logical session cache and vivify the record (updating last use).
-    if (cursor->getLsid()) {
-        auto vivifyCursorStatus =
-            LogicalSessionCache::get(opCtx)->vivify(opCtx, cursor->getLsid().get());
+    if (auto lsid = pinnedCursor.getLsid()) {
+        auto vivifyCursorStatus = LogicalSessionCache::get(opCtx)->vivify(opCtx, *lsid);
         if (!vivifyCursorStatus.isOK()) {
+            // Hand the cursor back so that a later getMore can still use it.
+            pinnedCursor.returnCursor(CursorState::NotExhausted);
             return vivifyCursorStatus;
         }
     }
 
-    cursor->reattachToOperationContext(opCtx);
-    return PinnedCursor(this, std::move(cursor), nss, cursorId);
+    return std::move(pinnedCursor);
 }
 
 void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cursor,
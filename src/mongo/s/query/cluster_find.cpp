@@ -58,10 +58,12 @@
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/query/cluster_query_knobs.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/establish_cursors.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -309,7 +311,8 @@ CursorId runQueryWithoutRetrying(OperationContext* opCtx,
     auto cursorState = ClusterCursorManager::CursorState::NotExhausted;
     int bytesBuffered = 0;
 
-    while (!FindCommon::enoughForFirstBatch(query.getQueryRequest(), results->size())) {
+    while (!FindCommon::enoughForFirstBatch(
+        query.getQueryRequest(), results->size(), bytesBuffered)) {
         auto next = uassertStatusOK(ccc->next(RouterExecStage::ExecContext::kInitialFind));
 
         if (next.isEOF()) {
@@ -422,6 +425,9 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
 
     auto const catalogCache = Grid::get(opCtx)->catalogCache();
 
+    auto const resultCache = ClusterQueryResultCache::get(opCtx);
+    const auto resultCacheKey = ClusterQueryResultCache::makeKey(opCtx, query, readPref);
+
     // Re-target and re-send the initial find command to the shards until we have established the
     // shard version.
     for (size_t retries = 1; retries <= kMaxRetries; ++retries) {
@@ -435,7 +441,32 @@ CursorId ClusterFind::runQuery(OperationContext* opCtx,
         auto routingInfo = uassertStatusOK(routingInfoStatus);
 
         try {
-            return runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+            if (!resultCacheKey) {
+                return runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+            }
+
+            // Serve the results of an identical earlier query if they are still valid, and
+            // otherwise cache the results of this one if they all fit in its first batch
+            auto const clock = opCtx->getServiceContext()->getFastClockSource();
+            auto routingVersion = ClusterQueryResultCache::makeRoutingVersion(routingInfo);
+            if (auto cachedResults = resultCache->lookup(
+                    *resultCacheKey, query.nss(), routingVersion, clock->now())) {
+                *results = std::move(*cachedResults);
+                return CursorId(0);
+            }
+
+            const auto writeGeneration = resultCache->getWriteGeneration(query.nss());
+            const auto cursorId =
+                runQueryWithoutRetrying(opCtx, query, readPref, routingInfo, results);
+            if (cursorId == CursorId(0)) {
+                resultCache->insert(*resultCacheKey,
+                                    query.nss(),
+                                    std::move(routingVersion),
+                                    writeGeneration,
+                                    *results,
+                                    clock->now());
+            }
+            return cursorId;
         } catch (DBException& ex) {
             if (retries >= kMaxRetries) {
                 // Check if there are no retries remaining, so the last received error can be
@@ -604,6 +635,10 @@ StatusWith<CursorResponse> ClusterFind::runGetMore(OperationContext* opCtx,
             ? RouterExecStage::ExecContext::kGetMoreNoResultsYet
             : RouterExecStage::ExecContext::kGetMoreWithAtLeastOneResultInBatch;
 
+        // As on mongod, stages of the merging pipeline which read ahead may clear this to avoid
+        // waiting for new results while they already hold some.
+        awaitDataState(opCtx).shouldWaitForInserts = batch.empty();
+
         StatusWith<ClusterQueryResult> next =
             Status{ErrorCodes::InternalError, "uninitialized cluster query result"};
         try {
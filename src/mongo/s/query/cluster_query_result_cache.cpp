@@ -0,0 +1,282 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/chunk_manager.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// The maximum number of bytes of keys and results held by the cache. The cache is disabled while
+// this is 0.
+MONGO_EXPORT_SERVER_PARAMETER(clusterQueryResultCacheSizeBytes, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "clusterQueryResultCacheSizeBytes must not be negative");
+        }
+        return Status::OK();
+    });
+
+// The age after which a cached result is no longer served, since writes which are not routed
+// through this mongos do not invalidate it
+MONGO_EXPORT_SERVER_PARAMETER(clusterQueryResultCacheMaxStalenessMS, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "clusterQueryResultCacheMaxStalenessMS must not be negative");
+        }
+        return Status::OK();
+    });
+
+const auto getClusterQueryResultCache =
+    ServiceContext::declareDecoration<ClusterQueryResultCache>();
+
+// Fields of the find command which do not affect its results
+const StringData kFieldsExcludedFromKey[] = {
+    "comment"_sd, "maxTimeMS"_sd, "readConcern"_sd, "noCursorTimeout"_sd};
+
+bool isExcludedFromKey(StringData fieldName) {
+    for (const auto& excluded : kFieldsExcludedFromKey) {
+        if (fieldName == excluded) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t entrySizeBytes(const std::string& key,
+                      const std::string& routingVersion,
+                      const std::vector<BSONObj>& results) {
+    size_t size = key.size() + routingVersion.size();
+    for (const auto& result : results) {
+        size += result.objsize();
+    }
+    return size;
+}
+
+}  // namespace
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(ServiceContext* serviceContext) {
+    return &getClusterQueryResultCache(serviceContext);
+}
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+boost::optional<std::string> ClusterQueryResultCache::makeKey(
+    OperationContext* opCtx, const CanonicalQuery& query, const ReadPreferenceSetting& readPref) {
+    if (clusterQueryResultCacheSizeBytes.load() == 0) {
+        return boost::none;
+    }
+
+    if (opCtx->getTxnNumber()) {
+        return boost::none;
+    }
+
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    const auto readConcernLevel = readConcernArgs.getLevel();
+    if (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern &&
+        readConcernLevel != repl::ReadConcernLevel::kMajorityReadConcern) {
+        return boost::none;
+    }
+    if (readConcernArgs.getArgsOpTime() || readConcernArgs.getArgsAfterClusterTime() ||
+        readConcernArgs.getArgsAtClusterTime()) {
+        return boost::none;
+    }
+
+    const auto& qr = query.getQueryRequest();
+    if (qr.isTailable() || qr.isAllowPartialResults() || qr.isOplogReplay()) {
+        return boost::none;
+    }
+
+    // The results of $where may differ from one run to the next
+    if (QueryPlannerCommon::hasNode(query.root(), MatchExpression::WHERE)) {
+        return boost::none;
+    }
+
+    BSONObjBuilder findCmdBuilder;
+    qr.asFindCommand(&findCmdBuilder);
+
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("ns", query.nss().ns());
+    {
+        BSONObjBuilder findBuilder(keyBuilder.subobjStart("find"));
+        for (const auto& elem : findCmdBuilder.done()) {
+            if (!isExcludedFromKey(elem.fieldNameStringData())) {
+                findBuilder.append(elem);
+            }
+        }
+    }
+    keyBuilder.append("readPreference", readPref.toInnerBSON());
+    keyBuilder.append("readConcernLevel", static_cast<int>(readConcernLevel));
+
+    // The key is the binary BSON, which distinguishes the types as well as the values of the
+    // query's constants
+    const BSONObj keyObj = keyBuilder.done();
+    return std::string(keyObj.objdata(), keyObj.objsize());
+}
+
+std::string ClusterQueryResultCache::makeRoutingVersion(
+    const CachedCollectionRoutingInfo& routingInfo) {
+    if (auto cm = routingInfo.cm()) {
+        return str::stream() << "sharded|" << cm->getVersion().toString();
+    }
+    return str::stream() << "unsharded|" << routingInfo.db().primaryId();
+}
+
+uint64_t ClusterQueryResultCache::getWriteGeneration(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _writeGenerations.find(nss.ns());
+    return it == _writeGenerations.end() ? 0 : it->second;
+}
+
+boost::optional<std::vector<BSONObj>> ClusterQueryResultCache::lookup(
+    const std::string& key,
+    const NamespaceString& nss,
+    const std::string& routingVersion,
+    Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto indexIt = _index.find(key);
+    if (indexIt == _index.end()) {
+        _misses.addAndFetch(1);
+        return boost::none;
+    }
+
+    auto entryIt = indexIt->second;
+    auto generationIt = _writeGenerations.find(nss.ns());
+    const uint64_t writeGeneration =
+        generationIt == _writeGenerations.end() ? 0 : generationIt->second;
+
+    if (entryIt->routingVersion != routingVersion || entryIt->writeGeneration != writeGeneration ||
+        now - entryIt->cachedAt > Milliseconds(clusterQueryResultCacheMaxStalenessMS.load())) {
+        _remove(lk, entryIt);
+        _invalidations.addAndFetch(1);
+        _misses.addAndFetch(1);
+        return boost::none;
+    }
+
+    // Move the entry to the front as the most recently used
+    _entries.splice(_entries.begin(), _entries, entryIt);
+    _hits.addAndFetch(1);
+    return entryIt->results;
+}
+
+void ClusterQueryResultCache::insert(const std::string& key,
+                                     const NamespaceString& nss,
+                                     std::string routingVersion,
+                                     uint64_t writeGeneration,
+                                     const std::vector<BSONObj>& results,
+                                     Date_t now) {
+    const long long maxSizeBytes = clusterQueryResultCacheSizeBytes.load();
+    const size_t sizeBytes = entrySizeBytes(key, routingVersion, results);
+    if (sizeBytes > static_cast<unsigned long long>(maxSizeBytes) / 4) {
+        return;
+    }
+
+    std::vector<BSONObj> ownedResults;
+    ownedResults.reserve(results.size());
+    for (const auto& result : results) {
+        ownedResults.push_back(result.getOwned());
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto generationIt = _writeGenerations.find(nss.ns());
+    if ((generationIt == _writeGenerations.end() ? 0 : generationIt->second) != writeGeneration) {
+        // A write was routed while the query ran, so its results may already be stale
+        return;
+    }
+
+    auto indexIt = _index.find(key);
+    if (indexIt != _index.end()) {
+        _remove(lk, indexIt->second);
+    }
+
+    _entries.push_front(Entry{key,
+                              nss,
+                              std::move(routingVersion),
+                              writeGeneration,
+                              std::move(ownedResults),
+                              now,
+                              sizeBytes});
+    _index[key] = _entries.begin();
+    _totalSizeBytes += sizeBytes;
+    _insertions.addAndFetch(1);
+
+    while (_totalSizeBytes > static_cast<unsigned long long>(maxSizeBytes)) {
+        _remove(lk, std::prev(_entries.end()));
+        _evictions.addAndFetch(1);
+    }
+}
+
+void ClusterQueryResultCache::invalidate(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // Entries of the namespace are removed lazily, when they are next looked up or evicted
+    ++_writeGenerations[nss.ns()];
+}
+
+void ClusterQueryResultCache::report(BSONObjBuilder* builder) const {
+    BSONObjBuilder cacheBuilder(builder->subobjStart("queryResultCache"));
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        cacheBuilder.appendNumber("numEntries", static_cast<long long>(_entries.size()));
+        cacheBuilder.appendNumber("totalSizeBytes", static_cast<long long>(_totalSizeBytes));
+    }
+    cacheBuilder.append("hits", _hits.load());
+    cacheBuilder.append("misses", _misses.load());
+    cacheBuilder.append("insertions", _insertions.load());
+    cacheBuilder.append("evictions", _evictions.load());
+    cacheBuilder.append("invalidations", _invalidations.load());
+}
+
+void ClusterQueryResultCache::_remove(WithLock, EntryList::iterator it) {
+    _totalSizeBytes -= it->sizeBytes;
+    _index.erase(it->key);
+    _entries.erase(it);
+}
+
+}  // namespace mongo
@@ -0,0 +1,170 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class CachedCollectionRoutingInfo;
+class CanonicalQuery;
+class OperationContext;
+struct ReadPreferenceSetting;
+class ServiceContext;
+
+/**
+ * An opt-in cache on mongos of the results of idempotent find commands which returned all of their
+ * results in their first batch, so that repeated identical reads of rarely changing data do not
+ * have to be sent to the shards.
+ *
+ * Entries are keyed by the namespace, the find command's shape and constants, the read preference
+ * and the read concern level. A cached entry is only served while:
+ *   - the routing version of its collection is the one it was cached under,
+ *   - no write to its namespace has been routed through this mongos since its query started, and
+ *   - it is younger than the maximum staleness.
+ * The cache holds at most 'clusterQueryResultCacheSizeBytes' of keys and results, evicting the
+ * least recently used entries first. It is disabled while that size is 0, which is the default.
+ *
+ * This class is thread-safe.
+ */
+class ClusterQueryResultCache {
+    MONGO_DISALLOW_COPYING(ClusterQueryResultCache);
+
+public:
+    ClusterQueryResultCache() = default;
+
+    static ClusterQueryResultCache* get(ServiceContext* serviceContext);
+    static ClusterQueryResultCache* get(OperationContext* opCtx);
+
+    /**
+     * Returns the cache key for the results of 'query' run with 'readPref', or boost::none if the
+     * cache is disabled or if the results of the query must not be cached (e.g. because it is
+     * tailable, runs in a transaction, reads at a point in time or is not deterministic).
+     */
+    static boost::optional<std::string> makeKey(OperationContext* opCtx,
+                                                const CanonicalQuery& query,
+                                                const ReadPreferenceSetting& readPref);
+
+    /**
+     * Returns a string which changes whenever the routing of the collection in 'routingInfo'
+     * changes, to be passed to lookup() and insert().
+     */
+    static std::string makeRoutingVersion(const CachedCollectionRoutingInfo& routingInfo);
+
+    /**
+     * Returns the generation of the writes to 'nss', to be read before running a query and passed
+     * to insert() with its results.
+     */
+    uint64_t getWriteGeneration(const NamespaceString& nss);
+
+    /**
+     * Returns the cached results for 'key' if there is an entry for it which is still valid for
+     * 'routingVersion' at time 'now'. Invalid entries are removed.
+     */
+    boost::optional<std::vector<BSONObj>> lookup(const std::string& key,
+                                                 const NamespaceString& nss,
+                                                 const std::string& routingVersion,
+                                                 Date_t now);
+
+    /**
+     * Caches 'results' under 'key', unless a write to 'nss' was routed since 'writeGeneration' was
+     * read or the entry would take more than a quarter of the cache. Evicts the least recently used
+     * entries to stay within the size of the cache.
+     */
+    void insert(const std::string& key,
+                const NamespaceString& nss,
+                std::string routingVersion,
+                uint64_t writeGeneration,
+                const std::vector<BSONObj>& results,
+                Date_t now);
+
+    /**
+     * Invalidates the cached results of all the queries on 'nss'. Called when a write to 'nss' is
+     * routed through this mongos.
+     */
+    void invalidate(const NamespaceString& nss);
+
+    /**
+     * Appends the cache's memory usage and hit rate counters to 'builder'.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string key;
+        NamespaceString nss;
+        std::string routingVersion;
+        uint64_t writeGeneration;
+        std::vector<BSONObj> results;
+        Date_t cachedAt;
+        size_t sizeBytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    /**
+     * Removes the entry at 'it' and accounts for the memory it used.
+     */
+    void _remove(WithLock, EntryList::iterator it);
+
+    // Protects the entries, their index and the write generations
+    mutable stdx::mutex _mutex;
+
+    // The entries from the most recently used to the least recently used
+    EntryList _entries;
+    stdx::unordered_map<std::string, EntryList::iterator> _index;
+
+    // Incremented for a namespace each time a write to it is routed through this mongos
+    StringMap<uint64_t> _writeGenerations;
+
+    size_t _totalSizeBytes{0};
+
+    AtomicInt64 _hits{0};
+    AtomicInt64 _misses{0};
+    AtomicInt64 _insertions{0};
+    AtomicInt64 _evictions{0};
+    AtomicInt64 _invalidations{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const std::string kRoutingVersion("unsharded|shard0");
+
+class ClusterQueryResultCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        setParameter("clusterQueryResultCacheSizeBytes", "1000000");
+    }
+
+    void tearDown() override {
+        setParameter("clusterQueryResultCacheSizeBytes", "0");
+        setParameter("clusterQueryResultCacheMaxStalenessMS", "1000");
+    }
+
+    void setParameter(StringData name, StringData value) {
+        auto param = ServerParameterSet::getGlobal()->getMap().find(name.toString());
+        ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+        ASSERT_OK(param->second->setFromString(value.toString()));
+    }
+
+    void insert(const std::string& key, std::vector<BSONObj> results) {
+        _cache.insert(key,
+                      kNss,
+                      kRoutingVersion,
+                      _cache.getWriteGeneration(kNss),
+                      std::move(results),
+                      _now);
+    }
+
+    ClusterQueryResultCache _cache;
+    Date_t _now = Date_t::now();
+};
+
+TEST_F(ClusterQueryResultCacheTest, LookupReturnsInsertedResults) {
+    ASSERT_FALSE(_cache.lookup("key", kNss, kRoutingVersion, _now));
+
+    insert("key", {BSON("_id" << 1), BSON("_id" << 2)});
+
+    auto results = _cache.lookup("key", kNss, kRoutingVersion, _now);
+    ASSERT(results);
+    ASSERT_EQ(2U, results->size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), results->front());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), results->back());
+
+    BSONObjBuilder builder;
+    _cache.report(&builder);
+    auto report = builder.obj()["queryResultCache"].Obj();
+    ASSERT_EQ(1, report["hits"].numberLong());
+    ASSERT_EQ(1, report["misses"].numberLong());
+    ASSERT_EQ(1, report["numEntries"].numberLong());
+}
+
+TEST_F(ClusterQueryResultCacheTest, RoutingVersionChangeInvalidatesEntry) {
+    insert("key", {BSON("_id" << 1)});
+    ASSERT_FALSE(_cache.lookup("key", kNss, "unsharded|shard1", _now));
+
+    // The invalid entry is removed
+    ASSERT_FALSE(_cache.lookup("key", kNss, kRoutingVersion, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, WriteInvalidatesEntriesOfItsNamespace) {
+    const NamespaceString otherNss("TestDB", "OtherColl");
+    insert("key", {BSON("_id" << 1)});
+
+    _cache.invalidate(otherNss);
+    ASSERT(_cache.lookup("key", kNss, kRoutingVersion, _now));
+
+    _cache.invalidate(kNss);
+    ASSERT_FALSE(_cache.lookup("key", kNss, kRoutingVersion, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, ResultsOfQueryConcurrentWithWriteAreNotCached) {
+    const auto writeGeneration = _cache.getWriteGeneration(kNss);
+    _cache.invalidate(kNss);
+    _cache.insert("key", kNss, kRoutingVersion, writeGeneration, {BSON("_id" << 1)}, _now);
+    ASSERT_FALSE(_cache.lookup("key", kNss, kRoutingVersion, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EntriesOlderThanMaxStalenessAreNotServed) {
+    setParameter("clusterQueryResultCacheMaxStalenessMS", "100");
+    insert("key", {BSON("_id" << 1)});
+
+    ASSERT(_cache.lookup("key", kNss, kRoutingVersion, _now + Milliseconds(100)));
+    ASSERT_FALSE(_cache.lookup("key", kNss, kRoutingVersion, _now + Milliseconds(101)));
+}
+
+TEST_F(ClusterQueryResultCacheTest, LeastRecentlyUsedEntriesAreEvicted) {
+    const std::string padding(200, 'x');
+    setParameter("clusterQueryResultCacheSizeBytes", "1000");
+
+    insert("key1", {BSON("padding" << padding)});
+    insert("key2", {BSON("padding" << padding)});
+    insert("key3", {BSON("padding" << padding)});
+
+    // Using the first entry makes the second one the least recently used
+    ASSERT(_cache.lookup("key1", kNss, kRoutingVersion, _now));
+    insert("key4", {BSON("padding" << padding)});
+    insert("key5", {BSON("padding" << padding)});
+
+    ASSERT(_cache.lookup("key1", kNss, kRoutingVersion, _now));
+    ASSERT_FALSE(_cache.lookup("key2", kNss, kRoutingVersion, _now));
+    ASSERT(_cache.lookup("key5", kNss, kRoutingVersion, _now));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EntriesLargerThanAQuarterOfTheCacheAreNotCached) {
+    setParameter("clusterQueryResultCacheSizeBytes", "1000");
+    insert("key", {BSON("padding" << std::string(300, 'x'))});
+    ASSERT_FALSE(_cache.lookup("key", kNss, kRoutingVersion, _now));
+}
+
+}  // namespace
+}  // namespace mongo
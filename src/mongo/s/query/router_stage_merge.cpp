@@ -56,8 +56,10 @@ StatusWith<ClusterQueryResult> RouterStageMerge::next(ExecContext execCtx) {
 StatusWith<ClusterQueryResult> RouterStageMerge::awaitNextWithTimeout(ExecContext execCtx) {
     invariant(_params->tailableMode == TailableModeEnum::kTailableAndAwaitData);
     // If we are in kInitialFind or kGetMoreWithAtLeastOneResultInBatch context and the ARM is not
-    // ready, we don't block. Fall straight through to the return statement.
-    while (!_arm.ready() && execCtx == ExecContext::kGetMoreNoResultsYet) {
+    // ready, we don't block. Fall straight through to the return statement. The same applies when
+    // a stage further along the pipeline has asked not to wait for inserts.
+    while (!_arm.ready() && execCtx == ExecContext::kGetMoreNoResultsYet &&
+           awaitDataState(getOpCtx()).shouldWaitForInserts) {
         auto nextEventStatus = getNextEvent();
         if (!nextEventStatus.isOK()) {
             return nextEventStatus.getStatus();
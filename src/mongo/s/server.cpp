@@ -59,6 +59,7 @@
 #include "mongo/db/logical_time_validator.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_killer.h"
 #include "mongo/db/startup_warnings_common.h"
@@ -130,6 +131,27 @@ const ntservice::NtServiceDefaultStrings defaultServiceStrings = {
 
 constexpr auto kSignKeysRetryInterval = Seconds{1};
 
+// The maximum number of sharded collections whose routing info is loaded at startup, before the
+// mongos starts accepting connections. The routing info is only loaded on first use when this is 0.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(catalogCacheWarmUpMaxCollections, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "catalogCacheWarmUpMaxCollections must not be negative");
+        }
+        return Status::OK();
+    });
+
+// The maximum number of collection routing info refreshes in flight during the startup warm-up
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(catalogCacheWarmUpMaxConcurrentRefreshes, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "catalogCacheWarmUpMaxConcurrentRefreshes must be at least 1");
+        }
+        return Status::OK();
+    });
+
 boost::optional<ShardingUptimeReporter> shardingUptimeReporter;
 
 Status waitForSigningKeys(OperationContext* opCtx) {
@@ -404,6 +426,16 @@ ExitCode runMongosServer(ServiceContext* serviceContext) {
             ->getBalancerConfiguration()
             ->refreshAndCheck(opCtx.get())
             .transitional_ignore();
+
+        // Load routing tables before accepting connections, so that the first requests to this
+        // mongos do not all wait on refreshes from the config servers
+        if (catalogCacheWarmUpMaxCollections > 0) {
+            Grid::get(opCtx.get())
+                ->catalogCache()
+                ->warmUp(opCtx.get(),
+                         catalogCacheWarmUpMaxCollections,
+                         catalogCacheWarmUpMaxConcurrentRefreshes);
+        }
     }
 
     startMongoSFTDC();
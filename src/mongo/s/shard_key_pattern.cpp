@@ -275,6 +275,42 @@ BSONObj ShardKeyPattern::extractShardKeyFromDoc(const BSONObj& doc) const {
     return extractShardKeyFromMatchable(matchable);
 }
 
+std::vector<BSONObj> ShardKeyPattern::extractShardKeysFromDocs(
+    const std::vector<BSONObj>& docs) const {
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(docs.size());
+
+    if (!isHashedPattern()) {
+        for (const auto& doc : docs) {
+            shardKeys.push_back(extractShardKeyFromDoc(doc));
+        }
+        return shardKeys;
+    }
+
+    // A hashed key pattern has only the hashed field. The documents without a valid value for it
+    // keep an empty shard key.
+    const BSONElement patternEl = _keyPattern.toBSON().firstElement();
+    std::vector<BSONElement> values;
+    std::vector<size_t> hashedDocs;
+    for (size_t i = 0; i < docs.size(); ++i) {
+        shardKeys.emplace_back();
+        BSONMatchableDocument matchable(docs[i]);
+        BSONElement value =
+            extractKeyElementFromMatchable(matchable, patternEl.fieldNameStringData());
+        if (isValidShardKeyElement(value)) {
+            values.push_back(value);
+            hashedDocs.push_back(i);
+        }
+    }
+
+    const auto hashes =
+        BSONElementHasher::hash64Batch(values, BSONElementHasher::DEFAULT_HASH_SEED);
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        shardKeys[hashedDocs[i]] = BSON(patternEl.fieldName() << hashes[i]);
+    }
+    return shardKeys;
+}
+
 std::vector<StringData> ShardKeyPattern::findMissingShardKeyFieldsFromDoc(const BSONObj doc) const {
     std::vector<StringData> missingFields;
     BSONMatchableDocument matchable(doc);
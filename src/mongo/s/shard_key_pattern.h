@@ -144,6 +144,12 @@ public:
      */
     BSONObj extractShardKeyFromDoc(const BSONObj& doc) const;
 
+    /**
+     * Returns extractShardKeyFromDoc() of each of the given documents, in order. The values of
+     * a hashed key pattern are hashed together, which is faster than hashing them one by one.
+     */
+    std::vector<BSONObj> extractShardKeysFromDocs(const std::vector<BSONObj>& docs) const;
+
     /**
      * Returns the set of shard key fields which are absent from the given document. Note that the
      * vector returned by this method contains StringData elements pointing into ShardKeyPattern's
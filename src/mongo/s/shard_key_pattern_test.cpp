@@ -248,6 +248,27 @@ TEST(ShardKeyPattern, ExtractDocShardKeyHashed) {
     ASSERT_BSONOBJ_EQ(docKey(pattern, BSON("a" << BSON_ARRAY(BSON("b" << value)))), BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractDocShardKeysMatchSingleDocShardKeys) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 20; ++i) {
+        docs.push_back(BSON("a" << BSON("b" << i) << "c" << i));
+        docs.push_back(BSON("a" << BSON("b" << ("str" + std::to_string(i)))));
+        docs.push_back(BSON("a" << BSON("c" << i)));
+        docs.push_back(BSON("a" << BSON("b" << BSON_ARRAY(i))));
+    }
+
+    for (const auto& keyPattern : {BSON("a.b"
+                                        << "hashed"),
+                                   BSON("a.b" << 1 << "c" << 1)}) {
+        ShardKeyPattern pattern(keyPattern);
+        const auto shardKeys = pattern.extractShardKeysFromDocs(docs);
+        ASSERT_EQUALS(shardKeys.size(), docs.size());
+        for (size_t i = 0; i < docs.size(); ++i) {
+            ASSERT_BSONOBJ_EQ(shardKeys[i], docKey(pattern, docs[i]));
+        }
+    }
+}
+
 static BSONObj queryKey(const ShardKeyPattern& pattern, const BSONObj& query) {
     QueryTestServiceContext serviceContext;
     auto opCtx = serviceContext.makeOperationContext();
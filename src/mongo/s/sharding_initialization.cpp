@@ -97,6 +97,22 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshRequirement
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshTimeoutMS,
                                       int,
                                       ConnectionPool::kDefaultRefreshTimeout.count());
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshJitterMS, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "ShardingTaskExecutorPoolRefreshJitterMS must be non-negative");
+        }
+        return Status::OK();
+    });
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRecentDemandWindowMS, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "ShardingTaskExecutorPoolRecentDemandWindowMS must be non-negative");
+        }
+        return Status::OK();
+    });
 
 namespace {
 
@@ -193,6 +209,9 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.minConnections = ShardingTaskExecutorPoolMinSize;
     connPoolOptions.refreshRequirement = Milliseconds(ShardingTaskExecutorPoolRefreshRequirementMS);
     connPoolOptions.refreshTimeout = Milliseconds(ShardingTaskExecutorPoolRefreshTimeoutMS);
+    connPoolOptions.refreshRequirementJitter =
+        Milliseconds(ShardingTaskExecutorPoolRefreshJitterMS);
+    connPoolOptions.recentDemandWindow = Milliseconds(ShardingTaskExecutorPoolRecentDemandWindowMS);
 
     if (connPoolOptions.refreshRequirement <= connPoolOptions.refreshTimeout) {
         auto newRefreshTimeout = connPoolOptions.refreshRequirement - Milliseconds(1);
@@ -218,6 +237,17 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
         connPoolOptions.hostTimeout = newHostTimeout;
     }
 
+    if (connPoolOptions.refreshRequirementJitter >= connPoolOptions.refreshRequirement) {
+        auto newRefreshJitter = connPoolOptions.refreshRequirement - Milliseconds(1);
+        warning() << "ShardingTaskExecutorPoolRefreshJitterMS ("
+                  << connPoolOptions.refreshRequirementJitter
+                  << ") set at or above ShardingTaskExecutorPoolRefreshRequirementMS ("
+                  << connPoolOptions.refreshRequirement
+                  << "). Adjusting ShardingTaskExecutorPoolRefreshJitterMS to "
+                  << newRefreshJitter;
+        connPoolOptions.refreshRequirementJitter = newRefreshJitter;
+    }
+
     auto network =
         executor::makeNetworkInterface("ShardRegistry",
                                        stdx::make_unique<ShardingNetworkConnectionHook>(),
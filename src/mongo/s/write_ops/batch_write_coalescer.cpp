@@ -0,0 +1,263 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/write_ops/batch_write_coalescer.h"
+
+#include <vector>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const auto getBatchWriteCoalescer = ServiceContext::declareDecoration<BatchWriteCoalescer>();
+
+/**
+ * Fills 'response' with the outcome of the 'count' documents starting at 'offset' of the merged
+ * batch whose response is 'merged'.
+ */
+void demultiplexResponse(const BatchedCommandResponse& merged,
+                         size_t offset,
+                         size_t count,
+                         BatchedCommandResponse* response) {
+    response->clear();
+    if (!merged.getOk()) {
+        response->setStatus(merged.getTopLevelStatus());
+        return;
+    }
+    response->setStatus(Status::OK());
+
+    // Each document of an unordered insert is either inserted or has a write error.
+    long long n = count;
+    if (merged.isErrDetailsSet()) {
+        for (const auto* error : merged.getErrDetails()) {
+            const size_t index = error->getIndex();
+            if (index < offset || index >= offset + count) {
+                continue;
+            }
+
+            auto memberError = stdx::make_unique<WriteErrorDetail>();
+            error->cloneTo(memberError.get());
+            memberError->setIndex(index - offset);
+            response->addToErrDetails(memberError.release());
+            --n;
+        }
+    }
+    response->setN(n);
+
+    if (merged.isWriteConcernErrorSet()) {
+        auto wcError = stdx::make_unique<WriteConcernErrorDetail>();
+        merged.getWriteConcernError()->cloneTo(wcError.get());
+        response->setWriteConcernError(wcError.release());
+    }
+    if (merged.isLastOpSet()) {
+        response->setLastOp(merged.getLastOp());
+    }
+    if (merged.isElectionIdSet()) {
+        response->setElectionId(merged.getElectionId());
+    }
+}
+
+}  // namespace
+
+struct BatchWriteCoalescer::Group {
+    explicit Group(const BatchedCommandRequest& request)
+        : nss(request.getNS()),
+          bypassDocumentValidation(request.getWriteCommandBase().getBypassDocumentValidation()),
+          allowImplicitCreate(request.isImplicitCreateAllowed()) {
+        if (request.hasWriteConcern()) {
+            writeConcern = request.getWriteConcern();
+        }
+    }
+
+    BatchedCommandRequest makeRequest() {
+        BatchedCommandRequest request([&] {
+            write_ops::Insert insertOp(nss);
+            insertOp.setWriteCommandBase([&] {
+                write_ops::WriteCommandBase wcb;
+                wcb.setOrdered(false);
+                wcb.setBypassDocumentValidation(bypassDocumentValidation);
+                return wcb;
+            }());
+            insertOp.setDocuments(std::move(documents));
+            return insertOp;
+        }());
+
+        if (writeConcern) {
+            request.setWriteConcern(*writeConcern);
+        }
+        request.setAllowImplicitCreate(allowImplicitCreate);
+        return request;
+    }
+
+    const NamespaceString nss;
+    const bool bypassDocumentValidation;
+    const bool allowImplicitCreate;
+    boost::optional<BSONObj> writeConcern;
+
+    // The documents of all the members, in the order in which they joined
+    std::vector<BSONObj> documents;
+
+    // Set once the group stops accepting writes, and once its merged batch has been executed
+    bool closed{false};
+    bool done{false};
+    stdx::condition_variable cv;
+
+    BatchWriteExecStats stats;
+    BatchedCommandResponse response;
+};
+
+BatchWriteCoalescer::BatchWriteCoalescer(size_t maxDocumentsPerBatch)
+    : _maxDocumentsPerBatch(maxDocumentsPerBatch) {}
+
+BatchWriteCoalescer* BatchWriteCoalescer::get(ServiceContext* service) {
+    return &getBatchWriteCoalescer(service);
+}
+
+bool BatchWriteCoalescer::canCoalesce(OperationContext* opCtx,
+                                      const BatchedCommandRequest& request) {
+    if (request.getBatchType() != BatchedCommandRequest::BatchType_Insert ||
+        request.isInsertIndexRequest() || request.hasShardVersion()) {
+        return false;
+    }
+
+    // Writes to the config servers are not sent as shard batches.
+    const auto db = request.getNS().db();
+    if (db == NamespaceString::kAdminDb || db == NamespaceString::kConfigDb) {
+        return false;
+    }
+
+    const auto& wcb = request.getWriteCommandBase();
+    if (wcb.getOrdered() || wcb.getStmtIds()) {
+        return false;
+    }
+
+    if (opCtx->getTxnNumber() || opCtx->hasDeadline()) {
+        return false;
+    }
+
+    if (request.hasWriteConcern()) {
+        const auto& writeConcern = request.getWriteConcern();
+        const auto wElem = writeConcern["w"];
+        for (const auto& elem : writeConcern) {
+            if (elem.fieldNameStringData() != "w" && elem.fieldNameStringData() != "wtimeout") {
+                return false;
+            }
+        }
+        if (!wElem.isNumber() || wElem.numberInt() != 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BatchWriteCoalescer::write(const BatchedCommandRequest& request,
+                                Microseconds window,
+                                const ExecuteFn& execute,
+                                BatchWriteExecStats* stats,
+                                BatchedCommandResponse* response) {
+    const auto& documents = request.getInsertRequest().getDocuments();
+    const std::string key = str::stream()
+        << request.getNS().ns() << '\0'
+        << request.getWriteCommandBase().getBypassDocumentValidation()
+        << request.isImplicitCreateAllowed()
+        << (request.hasWriteConcern() ? request.getWriteConcern().toString() : "");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    std::shared_ptr<Group> group;
+    bool isLeader = false;
+    auto it = _openGroups.find(key);
+    if (it != _openGroups.end() &&
+        it->second->documents.size() + documents.size() <= _maxDocumentsPerBatch) {
+        group = it->second;
+    } else {
+        if (it != _openGroups.end()) {
+            _closeGroup_inlock(key, it->second);
+        }
+        group = std::make_shared<Group>(request);
+        _openGroups[key] = group;
+        isLeader = true;
+    }
+
+    const size_t offset = group->documents.size();
+    group->documents.insert(group->documents.end(), documents.begin(), documents.end());
+    if (group->documents.size() >= _maxDocumentsPerBatch) {
+        _closeGroup_inlock(key, group);
+    }
+
+    if (isLeader) {
+        group->cv.wait_for(lk, window.toSystemDuration(), [&] { return group->closed; });
+        if (!group->closed) {
+            _closeGroup_inlock(key, group);
+        }
+        lk.unlock();
+
+        // The members are waiting on the outcome of the merged batch, so it must always be set.
+        try {
+            execute(group->makeRequest(), &group->stats, &group->response);
+        } catch (const DBException& ex) {
+            group->response.clear();
+            group->response.setStatus(ex.toStatus());
+        }
+
+        lk.lock();
+        group->done = true;
+        group->cv.notify_all();
+    } else {
+        // The documents of this write are now part of the group's batch, so wait for its outcome
+        // regardless of interruption.
+        group->cv.wait(lk, [&] { return group->done; });
+    }
+    lk.unlock();
+
+    *stats = group->stats;
+    demultiplexResponse(group->response, offset, documents.size(), response);
+}
+
+void BatchWriteCoalescer::_closeGroup_inlock(const std::string& key,
+                                             const std::shared_ptr<Group>& group) {
+    group->closed = true;
+    group->cv.notify_all();
+
+    auto it = _openGroups.find(key);
+    if (it != _openGroups.end() && it->second == group) {
+        _openGroups.erase(it);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/ops/write_ops.h"
+#include "mongo/s/write_ops/batch_write_exec.h"
+#include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Merges small unordered inserts into the same namespace, issued concurrently by different
+ * clients, into a single batch so that each targeted shard receives one request for all of them.
+ *
+ * The first write to arrive for a namespace leads a group. It waits up to the coalescing window
+ * for other writes to join, executes the merged batch and then every member takes the part of the
+ * response that covers its own documents. A group stops accepting writes early once it holds the
+ * maximum number of documents per batch.
+ */
+class BatchWriteCoalescer {
+    MONGO_DISALLOW_COPYING(BatchWriteCoalescer);
+
+public:
+    using ExecuteFn = stdx::function<void(
+        const BatchedCommandRequest&, BatchWriteExecStats*, BatchedCommandResponse*)>;
+
+    explicit BatchWriteCoalescer(size_t maxDocumentsPerBatch = write_ops::kMaxWriteBatchSize);
+
+    static BatchWriteCoalescer* get(ServiceContext* service);
+
+    /**
+     * Returns whether 'request' may be merged with the writes of other clients: an unordered
+     * insert with no write concern or {w: 1}, outside of any transaction or retryable write and
+     * without a time limit.
+     */
+    static bool canCoalesce(OperationContext* opCtx, const BatchedCommandRequest& request);
+
+    /**
+     * Executes 'request', which must satisfy canCoalesce(), as part of a merged batch, waiting up
+     * to 'window' for other writes to join it. 'execute' is called by the leader of the group with
+     * the merged request. 'stats' receives the statistics of the whole merged batch, and
+     * 'response' the outcome of the documents of 'request', indexed as in 'request'.
+     */
+    void write(const BatchedCommandRequest& request,
+               Microseconds window,
+               const ExecuteFn& execute,
+               BatchWriteExecStats* stats,
+               BatchedCommandResponse* response);
+
+private:
+    struct Group;
+
+    void _closeGroup_inlock(const std::string& key, const std::shared_ptr<Group>& group);
+
+    const size_t _maxDocumentsPerBatch;
+
+    stdx::mutex _mutex;
+
+    // Groups still accepting writes, keyed by their namespace and write options
+    std::map<std::string, std::shared_ptr<Group>> _openGroups;
+};
+
+}  // namespace mongo
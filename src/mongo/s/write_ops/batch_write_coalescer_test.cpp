@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/s/write_ops/batch_write_coalescer.h"
+#include "mongo/s/write_ops/write_error_detail.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+BatchedCommandRequest makeInsert(std::vector<BSONObj> documents, bool ordered = false) {
+    return BatchedCommandRequest([&] {
+        write_ops::Insert insertOp(kNss);
+        insertOp.setWriteCommandBase([&] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(ordered);
+            return wcb;
+        }());
+        insertOp.setDocuments(std::move(documents));
+        return insertOp;
+    }());
+}
+
+/**
+ * Executes a merged batch by failing the documents whose 'fail' field is true.
+ */
+void executeFailingMarkedDocuments(const BatchedCommandRequest& request,
+                                   BatchWriteExecStats* stats,
+                                   BatchedCommandResponse* response) {
+    const auto& documents = request.getInsertRequest().getDocuments();
+    response->setStatus(Status::OK());
+    long long n = 0;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (!documents[i]["fail"].trueValue()) {
+            ++n;
+            continue;
+        }
+        auto error = stdx::make_unique<WriteErrorDetail>();
+        error->setIndex(i);
+        error->setStatus({ErrorCodes::DuplicateKey, "duplicate"});
+        response->addToErrDetails(error.release());
+    }
+    response->setN(n);
+}
+
+TEST(BatchWriteCoalescerTest, OnlyUnorderedNonRetryableInsertsAreCoalesced) {
+    OperationContextNoop opCtx;
+    ASSERT(BatchWriteCoalescer::canCoalesce(&opCtx, makeInsert({BSON("x" << 1)})));
+    ASSERT(!BatchWriteCoalescer::canCoalesce(&opCtx, makeInsert({BSON("x" << 1)}, true)));
+
+    auto withWriteConcern = [](BSONObj writeConcern) {
+        auto request = makeInsert({BSON("x" << 1)});
+        request.setWriteConcern(writeConcern);
+        return request;
+    };
+    ASSERT(BatchWriteCoalescer::canCoalesce(&opCtx, withWriteConcern(BSON("w" << 1))));
+    ASSERT(!BatchWriteCoalescer::canCoalesce(&opCtx, withWriteConcern(BSON("w" << 2))));
+    ASSERT(!BatchWriteCoalescer::canCoalesce(&opCtx,
+                                             withWriteConcern(BSON("w" << 1 << "j" << true))));
+
+    opCtx.setLogicalSessionId(makeLogicalSessionIdForTest());
+    ASSERT(BatchWriteCoalescer::canCoalesce(&opCtx, makeInsert({BSON("x" << 1)})));
+    opCtx.setTxnNumber(1);
+    ASSERT(!BatchWriteCoalescer::canCoalesce(&opCtx, makeInsert({BSON("x" << 1)})));
+}
+
+TEST(BatchWriteCoalescerTest, SingleWriteIsExecutedAfterTheWindow) {
+    BatchWriteCoalescer coalescer;
+    int numExecutions = 0;
+
+    BatchWriteExecStats stats;
+    BatchedCommandResponse response;
+    coalescer.write(makeInsert({BSON("x" << 1), BSON("x" << 2 << "fail" << true)}),
+                    Microseconds(100),
+                    [&](const BatchedCommandRequest& request,
+                        BatchWriteExecStats* stats,
+                        BatchedCommandResponse* response) {
+                        ++numExecutions;
+                        ASSERT_EQ(2U, request.sizeWriteOps());
+                        ASSERT(!request.getWriteCommandBase().getOrdered());
+                        executeFailingMarkedDocuments(request, stats, response);
+                    },
+                    &stats,
+                    &response);
+
+    ASSERT_EQ(1, numExecutions);
+    ASSERT(response.getOk());
+    ASSERT_EQ(1, response.getN());
+    ASSERT_EQ(1U, response.sizeErrDetails());
+    ASSERT_EQ(1, response.getErrDetailsAt(0)->getIndex());
+}
+
+TEST(BatchWriteCoalescerTest, ConcurrentWritesShareOneBatch) {
+    // The group is executed as soon as it holds three documents, long before the window expires.
+    BatchWriteCoalescer coalescer(3);
+    AtomicInt32 numExecutions;
+    const auto execute = [&](const BatchedCommandRequest& request,
+                             BatchWriteExecStats* stats,
+                             BatchedCommandResponse* response) {
+        numExecutions.fetchAndAdd(1);
+        ASSERT_EQ(3U, request.sizeWriteOps());
+        executeFailingMarkedDocuments(request, stats, response);
+    };
+
+    BatchWriteExecStats statsA;
+    BatchedCommandResponse responseA;
+    stdx::thread writerA([&] {
+        coalescer.write(
+            makeInsert({BSON("a" << 1)}), Minutes(10), execute, &statsA, &responseA);
+    });
+
+    BatchWriteExecStats statsB;
+    BatchedCommandResponse responseB;
+    coalescer.write(makeInsert({BSON("b" << 1 << "fail" << true), BSON("b" << 2)}),
+                    Minutes(10),
+                    execute,
+                    &statsB,
+                    &responseB);
+    writerA.join();
+
+    ASSERT_EQ(1, numExecutions.load());
+
+    ASSERT(responseA.getOk());
+    ASSERT_EQ(1, responseA.getN());
+    ASSERT(!responseA.isErrDetailsSet());
+
+    // The error is reported at the index of the failed document within its own write.
+    ASSERT(responseB.getOk());
+    ASSERT_EQ(1, responseB.getN());
+    ASSERT_EQ(1U, responseB.sizeErrDetails());
+    ASSERT_EQ(0, responseB.getErrDetailsAt(0)->getIndex());
+    ASSERT_EQ(ErrorCodes::DuplicateKey, responseB.getErrDetailsAt(0)->toStatus().code());
+}
+
+TEST(BatchWriteCoalescerTest, ExecutionFailureIsReportedToEveryMember) {
+    BatchWriteCoalescer coalescer(2);
+    const auto execute = [](const BatchedCommandRequest& request,
+                            BatchWriteExecStats* stats,
+                            BatchedCommandResponse* response) {
+        uasserted(ErrorCodes::ShardNotFound, "no shard");
+    };
+
+    BatchWriteExecStats statsA;
+    BatchedCommandResponse responseA;
+    stdx::thread writerA([&] {
+        coalescer.write(
+            makeInsert({BSON("a" << 1)}), Minutes(10), execute, &statsA, &responseA);
+    });
+
+    BatchWriteExecStats statsB;
+    BatchedCommandResponse responseB;
+    coalescer.write(makeInsert({BSON("b" << 1)}), Minutes(10), execute, &statsB, &responseB);
+    writerA.join();
+
+    ASSERT_EQ(ErrorCodes::ShardNotFound, responseA.toStatus());
+    ASSERT_EQ(ErrorCodes::ShardNotFound, responseB.toStatus());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -259,6 +259,23 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // The documents of an unordered insert batch are all targeted at once, in the order their
+    // ops are visited below. An ordered batch is sent to one shard at a time and targeted again
+    // after each, so its documents are only targeted when they are reached.
+    std::vector<StatusWith<ShardEndpoint>> insertEndpoints;
+    auto nextInsertEndpoint = insertEndpoints.cbegin();
+    if (!ordered && _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest.isInsertIndexRequest()) {
+        const auto& docs = _clientRequest.getInsertRequest().getDocuments();
+        std::vector<BSONObj> readyDocs;
+        for (size_t i = 0; i < numWriteOps; ++i) {
+            if (_writeOps[i].getWriteState() == WriteOpState_Ready)
+                readyDocs.push_back(docs[i]);
+        }
+        insertEndpoints = targeter.targetInserts(_opCtx, readyDocs);
+        nextInsertEndpoint = insertEndpoints.cbegin();
+    }
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -274,7 +291,12 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        const StatusWith<ShardEndpoint>* insertEndpoint = nullptr;
+        if (nextInsertEndpoint != insertEndpoints.cend()) {
+            insertEndpoint = &*nextInsertEndpoint++;
+        }
+
+        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes, insertEndpoint);
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -35,6 +35,8 @@
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/commands/cluster_commands_helpers.h"
 #include "mongo/s/grid.h"
@@ -45,6 +47,10 @@
 namespace mongo {
 namespace {
 
+// When enabled, the shard keys of the documents written to each chunk are sampled, so that the
+// auto-splitter can choose split points from the sample instead of scanning the chunk on its shard
+MONGO_EXPORT_SERVER_PARAMETER(autoSplitFromSampledShardKeys, bool, false);
+
 enum CompareResult { CompareResult_Unknown, CompareResult_GTE, CompareResult_LT };
 
 constexpr auto kIdFieldName = "_id"_sd;
@@ -343,26 +349,94 @@ const NamespaceString& ChunkManagerTargeter::getNS() const {
 StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
                                                              const BSONObj& doc) const {
     BSONObj shardKey;
-
     if (_routingInfo->cm()) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
-
         shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+    }
+    return _targetInsertShardKey(doc, shardKey);
+}
 
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return {ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "document " << doc
-                                  << " does not contain shard key for pattern "
-                                  << _routingInfo->cm()->getShardKeyPattern().toString()};
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+
+    const auto cm = _routingInfo->cm();
+    if (!cm) {
+        for (const auto& doc : docs) {
+            endpoints.push_back(_targetInsertShardKey(doc, BSONObj()));
         }
+        return endpoints;
+    }
 
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    // The shard keys of all the documents are extracted at once, which hashes the values of a
+    // hashed shard key together.
+    std::vector<BSONObj> shardKeys = cm->getShardKeyPattern().extractShardKeysFromDocs(docs);
+
+    std::vector<Status> statuses;
+    statuses.reserve(docs.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        statuses.push_back(_checkInsertShardKey(docs[i], shardKeys[i]));
+        if (!statuses.back().isOK()) {
+            shardKeys[i] = BSONObj();
+        }
+    }
+
+    // The chunks of all the valid shard keys are looked up in a single walk in shard key order,
+    // and the endpoint of each shard is only built once and then shared by its documents
+    const auto chunks = cm->findIntersectingChunksWithSimpleCollation(shardKeys);
+    std::map<ShardId, ShardEndpoint> shardEndpoints;
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+        if (!statuses[i].isOK()) {
+            endpoints.push_back(std::move(statuses[i]));
+            continue;
+        }
+
+        const auto& chunk = *chunks[i];
+
+        // Track autosplit stats for sharded collections
+        // Note: this is only best effort accounting and is not accurate.
+        _stats->chunkSizeDelta[chunk.getMin()] += docs[i].objsize();
+        if (autoSplitFromSampledShardKeys.load()) {
+            chunk.getWritesTracker()->sampleKey(shardKeys[i]);
+        }
+
+        auto it = shardEndpoints.find(chunk.getShardId());
+        if (it == shardEndpoints.end()) {
+            it = shardEndpoints
+                     .emplace(chunk.getShardId(),
+                              ShardEndpoint(chunk.getShardId(), cm->getVersion(chunk.getShardId())))
+                     .first;
+        }
+        endpoints.push_back(it->second);
+    }
+
+    return endpoints;
+}
+
+Status ChunkManagerTargeter::_checkInsertShardKey(const BSONObj& doc,
+                                                  const BSONObj& shardKey) const {
+    //
+    // Sharded collections have the following requirements for targeting:
+    //
+    // Inserts must contain the exact shard key.
+    //
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return {ErrorCodes::ShardKeyNotFound,
+                str::stream() << "document " << doc << " does not contain shard key for pattern "
+                              << _routingInfo->cm()->getShardKeyPattern().toString()};
+    }
+
+    // Check shard key size on insert
+    return ShardKeyPattern::checkShardKeySize(shardKey);
+}
+
+StatusWith<ShardEndpoint> ChunkManagerTargeter::_targetInsertShardKey(
+    const BSONObj& doc, const BSONObj& shardKey) const {
+    if (_routingInfo->cm()) {
+        Status status = _checkInsertShardKey(doc, shardKey);
         if (!status.isOK())
             return status;
     }
@@ -632,6 +706,9 @@ ShardEndpoint ChunkManagerTargeter::_targetShardKey(const BSONObj& shardKey,
     // Note: this is only best effort accounting and is not accurate.
     if (estDataSize > 0) {
         _stats->chunkSizeDelta[chunk.getMin()] += estDataSize;
+        if (autoSplitFromSampledShardKeys.load()) {
+            chunk.getWritesTracker()->sampleKey(shardKey);
+        }
     }
 
     return {chunk.getShardId(), _routingInfo->cm()->getVersion(chunk.getShardId())};
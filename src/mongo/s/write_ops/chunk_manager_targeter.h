@@ -72,6 +72,9 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -143,6 +146,18 @@ private:
                                                         const BSONObj& query,
                                                         const BSONObj& collation) const;
 
+    /**
+     * Returns the ShardEndpoint of a document to insert, given its shard key, which is empty if
+     * the collection is unsharded or if the document has no valid shard key.
+     */
+    StatusWith<ShardEndpoint> _targetInsertShardKey(const BSONObj& doc,
+                                                    const BSONObj& shardKey) const;
+
+    /**
+     * Checks that a document to insert into a sharded collection has a valid shard key.
+     */
+    Status _checkInsertShardKey(const BSONObj& doc, const BSONObj& shardKey) const;
+
     /**
      * Returns a ShardEndpoint for an exact shard key query.
      *
@@ -35,9 +35,11 @@
 #include <algorithm>
 
 #include "mongo/base/status.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/type_collection.h"
@@ -46,16 +48,33 @@
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/config_server_client.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/shard_util.h"
+#include "mongo/s/write_ops/batch_write_coalescer.h"
 #include "mongo/s/write_ops/chunk_manager_targeter.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
 
 const uint64_t kTooManySplitPoints = 4;
 
+// The smallest sample of shard keys written to a chunk which split points are chosen from
+const size_t kMinSampledKeysForSplitPoints = 8;
+
+// How long, in microseconds, an unordered w:1 insert waits for concurrent inserts into the same
+// collection from other clients, to send all of them to each shard in one batch. 0 disables it.
+MONGO_EXPORT_SERVER_PARAMETER(clusterWriteCoalescingWindowMicros, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 100 * 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "clusterWriteCoalescingWindowMicros must be between 0 and 100000");
+        }
+        return Status::OK();
+    });
+
 void toBatchError(const Status& status, BatchedCommandResponse* response) {
     response->clear();
     response->setStatus(status);
@@ -139,6 +158,63 @@ BSONObj findExtremeKeyForShard(OperationContext* opCtx,
     return shardKeyPattern.extractShardKeyFromDoc(end);
 }
 
+/**
+ * Chooses split points for the chunk with the given range from a sample of the shard keys written
+ * to it, aiming like splitVector for chunks of half the desired chunk size. Returns no split points
+ * if the sample is too small or if fewer than two split points would be chosen, in which case the
+ * caller should fall back to having the shard scan the chunk for split points.
+ */
+std::vector<BSONObj> selectSplitPointsFromSampledKeys(std::vector<BSONObj> sampledKeys,
+                                                      const ChunkRange& chunkRange,
+                                                      uint64_t bytesWritten,
+                                                      uint64_t desiredChunkSize) {
+    if (sampledKeys.size() < kMinSampledKeysForSplitPoints || desiredChunkSize < 2) {
+        return {};
+    }
+
+    const uint64_t numChunks = bytesWritten / (desiredChunkSize / 2);
+    if (numChunks < 3) {
+        return {};
+    }
+
+    const SimpleBSONObjComparator::LessThan lessThan;
+    std::sort(sampledKeys.begin(), sampledKeys.end(), lessThan);
+    sampledKeys.erase(std::unique(sampledKeys.begin(),
+                                  sampledKeys.end(),
+                                  SimpleBSONObjComparator::kInstance.makeEqualTo()),
+                      sampledKeys.end());
+
+    // Only keys strictly inside the chunk can be split points
+    sampledKeys.erase(std::remove_if(sampledKeys.begin(),
+                                     sampledKeys.end(),
+                                     [&](const BSONObj& key) {
+                                         return !lessThan(chunkRange.getMin(), key) ||
+                                             !lessThan(key, chunkRange.getMax());
+                                     }),
+                      sampledKeys.end());
+
+    const uint64_t numSplitPoints = std::min<uint64_t>(
+        {numChunks - 1, sampledKeys.size() > 0 ? sampledKeys.size() - 1 : 0, kTooManySplitPoints});
+    if (numSplitPoints < 2) {
+        return {};
+    }
+
+    std::vector<BSONObj> splitPoints;
+    splitPoints.reserve(numSplitPoints);
+    for (uint64_t i = 1; i <= numSplitPoints; i++) {
+        const auto& key = sampledKeys[i * sampledKeys.size() / (numSplitPoints + 1)];
+        if (splitPoints.empty() || lessThan(splitPoints.back(), key)) {
+            splitPoints.push_back(key);
+        }
+    }
+
+    if (splitPoints.size() < 2) {
+        return {};
+    }
+
+    return splitPoints;
+}
+
 /**
  * Splits the chunks touched based from the targeter stats if needed.
  */
@@ -173,16 +249,18 @@ void splitIfNeeded(OperationContext* opCtx,
     }
 }
 
-}  // namespace
-
-void ClusterWriter::write(OperationContext* opCtx,
-                          const BatchedCommandRequest& request,
-                          BatchWriteExecStats* stats,
-                          BatchedCommandResponse* response) {
+void executeWrite(OperationContext* opCtx,
+                  const BatchedCommandRequest& request,
+                  BatchWriteExecStats* stats,
+                  BatchedCommandResponse* response) {
     const NamespaceString& nss = request.getNS();
 
     LastError::Disabled disableLastError(&LastError::get(opCtx->getClient()));
 
+    // Once the write is done, the cached results of queries on the namespace, including those of
+    // queries which ran concurrently with it, may be stale
+    ON_BLOCK_EXIT([&] { ClusterQueryResultCache::get(opCtx)->invalidate(nss); });
+
     // Config writes and shard writes are done differently
     if (nss.db() == NamespaceString::kAdminDb) {
         Grid::get(opCtx)->catalogClient()->writeConfigServerDirect(opCtx, request, response);
@@ -236,6 +314,30 @@ void ClusterWriter::write(OperationContext* opCtx,
     }
 }
 
+}  // namespace
+
+void ClusterWriter::write(OperationContext* opCtx,
+                          const BatchedCommandRequest& request,
+                          BatchWriteExecStats* stats,
+                          BatchedCommandResponse* response) {
+    const int coalescingWindowMicros = clusterWriteCoalescingWindowMicros.load();
+    if (coalescingWindowMicros > 0 && BatchWriteCoalescer::canCoalesce(opCtx, request)) {
+        BatchWriteCoalescer::get(opCtx->getServiceContext())
+            ->write(request,
+                    Microseconds(coalescingWindowMicros),
+                    [opCtx](const BatchedCommandRequest& mergedRequest,
+                            BatchWriteExecStats* mergedStats,
+                            BatchedCommandResponse* mergedResponse) {
+                        executeWrite(opCtx, mergedRequest, mergedStats, mergedResponse);
+                    },
+                    stats,
+                    response);
+        return;
+    }
+
+    executeWrite(opCtx, request, stats, response);
+}
+
 void updateChunkWriteStatsAndSplitIfNeeded(OperationContext* opCtx,
                                            ChunkManager* manager,
                                            Chunk chunk,
@@ -297,14 +399,23 @@ void updateChunkWriteStatsAndSplitIfNeeded(OperationContext* opCtx,
             }
         }();
 
-        auto splitPoints =
-            uassertStatusOK(shardutil::selectChunkSplitPoints(opCtx,
-                                                              chunk.getShardId(),
-                                                              nss,
-                                                              manager->getShardKeyPattern(),
-                                                              chunkRange,
-                                                              chunkSizeToUse,
-                                                              boost::none));
+        auto splitPoints = selectSplitPointsFromSampledKeys(writesTracker->getSampledKeys(),
+                                                            chunkRange,
+                                                            writesTracker->getBytesWritten(),
+                                                            desiredChunkSize);
+        if (splitPoints.empty()) {
+            splitPoints =
+                uassertStatusOK(shardutil::selectChunkSplitPoints(opCtx,
+                                                                  chunk.getShardId(),
+                                                                  nss,
+                                                                  manager->getShardKeyPattern(),
+                                                                  chunkRange,
+                                                                  chunkSizeToUse,
+                                                                  boost::none));
+        } else {
+            LOG(1) << "using " << splitPoints.size() << " split points chosen from "
+                   << "the sampled shard keys of chunk " << redact(chunk.toString());
+        }
 
         if (splitPoints.size() <= 1) {
             // No split points means there isn't enough data to split on; 1 split point means we
@@ -52,7 +52,8 @@ const WriteErrorDetail& WriteOp::getOpError() const {
 
 Status WriteOp::targetWrites(OperationContext* opCtx,
                              const NSTargeter& targeter,
-                             std::vector<TargetedWrite*>* targetedWrites) {
+                             std::vector<TargetedWrite*>* targetedWrites,
+                             const StatusWith<ShardEndpoint>* insertEndpoint) {
     const bool isIndexInsert = _itemRef.getRequest()->isInsertIndexRequest();
 
     auto swEndpoints = [&]() -> StatusWith<std::vector<ShardEndpoint>> {
@@ -63,7 +64,8 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
                 return targeter.targetCollection();
             }
 
-            auto swEndpoint = targeter.targetInsert(opCtx, _itemRef.getDocument());
+            auto swEndpoint = insertEndpoint ? *insertEndpoint
+                                             : targeter.targetInsert(opCtx, _itemRef.getDocument());
             if (!swEndpoint.isOK())
                 return swEndpoint.getStatus();
 
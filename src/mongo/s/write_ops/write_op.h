@@ -114,12 +114,16 @@ public:
      * The ShardTargeter determines the ShardEndpoints to send child writes to, but is not
      * modified by this operation.
      *
+     * If this is an insert whose ShardEndpoint was already targeted, e.g. by
+     * NSTargeter::targetInserts(), 'insertEndpoint' holds it and the targeter is not asked again.
+     *
      * Returns !OK if the targeting process itself fails
      *             (no TargetedWrites will be added, state unchanged)
      */
     Status targetWrites(OperationContext* opCtx,
                         const NSTargeter& targeter,
-                        std::vector<TargetedWrite*>* targetedWrites);
+                        std::vector<TargetedWrite*>* targetedWrites,
+                        const StatusWith<ShardEndpoint>* insertEndpoint = nullptr);
 
     /**
      * Returns the number of child writes that were last targeted.
@@ -37,8 +37,10 @@
 #include "mongo/client/dbclient_base.h"
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
@@ -60,6 +62,44 @@ MONGO_FAIL_POINT_DEFINE(mr_killop_test_fp);
 // 2 GB is the largest support Javascript file size.
 const fileofs kMaxJsFileLength = fileofs(2) * 1024 * 1024 * 1024;
 
+// The number of times a pooled scope is handed out again before it is discarded.
+MONGO_EXPORT_SERVER_PARAMETER(scriptingEngineMaxScopeReuse, int, 10)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "scriptingEngineMaxScopeReuse must not be negative");
+        }
+        return Status::OK();
+    });
+
+// The number of idle scopes each thread keeps for getPooledScopeForCurrentThread(). Every cached
+// scope holds its own JavaScript runtime, so this is best kept small. 0 disables the cache.
+MONGO_EXPORT_SERVER_PARAMETER(scriptingEngineThreadScopeCacheSize, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "scriptingEngineThreadScopeCacheSize must not be negative");
+        }
+        return Status::OK();
+    });
+
+/**
+ * Skips a leading block comment, which is not part of the key for cached functions.
+ */
+const char* skipLeadingComment(const char* code) {
+    if (code[0] == '/' && code[1] == '*') {
+        code += 2;
+        while (code[0] && code[1]) {
+            if (code[0] == '*' && code[1] == '/') {
+                code += 2;
+                break;
+            }
+            code++;
+        }
+    }
+    return code;
+}
+
 const ServiceContext::Decoration<std::unique_ptr<ScriptEngine>> forService =
     ServiceContext::declareDecoration<std::unique_ptr<ScriptEngine>>();
 static std::unique_ptr<ScriptEngine> globalScriptEngine;
@@ -268,16 +308,7 @@ void Scope::loadStored(OperationContext* opCtx, bool ignoreNotConnected) {
 }
 
 ScriptingFunction Scope::createFunction(const char* code) {
-    if (code[0] == '/' && code[1] == '*') {
-        code += 2;
-        while (code[0] && code[1]) {
-            if (code[0] == '*' && code[1] == '/') {
-                code += 2;
-                break;
-            }
-            code++;
-        }
-    }
+    code = skipLeadingComment(code);
 
     FunctionCacheMap::iterator i = _cachedFunctions.find(code);
     if (i != _cachedFunctions.end())
@@ -289,6 +320,10 @@ ScriptingFunction Scope::createFunction(const char* code) {
     return functionNumber;
 }
 
+bool Scope::hasCachedFunction(const char* code) const {
+    return _cachedFunctions.count(skipLeadingComment(code)) > 0;
+}
+
 namespace JSFiles {
 extern const JSFile collection;
 extern const JSFile crud_api;
@@ -326,6 +361,9 @@ void Scope::execCoreFiles() {
 namespace {
 class ScopeCache {
 public:
+    explicit ScopeCache(stdx::function<size_t()> maxPoolSize)
+        : _maxPoolSize(std::move(maxPoolSize)) {}
+
     void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -336,13 +374,17 @@ public:
             return;
         }
 
-        if (scope->getTimesUsed() > kMaxScopeReuse)
+        if (scope->getTimesUsed() > scriptingEngineMaxScopeReuse.load())
             return;  // used too many times to save
 
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
+        const size_t maxPoolSize = _maxPoolSize();
+        if (maxPoolSize == 0)
+            return;
+
+        while (_pools.size() >= maxPoolSize) {
             // prefer to keep recently-used scopes
             _pools.pop_back();
         }
@@ -352,21 +394,36 @@ public:
         _pools.push_front(toStore);
     }
 
-    std::shared_ptr<Scope> tryAcquire(OperationContext* opCtx, const string& poolName) {
+    std::shared_ptr<Scope> tryAcquire(OperationContext* opCtx,
+                                      const string& poolName,
+                                      const char* functionCode) {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
+        // Take the most recently used scope of the pool, unless another one has already compiled
+        // the function the caller is about to create.
+        Pools::iterator found = _pools.end();
         for (Pools::iterator it = _pools.begin(); it != _pools.end(); ++it) {
-            if (it->poolName == poolName) {
-                std::shared_ptr<Scope> scope = it->scope;
-                _pools.erase(it);
-                scope->incTimesUsed();
-                scope->reset();
-                scope->registerOperation(opCtx);
-                return scope;
+            if (it->poolName != poolName)
+                continue;
+
+            if (found == _pools.end())
+                found = it;
+
+            if (!functionCode || it->scope->hasCachedFunction(functionCode)) {
+                found = it;
+                break;
             }
         }
 
-        return std::shared_ptr<Scope>();
+        if (found == _pools.end())
+            return std::shared_ptr<Scope>();
+
+        std::shared_ptr<Scope> scope = found->scope;
+        _pools.erase(found);
+        scope->incTimesUsed();
+        scope->reset();
+        scope->registerOperation(opCtx);
+        return scope;
     }
 
     void clear() {
@@ -381,16 +438,20 @@ private:
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
+    // Note: if the pool size grows large, reconsider choice of datastructure for _pools
+    const stdx::function<size_t()> _maxPoolSize;
 
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
     stdx::mutex _mutex;
 };
 
-ScopeCache scopeCache;
+ScopeCache scopeCache([] { return size_t(10); });
+
+// Scopes created for the current thread can only be used, and destroyed, on that thread, so they
+// are pooled per thread. The pool is destroyed, along with its scopes, when the thread exits.
+thread_local ScopeCache threadScopeCache(
+    [] { return static_cast<size_t>(scriptingEngineThreadScopeCacheSize.load()); });
 }  // anonymous namespace
 
 void ScriptEngine::dropScopeCache() {
@@ -399,11 +460,11 @@ void ScriptEngine::dropScopeCache() {
 
 class PooledScope : public Scope {
 public:
-    PooledScope(const std::string& pool, const std::shared_ptr<Scope>& real)
-        : _pool(pool), _real(real) {}
+    PooledScope(ScopeCache* cache, const std::string& pool, const std::shared_ptr<Scope>& real)
+        : _cache(cache), _pool(pool), _real(real) {}
 
     virtual ~PooledScope() {
-        scopeCache.release(_pool, _real);
+        _cache->release(_pool, _real);
     }
 
     // wrappers for the derived (_real) scope
@@ -534,6 +595,7 @@ protected:
     }
 
 private:
+    ScopeCache* const _cache;
     string _pool;
     std::shared_ptr<Scope> _real;
 };
@@ -541,16 +603,35 @@ private:
 /** Get a scope from the pool of scopes matching the supplied pool name */
 unique_ptr<Scope> ScriptEngine::getPooledScope(OperationContext* opCtx,
                                                const string& db,
-                                               const string& scopeType) {
+                                               const string& scopeType,
+                                               const char* functionCode) {
     const string fullPoolName = db + scopeType;
-    std::shared_ptr<Scope> s = scopeCache.tryAcquire(opCtx, fullPoolName);
+    std::shared_ptr<Scope> s = scopeCache.tryAcquire(opCtx, fullPoolName, functionCode);
     if (!s) {
         s.reset(newScope());
         s->registerOperation(opCtx);
     }
 
     unique_ptr<Scope> p;
-    p.reset(new PooledScope(fullPoolName, s));
+    p.reset(new PooledScope(&scopeCache, fullPoolName, s));
+    p->setLocalDB(db);
+    p->loadStored(opCtx, true);
+    return p;
+}
+
+unique_ptr<Scope> ScriptEngine::getPooledScopeForCurrentThread(OperationContext* opCtx,
+                                                               const string& db,
+                                                               const string& scopeType,
+                                                               const char* functionCode) {
+    const string fullPoolName = db + scopeType;
+    std::shared_ptr<Scope> s = threadScopeCache.tryAcquire(opCtx, fullPoolName, functionCode);
+    if (!s) {
+        s.reset(newScopeForCurrentThread());
+        s->registerOperation(opCtx);
+    }
+
+    unique_ptr<Scope> p;
+    p.reset(new PooledScope(&threadScopeCache, fullPoolName, s));
     p->setLocalDB(db);
     p->loadStored(opCtx, true);
     return p;
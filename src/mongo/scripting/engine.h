@@ -107,6 +107,11 @@ public:
 
     virtual ScriptingFunction createFunction(const char* code);
 
+    /**
+     * Returns true if createFunction() has already compiled 'code' in this scope.
+     */
+    bool hasCachedFunction(const char* code) const;
+
     /**
      * @return 0 on success
      */
@@ -257,11 +262,24 @@ public:
      * @param db The db name
      * @param scopeType A unique id to limit scope sharing.
      *                  This must include authenticated users.
+     * @param functionCode If not null, a scope that has already compiled this function is
+     *                     preferred, so that it does not need to be compiled again.
      * @return the scope
      */
     std::unique_ptr<Scope> getPooledScope(OperationContext* opCtx,
                                           const std::string& db,
-                                          const std::string& scopeType);
+                                          const std::string& scopeType,
+                                          const char* functionCode = nullptr);
+
+    /**
+     * Like getPooledScope(), but the scope runs on the calling thread, as one from
+     * newScopeForCurrentThread() does, and is returned to a pool private to that thread. Without
+     * the scriptingEngineThreadScopeCacheSize server parameter, this is a new scope every time.
+     */
+    std::unique_ptr<Scope> getPooledScopeForCurrentThread(OperationContext* opCtx,
+                                                          const std::string& db,
+                                                          const std::string& scopeType,
+                                                          const char* functionCode = nullptr);
 
     void setScopeInitCallback(void (*func)(Scope&)) {
         _scopeInitCallback = func;
@@ -44,8 +44,10 @@
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/rpc/metadata.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
 #include "mongo/scripting/mozjs/cursor.h"
+#include "mongo/scripting/mozjs/idwrapper.h"
 #include "mongo/scripting/mozjs/implscope.h"
 #include "mongo/scripting/mozjs/objectwrapper.h"
 #include "mongo/scripting/mozjs/session.h"
@@ -108,6 +110,68 @@ DBClientBase* getConnection(JS::CallArgs& args) {
     return getConnectionRef(args).get();
 }
 
+/**
+ * If 'cmdObj' is an insert command whose 'documents' field is a non-empty array of objects, writes
+ * the documents into 'documents' one at a time and the rest of the command into 'body', and
+ * returns true. The documents can then be sent as an OP_MSG document sequence instead of being
+ * converted and copied as part of a single, large command object.
+ */
+bool convertInsertCommand(JSContext* cx,
+                          JS::HandleValue cmdObj,
+                          BSONObj* body,
+                          std::vector<BSONObj>* documents) {
+    ObjectWrapper cmd(cx, cmdObj);
+
+    bool isInsert = false;
+    cmd.enumerate([&](JS::HandleId id) {
+        IdWrapper idw(cx, id);
+        isInsert = idw.isString() && idw.equalsAscii("insert");
+        return false;
+    });
+
+    if (!isInsert || !cmd.hasOwnField("documents"))
+        return false;
+
+    JS::RootedValue documentsValue(cx);
+    cmd.getValue("documents", &documentsValue);
+    if (!documentsValue.isObject())
+        return false;
+
+    JS::RootedObject documentsObj(cx, documentsValue.toObjectOrNull());
+    bool isArray;
+    if (!JS_IsArrayObject(cx, documentsObj, &isArray))
+        uasserted(ErrorCodes::BadValue, "Failure to check is object an array");
+    if (!isArray)
+        return false;
+
+    uint32_t length;
+    if (!JS_GetArrayLength(cx, documentsObj, &length))
+        uasserted(ErrorCodes::BadValue, "Failure to get array length");
+    if (length == 0)
+        return false;
+
+    ObjectWrapper documentsArray(cx, documentsObj);
+    std::vector<BSONObj> converted;
+    converted.reserve(length);
+
+    JS::RootedValue value(cx);
+    int bufferSize = 512;
+    for (uint32_t i = 0; i < length; ++i) {
+        documentsArray.getValue(i, &value);
+        if (!value.isObject())
+            return false;
+
+        // The documents of a batch tend to be of similar size, so each one is written from a
+        // buffer sized for the previous one.
+        converted.push_back(ObjectWrapper(cx, value).toBSON(StringData(), bufferSize));
+        bufferSize = converted.back().objsize() + converted.back().objsize() / 4 + 16;
+    }
+
+    *body = cmd.toBSON("documents");
+    *documents = std::move(converted);
+    return true;
+}
+
 void setCursor(MozJSImplScope* scope,
                JS::HandleObject target,
                std::unique_ptr<DBClientCursor> cursor,
@@ -208,17 +272,29 @@ void MongoBase::Functions::runCommand::call(JSContext* cx, JS::CallArgs args) {
 
     std::string database = ValueWriter(cx, args.get(0)).toString();
 
-    BSONObj cmdObj = ValueWriter(cx, args.get(1)).toBSON();
-
     int queryOptions = ValueWriter(cx, args.get(2)).toInt32();
+
+    BSONObj cmdObj;
+    std::vector<BSONObj> documents;
     BSONObj cmdRes;
-    auto resTuple = conn->runCommandWithTarget(database, cmdObj, cmdRes, conn, queryOptions);
+    std::shared_ptr<DBClientBase> target;
+    if (convertInsertCommand(cx, args.get(1), &cmdObj, &documents)) {
+        auto request = rpc::upconvertRequest(database, std::move(cmdObj), queryOptions);
+        request.sequences.push_back({"documents", std::move(documents)});
+        auto res = conn->runCommandWithTarget(std::move(request), conn);
+        cmdRes = res.first->getCommandReply().getOwned();
+        target = std::move(res.second);
+    } else {
+        cmdObj = ValueWriter(cx, args.get(1)).toBSON();
+        target = std::get<1>(
+            conn->runCommandWithTarget(database, cmdObj, cmdRes, conn, queryOptions));
+    }
 
     // the returned object is not read only as some of our tests depend on modifying it.
     //
     // Also, we make a copy here because we want a copy after we dump cmdRes
     ValueReader(cx, args.rval()).fromBSON(cmdRes.getOwned(), nullptr, false /* read only */);
-    setHiddenMongo(cx, std::get<1>(resTuple), conn.get(), args);
+    setHiddenMongo(cx, target, conn.get(), args);
 }
 
 void MongoBase::Functions::runCommandWithMetadata::call(JSContext* cx, JS::CallArgs args) {
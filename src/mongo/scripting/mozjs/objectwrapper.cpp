@@ -454,18 +454,25 @@ void ObjectWrapper::callMethod(JS::HandleValue fun, JS::MutableHandleValue out)
     callMethod(fun, args, out);
 }
 
-BSONObj ObjectWrapper::toBSON() {
-    if (getScope(_context)->getProto<BSONInfo>().instanceOf(_object) ||
-        getScope(_context)->getProto<DBRefInfo>().instanceOf(_object)) {
+BSONObj ObjectWrapper::toBSON(StringData excludedField, int initialBufferSize) {
+    auto scope = getScope(_context);
+
+    if (scope->getProto<BSONInfo>().instanceOf(_object) ||
+        scope->getProto<DBRefInfo>().instanceOf(_object)) {
         BSONObj* originalBSON = nullptr;
         bool altered;
 
         std::tie(originalBSON, altered) = BSONInfo::originalBSON(_context, _object);
 
         if (originalBSON && !altered)
-            return *originalBSON;
+            return excludedField.empty() ? *originalBSON
+                                         : originalBSON->removeField(excludedField);
     }
 
+    // The _id field is written first, so it is skipped when it comes up among the top-level keys.
+    // Keys are atoms, so comparing ids avoids converting every top-level key to a string.
+    JS::HandleId idId = scope->getInternedStringId(InternedString::_id);
+
     JS::RootedId id(_context);
 
     // INCREDIBLY SUBTLE BEHAVIOR:
@@ -485,7 +492,7 @@ BSONObj ObjectWrapper::toBSON() {
     // debug mode will catch runtime errors, but be aware of how difficult this
     // is to get right and what to look for if one of them bites you.
 
-    BSONObjBuilder b;
+    BSONObjBuilder b(initialBufferSize);
 
     {
         // NOTE: Keep the frames in a scope so that it is clear that
@@ -525,13 +532,16 @@ BSONObj ObjectWrapper::toBSON() {
             id.set(frame.ids[frame.idx++]);
 
             if (frames.size() == 1) {
-                IdWrapper idw(_context, id);
-
-                // TODO: check if it's cheaper to just compare with an interned
-                // string of "_id" rather than with ascii
-                if (idw.isString() && idw.equalsAscii("_id")) {
+                if (id.get() == idId.get()) {
                     continue;
                 }
+
+                if (!excludedField.empty()) {
+                    IdWrapper idw(_context, id);
+                    if (idw.isString() && idw.equalsAscii(excludedField)) {
+                        continue;
+                    }
+                }
             }
 
             // writeField invokes ValueWriter with the frame stack, which will push
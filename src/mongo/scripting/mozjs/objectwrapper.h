@@ -174,8 +174,12 @@ public:
 
     /**
      * Writes a bson object reflecting the contents of the object
+     *
+     * The top-level field 'excludedField' is left out, if not empty. The bson is written from a
+     * buffer of 'initialBufferSize' bytes; callers converting many objects of similar size can pass
+     * the size of the previous one to avoid regrowing the buffer while writing.
      */
-    BSONObj toBSON();
+    BSONObj toBSON(StringData excludedField = StringData(), int initialBufferSize = 512);
 
     JS::HandleObject thisv() {
         return _object;
@@ -32,6 +32,8 @@
 
 #include "mongo/shell/bench.h"
 
+#include <cmath>
+#include <fstream>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclient_cursor.h"
@@ -39,8 +41,11 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
+#include "mongo/stdx/chrono.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/errno_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.h"
 #include "mongo/util/time_support.h"
@@ -315,6 +320,94 @@ Timestamp getLatestClusterTime(DBClientBase* conn) {
  *
  * 'numSecondsInThePast' must be greater than or equal to 0.
  */
+// Each power of two of latencies is split into 2^kLatencySubBucketBits linear sub-buckets.
+const int kLatencySubBucketBits = 5;
+const long long kLatencySubBucketCount = 1LL << kLatencySubBucketBits;
+
+// Latencies of 2^(kMaxLatencyMagnitude + 1) microseconds (about seven weeks) and above all fall
+// in the last bucket.
+const int kMaxLatencyMagnitude = 41;
+const size_t kNumLatencyBuckets =
+    (kMaxLatencyMagnitude - kLatencySubBucketBits + 2) * kLatencySubBucketCount;
+
+size_t latencyBucketIndex(long long micros) {
+    if (micros < kLatencySubBucketCount) {
+        return std::max(micros, 0LL);
+    }
+    const int magnitude = 63 - countLeadingZeros64(micros);
+    if (magnitude > kMaxLatencyMagnitude) {
+        return kNumLatencyBuckets - 1;
+    }
+    const int shift = magnitude - kLatencySubBucketBits;
+    return shift * kLatencySubBucketCount + (micros >> shift);
+}
+
+/**
+ * Returns the largest latency that falls into the bucket at "index".
+ */
+long long latencyBucketHighestValue(size_t index) {
+    const long long i = index;
+    if (i < kLatencySubBucketCount) {
+        return i;
+    }
+    const int shift = i / kLatencySubBucketCount - 1;
+    const long long subBucket = i - shift * kLatencySubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+/**
+ * Appends the count and latency percentiles of "counter" as a subobject called "name", if it
+ * observed any events.
+ */
+void appendLatencyPercentiles(BSONObjBuilder* builder,
+                              StringData name,
+                              const BenchRunEventCounter& counter) {
+    if (counter.getNumEvents() == 0) {
+        return;
+    }
+    BSONObjBuilder percentiles(builder->subobjStart(name));
+    percentiles.append("count", counter.getNumEvents());
+    percentiles.append("p50", counter.getPercentileMicros(50));
+    percentiles.append("p95", counter.getPercentileMicros(95));
+    percentiles.append("p99", counter.getPercentileMicros(99));
+    percentiles.append("p999", counter.getPercentileMicros(99.9));
+    percentiles.append("max", counter.getMaxMicros());
+}
+
+void appendLatencyPercentiles(BSONObjBuilder* builder, const BenchRunStats& stats) {
+    appendLatencyPercentiles(builder, "findOne", stats.findOneCounter);
+    appendLatencyPercentiles(builder, "insert", stats.insertCounter);
+    appendLatencyPercentiles(builder, "delete", stats.deleteCounter);
+    appendLatencyPercentiles(builder, "update", stats.updateCounter);
+    appendLatencyPercentiles(builder, "query", stats.queryCounter);
+    appendLatencyPercentiles(builder, "command", stats.commandCounter);
+}
+
+/**
+ * Describes the "seconds" long interval between two snapshots of the stats of a running activity.
+ */
+BSONObj makeIntervalReport(const BenchRunStats& current,
+                           const BenchRunStats& previous,
+                           double seconds) {
+    BenchRunStats interval = current;
+    interval.findOneCounter.subtract(previous.findOneCounter);
+    interval.insertCounter.subtract(previous.insertCounter);
+    interval.deleteCounter.subtract(previous.deleteCounter);
+    interval.updateCounter.subtract(previous.updateCounter);
+    interval.queryCounter.subtract(previous.queryCounter);
+    interval.commandCounter.subtract(previous.commandCounter);
+
+    BSONObjBuilder builder;
+    builder.append("seconds", seconds);
+    builder.append("totalOps/s", (current.opCount - previous.opCount) / seconds);
+    builder.append("errCount", static_cast<long long>(current.errCount - previous.errCount));
+    {
+        BSONObjBuilder latencies(builder.subobjStart("latencyPercentilesMicros"));
+        appendLatencyPercentiles(&latencies, interval);
+    }
+    return builder.obj();
+}
+
 Timestamp getAClusterTimeSecondsInThePast(DBClientBase* conn, int numSecondsInThePast) {
     invariant(numSecondsInThePast >= 0);
     Timestamp latestTimestamp = getLatestClusterTime(conn);
@@ -328,6 +421,57 @@ BenchRunEventCounter::BenchRunEventCounter() = default;
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _maxMicros = std::max(_maxMicros, other._maxMicros);
+
+    if (other._latencyBuckets.empty()) {
+        return;
+    }
+    _latencyBuckets.resize(kNumLatencyBuckets);
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+        _latencyBuckets[i] += other._latencyBuckets[i];
+    }
+}
+
+void BenchRunEventCounter::subtract(const BenchRunEventCounter& earlier) {
+    _numEvents -= earlier._numEvents;
+    _totalTimeMicros -= earlier._totalTimeMicros;
+
+    if (earlier._latencyBuckets.empty()) {
+        return;
+    }
+    // The exact maximum of the remaining events is unknown, so use the top of their last bucket.
+    _latencyBuckets.resize(kNumLatencyBuckets);
+    _maxMicros = 0;
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+        _latencyBuckets[i] -= earlier._latencyBuckets[i];
+        if (_latencyBuckets[i] > 0) {
+            _maxMicros = latencyBucketHighestValue(i);
+        }
+    }
+}
+
+void BenchRunEventCounter::_recordLatency(long long timeMicros) {
+    if (_latencyBuckets.empty()) {
+        _latencyBuckets.resize(kNumLatencyBuckets);
+    }
+    ++_latencyBuckets[latencyBucketIndex(timeMicros)];
+    _maxMicros = std::max(_maxMicros, timeMicros);
+}
+
+long long BenchRunEventCounter::getPercentileMicros(double percentile) const {
+    if (_numEvents <= 0) {
+        return 0;
+    }
+    const long long rank =
+        std::max(1LL, static_cast<long long>(std::ceil(percentile / 100 * _numEvents)));
+    long long seen = 0;
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+        seen += _latencyBuckets[i];
+        if (seen >= rank) {
+            return std::min(latencyBucketHighestValue(i), _maxMicros);
+        }
+    }
+    return _maxMicros;
 }
 
 void BenchRunStats::updateFrom(const BenchRunStats& other) {
@@ -372,6 +516,10 @@ void BenchRunConfig::initializeToDefaults() {
     throwGLE = false;
     breakOnTrap = true;
     randomSeed = 1314159265358979323;
+
+    targetOpsPerSecond = 0;
+    reportIntervalSeconds = 0;
+    resultsFile = "";
 }
 
 BenchRunConfig* BenchRunConfig::createFromBson(const BSONObj& args) {
@@ -551,6 +699,20 @@ BenchRunOp opFromBson(const BSONObj& op) {
             myOp.target = arg.String();
         } else if (name == "throwGLE") {
             myOp.throwGLE = arg.trueValue();
+        } else if (name == "transaction") {
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "Field 'transaction' is only valid for command op type. "
+                                     "Op type is "
+                                  << opType,
+                    opType == "command");
+            const auto mode = arg.valueStringData();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field 'transaction' should be \"start\" or \"continue\", "
+                                     "instead it's: "
+                                  << arg,
+                    arg.type() == String && (mode == "start" || mode == "continue"));
+            myOp.txnMode =
+                mode == "start" ? BenchRunOp::TxnMode::kStart : BenchRunOp::TxnMode::kContinue;
         } else if (name == "update") {
             uassert(34391,
                     str::stream() << "Field 'update' is only valid for update op type. Op type is "
@@ -696,6 +858,32 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             delayMillisOnFailedOperation = Milliseconds(arg.numberInt());
+        } else if (name == "targetOpsPerSecond") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be a number. Type is "
+                                  << typeName(arg.type()),
+                    arg.isNumber());
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' cannot be negative. Value is "
+                                  << arg.number(),
+                    arg.number() >= 0);
+            targetOpsPerSecond = arg.number();
+        } else if (name == "reportIntervalSeconds") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be a number. Type is "
+                                  << typeName(arg.type()),
+                    arg.isNumber());
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' cannot be negative. Value is "
+                                  << arg.number(),
+                    arg.number() >= 0);
+            reportIntervalSeconds = arg.number();
+        } else if (name == "resultsFile") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be a string. Type is "
+                                  << typeName(arg.type()),
+                    arg.type() == String);
+            resultsFile = arg.String();
         } else if (name == "hideResults") {
             hideResults = arg.trueValue();
         } else if (name == "handleErrors") {
@@ -739,6 +927,12 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
             uassert(34376, "benchRun passed an unsupported configuration field", false);
         }
     }
+
+    for (const auto& op : ops) {
+        uassert(ErrorCodes::InvalidOptions,
+                "benchRun ops with a 'transaction' field require useSessions",
+                op.txnMode == BenchRunOp::TxnMode::kNone || useSessions);
+    }
 }
 
 MONGO_DEFINE_SHIM(BenchRunConfig::createConnectionImpl);
@@ -830,6 +1024,11 @@ BenchRunWorker::BenchRunWorker(size_t id,
 
 BenchRunWorker::~BenchRunWorker() = default;
 
+BenchRunStats BenchRunWorker::statsSnapshot() const {
+    stdx::lock_guard<stdx::mutex> lk(_statsMutex);
+    return _stats;
+}
+
 void BenchRunWorker::start() {
     stdx::thread([this] { run(); }).detach();
 }
@@ -878,12 +1077,42 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
         }
     });
 
+    // In open-loop mode each op gets an arrival time, and the gaps between arrivals are drawn
+    // from an exponential distribution with the mean that gives this worker its share of the
+    // target rate.
+    const bool openLoop = _config->targetOpsPerSecond > 0;
+    const double meanArrivalGapMicros =
+        openLoop ? 1000 * 1000 * _config->parallel / _config->targetOpsPerSecond : 0;
+    auto nextArrival = stdx::chrono::steady_clock::now();
+
     while (!shouldStop()) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
                 break;
 
-            opState.stats = shouldCollectStats() ? &_stats : &_statsBlackHole;
+            if (openLoop) {
+                nextArrival += stdx::chrono::microseconds(static_cast<long long>(
+                    -std::log(1 - _rng.nextCanonicalDouble()) * meanArrivalGapMicros));
+                auto now = stdx::chrono::steady_clock::now();
+                while (now < nextArrival && !shouldStop()) {
+                    stdx::this_thread::sleep_for(
+                        std::min<stdx::chrono::steady_clock::duration>(nextArrival - now,
+                                                                        stdx::chrono::seconds(1)));
+                    now = stdx::chrono::steady_clock::now();
+                }
+                if (shouldStop())
+                    break;
+                opState.scheduleLag = now > nextArrival
+                    ? Microseconds(durationCount<Microseconds>(now - nextArrival))
+                    : Microseconds{0};
+            }
+
+            const bool collectStats = shouldCollectStats();
+            opState.stats = collectStats ? &_stats : &_statsBlackHole;
+            stdx::unique_lock<stdx::mutex> statsLock(_statsMutex, stdx::defer_lock);
+            if (collectStats) {
+                statsLock.lock();
+            }
 
             try {
                 op.executeOnce(conn, lsid, *_config, &opState);
@@ -935,6 +1164,12 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                 ++opState.stats->errCount;
             }
 
+            // Ops that trace no events don't carry their lag over to the next op.
+            opState.scheduleLag = Microseconds{0};
+            if (statsLock.owns_lock()) {
+                statsLock.unlock();
+            }
+
             if (++count % 100 == 0 && !op.useWriteCmd) {
                 conn->getLastError();
             }
@@ -982,7 +1217,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                 }
                 invariant(qr->validate());
 
-                BenchRunEventTrace _bret(&state->stats->findOneCounter);
+                BenchRunEventTrace _bret(&state->stats->findOneCounter, &state->scheduleLag);
                 boost::optional<TxnNumber> txnNumberForOp;
                 if (config.useSnapshotReads) {
                     ++state->txnNumber;
@@ -992,7 +1227,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                 runQueryWithReadCommands(
                     conn, lsid, txnNumberForOp, std::move(qr), Milliseconds(0), &result);
             } else {
-                BenchRunEventTrace _bret(&state->stats->findOneCounter);
+                BenchRunEventTrace _bret(&state->stats->findOneCounter, &state->scheduleLag);
                 result = conn->findOne(
                     this->ns, fixedQuery, nullptr, DBClientCursor::QueryOptionLocal_forceOpQuery);
             }
@@ -1001,21 +1236,38 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                 log() << "Result from benchRun thread [findOne] : " << result;
         } break;
         case OpType::COMMAND: {
+            boost::optional<TxnNumber> txnNumberForOp;
+            int options = this->options;
+            if (this->txnMode != TxnMode::kNone) {
+                invariant(lsid);
+                if (this->txnMode == TxnMode::kStart) {
+                    ++state->txnNumber;
+                    state->inProgressMultiStatementTxn = true;
+                    options |= kStartTransactionOption;
+                }
+                txnNumberForOp = state->txnNumber;
+                options |= kMultiStatementTransactionOption;
+            }
+
+            const BSONObj cmdObj = fixQuery(this->command, *state->bsonTemplateEvaluator);
             bool ok;
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->commandCounter);
-                ok = runCommandWithSession(conn,
-                                           this->ns,
-                                           fixQuery(this->command, *state->bsonTemplateEvaluator),
-                                           this->options,
-                                           lsid,
-                                           &result);
+                BenchRunEventTrace _bret(&state->stats->commandCounter, &state->scheduleLag);
+                ok = runCommandWithSession(
+                    conn, this->ns, cmdObj, options, lsid, txnNumberForOp, &result);
             }
             if (!ok) {
                 ++state->stats->errCount;
             }
 
+            const auto cmdName = cmdObj.firstElement().fieldNameStringData();
+            if (txnNumberForOp &&
+                (cmdName == "commitTransaction" || cmdName == "abortTransaction")) {
+                // The transaction is over, or was aborted by the failed attempt to commit it.
+                state->inProgressMultiStatementTxn = false;
+            }
+
             if (!result["cursor"].eoo()) {
                 // The command returned a cursor, so iterate all results.
                 auto cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(result));
@@ -1034,8 +1286,11 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                             runCommandWithSession(conn,
                                                   this->ns,
                                                   getMoreRequest.toBSON(),
-                                                  kNoOptions,
+                                                  txnNumberForOp
+                                                      ? kMultiStatementTransactionOption
+                                                      : kNoOptions,
                                                   lsid,
+                                                  txnNumberForOp,
                                                   &getMoreCommandResult));
                     cursorResponse =
                         uassertStatusOK(CursorResponse::parseFromBSON(getMoreCommandResult));
@@ -1083,7 +1338,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
 
                 invariant(qr->validate());
 
-                BenchRunEventTrace _bret(&state->stats->queryCounter);
+                BenchRunEventTrace _bret(&state->stats->queryCounter, &state->scheduleLag);
                 boost::optional<TxnNumber> txnNumberForOp;
                 if (config.useSnapshotReads) {
                     ++state->txnNumber;
@@ -1104,7 +1359,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
             } else {
                 // Use special query function for exhaust query option.
                 if (this->options & QueryOption_Exhaust) {
-                    BenchRunEventTrace _bret(&state->stats->queryCounter);
+                    BenchRunEventTrace _bret(&state->stats->queryCounter, &state->scheduleLag);
                     stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                     count =
                         conn->query(castedDoNothing,
@@ -1113,7 +1368,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                                     &this->projection,
                                     this->options | DBClientCursor::QueryOptionLocal_forceOpQuery);
                 } else {
-                    BenchRunEventTrace _bret(&state->stats->queryCounter);
+                    BenchRunEventTrace _bret(&state->stats->queryCounter, &state->scheduleLag);
                     std::unique_ptr<DBClientCursor> cursor(
                         conn->query(this->ns,
                                     fixedQuery,
@@ -1138,7 +1393,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
         case OpType::UPDATE: {
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->updateCounter);
+                BenchRunEventTrace _bret(&state->stats->updateCounter, &state->scheduleLag);
                 BSONObj query = fixQuery(this->query, *state->bsonTemplateEvaluator);
                 BSONObj update = fixQuery(this->update, *state->bsonTemplateEvaluator);
 
@@ -1189,7 +1444,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
         case OpType::INSERT: {
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->insertCounter);
+                BenchRunEventTrace _bret(&state->stats->insertCounter, &state->scheduleLag);
 
                 BSONObj insertDoc;
                 if (this->useWriteCmd) {
@@ -1253,7 +1508,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
         case OpType::REMOVE: {
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->deleteCounter);
+                BenchRunEventTrace _bret(&state->stats->deleteCounter, &state->scheduleLag);
                 BSONObj predicate = fixQuery(this->query, *state->bsonTemplateEvaluator);
                 if (this->useWriteCmd) {
                     BSONObjBuilder builder;
@@ -1430,6 +1685,16 @@ BenchRunStats BenchRunner::gatherStats() const {
     return stats;
 }
 
+BenchRunStats BenchRunner::snapshotStats() const {
+    BenchRunStats stats;
+
+    for (const auto& worker : _workers) {
+        stats.updateFrom(worker->statsSnapshot());
+    }
+
+    return stats;
+}
+
 BSONObj BenchRunner::finish(BenchRunner* runner) {
     runner->stop();
 
@@ -1482,8 +1747,31 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     buf.append("queries", stats.queryCounter.getNumEvents());
     buf.append("commands", stats.commandCounter.getNumEvents());
 
+    {
+        BSONObjBuilder latencies(buf.subobjStart("latencyPercentilesMicros"));
+        appendLatencyPercentiles(&latencies, stats);
+    }
+
+    if (!runner->_intervalReports.empty()) {
+        buf.append("intervals", runner->_intervalReports);
+    }
+
     BSONObj zoo = buf.obj();
 
+    const auto& resultsFile = runner->config().resultsFile;
+    if (!resultsFile.empty()) {
+        std::ofstream out(resultsFile, std::ios::out | std::ios::trunc);
+        out << zoo.jsonString(Strict, 1) << std::endl;
+        if (!out) {
+            const auto errorMessage = errnoWithDescription();
+            delete runner;
+            uasserted(ErrorCodes::FileNotOpen,
+                      str::stream() << "Couldn't write benchRun results to " << resultsFile
+                                    << ": "
+                                    << errorMessage);
+        }
+    }
+
     delete runner;
     return zoo;
 }
@@ -1500,7 +1788,25 @@ BSONObj BenchRunner::benchRunSync(const BSONObj& argsFake, void* data) {
     OID oid = OID(start.firstElement().String());
     BenchRunner* runner = BenchRunner::get(oid);
 
-    sleepmillis((int)(1000.0 * runner->config().seconds));
+    const double seconds = runner->config().seconds;
+    const double reportIntervalSeconds = runner->config().reportIntervalSeconds;
+    if (reportIntervalSeconds <= 0) {
+        sleepmillis((int)(1000.0 * seconds));
+        return benchFinish(start, data);
+    }
+
+    BenchRunStats previousStats;
+    for (double elapsed = 0; elapsed < seconds;) {
+        const double intervalSeconds = std::min(reportIntervalSeconds, seconds - elapsed);
+        sleepmillis((int)(1000.0 * intervalSeconds));
+        elapsed += intervalSeconds;
+
+        auto currentStats = runner->snapshotStats();
+        auto report = makeIntervalReport(currentStats, previousStats, intervalSeconds);
+        log() << "benchRun interval ending at " << elapsed << "s: " << report;
+        runner->_intervalReports.push_back(std::move(report));
+        previousStats = std::move(currentStats);
+    }
 
     return benchFinish(start, data);
 }
@@ -30,6 +30,7 @@
 
 #include <boost/optional.hpp>
 #include <string>
+#include <vector>
 
 #include "mongo/base/shim.h"
 #include "mongo/client/dbclient_base.h"
@@ -38,6 +39,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/timer.h"
 
 namespace pcrecpp {
@@ -83,6 +85,11 @@ struct BenchRunOp {
         // Transaction state
         TxnNumber txnNumber = 0;
         bool inProgressMultiStatementTxn = false;
+
+        // In open-loop mode, how long the operation about to run was held back past its scheduled
+        // arrival because the worker was still busy. The first event the operation traces is
+        // charged with it, so latencies include the queueing a closed-loop run would hide.
+        Microseconds scheduleLag{0};
     };
 
     void executeOnce(DBClientBase* conn,
@@ -136,6 +143,12 @@ struct BenchRunOp {
     // resources that a snapshot transaction would hold for a time.
     int maxRandomMillisecondDelayBeforeGetMore{0};
 
+    // Only used for command ops when 'useSessions' is set. Starts a new multi-statement
+    // transaction with the command, or runs the command in the transaction the last 'kStart'
+    // command on the same worker started. Commit or abort with a 'kContinue' command.
+    enum class TxnMode { kNone, kStart, kContinue };
+    TxnMode txnMode = TxnMode::kNone;
+
     // This is an owned copy of the raw operation. All unowned members point into this.
     BSONObj myBsonOp;
 };
@@ -220,6 +233,24 @@ public:
      */
     Milliseconds delayMillisOnFailedOperation{0};
 
+    /**
+     * When greater than zero, run open-loop: ops arrive at this overall rate, spread over the
+     * workers with exponentially distributed gaps (a Poisson process), rather than each worker
+     * starting its next op as soon as the last one returns.
+     */
+    double targetOpsPerSecond{0};
+
+    /**
+     * When greater than zero, benchRun() logs throughput and latency percentiles for each
+     * interval of this length, and returns them in the 'intervals' array of its result.
+     */
+    double reportIntervalSeconds{0};
+
+    /**
+     * When not empty, the result of the run is also written as JSON to this file.
+     */
+    std::string resultsFile;
+
     /// Base random seed for threads
     int64_t randomSeed;
 
@@ -256,6 +287,9 @@ private:
 /**
  * An event counter for events that have an associated duration.
  *
+ * Durations are also kept in a log-linear histogram, in the manner of an HDR histogram, so that
+ * percentiles can be reported with a relative error of about 3%.
+ *
  * Not thread safe. Expected use is one instance per thread during parallel execution.
  */
 class BenchRunEventCounter {
@@ -267,6 +301,12 @@ public:
      */
     void updateFrom(const BenchRunEventCounter& other);
 
+    /**
+     * Conceptually the equivalent of "-=". Removes the events of "earlier", an earlier copy of
+     * this counter, leaving the events counted since.
+     */
+    void subtract(const BenchRunEventCounter& earlier);
+
     /**
      * Count one instance of the event, which took "timeMicros" microseconds.
      */
@@ -277,6 +317,7 @@ public:
         }
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        _recordLatency(timeMicros);
     }
 
     /**
@@ -293,9 +334,28 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the duration in microseconds that "percentile" percent of the observed events took at
+     * most, or zero if there were no events.
+     */
+    long long getPercentileMicros(double percentile) const;
+
+    /**
+     * Get the longest observed duration in microseconds.
+     */
+    long long getMaxMicros() const {
+        return _maxMicros;
+    }
+
 private:
+    void _recordLatency(long long timeMicros);
+
     long long _totalTimeMicros{0};
     long long _numEvents{0};
+    long long _maxMicros{0};
+
+    // Allocated on the first event, so that counters which never see one stay small.
+    std::vector<long long> _latencyBuckets;
 };
 
 /**
@@ -319,6 +379,16 @@ public:
         initialize(eventCounter, eventCounter, false);
     }
 
+    /**
+     * Also charges the event with "*scheduleLag", the time it waited to start in open-loop mode,
+     * and resets it to zero so that later events of the same operation aren't charged again.
+     */
+    BenchRunEventTrace(BenchRunEventCounter* eventCounter, Microseconds* scheduleLag)
+        : _scheduleLagMicros(durationCount<Microseconds>(*scheduleLag)) {
+        *scheduleLag = Microseconds{0};
+        initialize(eventCounter, eventCounter, false);
+    }
+
     BenchRunEventTrace(BenchRunEventCounter* successCounter,
                        BenchRunEventCounter* failCounter,
                        bool defaultToFailure = true) {
@@ -326,7 +396,8 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)
+            ->countOne(_timer.micros() + _scheduleLagMicros);
     }
 
     void succeed() {
@@ -346,6 +417,7 @@ private:
     }
 
     Timer _timer;
+    long long _scheduleLagMicros{0};
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -491,6 +563,11 @@ public:
         return _stats;
     }
 
+    /**
+     * Get a copy of the run statistics collected so far, while the worker is still running.
+     */
+    BenchRunStats statsSnapshot() const;
+
 private:
     /// The main method of the worker, executed inside the thread launched by start().
     void run();
@@ -514,7 +591,9 @@ private:
     // Dummy stats to use before observation period.
     BenchRunStats _statsBlackHole;
 
-    // Actual stats collected during the run
+    // Actual stats collected during the run. Held while an op that updates them runs, so that
+    // statsSnapshot() never sees them mid-update.
+    mutable stdx::mutex _statsMutex;
     BenchRunStats _stats;
 };
 
@@ -574,6 +653,11 @@ public:
      */
     BenchRunStats gatherStats() const;
 
+    /**
+     * Get the event data collected so far by the workers of a running activity.
+     */
+    BenchRunStats snapshotStats() const;
+
     OID oid() const {
         return _oid;
     }
@@ -598,6 +682,9 @@ private:
     boost::optional<Timer> _brTimer;
     unsigned long long _microsElapsed;
 
+    // Per-interval reports logged during the run, when 'reportIntervalSeconds' is set.
+    std::vector<BSONObj> _intervalReports;
+
     std::unique_ptr<BenchRunConfig> _config;
     std::vector<std::unique_ptr<BenchRunWorker>> _workers;
 };
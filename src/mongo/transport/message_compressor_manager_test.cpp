@@ -31,6 +31,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/message.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
@@ -40,6 +42,11 @@
 #include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+#include "mongo/transport/message_compressor_zstd.h"
+#endif
 
 #include <string>
 #include <vector>
@@ -241,6 +248,34 @@ TEST(ZlibMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<ZlibMessageCompressor>());
 }
 
+#ifdef MONGO_CONFIG_HAVE_ZSTD
+TEST(ZstdMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, FidelityAtNonDefaultLevel) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("zstdNetworkCompressionLevel");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString("19"));
+    ON_BLOCK_EXIT([&] { param->second->setFromString("3").transitional_ignore(); });
+
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>());
+}
+
+TEST(ZstdMessageCompressor, RejectsInvalidLevel) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("zstdNetworkCompressionLevel");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_NOT_OK(param->second->setFromString("0"));
+    ASSERT_NOT_OK(param->second->setFromString("100"));
+}
+#endif
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
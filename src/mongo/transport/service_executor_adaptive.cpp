@@ -41,6 +41,7 @@
 #include "mongo/transport/thread_idle_callback.h"
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/duration.h"
+#include "mongo/util/errno_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
@@ -48,6 +49,11 @@
 
 #include <asio.hpp>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace mongo {
 namespace transport {
 namespace {
@@ -79,6 +85,10 @@ MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorIdlePctThreshold, int, 60);
 // value.
 MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorRecursionLimit, int, 8);
 
+// Pins each worker thread to a core (Linux only) so that a thread keeps its caches warm, and
+// reports queue latency per core. Only read when the executor starts.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(adaptiveServiceExecutorPinWorkerThreadsToCores, bool, false);
+
 constexpr auto kTotalQueued = "totalQueued"_sd;
 constexpr auto kTotalExecuted = "totalExecuted"_sd;
 constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
@@ -93,6 +103,7 @@ constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
 constexpr auto kStarvation = "starvation"_sd;
 constexpr auto kReserveMinimum = "belowReserveMinimum"_sd;
 constexpr auto kThreadReasons = "threadCreationCauses"_sd;
+constexpr auto kQueueLatencyByCore = "queueLatencyByCore"_sd;
 
 int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
     invariant(tickSource->getTicksPerSecond() >= 1000000);
@@ -145,8 +156,34 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return adaptiveServiceExecutorRecursionLimit.load();
     }
+
+    bool pinWorkerThreadsToCores() const final {
+        return adaptiveServiceExecutorPinWorkerThreadsToCores;
+    }
 };
 
+// Returns the cores this process is allowed to run on.
+std::vector<int> getPinnableCores() {
+    std::vector<int> cores;
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        warning() << "Failed to read the CPU affinity mask, worker threads will not be pinned: "
+                  << errnoWithDescription();
+        return cores;
+    }
+    for (int core = 0; core < CPU_SETSIZE; core++) {
+        if (CPU_ISSET(core, &cpuSet)) {
+            cores.push_back(core);
+        }
+    }
+#else
+    warning() << "Pinning worker threads to cores is not supported on this platform";
+#endif
+    return cores;
+}
+
 }  // namespace
 
 thread_local ServiceExecutorAdaptive::ThreadState* ServiceExecutorAdaptive::_localThreadState =
@@ -170,6 +207,13 @@ ServiceExecutorAdaptive::~ServiceExecutorAdaptive() {
 
 Status ServiceExecutorAdaptive::start() {
     invariant(!_isRunning.load());
+    if (_config->pinWorkerThreadsToCores()) {
+        _pinnableCores = getPinnableCores();
+        if (!_pinnableCores.empty()) {
+            _coreMetrics = std::vector<CoreMetrics>(_pinnableCores.back() + 1);
+        }
+    }
+
     _isRunning.store(true);
     _controllerThread = stdx::thread(&ServiceExecutorAdaptive::_controllerThreadRoutine, this);
     for (auto i = 0; i < _config->reservedThreads(); i++) {
@@ -219,6 +263,12 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
             ._totalSpentQueued.addAndFetch(start - scheduleTime);
 
+        if (_localThreadState->core != -1) {
+            auto& coreMetrics = _coreMetrics[_localThreadState->core];
+            coreMetrics._totalExecuted.addAndFetch(1);
+            coreMetrics._totalSpentQueued.addAndFetch(start - scheduleTime);
+        }
+
         if (_localThreadState->recursionDepth++ == 0) {
             _localThreadState->executing.markRunning();
             _threadsInUse.addAndFetch(1);
@@ -503,6 +553,26 @@ Milliseconds ServiceExecutorAdaptive::_getThreadJitter() const {
     return Milliseconds{jitter};
 }
 
+int ServiceExecutorAdaptive::_pinCurrentThreadToCore() {
+    if (_pinnableCores.empty()) {
+        return -1;
+    }
+
+    const auto core = _pinnableCores[_nextPinnedCore.fetchAndAdd(1) % _pinnableCores.size()];
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+    const auto ret = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (ret != 0) {
+        warning() << "Failed to pin worker thread to core " << core << ": "
+                  << errnoWithDescription(ret);
+        return -1;
+    }
+#endif
+    return core;
+}
+
 void ServiceExecutorAdaptive::_accumulateTaskMetrics(MetricsArray* outArray,
                                                      const MetricsArray& inputArray) const {
     for (auto it = inputArray.begin(); it != inputArray.end(); ++it) {
@@ -559,6 +629,10 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         setThreadName(threadName);
     }
 
+    if (_config->pinWorkerThreadsToCores()) {
+        state->core = _pinCurrentThreadToCore();
+    }
+
     log() << "Started new database worker thread " << threadId;
 
     bool guardThreadsRunning = true;
@@ -703,6 +777,21 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
         subSection.doneFast();
     }
     metricsByTask.doneFast();
+
+    if (!_coreMetrics.empty()) {
+        BSONObjBuilder byCore(section.subobjStart(kQueueLatencyByCore));
+        for (size_t core = 0; core < _coreMetrics.size(); core++) {
+            const auto executed = _coreMetrics[core]._totalExecuted.load();
+            if (executed == 0) {
+                continue;
+            }
+            BSONObjBuilder subSection(byCore.subobjStart(std::to_string(core)));
+            subSection << kTotalExecuted << executed << kTotalTimeQueuedUs
+                       << ticksToMicros(_coreMetrics[core]._totalSpentQueued.load(), _tickSource);
+            subSection.doneFast();
+        }
+        byCore.doneFast();
+    }
     section.doneFast();
 }
 
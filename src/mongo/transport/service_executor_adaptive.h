@@ -79,6 +79,12 @@ public:
         // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
         // before stack unwinding is forced.
         virtual int recursionLimit() const = 0;
+
+        // Whether each worker thread is pinned to one of the cores the process may run on, with
+        // the queue latency of the tasks it runs reported per core.
+        virtual bool pinWorkerThreadsToCores() const {
+            return false;
+        }
     };
 
     explicit ServiceExecutorAdaptive(ServiceContext* ctx, ReactorHandle reactor);
@@ -188,6 +194,17 @@ private:
         MetricsArray threadMetrics;
         std::int64_t markIdleCounter = 0;
         int recursionDepth = 0;
+
+        // The core this thread is pinned to, or -1 if it isn't pinned.
+        int core = -1;
+    };
+
+    struct CoreMetrics {
+        AtomicWord<int64_t> _totalExecuted{0};
+        AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+
+        // Keeps the counters of neighbouring cores off each other's cache lines.
+        char _pad[64 - sizeof(int64_t) - sizeof(TickSource::Tick)];
     };
 
     using ThreadList = stdx::list<ThreadState>;
@@ -198,6 +215,7 @@ private:
     void _controllerThreadRoutine();
     bool _isStarved() const;
     Milliseconds _getThreadJitter() const;
+    int _pinCurrentThreadToCore();
 
     void _accumulateTaskMetrics(MetricsArray* outArray, const MetricsArray& inputArray) const;
     void _accumulateAllTaskMetrics(MetricsArray* outputMetricsArray,
@@ -244,6 +262,12 @@ private:
     stdx::condition_variable _scheduleCondition;
 
     MetricsArray _accumulatedMetrics;
+
+    // When pinWorkerThreadsToCores() is set, worker threads are assigned round-robin to the
+    // cores in _pinnableCores, and _coreMetrics is indexed by core number.
+    std::vector<int> _pinnableCores;
+    AtomicWord<unsigned> _nextPinnedCore{0};
+    std::vector<CoreMetrics> _coreMetrics;
 };
 
 }  // namespace transport
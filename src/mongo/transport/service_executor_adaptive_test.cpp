@@ -104,6 +104,12 @@ struct RecursionOptions : public ServiceExecutorAdaptive::Options {
     }
 };
 
+struct PinnedOptions : public TestOptions {
+    bool pinWorkerThreadsToCores() const final {
+        return true;
+    }
+};
+
 class ServiceExecutorAdaptiveFixture : public unittest::Test {
 protected:
     void setUp() override {
@@ -390,5 +396,32 @@ TEST_F(ServiceExecutorAdaptiveFixture, TestDeferredTasks) {
     waitForCallback(0);
 }
 
+#ifdef __linux__
+/*
+ * This tests that tasks run by pinned worker threads are reported under the core they ran on.
+ */
+TEST_F(ServiceExecutorAdaptiveFixture, TestPinnedThreadsReportQueueLatencyByCore) {
+    auto exec = makeAndStartExecutor<PinnedOptions>();
+    auto guard = MakeGuard([&] { ASSERT_OK(exec->shutdown(config->workerThreadRunTime() * 2)); });
+
+    waitFor.store(1);
+    ASSERT_OK(exec->schedule(
+        notifyCallback, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+    waitForCallback(0);
+
+    BSONObjBuilder bob;
+    exec->appendStats(&bob);
+    auto byCore = bob.obj()["serviceExecutorTaskStats"]["queueLatencyByCore"];
+    ASSERT_EQ(byCore.type(), Object);
+
+    long long executed = 0;
+    for (auto&& core : byCore.Obj()) {
+        executed += core["totalExecuted"].numberLong();
+    }
+    // The task scheduled by makeAndStartExecutor() and the one above.
+    ASSERT_EQ(executed, 2);
+}
+#endif
+
 }  // namespace
 }  // namespace mongo
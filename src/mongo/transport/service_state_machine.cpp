@@ -37,6 +37,7 @@
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/service_entry_point.h"
@@ -87,6 +88,17 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Build the OP_MSG request that produces the next reply of an exhaust stream. Its id is that of
+// the reply just sent, so the next reply is marked as responding to it.
+Message makeExhaustMessage(const Message& response, const BSONObj& nextInvocation) {
+    OpMsgBuilder builder;
+    builder.setBody(nextInvocation);
+    auto message = builder.finish();
+    message.header().setId(response.header().getId());
+    OpMsg::setFlag(&message, OpMsg::kExhaustSupported);
+    return message;
+}
+
 }  // namespace
 
 using transport::ServiceExecutor;
@@ -359,7 +371,10 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
 
     auto& compressorMgr = MessageCompressorManager::forSession(_session());
 
-    _compressorId = boost::none;
+    // Replies streamed for an exhaust cursor are compressed like the request that started it.
+    if (!_inExhaust) {
+        _compressorId = boost::none;
+    }
     if (_inMessage.operation() == dbCompressed) {
         MessageCompressorId compressorId;
         auto swm = compressorMgr.decompressMessage(_inMessage, &compressorId);
@@ -391,6 +406,9 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
         // If this is an exhaust cursor, don't source more Messages
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
             _inExhaust = true;
+        } else if (dbresponse.nextInvocation) {
+            _inExhaust = true;
+            _inMessage = makeExhaustMessage(toSink, *dbresponse.nextInvocation);
         } else {
             _inExhaust = false;
             _inMessage.reset();
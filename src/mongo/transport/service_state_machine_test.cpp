@@ -79,7 +79,14 @@ public:
         if (_uassertInHandler)
             uassert(40469, "Synthetic uassert failure", false);
 
-        return DbResponse{builder.finish()};
+        _lastRequest = request;
+        DbResponse response{builder.finish()};
+        if (_exhaustReplies > 0) {
+            --_exhaustReplies;
+            response.nextInvocation = BSON("ping" << 1);
+            OpMsg::setFlag(&response.response, OpMsg::kMoreToCome);
+        }
+        return response;
     }
 
     void endAllSessions(transport::Session::TagMask tags) override {}
@@ -100,6 +107,14 @@ public:
         _uassertInHandler = true;
     }
 
+    void setExhaustReplies(int replies) {
+        _exhaustReplies = replies;
+    }
+
+    const Message& lastRequest() const {
+        return _lastRequest;
+    }
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -109,6 +124,8 @@ public:
 private:
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    int _exhaustReplies = 0;
+    Message _lastRequest;
 };
 
 using namespace transport;
@@ -339,6 +356,38 @@ TEST_F(ServiceStateMachineFixture, TestOkaySimpleCommand) {
     checkPingOk();
 }
 
+TEST_F(ServiceStateMachineFixture, TestOpMsgExhaust) {
+    _sep->setExhaustReplies(2);
+
+    ASSERT_EQ(_ssm->state(), State::Created);
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    // The first two replies each leave the state machine processing the next invocation rather
+    // than sourcing a request from the client.
+    int32_t lastReplyId = 0;
+    for (int i = 0; i < 2; ++i) {
+        _ssm->runNext();
+        ASSERT_EQ(_ssm->state(), State::Process);
+        auto reply = _tl->getLastSunk();
+        ASSERT_TRUE(OpMsg::isFlagSet(reply, OpMsg::kMoreToCome));
+        if (i > 0) {
+            ASSERT_EQ(reply.header().getResponseToMsgId(), lastReplyId);
+        }
+        lastReplyId = reply.header().getId();
+        ASSERT_TRUE(_tl->ranSink());
+    }
+
+    // The last reply ends the stream.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Source);
+    ASSERT_TRUE(OpMsg::isFlagSet(_sep->lastRequest(), OpMsg::kExhaustSupported));
+    auto reply = _tl->getLastSunk();
+    ASSERT_FALSE(OpMsg::isFlagSet(reply, OpMsg::kMoreToCome));
+    ASSERT_EQ(reply.header().getResponseToMsgId(), lastReplyId);
+    ASSERT_BSONOBJ_EQ(OpMsg::parse(reply).body, BSON("ok" << 1));
+}
+
 TEST_F(ServiceStateMachineFixture, TestThrowHandling) {
     _sep->setUassertInHandler();
 
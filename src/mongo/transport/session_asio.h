@@ -32,6 +32,7 @@
 
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
@@ -53,6 +54,24 @@ namespace transport {
 
 MONGO_FAIL_POINT_DEFINE(transportLayerASIOshortOpportunisticReadWrite);
 
+// Size of the per-session buffer that plain-text sessions read into ahead of the message being
+// sourced. Zero disables read-ahead, so every message costs a read for its header and another
+// for its body.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(transportLayerASIOReadAheadBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal != 0 && (newVal < 1024 || newVal > 16 * 1024 * 1024)) {
+            return Status(ErrorCodes::BadValue,
+                          "transportLayerASIOReadAheadBytes must be 0 or between 1KB and 16MB");
+        }
+        return Status::OK();
+    });
+
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+// Offer the session from the last TLS handshake with a peer when connecting to it again, so that
+// the peer can resume it rather than run a full handshake.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(sslEgressSessionResumption, bool, false);
+#endif
+
 template <typename SuccessValue>
 auto futurize(const std::error_code& ec, SuccessValue&& successValue) {
     using Result = Future<std::decay_t<SuccessValue>>;
@@ -100,6 +119,13 @@ public:
     }
 
     ~ASIOSession() {
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+        // A TLS 1.3 server only sends its session ticket after the handshake, so save the session
+        // again now that nothing else can be using the connection.
+        if (_sslSessionPeer) {
+            _tl->_saveEgressSSLSession(*_sslSessionPeer, _sslSocket->native_handle());
+        }
+#endif
         end();
     }
 
@@ -221,6 +247,11 @@ protected:
 
         _sslSocket.emplace(
             std::move(_socket), *_tl->_egressSSLContext, removeFQDNRoot(target.host()));
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+        if (auto session = _tl->_getEgressSSLSession(target)) {
+            ::SSL_set_session(_sslSocket->native_handle(), session.get());
+        }
+#endif
         lk.unlock();
 
         auto doHandshake = [&] {
@@ -235,6 +266,14 @@ protected:
         return doHandshake().then([this, target] {
             _ranHandshake = true;
 
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+            if (::SSL_session_reused(_sslSocket->native_handle())) {
+                LOG(2) << "Resumed SSL session with " << target;
+            }
+            _tl->_saveEgressSSLSession(target, _sslSocket->native_handle());
+            _sslSessionPeer = target;
+#endif
+
             auto sslManager = getSSLManager();
             auto swPeerInfo = uassertStatusOK(sslManager->parseAndValidatePeerCertificate(
                 _sslSocket->native_handle(), target.host()));
@@ -344,6 +383,10 @@ private:
     Future<Message> sourceMessageImpl(const transport::BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
+        if (useReadAhead()) {
+            return sourceMessageFromReadAhead(baton);
+        }
+
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
@@ -354,13 +397,7 @@ private:
 
                 const auto msgLen = size_t(MSGHEADER::View(headerBuffer.get()).getMessageLength());
                 if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
-                    StringBuilder sb;
-                    sb << "recv(): message msgLen " << msgLen << " is invalid. "
-                       << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
-                    const auto str = sb.str();
-                    LOG(0) << str;
-
-                    return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+                    return Future<Message>::makeReady(invalidMessageLengthStatus(msgLen));
                 }
 
                 if (msgLen == kHeaderSize) {
@@ -385,6 +422,122 @@ private:
             });
     }
 
+    bool useReadAhead() const {
+        if (transportLayerASIOReadAheadBytes == 0) {
+            return false;
+        }
+#ifdef MONGO_CONFIG_SSL
+        // The first read of an ingress session must be exactly one header long so that it can be
+        // handed to the SSL handshake, and SSL streams already buffer what they decrypt.
+        if (_sslSocket || !_ranHandshake) {
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    /**
+     * Sources a message through the read-ahead buffer. Each refill asks the socket for as many
+     * bytes as fit in the buffer, so a small message, and any messages pipelined behind it, arrive
+     * in one read rather than one for the header and one for the body. A message larger than what
+     * is buffered is completed with a read directly into the message.
+     */
+    Future<Message> sourceMessageFromReadAhead(const transport::BatonHandle& baton) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        const auto buffered = _readAheadEnd - _readAheadBegin;
+        if (buffered < kHeaderSize) {
+            return fillReadAhead(baton).then(
+                [this, baton] { return sourceMessageFromReadAhead(baton); });
+        }
+
+        const char* const begin = _readAheadBuffer.get() + _readAheadBegin;
+        if (checkForHTTPRequest(asio::buffer(begin, kHeaderSize))) {
+            return sendHTTPResponse(baton);
+        }
+
+        const auto msgLen = size_t(MSGHEADER::ConstView(begin).getMessageLength());
+        if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+            return Future<Message>::makeReady(invalidMessageLengthStatus(msgLen));
+        }
+
+        auto buffer = SharedBuffer::allocate(msgLen);
+        const auto fromReadAhead = std::min(msgLen, buffered);
+        memcpy(buffer.get(), begin, fromReadAhead);
+        consumeReadAhead(fromReadAhead);
+
+        if (fromReadAhead == msgLen) {
+            if (_isIngressSession) {
+                networkCounter.hitPhysicalIn(msgLen);
+            }
+            return Future<Message>::makeReady(Message(std::move(buffer)));
+        }
+
+        auto ptr = buffer.get() + fromReadAhead;
+        return read(asio::buffer(ptr, msgLen - fromReadAhead), baton)
+            .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
+                if (_isIngressSession) {
+                    networkCounter.hitPhysicalIn(msgLen);
+                }
+                return Message(std::move(buffer));
+            });
+    }
+
+    // Reads whatever the socket has available, up to the free space in the read-ahead buffer.
+    Future<void> fillReadAhead(const transport::BatonHandle& baton) {
+        if (!_readAheadBuffer) {
+            _readAheadBuffer = SharedBuffer::allocate(transportLayerASIOReadAheadBytes);
+        } else if (_readAheadBegin > 0) {
+            // Move the partial header to the front so the refill can use the whole buffer.
+            const auto buffered = _readAheadEnd - _readAheadBegin;
+            memmove(_readAheadBuffer.get(), _readAheadBuffer.get() + _readAheadBegin, buffered);
+            _readAheadBegin = 0;
+            _readAheadEnd = buffered;
+        }
+
+        auto freeSpace = asio::buffer(_readAheadBuffer.get() + _readAheadEnd,
+                                      _readAheadBuffer.capacity() - _readAheadEnd);
+        std::error_code ec;
+        const auto size = _socket.read_some(freeSpace, ec);
+        if (!ec) {
+            _readAheadEnd += size;
+            return Future<void>::makeReady();
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            if (baton) {
+                return baton->addSession(*this, Baton::Type::In).then([this, baton] {
+                    return fillReadAhead(baton);
+                });
+            }
+
+            return _socket.async_read_some(freeSpace, UseFuture{}).then([this](size_t size) {
+                _readAheadEnd += size;
+            });
+        }
+        return futurize(ec);
+    }
+
+    void consumeReadAhead(size_t size) {
+        _readAheadBegin += size;
+        if (_readAheadBegin == _readAheadEnd) {
+            _readAheadBegin = _readAheadEnd = 0;
+        }
+    }
+
+    Status invalidMessageLengthStatus(size_t msgLen) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        StringBuilder sb;
+        sb << "recv(): message msgLen " << msgLen << " is invalid. "
+           << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+        const auto str = sb.str();
+        LOG(0) << str;
+
+        return Status(ErrorCodes::ProtocolError, str);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers,
                       const transport::BatonHandle& baton = nullptr) {
@@ -704,11 +857,22 @@ private:
     boost::optional<Milliseconds> _socketTimeout;
 
     GenericSocket _socket;
+
+    // Bytes read from _socket past the end of the last message sourced; see useReadAhead().
+    SharedBuffer _readAheadBuffer;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
+
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
     bool _ranHandshake = false;
 #endif
 
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+    // The peer of a completed egress handshake, whose session is saved for resumption.
+    boost::optional<HostAndPort> _sslSessionPeer;
+#endif
+
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
 };
@@ -903,6 +903,41 @@ SSLParams::SSLModes TransportLayerASIO::_sslMode() const {
 }
 #endif
 
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+std::shared_ptr<SSL_SESSION> TransportLayerASIO::_getEgressSSLSession(const HostAndPort& peer) {
+    if (!sslEgressSessionResumption) {
+        return nullptr;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_egressSSLSessionsMutex);
+    auto it = _egressSSLSessions.find(peer);
+    if (it == _egressSSLSessions.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void TransportLayerASIO::_saveEgressSSLSession(const HostAndPort& peer, SSL* ssl) {
+    if (!sslEgressSessionResumption) {
+        return;
+    }
+
+    std::shared_ptr<SSL_SESSION> session(::SSL_get1_session(ssl), ::SSL_SESSION_free);
+    if (!session) {
+        return;
+    }
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+    // TLS 1.3 sessions only become resumable once the server sends a ticket after the handshake
+    if (!::SSL_SESSION_is_resumable(session.get())) {
+        return;
+    }
+#endif
+
+    stdx::lock_guard<stdx::mutex> lk(_egressSSLSessionsMutex);
+    _egressSSLSessions[peer] = std::move(session);
+}
+#endif
+
 BatonHandle TransportLayerASIO::makeBaton(OperationContext* opCtx) {
 #ifdef __linux__
     auto baton = std::make_shared<BatonASIO>(opCtx);
@@ -38,6 +38,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/transport/transport_mode.h"
 #include "mongo/util/fail_point_service.h"
@@ -45,6 +46,11 @@
 #include "mongo/util/net/ssl_options.h"
 #include "mongo/util/net/ssl_types.h"
 
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+struct ssl_st;
+struct ssl_session_st;
+#endif
+
 namespace asio {
 class io_context;
 
@@ -156,6 +162,19 @@ private:
     SSLParams::SSLModes _sslMode() const;
 #endif
 
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+    /**
+     * Returns the session of the last egress handshake with peer, to offer for resumption in the
+     * next one, or nullptr if there is none or sslEgressSessionResumption is off.
+     */
+    std::shared_ptr<ssl_session_st> _getEgressSSLSession(const HostAndPort& peer);
+
+    /**
+     * Remembers the session of a completed egress handshake with peer.
+     */
+    void _saveEgressSSLSession(const HostAndPort& peer, ssl_st* ssl);
+#endif
+
     stdx::mutex _mutex;
 
     // There are three reactors that are used by TransportLayerASIO. The _ingressReactor contains
@@ -189,6 +208,11 @@ private:
     std::unique_ptr<asio::ssl::context> _egressSSLContext;
 #endif
 
+#if defined(MONGO_CONFIG_SSL) && MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+    stdx::mutex _egressSSLSessionsMutex;
+    stdx::unordered_map<HostAndPort, std::shared_ptr<ssl_session_st>> _egressSSLSessions;
+#endif
+
     std::vector<std::pair<SockAddr, GenericAcceptor>> _acceptors;
 
     // Only used if _listenerOptions.async is false.
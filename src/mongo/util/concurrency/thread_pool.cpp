@@ -32,13 +32,17 @@
 
 #include "mongo/util/concurrency/thread_pool.h"
 
+#include <algorithm>
+
 #include "mongo/base/status.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -47,6 +51,14 @@ namespace {
 // Counter used to assign unique names to otherwise-unnamed thread pools.
 AtomicInt32 nextUnnamedThreadPoolId{1};
 
+// Number of worker queue tasks a worker runs before it looks at the shared queue again.
+const size_t kMaxWorkerQueueTasksInARow = 64;
+
+// The work-stealing pool whose worker is the current thread, if any, and the index of the worker
+// queue it owns.
+thread_local ThreadPool* workerPool = nullptr;
+thread_local size_t workerQueueIndex = 0;
+
 /**
  * Sets defaults and checks bounds limits on "options", and returns it.
  *
@@ -75,7 +87,14 @@ ThreadPool::Options cleanUpOptions(ThreadPool::Options&& options) {
 
 }  // namespace
 
-ThreadPool::ThreadPool(Options options) : _options(cleanUpOptions(std::move(options))) {}
+ThreadPool::ThreadPool(Options options) : _options(cleanUpOptions(std::move(options))) {
+    if (_options.workStealing) {
+        for (size_t i = 0; i < _options.maxThreads; ++i) {
+            _workerQueues.push_back(stdx::make_unique<WorkerQueue>());
+        }
+        _workerQueueInUse.resize(_options.maxThreads, false);
+    }
+}
 
 ThreadPool::~ThreadPool() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
@@ -191,6 +210,11 @@ void ThreadPool::_drainPendingTasks() {
 }
 
 Status ThreadPool::schedule(Task task) {
+    if (workerPool == this && _workerQueuesOpen.load()) {
+        _scheduleOnWorkerQueue(std::move(task));
+        return Status::OK();
+    }
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     switch (_state) {
         case joinRequired:
@@ -222,7 +246,8 @@ Status ThreadPool::schedule(Task task) {
 void ThreadPool::waitForIdle() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     // If there are any pending tasks, or non-idle threads, the pool is not idle.
-    while (!_pendingTasks.empty() || _numIdleThreads < _threads.size()) {
+    while (!_pendingTasks.empty() || _numIdleThreads < _threads.size() ||
+           _numWorkerQueuedTasks.load() > 0) {
         _poolIsIdle.wait(lk);
     }
 }
@@ -234,6 +259,8 @@ ThreadPool::Stats ThreadPool::getStats() const {
     result.numThreads = _threads.size();
     result.numIdleThreads = _numIdleThreads;
     result.numPendingTasks = _pendingTasks.size();
+    result.numWorkerQueuedTasks = _numWorkerQueuedTasks.load();
+    result.numStolenTasks = _numStolenTasks.load();
     result.lastFullUtilizationDate = _lastFullUtilizationDate;
     return result;
 }
@@ -263,7 +290,28 @@ void ThreadPool::_workerThreadBody(ThreadPool* pool, const std::string& threadNa
 
 void ThreadPool::_consumeTasks() {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_options.workStealing) {
+        const auto slot = std::find(_workerQueueInUse.begin(), _workerQueueInUse.end(), false);
+        invariant(slot != _workerQueueInUse.end());
+        *slot = true;
+        workerPool = this;
+        workerQueueIndex = slot - _workerQueueInUse.begin();
+    }
+    // Runs with _mutex held, on every way out of this function.
+    ON_BLOCK_EXIT([&] {
+        if (workerPool == this) {
+            _workerQueueInUse[workerQueueIndex] = false;
+            workerPool = nullptr;
+        }
+    });
+
     while (_state == running) {
+        // Tasks that other tasks scheduled on the worker queues come first, so that a task
+        // waiting on one that it scheduled is not held up by the shared queue.
+        if (_runWorkerQueueTasks(&lk)) {
+            continue;
+        }
+
         if (_pendingTasks.empty()) {
             if (_threads.size() > _options.minThreads) {
                 // Since there are more than minThreads threads, this thread may be eligible for
@@ -282,7 +330,7 @@ void ThreadPool::_consumeTasks() {
                 LOG(3) << "Not reaping because the earliest retirement date is "
                        << nextThreadRetirementDate;
                 MONGO_IDLE_THREAD_BLOCK;
-                _workAvailable.wait_until(lk, nextThreadRetirementDate.toSystemTimePoint());
+                _waitForWork_inlock(&lk, nextThreadRetirementDate);
             } else {
                 // Since the number of threads is not more than minThreads, this thread is not
                 // eligible for retirement. It is OK to sleep until _workAvailable is signaled,
@@ -291,7 +339,7 @@ void ThreadPool::_consumeTasks() {
                 LOG(3) << "waiting for work; I am one of " << _threads.size() << " thread(s);"
                        << " the minimum number of threads is " << _options.minThreads;
                 MONGO_IDLE_THREAD_BLOCK;
-                _workAvailable.wait(lk);
+                _waitForWork_inlock(&lk, Date_t::max());
             }
             continue;
         }
@@ -304,9 +352,11 @@ void ThreadPool::_consumeTasks() {
     // falls through to the detach code, below.
 
     if (_state == joinRequired || _state == joining) {
-        // Drain the leftover pending tasks.
-        while (!_pendingTasks.empty()) {
-            _doOneTask(&lk);
+        // Drain the leftover pending tasks, on the shared queue and on the worker queues.
+        while (!_pendingTasks.empty() || _runWorkerQueueTasks(&lk)) {
+            if (!_pendingTasks.empty()) {
+                _doOneTask(&lk);
+            }
         }
         --_numIdleThreads;
         return;
@@ -357,6 +407,82 @@ void ThreadPool::_doOneTask(stdx::unique_lock<stdx::mutex>* lk) {
     }
 }
 
+void ThreadPool::_scheduleOnWorkerQueue(Task task) {
+    auto& queue = *_workerQueues[workerQueueIndex];
+    _numWorkerQueuedTasks.fetchAndAdd(1);
+    {
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+    // A waiting worker increments _numWaitingWorkers before it checks _numWorkerQueuedTasks, and
+    // this thread did the opposite, so at least one of them sees the other's increment. If this
+    // thread does, the waiter holds _mutex until it is waiting on _workAvailable.
+    if (_numWaitingWorkers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+}
+
+bool ThreadPool::_runWorkerQueueTasks(stdx::unique_lock<stdx::mutex>* lk) {
+    if (!_options.workStealing || _numWorkerQueuedTasks.load() == 0) {
+        return false;
+    }
+    size_t numTasksRun = 0;
+    --_numIdleThreads;
+    lk->unlock();
+    try {
+        Task task;
+        while (numTasksRun < kMaxWorkerQueueTasksInARow && _popWorkerQueueTask(&task)) {
+            LOG(3) << "Executing a worker queue task on behalf of pool " << _options.poolName;
+            task();
+            task = nullptr;
+            ++numTasksRun;
+        }
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+    lk->lock();
+    ++_numIdleThreads;
+    if (_pendingTasks.empty() && _threads.size() == _numIdleThreads &&
+        _numWorkerQueuedTasks.load() == 0) {
+        _poolIsIdle.notify_all();
+    }
+    return numTasksRun > 0;
+}
+
+bool ThreadPool::_popWorkerQueueTask(Task* task) {
+    const size_t numQueues = _workerQueues.size();
+    for (size_t i = 0; i < numQueues; ++i) {
+        auto& queue = *_workerQueues[(workerQueueIndex + i) % numQueues];
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        *task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        _numWorkerQueuedTasks.subtractAndFetch(1);
+        if (i > 0) {
+            _numStolenTasks.fetchAndAdd(1);
+        }
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::_waitForWork_inlock(stdx::unique_lock<stdx::mutex>* lk, Date_t deadline) {
+    _numWaitingWorkers.fetchAndAdd(1);
+    if (_numWorkerQueuedTasks.load() == 0) {
+        if (deadline == Date_t::max()) {
+            _workAvailable.wait(*lk);
+        } else {
+            _workAvailable.wait_until(*lk, deadline.toSystemTimePoint());
+        }
+    }
+    _numWaitingWorkers.subtractAndFetch(1);
+}
+
 void ThreadPool::_startWorkerThread_inlock() {
     switch (_state) {
         case preStart:
@@ -396,6 +522,7 @@ void ThreadPool::_setState_inlock(const LifecycleState newState) {
         return;
     }
     _state = newState;
+    _workerQueuesOpen.store(newState == running);
     _stateChange.notify_all();
 }
 
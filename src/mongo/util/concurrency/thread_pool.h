@@ -29,10 +29,12 @@
 #pragma once
 
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -82,6 +84,14 @@ public:
         // a thread.
         Milliseconds maxIdleThreadAge = Seconds{30};
 
+        // If true, a task scheduled by a worker thread of the pool goes on a queue owned by that
+        // worker rather than on the shared queue, and a worker that runs out of work takes tasks
+        // from the queues of the other workers. Tasks that schedule more tasks then do so without
+        // taking the pool-wide mutex. Tasks no longer run in the order they were scheduled, and
+        // new threads are only started for tasks scheduled from outside the pool, so this suits
+        // pools whose minThreads equals maxThreads and whose tasks do not rely on ordering.
+        bool workStealing = false;
+
         // This function is run before each worker thread begins consuming tasks.
         using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
         OnCreateThreadFn onCreateThread = [](const std::string&) {};
@@ -100,9 +110,17 @@ public:
         // The number of idle threads currently in the pool.
         size_t numIdleThreads;
 
-        // The number of tasks waiting to be executed by the pool.
+        // The number of tasks waiting to be executed by the pool on its shared queue.
         size_t numPendingTasks;
 
+        // The number of tasks waiting on the queues of individual workers, for work-stealing
+        // pools.
+        size_t numWorkerQueuedTasks;
+
+        // The number of tasks that a worker of a work-stealing pool took from the queue of
+        // another worker, since the pool was created.
+        size_t numStolenTasks;
+
         // The last time that no threads in the pool were idle.
         Date_t lastFullUtilizationDate;
     };
@@ -197,6 +215,30 @@ private:
      */
     void _doOneTask(stdx::unique_lock<stdx::mutex>* lk);
 
+    /**
+     * Queues "task" on the queue of the calling worker thread of a work-stealing pool.
+     */
+    void _scheduleOnWorkerQueue(Task task);
+
+    /**
+     * Runs tasks from the worker queues of a work-stealing pool without holding _mutex, until
+     * there are none left or kMaxWorkerQueueTasksInARow have run. Returns false if no task ran.
+     * "lk" must own _mutex, and owns it again on return.
+     */
+    bool _runWorkerQueueTasks(stdx::unique_lock<stdx::mutex>* lk);
+
+    /**
+     * Pops the oldest task from the queue of the calling worker or, if that is empty, from the
+     * queue of another worker. Returns false if all the worker queues are empty.
+     */
+    bool _popWorkerQueueTask(Task* task);
+
+    /**
+     * Waits on _workAvailable until "deadline", unless a task is queued on a worker queue. "lk"
+     * must own _mutex.
+     */
+    void _waitForWork_inlock(stdx::unique_lock<stdx::mutex>* lk, Date_t deadline);
+
     /**
      * Changes the lifecycle state (_state) of the pool and wakes up any threads waiting for a state
      * change. Has no effect if _state == newState.
@@ -239,6 +281,33 @@ private:
 
     // The last time that _pendingTasks.size() grew to be at least _threads.size().
     Date_t _lastFullUtilizationDate;
+
+    // Queue of the tasks scheduled by one worker thread of a work-stealing pool.
+    struct WorkerQueue {
+        stdx::mutex mutex;
+        TaskList tasks;
+    };
+
+    // For work-stealing pools, one queue per possible worker thread. Each worker claims an unused
+    // entry of _workerQueueInUse when it starts, and releases it when it exits. Only the owning
+    // worker pushes on a queue, but any worker may pop from it.
+    std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
+    std::vector<bool> _workerQueueInUse;
+
+    // Whether workers may still queue tasks on their own queues, that is, whether _state is
+    // running. Readable without _mutex.
+    AtomicWord<bool> _workerQueuesOpen{false};
+
+    // Number of tasks on all the worker queues. Incremented before a task is pushed and
+    // decremented after it is popped, so it never undercounts.
+    AtomicUInt64 _numWorkerQueuedTasks;
+
+    // Number of workers waiting on _workAvailable, or about to. A worker queueing a task on its
+    // own queue wakes one of them, since it is busy running the task that scheduled it.
+    AtomicUInt32 _numWaitingWorkers;
+
+    // Number of tasks taken from the queue of another worker.
+    AtomicUInt64 _numStolenTasks;
 };
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
@@ -52,6 +53,11 @@ using namespace mongo;
 MONGO_INITIALIZER(ThreadPoolCommonTests)(InitializerContext*) {
     addTestsForThreadPool("ThreadPoolCommon",
                           []() { return stdx::make_unique<ThreadPool>(ThreadPool::Options()); });
+    addTestsForThreadPool("ThreadPoolWorkStealingCommon", []() {
+        ThreadPool::Options options;
+        options.workStealing = true;
+        return stdx::make_unique<ThreadPool>(options);
+    });
     return Status::OK();
 }
 
@@ -263,4 +269,59 @@ TEST_F(ThreadPoolTest, ThreadPoolRunsOnCreateThreadFunctionBeforeConsumingTasks)
     ASSERT_EQUALS(options.threadNamePrefix + "0", taskThreadName);
 }
 
+TEST_F(ThreadPoolTest, WorkStealingPoolRunsTaskScheduledByBlockedWorker) {
+    ThreadPool::Options options;
+    options.minThreads = 2;
+    options.maxThreads = 2;
+    options.workStealing = true;
+    auto& pool = makePool(options);
+    pool.startup();
+
+    // The child goes on the queue of the worker running the parent, which stays busy until the
+    // other worker steals the child and runs it.
+    ASSERT_OK(pool.schedule([this, &pool] {
+        ASSERT_OK(pool.schedule([this] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            flag2 = true;
+            cv2.notify_all();
+        }));
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv2.wait(lk, [this] { return flag2; });
+    }));
+    pool.waitForIdle();
+
+    auto stats = pool.getStats();
+    ASSERT_EQ(0U, stats.numPendingTasks);
+    ASSERT_EQ(0U, stats.numWorkerQueuedTasks);
+    ASSERT_EQ(1U, stats.numStolenTasks);
+}
+
+TEST_F(ThreadPoolTest, WorkStealingPoolRunsAllTasksScheduledByTasks) {
+    ThreadPool::Options options;
+    options.minThreads = 4;
+    options.maxThreads = 4;
+    options.workStealing = true;
+    auto& pool = makePool(options);
+    pool.startup();
+
+    // Each task schedules two more, down to a depth of 10.
+    AtomicUInt32 numTasksRun;
+    stdx::function<void(int)> fanOut = [&](int depth) {
+        numTasksRun.fetchAndAdd(1);
+        if (depth < 10) {
+            ASSERT_OK(pool.schedule([&fanOut, depth] { fanOut(depth + 1); }));
+            ASSERT_OK(pool.schedule([&fanOut, depth] { fanOut(depth + 1); }));
+        }
+    };
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_OK(pool.schedule([&fanOut] { fanOut(0); }));
+    }
+    pool.waitForIdle();
+
+    ASSERT_EQ(4U * ((1U << 11) - 1), numTasksRun.load());
+    auto stats = pool.getStats();
+    ASSERT_EQ(0U, stats.numPendingTasks);
+    ASSERT_EQ(0U, stats.numWorkerQueuedTasks);
+}
+
 }  // namespace
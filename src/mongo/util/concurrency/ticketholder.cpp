@@ -31,13 +31,122 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
+#include <algorithm>
 #include <iostream>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+constexpr int TicketHolder::kNumWaitBuckets;
+const std::array<long long, TicketHolder::kNumWaitBuckets> TicketHolder::kWaitBucketLowerBounds = {
+    0, 100, 1000, 10 * 1000, 100 * 1000, 1000 * 1000, 10 * 1000 * 1000};
+
+void TicketHolder::waitForTicket(OperationContext* opCtx) {
+    if (tryAcquire()) {
+        return;
+    }
+
+    Timer timer;
+    _numWaiters.addAndFetch(1);
+    ON_BLOCK_EXIT([&] {
+        _unregisterWaiter();
+        _recordWait(timer.micros());
+    });
+    _waitForTicket(opCtx);
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    if (tryAcquire()) {
+        return true;
+    }
+
+    Timer timer;
+    _numWaiters.addAndFetch(1);
+    ON_BLOCK_EXIT([&] {
+        _unregisterWaiter();
+        _recordWait(timer.micros());
+    });
+    return _waitForTicketUntil(opCtx, until);
+}
+
+bool TicketHolder::waitForLowPriorityTicketUntil(OperationContext* opCtx,
+                                                 Date_t until,
+                                                 Milliseconds maxDeferral) {
+    if (_numWaiters.load() == 0 && tryAcquire()) {
+        return true;
+    }
+
+    Timer timer;
+    ON_BLOCK_EXIT([&] { _recordWait(timer.micros()); });
+
+    {
+        const Date_t deferUntil = std::min(until, Date_t::now() + maxDeferral);
+        const auto noWaiters = [this] { return _numWaiters.load() == 0; };
+        stdx::unique_lock<stdx::mutex> lk(_waitersMutex);
+        if (opCtx) {
+            opCtx->waitForConditionOrInterruptUntil(_noWaiters, lk, deferUntil, noWaiters);
+        } else {
+            _noWaiters.wait_until(lk, deferUntil.toSystemTimePoint(), noWaiters);
+        }
+    }
+
+    if (tryAcquire()) {
+        return true;
+    }
+    if (until == Date_t::max()) {
+        _waitForTicket(opCtx);
+        return true;
+    }
+    return _waitForTicketUntil(opCtx, until);
+}
+
+void TicketHolder::_unregisterWaiter() {
+    if (_numWaiters.subtractAndFetch(1) == 0) {
+        stdx::lock_guard<stdx::mutex> lk(_waitersMutex);
+        _noWaiters.notify_all();
+    }
+}
+
+long long TicketHolder::numWaits() const {
+    return _numWaits.load();
+}
+
+long long TicketHolder::totalWaitMicros() const {
+    return _totalWaitMicros.load();
+}
+
+void TicketHolder::appendWaitStats(BSONObjBuilder* builder) const {
+    builder->append("waits", numWaits());
+    builder->append("totalWaitMicros", totalWaitMicros());
+
+    BSONArrayBuilder histogramBuilder(builder->subarrayStart("waitHistogram"));
+    for (int i = 0; i < kNumWaitBuckets; i++) {
+        const long long count = _waitBuckets[i].load();
+        if (count == 0) {
+            continue;
+        }
+        BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+        entryBuilder.append("micros", kWaitBucketLowerBounds[i]);
+        entryBuilder.append("count", count);
+    }
+}
+
+void TicketHolder::_recordWait(long long waitMicros) {
+    int bucket = kNumWaitBuckets - 1;
+    while (bucket > 0 && waitMicros < kWaitBucketLowerBounds[bucket]) {
+        bucket--;
+    }
+
+    _waitBuckets[bucket].addAndFetch(1);
+    _numWaits.addAndFetch(1);
+    _totalWaitMicros.addAndFetch(waitMicros);
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -86,11 +195,11 @@ bool TicketHolder::tryAcquire() {
     return true;
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
-    waitForTicketUntil(opCtx, Date_t::max());
+void TicketHolder::_waitForTicket(OperationContext* opCtx) {
+    _waitForTicketUntil(opCtx, Date_t::max());
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -143,8 +252,11 @@ Status TicketHolder::resize(int newSize) {
         _outof.fetchAndAdd(1);
     }
 
+    // Taking back tickets is not an acquisition, so do not count its waits.
     while (_outof.load() > newSize) {
-        waitForTicket();
+        if (!tryAcquire()) {
+            _waitForTicket(nullptr);
+        }
         _outof.subtractAndFetch(1);
     }
 
@@ -177,7 +289,7 @@ bool TicketHolder::tryAcquire() {
     return _tryAcquire();
 }
 
-void TicketHolder::waitForTicket(OperationContext* opCtx) {
+void TicketHolder::_waitForTicket(OperationContext* opCtx) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     if (opCtx) {
@@ -187,7 +299,7 @@ void TicketHolder::waitForTicket(OperationContext* opCtx) {
     }
 }
 
-bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+bool TicketHolder::_waitForTicketUntil(OperationContext* opCtx, Date_t until) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     if (opCtx) {
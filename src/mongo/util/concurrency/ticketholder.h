@@ -30,8 +30,11 @@
 #include <semaphore.h>
 #endif
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -39,6 +42,8 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
+
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
@@ -69,6 +74,17 @@ public:
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
+
+    /**
+     * Like waitForTicketUntil, but for a low priority acquisition: while acquisitions made through
+     * waitForTicket and waitForTicketUntil are waiting for a ticket, it stands back for up to
+     * 'maxDeferral' before competing with them for the next ticket, so that it cannot starve.
+     * Passing Date_t::max() as 'until' waits like waitForTicket once the deferral is over.
+     */
+    bool waitForLowPriorityTicketUntil(OperationContext* opCtx,
+                                       Date_t until,
+                                       Milliseconds maxDeferral);
+
     void release();
 
     Status resize(int newSize);
@@ -79,7 +95,44 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns how many acquisitions could not get a ticket right away, and the total time they
+     * spent waiting for one.
+     */
+    long long numWaits() const;
+    long long totalWaitMicros() const;
+
+    /**
+     * Appends the counts above and a histogram of the wait times of those acquisitions.
+     */
+    void appendWaitStats(BSONObjBuilder* builder) const;
+
 private:
+    // Inclusive lower bounds, in microseconds, of the wait time histogram buckets.
+    static constexpr int kNumWaitBuckets = 7;
+    static const std::array<long long, kNumWaitBuckets> kWaitBucketLowerBounds;
+
+    void _waitForTicket(OperationContext* opCtx);
+    bool _waitForTicketUntil(OperationContext* opCtx, Date_t until);
+
+    void _recordWait(long long waitMicros);
+
+    /**
+     * Unregisters a normal priority acquisition which was waiting for a ticket, waking up the low
+     * priority acquisitions if it was the last one.
+     */
+    void _unregisterWaiter();
+
+    std::array<AtomicInt64, kNumWaitBuckets> _waitBuckets;
+    AtomicInt64 _numWaits;
+    AtomicInt64 _totalWaitMicros;
+
+    // The number of normal priority acquisitions waiting for a ticket. Low priority acquisitions
+    // wait on '_noWaiters' for it to drop to zero.
+    AtomicInt32 _numWaiters;
+    stdx::mutex _waitersMutex;
+    stdx::condition_variable _noWaiters;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
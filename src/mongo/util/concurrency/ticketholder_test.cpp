@@ -31,8 +31,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 using namespace mongo;
@@ -71,4 +77,78 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, WaitStatsCountOnlyAcquisitionsWhichWaited) {
+    TicketHolder holder(1);
+
+    holder.waitForTicket();
+    ASSERT_EQ(holder.numWaits(), 0);
+    ASSERT_EQ(holder.totalWaitMicros(), 0);
+
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+    ASSERT_EQ(holder.numWaits(), 1);
+    ASSERT_GTE(holder.totalWaitMicros(), 1000);
+    holder.release();
+
+    BSONObjBuilder builder;
+    holder.appendWaitStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(stats["waits"].numberLong(), 1);
+
+    long long histogramCount = 0;
+    for (auto&& entry : stats["waitHistogram"].Obj()) {
+        ASSERT_GTE(holder.totalWaitMicros(), entry["micros"].numberLong());
+        histogramCount += entry["count"].numberLong();
+    }
+    ASSERT_EQ(histogramCount, 1);
+}
+
+TEST(TicketholderTest, LowPriorityAcquisitionWithoutWaiters) {
+    TicketHolder holder(1);
+
+    ASSERT(holder.waitForLowPriorityTicketUntil(nullptr, Date_t::now(), Seconds(10)));
+    ASSERT_EQ(holder.used(), 1);
+
+    // Without normal priority waiters there is nothing to defer to, so the deadline applies.
+    ASSERT_FALSE(holder.waitForLowPriorityTicketUntil(
+        nullptr, Date_t::now() + Milliseconds(2), Seconds(10)));
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 0);
+}
+
+TEST(TicketholderTest, LowPriorityAcquisitionDefersToNormalPriorityWaiters) {
+    TicketHolder holder(1);
+    holder.waitForTicket();
+
+    stdx::mutex mutex;
+    std::vector<std::string> order;
+    auto acquired = [&](std::string who) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        order.push_back(std::move(who));
+    };
+
+    stdx::thread normal([&] {
+        holder.waitForTicket();
+        acquired("normal");
+        holder.release();
+    });
+    sleepmillis(50);
+
+    stdx::thread low([&] {
+        if (holder.waitForLowPriorityTicketUntil(nullptr, Date_t::max(), Seconds(10))) {
+            acquired("low");
+            holder.release();
+        }
+    });
+    sleepmillis(50);
+
+    holder.release();
+    normal.join();
+    low.join();
+
+    ASSERT_EQ(order.size(), 2U);
+    ASSERT_EQ(order[0], "normal");
+    ASSERT_EQ(order[1], "low");
+}
 }  // namespace
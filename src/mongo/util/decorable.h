@@ -59,6 +59,8 @@
 
 #pragma once
 
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/debug_util.h"
 #include "mongo/util/decoration_container.h"
 #include "mongo/util/decoration_registry.h"
 
@@ -76,6 +78,7 @@ public:
         Decoration() = delete;
 
         T& operator()(D& d) const {
+            countAccess();
             return static_cast<Decorable&>(d)._decorations.getDecoration(this->_raw);
         }
 
@@ -84,6 +87,7 @@ public:
         }
 
         const T& operator()(const D& d) const {
+            countAccess();
             return static_cast<const Decorable&>(d)._decorations.getDecoration(this->_raw);
         }
 
@@ -117,13 +121,20 @@ public:
             return const_cast<Decorable*>(getOwnerImpl(const_cast<const T*>(t)));
         }
 
+        void countAccess() const {
+            if (kDebugBuild) {
+                _accessCount->fetchAndAdd(1);
+            }
+        }
+
         friend class Decorable;
 
         explicit Decoration(
             typename DecorationContainer<D>::template DecorationDescriptorWithType<T> raw)
-            : _raw(std::move(raw)) {}
+            : _raw(std::move(raw)), _accessCount(getRegistry()->getAccessCounter(_raw._raw)) {}
 
         typename DecorationContainer<D>::template DecorationDescriptorWithType<T> _raw;
+        AtomicUInt64* _accessCount;
     };
 
     template <typename T>
@@ -131,6 +142,22 @@ public:
         return Decoration<T>(getRegistry()->template declareDecoration<T>());
     }
 
+    /**
+     * Declares a decoration that is accessed on most operations. See
+     * DecorationRegistry::declareHotDecoration().
+     */
+    template <typename T>
+    static Decoration<T> declareHotDecoration() {
+        return Decoration<T>(getRegistry()->template declareHotDecoration<T>());
+    }
+
+    /**
+     * Returns the registry of the decorations declared on D, for diagnostics.
+     */
+    static const DecorationRegistry<D>& getDecorationRegistry() {
+        return *getRegistry();
+    }
+
 protected:
     Decorable() : _decorations(this, getRegistry()) {}
     ~Decorable() = default;
@@ -243,5 +243,69 @@ TEST(DecorableTest, DecorationWithOwner) {
     ASSERT_EQ(&owner, &DecorationWithOwner::get.owner(decoration));
 }
 
+struct LargeDecoration {
+    char data[200];
+};
+
+TEST(DecorableTest, HotDecorationsArePackedTogether) {
+    numConstructedAs = 0;
+    numDestructedAs = 0;
+    DecorationRegistry<MyDecorable> registry;
+    const auto regular1 = registry.declareDecoration<A>();
+    const auto hotChar = registry.declareHotDecoration<char>();
+    const auto regular2 = registry.declareDecoration<LargeDecoration>();
+    const auto hotInt = registry.declareHotDecoration<int>();
+    const auto hotA = registry.declareHotDecoration<A>();
+    ASSERT_EQ(16U, registry.getHotDecorationBufferSizeBytes());
+
+    {
+        DecorationContainer<MyDecorable> d(nullptr, &registry);
+        ASSERT_EQ(2, numConstructedAs);
+
+        d.getDecoration(regular1).value = 1;
+        d.getDecoration(hotChar) = 'x';
+        d.getDecoration(hotInt) = 2;
+        d.getDecoration(hotA).value = 3;
+        ASSERT_EQ(1, d.getDecoration(regular1).value);
+        ASSERT_EQ('x', d.getDecoration(hotChar));
+        ASSERT_EQ(2, d.getDecoration(hotInt));
+        ASSERT_EQ(3, d.getDecoration(hotA).value);
+
+        // The hot decorations sit together, whatever was declared between them.
+        const auto hotBegin = reinterpret_cast<uintptr_t>(&d.getDecoration(hotA));
+        const auto hotEnd = reinterpret_cast<uintptr_t>(&d.getDecoration(hotChar)) + 1;
+        ASSERT_LTE(hotEnd - hotBegin, 16U);
+        ASSERT_LT(hotEnd, reinterpret_cast<uintptr_t>(&d.getDecoration(regular2)));
+        ASSERT_EQ(0U,
+                  reinterpret_cast<uintptr_t>(&d.getDecoration(hotInt)) %
+                      std::alignment_of<int>::value);
+    }
+    ASSERT_EQ(2, numDestructedAs);
+}
+
+struct HotDecoratedOwnerChecker : public Decorable<HotDecoratedOwnerChecker> {};
+
+const auto hotOwnedDecoration = HotDecoratedOwnerChecker::declareHotDecoration<int>();
+const auto regularOwnedDecoration = HotDecoratedOwnerChecker::declareDecoration<int>();
+
+TEST(DecorableTest, HotDecorationWithOwner) {
+    HotDecoratedOwnerChecker owner;
+    ASSERT_EQ(&owner, hotOwnedDecoration.owner(&hotOwnedDecoration(owner)));
+    ASSERT_EQ(&owner, regularOwnedDecoration.owner(&regularOwnedDecoration(owner)));
+
+    auto stats = HotDecoratedOwnerChecker::getDecorationRegistry().getDecorationStats();
+    ASSERT_EQ(2U, stats.size());
+    ASSERT(stats[0].hot);
+    ASSERT(typeid(int) == *stats[0].type);
+    ASSERT_EQ(sizeof(int), stats[0].sizeBytes);
+    ASSERT_LT(stats[0].offset, 0);
+    ASSERT_FALSE(stats[1].hot);
+    ASSERT_GT(stats[1].offset, 0);
+    if (kDebugBuild) {
+        ASSERT_EQ(1U, stats[0].accessCount);
+        ASSERT_EQ(1U, stats[1].accessCount);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -61,9 +62,10 @@ public:
         friend DecorationRegistry<DecoratedType>;
         friend Decorable<DecoratedType>;
 
-        explicit DecorationDescriptor(size_t index) : _index(index) {}
+        explicit DecorationDescriptor(std::ptrdiff_t index) : _index(index) {}
 
-        size_t _index;
+        // Offset of the decoration from the back link, negative for hot decorations.
+        std::ptrdiff_t _index;
     };
 
     /**
@@ -96,14 +98,15 @@ public:
     explicit DecorationContainer(Decorable<DecoratedType>* const decorated,
                                  const DecorationRegistry<DecoratedType>* const registry)
         : _registry(registry),
-          _decorationData(new unsigned char[registry->getDecorationBufferSizeBytes()]) {
+          _decorationData(new unsigned char[registry->getDecorationBufferSizeBytes()]),
+          _backLink(_decorationData.get() + registry->getHotDecorationBufferSizeBytes()) {
         // Because the decorations live in the externally allocated storage buffer at
         // `_decorationData`, there needs to be a way to get back from a known location within this
         // buffer to the type which owns those decorations.  We place a pointer to ourselves, a
-        // "back link" in the front of this storage buffer, as this is the easiest "well known
-        // location" to compute.
+        // "back link" in this storage buffer, right after the hot decorations, as decorations are
+        // addressed by their offset from it.
         Decorable<DecoratedType>** const backLink =
-            reinterpret_cast<Decorable<DecoratedType>**>(_decorationData.get());
+            reinterpret_cast<Decorable<DecoratedType>**>(_backLink);
         *backLink = decorated;
         _registry->construct(this);
     }
@@ -118,14 +121,14 @@ public:
      * The descriptor must be one returned from this DecorationContainer's associated _registry.
      */
     void* getDecoration(DecorationDescriptor descriptor) {
-        return _decorationData.get() + descriptor._index;
+        return _backLink + descriptor._index;
     }
 
     /**
      * Same as the non-const form above, but returns a const result.
      */
     const void* getDecoration(DecorationDescriptor descriptor) const {
-        return _decorationData.get() + descriptor._index;
+        return _backLink + descriptor._index;
     }
 
     /**
@@ -147,6 +150,7 @@ public:
 private:
     const DecorationRegistry<DecoratedType>* const _registry;
     const std::unique_ptr<unsigned char[]> _decorationData;
+    unsigned char* const _backLink;
 };
 
 }  // namespace mongo
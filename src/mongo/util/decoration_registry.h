@@ -29,14 +29,19 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <iterator>
 #include <type_traits>
+#include <typeinfo>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/decoration_container.h"
 #include "mongo/util/scopeguard.h"
 
@@ -65,16 +70,74 @@ public:
      */
     template <typename T>
     auto declareDecoration() {
-        MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
-                                "Decorations must be nothrow destructible");
-        return
-            typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
-                std::move(declareDecoration(
-                    sizeof(T), std::alignment_of<T>::value, &constructAt<T>, &destroyAt<T>)));
+        return declareDecoration<T>(false);
+    }
+
+    /**
+     * Like declareDecoration(), but places the decoration among the other hot decorations, which
+     * are packed together ahead of all others so that the few decorations touched on every
+     * operation share as few cache lines as possible. Use this only for small decorations that
+     * are accessed on most operations.
+     */
+    template <typename T>
+    auto declareHotDecoration() {
+        return declareDecoration<T>(true);
     }
 
+    /**
+     * Returns the size of the buffer holding all decorations, including the back link.
+     */
     size_t getDecorationBufferSizeBytes() const {
-        return _totalSizeBytes;
+        return getHotDecorationBufferSizeBytes() + _regularSizeBytes;
+    }
+
+    /**
+     * Returns the number of bytes of the buffer taken by the hot decorations. The back link
+     * follows them, and the other decorations follow the back link.
+     */
+    size_t getHotDecorationBufferSizeBytes() const {
+        const size_t misalignment = _hotSizeBytes % alignof(std::max_align_t);
+        return misalignment ? _hotSizeBytes + alignof(std::max_align_t) - misalignment
+                            : _hotSizeBytes;
+    }
+
+    /**
+     * Description of one declared decoration, for diagnostics. Access counts are only
+     * maintained in debug builds.
+     */
+    struct DecorationStats {
+        const std::type_info* type;
+        std::ptrdiff_t offset;
+        size_t sizeBytes;
+        bool hot;
+        unsigned long long accessCount;
+    };
+
+    std::vector<DecorationStats> getDecorationStats() const {
+        std::vector<DecorationStats> stats;
+        for (size_t i = 0; i < _decorationInfo.size(); ++i) {
+            const auto& decoration = _decorationInfo[i];
+            stats.push_back({decoration.type,
+                             decoration.descriptor._index,
+                             decoration.sizeBytes,
+                             decoration.hot,
+                             _accessCounts[i].loadRelaxed()});
+        }
+        return stats;
+    }
+
+    /**
+     * Returns the counter of accesses to the decoration with the given descriptor, which
+     * Decorable increments in debug builds.
+     */
+    AtomicUInt64* getAccessCounter(
+        typename DecorationContainer<DecoratedType>::DecorationDescriptor descriptor) {
+        for (size_t i = 0; i < _decorationInfo.size(); ++i) {
+            if (_decorationInfo[i].descriptor._index == descriptor._index) {
+                return &_accessCounts[i];
+            }
+        }
+        MONGO_UNREACHABLE;
     }
 
     /**
@@ -138,14 +201,23 @@ private:
         DecorationInfo(
             typename DecorationContainer<DecoratedType>::DecorationDescriptor inDescriptor,
             DecorationConstructorFn inConstructor,
-            DecorationDestructorFn inDestructor)
+            DecorationDestructorFn inDestructor,
+            const std::type_info* inType,
+            size_t inSizeBytes,
+            bool inHot)
             : descriptor(std::move(inDescriptor)),
               constructor(std::move(inConstructor)),
-              destructor(std::move(inDestructor)) {}
+              destructor(std::move(inDestructor)),
+              type(inType),
+              sizeBytes(inSizeBytes),
+              hot(inHot) {}
 
         typename DecorationContainer<DecoratedType>::DecorationDescriptor descriptor;
         DecorationConstructorFn constructor;
         DecorationDestructorFn destructor;
+        const std::type_info* type;
+        size_t sizeBytes;
+        bool hot;
     };
 
     using DecorationInfoVector = std::vector<DecorationInfo>;
@@ -160,29 +232,70 @@ private:
         static_cast<T*>(location)->~T();
     }
 
+    template <typename T>
+    auto declareDecoration(bool hot) {
+        MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
+                                "Decorations must be nothrow destructible");
+        MONGO_STATIC_ASSERT_MSG(std::alignment_of<T>::value <= alignof(std::max_align_t),
+                                "Decorations must not be over-aligned");
+        return
+            typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
+                std::move(declareDecoration(sizeof(T),
+                                            std::alignment_of<T>::value,
+                                            &constructAt<T>,
+                                            &destroyAt<T>,
+                                            &typeid(T),
+                                            hot)));
+    }
+
     /**
      * Declares a decoration with given "constructor" and "destructor" functions,
      * of "sizeBytes" bytes.
      *
+     * Regular decorations are laid out after the back link, at increasing offsets. Hot
+     * decorations are placed before it, at decreasing offsets, so that they stay packed together
+     * regardless of how many regular decorations are declared around them.
+     *
      * NOTE: "destructor" must not throw exceptions.
      */
     typename DecorationContainer<DecoratedType>::DecorationDescriptor declareDecoration(
         const size_t sizeBytes,
         const size_t alignBytes,
         const DecorationConstructorFn constructor,
-        const DecorationDestructorFn destructor) {
-        const size_t misalignment = _totalSizeBytes % alignBytes;
-        if (misalignment) {
-            _totalSizeBytes += alignBytes - misalignment;
+        const DecorationDestructorFn destructor,
+        const std::type_info* const type,
+        const bool hot) {
+        std::ptrdiff_t offset;
+        if (hot) {
+            _hotSizeBytes += sizeBytes;
+            const size_t misalignment = _hotSizeBytes % alignBytes;
+            if (misalignment) {
+                _hotSizeBytes += alignBytes - misalignment;
+            }
+            offset = -static_cast<std::ptrdiff_t>(_hotSizeBytes);
+        } else {
+            const size_t misalignment = _regularSizeBytes % alignBytes;
+            if (misalignment) {
+                _regularSizeBytes += alignBytes - misalignment;
+            }
+            offset = _regularSizeBytes;
+            _regularSizeBytes += sizeBytes;
         }
-        typename DecorationContainer<DecoratedType>::DecorationDescriptor result(_totalSizeBytes);
-        _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
-        _totalSizeBytes += sizeBytes;
+        typename DecorationContainer<DecoratedType>::DecorationDescriptor result(offset);
+        _decorationInfo.push_back(
+            DecorationInfo(result, constructor, destructor, type, sizeBytes, hot));
+        _accessCounts.emplace_back();
         return result;
     }
 
     DecorationInfoVector _decorationInfo;
-    size_t _totalSizeBytes{sizeof(void*)};
+
+    // Parallel to _decorationInfo. A deque, so that counters handed out by getAccessCounter()
+    // stay put as more decorations are declared.
+    std::deque<AtomicUInt64> _accessCounts;
+
+    size_t _hotSizeBytes{0};
+    size_t _regularSizeBytes{sizeof(void*)};
 };
 
 }  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
+#include <new>
 #include <type_traits>
 
 #include "mongo/base/checked_cast.h"
@@ -317,6 +318,75 @@ enum class SSBState : uint8_t {
     kFinished,  // This should stay last since we have code like assert(state < kFinished).
 };
 
+class SharedStateBase;
+
+/**
+ * The type-erased callback a SharedStateBase runs on completion. Unlike std::function, which
+ * requires copyable callables and heap-allocates anything larger than a couple of pointers, this
+ * is move-only and stores callables of up to kInlineSize bytes in place, which covers the
+ * continuations created by then() and friends for typical captures.
+ */
+class SSBCallback {
+public:
+    static constexpr size_t kInlineSize = 6 * sizeof(void*);
+
+    SSBCallback() = default;
+    SSBCallback(const SSBCallback&) = delete;
+    SSBCallback& operator=(const SSBCallback&) = delete;
+
+    ~SSBCallback() {
+        reset();
+    }
+
+    template <typename Func>
+    SSBCallback& operator=(Func&& func) {
+        using Impl = std::decay_t<Func>;
+        using FitsInline = std::integral_constant<bool,
+                                                  sizeof(Impl) <= kInlineSize &&
+                                                      alignof(Impl) <= alignof(Storage)>;
+        reset();
+        emplace<Impl>(std::forward<Func>(func), FitsInline());
+        return *this;
+    }
+
+    explicit operator bool() const {
+        return _target;
+    }
+
+    void operator()(SharedStateBase* ssb) {
+        _invoke(_target, ssb);
+    }
+
+private:
+    using Storage = std::aligned_storage_t<kInlineSize>;
+
+    template <typename Impl, typename Func>
+    void emplace(Func&& func, std::true_type /*fitsInline*/) {
+        _target = new (&_inline) Impl(std::forward<Func>(func));
+        _destroy = [](void* target) { static_cast<Impl*>(target)->~Impl(); };
+        _invoke = [](void* target, SharedStateBase* ssb) { (*static_cast<Impl*>(target))(ssb); };
+    }
+
+    template <typename Impl, typename Func>
+    void emplace(Func&& func, std::false_type /*fitsInline*/) {
+        _target = new Impl(std::forward<Func>(func));
+        _destroy = [](void* target) { delete static_cast<Impl*>(target); };
+        _invoke = [](void* target, SharedStateBase* ssb) { (*static_cast<Impl*>(target))(ssb); };
+    }
+
+    void reset() {
+        if (_target) {
+            _destroy(_target);
+            _target = nullptr;
+        }
+    }
+
+    void* _target = nullptr;
+    void (*_destroy)(void* target) = nullptr;
+    void (*_invoke)(void* target, SharedStateBase* ssb) = nullptr;
+    Storage _inline;
+};
+
 class SharedStateBase : public FutureRefCountable {
 public:
     SharedStateBase(const SharedStateBase&) = delete;
@@ -422,7 +492,7 @@ public:
     boost::intrusive_ptr<SharedStateBase> continuation;  // F
 
     // Takes this as argument and usually writes to continuation.
-    std::function<void(SharedStateBase* input)> callback;  // F
+    SSBCallback callback;  // F
 
 
     // These are only used to signal completion to blocking waiters. Benchmarks showed that it was
@@ -31,6 +31,9 @@
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/inline_decls.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/future.h"
 
 namespace mongo {
@@ -211,6 +214,74 @@ void BM_futureInt4xDeferredThenChained(benchmark::State& state) {
     }
 }
 
+void BM_futureInt4xDeferredThenValueChained(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        Promise<int> p;
+        auto fut = p.getFuture()  //
+                       .then([](int i) { return i + 1; })
+                       .then([](int i) { return i + 1; })
+                       .then([](int i) { return i + 1; })
+                       .then([](int i) { return i + 1; });
+        p.emplaceValue(1);
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
+
+void BM_futureIntDeferredThenCapturing(benchmark::State& state) {
+    // The continuation captures more than fits in std::function's small buffer.
+    int a = 1, b = 2, c = 3, d = 4;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        Promise<int> p;
+        auto fut = p.getFuture().then([&a, &b, &c, &d](int i) { return i + a + b + c + d; });
+        p.emplaceValue(1);
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
+
+void BM_futureIntDeferredThenCrossThread(benchmark::State& state) {
+    // Another thread completes each Promise, so the continuation runs there while this thread
+    // blocks in get().
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    boost::optional<Promise<int>> toComplete;
+    bool done = false;
+
+    stdx::thread producer([&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        while (true) {
+            cv.wait(lk, [&] { return done || toComplete; });
+            if (!toComplete) {
+                return;
+            }
+            auto promise = std::move(*toComplete);
+            toComplete.reset();
+            lk.unlock();
+            promise.emplaceValue(1);
+            lk.lock();
+        }
+    });
+
+    for (auto _ : state) {
+        auto pf = makePromiseFuture<int>();
+        auto fut = std::move(pf.future).then([](int i) { return i + 1; });
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            toComplete.emplace(std::move(pf.promise));
+        }
+        cv.notify_one();
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        done = true;
+    }
+    cv.notify_one();
+    producer.join();
+}
+
 
 BENCHMARK(BM_plainIntReady);
 BENCHMARK(BM_futureIntReady);
@@ -226,5 +297,8 @@ BENCHMARK(BM_futureInt3xDeferredThenNested);
 BENCHMARK(BM_futureInt3xDeferredThenChained);
 BENCHMARK(BM_futureInt4xDeferredThenNested);
 BENCHMARK(BM_futureInt4xDeferredThenChained);
+BENCHMARK(BM_futureInt4xDeferredThenValueChained);
+BENCHMARK(BM_futureIntDeferredThenCapturing);
+BENCHMARK(BM_futureIntDeferredThenCrossThread);
 
 }  // namespace mongo
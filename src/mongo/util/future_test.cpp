@@ -30,6 +30,9 @@
 
 #include "mongo/util/future.h"
 
+#include <array>
+
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
@@ -291,6 +294,30 @@ TEST(Future, Success_thenSimple) {
                         });
 }
 
+TEST(Future, Success_thenLargeCapture) {
+    // Too big to be stored in place by the continuation callback.
+    std::array<int, 64> values;
+    values.fill(1);
+    FUTURE_SUCCESS_TEST([] { return 1; },
+                        [&](Future<int>&& fut) {
+                            ASSERT_EQ(std::move(fut)
+                                          .then([values](int i) { return i + values.back(); })
+                                          .get(),
+                                      2);
+                        });
+}
+
+TEST(Future, Success_thenMoveOnlyCapture) {
+    FUTURE_SUCCESS_TEST([] { return 1; },
+                        [](Future<int>&& fut) {
+                            auto two = stdx::make_unique<int>(2);
+                            ASSERT_EQ(std::move(fut)
+                                          .then([two = std::move(two)](int i) { return i + *two; })
+                                          .get(),
+                                      3);
+                        });
+}
+
 TEST(Future, Success_thenSimpleAuto) {
     FUTURE_SUCCESS_TEST([] { return 1; },
                         [](Future<int>&& fut) {
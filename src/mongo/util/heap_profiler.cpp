@@ -81,17 +81,35 @@
 //     stats: {
 //         //  internal stats related to heap profiling process (collisions, number of stacks, etc.)
 //     }
-//     stacks: {
-//         stack_n_: {             // one for each stack _n_
-//             activeBytes: ...,   // number of active bytes allocated by this stack
-//             stack: [            // the stack itself
+//     subsystems: {
+//         planCache: ...,         // number of active bytes attributed to each subsystem
+//         ...
+//         other: ...
+//     }
+//     top: [                      // the heapProfilingTopStacks stacks with the most active bytes
+//         {
+//             stackNum: _n_,
+//             activeBytes: ...,
+//             subsystem: ...,
+//             stack: [            // only with serverStatus({heapProfile: {frames: true}})
 //                 "frame0",
 //                 "frame1",
 //                 ...
-//            ]
-//        }
+//             ]
+//         },
+//         ...
+//     ]
+//     stacks: {
+//         stack_n_: {             // one for each stack _n_
+//             activeBytes: ...,   // number of active bytes allocated by this stack
+//         }
 //    }
 //
+// Active bytes are attributed to the subsystem of the innermost frame of the allocating stack that
+// belongs to one of the subsystems listed in kSubsystemRules below, or to "other". Memory held by
+// the storage engine cache is usually allocated from storage engine frames, so it is reported as
+// "other" here and is better tracked by the storage engine statistics, such as wiredTiger.cache.
+//
 // Each new stack encountered is also logged to mongod log with a message like
 //     .... stack_n_: {0: "frame0", 1: "frame1", ...}
 //
@@ -126,6 +144,52 @@
 namespace mongo {
 namespace {
 
+//
+// Subsystems that live bytes are attributed to.
+//
+
+enum Subsystem {
+    kPlanCache,
+    kCatalogCache,
+    kCollectionCatalog,
+    kSessions,
+    kCursors,
+    kOther,
+    kNumSubsystems
+};
+
+const char* const kSubsystemNames[kNumSubsystems] = {
+    "planCache", "catalogCache", "collectionCatalog", "sessions", "cursors", "other"};
+
+// A frame belongs to a subsystem if its demangled name starts with one of these prefixes.
+const struct {
+    const char* symbolPrefix;
+    Subsystem subsystem;
+} kSubsystemRules[] = {
+    {"mongo::PlanCache", kPlanCache},
+    {"mongo::CachedSolution", kPlanCache},
+    {"mongo::CatalogCache", kCatalogCache},
+    {"mongo::UUIDCatalog", kCollectionCatalog},
+    {"mongo::DatabaseHolder", kCollectionCatalog},
+    {"mongo::DatabaseImpl", kCollectionCatalog},
+    {"mongo::CollectionImpl", kCollectionCatalog},
+    {"mongo::IndexCatalogImpl", kCollectionCatalog},
+    {"mongo::SessionCatalog", kSessions},
+    {"mongo::Session::", kSessions},
+    {"mongo::LogicalSessionCache", kSessions},
+    {"mongo::TransactionParticipant", kSessions},
+    {"mongo::ClientCursor", kCursors},
+    {"mongo::CursorManager", kCursors},
+};
+
+Subsystem subsystemOfFrame(StringData frame) {
+    for (const auto& rule : kSubsystemRules) {
+        if (frame.startsWith(rule.symbolPrefix))
+            return rule.subsystem;
+    }
+    return kOther;
+}
+
 //
 // Simple hash table maps Key->Value.
 // All storage is pre-allocated at creation.
@@ -324,6 +388,7 @@ private:
         int stackNum = 0;        // used for stack short name
         BSONObj stackObj{};      // symbolized representation
         size_t activeBytes = 0;  // number of live allocated bytes charged to this stack
+        Subsystem subsystem = kOther;  // computed along with stackObj
         explicit StackInfo(int stackNum) : stackNum(stackNum) {}
         StackInfo() {}
     };
@@ -472,6 +537,7 @@ private:
         if (!stackInfo.stackObj.isEmpty())
             return;
         BSONArrayBuilder builder;
+        bool foundSubsystem = false;
         for (int j = skipStartFrames; j < stack.numFrames - skipEndFrames; j++) {
             Dl_info dli;
             StringData frameString;
@@ -498,6 +564,10 @@ private:
                 frameString = s.str();
             }
             builder.append(frameString);
+            if (!foundSubsystem) {
+                stackInfo.subsystem = subsystemOfFrame(frameString);
+                foundSubsystem = stackInfo.subsystem != kOther;
+            }
             if (demangled)
                 free(demangled);
         }
@@ -521,7 +591,7 @@ private:
     int numImportantSamples = 0;                // samples currently included in importantStacks
     const int kMaxImportantSamples = 4 * 3600;  // reset every 4 hours at default 1 sample / sec
 
-    void _generateServerStatusSection(BSONObjBuilder& builder) {
+    void _generateServerStatusSection(BSONObjBuilder& builder, bool includeFrames) {
         // compute and log some informational stats first time through
         if (logGeneralStats) {
             const size_t maxActiveMemory = sampleIntervalBytes * kMaxObjInfos;
@@ -569,6 +639,30 @@ private:
             return a->activeBytes > b->activeBytes;
         };
         std::stable_sort(stackInfos.begin(), stackInfos.end(), sortByActiveBytes);
+
+        // Build the subsystems subsection, with every subsystem so that its shape is stable.
+        std::array<size_t, kNumSubsystems> subsystemActiveBytes{};
+        for (auto stackInfo : stackInfos)
+            subsystemActiveBytes[stackInfo->subsystem] += stackInfo->activeBytes;
+        BSONObjBuilder subsystemsBuilder(builder.subobjStart("subsystems"));
+        for (int i = 0; i < kNumSubsystems; i++)
+            subsystemsBuilder.appendNumber(kSubsystemNames[i], subsystemActiveBytes[i]);
+        subsystemsBuilder.doneFast();
+
+        // Build the top subsection from the stacks with the most active bytes.
+        BSONArrayBuilder topBuilder(builder.subarrayStart("top"));
+        const size_t numTop = std::min<size_t>(stackInfos.size(), std::max(topStacksParameter, 0));
+        for (size_t i = 0; i < numTop; i++) {
+            StackInfo* stackInfo = stackInfos[i];
+            BSONObjBuilder topStackBuilder(topBuilder.subobjStart());
+            topStackBuilder.append("stackNum", stackInfo->stackNum);
+            topStackBuilder.appendNumber("activeBytes", stackInfo->activeBytes);
+            topStackBuilder.append("subsystem", kSubsystemNames[stackInfo->subsystem]);
+            if (includeFrames)
+                topStackBuilder.append("stack", stackInfo->stackObj);
+        }
+        topBuilder.doneFast();
+
         size_t threshold = totalActiveBytes * 0.99;
         size_t cumulative = 0;
         for (auto it = stackInfos.begin(); it != stackInfos.end(); ++it) {
@@ -615,6 +709,7 @@ public:
     static HeapProfiler* heapProfiler;
     static bool enabledParameter;
     static long long sampleIntervalBytesParameter;
+    static int topStacksParameter;
 
     HeapProfiler() {
         // Set sample interval from the parameter.
@@ -630,9 +725,9 @@ public:
         MallocHook::AddDeleteHook(free);
     }
 
-    static void generateServerStatusSection(BSONObjBuilder& builder) {
+    static void generateServerStatusSection(BSONObjBuilder& builder, bool includeFrames) {
         if (heapProfiler)
-            heapProfiler->_generateServerStatusSection(builder);
+            heapProfiler->_generateServerStatusSection(builder, includeFrames);
     }
 };
 
@@ -650,8 +745,13 @@ public:
 
     BSONObj generateSection(OperationContext* opCtx,
                             const BSONElement& configElement) const override {
+        // The frames of the top stacks are only included on request, since they are only useful
+        // to a reader and would make every FTDC sample much larger.
+        const bool includeFrames =
+            configElement.type() == Object && configElement.Obj()["frames"].trueValue();
+
         BSONObjBuilder builder;
-        HeapProfiler::generateServerStatusSection(builder);
+        HeapProfiler::generateServerStatusSection(builder, includeFrames);
         return builder.obj();
     }
 } heapProfilerServerStatusSection;
@@ -663,6 +763,7 @@ public:
 HeapProfiler* HeapProfiler::heapProfiler;
 bool HeapProfiler::enabledParameter = false;
 long long HeapProfiler::sampleIntervalBytesParameter = 256 * 1024;
+int HeapProfiler::topStacksParameter = 10;
 
 ExportedServerParameter<bool, ServerParameterType::kStartupOnly> heapProfilingEnabledParameter(
     ServerParameterSet::getGlobal(), "heapProfilingEnabled", &HeapProfiler::enabledParameter);
@@ -672,6 +773,9 @@ ExportedServerParameter<long long, ServerParameterType::kStartupOnly>
                                      "heapProfilingSampleIntervalBytes",
                                      &HeapProfiler::sampleIntervalBytesParameter);
 
+ExportedServerParameter<int, ServerParameterType::kStartupOnly> heapProfilingTopStacks(
+    ServerParameterSet::getGlobal(), "heapProfilingTopStacks", &HeapProfiler::topStacksParameter);
+
 MONGO_INITIALIZER_GENERAL(StartHeapProfiling, ("EndStartupOptionHandling"), ("default"))
 (InitializerContext* context) {
     if (HeapProfiler::enabledParameter)
@@ -70,6 +70,12 @@ public:
          * An interval at which the job should be run.
          */
         Milliseconds interval;
+
+        /**
+         * Up to this much time, chosen at random for each run, is added to the interval, so that
+         * jobs with the same interval on different nodes do not stay in step.
+         */
+        Milliseconds jitter{0};
     };
 
     class PeriodicJobHandle {
@@ -26,19 +26,26 @@
  * then also delete it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/util/periodic_runner_impl.h"
 
+#include <algorithm>
+
 #include "mongo/db/client.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/random.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
 PeriodicRunnerImpl::PeriodicRunnerImpl(ServiceContext* svc, ClockSource* clockSource)
-    : _svc(svc), _clockSource(clockSource) {}
+    : _svc(svc), _clockSource(clockSource), _random(SecureRandom::create()->nextInt64()) {}
 
 PeriodicRunnerImpl::~PeriodicRunnerImpl() {
     PeriodicRunnerImpl::shutdown();
@@ -46,7 +53,7 @@ PeriodicRunnerImpl::~PeriodicRunnerImpl() {
 
 std::shared_ptr<PeriodicRunnerImpl::PeriodicJobImpl> PeriodicRunnerImpl::createAndAddJob(
     PeriodicJob job) {
-    auto impl = std::make_shared<PeriodicJobImpl>(std::move(job), this->_clockSource, this->_svc);
+    auto impl = std::make_shared<PeriodicJobImpl>(std::move(job), this);
 
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _jobs.push_back(impl);
@@ -59,112 +66,147 @@ std::unique_ptr<PeriodicRunner::PeriodicJobHandle> PeriodicRunnerImpl::makeJob(P
 }
 
 void PeriodicRunnerImpl::scheduleJob(PeriodicJob job) {
-    auto impl = createAndAddJob(job);
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_running) {
-        impl->start();
-    }
+    createAndAddJob(job)->start();
 }
 
 void PeriodicRunnerImpl::startup() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    if (_running) {
-        return;
+    stdx::lock_guard<stdx::mutex> lifecycleLk(_lifecycleMutex);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_running) {
+            return;
+        }
+        _running = true;
     }
 
-    _running = true;
-
-    // schedule any jobs that we have
-    for (auto& job : _jobs) {
-        job->start();
-    }
+    ThreadPool::Options options;
+    options.poolName = "PeriodicRunner";
+    options.minThreads = 0;
+    // Only bounds the number of jobs that run at the same time; a job that finds every thread
+    // busy runs late rather than not at all.
+    options.maxThreads = 8;
+    _threadPool = stdx::make_unique<ThreadPool>(std::move(options));
+    _threadPool->startup();
+    _timerThread = stdx::thread([this] { _runTimer(); });
 }
 
 void PeriodicRunnerImpl::shutdown() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_running) {
+    stdx::lock_guard<stdx::mutex> lifecycleLk(_lifecycleMutex);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_running) {
+            return;
+        }
         _running = false;
 
         for (auto& job : _jobs) {
-            if (job->isAlive()) {
-                job->stop();
-            }
+            job->_execStatus = PeriodicJobImpl::ExecutionStatus::CANCELED;
         }
-        _jobs.clear();
     }
+    _timerCondvar.notify_all();
+    _timerThread.join();
+
+    // Waits for the runs in progress.
+    _threadPool->shutdown();
+    _threadPool->join();
+    _threadPool.reset();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _jobs.clear();
 }
 
-PeriodicRunnerImpl::PeriodicJobImpl::PeriodicJobImpl(PeriodicJob job,
-                                                     ClockSource* source,
-                                                     ServiceContext* svc)
-    : _job(std::move(job)), _clockSource(source), _serviceContext(svc) {}
-
-void PeriodicRunnerImpl::PeriodicJobImpl::_run() {
-    _thread = stdx::thread([this] {
-        Client::initThread(_job.name, _serviceContext, nullptr);
-        while (true) {
-            auto start = _clockSource->now();
-
-            stdx::unique_lock<stdx::mutex> lk(_mutex);
-            // Wait until it's unpaused or canceled
-            _condvar.wait(lk, [&] { return _execStatus != ExecutionStatus::PAUSED; });
-            if (_execStatus == ExecutionStatus::CANCELED) {
-                break;
+void PeriodicRunnerImpl::_runTimer() {
+    setThreadName("PeriodicRunnerTimer");
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_running) {
+        const auto now = _clockSource->now();
+        auto nextRunDate = Date_t::max();
+        for (auto& job : _jobs) {
+            if (job->_execStatus != PeriodicJobImpl::ExecutionStatus::RUNNING ||
+                job->_inProgress) {
+                continue;
+            }
+            if (job->_nextRunDate > now) {
+                nextRunDate = std::min(nextRunDate, job->_nextRunDate);
+                continue;
             }
 
-            // Unlock while job is running so we can pause/cancel concurrently
-            lk.unlock();
-            _job.job(Client::getCurrent());
-            lk.lock();
-
-            if (_clockSource->waitForConditionUntil(_condvar, lk, start + _job.interval, [&] {
-                    return _execStatus == ExecutionStatus::CANCELED;
-                })) {
-                break;
+            job->_inProgress = true;
+            auto status = _threadPool->schedule([this, job] { _runJob(job); });
+            if (!status.isOK()) {
+                // Only happens on shutdown, which takes _mutex before it stops the pool.
+                severe() << "Failed to schedule periodic job " << job->_job.name << ": "
+                         << status;
+                fassertFailed(50913);
             }
         }
-    });
+
+        if (nextRunDate == Date_t::max()) {
+            _timerCondvar.wait(lk);
+        } else {
+            _clockSource->waitForConditionUntil(_timerCondvar, lk, nextRunDate);
+        }
+    }
+}
+
+void PeriodicRunnerImpl::_runJob(const std::shared_ptr<PeriodicJobImpl>& job) {
+    {
+        // The job may have been canceled while this run was queued on the pool.
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (job->_execStatus == PeriodicJobImpl::ExecutionStatus::CANCELED) {
+            job->_inProgress = false;
+            return;
+        }
+    }
+
+    const auto start = _clockSource->now();
+    {
+        setThreadName(job->_job.name);
+        if (!job->_client) {
+            job->_client = _svc->makeClient(job->_job.name);
+        }
+        AlternativeClientRegion acr(job->_client);
+        job->_job.job(Client::getCurrent());
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    job->_inProgress = false;
+    job->_nextRunDate = start + job->_job.interval;
+    if (job->_job.jitter > Milliseconds(0)) {
+        job->_nextRunDate +=
+            Milliseconds(_random.nextInt64(durationCount<Milliseconds>(job->_job.jitter) + 1));
+    }
+    _timerCondvar.notify_one();
 }
 
+PeriodicRunnerImpl::PeriodicJobImpl::PeriodicJobImpl(PeriodicJob job, PeriodicRunnerImpl* runner)
+    : _job(std::move(job)), _runner(runner) {}
+
 void PeriodicRunnerImpl::PeriodicJobImpl::start() {
     {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        stdx::lock_guard<stdx::mutex> lk(_runner->_mutex);
         invariant(_execStatus == PeriodicJobImpl::ExecutionStatus::NOT_SCHEDULED);
         _execStatus = PeriodicJobImpl::ExecutionStatus::RUNNING;
+        _nextRunDate = _runner->_clockSource->now();
     }
-    _run();
+    _runner->_timerCondvar.notify_one();
 }
 
 void PeriodicRunnerImpl::PeriodicJobImpl::pause() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    stdx::lock_guard<stdx::mutex> lk(_runner->_mutex);
     invariant(_execStatus == PeriodicJobImpl::ExecutionStatus::RUNNING);
     _execStatus = PeriodicJobImpl::ExecutionStatus::PAUSED;
 }
 
 void PeriodicRunnerImpl::PeriodicJobImpl::resume() {
     {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        stdx::lock_guard<stdx::mutex> lk(_runner->_mutex);
         invariant(_execStatus == PeriodicJobImpl::ExecutionStatus::PAUSED);
         _execStatus = PeriodicJobImpl::ExecutionStatus::RUNNING;
+        // A job that came due while paused runs as soon as it is resumed.
+        _nextRunDate = std::min(_nextRunDate, _runner->_clockSource->now());
     }
-    _condvar.notify_one();
-}
-
-void PeriodicRunnerImpl::PeriodicJobImpl::stop() {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        invariant(isAlive());
-        invariant(_thread.joinable());
-
-        _execStatus = PeriodicJobImpl::ExecutionStatus::CANCELED;
-    }
-    _condvar.notify_one();
-    _thread.join();
-}
-
-bool PeriodicRunnerImpl::PeriodicJobImpl::isAlive() {
-    return _execStatus == ExecutionStatus::RUNNING || _execStatus == ExecutionStatus::PAUSED;
+    _runner->_timerCondvar.notify_one();
 }
 
 
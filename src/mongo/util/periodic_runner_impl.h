@@ -31,20 +31,25 @@
 #include <memory>
 #include <vector>
 
+#include "mongo/db/service_context.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/periodic_runner.h"
 
 namespace mongo {
 
 class Client;
-class ServiceContext;
 
 /**
- * An implementation of the PeriodicRunner which uses a thread per job and condvar waits on those
- * threads to independently sleep.
+ * An implementation of the PeriodicRunner in which one timer thread waits for the next job to be
+ * due, and hands it to a thread pool to run. The pool starts threads as jobs overlap and reaps
+ * them once idle, so a runner whose jobs are short mostly uses two threads however many jobs it
+ * has. A job never overlaps with itself: its next run is due one interval, plus jitter, after its
+ * previous run started, or as soon as that run ends if it took longer.
  */
 class PeriodicRunnerImpl : public PeriodicRunner {
 public:
@@ -63,35 +68,51 @@ private:
         MONGO_DISALLOW_COPYING(PeriodicJobImpl);
 
     public:
-        PeriodicJobImpl(PeriodicJob job, ClockSource* source, ServiceContext* svc);
+        PeriodicJobImpl(PeriodicJob job, PeriodicRunnerImpl* runner);
 
         void start();
         void pause();
         void resume();
-        void stop();
-
-        bool isAlive();
 
         enum class ExecutionStatus { NOT_SCHEDULED, RUNNING, PAUSED, CANCELED };
 
     private:
-        void _run();
+        friend class PeriodicRunnerImpl;
 
         PeriodicJob _job;
-        ClockSource* _clockSource;
-        ServiceContext* _serviceContext;
-        stdx::thread _thread;
+        PeriodicRunnerImpl* const _runner;
+
+        // The client that the job runs with, created by its first run. Only the run in progress
+        // uses it.
+        ServiceContext::UniqueClient _client;
+
+        // The remaining members are guarded by the runner's _mutex.
 
-        stdx::mutex _mutex;
-        stdx::condition_variable _condvar;
         /**
          * The current execution status of the job.
          */
         ExecutionStatus _execStatus{ExecutionStatus::NOT_SCHEDULED};
+
+        // When the job is next due, if it is RUNNING and not in progress.
+        Date_t _nextRunDate;
+
+        // Whether a run of the job is queued on or running in the thread pool.
+        bool _inProgress = false;
     };
 
     std::shared_ptr<PeriodicRunnerImpl::PeriodicJobImpl> createAndAddJob(PeriodicJob job);
 
+    /**
+     * Body of the timer thread. Hands each job to the thread pool when it is due, until the
+     * runner shuts down.
+     */
+    void _runTimer();
+
+    /**
+     * Runs "job" on the calling thread pool thread and computes when it is next due.
+     */
+    void _runJob(const std::shared_ptr<PeriodicJobImpl>& job);
+
     class PeriodicJobHandleImpl : public PeriodicJobHandle {
     public:
         explicit PeriodicJobHandleImpl(std::weak_ptr<PeriodicJobImpl> jobImpl)
@@ -107,10 +128,26 @@ private:
     ServiceContext* _svc;
     ClockSource* _clockSource;
 
-    std::vector<std::shared_ptr<PeriodicJobImpl>> _jobs;
+    // Serializes startup() and shutdown(), which cannot hold _mutex while they start or join the
+    // threads of the runner.
+    stdx::mutex _lifecycleMutex;
+
+    // Created by each startup(), and joined by the matching shutdown().
+    stdx::thread _timerThread;
+    std::unique_ptr<ThreadPool> _threadPool;
 
+    // Guards the members below and the execution state of all the jobs.
     stdx::mutex _mutex;
+
+    // Signaled when a job becomes due earlier than the timer thread expects, and on shutdown.
+    stdx::condition_variable _timerCondvar;
+
+    std::vector<std::shared_ptr<PeriodicJobImpl>> _jobs;
+
     bool _running = false;
+
+    // Source of the jitter added to the intervals of the jobs.
+    PseudoRandom _random;
 };
 
 }  // namespace mongo
@@ -32,6 +32,9 @@
 
 #include "mongo/util/periodic_runner_impl.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -365,5 +368,43 @@ TEST_F(PeriodicRunnerImplTest, TwoJobsDontDeadlock) {
     tearDown();
 }
 
+TEST_F(PeriodicRunnerImplTest, MoreJobsThanThreadsWithJitterTest) {
+    const size_t numJobs = 20;
+    std::vector<int> counts(numJobs, 0);
+    Milliseconds interval{5};
+    Milliseconds jitter{5};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    // Each job is due at most interval + jitter after its previous run started.
+    for (size_t j = 0; j < numJobs; ++j) {
+        PeriodicRunner::PeriodicJob job("job",
+                                        [&counts, &mutex, &cv, j](Client*) {
+                                            {
+                                                stdx::unique_lock<stdx::mutex> lk(mutex);
+                                                counts[j]++;
+                                            }
+                                            cv.notify_all();
+                                        },
+                                        interval);
+        job.jitter = jitter;
+        runner().scheduleJob(std::move(job));
+    }
+
+    // Fast forward ten times, every job should run each time.
+    for (int i = 0; i < 10; i++) {
+        clockSource().advance(interval + jitter);
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cv.wait(lk, [&counts, &i] {
+                return std::all_of(
+                    counts.begin(), counts.end(), [&i](int count) { return count > i; });
+            });
+        }
+    }
+    tearDown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "processinfo.h"
 
+#include <fstream>
 #include <iostream>
 #include <malloc.h>
 #include <sched.h>
@@ -412,8 +413,57 @@ public:
         }
         return 0;
     }
+
+    /**
+    * Get the ids of the NUMA nodes, in ascending order. Empty if the kernel does not report any.
+    */
+    static std::vector<int> getNumaNodes() {
+        std::vector<int> nodes;
+        try {
+            const boost::filesystem::path nodeDir("/sys/devices/system/node");
+            if (!boost::filesystem::is_directory(nodeDir)) {
+                return nodes;
+            }
+            for (boost::filesystem::directory_iterator it(nodeDir), end; it != end; ++it) {
+                const string name = it->path().filename().string();
+                int node;
+                if (name.compare(0, 4, "node") == 0 && name.size() > 4 &&
+                    mongo::parseNumberFromString(name.substr(4), &node).isOK()) {
+                    nodes.push_back(node);
+                }
+            }
+        } catch (boost::filesystem::filesystem_error& e) {
+            log() << "Unable to list NUMA nodes: failed to probe \"" << e.path1().string()
+                  << "\": " << e.code().message();
+            nodes.clear();
+        }
+        std::sort(nodes.begin(), nodes.end());
+        return nodes;
+    }
+
+    /**
+    * Append the memory allocation counters of a NUMA node, e.g. how many of the pages allocated
+    * by its CPUs came from another node ('other_node').
+    */
+    static void appendNumaStats(int node, BSONObjBuilder* out) {
+        std::ifstream numastat(str::stream() << "/sys/devices/system/node/node" << node
+                                             << "/numastat");
+        string name;
+        long long value;
+        while (numastat >> name >> value) {
+            out->append(name, value);
+        }
+    }
 };
 
+/**
+* The NUMA nodes of the host, which do not change while the process runs.
+*/
+const std::vector<int>& numaNodes() {
+    static const std::vector<int> nodes = LinuxSysHelper::getNumaNodes();
+    return nodes;
+}
+
 
 ProcessInfo::ProcessInfo(ProcessId pid) : _pid(pid) {}
 
@@ -464,6 +514,16 @@ void ProcessInfo::getExtraInfo(BSONObjBuilder& info) {
         info.appendNumber("page_faults", static_cast<long long>(ru.ru_majflt));
     else
         info.appendNumber("page_faults", static_cast<double>(ru.ru_majflt));
+
+    // On multi-node hosts, report how the pages allocated by each node's CPUs were placed, so
+    // that remote memory accesses can be tracked.
+    if (numaNodes().size() > 1) {
+        BSONObjBuilder numa(info.subobjStart("numa"));
+        for (int node : numaNodes()) {
+            BSONObjBuilder nodeStats(numa.subobjStart(str::stream() << "node" << node));
+            LinuxSysHelper::appendNumaStats(node, &nodeStats);
+        }
+    }
 }
 
 /**
@@ -516,6 +576,15 @@ void ProcessInfo::SystemInfo::collectSystemInfo() {
     bExtra.append("pageSize", static_cast<long long>(pageSize));
     bExtra.append("numPages", static_cast<int>(sysconf(_SC_PHYS_PAGES)));
     bExtra.append("maxOpenFiles", static_cast<int>(sysconf(_SC_OPEN_MAX)));
+    if (numaNodes().size() > 1) {
+        BSONArrayBuilder nodes(bExtra.subarrayStart("numaNodes"));
+        for (int node : numaNodes()) {
+            const string cpulist = str::stream() << "/sys/devices/system/node/node" << node
+                                                 << "/cpulist";
+            const string cpus = LinuxSysHelper::readLineFromFile(cpulist.c_str());
+            nodes.append(BSON("node" << node << "cpus" << cpus));
+        }
+    }
 
     _extraStats = bExtra.obj();
 }
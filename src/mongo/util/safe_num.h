@@ -159,7 +159,11 @@ public:
     friend class mutablebson::Element;
     friend class mutablebson::Document;
 
-    // TODO: output to builder
+    /**
+     * Appends this number to 'bob' as a field named 'fieldName', using the BSON type of the
+     * number. Must not be called on an EOO-typed instance.
+     */
+    void toBSON(StringData fieldName, BSONObjBuilder* bob) const;
 
     //
     // accessors
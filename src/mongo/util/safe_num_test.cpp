@@ -31,6 +31,7 @@
 #undef MONGO_PCH_WHITELISTED  // for malloc/realloc pulled from bson
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/unittest/unittest.h"
@@ -38,6 +39,8 @@
 
 namespace {
 
+using mongo::BSONObj;
+using mongo::BSONObjBuilder;
 using mongo::SafeNum;
 using mongo::Decimal128;
 
@@ -73,6 +76,24 @@ TEST(Basics, BSONElementInitialization) {
     ASSERT_EQUALS(numDecimal.type(), mongo::NumberDecimal);
 }
 
+TEST(Basics, ToBSON) {
+    BSONObjBuilder bob;
+    SafeNum(1).toBSON("int", &bob);
+    SafeNum(static_cast<int64_t>(2)).toBSON("long", &bob);
+    SafeNum(0.5).toBSON("double", &bob);
+    SafeNum(Decimal128("1.5")).toBSON("decimal", &bob);
+    const BSONObj obj = bob.obj();
+
+    ASSERT_EQUALS(obj["int"].type(), mongo::NumberInt);
+    ASSERT_TRUE(SafeNum(obj["int"]).isIdentical(SafeNum(1)));
+    ASSERT_EQUALS(obj["long"].type(), mongo::NumberLong);
+    ASSERT_TRUE(SafeNum(obj["long"]).isIdentical(SafeNum(static_cast<int64_t>(2))));
+    ASSERT_EQUALS(obj["double"].type(), mongo::NumberDouble);
+    ASSERT_TRUE(SafeNum(obj["double"]).isIdentical(SafeNum(0.5)));
+    ASSERT_EQUALS(obj["decimal"].type(), mongo::NumberDecimal);
+    ASSERT_TRUE(SafeNum(obj["decimal"]).isIdentical(SafeNum(Decimal128("1.5"))));
+}
+
 TEST(Comparison, EOO) {
     const SafeNum safeNumA;
     const SafeNum safeNumB;
@@ -0,0 +1,312 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_cpu_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+
+#include "mongo/config.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+#if defined(_POSIX_VERSION) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#define MONGO_HAVE_SAMPLING_CPU_PROFILER 1
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace mongo {
+
+constexpr int SamplingCpuProfiler::kMaxFrames;
+constexpr size_t SamplingCpuProfiler::kMaxTagLength;
+
+namespace {
+
+struct ThreadTag {
+    // Odd while the tag is being written, in which case the signal handler interrupted the write
+    // and must not read it.
+    unsigned generation;
+    char text[SamplingCpuProfiler::kMaxTagLength + 1];
+};
+
+// Trivially constructible, so that the signal handler can read it without running constructors.
+thread_local ThreadTag threadTag;
+
+#ifdef MONGO_HAVE_SAMPLING_CPU_PROFILER
+
+struct Sample {
+    int numFrames;
+    void* frames[SamplingCpuProfiler::kMaxFrames];
+    char tag[SamplingCpuProfiler::kMaxTagLength + 1];
+};
+
+// The frames of the signal handler and of the signal trampoline that calls it.
+const int kSkipFrames = 2;
+
+// State shared with the signal handler. The buffer and its capacity only change while no handler
+// can be sampling.
+std::unique_ptr<Sample[]> sampleBuffer;
+size_t sampleCapacity = 0;
+AtomicWord<bool> sampling{false};
+AtomicUInt64 nextSample;
+AtomicUInt64 droppedSamples;
+AtomicInt32 handlersRunning;
+
+void sigprofHandler(int, siginfo_t*, void*) {
+    const int savedErrno = errno;
+
+    // Announce the handler before checking whether to sample, so that stopping can wait for it.
+    handlersRunning.fetchAndAdd(1);
+    if (sampling.load()) {
+        const auto index = nextSample.fetchAndAdd(1);
+        if (index < sampleCapacity) {
+            Sample& sample = sampleBuffer[index];
+            sample.numFrames = backtrace(sample.frames, SamplingCpuProfiler::kMaxFrames);
+            if (threadTag.generation % 2 == 0) {
+                memcpy(sample.tag, threadTag.text, sizeof(sample.tag));
+            } else {
+                sample.tag[0] = '\0';
+            }
+        } else {
+            droppedSamples.fetchAndAdd(1);
+        }
+    }
+    handlersRunning.subtractAndFetch(1);
+
+    errno = savedErrno;
+}
+
+/**
+ * Returns the name of the function containing 'address', without its parameters. Addresses
+ * without a symbol are named after their module, so that their samples still fold together.
+ */
+std::string symbolize(void* address) {
+    Dl_info dli;
+    if (!dladdr(address, &dli)) {
+        return "??";
+    }
+    if (dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        std::string name = demangled ? demangled : dli.dli_sname;
+        free(demangled);
+
+        // Parameters are verbose, and the frames of folded stacks are separated by ';'.
+        const auto paren = name.find('(', name.find("operator()") == 0 ? 2 : 0);
+        if (paren != std::string::npos && paren > 0) {
+            name.resize(paren);
+        }
+        std::replace(name.begin(), name.end(), ';', ':');
+        return name;
+    }
+    if (dli.dli_fname) {
+        StringData module(dli.dli_fname);
+        const auto slash = module.rfind('/');
+        if (slash != std::string::npos) {
+            module = module.substr(slash + 1);
+        }
+        return str::stream() << "[" << module << "]";
+    }
+    return "??";
+}
+
+#endif  // MONGO_HAVE_SAMPLING_CPU_PROFILER
+
+}  // namespace
+
+SamplingCpuProfiler& SamplingCpuProfiler::get() {
+    static SamplingCpuProfiler profiler;
+    return profiler;
+}
+
+bool SamplingCpuProfiler::isSupported() {
+#ifdef MONGO_HAVE_SAMPLING_CPU_PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SamplingCpuProfiler::setThreadTag(StringData opType, StringData ns) {
+    auto& tag = threadTag;
+    tag.generation++;
+    std::atomic_signal_fence(std::memory_order_seq_cst);  // NOLINT
+
+    size_t length = std::min(opType.size(), kMaxTagLength);
+    memcpy(tag.text, opType.rawData(), length);
+    if (!ns.empty() && length < kMaxTagLength) {
+        tag.text[length++] = ':';
+        const size_t nsLength = std::min(ns.size(), kMaxTagLength - length);
+        memcpy(tag.text + length, ns.rawData(), nsLength);
+        length += nsLength;
+    }
+    tag.text[length] = '\0';
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);  // NOLINT
+    tag.generation++;
+}
+
+void SamplingCpuProfiler::clearThreadTag() {
+    setThreadTag(StringData(), StringData());
+}
+
+bool SamplingCpuProfiler::isRunning() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _running;
+}
+
+#ifdef MONGO_HAVE_SAMPLING_CPU_PROFILER
+
+Status SamplingCpuProfiler::start(int frequencyHz, size_t maxSamples) {
+    invariant(frequencyHz > 0 && frequencyHz <= 1000 * 1000);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_running) {
+        return {ErrorCodes::ConflictingOperationInProgress, "The CPU profiler is already running"};
+    }
+
+    // The handler stays installed once sampling has started, since a SIGPROF still in flight
+    // when sampling stops would otherwise terminate the process.
+    static bool handlerInstalled = false;
+    if (!handlerInstalled) {
+        // The first call to backtrace() loads the unwinder, which allocates, so it must not
+        // happen in the signal handler.
+        void* frames[1];
+        backtrace(frames, 1);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = sigprofHandler;
+        action.sa_flags = SA_SIGINFO | SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            const int savedErrno = errno;
+            return {ErrorCodes::InternalError,
+                    str::stream() << "Failed to install the SIGPROF handler: "
+                                  << errnoWithDescription(savedErrno)};
+        }
+        handlerInstalled = true;
+    }
+
+    sampleBuffer.reset(new Sample[maxSamples]);
+    sampleCapacity = maxSamples;
+    nextSample.store(0);
+    droppedSamples.store(0);
+    sampling.store(true);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000 * 1000 / frequencyHz;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const int savedErrno = errno;
+        sampling.store(false);
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to start the profiling timer: "
+                              << errnoWithDescription(savedErrno)};
+    }
+
+    _running = true;
+    _startTime = Date_t::now();
+    _frequencyHz = frequencyHz;
+    return Status::OK();
+}
+
+SamplingCpuProfiler::Result SamplingCpuProfiler::stop() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_running);
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sampling.store(false);
+    while (handlersRunning.load() > 0) {
+        stdx::this_thread::yield();
+    }
+    _running = false;
+
+    Result result;
+    result.startTime = _startTime;
+    result.endTime = Date_t::now();
+    result.frequencyHz = _frequencyHz;
+    result.samples = std::min<uint64_t>(nextSample.load(), sampleCapacity);
+    result.droppedSamples = droppedSamples.load();
+
+    std::unordered_map<void*, std::string> symbols;
+    std::unordered_map<std::string, long long> stackCounts;
+    for (long long i = 0; i < result.samples; i++) {
+        const Sample& sample = sampleBuffer[i];
+        std::string stack = sample.tag;
+        for (int j = sample.numFrames - 1; j >= kSkipFrames; j--) {
+            auto symbol = symbols.find(sample.frames[j]);
+            if (symbol == symbols.end()) {
+                symbol = symbols.emplace(sample.frames[j], symbolize(sample.frames[j])).first;
+            }
+            if (!stack.empty()) {
+                stack += ';';
+            }
+            stack += symbol->second;
+        }
+        stackCounts[stack]++;
+    }
+    sampleBuffer.reset();
+    sampleCapacity = 0;
+
+    result.foldedStacks.assign(stackCounts.begin(), stackCounts.end());
+    std::sort(result.foldedStacks.begin(),
+              result.foldedStacks.end(),
+              [](const auto& a, const auto& b) {
+                  return a.second > b.second || (a.second == b.second && a.first < b.first);
+              });
+    return result;
+}
+
+#else
+
+Status SamplingCpuProfiler::start(int frequencyHz, size_t maxSamples) {
+    return {ErrorCodes::IllegalOperation, "The CPU profiler is not supported on this platform"};
+}
+
+SamplingCpuProfiler::Result SamplingCpuProfiler::stop() {
+    MONGO_UNREACHABLE;
+}
+
+#endif  // MONGO_HAVE_SAMPLING_CPU_PROFILER
+
+}  // namespace mongo
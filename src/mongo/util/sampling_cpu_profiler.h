@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * A process-wide sampling CPU profiler. While it runs, SIGPROF is delivered to the threads using
+ * CPU 'frequencyHz' times per second of CPU time, and the handler records the stack of the
+ * interrupted thread along with the tag of that thread (see setThreadTag()). Stopping the profiler
+ * symbolizes the recorded stacks and folds identical ones together, in the format read by
+ * flamegraph tools.
+ *
+ * Samples are recorded into a buffer allocated when the profiler starts, so that the signal
+ * handler neither allocates nor locks; samples that do not fit are dropped and counted.
+ *
+ * Only available on POSIX systems with backtrace(), and not together with the gperftools CPU
+ * profiler, which also uses SIGPROF.
+ */
+class SamplingCpuProfiler {
+    MONGO_DISALLOW_COPYING(SamplingCpuProfiler);
+
+public:
+    static constexpr int kMaxFrames = 64;
+    static constexpr size_t kMaxTagLength = 96;
+
+    struct Result {
+        Date_t startTime;
+        Date_t endTime;
+        int frequencyHz = 0;
+        long long samples = 0;
+        long long droppedSamples = 0;
+
+        // Lines of the form "<tag>;<outermost frame>;...;<innermost frame>", with the number of
+        // samples of each, ordered from the most frequent.
+        std::vector<std::pair<std::string, long long>> foldedStacks;
+    };
+
+    static SamplingCpuProfiler& get();
+
+    /**
+     * Returns whether the profiler can run on this platform.
+     */
+    static bool isSupported();
+
+    /**
+     * Sets the tag recorded with samples of the calling thread, as "<opType>:<ns>", truncated to
+     * kMaxTagLength. Cheap enough to call for every operation.
+     */
+    static void setThreadTag(StringData opType, StringData ns);
+
+    /**
+     * Clears the tag of the calling thread.
+     */
+    static void clearThreadTag();
+
+    /**
+     * Starts sampling, keeping at most 'maxSamples' samples. Fails if the profiler is already
+     * running or is not supported.
+     */
+    Status start(int frequencyHz, size_t maxSamples);
+
+    bool isRunning() const;
+
+    /**
+     * Stops sampling and returns the folded stacks of the samples taken. The profiler must be
+     * running.
+     */
+    Result stop();
+
+private:
+    SamplingCpuProfiler() = default;
+
+    // Guards starting and stopping.
+    mutable stdx::mutex _mutex;
+    bool _running = false;
+    Date_t _startTime;
+    int _frequencyHz = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/sampling_cpu_profiler.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Spins for 'amount' of wall time, which is about as much CPU time on an idle test machine.
+ */
+long long burnCpu(Milliseconds amount) {
+    Timer timer;
+    long long iterations = 0;
+    while (timer.millis() < durationCount<Milliseconds>(amount)) {
+        iterations++;
+    }
+    return iterations;
+}
+
+TEST(SamplingCpuProfilerTest, SamplesAreTaggedAndFolded) {
+    if (!SamplingCpuProfiler::isSupported()) {
+        return;
+    }
+
+    auto& profiler = SamplingCpuProfiler::get();
+    SamplingCpuProfiler::setThreadTag("query", "test.coll");
+    ASSERT_OK(profiler.start(1000, 10000));
+    ASSERT(profiler.isRunning());
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress, profiler.start(1000, 10000));
+    burnCpu(Milliseconds(200));
+    auto result = profiler.stop();
+    SamplingCpuProfiler::clearThreadTag();
+
+    ASSERT_FALSE(profiler.isRunning());
+    ASSERT_GT(result.samples, 0);
+    ASSERT_EQ(1000, result.frequencyHz);
+    ASSERT_LTE(result.startTime, result.endTime);
+    ASSERT_FALSE(result.foldedStacks.empty());
+
+    long long total = 0;
+    bool foundTag = false;
+    for (size_t i = 0; i < result.foldedStacks.size(); i++) {
+        const auto& stack = result.foldedStacks[i];
+        if (i > 0) {
+            ASSERT_LTE(stack.second, result.foldedStacks[i - 1].second);
+        }
+        total += stack.second;
+        foundTag = foundTag || StringData(stack.first).startsWith("query:test.coll;");
+    }
+    ASSERT_EQ(result.samples, total);
+    ASSERT(foundTag);
+}
+
+TEST(SamplingCpuProfilerTest, DropsSamplesThatDoNotFit) {
+    if (!SamplingCpuProfiler::isSupported()) {
+        return;
+    }
+
+    auto& profiler = SamplingCpuProfiler::get();
+    ASSERT_OK(profiler.start(1000, 1));
+    burnCpu(Milliseconds(200));
+    auto result = profiler.stop();
+
+    ASSERT_EQ(1, result.samples);
+    ASSERT_GT(result.droppedSamples, 0);
+}
+
+TEST(SamplingCpuProfilerTest, ThreadTagIsTruncated) {
+    if (!SamplingCpuProfiler::isSupported()) {
+        return;
+    }
+
+    auto& profiler = SamplingCpuProfiler::get();
+    SamplingCpuProfiler::setThreadTag("query", std::string(1000, 'x'));
+    ASSERT_OK(profiler.start(1000, 10000));
+    burnCpu(Milliseconds(100));
+    auto result = profiler.stop();
+    SamplingCpuProfiler::clearThreadTag();
+
+    ASSERT_GT(result.samples, 0);
+    const auto expectedTag = "query:" + std::string(SamplingCpuProfiler::kMaxTagLength - 6, 'x');
+    for (const auto& stack : result.foldedStacks) {
+        ASSERT(StringData(stack.first).startsWith(expectedTag + ";")) << stack.first;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -51,6 +51,13 @@ public:
         return takeOwnership(mongoMalloc(sizeof(Holder) + bytes), bytes);
     }
 
+    /**
+     * Returns the number of bytes allocated for a buffer in addition to its capacity.
+     */
+    static constexpr size_t allocationOverhead() {
+        return sizeof(Holder);
+    }
+
     /**
      * Resizes the buffer, copying the current contents.
      *
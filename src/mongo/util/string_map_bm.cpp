@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+std::vector<std::string> makeKeys(int64_t count, StringData prefix) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (int64_t i = 0; i < count; ++i) {
+        keys.push_back(prefix.toString() + std::to_string(i));
+    }
+    return keys;
+}
+
+template <typename Map>
+void BM_Insert(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    for (auto keepRunning : state) {
+        Map map;
+        for (auto&& key : keys) {
+            map[key] = 1;
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map>
+void BM_FindHit(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    for (auto keepRunning : state) {
+        for (auto&& key : keys) {
+            benchmark::DoNotOptimize(map.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map>
+void BM_FindMiss(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    const auto missing = makeKeys(state.range(0), "other");
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    for (auto keepRunning : state) {
+        for (auto&& key : missing) {
+            benchmark::DoNotOptimize(map.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * missing.size());
+}
+
+/**
+ * Repeatedly erases and reinserts every key, which exercises reuse of deleted slots.
+ */
+template <typename Map>
+void BM_EraseInsert(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    Map map;
+    for (auto&& key : keys) {
+        map[key] = 1;
+    }
+
+    for (auto keepRunning : state) {
+        for (auto&& key : keys) {
+            map.erase(key);
+            map[key] = 1;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// Each benchmark runs against StringMap and against the std::unordered_map most callers would use
+// otherwise. The argument is the number of keys in the map.
+using StdMap = std::unordered_map<std::string, int>;
+
+BENCHMARK_TEMPLATE(BM_Insert, StringMap<int>)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_Insert, StdMap)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_FindHit, StringMap<int>)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_FindHit, StdMap)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_FindMiss, StringMap<int>)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_FindMiss, StdMap)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_EraseInsert, StringMap<int>)->Range(8, 1 << 16);
+BENCHMARK_TEMPLATE(BM_EraseInsert, StdMap)->Range(8, 1 << 16);
+
+}  // namespace
+}  // namespace mongo
@@ -157,6 +157,49 @@ TEST(StringMapTest, Erase2) {
     ASSERT_EQUALS(true, m.empty());
 }
 
+TEST(StringMapTest, Erase3) {
+    StringMap<int> m;
+    char buf[64];
+
+    for (int i = 0; i < 1000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+    }
+
+    // Erasing every other key must not hide the keys that follow them in a probe sequence.
+    for (int i = 0; i < 1000; i += 2) {
+        sprintf(buf, "foo%d", i);
+        ASSERT_EQUALS(1U, m.erase(buf));
+    }
+    ASSERT_EQUALS(500U, m.size());
+
+    for (int i = 0; i < 1000; i++) {
+        sprintf(buf, "foo%d", i);
+        ASSERT_EQUALS(i % 2 ? 1U : 0U, m.count(buf));
+    }
+
+    // Repeatedly reusing the freed slots must not grow the table.
+    size_t before = m.capacity();
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 1000; i += 2) {
+            sprintf(buf, "foo%d", i);
+            m[buf] = i;
+        }
+        for (int i = 0; i < 1000; i += 2) {
+            sprintf(buf, "foo%d", i);
+            ASSERT_EQUALS(1U, m.erase(buf));
+        }
+    }
+    ASSERT_EQUALS(before, m.capacity());
+
+    size_t count = 0;
+    for (auto&& entry : m) {
+        ASSERT_EQUALS(1, entry.second % 2);
+        count++;
+    }
+    ASSERT_EQUALS(500U, count);
+}
+
 TEST(StringMapTest, Iterator1) {
     StringMap<int> m;
     ASSERT(m.begin() == m.end());
@@ -189,7 +189,17 @@ int versionCmp(const StringData rhs, const StringData lhs) {
 std::string escape(StringData sd, bool escape_slash) {
     StringBuilder ret;
     ret.reset(sd.size());
-    for (const auto& c : sd) {
+
+    // Characters which need no escaping are appended a run at a time.
+    size_t runStart = 0;
+    for (size_t i = 0; i < sd.size(); ++i) {
+        const char c = sd[i];
+        if (c != '"' && c != '\\' && (c != '/' || !escape_slash) && !(c >= 0 && c <= 0x1f)) {
+            continue;
+        }
+        ret << sd.substr(runStart, i - runStart);
+        runStart = i + 1;
+
         switch (c) {
             case '"':
                 ret << "\\\"";
@@ -198,7 +208,7 @@ std::string escape(StringData sd, bool escape_slash) {
                 ret << "\\\\";
                 break;
             case '/':
-                ret << (escape_slash ? "\\/" : "/");
+                ret << "\\/";
                 break;
             case '\b':
                 ret << "\\b";
@@ -216,14 +226,11 @@ std::string escape(StringData sd, bool escape_slash) {
                 ret << "\\t";
                 break;
             default:
-                if (c >= 0 && c <= 0x1f) {
-                    // For c < 0x7f, ASCII value == Unicode code point.
-                    ret << "\\u00" << toHexLower(&c, 1);
-                } else {
-                    ret << c;
-                }
+                // For c < 0x7f, ASCII value == Unicode code point.
+                ret << "\\u00" << toHexLower(&c, 1);
         }
     }
+    ret << sd.substr(runStart);
     return ret.str();
 }
 
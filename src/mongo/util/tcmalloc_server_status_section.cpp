@@ -33,6 +33,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <fstream>
 #include <gperftools/malloc_extension.h>
 #include <valgrind/valgrind.h>
 
@@ -161,6 +162,23 @@ public:
                 sub, "thread_cache_free_bytes", "tcmalloc.thread_cache_free_bytes");
             appendNumericPropertyIfAvailable(
                 sub, "aggressive_memory_decommit", "tcmalloc.aggressive_memory_decommit");
+            sub.append("release_rate", MallocExtension::instance()->GetMemoryReleaseRate());
+
+            // Memory that tcmalloc holds from the operating system but has not handed out, as a
+            // share of the mapped heap. A high ratio with a low release rate means fragmentation.
+            size_t heapSize;
+            size_t allocated;
+            size_t unmapped;
+            if (MallocExtension::instance()->GetNumericProperty("generic.heap_size", &heapSize) &&
+                MallocExtension::instance()->GetNumericProperty("generic.current_allocated_bytes",
+                                                                &allocated) &&
+                MallocExtension::instance()->GetNumericProperty("tcmalloc.pageheap_unmapped_bytes",
+                                                                &unmapped) &&
+                heapSize > unmapped && heapSize - unmapped >= allocated) {
+                const size_t mapped = heapSize - unmapped;
+                sub.appendNumber("fragmentation_bytes", mapped - allocated);
+                sub.append("fragmentation_ratio", static_cast<double>(mapped - allocated) / mapped);
+            }
 
             appendNumericPropertyIfAvailable(
                 sub, "pageheap_committed_bytes", "tcmalloc.pageheap_committed_bytes");
@@ -181,6 +199,14 @@ public:
             appendNumericPropertyIfAvailable(
                 sub, "spinlock_total_delay_ns", "tcmalloc.spinlock_total_delay_ns");
 
+#ifdef __linux__
+            if (verbosity >= 2) {
+                // How much of the process's memory is backed by transparent huge pages, which
+                // need fewer TLB entries. This walks every mapping, so it is not the default.
+                appendHugePageUsage(sub);
+            }
+#endif
+
 #if MONGO_HAVE_GPERFTOOLS_SIZE_CLASS_STATS
             if (verbosity >= 2) {
                 // Size class information
@@ -207,6 +233,20 @@ private:
             builder.appendNumber(bsonName, value);
     }
 
+#ifdef __linux__
+    static void appendHugePageUsage(BSONObjBuilder& builder) {
+        std::ifstream smaps("/proc/self/smaps_rollup");
+        std::string line;
+        while (std::getline(smaps, line)) {
+            long long kb;
+            if (sscanf(line.c_str(), "AnonHugePages: %lld kB", &kb) == 1) {
+                builder.appendNumber("anon_huge_page_bytes", kb * 1024);
+                return;
+            }
+        }
+    }
+#endif
+
 #if MONGO_HAVE_GPERFTOOLS_SIZE_CLASS_STATS
     static void appendSizeClassInfo(void* bsonarr_builder, const base::MallocSizeClass* stats) {
         BSONArrayBuilder* builder = reinterpret_cast<BSONArrayBuilder*>(bsonarr_builder);
@@ -128,6 +128,61 @@ TcmallocNumericPropertyServerParameter tcmallocMaxTotalThreadCacheBytesParameter
 TcmallocNumericPropertyServerParameter tcmallocAggressiveMemoryDecommit(
     "tcmallocAggressiveMemoryDecommit", "tcmalloc.aggressive_memory_decommit");
 
+/**
+ * Controls how quickly tcmalloc returns free pages of its page heap to the operating system. Zero
+ * never releases them, and larger values release them more aggressively.
+ */
+class TcmallocReleaseRateServerParameter : public ServerParameter {
+    MONGO_DISALLOW_COPYING(TcmallocReleaseRateServerParameter);
+
+public:
+    TcmallocReleaseRateServerParameter()
+        : ServerParameter(ServerParameterSet::getGlobal(),
+                          "tcmallocReleaseRate",
+                          true /* change at startup */,
+                          true /* change at runtime */) {}
+
+    virtual void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) {
+        b.append(name, MallocExtension::instance()->GetMemoryReleaseRate());
+    }
+
+    virtual Status set(const BSONElement& newValueElement) {
+        if (!newValueElement.isNumber()) {
+            return Status(ErrorCodes::TypeMismatch,
+                          str::stream() << "Expected server parameter "
+                                        << newValueElement.fieldName()
+                                        << " to have numeric type, but found "
+                                        << newValueElement.toString(false)
+                                        << " of type "
+                                        << typeName(newValueElement.type()));
+        }
+        return _set(newValueElement.numberDouble());
+    }
+
+    virtual Status setFromString(const std::string& str) {
+        double value;
+        Status status = parseNumberFromString(str, &value);
+        if (!status.isOK()) {
+            return status;
+        }
+        return _set(value);
+    }
+
+private:
+    Status _set(double value) {
+        if (!(value >= 0 && value <= 10)) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Value " << value << " is out of range for "
+                                        << name()
+                                        << "; expected a value between 0 and 10");
+        }
+        if (!RUNNING_ON_VALGRIND) {
+            MallocExtension::instance()->SetMemoryReleaseRate(value);
+        }
+        return Status::OK();
+    }
+} tcmallocReleaseRateParameter;
+
 MONGO_INITIALIZER_GENERAL(TcmallocConfigurationDefaults,
                           MONGO_NO_PREREQUISITES,
                           ("BeginStartupOptionHandling"))
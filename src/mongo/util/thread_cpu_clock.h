@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#ifndef _WIN32
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+#define MONGO_HAVE_THREAD_CPU_CLOCK 1
+#endif
+
+/**
+ * Measures the CPU time consumed by one thread. Obtained by that thread through
+ * forCurrentThread(), it can then be read by any thread for as long as the measured thread is
+ * alive, so that currentOp can report the CPU time of operations running on other threads.
+ *
+ * Only supported on platforms with POSIX thread CPU-time clocks; elsewhere now() always returns
+ * boost::none.
+ */
+class ThreadCpuClock {
+public:
+    /**
+     * Returns whether thread CPU-time clocks are available on this platform.
+     */
+    static bool isSupported();
+
+    /**
+     * Returns the clock of the calling thread.
+     */
+    static ThreadCpuClock forCurrentThread();
+
+    /**
+     * Constructs a clock that is not bound to any thread and for which now() returns boost::none.
+     */
+    ThreadCpuClock() = default;
+
+    /**
+     * Returns the total CPU time the thread has consumed so far, or boost::none if it cannot be
+     * read.
+     */
+    boost::optional<Microseconds> now() const;
+
+private:
+#ifdef MONGO_HAVE_THREAD_CPU_CLOCK
+    explicit ThreadCpuClock(clockid_t clockId) : _clockId(clockId), _valid(true) {}
+
+    clockid_t _clockId{};
+#endif
+    bool _valid = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/thread_cpu_clock.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Spins until the given clock has advanced by at least 'amount' of CPU time.
+ */
+void burnCpu(const ThreadCpuClock& clock, Microseconds amount) {
+    const auto start = *clock.now();
+    while (*clock.now() - start < amount) {
+    }
+}
+
+TEST(ThreadCpuClockTest, UnboundClockHasNoTime) {
+    ASSERT_FALSE(ThreadCpuClock().now());
+}
+
+TEST(ThreadCpuClockTest, MeasuresCurrentThread) {
+    if (!ThreadCpuClock::isSupported()) {
+        return;
+    }
+
+    auto clock = ThreadCpuClock::forCurrentThread();
+    const auto start = clock.now();
+    ASSERT(start);
+    burnCpu(clock, Milliseconds(10));
+    ASSERT_GTE(*clock.now() - *start, Milliseconds(10));
+}
+
+TEST(ThreadCpuClockTest, CanBeReadFromAnotherThread) {
+    if (!ThreadCpuClock::isSupported()) {
+        return;
+    }
+
+    // The main thread sleeps while it is measured, so it uses almost no CPU time compared to the
+    // thread that measures it.
+    auto clock = ThreadCpuClock::forCurrentThread();
+    const auto start = *clock.now();
+    boost::optional<Microseconds> end;
+    stdx::thread other([&] {
+        burnCpu(ThreadCpuClock::forCurrentThread(), Milliseconds(50));
+        end = clock.now();
+    });
+    other.join();
+
+    ASSERT(end);
+    ASSERT_LT(*end - start, Milliseconds(50));
+}
+
+}  // namespace
+}  // namespace mongo
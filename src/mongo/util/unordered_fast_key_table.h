@@ -29,18 +29,167 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <type_traits>
 
+// TODO replace this with #if BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSE2_VERSION in boost 1.60
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_UNORDERED_FAST_KEY_TABLE_SSE2
+#endif
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/bits.h"
+#include "mongo/platform/endian.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+namespace unordered_fast_key_table_detail {
+
+/**
+ * Each slot of a table has a control byte. It is negative for empty and deleted slots. For a used
+ * slot, it holds the low 7 bits of the hash of the slot's key (its "H2").
+ */
+using ControlByte = int8_t;
+constexpr ControlByte kEmpty = -128;
+constexpr ControlByte kDeleted = -2;
+
+/**
+ * A set of slots within a group, as returned by the Group match functions. Iterating yields the
+ * offsets of the matching slots within the group in increasing order.
+ */
+template <typename Bits, int kShift>
+class BitMask {
+public:
+    explicit BitMask(Bits bits) : _bits(bits) {}
+
+    explicit operator bool() const {
+        return _bits != 0;
+    }
+
+    int lowest() const {
+        return countTrailingZeros64(_bits) >> kShift;
+    }
+
+    BitMask& operator++() {
+        _bits &= _bits - 1;
+        return *this;
+    }
+
+private:
+    Bits _bits;
+};
+
+#if defined(MONGO_UNORDERED_FAST_KEY_TABLE_SSE2)
+
+/**
+ * A group of 16 consecutive control bytes, matched with SSE2 instructions.
+ */
+class Group {
+public:
+    static constexpr int kWidth = 16;
+
+    explicit Group(const ControlByte* pos)
+        : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    BitMask<uint32_t, 0> match(ControlByte h2) const {
+        return BitMask<uint32_t, 0>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+    }
+
+    BitMask<uint32_t, 0> matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    BitMask<uint32_t, 0> matchEmptyOrDeleted() const {
+        // Empty and deleted slots are exactly those whose control byte has its sign bit set.
+        return BitMask<uint32_t, 0>(_mm_movemask_epi8(_ctrl));
+    }
+
+private:
+    __m128i _ctrl;
+};
+
+#else
+
+/**
+ * A group of 8 consecutive control bytes, matched with arithmetic on a 64-bit word.
+ */
+class Group {
+public:
+    static constexpr int kWidth = 8;
+
+    explicit Group(const ControlByte* pos) {
+        std::memcpy(&_ctrl, pos, sizeof(_ctrl));
+        _ctrl = endian::littleToNative(_ctrl);
+    }
+
+    /**
+     * May report a slot following a true match as matching too, which callers tolerate because
+     * they compare the keys of every matching slot.
+     */
+    BitMask<uint64_t, 3> match(ControlByte h2) const {
+        const uint64_t x = _ctrl ^ (kLsbs * static_cast<uint8_t>(h2));
+        return BitMask<uint64_t, 3>((x - kLsbs) & ~x & kMsbs);
+    }
+
+    BitMask<uint64_t, 3> matchEmpty() const {
+        // Of the negative control bytes, only kEmpty has its bit 1 clear.
+        return BitMask<uint64_t, 3>(_ctrl & (~_ctrl << 6) & kMsbs);
+    }
+
+    BitMask<uint64_t, 3> matchEmptyOrDeleted() const {
+        return BitMask<uint64_t, 3>(_ctrl & kMsbs);
+    }
+
+private:
+    static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+    static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+
+    uint64_t _ctrl;
+};
+
+#endif
+
+/**
+ * Visits the groups of a table whose number of groups is a power of two, starting from the group
+ * selected by 'hash'. Advancing by one more group each step visits every group exactly once in
+ * the first numGroups steps.
+ */
+class ProbeSequence {
+public:
+    ProbeSequence(uint32_t hash, unsigned groupMask) : _mask(groupMask), _group(hash & groupMask) {}
+
+    unsigned offset() const {
+        return _group * Group::kWidth;
+    }
+
+    void next() {
+        ++_step;
+        _group = (_group + _step) & _mask;
+    }
+
+private:
+    unsigned _mask;
+    unsigned _group;
+    unsigned _step = 0;
+};
+
+}  // namespace unordered_fast_key_table_detail
+
 /**
  * A hash map that allows a different type to be used stored (K_S) than is used for lookups (K_L).
  *
+ * Entries live in an open-addressed array of slots, with a separate array holding one control
+ * byte per slot. A lookup probes groups of consecutive control bytes, comparing a whole group
+ * against 7 bits of the key's hash at once and only comparing the keys of the slots that match.
+ * It stops at the first group with an empty slot. Erasing an entry leaves a tombstone unless its
+ * group has an empty slot, and tombstones are dropped whenever the table is rehashed.
+ *
  * Takes a Traits class that must have the following:
  *
  * static uint32_t hash(K_L); // Computes a 32-bit hash of the key.
@@ -70,147 +219,148 @@ public:
     using HashedKey = typename Traits::HashedKey;
 
 private:
-    class Entry {
-    public:
-        Entry() = default;
+    using ControlByte = unordered_fast_key_table_detail::ControlByte;
+    using Group = unordered_fast_key_table_detail::Group;
+    using ProbeSequence = unordered_fast_key_table_detail::ProbeSequence;
 
-        Entry(const Entry& other)
-            : _used(other._used), _everUsed(other.everUsed), _curHash(other._curHash) {
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-        }
-
-        Entry& operator=(const Entry& other) {
-            if (this == &other) {
-                return *this;
-            }
+    using Slot = typename std::aligned_storage<sizeof(value_type),
+                                               std::alignment_of<value_type>::value>::type;
 
-            if (isUsed()) {
-                unUse();
-            }
+    class Area {
+    public:
+        Area() = default;  // TODO constexpr
 
-            _used = other._used;
-            _everUsed = other._everUsed;
-            _curHash = other._curHash;
+        explicit Area(unsigned capacity)
+            : _capacity(capacity),
+              _growthLeft(maxSizeForCapacity(capacity)),
+              _ctrl(capacity ? new ControlByte[capacity] : nullptr),
+              _slots(capacity ? new Slot[capacity] : nullptr) {
+            // Capacity must be a power of two multiple of the group width, or zero, so that groups
+            // never straddle the end of the table.
+            dassert((capacity & (capacity - 1)) == 0);
+            dassert(capacity % Group::kWidth == 0);
+            std::memset(_ctrl.get(), unordered_fast_key_table_detail::kEmpty, capacity);
+        }
 
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
+        Area(const Area& other) : Area(other._capacity) {
+            _growthLeft = other._growthLeft;
+            std::memcpy(_ctrl.get(), other._ctrl.get(), _capacity);
+            for (unsigned pos = 0; pos < _capacity; ++pos) {
+                if (isUsed(pos)) {
+                    new (&_slots[pos]) value_type(other.getData(pos));
+                }
             }
+        }
 
+        Area& operator=(const Area& other) {
+            Area(other).swap(this);
             return *this;
         }
 
-        ~Entry() {
-            if (isUsed()) {
-                unUse();
+        ~Area() {
+            for (unsigned pos = 0; pos < _capacity; ++pos) {
+                if (isUsed(pos)) {
+                    getData(pos).~value_type();
+                }
             }
         }
 
-        template <typename... Args>
-        void emplaceData(const HashedKey& key, Args&&... args) {
-            dassert(!isUsed());
-            _used = true;
-            _everUsed = true;
-            _curHash = key.hash();
-            new (&_data) value_type(std::piecewise_construct,
-                                    std::forward_as_tuple(Traits::toStorage(key.key())),
-                                    std::forward_as_tuple(std::forward<Args>(args)...));
+        /**
+         * Returns the largest number of used and deleted slots an area of 'capacity' slots may
+         * have, which keeps at least one slot in eight empty.
+         */
+        static unsigned maxSizeForCapacity(unsigned capacity) {
+            return capacity - capacity / 8;
         }
 
-        bool isUsed() const {
-            return _used;
-        }
+        /**
+         * Returns the position of the entry with 'key', or -1.
+         */
+        int find(const HashedKey& key) const;
 
-        bool wasEverUsed() const {
-            return _everUsed;
-        }
+        /**
+         * Returns the position of the first empty or deleted slot in the probe sequence of 'hash'.
+         */
+        int findInsertPosition(uint32_t hash) const;
 
-        uint32_t getCurHash() const {
-            dassert(isUsed());
-            return _curHash;
+        template <typename... Args>
+        void emplaceAt(int pos, const HashedKey& key, Args&&... args) {
+            dassert(!isUsed(pos));
+            if (_ctrl[pos] == unordered_fast_key_table_detail::kEmpty) {
+                dassert(_growthLeft > 0);
+                --_growthLeft;
+            }
+            new (&_slots[pos]) value_type(std::piecewise_construct,
+                                          std::forward_as_tuple(Traits::toStorage(key.key())),
+                                          std::forward_as_tuple(std::forward<Args>(args)...));
+            _ctrl[pos] = h2(key.hash());
         }
 
-        void unUse() {
-            dassert(isUsed());
-            _used = false;
-            reinterpret_cast<value_type*>(&_data)->~value_type();
-        }
+        void eraseAt(int pos);
 
-        value_type& getData() {
-            dassert(isUsed());
-            return *reinterpret_cast<value_type*>(&_data);
-        }
+        /**
+         * Moves the values of all entries into 'newArea', which must have room for them.
+         */
+        void transfer(Area* newArea);
 
-        const value_type& getData() const {
-            dassert(isUsed());
-            return *reinterpret_cast<const value_type*>(&_data);
+        void swap(Area* other) {
+            using std::swap;
+            swap(_capacity, other->_capacity);
+            swap(_growthLeft, other->_growthLeft);
+            swap(_ctrl, other->_ctrl);
+            swap(_slots, other->_slots);
         }
 
-    private:
-        bool _used = false;
-        bool _everUsed = false;
-        uint32_t _curHash;
-        typename std::aligned_storage<sizeof(value_type),
-                                      std::alignment_of<value_type>::value>::type _data;
-    };
-
-    struct Area {
-        Area() = default;  // TODO constexpr
-
-        Area(unsigned capacity, unsigned maxProbe)
-            : _hashMask(capacity - 1),
-              _maxProbe(maxProbe),
-              _entries(capacity ? new Entry[capacity] : nullptr) {
-            // Capacity must be a power of two or zero. See the comment on _hashMask for why.
-            dassert((capacity & (capacity - 1)) == 0);
+        unsigned capacity() const {
+            return _capacity;
         }
 
-        Area(const Area& other) : Area(other.capacity(), other._maxProbe) {
-            std::copy(other.begin(), other.end(), begin());
+        unsigned growthLeft() const {
+            return _growthLeft;
         }
 
-        Area& operator=(const Area& other) {
-            Area(other).swap(this);
-            return *this;
+        bool isUsed(int pos) const {
+            return _ctrl[pos] >= 0;
         }
 
-        int find(const HashedKey& key, int* firstEmpty) const;
-
-        bool transfer(Area* newArea) const;
-
-        void swap(Area* other) {
-            using std::swap;
-            swap(_hashMask, other->_hashMask);
-            swap(_maxProbe, other->_maxProbe);
-            swap(_entries, other->_entries);
+        bool isDeleted(int pos) const {
+            return _ctrl[pos] == unordered_fast_key_table_detail::kDeleted;
         }
 
-        unsigned capacity() const {
-            return _hashMask + 1;
+        value_type& getData(int pos) {
+            dassert(isUsed(pos));
+            return *reinterpret_cast<value_type*>(&_slots[pos]);
         }
 
-        Entry* begin() {
-            return _entries.get();
+        const value_type& getData(int pos) const {
+            dassert(isUsed(pos));
+            return *reinterpret_cast<const value_type*>(&_slots[pos]);
         }
-        Entry* end() {
-            return _entries.get() + capacity();
+
+    private:
+        // The high bits of the hash select the first group to probe, and the low 7 bits are stored
+        // in the control byte, so a match within a group is not implied by the group choice.
+        static uint32_t h1(uint32_t hash) {
+            return hash >> 7;
         }
 
-        const Entry* begin() const {
-            return _entries.get();
+        static ControlByte h2(uint32_t hash) {
+            return static_cast<ControlByte>(hash & 0x7f);
         }
-        const Entry* end() const {
-            return _entries.get() + capacity();
+
+        ProbeSequence probe(uint32_t hash) const {
+            dassert(_capacity);  // Caller must special-case empty tables.
+            return ProbeSequence(h1(hash), _capacity / Group::kWidth - 1);
         }
 
-        // Capacity is always a power of two. This means that the operation (hash % capacity) can be
-        // preformed by (hash & (capacity - 1)). Since we need the mask more than the capacity we
-        // store it directly and derive the capacity from it. The default capacity is 0 so the
-        // default hashMask is -1.
-        unsigned _hashMask = -1;
-        unsigned _maxProbe = 0;
-        std::unique_ptr<Entry[]> _entries = {};
+        unsigned _capacity = 0;
+
+        // How many more slots may become used before the area must be rehashed. Reusing a deleted
+        // slot doesn't consume growth.
+        unsigned _growthLeft = 0;
+
+        std::unique_ptr<ControlByte[]> _ctrl = {};
+        std::unique_ptr<Slot[]> _slots = {};
     };
 
 public:
@@ -263,7 +413,7 @@ public:
     }
 
     template <typename AreaPtr,
-              typename reference = decltype(AreaPtr()->begin()->getData()),
+              typename reference = decltype(AreaPtr()->getData(0)),
               typename pointer = typename std::add_pointer<reference>::type>
     class iterator_impl
         : public std::
@@ -277,7 +427,7 @@ public:
         iterator_impl(AreaPtr area) {
             _area = area;
             _position = 0;
-            _max = _area->capacity() - 1;
+            _max = static_cast<int>(_area->capacity()) - 1;
             _skip();
         }
         iterator_impl(AreaPtr area, int pos) {
@@ -291,11 +441,11 @@ public:
             : _area(other._area), _position(other._position), _max(other._max) {}
 
         pointer operator->() const {
-            return &_area->_entries[_position].getData();
+            return &_area->getData(_position);
         }
 
         reference operator*() const {
-            return _area->_entries[_position].getData();
+            return _area->getData(_position);
         }
 
         iterator_impl& operator++() {
@@ -326,7 +476,7 @@ public:
                     _position = -1;
                     break;
                 }
-                if (_area->_entries[_position].isUsed())
+                if (_area->isUsed(_position))
                     break;
                 ++_position;
             }
@@ -348,37 +498,37 @@ public:
     const_iterator find(const K_L& key) const {
         if (empty())
             return end();  // Don't waste time hashing.
-        return const_iterator(&_area, _area.find(HashedKey(key), nullptr));
+        return const_iterator(&_area, _area.find(HashedKey(key)));
     }
 
     const_iterator find(const HashedKey& key) const {
         if (empty())
             return end();
-        return const_iterator(&_area, _area.find(key, nullptr));
+        return const_iterator(&_area, _area.find(key));
     }
 
     iterator find(const K_L& key) {
         if (empty())
             return end();  // Don't waste time hashing.
-        return iterator(&_area, _area.find(HashedKey(key), nullptr));
+        return iterator(&_area, _area.find(HashedKey(key)));
     }
 
     iterator find(const HashedKey& key) {
         if (empty())
             return end();
-        return iterator(&_area, _area.find(key, nullptr));
+        return iterator(&_area, _area.find(key));
     }
 
     size_t count(const K_L& key) const {
         if (empty())
             return 0;  // Don't waste time hashing.
-        return _area.find(HashedKey(key), nullptr) != -1;
+        return _area.find(HashedKey(key)) != -1;
     }
 
     size_t count(const HashedKey& key) const {
         if (empty())
             return 0;
-        return _area.find(key, nullptr) != -1;
+        return _area.find(key) != -1;
     }
 
     const_iterator begin() const {
@@ -423,6 +573,10 @@ public:
     }
 
 private:
+    /**
+     * Makes room for at least one more entry: rehashes into an area of the same capacity if
+     * deleted slots account for much of the area, and into one of twice the capacity otherwise.
+     */
     void _grow();
 
     size_t _size = 0;
@@ -35,60 +35,58 @@
 namespace mongo {
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key,
-                                                                  int* firstEmpty) const {
-    dassert(capacity());                        // Caller must special-case empty tables.
-    dassert(!firstEmpty || *firstEmpty == -1);  // Caller must initialize *firstEmpty.
-
-    unsigned probe = 0;
-    do {
-        unsigned pos = (key.hash() + probe) & _hashMask;
-
-        if (!_entries[pos].isUsed()) {
-            // space is empty
-            if (firstEmpty && *firstEmpty == -1)
-                *firstEmpty = pos;
-            if (!_entries[pos].wasEverUsed())
-                return -1;
-            continue;
+inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key) const {
+    const ControlByte keyH2 = h2(key.hash());
+    for (auto seq = probe(key.hash());; seq.next()) {
+        const Group group(&_ctrl[seq.offset()]);
+        for (auto match = group.match(keyH2); match; ++match) {
+            const int pos = seq.offset() + match.lowest();
+            if (Traits::equals(key.key(), Traits::toLookup(getData(pos).first)))
+                return pos;
         }
 
-        if (_entries[pos].getCurHash() != key.hash()) {
-            // space has something else
-            continue;
-        }
+        // A key is never placed past a group with an empty slot, so the search ends here.
+        if (group.matchEmpty())
+            return -1;
+    }
+}
 
-        if (!Traits::equals(key.key(), Traits::toLookup(_entries[pos].getData().first))) {
-            // hashes match
-            // strings are not equals
-            continue;
-        }
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::findInsertPosition(
+    uint32_t hash) const {
+    // Terminates because there is always at least one empty slot.
+    for (auto seq = probe(hash);; seq.next()) {
+        auto available = Group(&_ctrl[seq.offset()]).matchEmptyOrDeleted();
+        if (available)
+            return seq.offset() + available.lowest();
+    }
+}
 
-        // hashes and strings are equal
-        // yay!
-        return pos;
-    } while (++probe < _maxProbe);
-    return -1;
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::eraseAt(int pos) {
+    getData(pos).~value_type();
+
+    // If this slot's group has an empty slot, no probe sequence ever passed through the group, so
+    // the slot can become empty again rather than a tombstone.
+    const int groupStart = pos - pos % Group::kWidth;
+    if (Group(&_ctrl[groupStart]).matchEmpty()) {
+        _ctrl[pos] = unordered_fast_key_table_detail::kEmpty;
+        ++_growthLeft;
+    } else {
+        _ctrl[pos] = unordered_fast_key_table_detail::kDeleted;
+    }
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
-    for (auto&& entry : *this) {
-        if (!entry.isUsed())
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) {
+    for (unsigned pos = 0; pos < _capacity; ++pos) {
+        if (!isUsed(pos))
             continue;
 
-        int firstEmpty = -1;
-        int loc = newArea->find(
-            HashedKey(Traits::toLookup(entry.getData().first), entry.getCurHash()), &firstEmpty);
-
-        verify(loc == -1);
-        if (firstEmpty < 0) {
-            return false;
-        }
-
-        newArea->_entries[firstEmpty] = entry;
+        auto& entry = getData(pos);
+        HashedKey key(Traits::toLookup(entry.first));
+        newArea->emplaceAt(newArea->findInsertPosition(key.hash()), key, std::move(entry.second));
     }
-    return true;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -98,10 +96,7 @@ inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::UnorderedFastKeyTable(
     for (auto&& entry : entries) {
         // Only insert the entry if the key is not equivalent to the key of any other element
         // already in the table.
-        auto key = HashedKey(entry.first);
-        if (find(key) == end()) {
-            get(key) = entry.second;
-        }
+        try_emplace(entry.first, entry.second);
     }
 }
 
@@ -115,13 +110,13 @@ inline size_t UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const HashedKey&
     if (_size == 0)
         return 0;  // Nothing to delete.
 
-    int pos = _area.find(key, nullptr);
+    int pos = _area.find(key);
 
     if (pos < 0)
         return 0;
 
+    _area.eraseAt(pos);
     --_size;
-    _area._entries[pos].unUse();
     return 1;
 }
 
@@ -130,67 +125,51 @@ void UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const_iterator it) {
     dassert(it._position >= 0);
     dassert(it._area == &_area);
 
+    _area.eraseAt(it._position);
     --_size;
-    _area._entries[it._position].unUse();
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
 template <typename... Args>
 inline auto UnorderedFastKeyTable<K_L, K_S, V, Traits>::try_emplace(const HashedKey& key,
-                                                                    Args&&... args)
+                                                                   Args&&... args)
     -> std::pair<iterator, bool> {
-    if (!_area._entries) {
-        // This is the first insert ever. Need to allocate initial space.
-        dassert(_area.capacity() == 0);
-        _grow();
-    }
-
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        int firstEmpty = -1;
-        int pos = _area.find(key, &firstEmpty);
-        if (pos >= 0) {
-            // This is only possible the first pass through the loop, since you're allocating space
-            // for a new element after that.
-            dassert(numGrowTries == 0);
+    if (_area.capacity()) {
+        const int pos = _area.find(key);
+        if (pos >= 0)
             return {iterator(&_area, pos), false};
-        }
+    }
 
-        // key not in map
-        // need to add
-        if (firstEmpty >= 0) {
-            _size++;
-            _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
-            return {iterator(&_area, firstEmpty), true};
-        }
+    int pos = _area.capacity() ? _area.findInsertPosition(key.hash()) : -1;
 
-        // no space left in map
+    // Reusing a deleted slot never requires growing the area.
+    if (pos < 0 || (!_area.isDeleted(pos) && _area.growthLeft() == 0)) {
         _grow();
+        pos = _area.findInsertPosition(key.hash());
     }
-    msgasserted(16471, "UnorderedFastKeyTable couldn't add entry after growing many times");
+
+    _area.emplaceAt(pos, key, std::forward<Args>(args)...);
+    ++_size;
+    return {iterator(&_area, pos), true};
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
-    unsigned capacity = _area.capacity();
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        if (capacity == 0) {
-            const unsigned kDefaultStartingCapacity = 16;
-            capacity = kDefaultStartingCapacity;
-        } else {
-            capacity *= 2;
-        }
-
-        const double kMaxProbeRatio = 0.05;
-        unsigned maxProbes = (capacity * kMaxProbeRatio) + 1;  // Round up
-
-        Area newArea(capacity, maxProbes);
-        bool success = _area.transfer(&newArea);
-        if (!success) {
-            continue;
-        }
-        _area.swap(&newArea);
-        return;
+void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
+    static const unsigned kMinCapacity = 16;
+
+    // If the entries fit comfortably, the area is full mostly of tombstones, so rehashing at the
+    // same capacity reclaims them. Otherwise, double it.
+    const unsigned oldCapacity = _area.capacity();
+    unsigned newCapacity = oldCapacity;
+    if (newCapacity < kMinCapacity) {
+        newCapacity = kMinCapacity;
+    } else if (_size > oldCapacity / 16 * 7) {
+        newCapacity *= 2;
     }
-    msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't add entry after growing many times");
-}
+
+    Area newArea(newCapacity);
+    _area.transfer(&newArea);
+    _area.swap(&newArea);
 }
+
+}  // namespace mongo